@@ -347,7 +347,8 @@ static inline struct hostent* gethostbyname_compat(const char* name)
 /* ==========================================================================
  * IPX Compatibility Layer
  * IPX (Internetwork Packet Exchange) is completely obsolete.
- * All functions return failure/unavailable.
+ * All functions return failure/unavailable. LAN game listing is done by
+ * Platform_Discovery_* (UDP multicast/broadcast beacons) instead.
  * ========================================================================== */
 
 /* IPX address types */
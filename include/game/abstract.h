@@ -31,7 +31,7 @@ public:
     // Construction / Destruction
     // -------------------------------------------------------------------------
 
-    AbstractClass() : rtti_type_(RTTI_NONE), heap_id_(-1), is_active_(true) {}
+    AbstractClass() : rtti_type_(RTTI_NONE), heap_id_(-1), handle_slot_(-1), is_active_(true) {}
     virtual ~AbstractClass() = default;
 
     // Non-copyable (objects have unique identity)
@@ -104,8 +104,12 @@ public:
     void Set_Heap_ID(int id) { heap_id_ = id; }
 
 protected:
+    // Heaps stamp the type and ID of the objects they allocate
+    friend class ObjectHeapBase;
+
     RTTIType rtti_type_;    // Runtime type identifier
     int heap_id_;           // Index in object pool
+    int handle_slot_;       // Stable slot for ObjectHandles (-1 if none)
     bool is_active_;        // Is this object alive?
 };
 
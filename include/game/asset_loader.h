@@ -0,0 +1,144 @@
+/**
+ * AssetLoader - Background Asset Loading with Priorities
+ *
+ * Loads that touch disk or decode data (shapes, templates, sounds,
+ * music) run on a small worker pool. Each request has two parts: the
+ * work, which runs on a worker and must only touch its own data plus
+ * thread-safe platform calls (MIX reads, shape/template parsing), and
+ * an optional completion, which runs on the main thread inside Pump().
+ * GameClass::Run() calls Pump() once per frame, so caches and platform
+ * handles are only ever modified from the main thread.
+ *
+ * Queued work is taken strictly by priority, then in submission order.
+ *
+ * Without Start() (tests, tools) Submit() runs the work immediately and
+ * the completion still waits for Pump(), so callers see the same order
+ * either way.
+ *
+ * Usage:
+ *   auto shape = std::make_shared<ShapeRenderer>();
+ *   AssetLoader::Instance().Submit(ASSET_PRIORITY_VISIBLE,
+ *       [shape]() { shape->Load("E1.SHP"); },
+ *       [shape]() { Install(shape); });
+ */
+
+#ifndef GAME_ASSET_LOADER_H
+#define GAME_ASSET_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Load priority, most urgent first
+ */
+enum AssetPriority {
+    ASSET_PRIORITY_UI = 0,          // Cursor, menus, sidebar
+    ASSET_PRIORITY_VISIBLE,         // Units and terrain on screen
+    ASSET_PRIORITY_AUDIO,           // Sound effects and music
+    ASSET_PRIORITY_PREFETCH,        // Anything that may be needed later
+    ASSET_PRIORITY_COUNT
+};
+
+typedef uint32_t AssetJobId;
+constexpr AssetJobId ASSET_JOB_NONE = 0;
+
+class AssetLoader {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * Shared loader used by the game caches
+     */
+    static AssetLoader& Instance();
+
+    AssetLoader() = default;
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * Start the worker pool
+     *
+     * @param worker_count Threads to start; 0 = one less than the
+     *                     hardware threads, between 1 and 4
+     */
+    void Start(int worker_count = 0);
+
+    /**
+     * Stop the workers
+     *
+     * Work already running finishes; queued work is dropped. Completions
+     * of finished work still run at the next Pump().
+     */
+    void Stop();
+
+    bool IsRunning() const { return !workers_.empty(); }
+    int GetWorkerCount() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * Queue a load
+     *
+     * @param work Runs on a worker (or inline when not started)
+     * @param done Runs on the main thread in Pump() after work; may be empty
+     */
+    AssetJobId Submit(AssetPriority priority, Task work, Task done = Task());
+
+    /**
+     * Drop a load that has not started yet (neither work nor done runs)
+     *
+     * @return false if it already started or finished
+     */
+    bool Cancel(AssetJobId id);
+
+    /**
+     * Run completions of finished work (main thread sync point)
+     *
+     * @param max_completions Stop after this many; 0 = all ready
+     * @return Completions run
+     */
+    int Pump(int max_completions = 0);
+
+    /**
+     * Wait until all queued work has finished, then Pump()
+     *
+     * For load screens and shutdown; never call from a completion.
+     */
+    void Flush();
+
+    size_t GetQueuedCount() const;
+
+    /**
+     * True when nothing is queued, running, or waiting for Pump()
+     */
+    bool IsIdle() const;
+    uint32_t GetCompletedCount() const { return completed_; }
+
+private:
+    struct Job {
+        AssetJobId id;
+        Task work;
+        Task done;
+    };
+
+    void WorkerMain();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;          // Work queued or stopping
+    std::condition_variable idle_;          // A worker finished a job
+    std::deque<Job> queues_[ASSET_PRIORITY_COUNT];
+    std::vector<Job> finished_;             // Waiting for Pump()
+    std::vector<std::thread> workers_;
+    int active_ = 0;                        // Jobs running on workers
+    bool stopping_ = false;
+    AssetJobId next_id_ = 1;
+    uint32_t completed_ = 0;                // Main thread only
+};
+
+#endif // GAME_ASSET_LOADER_H
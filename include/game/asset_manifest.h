@@ -0,0 +1,157 @@
+/**
+ * AssetManifest - Scenario Prefetch List
+ *
+ * Shapes and voices normally load on first use, which hitches the frame
+ * where a unit type first appears or first speaks. A manifest lists what
+ * a scenario will need so the load screen can queue it all on the
+ * AssetLoader instead.
+ *
+ * Entries come from two places:
+ * - The scenario INI: theater, player house, and every unit, infantry,
+ *   ship, structure and terrain type placed on the map
+ * - A first-use log saved by earlier runs of the same scenario, which
+ *   catches anything the INI doesn't name (EVA lines, projectiles,
+ *   reinforcements)
+ *
+ * While recording, ShapeCache, SoundManager and VoiceManager report each
+ * asset they had to load on demand; those are exactly the hitches worth
+ * prefetching next time.
+ *
+ * Usage:
+ *   AssetManifest manifest;
+ *   manifest.Parse_Scenario(ini_text, ini_size);
+ *   manifest.Load_Log(log_path);
+ *   manifest.Prefetch();
+ *   AssetManifest::Begin_Recording(&first_use);
+ */
+
+#ifndef GAME_ASSET_MANIFEST_H
+#define GAME_ASSET_MANIFEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/asset_loader.h"
+#include "game/audio/sound_effect.h"
+#include "game/audio/voice_event.h"
+#include "game/house.h"
+#include "game/map.h"
+
+/**
+ * What an entry names
+ */
+enum AssetKind : uint8_t {
+    ASSET_KIND_SHAPE = 0,       // SHP/terrain file, by name
+    ASSET_KIND_EVA,             // EvaVoice
+    ASSET_KIND_UNIT_VOICE,      // UnitVoice + VoiceFaction
+    ASSET_KIND_SOUND,           // SoundEffect
+    ASSET_KIND_COUNT
+};
+
+struct AssetManifestEntry {
+    AssetKind kind;
+    int16_t id;                 // Voice or sound enum value (voices and sounds only)
+    uint8_t faction;            // VoiceFaction (unit voices only)
+    std::string name;           // Uppercase filename (shapes only)
+};
+
+class AssetManifest {
+public:
+    AssetManifest() = default;
+
+    /**
+     * Add the assets placed by a scenario INI
+     *
+     * Reads [Basic] Player, [Map] Theater, and the type column of
+     * [UNITS], [INFANTRY], [SHIPS], [STRUCTURES] and [TERRAIN].
+     * Unit and building types resolve through their type classes; other
+     * names are taken as the shape name, as in the original game.
+     *
+     * @return false if the text has no sections at all
+     */
+    bool Parse_Scenario(const char* text, size_t length);
+
+    /**
+     * Add the entries of a saved first-use log
+     *
+     * @return false if the file is missing (no entries added)
+     */
+    bool Load_Log(const char* path);
+
+    /**
+     * Write this manifest as a first-use log
+     */
+    bool Save_Log(const char* path) const;
+
+    /**
+     * Add one entry (duplicates are ignored)
+     *
+     * @return true if it was new
+     */
+    bool Add_Shape(const char* filename);
+    bool Add_Eva(EvaVoice voice);
+    bool Add_Unit_Voice(UnitVoice voice, VoiceFaction faction);
+    bool Add_Sound(SoundEffect sfx);
+
+    /**
+     * Add every entry of another manifest
+     */
+    void Merge(const AssetManifest& other);
+
+    /**
+     * Queue every entry on the AssetLoader
+     *
+     * Shapes go to ShapeCache::PreloadAsync(); voices and sounds are only
+     * queued when their manager is initialized. Sounds are pinned in the
+     * SoundManager cache so the scenario never decodes them twice.
+     *
+     * @return loads queued (entries already cached or loading are skipped)
+     */
+    int Prefetch(AssetPriority priority = ASSET_PRIORITY_PREFETCH) const;
+
+    void Clear();
+
+    TheaterType Get_Theater() const { return theater_; }
+    HousesType Get_Player() const { return player_; }
+    const std::vector<AssetManifestEntry>& Get_Entries() const { return entries_; }
+    size_t Size() const { return entries_.size(); }
+    bool Is_Empty() const { return entries_.empty(); }
+
+    // -------------------------------------------------------------------------
+    // First-Use Recording
+    // -------------------------------------------------------------------------
+
+    /**
+     * Send on-demand loads to a manifest (nullptr stops recording)
+     *
+     * Records may come from the audio thread; the log must not be read
+     * or saved until End_Recording() returns.
+     */
+    static void Begin_Recording(AssetManifest* log);
+    static void End_Recording();
+    static bool Is_Recording();
+
+    /**
+     * Report an asset loaded on demand (no-op when not recording)
+     */
+    static void Record_Shape(const char* filename);
+    static void Record_Eva(EvaVoice voice);
+    static void Record_Unit_Voice(UnitVoice voice, VoiceFaction faction);
+    static void Record_Sound(SoundEffect sfx);
+
+private:
+    bool Add(AssetKind kind, int16_t id, uint8_t faction, const char* name);
+    void Add_Placed_Type(const char* type_name, bool is_structure);
+    void Add_Player_Voices();
+
+    std::vector<AssetManifestEntry> entries_;
+    std::vector<std::string> terrain_;      // Resolved once the theater is known
+    TheaterType theater_ = THEATER_NONE;
+    HousesType player_ = HOUSE_NONE;
+
+    static AssetManifest* recording_;
+};
+
+#endif // GAME_ASSET_MANIFEST_H
@@ -0,0 +1,276 @@
+/**
+ * AssetPack - Pre-Decoded Asset Pack
+ *
+ * The original formats need work before use: SHP frames are LCW/XOR
+ * delta compressed, TMP tiles are parsed out of their icon sets, and AUD
+ * samples are ADPCM. An asset pack holds the results of that work,
+ * written once offline by the PackAssets tool:
+ *
+ * - Shapes as span-encoded frames, in ShapeFrame's own span layout
+ * - Theater tile atlases, one run of 24x24 tiles per template
+ * - Sound effects and voices as 16-bit PCM
+ *
+ * The pack is memory-mapped and every blob starts on a page boundary, so
+ * loading an asset is an index lookup: ShapeRenderer copies spans
+ * straight out, TileRenderer points its templates into the mapped atlas,
+ * and SoundManager hands the PCM to the platform as is. Anything not in
+ * the pack still loads from the MIX archives.
+ *
+ * ## File Layout (little-endian)
+ * ```
+ * AssetPackHeader
+ * AssetPackEntry[entry_count]     - sorted by Westwood filename CRC
+ * blobs                           - each page-aligned
+ * ```
+ *
+ * The pack must stay open while anything loaded from it is in use;
+ * close it only at shutdown, after the caches are cleared.
+ *
+ * Usage:
+ *   AssetPack::Instance().Open("gamedata/ASSETS.PAK");
+ *   renderer.Load("E1.SHP");      // Uses the pack if it has E1.SHP
+ */
+
+#ifndef GAME_ASSET_PACK_H
+#define GAME_ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class AudFile;
+class ShapeRenderer;
+struct ShapeFrame;
+struct TemplateData;
+
+// =============================================================================
+// On-Disk Structures
+// =============================================================================
+
+constexpr uint32_t ASSET_PACK_VERSION = 1;
+constexpr uint32_t ASSET_PACK_PAGE_SIZE = 4096;
+constexpr size_t ASSET_PACK_NAME_SIZE = 24;
+
+enum AssetPackKind : uint8_t {
+    ASSET_PACK_SHAPE = 1,       // AssetPackShape
+    ASSET_PACK_ATLAS = 2,       // AssetPackAtlas
+    ASSET_PACK_AUDIO = 3,       // AssetPackAudio
+};
+
+struct AssetPackHeader {
+    char magic[4];              // "RAPK"
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t page_size;
+    uint64_t index_offset;      // AssetPackEntry table
+    uint64_t file_size;
+};
+
+struct AssetPackEntry {
+    uint32_t crc;               // Platform_Westwood_CRC_Filename(name)
+    uint8_t kind;               // AssetPackKind
+    uint8_t reserved[3];
+    uint64_t offset;            // Blob start (page-aligned)
+    uint64_t size;              // Blob size in bytes
+    char name[ASSET_PACK_NAME_SIZE];  // Uppercase, null-terminated
+};
+
+/**
+ * Shape blob: header, frame table, then span bytes and row offsets.
+ * Offsets are relative to the blob start.
+ */
+struct AssetPackShape {
+    uint16_t frame_count;
+    uint16_t width;             // Largest frame
+    uint16_t height;
+    uint16_t reserved;
+};
+
+struct AssetPackFrame {
+    int16_t x_offset;
+    int16_t y_offset;
+    int16_t width;
+    int16_t height;
+    uint32_t spans_offset;      // ShapeFrame::spans bytes
+    uint32_t spans_size;
+    uint32_t rows_offset;       // height + 1 uint32_t (ShapeFrame::row_offsets)
+    uint32_t reserved;
+};
+
+/**
+ * Atlas blob (one per theater): header, template table, then the tiles
+ * of every template end to end. Templates are named by their theater
+ * filename (CLEAR1.TEM) so the pack survives TemplateType renumbering.
+ */
+struct AssetPackAtlas {
+    uint32_t template_count;
+    uint32_t tile_count;
+    uint32_t tiles_offset;      // tile_count * TILE_SIZE bytes
+    uint32_t reserved;
+};
+
+struct AssetPackTemplate {
+    char name[16];
+    uint32_t first_tile;
+    uint32_t tile_count;
+};
+
+/**
+ * Audio blob: header then 16-bit signed PCM
+ */
+struct AssetPackAudio {
+    uint16_t sample_rate;
+    uint8_t channels;
+    uint8_t compression;        // Source AudCompressionType (informational)
+    uint32_t pcm_size;          // Bytes
+    uint32_t pcm_offset;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32, "AssetPackHeader layout");
+static_assert(sizeof(AssetPackEntry) == 48, "AssetPackEntry layout");
+static_assert(sizeof(AssetPackShape) == 8, "AssetPackShape layout");
+static_assert(sizeof(AssetPackFrame) == 24, "AssetPackFrame layout");
+static_assert(sizeof(AssetPackAtlas) == 16, "AssetPackAtlas layout");
+static_assert(sizeof(AssetPackTemplate) == 24, "AssetPackTemplate layout");
+static_assert(sizeof(AssetPackAudio) == 16, "AssetPackAudio layout");
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+/**
+ * A blob inside the mapped pack
+ */
+struct AssetPackBlob {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+class AssetPack {
+public:
+    /**
+     * Pack used by the game loaders
+     */
+    static AssetPack& Instance();
+
+    AssetPack() = default;
+    ~AssetPack() { Close(); }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    /**
+     * Map a pack file and check its header and index
+     *
+     * @return false if missing or malformed (the pack stays closed)
+     */
+    bool Open(const char* path);
+
+    /**
+     * Map a pack already in memory (tests); data must outlive the pack
+     */
+    bool OpenMemory(const uint8_t* data, size_t size);
+
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    uint32_t GetEntryCount() const { return entry_count_; }
+    const AssetPackEntry* GetEntry(uint32_t index) const;
+
+    /**
+     * Find a blob by filename (case-insensitive) and kind
+     */
+    AssetPackBlob Find(const char* name, AssetPackKind kind) const;
+
+    /**
+     * Typed lookups; each checks the blob's tables against its size
+     */
+    const AssetPackShape* FindShape(const char* name, AssetPackBlob* blob) const;
+    const AssetPackAtlas* FindAtlas(const char* name, AssetPackBlob* blob) const;
+    const AssetPackAudio* FindAudio(const char* name, AssetPackBlob* blob) const;
+
+private:
+    bool Validate();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;                   // data_ came from Platform_File_Map
+    const AssetPackEntry* entries_ = nullptr;
+    uint32_t entry_count_ = 0;
+};
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+/**
+ * Builds a pack from decoded assets (used by the PackAssets tool)
+ */
+class AssetPackWriter {
+public:
+    /**
+     * Add every frame of a loaded shape, span-encoded
+     */
+    bool AddShape(const char* name, ShapeRenderer& shape);
+
+    /**
+     * Add span-encoded frames (frames without spans are stored empty)
+     *
+     * @param width, height Largest frame size
+     */
+    bool AddFrames(const char* name, const std::vector<ShapeFrame>& frames, int width, int height);
+
+    /**
+     * Add a theater's tile atlas
+     *
+     * @param names     Template filename per entry of templates
+     * @param tile_size Bytes per tile
+     */
+    bool AddAtlas(const char* name, const std::vector<std::string>& names,
+                  const std::vector<const TemplateData*>& templates, int tile_size);
+
+    /**
+     * Add decoded audio
+     */
+    bool AddAudio(const char* name, const AudFile& aud);
+
+    /**
+     * Add every blob of an open pack as stored (names already added are kept)
+     *
+     * @return Blobs added
+     */
+    int AddPack(const AssetPack& pack);
+
+    /**
+     * Check if a name of this kind was already added
+     */
+    bool Has(const char* name, AssetPackKind kind) const;
+
+    size_t GetEntryCount() const { return blobs_.size(); }
+
+    /**
+     * Lay out the pack in memory
+     */
+    std::vector<uint8_t> Build() const;
+
+    /**
+     * Build and write to a file
+     */
+    bool Write(const char* path) const;
+
+private:
+    struct Blob {
+        AssetPackEntry entry;
+        std::vector<uint8_t> data;
+    };
+
+    bool Add(const char* name, AssetPackKind kind, std::vector<uint8_t> data);
+
+    std::vector<Blob> blobs_;
+};
+
+#endif // GAME_ASSET_PACK_H
@@ -5,6 +5,8 @@
 #ifndef AUD_FILE_H
 #define AUD_FILE_H
 
+#include "game/mix_view.h"
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -54,6 +56,89 @@ struct WwAdpcmState {
     void Reset() { predictor = 0; step_index = 0; }
 };
 
+//=============================================================================
+// Streaming Decoder
+//=============================================================================
+
+// Decodes AUD data a piece at a time, carrying the ADPCM state from one
+// call to the next. The file bytes are not copied and must outlive the
+// decoder. AudFile decodes whole files through it.
+class AudDecoder {
+public:
+    AudDecoder();
+
+    // Parse and validate the header of an AUD file held in memory
+    bool Open(const uint8_t* data, uint32_t size);
+
+    void Close();
+    bool IsOpen() const { return src_ != nullptr; }
+
+    // Go back to the first sample
+    void Rewind();
+
+    // Decode up to max_samples 16-bit samples (interleaved when stereo)
+    // Returns the number written; 0 once the data is used up
+    size_t Decode(int16_t* out, size_t max_samples);
+
+    // All samples have been returned
+    bool IsFinished() const;
+
+    const AudHeader& GetHeader() const { return header_; }
+    uint16_t GetSampleRate() const { return header_.sample_rate; }
+    int GetChannels() const { return (header_.flags & AUD_FLAG_STEREO) ? 2 : 1; }
+
+    // Samples the whole file decodes to
+    size_t GetTotalSamples() const { return total_samples_; }
+
+private:
+    // Largest ADPCM block: one 25-sample WW chunk per stereo channel
+    static constexpr size_t MAX_BLOCK_SAMPLES = 50;
+
+    // Bytes and samples of the next ADPCM block
+    uint32_t BlockBytes() const;
+    size_t BlockSamples() const;
+
+    // Decode one block at src_pos_ and step past it
+    size_t DecodeBlock(int16_t* out);
+
+    size_t DecodeUncompressed(int16_t* out, size_t max_samples);
+
+    AudHeader header_;
+    const uint8_t* src_;
+    uint32_t src_size_;
+    uint32_t src_pos_;
+    size_t total_samples_;
+
+    WwAdpcmState state_[2];                 // Per channel (IMA uses [0])
+
+    // Rest of a block that did not fit the caller's buffer
+    int16_t pending_[MAX_BLOCK_SAMPLES];
+    size_t pending_pos_;
+    size_t pending_count_;
+};
+
+//=============================================================================
+// MIX Stream
+//=============================================================================
+
+// An AUD file decoded straight out of its MIX archive view, for music:
+// only the caller's buffer of PCM exists at any time
+class AudStream {
+public:
+    // Map the file from the MIX archives and open the decoder on it
+    bool Open(const char* filename);
+
+    void Close();
+    bool IsOpen() const { return decoder_.IsOpen(); }
+
+    AudDecoder& GetDecoder() { return decoder_; }
+    const AudDecoder& GetDecoder() const { return decoder_; }
+
+private:
+    MixView view_;
+    AudDecoder decoder_;
+};
+
 //=============================================================================
 // AUD File Loader Class
 //=============================================================================
@@ -79,8 +164,12 @@ public:
     bool LoadFromData(const uint8_t* data, uint32_t size);
 
     // Load AUD from a MIX archive file via platform API
+    // (the open AssetPack's decoded PCM is used when it has the file)
     bool LoadFromMix(const char* filename);
 
+    // Load decoded PCM from the open AssetPack
+    bool LoadFromPack(const char* filename);
+
     // Clear loaded data and reset state
     void Clear();
 
@@ -133,11 +222,6 @@ private:
     std::vector<int16_t> pcm_data_;
     std::string filename_;
     bool loaded_;
-
-    bool DecodeUncompressed(const uint8_t* src, uint32_t src_size);
-    bool DecodeWwAdpcm(const uint8_t* src, uint32_t src_size);
-    bool DecodeImaAdpcm(const uint8_t* src, uint32_t src_size);
-    int16_t DecodeWwNibble(WwAdpcmState& state, uint8_t nibble);
 };
 
 //=============================================================================
@@ -153,4 +237,10 @@ bool LoadAudFromMix(const char* filename,
 // Quick function to get AUD file info without full decode
 bool GetAudInfo(const uint8_t* data, uint32_t size, AudHeader* out_header = nullptr);
 
+// Decode raw IMA ADPCM bytes (no AUD header), low nibble first, carrying
+// state on from the last call; writes 2 samples per byte, `stride` apart
+// (2 to fill one channel of a stereo buffer). Used for VQA sound chunks.
+void DecodeImaAdpcm(WwAdpcmState& state, const uint8_t* data, size_t bytes,
+                    int16_t* out, size_t stride = 1);
+
 #endif // AUD_FILE_H
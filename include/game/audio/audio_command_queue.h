@@ -0,0 +1,103 @@
+// include/game/audio/audio_command_queue.h
+// Lock-free command ring from the game thread to the audio thread
+
+#ifndef AUDIO_COMMAND_QUEUE_H
+#define AUDIO_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//=============================================================================
+// Audio Commands
+//=============================================================================
+
+enum class AudioCommandType : uint8_t {
+    PLAY_SOUND,             // a = SoundEffect
+    PLAY_SOUND_AT,          // a = SoundEffect, b/c = world x/y, value = volume
+    PLAY_SOUND_AT_CELL,     // a = SoundEffect, b/c = cell x/y
+    STOP_ALL_SOUNDS,
+    SET_LISTENER,           // b/c = world x/y
+    SET_MASTER_VOLUME,      // value = volume, a = muted
+    SET_SFX_VOLUME,         // value
+    SET_MUSIC_VOLUME,       // value
+    SET_VOICE_VOLUME,       // value
+    PLAY_MUSIC,             // a = MusicTrack
+    STOP_MUSIC,
+    PAUSE_MUSIC,
+    RESUME_MUSIC,
+    TOGGLE_MUSIC_PAUSE,
+    NEXT_TRACK,
+    SET_MUSIC_SHUFFLE,      // a = enabled
+    SET_MUSIC_LOOP,         // a = enabled
+    PLAY_EVA,               // a = EvaVoice
+    QUEUE_EVA,              // a = EvaVoice
+    PLAY_UNIT,              // a = UnitVoice, b = VoiceFaction
+    STOP_VOICES,
+};
+
+struct AudioCommand {
+    AudioCommandType type;
+    int a;
+    int b;
+    int c;
+    float value;
+};
+
+//=============================================================================
+// Single-Producer / Single-Consumer Ring
+//=============================================================================
+
+/**
+ * Fixed-size ring of AudioCommands. Exactly one thread may Push (the game
+ * thread) and exactly one may Pop (the audio thread); neither ever blocks
+ * or allocates. Each side only writes its own index, and the acquire /
+ * release pair on the indices publishes the command slots between them.
+ */
+template <size_t Capacity>
+class AudioCommandRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    AudioCommandRing() : head_(0), tail_(0) {}
+
+    /// Producer: append a command
+    /// @return false if the ring is full (the command is dropped)
+    bool Push(const AudioCommand& cmd) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        slots_[tail & (Capacity - 1)] = cmd;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: take the oldest command
+    /// @return false if the ring is empty
+    bool Pop(AudioCommand& cmd) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        cmd = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Approximate number of queued commands (exact when called by either side while the other is idle)
+    size_t Size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const { return Size() == 0; }
+
+private:
+    // Indices count up forever; slots are index & (Capacity - 1).
+    // Separate cache lines so producer and consumer don't false-share.
+    alignas(64) std::atomic<size_t> head_;
+    alignas(64) std::atomic<size_t> tail_;
+    alignas(64) AudioCommand slots_[Capacity];
+};
+
+#endif // AUDIO_COMMAND_QUEUE_H
@@ -0,0 +1,77 @@
+// include/game/audio/audio_event_batch.h
+// Per-tick coalescing of positional audio events
+
+#ifndef AUDIO_EVENT_BATCH_H
+#define AUDIO_EVENT_BATCH_H
+
+#include "game/audio/audio_events.h"
+#include "game/audio/sound_effect.h"
+#include <cstdint>
+
+//=============================================================================
+// Coalesced Event
+//=============================================================================
+
+struct CoalescedAudioEvent {
+    AudioEventType type;
+    SoundEffect sfx;
+    int anchor_x;       // Position of the first event; merges are measured from here
+    int anchor_y;
+    int sum_x;          // Summed positions, for the centroid
+    int sum_y;
+    int count;          // Events merged into this entry
+
+    int GetCenterX() const { return sum_x / count; }
+    int GetCenterY() const { return sum_y / count; }
+};
+
+//=============================================================================
+// Audio Event Batch
+//=============================================================================
+
+/**
+ * Collects positional combat events raised during one game tick. Events
+ * with the same type and sound that land within MERGE_RADIUS of an
+ * existing entry are folded into it, so a volley of twenty shells becomes
+ * one louder impact instead of twenty voices fighting for the pool.
+ * Flush() hands each entry out once and empties the batch.
+ */
+class AudioEventBatch {
+public:
+    static constexpr int MAX_ENTRIES = 64;
+    static constexpr int MERGE_RADIUS = 72;     // 3 cells
+    static constexpr float MAX_VOLUME_BOOST = 2.0f;
+
+    AudioEventBatch() : count_(0) {}
+
+    /// Merge an event into the batch
+    /// @return false if it matched nothing and the batch is full
+    bool Add(AudioEventType type, SoundEffect sfx, int world_x, int world_y);
+
+    /// Call fn(const CoalescedAudioEvent&) for each entry, then clear
+    template <typename Fn>
+    void Flush(Fn fn) {
+        // Entries are copied out first so fn may Add() for the next tick
+        int count = count_;
+        CoalescedAudioEvent pending[MAX_ENTRIES];
+        for (int i = 0; i < count; i++) {
+            pending[i] = entries_[i];
+        }
+        count_ = 0;
+        for (int i = 0; i < count; i++) {
+            fn(pending[i]);
+        }
+    }
+
+    void Clear() { count_ = 0; }
+    int GetPendingCount() const { return count_; }
+
+    /// Playback volume for an entry that merged count events
+    static float GetVolumeForCount(int count);
+
+private:
+    CoalescedAudioEvent entries_[MAX_ENTRIES];
+    int count_;
+};
+
+#endif // AUDIO_EVENT_BATCH_H
@@ -92,6 +92,11 @@ void AudioEvents_Init();
 /// Shutdown audio events system
 void AudioEvents_Shutdown();
 
+/// Play the combat sounds queued this tick. Damage, explosion, weapon,
+/// impact and death events of the same kind within a few cells of each
+/// other are merged and played once, louder. Call once per game tick.
+void AudioEvents_FlushTick();
+
 //=============================================================================
 // Combat Event Handlers
 //=============================================================================
@@ -298,4 +303,7 @@ uint32_t AudioEvents_GetTotalTriggered();
 /// Get total events rate-limited this session
 uint32_t AudioEvents_GetTotalRateLimited();
 
+/// Get total events merged into another event's playback this session
+uint32_t AudioEvents_GetTotalCoalesced();
+
 #endif // AUDIO_EVENTS_H
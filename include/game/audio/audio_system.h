@@ -5,10 +5,16 @@
 #ifndef AUDIO_SYSTEM_H
 #define AUDIO_SYSTEM_H
 
+#include "game/audio/audio_command_queue.h"
 #include "game/audio/sound_effect.h"
 #include "game/audio/music_track.h"
 #include "game/audio/voice_event.h"
 #include "platform.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 
 //=============================================================================
 // Audio System Configuration
@@ -35,6 +41,10 @@ struct AudioSystemConfig {
     int sample_rate = 22050;
     int channels = 2;
     int buffer_size = 1024;
+
+    // Run subsystem updates on a dedicated audio thread
+    bool audio_thread = false;
+    int audio_thread_interval_ms = 5;   // Audio thread update period
 };
 
 //=============================================================================
@@ -45,6 +55,8 @@ struct AudioStats {
     // Sounds
     int loaded_sounds;
     int playing_sounds;
+    size_t sound_bytes;         // Decoded PCM resident
+    float sound_hit_rate;       // Plays that found their sound loaded
 
     // Music
     bool music_playing;
@@ -61,12 +73,65 @@ struct AudioStats {
     float music_volume;
     float voice_volume;
     bool muted;
+
+    // Audio thread
+    bool threaded;
+    uint32_t commands_dropped;  // Commands lost to a full queue
+
+    // Mixer (see AudioMixerStats)
+    uint32_t mixer_underruns;   // Streams that ran dry
+    uint32_t mixer_buffers;     // Stream buffers refilled
+    float mixer_buffer_ms;      // Last refill
+    float mixer_buffer_max_ms;  // Longest refill over the last update
+    uint32_t mixer_voices;      // Sound effects in the last mixed block
+    float mixer_mix_ms;         // Last sound effect block
+    float mixer_mix_max_ms;     // Longest sound effect block over the last update
+
+    // Voices and memory
+    uint32_t voices_stolen;     // Stopped for a more important sound
+    uint32_t voices_culled;     // Too far or too quiet to play
+    size_t voice_bytes;         // Decoded EVA/unit voice PCM resident
+    float decode_ms;            // Total time spent decoding audio
+};
+
+//=============================================================================
+// Decode Timing
+//=============================================================================
+
+/// Adds the wall time of its scope to the audio decode total. Safe on
+/// any thread, so asset loader workers can time their decodes too.
+class AudioDecodeTimer {
+public:
+    AudioDecodeTimer() : start_(std::chrono::steady_clock::now()) {}
+    ~AudioDecodeTimer();
+
+    AudioDecodeTimer(const AudioDecodeTimer&) = delete;
+    AudioDecodeTimer& operator=(const AudioDecodeTimer&) = delete;
+
+    /// Decode time recorded so far, in microseconds
+    static uint64_t GetTotalMicros();
+
+private:
+    std::chrono::steady_clock::time_point start_;
 };
 
 //=============================================================================
 // Audio System Class
 //=============================================================================
 
+/**
+ * With config.audio_thread set, SoundManager, MusicPlayer and
+ * VoiceManager are updated on a dedicated audio thread, so music
+ * streaming and EVA timing keep going while a game frame stalls.
+ * Every AudioSystem call becomes a non-blocking push onto a lock-free
+ * command queue that the audio thread drains before each update; calls
+ * that start sounds then return INVALID_PLAY_HANDLE, since the sound
+ * starts later on the audio thread.
+ *
+ * The subsystems belong to the audio thread while it runs. Game-thread
+ * code that must touch them directly (prefetch, asset loader
+ * completions) holds LockState() while it does.
+ */
 class AudioSystem {
 public:
     /// Singleton instance
@@ -96,8 +161,28 @@ public:
     /// - Processes voice queue
     /// - Handles music transitions
     /// - Cleans up finished sounds
+    /// With the audio thread running only the listener is sent from here.
     void Update();
 
+    //=========================================================================
+    // Audio Thread
+    //=========================================================================
+
+    /// Start updating the subsystems on the audio thread
+    void StartThread();
+
+    /// Stop the audio thread after it drains its queue
+    void StopThread();
+
+    /// Check if the audio thread is running
+    bool IsThreaded() const { return thread_.joinable(); }
+
+    /// Hold while calling SoundManager, MusicPlayer or VoiceManager from
+    /// outside the audio thread; uncontended when the thread isn't running
+    std::unique_lock<std::mutex> LockState() const {
+        return std::unique_lock<std::mutex>(state_mutex_);
+    }
+
     //=========================================================================
     // Master Volume Control
     //=========================================================================
@@ -141,7 +226,8 @@ public:
     PlayHandle PlaySound(SoundEffect sfx);
 
     /// Play a sound effect at world position
-    PlayHandle PlaySoundAt(SoundEffect sfx, int world_x, int world_y);
+    /// @param volume Base volume multiplier (final mix volume is capped at 1.0)
+    PlayHandle PlaySoundAt(SoundEffect sfx, int world_x, int world_y, float volume = 1.0f);
 
     /// Play a sound effect at cell position
     PlayHandle PlaySoundAtCell(SoundEffect sfx, int cell_x, int cell_y);
@@ -229,11 +315,39 @@ private:
     AudioSystem(const AudioSystem&) = delete;
     AudioSystem& operator=(const AudioSystem&) = delete;
 
+    static constexpr size_t COMMAND_QUEUE_SIZE = 1024;
+
     AudioSystemConfig config_;
     bool initialized_;
     bool master_muted_;
 
+    // Audio thread
+    AudioCommandRing<COMMAND_QUEUE_SIZE> commands_;
+    std::thread thread_;
+    std::atomic<bool> thread_stop_;
+    mutable std::mutex state_mutex_;    // Held by the audio thread while it updates
+    uint32_t commands_dropped_;
+
+    // Metrics (guarded by state_mutex_)
+    AudioMixerStats mixer_stats_;       // As of the last PublishMetrics()
+    uint64_t published_decode_us_;
+    int listener_x_;                    // Last listener sent to the audio thread
+    int listener_y_;
+
     void ApplyMasterVolume();
+
+    /// Queue a command for the audio thread, or run it now without one
+    /// @return Play handle for sounds started inline, else INVALID_PLAY_HANDLE
+    PlayHandle Dispatch(const AudioCommand& cmd);
+
+    /// Apply a command to the subsystems
+    PlayHandle Execute(const AudioCommand& cmd);
+
+    /// Audio thread body
+    void ThreadMain(int interval_ms);
+
+    /// Read the mixer stats and send the audio metrics to the profiler
+    void PublishMetrics();
 };
 
 //=============================================================================
@@ -5,39 +5,39 @@
 #ifndef EVENT_RATE_LIMITER_H
 #define EVENT_RATE_LIMITER_H
 
+#include "game/coord.h"
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <unordered_map>
+#include <vector>
 
 //=============================================================================
 // Rate Limiter Key Types
 //=============================================================================
 
-/// Key for position-based rate limiting (cell coordinates)
-struct PositionKey {
-    int16_t cell_x;
-    int16_t cell_y;
-
-    bool operator==(const PositionKey& other) const {
-        return cell_x == other.cell_x && cell_y == other.cell_y;
-    }
-};
-
-/// Hash function for PositionKey
-struct PositionKeyHash {
-    size_t operator()(const PositionKey& key) const {
-        return (static_cast<size_t>(key.cell_x) << 16) |
-               static_cast<size_t>(static_cast<uint16_t>(key.cell_y));
-    }
-};
-
 /// Key for object-based rate limiting
 using ObjectKey = uint32_t;  // Object ID or pointer cast
 
+/// Event types below this are rate limited; larger types always fire
+constexpr int RATE_LIMIT_MAX_EVENT_TYPES = 64;
+
+/// Object cooldown slots (power of two)
+constexpr int RATE_LIMIT_OBJECT_SLOTS = 1024;
+
 //=============================================================================
 // Event Rate Limiter
 //=============================================================================
 
 /// Rate limiter for audio events to prevent spam
+///
+/// Nothing here hashes into a node container or allocates after
+/// configuration:
+/// - Cooldowns and global times are flat arrays indexed by event type.
+/// - Position cooldowns keep one timestamp per map cell for each event
+///   type that has one. Cells off the map share the object table.
+/// - Object cooldowns live in a fixed open-addressing table keyed by
+///   (event type, object). A slot whose cooldown has passed is free for
+///   reuse, so entries age out without Cleanup().
 class EventRateLimiter {
 public:
     EventRateLimiter();
@@ -93,14 +93,13 @@ public:
     // Maintenance
     //=========================================================================
 
-    /// Clear old entries to prevent memory growth
-    /// Call periodically (e.g., every few seconds)
-    void Cleanup();
+    /// Entries age out on their own; kept for callers of the old API
+    void Cleanup() {}
 
     /// Reset all rate limiters
     void Reset();
 
-    /// Get number of tracked entries (for debugging)
+    /// Get number of tracked entries (for debugging; scans every table)
     size_t GetTrackedCount() const;
 
 private:
@@ -110,16 +109,40 @@ private:
         uint32_t object_cooldown_ms = 0;
     };
 
+    /// Object table slot; a stamp of 0 marks a slot never used
+    struct ObjectSlot {
+        uint32_t key;
+        uint16_t event_type;
+        uint16_t kind;          // ObjectKind
+        uint32_t stamp;
+    };
+
+    enum ObjectKind : uint16_t {
+        OBJECT_KIND_OBJECT = 0,
+        OBJECT_KIND_CELL,       // Off-map position
+    };
+
+    static constexpr int OBJECT_PROBE_LIMIT = 16;
+
     // Cooldown configurations per event type
-    std::unordered_map<int, CooldownConfig> configs_;
+    std::array<CooldownConfig, RATE_LIMIT_MAX_EVENT_TYPES> configs_;
 
-    // Last fire times
-    std::unordered_map<int, uint32_t> global_times_;
-    std::unordered_map<int, std::unordered_map<PositionKey, uint32_t, PositionKeyHash>> position_times_;
-    std::unordered_map<int, std::unordered_map<ObjectKey, uint32_t>> object_times_;
+    // Last fire times (stamps; 0 = never)
+    std::array<uint32_t, RATE_LIMIT_MAX_EVENT_TYPES> global_times_;
+    std::array<std::vector<uint32_t>, RATE_LIMIT_MAX_EVENT_TYPES> position_grids_;  // MAP_CELL_TOTAL each
+    std::array<ObjectSlot, RATE_LIMIT_OBJECT_SLOTS> object_slots_;
 
     uint32_t GetCurrentTime() const;
-    bool CheckCooldown(uint32_t last_time, uint32_t cooldown_ms) const;
+
+    /// Check a stamp and record now if the cooldown has passed
+    bool TryFire(uint32_t& stamp, uint32_t cooldown_ms, uint32_t now) const;
+
+    /// Check the object table for (event_type, kind, key) and record now if allowed
+    bool TryFireSlot(int event_type, ObjectKind kind, uint32_t key,
+                     uint32_t cooldown_ms, uint32_t now);
+
+    /// Global cooldown check without recording
+    bool GlobalReady(int event_type, uint32_t now) const;
 };
 
 //=============================================================================
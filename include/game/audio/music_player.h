@@ -9,6 +9,9 @@
 #include "platform.h"
 #include <vector>
 #include <cstdint>
+#include <memory>
+
+class AudStream;
 
 //=============================================================================
 // Music Player Configuration
@@ -18,7 +21,9 @@ struct MusicPlayerConfig {
     bool shuffle_enabled = false;   // Random track selection
     bool loop_enabled = true;       // Loop tracks
     bool auto_advance = true;       // Auto-play next track when done
-    float fade_duration_ms = 0.0f;  // Crossfade duration (0 = instant)
+    float fade_duration_ms = 0.0f;  // Fade when switching tracks by hand (0 = instant)
+    float crossfade_ms = 2000.0f;   // Overlap when auto-advancing (0 = gapless cut)
+    float lookahead_ms = 8000.0f;   // Open the next track this long before the end
 };
 
 //=============================================================================
@@ -30,7 +35,8 @@ enum class MusicState : uint8_t {
     PLAYING,        // Music is playing
     PAUSED,         // Music is paused
     FADING_OUT,     // Fading out before stop/switch
-    FADING_IN       // Fading in after switch
+    FADING_IN,      // Fading in after switch
+    CROSSFADING     // Outgoing and incoming tracks overlapping
 };
 
 //=============================================================================
@@ -69,6 +75,10 @@ public:
     /// @param fade If true and fade_duration > 0, fade out first
     void Stop(bool fade = false);
 
+    /// Map a track on the asset loader so the next Play() of it can start
+    /// streaming at once (used while fading out)
+    void PrefetchTrack(MusicTrack track);
+
     /// Pause current music
     void Pause();
 
@@ -94,8 +104,8 @@ public:
     /// Get current playback state
     MusicState GetState() const { return state_; }
 
-    /// Check if music is playing
-    bool IsPlaying() const { return state_ == MusicState::PLAYING; }
+    /// Check if music is playing (including a crossfade into the next track)
+    bool IsPlaying() const { return state_ == MusicState::PLAYING || state_ == MusicState::CROSSFADING; }
 
     /// Check if music is paused
     bool IsPaused() const { return state_ == MusicState::PAUSED; }
@@ -158,6 +168,26 @@ public:
     /// Check if auto-advance is enabled
     bool IsAutoAdvanceEnabled() const { return config_.auto_advance; }
 
+    /// Set how long auto-advanced tracks overlap (0 = back-to-back)
+    void SetCrossfadeDuration(float ms);
+
+    /// Get auto-advance crossfade duration
+    float GetCrossfadeDuration() const { return config_.crossfade_ms; }
+
+    /// Track chosen to follow the current one (NONE until the look-ahead picks it)
+    MusicTrack GetQueuedTrack() const { return next_track_; }
+
+    //=========================================================================
+    // Memory
+    //=========================================================================
+
+    /// PCM queued on open streams plus the decode scratch, in bytes
+    size_t GetResidentBytes() const;
+
+    /// Free what an idle player holds (for MemoryBudget); queued PCM of a
+    /// playing track stays. Returns the bytes actually freed.
+    size_t Release(size_t bytes);
+
     //=========================================================================
     // Per-Frame Update
     //=========================================================================
@@ -188,11 +218,38 @@ private:
     MusicTrack current_track_;
     MusicTrack pending_track_;  // Track to play after fade-out
 
-    SoundHandle sound_handle_;  // Loaded sound data
-    PlayHandle play_handle_;    // Currently playing instance
+    // Tracks are decoded while they play: only STREAM_LEAD_MS of PCM is
+    // queued on the platform stream, topped up each Update(). There are two
+    // decks so the next track can start before the current one has ended.
+    struct MusicDeck {
+        MusicTrack track = MusicTrack::NONE;
+        std::shared_ptr<AudStream> stream;
+        PlayHandle handle = INVALID_PLAY_HANDLE;
+        int32_t capacity = 0;       // Samples queued ahead of playback
+        size_t decoded = 0;         // Samples decoded since the last rewind
+        float gain = 0.0f;          // Fade level, before volume_ and mute
+        bool loop = false;          // Rewind at the end instead of finishing
+        bool finished = false;      // Platform stream told no more is coming
+    };
+
+    MusicDeck decks_[2];
+    int active_deck_;           // Deck holding current_track_
+    std::vector<int16_t> stream_buffer_;    // Decode scratch
+
+    static constexpr int STREAM_LEAD_MS = 300;
+    static constexpr size_t STREAM_CHUNK_SAMPLES = 4096;
+
+    // Background open of the next track
+    MusicTrack prefetch_track_;
+    std::shared_ptr<AudStream> prefetch_stream_;
+    bool prefetch_ready_;       // Open finished (set on the main thread)
+
+    // Auto-advance look-ahead: the track picked to follow current_track_
+    MusicTrack next_track_;
 
     float volume_;
-    float current_volume_;  // For fading
+    float fade_from_;       // Outgoing deck's level when the crossfade began
+    float fade_length_ms_;  // Length of the fade in progress
     bool muted_;
     bool initialized_;
 
@@ -211,14 +268,38 @@ private:
     // Internal Methods
     //=========================================================================
 
-    /// Load a track into memory
-    bool LoadTrack(MusicTrack track);
+    MusicDeck& ActiveDeck() { return decks_[active_deck_]; }
+    MusicDeck& IdleDeck() { return decks_[active_deck_ ^ 1]; }
+
+    /// Open a track for streaming on a deck
+    bool LoadTrack(MusicDeck& deck, MusicTrack track);
+
+    /// Stop and release a deck
+    void UnloadDeck(MusicDeck& deck);
 
-    /// Unload current track
+    /// Unload both decks
     void UnloadTrack();
 
-    /// Actually start playback of loaded track
-    bool StartPlayback(bool loop);
+    /// Actually start playback of a loaded deck
+    bool StartPlayback(MusicDeck& deck, bool loop);
+
+    /// Decode until the deck's platform stream holds STREAM_LEAD_MS
+    void FillStream(MusicDeck& deck);
+
+    /// Milliseconds of the deck's track left to play (decoded or not)
+    float GetRemainingMs(const MusicDeck& deck) const;
+
+    /// Pick and prefetch the next track, and start it when the current one is nearly done
+    void UpdateLookahead();
+
+    /// Start next_track_ on the idle deck and crossfade over fade_ms
+    bool BeginCrossfade(MusicTrack track, float fade_ms);
+
+    /// Make a freshly started track current and record it in the history
+    void OnTrackStarted(MusicTrack track);
+
+    /// Cut a crossfade short: drop the outgoing deck, incoming at full level
+    void FinishCrossfade();
 
     /// Handle track completion
     void OnTrackComplete();
@@ -6,9 +6,10 @@
 #define SOUND_MANAGER_H
 
 #include "game/audio/sound_effect.h"
+#include "game/audio/sound_voice_pool.h"
 #include "platform.h"
+#include <cstddef>
 #include <cstdint>
-#include <vector>
 #include <array>
 
 //=============================================================================
@@ -22,30 +23,38 @@ class AudFile;
 //=============================================================================
 
 struct SoundManagerConfig {
-    int max_concurrent_sounds = 16;       // Max total simultaneous sounds
+    int max_concurrent_sounds = 16;       // Voice pool size (at most SoundVoicePool::MAX_VOICES)
     int max_same_sound = 3;               // Max plays of same sound
     int default_max_distance = 1200;      // Max audible distance in pixels
     float min_audible_volume = 0.05f;     // Volume threshold for culling
-};
-
-//=============================================================================
-// Playing Sound Info
-//=============================================================================
-
-struct PlayingSoundInfo {
-    PlayHandle play_handle;      // Platform play handle
-    SoundEffect sound_id;        // Which sound
-    uint64_t start_time_ms;      // When playback started
-    bool positional;             // Is position-based
-    int world_x;                 // World position X
-    int world_y;                 // World position Y
-    float volume;                // Current volume
+    size_t cache_budget = 8 * 1024 * 1024; // Sound bytes kept resident (0 = unlimited)
+    uint32_t pin_recent_ms = 3 * 60 * 1000; // Sounds played this recently are never evicted
+    bool keep_compressed = true;          // IMA ADPCM sounds stay compressed, decoded as they play
 };
 
 //=============================================================================
 // Sound Manager Class
 //=============================================================================
 
+/**
+ * Sounds load on first play, or ahead of time through Preload() (the
+ * scenario prefetch manifest does this). With config.keep_compressed,
+ * IMA ADPCM sounds are handed to the platform still compressed, a
+ * quarter of their decoded size, and each voice decodes as it plays.
+ * Resident sound data is kept within config.cache_budget bytes; past that the least recently used sounds
+ * are destroyed and decoded again when next needed. Sounds that are
+ * pinned, playing, or played within config.pin_recent_ms are never
+ * evicted, so the budget can be exceeded while they hold it.
+ *
+ * Playing sounds occupy slots in a fixed voice pool. When the pool is
+ * full a new sound takes the slot of the lowest-priority voice if it
+ * outranks it, and is dropped otherwise; see GetVoicePriority().
+ *
+ * Positional voices are also kept in a packed array. Whenever the
+ * listener moves, one pass over it re-attenuates every voice, and stops
+ * those now beyond the max distance. Distance falloff is a table
+ * lookup on squared distance, so neither path takes a square root.
+ */
 class SoundManager {
 public:
     /// Singleton instance
@@ -55,7 +64,7 @@ public:
     // Lifecycle
     //=========================================================================
 
-    /// Initialize sound manager and load all sounds
+    /// Initialize sound manager (sounds load on demand)
     /// @param config Optional configuration
     /// @return true if successful
     bool Initialize(const SoundManagerConfig& config = SoundManagerConfig());
@@ -66,13 +75,44 @@ public:
     /// Check if initialized
     bool IsInitialized() const { return initialized_; }
 
-    /// Load all sound effects from MIX files
-    /// Called automatically by Initialize(), can be called again to reload
+    /// Load every sound effect (tools and tests; the game loads on demand)
+    /// Sounds beyond the cache budget are evicted again as they load
     void LoadAllSounds();
 
     /// Unload all sounds to free memory
     void UnloadAllSounds();
 
+    //=========================================================================
+    // Sound Cache
+    //=========================================================================
+
+    /// Load a sound ahead of its first play
+    /// Decodes on the asset loader when its workers are running
+    /// @param sfx Sound effect to load
+    /// @param pinned If true, the sound is exempt from budget eviction
+    /// @return true if loaded or queued
+    bool Preload(SoundEffect sfx, bool pinned = false);
+
+    /// Pin or unpin a sound (pins also apply to sounds not yet loaded)
+    void Pin(SoundEffect sfx);
+    void Unpin(SoundEffect sfx);
+    bool IsPinned(SoundEffect sfx) const;
+
+    /// Unpin every sound, e.g. before prefetching the next scenario
+    void UnpinAll();
+
+    /// Set the decoded PCM budget in bytes (0 = unlimited)
+    /// Shrinking the budget evicts immediately.
+    void SetCacheBudget(size_t bytes);
+    size_t GetCacheBudget() const { return config_.cache_budget; }
+
+    /// Evict least recently used sounds until within budget
+    void Trim();
+
+    /// Evict least recently used evictable sounds until bytes are freed
+    /// (for MemoryBudget); returns the bytes actually freed
+    size_t Release(size_t bytes);
+
     //=========================================================================
     // Playback
     //=========================================================================
@@ -150,6 +190,10 @@ public:
     /// Call each frame to track camera movement
     void UpdateListenerFromViewport();
 
+    /// Set whether Update() tracks the viewport itself
+    /// Off while the audio thread runs; the game thread sends the listener.
+    void SetFollowViewport(bool follow) { follow_viewport_ = follow; }
+
     //=========================================================================
     // Positional Audio Settings
     //=========================================================================
@@ -160,6 +204,15 @@ public:
     /// Get maximum audible distance
     int GetMaxDistance() const { return max_distance_; }
 
+    /// Cap voices playing at once below the pool size (0 = pool size)
+    /// New sounds past the cap steal or are dropped as if the pool were
+    /// full; voices already playing finish. Set by QualityGovernor.
+    void SetVoiceLimit(int limit) { voice_limit_ = limit > 0 ? limit : 0; }
+    int GetVoiceLimit() const { return voice_limit_; }
+
+    /// Distance attenuation at a world position (0 at or beyond max distance)
+    float CalculateDistanceVolume(int world_x, int world_y) const;
+
     //=========================================================================
     // Per-Frame Update
     //=========================================================================
@@ -175,9 +228,31 @@ public:
     /// Get number of loaded sounds
     int GetLoadedSoundCount() const;
 
+    /// Get decoded PCM bytes held by loaded sounds
+    size_t GetResidentBytes() const { return resident_bytes_; }
+
+    /// Get the fraction of plays that found their sound loaded (0 before any play)
+    float GetHitRate() const;
+
+    /// Get number of sounds evicted since startup
+    uint32_t GetEvictionCount() const { return eviction_count_; }
+
     /// Get number of currently playing sounds
     int GetPlayingSoundCount() const;
 
+    /// Get number of voices stopped to make room for louder or more important sounds
+    uint32_t GetStolenVoiceCount() const { return voices_stolen_; }
+
+    /// Get number of sounds not played, or stopped, for being out of range or inaudible
+    uint32_t GetCulledVoiceCount() const { return voices_culled_; }
+
+    /// Get voice pool priority for a sound at an attenuated volume
+    /// The category sets a floor (UI above SPECIAL above COMBAT above UNIT
+    /// above AMBIENT) and the sound's own priority scales with volume.
+    /// @param sfx Sound effect
+    /// @param volume Base volume after distance attenuation (0.0-1.0)
+    static uint8_t GetVoicePriority(SoundEffect sfx, float volume);
+
     /// Check if a specific sound is loaded
     bool IsSoundLoaded(SoundEffect sfx) const;
 
@@ -198,12 +273,17 @@ private:
     struct LoadedSound {
         SoundHandle platform_handle;    // Platform sound handle
         bool loaded;                    // Successfully loaded
+        bool pending;                   // Queued on the asset loader
+        bool pinned;                    // Exempt from budget eviction
+        bool played;                    // last_play_time is valid
         uint64_t last_play_time;        // Last time this sound was played
+        uint64_t last_use;              // Value of use_clock_ at last load or play
+        size_t pcm_bytes;               // Resident size while loaded (compressed or PCM)
         int current_play_count;         // How many currently playing
     };
 
     std::array<LoadedSound, static_cast<size_t>(SoundEffect::COUNT)> sounds_;
-    std::vector<PlayingSoundInfo> playing_sounds_;
+    SoundVoicePool voices_;
 
     // Configuration
     SoundManagerConfig config_;
@@ -217,10 +297,36 @@ private:
     int listener_x_;
     int listener_y_;
     int max_distance_;
+    bool follow_viewport_;
+
+    // Positional voices, packed for the spatial pass
+    struct SpatialVoice {
+        int world_x;
+        int world_y;
+        float mix_volume;       // Final volume before distance attenuation
+        float base_volume;      // Caller's volume, for voice priority
+        int slot;               // Voice pool slot
+    };
+    std::array<SpatialVoice, SoundVoicePool::MAX_VOICES> spatial_;
+    std::array<int8_t, SoundVoicePool::MAX_VOICES> spatial_index_;  // Slot -> spatial_ entry
+    int spatial_count_;
+    int64_t max_distance_sq_;
+    float falloff_scale_;       // Squared distance -> falloff table index
 
     // State
     bool initialized_;
     uint64_t current_time_;
+    uint32_t load_generation_;  // Bumped by UnloadAllSounds()
+
+    // Cache accounting
+    size_t resident_bytes_;
+    uint64_t use_clock_;
+    uint32_t cache_hits_;
+    uint32_t cache_misses_;
+    uint32_t eviction_count_;
+    uint32_t voices_stolen_;
+    uint32_t voices_culled_;
+    int voice_limit_;
 
     //=========================================================================
     // Internal Methods
@@ -229,13 +335,61 @@ private:
     /// Load a single sound effect
     bool LoadSound(SoundEffect sfx);
 
-    /// Calculate volume based on distance
-    float CalculateDistanceVolume(int world_x, int world_y) const;
+    /// Create a platform sound that stays IMA ADPCM
+    /// @return false if the file is missing or in another format
+    bool LoadCompressed(int idx, const char* filename);
+
+    /// Record a loaded platform sound and enforce the budget around it
+    void AdoptSound(int idx, SoundHandle handle, size_t pcm_bytes);
+
+    /// Find a sound to play, loading it on a miss
+    /// @return false if the sound can't be loaded
+    bool AcquireSound(int idx);
+
+    /// Destroy a loaded sound's platform data
+    void ReleaseSound(int idx);
+
+    /// Evict least recently used sounds until within budget
+    void EnforceBudget(int keep);
+    size_t EvictTo(size_t limit, int keep);
 
-    /// Check if sound can play (rate limiting, concurrent limits)
+    /// Check if a sound may be evicted
+    bool IsEvictable(const LoadedSound& sound) const;
+
+    /// Decode a sound effect on the asset loader; the platform sound is
+    /// created on the main thread when the loader is pumped
+    bool LoadSoundAsync(SoundEffect sfx);
+
+    /// Check if sound can play (rate limiting, per-sound concurrent limit)
     bool CanPlaySound(SoundEffect sfx) const;
 
-    /// Clean up finished sounds from playing list
+    /// Check the voice pool has room for a sound of this priority
+    /// @param steal Set to the voice to stop first, or -1 if a slot is free
+    /// @return false if the sound should be dropped
+    bool ReserveVoice(uint8_t priority, int& steal) const;
+
+    /// Start a loaded sound on the platform and record it in the pool
+    /// @param steal Voice to stop first (-1 for none)
+    /// @return Pool slot of the new voice, or -1 if the platform refused it
+    int StartVoice(int idx, int steal, float volume, float pan,
+                          bool positional, int world_x, int world_y, uint8_t priority);
+
+    /// Forget a pool voice and drop its sound's play count
+    void ReleaseVoice(int slot);
+
+    /// Record a sound dropped or stopped for being out of range or inaudible
+    void CountCulledVoice();
+
+    /// Squared distance from the listener
+    int64_t DistanceSquared(int world_x, int world_y) const;
+
+    /// Attenuation for a squared distance inside max distance
+    float FalloffForDistanceSquared(int64_t dist_sq) const;
+
+    /// Re-attenuate every positional voice after the listener or range changes
+    void UpdateSpatialVoices();
+
+    /// Release voices whose platform playback has finished
     void CleanupFinishedSounds();
 
     /// Get final volume for a sound
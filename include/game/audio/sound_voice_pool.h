@@ -0,0 +1,103 @@
+// include/game/audio/sound_voice_pool.h
+// Fixed-size pool of sound effect voices with priority stealing
+
+#ifndef SOUND_VOICE_POOL_H
+#define SOUND_VOICE_POOL_H
+
+#include "game/audio/sound_effect.h"
+#include "platform.h"
+#include <array>
+#include <cstdint>
+
+//=============================================================================
+// Playing Sound Info
+//=============================================================================
+
+struct PlayingSoundInfo {
+    PlayHandle play_handle;      // Platform play handle
+    SoundEffect sound_id;        // Which sound
+    uint64_t start_time_ms;      // When playback started
+    bool positional;             // Is position-based
+    int world_x;                 // World position X
+    int world_y;                 // World position Y
+    float volume;                // Current volume
+};
+
+//=============================================================================
+// Sound Voice Pool
+//=============================================================================
+
+/**
+ * Slots for the sound effects currently playing. Every active voice sits
+ * in one of 256 priority buckets, and a bitmap of non-empty buckets finds
+ * the lowest-priority voice with a few bit scans, so stealing costs the
+ * same however many voices are playing. Within a bucket voices are kept
+ * oldest first and the oldest is stolen.
+ */
+class SoundVoicePool {
+public:
+    static constexpr int MAX_VOICES = 64;
+
+    SoundVoicePool();
+
+    /// Drop every voice and set how many slots may be used (clamped to MAX_VOICES)
+    void Reset(int capacity);
+
+    int GetCapacity() const { return capacity_; }
+    int GetActiveCount() const { return active_count_; }
+    bool IsFull() const { return active_count_ >= capacity_; }
+
+    /// Claim a free slot for a voice
+    /// @return Slot index, or -1 if every slot is in use
+    int Allocate(const PlayingSoundInfo& info, uint8_t priority);
+
+    /// Return a slot to the free list
+    void Release(int slot);
+
+    /// Lowest-priority active voice, oldest first on ties
+    /// @return Slot index, or -1 if no voice is active
+    int FindLowest() const;
+
+    /// Find the slot playing a handle (-1 if none)
+    int Find(PlayHandle handle) const;
+
+    /// Move a voice to a new priority bucket (as the newest voice in it)
+    void SetPriority(int slot, uint8_t priority);
+
+    bool IsActive(int slot) const { return slot >= 0 && slot < MAX_VOICES && slots_[slot].active; }
+    uint8_t GetPriority(int slot) const { return slots_[slot].priority; }
+    PlayingSoundInfo& Get(int slot) { return slots_[slot].info; }
+    const PlayingSoundInfo& Get(int slot) const { return slots_[slot].info; }
+
+    /// Call fn(slot) for each active voice; fn may Release() the slot it is given
+    template <typename Fn>
+    void ForEachActive(Fn fn) {
+        for (int i = 0; i < capacity_; i++) {
+            if (slots_[i].active) {
+                fn(i);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        PlayingSoundInfo info;
+        uint8_t priority;
+        bool active;
+        int8_t prev;    // Bucket list links, or free list link in next
+        int8_t next;
+    };
+
+    void Link(int slot, uint8_t priority);
+    void Unlink(int slot);
+
+    std::array<Slot, MAX_VOICES> slots_;
+    std::array<int8_t, 256> bucket_head_;   // Oldest voice at each priority
+    std::array<int8_t, 256> bucket_tail_;   // Newest voice at each priority
+    uint64_t bucket_bits_[4];               // Non-empty buckets
+    int8_t free_head_;
+    int capacity_;
+    int active_count_;
+};
+
+#endif // SOUND_VOICE_POOL_H
@@ -154,6 +154,15 @@ enum class VoiceFaction : uint8_t {
     SOVIET      // Soviet/Russian voices
 };
 
+static constexpr int VOICE_FACTION_COUNT = 3;
+
+/// Bit for a faction in a faction mask
+inline uint8_t VoiceFactionBit(VoiceFaction faction) {
+    return static_cast<uint8_t>(1u << static_cast<int>(faction));
+}
+
+static constexpr uint8_t VOICE_FACTION_MASK_ALL = (1u << VOICE_FACTION_COUNT) - 1;
+
 //=============================================================================
 // Voice Info Structures
 //=============================================================================
@@ -7,10 +7,10 @@
 
 #include "game/audio/voice_event.h"
 #include "platform.h"
+#include <array>
+#include <bitset>
 #include <vector>
 #include <queue>
-#include <unordered_map>
-#include <functional>
 #include <cstdint>
 
 //=============================================================================
@@ -45,8 +45,15 @@ public:
     /// Check if initialized
     bool IsInitialized() const { return initialized_; }
 
-    /// Preload common voices for faster playback
-    void PreloadCommonVoices();
+    /// Queue the common EVA lines and the common unit acknowledgements
+    /// for each faction in faction_mask (see VoiceFactionBit) on the
+    /// asset loader, so the first use of each doesn't load on the spot
+    void PreloadCommonVoices(uint8_t faction_mask = VOICE_FACTION_MASK_ALL);
+
+    /// Queue a voice to decode on the asset loader; it becomes playable
+    /// when the loader is pumped. Returns false if it has no file.
+    bool PreloadEvaAsync(EvaVoice voice);
+    bool PreloadUnitAsync(UnitVoice voice, VoiceFaction faction);
 
     //=========================================================================
     // EVA Voice Playback
@@ -57,7 +64,8 @@ public:
     /// @return true if voice started or queued
     bool PlayEva(EvaVoice voice);
 
-    /// Queue an EVA voice (always queues, never interrupts)
+    /// Queue an EVA voice (never interrupts). A line already waiting in
+    /// the queue is not queued again.
     void QueueEva(EvaVoice voice);
 
     /// Stop current EVA voice and clear queue
@@ -125,6 +133,16 @@ public:
     /// Get queue size
     size_t GetQueueSize() const { return eva_queue_.size(); }
 
+    /// EVA lines dropped because the same line was already queued
+    uint32_t GetEvaCollapsedCount() const { return eva_collapsed_; }
+
+    /// Decoded PCM held by loaded EVA and unit voices, in bytes
+    size_t GetResidentBytes() const;
+
+    /// Check if a voice is decoded and ready to play without loading
+    bool IsEvaLoaded(EvaVoice voice) const;
+    bool IsUnitLoaded(UnitVoice voice, VoiceFaction faction) const;
+
 private:
     VoiceManager();
     ~VoiceManager();
@@ -136,40 +154,57 @@ private:
     //=========================================================================
 
     struct LoadedVoice {
-        SoundHandle handle;
-        bool loaded;
+        SoundHandle handle = INVALID_SOUND_HANDLE;
+        size_t pcm_bytes = 0;   // Decoded size, while loaded
+        bool loaded = false;
+        bool pending = false;   // Queued on the asset loader
+    };
+
+    // Higher priority first, then oldest first
+    struct QueuedVoiceLess {
+        bool operator()(const QueuedVoice& a, const QueuedVoice& b) const {
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            return a.queue_time > b.queue_time;
+        }
     };
 
+    static constexpr int EVA_VOICE_COUNT = static_cast<int>(EvaVoice::COUNT);
+    static constexpr int UNIT_VOICE_COUNT = static_cast<int>(UnitVoice::COUNT);
+    static constexpr uint64_t NEVER_PLAYED = UINT64_MAX;
+
     //=========================================================================
     // Internal Data
     //=========================================================================
 
-    // EVA voice data
-    std::unordered_map<int, LoadedVoice> eva_voices_;
-    std::priority_queue<QueuedVoice,
-                        std::vector<QueuedVoice>,
-                        std::function<bool(const QueuedVoice&, const QueuedVoice&)>> eva_queue_;
+    // EVA voice data, indexed by EvaVoice
+    std::array<LoadedVoice, EVA_VOICE_COUNT> eva_voices_;
+    std::priority_queue<QueuedVoice, std::vector<QueuedVoice>, QueuedVoiceLess> eva_queue_;
+    std::bitset<EVA_VOICE_COUNT> eva_queued_;   // Lines currently in eva_queue_
+    uint32_t eva_collapsed_;
     PlayHandle eva_play_handle_;
     EvaVoice current_eva_;
     uint64_t eva_last_play_time_;
 
-    // Rate limiting for EVA voices
-    std::unordered_map<int, uint64_t> eva_last_played_;
+    // Rate limiting for EVA voices (NEVER_PLAYED until first play)
+    std::array<uint64_t, EVA_VOICE_COUNT> eva_last_played_;
 
-    // Unit voice data
-    std::unordered_map<int, LoadedVoice> unit_voices_;
+    // Unit voice data, indexed by [VoiceFaction][UnitVoice]
+    std::array<std::array<LoadedVoice, UNIT_VOICE_COUNT>, VOICE_FACTION_COUNT> unit_voices_;
     PlayHandle unit_play_handle_;
     UnitVoice current_unit_;
     uint64_t unit_last_play_time_;
 
     // Rate limiting for unit voices
-    std::unordered_map<int, uint64_t> unit_last_played_;
+    std::array<uint64_t, UNIT_VOICE_COUNT> unit_last_played_;
 
     // Settings
     float volume_;
     bool muted_;
     bool initialized_;
     uint64_t current_time_;
+    uint32_t load_generation_;  // Bumped by Shutdown()
 
     //=========================================================================
     // Internal Methods
@@ -181,6 +216,15 @@ private:
     /// Load a unit voice file
     bool LoadUnitVoice(UnitVoice voice, VoiceFaction faction);
 
+    /// Load a voice file synchronously into a table entry
+    bool LoadVoice(LoadedVoice& entry, const char* filename);
+
+    /// Queue a voice decode into a table entry
+    bool QueueVoiceLoad(LoadedVoice& entry, const char* filename);
+
+    /// Release every loaded voice and reset the tables
+    void ResetVoiceTables();
+
     /// Get sound handle for EVA voice (loading if needed)
     SoundHandle GetEvaSound(EvaVoice voice);
 
@@ -199,8 +243,9 @@ private:
     /// Check if unit voice can play (rate limiting)
     bool CanPlayUnit(UnitVoice voice) const;
 
-    /// Get unique key for voice+faction
-    int GetUnitVoiceKey(UnitVoice voice, VoiceFaction faction) const;
+    /// Table entries (nullptr for out-of-range ids)
+    LoadedVoice* GetEvaEntry(EvaVoice voice);
+    LoadedVoice* GetUnitEntry(UnitVoice voice, VoiceFaction faction);
 };
 
 //=============================================================================
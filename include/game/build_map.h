@@ -0,0 +1,161 @@
+/**
+ * BuildMap - Where each house may place buildings, as bitplanes
+ *
+ * A building may go where every cell of its footprint is buildable land
+ * inside the map bounds, free of buildings and ground units, and at least
+ * one cell touches (or is one cell from) a building of the same house.
+ * Checking that cell by cell for every footprint cell, each frame the
+ * placement cursor moves and for every cell the AI considers, is a lot of
+ * repeated work. Instead the map keeps, like VisionMap, one bit per cell
+ * with 128 bits (two 64-bit words) per row:
+ *
+ *   - free         buildable, in bounds, no building footprint, no unit
+ *   - near[house]  within one cell of one of the house's buildings
+ *
+ * Both are kept up to date as things change rather than worked out when
+ * asked: MapClass reports land and occupancy changes cell by cell, and
+ * whoever places or removes a building reports it (Building_Added /
+ * Building_Removed), as with HouseEconomy. A house that lost a building
+ * has its near plane rebuilt on its next query by OR-ing in the grown
+ * footprint (FootprintMask::near) of each building it still has.
+ *
+ * Can_Place is then a row mask shifted into place and AND-ed with a word
+ * or two per footprint row, and Legal_Placements finds every legal
+ * top-left cell on the map with whole-row shifts and ANDs, 128 cells at a
+ * time.
+ *
+ * Original location: CODE/DISPLAY.CPP (Passes_Proximity_Check),
+ *                    CODE/CELL.CPP (Is_Clear_To_Build)
+ */
+
+#pragma once
+
+#include "game/cell.h"
+#include "game/coord.h"
+#include "game/house.h"
+#include "game/types/buildingtype.h"
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// BuildMap
+// =============================================================================
+
+class BuildMap {
+public:
+    /**
+     * 64-bit words per map row
+     */
+    static constexpr int ROW_WORDS = MAP_CELL_WIDTH / 64;
+    static constexpr int PLANE_WORDS = ROW_WORDS * MAP_CELL_HEIGHT;
+
+    /**
+     * Can a building stand on this land?
+     */
+    static bool Is_Buildable_Land(LandType land) { return land == LAND_CLEAR || land == LAND_ROAD; }
+
+    BuildMap();
+
+    /**
+     * Forget every building and unit; all land buildable, whole map in bounds
+     */
+    void Clear();
+
+    // -------------------------------------------------------------------------
+    // Reporting
+    // -------------------------------------------------------------------------
+
+    /**
+     * A cell's land type changed
+     */
+    void Land_Changed(int x, int y, LandType land);
+
+    /**
+     * Whether a cell holds a ground techno changed (CellClass::Is_Clear_To_Build)
+     */
+    void Occupied_Changed(int x, int y, bool occupied);
+
+    /**
+     * The playable part of the map changed
+     */
+    void Set_Bounds(int x, int y, int w, int h);
+
+    /**
+     * A building of this type now stands with its top-left cell at cell
+     */
+    void Building_Added(HousesType house, BuildingType type, CELL cell);
+
+    /**
+     * A building reported by Building_Added is gone
+     */
+    void Building_Removed(HousesType house, BuildingType type, CELL cell);
+
+    // -------------------------------------------------------------------------
+    // Queries
+    // -------------------------------------------------------------------------
+
+    /**
+     * Can house place a building of this type with its top-left cell at (x, y)?
+     */
+    bool Can_Place(HousesType house, BuildingType type, int x, int y);
+
+    /**
+     * Every top-left cell a building of this type could go for house
+     *
+     * @param out PLANE_WORDS words, one bit per cell as in Get_Free()
+     * @return Number of legal cells
+     */
+    int Legal_Placements(HousesType house, BuildingType type, uint64_t* out);
+
+    /**
+     * Legal top-left cell nearest to a cell
+     *
+     * @return CELL_NONE if the house can place the building nowhere
+     */
+    CELL Find_Placement(HousesType house, BuildingType type, CELL near);
+
+    bool Is_Free(int x, int y) const { return Test(free_, x, y); }
+    bool Is_Near(HousesType house, int x, int y);
+
+    /**
+     * Planes (PLANE_WORDS words, row-major, bit x%64 of word x/64)
+     */
+    const uint64_t* Get_Free() const { return free_; }
+    const uint64_t* Get_Near(HousesType house);
+
+    int Building_Count(HousesType house) const {
+        return Is_House(house) ? static_cast<int>(buildings_[house].size()) : 0;
+    }
+
+private:
+    struct Placed {
+        CELL cell;
+        BuildingType type;
+    };
+
+    static bool Is_House(HousesType house) { return house >= 0 && house < HOUSE_COUNT; }
+    static bool Is_XY(int x, int y) { return x >= 0 && x < MAP_CELL_WIDTH && y >= 0 && y < MAP_CELL_HEIGHT; }
+    static bool Test(const uint64_t* plane, int x, int y);
+    static void Set(uint64_t* plane, int x, int y, bool value);
+
+    // Bits [x, x + 8) of a plane row; cells past either edge read as 0
+    static uint64_t Row_Bits(const uint64_t* plane, int x, int y);
+
+    // OR an 8-bit row mask into a plane row at x (x may be negative)
+    static void Or_Row(uint64_t* plane, int x, int y, uint8_t bits);
+
+    void Refresh(int x, int y);
+    void Add_Footprint(BuildingType type, CELL cell, int delta);
+    void Or_Near(uint64_t* plane, BuildingType type, CELL cell) const;
+    void Rebuild_Near(HousesType house);
+
+    uint64_t free_[PLANE_WORDS];
+    uint64_t land_[PLANE_WORDS];                // Buildable land
+    uint64_t bounds_[PLANE_WORDS];              // Inside the map bounds
+    uint64_t occupied_[PLANE_WORDS];            // Ground techno in the cell
+    uint8_t footprint_[MAP_CELL_TOTAL];         // Buildings covering each cell
+
+    uint64_t near_[HOUSE_COUNT][PLANE_WORDS];
+    std::vector<Placed> buildings_[HOUSE_COUNT];
+    uint32_t dirty_;                            // Houses whose near plane is stale
+};
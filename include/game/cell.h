@@ -23,6 +23,47 @@ class TechnoClass;
 // Maximum objects that can occupy a single cell
 constexpr int CELL_MAX_OBJECTS = 4;
 
+// =============================================================================
+// Occupancy
+// =============================================================================
+
+/**
+ * CellSpot - Where infantry stand within a cell
+ *
+ * Up to five infantry share a cell: one in the center and one in each
+ * quarter.
+ */
+enum CellSpot : int8_t {
+    SPOT_NONE = -1,
+    SPOT_CENTER = 0,
+    SPOT_NW = 1,
+    SPOT_NE = 2,
+    SPOT_SW = 3,
+    SPOT_SE = 4,
+
+    SPOT_COUNT = 5
+};
+
+/**
+ * CellOccupy - Occupancy bits kept per cell
+ *
+ * Kept up to date by Add_Object / Remove_Object so movement and placement
+ * checks are bit tests rather than scans of the cell's objects.
+ */
+enum CellOccupy : uint8_t {
+    OCCUPY_CENTER = (1 << SPOT_CENTER),     // Infantry spots
+    OCCUPY_NW = (1 << SPOT_NW),
+    OCCUPY_NE = (1 << SPOT_NE),
+    OCCUPY_SW = (1 << SPOT_SW),
+    OCCUPY_SE = (1 << SPOT_SE),
+    OCCUPY_VEHICLE = (1 << 5),              // Unit or vessel
+    OCCUPY_BUILDING = (1 << 6),
+    OCCUPY_AIRCRAFT = (1 << 7),             // Aircraft on the ground
+
+    OCCUPY_INFANTRY = OCCUPY_CENTER | OCCUPY_NW | OCCUPY_NE | OCCUPY_SW | OCCUPY_SE,
+    OCCUPY_SOLID = OCCUPY_VEHICLE | OCCUPY_BUILDING,
+};
+
 // Special template values (prefixed CELL_ to avoid collision with TemplateType enum)
 constexpr uint8_t CELL_TEMPLATE_NONE = 0xFF;
 constexpr uint8_t CELL_TEMPLATE_CLEAR = 0;
@@ -215,6 +256,19 @@ public:
      */
     void Reduce_Tiberium(int amount);
 
+    /**
+     * Load_Terrain - Set template and overlay without reporting the change
+     *
+     * For whole-map loads; the caller resyncs the map's layers once
+     * afterwards (MapClass::Load_Cells).
+     */
+    void Load_Terrain(uint8_t template_type, uint8_t icon, OverlayType overlay, uint8_t data);
+
+    /**
+     * Load_Visibility - Set fog state without reporting the change
+     */
+    void Load_Visibility(CellVisibility vis) { visibility_ = vis; }
+
     // -------------------------------------------------------------------------
     // Land Type
     // -------------------------------------------------------------------------
@@ -237,6 +291,13 @@ public:
      */
     bool Is_Passable(bool is_naval = false, bool is_infantry = false) const;
 
+    /**
+     * Can unit type pass a cell of the given land type?
+     *
+     * Same rules as Is_Passable(), for callers reading MapClass layers.
+     */
+    static bool Is_Land_Passable(LandType land, bool is_naval = false, bool is_infantry = false);
+
     /**
      * Get movement speed multiplier (100 = normal)
      */
@@ -250,7 +311,7 @@ public:
      * Get/set visibility state
      */
     CellVisibility Get_Visibility() const { return visibility_; }
-    void Set_Visibility(CellVisibility vis) { visibility_ = vis; }
+    void Set_Visibility(CellVisibility vis);
 
     bool Is_Shrouded() const { return visibility_ == CELL_SHROUD; }
     bool Is_Explored() const { return visibility_ >= CELL_EXPLORED; }
@@ -279,8 +340,10 @@ public:
 
     /**
      * Remove object from this cell
+     *
+     * @return true if the object was in this cell
      */
-    void Remove_Object(ObjectClass* obj);
+    bool Remove_Object(ObjectClass* obj);
 
     /**
      * Get object at index (0-3)
@@ -295,18 +358,67 @@ public:
     /**
      * Count objects in cell
      */
-    int Object_Count() const;
+    int Object_Count() const { return object_count_; }
 
     /**
      * Is cell occupied?
      */
-    bool Is_Occupied() const { return objects_[0] != nullptr; }
+    bool Is_Occupied() const { return object_count_ != 0; }
 
     /**
      * Find techno (unit/building) in cell
      */
     TechnoClass* Find_Techno() const;
 
+    /**
+     * OCCUPY_* bits of the technos in this cell
+     *
+     * Objects that didn't fit the cell (see MapClass::Occupy_Cell) aren't
+     * counted, nor are bullets, animations and terrain.
+     */
+    uint8_t Get_Occupancy() const { return occupancy_; }
+
+    bool Is_Spot_Free(CellSpot spot) const {
+        return spot >= 0 && spot < SPOT_COUNT && !(occupancy_ & (1 << spot)) &&
+               !(occupancy_ & OCCUPY_SOLID);
+    }
+
+    /**
+     * Can a unit of this kind move in?
+     *
+     * Infantry need a free spot and no vehicle or building; anything else
+     * needs the cell empty of ground technos.
+     */
+    bool Is_Clear_To_Enter(bool is_infantry) const {
+        if (is_infantry) {
+            return !(occupancy_ & OCCUPY_SOLID) && (occupancy_ & OCCUPY_INFANTRY) != OCCUPY_INFANTRY;
+        }
+        return !(occupancy_ & (OCCUPY_SOLID | OCCUPY_INFANTRY));
+    }
+
+    /**
+     * Can a building be placed here?
+     */
+    bool Is_Clear_To_Build() const { return occupancy_ == 0; }
+
+    /**
+     * Free infantry spot nearest a coordinate in this cell
+     *
+     * @return SPOT_NONE if the cell holds a vehicle or building, or all
+     *         five spots are taken
+     */
+    CellSpot Closest_Free_Spot(COORDINATE coord) const;
+
+    /**
+     * Spot nearest a coordinate's position within its cell
+     */
+    static CellSpot Coord_Spot(COORDINATE coord);
+
+    /**
+     * Coordinate of a spot in a cell
+     */
+    static COORDINATE Spot_Coord(CELL cell, CellSpot spot);
+
     // -------------------------------------------------------------------------
     // Flags
     // -------------------------------------------------------------------------
@@ -315,7 +427,7 @@ public:
      * Various cell flags
      */
     bool Is_Bridge() const { return is_bridge_; }
-    void Set_Bridge(bool val) { is_bridge_ = val; }
+    void Set_Bridge(bool val);
 
     bool Is_Waypoint() const { return is_waypoint_; }
     void Set_Waypoint(bool val) { is_waypoint_ = val; }
@@ -335,6 +447,16 @@ public:
     void Recalc();
 
 private:
+    /**
+     * Flag_Changed - Tell the map this cell needs redrawing
+     */
+    void Flag_Changed();
+
+    /**
+     * Occupancy bit and techno slot of one object, folded into the cell
+     */
+    void Occupy(const ObjectClass* obj, int slot);
+
     // -------------------------------------------------------------------------
     // Data Members
     // -------------------------------------------------------------------------
@@ -362,7 +484,10 @@ private:
     bool is_flag_;              // Capture the flag
 
     // Occupancy
-    ObjectClass* objects_[CELL_MAX_OBJECTS]; // Objects in this cell
+    ObjectClass* objects_[CELL_MAX_OBJECTS]; // Objects in this cell, packed
+    uint8_t object_count_;      // Slots in use
+    uint8_t occupancy_;         // OCCUPY_* bits
+    int8_t techno_slot_;        // First techno in objects_, -1 if none
 };
 
 // =============================================================================
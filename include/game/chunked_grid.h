@@ -0,0 +1,215 @@
+/**
+ * ChunkedGrid - Per-cell storage for maps of any size, allocated by chunk
+ *
+ * The per-cell arrays sized for MAP_CELL_WIDTH x MAP_CELL_HEIGHT cost
+ * the full map whether a scenario uses it or not, and a 256x256 map
+ * would make every one of them four times larger. A ChunkedGrid splits
+ * the map into CHUNK_SIZE x CHUNK_SIZE cell chunks and allocates a chunk
+ * only when a cell in it is first written. Reading a cell of a missing
+ * chunk gives the empty value the grid was made with.
+ *
+ * Passes that only care about content (growth, object ticks, redraws)
+ * use For_Each_Chunk(), which visits the allocated chunks and skips the
+ * empty space around a small play area entirely.
+ *
+ * Cells within a chunk are row-major, so a chunk is 32 rows of 32 cells
+ * and neighbours in both directions stay within a few cache lines.
+ *
+ * Usage:
+ *   ChunkedGrid<uint8_t> overlay(256, 256, OVERLAY_NONE);
+ *   overlay.Touch(x, y) = OVERLAY_GOLD1;
+ *   uint8_t o = overlay.Get(XY_Wide_Cell(x, y));
+ *   overlay.For_Each_Chunk([](int x0, int y0, uint8_t* cells) { ... });
+ */
+
+#ifndef GAME_CHUNKED_GRID_H
+#define GAME_CHUNKED_GRID_H
+
+#include "game/coord.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+constexpr int CHUNK_SHIFT = 5;
+constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;                // 32x32 cells
+constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+// Largest map a ChunkedGrid (and WIDE_CELL) is meant for
+constexpr int MAP_MAX_CELL_WIDTH = 256;
+constexpr int MAP_MAX_CELL_HEIGHT = 256;
+
+template <typename T>
+class ChunkedGrid {
+public:
+    explicit ChunkedGrid(int width = MAP_CELL_WIDTH, int height = MAP_CELL_HEIGHT, const T& empty = T())
+        : empty_(empty) {
+        Resize(width, height);
+    }
+
+    /**
+     * Change the size; every chunk is dropped
+     */
+    void Resize(int width, int height) {
+        width_ = width > 0 ? width : 0;
+        height_ = height > 0 ? height : 0;
+        chunks_x_ = (width_ + CHUNK_MASK) >> CHUNK_SHIFT;
+        chunks_y_ = (height_ + CHUNK_MASK) >> CHUNK_SHIFT;
+        chunks_.clear();
+        chunks_.resize(static_cast<size_t>(chunks_x_) * chunks_y_);
+        allocated_ = 0;
+    }
+
+    /**
+     * Drop every chunk, so every cell reads empty again
+     */
+    void Clear() {
+        for (auto& chunk : chunks_) {
+            chunk.reset();
+        }
+        allocated_ = 0;
+    }
+
+    int Width() const { return width_; }
+    int Height() const { return height_; }
+
+    bool Is_Valid(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+
+    // =========================================================================
+    // Cell Access
+    // =========================================================================
+
+    /**
+     * Cell value, or the empty value outside the map or its chunks
+     */
+    const T& Get(int x, int y) const {
+        const T* cell = Cell_At(x, y);
+        return cell ? *cell : empty_;
+    }
+    const T& Get(WIDE_CELL cell) const { return Get(Wide_Cell_X(cell), Wide_Cell_Y(cell)); }
+
+    /**
+     * Cell, or nullptr outside the map or its chunks (allocates nothing)
+     */
+    T* Cell_At(int x, int y) {
+        return const_cast<T*>(static_cast<const ChunkedGrid*>(this)->Cell_At(x, y));
+    }
+    const T* Cell_At(int x, int y) const {
+        if (!Is_Valid(x, y)) {
+            return nullptr;
+        }
+        const std::unique_ptr<T[]>& chunk = chunks_[Chunk_Index(x, y)];
+        return chunk ? &chunk[Offset(x, y)] : nullptr;
+    }
+
+    /**
+     * Cell for writing, allocating its chunk if needed
+     *
+     * (x, y) must be on the map (Is_Valid).
+     */
+    T& Touch(int x, int y) {
+        std::unique_ptr<T[]>& chunk = chunks_[Chunk_Index(x, y)];
+        if (!chunk) {
+            chunk.reset(new T[CHUNK_CELLS]);
+            for (int i = 0; i < CHUNK_CELLS; i++) {
+                chunk[i] = empty_;
+            }
+            allocated_++;
+        }
+        return chunk[Offset(x, y)];
+    }
+    T& Touch(WIDE_CELL cell) { return Touch(Wide_Cell_X(cell), Wide_Cell_Y(cell)); }
+
+    /**
+     * Write a cell; writing the empty value into a missing chunk allocates nothing
+     */
+    void Set(int x, int y, const T& value) {
+        if (!Is_Valid(x, y)) {
+            return;
+        }
+        if (T* cell = Cell_At(x, y)) {
+            *cell = value;
+        } else if (!(value == empty_)) {
+            Touch(x, y) = value;
+        }
+    }
+
+    // =========================================================================
+    // Chunks
+    // =========================================================================
+
+    int Chunks_Wide() const { return chunks_x_; }
+    int Chunks_High() const { return chunks_y_; }
+    int Chunk_Count() const { return static_cast<int>(chunks_.size()); }
+    int Allocated_Chunks() const { return allocated_; }
+
+    bool Has_Chunk(int x, int y) const {
+        return Is_Valid(x, y) && chunks_[Chunk_Index(x, y)] != nullptr;
+    }
+
+    /**
+     * Bytes held by the allocated chunks
+     */
+    size_t Memory_Used() const { return static_cast<size_t>(allocated_) * CHUNK_CELLS * sizeof(T); }
+
+    /**
+     * Drop the chunk holding (x, y); its cells read empty again
+     */
+    void Release_Chunk(int x, int y) {
+        if (Is_Valid(x, y) && chunks_[Chunk_Index(x, y)]) {
+            chunks_[Chunk_Index(x, y)].reset();
+            allocated_--;
+        }
+    }
+
+    /**
+     * Visit every allocated chunk: fn(x0, y0, cells)
+     *
+     * (x0, y0) is the chunk's top-left cell and cells its CHUNK_CELLS
+     * cells, row-major. Cells past the map's right or bottom edge (when
+     * the size is not a multiple of CHUNK_SIZE) are there but unused.
+     */
+    template <typename Fn>
+    void For_Each_Chunk(Fn fn) {
+        for (int cy = 0; cy < chunks_y_; cy++) {
+            for (int cx = 0; cx < chunks_x_; cx++) {
+                std::unique_ptr<T[]>& chunk = chunks_[cy * chunks_x_ + cx];
+                if (chunk) {
+                    fn(cx << CHUNK_SHIFT, cy << CHUNK_SHIFT, chunk.get());
+                }
+            }
+        }
+    }
+
+    template <typename Fn>
+    void For_Each_Chunk(Fn fn) const {
+        for (int cy = 0; cy < chunks_y_; cy++) {
+            for (int cx = 0; cx < chunks_x_; cx++) {
+                const std::unique_ptr<T[]>& chunk = chunks_[cy * chunks_x_ + cx];
+                if (chunk) {
+                    fn(cx << CHUNK_SHIFT, cy << CHUNK_SHIFT, static_cast<const T*>(chunk.get()));
+                }
+            }
+        }
+    }
+
+    /**
+     * Offset of cell (x, y) within its chunk
+     */
+    static int Offset(int x, int y) { return ((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK); }
+
+private:
+    int Chunk_Index(int x, int y) const { return (y >> CHUNK_SHIFT) * chunks_x_ + (x >> CHUNK_SHIFT); }
+
+    std::vector<std::unique_ptr<T[]>> chunks_;  // Row-major, nullptr = empty
+    T empty_;
+    int width_ = 0;
+    int height_ = 0;
+    int chunks_x_ = 0;
+    int chunks_y_ = 0;
+    int allocated_ = 0;
+};
+
+#endif // GAME_CHUNKED_GRID_H
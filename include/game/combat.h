@@ -0,0 +1,124 @@
+/**
+ * CombatSystem - Target acquisition and firing for every techno
+ *
+ * Each tick runs in four phases over the technos, taken in heap order:
+ *
+ *   1. Acquire  - keep a target that can still be attacked, otherwise
+ *                 pick the nearest enemy in weapon range
+ *   2. Intent   - facing toward the target and whether it is in range
+ *   3. Fire     - whether the weapon is armed and on target
+ *   4. Apply    - write targets and facings back, rearm, deal damage
+ *
+ * The first three only read game state and write their own slot of the
+ * result arrays, so they run on the JobSystem. Apply runs on the calling
+ * thread in heap order, which keeps the outcome identical however many
+ * workers there are - lockstep games stay in sync.
+ *
+ * A techno standing still with nothing to shoot at, whose last threat
+ * scan found nothing, does not scan again every tick: it scans again
+ * SCAN_WAIT_MIN to SCAN_WAIT_MIN + SCAN_WAIT_SPREAD - 1 ticks later, the
+ * wait picked by its heap slot so a crowd placed together spreads its
+ * scans over several ticks. The wait is game state (TechnoClass::scan_wait_,
+ * saved with the object) and depends on nothing a peer could see
+ * differently, so lockstep games stay in sync. Technos that are moving
+ * or have just lost a target scan at once.
+ *
+ * Gathering walks the heaps a kind at a time, so the technos form one run
+ * per RTTI. Each phase takes its slice a run at a time and calls the
+ * kind's class directly (ObjectKind), keeping the per-techno queries out
+ * of the vtable.
+ *
+ * Original location: CODE/TECHNO.CPP (Greatest_Threat, Fire_At)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/core/rtti.h"
+#include <cstdint>
+#include <vector>
+
+class ObjectClass;
+class TechnoClass;
+
+// =============================================================================
+// CombatSystem
+// =============================================================================
+
+class CombatSystem {
+public:
+    /**
+     * Technos per job chunk
+     */
+    static constexpr int JOB_GRAIN = 64;
+
+    /**
+     * How far (in DirType steps) the gun may point off target and still fire
+     */
+    static constexpr int AIM_TOLERANCE = 8;
+
+    /**
+     * Ticks an idle techno skips threat scans after one finds nothing
+     */
+    static constexpr int SCAN_WAIT_MIN = 4;
+    static constexpr int SCAN_WAIT_SPREAD = 4;
+
+    struct Stats {
+        uint32_t technos;           // Technos processed
+        uint32_t acquired;          // Targets newly taken
+        uint32_t shots;             // Shots fired
+        uint32_t scans;             // Threat scans run
+    };
+
+    static CombatSystem& Instance();
+
+    CombatSystem() = default;
+
+    CombatSystem(const CombatSystem&) = delete;
+    CombatSystem& operator=(const CombatSystem&) = delete;
+
+    /**
+     * Run one combat tick for every active techno
+     */
+    void Update();
+
+    const Stats& Get_Stats() const { return stats_; }
+    void Reset_Stats() { stats_ = Stats(); }
+
+private:
+    static constexpr int NO_AIM = -1;
+    static constexpr int NO_SCAN = -1;
+
+    void Gather();
+    void Acquire_Targets(int begin, int end);
+    void Plan_Intent(int begin, int end);
+    void Plan_Fire(int begin, int end);
+    void Apply();
+
+    template <typename Fn>
+    void For_Each_Run(int begin, int end, Fn fn) const;
+
+    template <typename T> void Acquire_Run(int begin, int end);
+    template <typename T> void Intent_Run(int begin, int end);
+    template <typename T> void Fire_Run(int begin, int end);
+    template <typename T> void Apply_Run(int begin, int end);
+
+    // Technos [begin, end) are all of one kind
+    struct KindRun {
+        RTTIType rtti;
+        int begin;
+        int end;
+    };
+
+    std::vector<KindRun> runs_;
+
+    // Indexed alike; rebuilt every tick
+    std::vector<TechnoClass*> technos_;
+    std::vector<ObjectClass*> targets_;     // Acquire
+    std::vector<int8_t> scan_wait_;         // Acquire: new scan_wait_, or NO_SCAN
+    std::vector<int16_t> aim_;              // Intent: DirType or NO_AIM
+    std::vector<uint8_t> in_range_;         // Intent
+    std::vector<int> damage_;               // Fire: 0 = hold fire
+
+    Stats stats_ = {};
+};
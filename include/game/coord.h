@@ -45,6 +45,18 @@ typedef uint32_t COORDINATE;
  */
 typedef int16_t CELL;
 
+/**
+ * WIDE_CELL - 32-bit cell index for maps past 128x128
+ *
+ * Format:
+ *   Bits 31-16: Y cell
+ *   Bits 15-0:  X cell
+ *
+ * Used by the storage that follows the map size (ChunkedGrid, VisionMap)
+ * rather than the fixed 128x128 arrays.
+ */
+typedef int32_t WIDE_CELL;
+
 /**
  * LEPTON - Sub-pixel measurement unit
  * 256 leptons = 1 pixel
@@ -83,6 +95,7 @@ constexpr int MAX_COORD_VALUE = MAP_CELL_WIDTH * SUBCELL_PER_CELL;  // 32768
 // Invalid/null values
 constexpr COORDINATE COORD_NONE = 0xFFFFFFFF;
 constexpr CELL CELL_NONE = -1;
+constexpr WIDE_CELL WIDE_CELL_NONE = -1;
 
 // =============================================================================
 // Coordinate Macros (from original DEFINES.H)
@@ -143,6 +156,22 @@ constexpr CELL CELL_NONE = -1;
  */
 #define Cell_Y(cell) ((int)(((cell) >> 8) & 0xFF))
 
+/**
+ * Build wide cell from X and Y cell indices
+ */
+#define XY_Wide_Cell(x, y) ((WIDE_CELL)((((uint32_t)(y)) << 16) | ((uint32_t)(x) & 0xFFFF)))
+
+/**
+ * Extract X / Y from wide cell
+ */
+#define Wide_Cell_X(cell) ((int)((cell) & 0xFFFF))
+#define Wide_Cell_Y(cell) ((int)((((uint32_t)(cell)) >> 16) & 0xFFFF))
+
+/**
+ * Widen a CELL
+ */
+#define Cell_Wide(cell) XY_Wide_Cell(Cell_X(cell), Cell_Y(cell))
+
 /**
  * Convert cell to array index
  */
@@ -180,6 +209,11 @@ int Coord_Distance(COORDINATE coord1, COORDINATE coord2);
  */
 uint8_t Coord_Direction(COORDINATE from, COORDINATE to);
 
+/**
+ * Resolve Coord_Direction for count (from[i], to[i]) pairs into dirs
+ */
+void Coord_Direction_Batch(const COORDINATE* from, const COORDINATE* to, uint8_t* dirs, int count);
+
 /**
  * Move coordinate by distance in given direction
  */
@@ -206,6 +240,13 @@ CELL Adjacent_Cell(CELL cell, int direction);
  */
 COORDINATE Coord_Snap(COORDINATE coord);
 
+/**
+ * Interpolate between two coordinates (t = 0 gives from, t = 1 gives to)
+ * Returns to if either coordinate is COORD_NONE
+ * Float math: for drawing only, never for simulation state
+ */
+COORDINATE Coord_Lerp(COORDINATE from, COORDINATE to, float t);
+
 /**
  * Convert pixel coordinates to world coordinate
  */
@@ -0,0 +1,328 @@
+/**
+ * Containers - Small fixed-footprint containers for hot paths
+ *
+ * The standard containers go to the heap for even one element, which is
+ * wasted work for payloads that are almost always tiny: a selection of a
+ * few units, a shape's file name, a callback that only lives for one
+ * call. These keep such payloads inline:
+ *
+ *   FixedString<N>     NUL-terminated string in a char[N]; longer input
+ *                      is truncated rather than allocated
+ *   SmallVector<T, N>  vector holding up to N elements inline; only
+ *                      growing past N touches the heap
+ *   FunctionRef<Sig>   non-owning reference to a callable; two pointers,
+ *                      never allocates, must not outlive the callable
+ *
+ * Method names follow the standard library so they drop in for
+ * std::string / std::vector / std::function where those were used.
+ *
+ * Usage:
+ *   SmallVector<ObjectClass*, 16> hits;
+ *   hits.push_back(obj);
+ *
+ *   void Visit(FunctionRef<void(int)> fn);
+ *   Visit([&](int i) { total += i; });
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// =============================================================================
+// FixedString
+// =============================================================================
+
+template <size_t N>
+class FixedString {
+    static_assert(N > 0, "FixedString needs room for the terminator");
+
+public:
+    FixedString() { data_[0] = '\0'; }
+    FixedString(const char* text) { assign(text); }
+
+    FixedString& operator=(const char* text) {
+        assign(text);
+        return *this;
+    }
+
+    /**
+     * Copy text, keeping at most N - 1 characters
+     */
+    void assign(const char* text) {
+        size_ = 0;
+        if (text != nullptr) {
+            while (size_ < N - 1 && text[size_] != '\0') {
+                data_[size_] = text[size_];
+                size_++;
+            }
+        }
+        data_[size_] = '\0';
+    }
+
+    void clear() {
+        size_ = 0;
+        data_[0] = '\0';
+    }
+
+    const char* c_str() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_t capacity() { return N - 1; }
+
+    bool operator==(const char* text) const { return text != nullptr && strcmp(data_, text) == 0; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+
+private:
+    char data_[N];
+    size_t size_ = 0;
+};
+
+// =============================================================================
+// SmallVector
+// =============================================================================
+
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline room for one element");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(const SmallVector& other) {
+        reserve(other.size_);
+        std::uninitialized_copy(other.begin(), other.end(), data_);
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        take(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        release();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            std::uninitialized_copy(other.begin(), other.end(), data_);
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    // =========================================================================
+    // Access
+    // =========================================================================
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * True while the elements still fit in the inline storage
+     */
+    bool is_inline() const { return data_ == inline_data(); }
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T& front() { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    // =========================================================================
+    // Modifiers
+    // =========================================================================
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // Build the element first; args may point into our own storage
+            T value(std::forward<Args>(args)...);
+            grow(capacity_ * 2);
+            new (data_ + size_) T(std::move(value));
+        } else {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void pop_back() {
+        data_[--size_].~T();
+    }
+
+    /**
+     * Remove [first, last), keeping order
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        T* dest = data_ + (first - data_);
+        T* src = data_ + (last - data_);
+        T* old_end = end();
+        T* new_end = std::move(src, old_end, dest);
+        for (T* p = new_end; p != old_end; ++p) {
+            p->~T();
+        }
+        size_ -= static_cast<size_t>(old_end - new_end);
+        return dest;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void clear() {
+        for (size_t i = 0; i < size_; i++) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    void reserve(size_t count) {
+        if (count > capacity_) {
+            grow(count);
+        }
+    }
+
+    bool operator==(const SmallVector& other) const {
+        if (size_ != other.size_) return false;
+        for (size_t i = 0; i < size_; i++) {
+            if (!(data_[i] == other.data_[i])) return false;
+        }
+        return true;
+    }
+    bool operator!=(const SmallVector& other) const { return !(*this == other); }
+
+private:
+    T* inline_data() { return reinterpret_cast<T*>(inline_); }
+    const T* inline_data() const { return reinterpret_cast<const T*>(inline_); }
+
+    // Move everything to a heap block of count elements
+    void grow(size_t count) {
+        T* block = static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        for (size_t i = 0; i < size_; i++) {
+            new (block + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        release();
+        data_ = block;
+        capacity_ = count;
+    }
+
+    void release() {
+        if (!is_inline()) {
+            ::operator delete(data_, std::align_val_t(alignof(T)));
+        }
+        data_ = inline_data();
+        capacity_ = N;
+    }
+
+    // Steal other's heap block, or move its inline elements across
+    void take(SmallVector& other) {
+        if (other.is_inline()) {
+            data_ = inline_data();
+            capacity_ = N;
+            for (size_t i = 0; i < other.size_; i++) {
+                new (data_ + i) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.data_ = other.inline_data();
+            other.capacity_ = N;
+            other.size_ = 0;
+        }
+    }
+
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T* data_ = inline_data();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+};
+
+// =============================================================================
+// FunctionRef
+// =============================================================================
+
+template <typename Signature>
+class FunctionRef;
+
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    FunctionRef() = default;
+
+    /**
+     * Refer to a callable; it must outlive every call through this
+     */
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, FunctionRef>::value>::type>
+    FunctionRef(F&& fn) {
+        using Decayed = typename std::decay<F>::type;
+        if constexpr (std::is_pointer<Decayed>::value &&
+                      std::is_function<typename std::remove_pointer<Decayed>::type>::value) {
+            // Function names and pointers are kept by value
+            if (fn == nullptr) {
+                return;
+            }
+            target_.function = reinterpret_cast<void (*)()>(static_cast<Decayed>(fn));
+            invoke_ = [](Target target, Args... args) -> R {
+                return reinterpret_cast<Decayed>(target.function)(std::forward<Args>(args)...);
+            };
+        } else {
+            using Callable = typename std::remove_reference<F>::type;
+            target_.object = static_cast<const void*>(std::addressof(fn));
+            invoke_ = [](Target target, Args... args) -> R {
+                return (*static_cast<Callable*>(const_cast<void*>(target.object)))(std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const {
+        return invoke_(target_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+    union Target {
+        const void* object;
+        void (*function)();
+    };
+
+    Target target_ = {nullptr};
+    R (*invoke_)(Target, Args...) = nullptr;
+};
@@ -18,13 +18,20 @@
 
 #include "game/map.h"
 #include "game/coord.h"
+#include "game/graphics/render_layer.h"
 #include <cstdint>
+#include <memory>
+
+class GraphicsBuffer;
+class RenderSnapshot;
+class RadarRenderer;
 
 // =============================================================================
 // Display Constants
 // =============================================================================
 
-// Tactical display area (within screen)
+// Tactical display area (within screen); One_Time() resizes it to the
+// internal resolution, these are the 640x400 defaults
 constexpr int TACTICAL_X = 0;        // Left edge
 constexpr int TACTICAL_Y = 16;       // Below tab bar
 constexpr int TACTICAL_WIDTH = 640;  // Full width
@@ -70,6 +77,22 @@ public:
     virtual void Init(int theater = THEATER_TEMPERATE) override;
     virtual void Render() override;
 
+    /**
+     * Draw the tactical view and cursor into the back buffer
+     *
+     * Everything Render() does except presenting, so a frame can be drawn
+     * offscreen and timed without waiting on the display.
+     */
+    void Draw_Frame();
+
+    /**
+     * Counts for the last frame drawn, from Prepare_Frame() on
+     *
+     * Terrain tiles and dirty rectangles are what the cache redrew, not
+     * what was visible. frame_time_ms is left for the caller to fill in.
+     */
+    const RenderStats& Get_Frame_Stats() const { return frame_stats_; }
+
     // -------------------------------------------------------------------------
     // Viewport/Tactical Area
     // -------------------------------------------------------------------------
@@ -135,6 +158,17 @@ public:
     bool Is_Scroll_Constrained() const { return scroll_constrained_; }
     void Set_Scroll_Constrained(bool val) { scroll_constrained_ = val; }
 
+    /**
+     * Start decoding the terrain of cells about to scroll into view
+     *
+     * Templates the cells use that are not cached yet are queued on the
+     * AssetLoader at prefetch priority, so the exposed strip draws without
+     * a synchronous template load. Shrouded cells are skipped.
+     *
+     * @return Templates queued
+     */
+    int Prefetch_Cells(int start_x, int start_y, int end_x, int end_y);
+
     // -------------------------------------------------------------------------
     // Coordinate Conversion
     // -------------------------------------------------------------------------
@@ -196,6 +230,39 @@ public:
      */
     void Draw_Cursor();
 
+    // -------------------------------------------------------------------------
+    // Radar
+    // -------------------------------------------------------------------------
+
+    /**
+     * Set radar to receive per-cell invalidations for changed cells
+     */
+    void Set_Radar(RadarRenderer* radar) { radar_ = radar; }
+    RadarRenderer* Get_Radar() const { return radar_; }
+
+    // -------------------------------------------------------------------------
+    // Pipelined Rendering
+    // -------------------------------------------------------------------------
+
+    /**
+     * Draw objects from a snapshot instead of the live cells
+     *
+     * @param snapshot Objects to draw (nullptr for the live cells)
+     * @param alpha Interpolation between each object's previous and current coordinate
+     */
+    void Set_Object_Snapshot(const RenderSnapshot* snapshot, float alpha) {
+        object_snapshot_ = snapshot;
+        snapshot_alpha_ = alpha;
+    }
+
+    /**
+     * Bring the terrain cache up to date ahead of Render()
+     *
+     * Reads the map, so a pipelined game calls it while the simulation
+     * thread is idle; the next Render() then leaves the cells alone.
+     */
+    void Prepare_Frame();
+
 protected:
     // -------------------------------------------------------------------------
     // Rendering (protected)
@@ -207,11 +274,81 @@ protected:
     virtual void Draw_Tactical();
 
     /**
-     * Draw single cell (terrain + overlay)
+     * Draw the snapshot's objects over the tactical view
+     */
+    void Draw_Snapshot_Objects(int scroll_x, int scroll_y);
+
+    /**
+     * Bring the terrain cache up to date with the current scroll position
+     *
+     * Shifts the cached pixels when the view scrolled, then redraws only
+     * the exposed strips and cells flagged through Flag_Cell_Changed().
+     */
+    void Update_Terrain_Cache(int scroll_x, int scroll_y);
+
+    /**
+     * Redraw the terrain of every cell touching a cache-relative rectangle
+     */
+    void Redraw_Terrain_Rect(int x, int y, int w, int h, int scroll_x, int scroll_y);
+
+    /**
+     * Draw the terrain of cells [start_x, end_x) in row cy into Terrain_Target()
+     *
+     * Same layers as Draw_Cell(), but templates are batched through
+     * TileRenderer::DrawTileRun() instead of one call chain per cell.
+     */
+    void Draw_Cell_Row(int cy, int start_x, int end_x, int scroll_x, int scroll_y);
+
+    /**
+     * Darken a drawn cell for fog and the edges of neighbouring shroud
+     *
+     * Shapes come from the precomputed edge frames (shroud_edges.h),
+     * picked by the cell's edge masks in the packed layers.
+     */
+    void Draw_Shroud_Edges(int cx, int cy, int screen_x, int screen_y);
+
+    /**
+     * Redraw flagged cells covered by the terrain cache
+     */
+    void Redraw_Changed_Cells(int scroll_x, int scroll_y);
+
+    /**
+     * Find the cells that sit fully inside a w x h target at this scroll
+     *
+     * Done once per frame; interior cells then skip tile clipping.
+     */
+    void Classify_Interior_Cells(int scroll_x, int scroll_y, int w, int h);
+
+    /**
+     * Draw a cell, using the unclipped tile path when it is interior
+     */
+    void Draw_Cache_Cell(int cx, int cy, int scroll_x, int scroll_y);
+
+    /**
+     * Get the cell range covering a world pixel rectangle (clamped to map)
+     */
+    static void Cells_In_Rect(int world_x, int world_y, int w, int h,
+                              int& start_x, int& start_y, int& end_x, int& end_y);
+
+    /**
+     * Get buffer that terrain layers draw into (cache or screen)
+     */
+    GraphicsBuffer& Terrain_Target();
+
+    /**
+     * Pass this frame's changed cells on to the radar
+     */
+    void Forward_Changed_Cells();
+
+    /**
+     * Draw single cell (terrain + overlay) into Terrain_Target()
+     *
+     * Objects are not drawn here; Draw_Tactical() puts them on top of the
+     * cached terrain every frame.
      *
      * @param cell Cell to draw
-     * @param screen_x Screen X position
-     * @param screen_y Screen Y position
+     * @param screen_x X position within the target buffer
+     * @param screen_y Y position within the target buffer
      */
     virtual void Draw_Cell(CELL cell, int screen_x, int screen_y);
 
@@ -253,6 +390,29 @@ protected:
 
     // Render state
     bool need_full_redraw_;     // Force complete redraw
+
+    // Terrain cache (template, overlay and shroud layers of the tactical view)
+    std::unique_ptr<GraphicsBuffer> terrain_cache_;
+    GraphicsBuffer* terrain_target_; // Set while drawing into the cache
+    int cache_scroll_x_;        // Scroll position the cache was drawn at
+    int cache_scroll_y_;
+    bool cache_valid_;
+
+    // Cells whose tile lies fully inside the cache at this frame's scroll
+    int interior_x0_, interior_y0_;     // Inclusive
+    int interior_x1_, interior_y1_;     // Exclusive
+    bool drawing_interior_;             // Cell being drawn needs no clipping
+
+    // Radar fed from the change bitmap (not owned)
+    RadarRenderer* radar_;
+
+    // Pipelined rendering
+    const RenderSnapshot* object_snapshot_;    // Not owned; nullptr draws live cells
+    float snapshot_alpha_;
+    bool terrain_prepared_;                     // Prepare_Frame() ran for this frame
+
+    // Counted while drawing, reset by Prepare_Frame()
+    RenderStats frame_stats_;
 };
 
 // =============================================================================
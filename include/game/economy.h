@@ -0,0 +1,237 @@
+/**
+ * HouseEconomy - Money, power, storage and production for one house
+ *
+ * Every total is kept up to date as it changes rather than summed over
+ * the house's buildings each tick: placing or losing a building adjusts
+ * power and storage by that building's share, spending and harvesting
+ * adjust the balance. The per-tick work (AI) is only the house's active
+ * factories, so a house with a large base costs no more than a small one.
+ *
+ * Each change sets an ECON_* bit. The UI takes the bits once a frame
+ * (Take_Events) and redraws only what they name - the credits readout,
+ * the power bar, a build icon whose progress bar moved - instead of
+ * polling every value.
+ *
+ * Buildings don't carry their type yet, so whoever places or removes one
+ * reports it (Building_Added / Building_Removed); the scenario loader
+ * does this for the buildings it places.
+ *
+ * Original location: CODE/HOUSE.CPP (power, money), CODE/FACTORY.CPP
+ */
+
+#pragma once
+
+#include "game/house.h"
+#include "game/types/buildingtype.h"
+#include <cstdint>
+
+// =============================================================================
+// Events
+// =============================================================================
+
+enum EconomyEvent : uint32_t {
+    ECON_CREDITS = (1 << 0),    // Credits or stored ore changed
+    ECON_POWER = (1 << 1),      // Power output or drain changed
+    ECON_STORAGE = (1 << 2),    // Ore capacity changed
+    ECON_FACTORY = (1 << 3),    // A factory started, stepped, held, finished or stopped
+};
+
+// =============================================================================
+// Factories
+// =============================================================================
+
+/**
+ * FactoryKind - A house builds one item of each kind at a time
+ */
+enum FactoryKind : int8_t {
+    FACTORY_BUILDING = 0,
+    FACTORY_UNIT = 1,
+    FACTORY_INFANTRY = 2,
+    FACTORY_VESSEL = 3,
+    FACTORY_AIRCRAFT = 4,
+
+    FACTORY_KIND_COUNT = 5
+};
+
+/**
+ * FactoryState - Progress of one factory
+ *
+ * Production moves in STEP_COUNT steps, paying for each step as it is
+ * taken; without the money for the next step it waits.
+ */
+struct FactoryState {
+    static constexpr int STEP_COUNT = 54;
+
+    int type_id = -1;           // Item being built, -1 if idle
+    int cost = 0;
+    int ticks_per_step = 1;
+    int ticks = 0;              // Toward the next step
+    int step = 0;               // 0..STEP_COUNT
+    int spent = 0;              // Paid so far; refunded if abandoned
+    bool on_hold = false;
+
+    bool Is_Busy() const { return type_id >= 0; }
+    bool Is_Done() const { return Is_Busy() && step == STEP_COUNT; }
+    float Progress() const { return static_cast<float>(step) / STEP_COUNT; }
+};
+
+// =============================================================================
+// HouseEconomy
+// =============================================================================
+
+class HouseEconomy {
+public:
+    /**
+     * Ore storage of one building (RULES.INI Storage=)
+     */
+    static int Building_Storage(BuildingType type);
+
+    /**
+     * Default build time: a minute (900 ticks) per 1000 credits
+     */
+    static int Build_Ticks(int cost) { return cost * 9 / 10; }
+
+    /**
+     * Back to a house with nothing: no money, buildings or production
+     */
+    void Reset();
+
+    // -------------------------------------------------------------------------
+    // Buildings
+    // -------------------------------------------------------------------------
+
+    /**
+     * A building of this type now belongs to the house
+     */
+    void Building_Added(BuildingType type);
+
+    /**
+     * A building of this type was destroyed, sold or captured
+     */
+    void Building_Removed(BuildingType type);
+
+    // -------------------------------------------------------------------------
+    // Power
+    // -------------------------------------------------------------------------
+
+    int Power_Output() const { return power_output_; }
+    int Power_Drain() const { return power_drain_; }
+    bool Is_Low_Power() const { return power_drain_ > power_output_; }
+
+    // -------------------------------------------------------------------------
+    // Money
+    // -------------------------------------------------------------------------
+
+    int Credits() const { return credits_; }
+    int Stored_Ore() const { return ore_; }
+    int Capacity() const { return capacity_; }
+
+    /**
+     * Credits plus stored ore: what can be spent
+     */
+    int Available_Money() const { return credits_ + ore_; }
+
+    /**
+     * Add credits (scenario start, selling, crates, refunds)
+     */
+    void Refund_Money(int amount);
+
+    /**
+     * Pay for something, stored ore first
+     *
+     * @return false (and nothing spent) if the house can't afford it
+     */
+    bool Spend_Money(int amount);
+
+    /**
+     * Store harvested ore, up to capacity
+     *
+     * @return Amount stored; the rest is lost
+     */
+    int Harvest(int amount);
+
+    // -------------------------------------------------------------------------
+    // Production
+    // -------------------------------------------------------------------------
+
+    /**
+     * Start building an item
+     *
+     * @param ticks Build time, or 0 for Build_Ticks(cost)
+     * @return false if that factory is busy
+     */
+    bool Start_Production(FactoryKind kind, int type_id, int cost, int ticks = 0);
+
+    /**
+     * Pause or resume a factory
+     */
+    void Set_On_Hold(FactoryKind kind, bool on_hold);
+
+    /**
+     * Stop building and refund what was paid
+     */
+    void Abandon_Production(FactoryKind kind);
+
+    /**
+     * Take a finished item out of its factory
+     *
+     * @return Its type_id, or -1 if nothing is finished
+     */
+    int Take_Completed(FactoryKind kind);
+
+    const FactoryState& Factory(FactoryKind kind) const { return factories_[kind]; }
+
+    /**
+     * Advance the busy factories one tick
+     *
+     * Low power halves production speed.
+     */
+    void AI();
+
+    // -------------------------------------------------------------------------
+    // Events
+    // -------------------------------------------------------------------------
+
+    /**
+     * ECON_* bits set since the last call, and clear them
+     */
+    uint32_t Take_Events() {
+        uint32_t events = events_;
+        events_ = 0;
+        return events;
+    }
+
+    uint32_t Peek_Events() const { return events_; }
+
+private:
+    void Set_Power(int output, int drain);
+    void Set_Capacity(int capacity);
+
+    int credits_ = 0;
+    int ore_ = 0;
+    int capacity_ = 0;
+    int power_output_ = 0;
+    int power_drain_ = 0;
+    FactoryState factories_[FACTORY_KIND_COUNT];
+    bool low_power_tick_ = false;   // Alternates while low on power
+    uint32_t events_ = 0;
+};
+
+// =============================================================================
+// Houses
+// =============================================================================
+
+/**
+ * House_Economy - Economy of a house
+ */
+HouseEconomy& House_Economy(HousesType house);
+
+/**
+ * Reset_Economies - Reset every house's economy
+ */
+void Reset_Economies();
+
+/**
+ * Economy_AI - One economy tick for every house
+ */
+void Economy_AI();
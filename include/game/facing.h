@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 // =============================================================================
@@ -77,6 +78,9 @@ public:
     // Set rotation rate (steps per tick)
     void Set_Rate(uint8_t rate) { rate_ = rate; }
 
+    // Get rotation rate
+    uint8_t Rate() const { return rate_; }
+
     // Snap to desired facing instantly
     void Snap() { current_ = desired_; }
 
@@ -90,6 +94,10 @@ public:
     // Returns true if facing changed
     bool Rotate();
 
+    // Rotate count facings held in parallel arrays, as Rotate() does each
+    static void Rotate_Batch(DirType* current, const DirType* desired,
+                             const uint8_t* rate, int count);
+
     // Get which way to rotate (+1 = clockwise, -1 = counter-clockwise)
     int Rotation_Direction() const;
 
@@ -149,6 +157,7 @@ int8_t Dir_Delta(DirType from, DirType to);
 
 /**
  * Calculate direction from dx, dy deltas
+ * Octant table lookup, rounded to the nearest of the 256 directions
  */
 DirType Dir_From_XY(int dx, int dy);
 
@@ -178,3 +187,7 @@ extern const int8_t DirCosineTable[256];
 
 // 8-way facing for each 256 direction
 extern const uint8_t Dir8Way[256];
+
+// Dir_X_Factor / Dir_Y_Factor for every direction (sin and -cos scaled by 256)
+extern const std::array<int16_t, 256> DirXFactorTable;
+extern const std::array<int16_t, 256> DirYFactorTable;
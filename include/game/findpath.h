@@ -0,0 +1,206 @@
+/**
+ * PathFinder - Hierarchical A* over the map's land layer
+ *
+ * Short routes are a plain A* over cells. Long routes are planned on a
+ * graph of cluster entrances first (the map is cut into 16x16-cell
+ * clusters, and every open stretch of a cluster border is an entrance),
+ * then refined into cells one cluster at a time. Abstract routes are kept
+ * in an LRU cache keyed by start cluster, goal cluster and locomotion,
+ * so a group ordered to the same place costs one graph search plus a
+ * cheap local search per unit.
+ *
+ * The graph is rebuilt lazily whenever the map's land revision changes.
+ * Goals outside the start's zone (see ZoneMap) fail without a search.
+ *
+ * Original location: CODE/FINDPATH.CPP
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/core/rtti.h"
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class MapClass;
+
+// =============================================================================
+// Locomotion
+// =============================================================================
+
+/**
+ * LocomotionType - Which cells a mover may enter
+ */
+enum LocomotionType : uint8_t {
+    LOCO_TRACK = 0,     // Ground vehicles
+    LOCO_FOOT = 1,      // Infantry (may cross walls)
+    LOCO_FLOAT = 2,     // Ships (water only)
+    LOCO_FLY = 3,       // Aircraft (straight line)
+
+    LOCO_COUNT = 4
+};
+
+// Cost of entering a clear cell; diagonal steps cost 141/100 of this
+constexpr int STEP_COST = 100;
+constexpr int DIAGONAL_PERCENT = 141;
+
+/**
+ * Locomotion_Of - Locomotion used by an object kind
+ */
+LocomotionType Locomotion_Of(RTTIType rtti);
+
+/**
+ * Land_Step_Cost - Cost of entering a cell of a land type
+ *
+ * STEP_COST for clear ground, scaled by LandSpeedMultiplier; 0 if the
+ * locomotion cannot enter it. Diagonal steps cost 141/100 of this.
+ *
+ * @param land LandType, as stored in the map's land layer
+ */
+int Land_Step_Cost(LocomotionType loco, int land);
+
+// =============================================================================
+// PathFinder
+// =============================================================================
+
+class PathFinder {
+public:
+    static constexpr int CLUSTER_SHIFT = 4;
+    static constexpr int CLUSTER_SIZE = 1 << CLUSTER_SHIFT;
+    static constexpr int CLUSTERS_PER_ROW = MAP_CELL_WIDTH / CLUSTER_SIZE;
+    static constexpr int CLUSTER_COUNT = CLUSTERS_PER_ROW * (MAP_CELL_HEIGHT / CLUSTER_SIZE);
+    static constexpr int CACHE_SIZE = 64;
+
+    struct Stats {
+        uint32_t paths;             // Find_Path calls
+        uint32_t cache_hits;        // Abstract routes reused
+        uint32_t cache_misses;      // Abstract routes searched
+        uint32_t cells_expanded;    // Cells closed by cell-level searches
+        uint32_t unreachable;       // Rejected by zone without searching
+    };
+
+    static PathFinder& Instance();
+
+    PathFinder();
+
+    PathFinder(const PathFinder&) = delete;
+    PathFinder& operator=(const PathFinder&) = delete;
+
+    /**
+     * Find a route across the global Map
+     *
+     * @param start Cell the mover stands on (need not be passable)
+     * @param goal  Cell to reach
+     * @param path  Receives the cells to step through, start excluded
+     *              and goal included
+     * @return false if the goal cannot be reached
+     */
+    bool Find_Path(CELL start, CELL goal, LocomotionType loco, std::vector<CELL>& path);
+
+    /**
+     * Drop the cluster graphs and cached routes
+     */
+    void Invalidate();
+
+    /**
+     * Get number of entrance nodes in a locomotion's graph (builds it)
+     */
+    int Graph_Node_Count(LocomotionType loco);
+
+    const Stats& Get_Stats() const { return stats_; }
+    void Reset_Stats() { stats_ = Stats(); }
+
+private:
+    struct Bounds {
+        int x0, y0, x1, y1;         // Inclusive cell rectangle
+    };
+
+    struct OpenNode {
+        uint32_t f;
+        uint32_t h;
+        uint16_t index;
+    };
+
+    struct Edge {
+        uint16_t to;
+        uint32_t cost;
+    };
+
+    struct GraphNode {
+        uint16_t index;             // Cell (row-major layer index)
+        uint8_t cluster;
+        std::vector<Edge> edges;
+    };
+
+    struct Graph {
+        bool built = false;
+        std::vector<GraphNode> nodes;
+        std::vector<uint16_t> cluster_nodes[CLUSTER_COUNT];
+    };
+
+    struct CacheEntry {
+        uint32_t key;
+        std::vector<uint16_t> route;    // Graph node IDs, start to goal
+    };
+
+    // Cell-level search
+    bool Sync_Map();
+    int Cell_Cost(LocomotionType loco, int index) const;
+    uint32_t Heuristic(LocomotionType loco, int from, int to) const;
+    uint32_t Next_Generation();
+    bool Search(int start, int goal, LocomotionType loco, const Bounds& bounds);
+    void Trace(int start, int goal, std::vector<CELL>& path) const;
+    Bounds Cluster_Bounds(int cluster) const;
+    static int Cluster_Of(int index);
+
+    // Cluster graph
+    Graph& Get_Graph(LocomotionType loco);
+    void Build_Graph(LocomotionType loco, Graph& graph);
+    int Add_Entrance(Graph& graph, std::vector<int>& node_at, int index);
+    void Link_Border(LocomotionType loco, Graph& graph, std::vector<int>& node_at,
+                     int ax, int ay, int bx, int by, int dx, int dy, int length);
+    bool Plan_Route(int start, int goal, LocomotionType loco, std::vector<uint16_t>& route);
+    bool Refine(int start, int goal, LocomotionType loco, const std::vector<uint16_t>& route,
+                std::vector<CELL>& path);
+
+    // Route cache
+    const std::vector<uint16_t>* Cache_Find(uint32_t key);
+    void Cache_Store(uint32_t key, const std::vector<uint16_t>& route);
+
+    const MapClass* map_;               // Map the graphs were built from
+    uint32_t map_revision_;
+    const uint8_t* land_;               // Map's land layer
+    Bounds map_bounds_;
+    uint16_t land_cost_[LOCO_COUNT][256];  // By land layer byte; 0 = blocked
+    uint32_t min_cost_[LOCO_COUNT];
+
+    // Per-cell search state, valid where seen_ matches search_gen_
+    uint32_t search_gen_;
+    std::vector<uint32_t> seen_;
+    std::vector<uint32_t> closed_;
+    std::vector<uint32_t> cost_;
+    std::vector<uint8_t> from_;         // Direction stepped in from
+    std::vector<OpenNode> open_;
+
+    Graph graphs_[LOCO_COUNT];
+
+    std::list<CacheEntry> cache_;       // Most recently used first
+    std::unordered_map<uint32_t, std::list<CacheEntry>::iterator> cache_index_;
+
+    Stats stats_;
+};
+
+/**
+ * Path_Waypoints - Reduce a cell path to its turning points
+ *
+ * Writes the centre of every cell where the path changes direction and
+ * finishes on dest itself. If the turns don't fit, the first max are
+ * written and the caller plans the rest once the mover gets there.
+ *
+ * @param start Cell the path starts from
+ * @return Number of waypoints written (at most max)
+ */
+int Path_Waypoints(CELL start, const std::vector<CELL>& path, COORDINATE dest,
+                   COORDINATE* out, int max);
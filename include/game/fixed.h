@@ -0,0 +1,125 @@
+/**
+ * Fixed - Deterministic fixed-point numbers for the simulation
+ *
+ * A Fixed<I, F> holds a signed value with I integer bits and F fraction
+ * bits in one 32-bit integer. Every operation is integer arithmetic, so
+ * the same inputs give the same bits on every compiler and CPU - floats
+ * do not promise that, and lockstep games desync on the difference.
+ * Keep float math to presentation (interpolation, palettes, radar scale).
+ *
+ * Products and quotients round toward negative infinity, like the
+ * original game's fixed class; To_Int() truncates toward zero like a
+ * C cast.
+ *
+ * Usage:
+ *   fixed half = fixed::Ratio(1, 2);
+ *   int damage = (half * 75).To_Int();          // 37
+ *   constexpr fixed bias = fixed(3) / 2;        // 1.5, at compile time
+ *
+ * Original location: CODE/FIXED.H (fixed)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// =============================================================================
+// Fixed
+// =============================================================================
+
+template <int IntBits, int FracBits>
+class Fixed {
+    static_assert(IntBits > 0 && FracBits > 0 && IntBits + FracBits <= 32, "Fixed must fit 32 bits");
+
+public:
+    static constexpr int FRAC_BITS = FracBits;
+    static constexpr int32_t ONE = int32_t(1) << FracBits;
+
+    constexpr Fixed() : raw_(0) {}
+    constexpr Fixed(int value) : raw_(static_cast<int32_t>(static_cast<uint32_t>(value) << FracBits)) {}
+
+    /**
+     * Build from the raw scaled integer
+     */
+    static constexpr Fixed From_Raw(int32_t raw) {
+        Fixed f;
+        f.raw_ = raw;
+        return f;
+    }
+
+    /**
+     * Build numerator / denominator, rounded down
+     */
+    static constexpr Fixed Ratio(int numerator, int denominator) {
+        return From_Raw(static_cast<int32_t>(Floor_Div(static_cast<int64_t>(numerator) * ONE, denominator)));
+    }
+
+    constexpr int32_t Raw() const { return raw_; }
+
+    /**
+     * Whole part, truncated toward zero
+     */
+    constexpr int To_Int() const { return raw_ >= 0 ? raw_ >> FracBits : -((-raw_) >> FracBits); }
+
+    /**
+     * Nearest whole number, halves away from zero
+     */
+    constexpr int Round() const {
+        return raw_ >= 0 ? (raw_ + ONE / 2) >> FracBits : -((-raw_ + ONE / 2) >> FracBits);
+    }
+
+    // -------------------------------------------------------------------------
+    // Arithmetic
+    // -------------------------------------------------------------------------
+
+    constexpr Fixed operator-() const { return From_Raw(-raw_); }
+    constexpr Fixed operator+(Fixed other) const { return From_Raw(raw_ + other.raw_); }
+    constexpr Fixed operator-(Fixed other) const { return From_Raw(raw_ - other.raw_); }
+
+    constexpr Fixed operator*(Fixed other) const {
+        int64_t product = static_cast<int64_t>(raw_) * other.raw_;
+        return From_Raw(static_cast<int32_t>(Floor_Div(product, ONE)));
+    }
+
+    constexpr Fixed operator/(Fixed other) const {
+        return From_Raw(static_cast<int32_t>(Floor_Div(static_cast<int64_t>(raw_) * ONE, other.raw_)));
+    }
+
+    constexpr Fixed operator*(int value) const { return From_Raw(raw_ * value); }
+    constexpr Fixed operator/(int value) const { return From_Raw(static_cast<int32_t>(Floor_Div(raw_, value))); }
+
+    Fixed& operator+=(Fixed other) { raw_ += other.raw_; return *this; }
+    Fixed& operator-=(Fixed other) { raw_ -= other.raw_; return *this; }
+    Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    // -------------------------------------------------------------------------
+    // Comparison
+    // -------------------------------------------------------------------------
+
+    constexpr bool operator==(Fixed other) const { return raw_ == other.raw_; }
+    constexpr bool operator!=(Fixed other) const { return raw_ != other.raw_; }
+    constexpr bool operator<(Fixed other) const { return raw_ < other.raw_; }
+    constexpr bool operator<=(Fixed other) const { return raw_ <= other.raw_; }
+    constexpr bool operator>(Fixed other) const { return raw_ > other.raw_; }
+    constexpr bool operator>=(Fixed other) const { return raw_ >= other.raw_; }
+
+private:
+    // Division rounding toward negative infinity, whatever the signs
+    static constexpr int64_t Floor_Div(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (q * b != a && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    int32_t raw_;
+};
+
+template <int I, int F>
+constexpr Fixed<I, F> operator*(int value, Fixed<I, F> f) {
+    return f * value;
+}
+
+/**
+ * fixed - The simulation's general-purpose fixed-point type (16.16)
+ */
+using fixed = Fixed<16, 16>;
@@ -0,0 +1,98 @@
+/**
+ * FlowField - Shared route to one cell for a whole group
+ *
+ * A Dijkstra integration field flooded outward from the target over the
+ * map's land layer, plus the downhill direction for every cell. Any
+ * number of units heading to the same cell read their next step in O(1)
+ * instead of each running its own search.
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/findpath.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class MapClass;
+
+// =============================================================================
+// FlowField
+// =============================================================================
+
+class FlowField {
+public:
+    static constexpr uint8_t NO_FLOW = 0xFF;
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+
+    /**
+     * Number of recently built fields kept for reuse
+     */
+    static constexpr int CACHE_SIZE = 8;
+
+    /**
+     * Get a field toward target, reusing a cached one while the map is
+     * unchanged
+     *
+     * @return Field, or nullptr if there is no map or the target is blocked
+     */
+    static std::shared_ptr<const FlowField> Acquire(CELL target, LocomotionType loco);
+
+    /**
+     * Drop every cached field
+     */
+    static void Flush_Cache();
+
+    FlowField();
+
+    /**
+     * Flood the global Map from target
+     *
+     * @return false if there is no map or the target is blocked
+     */
+    bool Build(CELL target, LocomotionType loco);
+
+    /**
+     * Is this field still valid for the global Map?
+     */
+    bool Is_Current() const;
+
+    CELL Get_Target() const { return target_; }
+    LocomotionType Get_Locomotion() const { return loco_; }
+
+    /**
+     * Cost from cell to the target (UNREACHABLE if it can't get there)
+     */
+    uint32_t Cost(CELL cell) const;
+
+    bool Is_Reachable(CELL cell) const { return Cost(cell) != UNREACHABLE; }
+
+    /**
+     * FacingType to step in from cell (NO_FLOW at the target or if unreachable)
+     */
+    uint8_t Next_Direction(CELL cell) const;
+
+    /**
+     * Cell to step into from cell (CELL_NONE where there is no flow)
+     */
+    CELL Next_Cell(CELL cell) const;
+
+    /**
+     * Follow the field from start to the target
+     *
+     * @param path Receives the cells stepped through, start excluded
+     * @return false if start cannot reach the target
+     */
+    bool Trace(CELL start, std::vector<CELL>& path) const;
+
+private:
+    static bool In_Field(CELL cell);
+
+    CELL target_;
+    LocomotionType loco_;
+    const MapClass* map_;
+    uint32_t revision_;
+    std::vector<uint32_t> cost_;        // Row-major, like CellLayers
+    std::vector<uint8_t> flow_;         // FacingType or NO_FLOW
+};
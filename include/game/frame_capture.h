@@ -0,0 +1,209 @@
+/**
+ * FrameCapture - Match recording without stalling the game thread
+ *
+ * Reading the screen back and encoding it on the game thread, the way
+ * the visual tests take screenshots, costs a frame or more each time.
+ * FrameCapture splits the work: Capture() copies the 8-bit frame and
+ * its palette into a slot of a preallocated ring, and an encoder thread
+ * compresses the slots into the file in order. A 640x400 frame is 256 KB,
+ * so the game thread's share is one memcpy. When the encoder falls
+ * behind and the ring is full, the frame is dropped and counted rather
+ * than waited for.
+ *
+ * Frames are stored as indexes plus the palette, not as RGB: a third of
+ * the size before compression, and lossless. Between key frames each
+ * frame is XORed with the one before, so the unchanged parts of the
+ * screen become runs of zeros, and the result is LZO-compressed. The
+ * palette is stored when it changes and with every key frame.
+ * FrameCaptureReader reads the stream back.
+ *
+ * File layout (little-endian, as written by this build):
+ *   CaptureHeader
+ *   per frame:
+ *     CaptureFrameHeader
+ *     PaletteEntry[256]               (if CAPTURE_FRAME_PALETTE)
+ *     LZO block of width * height     (CaptureFrameHeader::size bytes)
+ *
+ * Usage:
+ *   FrameCapture::Instance().Start("MATCH.CAP", 640, 400);
+ *   ... each drawn frame ...
+ *   FrameCapture::Instance().Capture(pixels, pitch, palette, Platform_Timer_GetTicks());
+ *   ...
+ *   FrameCapture::Instance().Stop();
+ */
+
+#ifndef GAME_FRAME_CAPTURE_H
+#define GAME_FRAME_CAPTURE_H
+
+#include "platform.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr uint32_t CAPTURE_MAGIC = 0x50414352;     // "RCAP"
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+/**
+ * CaptureHeader - Start of a capture file
+ */
+struct CaptureHeader {
+    uint32_t magic;             // CAPTURE_MAGIC
+    uint32_t version;           // CAPTURE_VERSION
+    uint16_t width;
+    uint16_t height;
+    uint32_t key_interval;      // Frames from one key frame to the next
+};
+
+enum CaptureFrameFlags : uint16_t {
+    CAPTURE_FRAME_KEY = 1 << 0,         // Pixels stand alone (otherwise XOR the previous frame)
+    CAPTURE_FRAME_PALETTE = 1 << 1,     // A palette comes before the pixels
+};
+
+/**
+ * CaptureFrameHeader - Start of each frame
+ */
+struct CaptureFrameHeader {
+    uint32_t time_ms;           // When it was captured
+    uint16_t flags;             // CaptureFrameFlags
+    uint16_t reserved;
+    uint32_t size;              // Compressed pixel bytes
+};
+
+static_assert(sizeof(CaptureHeader) == 16, "Capture header is 16 bytes on disk");
+static_assert(sizeof(CaptureFrameHeader) == 12, "Capture frame header is 12 bytes on disk");
+
+// =============================================================================
+// FrameCapture
+// =============================================================================
+
+class FrameCapture {
+public:
+    static constexpr int RING_FRAMES = 8;           // Two thirds of a second behind at 12 fps
+    static constexpr uint32_t KEY_INTERVAL = 150;
+
+    struct Stats {
+        uint32_t captured;      // Copied into the ring
+        uint32_t dropped;       // Ring full
+        uint32_t written;       // Encoded into the file
+        uint64_t bytes_written;
+        double encode_ms;       // Encoder time spent, in total
+    };
+
+    static FrameCapture& Instance();
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * Open the file, allocate the ring and start the encoder
+     *
+     * @return false if already recording or the file can't be created
+     */
+    bool Start(const char* path, int width, int height);
+
+    /**
+     * Encode what is queued, then close the file
+     */
+    void Stop();
+
+    bool Is_Recording() const { return file_ != nullptr; }
+
+    /**
+     * Queue a frame of width x height indexes (rows pitch bytes apart)
+     *
+     * @return false if not recording or the frame was dropped
+     */
+    bool Capture(const uint8_t* pixels, int pitch, const PaletteEntry* palette, uint32_t time_ms);
+
+    /**
+     * Queue the screen as it is after the last flip
+     */
+    bool Capture_Screen(uint32_t time_ms);
+
+    Stats Get_Stats() const;
+
+private:
+    struct Slot {
+        std::vector<uint8_t> pixels;
+        PaletteEntry palette[256];
+        uint32_t time_ms;
+    };
+
+    void Encoder_Main();
+    void Encode(const Slot& slot);
+
+    PlatformFile* file_ = nullptr;
+    std::string path_;
+    int width_ = 0;
+    int height_ = 0;
+
+    Slot ring_[RING_FRAMES];
+    int head_ = 0;                      // Next slot Capture() fills (game thread)
+    int tail_ = 0;                      // Next slot the encoder takes (encoder)
+    int queued_ = 0;                    // Filled and not yet encoded
+    bool stopping_ = false;
+    mutable std::mutex mutex_;          // Guards queued_, stopping_ and stats_
+    std::condition_variable wake_;
+    std::thread encoder_;
+
+    // Encoder state
+    std::vector<uint8_t> previous_;     // Last frame written
+    std::vector<uint8_t> delta_;
+    std::vector<uint8_t> packed_;
+    std::vector<uint32_t> dict_;
+    PaletteEntry last_palette_[256];
+    uint32_t frames_encoded_ = 0;
+
+    Stats stats_ = {};
+};
+
+// =============================================================================
+// FrameCaptureReader
+// =============================================================================
+
+/**
+ * Plays a capture file back a frame at a time
+ */
+class FrameCaptureReader {
+public:
+    FrameCaptureReader() = default;
+    ~FrameCaptureReader() { Close(); }
+
+    FrameCaptureReader(const FrameCaptureReader&) = delete;
+    FrameCaptureReader& operator=(const FrameCaptureReader&) = delete;
+
+    bool Open(const char* path);
+    void Close();
+
+    int Get_Width() const { return header_.width; }
+    int Get_Height() const { return header_.height; }
+
+    /**
+     * Decode the next frame into Get_Pixels() / Get_Palette()
+     *
+     * @return false at the end of the file or on corrupt data
+     */
+    bool Next();
+
+    const uint8_t* Get_Pixels() const { return pixels_.data(); }
+    const PaletteEntry* Get_Palette() const { return palette_; }
+    uint32_t Get_Time() const { return time_ms_; }
+
+private:
+    PlatformFile* file_ = nullptr;
+    CaptureHeader header_ = {};
+    std::vector<uint8_t> pixels_;
+    std::vector<uint8_t> delta_;
+    std::vector<uint8_t> packed_;
+    PaletteEntry palette_[256] = {};
+    uint32_t time_ms_ = 0;
+};
+
+#endif // GAME_FRAME_CAPTURE_H
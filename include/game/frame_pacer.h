@@ -0,0 +1,116 @@
+/**
+ * Frame Pacer - Late input sampling for low-latency frames
+ *
+ * The default loop samples input, simulates, renders and then sleeps in
+ * Platform_Frame_End (and blocks in vsync), so what reaches the screen
+ * was read almost a frame earlier. In low-latency mode the frame instead
+ * sleeps first: the pacer predicts how long input-to-present takes from
+ * recent frames and wakes just early enough to finish before the next
+ * present is due.
+ */
+
+#ifndef GAME_FRAME_PACER_H
+#define GAME_FRAME_PACER_H
+
+#include <cstdint>
+
+// =============================================================================
+// FramePacer
+// =============================================================================
+
+/**
+ * FramePacer - Decides how long a frame sleeps before sampling input
+ *
+ * Work is predicted as a high percentile of the last HISTORY frames,
+ * measured without the pacing sleep and the time Present blocked. Presents
+ * are scheduled one period apart; a present that blocked marks the
+ * display's refresh, and the schedule locks to it.
+ *
+ * Max frames queued bounds how far ahead of the display a frame may be
+ * presented. At 1 a frame presents just before the refresh that shows
+ * it; each further frame starts input one period earlier, trading latency
+ * for slack against a mispredicted frame.
+ */
+class FramePacer {
+public:
+    static constexpr int HISTORY = 32;
+    static constexpr int MAX_FRAMES_QUEUED = 3;
+    static constexpr uint32_t DEFAULT_MARGIN_US = 1500;
+
+    FramePacer();
+
+    /**
+     * Turn low-latency pacing on or off (clears the history)
+     */
+    void Set_Low_Latency(bool enabled);
+    bool Is_Low_Latency() const { return low_latency_; }
+
+    /**
+     * Frames that may be presented ahead of the display (1..MAX_FRAMES_QUEUED)
+     */
+    void Set_Max_Frames_Queued(int frames);
+    int Get_Max_Frames_Queued() const { return max_frames_queued_; }
+
+    /**
+     * Slack kept between predicted work and the present (microseconds)
+     */
+    void Set_Margin_Us(uint32_t margin_us) { margin_us_ = margin_us; }
+    uint32_t Get_Margin_Us() const { return margin_us_; }
+
+    /**
+     * Forget the history and the present schedule
+     */
+    void Reset();
+
+    /**
+     * How long to sleep at a time before sampling input (microseconds)
+     *
+     * Zero when pacing is off, before the first frame, or when the
+     * predicted work no longer fits. Never more than one period.
+     */
+    uint64_t Get_Input_Wait_Us(uint64_t now_us, uint32_t period_us) const;
+
+    /**
+     * Sleep until input should be sampled
+     *
+     * @return Microseconds slept
+     */
+    uint64_t Wait_For_Input(uint32_t period_us);
+
+    /**
+     * Record a finished frame, after its present
+     *
+     * @param now_us Current time (Platform_Input_GetTimeUs clock)
+     * @param period_us Target frame period
+     * @param work_ms Frame time less the pacing sleep and present wait
+     * @param present_ms Time Present blocked this frame
+     */
+    void End_Frame(uint64_t now_us, uint32_t period_us, double work_ms, double present_ms);
+
+    /**
+     * Predicted input-to-present time for the next frame (milliseconds)
+     */
+    double Get_Predicted_Work_Ms() const { return predicted_us_ / 1000.0; }
+
+    /**
+     * When the next present is due (0 = not scheduled yet)
+     */
+    uint64_t Get_Next_Present_Us() const { return next_present_us_; }
+
+private:
+    // A present that blocked at least this long waited for the display
+    static constexpr uint32_t BLOCKED_PRESENT_US = 500;
+
+    bool low_latency_;
+    int max_frames_queued_;
+    uint32_t margin_us_;
+
+    uint32_t work_us_[HISTORY];     // Ring of recent frame work
+    int work_head_;
+    int work_count_;
+    uint32_t predicted_us_;         // 90th percentile of work_us_
+
+    uint64_t next_present_us_;
+};
+
+#endif // GAME_FRAME_PACER_H
@@ -5,6 +5,10 @@
  * They form a linked list attached to the screen and receive
  * input events.
  *
+ * A gadget on a screen reports its own changes: becoming dirty queues it
+ * for the screen's next Draw_Gadgets, and moving or resizing it tells the
+ * screen to re-index it for hit testing (GadgetGrid).
+ *
  * This is a simplified version for initial porting.
  * Full gadget system will be expanded later.
  *
@@ -107,6 +111,17 @@ public:
      */
     bool Is_Point_In(int px, int py) const;
 
+    /**
+     * Is the mouse over this gadget? Changing it redraws the gadget.
+     */
+    void Set_Hover(bool hover);
+    bool Is_Hover() const { return is_hover_; }
+
+    /**
+     * Is the gadget holding the mouse (sticky gadgets, between press and release)?
+     */
+    bool Is_Pressed() const { return is_pressed_; }
+
     // -------------------------------------------------------------------------
     // Drawing
     // -------------------------------------------------------------------------
@@ -140,7 +155,7 @@ public:
     /**
      * Mark gadget as needing redraw
      */
-    void Set_Dirty() { is_dirty_ = true; }
+    void Set_Dirty();
     bool Is_Dirty() const { return is_dirty_; }
     void Clear_Dirty() { is_dirty_ = false; }
 
@@ -153,9 +168,10 @@ public:
     int Get_Width() const { return width_; }
     int Get_Height() const { return height_; }
     int Get_ID() const { return id_; }
+    uint16_t Get_Flags() const { return flags_; }
 
-    void Set_Position(int x, int y) { x_ = x; y_ = y; Set_Dirty(); }
-    void Set_Size(int w, int h) { width_ = w; height_ = h; Set_Dirty(); }
+    void Set_Position(int x, int y) { x_ = x; y_ = y; Layout_Changed(); }
+    void Set_Size(int w, int h) { width_ = w; height_ = h; Layout_Changed(); }
 
     // -------------------------------------------------------------------------
     // List Management
@@ -165,6 +181,11 @@ public:
     void Set_Next(GadgetClass* next) { next_ = next; }
 
 protected:
+    /**
+     * Bounds changed: redraw, and re-index on the screen
+     */
+    void Layout_Changed();
+
     // Position and size
     int x_;
     int y_;
@@ -176,9 +197,17 @@ protected:
     int id_;
     bool is_dirty_;
     bool is_pressed_;  // Currently pressed (for sticky gadgets)
+    bool is_hover_;    // Mouse is over it
 
     // Linked list
     GadgetClass* next_;
+
+private:
+    friend class GScreenClass;
+
+    GScreenClass* screen_;   // Screen it is on, if any
+    int order_;              // Position in the screen's list (0 = head)
+    bool is_queued_;         // In the screen's redraw queue
 };
 
 // =============================================================================
@@ -0,0 +1,74 @@
+/**
+ * GadgetGrid - Spatial index for gadget hit testing
+ *
+ * Buckets a screen's gadgets into fixed-size cells over their bounding
+ * box, so finding what is under the mouse looks at one cell's handful of
+ * gadgets instead of the whole list. Each cell keeps its gadgets in list
+ * order (the order Process_Input sees them), stored as one flat array
+ * with per-cell offsets.
+ *
+ * The grid is a snapshot: rebuild it after gadgets are added, removed,
+ * moved or resized. Hidden and disabled gadgets are indexed like any
+ * other; callers check their state.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class GadgetClass;
+
+// =============================================================================
+// GadgetGrid
+// =============================================================================
+
+class GadgetGrid {
+public:
+    /**
+     * Cell size is 1 << CELL_SHIFT pixels square
+     */
+    static constexpr int CELL_SHIFT = 5;
+
+    /**
+     * Gadgets overlapping one cell, in list order
+     */
+    struct Range {
+        GadgetClass* const* first;
+        GadgetClass* const* last;
+
+        GadgetClass* const* begin() const { return first; }
+        GadgetClass* const* end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    /**
+     * Index every gadget in a list
+     *
+     * @param head First gadget of the screen's list
+     */
+    void Build(GadgetClass* head);
+
+    /**
+     * Drop every gadget
+     */
+    void Clear();
+
+    /**
+     * Gadgets whose cell holds a point
+     *
+     * Candidates only: each still needs Is_Point_In.
+     */
+    Range At(int x, int y) const;
+
+    int Get_Columns() const { return columns_; }
+    int Get_Rows() const { return rows_; }
+
+private:
+    int origin_x_ = 0;
+    int origin_y_ = 0;
+    int columns_ = 0;
+    int rows_ = 0;
+    std::vector<uint32_t> cell_start_;      // columns_ * rows_ + 1 offsets into entries_
+    std::vector<GadgetClass*> entries_;
+};
@@ -8,13 +8,29 @@
 
 #pragma once
 
+#include "game/asset_manifest.h"
 #include "game/display.h"
+#include "game/frame_pacer.h"
 #include "game/house.h"
+#include "game/incremental_loader.h"
+#include "game/mix_view.h"
+#include "game/power_saver.h"
+#include "game/scroll_motion.h"
+#include "game/tick_clock.h"
 #include <cstdint>
 #include <memory>
+#include <string>
 
 // Forward declarations
 class MainMenu;
+class RenderSnapshot;
+class ScenarioScope;
+class SimPipeline;
+struct Replay;
+struct ReplayStats;
+struct ResyncPackage;
+struct ResyncStats;
+struct ScenarioMap;
 
 // =============================================================================
 // Game State
@@ -48,6 +64,17 @@ enum GameSpeed : int8_t {
 // Logic tick intervals (milliseconds)
 extern const uint32_t GameSpeedTicks[5];
 
+/**
+ * StartupSystem - Subsystems brought up after the main menu shows
+ */
+enum StartupSystem : uint32_t {
+    STARTUP_AUDIO = 1 << 0,         // AudioSystem and its thread
+    STARTUP_SOUNDS = 1 << 1,        // Menu sounds loaded
+    STARTUP_NETWORK = 1 << 2,       // LAN game discovery
+    STARTUP_WORKERS = 1 << 3,       // Job system for the logic tick
+    STARTUP_ALL = STARTUP_AUDIO | STARTUP_SOUNDS | STARTUP_NETWORK | STARTUP_WORKERS
+};
+
 // =============================================================================
 // GameClass
 // =============================================================================
@@ -81,11 +108,24 @@ public:
     /**
      * Initialize - Full game initialization
      *
-     * Initializes platform, graphics, audio, assets.
+     * Brings up the platform, graphics, assets and the main menu. What
+     * the menu does not need (StartupSystem) comes up over the first
+     * frames after, a couple of milliseconds a frame.
      * @return true if successful
      */
     bool Initialize();
 
+    /**
+     * Are these StartupSystem bits up yet?
+     */
+    bool Is_Ready(uint32_t systems) const { return (ready_ & systems) == systems; }
+    bool Is_Startup_Complete() const { return Is_Ready(STARTUP_ALL); }
+
+    /**
+     * Bring up the rest of the StartupSystems now (tools, tests)
+     */
+    void Finish_Startup();
+
     /**
      * Shutdown - Clean shutdown
      */
@@ -138,6 +178,13 @@ public:
      */
     uint32_t Get_Tick() const { return tick_; }
 
+    /**
+     * Get the state hash at the end of the last logic tick
+     *
+     * What lockstep peers compare each tick to detect a desync.
+     */
+    uint64_t Get_State_Hash() const { return state_hash_; }
+
     /**
      * Get/set game speed
      */
@@ -149,6 +196,130 @@ public:
      */
     uint32_t Get_Tick_Interval() const;
 
+    /**
+     * Get how far this frame is between the last logic tick and the next (0..1)
+     *
+     * Draw moving objects at ObjectClass::Render_Coord(Get_Render_Alpha()).
+     */
+    float Get_Render_Alpha() const { return render_alpha_; }
+
+    /**
+     * Get game time dropped by the catch-up cap (milliseconds)
+     */
+    uint32_t Get_Dropped_Time() const { return tick_clock_.Get_Dropped_Time(); }
+
+    // -------------------------------------------------------------------------
+    // Frame Pacing
+    // -------------------------------------------------------------------------
+
+    /**
+     * Sleep before sampling input instead of after presenting
+     *
+     * Input is read as late as the predicted frame cost allows, so it is
+     * up to a frame fresher when shown. Off by default.
+     */
+    void Set_Low_Latency(bool enabled);
+    bool Is_Low_Latency() const { return frame_pacer_.Is_Low_Latency(); }
+
+    /**
+     * Frames that may be presented ahead of the display (low-latency mode)
+     */
+    void Set_Max_Frames_Queued(int frames) { frame_pacer_.Set_Max_Frames_Queued(frames); }
+    int Get_Max_Frames_Queued() const { return frame_pacer_.Get_Max_Frames_Queued(); }
+
+    const FramePacer& Get_Frame_Pacer() const { return frame_pacer_; }
+
+    /**
+     * Draw static screens only when something changes, and run slowly
+     * in the background (see PowerSaver). On by default.
+     */
+    void Set_Power_Saver(bool enabled) { power_saver_.Set_Enabled(enabled); }
+    const PowerSaver& Get_Power_Saver() const { return power_saver_; }
+
+    // -------------------------------------------------------------------------
+    // Pipelining
+    // -------------------------------------------------------------------------
+
+    /**
+     * Run logic ticks on a simulation thread while the previous tick renders
+     *
+     * Frames show the world one tick later than in serial mode. Off by default.
+     */
+    void Set_Pipelined(bool enabled);
+    bool Is_Pipelined() const { return sim_pipeline_ != nullptr; }
+
+    /**
+     * Get the snapshot being drawn (nullptr unless pipelined)
+     */
+    const RenderSnapshot* Get_Render_Snapshot() const;
+
+    // -------------------------------------------------------------------------
+    // Replays
+    // -------------------------------------------------------------------------
+
+    /**
+     * Record this session to path, starting when gameplay begins
+     *
+     * The replay is written when the game shuts down.
+     */
+    void Set_Record_Path(const char* path) { record_path_ = path ? path : ""; }
+
+    /**
+     * Play a replay headless: its ticks back to back, nothing drawn
+     *
+     * Needs no Initialize(); if there is no global Map the replay runs
+     * on a map of its own. Reports throughput in stats.
+     *
+     * @return false if the replay's snapshot does not load
+     */
+    bool Play_Replay(const Replay& replay, ReplayStats* stats);
+
+    /**
+     * Run logic ticks back to back on the global Map, nothing drawn
+     *
+     * Needs no Initialize(); for tools and benchmarks that drive the
+     * simulation themselves. Runs on the calling thread.
+     */
+    void Run_Ticks(int count);
+
+    /**
+     * Catch up to another peer: restore its checkpoint, then run the
+     * logged ticks headless until the package's live tick
+     *
+     * Runs the simulation only (no gadgets, nothing drawn). The ResyncLog,
+     * if running, starts over from the caught-up world.
+     *
+     * @return false if the snapshot does not load or the state hash
+     *         after the last tick differs from the package's
+     */
+    bool Resync(const ResyncPackage& package, ResyncStats* stats);
+
+    // -------------------------------------------------------------------------
+    // Profiling
+    // -------------------------------------------------------------------------
+
+    /**
+     * Sample the main thread's call stacks from now on (see SamplingProfiler)
+     *
+     * The samples are written to path as folded stacks when sampling is
+     * toggled off (F12) or the game shuts down.
+     */
+    void Start_Sample_Profile(const char* path, int rate_hz);
+
+    /**
+     * Start sampling, or stop it and write the profile (F12)
+     */
+    void Toggle_Sample_Profile();
+
+    /**
+     * Record every drawn frame to path (see FrameCapture)
+     *
+     * The file is finished when the game shuts down.
+     *
+     * @return false if the screen isn't up or the file can't be created
+     */
+    bool Start_Capture(const char* path);
+
     // -------------------------------------------------------------------------
     // Player
     // -------------------------------------------------------------------------
@@ -183,10 +354,19 @@ private:
      */
     void Update_Logic();
 
+    /**
+     * Update objects for one tick (everything in Update_Logic but the UI)
+     *
+     * Runs on the simulation thread when pipelined.
+     */
+    void Update_Simulation();
+
     /**
      * Render frame
+     *
+     * @param alpha Fraction of the next logic tick elapsed (0..1)
      */
-    void Render_Frame();
+    void Render_Frame(float alpha);
 
     /**
      * Handle menu input
@@ -198,6 +378,40 @@ private:
      */
     void Process_Gameplay();
 
+    /**
+     * Line up a scenario's load steps and enter the load screen
+     *
+     * Nothing is loaded here; Update_Loading() runs the steps a few
+     * milliseconds a frame.
+     */
+    void Begin_Scenario_Load(const char* scenario);
+
+    /**
+     * Destroy every object and end the scenario's arena scope
+     */
+    void End_Scenario();
+
+    /**
+     * Run this frame's share of the load steps; leave the load screen
+     * once they are done and the prefetch settles
+     */
+    void Update_Loading();
+
+    /**
+     * Stop recording first uses and save the log for the next run
+     */
+    void End_First_Use_Log();
+
+    /**
+     * Line up the StartupSystems for after the menu shows
+     */
+    void Defer_Startup();
+
+    /**
+     * Mark StartupSystems ready and log how long after launch
+     */
+    void Set_Ready(uint32_t systems, const char* name);
+
     // -------------------------------------------------------------------------
     // Private Members
     // -------------------------------------------------------------------------
@@ -210,17 +424,54 @@ private:
     // Timing
     uint32_t frame_;            // Render frame count
     uint32_t tick_;             // Logic tick count
-    uint32_t last_tick_time_;   // Time of last logic tick
+    uint64_t state_hash_;       // StateHash after the last tick
+    TickClock tick_clock_;      // Logic ticks owed, capped per frame
+    FramePacer frame_pacer_;    // Sleep before input (low-latency mode)
+    PowerSaver power_saver_;    // Skip or slow frames nobody needs
     uint32_t last_frame_time_;  // Time of last render
+    float render_alpha_;        // Interpolation between ticks for this frame
+
+    // Simulation thread (pipelined mode only)
+    std::unique_ptr<SimPipeline> sim_pipeline_;
 
     // Player
     HousesType player_house_;
 
     // Display
     DisplayClass* display_;
+    ScrollMotion scroll_motion_;    // Arrow-key scroll, eased
 
     // Main Menu
     std::unique_ptr<MainMenu> menu_;
+
+    // Arena allocations of the scenario being played (null between scenarios)
+    std::unique_ptr<ScenarioScope> scenario_scope_;
+
+    // Startup left for after the menu shows
+    IncrementalLoader deferred_startup_;
+    uint32_t ready_;                // StartupSystem bits
+    double startup_time_;           // When Initialize began (seconds)
+
+    // Scenario load, a step at a time
+    IncrementalLoader scenario_load_;
+    std::string load_name_;         // Scenario being loaded
+    MixView load_ini_;              // Its INI, until the steps are done
+    AssetManifest load_manifest_;   // What it will need
+    const ScenarioMap* load_map_;   // Decoded map (ScenarioLoader's; null if none)
+    size_t load_next_object_;       // Next placement to create
+
+    // Scenario prefetch
+    std::string first_use_path_;    // Log for the current scenario
+    AssetManifest first_use_;       // On-demand loads since the mission started
+    uint32_t loading_start_time_;   // When the prefetch began
+    uint32_t first_use_end_tick_;   // Stop recording at this tick
+
+    // Replay recording
+    std::string record_path_;       // Empty = not recording
+
+    // Sampling profiler output
+    std::string sample_path_;
+    int sample_rate_hz_;
 };
 
 // =============================================================================
@@ -247,3 +498,15 @@ void Game_Shutdown();
  * Main entry point
  */
 int Game_Main(int argc, char* argv[]);
+
+/**
+ * Register the game's MIX archives from a data directory
+ *
+ * Shared by GameClass::Initialize() and the offline tools.
+ *
+ * @return Primary archives found (REDALERT.MIX, MAIN.MIX)
+ */
+int Game_Register_Mix_Files(const char* data_path);
+
+// Pre-decoded asset pack opened from the data directory (see PackAssets)
+constexpr const char* ASSET_PACK_FILENAME = "ASSETS.PAK";
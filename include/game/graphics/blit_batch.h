@@ -0,0 +1,92 @@
+/**
+ * BlitBatch - Recorder for batched buffer operations
+ *
+ * Fills, lines, copies and remaps on a GraphicsBuffer are each an FFI
+ * call. Drawing the sidebar's icon frames and bars, or the shroud runs
+ * of the tactical view, makes hundreds of them a frame. A BlitBatch
+ * records them into a fixed array instead and hands the array to
+ * Platform_Buffer_Execute in one call when it fills up, on Flush(), or
+ * when the batch goes out of scope.
+ *
+ * Ops are clipped to the target by the platform, so callers don't clip.
+ * Sources and remap tables are read at flush time and must still be
+ * valid then. The target must stay locked until the batch is flushed;
+ * a batch flushed on an unlocked target is dropped, as GraphicsBuffer
+ * drops drawing on an unlocked buffer.
+ *
+ * Usage:
+ *   BlitBatch batch(buffer);
+ *   batch.Fill_Rect(x, y, w, h, 12);
+ *   batch.Draw_Rect(x, y, w, h, 0);
+ *   // flushed when batch is destroyed
+ */
+
+#ifndef GAME_GRAPHICS_BLIT_BATCH_H
+#define GAME_GRAPHICS_BLIT_BATCH_H
+
+#include "platform.h"
+#include <cstdint>
+
+class GraphicsBuffer;
+
+class BlitBatch {
+public:
+    // Ops recorded before an automatic flush
+    static constexpr int CAPACITY = 128;
+
+    explicit BlitBatch(GraphicsBuffer& target) : target_(target) {}
+    ~BlitBatch() { Flush(); }
+
+    BlitBatch(const BlitBatch&) = delete;
+    BlitBatch& operator=(const BlitBatch&) = delete;
+
+    // =========================================================================
+    // Recording
+    // =========================================================================
+
+    void Fill_Rect(int x, int y, int w, int h, uint8_t color);
+    void Draw_HLine(int x, int y, int length, uint8_t color) { Fill_Rect(x, y, length, 1, color); }
+    void Draw_VLine(int x, int y, int length, uint8_t color) { Fill_Rect(x, y, 1, length, color); }
+
+    /**
+     * Rectangle outline, as GraphicsBuffer::Draw_Rect
+     */
+    void Draw_Rect(int x, int y, int w, int h, uint8_t color);
+
+    /**
+     * Copy a w x h block of raw pixels, as GraphicsBuffer::Blit_From_Raw
+     *
+     * @param trans Skip pixels equal to trans_color
+     */
+    void Blit_Raw(const uint8_t* src_pixels, int src_pitch,
+                  int src_x, int src_y, int src_w, int src_h,
+                  int dst_x, int dst_y, int w, int h,
+                  bool trans = false, uint8_t trans_color = 0);
+
+    /**
+     * Remap a rectangle of the target through a 256-byte table
+     *
+     * @param trans Leave color 0 alone
+     */
+    void Remap(int x, int y, int w, int h, const uint8_t* remap_table, bool trans = false);
+
+    // =========================================================================
+    // Submission
+    // =========================================================================
+
+    /**
+     * Run every recorded op on the target
+     */
+    void Flush();
+
+    int Pending() const { return count_; }
+
+private:
+    PlatformBlitOp& Push(uint8_t kind);
+
+    GraphicsBuffer& target_;
+    PlatformBlitOp ops_[CAPACITY];
+    int count_ = 0;
+};
+
+#endif // GAME_GRAPHICS_BLIT_BATCH_H
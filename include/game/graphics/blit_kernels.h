@@ -0,0 +1,79 @@
+/**
+ * Blit Kernels - Vectorized Row Operations
+ *
+ * Inner loops shared by GraphicsBuffer and ShapeRenderer: key-color
+ * transparent copy, table remapping and masked (shadow) remapping, one
+ * row at a time.
+ *
+ * The best implementation for the running CPU is picked once on first
+ * use (SSE2/AVX2 on x86-64, NEON on ARM64, scalar elsewhere). Callers
+ * go through GetBlitKernels() and never see the instruction set.
+ *
+ * Usage:
+ *   const BlitKernels& k = GetBlitKernels();
+ *   k.copy_trans(dst_row, src_row, width, 0);
+ *   k.copy_remap_trans(dst_row, src_row, width, house_remap, 0);
+ */
+
+#ifndef GAME_GRAPHICS_BLIT_KERNELS_H
+#define GAME_GRAPHICS_BLIT_KERNELS_H
+
+#include <cstdint>
+
+/**
+ * BlitKernelLevel - Instruction set used by the kernels
+ */
+enum BlitKernelLevel {
+    BLIT_KERNEL_SCALAR = 0,
+    BLIT_KERNEL_SSE2,
+    BLIT_KERNEL_AVX2,
+    BLIT_KERNEL_NEON,
+};
+
+/**
+ * BlitKernels - Function table for row operations
+ *
+ * All functions accept count <= 0 and do nothing.
+ * Source and destination must not overlap.
+ */
+struct BlitKernels {
+    // dst[i] = src[i] where src[i] != key
+    void (*copy_trans)(uint8_t* dst, const uint8_t* src, int count, uint8_t key);
+
+    // dst[i] = table[src[i]]
+    void (*copy_remap)(uint8_t* dst, const uint8_t* src, int count,
+                       const uint8_t* table);
+
+    // dst[i] = table[src[i]] where src[i] != key
+    void (*copy_remap_trans)(uint8_t* dst, const uint8_t* src, int count,
+                             const uint8_t* table, uint8_t key);
+
+    // row[i] = table[row[i]]
+    void (*remap_inplace)(uint8_t* row, int count, const uint8_t* table);
+
+    // row[i] = table[row[i]] where mask[i] != key (shadows)
+    void (*remap_masked)(uint8_t* row, const uint8_t* mask, int count,
+                         const uint8_t* table, uint8_t key);
+
+    BlitKernelLevel level;
+    const char* name;
+};
+
+/**
+ * Get the active kernel table (selected on first call)
+ */
+const BlitKernels& GetBlitKernels();
+
+/**
+ * Get the best kernel level supported by this CPU
+ */
+BlitKernelLevel DetectBlitKernelLevel();
+
+/**
+ * Force a kernel level (for tests and benchmarks)
+ *
+ * @return false if the level is not supported on this CPU
+ */
+bool SetBlitKernelLevel(BlitKernelLevel level);
+
+#endif // GAME_GRAPHICS_BLIT_KERNELS_H
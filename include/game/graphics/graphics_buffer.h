@@ -24,9 +24,12 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <vector>
 
 // Forward declare platform types
 struct PlatformSurface;
+struct Rect;    // graphics/dirty_rect.h
 
 /**
  * GraphicsBuffer - 8-bit palettized graphics buffer
@@ -47,6 +50,9 @@ public:
     // Transparent color index (standard for Red Alert sprites)
     static constexpr uint8_t TRANSPARENT_COLOR = 0;
 
+    // Terrain tile edge (Blit_Tile24)
+    static constexpr int TILE24 = 24;
+
     // =========================================================================
     // Singleton Access (Main Screen Buffer)
     // =========================================================================
@@ -55,7 +61,9 @@ public:
      * Get the main screen buffer singleton
      *
      * This wraps the platform layer's back buffer and is the primary
-     * target for all game rendering.
+     * target for all game rendering. Its size is the internal resolution
+     * graphics was initialized at (Platform_Graphics_SetResolution), or
+     * DEFAULT_WIDTH x DEFAULT_HEIGHT until then.
      *
      * @return Reference to the screen buffer
      */
@@ -75,6 +83,8 @@ public:
      *
      * Use this for caching rendered content or intermediate compositing.
      * The buffer is allocated with Platform_Alloc and must be freed.
+     * Buffers of at least screen size are backed by large pages when
+     * the platform has them (see LargePages).
      *
      * @param width  Buffer width in pixels
      * @param height Buffer height in pixels
@@ -286,6 +296,39 @@ public:
                        int dst_x, int dst_y,
                        int width, int height);
 
+    /**
+     * Copy an opaque 24x24 tile with no checks
+     *
+     * The buffer must be locked and the tile fully inside it. Rows are
+     * fixed-size copies, which compile to a few vector moves each.
+     *
+     * @param src  Tile pixels (24x24, pitch 24)
+     * @param x, y Destination top-left
+     */
+    void Blit_Tile24(const uint8_t* src, int x, int y) {
+        uint8_t* dst = pixels_ + y * pitch_ + x;
+        for (int row = 0; row < TILE24; row++) {
+            memcpy(dst, src, TILE24);
+            dst += pitch_;
+            src += TILE24;
+        }
+    }
+
+    /**
+     * Copy an opaque 24x24 tile, clipped to the buffer
+     *
+     * For tiles on the edge of the buffer; interior tiles use Blit_Tile24.
+     */
+    void Blit_Tile24_Clipped(const uint8_t* src, int x, int y);
+
+    /**
+     * AND a 24x24 keep mask into the buffer, clipped
+     *
+     * Mask bytes are 0xFF (keep the pixel) or 0x00 (force index 0).
+     * Used for shroud and fog edges, which darken to black.
+     */
+    void Mask_Tile24(const uint8_t* keep, int x, int y);
+
     /**
      * Blit from raw pixel data with transparency
      *
@@ -297,6 +340,18 @@ public:
                              int width, int height,
                              uint8_t trans_color = TRANSPARENT_COLOR);
 
+    /**
+     * Shift buffer contents in place
+     *
+     * Moves every pixel by (dx, dy). Pixels shifted off the edge are lost;
+     * the exposed strips keep their old contents and must be redrawn by
+     * the caller. Used for scrolling cached layers.
+     *
+     * @param dx Horizontal shift (positive = right)
+     * @param dy Vertical shift (positive = down)
+     */
+    void Shift(int dx, int dy);
+
     // =========================================================================
     // Color Remapping
     // =========================================================================
@@ -353,6 +408,19 @@ public:
      */
     bool Flip();
 
+    /**
+     * Flip only the given screen regions
+     *
+     * Converts and uploads just these rectangles (typically
+     * DirtyRectTracker::get_dirty_rects()); the rest of the display keeps
+     * the previous frame. An empty list re-presents the previous frame.
+     * The platform does a full flip on the first frame and after palette
+     * changes.
+     *
+     * @return true on success
+     */
+    bool Flip(const std::vector<Rect>& rects);
+
 private:
     // =========================================================================
     // Private Members
@@ -0,0 +1,51 @@
+/**
+ * MapTerrainProvider - ITerrainProvider backed by MapClass
+ *
+ * Feeds the render pipeline and radar from the map's packed cell layers,
+ * so bulk consumers can stream template bytes instead of calling
+ * through the interface per cell.
+ *
+ * Usage:
+ *   MapTerrainProvider provider(Map);
+ *   radar.SetTerrainProvider(&provider);
+ *   radar.SetBlipSource([](RadarRenderer& r) { AddObjectRadarBlips(r, player); });
+ */
+
+#ifndef GAME_GRAPHICS_MAP_TERRAIN_H
+#define GAME_GRAPHICS_MAP_TERRAIN_H
+
+#include "game/graphics/render_pipeline.h"
+
+class MapClass;
+class RadarRenderer;
+
+class MapTerrainProvider : public ITerrainProvider {
+public:
+    explicit MapTerrainProvider(const MapClass* map = nullptr) : map_(map) {}
+
+    void SetMap(const MapClass* map) { map_ = map; }
+    const MapClass* GetMap() const { return map_; }
+
+    int GetTerrainTile(int cell_x, int cell_y) const override;
+    int GetTerrainIcon(int cell_x, int cell_y) const override;
+    bool IsValidCell(int cell_x, int cell_y) const override;
+    void GetMapSize(int* width, int* height) const override;
+    bool IsCellShrouded(int cell_x, int cell_y) const override;
+    const uint8_t* GetTemplateLayer(int* pitch) const override;
+
+private:
+    const MapClass* map_;
+};
+
+/**
+ * Add a blip for every placed object in the object spatial grid
+ *
+ * Objects owned by other houses are only shown on visible cells of the
+ * global Map (when one is set). Colors come from the owner's house remap.
+ *
+ * @param radar Radar to add blips to
+ * @param player_house House whose objects are always shown
+ */
+void AddObjectRadarBlips(RadarRenderer& radar, int player_house);
+
+#endif // GAME_GRAPHICS_MAP_TERRAIN_H
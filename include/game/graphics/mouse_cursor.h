@@ -3,6 +3,7 @@
  *
  * Renders the game's custom mouse cursor on top of all other graphics.
  * The cursor changes based on game context (move, attack, select, etc.).
+ * In hardware mode the OS draws it instead (see SetHardwareMode).
  *
  * Usage:
  *   MouseCursor& cursor = MouseCursor::Instance();
@@ -20,6 +21,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 // Forward declarations
 class GraphicsBuffer;
@@ -236,6 +238,12 @@ public:
      */
     void GetClickPosition(int* x, int* y) const;
 
+    /**
+     * Window scale factor (window pixels per game pixel)
+     */
+    void SetScale(int scale);
+    int GetScale() const { return scale_; }
+
     // =========================================================================
     // Update & Draw
     // =========================================================================
@@ -266,6 +274,72 @@ public:
      */
     void DrawAt(GraphicsBuffer& buffer, int x, int y);
 
+    // =========================================================================
+    // Save-Under
+    // =========================================================================
+
+    /**
+     * Draw cursor, first saving the pixels it covers
+     *
+     * RestoreUnder() puts them back, so a cursor move over a static
+     * screen only touches the old and new cursor rects.
+     *
+     * @param buffer Target buffer (must be locked)
+     */
+    void DrawSaved(GraphicsBuffer& buffer);
+
+    /**
+     * Put back the pixels saved by the last DrawSaved()
+     *
+     * @param x, y, w, h Output: rect restored (clipped to the buffer)
+     * @return false if nothing was saved
+     */
+    bool RestoreUnder(GraphicsBuffer& buffer, int* x = nullptr, int* y = nullptr,
+                      int* w = nullptr, int* h = nullptr);
+
+    /**
+     * Forget the saved pixels (e.g. after the screen was redrawn)
+     */
+    void DiscardSaveUnder() { save_valid_ = false; }
+
+    bool HasSaveUnder() const { return save_valid_; }
+
+    /**
+     * Get the rect the cursor covers at (x, y), before clipping
+     *
+     * @return false if hidden, not loaded or the frame is empty
+     */
+    bool GetDrawRect(int x, int y, int* rx, int* ry, int* rw, int* rh) const;
+
+    // =========================================================================
+    // Hardware Cursor
+    // =========================================================================
+
+    /**
+     * Let the OS draw the cursor
+     *
+     * Each MOUSE.SHP frame is converted once, at the current palette and
+     * scale, into a platform colour cursor; Update() then only switches
+     * between them, and Draw() leaves the buffer alone. The cursor moves
+     * at OS input rate however slowly the game renders. A palette or
+     * scale change rebuilds the cursors as they are next shown.
+     *
+     * @return false if the platform could not create the cursor (the
+     *         software cursor stays in use)
+     */
+    bool SetHardwareMode(bool enabled);
+    bool IsHardwareMode() const { return hardware_mode_; }
+
+    /**
+     * Free the converted cursors; they are rebuilt on demand
+     */
+    void InvalidateHardwareCursors();
+
+    /**
+     * Platform cursors currently built
+     */
+    int GetHardwareCursorCount() const;
+
     // =========================================================================
     // Animated Cursors
     // =========================================================================
@@ -329,6 +403,20 @@ private:
 
     int scale_;                   // Window scale factor (default 2)
 
+    // Hardware cursor: platform cursor per shape frame, built on first
+    // show at hw_palette_ and scale_
+    bool hardware_mode_;
+    std::vector<int32_t> hw_cursors_;   // -1 = not built
+    int hw_frame_;                      // Frame the OS shows, -1 = none
+    bool hw_shown_;
+    uint8_t hw_palette_[256 * 3];
+
+    // Pixels under the last DrawSaved() (clipped rect)
+    std::vector<uint8_t> save_pixels_;
+    int save_x_, save_y_;
+    int save_w_, save_h_;
+    bool save_valid_;
+
     // =========================================================================
     // Private Methods
     // =========================================================================
@@ -352,6 +440,20 @@ private:
      */
     void InitHotspots();
 
+    /**
+     * Show the current frame (or nothing, if hidden) as the OS cursor
+     *
+     * @return false if the cursor could not be built or set
+     */
+    bool ApplyHardwareCursor();
+
+    /**
+     * Convert a frame to a platform cursor at hw_palette_ and scale_
+     *
+     * @return Platform cursor handle, -1 on failure
+     */
+    int32_t BuildHardwareCursor(int frame);
+
     // Hotspot lookup table
     static CursorHotspot s_hotspots[CURSOR_COUNT];
     static bool s_hotspots_initialized;
@@ -20,6 +20,7 @@
 #ifndef GAME_GRAPHICS_PALETTE_MANAGER_H
 #define GAME_GRAPHICS_PALETTE_MANAGER_H
 
+#include "game/graphics/remap_tables.h"
 #include <cstdint>
 #include <functional>
 
@@ -123,6 +124,9 @@ public:
     static constexpr int UI_RANGE_START = 1;
     static constexpr int UI_RANGE_END = 15;
 
+    // Brightness steps in the precomputed fade tables (level 64 = full)
+    static constexpr int FADE_LEVELS = 64;
+
     // =========================================================================
     // Singleton
     // =========================================================================
@@ -208,6 +212,36 @@ public:
      */
     void GetRawPalette(uint8_t* output) const;
 
+    /**
+     * Get the current palette packed as ARGB8888 (0xFFRRGGBB)
+     *
+     * Same layout as the platform's conversion LUT. Kept in sync by
+     * ApplyEffects, which only rewrites entries whose color changed.
+     */
+    const uint32_t* GetPackedPalette() const { return packed_; }
+
+    /**
+     * Indices whose current color changed since the last Apply()
+     *
+     * Bit (i & 63) of word (i >> 6) is set for index i. A palette
+     * rotation only marks the rotated range; a fade marks nearly all.
+     */
+    const uint64_t* GetChangedMask() const { return changed_mask_; }
+
+    bool IsIndexChanged(int index) const {
+        index &= 0xFF;
+        return (changed_mask_[index >> 6] >> (index & 63)) & 1;
+    }
+
+    bool HasChangedIndices() const {
+        return (changed_mask_[0] | changed_mask_[1] | changed_mask_[2] | changed_mask_[3]) != 0;
+    }
+
+    /**
+     * Number of indices marked in the changed mask
+     */
+    int GetChangedCount() const;
+
     // =========================================================================
     // Fade Effects
     // =========================================================================
@@ -320,6 +354,15 @@ public:
      */
     void ClearAnimationRanges();
 
+    /**
+     * Advance color cycles only every Nth Update() (QualityGovernor)
+     *
+     * Each rotation rewrites the cycled entries and uploads them, so a
+     * slower cycle is fewer palette uploads.
+     */
+    void SetAnimationDivisor(int divisor) { anim_divisor_ = divisor > 1 ? divisor : 1; }
+    int GetAnimationDivisor() const { return anim_divisor_; }
+
     // =========================================================================
     // Update
     // =========================================================================
@@ -335,7 +378,8 @@ public:
     /**
      * Force palette update to platform layer
      *
-     * Normally called automatically by Update().
+     * Sends all 256 entries. Update() instead sends only the runs of
+     * indices in the changed mask, and nothing if no color changed.
      */
     void Apply();
 
@@ -346,6 +390,8 @@ public:
     /**
      * Generate remap table for house colors
      *
+     * Tables are cached per base palette (see GetCachedHouseRemap).
+     *
      * @param house House index (0-7)
      * @param output 256-byte remap table
      */
@@ -362,6 +408,8 @@ public:
     /**
      * Find closest palette index to RGB color
      *
+     * Uses a ColorLookup over the base palette, built on first call.
+     *
      * @param r, g, b Target color (8-bit)
      * @param skip_zero If true, never returns 0 (transparent)
      */
@@ -378,6 +426,20 @@ private:
     // Palette storage
     PaletteColor original_[PALETTE_SIZE];  // Base palette (unmodified)
     PaletteColor current_[PALETTE_SIZE];   // Current with effects applied
+    uint32_t packed_[PALETTE_SIZE];        // current_ as ARGB8888
+    uint64_t changed_mask_[PALETTE_SIZE / 64];  // Changed since last Apply
+
+    // Precomputed effects, packed 0x00RRGGBB. fade_table_[level][i] is
+    // original_[i] * level / FADE_LEVELS; flash_table_[level] is the
+    // flash color at that strength. Levels of a flash and the fade under
+    // it add up to FADE_LEVELS, so their sum never carries between channels.
+    uint32_t fade_table_[FADE_LEVELS + 1][PALETTE_SIZE];
+    uint32_t flash_table_[FADE_LEVELS + 1];
+
+    // Closest-color lookup over original_, rebuilt on first search after
+    // the base palette changes (color cycling does not invalidate it)
+    mutable ColorLookup lookup_;
+    mutable bool lookup_dirty_;
 
     // Fade state
     FadeState fade_state_;
@@ -397,6 +459,8 @@ private:
     static constexpr int MAX_ANIM_RANGES = 8;
     AnimationRange anim_ranges_[MAX_ANIM_RANGES];
     int anim_range_count_;
+    int anim_divisor_;
+    int anim_skipped_;            // Updates since the cycles last advanced
     bool water_anim_enabled_;
     bool fire_anim_enabled_;
 
@@ -411,6 +475,14 @@ private:
     void UpdateFlash();
     void UpdateAnimations();
     void ApplyEffects();
+    void ApplyChanges();
+    void BuildFadeTables();
+    void BuildFadeColumn(int index);
+    void BuildFlashTable();
+    void GetOriginalRaw(uint8_t* output) const;
+    int GetFadeLevel() const;
+    int GetFlashLevel() const;
+    void CommitColor(int index, const PaletteColor& color);
     void RotateRange(int start, int count, bool forward);
 };
 
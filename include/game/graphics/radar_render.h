@@ -11,7 +11,9 @@
 
 #include "game/graphics/graphics_buffer.h"
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 // =============================================================================
 // Forward Declarations
@@ -108,7 +110,15 @@ public:
     /**
      * Set the terrain provider for map data
      */
-    void SetTerrainProvider(ITerrainProvider* provider) { terrain_ = provider; }
+    void SetTerrainProvider(ITerrainProvider* provider) { terrain_ = provider; panel_dirty_ = true; }
+
+    /**
+     * Set the blip source, called to refill blips before each active draw
+     *
+     * Without a source, blips are whatever was last added by hand.
+     */
+    using BlipSource = std::function<void(RadarRenderer& radar)>;
+    void SetBlipSource(BlipSource source) { blip_source_ = std::move(source); }
 
     /**
      * Shutdown and release resources
@@ -127,7 +137,7 @@ public:
     /**
      * Set radar state (disabled, jammed, active)
      */
-    void SetState(RadarState state) { state_ = state; }
+    void SetState(RadarState state);
 
     /**
      * Get current radar state
@@ -188,16 +198,71 @@ public:
     // =========================================================================
 
     /**
-     * Update the radar image (call when map changes)
+     * Rebuild the whole radar image
      */
     void UpdateTerrainImage();
 
+    /**
+     * Mark one cell's radar pixels for refresh on the next draw
+     *
+     * Cheap enough to call for every building placement or tiberium
+     * growth; only the pixels covering the cell are recomputed.
+     */
+    void InvalidateCell(int cell_x, int cell_y);
+
+    /**
+     * Mark the whole radar image for rebuild on the next draw
+     */
+    void InvalidateTerrain();
+
+    /**
+     * Recompute only the cells passed to InvalidateCell()
+     */
+    void UpdateDirtyCells();
+
+    /**
+     * Get the cached terrain image (radar_width x radar_height, tightly packed)
+     */
+    const uint8_t* GetTerrainImage() const { return terrain_buffer_.get(); }
+
     /**
      * Draw the complete radar
+     *
+     * The panel (frame, terrain, blips, viewport box) is kept in its own
+     * buffer and only redrawn when something on it changed: terrain
+     * invalidation, a different blip list, viewport move, state change
+     * or a blink/static step. Otherwise this is one Blit_From.
+     *
      * @param buffer Target graphics buffer
      */
     void Draw(GraphicsBuffer& buffer);
 
+    /**
+     * Force the cached panel to be redrawn on the next Draw()
+     */
+    void InvalidatePanel() { panel_dirty_ = true; }
+
+    /**
+     * Will the next Draw() redraw the panel? (blip changes are only
+     * detected inside Draw, after the blip source has run)
+     */
+    bool IsPanelDirty() const { return panel_dirty_; }
+
+    /**
+     * Number of times the panel has been redrawn (for profiling/tests)
+     */
+    int GetPanelRedrawCount() const { return panel_redraws_; }
+
+    /**
+     * Look for panel changes only every Nth Draw() (QualityGovernor)
+     *
+     * In between, Draw() blits the cached panel without running the
+     * blip source; InvalidatePanel() and state changes still show on
+     * the next draw.
+     */
+    void SetRefreshInterval(int frames) { refresh_interval_ = frames > 1 ? frames : 1; }
+    int GetRefreshInterval() const { return refresh_interval_; }
+
     /**
      * Draw terrain only
      */
@@ -278,8 +343,26 @@ public:
 private:
     // Internal helpers
     void CreateTerrainBuffer();
+    void BuildLookupTables();
     uint8_t GetTerrainColor(int cell_x, int cell_y) const;
+    static uint8_t TileColor(int tile);
+
+    /**
+     * TerrainSource - Packed template layer, when the provider has one
+     */
+    struct TerrainSource {
+        const uint8_t* layer;
+        int pitch;
+        int width;
+        int height;
+    };
+    TerrainSource GetTerrainSource() const;
+    uint8_t CellColor(const TerrainSource& source, int cell_x, int cell_y) const;
     void DrawPixel(GraphicsBuffer& buffer, int x, int y, uint8_t color);
+    void DrawContents(GraphicsBuffer& buffer);
+    void RenderPanel();
+    bool BlipsChanged() const;
+    bool HasSelectedBlips() const;
 
     // State
     bool initialized_;
@@ -307,10 +390,25 @@ private:
     // Terrain provider
     ITerrainProvider* terrain_;
 
+    // Blip provider (optional)
+    BlipSource blip_source_;
+
+    // Integer lookup tables (built once; replace per-pixel float math)
+    std::vector<int> radar_to_cell_x_;  // Radar column -> cell X
+    std::vector<int> radar_to_cell_y_;  // Radar row -> cell Y
+    std::vector<int> cell_to_radar_x_;  // Cell X -> radar column (blip position)
+    std::vector<int> cell_to_radar_y_;  // Cell Y -> radar row
+    std::vector<int> cell_span_x_;      // Cell X -> first column showing it [map_width_ + 1]
+    std::vector<int> cell_span_y_;      // Cell Y -> first row showing it [map_height_ + 1]
+
     // Terrain image buffer (cached)
     std::unique_ptr<uint8_t[]> terrain_buffer_;
     bool terrain_dirty_;
 
+    // Cells to refresh on the next draw (y << 16 | x)
+    static constexpr size_t MAX_DIRTY_CELLS = 1024;
+    std::vector<uint32_t> dirty_cells_;
+
     // Blips
     static constexpr int MAX_BLIPS = 512;
     RadarBlip blips_[MAX_BLIPS];
@@ -323,6 +421,15 @@ private:
 
     // Jammed static animation
     int static_frame_;
+
+    // Cached panel: frame plus radar area, drawn with the radar at (1, 1)
+    std::unique_ptr<GraphicsBuffer> panel_;
+    bool panel_dirty_;
+    int panel_redraws_;
+    std::vector<RadarBlip> drawn_blips_;   // Blips on the cached panel
+    bool drawn_blink_;                     // blink_state_ when drawn
+    int refresh_interval_;
+    int refresh_skipped_;                  // Draws since the last refresh
 };
 
 #endif // GAME_GRAPHICS_RADAR_RENDER_H
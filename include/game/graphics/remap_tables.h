@@ -2,12 +2,61 @@
  * Standard Color Remap Tables
  *
  * Pre-defined remap tables for house colors, shadows, and effects.
+ *
+ * Closest-color searches go through a ColorLookup built once per
+ * palette, and generated tables are cached by (palette CRC, kind,
+ * house, intensity). InitRemapTables fills both at theater load, so
+ * later requests for the same palette are copies.
  */
 
 #ifndef GAME_GRAPHICS_REMAP_TABLES_H
 #define GAME_GRAPHICS_REMAP_TABLES_H
 
 #include <cstdint>
+#include <vector>
+
+// =============================================================================
+// Color Lookup
+// =============================================================================
+
+/**
+ * ColorLookup - Closest palette index for any RGB color
+ *
+ * RGB space is split into 32x32x32 cells. Each cell keeps the few
+ * palette entries that can be nearest to some point inside it, so a
+ * query tests only those instead of all 255 colors. Results match a
+ * full linear search exactly (index 0 is never returned; ties go to
+ * the lower index).
+ */
+class ColorLookup {
+public:
+    static constexpr int CELL_BITS = 5;
+    static constexpr int CELLS = 1 << CELL_BITS;   // Per channel
+
+    /**
+     * Build for a palette
+     *
+     * @param palette RGB palette data (768 bytes)
+     */
+    void Build(const uint8_t* palette);
+
+    bool IsBuilt() const { return !offsets_.empty(); }
+
+    /**
+     * Find the closest palette index (1-255) to an 8-bit RGB color
+     */
+    uint8_t Find(int r, int g, int b) const;
+
+private:
+    uint8_t palette_[768];
+    std::vector<uint32_t> offsets_;     // CELLS^3 + 1 ranges into candidates_
+    std::vector<uint8_t> candidates_;   // Per-cell indices, ascending
+};
+
+/**
+ * CRC32 of a 768-byte RGB palette (the remap cache key)
+ */
+uint32_t GetPaletteCRC(const uint8_t* palette);
 
 // =============================================================================
 // House Color Remapping
@@ -73,6 +122,35 @@ const uint8_t* GetShadowTable();
  */
 void GenerateShadowTable(const uint8_t* palette, uint8_t* output, float intensity);
 
+// =============================================================================
+// Cached Tables
+// =============================================================================
+
+/**
+ * Copy the house remap table for a palette, building it on first use
+ *
+ * @param palette RGB palette data (768 bytes)
+ * @param house   House color index (0-7); others give identity
+ * @param output  Output table (256 bytes)
+ */
+void GetCachedHouseRemap(const uint8_t* palette, int house, uint8_t* output);
+
+/**
+ * Copy the shadow table for a palette, building it on first use
+ *
+ * Intensity is keyed in 1/256 steps.
+ *
+ * @param palette    RGB palette data (768 bytes)
+ * @param intensity  Shadow darkness (0.0 = none, 1.0 = black)
+ * @param output     Output table (256 bytes)
+ */
+void GetCachedShadowTable(const uint8_t* palette, float intensity, uint8_t* output);
+
+/**
+ * Drop all cached tables and color lookups
+ */
+void ClearRemapCache();
+
 // =============================================================================
 // Fade Tables
 // =============================================================================
@@ -133,7 +211,8 @@ const uint8_t* GetIdentityTable();
  * Initialize all remap tables
  *
  * Must be called after palette is loaded. Generates house colors,
- * shadows, fades, etc. based on the current palette.
+ * shadows, fades, etc. based on the current palette, and seeds the
+ * table cache with the house and standard shadow tables.
  *
  * @param palette RGB palette data (768 bytes)
  */
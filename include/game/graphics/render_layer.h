@@ -10,6 +10,7 @@
 #ifndef GAME_GRAPHICS_RENDER_LAYER_H
 #define GAME_GRAPHICS_RENDER_LAYER_H
 
+#include "game/graphics/shape_id.h"
 #include <cstdint>
 
 // =============================================================================
@@ -82,6 +83,14 @@ public:
      * Get bounding box for dirty rect tracking
      */
     virtual void GetBounds(int& x, int& y, int& width, int& height) const = 0;
+
+    /**
+     * Check if Draw() fills the whole bounding box with opaque pixels
+     *
+     * Occluders let the pipeline skip what lower layers would draw
+     * entirely behind them (see RENDER_OCCLUDER).
+     */
+    virtual bool IsOccluder() const { return false; }
 };
 
 // =============================================================================
@@ -152,19 +161,85 @@ struct RenderEntry {
     }
 };
 
+// =============================================================================
+// Render Command
+// =============================================================================
+
+/**
+ * RenderCommandFlags - Pipeline hints on a RenderCommand (render_flags)
+ */
+enum RenderCommandFlags : uint8_t {
+    RENDER_OCCLUDER = 0x01,     // Opaque over its whole bounds: hides lower layers there
+};
+
+/**
+ * RenderCommand - One queued draw, plain data
+ *
+ * Game objects submit these through RenderPipeline::SubmitShape; the
+ * pipeline draws them with no virtual calls. Commands live in the frame
+ * arena and are valid until the next RenderPipeline::BeginFrame.
+ *
+ * A non-null object marks an IRenderable submitted through
+ * AddRenderable; it is drawn through its Draw() at screen_x/screen_y.
+ */
+struct RenderCommand {
+    uint64_t sort_key;          // Make_Render_Sort_Key(layer, sort_y, shape)
+    IRenderable* object;        // Legacy adapter, or nullptr for shape draws
+    const uint8_t* remap;       // House remap table, or nullptr
+    int32_t screen_x;
+    int32_t screen_y;
+    ShapeId shape;              // ShapeCache handle
+    uint32_t flags;             // ShapeFlags
+    uint16_t frame;
+    uint8_t layer;              // RenderLayer
+    uint8_t render_flags;       // RenderCommandFlags
+};
+
 // =============================================================================
 // Render Statistics
 // =============================================================================
 
+/**
+ * LayerStats - What one render layer cost in a frame
+ *
+ * Pixels are the draws' on-screen bounds (clipped frame or GetBounds()
+ * rects), so pixels over the layer's visible area is its overdraw.
+ */
+struct LayerStats {
+    int commands;       // Draws issued (terrain: tiles)
+    int pixels;         // Pixels covered by those draws
+    float time_ms;      // Time spent drawing the layer (summed over threads)
+
+    LayerStats() { Reset(); }
+
+    void Reset() {
+        commands = 0;
+        pixels = 0;
+        time_ms = 0.0f;
+    }
+
+    LayerStats& operator+=(const LayerStats& other) {
+        commands += other.commands;
+        pixels += other.pixels;
+        time_ms += other.time_ms;
+        return *this;
+    }
+};
+
 /**
  * RenderStats - Performance monitoring data
+ *
+ * Counted per thread and summed at the frame boundary (see RenderPipeline),
+ * hence operator+=.
  */
 struct RenderStats {
     int terrain_tiles_drawn;
     int objects_drawn;
     int dirty_rects_count;
     int pixels_filled;
+    int objects_culled;         // Not queued (shroud) or dropped behind occluders
     float frame_time_ms;
+    LayerStats layers[static_cast<int>(RenderLayer::COUNT)];  // By RenderLayer
 
     RenderStats() { Reset(); }
 
@@ -173,7 +248,28 @@ struct RenderStats {
         objects_drawn = 0;
         dirty_rects_count = 0;
         pixels_filled = 0;
+        objects_culled = 0;
         frame_time_ms = 0.0f;
+        for (LayerStats& layer : layers) {
+            layer.Reset();
+        }
+    }
+
+    RenderStats& operator+=(const RenderStats& other) {
+        terrain_tiles_drawn += other.terrain_tiles_drawn;
+        objects_drawn += other.objects_drawn;
+        dirty_rects_count += other.dirty_rects_count;
+        pixels_filled += other.pixels_filled;
+        objects_culled += other.objects_culled;
+        frame_time_ms += other.frame_time_ms;
+        for (int i = 0; i < static_cast<int>(RenderLayer::COUNT); i++) {
+            layers[i] += other.layers[i];
+        }
+        return *this;
+    }
+
+    const LayerStats& Layer(RenderLayer layer) const {
+        return layers[static_cast<int>(layer)];
     }
 };
 
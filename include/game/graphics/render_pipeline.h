@@ -12,9 +12,14 @@
 
 #include "game/graphics/render_layer.h"
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/render_sort.h"
+#include "platform/thread_shards.h"
+#include <condition_variable>
 #include <cstdint>
-#include <vector>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // =============================================================================
 // Forward Declarations
@@ -26,6 +31,9 @@ class PaletteManager;
 class MouseCursor;
 class SidebarRenderer;
 class RadarRenderer;
+class JobSystem;
+class ITerrainProvider;
+struct NetworkManager;
 
 // =============================================================================
 // Constants
@@ -34,6 +42,10 @@ class RadarRenderer;
 constexpr int MAX_DIRTY_RECTS = 128;
 constexpr int DIRTY_RECT_MERGE_THRESHOLD = 32;  // Merge if overlap margin < this
 
+// Render thread bands (see RenderPipeline::SetRasterBands)
+constexpr int MAX_RASTER_BANDS = 8;
+constexpr int MIN_RASTER_BAND_ROWS = 64;      // Auto bands are at least this tall
+
 // Default viewport dimensions (game area, excluding sidebar)
 constexpr int DEFAULT_TACTICAL_WIDTH = 480;
 constexpr int DEFAULT_TACTICAL_HEIGHT = 384;
@@ -52,6 +64,8 @@ constexpr int DEFAULT_TACTICAL_HEIGHT = 384;
  * 4. Handle UI overlay (sidebar, radar)
  * 5. Draw cursor on top
  */
+class DirtyRectTracker;
+
 class RenderPipeline {
 public:
     // Singleton access
@@ -67,9 +81,15 @@ public:
 
     /**
      * Initialize the render pipeline
+     *
+     * Any internal resolution works; the tactical viewport is the screen
+     * minus the sidebar. Calling again with another size re-lays the
+     * pipeline out for it (after Platform_Graphics_SetResolution and a
+     * graphics re-init).
+     *
      * @param screen_width Full screen width in pixels
      * @param screen_height Full screen height in pixels
-     * @return true if successful
+     * @return true if successful, false if the size can't fit the sidebar
      */
     bool Initialize(int screen_width, int screen_height);
 
@@ -123,6 +143,44 @@ public:
      */
     bool IsVisible(int world_x, int world_y, int width, int height) const;
 
+    // =========================================================================
+    // Culling
+    // =========================================================================
+
+    /**
+     * Check if the cell under a world position is shrouded (never seen)
+     *
+     * Shroud comes from the terrain provider; without one nothing is.
+     */
+    bool IsShrouded(int world_x, int world_y) const;
+
+    /**
+     * Visit the objects of a spatial index that can appear on screen
+     *
+     * Only the grid buckets under the tactical view (grown by margin
+     * pixels, for sprites reaching past their anchor) are walked, and
+     * objects on shrouded cells are skipped, so a mostly off-screen or
+     * unexplored army costs next to nothing. fn(object, world_x, world_y)
+     * typically calls SubmitShape().
+     *
+     * @param grid SpatialGrid (or anything with its ForEachInRect)
+     * @return Objects passed to fn
+     */
+    template <typename Grid, typename Fn>
+    int ForEachVisible(const Grid& grid, int margin, Fn fn) const {
+        int count = 0;
+        grid.ForEachInRect(scroll_x_ - margin, scroll_y_ - margin,
+                           scroll_x_ + tactical_viewport_.width + margin - 1,
+                           scroll_y_ + tactical_viewport_.height + margin - 1,
+                           [&](auto* object, int x, int y) {
+                               if (!IsShrouded(x, y)) {
+                                   fn(object, x, y);
+                                   count++;
+                               }
+                           });
+        return count;
+    }
+
     // =========================================================================
     // Dirty Rectangle Management
     // =========================================================================
@@ -150,7 +208,13 @@ public:
     /**
      * Get number of dirty rectangles
      */
-    int GetDirtyRectCount() const { return static_cast<int>(dirty_rects_.size()); }
+    int GetDirtyRectCount() const;
+
+    /**
+     * Check if the next frame needs a full redraw (requested, or cheaper
+     * than redrawing the dirty rectangles)
+     */
+    bool IsFullRedraw() const;
 
     /**
      * Enable/disable dirty rectangle optimization
@@ -159,13 +223,55 @@ public:
     void SetDirtyRectEnabled(bool enabled) { dirty_rect_enabled_ = enabled; }
     bool IsDirtyRectEnabled() const { return dirty_rect_enabled_; }
 
+    /**
+     * Enable/disable flipping only the dirty rectangles in EndFrame
+     * Only enable once every screen change is reported via AddDirtyRect;
+     * anything drawn outside the dirty rects is not shown until the next
+     * full redraw.
+     */
+    void SetDirtyFlipEnabled(bool enabled) { dirty_flip_enabled_ = enabled; }
+    bool IsDirtyFlipEnabled() const { return dirty_flip_enabled_; }
+
+    /**
+     * Enable/disable the shadow pass (QualityGovernor)
+     * When disabled, SubmitShape() drops SHAPE_SHADOW draws unqueued
+     */
+    void SetShadowsEnabled(bool enabled) { shadows_enabled_ = enabled; }
+    bool IsShadowsEnabled() const { return shadows_enabled_; }
+
     // =========================================================================
     // Renderable Management
     // =========================================================================
 
+    /**
+     * Queue a shape draw for this frame (fast path for game objects)
+     *
+     * The world position is converted and culled here, against the view
+     * and the shroud (of the cell under world_x, world_y); the command
+     * is drawn later with no virtual calls. Draws are sorted by layer,
+     * then sort_y, then shape.
+     *
+     * @param render_flags RenderCommandFlags, e.g. RENDER_OCCLUDER for an
+     *                     opaque building body
+     * @return true if queued, false if culled or the shape is unknown
+     */
+    bool SubmitShape(ShapeId shape, int frame, int world_x, int world_y,
+                     RenderLayer layer, int sort_y,
+                     const uint8_t* remap = nullptr, uint32_t flags = 0,
+                     uint8_t render_flags = 0);
+
+    /**
+     * Queue a prepared command (screen coordinates and sort key set by caller)
+     */
+    void SubmitCommand(const RenderCommand& command);
+
     /**
      * Add an object to be rendered this frame
      * Objects are sorted by layer, then by Y coordinate
+     *
+     * Compatibility adapter: the object's layer, sort Y and position are
+     * read once here and queued as a RenderCommand; only Draw() is
+     * called later. Culled like SubmitShape().
      */
     void AddRenderable(IRenderable* obj);
 
@@ -177,7 +283,12 @@ public:
     /**
      * Get number of queued renderables
      */
-    int GetRenderableCount() const { return static_cast<int>(render_queue_.size()); }
+    int GetRenderableCount() const { return static_cast<int>(command_count_); }
+
+    /**
+     * Queued commands (draw order once the frame has been sorted)
+     */
+    const RenderCommand* GetCommands() const { return commands_; }
 
     // =========================================================================
     // Frame Rendering
@@ -196,14 +307,84 @@ public:
 
     /**
      * End frame and present to screen
+     *
+     * In threaded mode this presents the previously rasterized frame.
      */
     void EndFrame();
 
     /**
      * Convenience method: BeginFrame + RenderFrame + EndFrame
+     *
+     * With dirty flips enabled and nothing reported dirty, only the
+     * cursor is redrawn (see DrawCursorFrame).
      */
     void DrawFrame();
 
+    /**
+     * Present a frame where only the cursor may have changed
+     *
+     * Restores the pixels saved under the old cursor, draws it at the new
+     * position and flips just those two rects. Menus and paused games
+     * cost almost nothing per frame this way.
+     *
+     * @return false (nothing done) if a full frame is needed: no frame
+     *         rendered yet, a full redraw or dirty rects pending
+     */
+    bool DrawCursorFrame();
+
+    // =========================================================================
+    // Threaded Rendering
+    // =========================================================================
+
+    /**
+     * Rasterize the scene on a dedicated render thread
+     *
+     * RenderFrame() then only sorts the queue and hands a copy of it to
+     * the render thread, which draws terrain through shroud into one of
+     * two off-screen buffers. EndFrame() presents the frame finished
+     * before it, so the game thread records frame N+1 while frame N
+     * rasterizes: a frame costs max(record, rasterize) instead of their
+     * sum, and reaches the screen one frame later.
+     *
+     * The sidebar, radar, cursor and debug overlay read live game and
+     * input state, so they stay on the calling thread and draw over the
+     * presented frame, as do the flips. Anything drawn straight to the
+     * screen before RenderFrame() is covered by the rasterized scene.
+     * IRenderable objects are drawn on the render thread and must not
+     * change until the next RenderFrame() or Finish(); the same goes for
+     * ShapeCache::Remove() and Clear(). ShapeCache budget eviction is
+     * held from one RenderFrame() to the next, so the cache may run over
+     * budget by a frame's shapes and is trimmed as each job is queued.
+     * Terrain tiles are looked up (and their templates loaded) by
+     * RenderFrame() and copied into the job, so the render thread touches
+     * no TileRenderer state and the tile renderer stays free to load,
+     * evict or switch theater.
+     */
+    void SetThreaded(bool enabled);
+    bool IsThreaded() const { return render_thread_.joinable(); }
+
+    /**
+     * Split the render thread's scene into horizontal bands
+     *
+     * Commands are binned by their bounds into every band they overlap,
+     * and the bands are rasterized side by side on a worker pool of the
+     * render thread's own, each into its rows of the frame. Clipping to
+     * the band is the buffer's usual clipping, and each band draws its
+     * commands in queue order, so the frame is the same as with one band.
+     * An IRenderable spanning bands has Draw() called once per band,
+     * possibly at the same time, with a buffer of just that band's rows.
+     *
+     * @param bands Band count, 1 for none, 0 (default) for one per worker
+     *              with at least MIN_RASTER_BAND_ROWS rows each
+     */
+    void SetRasterBands(int bands);
+    int GetRasterBands() const { return raster_bands_; }
+
+    /**
+     * Block until the frame handed to the render thread (if any) is drawn
+     */
+    void Finish();
+
     // =========================================================================
     // Individual Render Stages
     // =========================================================================
@@ -291,25 +472,40 @@ public:
      * Register the radar renderer
      */
     void SetRadarRenderer(RadarRenderer* radar) { radar_ = radar; }
+    RadarRenderer* GetRadarRenderer() const { return radar_; }
 
     /**
      * Set the terrain tile renderer
      */
     void SetTileRenderer(TileRenderer* tiles) { tile_renderer_ = tiles; }
 
+    /**
+     * Set the map data culling reads shroud from (nullptr = no shroud)
+     *
+     * With a provider, shrouded cells are filled black by RenderShroud()
+     * (before the shroud layer's commands), and nothing below is queued
+     * or drawn in them.
+     */
+    void SetTerrainProvider(ITerrainProvider* terrain) { terrain_ = terrain; }
+
     // =========================================================================
     // Statistics
     // =========================================================================
 
     /**
      * Get render statistics from last frame
+     *
+     * Stages count into the calling thread's shard; the shards are merged
+     * when RenderFrame() or DrawCursorFrame() finishes. layers[] has each
+     * RenderLayer's commands, pixels covered and drawing time, to tell
+     * which layers are worth caching or culling harder.
      */
     const RenderStats& GetStats() const { return stats_; }
 
     /**
      * Reset statistics
      */
-    void ResetStats() { stats_.Reset(); }
+    void ResetStats();
 
     // =========================================================================
     // Debug
@@ -322,19 +518,65 @@ public:
     bool IsDebugMode() const { return debug_mode_; }
 
     /**
-     * Draw debug overlays (dirty rects, layer info)
+     * Show overdraw instead of the tactical view in debug mode
+     *
+     * Each pixel is colored by how many draws covered it this frame
+     * (terrain included, by their bounds): black for none, then grey,
+     * green, bright green, dark red, and bright red for five or more.
+     * Counting costs a pass over every draw's rect, so only runs while
+     * this and debug mode are both on.
+     */
+    void SetOverdrawHeatmap(bool enabled) { overdraw_heatmap_ = enabled; }
+    bool IsOverdrawHeatmap() const { return overdraw_heatmap_; }
+
+    /**
+     * Draw debug overlays (overdraw heatmap, dirty rects, network stats,
+     * quality level)
      */
     void DrawDebugOverlay();
 
+    /**
+     * Network session to report on (nullptr outside multiplayer)
+     *
+     * Each frame its round trip, loss and traffic go to Profiler values,
+     * and the debug overlay lists them per peer.
+     */
+    void SetNetworkManager(NetworkManager* manager) { network_ = manager; }
+
 private:
     RenderPipeline();
     ~RenderPipeline();
 
     // Internal helpers
-    void MergeDirtyRects();
     void SortRenderQueue();
+    RenderCommand* AppendCommand();
     void RenderLayer(RenderLayer layer);
-    void ClipToViewport(DirtyRect& rect) const;
+    void PublishNetworkStats();
+    void DrawNetworkStats(GraphicsBuffer& screen);
+
+    // Culling stage: which view cells are hidden, and from which layer
+    struct OcclusionMap;
+    void CullOccluded();
+
+    // A layer's shadows, gathered in a mask and darkened in one pass
+    struct ShadowMask;
+
+    // Terrain into any buffer (screen or a render job's band), whose
+    // row 0 is screen row band_top. The tile is looked up by the caller
+    // (null draws the clear fill), so this reads no TileRenderer state.
+    void DrawTerrain(GraphicsBuffer& target, const Viewport& viewport,
+                     int scroll_x, int scroll_y, int band_top, const uint8_t* tile,
+                     RenderStats& stats, uint8_t* overdraw, const OcclusionMap* occlusion);
+    uint8_t* OverdrawCounts();
+
+    // Threaded rendering
+    struct RenderJob;
+    void QueueRenderJob();
+    void RasterizeJob(RenderJob& job);
+    void RasterizeBand(RenderJob& job, int band, int band_rows);
+    int BandCount(int height) const;
+    void PresentJob(int slot);
+    void RenderThreadMain();
 
     // State
     bool initialized_;
@@ -346,24 +588,65 @@ private:
     int scroll_x_;                // World X offset
     int scroll_y_;                // World Y offset
 
-    // Dirty rectangle tracking
-    std::vector<DirtyRect> dirty_rects_;
+    // Dirty rectangle tracking (shared tile-bitmap tracker)
+    std::unique_ptr<DirtyRectTracker> dirty_tracker_;
     bool dirty_rect_enabled_;
+    bool dirty_flip_enabled_ = false;
+    bool shadows_enabled_ = true;
     bool full_redraw_pending_;
-
-    // Render queue
-    std::vector<RenderEntry> render_queue_;
+    bool scene_drawn_ = false;    // Screen holds a complete rendered frame
+
+    // Where the cursor was last drawn (screen rect, before clipping)
+    bool cursor_drawn_ = false;
+    int cursor_x_ = 0, cursor_y_ = 0;
+    int cursor_w_ = 0, cursor_h_ = 0;
+    int cursor_frame_type_ = -1;
+
+    // Render queue (frame arena storage, reset by BeginFrame)
+    RenderCommand* commands_ = nullptr;
+    size_t command_count_ = 0;
+    size_t command_capacity_ = 0;
+    uint32_t layer_start_[static_cast<int>(RenderLayer::COUNT) + 1] = {};
+    RenderSorter sorter_;
+
+    // Render thread and its double-buffered jobs (see SetThreaded)
+    std::unique_ptr<RenderJob> jobs_[2];
+    std::thread render_thread_;
+    std::mutex render_mutex_;
+    std::condition_variable render_wake_;   // Job queued or stop requested
+    std::condition_variable render_done_;   // Queued job drawn
+    int render_job_ = -1;                   // Slot being drawn; guarded by render_mutex_
+    bool render_stop_ = false;              // Guarded by render_mutex_
+    int queued_slot_ = -1;                  // Last slot handed over and not presented
+    int ready_slot_ = -1;                   // Drawn slot EndFrame() presents
+    int raster_bands_ = 0;                  // 0 = auto
+    std::unique_ptr<JobSystem> band_jobs_;  // Band workers, used by the render thread only
+    bool shapes_held_ = false;              // The queued job holds ShapeCache eviction
+
+    // Cells hidden this frame (shroud and occluders), built by CullOccluded
+    std::unique_ptr<OcclusionMap> occlusion_;
+    ITerrainProvider* terrain_ = nullptr;
+
+    // Shadow mask of the serial stages (render bands have their own)
+    std::unique_ptr<ShadowMask> shadow_mask_;
 
     // Registered renderers
     TileRenderer* tile_renderer_;
     SidebarRenderer* sidebar_;
     RadarRenderer* radar_;
 
-    // Statistics
+    // Statistics: per-thread counts, and their sum as of the last frame end
+    ThreadSharded<RenderStats> stats_shards_;
     RenderStats stats_;
 
     // Debug
     bool debug_mode_;
+    bool overdraw_heatmap_ = false;
+    std::vector<uint8_t> overdraw_;   // Writes per screen pixel this frame, when counted
+
+    // Network session for stats (not owned)
+    NetworkManager* network_ = nullptr;
+    uint32_t network_stalls_ = 0;     // Stall count as of the last publish
 };
 
 // =============================================================================
@@ -404,6 +687,31 @@ public:
      * Get map dimensions
      */
     virtual void GetMapSize(int* width, int* height) const = 0;
+
+    /**
+     * Check if a cell is shrouded (never seen, drawn solid black)
+     *
+     * The render pipeline culls everything below the shroud layer there.
+     */
+    virtual bool IsCellShrouded(int cell_x, int cell_y) const {
+        (void)cell_x;
+        (void)cell_y;
+        return false;
+    }
+
+    /**
+     * Get packed template indices for bulk reads (optional)
+     *
+     * Lets per-pixel consumers like the radar avoid a virtual call per cell.
+     *
+     * @param[out] pitch Bytes between rows
+     * @return Row-major template bytes covering GetMapSize() (0xFF = no
+     *         template, drawn as clear), or nullptr if not available
+     */
+    virtual const uint8_t* GetTemplateLayer(int* pitch) const {
+        (void)pitch;
+        return nullptr;
+    }
 };
 
 #endif // GAME_GRAPHICS_RENDER_PIPELINE_H
@@ -0,0 +1,106 @@
+/**
+ * Render Sort - Packed Keys and Radix Sort for Draw Queues
+ *
+ * Draw queues are sorted by (layer, sort Y, texture). Each item's order
+ * is packed once into a 64-bit key, then the keys are sorted with an
+ * LSD radix sort that carries item indices along. There are no
+ * comparator calls, and byte passes where every key has the same digit
+ * are skipped, so a typical queue needs three or four passes.
+ *
+ * Queues are rebuilt every frame but rarely change order. If this
+ * frame's keys match last frame's, the previous order is reused without
+ * sorting at all. If they are already in order, the sort is skipped too.
+ *
+ * The sort is stable: items with equal keys keep submission order.
+ *
+ * Usage:
+ *   RenderSorter sorter;
+ *   sorter.Begin(count);
+ *   for (each item) sorter.Add(Make_Render_Sort_Key(layer, y, texture));
+ *   const uint32_t* order = sorter.Sort();   // order[i] = item index
+ */
+
+#ifndef GAME_GRAPHICS_RENDER_SORT_H
+#define GAME_GRAPHICS_RENDER_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Pack a sort key: layer (16 bits), sort Y (32 bits), texture (16 bits)
+ *
+ * Layer and Y are signed and biased so unsigned key order matches.
+ * Layers are clamped to int16 range; texture IDs above 0xFFFF only share
+ * a key slot (callers still split batches by the full ID).
+ */
+inline uint64_t Make_Render_Sort_Key(int layer, int sort_y, uint32_t texture) {
+    if (layer < INT16_MIN) layer = INT16_MIN;
+    if (layer > INT16_MAX) layer = INT16_MAX;
+    uint64_t l = static_cast<uint16_t>(static_cast<int16_t>(layer) ^ INT16_MIN);
+    uint64_t y = static_cast<uint32_t>(sort_y) ^ 0x80000000u;
+    uint64_t t = texture > 0xFFFF ? 0xFFFF : texture;
+    return (l << 48) | (y << 16) | t;
+}
+
+/**
+ * RenderSorter - Reusable key/index sorter
+ *
+ * Buffers are kept between frames, so steady-state sorting allocates nothing.
+ */
+class RenderSorter {
+public:
+    /**
+     * How the last Sort() produced its order
+     */
+    enum SortPath {
+        SORT_PATH_NONE = 0,     // Empty queue
+        SORT_PATH_REUSED,       // Same keys as last frame
+        SORT_PATH_ORDERED,      // Already in order
+        SORT_PATH_RADIX,        // Full radix sort
+    };
+
+    RenderSorter() = default;
+
+    /**
+     * Start a new queue (reserves for the expected count)
+     */
+    void Begin(size_t expected = 0);
+
+    /**
+     * Append the key of the next item (item index = call order)
+     */
+    void Add(uint64_t key) { keys_.push_back(key); }
+
+    /**
+     * Sort the keys added since Begin()
+     *
+     * @return order[i] is the index of the i-th item in draw order;
+     *         valid until the next Begin()
+     */
+    const uint32_t* Sort();
+
+    size_t Size() const { return keys_.size(); }
+    SortPath Get_Last_Path() const { return last_path_; }
+    int Get_Last_Passes() const { return last_passes_; }
+
+    /**
+     * Forget last frame's order (forces the next Sort() to re-check)
+     */
+    void Invalidate() { prev_keys_.clear(); }
+
+private:
+    void Radix_Sort();
+
+    std::vector<uint64_t> keys_;         // Keys in submission order
+    std::vector<uint64_t> prev_keys_;    // Previous frame's keys, submission order
+    std::vector<uint32_t> order_;        // Sorted item indices
+    std::vector<uint64_t> sort_keys_;    // Keys in sorted order (radix ping)
+    std::vector<uint64_t> tmp_keys_;     // Radix pong
+    std::vector<uint32_t> tmp_order_;
+
+    SortPath last_path_ = SORT_PATH_NONE;
+    int last_passes_ = 0;
+};
+
+#endif // GAME_GRAPHICS_RENDER_SORT_H
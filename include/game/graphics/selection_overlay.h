@@ -0,0 +1,130 @@
+/**
+ * SelectionOverlay - Selection brackets and health bars for one frame
+ *
+ * Every selected object draws corner brackets and a health bar, and the
+ * cursor highlight draws a box. As separate clipped line calls that is a
+ * dozen primitives per object, hundreds of them with a large selection.
+ * Instead the drawers record a small packed record each (Add_Brackets,
+ * Add_Box, Add_Health_Bar) and the frame rasterizes them all at once:
+ * the target is walked in bands of BAND_ROWS scanlines, and every record
+ * crossing a band is cut into horizontal spans for each of its rows and
+ * filled with one memset per span, the way Platform_Buffer_HLine fills.
+ * Clipping is one clamp per span.
+ *
+ * The records are drawn by whoever renders the frame: RenderPipeline in
+ * its selection stage (per band on the render thread), DisplayClass after
+ * its cursor. Drawing does not change the records, so bands can be drawn
+ * in parallel; Clear() starts the next frame.
+ *
+ * Usage:
+ *   SelectionOverlay& overlay = SelectionOverlay::Instance();
+ *   overlay.Add_Brackets(x, y, 24, 24, OVERLAY_COLOR_WHITE);
+ *   overlay.Add_Health_Bar(x, y - 5, 24, obj->Health_Percent());
+ *   ...
+ *   overlay.Draw(screen);
+ *   overlay.Clear();
+ *
+ * Original location: CODE/TECHNO.CPP (Draw_It health bar),
+ *                    CODE/OBJECT.CPP (Draw_Selection brackets)
+ */
+
+#ifndef GAME_GRAPHICS_SELECTION_OVERLAY_H
+#define GAME_GRAPHICS_SELECTION_OVERLAY_H
+
+#include <cstdint>
+#include <vector>
+
+class GraphicsBuffer;
+
+// Game palette colors the overlay uses
+constexpr uint8_t OVERLAY_COLOR_GREEN = 4;      // LTGREEN
+constexpr uint8_t OVERLAY_COLOR_YELLOW = 5;
+constexpr uint8_t OVERLAY_COLOR_RED = 8;
+constexpr uint8_t OVERLAY_COLOR_BLACK = 12;
+constexpr uint8_t OVERLAY_COLOR_WHITE = 15;
+
+class SelectionOverlay {
+public:
+    // Scanlines rasterized together
+    static constexpr int BAND_ROWS = 16;
+
+    // Height of a health bar, frame included
+    static constexpr int HEALTH_BAR_HEIGHT = 4;
+
+    static SelectionOverlay& Instance();
+
+    SelectionOverlay() = default;
+
+    // =========================================================================
+    // Recording
+    // =========================================================================
+
+    /**
+     * Corner brackets around a w x h rectangle at (x, y)
+     */
+    void Add_Brackets(int x, int y, int w, int h, uint8_t color);
+
+    /**
+     * One-pixel outline of a w x h rectangle at (x, y)
+     */
+    void Add_Box(int x, int y, int w, int h, uint8_t color);
+
+    /**
+     * Health bar w pixels wide at (x, y), filled to percent
+     *
+     * The fill is green above half health, yellow above a quarter and red
+     * below that, inside a black frame.
+     */
+    void Add_Health_Bar(int x, int y, int w, int percent);
+
+    /**
+     * Drop every record
+     */
+    void Clear() { records_.clear(); }
+
+    int Count() const { return static_cast<int>(records_.size()); }
+
+    // =========================================================================
+    // Rasterizing
+    // =========================================================================
+
+    /**
+     * Draw every record onto a locked buffer
+     *
+     * @return Records drawn
+     */
+    int Draw(GraphicsBuffer& target) const;
+
+    /**
+     * Draw the records crossing rows [top, top + rows) onto a surface
+     * holding just those rows
+     *
+     * @param pixels Row top of the surface
+     * @return Records whose first visible row lies in these rows
+     */
+    int Draw(uint8_t* pixels, int pitch, int width, int rows, int top) const;
+
+private:
+    enum RecordKind : uint8_t {
+        RECORD_BRACKETS = 0,
+        RECORD_BOX = 1,
+        RECORD_HEALTH = 2,
+    };
+
+    // 14 bytes; coordinates are screen pixels
+    struct Record {
+        int16_t x, y, w, h;
+        int16_t extra;          // Bracket arm length, or health fill width
+        uint8_t kind;
+        uint8_t color;          // Outline, or health bar frame
+        uint8_t fill_color;     // Health bar fill
+    };
+
+    void Push(RecordKind kind, int x, int y, int w, int h, int extra,
+              uint8_t color, uint8_t fill_color = 0);
+    static void Draw_Row(const Record& record, int row, uint8_t* line, int width);
+
+    std::vector<Record> records_;
+};
+
+#endif // GAME_GRAPHICS_SELECTION_OVERLAY_H
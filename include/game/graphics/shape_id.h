@@ -0,0 +1,19 @@
+/**
+ * Shape Handles
+ *
+ * Integer handles for shapes in the global ShapeCache. A handle is
+ * resolved once from a filename (ShapeCache::Register) and then used
+ * to index the cache directly, so per-frame draws never touch strings.
+ */
+
+#ifndef GAME_GRAPHICS_SHAPE_ID_H
+#define GAME_GRAPHICS_SHAPE_ID_H
+
+#include <cstdint>
+
+typedef int32_t ShapeId;
+
+// Invalid / unregistered shape handle
+constexpr ShapeId SHAPE_ID_NONE = -1;
+
+#endif // GAME_GRAPHICS_SHAPE_ID_H
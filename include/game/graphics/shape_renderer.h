@@ -12,6 +12,9 @@
  *
  * Performance:
  *   Frame data is cached after first access for fast repeated drawing.
+ *   PrecacheFrame()/PrecacheAllFrames() additionally convert frames to a
+ *   run-length span form so transparent pixels cost nothing to draw, and
+ *   pack them back to back in one block per shape (ShapeFrameSlab).
  *   Use ClearCache() to free memory if needed.
  *
  * Original: WIN32LIB/SHAPE.CPP, CODE/DISPLAY.CPP (Draw_Shape)
@@ -25,6 +28,11 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
+
+#include "game/asset_loader.h"
+#include "game/core/containers.h"
+#include "game/graphics/shape_id.h"
 
 // Forward declarations
 class GraphicsBuffer;
@@ -57,7 +65,41 @@ enum ShapeFlags : uint32_t {
 // =============================================================================
 
 /**
- * ShapeFrame - Cached decompressed frame data
+ * ShapeFrameView - Read-only view of one frame's data
+ *
+ * What the draw paths take, so a frame in a ShapeRenderer's slab and a
+ * standalone ShapeFrame are drawn alike. Exactly one of the two forms
+ * is set on a valid view.
+ */
+struct ShapeFrameView {
+    int16_t x_offset = 0;                   // Draw offset from shape origin
+    int16_t y_offset = 0;
+    int16_t width = 0;                      // Frame dimensions
+    int16_t height = 0;
+    const uint8_t* pixels = nullptr;        // Dense pixels (width * height)
+    const uint8_t* spans = nullptr;         // Span-encoded rows (see ShapeFrame)
+    const uint32_t* row_offsets = nullptr;  // height + 1 offsets into spans
+
+    size_t GetSize() const { return static_cast<size_t>(width) * height; }
+    bool HasPixels() const { return pixels != nullptr; }
+    bool HasSpans() const { return row_offsets != nullptr; }
+    bool IsValid() const { return width > 0 && height > 0 && (HasPixels() || HasSpans()); }
+};
+
+/**
+ * ShapeFrame - Decompressed frame data with storage of its own
+ *
+ * A frame is held either as dense pixels (width * height bytes) or as
+ * per-row opaque spans. The span form lets the draw loops skip
+ * transparent pixels entirely. ShapeRenderer builds frames in this form
+ * and then moves precached ones into its slab; asset packing and tests
+ * use it directly.
+ *
+ * Span encoding (per row, starting at row_offsets[row]):
+ *   [skip][count][count pixel bytes] ... repeated until row_offsets[row+1]
+ *   skip  = transparent pixels before the run (0-255)
+ *   count = opaque pixels in the run (0-255)
+ * Gaps or runs longer than 255 are split into several pairs.
  */
 struct ShapeFrame {
     int16_t x_offset;       // Draw offset from shape origin
@@ -65,11 +107,110 @@ struct ShapeFrame {
     int16_t width;          // Frame dimensions
     int16_t height;
     std::vector<uint8_t> pixels;  // Decompressed pixel data (width * height)
+    std::vector<uint8_t> spans;   // Span-encoded rows (see above)
+    std::vector<uint32_t> row_offsets;  // height + 1 offsets into spans
 
     ShapeFrame() : x_offset(0), y_offset(0), width(0), height(0) {}
 
     size_t GetSize() const { return static_cast<size_t>(width) * height; }
-    bool IsValid() const { return width > 0 && height > 0 && !pixels.empty(); }
+    bool HasPixels() const { return !pixels.empty(); }
+    bool HasSpans() const { return !row_offsets.empty(); }
+    bool IsValid() const { return width > 0 && height > 0 && (HasPixels() || HasSpans()); }
+
+    /**
+     * Encode dense pixels into spans
+     *
+     * @param release_pixels If true, free the dense pixels afterwards
+     * @return true if spans were built
+     */
+    bool BuildSpans(bool release_pixels = true);
+
+    /**
+     * Encode spans from dense pixels held elsewhere
+     *
+     * @param source width * height pixels
+     * @return true if spans were built
+     */
+    bool BuildSpansFrom(const uint8_t* source);
+
+    /**
+     * Rebuild dense pixels from spans (no-op if pixels already exist)
+     */
+    bool ExpandSpans();
+
+    /**
+     * Get memory used by the cached representation(s)
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * View of this frame's current form
+     */
+    ShapeFrameView View() const;
+};
+
+// =============================================================================
+// Frame Slab
+// =============================================================================
+
+/**
+ * ShapeFrameSlab - The span data of many frames in one block
+ *
+ * Each frame is its row offsets followed by its spans, appended back to
+ * back in the order they come in. A shape's animation frames then share
+ * one allocation and neighbouring frames share cache lines and pages.
+ *
+ * Frames are found by byte offset rather than address, so growing the
+ * block (which moves it) leaves them all valid. Move-only.
+ */
+class ShapeFrameSlab {
+public:
+    ShapeFrameSlab() = default;
+    ShapeFrameSlab(ShapeFrameSlab&& other) noexcept;
+    ShapeFrameSlab& operator=(ShapeFrameSlab&& other) noexcept;
+
+    ShapeFrameSlab(const ShapeFrameSlab&) = delete;
+    ShapeFrameSlab& operator=(const ShapeFrameSlab&) = delete;
+
+    /**
+     * Bytes a span-encoded frame takes in the slab
+     */
+    static size_t GetFrameBytes(int height, size_t spans_size);
+
+    /**
+     * Make room for bytes more, exactly, so a batch of frames whose size
+     * is known up front goes in without regrowing
+     */
+    void Reserve(size_t bytes);
+
+    /**
+     * Copy in a span-encoded frame, doubling the block if it is full
+     *
+     * @return Offset to pass to Rows()/Spans()
+     */
+    uint32_t Append(const ShapeFrame& frame);
+
+    const uint32_t* Rows(uint32_t offset) const {
+        return reinterpret_cast<const uint32_t*>(data_.get() + offset);
+    }
+    const uint8_t* Spans(uint32_t offset, int height) const {
+        return data_.get() + offset + (static_cast<size_t>(height) + 1) * sizeof(uint32_t);
+    }
+
+    size_t GetSize() const { return size_; }
+    size_t GetCapacity() const { return capacity_; }
+
+    /**
+     * Drop every frame and free the block
+     */
+    void Clear();
+
+private:
+    void Grow(size_t capacity);
+
+    std::unique_ptr<uint8_t[]> data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
 };
 
 // =============================================================================
@@ -104,7 +245,10 @@ public:
     // =========================================================================
 
     /**
-     * Load a shape file from MIX archives
+     * Load a shape file from the asset pack or MIX archives
+     *
+     * Shapes in the open AssetPack are used as is (already span-encoded);
+     * anything else is decoded from the MIX archives.
      *
      * @param filename Shape filename (e.g., "MTNK.SHP", "MOUSE.SHP")
      * @return true if loaded successfully
@@ -124,7 +268,7 @@ public:
     /**
      * Check if a shape is loaded
      */
-    bool IsLoaded() const { return shape_ != nullptr; }
+    bool IsLoaded() const { return shape_ != nullptr || packed_ != nullptr; }
 
     /**
      * Unload the current shape and free resources
@@ -220,6 +364,22 @@ public:
     // Drawing - Advanced
     // =========================================================================
 
+    /**
+     * Mark a frame's opaque pixels in a coverage mask
+     *
+     * Each is set to 1, so overlapping frames OR together. Flips and
+     * centering place it as DrawRemapped() would; the render pipeline
+     * gathers a layer's shadows this way and darkens them in one pass.
+     *
+     * @param mask  8-bit mask buffer, 0 = uncovered
+     * @param x, y  Screen coordinates
+     * @param frame Frame index
+     * @param flags Drawing flags (only placement ones apply)
+     * @return true if drawn successfully
+     */
+    bool DrawMask(GraphicsBuffer& mask, int x, int y, int frame,
+                  uint32_t flags = SHAPE_NORMAL);
+
     /**
      * Draw with ghost effect (50% transparency via checkerboard)
      *
@@ -281,16 +441,41 @@ public:
      *
      * Decompresses and caches all frames in memory for fast drawing.
      * Call this for frequently-used shapes to avoid per-draw decompression.
+     *
+     * Shapes from MIX files are first decoded in one in-order pass
+     * (Platform_Shape_DecodeRange), which resolves each XOR delta against
+     * the frame just decoded. Frames are independent after that, so with
+     * several workers each thread claims batches of frames and encodes
+     * them side by side; the calling thread works too.
+     * Shapes with few frames are always done on the calling thread.
+     *
+     * The encoded frames are then copied, in frame order, into a slab
+     * sized for exactly them.
+     *
+     * @param worker_count Threads to use; 0 = one per hardware thread
      */
-    void PrecacheAllFrames();
+    void PrecacheAllFrames(int worker_count = 1);
 
     /**
      * Pre-cache a specific frame
      *
+     * Appends it to the slab, which doubles when full.
+     *
      * @param frame Frame index to cache
      */
     void PrecacheFrame(int frame);
 
+    /**
+     * Cache a frame as a draw with these flags will use it
+     *
+     * Builds the frame (and its mirror, for flipped draws) if needed.
+     * Drawing a prepared frame touches no cache state, so several threads
+     * may then draw it at once, e.g. into separate bands of one buffer.
+     *
+     * @return true if the frame exists
+     */
+    bool PrepareFrame(int frame, uint32_t flags);
+
     /**
      * Clear the frame cache
      *
@@ -303,39 +488,140 @@ public:
      */
     size_t GetCacheSize() const;
 
+    /**
+     * Copy a frame's decoded pixels (index 0 = transparent)
+     *
+     * Used to pack frames into texture atlases.
+     *
+     * @param frame Frame index
+     * @param dst   Destination, at least height rows of width bytes
+     * @param pitch Destination row stride in bytes
+     * @return true if the frame exists and was copied
+     */
+    bool CopyFramePixels(int frame, uint8_t* dst, int pitch);
+
 private:
     // =========================================================================
     // Private Members
     // =========================================================================
 
     PlatformShape* shape_;                   // Platform shape handle
-    std::string name_;                       // Shape filename
+    const uint8_t* packed_;                  // Or: AssetPackShape blob in the pack
+    FixedString<32> name_;                   // Shape filename (8.3 names fit)
     int width_;                              // Max width
     int height_;                             // Max height
     int frame_count_;                        // Number of frames
-    std::vector<ShapeFrame> frame_cache_;    // Cached frame data
+
+    static constexpr uint32_t NOT_IN_SLAB = UINT32_MAX;
+
+    /**
+     * FrameSlot - Where one cached frame lives
+     *
+     * Precached frames are spans in a slab; a frame drawn before it is
+     * precached keeps dense pixels of its own until then.
+     */
+    struct FrameSlot {
+        int16_t x_offset = 0;
+        int16_t y_offset = 0;
+        int16_t width = 0;
+        int16_t height = 0;
+        uint32_t slab_offset = NOT_IN_SLAB;
+        std::vector<uint8_t> pixels;        // Dense form, outside the slab
+
+        bool InSlab() const { return slab_offset != NOT_IN_SLAB; }
+        bool IsCached() const { return width > 0 && (InSlab() || !pixels.empty()); }
+    };
+
+    std::vector<FrameSlot> frame_cache_;     // One per frame
+    ShapeFrameSlab slab_;                    // Their span data
+    std::vector<FrameSlot> flipped_cache_;   // Mirrored frames (lazy, FLIP_VARIANTS per frame)
+    ShapeFrameSlab flipped_slab_;
+
+    // X, Y and XY mirrors of each frame
+    static constexpr int FLIP_VARIANTS = 3;
+
+    // Parallel precache: frames claimed at a time, fewest frames per thread
+    static constexpr int PRECACHE_BATCH_FRAMES = 8;
+    static constexpr int PRECACHE_MIN_FRAMES_PER_WORKER = 32;
 
     // =========================================================================
     // Private Methods
     // =========================================================================
 
+    /**
+     * Point at the shape's blob in the open AssetPack
+     *
+     * @return false if the pack doesn't have it
+     */
+    bool LoadPacked(const char* filename);
+
     /**
      * Get or decompress a frame
      *
-     * Returns cached data if available, otherwise decompresses and caches.
+     * Returns cached data if available, otherwise decompresses and caches
+     * (packed frames go straight into the slab, being spans already).
+     * The view is invalid if the frame is empty, and only lasts until
+     * the next call that caches a frame.
+     */
+    ShapeFrameView GetFrame(int frame);
+
+    /**
+     * Get a frame mirrored per SHAPE_FLIP_X / SHAPE_FLIP_Y
+     *
+     * Mirrors are built on the first flipped draw of each frame and kept
+     * in the same form (dense or spans) as the original, so flipped draws
+     * use the same forward-copy loops. Returns GetFrame() if no flip.
      */
-    const ShapeFrame* GetFrame(int frame);
+    ShapeFrameView GetFlippedFrame(int frame, uint32_t flags);
+
+    /**
+     * Decode a frame to dense pixels (shapes loaded from MIX files)
+     *
+     * Touches no cache state, so workers may decode frames side by side.
+     */
+    bool DecodeFrame(int frame, ShapeFrame& out) const;
+
+    /**
+     * Produce a frame's span form, from the pack or by decoding
+     *
+     * Thread-safe like DecodeFrame() as long as only this frame's slot
+     * is being written.
+     */
+    bool BuildFrameSpans(int frame, ShapeFrame& out) const;
+
+    /**
+     * Put a span-encoded frame in a slab and point the slot at it
+     */
+    static void StoreSpans(FrameSlot& slot, ShapeFrameSlab& slab, const ShapeFrame& frame);
+
+    static ShapeFrameView ViewOf(const FrameSlot& slot, const ShapeFrameSlab& slab);
 
     /**
      * Internal draw implementation
      *
      * All public Draw* methods call this with appropriate parameters.
+     * Span-encoded frames are routed to DrawSpans(). Flip flags are
+     * ignored here; pass a frame from GetFlippedFrame() instead.
      */
     bool DrawInternal(GraphicsBuffer& buffer, int x, int y,
-                      const ShapeFrame& frame,
+                      const ShapeFrameView& frame,
                       const uint8_t* remap_table,
                       uint32_t flags,
                       uint8_t flat_color);
+
+    /**
+     * Span-based draw path
+     *
+     * Destination rectangle is already clipped by DrawInternal.
+     */
+    void DrawSpans(GraphicsBuffer& buffer,
+                   const ShapeFrameView& frame,
+                   int draw_x, int draw_y,
+                   int src_x, int src_y,
+                   int width, int height,
+                   const uint8_t* remap_table,
+                   uint32_t flags,
+                   uint8_t flat_color);
 };
 
 // =============================================================================
@@ -358,6 +644,19 @@ private:
 bool Draw_Shape(GraphicsBuffer& buffer, const char* filename,
                 int x, int y, int frame, uint32_t flags = SHAPE_NORMAL);
 
+/**
+ * Draw a shape frame by handle (no string lookup)
+ *
+ * @param buffer Target graphics buffer
+ * @param id     Handle from ShapeCache::Register
+ * @param x, y   Screen coordinates
+ * @param frame  Frame index
+ * @param flags  Drawing flags
+ * @return true if drawn successfully
+ */
+bool Draw_Shape(GraphicsBuffer& buffer, ShapeId id,
+                int x, int y, int frame, uint32_t flags = SHAPE_NORMAL);
+
 // =============================================================================
 // Shape Cache Manager
 // =============================================================================
@@ -367,6 +666,14 @@ bool Draw_Shape(GraphicsBuffer& buffer, const char* filename,
  *
  * Caches frequently-used shapes to avoid reloading from disk.
  * Use this for shapes that are drawn every frame (units, buildings).
+ *
+ * Lookups are hashed by Westwood filename CRC (case-insensitive, same
+ * as MIX lookups). An optional byte budget bounds total frame cache
+ * memory; when exceeded, the least recently used unpinned shapes are
+ * evicted. Pin shapes that must stay resident (e.g. MOUSE.SHP).
+ *
+ * Pointers returned by Get() stay valid until the shape is removed,
+ * cleared, or evicted by a later load. Pinned shapes are never evicted.
  */
 class ShapeCache {
 public:
@@ -385,13 +692,67 @@ public:
      */
     ShapeRenderer* Get(const char* filename);
 
+    /**
+     * Get a shape renderer by handle (loads if not cached)
+     *
+     * Indexes the handle table directly; the filename is only used if
+     * the shape has to be (re)loaded after eviction or Clear().
+     *
+     * @param id Handle from Register()
+     * @return Pointer to shape renderer, or nullptr on error
+     */
+    ShapeRenderer* Get(ShapeId id);
+
+    /**
+     * Resolve a filename to a stable handle
+     *
+     * Does not load the shape. Registering the same name twice returns
+     * the same handle. Handles stay valid for the life of the process,
+     * including across Clear() and eviction.
+     *
+     * @param filename Shape filename
+     * @return Handle, or SHAPE_ID_NONE if filename is empty
+     */
+    ShapeId Register(const char* filename);
+
+    /**
+     * Get the filename a handle was registered with
+     */
+    const char* Get_Name(ShapeId id) const;
+
     /**
      * Preload a shape into cache
      *
      * @param filename Shape filename
+     * @param pinned   If true, the shape is exempt from budget eviction
      * @return true if loaded successfully
      */
-    bool Preload(const char* filename);
+    bool Preload(const char* filename, bool pinned = false);
+
+    /**
+     * Load a shape into cache on the AssetLoader
+     *
+     * The file is read and parsed on a worker; the shape joins the cache
+     * at the next AssetLoader::Pump(). Until then Get() still loads it
+     * synchronously, in which case the background copy is dropped.
+     *
+     * @param filename Shape filename
+     * @param priority Load priority
+     * @param pinned   If true, the shape is pinned once cached
+     * @return true if a load was queued (false if cached or already queued)
+     */
+    bool PreloadAsync(const char* filename, AssetPriority priority = ASSET_PRIORITY_PREFETCH,
+                      bool pinned = false);
+
+    /**
+     * Check if a shape is cached (without loading it or touching its LRU age)
+     */
+    bool IsCached(const char* filename) { return Find(filename) != nullptr; }
+
+    /**
+     * Check if a background load is in flight for a shape
+     */
+    bool IsLoading(const char* filename) const;
 
     /**
      * Remove a shape from cache
@@ -401,10 +762,58 @@ public:
     void Remove(const char* filename);
 
     /**
-     * Clear entire cache
+     * Clear entire cache (including pinned shapes)
      */
     void Clear();
 
+    /**
+     * Pin or unpin a cached shape
+     *
+     * @param filename Shape filename (must already be cached)
+     * @return true if the shape was found
+     */
+    bool Pin(const char* filename);
+    bool Unpin(const char* filename);
+    bool IsPinned(const char* filename);
+
+    /**
+     * Set the memory budget in bytes (0 = unlimited)
+     *
+     * Shrinking the budget evicts immediately.
+     */
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const { return memory_budget_; }
+
+    /**
+     * Evict least recently used shapes until within budget
+     *
+     * Frame caches grow lazily after Get(), so call this once per frame
+     * (or after precaching) to keep usage bounded.
+     */
+    void Trim();
+
+    /**
+     * Evict least recently used unpinned shapes until bytes are freed
+     *
+     * For MemoryBudget; pinned shapes stay, so less may be freed.
+     *
+     * @return Bytes actually freed (0 while eviction is held)
+     */
+    size_t Release(size_t bytes);
+
+    /**
+     * Hold off budget eviction while renderers from Get() are kept
+     *
+     * Any Get() can go over budget and evict, which frees renderers an
+     * earlier Get() returned. While held, the budget may be exceeded and
+     * Trim(), Release() and loads evict nothing; the last release brings
+     * the cache back within budget. Holds nest. Remove() and Clear()
+     * still free shapes.
+     */
+    void HoldEviction() { eviction_holds_++; }
+    void ReleaseEviction();
+    bool IsEvictionHeld() const { return eviction_holds_ > 0; }
+
     /**
      * Get number of cached shapes
      */
@@ -415,6 +824,11 @@ public:
      */
     size_t GetMemoryUsage() const;
 
+    /**
+     * Get number of shapes evicted since startup
+     */
+    uint32_t GetEvictionCount() const { return eviction_count_; }
+
 private:
     ShapeCache() = default;
     ~ShapeCache();
@@ -423,13 +837,42 @@ private:
     ShapeCache& operator=(const ShapeCache&) = delete;
 
     struct CacheEntry {
+        std::string name;
         std::unique_ptr<ShapeRenderer> renderer;
         int access_count;
+        uint64_t last_access;   // Value of access_clock_ at last Get()
+        bool pinned;
+        ShapeId id;             // Registered handle, or SHAPE_ID_NONE
     };
 
-    std::vector<std::pair<std::string, CacheEntry>> cache_;
+    struct HandleSlot {
+        std::string name;
+        uint32_t key;
+        CacheEntry* entry;      // Null while the shape is not loaded
+    };
+
+    // Keyed by Platform_Westwood_CRC_Filename (collisions resolved by name)
+    std::unordered_multimap<uint32_t, CacheEntry> cache_;
+
+    size_t memory_budget_ = 0;
+    uint64_t access_clock_ = 0;
+    uint32_t eviction_count_ = 0;
+    int eviction_holds_ = 0;
+
+    // Indexed by ShapeId; nodes in cache_ are stable, so raw pointers hold
+    std::vector<HandleSlot> handles_;
+
+    // Names with a PreloadAsync() in flight
+    std::vector<std::string> loading_;
 
+    ShapeId FindHandle(uint32_t key, const char* filename) const;
+    void Erase(std::unordered_multimap<uint32_t, CacheEntry>::iterator it);
+    CacheEntry* Find(uint32_t key, const char* filename);
     CacheEntry* Find(const char* filename);
+    ShapeRenderer* Insert(uint32_t key, const char* filename,
+                          std::unique_ptr<ShapeRenderer> renderer);
+    void EnforceBudget(const CacheEntry* keep);
+    size_t EvictTo(size_t limit, const CacheEntry* keep);
 };
 
 #endif // GAME_GRAPHICS_SHAPE_RENDERER_H
@@ -0,0 +1,53 @@
+/**
+ * Shroud Edges - Precomputed Edge Shapes for Shroud and Fog
+ *
+ * Each cell keeps an 8-neighbour mask (MapClass::Get_Cell_Layers():
+ * shroud_edge / fog_edge) with bit FacingType set when that neighbour is
+ * covered. Only sides, and corners whose two sides are open, change the
+ * look, so the 256 masks reduce to 47 shape frames. The frames are
+ * built once as 24x24 keep masks and drawn with
+ * GraphicsBuffer::Mask_Tile24().
+ *
+ * Usage:
+ *   int frame = Shroud_Edge_Frame(layers->shroud_edge[index]);
+ *   if (frame != 0) buffer.Mask_Tile24(Shroud_Edge_Shape(frame), x, y);
+ *
+ * Original: CODE/DISPLAY.CPP (Redraw_Shadow), CODE/CELL.CPP (Cell_Shadow)
+ */
+
+#ifndef GAME_GRAPHICS_SHROUD_EDGES_H
+#define GAME_GRAPHICS_SHROUD_EDGES_H
+
+#include <cstdint>
+
+// Distinct edge shapes, including frame 0 (no edge)
+constexpr int SHROUD_EDGE_FRAMES = 47;
+
+/**
+ * Reduce a neighbour mask to the bits that affect the shape
+ *
+ * Corner bits are dropped when either adjacent side is covered.
+ */
+uint8_t Shroud_Edge_Reduce(uint8_t mask);
+
+/**
+ * Shape frame for a neighbour mask (0 = no edge, nothing to draw)
+ */
+int Shroud_Edge_Frame(uint8_t mask);
+
+/**
+ * Keep mask for a shroud edge frame (576 bytes, 0x00 = black)
+ */
+const uint8_t* Shroud_Edge_Shape(int frame);
+
+/**
+ * Keep mask for a fog edge frame (576 bytes, dithered toward the fog)
+ */
+const uint8_t* Fog_Edge_Shape(int frame);
+
+/**
+ * Keep mask for a cell that is itself fogged (even dither)
+ */
+const uint8_t* Fog_Fill_Shape();
+
+#endif // GAME_GRAPHICS_SHROUD_EDGES_H
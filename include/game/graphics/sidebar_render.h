@@ -11,14 +11,17 @@
 
 #include "game/graphics/graphics_buffer.h"
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 // =============================================================================
 // Forward Declarations
 // =============================================================================
 
+class BlitBatch;
 class ShapeRenderer;
 class PaletteManager;
+class HouseEconomy;
 
 // =============================================================================
 // Constants
@@ -38,6 +41,11 @@ constexpr int ICON_HEIGHT = 48;
 constexpr int ICONS_PER_COLUMN = 4;
 constexpr int ICON_COLUMNS = 2;
 
+// Power bar (left edge, beside the build icons) and credits readout
+constexpr int POWER_BAR_X = 2;
+constexpr int POWER_BAR_WIDTH = 4;
+constexpr int CREDITS_Y = 260;
+
 // Button positions
 constexpr int REPAIR_BUTTON_Y = 320;
 constexpr int SELL_BUTTON_Y = 344;
@@ -205,6 +213,33 @@ public:
      */
     int GetBuildItemCount() const { return static_cast<int>(build_items_[static_cast<int>(active_tab_)].size()); }
 
+    // =========================================================================
+    // Economy
+    // =========================================================================
+
+    /**
+     * Set the credits readout
+     */
+    void SetCredits(int credits);
+    int GetCredits() const { return credits_; }
+
+    /**
+     * Set the power bar
+     */
+    void SetPower(int output, int drain);
+
+    /**
+     * Bring the sidebar up to date with a house's economy
+     *
+     * Only what the ECON_* bits in events name is read: credits, the power
+     * bar, and the progress and hold state of build items (buildings on
+     * the structure tab, everything else on the unit tab). With no events
+     * nothing is touched and the cached panel stays as it is.
+     *
+     * @param events Bits from HouseEconomy::Take_Events
+     */
+    void ApplyEconomy(const HouseEconomy& economy, uint32_t events);
+
     // =========================================================================
     // Button States
     // =========================================================================
@@ -212,17 +247,17 @@ public:
     /**
      * Set repair button state
      */
-    void SetRepairButtonState(ButtonState state) { repair_state_ = state; }
+    void SetRepairButtonState(ButtonState state) { SetButtonState(repair_state_, state); }
 
     /**
      * Set sell button state
      */
-    void SetSellButtonState(ButtonState state) { sell_state_ = state; }
+    void SetSellButtonState(ButtonState state) { SetButtonState(sell_state_, state); }
 
     /**
      * Set map button state
      */
-    void SetMapButtonState(ButtonState state) { map_state_ = state; }
+    void SetMapButtonState(ButtonState state) { SetButtonState(map_state_, state); }
 
     /**
      * Get repair button state
@@ -245,10 +280,30 @@ public:
 
     /**
      * Draw the complete sidebar
+     *
+     * The panel is cached in its own buffer and redrawn only after a
+     * change (tab switch, scroll, build list edit, a progress tick that
+     * moves the bar, button state). Otherwise this is one Blit_From.
+     *
      * @param buffer Target graphics buffer
      */
     void Draw(GraphicsBuffer& buffer);
 
+    /**
+     * Force the cached panel to be redrawn on the next Draw()
+     */
+    void InvalidatePanel() { panel_dirty_ = true; }
+
+    /**
+     * Will the next Draw() redraw the panel?
+     */
+    bool IsPanelDirty() const { return panel_dirty_; }
+
+    /**
+     * Number of times the panel has been redrawn (for profiling/tests)
+     */
+    int GetPanelRedrawCount() const { return panel_redraws_; }
+
     /**
      * Draw just the tab bar
      */
@@ -269,6 +324,11 @@ public:
      */
     void DrawScrollArrows(GraphicsBuffer& buffer);
 
+    /**
+     * Draw the power bar and credits readout
+     */
+    void DrawEconomy(GraphicsBuffer& buffer);
+
     // =========================================================================
     // Hit Testing
     // =========================================================================
@@ -341,9 +401,19 @@ public:
 private:
     // Internal draw helpers
     void DrawBackground(GraphicsBuffer& buffer);
-    void DrawBuildIcon(GraphicsBuffer& buffer, int x, int y, const BuildQueueItem& item);
-    void DrawProgressBar(GraphicsBuffer& buffer, int x, int y, int width, float progress);
+    void DrawBuildIconFrame(BlitBatch& batch, int x, int y);
+    void DrawBuildIconStatus(BlitBatch& batch, int x, int y, const BuildQueueItem& item);
+    void DrawProgressBar(BlitBatch& batch, int x, int y, int width, float progress);
     void DrawButton(GraphicsBuffer& buffer, int x, int y, int frame, ButtonState state);
+    void DrawContents(GraphicsBuffer& buffer);
+    void RenderPanel();
+    void SetItemState(BuildQueueItem& item, float progress, bool on_hold);
+    void SetButtonState(ButtonState& slot, ButtonState state) {
+        if (slot != state) {
+            slot = state;
+            panel_dirty_ = true;
+        }
+    }
 
     // State
     bool initialized_;
@@ -358,6 +428,11 @@ private:
     // Build items per tab
     std::vector<BuildQueueItem> build_items_[static_cast<int>(SidebarTab::COUNT)];
 
+    // Economy readouts
+    int credits_;
+    int power_output_;
+    int power_drain_;
+
     // Button states
     ButtonState repair_state_;
     ButtonState sell_state_;
@@ -366,6 +441,11 @@ private:
     // Graphics
     std::unique_ptr<ShapeRenderer> icons_;
     std::unique_ptr<ShapeRenderer> buttons_;
+
+    // Cached panel, drawn with the sidebar at (0, 0)
+    std::unique_ptr<GraphicsBuffer> panel_;
+    bool panel_dirty_;
+    int panel_redraws_;
 };
 
 #endif // GAME_GRAPHICS_SIDEBAR_RENDER_H
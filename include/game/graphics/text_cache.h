@@ -0,0 +1,122 @@
+/**
+ * Text Cache - Pre-Decoded Glyphs and Cached String Spans
+ *
+ * Menu and gadget text is drawn every frame but rarely changes. Each
+ * font's glyphs are decoded once into horizontal pixel runs, and each
+ * drawn string is laid out once into a list of spans (row, x, length)
+ * keyed by (text, font, colour). Drawing a cached string is one
+ * Draw_HLine per span; no glyph lookup or bit testing per pixel.
+ *
+ * The cache holds a fixed number of strings and drops the least
+ * recently used one when full, so changing text (timers, counters)
+ * cannot grow it without bound.
+ *
+ * Usage:
+ *   TextCache& text = TextCache::Instance();
+ *   text.Draw(screen, "START NEW GAME", x, y, TEXT_FONT_MENU, color);
+ *
+ * Original: CODE/LOADFONT.CPP, WIN32LIB/FONT.CPP (Buffer_Print)
+ */
+
+#ifndef GAME_GRAPHICS_TEXT_CACHE_H
+#define GAME_GRAPHICS_TEXT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GraphicsBuffer;
+
+/**
+ * Fonts known to the cache
+ */
+enum TextFontType : uint8_t {
+    TEXT_FONT_MENU = 0,         // 5x7 uppercase bitmap font
+    TEXT_FONT_COUNT
+};
+
+/**
+ * One horizontal run of text pixels, relative to the string's top-left
+ */
+struct TextSpan {
+    int16_t x;
+    uint8_t y;
+    uint8_t length;
+};
+
+/**
+ * A laid-out string
+ */
+struct TextLayout {
+    int width = 0;
+    int height = 0;
+    uint8_t color = 0;
+    std::vector<TextSpan> spans;
+};
+
+/**
+ * TextCache - Glyph spans per font plus an LRU of laid-out strings
+ */
+class TextCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    explicit TextCache(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Shared cache used by the menus and gadgets
+     */
+    static TextCache& Instance();
+
+    /**
+     * Width/height in pixels of a string (no layout needed)
+     */
+    static int Text_Width(const char* text, TextFontType font);
+    static int Text_Height(TextFontType font);
+
+    /**
+     * Laid-out spans for a string, building them on a miss
+     *
+     * @return valid until the next Get_Layout() or Clear(); nullptr for
+     *         null text or an unknown font
+     */
+    const TextLayout* Get_Layout(const char* text, TextFontType font, uint8_t color);
+
+    /**
+     * Draw a string with its top-left at (x, y); buffer must be locked
+     */
+    void Draw(GraphicsBuffer& buffer, const char* text, int x, int y,
+              TextFontType font, uint8_t color);
+
+    /**
+     * Drop every cached string
+     */
+    void Clear();
+
+    size_t Size() const { return entries_.size(); }
+    size_t Get_Capacity() const { return capacity_; }
+    uint32_t Get_Hits() const { return hits_; }
+    uint32_t Get_Misses() const { return misses_; }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        TextFontType font;
+        uint8_t color;
+        uint32_t last_used;
+        std::string text;
+        TextLayout layout;
+    };
+
+    static uint32_t Hash(const char* text, TextFontType font, uint8_t color);
+    static void Build_Layout(const char* text, TextFontType font, TextLayout& layout);
+
+    std::vector<Entry> entries_;
+    size_t capacity_;
+    uint32_t clock_ = 0;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+};
+
+#endif // GAME_GRAPHICS_TEXT_CACHE_H
@@ -8,6 +8,10 @@
  *   TileRenderer::Instance().SetTheater(THEATER_TEMPERATE);
  *   TileRenderer::Instance().DrawTile(buffer, x, y, template_type, icon);
  *
+ * Background loading:
+ *   renderer.BeginTheaterLoad(THEATER_SNOW);   // palette now, tiles on a worker
+ *   renderer.UpdateTheaterLoad();              // each frame; swaps tiles in when done
+ *
  * Original: CODE/DISPLAY.CPP, CODE/CELL.CPP
  */
 
@@ -21,6 +25,7 @@
 #include <unordered_map>
 
 // Include map.h for TheaterType definition (avoid redefinition)
+#include "game/asset_loader.h"
 // NOTE: map.h includes gscreen.h, coord.h but NOT tile_renderer.h, so no circular dependency
 #include "game/map.h"
 
@@ -28,8 +33,10 @@
 #include "game/cell.h"
 
 // Forward declarations
+class AssetPackWriter;
 class GraphicsBuffer;
 struct PlatformTemplate;
+struct TheaterLoadJob;
 
 // =============================================================================
 // Constants
@@ -116,15 +123,16 @@ struct TemplateData {
     int width;                      // Width in cells
     int height;                     // Height in cells
     int tile_count;                 // Number of tiles
-    std::vector<uint8_t> pixels;    // All tile pixels (tile_count * 576)
+    const uint8_t* tiles;           // All tile pixels (tile_count * 576)
+    std::vector<uint8_t> pixels;    // Owns tiles when not in the theater atlas
     std::vector<LandType> land;     // Land type per tile position
 
     /**
      * Get pixel data for a specific tile
      */
     const uint8_t* GetTile(int index) const {
-        if (index < 0 || index >= tile_count) return nullptr;
-        return pixels.data() + index * TILE_SIZE;
+        if (index < 0 || index >= tile_count || !tiles) return nullptr;
+        return tiles + index * TILE_SIZE;
     }
 
     /**
@@ -136,6 +144,15 @@ struct TemplateData {
     }
 };
 
+/**
+ * TileRunEntry - One cell of a horizontal run passed to DrawTileRun()
+ */
+struct TileRunEntry {
+    TemplateType tmpl;              // TEMPLATE_NONE draws clear terrain
+    uint8_t icon;                   // Icon index within template
+    uint32_t seed;                  // Clear variation (usually the cell index)
+};
+
 // =============================================================================
 // TileRenderer Class
 // =============================================================================
@@ -179,6 +196,43 @@ public:
      */
     bool IsTheaterLoaded() const { return current_theater_ != THEATER_NONE; }
 
+    /**
+     * Switch theater and decode its templates on a worker thread
+     *
+     * The palette is applied immediately (as SetTheater). All templates
+     * are decoded into one contiguous tile atlas off the main thread;
+     * until UpdateTheaterLoad() swaps it in, templates still load on
+     * demand. A load already in progress is cancelled. If the open
+     * AssetPack has the theater's atlas it is installed at once instead.
+     *
+     * @return false if the theater is invalid
+     */
+    bool BeginTheaterLoad(TheaterType theater);
+
+    /**
+     * Install the background load's atlas once it has finished
+     *
+     * Call once per frame from the main thread.
+     *
+     * @return true while a load is still in progress
+     */
+    bool UpdateTheaterLoad();
+
+    /**
+     * Block until the background load finishes, then install it
+     */
+    void WaitForTheaterLoad();
+
+    /**
+     * Check if a background theater load is in progress
+     */
+    bool IsTheaterLoading() const;
+
+    /**
+     * Background load progress (0.0 - 1.0; 1.0 when idle)
+     */
+    float GetTheaterLoadProgress() const;
+
     // =========================================================================
     // Tile Drawing
     // =========================================================================
@@ -196,6 +250,33 @@ public:
     bool DrawTile(GraphicsBuffer& buffer, int x, int y,
                   TemplateType tmpl, int icon);
 
+    /**
+     * Draw a tile known to lie fully inside the buffer
+     *
+     * No clipping or bounds checks: for interior cells classified by
+     * the caller. Edge cells go through DrawTile().
+     *
+     * @return false if the template or buffer isn't ready (nothing drawn)
+     */
+    bool DrawTileInterior(GraphicsBuffer& buffer, int x, int y,
+                          TemplateType tmpl, int icon);
+
+    /**
+     * Draw a horizontal run of tiles, one cell apart, starting at (x, y)
+     *
+     * Tile pointers for the whole run are resolved first, then copied in
+     * one tight loop. Bounds are checked once for the run: a run fully
+     * inside the buffer takes the unclipped path for every tile. Missing
+     * templates fall back to clear terrain, as in DisplayClass.
+     *
+     * @param buffer     Target graphics buffer (must be locked)
+     * @param tiles      Template/icon pairs, left to right
+     * @param count      Number of entries
+     * @return number of tiles drawn from their own template
+     */
+    int DrawTileRun(GraphicsBuffer& buffer, int x, int y,
+                    const TileRunEntry* tiles, int count);
+
     /**
      * Draw a terrain tile with land type lookup
      */
@@ -209,6 +290,14 @@ public:
      */
     void DrawClear(GraphicsBuffer& buffer, int x, int y, uint32_t seed = 0);
 
+    /**
+     * Draw a tile's pixels, clipped, or the clear fill if pixels is null
+     *
+     * Reads no TileRenderer state, so any thread may draw tiles looked up
+     * beforehand (see GetTilePixels) while this one loads templates.
+     */
+    static void DrawTilePixels(GraphicsBuffer& buffer, int x, int y, const uint8_t* pixels);
+
     // =========================================================================
     // Overlay Drawing
     // =========================================================================
@@ -228,6 +317,17 @@ public:
      */
     const TemplateData* GetTemplate(TemplateType tmpl);
 
+    /**
+     * Get a tile's TILE_SIZE pixels (loads the template if needed)
+     *
+     * Valid until the template cache is cleared or the theater changes.
+     *
+     * @return Pixels, or nullptr if the template is missing
+     */
+    const uint8_t* GetTilePixels(TemplateType tmpl, int icon) {
+        return LookupTile(tmpl, icon, nullptr);
+    }
+
     /**
      * Get number of tiles in a template
      */
@@ -238,15 +338,50 @@ public:
      */
     LandType GetLandType(TemplateType tmpl, int icon);
 
+    /**
+     * Get filename for template type in the current theater
+     */
+    std::string GetTemplateFilename(TemplateType tmpl) const;
+
+    /**
+     * AssetPack entry holding a theater's tile atlas (e.g. "SNOW.ATL")
+     */
+    static std::string GetPackedAtlasName(TheaterType theater);
+
+    /**
+     * Decode a theater's templates and add them to a pack as its atlas
+     *
+     * Leaves the renderer alone, so it may run on a worker (only MIX
+     * reads and template parsing).
+     *
+     * @return false if the theater has no templates
+     */
+    static bool PackTheater(TheaterType theater, AssetPackWriter& writer);
+
     // =========================================================================
     // Cache Management
     // =========================================================================
 
     /**
      * Preload all templates for current theater
+     *
+     * Decodes every template into one contiguous tile atlas.
      */
     void PreloadAllTemplates();
 
+    /**
+     * Load one template on the AssetLoader
+     *
+     * Read, parse and tile copy run on a worker; the template joins the
+     * cache at the next AssetLoader::Pump(). Results for a theater or
+     * cache that has since changed are dropped. Templates in the
+     * AssetPack need no decoding and are loaded at once.
+     *
+     * @return true if a load was queued (false if loaded, missing,
+     *         already queued, packed, or covered by a theater load in flight)
+     */
+    bool LoadTemplateAsync(TemplateType tmpl, AssetPriority priority = ASSET_PRIORITY_VISIBLE);
+
     /**
      * Clear template cache
      */
@@ -270,6 +405,23 @@ private:
     // Template cache (indexed by TemplateType)
     std::unordered_map<int, std::unique_ptr<TemplateData>> template_cache_;
 
+    // Tiles of every preloaded template, packed end to end
+    std::vector<uint8_t> tile_atlas_;
+    bool atlas_packed_ = false;                           // Templates point into the AssetPack
+
+    // Dense views of template_cache_, rebuilt whenever it changes
+    const TemplateData* template_table_[TEMPLATE_COUNT];  // null = not loaded
+    bool template_missing_[TEMPLATE_COUNT];               // Load failed; don't retry
+    bool template_pending_[TEMPLATE_COUNT];               // LoadTemplateAsync in flight
+    uint32_t cache_generation_ = 0;                       // Bumped by ClearCache()
+    int tile_base_[TEMPLATE_COUNT + 1];                   // First tile slot per template
+    std::vector<const uint8_t*> tile_table_;              // (template, icon) -> pixels
+    std::vector<LandType> tile_land_;                     // (template, icon) -> land
+    std::vector<const uint8_t*> run_pixels_;              // DrawTileRun scratch
+
+    // Background theater load (null when idle)
+    std::unique_ptr<TheaterLoadJob> load_job_;
+
     // Overlay shape data (indexed by OverlayType)
     std::unordered_map<int, std::vector<uint8_t>> overlay_cache_;
 
@@ -283,14 +435,38 @@ private:
     TemplateData* LoadTemplate(TemplateType tmpl);
 
     /**
-     * Load an overlay shape
+     * Find tile pixels through the dense tables (loads on first use)
+     *
+     * Out-of-range icons fall back to icon 0.
      */
-    bool LoadOverlay(OverlayType overlay);
+    const uint8_t* LookupTile(TemplateType tmpl, int icon, LandType* land_out);
 
     /**
-     * Get filename for template type
+     * Rebuild the dense template and tile tables from template_cache_
      */
-    std::string GetTemplateFilename(TemplateType tmpl) const;
+    void RebuildTileTable();
+
+    /**
+     * Cancel and discard any background load
+     */
+    void CancelTheaterLoad();
+
+    /**
+     * Swap a finished job's atlas and templates into the cache
+     */
+    void InstallTheaterLoad(TheaterLoadJob& job);
+
+    /**
+     * Install the current theater's atlas from the AssetPack
+     *
+     * @return false if the pack doesn't have it
+     */
+    bool InstallPackedTheater();
+
+    /**
+     * Load an overlay shape
+     */
+    bool LoadOverlay(OverlayType overlay);
 
     /**
      * Get filename for overlay type
@@ -20,11 +20,14 @@
 
 #pragma once
 
+#include "game/gadget_grid.h"
 #include <cstdint>
 #include <cstddef>
+#include <vector>
 
 // Forward declarations
 class GadgetClass;
+struct GadgetInput;
 
 // =============================================================================
 // Screen Constants
@@ -250,11 +253,37 @@ public:
     int Process_Gadgets(int input);
 
     /**
-     * Draw_Gadgets - Draw all gadgets
+     * Process_Gadgets - Process one input state
      *
-     * Called during Render to draw UI elements.
+     * Only the gadgets under the mouse (found through the gadget grid),
+     * those holding the mouse, and keyboard gadgets when a key is down
+     * see the input; to any other gadget it would be a no-op. They see it
+     * in list order, as if the whole list were walked. Also moves the
+     * hover to the topmost visible gadget under the mouse.
+     *
+     * @return ID of activated gadget, or 0
      */
-    void Draw_Gadgets();
+    int Process_Gadgets(const GadgetInput& input);
+
+    /**
+     * Draw_Gadgets - Draw gadgets that need it
+     *
+     * Called during Render to draw UI elements. Only gadgets queued as
+     * dirty since the last call are drawn, in list order.
+     *
+     * @param forced Draw every visible gadget
+     */
+    void Draw_Gadgets(bool forced = false);
+
+    /**
+     * Queue a dirty gadget for the next Draw_Gadgets (GadgetClass::Set_Dirty)
+     */
+    void Queue_Gadget_Draw(GadgetClass* gadget);
+
+    /**
+     * A gadget was moved or resized; re-index before the next hit test
+     */
+    void Gadget_Layout_Changed() { gadget_layout_dirty_ = true; }
 
     // -------------------------------------------------------------------------
     // Screen State
@@ -289,6 +318,15 @@ protected:
     // Gadget list (simple linked list)
     GadgetClass* gadget_head_; // First gadget in list
 
+    // Gadget hit testing and redraw
+    GadgetGrid gadget_grid_;                    // Rebuilt when the layout changes
+    bool gadget_layout_dirty_;                  // Grid and order are stale
+    GadgetClass* gadget_hover_;                 // Topmost gadget under the mouse
+    std::vector<GadgetClass*> gadget_dirty_;    // Queued for Draw_Gadgets
+    std::vector<GadgetClass*> gadget_pressed_;  // Holding the mouse
+    std::vector<GadgetClass*> gadget_keyboard_; // GADGET_KEYBOARD gadgets
+    std::vector<GadgetClass*> gadget_scratch_;  // Process_Gadgets working set
+
     // -------------------------------------------------------------------------
     // Protected Helpers
     // -------------------------------------------------------------------------
@@ -302,6 +340,11 @@ protected:
      * Check if coordinates are within screen bounds
      */
     bool In_Bounds(int x, int y) const;
+
+    /**
+     * Re-index gadgets for hit testing and renumber their list order
+     */
+    void Rebuild_Gadget_Index();
 };
 
 // =============================================================================
@@ -0,0 +1,111 @@
+/**
+ * IncrementalLoader - Work done a slice per frame instead of all at once
+ *
+ * Starting a scenario reads the map, parses the manifest, resets every
+ * cell and creates every object. Done in one call it freezes the window
+ * for as long as that takes. An IncrementalLoader holds the same work as
+ * a list of steps and Pump() runs as many of them as fit in a time
+ * budget, so the frame loop keeps drawing the load screen in between.
+ *
+ * A step is called until it returns true, so a long one (creating a few
+ * hundred objects) can do a slice per call and pick up where it left off.
+ * Pump() always makes at least one step call, then keeps going while the
+ * budget lasts; a step that overruns the budget only delays the frame.
+ *
+ * Steps that do not depend on one another and only touch their own data
+ * can be added with Add_Parallel(). A run of them is handed to the
+ * AssetLoader workers together, and the step after the run waits until
+ * all of them are done. Without AssetLoader::Start() they run inline.
+ *
+ * Usage:
+ *   loader.Add_Parallel("Map", [&]() { map = Read_Map(); });
+ *   loader.Add_Parallel("Manifest", [&]() { manifest.Parse(...); });
+ *   loader.Add("Objects", [&]() { return Create_Some_Objects(); });
+ *   ...
+ *   if (loader.Pump(8.0)) { ... }  // Once per frame until it returns true
+ */
+
+#ifndef GAME_INCREMENTAL_LOADER_H
+#define GAME_INCREMENTAL_LOADER_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// IncrementalLoader
+// =============================================================================
+
+class IncrementalLoader {
+public:
+    using StepFn = std::function<bool()>;   // Returns true once finished
+    using WorkFn = std::function<void()>;
+
+    IncrementalLoader() = default;
+
+    IncrementalLoader(const IncrementalLoader&) = delete;
+    IncrementalLoader& operator=(const IncrementalLoader&) = delete;
+
+    /**
+     * Add a step run on the calling thread, called until it returns true
+     */
+    void Add(const char* name, StepFn step);
+
+    /**
+     * Add a step run once on a worker, alongside the parallel steps
+     * added right before or after it
+     */
+    void Add_Parallel(const char* name, WorkFn work);
+
+    /**
+     * Drop every step
+     *
+     * Parallel work already handed out still finishes; what it writes
+     * must outlive it.
+     */
+    void Clear();
+
+    /**
+     * Run steps until the budget is spent or they are all finished
+     *
+     * @param budget_ms Time to spend; at least one step call is made
+     * @return true once every step has finished
+     */
+    bool Pump(double budget_ms);
+
+    bool Is_Done() const { return next_ >= steps_.size(); }
+
+    /**
+     * Finished steps, as a share of all of them (0..1)
+     */
+    float Get_Progress() const;
+
+    /**
+     * Name of the step running now ("" when done)
+     */
+    const char* Get_Step_Name() const;
+
+    size_t Get_Step_Count() const { return steps_.size(); }
+
+private:
+    /**
+     * Hand out the parallel run at next_ if not yet; true once it is done
+     */
+    bool Join_Group();
+
+    struct Step {
+        std::string name;
+        StepFn step;                // Empty for a parallel step
+        WorkFn work;
+    };
+
+    std::vector<Step> steps_;
+    size_t next_ = 0;                           // First unfinished step
+    size_t group_end_ = 0;                      // End of the parallel run handed out
+    std::shared_ptr<std::atomic<int>> running_; // Parallel steps not yet finished
+};
+
+#endif // GAME_INCREMENTAL_LOADER_H
@@ -0,0 +1,198 @@
+/**
+ * INIClass - Zero-copy INI reader with hashed lookups
+ *
+ * Load() makes one pass over the text and records every section and
+ * entry as a view into it; nothing is copied and no string is built.
+ * Sections and entries are then found through hash tables keyed on the
+ * case-folded name, so a lookup costs one hash and usually one compare
+ * however large the file is. RULES.INI-sized files answer thousands of
+ * type queries without a single linear search.
+ *
+ * Names compare case-insensitively, as in the original. A section that
+ * appears twice is one section; an entry that appears twice keeps the
+ * last value.
+ *
+ * The text must outlive the INIClass. Load_File maps the file and keeps
+ * the mapping itself.
+ *
+ * Usage:
+ *   INIClass rules;
+ *   rules.Load_File("RULES.INI");
+ *   int cost = rules.Get_Int("MTNK", "Cost", 0);
+ *   fixed armor = rules.Get_Fixed("General", "RepairPercent", fixed::Ratio(1, 4));
+ *
+ * Original location: CODE/INI.CPP, CODE/CCINI.CPP
+ */
+
+#pragma once
+
+#include "game/fixed.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// =============================================================================
+// Name Hashing
+// =============================================================================
+
+/**
+ * Case-insensitive FNV-1a hash of a name
+ */
+inline uint32_t INI_Hash(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - ('a' - 'A'));
+        }
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Case-insensitive name compare
+ */
+bool INI_Equal(std::string_view a, std::string_view b);
+
+/**
+ * NameIndex - Open-addressed hash table from name hashes to indices
+ *
+ * Holds only (hash, index) pairs; the caller keeps the names and checks
+ * the candidate a hash leads to, so colliding names still resolve.
+ */
+class NameIndex {
+public:
+    /**
+     * Empty the table and size it for count names
+     */
+    void Reset(int count);
+
+    void Add(uint32_t hash, int index);
+
+    /**
+     * First index with this hash that match(index) accepts, or -1
+     */
+    template <typename Match>
+    int Find(uint32_t hash, Match match) const {
+        if (slots_.empty()) {
+            return -1;
+        }
+        for (size_t slot = hash & mask_;; slot = (slot + 1) & mask_) {
+            const Slot& s = slots_[slot];
+            if (s.index < 0) {
+                return -1;
+            }
+            if (s.hash == hash && match(s.index)) {
+                return s.index;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        int32_t index;          // -1 = empty
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t count_ = 0;
+};
+
+// =============================================================================
+// INIClass
+// =============================================================================
+
+class INIClass {
+public:
+    INIClass() = default;
+    ~INIClass();
+
+    INIClass(const INIClass&) = delete;
+    INIClass& operator=(const INIClass&) = delete;
+
+    /**
+     * Index INI text in place (replaces anything loaded before)
+     *
+     * @return false if the text holds no section
+     */
+    bool Load(const char* text, size_t length);
+
+    /**
+     * Map a file and index it; the mapping lives until Clear
+     */
+    bool Load_File(const char* path);
+
+    /**
+     * Forget everything (and unmap a file loaded by Load_File)
+     */
+    void Clear();
+
+    // -------------------------------------------------------------------------
+    // Sections and Entries
+    // -------------------------------------------------------------------------
+
+    int Section_Count() const { return static_cast<int>(sections_.size()); }
+    std::string_view Get_Section_Name(int index) const { return sections_[index].name; }
+
+    bool Is_Present(std::string_view section) const { return Find_Section(section) >= 0; }
+    bool Is_Present(std::string_view section, std::string_view entry) const;
+
+    /**
+     * Entries of a section, in file order (0 if the section is missing)
+     */
+    int Entry_Count(std::string_view section) const;
+    std::string_view Get_Entry(std::string_view section, int index) const;
+
+    // -------------------------------------------------------------------------
+    // Values
+    // -------------------------------------------------------------------------
+
+    /**
+     * Raw value (trimmed), or def if absent
+     */
+    std::string_view Get_String(std::string_view section, std::string_view entry,
+                                std::string_view def = std::string_view()) const;
+
+    /**
+     * Decimal, or hex with a leading '$'; def if absent or not a number
+     */
+    int Get_Int(std::string_view section, std::string_view entry, int def = 0) const;
+
+    /**
+     * yes/no, true/false, 1/0 (first letter decides); def otherwise
+     */
+    bool Get_Bool(std::string_view section, std::string_view entry, bool def = false) const;
+
+    /**
+     * "25%" or "0.25"; def if absent or malformed
+     */
+    fixed Get_Fixed(std::string_view section, std::string_view entry, fixed def = fixed()) const;
+
+private:
+    struct Section {
+        std::string_view name;
+        std::vector<int> entries;       // Indices into entries_, file order
+    };
+
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+        int section;
+    };
+
+    static uint32_t Entry_Hash(int section, std::string_view key) {
+        return INI_Hash(key) ^ (static_cast<uint32_t>(section) * 0x9E3779B1u);
+    }
+
+    int Find_Section(std::string_view section) const;
+    int Find_Entry(std::string_view section, std::string_view entry) const;
+    int Find_Entry(int section, std::string_view entry) const;
+
+    std::vector<Section> sections_;
+    std::vector<Entry> entries_;
+    NameIndex section_index_;
+    NameIndex entry_index_;
+    const uint8_t* mapped_ = nullptr;   // From Load_File
+};
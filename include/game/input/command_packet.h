@@ -0,0 +1,57 @@
+// include/game/input/command_packet.h
+// Compact command packets shared by local execution and the network
+// Task 16f - Command System
+
+#ifndef COMMAND_PACKET_H
+#define COMMAND_PACKET_H
+
+#include "game/input/command_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//=============================================================================
+// Command Packet
+//=============================================================================
+
+// One order for a whole group, like an event in the original's EVENT.CPP.
+// Units are carried as object ids, sorted, so the wire form can store each
+// as a varint delta from the one before: a box-selected group of adjacent
+// ids packs to about a byte per unit after the fixed header.
+struct CommandPacket {
+    // type, target type, flags, frame, world x/y, cell x/y, object id, unit count
+    static constexpr size_t HEADER_SIZE = 26;
+    static constexpr int MAX_UNITS = 0xFFFF;
+
+    uint32_t frame;                     // Flush the packet went out in
+    CommandType type;
+    uint32_t flags;                     // CommandFlags (low 16 bits on the wire)
+    CommandTarget::Type target_type;
+    int32_t world_x;
+    int32_t world_y;
+    int16_t cell_x;
+    int16_t cell_y;
+    uint32_t object_id;
+    std::vector<uint32_t> units;        // Ascending, no duplicates
+
+    void Clear();
+
+    // Copy type, flags and target (the object pointer stays behind)
+    void SetCommand(const Command& cmd);
+
+    // The command to run on this packet's units; object targets carry only
+    // their id
+    Command GetCommand() const;
+
+    // Replace the unit list, sorting and dropping duplicates
+    void SetUnits(const uint32_t* ids, int count);
+
+    // Append the wire form; returns bytes written
+    size_t Write(std::vector<uint8_t>& out) const;
+
+    // Parse one packet from the front of data; returns bytes read, 0 if
+    // data is short or malformed
+    size_t Read(const uint8_t* data, size_t size);
+};
+
+#endif // COMMAND_PACKET_H
@@ -6,6 +6,7 @@
 #define COMMAND_SYSTEM_H
 
 #include "game/input/command_types.h"
+#include "game/input/command_packet.h"
 #include "game/input/cursor_context.h"
 #include "game/input/selection_manager.h"
 #include <functional>
@@ -17,6 +18,9 @@
 
 class CommandSystem {
 public:
+    // Move orders for more units than this share one flow field
+    static constexpr int FLOW_FIELD_THRESHOLD = 8;
+
     // Singleton access
     static CommandSystem& Instance();
 
@@ -55,6 +59,32 @@ public:
     CommandResult IssueSellCommand(void* building);
     CommandResult IssueRepairCommand(void* building);
 
+    //=========================================================================
+    // Command Packets
+    //=========================================================================
+
+    // Run a packet from elsewhere (the network) on its units, leaving the
+    // local selection alone
+    CommandResult ExecutePacket(const CommandPacket& packet);
+
+    // Read and run every packet in a flushed buffer; returns packets run,
+    // stopping at the first malformed one
+    int ExecutePackets(const uint8_t* data, size_t size);
+
+    // Receives the packets issued since the last flush, in wire form.
+    // Without a sink, issued commands are not kept as packets.
+    using PacketSinkFunc = std::function<void(const uint8_t* data, size_t size, int count)>;
+    void SetPacketSink(PacketSinkFunc func) { send_packets_ = func; }
+
+    // Hand this frame's packets to the sink (once per frame)
+    void FlushPackets();
+
+    int GetPendingPacketCount() const { return pending_count_; }
+    uint32_t GetPacketFrame() const { return packet_frame_; }
+
+    // Packet built for the last issued command
+    const CommandPacket& GetLastPacket() const { return last_packet_; }
+
     //=========================================================================
     // Callbacks for Game Integration
     //=========================================================================
@@ -65,6 +95,14 @@ public:
 
     void SetAssignMissionCallback(AssignMissionFunc func) { assign_mission_ = func; }
 
+    // Assign one mission to many units at once; returns how many took it.
+    // Preferred over AssignMissionFunc when set: a command costs one call,
+    // or one per locomotion for a flow-field move.
+    using AssignBatchFunc = std::function<int(
+        void* const* units, int count, MissionType mission, const CommandTarget& target)>;
+
+    void SetAssignBatchCallback(AssignBatchFunc func) { assign_batch_ = func; }
+
     // Query if unit can perform action
     using CanPerformFunc = std::function<bool(void* unit, CommandType cmd)>;
     void SetCanPerformQuery(CanPerformFunc func) { can_perform_ = func; }
@@ -101,7 +139,10 @@ private:
     CommandType DetermineCommandForContext(const CursorContext& context,
                                            bool force_attack, bool force_move);
 
-    CommandResult ExecuteOnSelection(const Command& cmd);
+    // IssueCommand for the helpers above, stamped with this frame's input
+    CommandResult IssueInputCommand(Command& cmd);
+
+    CommandResult ExecuteOnUnits(const Command& cmd, SelectableObject* const* units, int count);
 
     bool initialized_;
 
@@ -109,14 +150,25 @@ private:
     Command last_command_;
     CommandResult last_result_;
 
+    // Packets
+    CommandPacket last_packet_;
+    std::vector<uint32_t> packet_ids_;
+    std::vector<uint8_t> pending_packets_;      // Wire form, this frame
+    int pending_count_;
+    uint32_t packet_frame_;
+    std::vector<SelectableObject*> resolved_;   // ExecutePacket's units
+    std::vector<void*> batch_;                  // Units for one batch call
+
     // Callbacks
     AssignMissionFunc assign_mission_;
+    AssignBatchFunc assign_batch_;
     CanPerformFunc can_perform_;
     IsEnemyFunc is_enemy_;
     IsOwnFunc is_own_;
     IsTransportFunc is_transport_;
     IsBuildingFunc is_building_;
     CommandFeedbackFunc on_command_;
+    PacketSinkFunc send_packets_;
 };
 
 //=============================================================================
@@ -6,6 +6,9 @@
 #define COMMAND_TYPES_H
 
 #include <cstdint>
+#include <memory>
+
+class FlowField;
 
 //=============================================================================
 // Command Type Enumeration
@@ -63,6 +66,7 @@ enum CommandFlags : uint32_t {
     CMD_FLAG_QUEUED     = (1 << 0),  // Add to queue, don't replace
     CMD_FLAG_FORCED     = (1 << 1),  // Force action (Ctrl modifier)
     CMD_FLAG_ALT        = (1 << 2),  // Alt modifier (force move)
+    CMD_FLAG_FLOW_FIELD = (1 << 3),  // Group move shares one flow field
 };
 
 //=============================================================================
@@ -89,12 +93,16 @@ struct CommandTarget {
     void* object;       // ObjectClass* when integrated
     uint32_t object_id;
 
+    // Field toward the target cell, shared by a flow-field group move
+    std::shared_ptr<const FlowField> flow_field;
+
     void Clear() {
         type = Type::NONE;
         world_x = world_y = 0;
         cell_x = cell_y = 0;
         object = nullptr;
         object_id = 0;
+        flow_field.reset();
     }
 
     void SetGround(int wx, int wy) {
@@ -136,12 +144,14 @@ struct Command {
 
     // Source information
     int source_count;       // How many units received this command
+    uint64_t input_time_us; // Stamp of the input that issued it (0 = none)
 
     void Clear() {
         type = CommandType::NONE;
         target.Clear();
         flags = CMD_FLAG_NONE;
         source_count = 0;
+        input_time_us = 0;
     }
 
     bool IsQueued() const { return (flags & CMD_FLAG_QUEUED) != 0; }
@@ -0,0 +1,68 @@
+// include/game/input/input_latency.h
+// Input-to-present latency tracing
+// Task 18h - Performance Optimization
+
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+#include <cstdint>
+
+//=============================================================================
+// Latency Effects
+//=============================================================================
+
+// Visible results of input, each traced separately
+enum class LatencyEffect {
+    CURSOR,         // Cursor or drag box follows a mouse move
+    SELECTION,      // Selection changed (click, box, hotkey, group recall)
+    COMMAND,        // Order issued (move marker, unit response)
+    COUNT
+};
+
+//=============================================================================
+// Input Latency Tracer
+//=============================================================================
+
+// Every input event carries the input clock time (Platform_Input_GetTimeUs)
+// at which Platform_PollEvents received it. Code that turns input into a
+// visible change marks the effect with the stamp of the input that caused
+// it; when the frame showing the change has been presented, each marked
+// effect records present time minus stamp into a Profiler histogram
+// ("Input Latency: Cursor" etc.).
+//
+// An effect marked several times before a present keeps its oldest stamp,
+// so the histogram reports how long the earliest waiting input took to
+// show. Main thread only.
+
+class InputLatency {
+public:
+    static InputLatency& Instance();
+
+    // Note a change caused by input stamped input_time_us (0 = no input;
+    // ignored)
+    void Mark(LatencyEffect effect, uint64_t input_time_us);
+
+    // Call once the frame is on screen (after the flip and any vsync wait)
+    void Present(uint64_t present_time_us);
+
+    // Stamp waiting for the next present, 0 if none
+    uint64_t GetPending(LatencyEffect effect) const;
+
+    // Latency recorded at the last present that showed the effect
+    double GetLastLatencyMs(LatencyEffect effect) const;
+
+    static const char* GetHistogramName(LatencyEffect effect);
+
+    void Reset();
+
+private:
+    InputLatency();
+
+    static constexpr int EFFECT_COUNT = static_cast<int>(LatencyEffect::COUNT);
+
+    uint64_t pending_us_[EFFECT_COUNT];
+    double last_latency_ms_[EFFECT_COUNT];
+    uint16_t histogram_ids_[EFFECT_COUNT];  // ProfileSampleId per effect
+};
+
+#endif // INPUT_LATENCY_H
@@ -34,6 +34,11 @@ public:
     void Shutdown();
 
     // Call once per frame after Input_Update()
+    //
+    // Actions resolve through the compiled binding table: the keys held
+    // and pressed this frame are looked up under the current modifiers and
+    // their action masks ORed together. When InputState reports only a few
+    // changed keys, just those keys are looked up again.
     void ProcessFrame();
 
     //=========================================================================
@@ -60,7 +65,7 @@ public:
     //=========================================================================
 
     // Enable/disable debug actions
-    void SetDebugEnabled(bool enabled) { debug_enabled_ = enabled; }
+    void SetDebugEnabled(bool enabled) { debug_enabled_ = enabled; CompileBindings(); }
     bool IsDebugEnabled() const { return debug_enabled_; }
 
     // Get current binding for an action
@@ -82,18 +87,37 @@ private:
     InputMapper& operator=(const InputMapper&) = delete;
 
     void SetupDefaultBindings();
-    void UpdateActionStates();
+    void ResolveActions(bool rescan);
+
+    // Rebuild the binding table from bindings_ (and the debug flag)
+    void CompileBindings();
 
     // Binding storage (indexed by GameAction)
     static constexpr int MAX_ACTIONS = static_cast<int>(GameAction::ACTION_COUNT);
     KeyBinding bindings_[MAX_ACTIONS];
 
+    // One bit per action
+    static constexpr int ACTION_WORDS = (MAX_ACTIONS + 63) / 64;
+    struct ActionMask {
+        uint64_t bits[ACTION_WORDS];
+    };
+
+    // Compiled bindings: actions a key fires under each combination of
+    // Shift, Ctrl and Alt (their MOD_ flags are the index)
+    static constexpr int MOD_COMBOS = 8;
+    ActionMask binding_table_[MOD_COMBOS][KEY_CODE_MAX];
+    ActionMask key_actions_[KEY_CODE_MAX];  // Every action bound to a key
+    ActionMask continuous_;                 // Actions held rather than pressed
+
     // Action states
-    bool action_active_[MAX_ACTIONS];       // Currently held
-    bool action_triggered_[MAX_ACTIONS];    // Just pressed this frame
-    bool action_released_[MAX_ACTIONS];     // Just released this frame
-    bool action_active_prev_[MAX_ACTIONS];  // Previous frame state
+    ActionMask active_;         // Currently held
+    ActionMask triggered_;      // Just pressed this frame
+    ActionMask released_;       // Just released this frame
+
+    // Keys held as of the last resolve, one bit per key code
+    uint64_t keys_down_[KEY_CODE_MAX / 64];
 
+    bool full_pass_;        // Bindings or debug flag changed since last frame
     bool debug_enabled_;
     bool initialized_;
 };
@@ -8,6 +8,8 @@
 #include "input_defs.h"
 #include <cstdint>
 
+struct InputEvent;
+
 //=============================================================================
 // Keyboard State
 //=============================================================================
@@ -19,8 +21,17 @@ struct KeyboardState {
     // Previous frame key states (for edge detection)
     bool keys_down_prev[KEY_CODE_MAX];
 
+    // Input clock (microseconds) of each key's last press, from its event
+    uint64_t key_press_time_us[KEY_CODE_MAX];
+
+    // Keys set through SetKey() since the last save, each listed once
+    uint8_t changed_keys[KEY_CODE_MAX];
+    bool key_listed[KEY_CODE_MAX];
+    int changed_count;
+
     // Current modifier state
     uint8_t modifiers;
+    bool modifiers_changed;
 
     // Key buffer for text input (circular buffer)
     static constexpr int KEY_BUFFER_SIZE = 32;
@@ -34,6 +45,15 @@ struct KeyboardState {
     // Copy current state to previous (call at start of frame)
     void SavePreviousState();
 
+    // Same, for when every change since the last save went through SetKey()
+    void SavePreviousChanges();
+
+    // Set one key, recording it as changed
+    void SetKey(int key_code, bool down);
+
+    // Rebuild modifiers from the Shift/Ctrl/Alt key states
+    void UpdateModifiers();
+
     // Add key to buffer
     void BufferKey(int key_code);
 
@@ -72,6 +92,9 @@ struct MouseState {
     bool buttons_down[INPUT_MOUSE_MAX];
     bool buttons_down_prev[INPUT_MOUSE_MAX];
 
+    // Input clock (microseconds) of each button's last press
+    uint64_t button_press_time_us[INPUT_MOUSE_MAX];
+
     // Timing for double-click detection
     uint64_t last_click_time[INPUT_MOUSE_MAX];
     int last_click_x[INPUT_MOUSE_MAX];
@@ -121,6 +144,42 @@ public:
     // Per-frame update (call once at start of game loop)
     void Update();
 
+    //=========================================================================
+    // Event Mode
+    //=========================================================================
+
+    // In event mode Update() drains the platform's timestamped event queue
+    // and applies only what changed, instead of sampling every key. The
+    // first frame after enabling, and any frame whose queue overflowed,
+    // falls back to a full sample.
+    void SetEventMode(bool enabled);
+    bool IsEventMode() const { return event_mode_; }
+
+    // Apply one key or mouse event (also used to inject input in tests)
+    void ApplyEvent(const InputEvent& event);
+
+    // True if this frame sampled every key (poll mode or a resync); when
+    // false only the keys listed by GetChangedKey() can differ from last
+    // frame
+    bool IsFullUpdate() const { return full_update_; }
+    int GetChangedKeyCount() const { return keyboard_.changed_count; }
+    int GetChangedKey(int index) const { return keyboard_.changed_keys[index]; }
+    bool ModifiersChanged() const { return keyboard_.modifiers_changed; }
+
+    // Events applied during the last Update()
+    int GetEventCount() const { return event_count_; }
+
+    // Input clock at the last Update(), and of individual presses; press
+    // times come from the events, so they keep sub-frame order
+    uint64_t GetUpdateTimeUs() const { return update_time_us_; }
+
+    // Stamp of the earliest input applied this frame (the update time on
+    // full updates), 0 if nothing arrived; carried by what the input causes
+    // so InputLatency can time it to the screen
+    uint64_t GetInputTimeUs() const { return input_time_us_; }
+    uint64_t GetKeyPressTimeUs(int key_code) const;
+    uint64_t GetMouseButtonPressTimeUs(int button) const;
+
     // Raw state access
     KeyboardState& Keyboard() { return keyboard_; }
     MouseState& Mouse() { return mouse_; }
@@ -195,11 +254,22 @@ private:
     void UpdateMouseState();
     void UpdateMouseCoordinates();
     void UpdateDragState();
-    void CheckDoubleClick(int button);
+    void CheckDoubleClick(int button, uint64_t time_ms);
+    void SetMousePosition(int raw_x, int raw_y);
+
+    // Apply queued events; false if the queue overflowed
+    bool ApplyPlatformEvents();
 
     bool initialized_;
     int window_scale_;
 
+    bool event_mode_;
+    bool resync_;           // Next event-mode frame samples everything
+    bool full_update_;
+    int event_count_;
+    uint64_t update_time_us_;
+    uint64_t input_time_us_;
+
     KeyboardState keyboard_;
     MouseState mouse_;
 
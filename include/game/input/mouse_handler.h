@@ -121,10 +121,23 @@ public:
     using TerrainQueryFunc = std::function<bool(int cell_x, int cell_y)>;
     using SelectionQueryFunc = std::function<bool()>;
 
-    void SetObjectAtPosQuery(ObjectAtPosFunc func) { get_object_at_ = func; }
+    void SetObjectAtPosQuery(ObjectAtPosFunc func) { get_object_at_ = func; InvalidateContext(); }
     void SetTerrainPassableQuery(TerrainQueryFunc func) { is_passable_ = func; }
     void SetTerrainVisibleQuery(TerrainQueryFunc func) { is_visible_ = func; }
-    void SetHasSelectionQuery(SelectionQueryFunc func) { has_selection_ = func; }
+    void SetHasSelectionQuery(SelectionQueryFunc func) { has_selection_ = func; InvalidateContext(); }
+
+    // Change counters. With both set, the object under the cursor and the
+    // has-selection answer are cached until the hovered cell, its
+    // occupants or the selection change; without them they are queried
+    // every frame.
+    using GenerationQueryFunc = std::function<uint32_t()>;
+    using CellGenerationQueryFunc = std::function<uint32_t(int cell_x, int cell_y)>;
+
+    void SetSelectionGenerationQuery(GenerationQueryFunc func) { selection_generation_ = func; InvalidateContext(); }
+    void SetCellGenerationQuery(CellGenerationQueryFunc func) { cell_generation_ = func; InvalidateContext(); }
+
+    // Requery next frame (an owner changed, an object was revealed...)
+    void InvalidateContext() { object_cache_valid_ = false; selection_cache_valid_ = false; }
 
     //=========================================================================
     // Special Modes
@@ -186,6 +199,18 @@ private:
     TerrainQueryFunc is_passable_;
     TerrainQueryFunc is_visible_;
     SelectionQueryFunc has_selection_;
+    GenerationQueryFunc selection_generation_;
+    CellGenerationQueryFunc cell_generation_;
+
+    // Cached query results and the counters they were taken at
+    bool object_cache_valid_;
+    int cached_cell_x_, cached_cell_y_;
+    uint32_t cached_cell_generation_;
+    void* cached_object_;
+
+    bool selection_cache_valid_;
+    uint32_t cached_selection_generation_;
+    bool cached_has_selection_;
 };
 
 //=============================================================================
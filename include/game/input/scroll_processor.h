@@ -5,6 +5,7 @@
 #ifndef SCROLL_PROCESSOR_H
 #define SCROLL_PROCESSOR_H
 
+#include "game/scroll_motion.h"
 #include <cstdint>
 #include <functional>
 
@@ -79,6 +80,11 @@ public:
     int GetScrollDeltaX() const { return scroll_delta_x_; }
     int GetScrollDeltaY() const { return scroll_delta_y_; }
 
+    // Eased velocity in pixels per frame; winds down for a few frames
+    // after the scroll stops
+    float GetVelocityX() const { return motion_.GetVelocityX(); }
+    float GetVelocityY() const { return motion_.GetVelocityY(); }
+
     //=========================================================================
     // Configuration
     //=========================================================================
@@ -98,6 +104,15 @@ public:
     using CanScrollFunc = std::function<bool(int dx, int dy)>;
     void SetCanScrollCallback(CanScrollFunc func) { can_scroll_ = func; }
 
+    // Called with the cells [start, end) about to scroll into GameViewport,
+    // so their terrain can be decoded ahead of the edge. A strip is passed
+    // on once, then again only when it reaches new cells.
+    using PrefetchFunc = std::function<void(int start_x, int start_y, int end_x, int end_y)>;
+    void SetPrefetchCallback(PrefetchFunc func) { prefetch_ = func; }
+
+    // Frames of motion the prefetch looks ahead
+    void SetPrefetchLookahead(int frames) { prefetch_frames_ = frames; }
+
 private:
     ScrollProcessor();
     ~ScrollProcessor();
@@ -108,6 +123,7 @@ private:
     ScrollDir DetectKeyboardScroll();
     void CalculateScrollDelta(ScrollDir dir, bool fast);
     void ApplyScroll();
+    void PrefetchAhead();
 
     bool initialized_;
 
@@ -126,10 +142,17 @@ private:
     ScrollDir combined_direction_;
     int scroll_delta_x_;
     int scroll_delta_y_;
+    ScrollMotion motion_;
+
+    // Prefetch
+    int prefetch_frames_;
+    ScrollCellRange prefetched_[2];     // Strips last passed on
+    int prefetched_count_;
 
     // Callbacks
     ApplyScrollFunc apply_scroll_;
     CanScrollFunc can_scroll_;
+    PrefetchFunc prefetch_;
 };
 
 //=============================================================================
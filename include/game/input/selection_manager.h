@@ -9,6 +9,9 @@
 #include <vector>
 #include <array>
 #include <functional>
+#include <unordered_map>
+#include "game/core/containers.h"
+#include "game/spatial_grid.h"
 
 //=============================================================================
 // Constants
@@ -17,6 +20,9 @@
 static const int MAX_SELECTION = 30;
 static const int NUM_CONTROL_GROUPS = 10;
 
+// Object IDs below this have a selected flag; larger IDs are searched
+static const uint32_t MAX_FLAGGED_OBJECT_ID = 1u << 20;
+
 //=============================================================================
 // Selectable Object Interface
 //=============================================================================
@@ -81,7 +87,12 @@ public:
     // Box selection (screen coordinates)
     void SelectInBox(int screen_x1, int screen_y1, int screen_x2, int screen_y2);
 
-    // Type-based selection
+    // Bulk selection: filtered, sorted and trimmed once, one change event.
+    // Select replaces the selection (unchanged if nothing qualifies).
+    void SelectObjects(SelectableObject* const* objs, int count);
+    void AddObjectsToSelection(SelectableObject* const* objs, int count);
+
+    // Type-based selection (rtti_type < 0 = any type)
     void SelectAllOfType(int rtti_type);
     void SelectAllVisible(int rtti_type);  // All visible on screen
 
@@ -94,8 +105,9 @@ public:
     bool HasSelection() const { return !selected_.empty(); }
     int GetSelectionCount() const { return static_cast<int>(selected_.size()); }
 
-    // Get selected objects
-    const std::vector<SelectableObject*>& GetSelection() const { return selected_; }
+    // Get selected objects (held inline, so changing them never allocates)
+    using SelectionList = SmallVector<SelectableObject*, MAX_SELECTION>;
+    const SelectionList& GetSelection() const { return selected_; }
     SelectableObject* GetPrimarySelection() const;  // First selected object
 
     // Type queries
@@ -115,9 +127,25 @@ public:
     bool HasGroup(int group_num) const;
     int GetGroupSize(int group_num) const;
 
-    // Get group center (for camera jump)
+    // Get group center (for camera jump). Kept as running sums, so it
+    // follows members as UpdateObject reports their moves.
     bool GetGroupCenter(int group_num, int& out_x, int& out_y) const;
 
+    //=========================================================================
+    // Lookup by ID (replays, command packets)
+    //=========================================================================
+
+    // Active object with this ID, or nullptr
+    SelectableObject* FindObject(uint32_t object_id) const;
+
+    // Active objects among these ascending IDs, in one pass over the
+    // objects; returns how many were found
+    int FindObjects(const uint32_t* sorted_ids, int count,
+                    std::vector<SelectableObject*>& out) const;
+
+    // Replace the selection with these objects, in this order (missing IDs skipped)
+    void SelectIds(const uint32_t* ids, int count);
+
     //=========================================================================
     // Object Lifecycle
     //=========================================================================
@@ -126,6 +154,29 @@ public:
     void OnObjectDestroyed(SelectableObject* obj);
     void OnObjectDestroyed(uint32_t object_id);
 
+    // Spatial index used when no query callback is set.
+    // Track on spawn, Update after pixel_x/pixel_y change, Untrack on removal.
+    void TrackObject(SelectableObject* obj);
+    void UpdateObject(SelectableObject* obj);
+    void UntrackObject(SelectableObject* obj);
+    const SpatialGrid<SelectableObject>& GetSpatialGrid() const { return grid_; }
+
+    // World queries: the callback if set, otherwise the spatial index
+    std::vector<SelectableObject*> GetObjectsInRect(int screen_x1, int screen_y1,
+                                                    int screen_x2, int screen_y2) const;
+    SelectableObject* GetObjectAt(int cell_x, int cell_y) const;
+
+    //=========================================================================
+    // Change Tracking (keys for caches of derived state, e.g. the cursor)
+    //=========================================================================
+
+    // Bumped on every selection change
+    uint32_t GetGeneration() const { return generation_; }
+
+    // Bumped when a tracked object enters or leaves the cell (by pixel
+    // position). Cells share counters, so a bump may be another cell's.
+    uint32_t GetCellGeneration(int cell_x, int cell_y) const;
+
     //=========================================================================
     // Event Callbacks
     //=========================================================================
@@ -155,19 +206,71 @@ private:
     SelectionManager(const SelectionManager&) = delete;
     SelectionManager& operator=(const SelectionManager&) = delete;
 
-    void NotifySelectionChanged(SelectionEvent event);
+    // from_input: caused by this frame's input, so timed by InputLatency
+    void NotifySelectionChanged(SelectionEvent event, bool from_input = true);
     bool CanSelect(const SelectableObject* obj) const;
     void SortSelection();  // Sort by priority
     void TrimSelection();  // Enforce MAX_SELECTION
 
+    // Control group membership, keeping grouped_ and group_sums_ in step
+    void AddToGroup(int group_num, SelectableObject* obj);
+    void RemoveFromGroups(uint32_t object_id, uint16_t group_mask);
+    void ClearGroup(int group_num);
+
+    // Selected flags: Unmark before changing selected_, Mark after
+    void MarkSelection();
+    void UnmarkSelection();
+    void SetSelectedFlag(uint32_t object_id, bool selected);
+    bool HasSelectedFlag(uint32_t object_id) const;
+
+    // Bump the occupancy counter of the cell holding a pixel position
+    void TouchCell(int pixel_x, int pixel_y);
+
+    // Screen rectangle to a normalized world pixel rectangle
+    static void ScreenRectToWorld(int screen_x1, int screen_y1, int screen_x2, int screen_y2,
+                                  int& x1, int& y1, int& x2, int& y2);
+
+    // Visit every candidate object: the all-objects query if set,
+    // otherwise the spatial index
+    template <typename Fn>
+    void ForEachObject(Fn fn) const;
+
     bool initialized_;
     int player_house_;
 
+    // Change counters
+    static const int CELL_GENERATION_SLOTS = 1024;  // 32x32 cells, tiled
+    uint32_t generation_;
+    std::array<uint32_t, CELL_GENERATION_SLOTS> cell_generations_;
+
     // Current selection
-    std::vector<SelectableObject*> selected_;
+    SelectionList selected_;
+
+    // One bit per object ID, set while that ID is selected
+    std::vector<uint64_t> selected_flags_;
 
     // Control groups (0-9)
-    std::array<std::vector<uint32_t>, NUM_CONTROL_GROUPS> groups_;
+    std::array<SmallVector<uint32_t, MAX_SELECTION>, NUM_CONTROL_GROUPS> groups_;
+
+    // Every object in some group, with the position its groups' sums
+    // hold for it
+    struct GroupedObject {
+        SelectableObject* obj;
+        int pixel_x;
+        int pixel_y;
+        uint16_t groups;        // Bit per control group
+    };
+    std::unordered_map<uint32_t, GroupedObject> grouped_;
+
+    // Member position sums per group, for the centroid
+    struct GroupSums {
+        int64_t x;
+        int64_t y;
+    };
+    std::array<GroupSums, NUM_CONTROL_GROUPS> group_sums_;
+
+    // Tracked objects by world pixel position
+    SpatialGrid<SelectableObject> grid_;
 
     // Callbacks
     SelectionCallback on_selection_changed_;
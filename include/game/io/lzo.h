@@ -0,0 +1,50 @@
+/**
+ * LZO - LZO1X-1 Block Codec
+ *
+ * Port of the LZO1X-1 compressor and LZO1X decompressor the original
+ * game shipped (LZO1X_C.CPP, LZO1X_D.CPP), producing the same stream
+ * format. LZO1X trades ratio for speed: it keeps a single-probe hash of
+ * recent 3-byte sequences and never searches, so both directions run
+ * close to memcpy speed. The stream ends with its own end-of-data code.
+ *
+ * Unlike the original, the decompressor checks every read and write
+ * against its buffers, so corrupt data (a bad save, a mangled network
+ * packet) fails cleanly instead of running off the end.
+ */
+
+#ifndef GAME_IO_LZO_H
+#define GAME_IO_LZO_H
+
+#include <cstdint>
+
+/**
+ * Entries in the compressor's hash dictionary
+ */
+constexpr int LZO_DICT_SIZE = 16384;
+
+/**
+ * Worst-case compressed size of length bytes (incompressible data grows)
+ */
+constexpr int LZO_Max_Compressed_Size(int length) {
+    return length + length / 16 + 64 + 3;
+}
+
+/**
+ * Compress a block
+ *
+ * @param dest Must hold LZO_Max_Compressed_Size(length) bytes
+ * @param dict LZO_DICT_SIZE entries of scratch space; any contents,
+ *             reusing one array across calls avoids reallocating it
+ * @return Compressed size
+ */
+int LZO_Compress(const uint8_t* source, int length, uint8_t* dest, uint32_t* dict);
+
+/**
+ * Decompress a block
+ *
+ * @return Decompressed size, or -1 if the data is corrupt, truncated, or
+ *         would overflow dest_size
+ */
+int LZO_Decompress(const uint8_t* source, int length, uint8_t* dest, int dest_size);
+
+#endif // GAME_IO_LZO_H
@@ -0,0 +1,118 @@
+/**
+ * LZOPipe / LZOStraw - Block-Compressed Stream Stages
+ *
+ * Port of the original LZOPIPE/LZOSTRAW. Data is cut into independent
+ * blocks, each LZO1X-compressed and written behind a small header:
+ * ```
+ * uint16_t comp_count      - compressed bytes that follow
+ * uint16_t uncomp_count    - bytes they decompress to
+ * ```
+ * (little-endian, as the original wrote it on x86). Only one block is
+ * ever held in memory, so a stream of any size compresses with a fixed
+ * footprint, and a reader can start decoding before the writer is done.
+ *
+ * Either stage can run in either direction: an LZOPipe that
+ * decompresses suits data arriving in pieces (network payloads), an
+ * LZOStraw that decompresses suits reading a save file.
+ *
+ * Usage (save):
+ *   FilePipe file(handle);
+ *   LZOPipe lzo(LZOPipe::COMPRESS);
+ *   lzo.Put_To(file);
+ *   lzo.Put(data, size);
+ *   lzo.End();
+ *
+ * Usage (load):
+ *   FileStraw file(handle);
+ *   LZOStraw lzo(LZOStraw::DECOMPRESS);
+ *   lzo.Get_From(file);
+ *   lzo.Get(data, size);
+ */
+
+#ifndef GAME_IO_LZO_PIPE_H
+#define GAME_IO_LZO_PIPE_H
+
+#include "game/io/pipe.h"
+#include "game/io/straw.h"
+#include <cstdint>
+#include <vector>
+
+constexpr int LZO_BLOCK_HEADER_SIZE = 4;
+constexpr int LZO_DEFAULT_BLOCK_SIZE = 8 * 1024;
+
+/**
+ * Largest block whose worst-case compressed size still fits comp_count
+ */
+constexpr int LZO_MAX_BLOCK_SIZE = 60 * 1024;
+
+class LZOPipe : public Pipe {
+public:
+    enum CompControl {
+        COMPRESS,
+        DECOMPRESS
+    };
+
+    /**
+     * @param block_size Uncompressed bytes per block when compressing,
+     *                   clamped to LZO_MAX_BLOCK_SIZE
+     */
+    explicit LZOPipe(CompControl control, int block_size = LZO_DEFAULT_BLOCK_SIZE);
+
+    int Put(const void* source, int length) override;
+    int Flush() override;
+
+    /**
+     * True once a corrupt or truncated block was seen while
+     * decompressing; everything after it is dropped
+     */
+    bool HasError() const { return error_; }
+
+private:
+    int Put_Block(const uint8_t* data, int length);
+    int Put_Decompressed(const uint8_t* data);
+
+    CompControl control_;
+    int block_size_;
+    int counter_ = 0;                   // Bytes held in buffer_
+    bool have_header_ = false;          // Decompress: header read, awaiting data
+    uint16_t comp_count_ = 0;
+    uint16_t uncomp_count_ = 0;
+    bool error_ = false;
+
+    std::vector<uint8_t> buffer_;       // Partial input block (or header)
+    std::vector<uint8_t> output_;       // Header + compressed, or decompressed
+    std::vector<uint32_t> dict_;        // Compressor dictionary
+};
+
+class LZOStraw : public Straw {
+public:
+    enum CompControl {
+        COMPRESS,
+        DECOMPRESS
+    };
+
+    explicit LZOStraw(CompControl control, int block_size = LZO_DEFAULT_BLOCK_SIZE);
+
+    int Get(void* dest, int length) override;
+
+    /**
+     * True once a corrupt or truncated block was read while decompressing
+     */
+    bool HasError() const { return error_; }
+
+private:
+    int Get_Full(void* dest, int length);
+    bool Next_Block(uint8_t* direct, int direct_size, int* direct_count);
+
+    CompControl control_;
+    int block_size_;
+    int counter_ = 0;                   // Bytes left in output_
+    int pos_ = 0;                       // Next byte of output_
+    bool error_ = false;
+
+    std::vector<uint8_t> input_;        // Raw block or compressed data
+    std::vector<uint8_t> output_;       // Block ready to hand out
+    std::vector<uint32_t> dict_;
+};
+
+#endif // GAME_IO_LZO_PIPE_H
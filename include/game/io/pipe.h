@@ -0,0 +1,101 @@
+/**
+ * Pipe - Push-Style Data Stream Stages
+ *
+ * Port of the original Westwood Pipe framework. A pipe accepts data
+ * through Put() and passes it (usually transformed) to the next pipe in
+ * its chain. Stages are linked writer first, sink last:
+ *
+ *   FilePipe file(handle);
+ *   LZOPipe lzo(LZOPipe::COMPRESS);
+ *   lzo.Put_To(file);
+ *   lzo.Put(&header, sizeof(header));
+ *   ...
+ *   lzo.End();                    // Flush partial blocks down the chain
+ *
+ * A stage may hold data back until it has a whole block, so the writer
+ * always finishes with End(). A pipe with nothing chained after it
+ * discards what it is given.
+ *
+ * Straws (game/io/straw.h) are the pull-style mirror for reading.
+ */
+
+#ifndef GAME_IO_PIPE_H
+#define GAME_IO_PIPE_H
+
+#include <cstdint>
+#include <vector>
+
+struct PlatformFile;
+
+class Pipe {
+public:
+    Pipe() = default;
+    virtual ~Pipe();
+
+    Pipe(const Pipe&) = delete;
+    Pipe& operator=(const Pipe&) = delete;
+
+    /**
+     * Submit data to the pipe
+     *
+     * @return Bytes this call output at the end of the chain
+     */
+    virtual int Put(const void* source, int length);
+
+    /**
+     * Process anything held back and pass the flush along
+     */
+    virtual int Flush();
+
+    /**
+     * Mark the end of the data; the chain may be reused afterwards
+     */
+    virtual int End() { return Flush(); }
+
+    /**
+     * Chain this pipe's output into another pipe (nullptr unlinks)
+     *
+     * The previous target is flushed first.
+     */
+    virtual void Put_To(Pipe* pipe);
+    void Put_To(Pipe& pipe) { Put_To(&pipe); }
+
+protected:
+    Pipe* chain_to_ = nullptr;
+    Pipe* chain_from_ = nullptr;
+};
+
+/**
+ * Sink that collects everything into memory
+ */
+class BufferPipe : public Pipe {
+public:
+    int Put(const void* source, int length) override;
+
+    const std::vector<uint8_t>& GetData() const { return data_; }
+    void Clear() { data_.clear(); }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+/**
+ * Sink that writes to an open platform file (not closed by the pipe)
+ */
+class FilePipe : public Pipe {
+public:
+    explicit FilePipe(PlatformFile* file) : file_(file) {}
+
+    int Put(const void* source, int length) override;
+
+    /**
+     * True if a write came up short
+     */
+    bool HasError() const { return error_; }
+
+private:
+    PlatformFile* file_;
+    bool error_ = false;
+};
+
+#endif // GAME_IO_PIPE_H
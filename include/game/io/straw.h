@@ -0,0 +1,81 @@
+/**
+ * Straw - Pull-Style Data Stream Stages
+ *
+ * Port of the original Westwood Straw framework. A straw hands out data
+ * through Get(), drawing (and usually transforming) it from the straw
+ * it is chained to. Stages are linked reader first, source last:
+ *
+ *   FileStraw file(handle);
+ *   LZOStraw lzo(LZOStraw::DECOMPRESS);
+ *   lzo.Get_From(file);
+ *   lzo.Get(&header, sizeof(header));
+ *
+ * Get() only returns less than asked for once the source runs dry.
+ */
+
+#ifndef GAME_IO_STRAW_H
+#define GAME_IO_STRAW_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct PlatformFile;
+
+class Straw {
+public:
+    Straw() = default;
+    virtual ~Straw();
+
+    Straw(const Straw&) = delete;
+    Straw& operator=(const Straw&) = delete;
+
+    /**
+     * Fetch data from the straw
+     *
+     * @return Bytes stored; less than length only at the end of data
+     */
+    virtual int Get(void* dest, int length);
+
+    /**
+     * Draw this straw's input from another straw (nullptr unlinks)
+     */
+    virtual void Get_From(Straw* straw);
+    void Get_From(Straw& straw) { Get_From(&straw); }
+
+protected:
+    Straw* chain_to_ = nullptr;
+    Straw* chain_from_ = nullptr;
+};
+
+/**
+ * Source that reads from memory (data must outlive the straw)
+ */
+class BufferStraw : public Straw {
+public:
+    BufferStraw(const void* data, size_t size)
+        : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+    int Get(void* dest, int length) override;
+
+    size_t GetRemaining() const { return size_ - pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+/**
+ * Source that reads from an open platform file (not closed by the straw)
+ */
+class FileStraw : public Straw {
+public:
+    explicit FileStraw(PlatformFile* file) : file_(file) {}
+
+    int Get(void* dest, int length) override;
+
+private:
+    PlatformFile* file_;
+};
+
+#endif // GAME_IO_STRAW_H
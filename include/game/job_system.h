@@ -0,0 +1,89 @@
+/**
+ * JobSystem - Fork/join worker pool for the simulation tick
+ *
+ * Parallel_For() cuts an index range into fixed-size chunks and runs
+ * them on the workers and the calling thread, returning once every chunk
+ * is done. The chunking depends only on the count and grain, never on
+ * the number of threads, so a job that writes only its own indices gives
+ * the same result on any machine - what lockstep multiplayer needs.
+ *
+ * Without Start() (tests, tools) every chunk runs inline, in order.
+ *
+ * Usage:
+ *   JobSystem::Instance().Parallel_For(count, 64, [&](int begin, int end) {
+ *       for (int i = begin; i < end; i++) out[i] = Work(in[i]);
+ *   });
+ */
+
+#ifndef GAME_JOB_SYSTEM_H
+#define GAME_JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "game/core/containers.h"
+
+class JobSystem {
+public:
+    /**
+     * Process indices [begin, end); a non-owning reference, so passing a
+     * capturing lambda never allocates
+     */
+    using RangeFn = FunctionRef<void(int begin, int end)>;
+
+    static JobSystem& Instance();
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Start the worker pool
+     *
+     * @param worker_count Threads to start besides the caller; 0 = one
+     *                     less than the hardware threads, at most 7
+     */
+    void Start(int worker_count = 0);
+
+    /**
+     * Join the workers; later jobs run inline
+     */
+    void Stop();
+
+    bool Is_Running() const { return !workers_.empty(); }
+    int Get_Worker_Count() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * Run fn over [0, count) in chunks of grain indices and wait
+     *
+     * Chunks may run in any order and at the same time, so fn must only
+     * write state belonging to its own indices. Not reentrant.
+     */
+    void Parallel_For(int count, int grain, RangeFn fn);
+
+private:
+    void Worker_Main(uint32_t seen);
+    void Run_Chunks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;      // Job posted or stopping
+    std::condition_variable done_;      // A worker left the job
+    uint32_t job_serial_ = 0;           // Guarded by mutex_
+    int busy_ = 0;                      // Workers in the job; guarded by mutex_
+    bool stopping_ = false;             // Guarded by mutex_
+
+    // Current job; written only while every worker is idle
+    RangeFn job_fn_;
+    int job_count_ = 0;
+    int job_grain_ = 1;
+    int job_chunks_ = 0;
+    std::atomic<int> next_chunk_{0};
+};
+
+#endif // GAME_JOB_SYSTEM_H
@@ -18,10 +18,19 @@
 
 #include "game/gscreen.h"
 #include "game/coord.h"
+#include "game/house.h"
+#include "game/core/containers.h"
 #include <cstdint>
+#include <vector>
 
-// Forward declaration
+// Forward declarations
+class BuildMap;
 class CellClass;
+class ObjectClass;
+class TiberiumGrowth;
+class OreFields;
+class VisionMap;
+class ZoneMap;
 
 // =============================================================================
 // Map Constants
@@ -41,6 +50,47 @@ enum TheaterType : int8_t {
 extern const char* TheaterNames[THEATER_COUNT];
 extern const char* TheaterFileSuffix[THEATER_COUNT];
 
+// Cell storage layouts
+enum CellLayoutType : uint8_t {
+    CELL_LAYOUT_LINEAR = 0,  // Row-major: y * MAP_CELL_WIDTH + x
+    CELL_LAYOUT_TILED = 1,   // 8x8 cell blocks, row-major within each block
+};
+
+// Tiled layout geometry (one 8x8 block of cells is contiguous)
+constexpr int CELL_TILE_SHIFT = 3;
+constexpr int CELL_TILE_SIZE = 1 << CELL_TILE_SHIFT;
+constexpr int CELL_TILE_MASK = CELL_TILE_SIZE - 1;
+constexpr int CELL_TILES_PER_ROW = MAP_CELL_WIDTH / CELL_TILE_SIZE;
+constexpr int CELL_TILE_TOTAL = CELL_TILES_PER_ROW * (MAP_CELL_HEIGHT / CELL_TILE_SIZE);
+
+// =============================================================================
+// Cell Layers
+// =============================================================================
+
+/**
+ * CellLayers - Packed copies of the per-cell fields read by hot loops
+ *
+ * Structure-of-arrays view of CellClass: one byte per cell per field,
+ * always row-major (y * MAP_CELL_WIDTH + x) whatever the cell layout.
+ * A full-map scan of one field touches 16 KB instead of the whole
+ * CellClass array. Values use the CellClass encodings (CELL_TEMPLATE_NONE,
+ * OverlayType, LandType, CellVisibility) cast to uint8_t.
+ *
+ * The edge masks are derived: bit FacingType is set when that neighbour
+ * is shrouded (shroud_edge) or not visible (fog_edge). They are updated
+ * only around cells whose visibility changes.
+ */
+struct CellLayers {
+    uint8_t template_type[MAP_CELL_TOTAL];
+    uint8_t icon[MAP_CELL_TOTAL];
+    uint8_t overlay[MAP_CELL_TOTAL];
+    uint8_t overlay_data[MAP_CELL_TOTAL];
+    uint8_t land[MAP_CELL_TOTAL];
+    uint8_t visibility[MAP_CELL_TOTAL];
+    uint8_t shroud_edge[MAP_CELL_TOTAL];
+    uint8_t fog_edge[MAP_CELL_TOTAL];
+};
+
 // =============================================================================
 // MapClass
 // =============================================================================
@@ -83,6 +133,15 @@ public:
      */
     virtual void Init(int theater = THEATER_TEMPERATE) override;
 
+    /**
+     * Alloc_Cells - Allocate and reset the cell array
+     *
+     * Called by One_Time(). Safe to call without graphics (tools, tests).
+     *
+     * @return true if cells are available
+     */
+    bool Alloc_Cells();
+
     // -------------------------------------------------------------------------
     // Cell Access
     // -------------------------------------------------------------------------
@@ -114,6 +173,35 @@ public:
      */
     CellClass* Get_Cell_At_Coord(COORDINATE coord);
 
+    // -------------------------------------------------------------------------
+    // Cell Storage Layout
+    // -------------------------------------------------------------------------
+
+    /**
+     * Set_Cell_Layout - Choose how cells are ordered in memory
+     *
+     * The tiled layout keeps each 8x8 block of cells contiguous, so area
+     * scans (reveals, path searches) touch far fewer cache lines than the
+     * row-major layout, where vertical neighbours are 128 cells apart.
+     * Existing cell contents are preserved.
+     */
+    void Set_Cell_Layout(CellLayoutType layout);
+    CellLayoutType Get_Cell_Layout() const { return cell_layout_; }
+
+    /**
+     * Cell_Storage_Index - Offset of cell (x, y) within cells_
+     */
+    int Cell_Storage_Index(int x, int y) const { return Storage_Index(cell_layout_, x, y); }
+
+    static int Storage_Index(CellLayoutType layout, int x, int y) {
+        if (layout == CELL_LAYOUT_TILED) {
+            int tile = (y >> CELL_TILE_SHIFT) * CELL_TILES_PER_ROW + (x >> CELL_TILE_SHIFT);
+            return (tile << (2 * CELL_TILE_SHIFT)) |
+                   ((y & CELL_TILE_MASK) << CELL_TILE_SHIFT) | (x & CELL_TILE_MASK);
+        }
+        return y * MAP_CELL_WIDTH + x;
+    }
+
     /**
      * Is_Valid_Cell - Check if cell index is valid
      */
@@ -176,6 +264,19 @@ public:
      */
     void Clear_Map();
 
+    /**
+     * Load_Cells - Set every cell's terrain and overlay from planes
+     *
+     * Planes are row-major (Layer_Index), as in CellLayers. One pass
+     * writes the cells with no per-cell change reports, then the layers
+     * are rebuilt once and the whole map is flagged for redraw. Objects
+     * are left alone, and so is visibility unless a plane of it
+     * (CellVisibility values) is given.
+     */
+    void Load_Cells(const uint8_t* templates, const uint8_t* icons,
+                    const uint8_t* overlays, const uint8_t* overlay_data,
+                    const uint8_t* visibility = nullptr);
+
     /**
      * Recalc_All - Recalculate all cell data
      *
@@ -184,11 +285,240 @@ public:
      */
     void Recalc_All();
 
+    /**
+     * Reveal_Area - Reveal all cells within radius of a cell
+     *
+     * @param center Center cell
+     * @param radius Radius in cells
+     * @param make_visible true = visible, false = explored only
+     */
+    void Reveal_Area(CELL center, int radius, bool make_visible = true);
+
     /**
      * Get_Theater_Type - Get current theater type
      */
     TheaterType Get_Theater_Type() const { return theater_type_; }
 
+    // -------------------------------------------------------------------------
+    // Packed Cell Layers
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get_Cell_Layers - Packed per-cell fields (nullptr before Alloc_Cells)
+     *
+     * Kept in sync by the CellClass setters for the global Map. Other
+     * instances must call Sync_All_Layers() after editing cells.
+     */
+    const CellLayers* Get_Cell_Layers() const { return layers_; }
+
+    /**
+     * Layer_Index - Offset of cell (x, y) within a CellLayers array
+     */
+    static int Layer_Index(int x, int y) { return y * MAP_CELL_WIDTH + x; }
+
+    /**
+     * Sync_Cell_Layers - Copy one cell's fields into the layers
+     */
+    void Sync_Cell_Layers(CELL cell);
+
+    /**
+     * Sync_All_Layers - Rebuild every layer from the cell array
+     */
+    void Sync_All_Layers();
+
+    /**
+     * Get_Shroud_Edge / Get_Fog_Edge - 8-neighbour cover mask of a cell
+     *
+     * Bit FacingType is set when that neighbour is shrouded / not visible.
+     */
+    uint8_t Get_Shroud_Edge(int x, int y) const;
+    uint8_t Get_Fog_Edge(int x, int y) const;
+
+    /**
+     * Is_Cell_Passable - Passability check from the packed land layer
+     */
+    bool Is_Cell_Passable(int x, int y, bool is_naval = false, bool is_infantry = false) const;
+
+    /**
+     * Get_Land_Revision - Bumped whenever passability may have changed
+     *
+     * Covers land type edits and bounds changes, so caches built from
+     * the land layer (path graphs) know when to rebuild.
+     */
+    uint32_t Get_Land_Revision() const { return land_revision_; }
+
+    /**
+     * Get_Zones - Connected regions per locomotion (nullptr before Alloc_Cells)
+     *
+     * Kept current with the land layer and the map bounds.
+     */
+    const ZoneMap* Get_Zones() const { return zones_; }
+
+    /**
+     * Get_Cell_Hash - XOR of every cell's StateHash::Cell_Term
+     *
+     * Updated as the layers are, so it always matches the cells once
+     * they are synced.
+     */
+    uint64_t Get_Cell_Hash() const { return cell_hash_; }
+
+    /**
+     * Recompute_Cell_Hash - Get_Cell_Hash the slow way, from the layers
+     */
+    uint64_t Recompute_Cell_Hash() const;
+
+    // -------------------------------------------------------------------------
+    // Vision
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get_Vision - Per-house explored/visible planes (nullptr before Alloc_Cells)
+     *
+     * Technos register their sight here as they change cells.
+     */
+    VisionMap* Get_Vision() { return vision_; }
+    const VisionMap* Get_Vision() const { return vision_; }
+
+    /**
+     * Update_Vision - Rebuild changed sight and show the player's view
+     *
+     * Cells the player's house gained sight of are revealed and cells it
+     * lost are fogged; every other cell's visibility is left alone.
+     */
+    void Update_Vision(HousesType player);
+
+    // -------------------------------------------------------------------------
+    // Building Placement
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get_Build_Map - Per-house buildable planes (nullptr before Alloc_Cells)
+     *
+     * Land, bounds and occupancy are kept current by the map; buildings
+     * are reported by whoever places or removes them.
+     */
+    BuildMap* Get_Build_Map() { return build_; }
+    const BuildMap* Get_Build_Map() const { return build_; }
+
+    // -------------------------------------------------------------------------
+    // Tiberium
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get_Tiberium - Ore cells and their growth (nullptr before Alloc_Cells)
+     *
+     * Kept current with the overlay layer.
+     */
+    TiberiumGrowth* Get_Tiberium() { return tiberium_; }
+    const TiberiumGrowth* Get_Tiberium() const { return tiberium_; }
+
+    /**
+     * Get_Ore_Fields - Where ore and gems lie, for harvesters (nullptr before Alloc_Cells)
+     *
+     * Kept current with the overlay layer.
+     */
+    const OreFields* Get_Ore_Fields() const { return ore_fields_; }
+
+    /**
+     * Grow_Tiberium - Run one tick of ore growth and spread
+     */
+    void Grow_Tiberium();
+
+    // -------------------------------------------------------------------------
+    // Object Occupancy
+    // -------------------------------------------------------------------------
+
+    /**
+     * ObjectFilter - Return true to keep an object in a query result
+     *
+     * Non-owning: a lambda passed straight into a query costs no heap
+     * allocation per call.
+     */
+    using ObjectFilter = FunctionRef<bool(const ObjectClass*)>;
+
+    /**
+     * Occupy_Cell / Vacate_Cell - Track an object entering or leaving a cell
+     *
+     * Called by ObjectClass::Mark_Cell/Unmark_Cell. Objects that do not
+     * fit a full cell are kept on an overflow list so queries still see
+     * them. Vacating a cell the object is not in does nothing.
+     */
+    void Occupy_Cell(CELL cell, ObjectClass* obj);
+    void Vacate_Cell(CELL cell, ObjectClass* obj);
+
+    /**
+     * Objects_In_Radius - Collect objects within range of a coordinate
+     *
+     * Walks the cell object lists around coord, skipping every 8x8 cell
+     * block that holds no objects, so the cost follows local density
+     * rather than the total object count. Distance is Coord_Distance.
+     *
+     * @param coord Center of the search
+     * @param range Radius in leptons
+     * @param[out] out Matching objects are appended, in cell order
+     * @param filter Optional; objects it rejects are left out
+     * @return Number of objects appended
+     */
+    int Objects_In_Radius(COORDINATE coord, int range, std::vector<ObjectClass*>& out,
+                          ObjectFilter filter = ObjectFilter()) const;
+
+    /**
+     * Get_Block_Occupancy - Objects in the 8x8 cell block holding (x, y)
+     */
+    int Get_Block_Occupancy(int x, int y) const;
+
+    // -------------------------------------------------------------------------
+    // Change Tracking
+    // -------------------------------------------------------------------------
+
+    /**
+     * Flag_Cell_Changed - Mark a cell as needing redraw
+     *
+     * Called by CellClass when its template, overlay or visibility
+     * changes; also refreshes the cell's packed layers. DisplayClass
+     * consumes the flags once per frame.
+     */
+    void Flag_Cell_Changed(CELL cell);
+
+    /**
+     * Flag_All_Cells_Changed - Mark every cell as needing redraw
+     */
+    void Flag_All_Cells_Changed();
+
+    /**
+     * Is_Cell_Changed - Has cell changed since the last Clear_Changed_Cells?
+     */
+    bool Is_Cell_Changed(CELL cell) const;
+    bool Is_Cell_Changed(int x, int y) const;
+
+    /**
+     * Has_Changed_Cells - Is any cell flagged?
+     */
+    bool Has_Changed_Cells() const { return any_cell_changed_; }
+
+    /**
+     * For_Each_Changed_Cell - Call fn(x, y) for every flagged cell
+     */
+    template <typename Fn>
+    void For_Each_Changed_Cell(Fn fn) const {
+        if (!any_cell_changed_) {
+            return;
+        }
+        for (int word = 0; word < CHANGED_WORDS; word++) {
+            uint64_t bits = changed_cells_[word];
+            while (bits != 0) {
+                int index = (word << 6) + __builtin_ctzll(bits);
+                fn(index % MAP_CELL_WIDTH, index / MAP_CELL_WIDTH);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /**
+     * Clear_Changed_Cells - Reset all change flags
+     */
+    void Clear_Changed_Cells();
+
     // -------------------------------------------------------------------------
     // Coordinate Utilities
     // -------------------------------------------------------------------------
@@ -228,6 +558,38 @@ public:
     CELL Get_Tactical_Cell() const { return ::Coord_Cell(tactical_pos_); }
 
 protected:
+    /**
+     * Copy_Cell_Fields - Write cell (x, y) into the plain layers
+     *
+     * @return previous visibility layer value
+     */
+    uint8_t Copy_Cell_Fields(int x, int y);
+
+    /**
+     * Update_Edge_Masks - Fix neighbour edge bits after a visibility change
+     *
+     * Only the 8 neighbours are touched; those whose mask changed and
+     * that still show terrain are flagged for redraw.
+     */
+    void Update_Edge_Masks(int x, int y, uint8_t old_vis, uint8_t new_vis);
+
+    /**
+     * Rebuild_Edge_Masks - Recompute every edge mask from the visibility layer
+     */
+    void Rebuild_Edge_Masks();
+
+    /**
+     * Rebuild_Zones - Relabel every zone from the land layer and bounds
+     */
+    void Rebuild_Zones();
+
+    /**
+     * Alloc_Cell_Array / Free_Cell_Array - Constructed cell array on
+     * large pages where available (see LargePages)
+     */
+    static CellClass* Alloc_Cell_Array();
+    static void Free_Cell_Array(CellClass* cells);
+
     // -------------------------------------------------------------------------
     // Protected Members
     // -------------------------------------------------------------------------
@@ -235,12 +597,29 @@ protected:
     // Cell storage
     CellClass* cells_;          // Array of cells [MAP_CELL_TOTAL]
     bool cells_owned_;          // Did we allocate cells_?
+    CellLayoutType cell_layout_;// Ordering of cells_ (see Cell_Storage_Index)
+    CellLayers* layers_;        // Packed copies of hot cell fields
+    ZoneMap* zones_;            // Connectivity of the land layer
+    VisionMap* vision_;         // Per-house sight
+    BuildMap* build_;           // Where each house may build
+    TiberiumGrowth* tiberium_;  // Ore cells of the overlay layer
+    OreFields* ore_fields_;     // Ore and gems by cell block
+
+    // Object occupancy (see Occupy_Cell)
+    struct OverflowEntry {
+        CELL cell;
+        ObjectClass* object;
+    };
+    int block_occupancy_[CELL_TILE_TOTAL];      // Objects per 8x8 cell block
+    std::vector<OverflowEntry> overflow_;       // Objects in full cells
 
     // Map bounds (scenario play area)
     int map_x_;                 // Left edge cell X
     int map_y_;                 // Top edge cell Y
     int map_width_;             // Width in cells
     int map_height_;            // Height in cells
+    uint32_t land_revision_;    // See Get_Land_Revision()
+    uint64_t cell_hash_;        // See Get_Cell_Hash()
 
     // Theater
     TheaterType theater_type_;  // Current terrain theme
@@ -248,6 +627,11 @@ protected:
     // Tactical view position
     COORDINATE tactical_pos_;   // Top-left of viewport in leptons
 
+    // Change tracking (one bit per cell, row-major like cells_)
+    static constexpr int CHANGED_WORDS = MAP_CELL_TOTAL / 64;
+    uint64_t changed_cells_[CHANGED_WORDS];
+    bool any_cell_changed_;
+
     // Dummy cell for out-of-bounds access
     static CellClass dummy_cell_;
 };
@@ -0,0 +1,152 @@
+/**
+ * Memory Budget - One account of every resident cache, with a hard cap
+ *
+ * Shapes, tiles, sounds, music and cached MIX data each keep their own
+ * memory and, at best, their own budget. MemoryBudget is where they all
+ * report: each cache registers how to count its bytes and how to give
+ * some back, and Update() (once per frame) keeps the total in check.
+ *
+ * Usage:
+ *   int id = MemoryBudget::Instance().Register("Shapes", 2,
+ *       []() { return ShapeCache::Instance().GetMemoryUsage(); },
+ *       [](size_t bytes) { return ShapeCache::Instance().Release(bytes); });
+ *   MemoryBudget::Instance().Set_Limit(96 * 1024 * 1024);
+ */
+
+#ifndef GAME_MEMORY_BUDGET_H
+#define GAME_MEMORY_BUDGET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// MemoryBudget
+// =============================================================================
+
+/**
+ * MemoryBudget - Registry of caches and the eviction policy over them
+ *
+ * Update() first trims any cache over its own budget, then, while the
+ * total is over the process limit or the system is short of RAM, asks
+ * caches to evict in cost-benefit order: the most bytes per unit of
+ * reload cost go first, so a big cache that is cheap to refill (cached
+ * MIX data, which falls back to the mapped file) is emptied before a
+ * small one every frame depends on (terrain tiles).
+ *
+ * Callbacks run on the calling (main) thread; a cache owned by another
+ * thread takes its own lock inside them.
+ */
+class MemoryBudget {
+public:
+    /**
+     * Bytes the cache holds right now
+     */
+    using BytesFn = std::function<size_t()>;
+
+    /**
+     * Free at least bytes if possible; return the bytes actually freed
+     */
+    using EvictFn = std::function<size_t(size_t bytes)>;
+
+    // System RAM is polled this often while a free-RAM floor is set
+    static constexpr uint32_t RAM_POLL_FRAMES = 60;
+
+    struct CacheStats {
+        std::string name;
+        size_t bytes = 0;               // As of the last Update()
+        size_t budget = 0;              // Own cap (0 = none)
+        int reload_cost = 1;            // Relative cost per byte to refill
+        uint64_t evicted_bytes = 0;     // Since registration
+    };
+
+    static MemoryBudget& Instance();
+
+    MemoryBudget() = default;
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    /**
+     * Register a cache
+     *
+     * @param name        Shown in reports and as the "Mem <name>" profiler track
+     * @param reload_cost Relative cost per byte of refilling it (>= 1)
+     * @param bytes       Counts its resident bytes
+     * @param evict       Frees bytes on request
+     * @return Id for the other calls
+     */
+    int Register(const char* name, int reload_cost, BytesFn bytes, EvictFn evict);
+    void Unregister(int id);
+
+    /**
+     * Cap one cache on its own (0 = none)
+     */
+    void Set_Budget(int id, size_t bytes);
+
+    /**
+     * Cap the total over every cache (0 = none)
+     */
+    void Set_Limit(size_t bytes) { limit_ = bytes; }
+    size_t Get_Limit() const { return limit_; }
+
+    /**
+     * Evict while Platform_Ram_Free() is below this (0 = ignore RAM)
+     */
+    void Set_Min_Free_Ram(size_t bytes) { min_free_ram_ = bytes; }
+    size_t Get_Min_Free_Ram() const { return min_free_ram_; }
+
+    /**
+     * Recount every cache and evict until within limits
+     *
+     * @return Bytes evicted
+     */
+    size_t Update();
+
+    /**
+     * Evict up to bytes across all caches in cost-benefit order
+     *
+     * @return Bytes evicted
+     */
+    size_t Evict(size_t bytes);
+
+    size_t Get_Total_Bytes() const { return total_bytes_; }
+    uint64_t Get_Evicted_Bytes() const { return evicted_bytes_; }
+
+    /**
+     * Per-cache figures, indexed by registration id (null if unregistered)
+     */
+    int Get_Cache_Count() const { return static_cast<int>(caches_.size()); }
+    const CacheStats* Get_Stats(int id) const;
+
+    /**
+     * Log one line per cache: bytes, budget and evictions
+     */
+    void Log_Report() const;
+
+private:
+    struct Cache {
+        CacheStats stats;
+        BytesFn bytes;
+        EvictFn evict;
+        uint16_t profile_id = 0;        // ProfileSampleId of the "Mem" track
+        bool active = false;
+    };
+
+    size_t Recount();
+    size_t Evict_From(Cache& cache, size_t bytes);
+    size_t Ram_Shortfall();
+
+    std::vector<Cache> caches_;
+    std::vector<int> order_;            // Eviction order scratch
+    size_t limit_ = 0;
+    size_t min_free_ram_ = 0;
+    size_t ram_shortfall_ = 0;          // From the last RAM poll
+    uint32_t frames_since_poll_ = RAM_POLL_FRAMES;
+    size_t total_bytes_ = 0;
+    uint64_t evicted_bytes_ = 0;
+};
+
+#endif // GAME_MEMORY_BUDGET_H
@@ -0,0 +1,88 @@
+/**
+ * MixView - Zero-Copy Access to Files in MIX Archives
+ *
+ * Wraps Platform_Mix_Map() / Platform_Mix_Unmap(). The bytes point
+ * straight into the cached archive or the memory-mapped MIX file, so
+ * loaders parse them in place instead of sizing and allocating a buffer
+ * for Platform_Mix_Read(). The view unmaps itself when destroyed.
+ *
+ * The data is read-only and shared; copy out anything that must outlive
+ * the view.
+ *
+ * Usage:
+ *   MixView view("E1.SHP");
+ *   if (view) Parse(view.Data(), view.Size());
+ */
+
+#ifndef GAME_MIX_VIEW_H
+#define GAME_MIX_VIEW_H
+
+#include "platform.h"
+#include <cstdint>
+
+class MixView {
+public:
+    MixView() = default;
+    explicit MixView(const char* filename) { Open(filename); }
+    ~MixView() { Close(); }
+
+    MixView(const MixView&) = delete;
+    MixView& operator=(const MixView&) = delete;
+
+    MixView(MixView&& other) noexcept
+        : data_(other.data_)
+        , size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MixView& operator=(MixView&& other) noexcept {
+        if (this != &other) {
+            Close();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * Map a file from the registered MIX archives (replaces any open view)
+     *
+     * @return false if the file is missing or empty
+     */
+    bool Open(const char* filename) {
+        Close();
+        if (filename) {
+            data_ = Platform_Mix_Map(filename, &size_);
+        }
+        if (!data_) {
+            size_ = 0;
+        }
+        return data_ != nullptr;
+    }
+
+    /**
+     * Release the view
+     */
+    void Close() {
+        if (data_) {
+            Platform_Mix_Unmap(data_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    const uint8_t* Data() const { return data_; }
+    int32_t Size() const { return size_; }
+    bool IsOpen() const { return data_ != nullptr; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    int32_t size_ = 0;
+};
+
+#endif // GAME_MIX_VIEW_H
@@ -0,0 +1,114 @@
+/**
+ * MovementSystem - Batched movement for mobile units
+ *
+ * Every FootClass with somewhere to go is registered here, and its
+ * position, facing, speed and path cursor are kept in packed parallel
+ * arrays. Each tick turns every body in one pass and steps every unit
+ * along its facing in another, both over plain integers, and only the
+ * units that crossed a cell boundary or reached a waypoint go back to
+ * the object for cell bookkeeping.
+ *
+ * Original location: CODE/DRIVE.CPP, CODE/FOOT.CPP (Basic_Path, AI)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/facing.h"
+#include <cstdint>
+#include <vector>
+
+class FootClass;
+
+// =============================================================================
+// MovementSystem
+// =============================================================================
+
+class MovementSystem {
+public:
+    /**
+     * Longest path a unit can be given; longer paths are truncated
+     */
+    static constexpr int MAX_WAYPOINTS = 16;
+
+    static MovementSystem& Instance();
+
+    MovementSystem() = default;
+    ~MovementSystem();
+
+    MovementSystem(const MovementSystem&) = delete;
+    MovementSystem& operator=(const MovementSystem&) = delete;
+
+    /**
+     * Send a unit along a list of waypoints, replacing any current path
+     *
+     * The unit must already be placed on the map.
+     *
+     * @return false if the unit is not placed or the path is empty
+     */
+    bool Set_Path(FootClass* unit, const COORDINATE* points, int count);
+
+    /**
+     * Send a unit straight to one coordinate
+     */
+    bool Move_To(FootClass* unit, COORDINATE dest) { return Set_Path(unit, &dest, 1); }
+
+    /**
+     * Stop a unit where it stands and release it
+     */
+    void Stop(FootClass* unit);
+
+    /**
+     * Update a registered unit's speed (leptons per tick)
+     */
+    void Set_Speed(FootClass* unit, int speed);
+
+    /**
+     * Forget a unit without touching its position
+     */
+    void Remove(FootClass* unit);
+
+    /**
+     * Run one tick of turning and driving for every registered unit
+     */
+    void Update();
+
+    /**
+     * Forget every unit
+     */
+    void Clear();
+
+    int Count() const { return static_cast<int>(units_.size()); }
+
+    /**
+     * Get number of cell boundaries crossed since the last Clear()
+     */
+    uint32_t Get_Cell_Transitions() const { return cell_transitions_; }
+
+private:
+    int Add(FootClass* unit);
+    void Erase(int index);
+    void Aim(int index);
+    void Next_Waypoint(int index);
+
+    // One entry per registered unit, all indexed alike
+    std::vector<FootClass*> units_;
+    std::vector<int32_t> x_;                // Position (leptons)
+    std::vector<int32_t> y_;
+    std::vector<int32_t> dest_x_;           // Current waypoint (leptons)
+    std::vector<int32_t> dest_y_;
+    std::vector<int32_t> speed_;            // Leptons per tick
+    std::vector<DirType> facing_;           // Current body facing
+    std::vector<DirType> desired_;          // Facing toward the waypoint
+    std::vector<uint8_t> rate_;             // Turn rate (0 = instant)
+    std::vector<CELL> cell_;                // Cell last marked
+    std::vector<uint8_t> path_cursor_;      // Index of current waypoint
+    std::vector<uint8_t> path_length_;
+    std::vector<COORDINATE> path_;          // MAX_WAYPOINTS per unit
+
+    // Per-tick scratch, filled by the driving pass
+    std::vector<uint8_t> arrived_;
+    std::vector<CELL> new_cell_;
+
+    uint32_t cell_transitions_ = 0;
+};
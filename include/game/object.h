@@ -11,12 +11,14 @@
 
 #include "game/abstract.h"
 #include "game/coord.h"
+#include "game/fixed.h"
 #include "game/house.h"
 #include <cstdint>
 
 // Forward declarations
 class CellClass;
 class DisplayClass;
+template <typename T> class SpatialGrid;
 
 // =============================================================================
 // Object Constants
@@ -64,6 +66,21 @@ public:
     virtual COORDINATE Get_Coord() const override { return coord_; }
     virtual void Set_Coord(COORDINATE coord);
 
+    /**
+     * Remember the current coordinate as the previous tick's position
+     *
+     * Called before each logic tick so rendering can interpolate.
+     */
+    void Latch_Coord() { prev_coord_ = coord_; }
+
+    /**
+     * Get position to draw at, between the previous tick and this one
+     *
+     * @param alpha Fraction of the next tick elapsed (GameClass::Get_Render_Alpha)
+     * @return Interpolated coordinate, or the current one after a jump
+     */
+    COORDINATE Render_Coord(float alpha) const;
+
     /**
      * Get/set cell position
      */
@@ -95,6 +112,11 @@ public:
      */
     int Health_Percent() const;
 
+    /**
+     * Get health as a fraction of full strength (0 to 1)
+     */
+    fixed Health_Ratio() const;
+
     /**
      * Is object at full health?
      */
@@ -127,7 +149,7 @@ public:
     /**
      * Set owner
      */
-    void Set_Owner(HousesType house) { owner_ = house; }
+    void Set_Owner(HousesType house);
 
     /**
      * Is owned by specific house?
@@ -211,20 +233,17 @@ public:
     virtual void Destroyed();
 
     // -------------------------------------------------------------------------
-    // Object List
+    // State Hash
     // -------------------------------------------------------------------------
 
     /**
-     * Link/Unlink from global object list
-     */
-    void Link_To_List();
-    void Unlink_From_List();
-
-    /**
-     * Get next/previous in list
+     * Toggle_State_Hash - XOR this object's term into the StateHash
+     *
+     * Called once before and once after changing a hashed field
+     * (coordinate, strength, owner), and by the heap as the object is
+     * tracked and untracked. Does nothing for objects outside a heap.
      */
-    ObjectClass* Next_Object() const { return next_; }
-    ObjectClass* Prev_Object() const { return prev_; }
+    void Toggle_State_Hash() const;
 
 protected:
     // -------------------------------------------------------------------------
@@ -232,26 +251,19 @@ protected:
     // -------------------------------------------------------------------------
 
     COORDINATE coord_;       // World position
+    COORDINATE prev_coord_;  // Position at the start of this tick
     int strength_;           // Current health
     HousesType owner_;       // Owning house
     bool is_selected_;       // Selection state
-
-    // Object list links
-    ObjectClass* next_;
-    ObjectClass* prev_;
 };
 
 // =============================================================================
-// Global Object List
+// Spatial Index
 // =============================================================================
 
 /**
- * AllObjects - Head of global object list
- */
-extern ObjectClass* AllObjects;
-
-/**
- * Object iteration helper
+ * Object_Grid - Spatial index of placed objects by world pixel position
+ *
+ * Maintained by Mark_Cell/Unmark_Cell; see game/spatial_grid.h for queries.
  */
-#define FOR_ALL_OBJECTS(var) \
-    for (ObjectClass* var = AllObjects; var != nullptr; var = var->Next_Object())
+SpatialGrid<ObjectClass>& Object_Grid();
@@ -0,0 +1,102 @@
+/**
+ * ObjectDispatch - Static, per-RTTI dispatch for object behavior
+ *
+ * Every heap object is exactly the class its kind maps to (ObjectKind), so
+ * once the RTTI is known the virtual call can be made directly. Two ways
+ * to use that:
+ *
+ *   - Type-partitioned loops: With_Techno_Kind() turns an RTTI into a
+ *     template argument once per run of same-kind objects, and the loop
+ *     body calls obj->T::Weapon_Range() etc. These are plain calls the
+ *     compiler can inline, with no per-object indirect branch.
+ *   - Object_Dispatch(): a table of AI/Draw/Take_Damage entry points per
+ *     RTTI, for mixed-kind call sites (a shot's target can be anything).
+ *     Objects outside the heaps (RTTI_NONE) fall back to the vtable.
+ *
+ * Adding a class for a kind means changing its ObjectKind entry; the
+ * heaps, the dispatch table and the type-partitioned loops follow.
+ */
+
+#pragma once
+
+#include "game/core/rtti.h"
+#include "game/techno.h"
+
+// =============================================================================
+// ObjectKind
+// =============================================================================
+
+/**
+ * ObjectKind - The class every object of kind R is an instance of
+ *
+ * Units, infantry, vessels and aircraft are all FootClass until their own
+ * classes are ported; buildings are TechnoClass.
+ */
+template <RTTIType R>
+struct ObjectKind {
+    using Type = ObjectClass;
+};
+
+template <> struct ObjectKind<RTTI_UNIT> { using Type = FootClass; };
+template <> struct ObjectKind<RTTI_INFANTRY> { using Type = FootClass; };
+template <> struct ObjectKind<RTTI_VESSEL> { using Type = FootClass; };
+template <> struct ObjectKind<RTTI_AIRCRAFT> { using Type = FootClass; };
+template <> struct ObjectKind<RTTI_BUILDING> { using Type = TechnoClass; };
+
+/**
+ * With_Techno_Kind - Call fn.template operator()<T>() for a techno kind
+ *
+ * fn is a generic lambda taking the class as a tag: [&](auto* tag) { using
+ * T = std::remove_pointer_t<decltype(tag)>; ... }. Does nothing for
+ * kinds that are not technos.
+ */
+template <typename Fn>
+void With_Techno_Kind(RTTIType rtti, Fn&& fn) {
+    switch (rtti) {
+        case RTTI_UNIT:
+            fn(static_cast<ObjectKind<RTTI_UNIT>::Type*>(nullptr));
+            break;
+        case RTTI_INFANTRY:
+            fn(static_cast<ObjectKind<RTTI_INFANTRY>::Type*>(nullptr));
+            break;
+        case RTTI_VESSEL:
+            fn(static_cast<ObjectKind<RTTI_VESSEL>::Type*>(nullptr));
+            break;
+        case RTTI_AIRCRAFT:
+            fn(static_cast<ObjectKind<RTTI_AIRCRAFT>::Type*>(nullptr));
+            break;
+        case RTTI_BUILDING:
+            fn(static_cast<ObjectKind<RTTI_BUILDING>::Type*>(nullptr));
+            break;
+        default:
+            break;
+    }
+}
+
+// =============================================================================
+// ObjectDispatch
+// =============================================================================
+
+/**
+ * ObjectDispatch - Behavior entry points for one object kind
+ */
+struct ObjectDispatch {
+    void (*ai)(ObjectClass* obj);
+    void (*draw)(ObjectClass* obj, int x, int y, void* window);
+    int (*take_damage)(ObjectClass* obj, int damage, ObjectClass* source, int warhead);
+};
+
+/**
+ * Object_Dispatch - Entry points for objects of a kind
+ *
+ * RTTI_NONE and non-object kinds get entries that call through the vtable.
+ */
+const ObjectDispatch& Object_Dispatch(RTTIType rtti);
+
+/**
+ * Dispatch_Take_Damage - obj->Take_Damage() without a virtual call
+ */
+inline int Dispatch_Take_Damage(ObjectClass* obj, int damage, ObjectClass* source = nullptr,
+                                int warhead = 0) {
+    return Object_Dispatch(obj->What_Am_I()).take_damage(obj, damage, source, warhead);
+}
@@ -0,0 +1,277 @@
+/**
+ * ObjectHeap - Per-class pooled storage for game objects
+ *
+ * Each object kind (RTTI) gets its own pool, and every heap keeps a dense
+ * array of its live objects so the simulation can walk one kind at a time
+ * in a tight, type-homogeneous loop.
+ *
+ * Original location: CODE/HEAP.H, CODE/HEAP.CPP (FixedIHeapClass)
+ */
+
+#pragma once
+
+#include "game/object.h"
+#include "game/core/rtti.h"
+#include "platform/memory_pool.h"
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// ObjectHandle
+// =============================================================================
+
+/**
+ * ObjectHandle - Reference to an object that survives its destruction
+ *
+ * Resolves to nullptr once the object is freed, even if its memory and
+ * slot have been reused since. Safe to keep across ticks (targets,
+ * selections) where a raw pointer could dangle.
+ */
+struct ObjectHandle {
+    RTTIType rtti = RTTI_NONE;
+    uint16_t slot = 0;
+    uint16_t generation = 0;
+
+    bool Is_None() const { return rtti == RTTI_NONE; }
+    bool operator==(const ObjectHandle& other) const {
+        return rtti == other.rtti && slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+// =============================================================================
+// ObjectHeapBase
+// =============================================================================
+
+/**
+ * ObjectHeapBase - Live-object tracking shared by every heap
+ *
+ * An object's heap ID is its index in the active array; freeing moves the
+ * last active object into the hole, so IDs are only stable while no object
+ * of the same kind is freed. Use an ObjectHandle to refer to an object
+ * for longer.
+ */
+class ObjectHeapBase {
+public:
+    explicit ObjectHeapBase(RTTIType rtti) : rtti_(rtti) {}
+    virtual ~ObjectHeapBase() = default;
+
+    ObjectHeapBase(const ObjectHeapBase&) = delete;
+    ObjectHeapBase& operator=(const ObjectHeapBase&) = delete;
+
+    /**
+     * Allocate a default object of this heap's kind
+     */
+    virtual ObjectClass* Alloc_Object() = 0;
+
+    /**
+     * Destroy an object and return its slot to the pool
+     */
+    virtual void Free_Object(ObjectClass* obj) = 0;
+
+    /**
+     * Destroy every live object
+     */
+    void Free_All();
+
+    /**
+     * Run one logic tick for every live object
+     *
+     * Latches each object's coordinate for interpolation, then calls AI()
+     * on the active ones. Objects may free themselves from AI().
+     */
+    virtual void AI_Pass() = 0;
+
+    /**
+     * Get a handle to one of this heap's objects
+     */
+    virtual ObjectHandle Handle_Of(const ObjectClass* obj) const = 0;
+
+    /**
+     * Find the object a handle refers to
+     *
+     * @return Object, or nullptr if it has been freed
+     */
+    virtual ObjectClass* Resolve(ObjectHandle handle) const = 0;
+
+    RTTIType Get_RTTI() const { return rtti_; }
+    int Count() const { return static_cast<int>(active_.size()); }
+    ObjectClass* Active(int index) const { return active_[index]; }
+
+    /**
+     * Call fn(obj) for each live object, last allocated first
+     *
+     * fn may free the object it is given, but no other object of this kind.
+     */
+    template <typename Fn>
+    void For_Each(Fn fn) {
+        for (int i = Count() - 1; i >= 0; i--) {
+            fn(active_[i]);
+        }
+    }
+
+protected:
+    /**
+     * Stamp a new object with this heap's RTTI, ID and pool slot and track it
+     */
+    void Track(ObjectClass* obj, int slot);
+
+    /**
+     * Stop tracking an object about to be freed
+     *
+     * @return Its pool slot, or -1 if the object does not belong to this heap
+     */
+    int Untrack(ObjectClass* obj);
+
+    /**
+     * Pool slot of a tracked object (-1 if none)
+     */
+    static int Slot_Of(const ObjectClass* obj);
+
+    RTTIType rtti_;
+    std::vector<ObjectClass*> active_;      // Live objects, indexed by heap ID
+};
+
+// =============================================================================
+// ObjectHeap
+// =============================================================================
+
+/**
+ * ObjectHeap - Heap of one object class
+ *
+ * Objects live in fixed blocks of BlockSize from a SlotPool, so pointers
+ * stay valid until the object is freed. An ObjectHandle is the pool's
+ * slot and generation, checked by the pool.
+ */
+template <typename T, size_t BlockSize = 64>
+class ObjectHeap : public ObjectHeapBase {
+public:
+    explicit ObjectHeap(RTTIType rtti) : ObjectHeapBase(rtti) {}
+    ~ObjectHeap() override { Free_All(); }
+
+    T* Alloc() {
+        SlotHandle handle = pool_.allocate();
+        T* obj = pool_.get(handle);
+        if (obj != nullptr) {
+            Track(obj, static_cast<int>(handle.index()));
+        }
+        return obj;
+    }
+
+    void Free(T* obj) {
+        int slot = obj ? Untrack(obj) : -1;
+        if (slot < 0) return;
+        pool_.deallocate(pool_.handle_at(static_cast<uint32_t>(slot)));
+    }
+
+    ObjectClass* Alloc_Object() override { return Alloc(); }
+    void Free_Object(ObjectClass* obj) override { Free(static_cast<T*>(obj)); }
+
+    ObjectHandle Handle_Of(const ObjectClass* obj) const override {
+        ObjectHandle handle;
+        int slot = obj ? Slot_Of(obj) : -1;
+        if (slot >= 0 && pool_.at(static_cast<uint32_t>(slot)) == obj) {
+            handle.rtti = rtti_;
+            handle.slot = static_cast<uint16_t>(slot);
+            handle.generation = static_cast<uint16_t>(pool_.handle_at(handle.slot).generation());
+        }
+        return handle;
+    }
+
+    ObjectClass* Resolve(ObjectHandle handle) const override {
+        if (handle.rtti != rtti_) return nullptr;
+        return pool_.get(SlotHandle::make(handle.slot, handle.generation));
+    }
+
+    void AI_Pass() override {
+        // Every object here is exactly a T, so AI() is called directly
+        // rather than through the vtable
+        for (int i = Count() - 1; i >= 0; i--) {
+            T* obj = static_cast<T*>(active_[i]);
+            if (i > 0) {
+                __builtin_prefetch(active_[i - 1]);
+            }
+            obj->Latch_Coord();
+            if (obj->Is_Active()) {
+                obj->T::AI();
+            }
+        }
+    }
+
+    T* operator[](int index) const { return static_cast<T*>(active_[index]); }
+
+    /**
+     * Get number of slots allocated (live plus free)
+     */
+    size_t Capacity() const { return pool_.capacity(); }
+
+private:
+    SlotPool<T, BlockSize> pool_;
+};
+
+// =============================================================================
+// Object Creation
+// =============================================================================
+
+/**
+ * Object_Heap - Heap holding objects of a kind
+ *
+ * @return Heap, or nullptr for RTTI values that are not objects
+ */
+ObjectHeapBase* Object_Heap(RTTIType rtti);
+
+/**
+ * Create_Object - Allocate an object from its kind's heap
+ *
+ * The object is not placed on the map.
+ *
+ * @return New object, or nullptr for RTTI values that are not objects
+ */
+ObjectClass* Create_Object(RTTIType rtti);
+
+/**
+ * Destroy_Object - Return an object to its heap
+ */
+void Destroy_Object(ObjectClass* obj);
+
+/**
+ * Object_Handle - Get a stable handle to a heap-allocated object
+ */
+ObjectHandle Object_Handle(const ObjectClass* obj);
+
+/**
+ * Resolve_Object - Find the object a handle refers to
+ *
+ * @return Object, or nullptr if it has been freed (or the handle is none)
+ */
+ObjectClass* Resolve_Object(ObjectHandle handle);
+
+/**
+ * Object_Count - Get number of live objects of every kind
+ */
+int Object_Count();
+
+/**
+ * AI_All_Objects - Run one logic tick for every object, a kind at a time
+ */
+void AI_All_Objects();
+
+/**
+ * Destroy_All_Objects - Empty every heap
+ */
+void Destroy_All_Objects();
+
+/**
+ * For_Each_Object - Call fn(obj) for each live object, one kind at a time
+ *
+ * Kinds are visited in RTTI order; within a kind, as ObjectHeapBase::For_Each.
+ */
+template <typename Fn>
+void For_Each_Object(Fn fn) {
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        ObjectHeapBase* heap = Object_Heap(static_cast<RTTIType>(rtti));
+        if (heap) {
+            heap->For_Each(fn);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * Power Saver - Draws only what changed, and slowly when nobody looks
+ *
+ * The main loop draws and presents every frame at the full rate even
+ * when nothing on screen moves (the main menu) or nobody can see it
+ * (the window is minimized or in the background). On always-on kiosks
+ * that is heat and power for nothing.
+ *
+ * Once per frame, after input, Begin_Frame() decides:
+ *
+ *   Active       Drawn every frame at the full rate.
+ *   Static       Nothing moves by itself. Drawn when an event arrives
+ *                (input, a window expose), when Invalidate() is called,
+ *                and every STATIC_REDRAW_MS for timers; in between the
+ *                loop sleeps in Platform_WaitEvents().
+ *   Background   The window is in the background. Drawn every frame,
+ *                but the loop runs at BACKGROUND_FPS; the simulation
+ *                keeps up through TickClock's catch-up ticks.
+ *
+ * Get_Wait_Ms() is how long to wait for events at the end of the frame.
+ *
+ * Sample_Cpu() turns process CPU time into CPU milliseconds per second
+ * of wall time, published as the "CPU (ms/s)" profiler value.
+ *
+ * Usage:
+ *   if (saver.Begin_Frame(now, background, static_screen, Platform_GetEventCount())) {
+ *       Render_Frame(alpha);
+ *   }
+ *   ...
+ *   Platform_WaitEvents(saver.Get_Wait_Ms(Platform_Timer_GetTicks()));
+ */
+
+#ifndef GAME_POWER_SAVER_H
+#define GAME_POWER_SAVER_H
+
+#include <cstdint>
+
+// =============================================================================
+// PowerSaver
+// =============================================================================
+
+class PowerSaver {
+public:
+    enum State : uint8_t {
+        POWER_ACTIVE = 0,
+        POWER_STATIC,
+        POWER_BACKGROUND
+    };
+
+    // Four catch-up ticks a frame still cover the fastest game speed
+    static constexpr uint32_t BACKGROUND_FPS = 10;
+    static constexpr uint32_t STATIC_REDRAW_MS = 1000;
+    static constexpr uint32_t CPU_WINDOW_MS = 1000;
+
+    struct Stats {
+        uint32_t frames_drawn;
+        uint32_t frames_skipped;
+    };
+
+    PowerSaver() = default;
+
+    /**
+     * On by default; off, every frame is active
+     */
+    void Set_Enabled(bool enabled) { enabled_ = enabled; }
+    bool Is_Enabled() const { return enabled_; }
+
+    /**
+     * Judge this frame
+     *
+     * @param now Current time (milliseconds)
+     * @param background Window minimized or in the background
+     * @param static_screen Nothing on screen changes unless an event does it
+     * @param events Platform_GetEventCount()
+     * @return true to draw and present this frame
+     */
+    bool Begin_Frame(uint32_t now, bool background, bool static_screen, uint32_t events);
+
+    /**
+     * Draw the next static frame regardless
+     */
+    void Invalidate() { dirty_ = true; }
+
+    /**
+     * Milliseconds to wait for events before the next frame (0 = none)
+     */
+    uint32_t Get_Wait_Ms(uint32_t now) const;
+
+    State Get_State() const { return state_; }
+    bool Should_Draw() const { return draw_; }
+    const Stats& Get_Stats() const { return stats_; }
+
+    /**
+     * Feed process counters (nanoseconds); the rate updates once a
+     * CPU_WINDOW_MS has passed since the last update
+     */
+    void Sample_Cpu(int64_t wall_ns, int64_t cpu_ns);
+
+    /**
+     * CPU time the process used per second of wall time (1000 = one core)
+     */
+    double Get_Cpu_Ms_Per_Second() const { return cpu_ms_per_s_; }
+
+private:
+    bool enabled_ = true;
+    State state_ = POWER_ACTIVE;
+    bool draw_ = true;
+    bool dirty_ = true;
+    uint32_t events_ = 0;           // Event count at the last frame
+    uint32_t frame_start_ = 0;
+    uint32_t last_draw_ = 0;
+    Stats stats_ = {};
+
+    int64_t cpu_wall_ns_ = -1;      // Counters at the last rate update
+    int64_t cpu_ns_ = 0;
+    double cpu_ms_per_s_ = 0.0;
+};
+
+#endif // GAME_POWER_SAVER_H
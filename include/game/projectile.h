@@ -0,0 +1,151 @@
+/**
+ * ProjectileSystem - Pooled bullets and animations
+ *
+ * Bullets in flight and one-shot animations (explosions, smoke, muzzle
+ * flashes) are short-lived, numerous and all do the same thing each
+ * tick: move, count down and advance a frame. They are kept here in
+ * fixed-capacity parallel arrays rather than as heap objects, and one
+ * loop per tick integrates every entry. Expired entries are removed by
+ * moving the last entry into their slot, so the live entries are always
+ * the first Count() of each array.
+ *
+ * A bullet that runs out of flight time has arrived: it reports an
+ * impact sound and, if it was given one, starts its impact animation
+ * where it landed. Damage is not dealt here; CombatSystem applies it
+ * when the shot is fired.
+ *
+ * Drawing needs no objects either: Submit() queues one RenderCommand per
+ * entry straight from the arrays.
+ *
+ * Original location: CODE/BULLET.CPP (BulletClass::AI), CODE/ANIM.CPP (AnimClass::AI)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/graphics/render_layer.h"
+#include "game/graphics/shape_id.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class RenderPipeline;
+
+// Pool size; spawns beyond it are dropped
+constexpr int PROJECTILE_CAPACITY = 1024;
+
+// =============================================================================
+// ProjectileSystem
+// =============================================================================
+
+class ProjectileSystem {
+public:
+    struct Stats {
+        uint32_t spawned;           // Entries added
+        uint32_t dropped;           // Spawns refused, pool full
+        uint32_t impacts;           // Bullets that arrived
+        uint32_t expired;           // Entries removed
+    };
+
+    static ProjectileSystem& Instance();
+
+    ProjectileSystem();
+
+    ProjectileSystem(const ProjectileSystem&) = delete;
+    ProjectileSystem& operator=(const ProjectileSystem&) = delete;
+
+    /**
+     * Remove every entry
+     */
+    void Clear();
+
+    /**
+     * Launch a bullet from one coordinate to another
+     *
+     * @param shape Bullet shape, drawn at frame (its facing frame)
+     * @param speed Leptons per tick; the flight takes distance / speed
+     *              ticks, rounded up, and ends exactly on to
+     * @param impact Animation started on arrival, or SHAPE_ID_NONE
+     * @param impact_frames Length of that animation in ticks
+     * @return Pool index, or -1 if the pool is full
+     */
+    int Fire(ShapeId shape, int frame, COORDINATE from, COORDINATE to, int speed,
+             ShapeId impact = SHAPE_ID_NONE, int impact_frames = 0);
+
+    /**
+     * Play an animation once at a coordinate, one frame per tick
+     *
+     * @return Pool index, or -1 if the pool is full
+     */
+    int Spawn_Anim(ShapeId shape, COORDINATE at, int frames, int first_frame = 0);
+
+    /**
+     * Advance every entry one tick
+     */
+    void Update();
+
+    /**
+     * Queue every entry on the render pipeline
+     *
+     * @return Commands queued (off-screen entries are culled)
+     */
+    int Submit(RenderPipeline& pipeline) const;
+
+    /**
+     * Share of animations Submit() draws, of 256 (QualityGovernor)
+     *
+     * Which ones are left out is fixed by where they play, so a skipped
+     * animation stays hidden for its whole life instead of flickering.
+     * Bullets are always drawn, and nothing but drawing changes.
+     */
+    void Set_Anim_Density(int density) { anim_density_ = std::clamp(density, 0, 256); }
+    int Get_Anim_Density() const { return anim_density_; }
+
+    int Count() const { return count_; }
+
+    /**
+     * Entry state by pool index (valid until the next Update)
+     */
+    COORDINATE Get_Coord(int index) const;
+    int Get_Frame(int index) const { return frame_[index]; }
+    int Get_Life(int index) const { return life_[index]; }
+    ShapeId Get_Shape(int index) const { return shape_[index]; }
+    RenderLayer Get_Layer(int index) const { return static_cast<RenderLayer>(layer_[index]); }
+
+    const Stats& Get_Stats() const { return stats_; }
+    void Reset_Stats() { stats_ = Stats(); }
+
+private:
+    friend class SaveLoad;
+
+    // Positions carry 8 fraction bits below the lepton so slow, long
+    // flights still land on their target
+    static constexpr int SUB_BITS = 8;
+
+    struct Impact {
+        int32_t x, y;
+        ShapeId shape;
+        uint16_t frames;
+    };
+
+    int Append(ShapeId shape, int frame, COORDINATE at, RenderLayer layer);
+    void Remove(int index);
+
+    // Indexed alike, first count_ entries live
+    std::vector<int32_t> x_;                // Leptons << SUB_BITS
+    std::vector<int32_t> y_;
+    std::vector<int32_t> vx_;               // Per tick, same scale
+    std::vector<int32_t> vy_;
+    std::vector<uint16_t> life_;            // Ticks left
+    std::vector<ShapeId> shape_;
+    std::vector<uint16_t> frame_;
+    std::vector<uint8_t> frame_step_;       // 0 = bullet (fixed frame), 1 = anim
+    std::vector<uint8_t> layer_;            // RenderLayer
+    std::vector<ShapeId> impact_shape_;     // Bullets only
+    std::vector<uint16_t> impact_frames_;
+    int count_;
+
+    std::vector<Impact> impacts_;           // Arrivals this tick
+    Stats stats_;
+    int anim_density_;
+};
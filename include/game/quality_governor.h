@@ -0,0 +1,129 @@
+/**
+ * Quality Governor - Trades optional work for frame time
+ *
+ * Some of each frame's work can be cut without changing the game: how
+ * many smoke and explosion animations are drawn, the shadow pass, how
+ * often the palette cycles and the radar panel refreshes, and how many
+ * sound effects play at once. When frames run over their budget the
+ * governor cuts these a level at a time; when they are comfortably
+ * under again it gives them back, a level at a time.
+ *
+ * Once per frame, Update() takes a high percentile of the recent frame
+ * times from the Profiler. Cutting takes a short run of frames over
+ * budget; restoring takes a much longer run well under it, and after
+ * each change the governor waits for the window to fill with frames
+ * drawn at the new level, so it does not see-saw between two levels.
+ *
+ * The knobs themselves belong to their subsystems; whoever owns them
+ * hands an ApplyFn that sets them for a level.
+ *
+ * Usage:
+ *   QualityGovernor& governor = QualityGovernor::Instance();
+ *   governor.Set_Apply([](const QualityGovernor::Knobs& knobs) { ... });
+ *   governor.Set_Budget_Ms(16.7);
+ *   governor.Update();     // Once per frame, after Profiler::end_frame()
+ */
+
+#ifndef GAME_QUALITY_GOVERNOR_H
+#define GAME_QUALITY_GOVERNOR_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// =============================================================================
+// QualityGovernor
+// =============================================================================
+
+class QualityGovernor {
+public:
+    /**
+     * What a level allows; level 0 is everything
+     */
+    struct Knobs {
+        int anim_density;           // Share of effect animations drawn, of 256
+        bool shadows;               // Shadow pass drawn
+        int palette_divisor;        // Palette cycles advance every Nth frame
+        int radar_interval;         // Radar panel refreshed every Nth frame
+        int voice_limit;            // Sound effects at once (0 = the pool's size)
+    };
+
+    using ApplyFn = std::function<void(const Knobs& knobs)>;
+
+    static constexpr int MAX_LEVEL = 4;
+
+    static constexpr int WINDOW_FRAMES = 30;        // Frame times looked at
+    static constexpr int PERCENTILE = 90;
+    static constexpr int OVER_FRAMES = 15;          // Over budget this long to cut
+    static constexpr int UNDER_FRAMES = 120;        // Under the recover line this long to restore
+    static constexpr double RECOVER_RATIO = 0.75;   // Recover line, as a share of the budget
+
+    struct Stats {
+        uint32_t cuts;              // Level raised
+        uint32_t restores;          // Level lowered
+    };
+
+    static QualityGovernor& Instance();
+
+    QualityGovernor() = default;
+
+    QualityGovernor(const QualityGovernor&) = delete;
+    QualityGovernor& operator=(const QualityGovernor&) = delete;
+
+    static const Knobs& Get_Knobs(int level);
+
+    /**
+     * Sets the knobs; called with the current level right away and on
+     * every change after
+     */
+    void Set_Apply(ApplyFn apply);
+
+    /**
+     * Frame time to hold (0 = governor off, full quality)
+     */
+    void Set_Budget_Ms(double ms) { budget_ms_ = ms; }
+    double Get_Budget_Ms() const { return budget_ms_; }
+
+    /**
+     * Judge the recent Profiler frame times and publish the level as
+     * the "Quality Level" profiler value
+     *
+     * @return Level now in force
+     */
+    int Update();
+
+    /**
+     * One frame's judgement, given the percentile frame time
+     *
+     * @return Level now in force
+     */
+    int Evaluate(double frame_ms);
+
+    /**
+     * Jump to a level and start the hysteresis over
+     */
+    void Set_Level(int level);
+    int Get_Level() const { return level_; }
+
+    /**
+     * Percentile frame time the last Update() judged
+     */
+    double Get_Frame_Ms() const { return frame_ms_; }
+
+    const Stats& Get_Stats() const { return stats_; }
+
+private:
+    void Change(int level);
+
+    ApplyFn apply_;
+    double budget_ms_ = 0.0;
+    double frame_ms_ = 0.0;
+    int level_ = 0;
+    int over_ = 0;                  // Consecutive frames over budget
+    int under_ = 0;                 // Consecutive frames under the recover line
+    int hold_ = 0;                  // Frames left before judging again
+    std::vector<double> times_;     // Scratch for the percentile
+    Stats stats_ = {};
+};
+
+#endif // GAME_QUALITY_GOVERNOR_H
@@ -0,0 +1,110 @@
+/**
+ * Random - Deterministic random streams for simulation and effects
+ *
+ * The same LCG as Platform_Random_* (RANDOM.ASM's), inlined so a draw is
+ * a multiply and an add instead of a call across the FFI boundary. A
+ * stream seeded like the platform generator gives the same values for
+ * Next(), Range() and Max().
+ *
+ * There are two streams:
+ *
+ *   - Sim_Random(): lockstep state. Everything that changes the
+ *     simulation draws from it and from nothing else; replays and
+ *     resyncs carry its seed, so every peer makes the same draws.
+ *   - Fx_Random(): presentation only (particle jitter, shake, sound
+ *     variation). Free to differ between peers and between frame rates,
+ *     and drawing from it never moves the sim stream.
+ *
+ * Fill() hands out a batch at once for callers that need many values per
+ * tick (scatter patterns, debris); it gives the same values as that many
+ * Next() calls.
+ *
+ * Streams are not thread-safe. The sim stream belongs to the simulation
+ * thread; a job wanting its own randomness should seed a local stream.
+ */
+
+#ifndef GAME_RANDOM_H
+#define GAME_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// =============================================================================
+// RandomStream
+// =============================================================================
+
+class RandomStream {
+public:
+    static constexpr uint32_t MULTIPLIER = 1103515245u;
+    static constexpr uint32_t INCREMENT = 12345u;
+    static constexpr uint32_t MAX_VALUE = 0x7FFF;
+
+    explicit RandomStream(uint32_t seed = 1) : seed_(seed) {}
+
+    void Seed(uint32_t seed) { seed_ = seed; }
+    uint32_t Get_Seed() const { return seed_; }
+
+    /**
+     * Next value (0..MAX_VALUE)
+     */
+    uint32_t Next() {
+        seed_ = seed_ * MULTIPLIER + INCREMENT;
+        return (seed_ >> 16) & MAX_VALUE;
+    }
+
+    /**
+     * Value in [min, max]; min if the range is empty
+     */
+    int32_t Range(int32_t min, int32_t max) {
+        if (min >= max) {
+            return min;
+        }
+        uint32_t span = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1;
+        return static_cast<int32_t>(static_cast<uint32_t>(min) + Next() % span);
+    }
+
+    /**
+     * Value in [0, max); 0 if max is 0
+     */
+    uint32_t Max(uint32_t max) {
+        if (max == 0) {
+            return 0;
+        }
+        return Next() % max;
+    }
+
+    /**
+     * Write the next count values (0..MAX_VALUE) to out
+     *
+     * Steps eight independent lanes from one seed, so the loop carries no
+     * multiply-to-multiply dependency and vectorizes.
+     */
+    void Fill(uint32_t* out, size_t count);
+
+private:
+    uint32_t seed_;
+};
+
+// =============================================================================
+// Streams
+// =============================================================================
+
+/**
+ * Simulation stream; lockstep state
+ */
+RandomStream& Sim_Random();
+
+/**
+ * Presentation stream; never affects the simulation
+ */
+RandomStream& Fx_Random();
+
+/**
+ * Seed the simulation stream
+ *
+ * Also seeds the platform generator, so code still drawing through
+ * Platform_Random_* starts from the same point.
+ */
+void Sim_Random_Seed(uint32_t seed);
+
+#endif // GAME_RANDOM_H
@@ -0,0 +1,128 @@
+/**
+ * Relay - Lockstep packet relay for the dedicated server
+ *
+ * A lockstep match needs nothing from its host but a meeting point:
+ * every peer runs the full simulation and only commands travel. The
+ * relay hosts that meeting point for many matches in one headless
+ * process, with no graphics, audio or input. Each match is one
+ * PlatformHost on its own port. Every packet a peer sends is broadcast
+ * back out to the match on the channel it came in on, with the same
+ * delivery. Peers skip their own echoes by the player id in the
+ * GamePacketHeader. The enet wrapper can't address a single peer, so
+ * the echo can't be suppressed here.
+ *
+ * Usage:
+ *   RelayServer server;
+ *   server.Start(5555, 32, 8);          // 32 matches on ports 5555..5586
+ *   while (running) {
+ *       if (server.Service() == 0) Platform_Timer_Delay(1);
+ *   }
+ *   server.Stop();
+ */
+
+#ifndef GAME_RELAY_H
+#define GAME_RELAY_H
+
+#include <cstdint>
+#include <vector>
+
+struct PlatformHost;
+
+/**
+ * RelayStats - Traffic through one match or the whole server
+ */
+struct RelayStats {
+    uint32_t matches = 0;               // Hosts listening
+    uint32_t active_matches = 0;        // With at least one peer
+    uint32_t peers = 0;
+    uint64_t packets_in = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;             // Counted once per peer sent to
+};
+
+// =============================================================================
+// RelayMatch
+// =============================================================================
+
+class RelayMatch {
+public:
+    static constexpr int CHANNELS = 2;          // Reliable, unreliable
+    static constexpr int BATCH_PACKETS = 64;
+
+    RelayMatch() = default;
+    ~RelayMatch();
+
+    RelayMatch(const RelayMatch&) = delete;
+    RelayMatch& operator=(const RelayMatch&) = delete;
+
+    /**
+     * Listen on port for up to max_players peers
+     *
+     * @return false if the host could not be created
+     */
+    bool Open(uint16_t port, int max_players);
+
+    void Close();
+
+    bool Is_Open() const { return host_ != nullptr; }
+
+    /**
+     * Take in what the peers sent and broadcast it back out
+     *
+     * @return Packets relayed
+     */
+    int Service();
+
+    uint16_t Get_Port() const { return port_; }
+    int Get_Peer_Count() const;
+    const RelayStats& Get_Stats() const { return stats_; }
+
+private:
+    PlatformHost* host_ = nullptr;
+    uint16_t port_ = 0;
+    RelayStats stats_;
+};
+
+// =============================================================================
+// RelayServer
+// =============================================================================
+
+class RelayServer {
+public:
+    RelayServer() = default;
+    ~RelayServer() { Stop(); }
+
+    RelayServer(const RelayServer&) = delete;
+    RelayServer& operator=(const RelayServer&) = delete;
+
+    /**
+     * Open match_count matches on consecutive ports from base_port
+     *
+     * A port that can't be bound is skipped with a warning.
+     *
+     * @return Matches opened
+     */
+    int Start(uint16_t base_port, int match_count, int players_per_match);
+
+    void Stop();
+
+    /**
+     * Service every match once
+     *
+     * @return Packets relayed across all matches
+     */
+    int Service();
+
+    /**
+     * Totals across the matches
+     */
+    RelayStats Get_Stats() const;
+
+    int Get_Match_Count() const { return static_cast<int>(matches_.size()); }
+    const RelayMatch& Get_Match(int index) const { return *matches_[index]; }
+
+private:
+    std::vector<RelayMatch*> matches_;
+};
+
+#endif // GAME_RELAY_H
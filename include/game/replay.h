@@ -0,0 +1,195 @@
+/**
+ * Replay - Recorded matches and headless playback
+ *
+ * The simulation is deterministic given its starting state, the random
+ * seed and the commands the player issued on each tick, so those three
+ * are all a replay stores:
+ *
+ *   - a SaveLoad snapshot of the world when recording began
+ *   - the simulation random seed (Sim_Random) at that moment
+ *   - every command that went through CommandSystem::IssueCommand, with
+ *     the logic tick it was issued before and the ids of the objects
+ *     selected at the time
+ *
+ * Playing one back restores the snapshot, reseeds, and before each logic
+ * tick reissues that tick's commands on the recorded selection. Run
+ * headless (GameClass::Play_Replay), nothing is drawn and ticks run back
+ * to back, so the same replay both reproduces a match and measures
+ * simulation throughput in ticks per second.
+ *
+ * A command's objects are stored by SelectableObject id and looked up
+ * again through the SelectionManager's object query on playback.
+ *
+ * File layout (little-endian, as written by this build):
+ *   ReplayHeader
+ *   snapshot bytes      (a SaveLoad stream, snapshot_size bytes)
+ *   ReplayCommand[command_count]
+ *   uint32_t[id_count]  selection ids, indexed by ReplayCommand::first_id
+ *
+ * Usage:
+ *   ReplayRecorder::Instance().Start(seed, *Map);
+ *   ... play; GameClass ends each tick with ReplayRecorder::End_Tick() ...
+ *   ReplayRecorder::Instance().Stop().Save("MATCH.RPL");
+ *
+ *   Replay replay;
+ *   if (replay.Load("MATCH.RPL")) {
+ *       ReplayStats stats;
+ *       Game->Play_Replay(replay, &stats);
+ *   }
+ *
+ * Original location: CODE/QUEUE.CPP (the RECORD.BIN playback)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MapClass;
+struct Command;
+
+/**
+ * ReplayHeader - Start of a replay file
+ */
+struct ReplayHeader {
+    uint32_t magic;             // REPLAY_MAGIC
+    uint32_t version;           // REPLAY_VERSION
+    uint32_t seed;              // Sim_Random seed when recording began
+    uint32_t tick_count;        // Logic ticks recorded
+    uint32_t command_count;
+    uint32_t id_count;
+    uint32_t snapshot_size;
+};
+
+/**
+ * ReplayCommand - One issued command, as stored
+ */
+struct ReplayCommand {
+    uint32_t tick;              // Issued before this tick (0 = first recorded)
+    int32_t type;               // CommandType
+    uint32_t flags;             // CommandFlags as issued
+    int32_t target_type;        // CommandTarget::Type
+    int32_t world_x;
+    int32_t world_y;
+    int32_t cell_x;
+    int32_t cell_y;
+    uint32_t object_id;         // Target's SelectableObject id (OBJECT targets)
+    uint32_t first_id;          // Selection, in Replay::ids
+    uint32_t id_count;
+};
+
+constexpr uint32_t REPLAY_MAGIC = 0x50524152;   // "RARP"
+constexpr uint32_t REPLAY_VERSION = 1;
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+/**
+ * Replay - A recorded match
+ */
+struct Replay {
+    uint32_t seed = 0;
+    uint32_t tick_count = 0;
+    std::vector<uint8_t> snapshot;          // SaveLoad stream
+    std::vector<ReplayCommand> commands;    // In issue order
+    std::vector<uint32_t> ids;
+
+    void Clear();
+
+    bool Save(const char* path) const;
+
+    /**
+     * @return false if the file is missing, damaged or from another version
+     */
+    bool Load(const char* path);
+};
+
+/**
+ * ReplayStats - What a headless playback measured
+ */
+struct ReplayStats {
+    uint32_t ticks = 0;
+    uint32_t commands = 0;              // Reissued
+    double seconds = 0.0;               // Wall time spent ticking
+    double ticks_per_second = 0.0;
+    uint64_t state_hash = 0;            // After the last tick
+};
+
+// =============================================================================
+// ReplayRecorder
+// =============================================================================
+
+class ReplayRecorder {
+public:
+    static ReplayRecorder& Instance();
+
+    /**
+     * Snapshot map, seed the random generator and start taking commands
+     *
+     * @return false if the snapshot could not be taken
+     */
+    bool Start(uint32_t seed, const MapClass& map);
+
+    /**
+     * Stop and hand over what was recorded
+     */
+    Replay Stop();
+
+    bool Is_Recording() const { return recording_; }
+
+    /**
+     * Take a command on the current selection (called by IssueCommand)
+     */
+    void Record(const Command& cmd);
+
+    /**
+     * Count a finished logic tick
+     */
+    void End_Tick() {
+        if (recording_) replay_.tick_count++;
+    }
+
+private:
+    ReplayRecorder() : recording_(false) {}
+
+    Replay replay_;
+    bool recording_;
+};
+
+// =============================================================================
+// ReplayPlayer
+// =============================================================================
+
+class ReplayPlayer {
+public:
+    /**
+     * Restore the replay's snapshot into map and reseed
+     *
+     * The replay must outlive the player.
+     *
+     * @return false if the snapshot does not load
+     */
+    bool Start(const Replay& replay, MapClass& map);
+
+    /**
+     * Reissue the commands recorded before the current tick
+     *
+     * @return Commands issued
+     */
+    int Begin_Tick();
+
+    /**
+     * Move on to the next tick
+     */
+    void End_Tick() { tick_++; }
+
+    bool Is_Finished() const { return replay_ == nullptr || tick_ >= replay_->tick_count; }
+    uint32_t Get_Tick() const { return tick_; }
+
+private:
+    const Replay* replay_ = nullptr;
+    uint32_t tick_ = 0;
+    size_t next_ = 0;               // First command not yet issued
+};
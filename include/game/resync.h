@@ -0,0 +1,217 @@
+/**
+ * Resync - Bringing a desynced or rejoining peer back to the live tick
+ *
+ * The simulation is deterministic given a starting state, the random
+ * generator's state and the commands run before each tick, so a peer
+ * that has desynced or reconnected doesn't have to be dropped. A peer
+ * in good standing sends it a ResyncPackage:
+ *
+ *   - the last checkpoint: a SaveLoad snapshot (LZO compressed), the
+ *     random generator's state and the tick it was taken before
+ *   - every command packet run since, in wire form (CommandPacket),
+ *     grouped by the tick they ran before
+ *   - the live tick and the state hash after it
+ *
+ * The receiver restores the checkpoint and runs the ticks back to back
+ * with nothing drawn (GameClass::Resync), reissuing each tick's packets,
+ * until it reaches the live tick; the state hash confirms it got there.
+ *
+ * ResyncLog keeps the checkpoint and the log. It takes a new checkpoint
+ * every RESYNC_CHECKPOINT_TICKS and drops the log with the old one, so
+ * catching up never replays more than that many ticks.
+ *
+ * Package layout (little-endian, as written by this build):
+ *   ResyncHeader
+ *   snapshot bytes      (a SaveLoad stream, snapshot_size bytes)
+ *   log bytes           (log_size bytes of ResyncTick + packet bytes)
+ *
+ * Usage:
+ *   // Every peer, when the match starts
+ *   ResyncLog::Instance().Start(Game->Get_Tick(), *Map);
+ *
+ *   // A peer in sync, when another asks
+ *   ResyncPackage package;
+ *   ResyncLog::Instance().Build(Game->Get_Tick(), Game->Get_State_Hash(), package);
+ *   package.Write(bytes);
+ *
+ *   // The peer catching up
+ *   if (package.Read(bytes.data(), bytes.size()) && Game->Resync(package, &stats)) { ... }
+ *
+ * Original location: CODE/QUEUE.CPP (the lockstep the log feeds)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MapClass;
+struct CommandPacket;
+
+/**
+ * ResyncHeader - Start of a resync package
+ */
+struct ResyncHeader {
+    uint32_t magic;             // RESYNC_MAGIC
+    uint32_t version;           // RESYNC_VERSION
+    uint32_t base_tick;         // Tick the snapshot was taken before
+    uint32_t live_tick;         // Tick to catch up to
+    uint32_t seed;              // Random generator state at base_tick
+    uint32_t snapshot_size;
+    uint32_t log_size;
+    uint32_t reserved;
+    uint64_t state_hash;        // StateHash after live_tick's last tick
+};
+
+/**
+ * ResyncTick - Tag in front of one tick's command packets
+ */
+struct ResyncTick {
+    uint32_t tick;              // Ran before this tick, counted from base_tick
+    uint32_t size;              // Packet bytes that follow
+};
+
+constexpr uint32_t RESYNC_MAGIC = 0x53594E43;   // "CNYS"
+constexpr uint32_t RESYNC_VERSION = 1;
+
+// Ticks between checkpoints (a minute at normal speed)
+constexpr uint32_t RESYNC_CHECKPOINT_TICKS = 900;
+
+// =============================================================================
+// ResyncPackage
+// =============================================================================
+
+/**
+ * ResyncPackage - What a peer needs to catch up
+ */
+struct ResyncPackage {
+    uint32_t base_tick = 0;
+    uint32_t live_tick = 0;
+    uint32_t seed = 0;
+    uint64_t state_hash = 0;
+    std::vector<uint8_t> snapshot;          // SaveLoad stream
+    std::vector<uint8_t> log;               // ResyncTick blocks, in tick order
+
+    void Clear();
+
+    /**
+     * Append the package's wire form to out
+     */
+    void Write(std::vector<uint8_t>& out) const;
+
+    /**
+     * @return false if data is not a whole package from this version
+     */
+    bool Read(const uint8_t* data, size_t size);
+};
+
+/**
+ * ResyncStats - What a catch-up did
+ */
+struct ResyncStats {
+    uint32_t ticks = 0;                 // Run headless
+    uint32_t packets = 0;               // Reissued
+    double seconds = 0.0;               // Wall time, including the restore
+    bool hash_matched = false;
+};
+
+// =============================================================================
+// ResyncLog
+// =============================================================================
+
+class ResyncLog {
+public:
+    static ResyncLog& Instance();
+
+    /**
+     * Take the first checkpoint, before tick, and start logging
+     *
+     * @return false if the snapshot could not be taken
+     */
+    bool Start(uint32_t tick, const MapClass& map);
+
+    void Stop();
+
+    bool Is_Active() const { return active_; }
+
+    /**
+     * Ticks between checkpoints (RESYNC_CHECKPOINT_TICKS by default)
+     */
+    void Set_Checkpoint_Interval(uint32_t ticks) { interval_ = ticks > 0 ? ticks : 1; }
+
+    /**
+     * Log a packet run before the current tick (called by CommandSystem
+     * for issued and received commands alike)
+     */
+    void Record(const CommandPacket& packet);
+
+    /**
+     * Count a finished tick; tick is the next one to run. Takes a new
+     * checkpoint when one is due.
+     */
+    void End_Tick(uint32_t tick, const MapClass& map);
+
+    /**
+     * Package the checkpoint and log for catching up to live_tick
+     *
+     * @return false if not logging
+     */
+    bool Build(uint32_t live_tick, uint64_t state_hash, ResyncPackage& out) const;
+
+    uint32_t Get_Checkpoint_Tick() const { return package_.base_tick; }
+    size_t Get_Log_Size() const { return package_.log.size(); }
+
+private:
+    ResyncLog() = default;
+
+    bool Checkpoint(uint32_t tick, const MapClass& map);
+
+    ResyncPackage package_;             // Checkpoint and log so far
+    uint32_t tick_ = 0;                 // Next tick to run
+    size_t open_block_ = SIZE_MAX;      // Offset of the current tick's ResyncTick
+    uint32_t interval_ = RESYNC_CHECKPOINT_TICKS;
+    bool active_ = false;
+};
+
+// =============================================================================
+// ResyncPlayer
+// =============================================================================
+
+class ResyncPlayer {
+public:
+    /**
+     * Restore the package's checkpoint into map and reseed
+     *
+     * The package must outlive the player.
+     *
+     * @return false if the snapshot does not load
+     */
+    bool Start(const ResyncPackage& package, MapClass& map);
+
+    /**
+     * Run the packets logged before the current tick
+     *
+     * @return Packets run
+     */
+    int Begin_Tick();
+
+    /**
+     * Move on to the next tick
+     */
+    void End_Tick() { tick_++; }
+
+    bool Is_Finished() const {
+        return package_ == nullptr || package_->base_tick + tick_ >= package_->live_tick;
+    }
+
+    /**
+     * Absolute tick about to run
+     */
+    uint32_t Get_Tick() const { return package_ ? package_->base_tick + tick_ : 0; }
+
+private:
+    const ResyncPackage* package_ = nullptr;
+    uint32_t tick_ = 0;                 // Counted from base_tick
+    size_t next_ = 0;                   // Offset of the next ResyncTick
+};
@@ -0,0 +1,149 @@
+/**
+ * SaveLoad - Game state snapshots
+ *
+ * The original saved every object field by field through a pipe chain.
+ * Here a save is a snapshot of the state the simulation keeps in flat
+ * arrays, written as a few large blocks so both directions run at about
+ * the speed of the disk:
+ *
+ *   - the map's per-cell planes, straight from CellLayers, plus each
+ *     house's explored and visible bitplanes
+ *   - one block per object heap: a fixed-size SaveObject record per
+ *     live object, in heap order
+ *   - the projectile pool's parallel arrays, copied whole
+ *
+ * Pointers never reach the file. A techno's target is stored as the
+ * target's RTTI and heap index, which is where the loader recreates it,
+ * and shape handles (valid for one process only) become indices into a
+ * table of shape names saved alongside.
+ *
+ * Everything after the SaveHeader goes through an LZOPipe. Loading
+ * decodes the whole snapshot before it touches the world, so a damaged
+ * or outdated file leaves the game as it was.
+ *
+ * Transient state is rebuilt rather than saved: movement paths are
+ * replanned from each unit's destination, sight is re-registered as
+ * technos are placed, and derived map data (land, zones, ore list) is
+ * recomputed from the restored cells.
+ *
+ * File layout (little-endian, as written by this build):
+ *   SaveHeader
+ *   LZO blocks of:
+ *     SaveBlock{SAVE_BLOCK_MAP}          bounds, 5 cell planes, vision planes
+ *     SaveBlock{SAVE_BLOCK_OBJECTS} x N  RTTI, then SaveObject[count]
+ *     SaveBlock{SAVE_BLOCK_PROJECTILES}  shape names, then the arrays
+ *     SaveBlock{SAVE_BLOCK_END}
+ *
+ * Usage:
+ *   SaveLoad::Save_Game("SAVEGAME.000", *Map);
+ *   ...
+ *   if (!SaveLoad::Load_Game("SAVEGAME.000", *Map)) { ... }
+ *
+ * Original location: CODE/SAVELOAD.CPP
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MapClass;
+class Pipe;
+class Straw;
+
+/**
+ * SaveHeader - Start of a save file, stored uncompressed
+ */
+struct SaveHeader {
+    uint32_t magic;             // SAVE_MAGIC
+    uint32_t version;           // SAVE_VERSION
+    uint32_t body_size;         // Uncompressed bytes that follow
+    uint32_t object_count;      // For load menus
+};
+
+/**
+ * SaveBlock - Tag in front of each block of the body
+ */
+struct SaveBlock {
+    uint32_t id;                // SaveBlockType
+    uint32_t size;              // Bytes that follow, excluding this tag
+};
+
+enum SaveBlockType : uint32_t {
+    SAVE_BLOCK_END = 0,
+    SAVE_BLOCK_MAP = 1,
+    SAVE_BLOCK_OBJECTS = 2,
+    SAVE_BLOCK_PROJECTILES = 3,
+};
+
+/**
+ * SaveObject - One live object, as stored
+ *
+ * Fields past strength only mean something for technos (and speed and
+ * destination for foot units); other kinds store their defaults.
+ */
+struct SaveObject {
+    COORDINATE coord;
+    COORDINATE destination;     // COORD_NONE if idle
+    int32_t strength;
+    int32_t speed;
+    int32_t arm;                // Ticks until the weapon is ready
+    int32_t target_index;       // Heap index of the target, -1 for none
+    int8_t target_rtti;
+    int8_t owner;               // HousesType
+    uint8_t flags;              // SAVE_OBJECT_*
+    uint8_t sight_range;
+    uint8_t body_current, body_desired, body_rate;
+    uint8_t turret_current, turret_desired, turret_rate;
+    int8_t armor;               // ArmorType
+    int8_t primary_weapon;      // WeaponType
+    int8_t secondary_weapon;
+    uint8_t scan_wait;          // Idle ticks until the next threat scan
+    uint8_t reserved[2];
+};
+
+constexpr uint8_t SAVE_OBJECT_ACTIVE = 0x01;
+constexpr uint8_t SAVE_OBJECT_SELECTED = 0x02;
+constexpr uint8_t SAVE_OBJECT_CLOAKED = 0x04;
+
+constexpr uint32_t SAVE_MAGIC = 0x56534152;     // "RASV"
+constexpr uint32_t SAVE_VERSION = 1;
+
+// =============================================================================
+// SaveLoad
+// =============================================================================
+
+class SaveLoad {
+public:
+    /**
+     * Write a snapshot of map, the object heaps and the projectile pool
+     *
+     * @return false if map has no cells
+     */
+    static bool Save(Pipe& pipe, const MapClass& map);
+
+    /**
+     * Replace the world with a snapshot
+     *
+     * The snapshot is read and checked in full first; on failure nothing
+     * has changed.
+     *
+     * @return false if the data is not a save from this version or is damaged
+     */
+    static bool Load(Straw& straw, MapClass& map);
+
+    /**
+     * Save / load through a file
+     */
+    static bool Save_Game(const char* path, const MapClass& map);
+    static bool Load_Game(const char* path, MapClass& map);
+
+private:
+    struct Snapshot;
+
+    static void Write_Body(std::vector<uint8_t>& out, const MapClass& map);
+    static bool Read_Body(const uint8_t* data, size_t size, Snapshot& snapshot);
+    static void Apply(const Snapshot& snapshot, MapClass& map);
+};
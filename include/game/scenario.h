@@ -0,0 +1,171 @@
+/**
+ * ScenarioLoader - Scenario map loading through a binary cache
+ *
+ * A scenario INI stores its terrain as [MapPack] and its overlays as
+ * [OverlayPack]: base64 text wrapping LCW-compressed blocks. Decoding
+ * them, and reading every unit and structure line, is string work that
+ * gives the same answer every time the same mission loads.
+ *
+ * So the first load parses the INI into a ScenarioMap - plain per-cell
+ * planes in the map's row-major layer order plus a list of object
+ * placements - and writes it to the cache directory, tagged with the
+ * CRC of the INI text. Later loads of an unchanged INI read the planes
+ * back with a few memcpys and skip all parsing. Any edit to the INI
+ * changes the CRC, and the stale cache is simply rewritten.
+ *
+ * Cache file layout (little-endian, as written by this build):
+ *   ScenarioCacheHeader
+ *   templates, icons, overlays, overlay_data   (MAP_CELL_TOTAL bytes each)
+ *   ScenarioPlacement[placement_count]
+ *
+ * Usage:
+ *   const ScenarioMap* scenario = ScenarioLoader::Instance().Read("SCG01EA.INI", text, size);
+ *   if (scenario) {
+ *       Map->Init(scenario->theater);
+ *       ScenarioLoader::Apply(*scenario, *Map);
+ *   }
+ *
+ * Original location: CODE/SCENARIO.CPP (Read_Scenario), CODE/IOMAP.CPP (Read_Binary)
+ */
+
+#ifndef GAME_SCENARIO_H
+#define GAME_SCENARIO_H
+
+#include "game/coord.h"
+#include "game/map.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * ScenarioPlacement - One unit, infantry, ship or structure from the INI
+ */
+struct ScenarioPlacement {
+    uint8_t rtti;               // RTTIType
+    int8_t house;               // HousesType
+    int16_t type;               // UnitType/BuildingType, -1 if no table entry
+    CELL cell;                  // XY_Cell
+    uint16_t strength;          // 0..256, 256 = full
+    uint8_t facing;             // DirType
+    uint8_t reserved;
+};
+
+/**
+ * ScenarioMap - Everything a scenario puts on the map, decoded
+ *
+ * Planes are row-major (MapClass::Layer_Index) and use the CellClass
+ * encodings: CELL_TEMPLATE_NONE, OverlayType cast to uint8_t.
+ */
+struct ScenarioMap {
+    TheaterType theater;
+    int16_t x, y, width, height;        // Map bounds
+    uint8_t templates[MAP_CELL_TOTAL];
+    uint8_t icons[MAP_CELL_TOTAL];
+    uint8_t overlays[MAP_CELL_TOTAL];
+    uint8_t overlay_data[MAP_CELL_TOTAL];
+    std::vector<ScenarioPlacement> placements;
+
+    /**
+     * Empty map: no templates or overlays, full bounds, no objects
+     */
+    void Clear();
+};
+
+/**
+ * ScenarioCacheHeader - Start of a cache file
+ */
+struct ScenarioCacheHeader {
+    uint32_t magic;             // SCENARIO_CACHE_MAGIC
+    uint32_t version;           // SCENARIO_CACHE_VERSION
+    uint32_t ini_crc;           // CRC32 of the INI text it was parsed from
+    uint32_t ini_size;
+    int8_t theater;
+    uint8_t reserved[3];
+    int16_t x, y, width, height;
+    uint32_t placement_count;
+};
+
+constexpr uint32_t SCENARIO_CACHE_MAGIC = 0x50414D53;   // "SMAP"
+constexpr uint32_t SCENARIO_CACHE_VERSION = 1;
+
+// =============================================================================
+// ScenarioLoader
+// =============================================================================
+
+class ScenarioLoader {
+public:
+    static ScenarioLoader& Instance();
+
+    ScenarioLoader();
+
+    ScenarioLoader(const ScenarioLoader&) = delete;
+    ScenarioLoader& operator=(const ScenarioLoader&) = delete;
+
+    /**
+     * Decode a scenario's map and objects
+     *
+     * Uses the cache when it matches the INI, otherwise parses and
+     * refreshes it.
+     *
+     * @param name Scenario file name; names the cache file
+     * @return The decoded scenario, valid until the next Read; nullptr
+     *         if the INI has no usable [MapPack]
+     */
+    const ScenarioMap* Read(const char* name, const char* text, size_t length);
+
+    /**
+     * Did the last successful Read come from the cache?
+     */
+    bool Was_Cached() const { return was_cached_; }
+
+    /**
+     * Cache directory (default: Platform_GetCachePath); "" disables caching
+     */
+    void Set_Cache_Dir(const std::string& dir) {
+        cache_dir_ = dir;
+        cache_dir_set_ = true;
+    }
+
+    /**
+     * Parse INI text into out
+     *
+     * @return false if there is no [MapPack] or it does not decode
+     */
+    static bool Parse(const char* text, size_t length, ScenarioMap& out);
+
+    /**
+     * Read / write a cache file; Read fails unless it was written for
+     * an INI with this CRC and size by a build with this format
+     */
+    static bool Read_Cache(const char* path, uint32_t ini_crc, uint32_t ini_size, ScenarioMap& out);
+    static bool Write_Cache(const char* path, uint32_t ini_crc, uint32_t ini_size, const ScenarioMap& scenario);
+
+    /**
+     * Put a decoded scenario on map: cells, bounds and objects
+     *
+     * Existing objects are destroyed and every cell is reset first. The
+     * theater is left to the caller (MapClass::Init), which also needs
+     * graphics.
+     */
+    static void Apply(const ScenarioMap& scenario, MapClass& map);
+
+    /**
+     * Apply() in pieces, for loading a few objects a frame: the cells and
+     * bounds first, then placements [first, first + count)
+     *
+     * @return Index of the next placement to apply
+     */
+    static void Apply_Map(const ScenarioMap& scenario, MapClass& map);
+    static size_t Apply_Objects(const ScenarioMap& scenario, MapClass& map, size_t first, size_t count);
+
+private:
+    std::string Cache_Path(const char* name) const;
+
+    ScenarioMap scenario_;              // Reused between loads (64 KB of planes)
+    std::string cache_dir_;
+    bool cache_dir_set_;                // Otherwise asked of the platform
+    bool was_cached_;
+};
+
+#endif // GAME_SCENARIO_H
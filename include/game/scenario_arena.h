@@ -0,0 +1,183 @@
+/**
+ * Scenario Arena - One region for everything that lives as long as a mission
+ *
+ * Data that belongs to one scenario and dies with it is bump-allocated
+ * from a MemoryArena inside a ScenarioScope. Ending the scope runs the
+ * destructors of what was created in it, newest first, then rewinds the
+ * arena in one step; nothing is freed piece by piece. The arena keeps its
+ * blocks, so restarting a mission reuses the same memory without going
+ * back to the system.
+ *
+ * Scopes nest: a scope opened inside another (a replay run, a mission
+ * restart test) only unwinds what was created since it opened.
+ *
+ * Usage:
+ *   {
+ *       ScenarioScope scope;
+ *       TeamData* teams = ScenarioArena::Instance().Create_Array<TeamData>(count);
+ *       ...
+ *   }   // Destructors run, arena rewinds
+ *
+ * Main thread only: scenarios load and end there.
+ */
+
+#ifndef GAME_SCENARIO_ARENA_H
+#define GAME_SCENARIO_ARENA_H
+
+#include "platform/memory_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// =============================================================================
+// ScenarioArena
+// =============================================================================
+
+class ScenarioArena {
+public:
+    static constexpr size_t INITIAL_SIZE = 1024 * 1024;
+
+    /**
+     * Called when the scope it was registered in ends
+     */
+    using CleanupFn = void (*)(void* context);
+
+    static ScenarioArena& Instance();
+
+    ScenarioArena();
+
+    ScenarioArena(const ScenarioArena&) = delete;
+    ScenarioArena& operator=(const ScenarioArena&) = delete;
+
+    /**
+     * Raw memory for the innermost open scope
+     *
+     * @return nullptr if no scope is open
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Construct a T that is destroyed when the innermost scope ends
+     *
+     * @return nullptr if no scope is open
+     */
+    template <typename T, typename... Args>
+    T* Create(Args&&... args) {
+        void* mem = Allocate(sizeof(T), alignof(T));
+        if (mem == nullptr) {
+            return nullptr;
+        }
+        T* obj = new (mem) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            At_Scope_End([](void* p) { static_cast<T*>(p)->~T(); }, obj);
+        }
+        return obj;
+    }
+
+    /**
+     * Construct count default Ts, destroyed when the innermost scope ends
+     *
+     * @return nullptr if no scope is open
+     */
+    template <typename T>
+    T* Create_Array(size_t count) {
+        if (count == 0) {
+            return nullptr;
+        }
+        // Count goes in front so the cleanup knows how many to destroy
+        constexpr size_t header = (sizeof(size_t) + alignof(T) - 1) / alignof(T) * alignof(T);
+        size_t align = alignof(T) > alignof(size_t) ? alignof(T) : alignof(size_t);
+        char* mem = static_cast<char*>(Allocate(header + sizeof(T) * count, align));
+        if (mem == nullptr) {
+            return nullptr;
+        }
+        T* arr = reinterpret_cast<T*>(mem + header);
+        for (size_t i = 0; i < count; i++) {
+            new (&arr[i]) T();
+        }
+        if (!std::is_trivially_destructible<T>::value) {
+            *reinterpret_cast<size_t*>(mem) = count;
+            At_Scope_End([](void* p) {
+                T* first = reinterpret_cast<T*>(static_cast<char*>(p) + header);
+                for (size_t i = *static_cast<size_t*>(p); i > 0; i--) {
+                    first[i - 1].~T();
+                }
+            }, mem);
+        }
+        return arr;
+    }
+
+    /**
+     * Run fn(context) when the innermost scope ends, newest first
+     *
+     * For scenario state kept outside the arena (caches keyed on the map)
+     * that must be dropped with the scenario. Ignored if no scope is open.
+     */
+    void At_Scope_End(CleanupFn fn, void* context);
+
+    /**
+     * Open scopes (0 = between scenarios)
+     */
+    int Get_Depth() const { return depth_; }
+
+    /**
+     * Outermost scopes ended so far; changes each time a scenario ends
+     */
+    uint32_t Get_Generation() const { return generation_; }
+
+    size_t Get_Used() const { return arena_.get_total_allocated(); }
+    size_t Get_Capacity() const { return arena_.get_total_capacity(); }
+    size_t Get_System_Allocations() const { return arena_.get_system_allocations(); }
+
+private:
+    friend class ScenarioScope;
+
+    struct Cleanup {
+        CleanupFn fn;
+        void* context;
+    };
+
+    /**
+     * Run cleanups registered after mark, newest first
+     */
+    void Unwind(size_t mark);
+
+    /**
+     * End the outermost scope: every cleanup, then a full reset
+     */
+    void Reset();
+
+    MemoryArena arena_;
+    std::vector<Cleanup> cleanups_;
+    int depth_;
+    uint32_t generation_;
+};
+
+// =============================================================================
+// ScenarioScope
+// =============================================================================
+
+/**
+ * ScenarioScope - Lifetime of one scenario's arena allocations
+ *
+ * Scopes must end in reverse order of opening, as with any RAII guard.
+ */
+class ScenarioScope {
+public:
+    ScenarioScope();
+    ~ScenarioScope();
+
+    ScenarioScope(const ScenarioScope&) = delete;
+    ScenarioScope& operator=(const ScenarioScope&) = delete;
+
+private:
+    ScenarioArena& arena_;
+    MemoryArena::Marker marker_;        // Rewinds a nested scope
+    size_t cleanup_mark_;
+    int depth_;                         // Depth including this scope
+};
+
+#endif // GAME_SCENARIO_ARENA_H
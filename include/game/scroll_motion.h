@@ -0,0 +1,99 @@
+/**
+ * Scroll Motion - Eased, sub-pixel scroll velocity
+ *
+ * Edge and keyboard scrolling used to move the view a whole number of
+ * pixels a frame, starting and stopping at full speed. ScrollMotion eases
+ * the velocity toward the requested speed and carries the fraction of a
+ * pixel left over each frame into the next, so speeds need not be whole
+ * pixels and the view neither jolts nor stutters.
+ *
+ * It also predicts where the view is heading: LeadCells() gives the cells
+ * that will scroll into view over the next few frames, so their terrain can
+ * be decoded before the edge reaches them.
+ */
+
+#ifndef GAME_SCROLL_MOTION_H
+#define GAME_SCROLL_MOTION_H
+
+// =============================================================================
+// Cell Range
+// =============================================================================
+
+/**
+ * ScrollCellRange - Cells [start_x, end_x) x [start_y, end_y)
+ */
+struct ScrollCellRange {
+    int start_x;
+    int start_y;
+    int end_x;
+    int end_y;
+
+    bool operator==(const ScrollCellRange& other) const {
+        return start_x == other.start_x && start_y == other.start_y &&
+               end_x == other.end_x && end_y == other.end_y;
+    }
+    bool operator!=(const ScrollCellRange& other) const { return !(*this == other); }
+};
+
+// =============================================================================
+// ScrollMotion
+// =============================================================================
+
+/**
+ * ScrollMotion - Scroll velocity eased toward a target, in pixels per frame
+ */
+class ScrollMotion {
+public:
+    // Fraction of the gap to the target speed closed each frame
+    static constexpr float EASE_IN = 0.25f;     // Speeding up
+    static constexpr float EASE_OUT = 0.35f;    // Slowing down or turning
+
+    // Frames of motion LeadCells() looks ahead by default
+    static constexpr int DEFAULT_LOOKAHEAD_FRAMES = 8;
+
+    ScrollMotion();
+
+    /**
+     * Stop at once and drop any sub-pixel remainder
+     */
+    void Reset();
+
+    /**
+     * Advance one frame with the velocity eased toward a target
+     *
+     * @param target_x Requested speed in pixels per frame (negative = left)
+     * @param target_y Requested speed in pixels per frame (negative = up)
+     * @param[out] dx Whole pixels to scroll this frame
+     * @param[out] dy Whole pixels to scroll this frame
+     */
+    void Step(float target_x, float target_y, int& dx, int& dy);
+
+    float GetVelocityX() const { return velocity_x_; }
+    float GetVelocityY() const { return velocity_y_; }
+    bool IsMoving() const { return velocity_x_ != 0.0f || velocity_y_ != 0.0f; }
+
+    /**
+     * Cells that come into view if the current velocity holds
+     *
+     * A view moving diagonally exposes a column strip and a row strip;
+     * moving along one axis exposes one. Ranges are not clamped to a map.
+     *
+     * @param view_x, view_y Top-left of the view in world pixels
+     * @param view_w, view_h View size in pixels
+     * @param frames Frames to look ahead
+     * @param[out] out Up to two ranges
+     * @return Number of ranges written
+     */
+    int LeadCells(int view_x, int view_y, int view_w, int view_h, int frames,
+                  ScrollCellRange out[2]) const;
+
+private:
+    static float Ease(float velocity, float target);
+
+    float velocity_x_;
+    float velocity_y_;
+    float remainder_x_;     // Sub-pixel motion not yet applied
+    float remainder_y_;
+};
+
+#endif // GAME_SCROLL_MOTION_H
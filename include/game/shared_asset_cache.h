@@ -0,0 +1,140 @@
+/**
+ * SharedAssetCache - Decoded assets shared by the instances on a host
+ *
+ * Several instances on one host (kiosks, bot matches, replay renders)
+ * each decode the same shapes, theater tiles and sounds out of the MIX
+ * files into private memory. With the shared cache on, an instance notes
+ * what it had to decode and Save() writes it as an AssetPack under
+ * Platform_GetCachePath(); instances started after that map the file
+ * through AssetPack::Instance() instead of decoding. Tile atlases and
+ * sound PCM are used straight from the mapping, and the mapping is
+ * read-only, so the OS keeps one copy of those pages for every instance.
+ *
+ * An instance that mapped a cache still notes what the cache lacked;
+ * Save() writes whatever the file holds by then plus the new assets.
+ * The file is written under a temporary name and renamed over the old
+ * one, so instances with the old file mapped keep reading it undisturbed.
+ *
+ * The file name carries a key made from the MIX file sizes and the pack
+ * version, so changed game data starts a new cache instead of serving
+ * stale frames. A pack built by the PackAssets tool takes precedence;
+ * with one open the shared cache stays off.
+ *
+ * Usage:
+ *   SharedAssetCache& shared = SharedAssetCache::Instance();
+ *   shared.Set_Enabled(true);
+ *   shared.Open(data_path);        // Maps the cache if there is one
+ *   ...
+ *   shared.Save_Async();           // Once the scenario is under way
+ *   shared.Save();                 // At shutdown
+ */
+
+#ifndef GAME_SHARED_ASSET_CACHE_H
+#define GAME_SHARED_ASSET_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+enum TheaterType : int8_t;
+
+// =============================================================================
+// SharedAssetCache
+// =============================================================================
+
+class SharedAssetCache {
+public:
+    static SharedAssetCache& Instance();
+
+    SharedAssetCache() = default;
+
+    SharedAssetCache(const SharedAssetCache&) = delete;
+    SharedAssetCache& operator=(const SharedAssetCache&) = delete;
+
+    /**
+     * Off by default; Open() does nothing until enabled
+     */
+    void Set_Enabled(bool enabled) { enabled_ = enabled; }
+    bool Is_Enabled() const { return enabled_; }
+
+    /**
+     * Use the cache file for the game data in data_path
+     *
+     * @return true if a cache was mapped into AssetPack::Instance()
+     */
+    bool Open(const char* data_path);
+
+    /**
+     * Use a given cache file (tests, tools)
+     */
+    bool Open_File(const char* path);
+
+    /**
+     * Stop noting assets; unmaps the cache if Open mapped it
+     *
+     * Like AssetPack::Close(), only once nothing points into the pack.
+     */
+    void Close();
+
+    /**
+     * Noting decoded assets for the next Save()
+     */
+    bool Is_Active() const { return active_.load(std::memory_order_relaxed); }
+    bool Is_Mapped() const { return mapped_; }
+    const std::string& Get_Path() const { return path_; }
+
+    /**
+     * Report an asset decoded from the MIX files (no-op unless active)
+     *
+     * Thread-safe; loads report from the AssetLoader workers.
+     */
+    static void Note_Shape(const char* filename);
+    static void Note_Audio(const char* filename);
+    static void Note_Theater(TheaterType theater);
+
+    /**
+     * Assets noted and not yet written
+     */
+    size_t Pending() const;
+
+    /**
+     * Write the cache file: its current contents plus every noted asset,
+     * decoded afresh from the MIX files
+     *
+     * Noted assets that no longer decode are dropped. Safe to call from
+     * a worker; a second Save waits for the first.
+     *
+     * @return false if there was nothing new or the write failed
+     */
+    bool Save();
+
+    /**
+     * Save() on an AssetLoader worker, at prefetch priority
+     */
+    void Save_Async();
+
+    /**
+     * Key of the game data in data_path (the MIX files' sizes)
+     */
+    static uint32_t Data_Key(const char* data_path);
+
+private:
+    bool Write_Pack(const std::set<std::string>& shapes, const std::set<std::string>& audio,
+                    uint32_t theaters);
+
+    bool enabled_ = false;
+    bool mapped_ = false;                   // Open() mapped the file into AssetPack::Instance()
+    std::atomic<bool> active_{false};
+    std::string path_;
+
+    mutable std::mutex mutex_;              // Guards the noted sets
+    std::set<std::string> shapes_;
+    std::set<std::string> audio_;
+    uint32_t theaters_ = 0;                 // Bit per TheaterType
+    std::mutex save_mutex_;                 // One Save() at a time
+};
+
+#endif // GAME_SHARED_ASSET_CACHE_H
@@ -0,0 +1,154 @@
+/**
+ * Simulation Pipeline - Run logic ticks alongside rendering
+ *
+ * In pipelined mode the main thread draws frame N from an immutable
+ * snapshot of the objects while a simulation thread runs the ticks for
+ * frame N+1. Snapshots are double-buffered: the sim thread fills the
+ * back buffer after its ticks and the main thread swaps it to the front
+ * once the sim thread is idle again.
+ */
+
+#ifndef GAME_SIM_PIPELINE_H
+#define GAME_SIM_PIPELINE_H
+
+#include "game/coord.h"
+#include "game/core/rtti.h"
+#include "game/facing.h"
+#include "game/house.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+// Render Snapshot
+// =============================================================================
+
+/**
+ * ObjectSnapshot - What the renderer needs to draw one object
+ */
+struct ObjectSnapshot {
+    COORDINATE coord;           // Position at the end of the tick
+    COORDINATE prev_coord;      // Position at the start of the tick
+    RTTIType rtti;              // Object kind
+    HousesType owner;           // Owning house
+    DirType facing;             // Body facing (DIR_N for non-technos)
+    DirType turret_facing;      // Turret facing (same as body if none)
+    uint8_t remap;              // House color index (HouseColorIndex)
+    uint8_t health;             // Health percent (0-100)
+    bool selected;              // Draw selection box
+};
+
+/**
+ * RenderSnapshot - Immutable copy of the visible objects after a tick
+ *
+ * Captured on the thread that owns the simulation; read by the renderer
+ * without touching live objects.
+ */
+class RenderSnapshot {
+public:
+    RenderSnapshot();
+
+    /**
+     * Copy every active, unshrouded object
+     *
+     * @param tick Logic tick the snapshot was taken after
+     */
+    void Capture(uint32_t tick);
+
+    /**
+     * Forget all objects
+     */
+    void Clear();
+
+    const std::vector<ObjectSnapshot>& Objects() const { return objects_; }
+    uint32_t Get_Tick() const { return tick_; }
+
+private:
+    std::vector<ObjectSnapshot> objects_;   // Reused between captures
+    uint32_t tick_;
+};
+
+// =============================================================================
+// Simulation Pipeline
+// =============================================================================
+
+/**
+ * SimPipeline - Simulation thread with double-buffered snapshot handoff
+ *
+ * Each frame the main thread calls Kick() once its input is applied,
+ * renders from Front(), then calls Wait() before touching game state
+ * again. Between Kick() and Wait() the sim thread owns all game objects
+ * and the map; the main thread may only read Front().
+ */
+class SimPipeline {
+public:
+    /**
+     * Run one logic tick and return the new tick number
+     */
+    using TickFn = std::function<uint32_t()>;
+
+    SimPipeline();
+    ~SimPipeline();
+
+    SimPipeline(const SimPipeline&) = delete;
+    SimPipeline& operator=(const SimPipeline&) = delete;
+
+    /**
+     * Start the sim thread (no-op if already running)
+     */
+    void Start(TickFn tick_fn);
+
+    /**
+     * Finish any pending ticks and join the sim thread
+     */
+    void Stop();
+
+    bool Is_Running() const { return thread_.joinable(); }
+
+    /**
+     * Hand ticks to the sim thread; it snapshots after the last one
+     *
+     * Does nothing if ticks is zero. Call Wait() before the next Kick().
+     */
+    void Kick(int ticks);
+
+    /**
+     * Block until the kicked ticks finish, then publish their snapshot
+     *
+     * @return true if a new snapshot was published
+     */
+    bool Wait();
+
+    /**
+     * Snapshot the current state directly (main thread, sim thread idle)
+     *
+     * Used after loads and while paused so Front() is never stale.
+     */
+    void Capture_Now(uint32_t tick);
+
+    /**
+     * Snapshot the renderer should draw
+     */
+    const RenderSnapshot& Front() const { return snapshots_[front_]; }
+
+private:
+    void Thread_Main();
+
+    TickFn tick_fn_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;      // Work queued or stop requested
+    std::condition_variable done_;      // Queued work finished
+    int pending_ticks_;                 // Guarded by mutex_
+    bool busy_;                         // Guarded by mutex_
+    bool stop_;                         // Guarded by mutex_
+
+    RenderSnapshot snapshots_[2];
+    int front_;                         // Only changed by the main thread
+    bool back_ready_;                   // Back buffer holds an unpublished capture
+};
+
+#endif // GAME_SIM_PIPELINE_H
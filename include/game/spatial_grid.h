@@ -0,0 +1,247 @@
+/**
+ * SpatialGrid - Uniform Grid Index over World Positions
+ *
+ * Buckets objects by world pixel position so rectangle and radius
+ * queries only visit the buckets they overlap. Insert, move and remove
+ * are O(1); a query costs the covered buckets plus the objects in them.
+ *
+ * Used for:
+ * - Box selection and click picking (SelectionManager)
+ * - Radar blips (ObjectClass positions)
+ *
+ * The grid covers the standard map unless made with another map's
+ * pixel size; positions past the edges fall into the edge buckets.
+ *
+ * Usage:
+ *   SpatialGrid<Unit> grid;
+ *   grid.Insert(&unit, px, py);
+ *   grid.Move(&unit, new_px, new_py);
+ *   grid.QueryRect(x1, y1, x2, y2, results);
+ */
+
+#ifndef GAME_SPATIAL_GRID_H
+#define GAME_SPATIAL_GRID_H
+
+#include "game/coord.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Bucket edge in pixels (4x4 cells): 32x32 buckets over a 128x128 map, 64x64 over 256x256
+constexpr int SPATIAL_BUCKET_SHIFT = 7;
+constexpr int SPATIAL_BUCKET_SIZE = 1 << SPATIAL_BUCKET_SHIFT;
+constexpr int SPATIAL_GRID_WIDTH = (MAP_PIXEL_WIDTH + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE;
+constexpr int SPATIAL_GRID_HEIGHT = (MAP_PIXEL_HEIGHT + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE;
+
+template <typename T>
+class SpatialGrid {
+public:
+    struct Entry {
+        T* object;
+        int x;      // World pixel X
+        int y;      // World pixel Y
+    };
+
+    explicit SpatialGrid(int pixel_width = MAP_PIXEL_WIDTH, int pixel_height = MAP_PIXEL_HEIGHT)
+        : grid_width_(std::max(1, (pixel_width + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE))
+        , grid_height_(std::max(1, (pixel_height + SPATIAL_BUCKET_SIZE - 1) / SPATIAL_BUCKET_SIZE))
+        , buckets_(static_cast<size_t>(grid_width_) * grid_height_) {}
+
+    /**
+     * Buckets across and down
+     */
+    int Grid_Width() const { return grid_width_; }
+    int Grid_Height() const { return grid_height_; }
+
+    // =========================================================================
+    // Maintenance
+    // =========================================================================
+
+    /**
+     * Add object at world pixel position (moves it if already present)
+     */
+    void Insert(T* object, int x, int y) {
+        if (!object) return;
+        Move(object, x, y);
+    }
+
+    /**
+     * Update object position; cheap when it stays in the same bucket
+     */
+    void Move(T* object, int x, int y) {
+        auto it = slots_.find(object);
+        int bucket = BucketIndex(x, y);
+        if (it == slots_.end() || it->second.bucket == SLOT_REMOVED) {
+            Attach(object, x, y, bucket);
+            count_++;
+            return;
+        }
+
+        Slot& slot = it->second;
+        if (slot.bucket == bucket) {
+            Entry& e = buckets_[bucket][slot.index];
+            e.x = x;
+            e.y = y;
+            return;
+        }
+
+        Detach(slot);
+        Attach(object, x, y, bucket);
+    }
+
+    /**
+     * Remove object (no-op if not present)
+     *
+     * The object's slot record stays behind, marked removed, so putting
+     * it back (objects leave and rejoin on every coordinate change) does
+     * not allocate a map node each time. Records are bounded by the
+     * number of distinct object addresses, which the heaps recycle.
+     */
+    void Remove(const T* object) {
+        auto it = slots_.find(object);
+        if (it == slots_.end() || it->second.bucket == SLOT_REMOVED) return;
+        Detach(it->second);
+        it->second.bucket = SLOT_REMOVED;
+        count_--;
+    }
+
+    /**
+     * Remove everything
+     */
+    void Clear() {
+        for (auto& bucket : buckets_) {
+            bucket.clear();
+        }
+        slots_.clear();
+        count_ = 0;
+    }
+
+    bool Contains(const T* object) const {
+        auto it = slots_.find(object);
+        return it != slots_.end() && it->second.bucket != SLOT_REMOVED;
+    }
+
+    /**
+     * Object's entry (with its stored position), or nullptr if not present
+     */
+    const Entry* Find(const T* object) const {
+        auto it = slots_.find(object);
+        if (it == slots_.end() || it->second.bucket == SLOT_REMOVED) return nullptr;
+        return &buckets_[it->second.bucket][it->second.index];
+    }
+    int Size() const { return count_; }
+
+    // =========================================================================
+    // Queries
+    // =========================================================================
+
+    /**
+     * Visit objects inside an inclusive pixel rectangle: fn(T*, x, y)
+     */
+    template <typename Fn>
+    void ForEachInRect(int x1, int y1, int x2, int y2, Fn fn) const {
+        if (x1 > x2 || y1 > y2) return;
+
+        int bx1 = BucketCoord(x1, grid_width_);
+        int by1 = BucketCoord(y1, grid_height_);
+        int bx2 = BucketCoord(x2, grid_width_);
+        int by2 = BucketCoord(y2, grid_height_);
+
+        for (int by = by1; by <= by2; by++) {
+            for (int bx = bx1; bx <= bx2; bx++) {
+                for (const Entry& e : buckets_[by * grid_width_ + bx]) {
+                    if (e.x >= x1 && e.x <= x2 && e.y >= y1 && e.y <= y2) {
+                        fn(e.object, e.x, e.y);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Visit objects within radius pixels of a point: fn(T*, x, y)
+     */
+    template <typename Fn>
+    void ForEachInRadius(int cx, int cy, int radius, Fn fn) const {
+        int64_t radius_sq = static_cast<int64_t>(radius) * radius;
+        ForEachInRect(cx - radius, cy - radius, cx + radius, cy + radius,
+            [&](T* object, int x, int y) {
+                int64_t dx = x - cx;
+                int64_t dy = y - cy;
+                if (dx * dx + dy * dy <= radius_sq) {
+                    fn(object, x, y);
+                }
+            });
+    }
+
+    /**
+     * Visit every object: fn(T*, x, y)
+     */
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (const auto& bucket : buckets_) {
+            for (const Entry& e : bucket) {
+                fn(e.object, e.x, e.y);
+            }
+        }
+    }
+
+    /**
+     * Collect objects inside an inclusive pixel rectangle
+     */
+    void QueryRect(int x1, int y1, int x2, int y2, std::vector<T*>& out) const {
+        ForEachInRect(x1, y1, x2, y2, [&out](T* object, int, int) { out.push_back(object); });
+    }
+
+    /**
+     * Collect objects within radius pixels of a point
+     */
+    void QueryRadius(int cx, int cy, int radius, std::vector<T*>& out) const {
+        ForEachInRadius(cx, cy, radius, [&out](T* object, int, int) { out.push_back(object); });
+    }
+
+private:
+    struct Slot {
+        int bucket;         // SLOT_REMOVED once removed
+        int index;
+    };
+
+    static constexpr int SLOT_REMOVED = -1;
+
+    static int BucketCoord(int pixel, int limit) {
+        int b = pixel >> SPATIAL_BUCKET_SHIFT;
+        if (b < 0) return 0;
+        if (b >= limit) return limit - 1;
+        return b;
+    }
+
+    int BucketIndex(int x, int y) const {
+        return BucketCoord(y, grid_height_) * grid_width_ + BucketCoord(x, grid_width_);
+    }
+
+    void Attach(T* object, int x, int y, int bucket) {
+        std::vector<Entry>& list = buckets_[bucket];
+        slots_[object] = Slot{ bucket, static_cast<int>(list.size()) };
+        list.push_back(Entry{ object, x, y });
+    }
+
+    // Swap-remove from the bucket, fixing the slot of the entry moved down
+    void Detach(const Slot& slot) {
+        std::vector<Entry>& list = buckets_[slot.bucket];
+        int last = static_cast<int>(list.size()) - 1;
+        if (slot.index != last) {
+            list[slot.index] = list[last];
+            slots_[list[slot.index].object].index = slot.index;
+        }
+        list.pop_back();
+    }
+
+    int grid_width_;
+    int grid_height_;
+    std::vector<std::vector<Entry>> buckets_;
+    std::unordered_map<const T*, Slot> slots_;
+    int count_ = 0;
+};
+
+#endif // GAME_SPATIAL_GRID_H
@@ -0,0 +1,112 @@
+/**
+ * SplashDamage - Area damage from every explosion of a tick, dealt once
+ *
+ * An artillery barrage lands dozens of overlapping explosions in a tick.
+ * Dealing each one as it lands means a radius query, a Take_Damage and a
+ * damage sound per object per explosion, and the outcome depends on the
+ * order they landed. Instead explosions are queued (Add_Impact) and
+ * Resolve() deals them together:
+ *
+ *   1. Gather - one Objects_In_Radius query per impact; each object hit
+ *               adds the impact's damage, less with distance, to its
+ *               entry in a flat table indexed by heap slot
+ *   2. Apply  - one Take_Damage and one AudioEvent_Damage per object,
+ *               in handle order, with the total
+ *
+ * An object takes the source and warhead of the impact that hurt it most.
+ * Damage falls off linearly from full at the point of impact to half at
+ * the edge of the blast radius.
+ *
+ * Original location: CODE/COMBAT.CPP (Explosion_Damage, Modify_Damage)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/core/rtti.h"
+#include "game/object_heap.h"
+#include <cstdint>
+#include <vector>
+
+class ObjectClass;
+
+// =============================================================================
+// SplashDamage
+// =============================================================================
+
+class SplashDamage {
+public:
+    struct Stats {
+        uint32_t impacts;           // Impacts resolved
+        uint32_t hits;              // Object-impact pairs
+        uint32_t damaged;           // Objects dealt damage (one per object per tick)
+    };
+
+    static SplashDamage& Instance();
+
+    SplashDamage() = default;
+
+    SplashDamage(const SplashDamage&) = delete;
+    SplashDamage& operator=(const SplashDamage&) = delete;
+
+    /**
+     * Queue an explosion for this tick's Resolve
+     *
+     * @param damage Damage at the point of impact
+     * @param range Blast radius in leptons
+     * @param warhead Passed on to Take_Damage
+     * @param source Who fired it; may be destroyed before Resolve
+     */
+    void Add_Impact(COORDINATE at, int damage, int range, int warhead = 0,
+                    ObjectClass* source = nullptr);
+
+    /**
+     * Deal every queued impact and empty the queue
+     *
+     * @return Objects damaged
+     */
+    int Resolve();
+
+    /**
+     * Drop queued impacts without dealing them
+     */
+    void Clear() { impacts_.clear(); }
+
+    int Pending() const { return static_cast<int>(impacts_.size()); }
+
+    /**
+     * Damage an impact deals distance leptons away from where it landed
+     */
+    static int Falloff(int damage, int distance, int range);
+
+    const Stats& Get_Stats() const { return stats_; }
+    void Reset_Stats() { stats_ = Stats(); }
+
+private:
+    struct Impact {
+        COORDINATE at;
+        int32_t damage;
+        int32_t range;
+        int32_t warhead;
+        ObjectHandle source;
+    };
+
+    struct Hit {
+        ObjectHandle handle;
+        ObjectClass* obj;
+        int32_t total;
+        int32_t heaviest;           // Largest single impact's share
+        int32_t impact;             // That impact
+        int32_t last_impact;        // Skips an object listed twice by one query
+    };
+
+    void Gather();
+    int Apply();
+
+    std::vector<Impact> impacts_;
+    std::vector<Hit> hits_;
+    std::vector<int32_t> index_[RTTI_COUNT];    // Hit per heap slot, -1 if none
+    std::vector<ObjectClass*> nearby_;          // Reused query result
+
+    Stats stats_ = {};
+};
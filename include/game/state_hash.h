@@ -0,0 +1,97 @@
+/**
+ * StateHash - Running hash of the synchronized game state
+ *
+ * Lockstep peers compare a hash of their game state to catch a desync.
+ * The original computed it by walking every object each time it was
+ * checked. Here the hash is kept up to date as the state changes, so
+ * reading it costs nothing and it can be compared every tick.
+ *
+ * The hash is the XOR of one 64-bit term per piece of state: one per
+ * live object (its heap slot, coordinate, strength and owner) and one
+ * per map cell (its template, icon, overlay and overlay data). Whatever
+ * changes a piece XORs its old term out and its new term in. XOR does
+ * not care about order, so peers that make the same changes in a
+ * different order still agree, and the value always equals what a full
+ * recompute would give.
+ *
+ * Object terms are collected here; cell terms are kept by the MapClass
+ * that owns the cells (Get_Cell_Hash). Value() combines them with the
+ * global Map's.
+ *
+ * Mutations happen on the simulation thread only, so the running value
+ * is a plain integer.
+ *
+ * Original location: CODE/EVENT.CPP, CODE/QUEUE.CPP (frame CRCs)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include <cstdint>
+
+class MapClass;
+
+// =============================================================================
+// StateHash
+// =============================================================================
+
+class StateHash {
+public:
+    static StateHash& Instance();
+
+    /**
+     * Hash of every live object and the global Map's cells
+     */
+    uint64_t Value() const;
+
+    /**
+     * Hash the slow way, from scratch; equals Value() unless a mutation
+     * skipped its update
+     */
+    static uint64_t Recompute();
+
+    /**
+     * XOR a term in or out
+     */
+    void Toggle_Object(uint64_t term) { objects_ ^= term; }
+
+    /**
+     * Terms for one object and one cell
+     */
+    static uint64_t Object_Term(int rtti, int slot, COORDINATE coord, int strength, int owner);
+    static uint64_t Cell_Term(int index, uint8_t template_type, uint8_t icon,
+                              uint8_t overlay, uint8_t overlay_data);
+
+private:
+    StateHash() : objects_(0) {}
+
+    uint64_t objects_;
+};
+
+/**
+ * Splitmix64 finalizer: every input bit affects every output bit
+ */
+inline uint64_t State_Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t StateHash::Object_Term(int rtti, int slot, COORDINATE coord, int strength, int owner) {
+    uint64_t id = (static_cast<uint64_t>(static_cast<uint8_t>(rtti)) << 56) |
+                  (static_cast<uint64_t>(static_cast<uint16_t>(slot)) << 40) | 1;
+    uint64_t fields = (static_cast<uint64_t>(coord) << 32) |
+                      (static_cast<uint64_t>(static_cast<uint8_t>(owner)) << 24) |
+                      (static_cast<uint32_t>(strength) & 0xFFFFFF);
+    return State_Mix(State_Mix(id) ^ fields);
+}
+
+inline uint64_t StateHash::Cell_Term(int index, uint8_t template_type, uint8_t icon,
+                                     uint8_t overlay, uint8_t overlay_data) {
+    return State_Mix((static_cast<uint64_t>(index) << 32) |
+                     (static_cast<uint32_t>(template_type) << 24) | (icon << 16) |
+                     (overlay << 8) | overlay_data);
+}
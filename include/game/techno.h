@@ -16,9 +16,20 @@
 #include "game/house.h"
 #include "game/facing.h"
 #include "game/weapon.h"
+#include <memory>
 
 // Forward declarations
 class HouseClass;
+class FlowField;
+
+// Stand-in weapon figures for every armed techno until the weapon tables
+// are ported
+constexpr int TECHNO_WEAPON_RANGE = 5 * LEPTON_PER_CELL;   // Leptons
+constexpr int TECHNO_WEAPON_DAMAGE = 25;
+constexpr int TECHNO_REARM_TICKS = 20;
+
+// Sight range in cells until the type tables drive it
+constexpr int TECHNO_SIGHT_RANGE = 3;
 
 // =============================================================================
 // TechnoClass
@@ -83,6 +94,26 @@ public:
      */
     virtual WeaponType Get_Secondary_Weapon() const { return secondary_weapon_; }
 
+    /**
+     * Arm with weapons (WEAPON_NONE to disarm)
+     */
+    void Set_Weapons(WeaponType primary, WeaponType secondary = WEAPON_NONE);
+
+    /**
+     * Weapon reach in leptons (0 if unarmed)
+     */
+    virtual int Weapon_Range() const;
+
+    /**
+     * Damage dealt per shot (0 if unarmed)
+     */
+    virtual int Weapon_Damage() const;
+
+    /**
+     * Ticks between shots
+     */
+    virtual int Rearm_Delay() const { return TECHNO_REARM_TICKS; }
+
     /**
      * Can attack target?
      */
@@ -98,6 +129,30 @@ public:
      */
     void Set_Target(ObjectClass* target) { target_ = target; }
 
+    // -------------------------------------------------------------------------
+    // Sight
+    // -------------------------------------------------------------------------
+
+    /**
+     * Get sight range in cells (0 = blind)
+     */
+    int Get_Sight_Range() const { return sight_range_; }
+
+    /**
+     * Set sight range; takes effect at once if the techno is on the map
+     */
+    void Set_Sight_Range(int range);
+
+    // -------------------------------------------------------------------------
+    // Occupancy
+    // -------------------------------------------------------------------------
+
+    /**
+     * Also register / drop the owner's sight from the cell
+     */
+    virtual void Mark_Cell() override;
+    virtual void Unmark_Cell() override;
+
     // -------------------------------------------------------------------------
     // Cloaking (Allies stealth tech)
     // -------------------------------------------------------------------------
@@ -119,6 +174,17 @@ public:
     virtual void AI() override;
 
 protected:
+    /**
+     * Is the body facing driven by something other than AI()?
+     */
+    virtual bool Is_Steered() const { return false; }
+
+    void Mark_Sight();
+    void Unmark_Sight();
+
+    friend class CombatSystem;
+    friend class SaveLoad;
+
     // Facing
     FacingClass body_facing_;     // Body direction
     FacingClass turret_facing_;   // Turret direction (if has turret)
@@ -128,6 +194,13 @@ protected:
     WeaponType primary_weapon_;   // Primary weapon
     WeaponType secondary_weapon_; // Secondary weapon
     ObjectClass* target_;         // Current target
+    int arm_;                     // Ticks until the weapon can fire again
+    uint8_t scan_wait_;           // Idle ticks until the next threat scan
+
+    // Sight
+    int sight_range_;             // Cells
+    CELL sight_cell_;             // Where sight is registered (CELL_NONE = not)
+    HousesType sight_house_;      // House it is registered for
 
     // Stealth
     bool is_cloaked_;             // Cloaking active
@@ -148,18 +221,32 @@ public:
     FootClass();
     virtual ~FootClass();
 
-    // Speed and movement
+    // Speed and movement (leptons per tick)
     virtual int Get_Speed() const { return speed_; }
-    void Set_Speed(int speed) { speed_ = speed; }
+    void Set_Speed(int speed);
 
-    // Destination
+    // Destination; setting one drives there through the MovementSystem
     COORDINATE Get_Destination() const { return destination_; }
-    void Set_Destination(COORDINATE dest) { destination_ = dest; }
+    void Set_Destination(COORDINATE dest);
+
+    // Drive to dest by following a field shared with the rest of a group
+    void Follow_Flow_Field(std::shared_ptr<const FlowField> field, COORDINATE dest);
 
     // Is moving?
     bool Is_Moving() const { return destination_ != COORD_NONE && destination_ != coord_; }
 
+    // Placing the unit elsewhere abandons its path
+    virtual void Set_Coord(COORDINATE coord) override;
+
 protected:
+    // While moving, the MovementSystem turns the body
+    virtual bool Is_Steered() const override { return move_index_ >= 0; }
+
+    friend class CombatSystem;
+    friend class MovementSystem;
+
     int speed_;                   // Movement speed
     COORDINATE destination_;      // Movement target
+    int move_index_;              // Slot in the MovementSystem (-1 if idle)
+    std::shared_ptr<const FlowField> flow_field_;  // Group route, if any
 };
@@ -0,0 +1,188 @@
+/**
+ * TiberiumGrowth - Ore growth and spread over the cells that hold ore
+ *
+ * The map reports every cell whose overlay becomes or stops being ore,
+ * so the growth set only ever holds ore cells. Each tick visits a fixed
+ * budget of them, round-robin: a cell below full grows one stage, a full
+ * cell seeds one clear neighbour. Cost follows the amount of ore on the
+ * map, never the map size. Gems neither grow nor spread.
+ *
+ * Changes go through CellClass::Set_Overlay, which flags the cell for
+ * the terrain cache and the radar like any other overlay edit.
+ *
+ * OreFields keeps, for the same overlay changes, where all ore and gems
+ * lie and what they are worth, so harvesters can find the nearest ore or
+ * the richest field without scanning the map.
+ *
+ * Original location: CODE/MAP.CPP (MapClass::Logic, TiberiumGrowth/TiberiumSpread),
+ *                    CODE/UNIT.CPP (Tiberium_Check, Goto_Tiberium)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MapClass;
+
+// Ore cells visited per tick by default
+constexpr int TIBERIUM_GROWTH_BUDGET = 8;
+
+// =============================================================================
+// TiberiumGrowth
+// =============================================================================
+
+class TiberiumGrowth {
+public:
+    struct Stats {
+        uint32_t visited;           // Cells processed
+        uint32_t grown;             // Stages added
+        uint32_t spread;            // New cells seeded
+    };
+
+    TiberiumGrowth();
+
+    /**
+     * Forget every cell
+     */
+    void Clear();
+
+    /**
+     * Track an overlay change (layer bytes, as in CellLayers::overlay)
+     */
+    void Overlay_Changed(CELL cell, uint8_t old_overlay, uint8_t new_overlay);
+
+    /**
+     * Grow or spread the next budget cells of map
+     */
+    void Update(MapClass& map);
+
+    /**
+     * Cells visited per Update
+     */
+    void Set_Budget(int cells) { budget_ = cells; }
+    int Get_Budget() const { return budget_; }
+
+    int Count() const { return static_cast<int>(cells_.size()); }
+    bool Contains(CELL cell) const;
+
+    const Stats& Get_Stats() const { return stats_; }
+    void Reset_Stats() { stats_ = Stats(); }
+
+private:
+    static bool Is_Growing(uint8_t overlay);
+    static bool Is_Map_Cell(CELL cell) {
+        return cell >= 0 && Cell_X(cell) < MAP_CELL_WIDTH && Cell_Y(cell) < MAP_CELL_HEIGHT;
+    }
+    static int Index(CELL cell) { return Cell_Y(cell) * MAP_CELL_WIDTH + Cell_X(cell); }
+
+    void Add(CELL cell);
+    void Remove(CELL cell);
+    void Grow(MapClass& map, CELL cell);
+    void Spread(MapClass& map, CELL cell);
+
+    std::vector<CELL> cells_;           // Ore cells, visit order
+    std::vector<int16_t> slot_;         // Index in cells_ per cell (row-major), -1 if absent
+    size_t cursor_;                     // Next cells_ index to visit
+    uint32_t spread_turn_;              // Rotates the first neighbour tried
+    int budget_;
+    Stats stats_;
+};
+
+// =============================================================================
+// OreFields
+// =============================================================================
+
+/**
+ * OreFields - Ore and gem cells summarised by 8x8 cell block
+ *
+ * Each block keeps a 64-bit mask of its resource cells, their count, the
+ * sums of their coordinates (for a centroid) and their total value as
+ * CellClass::Get_Tiberium_Value counts it. The map reports overlay changes
+ * as for TiberiumGrowth, so harvesting (CellClass::Reduce_Tiberium emptying
+ * a cell) and growth keep the blocks current one cell at a time.
+ *
+ * Nearest_Ore looks at rings of blocks around the start, skips empty
+ * blocks on their mask alone, and stops once a ring cannot hold anything
+ * closer than the best cell so far. Each non-empty block is also a field
+ * with a centroid and remaining value for Richest_Field.
+ */
+class OreFields {
+public:
+    static constexpr int BLOCK_SHIFT = 3;
+    static constexpr int BLOCK_SIZE = 1 << BLOCK_SHIFT;
+    static constexpr int BLOCKS_PER_ROW = MAP_CELL_WIDTH / BLOCK_SIZE;
+    static constexpr int BLOCK_TOTAL = BLOCKS_PER_ROW * (MAP_CELL_HEIGHT / BLOCK_SIZE);
+
+    struct Field {
+        CELL centroid;              // Resource cell nearest the block's centroid
+        int cells;
+        int value;
+    };
+
+    OreFields();
+
+    /**
+     * Forget every cell
+     */
+    void Clear();
+
+    /**
+     * Track an overlay change (layer bytes, as in CellLayers::overlay)
+     */
+    void Overlay_Changed(CELL cell, uint8_t old_overlay, uint8_t new_overlay);
+
+    /**
+     * Value of a resource overlay (CellClass::Get_Tiberium_Value), 0 for others
+     */
+    static int Overlay_Value(uint8_t overlay);
+
+    /**
+     * Resource cell nearest to a cell (straight-line distance)
+     *
+     * Ties go to the lowest CELL, so every machine picks the same one.
+     *
+     * @param max_range Farthest distance in cells to look
+     * @return CELL_NONE if no resource lies within range
+     */
+    CELL Nearest_Ore(CELL from, int max_range = MAP_CELL_WIDTH) const;
+
+    /**
+     * Field with the most value left within max_range cells of a cell
+     *
+     * Ties go to the nearer field. Returns false if there is none.
+     */
+    bool Richest_Field(CELL from, int max_range, Field& out) const;
+
+    bool Contains(CELL cell) const;
+    int Count() const { return count_; }
+    int Total_Value() const { return total_value_; }
+    int Field_Count() const { return static_cast<int>(fields_.size()); }
+
+private:
+    struct Block {
+        uint64_t mask;              // Bit (y & 7) * 8 + (x & 7)
+        int32_t sum_x;
+        int32_t sum_y;
+        int32_t value;
+    };
+
+    static bool Is_Map_Cell(CELL cell) {
+        return cell >= 0 && Cell_X(cell) < MAP_CELL_WIDTH && Cell_Y(cell) < MAP_CELL_HEIGHT;
+    }
+    static int Block_Of(int x, int y) { return (y >> BLOCK_SHIFT) * BLOCKS_PER_ROW + (x >> BLOCK_SHIFT); }
+    static int Bit_Of(int x, int y) { return ((y & (BLOCK_SIZE - 1)) << BLOCK_SHIFT) | (x & (BLOCK_SIZE - 1)); }
+
+    // Nearest cell of a block's mask to (x, y); keeps best/best_d2 if none is nearer
+    static void Scan_Block(int block, uint64_t mask, int x, int y, CELL& best, int& best_d2);
+
+    Field Make_Field(int block) const;
+
+    Block blocks_[BLOCK_TOTAL];
+    std::vector<int16_t> fields_;       // Non-empty blocks
+    std::vector<int16_t> field_slot_;   // Index in fields_ per block, -1 if empty
+    int count_;
+    int total_value_;
+};
@@ -0,0 +1,67 @@
+/**
+ * Tick Clock - Fixed-timestep scheduling for the logic loop
+ *
+ * Decides how many logic ticks a frame owes and how far the frame sits
+ * between the last tick and the next, so rendering can interpolate.
+ */
+
+#ifndef GAME_TICK_CLOCK_H
+#define GAME_TICK_CLOCK_H
+
+#include <cstdint>
+
+// =============================================================================
+// TickClock
+// =============================================================================
+
+/**
+ * TickClock - Accumulates frame time into whole logic ticks
+ *
+ * A frame runs at most MAX_CATCHUP_TICKS ticks. Time owed beyond that is
+ * dropped rather than carried, so after a stall (loading, debugger, window
+ * drag) the simulation briefly runs slower than real time instead of
+ * spiralling into ever longer catch-up frames.
+ */
+class TickClock {
+public:
+    static constexpr int MAX_CATCHUP_TICKS = 4;
+
+    TickClock();
+
+    /**
+     * Start counting from a time (milliseconds)
+     */
+    void Reset(uint32_t now);
+
+    /**
+     * Claim the ticks due at a time
+     *
+     * @param now Current time (milliseconds)
+     * @param interval Milliseconds per tick
+     * @return Ticks to run this frame (0..MAX_CATCHUP_TICKS)
+     */
+    int Advance(uint32_t now, uint32_t interval);
+
+    /**
+     * Fraction of the next tick already elapsed (0..1)
+     *
+     * Render objects at Lerp(previous, current, alpha).
+     */
+    float Alpha(uint32_t now, uint32_t interval) const;
+
+    /**
+     * Get time of the last claimed tick
+     */
+    uint32_t Get_Last_Tick_Time() const { return last_tick_time_; }
+
+    /**
+     * Get total time dropped by the catch-up cap (milliseconds)
+     */
+    uint32_t Get_Dropped_Time() const { return dropped_ms_; }
+
+private:
+    uint32_t last_tick_time_;   // Time of last logic tick
+    uint32_t dropped_ms_;       // Time dilated away since Reset
+};
+
+#endif // GAME_TICK_CLOCK_H
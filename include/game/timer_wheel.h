@@ -0,0 +1,147 @@
+/**
+ * TimerWheel - Wakeups by tick, paid for only when they fire
+ *
+ * Countdowns that are decremented every tick cost every tick, for every
+ * object that has one, whether or not anything is about to happen. A
+ * wheel instead files each timer under the tick it is due and each tick
+ * looks at one slot.
+ *
+ * Four levels of 64 slots each cover 64, 64^2, 64^3 and 64^4 ticks ahead.
+ * A timer goes in the finest level whose span covers its delay; when the
+ * level below wraps, a level's current slot is emptied and its timers are
+ * filed again, closer in. Timers further out than 64^4 ticks wait in the
+ * top level and are refiled every time it comes round. Schedule and Cancel are O(1) list operations
+ * on a pooled node, and Advance touches only the slot that is due (plus,
+ * every 64 ticks, one slot of the level above).
+ *
+ * Timers due the same tick fire in the order they were scheduled, so the
+ * outcome is the same on every machine. A handler may schedule or cancel
+ * timers, including ones due the same tick that have not fired yet.
+ *
+ * Usage:
+ *   TimerWheel wheel;
+ *   TimerWheel::TimerId id = wheel.Schedule(30, payload);
+ *   ...
+ *   wheel.Advance([](uint32_t payload) { ... });    // once per tick
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// TimerWheel
+// =============================================================================
+
+class TimerWheel {
+public:
+    using TimerId = uint32_t;
+
+    static constexpr TimerId TIMER_NONE = 0;
+
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+
+    TimerWheel();
+
+    /**
+     * Drop every timer and go back to tick 0
+     */
+    void Clear();
+
+    /**
+     * Wake in delay ticks (at least 1): the Advance that reaches Now() + delay
+     *
+     * @param payload Handed to the handler when the timer fires
+     * @return Id for Cancel; never TIMER_NONE
+     */
+    TimerId Schedule(uint32_t delay, uint32_t payload);
+
+    /**
+     * Stop a timer that has not fired yet
+     *
+     * @return false if it already fired or was cancelled
+     */
+    bool Cancel(TimerId id);
+
+    bool Is_Pending(TimerId id) const { return Live(id) >= 0; }
+
+    /**
+     * Tick a pending timer is due
+     */
+    uint32_t Due(TimerId id) const;
+
+    /**
+     * Move to the next tick and call fn(payload) for every timer due then
+     *
+     * @return Timers fired
+     */
+    template <typename Fn>
+    int Advance(Fn fn);
+
+    uint32_t Now() const { return now_; }
+    int Count() const { return count_; }
+
+private:
+    static constexpr int32_t NIL = -1;
+    static constexpr int16_t SLOT_DUE = -2;     // Collected, about to fire
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    struct Node {
+        uint32_t due;
+        uint32_t payload;
+        uint32_t sequence;      // Schedule order, for same-tick ties
+        int32_t prev;           // NIL at the head of a slot
+        int32_t next;           // NIL at the tail; next free node when free
+        uint16_t generation;    // Bumped on free; stale ids stop matching
+        int16_t slot;           // level * SLOTS + slot, SLOT_DUE, or NIL when free
+    };
+
+    static TimerId Make_Id(int32_t index, uint16_t generation) {
+        return (static_cast<uint32_t>(generation) << INDEX_BITS) | static_cast<uint32_t>(index + 1);
+    }
+
+    // Node index of a pending timer, or NIL
+    int32_t Live(TimerId id) const;
+
+    void File(int32_t index);
+    void Unlink(int32_t index);
+    void Free(int32_t index);
+    void Cascade(int level);
+
+    // Unfile the timers due now into due_, in schedule order
+    void Collect();
+
+    std::vector<Node> nodes_;
+    int32_t free_;                          // Free node list
+    int32_t heads_[LEVELS * SLOTS];
+    int32_t tails_[LEVELS * SLOTS];
+    std::vector<int32_t> due_;              // Collected by the current Advance
+    uint32_t now_;
+    uint32_t sequence_;
+    int count_;
+};
+
+template <typename Fn>
+int TimerWheel::Advance(Fn fn) {
+    now_++;
+    Collect();
+
+    int fired = 0;
+    for (size_t i = 0; i < due_.size(); i++) {
+        int32_t index = due_[i];
+        if (nodes_[index].slot != SLOT_DUE) {
+            continue;   // Cancelled by an earlier handler
+        }
+        uint32_t payload = nodes_[index].payload;
+        Free(index);
+        fired++;
+        fn(payload);
+    }
+    due_.clear();
+    return fired;
+}
@@ -0,0 +1,224 @@
+/**
+ * TriggerEngine - Scenario triggers evaluated only when their events fire
+ *
+ * A trigger waits on one or two events and runs its action when they
+ * have happened (TRIGGER_ONLY, _AND, _OR). Rather than asking every
+ * trigger each tick whether its events have happened, the engine files
+ * each trigger under the events it waits on:
+ *
+ *   - TEVENT_DESTROYED      by attached object handle
+ *   - TEVENT_ENTERED        by cell, with a bitmap of watched cells
+ *   - TEVENT_TIME           on a TimerWheel, by due tick
+ *   - TEVENT_CREDITS        by house
+ *
+ * Game code reports what happened (Object_Destroyed, Cell_Entered) and
+ * the engine springs just the triggers filed under it. Update then
+ * evaluates only those triggers, plus due timers and the credit
+ * triggers of houses whose money changed. An object stepping into a cell
+ * nobody watches costs one bit test; a tick where nothing relevant
+ * happened costs one wheel slot and one comparison per watched house, no
+ * matter how many triggers the mission has.
+ *
+ * What an action does is up to whoever sets the action handler: the
+ * engine hands over the trigger's index and its TriggerType.
+ *
+ * Usage:
+ *   TriggerType type;
+ *   type.event1 = {TEVENT_ENTERED, HOUSE_GOOD, 0};
+ *   type.action = 3;
+ *   int id = TriggerEngine::Instance().Add(type);
+ *   TriggerEngine::Instance().Attach_Cell(id, XY_Cell(40, 52));
+ *
+ * Original location: CODE/TRIGGER.CPP, CODE/TEVENT.CPP
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/house.h"
+#include "game/object_heap.h"
+#include "game/timer_wheel.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class ObjectClass;
+
+// =============================================================================
+// Events
+// =============================================================================
+
+enum TEventType : uint8_t {
+    TEVENT_NONE = 0,
+    TEVENT_ENTERED = 1,     // An object of house (or any) entered an attached cell
+    TEVENT_DESTROYED = 2,   // An attached object was destroyed
+    TEVENT_TIME = 3,        // data ticks after the trigger was added or last fired
+    TEVENT_CREDITS = 4,     // House has at least data credits
+
+    TEVENT_COUNT = 5
+};
+
+struct TEventClass {
+    TEventType type = TEVENT_NONE;
+    HousesType house = HOUSE_NONE;  // TEVENT_ENTERED: HOUSE_NONE is anyone
+    int32_t data = 0;
+};
+
+// =============================================================================
+// Triggers
+// =============================================================================
+
+enum TriggerLogic : uint8_t {
+    TRIGGER_ONLY = 0,       // event1
+    TRIGGER_AND = 1,        // event1 and event2, in either order
+    TRIGGER_OR = 2,         // event1 or event2
+};
+
+enum TriggerPersist : uint8_t {
+    TRIGGER_VOLATILE = 0,   // Fires once
+    TRIGGER_PERSISTENT = 1, // Fires every time its events happen
+};
+
+struct TriggerType {
+    TEventClass event1;
+    TEventClass event2;
+    TriggerLogic logic = TRIGGER_ONLY;
+    TriggerPersist persist = TRIGGER_VOLATILE;
+    int32_t action = 0;     // Passed to the action handler
+};
+
+// =============================================================================
+// TriggerEngine
+// =============================================================================
+
+class TriggerEngine {
+public:
+    using ActionHandler = std::function<void(int id, const TriggerType& type)>;
+
+    static TriggerEngine& Instance();
+
+    /**
+     * Drop every trigger and subscription and restart the tick count
+     */
+    void Clear();
+
+    /**
+     * Add a trigger
+     *
+     * TEVENT_TIME and TEVENT_CREDITS subscribe at once; TEVENT_ENTERED and
+     * TEVENT_DESTROYED wait for Attach_Cell / Attach_Object.
+     *
+     * @return Trigger index
+     */
+    int Add(const TriggerType& type);
+
+    /**
+     * Watch a cell for the trigger's TEVENT_ENTERED
+     */
+    void Attach_Cell(int id, CELL cell);
+
+    /**
+     * Watch an object for the trigger's TEVENT_DESTROYED
+     */
+    void Attach_Object(int id, const ObjectClass* obj);
+
+    void Set_Action_Handler(ActionHandler handler) { action_ = std::move(handler); }
+
+    // -------------------------------------------------------------------------
+    // Reporting
+    // -------------------------------------------------------------------------
+
+    /**
+     * Whether any trigger watches a cell; the caller's fast path
+     */
+    bool Is_Cell_Watched(CELL cell) const {
+        return cell >= 0 && (cell_bits_[cell >> 6] >> (cell & 63)) & 1;
+    }
+
+    /**
+     * Whether any trigger watches any object; the caller's fast path
+     */
+    bool Is_Watching_Objects() const { return !by_object_.empty(); }
+
+    /**
+     * An object of a house moved into a cell
+     */
+    void Cell_Entered(CELL cell, HousesType house);
+
+    /**
+     * An object was destroyed
+     */
+    void Object_Destroyed(const ObjectClass* obj);
+
+    /**
+     * One logic tick: spring due timers and credit triggers, then run the
+     * actions of every sprung trigger whose logic is now satisfied, in
+     * trigger order
+     */
+    void Update();
+
+    // -------------------------------------------------------------------------
+    // Queries
+    // -------------------------------------------------------------------------
+
+    int Count() const { return static_cast<int>(triggers_.size()); }
+    uint32_t Get_Tick() const { return tick_; }
+    bool Is_Active(int id) const { return id >= 0 && id < Count() && triggers_[id].active; }
+    int Fire_Count(int id) const { return id >= 0 && id < Count() ? triggers_[id].fired : 0; }
+
+    /**
+     * Triggers evaluated since Clear; each trigger counts once per tick
+     * it had a sprung event
+     */
+    uint32_t Evaluations() const { return evaluations_; }
+
+private:
+    TriggerEngine();
+
+    struct Trigger {
+        TriggerType type;
+        uint8_t sprung = 0;     // Bit 0 event1, bit 1 event2
+        bool active = true;
+        bool queued = false;
+        TimerWheel::TimerId timer[2] = {TimerWheel::TIMER_NONE, TimerWheel::TIMER_NONE};
+        int fired = 0;
+    };
+
+    struct CellWatch {
+        CELL cell;
+        int id;
+    };
+
+    struct CreditWatch {
+        int id;
+        int32_t amount;
+        uint8_t bit;
+    };
+
+    static uint64_t Key(ObjectHandle handle) {
+        return (static_cast<uint64_t>(handle.rtti) << 32) |
+               (static_cast<uint64_t>(handle.slot) << 16) | handle.generation;
+    }
+
+    void Spring(int id, TEventType type, HousesType house);
+    void Queue(int id);
+    void Arm_Timer(int id);
+    void Check_Credits();
+    bool Is_Satisfied(const Trigger& trigger) const;
+
+    std::vector<Trigger> triggers_;
+
+    // Subscriptions
+    uint64_t cell_bits_[32768 / 64];           // One bit per non-negative CELL
+    std::vector<CellWatch> by_cell_;            // Sorted by cell, then id
+    std::unordered_multimap<uint64_t, int> by_object_;
+    TimerWheel timers_;                         // Payload id << 1 | event bit
+    std::vector<CreditWatch> by_house_[HOUSE_COUNT];
+    int32_t last_money_[HOUSE_COUNT];
+
+    std::vector<int> pending_;                  // Sprung this tick
+    ActionHandler action_;
+    uint32_t tick_ = 0;
+    uint32_t evaluations_ = 0;
+};
@@ -55,6 +55,44 @@ enum BuildingType : int8_t {
     BUILDING_COUNT = 21
 };
 
+// =============================================================================
+// Building Type Data
+// =============================================================================
+
+/**
+ * BuildingTypeFlags - Yes/no properties of a building type
+ */
+enum BuildingTypeFlags : uint8_t {
+    BUILDING_FLAG_CONYARD = (1 << 0),   // Construction yard
+    BUILDING_FLAG_DEFENSE = (1 << 1),   // Base defense
+    BUILDING_FLAG_NO_BIB = (1 << 2),    // Sits without a concrete bib
+};
+
+/**
+ * BuildingTypeData - Default definition of a building type
+ *
+ * Plain data, so the defaults are a constexpr table (type_tables.h) and
+ * a type class is made by copying one row.
+ */
+struct BuildingTypeData {
+    const char* name;               // INI name
+    const char* full_name;          // Display name
+    int8_t width;                   // Footprint in cells
+    int8_t height;
+    int16_t strength;               // Max health
+    ArmorType armor;
+    int16_t power;                  // Produced (+) or drained (-)
+    int16_t cost;
+    int16_t build_time;
+    uint32_t prerequisites;         // PREREQ_* flags
+    int8_t tech_level;              // -1 = never buildable
+    SideType side;
+    int8_t sight;                   // Sight range in cells
+    int8_t factory_type;            // See Get_Factory_Type()
+    WeaponType weapon;
+    uint8_t flags;                  // BUILDING_FLAG_*
+};
+
 // =============================================================================
 // BuildingTypeClass
 // =============================================================================
@@ -77,6 +115,12 @@ public:
     BuildingTypeClass();
     BuildingTypeClass(const char* ini_name, const char* full_name);
 
+    /**
+     * The type as defined by its row in the default table
+     */
+    explicit BuildingTypeClass(BuildingType type);
+    explicit BuildingTypeClass(const BuildingTypeData& data);
+
     // -------------------------------------------------------------------------
     // Size
     // -------------------------------------------------------------------------
@@ -183,6 +227,6 @@ inline BuildingTypeClass* Building_Type(BuildingType type) {
 }
 
 /**
- * Get building type by name
+ * Get building type by name (case-insensitive); BUILDING_NONE if unknown
  */
 BuildingType Building_Type_From_Name(const char* name);
@@ -11,6 +11,7 @@
 
 #include "game/types/abstracttype.h"
 #include "game/weapon.h"
+#include "game/graphics/shape_id.h"
 
 // =============================================================================
 // ObjectTypeClass
@@ -44,6 +45,12 @@ public:
     const char* Get_Shape_Name() const { return shape_name_; }
     void Set_Shape_Name(const char* name) { shape_name_ = name; }
 
+    /**
+     * Get shape cache handle (resolved by Init_Type_Shapes)
+     */
+    ShapeId Get_Shape_Id() const { return shape_id_; }
+    void Set_Shape_Id(ShapeId id) { shape_id_ = id; }
+
     /**
      * Get number of frames in shape
      */
@@ -79,6 +86,7 @@ public:
 protected:
     // Graphics
     const char* shape_name_;     // Shape file name
+    ShapeId shape_id_;           // ShapeCache handle for shape_name_
     int frame_count_;            // Number of animation frames
 
     // Combat
@@ -96,6 +104,7 @@ protected:
 inline ObjectTypeClass::ObjectTypeClass()
     : AbstractTypeClass()
     , shape_name_("")
+    , shape_id_(SHAPE_ID_NONE)
     , frame_count_(1)
     , armor_(ARMOR_NONE)
     , max_strength_(1)
@@ -106,9 +115,23 @@ inline ObjectTypeClass::ObjectTypeClass()
 inline ObjectTypeClass::ObjectTypeClass(const char* ini_name, const char* full_name, RTTIType rtti)
     : AbstractTypeClass(ini_name, full_name, rtti)
     , shape_name_(ini_name)
+    , shape_id_(SHAPE_ID_NONE)
     , frame_count_(1)
     , armor_(ARMOR_NONE)
     , max_strength_(1)
     , is_selectable_(true)
 {
 }
+
+// =============================================================================
+// Shape Handle Resolution
+// =============================================================================
+
+/**
+ * Register the shape of every static unit and building type with the
+ * global ShapeCache and store the resulting handles on the types.
+ *
+ * Shapes are not loaded here; the first draw loads them.
+ * Defined in types.cpp.
+ */
+void Init_Type_Shapes();
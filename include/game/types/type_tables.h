@@ -0,0 +1,305 @@
+/**
+ * Type Tables - Compile-time default unit and building definitions
+ *
+ * Every default stat lives in the constexpr rows below. UnitTypes[] and
+ * BuildingTypes[] are made from them by copying one row each, so startup
+ * runs no per-type setup code. RULES.INI then patches the live types
+ * sparsely: only the entries a file actually gives are touched, and
+ * Reset_Type_Rules() puts the table values back.
+ *
+ * Name lookup goes through a perfect hash also built at compile time:
+ * one hash, one slot, one name compare, never a probe or a scan.
+ *
+ * Original location: CODE/UDATA.CPP, CODE/BDATA.CPP
+ */
+
+#pragma once
+
+#include "game/types/buildingtype.h"
+#include "game/types/unittype.h"
+#include <cstdint>
+#include <string_view>
+
+class INIClass;
+
+// =============================================================================
+// Unit Table
+// =============================================================================
+
+// name, full name, shape, frames, strength, armor, speed, primary, secondary,
+// cost, build time, prerequisites, tech level, side, sight, turret rate, flags
+inline constexpr UnitTypeData UNIT_TYPE_TABLE[UNIT_COUNT] = {
+    {"MTNK", "Medium Tank", "MTNK", 32, 400, ARMOR_HEAVY, 10, WEAPON_90MM, WEAPON_NONE,
+     800, 100, PREREQ_WARFACTORY, 2, SIDE_ALLIED, 5, 5, UNIT_FLAG_TURRET | UNIT_FLAG_CRUSHER},
+    {"LTNK", "Light Tank", "LTNK", 32, 300, ARMOR_LIGHT, 12, WEAPON_75MM, WEAPON_NONE,
+     600, 80, PREREQ_WARFACTORY, 1, SIDE_ALLIED, 5, 5, UNIT_FLAG_TURRET},
+    {"HTNK", "Heavy Tank", "HTNK", 32, 600, ARMOR_HEAVY, 6, WEAPON_120MM, WEAPON_MAMMOTH_TUSK,
+     1500, 150, PREREQ_WARFACTORY | PREREQ_TECHCENTER, 5, SIDE_SOVIET, 4, 5,
+     UNIT_FLAG_TURRET | UNIT_FLAG_CRUSHER},
+    {"APC", "APC", "APC", 1, 200, ARMOR_LIGHT, 14, WEAPON_M60MG, WEAPON_NONE,
+     700, 90, PREREQ_WARFACTORY, 2, SIDE_ALLIED, 3, 5, 0},
+    {"ARTY", "Artillery", "ARTY", 1, 150, ARMOR_LIGHT, 8, WEAPON_155MM, WEAPON_NONE,
+     600, 80, PREREQ_WARFACTORY, 4, SIDE_ALLIED, 3, 5, 0},
+    {"HARV", "Ore Truck", "HARV", 1, 600, ARMOR_LIGHT, 8, WEAPON_NONE, WEAPON_NONE,
+     1400, 120, PREREQ_NONE, 1, SIDE_NEUTRAL, 3, 5, UNIT_FLAG_HARVESTER},
+    {"MCV", "MCV", "MCV", 1, 600, ARMOR_LIGHT, 6, WEAPON_NONE, WEAPON_NONE,
+     2500, 200, PREREQ_NONE, 1, SIDE_NEUTRAL, 3, 5, UNIT_FLAG_MCV},
+    {"JEEP", "Ranger", "JEEP", 1, 150, ARMOR_LIGHT, 16, WEAPON_M60MG, WEAPON_NONE,
+     500, 60, PREREQ_WARFACTORY, 1, SIDE_ALLIED, 3, 5, UNIT_FLAG_WHEELED},
+    {"V2RL", "V2 Launcher", "V2RL", 1, 150, ARMOR_LIGHT, 8, WEAPON_SCUD, WEAPON_NONE,
+     700, 100, PREREQ_WARFACTORY | PREREQ_RADAR, 4, SIDE_SOVIET, 3, 5, 0},
+    {"FTNK", "Flame Tank", "FTNK", 1, 300, ARMOR_HEAVY, 10, WEAPON_FIREBALL, WEAPON_NONE,
+     800, 100, PREREQ_WARFACTORY, 3, SIDE_SOVIET, 3, 5, 0},
+};
+
+// =============================================================================
+// Building Table
+// =============================================================================
+
+// name, full name, width, height, strength, armor, power, cost, build time,
+// prerequisites, tech level, side, sight, factory type, weapon, flags
+inline constexpr BuildingTypeData BUILDING_TYPE_TABLE[BUILDING_COUNT] = {
+    {"FACT", "Construction Yard", 3, 3, 1000, ARMOR_WOOD, -30, 0, 0,
+     PREREQ_NONE, 1, SIDE_NEUTRAL, 3, 4, WEAPON_NONE, BUILDING_FLAG_CONYARD},
+    {"POWR", "Power Plant", 2, 2, 400, ARMOR_WOOD, 100, 300, 0,
+     PREREQ_NONE, 1, SIDE_NEUTRAL, 3, 0, WEAPON_NONE, 0},
+    {"APWR", "Advanced Power Plant", 3, 3, 700, ARMOR_WOOD, 200, 500, 0,
+     PREREQ_NONE, 8, SIDE_NEUTRAL, 3, 0, WEAPON_NONE, 0},
+    {"BARR", "Barracks", 2, 2, 800, ARMOR_WOOD, -20, 400, 0,
+     PREREQ_NONE, 1, SIDE_ALLIED, 3, 1, WEAPON_NONE, 0},
+    {"TENT", "Barracks", 2, 2, 800, ARMOR_WOOD, -20, 400, 0,
+     PREREQ_NONE, 1, SIDE_SOVIET, 3, 1, WEAPON_NONE, 0},
+    {"WEAP", "War Factory", 3, 3, 1000, ARMOR_WOOD, -30, 2000, 0,
+     PREREQ_NONE, 3, SIDE_NEUTRAL, 3, 2, WEAPON_NONE, 0},
+    {"DOME", "Radar Dome", 2, 2, 1000, ARMOR_WOOD, -40, 1000, 0,
+     PREREQ_NONE, 3, SIDE_NEUTRAL, 10, 0, WEAPON_NONE, 0},
+    {"HPAD", "Helipad", 2, 2, 800, ARMOR_WOOD, -10, 1500, 0,
+     PREREQ_RADAR, 9, SIDE_ALLIED, 3, 3, WEAPON_NONE, 0},
+    {"AFLD", "Airfield", 3, 2, 1000, ARMOR_WOOD, -30, 600, 0,
+     PREREQ_RADAR, 5, SIDE_SOVIET, 3, 3, WEAPON_NONE, 0},
+    {"SPEN", "Sub Pen", 3, 3, 1000, ARMOR_WOOD, -30, 650, 0,
+     PREREQ_NONE, 3, SIDE_SOVIET, 3, 0, WEAPON_NONE, BUILDING_FLAG_NO_BIB},
+    {"SYRD", "Shipyard", 3, 3, 1000, ARMOR_WOOD, -30, 650, 0,
+     PREREQ_NONE, 3, SIDE_ALLIED, 3, 0, WEAPON_NONE, BUILDING_FLAG_NO_BIB},
+    {"GUN", "Turret", 1, 1, 400, ARMOR_HEAVY, -40, 600, 0,
+     PREREQ_BARRACKS, 4, SIDE_ALLIED, 6, 0, WEAPON_TURRET_GUN,
+     BUILDING_FLAG_DEFENSE | BUILDING_FLAG_NO_BIB},
+    {"AGUN", "AA Gun", 1, 1, 400, ARMOR_HEAVY, -50, 600, 0,
+     PREREQ_RADAR, 5, SIDE_ALLIED, 6, 0, WEAPON_ZSU23,
+     BUILDING_FLAG_DEFENSE | BUILDING_FLAG_NO_BIB},
+    {"GTWR", "Guard Tower", 1, 1, 400, ARMOR_WOOD, 0, 500, 0,
+     PREREQ_BARRACKS, 1, SIDE_ALLIED, 4, 0, WEAPON_VULCAN,
+     BUILDING_FLAG_DEFENSE | BUILDING_FLAG_NO_BIB},
+    {"TSLA", "Tesla Coil", 1, 2, 400, ARMOR_HEAVY, -150, 1500, 0,
+     PREREQ_WARFACTORY, 7, SIDE_SOVIET, 8, 0, WEAPON_TESLA_ZAP,
+     BUILDING_FLAG_DEFENSE | BUILDING_FLAG_NO_BIB},
+    {"SAM", "SAM Site", 2, 1, 400, ARMOR_HEAVY, -20, 750, 0,
+     PREREQ_RADAR, 9, SIDE_SOVIET, 5, 0, WEAPON_NIKE,
+     BUILDING_FLAG_DEFENSE | BUILDING_FLAG_NO_BIB},
+    {"SILO", "Ore Silo", 1, 1, 300, ARMOR_WOOD, -10, 150, 0,
+     PREREQ_NONE, 1, SIDE_NEUTRAL, 3, 0, WEAPON_NONE, BUILDING_FLAG_NO_BIB},
+    {"PROC", "Ore Refinery", 3, 3, 900, ARMOR_WOOD, -30, 2000, 0,
+     PREREQ_NONE, 1, SIDE_NEUTRAL, 4, 0, WEAPON_NONE, 0},
+    {"FCOM", "Forward Command", 2, 2, 400, ARMOR_WOOD, -200, 1500, 0,
+     PREREQ_NONE, -1, SIDE_NEUTRAL, 3, 0, WEAPON_NONE, 0},
+    {"ATEK", "Allied Tech Center", 2, 2, 400, ARMOR_WOOD, -200, 1500, 0,
+     PREREQ_WARFACTORY | PREREQ_RADAR, 10, SIDE_ALLIED, 3, 0, WEAPON_NONE, 0},
+    {"STEK", "Soviet Tech Center", 2, 2, 600, ARMOR_WOOD, -100, 1500, 0,
+     PREREQ_WARFACTORY | PREREQ_RADAR, 6, SIDE_SOVIET, 3, 0, WEAPON_NONE, 0},
+};
+
+// =============================================================================
+// Occupy Lists
+// =============================================================================
+
+/**
+ * Cells a building covers, as offsets from its top-left cell
+ */
+struct OccupyList {
+    static constexpr int MAX_CELLS = 9;
+
+    int count;
+    struct {
+        int8_t x;
+        int8_t y;
+    } cells[MAX_CELLS];
+};
+
+constexpr OccupyList Make_Occupy_List(const BuildingTypeData& data) {
+    OccupyList list = {};
+    for (int y = 0; y < data.height; y++) {
+        for (int x = 0; x < data.width; x++) {
+            list.cells[list.count].x = static_cast<int8_t>(x);
+            list.cells[list.count].y = static_cast<int8_t>(y);
+            list.count++;
+        }
+    }
+    return list;
+}
+
+struct OccupyTable {
+    OccupyList lists[BUILDING_COUNT];
+};
+
+constexpr OccupyTable Make_Occupy_Table() {
+    OccupyTable table = {};
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        table.lists[i] = Make_Occupy_List(BUILDING_TYPE_TABLE[i]);
+    }
+    return table;
+}
+
+inline constexpr OccupyTable BUILDING_OCCUPY = Make_Occupy_Table();
+
+/**
+ * Cells covered by a building type (its default footprint)
+ */
+inline const OccupyList& Building_Occupy(BuildingType type) {
+    return BUILDING_OCCUPY.lists[type];
+}
+
+// =============================================================================
+// Footprint Masks
+// =============================================================================
+
+/**
+ * A building's footprint as row bitmasks, for BuildMap's word-wise tests
+ *
+ * Bit x of rows[y] is the cell (x, y) from the top-left cell. near[] is
+ * the footprint grown by one cell on every side, from (-1, -1): the cells
+ * a new building must touch to count as adjacent.
+ */
+struct FootprintMask {
+    static constexpr int MAX_ROWS = 5;
+
+    int8_t width;
+    int8_t height;
+    uint8_t rows[MAX_ROWS];
+    uint8_t near[MAX_ROWS];
+};
+
+constexpr FootprintMask Make_Footprint_Mask(const OccupyList& list) {
+    FootprintMask mask = {};
+    for (int i = 0; i < list.count; i++) {
+        int x = list.cells[i].x;
+        int y = list.cells[i].y;
+        mask.width = static_cast<int8_t>(x + 1 > mask.width ? x + 1 : mask.width);
+        mask.height = static_cast<int8_t>(y + 1 > mask.height ? y + 1 : mask.height);
+        mask.rows[y] |= static_cast<uint8_t>(1 << x);
+        for (int dy = 0; dy < 3; dy++) {
+            mask.near[y + dy] |= static_cast<uint8_t>(7 << x);
+        }
+    }
+    return mask;
+}
+
+struct FootprintTable {
+    FootprintMask masks[BUILDING_COUNT];
+};
+
+constexpr FootprintTable Make_Footprint_Table() {
+    FootprintTable table = {};
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        table.masks[i] = Make_Footprint_Mask(BUILDING_OCCUPY.lists[i]);
+    }
+    return table;
+}
+
+inline constexpr FootprintTable BUILDING_FOOTPRINT = Make_Footprint_Table();
+
+static_assert(BUILDING_FOOTPRINT.masks[BUILDING_FACT].rows[2] == 7 &&
+              BUILDING_FOOTPRINT.masks[BUILDING_FACT].near[4] == 31,
+              "Footprint masks must cover the occupy lists");
+
+/**
+ * Footprint of a building type as row masks (its default footprint)
+ */
+inline const FootprintMask& Building_Footprint(BuildingType type) {
+    return BUILDING_FOOTPRINT.masks[type];
+}
+
+// =============================================================================
+// Perfect Name Hash
+// =============================================================================
+
+/**
+ * Case-insensitive FNV-1a of a name, perturbed by a seed
+ */
+constexpr uint32_t Type_Name_Hash(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B1u);
+    for (char c : name) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - ('a' - 'A'));
+        }
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+/**
+ * Slot table in which every type name has a slot to itself
+ *
+ * Built by trying seeds until no two names share a slot; SLOTS is about
+ * three times the name count so one turns up within a few dozen tries.
+ */
+template <int SLOTS>
+struct TypeNameTable {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+
+    uint32_t seed;                  // ~0u if no seed was found
+    int8_t index[SLOTS];            // Type in each slot, -1 = empty
+
+    constexpr int Slot(std::string_view name) const {
+        return static_cast<int>(Type_Name_Hash(name, seed) & (SLOTS - 1));
+    }
+};
+
+template <int SLOTS, typename Row, int COUNT>
+constexpr TypeNameTable<SLOTS> Make_Name_Table(const Row (&rows)[COUNT]) {
+    TypeNameTable<SLOTS> table = {};
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        table.seed = seed;
+        for (int slot = 0; slot < SLOTS; slot++) {
+            table.index[slot] = -1;
+        }
+        bool clash = false;
+        for (int i = 0; i < COUNT && !clash; i++) {
+            int slot = table.Slot(rows[i].name);
+            clash = table.index[slot] >= 0;
+            table.index[slot] = static_cast<int8_t>(i);
+        }
+        if (!clash) {
+            return table;
+        }
+    }
+    table.seed = ~0u;
+    return table;
+}
+
+inline constexpr TypeNameTable<32> UNIT_NAME_TABLE = Make_Name_Table<32>(UNIT_TYPE_TABLE);
+inline constexpr TypeNameTable<64> BUILDING_NAME_TABLE = Make_Name_Table<64>(BUILDING_TYPE_TABLE);
+
+static_assert(UNIT_NAME_TABLE.seed != ~0u, "No perfect hash for the unit names");
+static_assert(BUILDING_NAME_TABLE.seed != ~0u, "No perfect hash for the building names");
+static_assert(UNIT_NAME_TABLE.index[UNIT_NAME_TABLE.Slot("mtnk")] == UNIT_MTNK,
+              "Unit name hash must ignore case");
+
+// =============================================================================
+// RULES.INI
+// =============================================================================
+
+/**
+ * Patch the live types with whatever a rules file gives
+ *
+ * Recognized entries: Strength, Armor, Cost, TechLevel, Sight, Speed
+ * and ROT (units), Power (buildings). Anything absent keeps its current
+ * value.
+ *
+ * @return Number of types the file had a section for
+ */
+int Apply_Type_Rules(const INIClass& rules);
+
+/**
+ * Return every type to its table defaults (shape handles are kept)
+ */
+void Reset_Type_Rules();
@@ -40,6 +40,47 @@ enum UnitType : int8_t {
     UNIT_COUNT = 10
 };
 
+// =============================================================================
+// Unit Type Data
+// =============================================================================
+
+/**
+ * UnitTypeFlags - Yes/no properties of a unit type
+ */
+enum UnitTypeFlags : uint8_t {
+    UNIT_FLAG_WHEELED = (1 << 0),       // Wheeled rather than tracked
+    UNIT_FLAG_CRUSHER = (1 << 1),       // Crushes infantry
+    UNIT_FLAG_TURRET = (1 << 2),        // Rotating turret
+    UNIT_FLAG_HARVESTER = (1 << 3),
+    UNIT_FLAG_MCV = (1 << 4),
+};
+
+/**
+ * UnitTypeData - Default definition of a unit type
+ *
+ * Plain data, so the defaults are a constexpr table (type_tables.h) and
+ * a type class is made by copying one row.
+ */
+struct UnitTypeData {
+    const char* name;               // INI name
+    const char* full_name;          // Display name
+    const char* shape;              // Shape file, without ".SHP"
+    int16_t frames;                 // Shape frames
+    int16_t strength;               // Max health
+    ArmorType armor;
+    int8_t speed;
+    WeaponType primary;
+    WeaponType secondary;
+    int16_t cost;
+    int16_t build_time;
+    uint32_t prerequisites;         // PREREQ_* flags
+    int8_t tech_level;
+    SideType side;
+    int8_t sight;                   // Sight range in cells
+    int8_t turret_rate;
+    uint8_t flags;                  // UNIT_FLAG_*
+};
+
 // =============================================================================
 // UnitTypeClass
 // =============================================================================
@@ -62,6 +103,12 @@ public:
     UnitTypeClass();
     UnitTypeClass(const char* ini_name, const char* full_name);
 
+    /**
+     * The type as defined by its row in the default table
+     */
+    explicit UnitTypeClass(UnitType type);
+    explicit UnitTypeClass(const UnitTypeData& data);
+
     // -------------------------------------------------------------------------
     // Movement
     // -------------------------------------------------------------------------
@@ -150,6 +197,6 @@ inline UnitTypeClass* Unit_Type(UnitType type) {
 }
 
 /**
- * Get unit type by name
+ * Get unit type by name (case-insensitive); UNIT_NONE if unknown
  */
 UnitType Unit_Type_From_Name(const char* name);
@@ -15,6 +15,8 @@
 
 // Forward declarations
 class GraphicsBuffer;
+struct LanDiscovery;
+struct DiscoveredGame;
 
 // =============================================================================
 // Menu Button Definition
@@ -78,6 +80,12 @@ public:
      */
     bool Initialize();
 
+    /**
+     * Start looking for LAN games (once; GameClass does it after the
+     * menu first shows)
+     */
+    void StartDiscovery();
+
     /**
      * Shutdown and release resources
      */
@@ -121,6 +129,21 @@ public:
      */
     void Reset();
 
+    /**
+     * Games found on the LAN so far
+     *
+     * Browsing runs on its own thread from Initialize(), so the
+     * multiplayer lobby opens with the list already filled in.
+     *
+     * @return Games written to games (at most max_games)
+     */
+    int GetLanGames(DiscoveredGame* games, int max_games) const;
+
+    /**
+     * LAN browser, for the lobby to advertise a hosted game (may be null)
+     */
+    LanDiscovery* GetDiscovery() const { return discovery_; }
+
     // =========================================================================
     // Constants
     // =========================================================================
@@ -206,6 +229,9 @@ private:
 
     // Menu buttons
     MenuButton buttons_[BUTTON_COUNT];
+
+    // LAN game browser
+    LanDiscovery* discovery_;
 };
 
 #endif // GAME_UI_MAIN_MENU_H
@@ -0,0 +1,189 @@
+/**
+ * VqaDecoder - Westwood VQA Movie Decoding
+ *
+ * Parses a VQA file held in memory (normally a MixView of the MIX
+ * archive) one frame at a time: codebooks (full CBF0/CBFZ, or partial
+ * CBP0/CBPZ assembled over a frame group), palettes (CPL0/CPLZ), vector
+ * pointers (VPT0/VPTZ/VPTK/VPTD) and the interleaved sound chunks
+ * (SND0 raw PCM, SND2 IMA ADPCM). Replaces VQ/VQA32 LOADER.CPP and the
+ * UnVQ_4x2 / UnVQ_4x4 drawers.
+ *
+ * Nothing is read ahead of the frame being decoded, so memory stays at
+ * the codebooks and one frame's pointers however long the movie is.
+ * The file bytes are not copied and must outlive the decoder.
+ *
+ * Usage:
+ *   VqaDecoder decoder;
+ *   VqaFrame frame;
+ *   if (decoder.Open(view.Data(), view.Size())) {
+ *       while (decoder.DecodeFrame(frame)) Show(frame);
+ *   }
+ */
+
+#ifndef GAME_VIDEO_VQA_DECODER_H
+#define GAME_VIDEO_VQA_DECODER_H
+
+#include "game/audio/aud_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// File Format
+// =============================================================================
+
+/**
+ * VQHD chunk: the movie's header (VQAHeader in VQAFILE.H)
+ */
+#pragma pack(push, 1)
+struct VqaHeader {
+    uint16_t version;               // 1 = C&C, 2 = Red Alert
+    uint16_t flags;                 // VqaHeaderFlags
+    uint16_t frames;
+    uint16_t width;
+    uint16_t height;
+    uint8_t  block_width;           // Codebook block size (4x2 or 4x4)
+    uint8_t  block_height;
+    uint8_t  fps;
+    uint8_t  group_size;            // Frames one partial codebook spans
+    uint16_t colors;                // Colors used in the palette
+    uint16_t codebook_entries;      // Largest codebook
+    uint16_t x_pos;                 // Suggested position (0xFFFF = center)
+    uint16_t y_pos;
+    uint16_t max_frame_size;
+    uint16_t sample_rate;
+    uint8_t  channels;
+    uint8_t  bits_per_sample;
+    uint16_t alt_sample_rate;
+    uint8_t  alt_channels;
+    uint8_t  alt_bits_per_sample;
+    uint16_t future_use[5];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(VqaHeader) == 42, "VqaHeader must be 42 bytes");
+
+enum VqaHeaderFlags : uint16_t {
+    VQA_FLAG_AUDIO      = 0x0001,   // Audio track present
+    VQA_FLAG_ALT_AUDIO  = 0x0002,   // Alternate audio track present
+};
+
+// Chunk IDs, as the big-endian fourcc reads
+constexpr uint32_t Vqa_Id(char a, char b, char c, char d) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(a)) << 24) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 8) |
+           static_cast<uint32_t>(static_cast<uint8_t>(d));
+}
+
+// =============================================================================
+// Decoded Frame
+// =============================================================================
+
+/**
+ * VqaFrame - One decoded frame and the sound that came with it
+ *
+ * Reused from frame to frame; the buffers keep their capacity.
+ */
+struct VqaFrame {
+    int index = -1;                 // Frame number
+    std::vector<uint8_t> pixels;    // width * height, 8-bit indexed
+    uint8_t palette[768] = {};      // 6-bit VGA RGB, current as of this frame
+    bool palette_changed = false;   // A palette chunk came with this frame
+    std::vector<int16_t> audio;     // Interleaved PCM stored with this frame
+};
+
+// =============================================================================
+// Decoder
+// =============================================================================
+
+class VqaDecoder {
+public:
+    VqaDecoder() = default;
+
+    VqaDecoder(const VqaDecoder&) = delete;
+    VqaDecoder& operator=(const VqaDecoder&) = delete;
+
+    /**
+     * Parse the FORM/WVQA wrapper and the VQHD header
+     *
+     * @return false if this is not a VQA the decoder can draw
+     */
+    bool Open(const uint8_t* data, uint32_t size);
+
+    void Close();
+    bool IsOpen() const { return data_ != nullptr; }
+
+    /**
+     * Decode the next frame into frame
+     *
+     * Sound chunks met on the way are decoded into frame.audio. Frames
+     * are always drawn whole, so frame needs no earlier contents.
+     *
+     * @return false after the last frame, or on a damaged chunk
+     */
+    bool DecodeFrame(VqaFrame& frame);
+
+    // All frames decoded (or the data ran out)
+    bool IsFinished() const;
+
+    // Frames decoded so far
+    int GetFrameIndex() const { return frame_index_; }
+
+    const VqaHeader& GetHeader() const { return header_; }
+    int GetWidth() const { return header_.width; }
+    int GetHeight() const { return header_.height; }
+    int GetFrameCount() const { return header_.frames; }
+    int GetFrameRate() const { return header_.fps; }
+
+    bool HasAudio() const { return (header_.flags & VQA_FLAG_AUDIO) != 0; }
+    int GetSampleRate() const { return header_.sample_rate; }
+    int GetChannels() const { return header_.channels; }
+
+    // Codebooks and pointer scratch, in bytes
+    size_t GetResidentBytes() const;
+
+private:
+    // Handle one chunk (recursing into VQFR/VQFK); sets drawn once the
+    // frame's pointers have been drawn
+    bool Process_Chunk(uint32_t id, const uint8_t* body, uint32_t size,
+                       VqaFrame& frame, bool& drawn);
+
+    // Full codebook, raw or LCW, for the next frame
+    bool Load_Codebook(const uint8_t* body, uint32_t size, bool compressed);
+
+    // One part of a codebook assembled over group_size frames
+    bool Load_Partial_Codebook(const uint8_t* body, uint32_t size, bool compressed);
+
+    bool Load_Palette(const uint8_t* body, uint32_t size, bool compressed, VqaFrame& frame);
+
+    // Unpack a frame's pointers and draw its blocks
+    bool Draw_Pointers(const uint8_t* body, uint32_t size, bool compressed, VqaFrame& frame);
+
+    void Decode_Audio(uint32_t id, const uint8_t* body, uint32_t size, VqaFrame& frame);
+
+    const uint8_t* data_ = nullptr;
+    uint32_t size_ = 0;
+    uint32_t pos_ = 0;                      // Next chunk
+    VqaHeader header_ = {};
+    int frame_index_ = 0;
+
+    int blocks_x_ = 0;                      // Blocks per row
+    int blocks_y_ = 0;
+    int block_size_ = 0;                    // Bytes per codebook entry
+    uint8_t solid_marker_ = 0;              // Pointer high byte meaning one color
+    size_t codebook_capacity_ = 0;
+
+    std::vector<uint8_t> codebook_;         // Drawing this frame
+    std::vector<uint8_t> next_codebook_;    // Completed, used from the next frame
+    bool next_codebook_ready_ = false;
+    std::vector<uint8_t> codebook_parts_;   // Partial codebook so far
+    int parts_loaded_ = 0;
+    bool parts_compressed_ = false;
+    std::vector<uint8_t> pointers_;         // Low bytes, then high bytes
+    uint8_t palette_[768] = {};
+
+    WwAdpcmState audio_state_[2];           // IMA state per channel, across chunks
+};
+
+#endif // GAME_VIDEO_VQA_DECODER_H
@@ -0,0 +1,154 @@
+/**
+ * VqaPlayer - Streaming VQA Movie Playback
+ *
+ * Plays a VQA straight out of its MIX archive. A worker thread decodes
+ * ahead into a small ring of FRAME_RING frames and stops when the ring
+ * is full; the main thread's Update() hands the sound to a platform
+ * stream and shows whichever frame is due, dropping any it is too late
+ * for. Memory stays at the ring, the decoder's codebooks and about
+ * AUDIO_LEAD_MS of sound, however long the movie runs.
+ *
+ * Frames are timed by the sound actually played when the movie has any,
+ * and by the wall clock otherwise (or once the sound has run out).
+ *
+ * Usage:
+ *   VqaPlayer player;
+ *   if (player.Open("ALLY1.VQA")) {
+ *       while (player.Update()) { Poll_Input(); Platform_Delay(5); }
+ *   }
+ *
+ * Or Vqa_Play("ALLY1.VQA") to play one through with ESC to skip.
+ */
+
+#ifndef GAME_VIDEO_VQA_PLAYER_H
+#define GAME_VIDEO_VQA_PLAYER_H
+
+#include "game/mix_view.h"
+#include "game/video/vqa_decoder.h"
+#include "platform.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class VqaPlayer {
+public:
+    // Frames decoded ahead of the one on screen
+    static constexpr int FRAME_RING = 4;
+
+    // Sound queued on the platform stream
+    static constexpr int AUDIO_LEAD_MS = 500;
+
+    VqaPlayer() = default;
+    ~VqaPlayer() { Close(); }
+
+    VqaPlayer(const VqaPlayer&) = delete;
+    VqaPlayer& operator=(const VqaPlayer&) = delete;
+
+    /**
+     * Map a movie from the MIX archives and start decoding it
+     *
+     * @return false if the file is missing or not a playable VQA
+     */
+    bool Open(const char* filename);
+
+    /**
+     * Play a movie already in memory; data must outlive the player
+     */
+    bool OpenMemory(const uint8_t* data, uint32_t size);
+
+    /**
+     * Stop the decoder thread and the sound, and unmap the movie
+     */
+    void Close();
+
+    bool IsOpen() const { return decoder_.IsOpen(); }
+
+    /**
+     * Feed the sound stream and show the frame that is due, if any
+     *
+     * Call every few milliseconds; it never waits on the decoder.
+     *
+     * @return false once the movie has finished
+     */
+    bool Update();
+
+    // Every frame shown or dropped and the sound played out
+    bool IsFinished() const;
+
+    /**
+     * Oldest decoded frame not yet released, or nullptr if the decoder
+     * has not got that far. Update() does this itself; for callers that
+     * draw frames their own way.
+     */
+    const VqaFrame* PeekFrame();
+
+    // Hand the frame from PeekFrame() back to the decoder
+    void ReleaseFrame();
+
+    int GetFramesShown() const { return frames_shown_; }
+    int GetFramesDropped() const { return frames_dropped_; }
+    const VqaHeader& GetHeader() const { return decoder_.GetHeader(); }
+
+    // Frame ring, codebooks and queued sound, in bytes (not the movie
+    // file itself, which stays mapped)
+    size_t GetResidentBytes();
+
+    void SetVolume(float volume);
+
+private:
+    bool Start();
+    void Decode_Loop();
+
+    // Move decoded sound onto the platform stream as it has room
+    void Feed_Audio();
+
+    // Playback position in ms
+    double Clock_Ms();
+
+    void Present(const VqaFrame& frame);
+
+    MixView view_;
+    VqaDecoder decoder_;
+
+    // Ring of decoded frames; slot i % FRAME_RING holds frame i. The
+    // worker owns slots at or past decoded_, the main thread the rest.
+    VqaFrame slots_[FRAME_RING];
+    int decoded_ = 0;
+    int consumed_ = 0;
+    bool decode_done_ = false;
+    bool stop_ = false;
+    size_t decoder_bytes_ = 0;
+
+    // Sound decoded with the frames and not yet on the stream
+    std::vector<int16_t> audio_queue_;
+    size_t audio_read_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ring_cv_;
+    std::thread worker_;
+
+    PlayHandle audio_handle_ = INVALID_PLAY_HANDLE;
+    int audio_rate_ = 0;                    // Samples per second, all channels
+    int64_t audio_written_ = 0;
+    bool audio_finished_ = false;
+    float volume_ = 1.0f;
+
+    std::chrono::steady_clock::time_point start_time_;
+    bool started_ = false;
+    int frames_shown_ = 0;
+    int frames_dropped_ = 0;
+    uint8_t shown_palette_[768] = {};
+};
+
+/**
+ * Play a movie through, blocking until it ends or ESC is pressed
+ *
+ * @return false if the movie could not be opened
+ */
+bool Vqa_Play(const char* filename);
+
+#endif // GAME_VIDEO_VQA_PLAYER_H
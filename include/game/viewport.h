@@ -14,6 +14,7 @@
 
 // Include coord.h for COORDINATE, CELL, and related macros (avoid redefinition)
 #include "game/coord.h"
+#include "game/scroll_motion.h"
 
 // =============================================================================
 // Screen Layout Constants
@@ -123,6 +124,16 @@ public:
      */
     void Reset();
 
+    /**
+     * Set the internal screen resolution the layout is built around
+     *
+     * The tactical view becomes the screen minus the sidebar and tab bar,
+     * so larger screens show more of the map. Kept across Initialize().
+     */
+    void SetScreenSize(int screen_width, int screen_height);
+    int GetScreenWidth() const { return screen_width_; }
+    int GetScreenHeight() const { return screen_height_; }
+
     // =========================================================================
     // Map Bounds
     // =========================================================================
@@ -180,7 +191,7 @@ public:
 
     /**
      * Update edge scroll based on mouse position
-     * Call each frame
+     * Call each frame; the speed eases in and out (see ScrollMotion)
      */
     void UpdateEdgeScroll(int mouse_x, int mouse_y);
 
@@ -331,6 +342,10 @@ private:
      */
     int CalculateEdgeScrollSpeed(int distance_into_zone) const;
 
+    // Internal screen resolution (VP_SCREEN_WIDTH x VP_SCREEN_HEIGHT by default)
+    int screen_width_;
+    int screen_height_;
+
     // Map dimensions in cells
     int map_width_;
     int map_height_;
@@ -340,6 +355,8 @@ private:
     int scroll_speed_multiplier_;
     uint8_t current_scroll_direction_;
     int scroll_accel_counter_;
+    ScrollMotion edge_motion_;
+    ScrollMotion keyboard_motion_;
 
     // Target tracking
     bool tracking_enabled_;
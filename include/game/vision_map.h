@@ -0,0 +1,140 @@
+/**
+ * VisionMap - Per-house explored and visible cells as bitplanes
+ *
+ * Each house has two planes of one bit per cell, rounded up to 64-bit
+ * words per map row: explored (ever seen) and visible (seen now). The
+ * planes follow the map size the VisionMap is made with; the standard
+ * 128x128 map is two words per row.
+ *
+ * Technos register their sight with Add_Sight when they enter a cell
+ * and drop it with Remove_Sight when they leave, so nothing happens
+ * while a unit moves within a cell. A house whose sight changed has its
+ * visible plane rebuilt on the next Update by OR-ing one precomputed
+ * circle per sighter into it, a couple of words per row. Rebuilding
+ * rather than clearing the old circle keeps cells another unit of the
+ * same house still watches.
+ *
+ * Original location: CODE/CELL.CPP (IsMapped/IsVisible), CODE/MAP.CPP (Sight_From)
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/house.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// VisionMap
+// =============================================================================
+
+class VisionMap {
+public:
+    /**
+     * Longest sight range in cells; longer requests are clamped
+     */
+    static constexpr int MAX_SIGHT = 15;
+
+    /**
+     * 64-bit words per map row, and per plane, of the standard map
+     */
+    static constexpr int ROW_WORDS = MAP_CELL_WIDTH / 64;
+    static constexpr int PLANE_WORDS = ROW_WORDS * MAP_CELL_HEIGHT;
+
+    explicit VisionMap(int width = MAP_CELL_WIDTH, int height = MAP_CELL_HEIGHT);
+
+    int Get_Width() const { return width_; }
+    int Get_Height() const { return height_; }
+
+    /**
+     * 64-bit words per row, and per plane, of this map
+     */
+    int Get_Row_Words() const { return row_words_; }
+    int Get_Plane_Words() const { return plane_words_; }
+
+    /**
+     * Forget every sighter and everything every house has seen
+     */
+    void Clear();
+
+    /**
+     * Register / drop a sighter of house at cell
+     *
+     * Remove_Sight takes the values Add_Sight was given; removing a
+     * sighter that was never added does nothing.
+     */
+    void Add_Sight(HousesType house, CELL cell, int range);
+    void Remove_Sight(HousesType house, CELL cell, int range);
+
+    /**
+     * Same, by cell X and Y, for maps past 128x128
+     */
+    void Add_Sight(HousesType house, int x, int y, int range);
+    void Remove_Sight(HousesType house, int x, int y, int range);
+
+    /**
+     * Explore a circle for house without a sighter (scenario start, flares)
+     */
+    void Explore(HousesType house, CELL cell, int range);
+    void Explore(HousesType house, int x, int y, int range);
+
+    /**
+     * Restore a house's planes (Get_Plane_Words() words each) from a save
+     *
+     * Sighters are not restored; the technos re-register theirs as they
+     * are placed, and the next Update rebuilds the same visible plane.
+     */
+    void Load_Planes(HousesType house, const uint64_t* visible, const uint64_t* explored);
+
+    /**
+     * Rebuild the visible plane of every house whose sight changed
+     *
+     * @return Bitmask of the houses rebuilt (bit HousesType)
+     */
+    uint32_t Update();
+
+    bool Is_Visible(HousesType house, int x, int y) const { return Test(visible_, house, x, y); }
+    bool Is_Explored(HousesType house, int x, int y) const { return Test(explored_, house, x, y); }
+
+    /**
+     * Get a house's plane (Get_Plane_Words() words, row-major, bit x%64 of word x/64)
+     */
+    const uint64_t* Get_Visible(HousesType house) const { return Plane(visible_, house); }
+    const uint64_t* Get_Explored(HousesType house) const { return Plane(explored_, house); }
+
+    /**
+     * Get number of sighters registered for a house
+     */
+    int Sighter_Count(HousesType house) const { return static_cast<int>(sighters_[house].size()); }
+
+private:
+    struct Sighter {
+        WIDE_CELL cell;
+        int range;
+    };
+
+    static bool Is_House(HousesType house) { return house >= 0 && house < HOUSE_COUNT; }
+
+    uint64_t* Plane(std::vector<uint64_t>& planes, HousesType house) {
+        return planes.data() + static_cast<size_t>(house) * plane_words_;
+    }
+    const uint64_t* Plane(const std::vector<uint64_t>& planes, HousesType house) const {
+        return planes.data() + static_cast<size_t>(house) * plane_words_;
+    }
+    bool Test(const std::vector<uint64_t>& planes, HousesType house, int x, int y) const;
+
+    void Or_Circle(uint64_t* plane, int cx, int cy, int range) const;
+
+    // Half-width of the circle of radius r at row offset dy: span_[r][dy + MAX_SIGHT]
+    int8_t span_[MAX_SIGHT + 1][2 * MAX_SIGHT + 1];
+
+    int width_;
+    int height_;
+    int row_words_;
+    int plane_words_;
+    std::vector<uint64_t> visible_;     // HOUSE_COUNT planes of plane_words_
+    std::vector<uint64_t> explored_;
+    std::vector<Sighter> sighters_[HOUSE_COUNT];
+    uint32_t dirty_;                    // Houses whose sighters changed
+};
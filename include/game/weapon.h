@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "game/fixed.h"
 #include <cstdint>
 
 // =============================================================================
@@ -146,6 +147,11 @@ enum BulletType : int8_t {
  */
 struct WarheadVsArmor {
     int16_t versus[ARMOR_COUNT];  // Damage multiplier per armor type (%)
+
+    /**
+     * Get multiplier against armor as a fixed-point fraction
+     */
+    fixed Modifier(ArmorType armor) const { return fixed::Ratio(versus[armor], 100); }
 };
 
 /**
@@ -0,0 +1,105 @@
+/**
+ * ZoneMap - Connected regions of the map per locomotion
+ *
+ * Every passable cell inside the map bounds carries a zone number; two
+ * cells share a number exactly when a mover of that locomotion can get
+ * from one to the other. Diagonal steps may not cut corners, so zones
+ * are the 4-connected regions of passable cells.
+ *
+ * The map keeps its ZoneMap current as land changes. Opening a cell
+ * joins the zones around it (the smaller ones are relabelled into the
+ * largest); closing one only floods when the cells around it no longer
+ * touch each other locally. Reachability is then one compare.
+ */
+
+#pragma once
+
+#include "game/coord.h"
+#include "game/findpath.h"
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// ZoneMap
+// =============================================================================
+
+class ZoneMap {
+public:
+    static constexpr uint16_t NO_ZONE = 0;
+
+    /**
+     * Locomotions with zones of their own; aircraft reach everywhere
+     */
+    static constexpr int ZONED_COUNT = LOCO_FLY;
+
+    ZoneMap();
+
+    /**
+     * Label every cell from scratch
+     *
+     * @param land Map's land layer (row-major); must outlive this map
+     * @param x0, y0, x1, y1 Inclusive cell rectangle to label
+     */
+    void Rebuild(const uint8_t* land, int x0, int y0, int x1, int y1);
+
+    /**
+     * Ignore land changes until the next Rebuild
+     */
+    void Invalidate() { valid_ = false; }
+
+    bool Is_Valid() const { return valid_; }
+
+    /**
+     * Fix zones after the land layer at (x, y) was rewritten
+     */
+    void Land_Changed(int x, int y, uint8_t old_land, uint8_t new_land);
+
+    /**
+     * Get zone of a cell (NO_ZONE if blocked, out of bounds or not labelled)
+     */
+    uint16_t Get_Zone(LocomotionType loco, int x, int y) const;
+
+    /**
+     * Can a mover standing on from get to to?
+     *
+     * A mover standing on a blocked cell may step off to any open side.
+     * Answers true while the zones are not valid, so callers fall back
+     * to searching.
+     */
+    bool Can_Reach(LocomotionType loco, CELL from, CELL to) const;
+
+    /**
+     * Get number of non-empty zones
+     */
+    int Zone_Count(LocomotionType loco) const;
+
+    /**
+     * Get cells relabelled by incremental updates since the last Rebuild
+     */
+    uint32_t Get_Relabelled() const { return relabelled_; }
+
+private:
+    struct Layer {
+        std::vector<uint16_t> zone;     // Row-major, like CellLayers
+        std::vector<uint32_t> size;     // Cells per zone number
+    };
+
+    bool In_Bounds(int x, int y) const { return x >= x0_ && x <= x1_ && y >= y0_ && y <= y1_; }
+    bool Is_Open(int loco, int x, int y) const;
+    uint16_t New_Zone(Layer& layer);
+    uint32_t Relabel(int loco, int seed, uint16_t zone);
+    void Cell_Opened(int loco, int x, int y);
+    void Cell_Closed(int loco, int x, int y, uint16_t zone);
+
+    bool valid_;
+    const uint8_t* land_;
+    int x0_, y0_, x1_, y1_;
+    bool open_[ZONED_COUNT][256];       // By land layer byte
+    Layer layers_[ZONED_COUNT];
+    uint32_t relabelled_;
+
+    // Flood scratch
+    std::vector<uint16_t> queue_;
+    std::vector<uint32_t> mark_;
+    uint32_t mark_gen_;
+};
@@ -33,6 +33,31 @@
  */
 #define LCW_COMPRESSED 2
 
+/**
+ * Fill `width` x `height` at (x, y) with `color`; lines are 1-pixel fills
+ */
+#define PLATFORM_BLIT_FILL 0
+
+/**
+ * Copy from `src` (opaque)
+ */
+#define PLATFORM_BLIT_COPY 1
+
+/**
+ * Copy from `src`, skipping pixels equal to `color`
+ */
+#define PLATFORM_BLIT_COPY_TRANS 2
+
+/**
+ * Remap the destination rectangle through the 256-byte table at `src`
+ */
+#define PLATFORM_BLIT_REMAP 3
+
+/**
+ * Remap, leaving color 0 alone
+ */
+#define PLATFORM_BLIT_REMAP_TRANS 4
+
 /**
  * Default shadow intensity (50% darkness)
  */
@@ -55,12 +80,58 @@
 
 #define RSA_CRYPT_BLOCK_SIZE 40
 
+/**
+ * Caller tags the game can set; higher values are folded into the last
+ */
+#define IO_TAG_COUNT 16
+
+/**
+ * Returned by `create` on failure
+ */
+#define INVALID_CURSOR_HANDLE -1
+
+/**
+ * Events held between polls; older ones are dropped past this
+ */
+#define EVENT_QUEUE_CAPACITY 256
+
+/**
+ * Platform_Alloc flag: pin a `PLATFORM_MEM_HUGE_PAGES` block in RAM
+ */
+#define PLATFORM_MEM_LOCK 2
+
+/**
+ * Platform_Alloc flag: back the block with 2 MB pages where the OS allows,
+ * falling back to ordinary memory
+ */
+#define PLATFORM_MEM_HUGE_PAGES 8
+
+/**
+ * Port beacons and queries are sent to
+ */
+#define DISCOVERY_PORT 5554
+
+/**
+ * Games the cache holds
+ */
+#define MAX_DISCOVERED_GAMES 64
+
+/**
+ * Longest session name carried in a beacon (not counting the NUL)
+ */
+#define MAX_SESSION_NAME 31
+
 /**
  * Magic number for packet validation
  * Original: 0xDABD for serial, various for network
  */
 #define PACKET_MAGIC 49374
 
+/**
+ * Header flag: the payload is compressed (see compress.rs)
+ */
+#define PACKET_FLAG_COMPRESSED 1
+
 /**
  * Initial CRC value for streaming calculation
  */
@@ -76,6 +147,18 @@ typedef enum FileMode {
   FILE_MODE_APPEND = 4,
 } FileMode;
 
+/**
+ * Kind of input event
+ */
+typedef enum InputEventType {
+  INPUT_EVENT_TYPE_KEY_DOWN = 0,
+  INPUT_EVENT_TYPE_KEY_UP = 1,
+  INPUT_EVENT_TYPE_MOUSE_DOWN = 2,
+  INPUT_EVENT_TYPE_MOUSE_UP = 3,
+  INPUT_EVENT_TYPE_MOUSE_MOVE = 4,
+  INPUT_EVENT_TYPE_MOUSE_WHEEL = 5,
+} InputEventType;
+
 /**
  * Key codes (matching Windows VK_* values for compatibility)
  */
@@ -155,6 +238,11 @@ typedef enum SeekOrigin {
   SEEK_ORIGIN_END = 2,
 } SeekOrigin;
 
+/**
+ * LAN game browser and advertiser, serviced on its own thread
+ */
+typedef struct LanDiscovery LanDiscovery;
+
 /**
  * Network Manager
  *
@@ -162,6 +250,20 @@ typedef enum SeekOrigin {
  */
 typedef struct NetworkManager NetworkManager;
 
+/**
+ * A host or client serviced on its own thread
+ *
+ * Owned by the game thread. Sends queue to the thread; received packets
+ * wait in a ring until read.
+ */
+typedef struct NetworkThread NetworkThread;
+
+/**
+ * Standalone conditioner for C++ tests: packets go in with a time, come
+ * out once due
+ */
+typedef struct PacketConditioner PacketConditioner;
+
 /**
  * Platform network client
  *
@@ -186,6 +288,11 @@ typedef struct PlatformFile PlatformFile;
  */
 typedef struct PlatformHost PlatformHost;
 
+/**
+ * Opaque handle to a loaded PCX image
+ */
+typedef struct PlatformPcx PlatformPcx;
+
 /**
  * Opaque handle to a loaded shape file
  */
@@ -196,11 +303,6 @@ typedef struct PlatformShape PlatformShape;
  */
 typedef struct PlatformTemplate PlatformTemplate;
 
-/**
- * Opaque handle to a loaded PCX image
- */
-typedef struct PlatformPcx PlatformPcx;
-
 /**
  * Display mode configuration
  */
@@ -219,6 +321,56 @@ typedef struct PaletteEntry {
   uint8_t b;
 } PaletteEntry;
 
+/**
+ * Clipping rectangle for blit operations
+ *
+ * Used to define source regions and handle clipping to destination bounds.
+ */
+typedef struct ClipRect {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+} ClipRect;
+
+/**
+ * CPU-side timing of the last flip, in microseconds
+ *
+ * SDL_Renderer has no GPU timer queries, so each stage is bracketed with
+ * host timestamps. `present_us` includes the vsync wait and any driver
+ * stall, so a large value points at presentation rather than drawing.
+ */
+typedef struct FlipTiming {
+  /**
+   * Palette conversion of the back buffer
+   */
+  uint32_t convert_us;
+  /**
+   * Streaming texture upload
+   */
+  uint32_t upload_us;
+  /**
+   * Canvas clear and scaled texture copy
+   */
+  uint32_t scale_us;
+  /**
+   * SDL_RenderPresent (includes vsync)
+   */
+  uint32_t present_us;
+  /**
+   * Whole flip
+   */
+  uint32_t total_us;
+  /**
+   * Flips measured so far
+   */
+  uint32_t flip_count;
+  /**
+   * Back buffer pixels converted and uploaded by the last flip
+   */
+  uint32_t pixels_converted;
+} FlipTiming;
+
 /**
  * Opaque surface handle for C
  */
@@ -226,6 +378,21 @@ typedef struct PlatformSurface {
   uint8_t _private[0];
 } PlatformSurface;
 
+/**
+ * Timestamped input event, as queued for Platform_Input_PollEvents
+ *
+ * `code` is the KeyCode or MouseButton; `x`/`y` the mouse position (the
+ * wheel delta in `y` for MouseWheel). `time_us` is when the platform saw
+ * the event, on the Platform_Input_GetTimeUs clock.
+ */
+typedef struct InputEvent {
+  enum InputEventType kind;
+  int32_t code;
+  int32_t x;
+  int32_t y;
+  uint64_t time_us;
+} InputEvent;
+
 /**
  * Timer handle
  */
@@ -236,6 +403,48 @@ typedef int32_t TimerHandle;
  */
 typedef void (*CTimerCallback)(void*);
 
+/**
+ * How regularly frames have been ending, over the last PACING_HISTORY
+ *
+ * An interval is the time from one end_frame() return to the next, so
+ * it is what the display sees, pacing wait included.
+ */
+typedef struct FramePacingStats {
+  /**
+   * Last frame interval (ms)
+   */
+  double last_ms;
+  /**
+   * Mean frame interval (ms)
+   */
+  double mean_ms;
+  /**
+   * Standard deviation of the frame interval (ms)
+   */
+  double stddev_ms;
+  /**
+   * Shortest and longest frame interval (ms)
+   */
+  double min_ms;
+  double max_ms;
+  /**
+   * Mean time sleep returned past its wake-up time (us)
+   */
+  double sleep_overshoot_us;
+  /**
+   * Mean time spun per frame (us)
+   */
+  double spin_us;
+  /**
+   * Frames that ended more than a period past their deadline
+   */
+  uint32_t late_frames;
+  /**
+   * Intervals the stats cover
+   */
+  uint32_t frames;
+} FramePacingStats;
+
 /**
  * Directory entry information
  */
@@ -254,6 +463,32 @@ typedef struct DirEntry {
   int64_t size;
 } DirEntry;
 
+/**
+ * Read counters for one tag, source or entry
+ */
+typedef struct PlatformIoStats {
+  /**
+   * Read calls
+   */
+  uint64_t calls;
+  /**
+   * Bytes read
+   */
+  uint64_t bytes;
+  /**
+   * Time spent inside the read calls, nanoseconds
+   */
+  uint64_t blocked_ns;
+  /**
+   * Calls that read an entry already read this session
+   */
+  uint64_t repeat_calls;
+  /**
+   * Bytes those repeated reads read again
+   */
+  uint64_t repeat_bytes;
+} PlatformIoStats;
+
 /**
  * Audio configuration
  */
@@ -264,6 +499,51 @@ typedef struct AudioConfig {
   int32_t buffer_size;
 } AudioConfig;
 
+/**
+ * Mixer-side timing of sound effects and streamed sounds
+ *
+ * rodio owns the device callback, so the part we can time is our own:
+ * each block of sound effects the mixer sums, and each stream refill it
+ * performs while filling an output buffer (the lock on the game's queue
+ * plus the copy). Long refills mean the mixer thread is being starved;
+ * underruns with short refills mean the game isn't queuing far enough
+ * ahead.
+ */
+typedef struct AudioMixerStats {
+  /**
+   * Streams that ran dry before being finished (heard as a gap)
+   */
+  uint32_t underruns;
+  /**
+   * Stream buffers refilled by the mixer
+   */
+  uint32_t buffers;
+  /**
+   * Last refill, microseconds
+   */
+  uint32_t last_buffer_us;
+  /**
+   * Longest refill since the previous read of the stats
+   */
+  uint32_t max_buffer_us;
+  /**
+   * All refills, microseconds
+   */
+  uint64_t total_buffer_us;
+  /**
+   * Sound effect voices in the last mixed block
+   */
+  uint32_t mix_voices;
+  /**
+   * Last sound effect block (MIX_BLOCK_FRAMES), microseconds
+   */
+  uint32_t last_mix_us;
+  /**
+   * Longest sound effect block since the previous read of the stats
+   */
+  uint32_t max_mix_us;
+} AudioMixerStats;
+
 /**
  * Sound handle type
  */
@@ -275,16 +555,312 @@ typedef int32_t SoundHandle;
 typedef int32_t PlayHandle;
 
 /**
- * Clipping rectangle for blit operations
+ * One operation of a batch
  *
- * Used to define source regions and handle clipping to destination bounds.
+ * `x`, `y`, `width` and `height` are the destination rectangle. Copies
+ * read `width` x `height` from (`src_x`, `src_y`) in `src`; the `src_*`
+ * sizes are ignored by fills and remaps.
  */
-typedef struct ClipRect {
+typedef struct PlatformBlitOp {
+  uint8_t kind;
+  /**
+   * Fill color, or transparent key for copies
+   */
+  uint8_t color;
+  uint16_t reserved;
   int32_t x;
   int32_t y;
   int32_t width;
   int32_t height;
-} ClipRect;
+  /**
+   * Source pixels (copies) or remap table (remaps)
+   */
+  const uint8_t *src;
+  int32_t src_pitch;
+  int32_t src_width;
+  int32_t src_height;
+  int32_t src_x;
+  int32_t src_y;
+} PlatformBlitOp;
+
+/**
+ * Read position within a batch payload, for Platform_Packet_NextBatchMessage
+ */
+typedef struct BatchCursor {
+  /**
+   * Byte offset of the next message (start at 0)
+   */
+  uint32_t offset;
+  /**
+   * Handle of the previous message (start at 0)
+   */
+  uint32_t handle;
+} BatchCursor;
+
+/**
+ * Packet descriptor filled by the batch receive calls
+ *
+ * `data` points into the receive arena and is valid until the batch is
+ * released.
+ */
+typedef struct PacketView {
+  /**
+   * Packet bytes
+   */
+  const uint8_t *data;
+  /**
+   * Packet size in bytes
+   */
+  uint32_t size;
+  /**
+   * Index of the peer that sent the packet (0 = host, for clients)
+   */
+  uint32_t peer_index;
+  /**
+   * Channel the packet was received on
+   */
+  uint8_t channel;
+} PacketView;
+
+/**
+ * Link conditions to simulate (all zero = a perfect link)
+ */
+typedef struct NetConditions {
+  /**
+   * One-way delay added to every packet
+   */
+  uint32_t latency_ms;
+  /**
+   * Random extra delay, up to this much, per packet
+   */
+  uint32_t jitter_ms;
+  /**
+   * Chance a packet is lost, in percent
+   */
+  uint32_t loss_percent;
+  /**
+   * Chance an unreliable packet is held back past later ones, in percent
+   */
+  uint32_t reorder_percent;
+  /**
+   * Link speed in kilobits per second (0 = unlimited)
+   */
+  uint32_t bandwidth_kbps;
+  /**
+   * Random seed (0 picks a fixed default)
+   */
+  uint32_t seed;
+} NetConditions;
+
+/**
+ * What a conditioner did to the traffic through it
+ */
+typedef struct ConditionerStats {
+  /**
+   * Packets submitted
+   */
+  uint64_t packets_in;
+  /**
+   * Packets handed back out
+   */
+  uint64_t packets_out;
+  /**
+   * Bytes handed back out
+   */
+  uint64_t bytes_out;
+  /**
+   * Unreliable packets lost, or dropped at a full bandwidth backlog
+   */
+  uint64_t dropped;
+  /**
+   * Reliable packets delayed by a simulated resend
+   */
+  uint64_t retransmitted;
+  /**
+   * Unreliable packets held back past later ones
+   */
+  uint64_t reordered;
+  /**
+   * Packets waiting to be released
+   */
+  uint32_t queued;
+} ConditionerStats;
+
+/**
+ * What a hosted game advertises
+ */
+typedef struct SessionBeacon {
+  /**
+   * Session name, NUL-terminated
+   */
+  uint8_t name[MAX_SESSION_NAME + 1];
+  /**
+   * CRC of the scenario being played
+   */
+  uint32_t map_crc;
+  /**
+   * Game build; joining across versions desyncs
+   */
+  uint32_t version;
+  /**
+   * Port the game is hosted on
+   */
+  uint16_t port;
+  /**
+   * Players in the session
+   */
+  uint8_t players;
+  /**
+   * Player slots
+   */
+  uint8_t max_players;
+} SessionBeacon;
+
+/**
+ * A game found on the LAN
+ */
+typedef struct DiscoveredGame {
+  /**
+   * The beacon as last received
+   */
+  struct SessionBeacon beacon;
+  /**
+   * Host address in dotted form, NUL-terminated (for JoinGame)
+   */
+  uint8_t address[16];
+  /**
+   * Time since the last beacon, milliseconds
+   */
+  uint32_t age_ms;
+} DiscoveredGame;
+
+/**
+ * Frame delay and stall statistics
+ */
+typedef struct FrameDelayStats {
+  /**
+   * Ticks between issuing a command and executing it
+   */
+  uint32_t frame_delay;
+  /**
+   * Delay the current round trip estimates call for
+   */
+  uint32_t target_delay;
+  /**
+   * Smoothed round trip time of the slowest peer, microseconds
+   */
+  uint32_t rtt_us;
+  /**
+   * Round trip deviation of the slowest peer, microseconds
+   */
+  uint32_t jitter_us;
+  /**
+   * Peers with a current estimate
+   */
+  uint32_t peer_count;
+  /**
+   * Number of stalls reported
+   */
+  uint32_t stall_count;
+  /**
+   * Total time spent stalled, microseconds
+   */
+  uint64_t stall_us;
+  /**
+   * Length of the most recent stall, microseconds
+   */
+  uint64_t last_stall_us;
+} FrameDelayStats;
+
+/**
+ * Traffic through the manager
+ *
+ * Counts game data handed to and received from enet, pings included;
+ * enet's own headers, acks and resends are not counted. A host broadcast
+ * counts once per peer.
+ */
+typedef struct TrafficStats {
+  /**
+   * Bytes received per second, over the last full second
+   */
+  uint32_t bytes_in_per_sec;
+  /**
+   * Bytes sent per second, over the last full second
+   */
+  uint32_t bytes_out_per_sec;
+  /**
+   * Packets received per second
+   */
+  uint32_t packets_in_per_sec;
+  /**
+   * Packets sent per second
+   */
+  uint32_t packets_out_per_sec;
+  /**
+   * Bytes received this session
+   */
+  uint64_t bytes_in;
+  /**
+   * Bytes sent this session
+   */
+  uint64_t bytes_out;
+  /**
+   * Bytes payload compression kept off the wire this session
+   */
+  uint64_t bytes_out_saved;
+} TrafficStats;
+
+/**
+ * Round trip and loss figures for one peer
+ */
+typedef struct PeerLatencyStats {
+  /**
+   * Peer identifier (its ping token)
+   */
+  uint32_t peer_id;
+  /**
+   * Smoothed round trip time, microseconds
+   */
+  uint32_t rtt_us;
+  /**
+   * Round trip deviation, microseconds
+   */
+  uint32_t jitter_us;
+  /**
+   * Pings unanswered over the last 64, in tenths of a percent
+   */
+  uint32_t loss_permille;
+} PeerLatencyStats;
+
+/**
+ * Service thread counters
+ */
+typedef struct NetThreadStats {
+  /**
+   * Packets handed to the game
+   */
+  uint32_t packets_received;
+  /**
+   * Packets passed to enet
+   */
+  uint32_t packets_sent;
+  /**
+   * Sends refused because the outgoing ring was full
+   */
+  uint32_t send_overflows;
+  /**
+   * Arrival-to-read time of the last packet read, microseconds
+   */
+  uint32_t last_queue_delay_us;
+  /**
+   * Longest arrival-to-read time, microseconds
+   */
+  uint32_t max_queue_delay_us;
+  /**
+   * Smoothed variation between packet inter-arrival times, microseconds
+   */
+  uint32_t jitter_us;
+} NetThreadStats;
 
 #define INVALID_SOUND_HANDLE -1
 
@@ -447,9 +1023,9 @@ int32_t Platform_GetCachePath(char *buffer, int32_t buffer_size);
  * - -1 on error
  *
  * # Search Order
- * 1. App bundle Resources/data/
- * 2. ./data/
- * 3. ../data/
+ * 1. App bundle Resources/gamedata/
+ * 2. ./gamedata/
+ * 3. ../gamedata/
  */
 int32_t Platform_GetDataPath(char *buffer, int32_t buffer_size);
 
@@ -548,6 +1124,56 @@ void Platform_Graphics_Shutdown(void);
  */
 bool Platform_Graphics_IsInitialized(void);
 
+/**
+ * Run graphics without a window at the next Platform_Graphics_Init
+ *
+ * The back buffer is plain memory and a flip only converts it through
+ * the palette, so drawing and palette effects can run on machines with no
+ * display or GPU. The PLATFORM_HEADLESS environment variable does the
+ * same for programs that don't call this.
+ *
+ * # Safety
+ * - `dump_dir` must be null or a valid null-terminated C string; when
+ *   given, every flip writes the frame there as frame_NNNNNN.png
+ */
+void Platform_Graphics_SetHeadless(bool headless, const char *dump_dir);
+
+/**
+ * Check if graphics is running without a window
+ */
+bool Platform_Graphics_IsHeadless(void);
+
+/**
+ * Present through a GPU palette shader from the next Platform_Graphics_Init
+ *
+ * The back buffer is uploaded as 8-bit indices and the palette as a
+ * 256x1 texture; a fragment shader does the lookup while scaling. Palette
+ * animation and fades then cost a 1 KB upload instead of a reconversion.
+ * Falls back to CPU conversion when OpenGL 2.1 is not available. The
+ * PLATFORM_GPU_PALETTE environment variable does the same for programs
+ * that don't call this.
+ */
+void Platform_Graphics_SetGpuPalette(bool enabled);
+
+/**
+ * Check if flips present through the GPU palette shader
+ */
+bool Platform_Graphics_IsGpuPalette(void);
+
+/**
+ * Set the internal resolution from the next Platform_Graphics_Init
+ *
+ * The back buffer, screen texture and palette conversion all take this
+ * size; the window opens at 2x for sizes up to 960x600 and at 1x above.
+ * The PLATFORM_RESOLUTION environment variable ("1920x1080") does the
+ * same for programs that don't call this.
+ *
+ * # Returns
+ * - 0 on success
+ * - -1 if the size is outside 320x200..3840x2160
+ */
+int32_t Platform_Graphics_SetResolution(int32_t width, int32_t height);
+
 /**
  * Clear screen with color (for testing)
  */
@@ -607,6 +1233,23 @@ void Platform_Graphics_RestorePalette(void);
  */
 int32_t Platform_Graphics_Flip(void);
 
+/**
+ * Flip only the given back buffer rectangles to screen
+ *
+ * Converts and uploads just those regions; the rest of the screen keeps
+ * the previous frame. Rects are clipped to the screen. count == 0 presents
+ * the previous frame unchanged. Does a full flip on the first frame and
+ * after palette changes.
+ */
+int32_t Platform_Graphics_FlipRects(const struct ClipRect *rects, int32_t count);
+
+/**
+ * Get CPU-side timing of the last flip (convert, upload, scale, present)
+ *
+ * Returns 0 on success, -1 if graphics is not initialized or timing is null.
+ */
+int32_t Platform_Graphics_GetFlipTiming(struct FlipTiming *timing);
+
 /**
  * Wait for vertical sync (no-op, handled by SDL)
  */
@@ -632,6 +1275,19 @@ bool Platform_Graphics_IsHardwareAccelerated(void);
  */
 bool Platform_PollEvents(void);
 
+/**
+ * Events Platform_PollEvents has handled so far, window exposes included;
+ * a change since the last look means the screen may need drawing again
+ */
+uint32_t Platform_GetEventCount(void);
+
+/**
+ * Sleep until an event is queued or timeout_ms passes
+ *
+ * The event stays queued for Platform_PollEvents. Returns true if one is.
+ */
+bool Platform_WaitEvents(uint32_t timeout_ms);
+
 /**
  * Get tick count in milliseconds since SDL init
  */
@@ -728,6 +1384,25 @@ void Platform_Input_Update(void);
  */
 bool Platform_Input_ShouldQuit(void);
 
+/**
+ * Turn the input event queue on or off (it starts empty either way)
+ */
+void Platform_Input_EnableEvents(bool enabled);
+
+/**
+ * Move up to max queued input events into events, oldest first
+ *
+ * Returns the number written, or -1 if events were dropped since the last
+ * poll; the queue is then empty and the caller should resync from the
+ * Platform_Key_IsPressed / Platform_Mouse_* state.
+ */
+int32_t Platform_Input_PollEvents(struct InputEvent *events, int32_t max);
+
+/**
+ * Current time on the input event clock, in microseconds
+ */
+uint64_t Platform_Input_GetTimeUs(void);
+
 /**
  * Check if key is currently pressed
  */
@@ -813,6 +1488,32 @@ void Platform_Mouse_Show(void);
  */
 void Platform_Mouse_Hide(void);
 
+/**
+ * Create a hardware colour cursor from ARGB8888 pixels (alpha 0 = clear)
+ *
+ * Returns a handle for Platform_Cursor_Set, or -1 on failure.
+ */
+int32_t Platform_Cursor_Create(const uint32_t *pixels,
+                               int32_t width,
+                               int32_t height,
+                               int32_t hot_x,
+                               int32_t hot_y);
+
+/**
+ * Make a hardware cursor current (also shows the cursor)
+ */
+bool Platform_Cursor_Set(int32_t handle);
+
+/**
+ * Return to the system arrow cursor
+ */
+void Platform_Cursor_SetDefault(void);
+
+/**
+ * Free a hardware cursor
+ */
+void Platform_Cursor_Destroy(int32_t handle);
+
 /**
  * Get milliseconds since platform init
  */
@@ -860,15 +1561,57 @@ TimerHandle Platform_Timer_InvalidHandle(void);
 void Platform_Frame_Begin(void);
 
 /**
- * End frame timing (sleeps to maintain target FPS)
+ * End frame timing: waits for the frame's deadline to hold the target FPS,
+ * sleeping most of the way and spinning the rest
  */
 void Platform_Frame_End(void);
 
 /**
- * Set target FPS
+ * Set target FPS (starts the pacing stats over)
  */
 void Platform_Frame_SetTargetFPS(uint32_t fps);
 
+/**
+ * Get target FPS
+ */
+uint32_t Platform_Frame_GetTargetFPS(void);
+
+/**
+ * Turn the Platform_Frame_End sleep on or off, for callers that pace
+ * frames themselves (FPS is still measured)
+ */
+void Platform_Frame_SetLimiter(bool enabled);
+
+/**
+ * Set how much of the Platform_Frame_End wait is spun rather than
+ * slept, in microseconds (0 sleeps all of it)
+ */
+void Platform_Frame_SetSpinThreshold(uint32_t us);
+
+/**
+ * Get the spin threshold in microseconds
+ */
+uint32_t Platform_Frame_GetSpinThreshold(void);
+
+/**
+ * Tell the pacer presents wait for vsync at this refresh rate (0 = they
+ * don't). Graphics init sets this from the display.
+ */
+void Platform_Frame_SetVSyncRefresh(uint32_t hz);
+
+/**
+ * Get the refresh rate the pacer assumes presents wait for (0 = none)
+ */
+uint32_t Platform_Frame_GetVSyncRefresh(void);
+
+/**
+ * Get frame interval regularity over the recent frames
+ *
+ * # Safety
+ * `stats` must be null or point to a writable FramePacingStats
+ */
+void Platform_Frame_GetPacingStats(struct FramePacingStats *stats);
+
 /**
  * Get last frame time in seconds
  */
@@ -919,6 +1662,11 @@ uintptr_t Platform_Mem_GetPeak(void);
  */
 uintptr_t Platform_Mem_GetCount(void);
 
+/**
+ * Get bytes currently mapped on large pages (PLATFORM_MEM_HUGE_PAGES)
+ */
+uintptr_t Platform_Mem_GetLargePageBytes(void);
+
 /**
  * Dump leaks (debug only)
  */
@@ -1034,6 +1782,31 @@ bool Platform_File_Delete(const char *path);
  */
 int64_t Platform_File_Copy(const char *src, const char *dst);
 
+/**
+ * Map a whole file read-only
+ *
+ * Each call makes a new mapping (a full read where mapping is not
+ * supported). The pointer stays valid until Platform_File_Unmap().
+ *
+ * # Safety
+ * - `path` must be a valid null-terminated C string
+ * - `out_size` must be a valid pointer
+ *
+ * # Returns
+ * - Pointer to the file bytes, with the size in `out_size`
+ * - null if missing, empty, or on error (`out_size` set to 0)
+ */
+const uint8_t *Platform_File_Map(const char *path, int64_t *out_size);
+
+/**
+ * Release a pointer returned by Platform_File_Map
+ *
+ * # Safety
+ * - `data` must be null or a pointer returned by Platform_File_Map that
+ *   has not been unmapped yet
+ */
+void Platform_File_Unmap(const uint8_t *data);
+
 /**
  * Open a directory for iteration
  */
@@ -1064,6 +1837,71 @@ bool Platform_CreateDirectory(const char *path);
  */
 bool Platform_DeleteDirectory(const char *path);
 
+/**
+ * Set the caller tag that this thread's file and MIX reads are charged to
+ *
+ * # Returns
+ * - The previous tag, so scopes can restore it
+ */
+int32_t Platform_Io_SetTag(int32_t tag);
+
+/**
+ * Turn I/O accounting on or off (on by default)
+ */
+void Platform_Io_SetEnabled(bool enabled);
+
+/**
+ * Forget all recorded reads, archives and repeats
+ */
+void Platform_Io_Reset(void);
+
+/**
+ * Get the reads charged to one caller tag
+ *
+ * # Returns
+ * - 0 on success, -1 on a null pointer or out-of-range tag
+ */
+int32_t Platform_Io_GetTagStats(int32_t tag, struct PlatformIoStats *out);
+
+/**
+ * Get all reads recorded since the last reset
+ */
+int32_t Platform_Io_GetTotals(struct PlatformIoStats *out);
+
+/**
+ * Number of sources read from: MIX archives by path, plus "(files)"
+ */
+int32_t Platform_Io_GetSourceCount(void);
+
+/**
+ * Get a source's name and reads, in the order first read from
+ *
+ * # Returns
+ * - 0 on success, -1 if `index` is out of range
+ */
+int32_t Platform_Io_GetSourceStats(int32_t index,
+                                   struct PlatformIoStats *out,
+                                   char *name,
+                                   int32_t name_size);
+
+/**
+ * Number of entries read more than once since the last reset
+ */
+int32_t Platform_Io_GetRepeatCount(void);
+
+/**
+ * Get an entry read more than once, most bytes re-read first
+ *
+ * # Returns
+ * - 0 on success, -1 if `index` is out of range
+ */
+int32_t Platform_Io_GetRepeat(int32_t index,
+                              struct PlatformIoStats *out,
+                              char *source,
+                              int32_t source_size,
+                              char *entry,
+                              int32_t entry_size);
+
 /**
  * Initialize audio subsystem
  */
@@ -1089,6 +1927,12 @@ void Platform_Audio_SetMasterVolume(float volume);
  */
 float Platform_Audio_GetMasterVolume(void);
 
+/**
+ * Get mixer statistics for sound effects and streamed sounds; the peaks
+ * restart from each call. Returns 0 on success, -1 if stats is null.
+ */
+int32_t Platform_Audio_GetMixerStats(struct AudioMixerStats *stats);
+
 /**
  * Create a sound from raw PCM data in memory
  */
@@ -1148,6 +1992,30 @@ void Platform_Sound_Resume(PlayHandle handle);
  */
 int32_t Platform_Sound_GetPlayingCount(void);
 
+/**
+ * Start a streamed sound holding up to `capacity` queued 16-bit samples.
+ * Stop, volume, pause and resume use the Platform_Sound_* calls.
+ */
+PlayHandle Platform_Stream_Open(int32_t sample_rate,
+                                int32_t channels,
+                                int32_t capacity,
+                                float volume);
+
+/**
+ * Queue interleaved samples on a stream; returns how many were taken
+ */
+int32_t Platform_Stream_Write(PlayHandle handle, const int16_t *samples, int32_t count);
+
+/**
+ * Get the number of samples queued on a stream and not yet played
+ */
+int32_t Platform_Stream_GetQueued(PlayHandle handle);
+
+/**
+ * Mark a stream complete; it stops once its queued samples have played
+ */
+void Platform_Stream_Finish(PlayHandle handle);
+
 /**
  * Create a sound from ADPCM compressed data
  */
@@ -1166,6 +2034,18 @@ SoundHandle Platform_Sound_CreateFromADPCMWithState(const void *data,
                                                     int32_t predictor,
                                                     int32_t step_index);
 
+/**
+ * Create a sound from ADPCM data that stays compressed in memory: each
+ * play decodes it, from the given decoder state, as it is mixed. Takes
+ * the same arguments as Platform_Sound_CreateFromADPCMWithState.
+ */
+SoundHandle Platform_Sound_CreateCompressedADPCM(const void *data,
+                                                 int32_t size,
+                                                 int32_t sample_rate,
+                                                 int32_t channels,
+                                                 int32_t predictor,
+                                                 int32_t step_index);
+
 /**
  * Clear buffer with a single value
  *
@@ -1220,6 +2100,25 @@ void Platform_Buffer_VLine(uint8_t *buffer,
                            int32_t length,
                            uint8_t color);
 
+/**
+ * Run a batch of fills, copies and remaps on one buffer
+ *
+ * The destination is checked once for the whole batch; ops run in order,
+ * each clipped to the buffer.
+ *
+ * # Safety
+ * - `dest` must point to valid memory of at least `pitch * height` bytes
+ * - `ops` must point to `count` ops
+ * - Each copy's `src` must point to `src_pitch * src_height` bytes and
+ *   each remap's `src` to 256 bytes
+ */
+void Platform_Buffer_Execute(uint8_t *dest,
+                             int32_t pitch,
+                             int32_t width,
+                             int32_t height,
+                             const struct PlatformBlitOp *ops,
+                             int32_t count);
+
 /**
  * Blit from source buffer to destination (opaque)
  *
@@ -1334,6 +2233,49 @@ void Platform_Buffer_RemapCopy(uint8_t *dest,
                                int32_t height,
                                const uint8_t *remap_table);
 
+/**
+ * Remap from source to destination, skipping source color 0
+ *
+ * The house-color blit: 16 pixels at a time are tested for transparency.
+ *
+ * # Safety
+ * Same as Platform_Buffer_RemapCopy
+ */
+void Platform_Buffer_RemapCopyTrans(uint8_t *dest,
+                                    int32_t dest_pitch,
+                                    int32_t dest_x,
+                                    int32_t dest_y,
+                                    const uint8_t *src,
+                                    int32_t src_pitch,
+                                    int32_t src_x,
+                                    int32_t src_y,
+                                    int32_t width,
+                                    int32_t height,
+                                    const uint8_t *remap_table);
+
+/**
+ * Darken destination pixels through a shadow table where a mask is non-zero
+ *
+ * The shadow-mask counterpart of Platform_Buffer_RemapCopyTrans: the
+ * lookup is on the destination pixel, the source only says where.
+ *
+ * # Safety
+ * - `dest` must point to valid memory of at least `dest_pitch * (dest_y + height)` bytes
+ * - `mask` must point to valid memory of at least `mask_pitch * (mask_y + height)` bytes
+ * - `shadow_table` must point to exactly 256 bytes
+ */
+void Platform_Buffer_RemapShadow(uint8_t *dest,
+                                 int32_t dest_pitch,
+                                 int32_t dest_x,
+                                 int32_t dest_y,
+                                 const uint8_t *mask,
+                                 int32_t mask_pitch,
+                                 int32_t mask_x,
+                                 int32_t mask_y,
+                                 int32_t width,
+                                 int32_t height,
+                                 const uint8_t *shadow_table);
+
 /**
  * Scale buffer using nearest-neighbor interpolation
  *
@@ -1393,6 +2335,30 @@ void Platform_Buffer_ScaleTransKey(uint8_t *dest,
                                    int32_t scale_height,
                                    uint8_t transparent_color);
 
+/**
+ * Scale a 32-bit ARGB image with sharp bilinear filtering
+ *
+ * Pixels stay square blocks with blended edges; whole factors on both
+ * axes replicate pixels. Pitches are in bytes and must be multiples of 4.
+ *
+ * # Safety
+ * - `dest` must point to valid memory of at least `dest_pitch * dest_height` bytes
+ * - `src` must point to valid memory of at least `src_pitch * src_height` bytes
+ * - Both must be 4-byte aligned
+ */
+void Platform_Buffer_ScaleSharp(uint32_t *dest,
+                                int32_t dest_pitch,
+                                int32_t dest_width,
+                                int32_t dest_height,
+                                const uint32_t *src,
+                                int32_t src_pitch,
+                                int32_t src_width,
+                                int32_t src_height,
+                                int32_t dest_x,
+                                int32_t dest_y,
+                                int32_t scale_width,
+                                int32_t scale_height);
+
 /**
  * Apply shadow to rectangular region
  *
@@ -1411,9 +2377,12 @@ void Platform_Buffer_Shadow(uint8_t *buffer,
 /**
  * Apply shadow using mask sprite
  *
+ * The mask may be a window into a larger buffer (`mask_pitch` wider
+ * than `width`); its last row is only read `width` bytes in.
+ *
  * # Safety
  * - `buffer` must point to valid memory
- * - `mask` must point to valid memory of at least `mask_pitch * height` bytes
+ * - `mask` must point to valid memory of at least `mask_pitch * (height - 1) + width` bytes
  * - `shadow_table` must point to exactly 256 bytes
  */
 void Platform_Buffer_ShadowMask(uint8_t *buffer,
@@ -1544,6 +2513,17 @@ uint32_t Platform_Westwood_CRC(const uint8_t *data, int32_t size);
  */
 uint32_t Platform_Westwood_CRC_Filename(const char *filename);
 
+/**
+ * Hash data to 64 bits for cache keys and state checksums.
+ *
+ * Much faster than either CRC on anything past a few bytes, but matches
+ * no Westwood format; never use it for MIX lookups or saved data.
+ *
+ * # Safety
+ * - `data` must point to valid memory of at least `size` bytes
+ */
+uint64_t Platform_Hash64(const uint8_t *data, int32_t size, uint64_t seed);
+
 /**
  * Seed the global random number generator
  */
@@ -1579,6 +2559,9 @@ int32_t Platform_Assets_Init(void);
 /**
  * Register a MIX file with the asset system
  *
+ * Encrypted indices are cached under the platform cache directory and
+ * reused while the file's size, mtime and header CRC are unchanged.
+ *
  * # Safety
  * - `path` must be a valid null-terminated C string
  *
@@ -1654,27 +2637,72 @@ int32_t Platform_Mix_Read(const char *filename, uint8_t *buffer, int32_t buffer_
  */
 int32_t Platform_Mix_GetSize(const char *filename);
 
+/**
+ * Map file data from MIX archives without copying
+ *
+ * Returns a read-only pointer straight into the archive: the cached data
+ * for cached archives, otherwise a memory map of the MIX file shared by
+ * all of its entries. The pointer stays valid until Platform_Mix_Unmap(),
+ * even if the archive is uncached or unregistered in the meantime.
+ *
+ * # Safety
+ * - `filename` must be a valid null-terminated C string
+ * - `out_size` must be a valid pointer
+ *
+ * # Returns
+ * - Pointer to the file data, with its size in `out_size`
+ * - null if not found, empty, or on error (`out_size` set to 0)
+ */
+const uint8_t *Platform_Mix_Map(const char *filename, int32_t *out_size);
+
+/**
+ * Release a pointer returned by Platform_Mix_Map
+ *
+ * # Safety
+ * - `data` must be null or a pointer returned by Platform_Mix_Map that
+ *   has not been unmapped yet
+ */
+void Platform_Mix_Unmap(const uint8_t *data);
+
 /**
  * Get number of registered MIX files
  */
 int32_t Platform_Mix_GetCount(void);
 
+/**
+ * Get the bytes held by cached MIX data
+ */
+uintptr_t Platform_Mix_GetCachedBytes(void);
+
+/**
+ * Drop cached data of MIX files that can be re-read from disk
+ *
+ * # Returns
+ * - Bytes released
+ */
+uintptr_t Platform_Mix_ReleaseCaches(void);
+
 /**
  * Register a nested MIX file
  *
- * Extracts a MIX file that's stored inside another registered MIX file
+ * This extracts a MIX file that's stored inside another registered MIX file
  * and registers it so its contents can be accessed.
  *
  * For example, MAIN.MIX contains conquer.mix and local.mix which need to be
- * extracted and registered to access their contents like TITLE.PCX.
+ * extracted and registered to access their contents.
+ *
+ * # Safety
+ * - `nested_name` must be a valid null-terminated C string
  *
- * @param nested_name Name of the nested MIX file (e.g., "local.mix")
- * @return Number of files in the nested MIX on success, 0 if not found, -1 on error
+ * # Returns
+ * - Number of files in the nested MIX on success
+ * - 0 if nested MIX not found
+ * - -1 on error
  */
 int32_t Platform_Mix_RegisterNested(const char *nested_name);
 
 /**
- * Debug: Dump all entries in all registered MIX files to stderr
+ * Debug: Dump all entries in all registered MIX files
  *
  * This is for debugging hash lookup issues.
  */
@@ -1775,6 +2803,28 @@ int32_t Platform_Shape_GetFrame(const struct PlatformShape *shape,
                                 uint8_t *buffer,
                                 int32_t buffer_size);
 
+/**
+ * Decode consecutive frames into one buffer
+ *
+ * Frames are written back to back, width * height bytes each, starting
+ * with `first_frame`. Walking frames in order lets each XOR delta frame
+ * use the frame already written before it, so decoding a whole shape is
+ * a single pass.
+ *
+ * # Safety
+ * - `shape` must be a valid shape pointer
+ * - `buffer` must point to at least `buffer_size` bytes
+ *
+ * # Returns
+ * - Number of frames decoded (up to `frame_count`, as many as fit)
+ * - -1 on error
+ */
+int32_t Platform_Shape_DecodeRange(const struct PlatformShape *shape,
+                                   int32_t first_frame,
+                                   int32_t frame_count,
+                                   uint8_t *buffer,
+                                   int32_t buffer_size);
+
 /**
  * Load a template file from raw data
  *
@@ -1833,10 +2883,6 @@ int32_t Platform_Template_GetTile(const struct PlatformTemplate *template_,
                                   uint8_t *buffer,
                                   int32_t buffer_size);
 
-// =============================================================================
-// PCX Image Loading
-// =============================================================================
-
 /**
  * Load a PCX image from MIX archives
  *
@@ -1891,7 +2937,7 @@ void Platform_PCX_GetSize(const struct PlatformPcx *pcx, int32_t *width, int32_t
 int32_t Platform_PCX_GetPixels(const struct PlatformPcx *pcx, uint8_t *buffer, int32_t buffer_size);
 
 /**
- * Get PCX palette data (768 bytes, 256 RGB triplets)
+ * Get PCX palette data
  *
  * # Safety
  * - `pcx` must be a valid PCX pointer
@@ -2072,10 +3118,36 @@ int32_t Platform_Log_GetLevel(void);
  * Flush log buffer to disk
  *
  * Call this periodically or before program exit to ensure
- * all log messages are written to the file.
+ * all log messages are written to the file. In async mode it also
+ * waits until the writer thread has written every line logged
+ * before the call.
  */
 void Platform_Log_Flush(void);
 
+/**
+ * Turn async logging on or off
+ *
+ * On, log calls only format into a lock-free ring of preallocated
+ * records and a background thread writes them out in batches;
+ * Platform_Log_Flush waits for it. A full ring drops lines rather than
+ * block (see Platform_Log_GetDropped).
+ *
+ * # Returns
+ * - 0 on success
+ * - -1 if the writer thread could not be started
+ */
+int32_t Platform_Log_SetAsync(int32_t enabled);
+
+/**
+ * Whether async logging is on (1) or off (0)
+ */
+int32_t Platform_Log_IsAsync(void);
+
+/**
+ * Lines dropped because the async ring was full, since startup
+ */
+uint64_t Platform_Log_GetDropped(void);
+
 /**
  * Initialize the network subsystem
  *
@@ -2100,6 +3172,28 @@ void Platform_Network_Shutdown(void);
  */
 int32_t Platform_Network_IsInitialized(void);
 
+/**
+ * Read the next message from a batch payload
+ *
+ * # Arguments
+ * * `payload` - Batch payload (from Platform_Packet_GetPayload)
+ * * `size` - Payload size
+ * * `cursor` - Read position, zeroed before the first call and advanced
+ * * `out_code` - Output: message code
+ * * `out_handle` - Output: message handle
+ * * `out_body_size` - Output: body size
+ *
+ * # Returns
+ * * Pointer to the message body (inside `payload`)
+ * * null at the end of the payload, on a malformed message or on error
+ */
+const uint8_t *Platform_Packet_NextBatchMessage(const uint8_t *payload,
+                                                int32_t size,
+                                                struct BatchCursor *cursor,
+                                                uint8_t *out_code,
+                                                uint32_t *out_handle,
+                                                int32_t *out_body_size);
+
 /**
  * Create a new network client
  *
@@ -2220,6 +3314,32 @@ int32_t Platform_Client_Receive(struct PlatformClient *client,
                                 uint8_t *buffer,
                                 int32_t buffer_size);
 
+/**
+ * Receive waiting packets without copying them
+ *
+ * Fills `packets` with descriptors pointing into the client's receive
+ * arena. The data stays valid until Platform_Client_ReleaseBatch; call
+ * that once per frame after handling the packets. Calling again before
+ * the release continues through the same batch.
+ *
+ * # Arguments
+ * * `client` - Client pointer
+ * * `packets` - Descriptor array to fill
+ * * `max_packets` - Capacity of `packets`
+ *
+ * # Returns
+ * * Number of descriptors written (0 if no packets)
+ * * -1: error
+ */
+int32_t Platform_Client_ReceiveBatch(struct PlatformClient *client,
+                                     struct PacketView *packets,
+                                     int32_t max_packets);
+
+/**
+ * Release the packets returned by Platform_Client_ReceiveBatch
+ */
+void Platform_Client_ReleaseBatch(struct PlatformClient *client);
+
 /**
  * Check if client has packets waiting
  */
@@ -2235,6 +3355,88 @@ void Platform_Client_Disconnect(struct PlatformClient *client);
  */
 void Platform_Client_Flush(struct PlatformClient *client);
 
+/**
+ * Create a conditioner; null conditions mean a perfect link
+ */
+struct PacketConditioner *Platform_Conditioner_Create(const struct NetConditions *conditions);
+
+void Platform_Conditioner_Destroy(struct PacketConditioner *conditioner);
+
+/**
+ * Change the simulated conditions; held packets keep their release times
+ */
+void Platform_Conditioner_SetConditions(struct PacketConditioner *conditioner,
+                                        const struct NetConditions *conditions);
+
+/**
+ * Put a packet on the simulated link at `now_us`
+ *
+ * Returns 0 if it will be delivered, 1 if it was lost, -1 on error
+ */
+int32_t Platform_Conditioner_Submit(struct PacketConditioner *conditioner,
+                                    uint64_t now_us,
+                                    uint8_t channel,
+                                    const uint8_t *data,
+                                    int32_t size,
+                                    int32_t reliable);
+
+/**
+ * Take the next packet due by `now_us`
+ *
+ * Returns its size (0 if none is due), or -1 on error or if `buffer` is
+ * too small; a packet that doesn't fit is dropped.
+ */
+int32_t Platform_Conditioner_Receive(struct PacketConditioner *conditioner,
+                                     uint64_t now_us,
+                                     uint8_t *buffer,
+                                     int32_t buffer_size,
+                                     uint8_t *channel);
+
+/**
+ * Time the next held packet is due, or 0 if none is held
+ */
+uint64_t Platform_Conditioner_NextRelease(struct PacketConditioner *conditioner);
+
+/**
+ * Returns 0 on success, -1 on error
+ */
+int32_t Platform_Conditioner_GetStats(struct PacketConditioner *conditioner,
+                                      struct ConditionerStats *stats);
+
+/**
+ * Start browsing the LAN for games
+ *
+ * # Returns
+ * * Pointer to LanDiscovery on success
+ * * null if no socket could be bound
+ */
+struct LanDiscovery *Platform_Discovery_Start(void);
+
+/**
+ * Stop browsing and advertising, and free the discovery
+ */
+void Platform_Discovery_Stop(struct LanDiscovery *discovery);
+
+/**
+ * Advertise a hosted game, or stop advertising with a null beacon
+ */
+void Platform_Discovery_Advertise(struct LanDiscovery *discovery,
+                                  const struct SessionBeacon *beacon);
+
+/**
+ * Query for games now instead of at the next interval
+ */
+void Platform_Discovery_Refresh(struct LanDiscovery *discovery);
+
+/**
+ * Copy out the games found so far; never blocks on the network
+ *
+ * Returns games written (at most `max_games`), or -1 on error
+ */
+int32_t Platform_Discovery_GetGames(struct LanDiscovery *discovery,
+                                    struct DiscoveredGame *games,
+                                    int32_t max_games);
+
 /**
  * Create a new network host
  *
@@ -2293,6 +3495,32 @@ int32_t Platform_Host_Receive(struct PlatformHost *host,
                               uint8_t *buffer,
                               int32_t buffer_size);
 
+/**
+ * Receive waiting packets without copying them
+ *
+ * Fills `packets` with descriptors pointing into the host's receive
+ * arena. The data stays valid until Platform_Host_ReleaseBatch; call
+ * that once per frame after handling the packets. Calling again before
+ * the release continues through the same batch.
+ *
+ * # Arguments
+ * * `host` - Host pointer
+ * * `packets` - Descriptor array to fill
+ * * `max_packets` - Capacity of `packets`
+ *
+ * # Returns
+ * * Number of descriptors written (0 if no packets)
+ * * -1: error or null pointers
+ */
+int32_t Platform_Host_ReceiveBatch(struct PlatformHost *host,
+                                   struct PacketView *packets,
+                                   int32_t max_packets);
+
+/**
+ * Release the packets returned by Platform_Host_ReceiveBatch
+ */
+void Platform_Host_ReleaseBatch(struct PlatformHost *host);
+
 /**
  * Check if host has packets waiting
  *
@@ -2435,6 +3663,94 @@ int32_t Platform_NetworkManager_SendData(struct NetworkManager *manager,
                                          int32_t size,
                                          int32_t reliable);
 
+/**
+ * Queue a message for the next Platform_NetworkManager_FlushMessages
+ *
+ * # Arguments
+ * * `channel` - Channel to send on (0 reliable, 1 unreliable)
+ * * `code` - Message code
+ * * `handle` - Unit/object handle (delta-encoded), or 0
+ * * `data` - Message body (may be null when `size` is 0)
+ * * `size` - Body size
+ *
+ * Returns 0 on success, -1 on error
+ */
+int32_t Platform_NetworkManager_QueueMessage(struct NetworkManager *manager,
+                                             uint8_t channel,
+                                             uint8_t code,
+                                             uint32_t handle,
+                                             const uint8_t *data,
+                                             int32_t size);
+
+/**
+ * Send the messages queued this tick and flush
+ *
+ * Returns packets sent, or -1 on error
+ */
+int32_t Platform_NetworkManager_FlushMessages(struct NetworkManager *manager);
+
+/**
+ * Get the lockstep command delay in ticks
+ *
+ * Returns the delay, or -1 on error
+ */
+int32_t Platform_NetworkManager_GetFrameDelay(struct NetworkManager *manager);
+
+/**
+ * Set the simulation tick rate the frame delay is counted in
+ */
+void Platform_NetworkManager_SetTickRate(struct NetworkManager *manager, int32_t ticks_per_second);
+
+/**
+ * Report time the simulation spent waiting for remote commands
+ */
+void Platform_NetworkManager_RecordStall(struct NetworkManager *manager, uint32_t stall_us);
+
+/**
+ * Get frame delay, round trip and stall statistics
+ *
+ * Returns 0 on success, -1 on error
+ */
+int32_t Platform_NetworkManager_GetFrameDelayStats(struct NetworkManager *manager,
+                                                   struct FrameDelayStats *stats);
+
+/**
+ * Enable or disable compressing outgoing game packets (on by default)
+ */
+void Platform_NetworkManager_SetCompression(struct NetworkManager *manager, int32_t enabled);
+
+/**
+ * Simulate a bad link on everything the session receives (testing
+ * only); null conditions go back to the real link
+ */
+void Platform_NetworkManager_SetConditions(struct NetworkManager *manager,
+                                           const struct NetConditions *conditions);
+
+/**
+ * Get what the simulated link has done
+ *
+ * Returns 0 on success, -1 on error or if no conditions are set
+ */
+int32_t Platform_NetworkManager_GetConditionerStats(struct NetworkManager *manager,
+                                                    struct ConditionerStats *stats);
+
+/**
+ * Get traffic rates and totals
+ *
+ * Returns 0 on success, -1 on error
+ */
+int32_t Platform_NetworkManager_GetTrafficStats(struct NetworkManager *manager,
+                                                struct TrafficStats *stats);
+
+/**
+ * Get round trip, jitter and loss for each peer heard from recently
+ *
+ * Returns entries written (at most `max_peers`), or -1 on error
+ */
+int32_t Platform_NetworkManager_GetPeerStats(struct NetworkManager *manager,
+                                             struct PeerLatencyStats *stats,
+                                             int32_t max_peers);
+
 /**
  * Receive data
  *
@@ -2493,7 +3809,8 @@ int32_t Platform_Packet_ParseHeader(const uint8_t *data,
 /**
  * Get pointer to payload data within a packet
  *
- * Returns pointer to payload start, or null on error
+ * Returns pointer to payload start, or null on error or if the payload
+ * is compressed (use Platform_Packet_DecodePayload for those)
  * Sets out_payload_size to payload size
  */
 const uint8_t *Platform_Packet_GetPayload(const uint8_t *data,
@@ -2513,6 +3830,131 @@ int32_t Platform_Packet_Build(uint8_t code,
                               uint8_t *out_buffer,
                               int32_t buffer_size);
 
+/**
+ * Build a packet like Platform_Packet_Build, compressing the payload
+ * when that makes it smaller
+ *
+ * The packet goes out raw otherwise, so the buffer must still fit the
+ * uncompressed packet.
+ *
+ * Returns bytes written, or -1 on error
+ */
+int32_t Platform_Packet_BuildCompressed(uint8_t code,
+                                        uint32_t sequence,
+                                        uint8_t player_id,
+                                        const uint8_t *payload,
+                                        int32_t payload_size,
+                                        uint8_t *out_buffer,
+                                        int32_t buffer_size);
+
+/**
+ * Copy a packet's payload out, decompressing it if flagged
+ *
+ * Works on raw packets too, so receivers can use it for everything.
+ *
+ * Returns payload bytes written, or -1 on error (bad header, corrupt
+ * payload, or a buffer too small for it)
+ */
+int32_t Platform_Packet_DecodePayload(const uint8_t *data,
+                                      int32_t size,
+                                      uint8_t *out_payload,
+                                      int32_t payload_capacity);
+
+/**
+ * Start a network thread hosting a game
+ *
+ * # Returns
+ * * Pointer to NetworkThread on success
+ * * null on failure
+ */
+struct NetworkThread *Platform_NetThread_StartHost(uint16_t port,
+                                                   int32_t max_clients,
+                                                   int32_t channel_count);
+
+/**
+ * Start a network thread connecting to a server
+ *
+ * Poll Platform_NetThread_GetStatus for the connection result.
+ *
+ * # Returns
+ * * Pointer to NetworkThread on success
+ * * null on failure
+ */
+struct NetworkThread *Platform_NetThread_StartClient(const char *address, uint16_t port);
+
+/**
+ * Stop a network thread and free it
+ *
+ * # Safety
+ * * `thread` must be a valid pointer from Platform_NetThread_Start*
+ */
+void Platform_NetThread_Stop(struct NetworkThread *thread);
+
+/**
+ * Get the thread status
+ *
+ * # Returns
+ * * 0 = Starting, 1 = Connecting, 2 = Running, 3 = Failed,
+ *   4 = Disconnected, 5 = Stopped
+ * * -1 on error
+ */
+int32_t Platform_NetThread_GetStatus(struct NetworkThread *thread);
+
+/**
+ * Queue a packet for the thread to send (broadcast when hosting)
+ *
+ * # Returns
+ * * 0 on success
+ * * -1 if the outgoing ring is full or on error
+ */
+int32_t Platform_NetThread_Send(struct NetworkThread *thread,
+                                uint8_t channel,
+                                const uint8_t *data,
+                                int32_t size,
+                                int32_t reliable);
+
+/**
+ * Receive the next packet
+ *
+ * # Arguments
+ * * `thread` - Thread pointer
+ * * `peer_index` - Output: sending peer
+ * * `channel` - Output: channel received on
+ * * `arrival_us` - Output: arrival time on the Platform_Input_GetTimeUs clock
+ * * `buffer` - Buffer to copy packet data into
+ * * `buffer_size` - Size of buffer
+ *
+ * # Returns
+ * * Positive: bytes copied (truncated to fit)
+ * * 0: no packet available
+ * * -1: error
+ */
+int32_t Platform_NetThread_Receive(struct NetworkThread *thread,
+                                   uint32_t *peer_index,
+                                   uint8_t *channel,
+                                   uint64_t *arrival_us,
+                                   uint8_t *buffer,
+                                   int32_t buffer_size);
+
+/**
+ * Number of received packets waiting
+ */
+int32_t Platform_NetThread_PacketCount(struct NetworkThread *thread);
+
+/**
+ * Number of connected peers
+ */
+int32_t Platform_NetThread_PeerCount(struct NetworkThread *thread);
+
+/**
+ * Read the thread's counters
+ *
+ * # Returns
+ * * 0 on success
+ * * -1 on error
+ */
+int32_t Platform_NetThread_GetStats(struct NetworkThread *thread, struct NetThreadStats *stats);
+
 /**
  * Get current FPS
  *
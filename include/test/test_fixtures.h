@@ -6,8 +6,76 @@
 #define TEST_FIXTURES_H
 
 #include "test/test_framework.h"
+#include "platform.h"
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Test Environment - Platform State Shared by the Whole Process
+//=============================================================================
+
+/// The platform, graphics, audio and MIX files are brought up the first
+/// time a test asks for them and stay up until the process ends. Between
+/// tests Reset() puts them back to how init left them (blank back buffer,
+/// the palette and resolution init set, no sounds playing, no keys held),
+/// which costs microseconds where a shutdown and init costs a window and
+/// an audio device. Tests that shut the platform down themselves are
+/// fine: the next Require*() notices and brings it back.
+///
+/// TEST_ISOLATED=1 (--isolated) shuts everything down after every test
+/// instead, for chasing state that leaks from one test into the next.
+class TestEnvironment {
+public:
+    static TestEnvironment& Instance();
+
+    /// Bring a subsystem up if it isn't; true if it is up afterwards
+    bool RequirePlatform();
+    bool RequireGraphics();
+    bool RequireAudio();
+    bool RequireAssets();
+
+    /// Register a MIX file once, from the working directory, gamedata/ or data/
+    bool RequireMix(const char* name);
+    bool IsMixLoaded(const char* name) const;
+
+    /// Put what is up back to its state right after init
+    void Reset();
+
+    /// End of a fixture test: Reset(), or Shutdown() when isolated
+    void Release();
+
+    /// Shut everything down; runs by itself when the test process ends
+    void Shutdown();
+
+    bool IsIsolated() const { return isolated_; }
+    void SetIsolated(bool isolated) { isolated_ = isolated; }
+
+    /// Full subsystem inits and fast resets so far
+    int GetInitCount() const { return init_count_; }
+    int GetResetCount() const { return reset_count_; }
+
+private:
+    TestEnvironment();
+
+    void ForgetAssets();
+
+    bool teardown_registered_ = false;
+    bool isolated_ = false;
+    bool assets_initialized_ = false;
+    std::vector<std::string> mixes_;    // Names passed to RequireMix that loaded
+
+    // Graphics and audio as init left them
+    PaletteEntry palette_[256];
+    int width_ = 0;
+    int height_ = 0;
+    float master_volume_ = 1.0f;
+
+    int init_count_ = 0;
+    int reset_count_ = 0;
+};
 
 //=============================================================================
 // Base Test Fixture
@@ -23,6 +91,10 @@ public:
     /// Called after each test (even on failure)
     virtual void TearDown() {}
 
+    /// Called before each test after the first when the fixture is shared
+    /// by a suite or the process (TEST_WITH_SUITE_FIXTURE and friends)
+    virtual void Reset() {}
+
 protected:
     TestFixture() = default;
 };
@@ -35,6 +107,7 @@ class PlatformFixture : public TestFixture {
 public:
     void SetUp() override;
     void TearDown() override;
+    void Reset() override;
 
     /// Check if platform initialized successfully
     bool IsInitialized() const { return initialized_; }
@@ -105,6 +178,9 @@ public:
     /// Check if a specific MIX file is loaded
     bool IsMixLoaded(const char* mix_name) const;
 
+    /// Register a MIX file for this and later tests (see TestEnvironment)
+    bool LoadMix(const char* mix_name);
+
 protected:
     bool assets_loaded_ = false;
 };
@@ -162,4 +238,102 @@ protected:
     } g_test_registrar_##test_name; \
     static void TestFunc_##test_name(fixture_class& fixture)
 
+//=============================================================================
+// Shared Fixtures
+//=============================================================================
+
+/// One fixture per category: set up by the category's first test, reset
+/// before each later one, and torn down when the runner leaves the category
+template <typename Fixture>
+class SuiteFixture {
+public:
+    static Fixture& Get(const std::string& category) {
+        auto& fixtures = Fixtures();
+        auto it = fixtures.find(category);
+        if (it != fixtures.end()) {
+            it->second->Reset();
+            return *it->second;
+        }
+        Fixture* fixture = new Fixture();
+        fixtures[category].reset(fixture);
+        TestRegistry::Instance().AddSuiteTeardown(category, [category]() {
+            auto& all = Fixtures();
+            auto found = all.find(category);
+            if (found != all.end()) {
+                found->second->TearDown();
+                all.erase(found);
+            }
+        });
+        fixture->SetUp();
+        return *fixture;
+    }
+
+private:
+    static std::map<std::string, std::unique_ptr<Fixture>>& Fixtures() {
+        static std::map<std::string, std::unique_ptr<Fixture>> fixtures;
+        return fixtures;
+    }
+};
+
+/// One fixture for the whole test process: set up by the first test that
+/// uses it, reset before each later one, torn down when the process ends
+template <typename Fixture>
+class ProcessFixture {
+public:
+    static Fixture& Get() {
+        auto& fixture = Instance();
+        if (fixture) {
+            fixture->Reset();
+            return *fixture;
+        }
+        fixture.reset(new Fixture());
+        TestRegistry::Instance().AddProcessTeardown([]() {
+            auto& current = Instance();
+            if (current) {
+                current->TearDown();
+                current.reset();
+            }
+        });
+        fixture->SetUp();
+        return *fixture;
+    }
+
+private:
+    static std::unique_ptr<Fixture>& Instance() {
+        static std::unique_ptr<Fixture> fixture;
+        return fixture;
+    }
+};
+
+#define TEST_SHARED_FIXTURE_REGISTRAR(test_name, test_category) \
+    static struct TestRegistrar_##test_name { \
+        TestRegistrar_##test_name() { \
+            TestCaseInfo info; \
+            info.name = #test_name; \
+            info.category = test_category; \
+            info.file = __FILE__; \
+            info.line = __LINE__; \
+            info.timeout_ms = 0; \
+            TestRegistry::Instance().RegisterTest(info, TestWrapper_##test_name); \
+        } \
+    } g_test_registrar_##test_name;
+
+/// Define a test that shares one fixture with the rest of its category
+#define TEST_WITH_SUITE_FIXTURE(fixture_class, test_name, test_category) \
+    static void TestFunc_##test_name(fixture_class& fixture); \
+    static void TestWrapper_##test_name() { \
+        TestFunc_##test_name(SuiteFixture<fixture_class>::Get(test_category)); \
+    } \
+    TEST_SHARED_FIXTURE_REGISTRAR(test_name, test_category) \
+    static void TestFunc_##test_name(fixture_class& fixture)
+
+/// Define a test that shares one fixture with every test in the process
+#define TEST_WITH_PROCESS_FIXTURE(fixture_class, test_name, test_category) \
+    static void TestFunc_##test_name(fixture_class& fixture); \
+    static void TestWrapper_##test_name() { \
+        TestFunc_##test_name(ProcessFixture<fixture_class>::Get()); \
+    } \
+    TEST_SHARED_FIXTURE_REGISTRAR(test_name, test_category) \
+    static void TestFunc_##test_name(fixture_class& fixture)
+
 #endif // TEST_FIXTURES_H
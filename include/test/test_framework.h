@@ -23,7 +23,8 @@ enum class TestResult {
     FAILED,
     SKIPPED,
     TIMEOUT,
-    CRASHED
+    CRASHED,
+    PERF_FAIL    // Passed, but slower than its TEST_PERF_BUDGET
 };
 
 const char* TestResult_ToString(TestResult result);
@@ -40,6 +41,14 @@ struct TestCaseInfo {
     uint32_t timeout_ms;  // 0 = default timeout
 };
 
+/// A measurement a test reports for baselining, one sample per recording
+struct TestMetric {
+    std::string name;             // Unique within the test, e.g. "Sim/1000"
+    std::string unit;             // "ms", "fps", ...
+    bool higher_is_better;        // Throughputs and rates; times are lower
+    std::vector<double> samples;
+};
+
 struct TestCaseResult {
     TestCaseInfo info;
     TestResult result;
@@ -47,6 +56,7 @@ struct TestCaseResult {
     double duration_ms;       // Execution time
     std::string failure_file; // File where assertion failed
     int failure_line;         // Line where assertion failed
+    std::vector<TestMetric> metrics;  // Recorded with TEST_METRIC
 };
 
 //=============================================================================
@@ -82,9 +92,23 @@ public:
     /// Clear all tests (for testing the framework itself)
     void Clear();
 
+    /// Run a function when the runner leaves a category (suite-scoped fixtures)
+    void AddSuiteTeardown(const std::string& category, std::function<void()> func);
+
+    /// Run and drop the teardowns of a category, newest first
+    void EndSuite(const std::string& category);
+
+    /// Run a function once when the test process is done (process-scoped fixtures)
+    void AddProcessTeardown(std::function<void()> func);
+
+    /// Run and drop the process teardowns, newest first
+    void EndProcess();
+
 private:
     TestRegistry() = default;
     std::vector<std::pair<TestCaseInfo, TestFunction>> tests_;
+    std::map<std::string, std::vector<std::function<void()>>> suite_teardowns_;
+    std::vector<std::function<void()>> process_teardowns_;
 };
 
 //=============================================================================
@@ -115,6 +139,13 @@ private:
     std::string reason_;
 };
 
+/// Thrown by TEST_PERF_BUDGET when the work is over its budget
+class TestPerfFailed : public TestAssertionFailed {
+public:
+    TestPerfFailed(const std::string& message, const char* file, int line)
+        : TestAssertionFailed(message, file, line) {}
+};
+
 //=============================================================================
 // Test Runner Configuration
 //=============================================================================
@@ -129,12 +160,15 @@ struct TestRunnerConfig {
     bool verbose = false;         // Detailed output
     bool quiet = false;           // Minimal output
     std::string xml_output;       // Output JUnit XML to file
+    std::string json_output;      // Output results and metrics as JSON
 
     // Execution
     uint32_t default_timeout_ms = 30000;  // 30 second default
     bool stop_on_failure = false;         // Stop after first failure
     bool shuffle = false;                 // Randomize test order
     uint32_t shuffle_seed = 0;            // Seed for shuffle (0 = random)
+    int repeat = 1;                       // Runs per test, metrics pooled
+    int jobs = 1;                         // Worker processes, 0 = one per core
 
     // Parse from command line arguments
     bool ParseArgs(int argc, char* argv[]);
@@ -145,6 +179,8 @@ struct TestRunnerConfig {
 // Test Runner
 //=============================================================================
 
+class TestReporter;
+
 class TestRunner {
 public:
     explicit TestRunner(const TestRunnerConfig& config = TestRunnerConfig());
@@ -170,13 +206,67 @@ private:
     int passed_ = 0;
     int failed_ = 0;
     int skipped_ = 0;
+    std::string current_suite_;   // Category whose suite fixtures are live
 
     TestCaseResult RunSingleTest(const TestCaseInfo& info, TestFunction func);
+    TestCaseResult RunRepeated(const TestCaseInfo& info, TestFunction func);
+    void CountResult(const TestCaseResult& result);
+
+    /// Moving on to a test of another category ends the suite fixtures
+    /// of the one before
+    void EnterSuite(const std::string& category);
+    void EndSuite();
+
+    /// Run tests in worker processes, a whole category to a worker so
+    /// tests sharing singletons never run concurrently; results are merged
+    /// back in registration order. Returns false if workers can't be used.
+    bool RunParallel(const std::vector<std::pair<TestCaseInfo, TestFunction>>& tests,
+                     TestReporter& reporter);
     void ReportProgress(const TestCaseResult& result);
     void ReportSummary();
     void WriteXmlReport();
 };
 
+//=============================================================================
+// Test Metrics
+//=============================================================================
+
+/// Record one sample of a metric for the running test. Samples of the same
+/// name accumulate, across --repeat runs too, and go to the JSON report.
+void Test_Record_Metric(const std::string& name, double value,
+                        const char* unit, bool higher_is_better = false);
+
+//=============================================================================
+// Performance Budgets
+//=============================================================================
+
+/// Time the speed kernel takes on the reference machine budgets are
+/// written against (optimized build)
+constexpr double TEST_PERF_REFERENCE_KERNEL_MS = 8.0;
+
+/// How much slower than the reference machine this host runs a fixed
+/// reference kernel (2.0 = half the speed). Measured once per process;
+/// the kernel is built like the tests, so an unoptimized build gets a
+/// larger factor too.
+double Test_Host_Speed_Factor();
+
+/// Time one run of work() and fail the test with PERF_FAIL if it took
+/// longer than budget_ms scaled by Test_Host_Speed_Factor().
+///
+/// Calibrate, then measure: one warm-up run, then the batch of runs is
+/// doubled until it lasts a few milliseconds, and the median per-run time
+/// of several batches is what counts. It is recorded as a metric, so
+/// --json baselines pick it up. TEST_PERF_SLACK (--perf-slack) multiplies
+/// every budget; 0 measures without gating, as do builds without NDEBUG
+/// unless a slack is given.
+void Test_Perf_Budget(const std::string& name, double budget_ms,
+                      const std::function<void()>& work,
+                      const char* file, int line);
+
+/// e.g. TEST_PERF_BUDGET("Draw10k", 12.0, [&]() { for (...) Draw(...); });
+#define TEST_PERF_BUDGET(name, budget_ms, work) \
+    Test_Perf_Budget(name, budget_ms, work, __FILE__, __LINE__)
+
 //=============================================================================
 // Test Registration Macro
 //=============================================================================
@@ -340,6 +430,12 @@ private:
         } \
     } while (0)
 
+#define TEST_METRIC(name, value, unit) \
+    Test_Record_Metric(name, value, unit, false)
+
+#define TEST_METRIC_HIGHER(name, value, unit) \
+    Test_Record_Metric(name, value, unit, true)
+
 #define TEST_FAIL(msg) \
     throw TestAssertionFailed(msg, __FILE__, __LINE__)
 
@@ -358,7 +454,9 @@ private:
             return 1; \
         } \
         TestRunner runner(config); \
-        return runner.Run(); \
+        int result = runner.Run(); \
+        TestRegistry::Instance().EndProcess(); \
+        return result; \
     }
 
 #endif // TEST_FRAMEWORK_H
@@ -83,6 +83,21 @@ private:
     std::string EscapeXml(const std::string& str) const;
 };
 
+//=============================================================================
+// JSON Reporter - Results and Metrics for Baseline Comparison
+//=============================================================================
+
+class JsonReporter : public TestReporter {
+public:
+    explicit JsonReporter(const std::string& output_path);
+
+    void OnTestRunComplete(const std::vector<TestCaseResult>& results,
+                          int passed, int failed, int skipped) override;
+
+private:
+    std::string output_path_;
+};
+
 //=============================================================================
 // Multi Reporter - Combine Multiple Reporters
 //=============================================================================
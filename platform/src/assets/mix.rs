@@ -33,13 +33,19 @@
 //! [If has digest: 20-byte SHA-1 hash]
 //! ```
 
+use crate::files::io_stats;
 use std::collections::HashMap;
-use std::fs::File;
+use std::fs::{self, File};
 use std::io::{self, Read, Seek, SeekFrom};
-use std::path::Path;
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
 
+#[cfg(unix)]
+use once_cell::sync::OnceCell;
+
+use super::mix_cache::{self, IndexStamp, MixIndex};
 use crate::crypto::{decrypt_mix_key, BlowfishEngine};
-use crate::util::crc::westwood_crc_filename;
+use crate::util::crc::{crc32, westwood_crc_filename};
 
 /// Size of the RSA-encrypted key block in MIX files
 const RSA_KEY_BLOCK_SIZE: usize = 80;
@@ -148,6 +154,116 @@ impl MixHeader {
     }
 }
 
+/// Read-only memory map of a whole MIX file
+///
+/// Shared by every view into the archive; unmapped when the last owner
+/// (the MixFile or an outstanding MixView) drops it.
+#[cfg(unix)]
+pub struct MappedFile {
+    ptr: *mut libc::c_void,
+    len: usize,
+}
+
+// The mapping is read-only and never remapped
+#[cfg(unix)]
+unsafe impl Send for MappedFile {}
+#[cfg(unix)]
+unsafe impl Sync for MappedFile {}
+
+#[cfg(unix)]
+impl MappedFile {
+    /// Map a file read-only
+    pub fn open(path: &str) -> io::Result<Self> {
+        use std::os::unix::io::AsRawFd;
+
+        let file = File::open(path)?;
+        let len = file.metadata()?.len() as usize;
+        if len == 0 {
+            return Err(io::Error::new(io::ErrorKind::InvalidData, "empty file"));
+        }
+
+        // The mapping outlives the descriptor, so the file can close here
+        let ptr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+
+        Ok(MappedFile { ptr, len })
+    }
+
+    /// Mapped bytes
+    pub fn as_slice(&self) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(self.ptr as *const u8, self.len) }
+    }
+}
+
+#[cfg(unix)]
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        unsafe {
+            libc::munmap(self.ptr, self.len);
+        }
+    }
+}
+
+/// Backing storage of a MixView
+enum MixViewSource {
+    /// Slice of a cached data section
+    Cached(Arc<Vec<u8>>),
+    /// Slice of a memory-mapped archive
+    #[cfg(unix)]
+    Mapped(Arc<MappedFile>),
+    /// Copy read from disk (no mapping available)
+    Owned(Vec<u8>),
+}
+
+/// Read-only view of one file inside a MIX archive
+///
+/// Keeps its backing storage alive, so the bytes stay valid after the
+/// archive is uncached or unregistered.
+pub struct MixView {
+    source: MixViewSource,
+    start: usize,
+    len: usize,
+}
+
+impl MixView {
+    /// File data
+    pub fn as_slice(&self) -> &[u8] {
+        let range = self.start..self.start + self.len;
+        match &self.source {
+            MixViewSource::Cached(data) => &data[range],
+            #[cfg(unix)]
+            MixViewSource::Mapped(map) => &map.as_slice()[range],
+            MixViewSource::Owned(data) => &data[range],
+        }
+    }
+
+    /// File size in bytes
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// True for an empty file
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// True if the view copied the data rather than borrowing it
+    pub fn is_copy(&self) -> bool {
+        matches!(self.source, MixViewSource::Owned(_))
+    }
+}
+
 /// A single MIX archive file
 pub struct MixFile {
     /// Path to the MIX file
@@ -159,7 +275,10 @@ pub struct MixFile {
     /// Offset to start of data section
     data_start: u64,
     /// Optional: cached file data (if loaded into memory)
-    cached_data: Option<Vec<u8>>,
+    cached_data: Option<Arc<Vec<u8>>>,
+    /// Memory map of the archive, created by the first map_entry()
+    #[cfg(unix)]
+    mapping: OnceCell<Option<Arc<MappedFile>>>,
 }
 
 impl MixFile {
@@ -243,21 +362,103 @@ impl MixFile {
             entries,
             data_start,
             cached_data: None,
+            #[cfg(unix)]
+            mapping: OnceCell::new(),
         })
     }
 
+    /// Open a MIX file, reusing a decrypted index from `cache_dir`
+    ///
+    /// A cached index is used only if the file's size and mtime match and
+    /// the CRC of its raw header bytes (key block and encrypted index) is
+    /// unchanged, so the RSA and Blowfish work is skipped entirely on a
+    /// hit. Only encrypted indices are written back; plain ones are cheap
+    /// to parse.
+    pub fn open_cached<P: AsRef<Path>>(path: P, cache_dir: &Path) -> Result<Self, MixError> {
+        let path = path.as_ref();
+        let stamp = IndexStamp::of_file(path)?;
+        let key = fs::canonicalize(path).unwrap_or_else(|_| path.to_path_buf());
+        let cache_file = mix_cache::cache_file(cache_dir, &key.to_string_lossy());
+
+        if let Some((index, crc)) = mix_cache::load(&cache_file, &stamp) {
+            if Self::header_crc(path, index.data_start).ok() == Some(crc) {
+                return Ok(MixFile {
+                    path: path.to_string_lossy().to_string(),
+                    header: index.header,
+                    entries: index.entries,
+                    data_start: index.data_start,
+                    cached_data: None,
+                    #[cfg(unix)]
+                    mapping: OnceCell::new(),
+                });
+            }
+        }
+
+        let mix = Self::open(path)?;
+        if mix.header.is_encrypted {
+            if let Ok(crc) = Self::header_crc(path, mix.data_start) {
+                let index = MixIndex {
+                    header: mix.header.clone(),
+                    entries: mix.entries.clone(),
+                    data_start: mix.data_start,
+                };
+                // A failed write only costs the next launch a decrypt
+                let _ = mix_cache::store(&cache_file, &stamp, &index, crc);
+            }
+        }
+        Ok(mix)
+    }
+
+    /// CRC32 of the bytes before the data section
+    fn header_crc(path: &Path, data_start: u64) -> Result<u32, MixError> {
+        let mut file = File::open(path)?;
+        let mut header = vec![0u8; data_start as usize];
+        file.read_exact(&mut header)?;
+        Ok(crc32(&header))
+    }
+
     /// Create a MIX file from in-memory data
     ///
     /// This is used for nested MIX files extracted from a parent MIX.
     /// The data is kept in memory (cached) since there's no file path.
     pub fn from_data(name: &str, data: Vec<u8>) -> Result<Self, MixError> {
+        let index = Self::read_index_from_data(&data)?;
+        Ok(Self::from_memory_index(name, index, &data))
+    }
+
+    /// Create a MIX file from in-memory data, reusing a cached index
+    ///
+    /// Nested MIX files are keyed by name and validated by size and a CRC
+    /// of their raw header bytes. Only encrypted indices are written back.
+    pub fn from_data_cached(name: &str, data: Vec<u8>, cache_dir: &Path) -> Result<Self, MixError> {
+        let stamp = IndexStamp::of_data(data.len());
+        let cache_file = mix_cache::cache_file(cache_dir, &format!("nested:{}", name));
+
+        if let Some((index, crc)) = mix_cache::load(&cache_file, &stamp) {
+            let start = index.data_start as usize;
+            if start <= data.len() && crc32(&data[..start]) == crc {
+                return Ok(Self::from_memory_index(name, index, &data));
+            }
+        }
+
+        let index = Self::read_index_from_data(&data)?;
+        if index.header.is_encrypted {
+            let crc = crc32(&data[..index.data_start as usize]);
+            // A failed write only costs the next launch a decrypt
+            let _ = mix_cache::store(&cache_file, &stamp, &index, crc);
+        }
+        Ok(Self::from_memory_index(name, index, &data))
+    }
+
+    /// Parse the index of an in-memory MIX
+    fn read_index_from_data(data: &[u8]) -> Result<MixIndex, MixError> {
         use std::io::Cursor;
 
         if data.len() < 6 {
             return Err(MixError::InvalidHeader);
         }
 
-        let mut cursor = Cursor::new(&data);
+        let mut cursor = Cursor::new(data);
 
         // Read first 4 bytes to detect format
         let mut flag_buf = [0u8; 4];
@@ -310,18 +511,28 @@ impl MixFile {
             (header, entries, data_start)
         };
 
-        // For in-memory MIX, we need to extract just the data section
-        let data_section = data[data_start as usize..].to_vec();
-
-        Ok(MixFile {
-            path: format!("memory://{}", name),
+        Ok(MixIndex {
             header,
             entries,
-            data_start: 0, // Data starts at offset 0 in cached_data
-            cached_data: Some(data_section),
+            data_start,
         })
     }
 
+    /// Build an in-memory MIX from a parsed index (copies the data section)
+    fn from_memory_index(name: &str, index: MixIndex, data: &[u8]) -> Self {
+        let data_section = data[index.data_start as usize..].to_vec();
+
+        MixFile {
+            path: format!("memory://{}", name),
+            header: index.header,
+            entries: index.entries,
+            data_start: 0, // Data starts at offset 0 in cached_data
+            cached_data: Some(Arc::new(data_section)),
+            #[cfg(unix)]
+            mapping: OnceCell::new(),
+        }
+    }
+
     /// Read entries from a reader
     fn read_entries<R: Read>(reader: &mut R, count: usize) -> Result<Vec<MixEntry>, MixError> {
         let mut entries = Vec::with_capacity(count);
@@ -441,7 +652,7 @@ impl MixFile {
         let mut data = vec![0u8; self.header.data_size as usize];
         file.read_exact(&mut data)?;
 
-        self.cached_data = Some(data);
+        self.cached_data = Some(Arc::new(data));
         Ok(())
     }
 
@@ -455,6 +666,19 @@ impl MixFile {
         self.cached_data.is_some()
     }
 
+    /// Bytes held by the cached data section (0 when not cached)
+    pub fn cached_bytes(&self) -> usize {
+        self.cached_data.as_ref().map_or(0, |data| data.len())
+    }
+
+    /// True if the data can be read back from disk after uncache()
+    ///
+    /// Archives built from memory (nested MIX files) have nowhere else to
+    /// read from, so their data must stay cached.
+    pub fn is_on_disk(&self) -> bool {
+        !self.path.starts_with("memory://")
+    }
+
     /// Get number of files in the archive
     pub fn file_count(&self) -> usize {
         self.entries.len()
@@ -518,6 +742,62 @@ impl MixFile {
         Ok(data)
     }
 
+    /// Map file data by entry without copying
+    ///
+    /// Cached archives hand out a slice of the cached data. Archives on
+    /// disk are memory-mapped once (only the index of an encrypted MIX is
+    /// encrypted, so file bodies map as-is); if mapping fails the entry
+    /// is read into an owned buffer instead.
+    pub fn map_entry(&self, entry: &MixEntry) -> Result<MixView, MixError> {
+        let start = entry.offset as usize;
+        let len = entry.size as usize;
+
+        if let Some(ref data) = self.cached_data {
+            if start + len > data.len() {
+                return Err(MixError::InvalidFormat(format!(
+                    "Entry offset {} + size {} exceeds data size {}",
+                    entry.offset,
+                    entry.size,
+                    data.len()
+                )));
+            }
+            return Ok(MixView {
+                source: MixViewSource::Cached(Arc::clone(data)),
+                start,
+                len,
+            });
+        }
+
+        #[cfg(unix)]
+        {
+            let mapping = self
+                .mapping
+                .get_or_init(|| MappedFile::open(&self.path).ok().map(Arc::new));
+
+            if let Some(map) = mapping {
+                let start = self.data_start as usize + start;
+                if start + len > map.len {
+                    return Err(MixError::InvalidFormat(format!(
+                        "Entry offset {} + size {} exceeds file size {}",
+                        entry.offset, entry.size, map.len
+                    )));
+                }
+                return Ok(MixView {
+                    source: MixViewSource::Mapped(Arc::clone(map)),
+                    start,
+                    len,
+                });
+            }
+        }
+
+        let data = self.read_entry(entry)?;
+        Ok(MixView {
+            len: data.len(),
+            source: MixViewSource::Owned(data),
+            start: 0,
+        })
+    }
+
     /// Read file data by CRC
     pub fn read_by_crc(&self, crc: i32) -> Result<Vec<u8>, MixError> {
         let entry = self
@@ -559,6 +839,10 @@ pub struct MixManager {
     mixes: Vec<MixFile>,
     /// Optional: CRC to filename mapping for debugging
     name_map: HashMap<i32, String>,
+    /// Optional: directory for decrypted index caches
+    index_cache_dir: Option<PathBuf>,
+    /// Merged index: CRC -> (archive, entry) of the first archive holding it
+    index: HashMap<i32, (u32, u32)>,
 }
 
 impl MixManager {
@@ -567,21 +851,57 @@ impl MixManager {
         MixManager {
             mixes: Vec::new(),
             name_map: HashMap::new(),
+            index_cache_dir: None,
+            index: HashMap::new(),
+        }
+    }
+
+    /// Set the directory for decrypted index caches (None disables caching)
+    pub fn set_index_cache_dir(&mut self, dir: Option<PathBuf>) {
+        self.index_cache_dir = dir;
+    }
+
+    /// Open a MIX file through the index cache when one is set
+    fn open_mix<P: AsRef<Path>>(&self, path: P) -> Result<MixFile, MixError> {
+        match self.index_cache_dir {
+            Some(ref dir) => MixFile::open_cached(path, dir),
+            None => MixFile::open(path),
+        }
+    }
+
+    /// Append an archive and merge its entries into the index
+    ///
+    /// Earlier archives keep priority, matching the in-order search.
+    fn add_mix(&mut self, mix: MixFile) {
+        let mix_idx = self.mixes.len() as u32;
+        self.index.reserve(mix.entries.len());
+        for (entry_idx, entry) in mix.entries.iter().enumerate() {
+            self.index.entry(entry.crc).or_insert((mix_idx, entry_idx as u32));
+        }
+        self.mixes.push(mix);
+    }
+
+    /// Rebuild the merged index after archives were removed
+    fn rebuild_index(&mut self) {
+        let mixes = std::mem::take(&mut self.mixes);
+        self.index.clear();
+        for mix in mixes {
+            self.add_mix(mix);
         }
     }
 
     /// Register a MIX file
     pub fn register<P: AsRef<Path>>(&mut self, path: P) -> Result<(), MixError> {
-        let mix = MixFile::open(path)?;
-        self.mixes.push(mix);
+        let mix = self.open_mix(path)?;
+        self.add_mix(mix);
         Ok(())
     }
 
     /// Register and cache a MIX file
     pub fn register_and_cache<P: AsRef<Path>>(&mut self, path: P) -> Result<(), MixError> {
-        let mut mix = MixFile::open(path)?;
+        let mut mix = self.open_mix(path)?;
         mix.cache()?;
-        self.mixes.push(mix);
+        self.add_mix(mix);
         Ok(())
     }
 
@@ -594,15 +914,18 @@ impl MixManager {
         let data = self.read(nested_name)?;
 
         // Parse it as a MIX file
-        let mix = MixFile::from_data(nested_name, data)?;
-        self.mixes.push(mix);
+        let mix = match self.index_cache_dir {
+            Some(ref dir) => MixFile::from_data_cached(nested_name, data, dir)?,
+            None => MixFile::from_data(nested_name, data)?,
+        };
+        self.add_mix(mix);
         Ok(())
     }
 
     /// Register a MIX file from in-memory data
     pub fn register_from_data(&mut self, name: &str, data: Vec<u8>) -> Result<(), MixError> {
         let mix = MixFile::from_data(name, data)?;
-        self.mixes.push(mix);
+        self.add_mix(mix);
         Ok(())
     }
 
@@ -610,6 +933,7 @@ impl MixManager {
     pub fn unregister(&mut self, path: &str) -> bool {
         if let Some(idx) = self.mixes.iter().position(|m| m.path == path) {
             self.mixes.remove(idx);
+            self.rebuild_index();
             true
         } else {
             false
@@ -617,16 +941,17 @@ impl MixManager {
     }
 
     /// Find a file across all registered MIX files
+    ///
+    /// One probe of the merged index, however many archives are loaded.
     pub fn find(&self, filename: &str) -> Option<(&MixFile, &MixEntry)> {
-        let crc = westwood_crc_filename(filename) as i32;
-
-        for mix in &self.mixes {
-            if let Some(entry) = mix.find_by_crc(crc) {
-                return Some((mix, entry));
-            }
-        }
+        self.find_by_crc(westwood_crc_filename(filename) as i32)
+    }
 
-        None
+    /// Find a file by CRC across all registered MIX files
+    pub fn find_by_crc(&self, crc: i32) -> Option<(&MixFile, &MixEntry)> {
+        let &(mix_idx, entry_idx) = self.index.get(&crc)?;
+        let mix = &self.mixes[mix_idx as usize];
+        Some((mix, &mix.entries[entry_idx as usize]))
     }
 
     /// Check if file exists in any registered MIX
@@ -637,7 +962,25 @@ impl MixManager {
     /// Read file data from the first MIX that contains it
     pub fn read(&self, filename: &str) -> Result<Vec<u8>, MixError> {
         match self.find(filename) {
-            Some((mix, entry)) => mix.read_entry(entry),
+            Some((mix, entry)) => {
+                let started = io_stats::start();
+                let data = mix.read_entry(entry)?;
+                io_stats::record(&mix.path, Some(filename), data.len(), started);
+                Ok(data)
+            }
+            None => Err(MixError::FileNotFound(filename.to_string())),
+        }
+    }
+
+    /// Map file data from the first MIX that contains it
+    pub fn map(&self, filename: &str) -> Result<MixView, MixError> {
+        match self.find(filename) {
+            Some((mix, entry)) => {
+                let started = io_stats::start();
+                let view = mix.map_entry(entry)?;
+                io_stats::record(&mix.path, Some(filename), view.len(), started);
+                Ok(view)
+            }
             None => Err(MixError::FileNotFound(filename.to_string())),
         }
     }
@@ -645,6 +988,9 @@ impl MixManager {
     /// Get pointer to file data if cached
     pub fn get_ptr(&self, filename: &str) -> Option<&[u8]> {
         let crc = westwood_crc_filename(filename) as i32;
+        if !self.index.contains_key(&crc) {
+            return None;
+        }
 
         for mix in &self.mixes {
             if mix.find_by_crc(crc).is_some() {
@@ -684,6 +1030,28 @@ impl MixManager {
         false
     }
 
+    /// Bytes held by cached archive data, including in-memory archives
+    pub fn cached_bytes(&self) -> usize {
+        self.mixes.iter().map(|mix| mix.cached_bytes()).sum()
+    }
+
+    /// Drop the cached data of every archive that can be re-read from disk
+    ///
+    /// Later reads go through the file (or its memory map) instead. Views
+    /// handed out earlier keep their data alive until released.
+    ///
+    /// Returns the bytes released.
+    pub fn release_caches(&mut self) -> usize {
+        let mut released = 0;
+        for mix in &mut self.mixes {
+            if mix.is_on_disk() {
+                released += mix.cached_bytes();
+                mix.uncache();
+            }
+        }
+        released
+    }
+
     /// Register a known filename for CRC debugging
     pub fn register_name(&mut self, filename: &str) {
         let crc = westwood_crc_filename(filename) as i32;
@@ -772,4 +1140,134 @@ mod tests {
         assert_eq!(header.data_size, 0x1000);
         assert_eq!(header.header_size(), 6 + 10 * 12); // 126 bytes
     }
+
+    /// Plain-format MIX holding one file
+    fn single_file_mix(name: &str, contents: &[u8]) -> Vec<u8> {
+        let crc = westwood_crc_filename(name) as i32;
+        let mut data = Vec::new();
+        data.extend_from_slice(&1i16.to_le_bytes());
+        data.extend_from_slice(&(contents.len() as i32).to_le_bytes());
+        data.extend_from_slice(&crc.to_le_bytes());
+        data.extend_from_slice(&0u32.to_le_bytes());
+        data.extend_from_slice(&(contents.len() as u32).to_le_bytes());
+        data.extend_from_slice(contents);
+        data
+    }
+
+    #[test]
+    fn test_map_cached_entry() {
+        let mut manager = MixManager::new();
+        manager
+            .register_from_data("test.mix", single_file_mix("TEST.DAT", b"hello"))
+            .unwrap();
+
+        let view = manager.map("TEST.DAT").unwrap();
+        assert_eq!(view.as_slice(), b"hello");
+        assert!(!view.is_copy());
+
+        // The view keeps the data alive after the archive goes away
+        assert!(manager.unregister("memory://test.mix"));
+        assert_eq!(view.as_slice(), b"hello");
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn test_map_file_entry() {
+        let path = std::env::temp_dir().join(format!("mix_map_{}.mix", std::process::id()));
+        std::fs::write(&path, single_file_mix("TEST.DAT", b"mapped")).unwrap();
+
+        let mut manager = MixManager::new();
+        manager.register(&path).unwrap();
+        let first = manager.map("TEST.DAT").unwrap();
+        let second = manager.map("TEST.DAT").unwrap();
+        assert_eq!(first.as_slice(), b"mapped");
+        assert!(!first.is_copy());
+        assert_eq!(first.as_slice().as_ptr(), second.as_slice().as_ptr());
+
+        std::fs::remove_file(&path).unwrap();
+        assert!(matches!(manager.map("MISSING.DAT"), Err(MixError::FileNotFound(_))));
+    }
+
+    #[test]
+    fn test_open_cached_uses_valid_index() {
+        let base = std::env::temp_dir().join(format!("mix_idx_{}", std::process::id()));
+        let cache_dir = base.join("cache");
+        fs::create_dir_all(&base).unwrap();
+        let path = base.join("test.mix");
+        let bytes = single_file_mix("TEST.DAT", b"cached");
+        fs::write(&path, &bytes).unwrap();
+
+        // Plant an index that differs from the file's real one
+        let mix = MixFile::open(&path).unwrap();
+        let mut index = MixIndex {
+            header: mix.header.clone(),
+            entries: mix.entries.clone(),
+            data_start: mix.data_start,
+        };
+        index.entries[0].crc = westwood_crc_filename("OTHER.DAT") as i32;
+        let key = fs::canonicalize(&path).unwrap();
+        let cache_file = mix_cache::cache_file(&cache_dir, &key.to_string_lossy());
+        let stamp = IndexStamp::of_file(&path).unwrap();
+        let crc = crc32(&bytes[..mix.data_start as usize]);
+        mix_cache::store(&cache_file, &stamp, &index, crc).unwrap();
+
+        let cached = MixFile::open_cached(&path, &cache_dir).unwrap();
+        assert!(cached.contains("OTHER.DAT"));
+        assert_eq!(cached.read("OTHER.DAT").unwrap(), b"cached");
+
+        // A header that no longer matches falls back to parsing the file
+        mix_cache::store(&cache_file, &stamp, &index, crc ^ 1).unwrap();
+        let parsed = MixFile::open_cached(&path, &cache_dir).unwrap();
+        assert!(parsed.contains("TEST.DAT"));
+        assert!(!parsed.contains("OTHER.DAT"));
+
+        fs::remove_dir_all(&base).unwrap();
+    }
+
+    #[test]
+    fn test_release_caches_keeps_memory_archives() {
+        let path = std::env::temp_dir().join(format!("mix_release_{}.mix", std::process::id()));
+        std::fs::write(&path, single_file_mix("DISK.DAT", b"on disk")).unwrap();
+
+        let mut manager = MixManager::new();
+        manager.register_and_cache(&path).unwrap();
+        manager
+            .register_from_data("nested.mix", single_file_mix("NESTED.DAT", b"nested"))
+            .unwrap();
+        let cached = manager.cached_bytes();
+        assert!(cached > 0);
+
+        // Only the archive on disk lets go; both still read
+        let released = manager.release_caches();
+        assert!(released > 0);
+        assert_eq!(manager.cached_bytes(), cached - released);
+        assert_eq!(manager.read("DISK.DAT").unwrap(), b"on disk");
+        assert_eq!(manager.read("NESTED.DAT").unwrap(), b"nested");
+
+        std::fs::remove_file(&path).unwrap();
+    }
+
+    #[test]
+    fn test_merged_index_priority() {
+        let mut manager = MixManager::new();
+        manager
+            .register_from_data("first.mix", single_file_mix("SHARED.DAT", b"first"))
+            .unwrap();
+        manager
+            .register_from_data("second.mix", single_file_mix("SHARED.DAT", b"second"))
+            .unwrap();
+        manager
+            .register_from_data("extra.mix", single_file_mix("EXTRA.DAT", b"extra"))
+            .unwrap();
+
+        // The first registered archive wins
+        assert_eq!(manager.read("SHARED.DAT").unwrap(), b"first");
+        assert_eq!(manager.read("extra.dat").unwrap(), b"extra");
+        assert!(!manager.exists("MISSING.DAT"));
+
+        // Removing it exposes the next one
+        assert!(manager.unregister("memory://first.mix"));
+        assert_eq!(manager.read("SHARED.DAT").unwrap(), b"second");
+        assert_eq!(manager.read("EXTRA.DAT").unwrap(), b"extra");
+    }
 }
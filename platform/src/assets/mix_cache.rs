@@ -0,0 +1,280 @@
+//! Persistent cache of decrypted MIX indices
+//!
+//! Opening an encrypted MIX means an RSA decrypt of the key block and a
+//! Blowfish pass over the whole index. The result only changes when the
+//! archive does, so the decrypted index is written to the cache directory
+//! and reused on the next launch.
+//!
+//! ## Cache File Format
+//! ```text
+//! magic:       [u8; 4] - "RAMI"
+//! version:     u32
+//! size:        u64     - Archive size in bytes
+//! mtime_secs:  u64     - Archive modification time (0 for nested MIX files)
+//! mtime_nanos: u32
+//! header_crc:  u32     - CRC32 of the archive's raw (encrypted) header bytes
+//! data_start:  u64     - Offset of the data section
+//! file_count:  u16
+//! data_size:   u32
+//! flags:       u8      - bit 0 extended, bit 1 digest, bit 2 encrypted
+//! entries:     [crc: i32, offset: u32, size: u32] * file_count
+//! body_crc:    u32     - CRC32 of everything above
+//! ```
+//!
+//! Size and mtime reject a changed archive without reading it. The header
+//! CRC is checked against the raw bytes before `data_start`, which are the
+//! encrypted key block and index, so a hit is never stale even when the
+//! mtime is preserved.
+
+use std::fs;
+use std::io;
+use std::path::{Path, PathBuf};
+use std::time::UNIX_EPOCH;
+
+use super::mix::{MixEntry, MixHeader};
+use crate::util::crc::crc32;
+
+const MAGIC: &[u8; 4] = b"RAMI";
+const VERSION: u32 = 1;
+const FIXED_SIZE: usize = 4 + 4 + 8 + 8 + 4 + 4 + 8 + 2 + 4 + 1;
+
+const FLAG_EXTENDED: u8 = 0x01;
+const FLAG_DIGEST: u8 = 0x02;
+const FLAG_ENCRYPTED: u8 = 0x04;
+
+/// Identity of an archive on disk (or of a nested archive's bytes)
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct IndexStamp {
+    pub size: u64,
+    pub mtime_secs: u64,
+    pub mtime_nanos: u32,
+}
+
+impl IndexStamp {
+    /// Stamp of a file on disk
+    pub fn of_file(path: &Path) -> io::Result<Self> {
+        let meta = fs::metadata(path)?;
+        let mtime = meta
+            .modified()
+            .ok()
+            .and_then(|t| t.duration_since(UNIX_EPOCH).ok())
+            .unwrap_or_default();
+
+        Ok(IndexStamp {
+            size: meta.len(),
+            mtime_secs: mtime.as_secs(),
+            mtime_nanos: mtime.subsec_nanos(),
+        })
+    }
+
+    /// Stamp of an in-memory archive (nested MIX files have no mtime)
+    pub fn of_data(len: usize) -> Self {
+        IndexStamp {
+            size: len as u64,
+            mtime_secs: 0,
+            mtime_nanos: 0,
+        }
+    }
+}
+
+/// A parsed MIX index, as stored in the cache
+#[derive(Debug, Clone)]
+pub struct MixIndex {
+    pub header: MixHeader,
+    pub entries: Vec<MixEntry>,
+    pub data_start: u64,
+}
+
+/// Cache file path for an archive key (path or nested name)
+pub fn cache_file(cache_dir: &Path, key: &str) -> PathBuf {
+    let crc = crc32(key.to_uppercase().as_bytes());
+    cache_dir.join(format!("{:08x}.mixidx", crc))
+}
+
+/// Load a cached index if it matches `stamp`
+///
+/// Returns the index and the header CRC it was built from. The caller
+/// must compare that CRC with the archive's header bytes before use.
+pub fn load(file: &Path, stamp: &IndexStamp) -> Option<(MixIndex, u32)> {
+    let data = fs::read(file).ok()?;
+    if data.len() < FIXED_SIZE + 4 {
+        return None;
+    }
+
+    let (body, tail) = data.split_at(data.len() - 4);
+    if crc32(body) != u32::from_le_bytes(tail.try_into().ok()?) {
+        return None;
+    }
+
+    let mut r = Reader { data: body, pos: 0 };
+    if r.bytes(4)? != MAGIC || r.u32()? != VERSION {
+        return None;
+    }
+
+    let cached = IndexStamp {
+        size: r.u64()?,
+        mtime_secs: r.u64()?,
+        mtime_nanos: r.u32()?,
+    };
+    if cached != *stamp {
+        return None;
+    }
+
+    let header_crc = r.u32()?;
+    let data_start = r.u64()?;
+    let file_count = r.u16()?;
+    let data_size = r.u32()?;
+    let flags = r.bytes(1)?[0];
+
+    if body.len() != FIXED_SIZE + file_count as usize * 12 {
+        return None;
+    }
+
+    let mut entries = Vec::with_capacity(file_count as usize);
+    for _ in 0..file_count {
+        let bytes: &[u8; 12] = r.bytes(12)?.try_into().ok()?;
+        entries.push(MixEntry::from_bytes(bytes));
+    }
+
+    let header = MixHeader {
+        file_count,
+        data_size,
+        is_extended: flags & FLAG_EXTENDED != 0,
+        has_digest: flags & FLAG_DIGEST != 0,
+        is_encrypted: flags & FLAG_ENCRYPTED != 0,
+    };
+
+    Some((
+        MixIndex {
+            header,
+            entries,
+            data_start,
+        },
+        header_crc,
+    ))
+}
+
+/// Write an index to the cache (atomically, via a temporary file)
+pub fn store(file: &Path, stamp: &IndexStamp, index: &MixIndex, header_crc: u32) -> io::Result<()> {
+    let mut out = Vec::with_capacity(FIXED_SIZE + index.entries.len() * 12 + 4);
+    out.extend_from_slice(MAGIC);
+    out.extend_from_slice(&VERSION.to_le_bytes());
+    out.extend_from_slice(&stamp.size.to_le_bytes());
+    out.extend_from_slice(&stamp.mtime_secs.to_le_bytes());
+    out.extend_from_slice(&stamp.mtime_nanos.to_le_bytes());
+    out.extend_from_slice(&header_crc.to_le_bytes());
+    out.extend_from_slice(&index.data_start.to_le_bytes());
+    out.extend_from_slice(&(index.entries.len() as u16).to_le_bytes());
+    out.extend_from_slice(&index.header.data_size.to_le_bytes());
+
+    let mut flags = 0u8;
+    if index.header.is_extended {
+        flags |= FLAG_EXTENDED;
+    }
+    if index.header.has_digest {
+        flags |= FLAG_DIGEST;
+    }
+    if index.header.is_encrypted {
+        flags |= FLAG_ENCRYPTED;
+    }
+    out.push(flags);
+
+    for entry in &index.entries {
+        out.extend_from_slice(&entry.crc.to_le_bytes());
+        out.extend_from_slice(&entry.offset.to_le_bytes());
+        out.extend_from_slice(&entry.size.to_le_bytes());
+    }
+
+    let body_crc = crc32(&out);
+    out.extend_from_slice(&body_crc.to_le_bytes());
+
+    if let Some(dir) = file.parent() {
+        fs::create_dir_all(dir)?;
+    }
+    let tmp = file.with_extension("tmp");
+    fs::write(&tmp, &out)?;
+    fs::rename(&tmp, file)
+}
+
+/// Little-endian cursor over the cache body
+struct Reader<'a> {
+    data: &'a [u8],
+    pos: usize,
+}
+
+impl<'a> Reader<'a> {
+    fn bytes(&mut self, n: usize) -> Option<&'a [u8]> {
+        let end = self.pos.checked_add(n)?;
+        let slice = self.data.get(self.pos..end)?;
+        self.pos = end;
+        Some(slice)
+    }
+
+    fn u16(&mut self) -> Option<u16> {
+        Some(u16::from_le_bytes(self.bytes(2)?.try_into().ok()?))
+    }
+
+    fn u32(&mut self) -> Option<u32> {
+        Some(u32::from_le_bytes(self.bytes(4)?.try_into().ok()?))
+    }
+
+    fn u64(&mut self) -> Option<u64> {
+        Some(u64::from_le_bytes(self.bytes(8)?.try_into().ok()?))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sample_index() -> MixIndex {
+        MixIndex {
+            header: MixHeader {
+                file_count: 2,
+                data_size: 300,
+                is_extended: true,
+                has_digest: false,
+                is_encrypted: true,
+            },
+            entries: vec![
+                MixEntry { crc: -5, offset: 0, size: 100 },
+                MixEntry { crc: 42, offset: 100, size: 200 },
+            ],
+            data_start: 112,
+        }
+    }
+
+    #[test]
+    fn test_store_and_load_round_trip() {
+        let dir = std::env::temp_dir().join(format!("mixidx_rt_{}", std::process::id()));
+        let file = cache_file(&dir, "gamedata/REDALERT.MIX");
+        let stamp = IndexStamp { size: 412, mtime_secs: 1000, mtime_nanos: 7 };
+
+        store(&file, &stamp, &sample_index(), 0xDEADBEEF).unwrap();
+        let (index, crc) = load(&file, &stamp).unwrap();
+        assert_eq!(crc, 0xDEADBEEF);
+        assert_eq!(index.data_start, 112);
+        assert_eq!(index.entries.len(), 2);
+        assert_eq!(index.entries[1].offset, 100);
+        assert!(index.header.is_encrypted && index.header.is_extended);
+
+        // A different stamp (archive replaced) misses
+        let newer = IndexStamp { mtime_secs: 1001, ..stamp };
+        assert!(load(&file, &newer).is_none());
+
+        // A corrupted cache file misses
+        let mut bytes = fs::read(&file).unwrap();
+        bytes[FIXED_SIZE] ^= 0xFF;
+        fs::write(&file, &bytes).unwrap();
+        assert!(load(&file, &stamp).is_none());
+
+        fs::remove_dir_all(&dir).unwrap();
+    }
+
+    #[test]
+    fn test_cache_file_is_case_insensitive() {
+        let dir = Path::new("/tmp");
+        assert_eq!(cache_file(dir, "main.mix"), cache_file(dir, "MAIN.MIX"));
+        assert_ne!(cache_file(dir, "main.mix"), cache_file(dir, "local.mix"));
+    }
+}
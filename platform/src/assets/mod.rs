@@ -4,6 +4,7 @@
 //! and extracting various asset types (palettes, shapes, templates, PCX images, etc.)
 
 pub mod mix;
+pub mod mix_cache;
 pub mod palette;
 pub mod pcx;
 pub mod shape;
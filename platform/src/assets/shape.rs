@@ -30,6 +30,7 @@
 //! ```
 
 use std::io::{self, Read, Seek, SeekFrom};
+use std::sync::Mutex;
 
 use crate::compression::lcw;
 
@@ -133,13 +134,25 @@ impl ShapeFrame {
 }
 
 /// A shape file containing multiple frames
+///
+/// Frames are decoded on request rather than at load, straight into the
+/// caller's memory. An XOR delta frame needs its reference decoded first;
+/// `decode_range` walks frames in order and takes references from the
+/// frames it has already written, so decoding a whole animation costs one
+/// pass however long its delta chains are. The last frame decoded is kept
+/// as well, so frames requested one at a time in order (an animation
+/// playing) also decode each frame once.
 pub struct ShapeFile {
     /// Frame width
     pub width: u16,
     /// Frame height
     pub height: u16,
-    /// Decoded frames
-    frames: Vec<ShapeFrame>,
+    /// The file as loaded; frame data is read from here
+    data: Vec<u8>,
+    /// Frame offset table
+    offsets: Vec<FrameOffset>,
+    /// Last frame decoded and its pixels
+    last: Mutex<Option<(usize, Vec<u8>)>>,
 }
 
 impl ShapeFile {
@@ -175,65 +188,18 @@ impl ShapeFile {
             let format = data[base + 4];
             let ref_frame = data[base + 5];
 
+            if offset != 0 && offset as usize >= data.len() {
+                return Err(ShapeError::InvalidFrame(i));
+            }
             offsets.push(FrameOffset { offset, format, ref_frame });
         }
 
-        // Decode frames
-        let frame_size = width as usize * height as usize;
-        let mut frames: Vec<ShapeFrame> = Vec::with_capacity(frame_count);
-
-        for (frame_idx, frame_offset) in offsets.iter().enumerate() {
-            let frame = if frame_offset.offset == 0 {
-                // Empty frame
-                ShapeFrame::empty(width, height)
-            } else {
-                // Get frame data slice
-                let start = frame_offset.offset as usize;
-                if start >= data.len() {
-                    return Err(ShapeError::InvalidFrame(frame_idx));
-                }
-
-                let frame_data = &data[start..];
-                let is_compressed = (frame_offset.format & frame_format::LCW_COMPRESSED) != 0;
-                let is_xor = (frame_offset.format & frame_format::XOR_DELTA) != 0;
-
-                let mut pixels = if is_compressed {
-                    // LCW decompress
-                    let mut output = vec![0u8; frame_size];
-                    match lcw::lcw_decompress(frame_data, &mut output) {
-                        Ok(_) => output,
-                        Err(_) => return Err(ShapeError::DecompressionFailed),
-                    }
-                } else {
-                    // Raw data
-                    if frame_data.len() < frame_size {
-                        return Err(ShapeError::InvalidFrame(frame_idx));
-                    }
-                    frame_data[..frame_size].to_vec()
-                };
-
-                // Apply XOR delta if needed
-                if is_xor && frame_offset.ref_frame < frames.len() as u8 {
-                    let ref_pixels = &frames[frame_offset.ref_frame as usize].pixels;
-                    for (p, r) in pixels.iter_mut().zip(ref_pixels.iter()) {
-                        *p ^= *r;
-                    }
-                }
-
-                ShapeFrame {
-                    width,
-                    height,
-                    pixels,
-                }
-            };
-
-            frames.push(frame);
-        }
-
         Ok(ShapeFile {
             width,
             height,
-            frames,
+            data: data.to_vec(),
+            offsets,
+            last: Mutex::new(None),
         })
     }
 
@@ -246,22 +212,126 @@ impl ShapeFile {
 
     /// Get number of frames
     pub fn frame_count(&self) -> usize {
-        self.frames.len()
+        self.offsets.len()
     }
 
-    /// Get a specific frame
-    pub fn frame(&self, index: usize) -> Option<&ShapeFrame> {
-        self.frames.get(index)
+    /// Bytes in one decoded frame
+    pub fn frame_size(&self) -> usize {
+        self.width as usize * self.height as usize
     }
 
-    /// Get mutable reference to a frame
-    pub fn frame_mut(&mut self, index: usize) -> Option<&mut ShapeFrame> {
-        self.frames.get_mut(index)
+    /// Decode a specific frame
+    ///
+    /// Decodes the frames its delta chain refers to along the way; use
+    /// `decode_range` for runs of frames.
+    pub fn frame(&self, index: usize) -> Option<ShapeFrame> {
+        if index >= self.frame_count() {
+            return None;
+        }
+        let mut pixels = vec![0u8; self.frame_size()];
+        self.decode_range(index, &mut pixels).ok()?;
+        Some(ShapeFrame {
+            width: self.width,
+            height: self.height,
+            pixels,
+        })
     }
 
-    /// Iterate over all frames
-    pub fn frames(&self) -> impl Iterator<Item = &ShapeFrame> {
-        self.frames.iter()
+    /// Decode consecutive frames into `out`, `frame_size()` bytes each
+    ///
+    /// Decodes as many whole frames as fit, starting at `first`. A delta
+    /// frame whose reference is inside the range reuses what was already
+    /// written there; only references before `first` are decoded apart.
+    ///
+    /// Returns the number of frames decoded.
+    pub fn decode_range(&self, first: usize, out: &mut [u8]) -> Result<usize, ShapeError> {
+        let frame_size = self.frame_size();
+        let count = std::cmp::min(out.len() / frame_size, self.frame_count().saturating_sub(first));
+
+        for i in 0..count {
+            let index = first + i;
+            let (done, rest) = out.split_at_mut(i * frame_size);
+            let target = &mut rest[..frame_size];
+            self.decode_pixels(index, target)?;
+
+            let offset = self.offsets[index];
+            let is_xor = (offset.format & frame_format::XOR_DELTA) != 0;
+            let reference = offset.ref_frame as usize;
+            if offset.offset == 0 || !is_xor || reference >= index {
+                continue;
+            }
+
+            if reference >= first {
+                let start = (reference - first) * frame_size;
+                Self::xor(target, &done[start..start + frame_size]);
+                continue;
+            }
+
+            let cached = match self.last.lock() {
+                Ok(last) => match &*last {
+                    Some((index, pixels)) if *index == reference => {
+                        Self::xor(target, pixels);
+                        true
+                    }
+                    _ => false,
+                },
+                Err(_) => false,
+            };
+            if !cached {
+                match self.frame(reference) {
+                    Some(frame) => Self::xor(target, &frame.pixels),
+                    None => return Err(ShapeError::InvalidFrame(reference)),
+                }
+            }
+        }
+
+        // Keep the last frame as the base for whatever is asked for next
+        if count > 0 {
+            if let Ok(mut last) = self.last.lock() {
+                let pixels = &out[(count - 1) * frame_size..count * frame_size];
+                match &mut *last {
+                    Some((index, kept)) => {
+                        *index = first + count - 1;
+                        kept.clear();
+                        kept.extend_from_slice(pixels);
+                    }
+                    None => *last = Some((first + count - 1, pixels.to_vec())),
+                }
+            }
+        }
+
+        Ok(count)
+    }
+
+    /// Decompress or copy one frame's own data, before any XOR delta
+    fn decode_pixels(&self, index: usize, target: &mut [u8]) -> Result<(), ShapeError> {
+        let offset = self.offsets[index];
+        if offset.offset == 0 {
+            // Empty frame
+            target.fill(0);
+            return Ok(());
+        }
+
+        let frame_data = &self.data[offset.offset as usize..];
+        if (offset.format & frame_format::LCW_COMPRESSED) != 0 {
+            // Anything the stream doesn't write stays clear
+            target.fill(0);
+            lcw::lcw_decompress(frame_data, target)
+                .map_err(|_| ShapeError::DecompressionFailed)?;
+        } else {
+            // Raw data
+            if frame_data.len() < target.len() {
+                return Err(ShapeError::InvalidFrame(index));
+            }
+            target.copy_from_slice(&frame_data[..target.len()]);
+        }
+        Ok(())
+    }
+
+    fn xor(target: &mut [u8], reference: &[u8]) {
+        for (p, r) in target.iter_mut().zip(reference.iter()) {
+            *p ^= *r;
+        }
     }
 }
 
@@ -316,4 +386,69 @@ mod tests {
         let result = ShapeFile::from_data(&data);
         assert!(matches!(result, Err(ShapeError::InvalidHeader)));
     }
+
+    /// Raw 2x2 frames: frame 0 a keyframe, each later one XOR'd with the
+    /// frame before it
+    fn delta_chain_shape(frame_count: usize) -> Vec<u8> {
+        let mut data = vec![frame_count as u8, 0, 0, 0, 2, 0, 2, 0];
+        let data_start = 8 + frame_count * 8;
+        for i in 0..frame_count {
+            let offset = (data_start + i * 4) as u32;
+            data.extend_from_slice(&offset.to_le_bytes());
+            if i == 0 {
+                data.extend_from_slice(&[0, 0, 0, 0]);
+            } else {
+                data.extend_from_slice(&[frame_format::XOR_DELTA, (i - 1) as u8, 0, 0]);
+            }
+        }
+        for i in 0..frame_count {
+            // Frame i decodes to [i, i+1, i+2, i+3]
+            let value = |f: usize, p: usize| (f + p) as u8;
+            for p in 0..4 {
+                let delta = if i == 0 { value(0, p) } else { value(i, p) ^ value(i - 1, p) };
+                data.push(delta);
+            }
+        }
+        data
+    }
+
+    #[test]
+    fn test_shape_delta_chain_single_frame() {
+        let shape = ShapeFile::from_data(&delta_chain_shape(6)).unwrap();
+        assert_eq!(shape.frame_count(), 6);
+        assert_eq!(shape.frame(5).unwrap().pixels, vec![5, 6, 7, 8]);
+        assert!(shape.frame(6).is_none());
+    }
+
+    #[test]
+    fn test_shape_decode_range_matches_frames() {
+        let shape = ShapeFile::from_data(&delta_chain_shape(6)).unwrap();
+
+        // Starts mid-chain, so frame 2's reference is decoded apart
+        let mut out = vec![0xFFu8; 4 * 3 + 2];
+        assert_eq!(shape.decode_range(3, &mut out).unwrap(), 3);
+        for i in 0..3 {
+            assert_eq!(&out[i * 4..i * 4 + 4], shape.frame(3 + i).unwrap().pixels.as_slice());
+        }
+        // Partial trailing frame left alone
+        assert_eq!(&out[12..], &[0xFF, 0xFF]);
+
+        // Single frames in order reuse the one before
+        for i in 0..6 {
+            assert_eq!(shape.frame(i).unwrap().pixels, vec![i as u8, i as u8 + 1, i as u8 + 2, i as u8 + 3]);
+        }
+
+        // Clipped at the last frame
+        let mut all = vec![0u8; 4 * 10];
+        assert_eq!(shape.decode_range(0, &mut all).unwrap(), 6);
+        assert_eq!(&all[20..24], &[5, 6, 7, 8]);
+    }
+
+    #[test]
+    fn test_shape_bad_frame_offset() {
+        let mut data = delta_chain_shape(2);
+        data[8] = 0xFF;
+        data[9] = 0xFF;
+        assert!(matches!(ShapeFile::from_data(&data), Err(ShapeError::InvalidFrame(0))));
+    }
 }
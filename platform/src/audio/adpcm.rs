@@ -5,14 +5,14 @@
 
 /// IMA ADPCM index adjustment table
 /// Maps the 4-bit ADPCM code to step index adjustment
-static INDEX_TABLE: [i32; 16] = [
+const INDEX_TABLE: [i32; 16] = [
     -1, -1, -1, -1, 2, 4, 6, 8,
     -1, -1, -1, -1, 2, 4, 6, 8,
 ];
 
 /// IMA ADPCM step size table
 /// 89 quantizer step sizes for the ADPCM algorithm
-static STEP_TABLE: [i32; 89] = [
+const STEP_TABLE: [i32; 89] = [
     7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
     19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
     50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
@@ -24,6 +24,55 @@ static STEP_TABLE: [i32; 89] = [
     15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
 ];
 
+/// What one code does at one step index: the signed predictor change and
+/// the step index for the next nibble
+#[derive(Clone, Copy)]
+struct Code {
+    diff: i32,
+    next_index: i32,
+}
+
+/// Every (step index, code) pair worked out ahead of time, so decoding a
+/// nibble is one lookup and a branch-free clamp instead of four bit tests
+static CODES: [[Code; 16]; 89] = build_codes();
+
+const fn build_codes() -> [[Code; 16]; 89] {
+    let mut table = [[Code { diff: 0, next_index: 0 }; 16]; 89];
+    let mut index = 0;
+    while index < 89 {
+        let step = STEP_TABLE[index];
+        let mut nibble = 0;
+        while nibble < 16 {
+            // diff = step/8 + step/4*b0 + step/2*b1 + step*b2
+            let mut diff = step >> 3;
+            if nibble & 1 != 0 {
+                diff += step >> 2;
+            }
+            if nibble & 2 != 0 {
+                diff += step >> 1;
+            }
+            if nibble & 4 != 0 {
+                diff += step;
+            }
+            if nibble & 8 != 0 {
+                diff = -diff;
+            }
+
+            let mut next = index as i32 + INDEX_TABLE[nibble];
+            if next < 0 {
+                next = 0;
+            } else if next > 88 {
+                next = 88;
+            }
+
+            table[index][nibble] = Code { diff, next_index: next };
+            nibble += 1;
+        }
+        index += 1;
+    }
+    table
+}
+
 /// ADPCM decoder state
 #[derive(Debug, Clone)]
 pub struct AdpcmDecoder {
@@ -68,48 +117,21 @@ impl AdpcmDecoder {
 
     /// Decode a single 4-bit ADPCM nibble to a 16-bit PCM sample
     #[inline]
-    fn decode_nibble(&mut self, nibble: u8) -> i16 {
-        let step = STEP_TABLE[self.step_index as usize];
-
-        // Calculate the difference using the step size
-        // diff = step/8 + step/4*b0 + step/2*b1 + step*b2
-        let mut diff = step >> 3;
-        if nibble & 1 != 0 {
-            diff += step >> 2;
-        }
-        if nibble & 2 != 0 {
-            diff += step >> 1;
-        }
-        if nibble & 4 != 0 {
-            diff += step;
-        }
-
-        // Apply sign bit
-        if nibble & 8 != 0 {
-            diff = -diff;
-        }
-
-        // Update predictor with clamping
-        self.predictor += diff;
-        self.predictor = self.predictor.clamp(-32768, 32767);
-
-        // Update step index with clamping
-        self.step_index += INDEX_TABLE[(nibble & 0x0F) as usize];
-        self.step_index = self.step_index.clamp(0, 88);
-
+    pub fn decode_nibble(&mut self, nibble: u8) -> i16 {
+        let code = CODES[self.step_index as usize][(nibble & 0x0F) as usize];
+        self.predictor = (self.predictor + code.diff).clamp(-32768, 32767);
+        self.step_index = code.next_index;
         self.predictor as i16
     }
 
     /// Decode a block of ADPCM data to PCM samples
     /// Each input byte produces 2 output samples (low nibble first, then high nibble)
     pub fn decode(&mut self, input: &[u8]) -> Vec<i16> {
-        let mut output = Vec::with_capacity(input.len() * 2);
+        let mut output = vec![0i16; input.len() * 2];
 
-        for &byte in input {
-            // Decode low nibble first
-            output.push(self.decode_nibble(byte & 0x0F));
-            // Then decode high nibble
-            output.push(self.decode_nibble((byte >> 4) & 0x0F));
+        for (&byte, pair) in input.iter().zip(output.chunks_exact_mut(2)) {
+            pair[0] = self.decode_nibble(byte & 0x0F);
+            pair[1] = self.decode_nibble(byte >> 4);
         }
 
         output
@@ -225,6 +247,53 @@ mod tests {
         assert!(sample >= -32768 && sample <= 32767);
     }
 
+    /// The original per-nibble arithmetic, to check the code table against
+    fn reference_nibble(predictor: &mut i32, step_index: &mut i32, nibble: u8) -> i16 {
+        let step = STEP_TABLE[*step_index as usize];
+        let mut diff = step >> 3;
+        if nibble & 1 != 0 {
+            diff += step >> 2;
+        }
+        if nibble & 2 != 0 {
+            diff += step >> 1;
+        }
+        if nibble & 4 != 0 {
+            diff += step;
+        }
+        if nibble & 8 != 0 {
+            diff = -diff;
+        }
+        *predictor = (*predictor + diff).clamp(-32768, 32767);
+        *step_index = (*step_index + INDEX_TABLE[nibble as usize]).clamp(0, 88);
+        *predictor as i16
+    }
+
+    #[test]
+    fn test_code_table_matches_reference() {
+        for index in 0..89 {
+            for nibble in 0..16u8 {
+                for start in [-32768, -1000, 0, 1000, 32767] {
+                    let mut decoder = AdpcmDecoder::with_state(start, index);
+                    let (mut predictor, mut step_index) = (start, index);
+                    let expected = reference_nibble(&mut predictor, &mut step_index, nibble);
+                    assert_eq!(decoder.decode_nibble(nibble), expected);
+                    assert_eq!(decoder.step_index(), step_index);
+                }
+            }
+        }
+
+        let input: Vec<u8> = (0..4096u32).map(|i| (i.wrapping_mul(2654435761) >> 13) as u8).collect();
+        let (mut predictor, mut step_index) = (0, 0);
+        let expected: Vec<i16> = input.iter()
+            .flat_map(|&b| {
+                let low = reference_nibble(&mut predictor, &mut step_index, b & 0x0F);
+                let high = reference_nibble(&mut predictor, &mut step_index, b >> 4);
+                [low, high]
+            })
+            .collect();
+        assert_eq!(decode_adpcm(&input), expected);
+    }
+
     #[test]
     fn test_negative_samples() {
         let mut decoder = AdpcmDecoder::new();
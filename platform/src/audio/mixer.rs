@@ -0,0 +1,838 @@
+//! Software mixer for sound effects
+//!
+//! Sounds are resampled to the device rate once, when they are created,
+//! instead of by rodio every time they play. The mixer then sums every
+//! playing voice into one 32-bit accumulator per output block: 16-bit
+//! samples times Q15 gains, eight samples at a time with SSE2 or NEON.
+//! Volume and pan changes ramp over RAMP_FRAMES so they never click, and
+//! a stopped voice ramps out before it is dropped.
+//!
+//! A sound may instead stay IMA ADPCM in memory. Each voice playing it
+//! carries its own decoder and refills a small ring of mix-rate PCM as
+//! the mix reaches it, so decoding costs only what is being heard.
+
+use super::adpcm::AdpcmDecoder;
+use std::sync::Arc;
+
+/// The mixer always produces interleaved stereo
+pub(crate) const OUTPUT_CHANNELS: usize = 2;
+
+/// Frames a volume, pan or stop takes to reach its new gain
+pub(crate) const RAMP_FRAMES: usize = 64;
+
+/// Q15 gain of 1.0 (as near as an i16 gets)
+const Q15_ONE: f32 = 32767.0;
+
+// =============================================================================
+// Sounds
+// =============================================================================
+
+/// A sound ready to mix, mono or stereo: PCM already at the mixer's
+/// rate, or IMA ADPCM that each voice decodes and resamples as it plays
+pub struct MixSound {
+    pub samples: Vec<i16>,
+    pub channels: usize,
+    adpcm: Option<AdpcmData>,
+}
+
+/// A compressed sound: the nibbles, the decoder state they start from,
+/// and the 32.32 source step per output frame
+struct AdpcmData {
+    bytes: Vec<u8>,
+    predictor: i32,
+    step_index: i32,
+    step: u64,
+}
+
+impl MixSound {
+    /// Resample `samples` from `sample_rate` to `mix_rate`. Sounds with
+    /// more than two channels keep their first two.
+    pub fn new(samples: &[i16], channels: u16, sample_rate: u32, mix_rate: u32) -> Self {
+        let channels = (channels as usize).max(1);
+        if channels > OUTPUT_CHANNELS {
+            let stereo: Vec<i16> = samples
+                .chunks_exact(channels)
+                .flat_map(|frame| [frame[0], frame[1]])
+                .collect();
+            return Self::new(&stereo, OUTPUT_CHANNELS as u16, sample_rate, mix_rate);
+        }
+
+        Self {
+            samples: resample(samples, channels, sample_rate, mix_rate),
+            channels,
+            adpcm: None,
+        }
+    }
+
+    /// Keep IMA ADPCM as it is (low nibble first, one decoder state for
+    /// every channel, as `decode_adpcm_with_state` reads it). Resident
+    /// memory is a quarter of the decoded PCM; the cost is decoding it
+    /// again on every play.
+    pub fn adpcm(bytes: Vec<u8>, channels: u16, sample_rate: u32, mix_rate: u32,
+                 predictor: i32, step_index: i32) -> Self {
+        let step = if sample_rate == 0 || mix_rate == 0 {
+            ONE
+        } else {
+            ((sample_rate as u64) << 32) / mix_rate as u64
+        };
+        Self {
+            samples: Vec::new(),
+            channels: (channels as usize).clamp(1, OUTPUT_CHANNELS),
+            adpcm: Some(AdpcmData { bytes, predictor, step_index, step }),
+        }
+    }
+
+    pub fn is_compressed(&self) -> bool {
+        self.adpcm.is_some()
+    }
+
+    /// Frames of PCM (none for a compressed sound)
+    pub fn frames(&self) -> usize {
+        self.samples.len() / self.channels
+    }
+
+    /// Memory the sound holds
+    pub fn resident_bytes(&self) -> usize {
+        self.samples.len() * std::mem::size_of::<i16>()
+            + self.adpcm.as_ref().map_or(0, |adpcm| adpcm.bytes.len())
+    }
+}
+
+/// 1.0 in 32.32 fixed point
+const ONE: u64 = 1 << 32;
+
+/// Linear-interpolating sample rate conversion of interleaved samples
+pub fn resample(samples: &[i16], channels: usize, from: u32, to: u32) -> Vec<i16> {
+    let channels = channels.max(1);
+    let frames = samples.len() / channels;
+    if from == to || from == 0 || to == 0 || frames == 0 {
+        return samples[..frames * channels].to_vec();
+    }
+
+    // 32.32 fixed-point position in the source
+    let step = ((from as u64) << 32) / to as u64;
+    let out_frames = ((frames as u64 * to as u64 + from as u64 - 1) / from as u64) as usize;
+    let mut out = Vec::with_capacity(out_frames * channels);
+
+    let mut position: u64 = 0;
+    for _ in 0..out_frames {
+        let index = (position >> 32) as usize;
+        let next = (index + 1).min(frames - 1);
+        let frac = ((position >> 16) & 0xFFFF) as i32;
+        for c in 0..channels {
+            let a = samples[index * channels + c] as i32;
+            let b = samples[next * channels + c] as i32;
+            out.push((a + (((b - a) * frac) >> 16)) as i16);
+        }
+        position += step;
+    }
+    out
+}
+
+/// Left and right gains for a volume (0..1) and pan (-1 left .. 1 right).
+/// Centre plays both sides at full volume; panning turns the far side down.
+pub fn pan_gains(volume: f32, pan: f32) -> [f32; 2] {
+    let volume = volume.clamp(0.0, 1.0);
+    let pan = pan.clamp(-1.0, 1.0);
+    [volume * (1.0 - pan).min(1.0), volume * (1.0 + pan).min(1.0)]
+}
+
+fn to_q15(gain: [f32; 2]) -> [i16; 2] {
+    [(gain[0] * Q15_ONE).round() as i16, (gain[1] * Q15_ONE).round() as i16]
+}
+
+// =============================================================================
+// Compressed Voices
+// =============================================================================
+
+/// Frames of PCM a compressed voice decodes ahead
+pub(crate) const RING_FRAMES: usize = 256;
+
+/// A playing compressed sound: the decoder, carried from one refill to
+/// the next, and the ring of mix-rate PCM it refills
+struct AdpcmStream {
+    decoder: AdpcmDecoder,
+    nibble: usize,              // Next nibble to decode
+    prev: [i16; 2],             // Source frames either side of the position
+    next: Option<[i16; 2]>,     // None past the last frame
+    frac: u64,                  // 32.32 position between prev and next
+    ring: Vec<i16>,
+    ring_pos: usize,            // Frames
+    ring_len: usize,
+}
+
+impl AdpcmStream {
+    fn new(sound: &MixSound) -> Self {
+        let mut stream = Self {
+            decoder: AdpcmDecoder::new(),
+            nibble: 0,
+            prev: [0; 2],
+            next: None,
+            frac: 0,
+            ring: vec![0; RING_FRAMES * sound.channels],
+            ring_pos: 0,
+            ring_len: 0,
+        };
+        stream.rewind(sound);
+        stream
+    }
+
+    fn rewind(&mut self, sound: &MixSound) {
+        if let Some(adpcm) = &sound.adpcm {
+            self.decoder = AdpcmDecoder::with_state(adpcm.predictor, adpcm.step_index);
+        }
+        self.nibble = 0;
+        self.next = self.decode_frame(sound);
+        self.frac = ONE;            // Step onto the first frame before using it
+        self.ring_pos = 0;
+        self.ring_len = 0;
+    }
+
+    fn decode_frame(&mut self, sound: &MixSound) -> Option<[i16; 2]> {
+        let bytes = &sound.adpcm.as_ref()?.bytes;
+        let channels = sound.channels;
+        if self.nibble + channels > bytes.len() * 2 {
+            return None;
+        }
+
+        let mut frame = [0i16; 2];
+        for sample in frame.iter_mut().take(channels) {
+            let byte = bytes[self.nibble / 2];
+            let nibble = if self.nibble & 1 == 0 { byte & 0x0F } else { byte >> 4 };
+            *sample = self.decoder.decode_nibble(nibble);
+            self.nibble += 1;
+        }
+        Some(frame)
+    }
+
+    /// Decode and resample up to RING_FRAMES frames into the ring
+    fn refill(&mut self, sound: &MixSound) -> usize {
+        let step = sound.adpcm.as_ref().map_or(ONE, |adpcm| adpcm.step);
+        let channels = sound.channels;
+        let mut frames = 0;
+        'fill: while frames < RING_FRAMES {
+            while self.frac >= ONE {
+                match self.next {
+                    Some(frame) => {
+                        self.prev = frame;
+                        self.next = self.decode_frame(sound);
+                        self.frac -= ONE;
+                    }
+                    None => break 'fill,
+                }
+            }
+
+            let next = self.next.unwrap_or(self.prev);
+            let frac = ((self.frac >> 16) & 0xFFFF) as i32;
+            for c in 0..channels {
+                let a = self.prev[c] as i32;
+                let b = next[c] as i32;
+                self.ring[frames * channels + c] = (a + (((b - a) * frac) >> 16)) as i16;
+            }
+            self.frac += step;
+            frames += 1;
+        }
+        self.ring_pos = 0;
+        self.ring_len = frames;
+        frames
+    }
+
+    /// Up to `max` frames of PCM, refilling the ring when it is used up;
+    /// None once the sound is over
+    fn take(&mut self, sound: &MixSound, max: usize, looping: bool) -> Option<&[i16]> {
+        if self.ring_pos >= self.ring_len && self.refill(sound) == 0 {
+            if !looping {
+                return None;
+            }
+            self.rewind(sound);
+            if self.refill(sound) == 0 {
+                return None;
+            }
+        }
+
+        let channels = sound.channels;
+        let count = max.min(self.ring_len - self.ring_pos);
+        let start = self.ring_pos * channels;
+        self.ring_pos += count;
+        Some(&self.ring[start..start + count * channels])
+    }
+}
+
+// =============================================================================
+// Voices
+// =============================================================================
+
+/// A voice's gain: ramping towards a target, then held as Q15
+struct Gain {
+    current: [f32; 2],
+    target: [f32; 2],
+    step: [f32; 2],
+    ramp: usize,            // Frames left in the ramp
+    q15: [i16; 2],          // Gain once the ramp is done
+}
+
+impl Gain {
+    fn new(gain: [f32; 2]) -> Self {
+        Self {
+            current: gain,
+            target: gain,
+            step: [0.0; 2],
+            ramp: 0,
+            q15: to_q15(gain),
+        }
+    }
+
+    fn retarget(&mut self, target: [f32; 2]) {
+        self.target = target;
+        self.step = [
+            (target[0] - self.current[0]) / RAMP_FRAMES as f32,
+            (target[1] - self.current[1]) / RAMP_FRAMES as f32,
+        ];
+        self.ramp = RAMP_FRAMES;
+    }
+
+    /// Add `src` (interleaved, `channels` wide) into `acc` (stereo)
+    fn mix(&mut self, acc: &mut [i32], src: &[i16], channels: usize) {
+        let count = src.len() / channels;
+        let acc = &mut acc[..count * OUTPUT_CHANNELS];
+        if self.ramp > 0 {
+            for frame in 0..count {
+                self.current[0] += self.step[0];
+                self.current[1] += self.step[1];
+                let left = src[frame * channels] as f32;
+                let right = src[frame * channels + channels - 1] as f32;
+                acc[frame * 2] += (left * self.current[0]) as i32;
+                acc[frame * 2 + 1] += (right * self.current[1]) as i32;
+            }
+
+            self.ramp -= count.min(self.ramp);
+            if self.ramp == 0 {
+                self.current = self.target;
+                self.q15 = to_q15(self.target);
+            }
+        } else if self.q15 != [0, 0] {
+            if channels == 1 {
+                kernels::mix_mono(acc, src, self.q15);
+            } else {
+                kernels::mix_stereo(acc, src, self.q15);
+            }
+        }
+    }
+}
+
+struct Voice {
+    id: i32,
+    sound: Arc<MixSound>,
+    position: usize,                // Frame, for PCM
+    stream: Option<AdpcmStream>,    // For compressed sounds
+    looping: bool,
+    paused: bool,
+    stopping: bool,                 // Ramping out; dropped once silent
+    volume: f32,
+    pan: f32,
+    gain: Gain,
+}
+
+impl Voice {
+    /// Add this voice into `acc` (interleaved stereo); false once it is done
+    fn mix_into(&mut self, acc: &mut [i32]) -> bool {
+        if self.paused {
+            return !self.stopping;
+        }
+
+        let frames = acc.len() / OUTPUT_CHANNELS;
+        let channels = self.sound.channels;
+        let mut done = 0;
+        while done < frames {
+            if self.stopping && self.gain.ramp == 0 {
+                return false;
+            }
+
+            // A ramp is mixed on its own, so the kernels see steady gains
+            let mut max = frames - done;
+            if self.gain.ramp > 0 {
+                max = max.min(self.gain.ramp);
+            }
+
+            let src = match &mut self.stream {
+                Some(stream) => match stream.take(&self.sound, max, self.looping) {
+                    Some(src) => src,
+                    None => return false,
+                },
+                None => {
+                    let total = self.sound.frames();
+                    if self.position >= total {
+                        if !self.looping || total == 0 {
+                            return false;
+                        }
+                        self.position = 0;
+                    }
+                    let count = max.min(total - self.position);
+                    let start = self.position * channels;
+                    self.position += count;
+                    &self.sound.samples[start..start + count * channels]
+                }
+            };
+
+            self.gain.mix(&mut acc[done * OUTPUT_CHANNELS..], src, channels);
+            done += src.len() / channels;
+        }
+        !(self.stopping && self.gain.ramp == 0)
+    }
+}
+
+// =============================================================================
+// Mixer
+// =============================================================================
+
+pub struct Mixer {
+    rate: u32,
+    master: f32,
+    voices: Vec<Voice>,
+    accum: Vec<i32>,
+}
+
+impl Mixer {
+    pub fn new(rate: u32) -> Self {
+        Self {
+            rate,
+            master: 1.0,
+            voices: Vec::new(),
+            accum: Vec::new(),
+        }
+    }
+
+    /// Output sample rate; sounds must be resampled to it
+    pub fn rate(&self) -> u32 {
+        self.rate
+    }
+
+    pub fn voice_count(&self) -> usize {
+        self.voices.len()
+    }
+
+    pub fn has_voice(&self, id: i32) -> bool {
+        self.voices.iter().any(|v| v.id == id)
+    }
+
+    fn voice(&mut self, id: i32) -> Option<&mut Voice> {
+        self.voices.iter_mut().find(|v| v.id == id)
+    }
+
+    /// Start a voice; it plays at full gain from its first sample
+    pub fn play(&mut self, id: i32, sound: Arc<MixSound>, volume: f32, pan: f32, looping: bool) {
+        let gain = pan_gains(volume * self.master, pan);
+        let stream = if sound.is_compressed() { Some(AdpcmStream::new(&sound)) } else { None };
+        self.voices.push(Voice {
+            id,
+            sound,
+            position: 0,
+            stream,
+            looping,
+            paused: false,
+            stopping: false,
+            volume,
+            pan,
+            gain: Gain::new(gain),
+        });
+    }
+
+    /// Ramp a voice out; returns false if there was no such voice
+    pub fn stop(&mut self, id: i32) -> bool {
+        match self.voice(id) {
+            Some(voice) => {
+                voice.stopping = true;
+                voice.gain.retarget([0.0; 2]);
+                true
+            }
+            None => false,
+        }
+    }
+
+    pub fn stop_all(&mut self) {
+        for voice in &mut self.voices {
+            voice.stopping = true;
+            voice.gain.retarget([0.0; 2]);
+        }
+    }
+
+    pub fn set_volume(&mut self, id: i32, volume: f32) -> bool {
+        let master = self.master;
+        match self.voice(id) {
+            Some(voice) => {
+                voice.volume = volume;
+                if !voice.stopping {
+                    voice.gain.retarget(pan_gains(volume * master, voice.pan));
+                }
+                true
+            }
+            None => false,
+        }
+    }
+
+    pub fn set_master_volume(&mut self, master: f32) {
+        self.master = master.clamp(0.0, 1.0);
+        for voice in &mut self.voices {
+            if !voice.stopping {
+                voice.gain.retarget(pan_gains(voice.volume * self.master, voice.pan));
+            }
+        }
+    }
+
+    pub fn set_paused(&mut self, id: i32, paused: bool) -> bool {
+        match self.voice(id) {
+            Some(voice) => {
+                voice.paused = paused;
+                true
+            }
+            None => false,
+        }
+    }
+
+    /// Fill `out` (interleaved stereo) with every voice mixed; voices that
+    /// end in this block are dropped
+    pub fn mix(&mut self, out: &mut [i16]) {
+        let len = out.len() / OUTPUT_CHANNELS * OUTPUT_CHANNELS;
+        let accum = &mut self.accum;
+        accum.clear();
+        accum.resize(len, 0);
+
+        self.voices.retain_mut(|voice| voice.mix_into(accum));
+
+        for (sample, &sum) in out.iter_mut().zip(accum.iter()) {
+            *sample = sum.clamp(i16::MIN as i32, i16::MAX as i32) as i16;
+        }
+        out[len..].fill(0);
+    }
+}
+
+// =============================================================================
+// Kernels
+// =============================================================================
+
+/// acc += sample * gain >> 15, with the gain alternating left/right.
+/// Every version gives bit-identical results.
+pub mod kernels {
+    /// Stereo source: `acc.len() == src.len()`
+    pub fn mix_stereo(acc: &mut [i32], src: &[i16], gains: [i16; 2]) {
+        let len = acc.len().min(src.len());
+        #[allow(unused_mut, unused_assignments)]
+        let mut done = 0;
+
+        #[cfg(all(target_arch = "x86_64", feature = "simd"))]
+        {
+            // Safety: x86_64 always has SSE2; the kernel stays within len
+            done = unsafe { x86_64_impl::mix_stereo_sse2(&mut acc[..len], &src[..len], gains) };
+        }
+
+        #[cfg(all(target_arch = "aarch64", feature = "simd"))]
+        {
+            // Safety: aarch64 always has NEON; the kernel stays within len
+            done = unsafe { aarch64_impl::mix_stereo_neon(&mut acc[..len], &src[..len], gains) };
+        }
+
+        mix_stereo_scalar(&mut acc[done..len], &src[done..len], gains);
+    }
+
+    /// Mono source played on both sides: `acc.len() == 2 * src.len()`
+    pub fn mix_mono(acc: &mut [i32], src: &[i16], gains: [i16; 2]) {
+        let len = (acc.len() / 2).min(src.len());
+        #[allow(unused_mut, unused_assignments)]
+        let mut done = 0;
+
+        #[cfg(all(target_arch = "x86_64", feature = "simd"))]
+        {
+            done = unsafe { x86_64_impl::mix_mono_sse2(&mut acc[..len * 2], &src[..len], gains) };
+        }
+
+        #[cfg(all(target_arch = "aarch64", feature = "simd"))]
+        {
+            done = unsafe { aarch64_impl::mix_mono_neon(&mut acc[..len * 2], &src[..len], gains) };
+        }
+
+        mix_mono_scalar(&mut acc[done * 2..len * 2], &src[done..len], gains);
+    }
+
+    pub fn mix_stereo_scalar(acc: &mut [i32], src: &[i16], gains: [i16; 2]) {
+        for (i, (a, &s)) in acc.iter_mut().zip(src).enumerate() {
+            *a += (s as i32 * gains[i & 1] as i32) >> 15;
+        }
+    }
+
+    pub fn mix_mono_scalar(acc: &mut [i32], src: &[i16], gains: [i16; 2]) {
+        for (a, &s) in acc.chunks_exact_mut(2).zip(src) {
+            a[0] += (s as i32 * gains[0] as i32) >> 15;
+            a[1] += (s as i32 * gains[1] as i32) >> 15;
+        }
+    }
+
+    #[cfg(all(target_arch = "x86_64", feature = "simd"))]
+    mod x86_64_impl {
+        use std::arch::x86_64::*;
+
+        /// Full 32-bit products of eight i16 pairs, shifted down and
+        /// added into acc[0..8]
+        #[inline]
+        unsafe fn accumulate8(acc: *mut i32, samples: __m128i, gains: __m128i) {
+            let lo = _mm_mullo_epi16(samples, gains);
+            let hi = _mm_mulhi_epi16(samples, gains);
+            let p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+            let p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+            let a0 = acc as *mut __m128i;
+            let a1 = acc.add(4) as *mut __m128i;
+            _mm_storeu_si128(a0, _mm_add_epi32(_mm_loadu_si128(a0), p0));
+            _mm_storeu_si128(a1, _mm_add_epi32(_mm_loadu_si128(a1), p1));
+        }
+
+        /// Returns samples done (a multiple of 8)
+        ///
+        /// # Safety
+        /// acc and src must be the same length
+        pub unsafe fn mix_stereo_sse2(acc: &mut [i32], src: &[i16], gains: [i16; 2]) -> usize {
+            let g = _mm_set1_epi32(((gains[1] as u16 as i32) << 16) | gains[0] as u16 as i32);
+            let chunks = src.len() / 8;
+            for i in 0..chunks {
+                let s = _mm_loadu_si128(src.as_ptr().add(i * 8) as *const __m128i);
+                accumulate8(acc.as_mut_ptr().add(i * 8), s, g);
+            }
+            chunks * 8
+        }
+
+        /// Returns source samples done (a multiple of 8)
+        ///
+        /// # Safety
+        /// acc must be twice the length of src
+        pub unsafe fn mix_mono_sse2(acc: &mut [i32], src: &[i16], gains: [i16; 2]) -> usize {
+            let g = _mm_set1_epi32(((gains[1] as u16 as i32) << 16) | gains[0] as u16 as i32);
+            let chunks = src.len() / 8;
+            for i in 0..chunks {
+                let s = _mm_loadu_si128(src.as_ptr().add(i * 8) as *const __m128i);
+                let out = acc.as_mut_ptr().add(i * 16);
+                accumulate8(out, _mm_unpacklo_epi16(s, s), g);
+                accumulate8(out.add(8), _mm_unpackhi_epi16(s, s), g);
+            }
+            chunks * 8
+        }
+    }
+
+    #[cfg(all(target_arch = "aarch64", feature = "simd"))]
+    mod aarch64_impl {
+        use std::arch::aarch64::*;
+
+        #[inline]
+        unsafe fn accumulate8(acc: *mut i32, samples: int16x8_t, gains: int16x4_t) {
+            let p0 = vshrq_n_s32::<15>(vmull_s16(vget_low_s16(samples), gains));
+            let p1 = vshrq_n_s32::<15>(vmull_s16(vget_high_s16(samples), gains));
+            vst1q_s32(acc, vaddq_s32(vld1q_s32(acc), p0));
+            vst1q_s32(acc.add(4), vaddq_s32(vld1q_s32(acc.add(4)), p1));
+        }
+
+        /// # Safety
+        /// acc and src must be the same length
+        pub unsafe fn mix_stereo_neon(acc: &mut [i32], src: &[i16], gains: [i16; 2]) -> usize {
+            let pair = [gains[0], gains[1], gains[0], gains[1]];
+            let g = vld1_s16(pair.as_ptr());
+            let chunks = src.len() / 8;
+            for i in 0..chunks {
+                let s = vld1q_s16(src.as_ptr().add(i * 8));
+                accumulate8(acc.as_mut_ptr().add(i * 8), s, g);
+            }
+            chunks * 8
+        }
+
+        /// # Safety
+        /// acc must be twice the length of src
+        pub unsafe fn mix_mono_neon(acc: &mut [i32], src: &[i16], gains: [i16; 2]) -> usize {
+            let pair = [gains[0], gains[1], gains[0], gains[1]];
+            let g = vld1_s16(pair.as_ptr());
+            let chunks = src.len() / 8;
+            for i in 0..chunks {
+                let s = vld1q_s16(src.as_ptr().add(i * 8));
+                let out = acc.as_mut_ptr().add(i * 16);
+                accumulate8(out, vzip1q_s16(s, s), g);
+                accumulate8(out.add(8), vzip2q_s16(s, s), g);
+            }
+            chunks * 8
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn noise(len: usize, seed: u32) -> Vec<i16> {
+        let mut state = seed;
+        (0..len)
+            .map(|_| {
+                state = state.wrapping_mul(1664525).wrapping_add(1013904223);
+                (state >> 16) as i16
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_kernels_match_scalar() {
+        let gains = [32767, -12345];
+        for len in [0, 1, 7, 8, 9, 63, 256] {
+            let src = noise(len * 2, len as u32);
+            let mut expected = vec![100; len * 2];
+            let mut actual = expected.clone();
+            kernels::mix_stereo_scalar(&mut expected, &src, gains);
+            kernels::mix_stereo(&mut actual, &src, gains);
+            assert_eq!(actual, expected, "stereo, {} frames", len);
+
+            let src = noise(len, len as u32 + 1);
+            let mut expected = vec![-100; len * 2];
+            let mut actual = expected.clone();
+            kernels::mix_mono_scalar(&mut expected, &src, gains);
+            kernels::mix_mono(&mut actual, &src, gains);
+            assert_eq!(actual, expected, "mono, {} frames", len);
+        }
+    }
+
+    #[test]
+    fn test_resample_interpolates_to_the_new_rate() {
+        let up = resample(&[0, 1000, 2000], 1, 22050, 44100);
+        assert_eq!(up, vec![0, 500, 1000, 1500, 2000, 2000]);
+
+        let stereo = resample(&[0, -100, 1000, -200], 2, 22050, 44100);
+        assert_eq!(stereo, vec![0, -100, 500, -150, 1000, -200, 1000, -200]);
+
+        assert_eq!(resample(&[1, 2, 3], 1, 22050, 22050), vec![1, 2, 3]);
+        assert_eq!(resample(&[1, 2, 3, 4], 1, 44100, 22050), vec![1, 3]);
+    }
+
+    #[test]
+    fn test_sounds_keep_two_channels() {
+        let sound = MixSound::new(&[1, 2, 3, 4, 5, 6], 3, 22050, 22050);
+        assert_eq!(sound.channels, 2);
+        assert_eq!(sound.samples, vec![1, 2, 4, 5]);
+    }
+
+    #[test]
+    fn test_pan_gains() {
+        assert_eq!(pan_gains(1.0, 0.0), [1.0, 1.0]);
+        assert_eq!(pan_gains(0.5, -1.0), [0.5, 0.0]);
+        assert_eq!(pan_gains(1.0, 0.5), [0.5, 1.0]);
+    }
+
+    #[test]
+    fn test_voices_sum_and_end() {
+        let mut mixer = Mixer::new(22050);
+        let sound = Arc::new(MixSound::new(&[1000; 10], 1, 22050, 22050));
+        mixer.play(1, sound.clone(), 1.0, 0.0, false);
+        mixer.play(2, sound, 1.0, -1.0, false);
+
+        let mut out = vec![0i16; 16];
+        mixer.mix(&mut out);
+        assert_eq!(&out[..2], &[1998, 999]);
+        assert_eq!(mixer.voice_count(), 2);
+
+        mixer.mix(&mut out);
+        assert_eq!(&out[2..6], &[1998, 999, 0, 0]);
+        assert_eq!(mixer.voice_count(), 0);
+    }
+
+    #[test]
+    fn test_looping_voice_wraps() {
+        let mut mixer = Mixer::new(22050);
+        let sound = Arc::new(MixSound::new(&[100, 200], 1, 22050, 22050));
+        mixer.play(1, sound, 1.0, 0.0, true);
+
+        let mut out = vec![0i16; 10];
+        mixer.mix(&mut out);
+        assert_eq!(out, vec![99, 99, 199, 199, 99, 99, 199, 199, 99, 99]);
+        assert!(mixer.has_voice(1));
+    }
+
+    #[test]
+    fn test_changes_ramp() {
+        let mut mixer = Mixer::new(22050);
+        let sound = Arc::new(MixSound::new(&[10000; 1000], 1, 22050, 22050));
+        mixer.play(1, sound, 1.0, 0.0, true);
+        mixer.set_volume(1, 0.5);
+
+        let mut out = vec![0i16; RAMP_FRAMES * 2 + 4];
+        mixer.mix(&mut out);
+        assert!(out[0] < 10000 && out[0] > 9800, "first frame moves one step");
+        assert!(out[RAMP_FRAMES] < out[0], "gain falls through the ramp");
+        assert_eq!(out[RAMP_FRAMES * 2], 5000, "ramp ends on the target");
+
+        // Stopping ramps out, then drops the voice
+        assert!(mixer.stop(1));
+        assert!(!mixer.stop(2));
+        mixer.mix(&mut out);
+        assert!(out[0] > 0 && out[RAMP_FRAMES * 2 - 2] < out[0]);
+        assert_eq!(out[RAMP_FRAMES * 2], 0);
+        assert_eq!(mixer.voice_count(), 0);
+    }
+
+    #[test]
+    fn test_paused_voice_holds_its_place() {
+        let mut mixer = Mixer::new(22050);
+        let sound = Arc::new(MixSound::new(&[1, 2, 3, 4], 1, 22050, 22050));
+        mixer.play(7, sound, 1.0, 0.0, false);
+        assert!(mixer.set_paused(7, true));
+
+        let mut out = vec![5i16; 4];
+        mixer.mix(&mut out);
+        assert_eq!(out, vec![0; 4]);
+
+        mixer.set_paused(7, false);
+        mixer.mix(&mut out);
+        assert_eq!(out, vec![0, 0, 1, 1]);
+    }
+
+    /// Mix a sound alone, in blocks of `block` frames, until it ends
+    fn mix_all(sound: MixSound, block: usize) -> Vec<i16> {
+        let mut mixer = Mixer::new(44100);
+        mixer.play(1, Arc::new(sound), 1.0, 0.0, false);
+        let mut all = Vec::new();
+        let mut out = vec![0i16; block * 2];
+        while mixer.voice_count() > 0 {
+            mixer.mix(&mut out);
+            all.extend_from_slice(&out);
+        }
+        all
+    }
+
+    #[test]
+    fn test_compressed_sounds_play_as_decoded() {
+        let bytes: Vec<u8> = noise(700, 9).iter().map(|&s| s as u8).collect();
+        for (channels, rate) in [(1, 44100), (1, 22050), (2, 22050)] {
+            let pcm = super::super::adpcm::decode_adpcm_with_state(&bytes, 100, 20);
+            let expected = mix_all(MixSound::new(&pcm, channels, rate, 44100), 100);
+            let sound = MixSound::adpcm(bytes.clone(), channels, rate, 44100, 100, 20);
+            assert!(sound.is_compressed());
+            assert_eq!(sound.resident_bytes(), 700);
+            assert_eq!(mix_all(sound, 100), expected, "{} channels at {} Hz", channels, rate);
+        }
+    }
+
+    #[test]
+    fn test_compressed_voice_loops_from_its_first_state() {
+        let bytes = vec![0x77u8; 300];
+        let mut mixer = Mixer::new(22050);
+        mixer.play(1, Arc::new(MixSound::adpcm(bytes, 1, 22050, 22050, 0, 0)), 1.0, 0.0, true);
+
+        let mut first = vec![0i16; 600 * 2];
+        let mut second = first.clone();
+        mixer.mix(&mut first);
+        mixer.mix(&mut second);
+        assert_eq!(first, second, "each pass decodes the same");
+        assert!(mixer.has_voice(1));
+    }
+
+    #[test]
+    fn test_clipping_saturates() {
+        let mut mixer = Mixer::new(22050);
+        let sound = Arc::new(MixSound::new(&[30000, -30000], 1, 22050, 22050));
+        mixer.play(1, sound.clone(), 1.0, 0.0, false);
+        mixer.play(2, sound, 1.0, 0.0, false);
+
+        let mut out = vec![0i16; 4];
+        mixer.mix(&mut out);
+        assert_eq!(out, vec![i16::MAX, i16::MAX, i16::MIN, i16::MIN]);
+    }
+}
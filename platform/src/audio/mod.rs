@@ -4,12 +4,17 @@
 //! audio on a dedicated thread.
 
 pub mod adpcm;
+pub mod mixer;
 
 use crate::error::PlatformError;
-use rodio::{OutputStream, OutputStreamHandle, Sink, Source};
+use mixer::{MixSound, Mixer, OUTPUT_CHANNELS};
+use rodio::cpal::traits::HostTrait;
+use rodio::{DeviceTrait, OutputStream, Sink, Source};
 use std::sync::{Arc, Mutex, mpsc};
-use std::collections::HashMap;
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::collections::{HashMap, VecDeque};
 use std::thread::{self, JoinHandle};
+use std::time::Instant;
 use once_cell::sync::Lazy;
 
 /// Audio configuration
@@ -49,19 +54,40 @@ pub struct SoundData {
     pub channels: u16,
 }
 
+/// IMA ADPCM kept compressed, with the decoder state it starts from
+pub struct AdpcmSoundData {
+    pub bytes: Vec<u8>,
+    pub sample_rate: u32,
+    pub channels: u16,
+    pub predictor: i32,
+    pub step_index: i32,
+}
+
 /// Commands sent to the audio thread
 enum AudioCommand {
     CreateSound {
         id: SoundHandle,
         data: SoundData,
     },
+    CreateAdpcmSound {
+        id: SoundHandle,
+        data: AdpcmSoundData,
+    },
     DestroySound(SoundHandle),
     Play {
         sound_id: SoundHandle,
         play_id: PlayHandle,
         volume: f32,
+        pan: f32,
         looping: bool,
     },
+    PlayStream {
+        play_id: PlayHandle,
+        stream: SharedStream,
+        sample_rate: u32,
+        channels: u16,
+        volume: f32,
+    },
     Stop(PlayHandle),
     StopAll,
     SetVolume { handle: PlayHandle, volume: f32 },
@@ -101,6 +127,144 @@ struct AudioController {
 /// Global audio controller singleton
 static AUDIO: Lazy<Mutex<Option<AudioController>>> = Lazy::new(|| Mutex::new(None));
 
+// =============================================================================
+// Streamed Sounds
+// =============================================================================
+
+/// Samples queued for a streamed sound: the game writes decoded PCM in,
+/// the mixer drains it. Holds whole frames only, so a stereo stream never
+/// drifts out of channel order.
+struct StreamBuffer {
+    samples: VecDeque<i16>,
+    capacity: usize,
+    channels: usize,
+    finished: bool,
+}
+
+impl StreamBuffer {
+    fn new(capacity: usize, channels: usize) -> Self {
+        let channels = channels.max(1);
+        let capacity = capacity.max(channels) / channels * channels;
+        Self {
+            samples: VecDeque::with_capacity(capacity),
+            capacity,
+            channels,
+            finished: false,
+        }
+    }
+
+    /// Queue as many whole frames as fit; returns samples taken
+    fn write(&mut self, data: &[i16]) -> usize {
+        if self.finished {
+            return 0;
+        }
+        let room = self.capacity - self.samples.len();
+        let count = data.len().min(room) / self.channels * self.channels;
+        self.samples.extend(&data[..count]);
+        count
+    }
+
+    /// Move up to `max` samples (whole frames) onto the end of `out`
+    fn read(&mut self, out: &mut Vec<i16>, max: usize) -> usize {
+        let count = self.samples.len().min(max) / self.channels * self.channels;
+        out.extend(self.samples.drain(..count));
+        count
+    }
+
+    /// No more data will come and everything queued has been played
+    fn is_drained(&self) -> bool {
+        self.finished && self.samples.is_empty()
+    }
+}
+
+type SharedStream = Arc<Mutex<StreamBuffer>>;
+
+/// Open streams by play handle, shared with their sources on the audio thread
+static STREAMS: Lazy<Mutex<HashMap<PlayHandle, SharedStream>>> = Lazy::new(|| Mutex::new(HashMap::new()));
+
+/// Frames a stream source takes from its buffer per lock
+const STREAM_BATCH_FRAMES: usize = 256;
+
+/// Frames of silence played when a stream runs dry before it is finished
+const STREAM_UNDERRUN_FRAMES: usize = 64;
+
+/// Frames of sound effects mixed per lock on the mixer
+const MIX_BLOCK_FRAMES: usize = 256;
+
+/// Mix rate when the device doesn't report one
+const MIX_DEFAULT_RATE: u32 = 44100;
+
+// =============================================================================
+// Mixer Statistics
+// =============================================================================
+
+/// Mixer-side timing of sound effects and streamed sounds
+///
+/// rodio owns the device callback, so the part we can time is our own:
+/// each block of sound effects the mixer sums, and each stream refill it
+/// performs while filling an output buffer (the lock on the game's queue
+/// plus the copy). Long refills mean the mixer thread is being starved;
+/// underruns with short refills mean the game isn't queuing far enough
+/// ahead.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct AudioMixerStats {
+    /// Streams that ran dry before being finished (heard as a gap)
+    pub underruns: u32,
+    /// Stream buffers refilled by the mixer
+    pub buffers: u32,
+    /// Last refill, microseconds
+    pub last_buffer_us: u32,
+    /// Longest refill since the previous read of the stats
+    pub max_buffer_us: u32,
+    /// All refills, microseconds
+    pub total_buffer_us: u64,
+    /// Sound effect voices in the last mixed block
+    pub mix_voices: u32,
+    /// Last sound effect block (MIX_BLOCK_FRAMES), microseconds
+    pub last_mix_us: u32,
+    /// Longest sound effect block since the previous read of the stats
+    pub max_mix_us: u32,
+}
+
+static MIX_UNDERRUNS: AtomicU32 = AtomicU32::new(0);
+static MIX_BUFFERS: AtomicU32 = AtomicU32::new(0);
+static MIX_LAST_NS: AtomicU64 = AtomicU64::new(0);
+static MIX_MAX_NS: AtomicU64 = AtomicU64::new(0);
+static MIX_TOTAL_NS: AtomicU64 = AtomicU64::new(0);
+static MIX_VOICES: AtomicU32 = AtomicU32::new(0);
+static MIX_BLOCK_LAST_NS: AtomicU64 = AtomicU64::new(0);
+static MIX_BLOCK_MAX_NS: AtomicU64 = AtomicU64::new(0);
+
+fn record_mix_buffer(start: Instant) {
+    let ns = start.elapsed().as_nanos() as u64;
+    MIX_BUFFERS.fetch_add(1, Ordering::Relaxed);
+    MIX_LAST_NS.store(ns, Ordering::Relaxed);
+    MIX_MAX_NS.fetch_max(ns, Ordering::Relaxed);
+    MIX_TOTAL_NS.fetch_add(ns, Ordering::Relaxed);
+}
+
+fn record_mix_block(start: Instant, voices: usize) {
+    let ns = start.elapsed().as_nanos() as u64;
+    MIX_VOICES.store(voices as u32, Ordering::Relaxed);
+    MIX_BLOCK_LAST_NS.store(ns, Ordering::Relaxed);
+    MIX_BLOCK_MAX_NS.fetch_max(ns, Ordering::Relaxed);
+}
+
+/// Read the mixer statistics; the peaks restart from each read
+pub fn take_mixer_stats() -> AudioMixerStats {
+    AudioMixerStats {
+        underruns: MIX_UNDERRUNS.load(Ordering::Relaxed),
+        buffers: MIX_BUFFERS.load(Ordering::Relaxed),
+        last_buffer_us: (MIX_LAST_NS.load(Ordering::Relaxed) / 1000) as u32,
+        max_buffer_us: (MIX_MAX_NS.swap(0, Ordering::Relaxed) / 1000) as u32,
+        total_buffer_us: MIX_TOTAL_NS.load(Ordering::Relaxed) / 1000,
+        mix_voices: MIX_VOICES.load(Ordering::Relaxed),
+        last_mix_us: (MIX_BLOCK_LAST_NS.load(Ordering::Relaxed) / 1000) as u32,
+        max_mix_us: (MIX_BLOCK_MAX_NS.swap(0, Ordering::Relaxed) / 1000) as u32,
+    }
+}
+
 // =============================================================================
 // Audio Thread
 // =============================================================================
@@ -109,8 +273,19 @@ fn audio_thread(
     command_rx: mpsc::Receiver<AudioCommand>,
     shared: Arc<Mutex<SharedState>>,
 ) {
-    // Initialize audio output on this thread
-    let (_stream, stream_handle) = match OutputStream::try_default() {
+    // Initialize audio output on this thread, at the device's own rate so
+    // the sound effect mix goes out unconverted
+    let device = rodio::cpal::default_host().default_output_device();
+    let mix_rate = device
+        .as_ref()
+        .and_then(|d| d.default_output_config().ok())
+        .map(|config| config.sample_rate().0)
+        .unwrap_or(MIX_DEFAULT_RATE);
+    let opened = match device.as_ref() {
+        Some(d) => OutputStream::try_from_device(d),
+        None => OutputStream::try_default(),
+    };
+    let (_stream, stream_handle) = match opened {
         Ok((s, h)) => (s, h),
         Err(e) => {
             eprintln!("[AUDIO] Failed to initialize output stream: {}", e);
@@ -118,7 +293,21 @@ fn audio_thread(
         }
     };
 
-    let mut sounds: HashMap<SoundHandle, Arc<SoundData>> = HashMap::new();
+    // Sound effects all go through one mixer on one sink; streams keep
+    // a sink each
+    let mixer = Arc::new(Mutex::new(Mixer::new(mix_rate)));
+    let mix_sink = match Sink::try_new(&stream_handle) {
+        Ok(sink) => {
+            sink.append(MixerSource::new(mixer.clone()));
+            Some(sink)
+        }
+        Err(e) => {
+            eprintln!("[AUDIO] Failed to start the sound effect mixer: {}", e);
+            None
+        }
+    };
+
+    let mut sounds: HashMap<SoundHandle, Arc<MixSound>> = HashMap::new();
     let mut playing: HashMap<PlayHandle, Sink> = HashMap::new();
     let mut master_volume: f32 = 1.0;
 
@@ -126,7 +315,18 @@ fn audio_thread(
         match command_rx.recv() {
             Ok(cmd) => match cmd {
                 AudioCommand::CreateSound { id, data } => {
-                    sounds.insert(id, Arc::new(data));
+                    // Resampled once here, not on every play
+                    let sound = MixSound::new(&data.samples, data.channels, data.sample_rate, mix_rate);
+                    sounds.insert(id, Arc::new(sound));
+                    if let Ok(mut s) = shared.lock() {
+                        s.sound_count = sounds.len();
+                    }
+                }
+                AudioCommand::CreateAdpcmSound { id, data } => {
+                    // Decoded by each voice as it plays
+                    let sound = MixSound::adpcm(data.bytes, data.channels, data.sample_rate, mix_rate,
+                                                data.predictor, data.step_index);
+                    sounds.insert(id, Arc::new(sound));
                     if let Ok(mut s) = shared.lock() {
                         s.sound_count = sounds.len();
                     }
@@ -137,45 +337,53 @@ fn audio_thread(
                         s.sound_count = sounds.len();
                     }
                 }
-                AudioCommand::Play { sound_id, play_id, volume, looping } => {
+                AudioCommand::Play { sound_id, play_id, volume, pan, looping } => {
                     if let Some(sound) = sounds.get(&sound_id) {
-                        let source = SoundSource {
-                            samples: sound.samples.clone(),
-                            sample_rate: sound.sample_rate,
-                            channels: sound.channels,
-                            position: 0,
-                            looping,
-                        };
-
-                        if let Ok(sink) = Sink::try_new(&stream_handle) {
-                            sink.set_volume(volume * master_volume);
-                            sink.append(source);
-                            playing.insert(play_id, sink);
-                            if let Ok(mut s) = shared.lock() {
-                                s.playing_count = playing.len();
-                            }
+                        if let Ok(mut mixer) = mixer.lock() {
+                            mixer.play(play_id, sound.clone(), volume, pan, looping);
                         }
                     }
                 }
-                AudioCommand::Stop(handle) => {
-                    if let Some(sink) = playing.remove(&handle) {
-                        sink.stop();
+                AudioCommand::PlayStream { play_id, stream, sample_rate, channels, volume } => {
+                    let source = StreamSource {
+                        stream,
+                        pending: Vec::new(),
+                        position: 0,
+                        sample_rate,
+                        channels,
+                    };
+
+                    if let Ok(sink) = Sink::try_new(&stream_handle) {
+                        sink.set_volume(volume * master_volume);
+                        sink.append(source);
+                        playing.insert(play_id, sink);
+                    } else if let Ok(mut streams) = STREAMS.lock() {
+                        // Nothing will drain it; let the writer see it end
+                        streams.remove(&play_id);
                     }
-                    if let Ok(mut s) = shared.lock() {
-                        s.playing_count = playing.len();
+                }
+                AudioCommand::Stop(handle) => {
+                    let mixed = mixer.lock().map(|mut m| m.stop(handle)).unwrap_or(false);
+                    if !mixed {
+                        if let Some(sink) = playing.remove(&handle) {
+                            sink.stop();
+                        }
                     }
                 }
                 AudioCommand::StopAll => {
+                    if let Ok(mut mixer) = mixer.lock() {
+                        mixer.stop_all();
+                    }
                     for (_, sink) in playing.drain() {
                         sink.stop();
                     }
-                    if let Ok(mut s) = shared.lock() {
-                        s.playing_count = 0;
-                    }
                 }
                 AudioCommand::SetVolume { handle, volume } => {
-                    if let Some(sink) = playing.get(&handle) {
-                        sink.set_volume(volume * master_volume);
+                    let mixed = mixer.lock().map(|mut m| m.set_volume(handle, volume)).unwrap_or(false);
+                    if !mixed {
+                        if let Some(sink) = playing.get(&handle) {
+                            sink.set_volume(volume * master_volume);
+                        }
                     }
                 }
                 AudioCommand::SetMasterVolume(vol) => {
@@ -184,26 +392,41 @@ fn audio_thread(
                         s.master_volume = master_volume;
                     }
                     // Update all playing sounds
+                    if let Ok(mut mixer) = mixer.lock() {
+                        mixer.set_master_volume(master_volume);
+                    }
                     for sink in playing.values() {
                         sink.set_volume(master_volume);
                     }
                 }
                 AudioCommand::Pause(handle) => {
-                    if let Some(sink) = playing.get(&handle) {
-                        sink.pause();
+                    let mixed = mixer.lock().map(|mut m| m.set_paused(handle, true)).unwrap_or(false);
+                    if !mixed {
+                        if let Some(sink) = playing.get(&handle) {
+                            sink.pause();
+                        }
                     }
                 }
                 AudioCommand::Resume(handle) => {
-                    if let Some(sink) = playing.get(&handle) {
-                        sink.play();
+                    let mixed = mixer.lock().map(|mut m| m.set_paused(handle, false)).unwrap_or(false);
+                    if !mixed {
+                        if let Some(sink) = playing.get(&handle) {
+                            sink.play();
+                        }
                     }
                 }
                 AudioCommand::Shutdown => {
                     // Stop all sounds and exit
+                    if let Some(sink) = &mix_sink {
+                        sink.stop();
+                    }
                     for (_, sink) in playing.drain() {
                         sink.stop();
                     }
                     sounds.clear();
+                    if let Ok(mut streams) = STREAMS.lock() {
+                        streams.clear();
+                    }
                     break;
                 }
             },
@@ -213,10 +436,25 @@ fn audio_thread(
             }
         }
 
-        // Clean up finished sounds
-        playing.retain(|_, sink| !sink.empty());
+        // Clean up finished sounds (and the streams that fed them)
+        let mut finished = Vec::new();
+        playing.retain(|handle, sink| {
+            let done = sink.empty();
+            if done {
+                finished.push(*handle);
+            }
+            !done
+        });
+        if !finished.is_empty() {
+            if let Ok(mut streams) = STREAMS.lock() {
+                for handle in &finished {
+                    streams.remove(handle);
+                }
+            }
+        }
+        let voices = mixer.lock().map(|m| m.voice_count()).unwrap_or(0);
         if let Ok(mut s) = shared.lock() {
-            s.playing_count = playing.len();
+            s.playing_count = playing.len() + voices;
         }
     }
 }
@@ -323,14 +561,43 @@ pub fn create_sound(
     channels: u16,
     bits_per_sample: u16,
 ) -> SoundHandle {
-    let samples = convert_to_i16(data, bits_per_sample);
+    create_sound_from_samples(convert_to_i16(data, bits_per_sample), sample_rate, channels)
+}
 
-    let sound_data = SoundData {
+/// Create a sound from decoded 16-bit samples, taking ownership of them
+pub fn create_sound_from_samples(
+    samples: Vec<i16>,
+    sample_rate: u32,
+    channels: u16,
+) -> SoundHandle {
+    let data = SoundData {
         samples,
         sample_rate,
         channels,
     };
+    send_create_sound(|id| AudioCommand::CreateSound { id, data })
+}
 
+/// Create a sound that stays IMA ADPCM in memory; each play decodes it
+/// from the given decoder state as the mixer reaches it
+pub fn create_sound_from_adpcm(
+    bytes: Vec<u8>,
+    sample_rate: u32,
+    channels: u16,
+    predictor: i32,
+    step_index: i32,
+) -> SoundHandle {
+    let data = AdpcmSoundData {
+        bytes,
+        sample_rate,
+        channels,
+        predictor,
+        step_index,
+    };
+    send_create_sound(|id| AudioCommand::CreateAdpcmSound { id, data })
+}
+
+fn send_create_sound(command: impl FnOnce(SoundHandle) -> AudioCommand) -> SoundHandle {
     if let Ok(guard) = AUDIO.lock() {
         if let Some(controller) = guard.as_ref() {
             if let Ok(mut shared) = controller.shared.lock() {
@@ -339,10 +606,7 @@ pub fn create_sound(
                 // Update sound count immediately
                 shared.sound_count += 1;
 
-                let _ = controller.command_tx.send(AudioCommand::CreateSound {
-                    id: handle,
-                    data: sound_data,
-                });
+                let _ = controller.command_tx.send(command(handle));
 
                 return handle;
             }
@@ -406,7 +670,7 @@ fn convert_to_i16(data: &[u8], bits_per_sample: u16) -> Vec<i16> {
 // =============================================================================
 
 /// Play a sound with volume and pan control
-pub fn play(handle: SoundHandle, volume: f32, _pan: f32, looping: bool) -> PlayHandle {
+pub fn play(handle: SoundHandle, volume: f32, pan: f32, looping: bool) -> PlayHandle {
     if let Ok(guard) = AUDIO.lock() {
         if let Some(controller) = guard.as_ref() {
             if let Ok(mut shared) = controller.shared.lock() {
@@ -417,6 +681,7 @@ pub fn play(handle: SoundHandle, volume: f32, _pan: f32, looping: bool) -> PlayH
                     sound_id: handle,
                     play_id: play_handle,
                     volume,
+                    pan,
                     looping,
                 });
 
@@ -430,6 +695,9 @@ pub fn play(handle: SoundHandle, volume: f32, _pan: f32, looping: bool) -> PlayH
 
 /// Stop a playing sound
 pub fn stop(handle: PlayHandle) {
+    if let Ok(mut streams) = STREAMS.lock() {
+        streams.remove(&handle);
+    }
     if let Ok(guard) = AUDIO.lock() {
         if let Some(controller) = guard.as_ref() {
             let _ = controller.command_tx.send(AudioCommand::Stop(handle));
@@ -439,6 +707,9 @@ pub fn stop(handle: PlayHandle) {
 
 /// Stop all playing sounds
 pub fn stop_all() {
+    if let Ok(mut streams) = STREAMS.lock() {
+        streams.clear();
+    }
     if let Ok(guard) = AUDIO.lock() {
         if let Some(controller) = guard.as_ref() {
             let _ = controller.command_tx.send(AudioCommand::StopAll);
@@ -447,8 +718,14 @@ pub fn stop_all() {
 }
 
 /// Check if a sound is currently playing
-/// Note: This is approximate due to the threaded nature
-pub fn is_playing(_handle: PlayHandle) -> bool {
+/// Note: This is approximate due to the threaded nature, except for
+/// streams, which play until finished and drained
+pub fn is_playing(handle: PlayHandle) -> bool {
+    if let Ok(streams) = STREAMS.lock() {
+        if let Some(stream) = streams.get(&handle) {
+            return stream.lock().map(|buffer| !buffer.is_drained()).unwrap_or(false);
+        }
+    }
     if let Ok(guard) = AUDIO.lock() {
         if let Some(controller) = guard.as_ref() {
             if let Ok(shared) = controller.shared.lock() {
@@ -502,41 +779,175 @@ pub fn get_playing_count() -> usize {
 }
 
 // =============================================================================
-// Custom Sound Source for rodio
+// Streaming
 // =============================================================================
 
-/// Custom sound source implementing rodio's Source trait
-struct SoundSource {
-    samples: Vec<i16>,
-    sample_rate: u32,
-    channels: u16,
+/// Start a streamed sound with room for `capacity` queued samples.
+/// It plays silence until written to and ends once finished and drained.
+pub fn open_stream(sample_rate: u32, channels: u16, capacity: usize, volume: f32) -> PlayHandle {
+    if let Ok(guard) = AUDIO.lock() {
+        if let Some(controller) = guard.as_ref() {
+            if let Ok(mut shared) = controller.shared.lock() {
+                let play_handle = shared.next_play_handle;
+                shared.next_play_handle += 1;
+
+                let stream = Arc::new(Mutex::new(StreamBuffer::new(capacity, channels as usize)));
+                if let Ok(mut streams) = STREAMS.lock() {
+                    streams.insert(play_handle, stream.clone());
+                }
+
+                let _ = controller.command_tx.send(AudioCommand::PlayStream {
+                    play_id: play_handle,
+                    stream,
+                    sample_rate,
+                    channels,
+                    volume,
+                });
+
+                return play_handle;
+            }
+        }
+    }
+
+    INVALID_PLAY_HANDLE
+}
+
+fn find_stream(handle: PlayHandle) -> Option<SharedStream> {
+    STREAMS.lock().ok().and_then(|streams| streams.get(&handle).cloned())
+}
+
+/// Queue samples on a stream; returns how many fit
+pub fn write_stream(handle: PlayHandle, samples: &[i16]) -> usize {
+    find_stream(handle)
+        .and_then(|stream| stream.lock().ok().map(|mut buffer| buffer.write(samples)))
+        .unwrap_or(0)
+}
+
+/// Samples written to a stream and not yet taken by the mixer
+pub fn get_stream_queued(handle: PlayHandle) -> usize {
+    find_stream(handle)
+        .and_then(|stream| stream.lock().ok().map(|buffer| buffer.samples.len()))
+        .unwrap_or(0)
+}
+
+/// Mark a stream complete; it stops once the queued samples have played
+pub fn finish_stream(handle: PlayHandle) {
+    if let Some(stream) = find_stream(handle) {
+        if let Ok(mut buffer) = stream.lock() {
+            buffer.finished = true;
+        }
+    }
+}
+
+// =============================================================================
+// Custom Sound Sources for rodio
+// =============================================================================
+
+/// Source that plays the sound effect mixer, a block at a time
+struct MixerSource {
+    mixer: Arc<Mutex<Mixer>>,
+    block: Vec<i16>,
     position: usize,
-    looping: bool,
+    sample_rate: u32,
 }
 
-impl Iterator for SoundSource {
+impl MixerSource {
+    fn new(mixer: Arc<Mutex<Mixer>>) -> Self {
+        let sample_rate = mixer.lock().map(|m| m.rate()).unwrap_or(MIX_DEFAULT_RATE);
+        let block = vec![0; MIX_BLOCK_FRAMES * OUTPUT_CHANNELS];
+        Self {
+            mixer,
+            position: block.len(),
+            block,
+            sample_rate,
+        }
+    }
+}
+
+impl Iterator for MixerSource {
     type Item = i16;
 
     fn next(&mut self) -> Option<Self::Item> {
-        if self.position >= self.samples.len() {
-            if self.looping {
-                self.position = 0;
-            } else {
-                return None;
-            }
+        if self.position >= self.block.len() {
+            let start = Instant::now();
+            let voices = match self.mixer.lock() {
+                Ok(mut mixer) => {
+                    mixer.mix(&mut self.block);
+                    mixer.voice_count()
+                }
+                Err(_) => {
+                    self.block.fill(0);
+                    0
+                }
+            };
+            record_mix_block(start, voices);
+            self.position = 0;
         }
 
-        if self.samples.is_empty() {
-            return None;
+        let sample = self.block[self.position];
+        self.position += 1;
+        Some(sample)
+    }
+}
+
+impl Source for MixerSource {
+    fn current_frame_len(&self) -> Option<usize> {
+        None
+    }
+
+    fn channels(&self) -> u16 {
+        OUTPUT_CHANNELS as u16
+    }
+
+    fn sample_rate(&self) -> u32 {
+        self.sample_rate
+    }
+
+    fn total_duration(&self) -> Option<std::time::Duration> {
+        None
+    }
+}
+
+/// Source that plays whatever the game has queued on a stream
+struct StreamSource {
+    stream: SharedStream,
+    pending: Vec<i16>,
+    position: usize,
+    sample_rate: u32,
+    channels: u16,
+}
+
+impl Iterator for StreamSource {
+    type Item = i16;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.position >= self.pending.len() {
+            let channels = self.channels.max(1) as usize;
+            self.pending.clear();
+            self.position = 0;
+
+            let start = Instant::now();
+            let mut buffer = self.stream.lock().ok()?;
+            buffer.read(&mut self.pending, STREAM_BATCH_FRAMES * channels);
+            if self.pending.is_empty() {
+                if buffer.finished {
+                    return None;
+                }
+                // Underrun: keep the sink alive with a little silence
+                MIX_UNDERRUNS.fetch_add(1, Ordering::Relaxed);
+                self.pending.resize(STREAM_UNDERRUN_FRAMES * channels, 0);
+            }
+            drop(buffer);
+            record_mix_buffer(start);
         }
 
-        let sample = self.samples[self.position];
+        let sample = self.pending[self.position];
         self.position += 1;
         Some(sample)
     }
 }
 
-impl Source for SoundSource {
+impl Source for StreamSource {
     fn current_frame_len(&self) -> Option<usize> {
         None
     }
@@ -550,13 +961,40 @@ impl Source for SoundSource {
     }
 
     fn total_duration(&self) -> Option<std::time::Duration> {
-        if self.looping {
-            None
-        } else {
-            let total_samples = self.samples.len() / self.channels.max(1) as usize;
-            Some(std::time::Duration::from_secs_f64(
-                total_samples as f64 / self.sample_rate.max(1) as f64
-            ))
-        }
+        None
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_stream_buffer_takes_whole_frames_up_to_capacity() {
+        let mut buffer = StreamBuffer::new(9, 2);
+        assert_eq!(buffer.capacity, 8);
+        assert_eq!(buffer.write(&[1, 2, 3]), 2);
+        assert_eq!(buffer.write(&[4, 5, 6, 7, 8, 9, 10, 11]), 6);
+        assert_eq!(buffer.write(&[12, 13]), 0);
+
+        let mut out = Vec::new();
+        assert_eq!(buffer.read(&mut out, 5), 4);
+        assert_eq!(out, vec![1, 2, 4, 5]);
+        assert_eq!(buffer.write(&[12, 13, 14, 15]), 4);
+        assert_eq!(buffer.samples.len(), 8);
+    }
+
+    #[test]
+    fn test_stream_buffer_drains_after_finish() {
+        let mut buffer = StreamBuffer::new(16, 1);
+        buffer.write(&[1, 2, 3]);
+        buffer.finished = true;
+        assert!(!buffer.is_drained());
+        assert_eq!(buffer.write(&[4]), 0);
+
+        let mut out = Vec::new();
+        buffer.read(&mut out, 16);
+        assert_eq!(out, vec![1, 2, 3]);
+        assert!(buffer.is_drained());
     }
 }
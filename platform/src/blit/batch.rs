@@ -0,0 +1,182 @@
+//! Batched buffer operations
+//!
+//! A frame's small primitives (sidebar icon frames, progress bars, shroud
+//! runs) would each be one FFI call with its own argument checks. Instead
+//! the caller packs them into an array of `PlatformBlitOp` and hands the
+//! whole array over at once: the destination is checked once, then each
+//! op is dispatched to the same routines the single-op calls use.
+
+use super::{basic, copy, remap, ClipRect};
+
+/// Fill `width` x `height` at (x, y) with `color`; lines are 1-pixel fills
+pub const PLATFORM_BLIT_FILL: u8 = 0;
+/// Copy from `src` (opaque)
+pub const PLATFORM_BLIT_COPY: u8 = 1;
+/// Copy from `src`, skipping pixels equal to `color`
+pub const PLATFORM_BLIT_COPY_TRANS: u8 = 2;
+/// Remap the destination rectangle through the 256-byte table at `src`
+pub const PLATFORM_BLIT_REMAP: u8 = 3;
+/// Remap, leaving color 0 alone
+pub const PLATFORM_BLIT_REMAP_TRANS: u8 = 4;
+
+/// One operation of a batch
+///
+/// `x`, `y`, `width` and `height` are the destination rectangle. Copies
+/// read `width` x `height` from (`src_x`, `src_y`) in `src`; the `src_*`
+/// sizes are ignored by fills and remaps.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct PlatformBlitOp {
+    pub kind: u8,
+    /// Fill color, or transparent key for copies
+    pub color: u8,
+    pub reserved: u16,
+    pub x: i32,
+    pub y: i32,
+    pub width: i32,
+    pub height: i32,
+    /// Source pixels (copies) or remap table (remaps)
+    pub src: *const u8,
+    pub src_pitch: i32,
+    pub src_width: i32,
+    pub src_height: i32,
+    pub src_x: i32,
+    pub src_y: i32,
+}
+
+/// Run a batch of operations on one destination, in order
+///
+/// Every op is clipped to the destination; ops with an unknown kind or a
+/// null source are skipped.
+///
+/// # Safety
+/// Each copy's `src` must point to `src_pitch * src_height` bytes and each
+/// remap's `src` to 256 bytes.
+pub unsafe fn execute(
+    dest: &mut [u8],
+    pitch: usize,
+    width: i32,
+    height: i32,
+    ops: &[PlatformBlitOp],
+) {
+    for op in ops {
+        match op.kind {
+            PLATFORM_BLIT_FILL => {
+                basic::buffer_fill_rect(
+                    dest, pitch, width, height,
+                    op.x, op.y, op.width, op.height,
+                    op.color,
+                );
+            }
+            PLATFORM_BLIT_COPY | PLATFORM_BLIT_COPY_TRANS => {
+                if op.src.is_null() || op.src_pitch <= 0 || op.src_height <= 0 {
+                    continue;
+                }
+                let src = std::slice::from_raw_parts(op.src, (op.src_pitch * op.src_height) as usize);
+                let src_rect = ClipRect::new(op.src_x, op.src_y, op.width, op.height);
+                if op.kind == PLATFORM_BLIT_COPY {
+                    copy::buffer_to_buffer(
+                        dest, pitch, width, height,
+                        src, op.src_pitch as usize, op.src_width, op.src_height,
+                        op.x, op.y, src_rect,
+                    );
+                } else {
+                    copy::buffer_to_buffer_trans_key(
+                        dest, pitch, width, height,
+                        src, op.src_pitch as usize, op.src_width, op.src_height,
+                        op.x, op.y, src_rect,
+                        op.color,
+                    );
+                }
+            }
+            PLATFORM_BLIT_REMAP | PLATFORM_BLIT_REMAP_TRANS => {
+                if op.src.is_null() {
+                    continue;
+                }
+                let rect = ClipRect::new(0, 0, op.width, op.height);
+                let Some((clipped, x, y)) = rect.clip_to_bounds(op.x, op.y, width, height) else {
+                    continue;
+                };
+                let table: &remap::RemapTable = &*(op.src as *const remap::RemapTable);
+                if op.kind == PLATFORM_BLIT_REMAP {
+                    remap::buffer_remap(dest, pitch, x, y, clipped.width, clipped.height, table);
+                } else {
+                    remap::buffer_remap_trans(dest, pitch, x, y, clipped.width, clipped.height, table);
+                }
+            }
+            _ => {}
+        }
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn op(kind: u8, color: u8, x: i32, y: i32, width: i32, height: i32) -> PlatformBlitOp {
+        PlatformBlitOp {
+            kind,
+            color,
+            reserved: 0,
+            x,
+            y,
+            width,
+            height,
+            src: std::ptr::null(),
+            src_pitch: 0,
+            src_width: 0,
+            src_height: 0,
+            src_x: 0,
+            src_y: 0,
+        }
+    }
+
+    #[test]
+    fn test_execute_fills_in_order_and_clips() {
+        let mut buffer = vec![0u8; 100];
+        let ops = [
+            op(PLATFORM_BLIT_FILL, 1, 0, 0, 10, 10),
+            op(PLATFORM_BLIT_FILL, 2, 8, 8, 5, 5),      // Clipped at the corner
+            op(PLATFORM_BLIT_FILL, 3, 0, 4, 10, 1),     // A line over the first fill
+        ];
+        unsafe { execute(&mut buffer, 10, 10, 10, &ops) };
+
+        assert_eq!(buffer[0], 1);
+        assert_eq!(buffer[9 * 10 + 9], 2);
+        assert_eq!(buffer[8 * 10 + 7], 1);
+        assert!(buffer[40..50].iter().all(|&b| b == 3));
+    }
+
+    #[test]
+    fn test_execute_copy_and_remap() {
+        let mut buffer = vec![5u8; 16];
+        let src = [0u8, 7, 7, 0];
+        let mut table = [0u8; 256];
+        for (i, entry) in table.iter_mut().enumerate() {
+            *entry = (i as u8).wrapping_add(1);
+        }
+
+        let mut copy_trans = op(PLATFORM_BLIT_COPY_TRANS, 0, 1, 1, 2, 2);
+        copy_trans.src = src.as_ptr();
+        copy_trans.src_pitch = 2;
+        copy_trans.src_width = 2;
+        copy_trans.src_height = 2;
+        let mut remap_op = op(PLATFORM_BLIT_REMAP, 0, 2, 2, 10, 10);
+        remap_op.src = table.as_ptr();
+        let missing = op(PLATFORM_BLIT_REMAP, 0, 0, 0, 4, 4);   // No table: skipped
+        let unknown = op(99, 0, 0, 0, 4, 4);
+
+        unsafe { execute(&mut buffer, 4, 4, 4, &[copy_trans, remap_op, missing, unknown]) };
+
+        assert_eq!(buffer[1 * 4 + 1], 5);      // Transparent source pixel
+        assert_eq!(buffer[1 * 4 + 2], 7);
+        assert_eq!(buffer[2 * 4 + 1], 7);
+        assert_eq!(buffer[2 * 4 + 2], 6);      // Remapped, clipped to 2x2
+        assert_eq!(buffer[3 * 4 + 3], 6);
+        assert_eq!(buffer[0], 5);
+    }
+}
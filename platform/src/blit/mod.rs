@@ -6,12 +6,11 @@
 //! graphics operations originally written in x86 assembly.
 
 pub mod basic;
+pub mod batch;
 pub mod copy;
 pub mod remap;
 pub mod scale;
 pub mod shadow;
-
-#[cfg(feature = "simd")]
 pub mod simd;
 
 /// Clipping rectangle for blit operations
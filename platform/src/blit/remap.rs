@@ -5,6 +5,8 @@
 //! Remapping transforms pixel colors through a 256-byte lookup table.
 //! This is used for team colors, shadows, and other effects.
 
+use super::simd;
+
 /// Type alias for remap table (256 entries for 8-bit indexed color)
 pub type RemapTable = [u8; 256];
 
@@ -141,7 +143,8 @@ pub fn buffer_remap_copy(
 
 /// Remap copy with transparency
 ///
-/// Like `buffer_remap_copy` but skips source pixels with value 0.
+/// Like `buffer_remap_copy` but skips source pixels with value 0. Rows go
+/// through `simd::buffer_remap_copy_trans_fast`.
 pub fn buffer_remap_copy_trans(
     dest: &mut [u8],
     dest_pitch: usize,
@@ -154,6 +157,61 @@ pub fn buffer_remap_copy_trans(
     width: i32,
     height: i32,
     remap_table: &RemapTable,
+) {
+    for_each_row_pair(
+        dest, dest_pitch, dest_x, dest_y,
+        src, src_pitch, src_x, src_y,
+        width, height,
+        |dest_row, src_row| simd::buffer_remap_copy_trans_fast(dest_row, src_row, remap_table),
+    );
+}
+
+/// Shadow through a mask
+///
+/// Darkens destination pixels through `shadow_table` wherever the mask
+/// (a shape frame) is non-zero; the mask's colors are not drawn. Rows go
+/// through `simd::buffer_remap_shadow_fast`.
+///
+/// # Arguments
+/// * `dest`, `dest_pitch`, `dest_x`, `dest_y` - Destination region
+/// * `mask`, `mask_pitch`, `mask_x`, `mask_y` - Mask region
+/// * `width`, `height` - Region size
+/// * `shadow_table` - 256-byte lookup table
+pub fn buffer_remap_shadow(
+    dest: &mut [u8],
+    dest_pitch: usize,
+    dest_x: i32,
+    dest_y: i32,
+    mask: &[u8],
+    mask_pitch: usize,
+    mask_x: i32,
+    mask_y: i32,
+    width: i32,
+    height: i32,
+    shadow_table: &RemapTable,
+) {
+    for_each_row_pair(
+        dest, dest_pitch, dest_x, dest_y,
+        mask, mask_pitch, mask_x, mask_y,
+        width, height,
+        |dest_row, mask_row| simd::buffer_remap_shadow_fast(dest_row, mask_row, shadow_table),
+    );
+}
+
+/// Call `op` with matching destination and source rows of a region,
+/// each cut short at the end of its buffer
+fn for_each_row_pair<F: FnMut(&mut [u8], &[u8])>(
+    dest: &mut [u8],
+    dest_pitch: usize,
+    dest_x: i32,
+    dest_y: i32,
+    src: &[u8],
+    src_pitch: usize,
+    src_x: i32,
+    src_y: i32,
+    width: i32,
+    height: i32,
+    mut op: F,
 ) {
     if width <= 0 || height <= 0 {
         return;
@@ -169,18 +227,17 @@ pub fn buffer_remap_copy_trans(
     for row in 0..height {
         let dest_row_start = (dest_y + row) * dest_pitch + dest_x;
         let src_row_start = (src_y + row) * src_pitch + src_x;
-
-        for col in 0..width {
-            let src_idx = src_row_start + col;
-            let dest_idx = dest_row_start + col;
-
-            if src_idx < src.len() && dest_idx < dest.len() {
-                let src_pixel = src[src_idx];
-                if src_pixel != 0 {
-                    dest[dest_idx] = remap_table[src_pixel as usize];
-                }
-            }
+        if dest_row_start >= dest.len() || src_row_start >= src.len() {
+            break;
         }
+
+        let count = width
+            .min(dest.len() - dest_row_start)
+            .min(src.len() - src_row_start);
+        op(
+            &mut dest[dest_row_start..dest_row_start + count],
+            &src[src_row_start..src_row_start + count],
+        );
     }
 }
 
@@ -389,6 +446,55 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_buffer_remap_shadow() {
+        // Mask with a transparent left half
+        let mut mask = vec![0u8; 25];
+        for y in 0..5 {
+            for x in 2..5 {
+                mask[y * 5 + x] = 7;
+            }
+        }
+
+        let mut dest: Vec<u8> = (0..100).map(|i| i as u8).collect();
+        let shadow = create_shift_table(100);
+
+        buffer_remap_shadow(
+            &mut dest, 10, 1, 1,
+            &mask, 5, 0, 0,
+            5, 5,
+            &shadow,
+        );
+
+        for y in 0..10 {
+            for x in 0..10 {
+                let original = (y * 10 + x) as u8;
+                let shaded = x >= 3 && x < 6 && y >= 1 && y < 6;
+                let expected = if shaded { original + 100 } else { original };
+                assert_eq!(dest[y * 10 + x], expected, "at ({}, {})", x, y);
+            }
+        }
+    }
+
+    #[test]
+    fn test_buffer_remap_copy_trans_clipped() {
+        // Rows past the end of either buffer are cut short, not skipped
+        let src = vec![1u8; 40];
+        let mut dest = vec![0u8; 35];
+        let mut table = create_identity_table();
+        table[1] = 9;
+
+        buffer_remap_copy_trans(
+            &mut dest, 10, 5, 2,
+            &src, 20, 0, 0,
+            20, 2,
+            &table,
+        );
+
+        assert!(dest[..25].iter().all(|&b| b == 0));
+        assert!(dest[25..].iter().all(|&b| b == 9));
+    }
+
     #[test]
     fn test_shift_table() {
         let table = create_shift_table(10);
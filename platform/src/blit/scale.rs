@@ -3,11 +3,30 @@
 //! Replaces WIN32LIB/DRAWBUFF/SCALE.ASM
 //!
 //! Uses nearest-neighbor interpolation with 16.16 fixed-point arithmetic
-//! for sub-pixel accuracy.
+//! for sub-pixel accuracy. Each destination row is built once per source
+//! row and then copied, so the per-pixel work is a table lookup:
+//!
+//! - Exact 1x-4x horizontal factors (with any whole vertical factor)
+//!   replicate pixels with wide stores instead of mapping columns.
+//! - Other ratios gather through a per-column source index table, cached
+//!   per thread for the last scale width and clip offset.
+//!
+//! `buffer_scale_sharp` scales 32-bit ARGB frames with sharp bilinear
+//! filtering: pixels stay square blocks and only their edges are blended.
+//! Its coefficient tables are cached per output resolution, and whole
+//! factors (such as the 2.0 of a HiDPI drawable) take the replication path.
+
+use std::cell::RefCell;
 
 /// Fixed-point shift amount (16.16 format)
 const FP_SHIFT: u32 = 16;
 
+/// Largest horizontal factor with a dedicated 8-bit replication path
+const MAX_REPLICATE_FACTOR: usize = 4;
+
+/// Output resolutions whose sharp bilinear tables are kept per thread
+const SHARP_CACHE_SIZE: usize = 4;
+
 /// Scale source to destination using nearest-neighbor interpolation
 ///
 /// # Arguments
@@ -37,73 +56,12 @@ pub fn buffer_scale(
     scale_width: i32,
     scale_height: i32,
 ) {
-    // Validate inputs
-    if scale_width <= 0 || scale_height <= 0 {
-        return;
-    }
-    if src_width <= 0 || src_height <= 0 {
-        return;
-    }
-    if dest_width <= 0 || dest_height <= 0 {
-        return;
-    }
-
-    // Calculate fixed-point scaling ratios
-    // x_ratio = (src_width << 16) / scale_width
-    let x_ratio = ((src_width as u32) << FP_SHIFT) / scale_width as u32;
-    let y_ratio = ((src_height as u32) << FP_SHIFT) / scale_height as u32;
-
-    // Calculate clipping
-    let clip_result = clip_scaled_rect(
-        dest_x, dest_y,
-        scale_width, scale_height,
-        dest_width, dest_height,
-        x_ratio, y_ratio,
+    scale_indexed(
+        dest, dest_pitch, dest_width, dest_height,
+        src, src_pitch, src_width, src_height,
+        dest_x, dest_y, scale_width, scale_height,
+        None,
     );
-
-    let Some((clip_dest_x, clip_dest_y, clip_width, clip_height, start_x_fp, start_y_fp)) = clip_result else {
-        return;  // Completely clipped
-    };
-
-    // Scale each row
-    let mut y_accum = start_y_fp;
-
-    for dy in 0..clip_height {
-        let dest_row_y = clip_dest_y + dy;
-        if dest_row_y < 0 || dest_row_y >= dest_height {
-            y_accum += y_ratio;
-            continue;
-        }
-
-        let src_y = (y_accum >> FP_SHIFT) as i32;
-        if src_y < 0 || src_y >= src_height {
-            y_accum += y_ratio;
-            continue;
-        }
-
-        let dest_row_offset = (dest_row_y as usize) * dest_pitch;
-        let src_row_offset = (src_y as usize) * src_pitch;
-
-        let mut x_accum = start_x_fp;
-
-        for dx in 0..clip_width {
-            let dest_col_x = clip_dest_x + dx;
-            if dest_col_x >= 0 && dest_col_x < dest_width {
-                let src_x = (x_accum >> FP_SHIFT) as i32;
-                if src_x >= 0 && src_x < src_width {
-                    let dest_idx = dest_row_offset + dest_col_x as usize;
-                    let src_idx = src_row_offset + src_x as usize;
-
-                    if dest_idx < dest.len() && src_idx < src.len() {
-                        dest[dest_idx] = src[src_idx];
-                    }
-                }
-            }
-            x_accum += x_ratio;
-        }
-
-        y_accum += y_ratio;
-    }
 }
 
 /// Scale with transparency (skip color 0)
@@ -148,6 +106,61 @@ pub fn buffer_scale_trans_key(
     scale_width: i32,
     scale_height: i32,
     transparent_color: u8,
+) {
+    scale_indexed(
+        dest, dest_pitch, dest_width, dest_height,
+        src, src_pitch, src_width, src_height,
+        dest_x, dest_y, scale_width, scale_height,
+        Some(transparent_color),
+    );
+}
+
+/// Source column for each destination column of a clipped scale
+struct ColumnMap {
+    key: (u32, u32, usize),
+    index: Vec<u32>,
+}
+
+thread_local! {
+    static COLUMN_MAP: RefCell<ColumnMap> = RefCell::new(ColumnMap { key: (0, 0, 0), index: Vec::new() });
+}
+
+impl ColumnMap {
+    /// Make the table current for `width` columns stepping `x_ratio` from `start_x_fp`
+    fn prepare(&mut self, start_x_fp: u32, x_ratio: u32, width: usize) -> &[u32] {
+        let key = (start_x_fp, x_ratio, width);
+        if self.key != key || self.index.len() != width {
+            self.key = key;
+            self.index.clear();
+            self.index.extend((0..width as u32).map(|dx| (start_x_fp + dx * x_ratio) >> FP_SHIFT));
+        }
+        &self.index
+    }
+}
+
+/// Whole factors for a scale, if both axes are exact multiples of the source
+fn integer_factors(src_width: i32, src_height: i32, scale_width: i32, scale_height: i32) -> Option<(usize, usize)> {
+    if scale_width % src_width != 0 || scale_height % src_height != 0 {
+        return None;
+    }
+    Some(((scale_width / src_width) as usize, (scale_height / src_height) as usize))
+}
+
+/// Shared body of the 8-bit scalers; `key` pixels are skipped when given
+fn scale_indexed(
+    dest: &mut [u8],
+    dest_pitch: usize,
+    dest_width: i32,
+    dest_height: i32,
+    src: &[u8],
+    src_pitch: usize,
+    src_width: i32,
+    src_height: i32,
+    dest_x: i32,
+    dest_y: i32,
+    scale_width: i32,
+    scale_height: i32,
+    key: Option<u8>,
 ) {
     // Validate inputs
     if scale_width <= 0 || scale_height <= 0 {
@@ -160,9 +173,12 @@ pub fn buffer_scale_trans_key(
         return;
     }
 
+    // Calculate fixed-point scaling ratios
+    // x_ratio = (src_width << 16) / scale_width
     let x_ratio = ((src_width as u32) << FP_SHIFT) / scale_width as u32;
     let y_ratio = ((src_height as u32) << FP_SHIFT) / scale_height as u32;
 
+    // Calculate clipping
     let clip_result = clip_scaled_rect(
         dest_x, dest_y,
         scale_width, scale_height,
@@ -171,49 +187,123 @@ pub fn buffer_scale_trans_key(
     );
 
     let Some((clip_dest_x, clip_dest_y, clip_width, clip_height, start_x_fp, start_y_fp)) = clip_result else {
-        return;
+        return;  // Completely clipped
     };
 
-    let mut y_accum = start_y_fp;
-
-    for dy in 0..clip_height {
-        let dest_row_y = clip_dest_y + dy;
-        if dest_row_y < 0 || dest_row_y >= dest_height {
-            y_accum += y_ratio;
-            continue;
-        }
+    // Whole horizontal factors up to 4x replicate; 16.16 steps of a
+    // third would drift a column early every few pixels anyway
+    let factors = integer_factors(src_width, src_height, scale_width, scale_height)
+        .filter(|&(fx, _)| fx <= MAX_REPLICATE_FACTOR);
+    let first_col = (clip_dest_x - dest_x) as usize;
+    let first_row = (clip_dest_y - dest_y) as usize;
+    let width = clip_width as usize;
+    let src_width = src_width as usize;
+
+    COLUMN_MAP.with(|map| {
+        let mut map = map.borrow_mut();
+        let columns = match factors {
+            Some(_) => &[][..],
+            None => map.prepare(start_x_fp, x_ratio, width),
+        };
+
+        // Destination row for the current source row
+        let mut row = vec![0u8; width];
+        let mut row_src = usize::MAX;
+
+        for dy in 0..clip_height as usize {
+            let src_y = match factors {
+                Some((_, fy)) => (first_row + dy) / fy,
+                None => ((start_y_fp + dy as u32 * y_ratio) >> FP_SHIFT) as usize,
+            };
+            let dest_start = (clip_dest_y as usize + dy) * dest_pitch + clip_dest_x as usize;
+            let Some(dest_row) = dest.get_mut(dest_start..dest_start + width) else {
+                continue;
+            };
+
+            if src_y != row_src {
+                let src_start = src_y * src_pitch;
+                let Some(src_row) = src.get(src_start..src_start + src_width) else {
+                    continue;
+                };
+                match factors {
+                    Some((fx, _)) => replicate_row(&mut row, src_row, fx, first_col),
+                    None => {
+                        for (d, &sx) in row.iter_mut().zip(columns) {
+                            *d = src_row[sx as usize];
+                        }
+                    }
+                }
+                row_src = src_y;
+            }
 
-        let src_y = (y_accum >> FP_SHIFT) as i32;
-        if src_y < 0 || src_y >= src_height {
-            y_accum += y_ratio;
-            continue;
+            match key {
+                None => dest_row.copy_from_slice(&row),
+                Some(key) => {
+                    for (d, &s) in dest_row.iter_mut().zip(&row) {
+                        if s != key {
+                            *d = s;
+                        }
+                    }
+                }
+            }
         }
+    });
+}
 
-        let dest_row_offset = (dest_row_y as usize) * dest_pitch;
-        let src_row_offset = (src_y as usize) * src_pitch;
-
-        let mut x_accum = start_x_fp;
+/// Fill `dst` with `src` pixels repeated `factor` times, starting at
+/// column `first` of the scaled row
+fn replicate_row(dst: &mut [u8], src: &[u8], factor: usize, first: usize) {
+    let mut sx = first / factor;
 
-        for dx in 0..clip_width {
-            let dest_col_x = clip_dest_x + dx;
-            if dest_col_x >= 0 && dest_col_x < dest_width {
-                let src_x = (x_accum >> FP_SHIFT) as i32;
-                if src_x >= 0 && src_x < src_width {
-                    let dest_idx = dest_row_offset + dest_col_x as usize;
-                    let src_idx = src_row_offset + src_x as usize;
+    // Partial block left by clipping
+    let head = ((factor - first % factor) % factor).min(dst.len());
+    if head > 0 {
+        dst[..head].fill(src[sx]);
+        sx += 1;
+    }
 
-                    if dest_idx < dest.len() && src_idx < src.len() {
-                        let pixel = src[src_idx];
-                        if pixel != transparent_color {
-                            dest[dest_idx] = pixel;
-                        }
-                    }
-                }
+    let body = &mut dst[head..];
+    let pixels = body.len() / factor;
+    let (whole, tail) = body.split_at_mut(pixels * factor);
+    let src_run = &src[sx..sx + pixels];
+
+    match factor {
+        1 => whole.copy_from_slice(src_run),
+        2 => {
+            // Four source pixels per 8-byte store
+            let mut out = whole.chunks_exact_mut(8);
+            let mut pix = src_run.chunks_exact(4);
+            for (d, s) in (&mut out).zip(&mut pix) {
+                let mut v = u32::from_le_bytes([s[0], s[1], s[2], s[3]]) as u64;
+                v = (v | v << 16) & 0x0000_FFFF_0000_FFFF;
+                v = (v | v << 8) & 0x00FF_00FF_00FF_00FF;
+                d.copy_from_slice(&(v * 0x0101).to_le_bytes());
+            }
+            for (d, &p) in out.into_remainder().chunks_exact_mut(2).zip(pix.remainder()) {
+                d.copy_from_slice(&[p, p]);
+            }
+        }
+        3 => {
+            for (d, &p) in whole.chunks_exact_mut(3).zip(src_run) {
+                d.copy_from_slice(&[p, p, p]);
             }
-            x_accum += x_ratio;
         }
+        _ => {
+            // Two source pixels per 8-byte store
+            let mut out = whole.chunks_exact_mut(8);
+            let mut pix = src_run.chunks_exact(2);
+            for (d, s) in (&mut out).zip(&mut pix) {
+                let v = (s[0] as u64 | (s[1] as u64) << 32) * 0x0101_0101;
+                d.copy_from_slice(&v.to_le_bytes());
+            }
+            for (d, &p) in out.into_remainder().chunks_exact_mut(4).zip(pix.remainder()) {
+                d.copy_from_slice(&[p; 4]);
+            }
+        }
+    }
 
-        y_accum += y_ratio;
+    if !tail.is_empty() {
+        tail.fill(src[sx + pixels]);
     }
 }
 
@@ -296,6 +386,232 @@ pub fn calc_scale_to_fit(
     (scaled_width, scaled_height)
 }
 
+
+/// Calculate the largest whole-factor scale of source that fits the destination
+///
+/// Falls back to `calc_scale_to_fit` when the source is larger than the
+/// destination, so the result always fits.
+pub fn calc_integer_scale_to_fit(
+    src_width: i32,
+    src_height: i32,
+    max_width: i32,
+    max_height: i32,
+) -> (i32, i32) {
+    if src_width <= 0 || src_height <= 0 {
+        return (0, 0);
+    }
+
+    let factor = (max_width / src_width).min(max_height / src_height);
+    if factor < 1 {
+        return calc_scale_to_fit(src_width, src_height, max_width, max_height);
+    }
+
+    (src_width * factor, src_height * factor)
+}
+
+// =============================================================================
+// Sharp Bilinear (ARGB8888)
+// =============================================================================
+
+/// Source index and blend weight for each output column or row
+///
+/// Output `i` is `lerp(src[index[i]], src[index[i] + 1], weight[i] / 256)`;
+/// a weight of 0 never reads `index[i] + 1`.
+#[derive(Debug, Clone, PartialEq)]
+pub struct SharpAxis {
+    pub index: Vec<u32>,
+    pub weight: Vec<u16>,
+}
+
+impl SharpAxis {
+    /// Build the table for scaling `src` pixels to `out` pixels
+    ///
+    /// Each source pixel becomes a solid block of the integer part of the
+    /// scale, and only the fraction left over is spent on a blended edge
+    /// between blocks.
+    pub fn new(src: i32, out: i32) -> Self {
+        let scale = out as f32 / src as f32;
+        let prescale = scale.floor().max(1.0);
+        let range = 0.5 - 0.5 / prescale;
+        let last = (src - 1) as f32;
+
+        let mut index = Vec::with_capacity(out as usize);
+        let mut weight = Vec::with_capacity(out as usize);
+        for o in 0..out {
+            let texel = (o as f32 + 0.5) / scale;
+            let cell = texel.floor();
+            let offset = texel - cell - 0.5;
+            let edge = (offset - offset.clamp(-range, range)) * prescale;
+
+            // Sample position with pixel centers on whole numbers
+            let pos = (cell + edge).clamp(0.0, last);
+            let mut i = pos.floor() as u32;
+            let mut w = ((pos - pos.floor()) * 256.0).round() as u32;
+            if w >= 256 {
+                i += 1;
+                w = 0;
+            }
+            index.push(i);
+            weight.push(w as u16);
+        }
+
+        Self { index, weight }
+    }
+}
+
+/// Both axes of a sharp bilinear scale
+struct SharpTables {
+    key: (i32, i32, i32, i32),
+    x: SharpAxis,
+    y: SharpAxis,
+}
+
+thread_local! {
+    static SHARP_TABLES: RefCell<Vec<SharpTables>> = RefCell::new(Vec::new());
+}
+
+/// Blend two ARGB pixels, `weight` of 0..=255 toward `b`
+#[inline]
+fn lerp_argb(a: u32, b: u32, weight: u32) -> u32 {
+    let inv = 256 - weight;
+    let rb = (((a & 0x00FF_00FF) * inv + (b & 0x00FF_00FF) * weight) >> 8) & 0x00FF_00FF;
+    let ag = (((a >> 8) & 0x00FF_00FF) * inv + ((b >> 8) & 0x00FF_00FF) * weight) & 0xFF00_FF00;
+    rb | ag
+}
+
+/// Scale a 32-bit ARGB image with sharp bilinear filtering
+///
+/// Arguments match `buffer_scale`, with pitches in pixels. Whole factors
+/// on both axes replicate pixels, which is what sharp bilinear would
+/// produce for them anyway.
+pub fn buffer_scale_sharp(
+    dest: &mut [u32],
+    dest_pitch: usize,
+    dest_width: i32,
+    dest_height: i32,
+    src: &[u32],
+    src_pitch: usize,
+    src_width: i32,
+    src_height: i32,
+    dest_x: i32,
+    dest_y: i32,
+    scale_width: i32,
+    scale_height: i32,
+) {
+    if scale_width <= 0 || scale_height <= 0 {
+        return;
+    }
+    if src_width <= 0 || src_height <= 0 {
+        return;
+    }
+    if dest_width <= 0 || dest_height <= 0 {
+        return;
+    }
+    if src.len() < (src_height as usize - 1) * src_pitch + src_width as usize {
+        return;
+    }
+
+    let Some((clip_dest_x, clip_dest_y, clip_width, clip_height, _, _)) = clip_scaled_rect(
+        dest_x, dest_y,
+        scale_width, scale_height,
+        dest_width, dest_height,
+        0, 0,
+    ) else {
+        return;
+    };
+
+    let first_col = (clip_dest_x - dest_x) as usize;
+    let first_row = (clip_dest_y - dest_y) as usize;
+    let width = clip_width as usize;
+    let src_row = |y: usize| &src[y * src_pitch..y * src_pitch + src_width as usize];
+    let dest_start = |dy: usize| (clip_dest_y as usize + dy) * dest_pitch + clip_dest_x as usize;
+
+    if let Some((fx, fy)) = integer_factors(src_width, src_height, scale_width, scale_height) {
+        let mut row = vec![0u32; width];
+        let mut row_src = usize::MAX;
+        for dy in 0..clip_height as usize {
+            let src_y = (first_row + dy) / fy;
+            if src_y != row_src {
+                let line = &src_row(src_y)[first_col / fx..];
+                let head = ((fx - first_col % fx) % fx).min(width);
+                let (partial, rest) = row.split_at_mut(head);
+                partial.fill(line[0]);
+                let line = if head > 0 { &line[1..] } else { line };
+                for (block, &p) in rest.chunks_mut(fx).zip(line) {
+                    block.fill(p);
+                }
+                row_src = src_y;
+            }
+            let start = dest_start(dy);
+            if let Some(out) = dest.get_mut(start..start + width) {
+                out.copy_from_slice(&row);
+            }
+        }
+        return;
+    }
+
+    SHARP_TABLES.with(|cache| {
+        let mut cache = cache.borrow_mut();
+        let key = (src_width, src_height, scale_width, scale_height);
+        let slot = match cache.iter().position(|t| t.key == key) {
+            Some(slot) => slot,
+            None => {
+                if cache.len() >= SHARP_CACHE_SIZE {
+                    cache.remove(0);
+                }
+                cache.push(SharpTables {
+                    key,
+                    x: SharpAxis::new(src_width, scale_width),
+                    y: SharpAxis::new(src_height, scale_height),
+                });
+                cache.len() - 1
+            }
+        };
+        let tables = &cache[slot];
+        let columns = first_col..first_col + width;
+        let (xi, xw) = (&tables.x.index[columns.clone()], &tables.x.weight[columns]);
+
+        // Horizontally filtered source rows, reused while output rows
+        // stay on the same pair
+        let mut rows = [(usize::MAX, vec![0u32; width]), (usize::MAX, vec![0u32; width])];
+        let filter = |y: usize, rows: &mut [(usize, Vec<u32>); 2]| -> usize {
+            if let Some(slot) = rows.iter().position(|r| r.0 == y) {
+                return slot;
+            }
+            // Replace whichever row is not the other half of this pair
+            let slot = if rows[0].0 == y.wrapping_sub(1) { 1 } else { 0 };
+            let line = src_row(y);
+            for ((d, &i), &w) in rows[slot].1.iter_mut().zip(xi).zip(xw) {
+                *d = if w == 0 {
+                    line[i as usize]
+                } else {
+                    lerp_argb(line[i as usize], line[i as usize + 1], w as u32)
+                };
+            }
+            rows[slot].0 = y;
+            slot
+        };
+
+        for dy in 0..clip_height as usize {
+            let y = tables.y.index[first_row + dy] as usize;
+            let w = tables.y.weight[first_row + dy] as u32;
+            let top = filter(y, &mut rows);
+            let start = dest_start(dy);
+            let Some(out) = dest.get_mut(start..start + width) else {
+                continue;
+            };
+            if w == 0 {
+                out.copy_from_slice(&rows[top].1);
+            } else {
+                let bottom = filter(y + 1, &mut rows);
+                for ((d, &a), &b) in out.iter_mut().zip(&rows[top].1).zip(&rows[bottom].1) {
+                    *d = lerp_argb(a, b, w);
+                }
+            }
+        }
+    });
+}
+
 // =============================================================================
 // Unit Tests
 // =============================================================================
@@ -568,4 +884,180 @@ mod tests {
         assert_eq!(&dest[0..4], &[1, 1, 2, 2]);
         assert_eq!(&dest[4..8], &[3, 3, 4, 4]);
     }
+
+    /// Per-pixel reference for whole-factor replication
+    fn replicate_reference(src: &[u8], src_w: usize, fx: usize, fy: usize) -> Vec<u8> {
+        let src_h = src.len() / src_w;
+        let mut out = vec![0u8; src_w * fx * src_h * fy];
+        for y in 0..src_h * fy {
+            for x in 0..src_w * fx {
+                out[y * src_w * fx + x] = src[(y / fy) * src_w + x / fx];
+            }
+        }
+        out
+    }
+
+    #[test]
+    fn test_scale_integer_factors() {
+        // Odd widths exercise the wide-store remainders
+        let (src_w, src_h) = (13, 5);
+        let src: Vec<u8> = (0..src_w * src_h).map(|i| (i * 7 + 1) as u8).collect();
+
+        for fx in 1..=4 {
+            for fy in 1..=3 {
+                let (w, h) = (src_w * fx, src_h * fy);
+                let mut dest = vec![0u8; w * h];
+                buffer_scale(
+                    &mut dest, w, w as i32, h as i32,
+                    &src, src_w, src_w as i32, src_h as i32,
+                    0, 0, w as i32, h as i32,
+                );
+                assert_eq!(dest, replicate_reference(&src, src_w, fx, fy), "{}x{}", fx, fy);
+            }
+        }
+    }
+
+    #[test]
+    fn test_scale_integer_clipped() {
+        // Clipping mid-block on every edge keeps the partial blocks
+        let (src_w, src_h) = (9, 4);
+        let src: Vec<u8> = (0..src_w * src_h).map(|i| (i + 1) as u8).collect();
+
+        for fx in 2..=4 {
+            let reference = replicate_reference(&src, src_w, fx, 3);
+            let (full_w, full_h) = (src_w * fx, src_h * 3);
+            let (w, h) = (full_w - 3, full_h - 2);
+            let mut dest = vec![0u8; w * h];
+            buffer_scale(
+                &mut dest, w, w as i32, h as i32,
+                &src, src_w, src_w as i32, src_h as i32,
+                -1, -1, full_w as i32, full_h as i32,
+            );
+            for y in 0..h {
+                for x in 0..w {
+                    let expected = if x + 1 < full_w && y + 1 < full_h {
+                        reference[(y + 1) * full_w + x + 1]
+                    } else {
+                        0
+                    };
+                    assert_eq!(dest[y * w + x], expected, "{}x at ({}, {})", fx, x, y);
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_scale_3x_exact() {
+        // 16.16 steps of 1/3 used to land one column early
+        let src = vec![1, 2, 3];
+        let mut dest = vec![0u8; 9];
+        buffer_scale(&mut dest, 9, 9, 1, &src, 3, 3, 1, 0, 0, 9, 1);
+        assert_eq!(dest, [1, 1, 1, 2, 2, 2, 3, 3, 3]);
+    }
+
+    #[test]
+    fn test_scale_trans_integer_and_mapped() {
+        let src = vec![0, 5, 6, 0, 7];
+        for scale in [10, 7] {
+            let mut dest = vec![0xFFu8; scale * 2];
+            buffer_scale_trans(
+                &mut dest, scale, scale as i32, 2,
+                &src, 5, 5, 1,
+                0, 0, scale as i32, 2,
+            );
+            for y in 0..2 {
+                for x in 0..scale {
+                    let s = src[x * 5 / scale];
+                    let expected = if s == 0 { 0xFF } else { s };
+                    assert_eq!(dest[y * scale + x], expected, "{} wide at ({}, {})", scale, x, y);
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn test_calc_integer_scale_to_fit() {
+        // 640x400 in a 2560x1440 HiDPI drawable -> 3x
+        assert_eq!(calc_integer_scale_to_fit(640, 400, 2560, 1440), (1920, 1200));
+        assert_eq!(calc_integer_scale_to_fit(640, 400, 1280, 800), (1280, 800));
+
+        // Too small for 1x falls back to a fractional fit
+        assert_eq!(calc_integer_scale_to_fit(100, 100, 50, 50), (50, 50));
+    }
+
+    #[test]
+    fn test_sharp_axis_whole_factor_has_no_blend() {
+        let axis = SharpAxis::new(4, 12);
+        assert!(axis.weight.iter().all(|&w| w == 0));
+        let expected: Vec<u32> = (0..12).map(|o| o / 3).collect();
+        assert_eq!(axis.index, expected);
+    }
+
+    #[test]
+    fn test_sharp_axis_blends_only_edges() {
+        // 2.5x: blending stays within a column or two of the three edges
+        let axis = SharpAxis::new(4, 10);
+        let blended = axis.weight.iter().filter(|&&w| w != 0).count();
+        assert!(blended <= 6, "{} blended columns", blended);
+        assert_eq!((axis.index[0], axis.weight[0]), (0, 0));
+        assert_eq!((axis.index[9], axis.weight[9]), (3, 0));
+
+        // Sample positions never move backwards
+        let pos: Vec<u32> = axis.index.iter().zip(&axis.weight).map(|(&i, &w)| i * 256 + w as u32).collect();
+        assert!(pos.windows(2).all(|p| p[0] <= p[1]));
+    }
+
+    #[test]
+    fn test_sharp_matches_replication_on_whole_factors() {
+        let src: Vec<u32> = (0..6 * 4).map(|i| 0xFF00_0000 | (i * 0x0A0B0C)).collect();
+        let (w, h) = (12, 8);
+        let mut dest = vec![0u32; w * h];
+        buffer_scale_sharp(&mut dest, w, w as i32, h as i32, &src, 6, 6, 4, 0, 0, w as i32, h as i32);
+        for y in 0..h {
+            for x in 0..w {
+                assert_eq!(dest[y * w + x], src[(y / 2) * 6 + x / 2], "at ({}, {})", x, y);
+            }
+        }
+    }
+
+    #[test]
+    fn test_sharp_fractional_scale() {
+        // Black | white, 2x1 scaled to 5x3
+        let src = vec![0xFF00_0000u32, 0xFFFF_FFFF];
+        let (w, h) = (5, 3);
+        let mut dest = vec![0u32; w * h];
+        buffer_scale_sharp(&mut dest, w, w as i32, h as i32, &src, 2, 2, 1, 0, 0, w as i32, h as i32);
+
+        for y in 0..h {
+            let row = &dest[y * w..(y + 1) * w];
+            assert_eq!(row[0], 0xFF00_0000);
+            assert_eq!(row[1], 0xFF00_0000);
+            assert_eq!(row[3], 0xFFFF_FFFF);
+            assert_eq!(row[4], 0xFFFF_FFFF);
+
+            // The middle column is the blended edge, alpha untouched
+            assert_eq!(row[2] >> 24, 0xFF);
+            let green = (row[2] >> 8) & 0xFF;
+            assert!(green > 0x40 && green < 0xC0, "edge {:08X}", row[2]);
+        }
+    }
+
+    #[test]
+    fn test_sharp_clipped_matches_unclipped() {
+        let src: Vec<u32> = (0..7 * 5).map(|i| 0xFF00_0000 | (i * 0x050607)).collect();
+        let (full_w, full_h) = (17, 12);
+        let mut full = vec![0u32; full_w * full_h];
+        buffer_scale_sharp(&mut full, full_w, full_w as i32, full_h as i32,
+                           &src, 7, 7, 5, 0, 0, full_w as i32, full_h as i32);
+
+        let (w, h) = (10, 9);
+        let mut clipped = vec![0u32; w * h];
+        buffer_scale_sharp(&mut clipped, w, w as i32, h as i32,
+                           &src, 7, 7, 5, -4, -2, full_w as i32, full_h as i32);
+        for y in 0..h {
+            for x in 0..w {
+                assert_eq!(clipped[y * w + x], full[(y + 2) * full_w + x + 4], "at ({}, {})", x, y);
+            }
+        }
+    }
 }
@@ -5,6 +5,7 @@
 //! Shadows are applied by darkening existing pixels through a lookup table.
 
 use super::remap::RemapTable;
+use super::simd;
 
 /// Default shadow intensity (50% darkness)
 pub const DEFAULT_SHADOW_INTENSITY: f32 = 0.5;
@@ -174,20 +175,22 @@ pub fn buffer_shadow_clipped(
     let clip_width = clip_width as usize;
     let clip_height = clip_height as usize;
 
+    // Rows go through the SIMD kernel, which skips blocks the mask leaves
+    // clear, so a sparse frame-sized mask costs little
     for row in 0..clip_height {
         let buf_row_start = (clip_y + row) * buffer_pitch + clip_x;
         let mask_row_start = (mask_y + row) * mask_pitch + mask_x;
-
-        for col in 0..clip_width {
-            let mask_idx = mask_row_start + col;
-            let buf_idx = buf_row_start + col;
-
-            if mask_idx < mask.len() && buf_idx < buffer.len() {
-                if mask[mask_idx] != 0 {
-                    buffer[buf_idx] = shadow_table[buffer[buf_idx] as usize];
-                }
-            }
+        let buf_row_end = (buf_row_start + clip_width).min(buffer.len());
+        let mask_row_end = (mask_row_start + clip_width).min(mask.len());
+        if buf_row_start >= buf_row_end || mask_row_start >= mask_row_end {
+            break;
         }
+
+        simd::buffer_remap_shadow_fast(
+            &mut buffer[buf_row_start..buf_row_end],
+            &mask[mask_row_start..mask_row_end],
+            shadow_table,
+        );
     }
 }
 
@@ -444,6 +447,30 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_buffer_shadow_clipped_mask_window() {
+        let mut buffer = vec![200u8; 100];  // 10x10
+        let mut mask = vec![0u8; 100];      // 10x10 frame mask
+        mask[5 * 10 + 5] = 1;
+        mask[8 * 10 + 8] = 1;
+        let table = create_simple_shadow_table();
+
+        // The 4x4 window at (5, 5) of the mask, ending short of its last row
+        buffer_shadow_clipped(
+            &mut buffer, 10, 10, 10,
+            &mask[55..55 + 10 * 3 + 4], 10,
+            2, 2, 4, 4,
+            &table,
+        );
+
+        for y in 0..10 {
+            for x in 0..10 {
+                let expected = if (x, y) == (2, 2) || (x, y) == (5, 5) { 100 } else { 200 };
+                assert_eq!(buffer[y * 10 + x], expected, "at ({}, {})", x, y);
+            }
+        }
+    }
+
     #[test]
     fn test_buffer_shadow_negative_coords() {
         let mut buffer = vec![200u8; 100];
@@ -112,6 +112,92 @@ mod x86_64_impl {
             *ptr.add(tail_start + i) = remap[idx];
         }
     }
+
+    /// Remap-copy skipping color 0 using SSE2
+    ///
+    /// Each block of 16 source pixels is tested for transparency at once:
+    /// fully transparent blocks are skipped, fully opaque ones stored
+    /// whole, and mixed ones blended with the destination under the mask.
+    /// The table lookups stay scalar (no byte gather before AVX-512).
+    #[inline]
+    pub unsafe fn buffer_remap_copy_trans_sse2(
+        dst: &mut [u8],
+        src: &[u8],
+        remap: &[u8; 256],
+    ) {
+        let len = src.len().min(dst.len());
+        let src_ptr = src.as_ptr();
+        let dst_ptr = dst.as_mut_ptr();
+        let zero = _mm_setzero_si128();
+        let mut mapped = [0u8; 16];
+
+        let chunks = len / 16;
+        for i in 0..chunks {
+            let base = i * 16;
+            let s = _mm_loadu_si128(src_ptr.add(base) as *const __m128i);
+            let mask = _mm_cmpeq_epi8(s, zero); // 0xFF where transparent
+            let bits = _mm_movemask_epi8(mask);
+            if bits == 0xFFFF {
+                continue;
+            }
+            for j in 0..16 {
+                mapped[j] = remap[*src_ptr.add(base + j) as usize];
+            }
+            let m = _mm_loadu_si128(mapped.as_ptr() as *const __m128i);
+            let d = dst_ptr.add(base) as *mut __m128i;
+            if bits == 0 {
+                _mm_storeu_si128(d, m);
+            } else {
+                let old = _mm_loadu_si128(d);
+                _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(mask, old), _mm_andnot_si128(mask, m)));
+            }
+        }
+
+        let tail_start = chunks * 16;
+        super::remap_copy_trans_scalar(&mut dst[tail_start..len], &src[tail_start..len], remap);
+    }
+
+    /// Darken destination pixels under a non-zero mask using SSE2
+    ///
+    /// Same block tests as `buffer_remap_copy_trans_sse2`, with the lookup
+    /// on the destination pixel instead of the source.
+    #[inline]
+    pub unsafe fn buffer_remap_shadow_sse2(
+        dst: &mut [u8],
+        mask: &[u8],
+        shadow: &[u8; 256],
+    ) {
+        let len = mask.len().min(dst.len());
+        let mask_ptr = mask.as_ptr();
+        let dst_ptr = dst.as_mut_ptr();
+        let zero = _mm_setzero_si128();
+        let mut mapped = [0u8; 16];
+
+        let chunks = len / 16;
+        for i in 0..chunks {
+            let base = i * 16;
+            let s = _mm_loadu_si128(mask_ptr.add(base) as *const __m128i);
+            let clear = _mm_cmpeq_epi8(s, zero);
+            let bits = _mm_movemask_epi8(clear);
+            if bits == 0xFFFF {
+                continue;
+            }
+            for j in 0..16 {
+                mapped[j] = shadow[*dst_ptr.add(base + j) as usize];
+            }
+            let m = _mm_loadu_si128(mapped.as_ptr() as *const __m128i);
+            let d = dst_ptr.add(base) as *mut __m128i;
+            if bits == 0 {
+                _mm_storeu_si128(d, m);
+            } else {
+                let old = _mm_loadu_si128(d);
+                _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(clear, old), _mm_andnot_si128(clear, m)));
+            }
+        }
+
+        let tail_start = chunks * 16;
+        super::remap_shadow_scalar(&mut dst[tail_start..len], &mask[tail_start..len], shadow);
+    }
 }
 
 #[cfg(all(target_arch = "aarch64", feature = "simd"))]
@@ -203,6 +289,76 @@ mod aarch64_impl {
             *ptr.add(tail_start + i) = remap[idx];
         }
     }
+
+    /// Remap-copy skipping color 0 using NEON
+    #[inline]
+    pub unsafe fn buffer_remap_copy_trans_neon(
+        dst: &mut [u8],
+        src: &[u8],
+        remap: &[u8; 256],
+    ) {
+        let len = src.len().min(dst.len());
+        let src_ptr = src.as_ptr();
+        let dst_ptr = dst.as_mut_ptr();
+        let zero = vdupq_n_u8(0);
+        let mut mapped = [0u8; 16];
+
+        let chunks = len / 16;
+        for i in 0..chunks {
+            let base = i * 16;
+            let mask = vceqq_u8(vld1q_u8(src_ptr.add(base)), zero);
+            if vminvq_u8(mask) == 0xFF {
+                continue;
+            }
+            for j in 0..16 {
+                mapped[j] = remap[*src_ptr.add(base + j) as usize];
+            }
+            let m = vld1q_u8(mapped.as_ptr());
+            if vmaxvq_u8(mask) == 0 {
+                vst1q_u8(dst_ptr.add(base), m);
+            } else {
+                vst1q_u8(dst_ptr.add(base), vbslq_u8(mask, vld1q_u8(dst_ptr.add(base)), m));
+            }
+        }
+
+        let tail_start = chunks * 16;
+        super::remap_copy_trans_scalar(&mut dst[tail_start..len], &src[tail_start..len], remap);
+    }
+
+    /// Darken destination pixels under a non-zero mask using NEON
+    #[inline]
+    pub unsafe fn buffer_remap_shadow_neon(
+        dst: &mut [u8],
+        mask: &[u8],
+        shadow: &[u8; 256],
+    ) {
+        let len = mask.len().min(dst.len());
+        let mask_ptr = mask.as_ptr();
+        let dst_ptr = dst.as_mut_ptr();
+        let zero = vdupq_n_u8(0);
+        let mut mapped = [0u8; 16];
+
+        let chunks = len / 16;
+        for i in 0..chunks {
+            let base = i * 16;
+            let clear = vceqq_u8(vld1q_u8(mask_ptr.add(base)), zero);
+            if vminvq_u8(clear) == 0xFF {
+                continue;
+            }
+            for j in 0..16 {
+                mapped[j] = shadow[*dst_ptr.add(base + j) as usize];
+            }
+            let m = vld1q_u8(mapped.as_ptr());
+            if vmaxvq_u8(clear) == 0 {
+                vst1q_u8(dst_ptr.add(base), m);
+            } else {
+                vst1q_u8(dst_ptr.add(base), vbslq_u8(clear, vld1q_u8(dst_ptr.add(base)), m));
+            }
+        }
+
+        let tail_start = chunks * 16;
+        super::remap_shadow_scalar(&mut dst[tail_start..len], &mask[tail_start..len], shadow);
+    }
 }
 
 // =============================================================================
@@ -280,6 +436,70 @@ pub fn buffer_remap_fast(buffer: &mut [u8], remap: &[u8; 256]) {
     }
 }
 
+/// Remap-copy skipping source color 0, with SIMD optimization when available
+///
+/// `dst[i] = remap[src[i]]` wherever `src[i] != 0`; this is how
+/// house-colored shapes are drawn.
+pub fn buffer_remap_copy_trans_fast(dst: &mut [u8], src: &[u8], remap: &[u8; 256]) {
+    #[cfg(all(target_arch = "x86_64", feature = "simd"))]
+    {
+        unsafe { x86_64_impl::buffer_remap_copy_trans_sse2(dst, src, remap); }
+        return;
+    }
+
+    #[cfg(all(target_arch = "aarch64", feature = "simd"))]
+    {
+        unsafe { aarch64_impl::buffer_remap_copy_trans_neon(dst, src, remap); }
+        return;
+    }
+
+    #[allow(unreachable_code)]
+    {
+        remap_copy_trans_scalar(dst, src, remap);
+    }
+}
+
+/// Darken destination pixels where the mask is non-zero, with SIMD
+/// optimization when available
+///
+/// `dst[i] = shadow[dst[i]]` wherever `mask[i] != 0`.
+pub fn buffer_remap_shadow_fast(dst: &mut [u8], mask: &[u8], shadow: &[u8; 256]) {
+    #[cfg(all(target_arch = "x86_64", feature = "simd"))]
+    {
+        unsafe { x86_64_impl::buffer_remap_shadow_sse2(dst, mask, shadow); }
+        return;
+    }
+
+    #[cfg(all(target_arch = "aarch64", feature = "simd"))]
+    {
+        unsafe { aarch64_impl::buffer_remap_shadow_neon(dst, mask, shadow); }
+        return;
+    }
+
+    #[allow(unreachable_code)]
+    {
+        remap_shadow_scalar(dst, mask, shadow);
+    }
+}
+
+#[inline]
+fn remap_copy_trans_scalar(dst: &mut [u8], src: &[u8], remap: &[u8; 256]) {
+    for (d, &s) in dst.iter_mut().zip(src) {
+        if s != 0 {
+            *d = remap[s as usize];
+        }
+    }
+}
+
+#[inline]
+fn remap_shadow_scalar(dst: &mut [u8], mask: &[u8], shadow: &[u8; 256]) {
+    for (d, &m) in dst.iter_mut().zip(mask) {
+        if m != 0 {
+            *d = shadow[*d as usize];
+        }
+    }
+}
+
 // =============================================================================
 // Unit Tests
 // =============================================================================
@@ -393,4 +613,29 @@ mod tests {
             assert_eq!(remap_simd, remap_scalar, "remap mismatch at size {}", size);
         }
     }
+
+    #[test]
+    fn test_remap_trans_fast_matches_scalar() {
+        let table: [u8; 256] = core::array::from_fn(|i| (255 - i) as u8);
+
+        // Runs of transparent, opaque and mixed 16-pixel blocks
+        for size in [1, 15, 16, 17, 33, 64, 100, 129] {
+            let src: Vec<u8> = (0..size)
+                .map(|i| if i % 5 == 0 || (i >= 16 && i < 32) { 0 } else { (i * 7) as u8 | 1 })
+                .collect();
+            let base: Vec<u8> = (0..size).map(|i| (200 + i) as u8).collect();
+
+            let mut fast = base.clone();
+            let mut scalar = base.clone();
+            buffer_remap_copy_trans_fast(&mut fast, &src, &table);
+            remap_copy_trans_scalar(&mut scalar, &src, &table);
+            assert_eq!(fast, scalar, "remap trans mismatch at size {}", size);
+
+            let mut fast = base.clone();
+            let mut scalar = base;
+            buffer_remap_shadow_fast(&mut fast, &src, &table);
+            remap_shadow_scalar(&mut scalar, &src, &table);
+            assert_eq!(fast, scalar, "remap shadow mismatch at size {}", size);
+        }
+    }
 }
@@ -29,6 +29,16 @@ const MIN_MATCH: usize = 3;
 
 /// Decompress LCW-encoded data
 ///
+/// Bounds are checked once per command, then each command is a single
+/// slice copy: literals are one `copy_from_slice`, and back-references
+/// that don't overlap their output are one `copy_within`. Overlapping
+/// back-references (offset shorter than the run, i.e. RLE) repeat the
+/// pattern by doubling, so an offset of 1 becomes a fill.
+///
+/// Runs are clipped at the end of `source` or `dest` exactly as a
+/// byte-at-a-time decoder would, and nothing past the returned length
+/// is written.
+///
 /// # Arguments
 /// * `source` - LCW-compressed input data
 /// * `dest` - Output buffer (must be large enough for decompressed data)
@@ -61,15 +71,12 @@ pub fn lcw_decompress(source: &[u8], dest: &mut [u8]) -> Result<usize, PlatformE
                 (cmd & 0x3F) as usize + 1
             };
 
-            // Copy literal bytes
-            for _ in 0..count {
-                if src_pos >= source.len() || dst_pos >= dest.len() {
-                    break;
-                }
-                dest[dst_pos] = source[src_pos];
-                dst_pos += 1;
-                src_pos += 1;
-            }
+            let n = count
+                .min(source.len() - src_pos)
+                .min(dest.len() - dst_pos);
+            dest[dst_pos..dst_pos + n].copy_from_slice(&source[src_pos..src_pos + n]);
+            src_pos += n;
+            dst_pos += n;
         } else {
             // Back-reference (0x01-0x7F)
             // Since bit 7=0, bits[6:4] can be 0-7, giving count 3-10
@@ -86,21 +93,42 @@ pub fn lcw_decompress(source: &[u8], dest: &mut [u8]) -> Result<usize, PlatformE
                 return Err(PlatformError::InvalidData);
             }
 
-            // Copy from back-reference (handle overlapping for RLE)
-            let ref_start = dst_pos - offset;
-            for i in 0..count {
-                if dst_pos >= dest.len() {
-                    break;
-                }
-                dest[dst_pos] = dest[ref_start + i];
-                dst_pos += 1;
-            }
+            let n = count.min(dest.len() - dst_pos);
+            copy_back_reference(dest, dst_pos, offset, n);
+            dst_pos += n;
         }
     }
 
     Ok(dst_pos)
 }
 
+/// Copy `len` bytes from `offset` bytes back, as a forward byte loop would
+///
+/// Caller guarantees `offset <= pos` and `pos + len <= dest.len()`.
+#[inline]
+fn copy_back_reference(dest: &mut [u8], pos: usize, offset: usize, len: usize) {
+    let start = pos - offset;
+
+    if offset >= len {
+        // Source run is already complete
+        dest.copy_within(start..start + len, pos);
+    } else if offset == 1 {
+        // Repeat of the previous byte
+        let value = dest[start];
+        dest[pos..pos + len].fill(value);
+    } else {
+        // Repeating pattern: each copy doubles the available period
+        let mut done = 0;
+        let mut period = offset;
+        while done < len {
+            let chunk = period.min(len - done);
+            dest.copy_within(start..start + chunk, pos + done);
+            done += chunk;
+            period += chunk;
+        }
+    }
+}
+
 /// Compress data using LCW algorithm
 ///
 /// # Arguments
@@ -254,6 +282,74 @@ pub fn lcw_decompress_alloc(source: &[u8], expected_size: usize) -> Result<Vec<u
 mod tests {
     use super::*;
 
+    /// Byte-at-a-time decoder the fast path must match
+    fn lcw_decompress_reference(source: &[u8], dest: &mut [u8]) -> Result<usize, PlatformError> {
+        let mut src_pos = 0;
+        let mut dst_pos = 0;
+
+        while src_pos < source.len() {
+            let cmd = source[src_pos];
+            src_pos += 1;
+
+            if cmd == 0 {
+                break;
+            } else if cmd & 0x80 != 0 {
+                let count = if cmd & 0x40 != 0 {
+                    if src_pos >= source.len() {
+                        return Err(PlatformError::InvalidData);
+                    }
+                    let low = source[src_pos] as usize;
+                    src_pos += 1;
+                    (((cmd & 0x3F) as usize) << 8 | low) + 1
+                } else {
+                    (cmd & 0x3F) as usize + 1
+                };
+                for _ in 0..count {
+                    if src_pos >= source.len() || dst_pos >= dest.len() {
+                        break;
+                    }
+                    dest[dst_pos] = source[src_pos];
+                    dst_pos += 1;
+                    src_pos += 1;
+                }
+            } else {
+                let count = ((cmd >> 4) & 0x07) as usize + 3;
+                if src_pos >= source.len() {
+                    return Err(PlatformError::InvalidData);
+                }
+                let offset = (((cmd & 0x0F) as usize) << 8) | source[src_pos] as usize;
+                src_pos += 1;
+                if offset == 0 || offset > dst_pos {
+                    return Err(PlatformError::InvalidData);
+                }
+                let ref_start = dst_pos - offset;
+                for i in 0..count {
+                    if dst_pos >= dest.len() {
+                        break;
+                    }
+                    dest[dst_pos] = dest[ref_start + i];
+                    dst_pos += 1;
+                }
+            }
+        }
+
+        Ok(dst_pos)
+    }
+
+    /// Decode with both decoders into `dest_len` and compare everything
+    fn assert_matches_reference(compressed: &[u8], dest_len: usize) {
+        let mut fast = vec![0xEEu8; dest_len];
+        let mut slow = vec![0xEEu8; dest_len];
+        let fast_result = lcw_decompress(compressed, &mut fast);
+        let slow_result = lcw_decompress_reference(compressed, &mut slow);
+
+        assert_eq!(fast_result.is_ok(), slow_result.is_ok());
+        if let (Ok(a), Ok(b)) = (fast_result, slow_result) {
+            assert_eq!(a, b);
+        }
+        assert_eq!(fast, slow);
+    }
+
     #[test]
     fn test_lcw_decompress_literals() {
         // Short literal: 0x83 = 0x80 | 3, so 4 bytes follow
@@ -449,4 +545,81 @@ mod tests {
         assert!(lcw_max_compressed_size(100) >= 100);
         assert!(lcw_max_compressed_size(1000) >= 1000);
     }
+
+    #[test]
+    fn test_lcw_decompress_overlapping_periods() {
+        // Every offset shorter than the run, at every run length
+        for offset in 1..=10usize {
+            for count in 3..=10usize {
+                let mut compressed = vec![0x80 | (offset as u8 - 1)];
+                compressed.extend((0..offset).map(|i| b'a' + i as u8));
+                compressed.push(((count - 3) << 4) as u8);
+                compressed.push(offset as u8);
+                compressed.push(0x00);
+                if compressed[offset + 1] == 0 {
+                    continue;   // count=3 with offset < 256 encodes as END
+                }
+
+                let mut dest = [0u8; 32];
+                let len = lcw_decompress(&compressed, &mut dest).unwrap();
+                assert_eq!(len, offset + count);
+                for i in 0..len {
+                    assert_eq!(dest[i], b'a' + (i % offset) as u8, "offset {} count {}", offset, count);
+                }
+                assert_matches_reference(&compressed, 32);
+            }
+        }
+    }
+
+    #[test]
+    fn test_lcw_decompress_clipped_runs() {
+        // Literal and back-reference runs past the end of dest
+        let mut compressed = vec![0xC0, 0x63];     // 100-byte literal
+        compressed.extend((0..100u8).map(|i| i.wrapping_mul(3)));
+        compressed.extend([0x70, 0x01, 0x70, 0x07, 0x00]);
+        for dest_len in [0, 1, 50, 99, 100, 101, 105, 110, 120, 200] {
+            assert_matches_reference(&compressed, dest_len);
+        }
+
+        // Literal running past the end of source
+        let mut truncated = vec![0x8F];
+        truncated.extend([1u8, 2, 3, 4]);
+        assert_matches_reference(&truncated, 64);
+    }
+
+    #[test]
+    fn test_lcw_decompress_matches_reference() {
+        // Compressed patterns of varying redundancy
+        let mut seed = 12345u32;
+        for round in 0..64 {
+            let len = 1 + (round * 97) % 3000;
+            let mut source = vec![0u8; len];
+            for byte in source.iter_mut() {
+                seed = seed.wrapping_mul(1103515245).wrapping_add(12345);
+                let r = (seed >> 16) as usize;
+                *byte = if r % 4 == 0 { (r >> 3) as u8 } else { (r % (1 + round % 5)) as u8 };
+            }
+
+            let mut compressed = vec![0u8; lcw_max_compressed_size(len)];
+            let comp_len = lcw_compress(&source, &mut compressed).unwrap();
+            compressed.truncate(comp_len);
+
+            assert_matches_reference(&compressed, len);
+            assert_matches_reference(&compressed, len / 2);
+
+            let mut dest = vec![0u8; len];
+            assert_eq!(lcw_decompress(&compressed, &mut dest).unwrap(), len);
+            assert_eq!(dest, source);
+        }
+    }
+
+    #[test]
+    fn test_lcw_decompress_leaves_tail_untouched() {
+        // Callers read the whole buffer, so bytes past the output must survive
+        let compressed = [0x80, b'A', 0x70, 0x01, 0x00];
+        let mut dest = [0x5Au8; 32];
+        let len = lcw_decompress(&compressed, &mut dest).unwrap();
+        assert_eq!(len, 11);
+        assert!(dest[11..].iter().all(|&b| b == 0x5A));
+    }
 }
@@ -5,12 +5,12 @@
 
 use crate::error::{catch_panic_or, get_error, set_error, clear_error};
 use crate::{PLATFORM_STATE, PlatformState, PlatformResult, PLATFORM_VERSION};
-use crate::graphics::{self, DisplayMode};
+use crate::graphics::{self, DisplayMode, FlipTiming};
 use crate::input;
 use std::ffi::{c_char, CStr};
 
 // Re-export input types for cbindgen
-pub use crate::input::{KeyCode, MouseButton};
+pub use crate::input::{InputEvent, InputEventType, KeyCode, MouseButton};
 
 /// Log level for Platform_Log
 #[repr(C)]
@@ -227,6 +227,66 @@ pub extern "C" fn Platform_Graphics_IsInitialized() -> bool {
     graphics::is_initialized()
 }
 
+/// Run graphics without a window at the next Platform_Graphics_Init
+///
+/// The back buffer is plain memory and a flip only converts it through
+/// the palette, so drawing and palette effects can run on machines with no
+/// display or GPU. The PLATFORM_HEADLESS environment variable does the
+/// same for programs that don't call this.
+///
+/// # Safety
+/// - `dump_dir` must be null or a valid null-terminated C string; when
+///   given, every flip writes the frame there as frame_NNNNNN.png
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Graphics_SetHeadless(headless: bool, dump_dir: *const c_char) {
+    let dump_dir = if dump_dir.is_null() {
+        None
+    } else {
+        CStr::from_ptr(dump_dir).to_str().ok().map(std::path::PathBuf::from)
+    };
+    graphics::set_headless(headless, dump_dir);
+}
+
+/// Check if graphics is running without a window
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_IsHeadless() -> bool {
+    graphics::is_headless()
+}
+
+/// Present through a GPU palette shader from the next Platform_Graphics_Init
+///
+/// The back buffer is uploaded as 8-bit indices and the palette as a
+/// 256x1 texture; a fragment shader does the lookup while scaling. Palette
+/// animation and fades then cost a 1 KB upload instead of a reconversion.
+/// Falls back to CPU conversion when OpenGL 2.1 is not available. The
+/// PLATFORM_GPU_PALETTE environment variable does the same for programs
+/// that don't call this.
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_SetGpuPalette(enabled: bool) {
+    graphics::set_gpu_palette(enabled);
+}
+
+/// Check if flips present through the GPU palette shader
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_IsGpuPalette() -> bool {
+    graphics::is_gpu_palette()
+}
+
+/// Set the internal resolution from the next Platform_Graphics_Init
+///
+/// The back buffer, screen texture and palette conversion all take this
+/// size; the window opens at 2x for sizes up to 960x600 and at 1x above.
+/// The PLATFORM_RESOLUTION environment variable ("1920x1080") does the
+/// same for programs that don't call this.
+///
+/// # Returns
+/// - 0 on success
+/// - -1 if the size is outside 320x200..3840x2160
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_SetResolution(width: i32, height: i32) -> i32 {
+    if graphics::set_resolution(width, height) { 0 } else { -1 }
+}
+
 /// Clear screen with color (for testing)
 #[no_mangle]
 pub extern "C" fn Platform_Graphics_Clear(r: u8, g: u8, b: u8) {
@@ -384,6 +444,55 @@ pub extern "C" fn Platform_Graphics_Flip() -> i32 {
     }
 }
 
+/// Flip only the given back buffer rectangles to screen
+///
+/// Converts and uploads just those regions; the rest of the screen keeps
+/// the previous frame. Rects are clipped to the screen. count == 0 presents
+/// the previous frame unchanged. Does a full flip on the first frame and
+/// after palette changes.
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_FlipRects(rects: *const ClipRect, count: i32) -> i32 {
+    let rects: &[ClipRect] = if rects.is_null() || count <= 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(rects, count as usize) }
+    };
+
+    let result = graphics::with_graphics(|state| {
+        state.flip_rects(rects)
+    });
+
+    match result {
+        Some(Ok(())) => 0,
+        Some(Err(e)) => {
+            set_error(e.to_string());
+            -1
+        }
+        None => {
+            set_error("Graphics not initialized");
+            -1
+        }
+    }
+}
+
+/// Get CPU-side timing of the last flip (convert, upload, scale, present)
+///
+/// Returns 0 on success, -1 if graphics is not initialized or timing is null.
+#[no_mangle]
+pub extern "C" fn Platform_Graphics_GetFlipTiming(timing: *mut FlipTiming) -> i32 {
+    if timing.is_null() {
+        return -1;
+    }
+
+    match graphics::with_graphics(|state| state.flip_timing) {
+        Some(value) => {
+            unsafe { *timing = value; }
+            0
+        }
+        None => -1,
+    }
+}
+
 /// Wait for vertical sync (no-op, handled by SDL)
 #[no_mangle]
 pub extern "C" fn Platform_Graphics_WaitVSync() {
@@ -420,6 +529,21 @@ pub extern "C" fn Platform_PollEvents() -> bool {
     graphics::poll_events()
 }
 
+/// Events Platform_PollEvents has handled so far, window exposes included;
+/// a change since the last look means the screen may need drawing again
+#[no_mangle]
+pub extern "C" fn Platform_GetEventCount() -> u32 {
+    graphics::event_count()
+}
+
+/// Sleep until an event is queued or timeout_ms passes
+///
+/// The event stays queued for Platform_PollEvents. Returns true if one is.
+#[no_mangle]
+pub extern "C" fn Platform_WaitEvents(timeout_ms: u32) -> bool {
+    graphics::wait_events(timeout_ms)
+}
+
 /// Get tick count in milliseconds since SDL init
 #[no_mangle]
 pub extern "C" fn Platform_GetTicks() -> u32 {
@@ -645,6 +769,36 @@ pub extern "C" fn Platform_Input_ShouldQuit() -> bool {
     input::should_quit()
 }
 
+/// Turn the input event queue on or off (it starts empty either way)
+#[no_mangle]
+pub extern "C" fn Platform_Input_EnableEvents(enabled: bool) {
+    input::with_input(|state| state.set_events_enabled(enabled));
+}
+
+/// Move up to max queued input events into events, oldest first
+///
+/// Returns the number written, or -1 if events were dropped since the last
+/// poll; the queue is then empty and the caller should resync from the
+/// Platform_Key_IsPressed / Platform_Mouse_* state.
+#[no_mangle]
+pub extern "C" fn Platform_Input_PollEvents(events: *mut InputEvent, max: i32) -> i32 {
+    if events.is_null() || max <= 0 {
+        return 0;
+    }
+    let out = unsafe { std::slice::from_raw_parts_mut(events, max as usize) };
+    match input::with_input(|state| state.poll_events(out)) {
+        Some(Some(count)) => count as i32,
+        Some(None) => -1,
+        None => 0,
+    }
+}
+
+/// Current time on the input event clock, in microseconds
+#[no_mangle]
+pub extern "C" fn Platform_Input_GetTimeUs() -> u64 {
+    input::time_us()
+}
+
 // =============================================================================
 // Keyboard Input
 // =============================================================================
@@ -781,6 +935,42 @@ pub extern "C" fn Platform_Mouse_Hide() {
     }
 }
 
+/// Create a hardware colour cursor from ARGB8888 pixels (alpha 0 = clear)
+///
+/// Returns a handle for Platform_Cursor_Set, or -1 on failure.
+#[no_mangle]
+pub extern "C" fn Platform_Cursor_Create(
+    pixels: *const u32,
+    width: i32,
+    height: i32,
+    hot_x: i32,
+    hot_y: i32,
+) -> i32 {
+    if pixels.is_null() || width <= 0 || height <= 0 {
+        return graphics::cursor::INVALID_CURSOR_HANDLE;
+    }
+    let argb = unsafe { std::slice::from_raw_parts(pixels, (width * height) as usize) };
+    graphics::cursor::create(argb, width, height, hot_x, hot_y)
+}
+
+/// Make a hardware cursor current (also shows the cursor)
+#[no_mangle]
+pub extern "C" fn Platform_Cursor_Set(handle: i32) -> bool {
+    graphics::cursor::set(handle)
+}
+
+/// Return to the system arrow cursor
+#[no_mangle]
+pub extern "C" fn Platform_Cursor_SetDefault() {
+    graphics::cursor::set_default();
+}
+
+/// Free a hardware cursor
+#[no_mangle]
+pub extern "C" fn Platform_Cursor_Destroy(handle: i32) {
+    graphics::cursor::destroy(handle);
+}
+
 // =============================================================================
 // Timer FFI
 // =============================================================================
@@ -859,18 +1049,70 @@ pub extern "C" fn Platform_Frame_Begin() {
     timer::with_frame_controller(|fc| fc.begin_frame());
 }
 
-/// End frame timing (sleeps to maintain target FPS)
+/// End frame timing: waits for the frame's deadline to hold the target FPS,
+/// sleeping most of the way and spinning the rest
 #[no_mangle]
 pub extern "C" fn Platform_Frame_End() {
     timer::with_frame_controller(|fc| fc.end_frame());
 }
 
-/// Set target FPS
+/// Set target FPS (starts the pacing stats over)
 #[no_mangle]
 pub extern "C" fn Platform_Frame_SetTargetFPS(fps: u32) {
     timer::with_frame_controller(|fc| fc.set_target_fps(fps));
 }
 
+/// Get target FPS
+#[no_mangle]
+pub extern "C" fn Platform_Frame_GetTargetFPS() -> u32 {
+    timer::with_frame_controller(|fc| fc.target_fps())
+}
+
+/// Turn the Platform_Frame_End sleep on or off, for callers that pace
+/// frames themselves (FPS is still measured)
+#[no_mangle]
+pub extern "C" fn Platform_Frame_SetLimiter(enabled: bool) {
+    timer::with_frame_controller(|fc| fc.set_limiter(enabled));
+}
+
+/// Set how much of the Platform_Frame_End wait is spun rather than
+/// slept, in microseconds (0 sleeps all of it)
+#[no_mangle]
+pub extern "C" fn Platform_Frame_SetSpinThreshold(us: u32) {
+    timer::with_frame_controller(|fc| fc.set_spin_threshold_us(us));
+}
+
+/// Get the spin threshold in microseconds
+#[no_mangle]
+pub extern "C" fn Platform_Frame_GetSpinThreshold() -> u32 {
+    timer::with_frame_controller(|fc| fc.spin_threshold_us())
+}
+
+/// Tell the pacer presents wait for vsync at this refresh rate (0 = they
+/// don't). Graphics init sets this from the display.
+#[no_mangle]
+pub extern "C" fn Platform_Frame_SetVSyncRefresh(hz: u32) {
+    timer::with_frame_controller(|fc| fc.set_vsync_refresh(hz));
+}
+
+/// Get the refresh rate the pacer assumes presents wait for (0 = none)
+#[no_mangle]
+pub extern "C" fn Platform_Frame_GetVSyncRefresh() -> u32 {
+    timer::with_frame_controller(|fc| fc.vsync_refresh())
+}
+
+/// Get frame interval regularity over the recent frames
+///
+/// # Safety
+/// `stats` must be null or point to a writable FramePacingStats
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Frame_GetPacingStats(stats: *mut timer::FramePacingStats) {
+    if stats.is_null() {
+        return;
+    }
+    *stats = timer::with_frame_controller(|fc| fc.pacing_stats());
+}
+
 /// Get last frame time in seconds
 #[no_mangle]
 pub extern "C" fn Platform_Frame_GetTime() -> f64 {
@@ -941,6 +1183,12 @@ pub extern "C" fn Platform_Mem_GetCount() -> usize {
     memory::get_count()
 }
 
+/// Get bytes currently mapped on large pages (PLATFORM_MEM_HUGE_PAGES)
+#[no_mangle]
+pub extern "C" fn Platform_Mem_GetLargePageBytes() -> usize {
+    memory::get_large_page_bytes()
+}
+
 /// Dump leaks (debug only)
 #[no_mangle]
 pub extern "C" fn Platform_Mem_DumpLeaks() {
@@ -1268,6 +1516,110 @@ pub unsafe extern "C" fn Platform_File_Copy(src: *const c_char, dst: *const c_ch
     files::copy_file(src_str, dst_str).map(|n| n as i64).unwrap_or(-1)
 }
 
+/// Backing storage of a Platform_File_Map pointer
+enum FileMapping {
+    #[cfg(unix)]
+    Mapped(crate::assets::mix::MappedFile),
+    /// Whole-file copy where mapping is unavailable
+    #[allow(dead_code)]
+    Owned(Vec<u8>),
+}
+
+impl FileMapping {
+    fn open(path: &str) -> std::io::Result<Self> {
+        #[cfg(unix)]
+        {
+            crate::assets::mix::MappedFile::open(path).map(FileMapping::Mapped)
+        }
+        #[cfg(not(unix))]
+        {
+            std::fs::read(path).map(FileMapping::Owned)
+        }
+    }
+
+    fn as_slice(&self) -> &[u8] {
+        match self {
+            #[cfg(unix)]
+            FileMapping::Mapped(map) => map.as_slice(),
+            FileMapping::Owned(data) => data,
+        }
+    }
+}
+
+/// Mappings handed out by Platform_File_Map, keyed by data pointer
+static FILE_MAPS: once_cell::sync::Lazy<Mutex<HashMap<usize, FileMapping>>> =
+    once_cell::sync::Lazy::new(|| Mutex::new(HashMap::new()));
+
+/// Map a whole file read-only
+///
+/// Each call makes a new mapping (a full read where mapping is not
+/// supported). The pointer stays valid until Platform_File_Unmap().
+///
+/// # Safety
+/// - `path` must be a valid null-terminated C string
+/// - `out_size` must be a valid pointer
+///
+/// # Returns
+/// - Pointer to the file bytes, with the size in `out_size`
+/// - null if missing, empty, or on error (`out_size` set to 0)
+#[no_mangle]
+pub unsafe extern "C" fn Platform_File_Map(path: *const c_char, out_size: *mut i64) -> *const u8 {
+    if out_size.is_null() {
+        return std::ptr::null();
+    }
+    *out_size = 0;
+
+    if path.is_null() {
+        return std::ptr::null();
+    }
+
+    let path_str = match CStr::from_ptr(path).to_str() {
+        Ok(s) => s,
+        Err(_) => return std::ptr::null(),
+    };
+
+    let started = files::io_stats::start();
+    let mapping = match FileMapping::open(path_str) {
+        Ok(mapping) => mapping,
+        Err(e) => {
+            set_error(e.to_string());
+            return std::ptr::null();
+        }
+    };
+
+    let data = mapping.as_slice();
+    if data.is_empty() {
+        return std::ptr::null();
+    }
+    let ptr = data.as_ptr();
+    let size = data.len() as i64;
+    files::io_stats::record(files::io_stats::LOOSE_FILES, Some(path_str), data.len(), started);
+
+    match FILE_MAPS.lock() {
+        Ok(mut maps) => maps.insert(ptr as usize, mapping),
+        Err(_) => return std::ptr::null(),
+    };
+
+    *out_size = size;
+    ptr
+}
+
+/// Release a pointer returned by Platform_File_Map
+///
+/// # Safety
+/// - `data` must be null or a pointer returned by Platform_File_Map that
+///   has not been unmapped yet
+#[no_mangle]
+pub unsafe extern "C" fn Platform_File_Unmap(data: *const u8) {
+    if data.is_null() {
+        return;
+    }
+
+    if let Ok(mut maps) = FILE_MAPS.lock() {
+        maps.remove(&(data as usize));
+    }
+}
+
 /// Open a directory for iteration
 #[no_mangle]
 pub unsafe extern "C" fn Platform_Dir_Open(path: *const c_char) -> *mut PlatformDir {
@@ -1356,6 +1708,126 @@ pub unsafe extern "C" fn Platform_DeleteDirectory(path: *const c_char) -> bool {
     }
 }
 
+// =============================================================================
+// I/O Accounting FFI
+// =============================================================================
+
+use crate::files::io_stats::{self, PlatformIoStats};
+
+/// Copy `text` into a caller buffer, truncated to fit and null-terminated
+unsafe fn copy_name(text: &str, buffer: *mut c_char, buffer_size: i32) {
+    if buffer.is_null() || buffer_size <= 0 {
+        return;
+    }
+    let bytes = text.as_bytes();
+    let copy_len = std::cmp::min(bytes.len(), (buffer_size - 1) as usize);
+    std::ptr::copy_nonoverlapping(bytes.as_ptr(), buffer as *mut u8, copy_len);
+    *buffer.add(copy_len) = 0;
+}
+
+/// Set the caller tag that this thread's file and MIX reads are charged to
+///
+/// # Returns
+/// - The previous tag, so scopes can restore it
+#[no_mangle]
+pub extern "C" fn Platform_Io_SetTag(tag: i32) -> i32 {
+    io_stats::set_tag(tag.clamp(0, u8::MAX as i32) as u8) as i32
+}
+
+/// Turn I/O accounting on or off (on by default)
+#[no_mangle]
+pub extern "C" fn Platform_Io_SetEnabled(enabled: bool) {
+    io_stats::set_enabled(enabled);
+}
+
+/// Forget all recorded reads, archives and repeats
+#[no_mangle]
+pub extern "C" fn Platform_Io_Reset() {
+    io_stats::reset();
+}
+
+/// Get the reads charged to one caller tag
+///
+/// # Returns
+/// - 0 on success, -1 on a null pointer or out-of-range tag
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Io_GetTagStats(tag: i32, out: *mut PlatformIoStats) -> i32 {
+    if out.is_null() || tag < 0 || tag as usize >= io_stats::IO_TAG_COUNT {
+        return -1;
+    }
+    *out = io_stats::tag_stats(tag as usize);
+    0
+}
+
+/// Get all reads recorded since the last reset
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Io_GetTotals(out: *mut PlatformIoStats) -> i32 {
+    if out.is_null() {
+        return -1;
+    }
+    *out = io_stats::totals();
+    0
+}
+
+/// Number of sources read from: MIX archives by path, plus "(files)"
+#[no_mangle]
+pub extern "C" fn Platform_Io_GetSourceCount() -> i32 {
+    io_stats::sources().len() as i32
+}
+
+/// Get a source's name and reads, in the order first read from
+///
+/// # Returns
+/// - 0 on success, -1 if `index` is out of range
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Io_GetSourceStats(
+    index: i32,
+    out: *mut PlatformIoStats,
+    name: *mut c_char,
+    name_size: i32,
+) -> i32 {
+    let sources = io_stats::sources();
+    let Some((source, stats)) = usize::try_from(index).ok().and_then(|i| sources.get(i)) else {
+        return -1;
+    };
+    if !out.is_null() {
+        *out = *stats;
+    }
+    copy_name(source, name, name_size);
+    0
+}
+
+/// Number of entries read more than once since the last reset
+#[no_mangle]
+pub extern "C" fn Platform_Io_GetRepeatCount() -> i32 {
+    io_stats::repeats().len() as i32
+}
+
+/// Get an entry read more than once, most bytes re-read first
+///
+/// # Returns
+/// - 0 on success, -1 if `index` is out of range
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Io_GetRepeat(
+    index: i32,
+    out: *mut PlatformIoStats,
+    source: *mut c_char,
+    source_size: i32,
+    entry: *mut c_char,
+    entry_size: i32,
+) -> i32 {
+    let repeats = io_stats::repeats();
+    let Some((source_name, entry_name, stats)) = usize::try_from(index).ok().and_then(|i| repeats.get(i)) else {
+        return -1;
+    };
+    if !out.is_null() {
+        *out = *stats;
+    }
+    copy_name(source_name, source, source_size);
+    copy_name(entry_name, entry, entry_size);
+    0
+}
+
 // =============================================================================
 // Audio FFI
 // =============================================================================
@@ -1404,6 +1876,18 @@ pub extern "C" fn Platform_Audio_GetMasterVolume() -> f32 {
     audio::get_master_volume()
 }
 
+/// Get mixer statistics for sound effects and streamed sounds; the peaks
+/// restart from each call. Returns 0 on success, -1 if stats is null.
+#[no_mangle]
+pub extern "C" fn Platform_Audio_GetMixerStats(stats: *mut audio::AudioMixerStats) -> i32 {
+    if stats.is_null() {
+        return -1;
+    }
+
+    unsafe { *stats = audio::take_mixer_stats(); }
+    0
+}
+
 // =============================================================================
 // Sound FFI
 // =============================================================================
@@ -1498,6 +1982,52 @@ pub extern "C" fn Platform_Sound_GetPlayingCount() -> i32 {
     audio::get_playing_count() as i32
 }
 
+// =============================================================================
+// Streaming FFI
+// =============================================================================
+
+/// Start a streamed sound holding up to `capacity` queued 16-bit samples.
+/// Stop, volume, pause and resume use the Platform_Sound_* calls.
+#[no_mangle]
+pub extern "C" fn Platform_Stream_Open(
+    sample_rate: i32,
+    channels: i32,
+    capacity: i32,
+    volume: f32,
+) -> PlayHandle {
+    if sample_rate <= 0 || channels <= 0 || capacity <= 0 {
+        return INVALID_PLAY_HANDLE;
+    }
+    audio::open_stream(sample_rate as u32, channels as u16, capacity as usize, volume)
+}
+
+/// Queue interleaved samples on a stream; returns how many were taken
+#[no_mangle]
+pub extern "C" fn Platform_Stream_Write(
+    handle: PlayHandle,
+    samples: *const i16,
+    count: i32,
+) -> i32 {
+    if samples.is_null() || count <= 0 {
+        return 0;
+    }
+
+    let slice = unsafe { std::slice::from_raw_parts(samples, count as usize) };
+    audio::write_stream(handle, slice) as i32
+}
+
+/// Get the number of samples queued on a stream and not yet played
+#[no_mangle]
+pub extern "C" fn Platform_Stream_GetQueued(handle: PlayHandle) -> i32 {
+    audio::get_stream_queued(handle) as i32
+}
+
+/// Mark a stream complete; it stops once its queued samples have played
+#[no_mangle]
+pub extern "C" fn Platform_Stream_Finish(handle: PlayHandle) {
+    audio::finish_stream(handle);
+}
+
 // =============================================================================
 // ADPCM FFI
 // =============================================================================
@@ -1525,16 +2055,10 @@ pub extern "C" fn Platform_Sound_CreateFromADPCM(
         return INVALID_SOUND_HANDLE;
     }
 
-    // Convert i16 samples to bytes for create_sound
-    let bytes: Vec<u8> = samples.iter()
-        .flat_map(|&s| s.to_le_bytes())
-        .collect();
-
-    audio::create_sound(
-        &bytes,
+    audio::create_sound_from_samples(
+        samples,
         sample_rate as u32,
         channels as u16,
-        16, // ADPCM decodes to 16-bit
     )
 }
 
@@ -1561,16 +2085,37 @@ pub extern "C" fn Platform_Sound_CreateFromADPCMWithState(
         return INVALID_SOUND_HANDLE;
     }
 
-    // Convert i16 samples to bytes
-    let bytes: Vec<u8> = samples.iter()
-        .flat_map(|&s| s.to_le_bytes())
-        .collect();
+    audio::create_sound_from_samples(
+        samples,
+        sample_rate as u32,
+        channels as u16,
+    )
+}
+
+/// Create a sound from ADPCM data that stays compressed in memory: each
+/// play decodes it, from the given decoder state, as it is mixed. Takes
+/// the same arguments as Platform_Sound_CreateFromADPCMWithState.
+#[no_mangle]
+pub extern "C" fn Platform_Sound_CreateCompressedADPCM(
+    data: *const c_void,
+    size: i32,
+    sample_rate: i32,
+    channels: i32,
+    predictor: i32,
+    step_index: i32,
+) -> SoundHandle {
+    if data.is_null() || size <= 0 {
+        return INVALID_SOUND_HANDLE;
+    }
+
+    let slice = unsafe { std::slice::from_raw_parts(data as *const u8, size as usize) };
 
-    audio::create_sound(
-        &bytes,
+    audio::create_sound_from_adpcm(
+        slice.to_vec(),
         sample_rate as u32,
         channels as u16,
-        16,
+        predictor,
+        step_index,
     )
 }
 
@@ -1694,6 +2239,33 @@ pub unsafe extern "C" fn Platform_Buffer_VLine(
     );
 }
 
+/// Run a batch of fills, copies and remaps on one buffer
+///
+/// The destination is checked once for the whole batch; ops run in order,
+/// each clipped to the buffer.
+///
+/// # Safety
+/// - `dest` must point to valid memory of at least `pitch * height` bytes
+/// - `ops` must point to `count` ops
+/// - Each copy's `src` must point to `src_pitch * src_height` bytes and
+///   each remap's `src` to 256 bytes
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Buffer_Execute(
+    dest: *mut u8,
+    pitch: i32,
+    width: i32,
+    height: i32,
+    ops: *const blit::batch::PlatformBlitOp,
+    count: i32,
+) {
+    if dest.is_null() || ops.is_null() || count <= 0 || pitch <= 0 || height <= 0 {
+        return;
+    }
+    let dest_slice = std::slice::from_raw_parts_mut(dest, (pitch * height) as usize);
+    let ops = std::slice::from_raw_parts(ops, count as usize);
+    blit::batch::execute(dest_slice, pitch as usize, width, height, ops);
+}
+
 // =============================================================================
 // Buffer Blit FFI (replaces BITBLIT.ASM)
 // =============================================================================
@@ -1938,6 +2510,91 @@ pub unsafe extern "C" fn Platform_Buffer_RemapCopy(
     );
 }
 
+/// Remap from source to destination, skipping source color 0
+///
+/// The house-color blit: 16 pixels at a time are tested for transparency.
+///
+/// # Safety
+/// Same as Platform_Buffer_RemapCopy
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Buffer_RemapCopyTrans(
+    dest: *mut u8,
+    dest_pitch: i32,
+    dest_x: i32,
+    dest_y: i32,
+    src: *const u8,
+    src_pitch: i32,
+    src_x: i32,
+    src_y: i32,
+    width: i32,
+    height: i32,
+    remap_table: *const u8,
+) {
+    if dest.is_null() || src.is_null() || remap_table.is_null() {
+        return;
+    }
+    if dest_pitch <= 0 || src_pitch <= 0 || width <= 0 || height <= 0 {
+        return;
+    }
+
+    let dest_size = (dest_pitch * (dest_y + height)) as usize;
+    let src_size = (src_pitch * (src_y + height)) as usize;
+    let dest_slice = std::slice::from_raw_parts_mut(dest, dest_size);
+    let src_slice = std::slice::from_raw_parts(src, src_size);
+    let table: &[u8; 256] = &*(remap_table as *const [u8; 256]);
+
+    blit::remap::buffer_remap_copy_trans(
+        dest_slice, dest_pitch as usize, dest_x, dest_y,
+        src_slice, src_pitch as usize, src_x, src_y,
+        width, height,
+        table,
+    );
+}
+
+/// Darken destination pixels through a shadow table where a mask is non-zero
+///
+/// The shadow-mask counterpart of Platform_Buffer_RemapCopyTrans: the
+/// lookup is on the destination pixel, the source only says where.
+///
+/// # Safety
+/// - `dest` must point to valid memory of at least `dest_pitch * (dest_y + height)` bytes
+/// - `mask` must point to valid memory of at least `mask_pitch * (mask_y + height)` bytes
+/// - `shadow_table` must point to exactly 256 bytes
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Buffer_RemapShadow(
+    dest: *mut u8,
+    dest_pitch: i32,
+    dest_x: i32,
+    dest_y: i32,
+    mask: *const u8,
+    mask_pitch: i32,
+    mask_x: i32,
+    mask_y: i32,
+    width: i32,
+    height: i32,
+    shadow_table: *const u8,
+) {
+    if dest.is_null() || mask.is_null() || shadow_table.is_null() {
+        return;
+    }
+    if dest_pitch <= 0 || mask_pitch <= 0 || width <= 0 || height <= 0 {
+        return;
+    }
+
+    let dest_size = (dest_pitch * (dest_y + height)) as usize;
+    let mask_size = (mask_pitch * (mask_y + height)) as usize;
+    let dest_slice = std::slice::from_raw_parts_mut(dest, dest_size);
+    let mask_slice = std::slice::from_raw_parts(mask, mask_size);
+    let table: &[u8; 256] = &*(shadow_table as *const [u8; 256]);
+
+    blit::remap::buffer_remap_shadow(
+        dest_slice, dest_pitch as usize, dest_x, dest_y,
+        mask_slice, mask_pitch as usize, mask_x, mask_y,
+        width, height,
+        table,
+    );
+}
+
 // =============================================================================
 // Buffer Scale FFI (replaces SCALE.ASM)
 // =============================================================================
@@ -2068,6 +2725,52 @@ pub unsafe extern "C" fn Platform_Buffer_ScaleTransKey(
     );
 }
 
+/// Scale a 32-bit ARGB image with sharp bilinear filtering
+///
+/// Pixels stay square blocks with blended edges; whole factors on both
+/// axes replicate pixels. Pitches are in bytes and must be multiples of 4.
+///
+/// # Safety
+/// - `dest` must point to valid memory of at least `dest_pitch * dest_height` bytes
+/// - `src` must point to valid memory of at least `src_pitch * src_height` bytes
+/// - Both must be 4-byte aligned
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Buffer_ScaleSharp(
+    dest: *mut u32,
+    dest_pitch: i32,
+    dest_width: i32,
+    dest_height: i32,
+    src: *const u32,
+    src_pitch: i32,
+    src_width: i32,
+    src_height: i32,
+    dest_x: i32,
+    dest_y: i32,
+    scale_width: i32,
+    scale_height: i32,
+) {
+    if dest.is_null() || src.is_null() {
+        return;
+    }
+    if dest_pitch <= 0 || src_pitch <= 0 || dest_pitch % 4 != 0 || src_pitch % 4 != 0 {
+        return;
+    }
+    if dest_height <= 0 || src_height <= 0 {
+        return;
+    }
+
+    let dest_stride = (dest_pitch / 4) as usize;
+    let src_stride = (src_pitch / 4) as usize;
+    let dest_slice = std::slice::from_raw_parts_mut(dest, dest_stride * dest_height as usize);
+    let src_slice = std::slice::from_raw_parts(src, src_stride * src_height as usize);
+
+    blit::scale::buffer_scale_sharp(
+        dest_slice, dest_stride, dest_width, dest_height,
+        src_slice, src_stride, src_width, src_height,
+        dest_x, dest_y, scale_width, scale_height,
+    );
+}
+
 // =============================================================================
 // Shadow FFI (replaces SHADOW.ASM)
 // =============================================================================
@@ -2108,9 +2811,12 @@ pub unsafe extern "C" fn Platform_Buffer_Shadow(
 
 /// Apply shadow using mask sprite
 ///
+/// The mask may be a window into a larger buffer (`mask_pitch` wider
+/// than `width`); its last row is only read `width` bytes in.
+///
 /// # Safety
 /// - `buffer` must point to valid memory
-/// - `mask` must point to valid memory of at least `mask_pitch * height` bytes
+/// - `mask` must point to valid memory of at least `mask_pitch * (height - 1) + width` bytes
 /// - `shadow_table` must point to exactly 256 bytes
 #[no_mangle]
 pub unsafe extern "C" fn Platform_Buffer_ShadowMask(
@@ -2129,12 +2835,12 @@ pub unsafe extern "C" fn Platform_Buffer_ShadowMask(
     if buffer.is_null() || mask.is_null() || shadow_table.is_null() {
         return;
     }
-    if buffer_pitch <= 0 || mask_pitch <= 0 {
+    if buffer_pitch <= 0 || mask_pitch <= 0 || width <= 0 || height <= 0 {
         return;
     }
 
     let buf_size = (buffer_pitch * buffer_height) as usize;
-    let mask_size = (mask_pitch * height) as usize;
+    let mask_size = (mask_pitch * (height - 1) + width) as usize;
     let buffer_slice = std::slice::from_raw_parts_mut(buffer, buf_size);
     let mask_slice = std::slice::from_raw_parts(mask, mask_size);
     let table: &[u8; 256] = &*(shadow_table as *const [u8; 256]);
@@ -2264,7 +2970,7 @@ pub extern "C" fn Platform_LCW_MaxCompressedSize(uncompressed_size: i32) -> i32
 // CRC32 FFI (replaces CRC.ASM)
 // =============================================================================
 
-use crate::util::{crc, random};
+use crate::util::{crc, hash, random};
 
 /// Calculate CRC32 of data
 ///
@@ -2350,10 +3056,28 @@ pub unsafe extern "C" fn Platform_Westwood_CRC_Filename(filename: *const c_char)
         return 0;
     }
 
-    match CStr::from_ptr(filename).to_str() {
-        Ok(s) => crc::westwood_crc_filename(s),
-        Err(_) => 0,
+    crc::westwood_crc_filename_bytes(CStr::from_ptr(filename).to_bytes())
+}
+
+// =============================================================================
+// Hash FFI (engine-internal keys, not Westwood compatible)
+// =============================================================================
+
+/// Hash data to 64 bits for cache keys and state checksums.
+///
+/// Much faster than either CRC on anything past a few bytes, but matches
+/// no Westwood format; never use it for MIX lookups or saved data.
+///
+/// # Safety
+/// - `data` must point to valid memory of at least `size` bytes
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Hash64(data: *const u8, size: i32, seed: u64) -> u64 {
+    if data.is_null() || size <= 0 {
+        return hash::hash64(&[], seed);
     }
+
+    let slice = std::slice::from_raw_parts(data, size as usize);
+    hash::hash64(slice, seed)
 }
 
 // =============================================================================
@@ -2395,13 +3119,26 @@ pub extern "C" fn Platform_Random_Max(max: u32) -> u32 {
 // =============================================================================
 
 use crate::assets::{MixManager, PcxImage, ShapeFile, TemplateFile};
-use crate::assets::mix::MixError;
+use crate::assets::mix::{MixError, MixView};
 use crate::assets::palette::Palette as AssetPalette;
-use std::sync::RwLock;
+use std::collections::HashMap;
+use std::sync::{Mutex, RwLock};
 
 /// Global MIX manager instance
-static MIX_MANAGER: once_cell::sync::Lazy<RwLock<MixManager>> =
-    once_cell::sync::Lazy::new(|| RwLock::new(MixManager::new()));
+///
+/// Decrypted MIX indices are cached under the platform cache directory.
+static MIX_MANAGER: once_cell::sync::Lazy<RwLock<MixManager>> = once_cell::sync::Lazy::new(|| {
+    let mut manager = MixManager::new();
+    manager.set_index_cache_dir(Some(crate::config::get_cache_path().join("mix_index")));
+    RwLock::new(manager)
+});
+
+/// Views handed out by Platform_Mix_Map, keyed by data pointer
+///
+/// The same entry can be mapped more than once and share a pointer, so
+/// each key holds one view per outstanding map.
+static MIX_VIEWS: once_cell::sync::Lazy<Mutex<HashMap<usize, Vec<MixView>>>> =
+    once_cell::sync::Lazy::new(|| Mutex::new(HashMap::new()));
 
 /// Initialize the asset system
 ///
@@ -2415,6 +3152,9 @@ pub extern "C" fn Platform_Assets_Init() -> i32 {
 
 /// Register a MIX file with the asset system
 ///
+/// Encrypted indices are cached under the platform cache directory and
+/// reused while the file's size, mtime and header CRC are unchanged.
+///
 /// # Safety
 /// - `path` must be a valid null-terminated C string
 ///
@@ -2563,8 +3303,9 @@ pub unsafe extern "C" fn Platform_Mix_Read(
 
     match MIX_MANAGER.read() {
         Ok(manager) => {
-            match manager.read(name_str) {
-                Ok(data) => {
+            match manager.map(name_str) {
+                Ok(view) => {
+                    let data = view.as_slice();
                     let copy_len = std::cmp::min(data.len(), buffer_size as usize);
                     std::ptr::copy_nonoverlapping(data.as_ptr(), buffer, copy_len);
                     copy_len as i32
@@ -2611,6 +3352,87 @@ pub unsafe extern "C" fn Platform_Mix_GetSize(filename: *const c_char) -> i32 {
     }
 }
 
+/// Map file data from MIX archives without copying
+///
+/// Returns a read-only pointer straight into the archive: the cached data
+/// for cached archives, otherwise a memory map of the MIX file shared by
+/// all of its entries. The pointer stays valid until Platform_Mix_Unmap(),
+/// even if the archive is uncached or unregistered in the meantime.
+///
+/// # Safety
+/// - `filename` must be a valid null-terminated C string
+/// - `out_size` must be a valid pointer
+///
+/// # Returns
+/// - Pointer to the file data, with its size in `out_size`
+/// - null if not found, empty, or on error (`out_size` set to 0)
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Mix_Map(filename: *const c_char, out_size: *mut i32) -> *const u8 {
+    if out_size.is_null() {
+        return std::ptr::null();
+    }
+    *out_size = 0;
+
+    if filename.is_null() {
+        return std::ptr::null();
+    }
+
+    let name_str = match CStr::from_ptr(filename).to_str() {
+        Ok(s) => s,
+        Err(_) => return std::ptr::null(),
+    };
+
+    let view = match MIX_MANAGER.read() {
+        Ok(manager) => match manager.map(name_str) {
+            Ok(view) => view,
+            Err(MixError::FileNotFound(_)) => return std::ptr::null(),
+            Err(e) => {
+                set_error(e.to_string());
+                return std::ptr::null();
+            }
+        },
+        Err(_) => return std::ptr::null(),
+    };
+
+    if view.is_empty() {
+        return std::ptr::null();
+    }
+
+    let data = view.as_slice();
+    let ptr = data.as_ptr();
+    let size = data.len() as i32;
+
+    match MIX_VIEWS.lock() {
+        Ok(mut views) => views.entry(ptr as usize).or_default().push(view),
+        Err(_) => return std::ptr::null(),
+    }
+
+    *out_size = size;
+    ptr
+}
+
+/// Release a pointer returned by Platform_Mix_Map
+///
+/// # Safety
+/// - `data` must be null or a pointer returned by Platform_Mix_Map that
+///   has not been unmapped yet
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Mix_Unmap(data: *const u8) {
+    if data.is_null() {
+        return;
+    }
+
+    if let Ok(mut views) = MIX_VIEWS.lock() {
+        let key = data as usize;
+        if let Some(list) = views.get_mut(&key) {
+            list.pop();
+            if list.is_empty() {
+                views.remove(&key);
+            }
+        }
+    }
+}
+
 /// Get number of registered MIX files
 #[no_mangle]
 pub extern "C" fn Platform_Mix_GetCount() -> i32 {
@@ -2620,6 +3442,27 @@ pub extern "C" fn Platform_Mix_GetCount() -> i32 {
     }
 }
 
+/// Get the bytes held by cached MIX data
+#[no_mangle]
+pub extern "C" fn Platform_Mix_GetCachedBytes() -> usize {
+    match MIX_MANAGER.read() {
+        Ok(manager) => manager.cached_bytes(),
+        Err(_) => 0,
+    }
+}
+
+/// Drop cached data of MIX files that can be re-read from disk
+///
+/// # Returns
+/// - Bytes released
+#[no_mangle]
+pub extern "C" fn Platform_Mix_ReleaseCaches() -> usize {
+    match MIX_MANAGER.write() {
+        Ok(mut manager) => manager.release_caches(),
+        Err(_) => 0,
+    }
+}
+
 /// Register a nested MIX file
 ///
 /// This extracts a MIX file that's stored inside another registered MIX file
@@ -2746,14 +3589,14 @@ pub unsafe extern "C" fn Platform_Palette_Load(
 
     match MIX_MANAGER.read() {
         Ok(manager) => {
-            match manager.read(name_str) {
+            match manager.map(name_str) {
                 Ok(data) => {
                     if data.len() != 768 {
                         set_error(format!("Invalid palette size: {}", data.len()));
                         return -1;
                     }
 
-                    match AssetPalette::from_pal_data(&data) {
+                    match AssetPalette::from_pal_data(data.as_slice()) {
                         Ok(palette) => {
                             let rgb = palette.to_rgb_bytes();
                             std::ptr::copy_nonoverlapping(rgb.as_ptr(), output, 768);
@@ -2805,9 +3648,9 @@ pub unsafe extern "C" fn Platform_Shape_Load(filename: *const c_char) -> *mut Pl
 
     match MIX_MANAGER.read() {
         Ok(manager) => {
-            match manager.read(name_str) {
+            match manager.map(name_str) {
                 Ok(data) => {
-                    match ShapeFile::from_data(&data) {
+                    match ShapeFile::from_data(data.as_slice()) {
                         Ok(shape) => {
                             Box::into_raw(Box::new(PlatformShape { inner: shape }))
                         }
@@ -2928,6 +3771,21 @@ pub unsafe extern "C" fn Platform_Shape_GetFrame(
     }
 
     let s = &(*shape).inner;
+    if frame_index < 0 || frame_index as usize >= s.frame_count() {
+        return 0;
+    }
+
+    // Room for the whole frame: decode in place
+    if buffer_size as usize >= s.frame_size() {
+        let out = std::slice::from_raw_parts_mut(buffer, s.frame_size());
+        return match s.decode_range(frame_index as usize, out) {
+            Ok(_) => out.len() as i32,
+            Err(e) => {
+                set_error(e.to_string());
+                -1
+            }
+        };
+    }
 
     match s.frame(frame_index as usize) {
         Some(frame) => {
@@ -2935,7 +3793,46 @@ pub unsafe extern "C" fn Platform_Shape_GetFrame(
             std::ptr::copy_nonoverlapping(frame.pixels.as_ptr(), buffer, copy_len);
             copy_len as i32
         }
-        None => 0,
+        None => -1,
+    }
+}
+
+/// Decode consecutive frames into one buffer
+///
+/// Frames are written back to back, width * height bytes each, starting
+/// with `first_frame`. Walking frames in order lets each XOR delta frame
+/// use the frame already written before it, so decoding a whole shape is
+/// a single pass.
+///
+/// # Safety
+/// - `shape` must be a valid shape pointer
+/// - `buffer` must point to at least `buffer_size` bytes
+///
+/// # Returns
+/// - Number of frames decoded (up to `frame_count`, as many as fit)
+/// - -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Shape_DecodeRange(
+    shape: *const PlatformShape,
+    first_frame: i32,
+    frame_count: i32,
+    buffer: *mut u8,
+    buffer_size: i32,
+) -> i32 {
+    if shape.is_null() || buffer.is_null() || buffer_size <= 0 || first_frame < 0 || frame_count < 0 {
+        return -1;
+    }
+
+    let s = &(*shape).inner;
+    let wanted = (frame_count as usize).saturating_mul(s.frame_size());
+    let out = std::slice::from_raw_parts_mut(buffer, std::cmp::min(wanted, buffer_size as usize));
+
+    match s.decode_range(first_frame as usize, out) {
+        Ok(count) => count as i32,
+        Err(e) => {
+            set_error(e.to_string());
+            -1
+        }
     }
 }
 
@@ -3090,9 +3987,9 @@ pub unsafe extern "C" fn Platform_PCX_Load(filename: *const c_char) -> *mut Plat
 
     match MIX_MANAGER.read() {
         Ok(manager) => {
-            match manager.read(name_str) {
+            match manager.map(name_str) {
                 Ok(data) => {
-                    match PcxImage::from_data(&data) {
+                    match PcxImage::from_data(data.as_slice()) {
                         Ok(pcx) => {
                             Box::into_raw(Box::new(PlatformPcx { inner: pcx }))
                         }
@@ -0,0 +1,311 @@
+//! I/O accounting
+//!
+//! Counts every read that goes through the platform layer: loose files
+//! (`PlatformFile`, `Platform_File_Map`) and MIX entries (`MixManager::read`
+//! and `MixManager::map`, which every MIX FFI entry point and the Rust-side
+//! shape, palette and PCX loaders go through). Each read is charged to:
+//!
+//! - the caller tag of the reading thread (set by the game with
+//!   `Platform_Io_SetTag`, e.g. graphics, audio, scenario)
+//! - its source: the MIX archive path, or `(files)` for loose files
+//! - the entry it read, so that the same entry read twice in one session
+//!   shows up as a repeat along with the bytes the second read wasted
+//!
+//! Mapped reads are counted at map time with the size of the entry; the
+//! time recorded for them is only the cost of setting up the view, the
+//! disk reads themselves happen later as page faults.
+
+use once_cell::sync::Lazy;
+use std::cell::Cell;
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Mutex;
+use std::time::Instant;
+
+/// Caller tags the game can set; higher values are folded into the last
+pub const IO_TAG_COUNT: usize = 16;
+
+/// Source name for reads of loose files
+pub const LOOSE_FILES: &str = "(files)";
+
+/// Read counters for one tag, source or entry
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct PlatformIoStats {
+    /// Read calls
+    pub calls: u64,
+    /// Bytes read
+    pub bytes: u64,
+    /// Time spent inside the read calls, nanoseconds
+    pub blocked_ns: u64,
+    /// Calls that read an entry already read this session
+    pub repeat_calls: u64,
+    /// Bytes those repeated reads read again
+    pub repeat_bytes: u64,
+}
+
+impl PlatformIoStats {
+    fn add(&mut self, bytes: u64, blocked_ns: u64, first_call: bool, repeat: bool) {
+        if first_call {
+            self.calls += 1;
+            if repeat {
+                self.repeat_calls += 1;
+            }
+        }
+        self.bytes += bytes;
+        self.blocked_ns += blocked_ns;
+        if repeat {
+            self.repeat_bytes += bytes;
+        }
+    }
+}
+
+/// A recorded read of an entry, for charging follow-up reads on the same
+/// handle to it (a loose file read in chunks is one read of the file)
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct EntryId {
+    source: u32,
+    entry: u32,
+    repeat: bool,
+}
+
+struct Source {
+    name: String,
+    stats: PlatformIoStats,
+}
+
+struct Entry {
+    source: u32,
+    name: String,
+    stats: PlatformIoStats,
+}
+
+#[derive(Default)]
+struct Ledger {
+    tags: [PlatformIoStats; IO_TAG_COUNT],
+    sources: Vec<Source>,
+    source_index: HashMap<String, u32>,
+    entries: Vec<Entry>,
+    entry_index: HashMap<(u32, String), u32>,
+}
+
+impl Ledger {
+    fn source(&mut self, name: &str) -> u32 {
+        if let Some(&index) = self.source_index.get(name) {
+            return index;
+        }
+        let index = self.sources.len() as u32;
+        self.sources.push(Source { name: name.to_string(), stats: PlatformIoStats::default() });
+        self.source_index.insert(name.to_string(), index);
+        index
+    }
+
+    fn charge(&mut self, id: EntryId, bytes: u64, blocked_ns: u64, first_call: bool) {
+        let tag = current_tag() as usize;
+        self.tags[tag].add(bytes, blocked_ns, first_call, id.repeat);
+        self.sources[id.source as usize].stats.add(bytes, blocked_ns, first_call, id.repeat);
+        if id.entry != u32::MAX {
+            self.entries[id.entry as usize].stats.add(bytes, blocked_ns, first_call, id.repeat);
+        }
+    }
+}
+
+static ENABLED: AtomicBool = AtomicBool::new(true);
+
+static LEDGER: Lazy<Mutex<Ledger>> = Lazy::new(|| Mutex::new(Ledger::default()));
+
+thread_local! {
+    static CURRENT_TAG: Cell<u8> = Cell::new(0);
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+/// Set the caller tag for reads on this thread; returns the previous one
+pub fn set_tag(tag: u8) -> u8 {
+    let tag = tag.min(IO_TAG_COUNT as u8 - 1);
+    CURRENT_TAG.with(|current| current.replace(tag))
+}
+
+/// Caller tag of this thread
+pub fn current_tag() -> u8 {
+    CURRENT_TAG.with(|current| current.get())
+}
+
+/// Turn accounting on or off (on by default)
+pub fn set_enabled(enabled: bool) {
+    ENABLED.store(enabled, Ordering::Relaxed);
+}
+
+pub fn is_enabled() -> bool {
+    ENABLED.load(Ordering::Relaxed)
+}
+
+/// Start timing a read; None when accounting is off
+#[inline]
+pub fn start() -> Option<Instant> {
+    if is_enabled() {
+        Some(Instant::now())
+    } else {
+        None
+    }
+}
+
+/// Record a finished read of `entry` (or of no particular entry) from
+/// `source`. Returns the entry's id for follow-up reads, None when
+/// accounting was off at `start()`.
+pub fn record(source: &str, entry: Option<&str>, bytes: usize, started: Option<Instant>) -> Option<EntryId> {
+    let started = started?;
+    let blocked_ns = started.elapsed().as_nanos() as u64;
+    let mut ledger = LEDGER.lock().ok()?;
+
+    let source = ledger.source(source);
+    let id = match entry {
+        Some(name) => {
+            let key = (source, name.to_ascii_uppercase());
+            match ledger.entry_index.get(&key) {
+                Some(&index) => EntryId { source, entry: index, repeat: true },
+                None => {
+                    let index = ledger.entries.len() as u32;
+                    ledger.entries.push(Entry {
+                        source,
+                        name: key.1.clone(),
+                        stats: PlatformIoStats::default(),
+                    });
+                    ledger.entry_index.insert(key, index);
+                    EntryId { source, entry: index, repeat: false }
+                }
+            }
+        }
+        None => EntryId { source, entry: u32::MAX, repeat: false },
+    };
+
+    ledger.charge(id, bytes as u64, blocked_ns, true);
+    Some(id)
+}
+
+/// Record a further read of an entry `record()` already counted; the
+/// bytes and time add to it without counting another call
+pub fn record_more(id: EntryId, bytes: usize, started: Option<Instant>) {
+    let Some(started) = started else { return };
+    let blocked_ns = started.elapsed().as_nanos() as u64;
+    if let Ok(mut ledger) = LEDGER.lock() {
+        ledger.charge(id, bytes as u64, blocked_ns, false);
+    }
+}
+
+/// Forget everything recorded so far
+pub fn reset() {
+    if let Ok(mut ledger) = LEDGER.lock() {
+        *ledger = Ledger::default();
+    }
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+pub fn tag_stats(tag: usize) -> PlatformIoStats {
+    match LEDGER.lock() {
+        Ok(ledger) if tag < IO_TAG_COUNT => ledger.tags[tag],
+        _ => PlatformIoStats::default(),
+    }
+}
+
+/// All reads, whatever their tag
+pub fn totals() -> PlatformIoStats {
+    let mut total = PlatformIoStats::default();
+    if let Ok(ledger) = LEDGER.lock() {
+        for stats in &ledger.tags {
+            total.calls += stats.calls;
+            total.bytes += stats.bytes;
+            total.blocked_ns += stats.blocked_ns;
+            total.repeat_calls += stats.repeat_calls;
+            total.repeat_bytes += stats.repeat_bytes;
+        }
+    }
+    total
+}
+
+/// Sources in the order they were first read from
+pub fn sources() -> Vec<(String, PlatformIoStats)> {
+    match LEDGER.lock() {
+        Ok(ledger) => ledger.sources.iter().map(|s| (s.name.clone(), s.stats)).collect(),
+        Err(_) => Vec::new(),
+    }
+}
+
+/// Entries read more than once as (source, entry, stats), most bytes
+/// wasted first
+pub fn repeats() -> Vec<(String, String, PlatformIoStats)> {
+    let Ok(ledger) = LEDGER.lock() else { return Vec::new() };
+    let mut repeats: Vec<_> = ledger
+        .entries
+        .iter()
+        .filter(|e| e.stats.repeat_calls > 0)
+        .map(|e| (ledger.sources[e.source as usize].name.clone(), e.name.clone(), e.stats))
+        .collect();
+    repeats.sort_by(|a, b| b.2.repeat_bytes.cmp(&a.2.repeat_bytes).then(a.1.cmp(&b.1)));
+    repeats
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // The ledger is global, so everything runs in one test
+    #[test]
+    fn test_io_accounting() {
+        reset();
+        let previous = set_tag(3);
+
+        let first = record("MAIN.MIX", Some("rules.ini"), 100, start()).unwrap();
+        assert!(!first.repeat);
+        let again = record("MAIN.MIX", Some("RULES.INI"), 100, start()).unwrap();
+        assert!(again.repeat);
+        assert_eq!(again.entry, first.entry);
+
+        // Same name in another archive is another entry
+        let other = record("LOCAL.MIX", Some("RULES.INI"), 50, start()).unwrap();
+        assert!(!other.repeat);
+
+        // A loose file read in two chunks is one call
+        let file = record(LOOSE_FILES, Some("/data/a.ini"), 10, start()).unwrap();
+        record_more(file, 20, start());
+
+        set_tag(previous);
+        record(LOOSE_FILES, None, 5, start());
+
+        let tag = tag_stats(3);
+        assert_eq!(tag.calls, 4);
+        assert_eq!(tag.bytes, 280);
+        assert_eq!(tag.repeat_calls, 1);
+        assert_eq!(tag.repeat_bytes, 100);
+        assert_eq!(totals().bytes, 285);
+        assert_eq!(totals().calls, 5);
+
+        let sources = sources();
+        assert_eq!(sources.len(), 3);
+        assert_eq!(sources[0].0, "MAIN.MIX");
+        assert_eq!(sources[0].1.bytes, 200);
+        assert_eq!(sources[2].1.calls, 2);
+
+        let repeats = repeats();
+        assert_eq!(repeats.len(), 1);
+        assert_eq!(repeats[0].1, "RULES.INI");
+        assert_eq!(repeats[0].2.calls, 2);
+
+        // Out-of-range tags fold into the last one
+        assert_eq!(set_tag(200), previous);
+        assert_eq!(current_tag(), IO_TAG_COUNT as u8 - 1);
+        set_tag(previous);
+
+        set_enabled(false);
+        assert!(record(LOOSE_FILES, None, 5, start()).is_none());
+        set_enabled(true);
+
+        reset();
+        assert_eq!(totals(), PlatformIoStats::default());
+    }
+}
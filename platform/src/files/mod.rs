@@ -2,6 +2,7 @@
 //!
 //! Provides cross-platform file I/O with Windows path compatibility.
 
+pub mod io_stats;
 pub mod path;
 
 use crate::error::PlatformError;
@@ -45,6 +46,8 @@ pub struct PlatformFile {
     path: PathBuf,
     mode: FileMode,
     size: i64,
+    /// The read counted by io_stats, once the file has been read from
+    io_entry: Option<io_stats::EntryId>,
 }
 
 impl PlatformFile {
@@ -81,22 +84,39 @@ impl PlatformFile {
             path: file_path,
             mode,
             size,
+            io_entry: None,
         })
     }
 
     /// Read bytes from file into buffer
     /// Returns number of bytes read
     pub fn read(&mut self, buffer: &mut [u8]) -> Result<usize, PlatformError> {
-        Ok(self.file.read(buffer)?)
+        let started = io_stats::start();
+        let n = self.file.read(buffer)?;
+        self.account_read(n, started);
+        Ok(n)
     }
 
     /// Read entire file contents
     pub fn read_all(&mut self) -> Result<Vec<u8>, PlatformError> {
+        let started = io_stats::start();
         let mut buffer = Vec::new();
         self.file.read_to_end(&mut buffer)?;
+        self.account_read(buffer.len(), started);
         Ok(buffer)
     }
 
+    /// All reads through one handle count as one read of the file
+    fn account_read(&mut self, bytes: usize, started: Option<std::time::Instant>) {
+        match self.io_entry {
+            Some(id) => io_stats::record_more(id, bytes, started),
+            None => {
+                let path = self.path.to_string_lossy();
+                self.io_entry = io_stats::record(io_stats::LOOSE_FILES, Some(&path), bytes, started);
+            }
+        }
+    }
+
     /// Write bytes to file
     /// Returns number of bytes written
     pub fn write(&mut self, buffer: &[u8]) -> Result<usize, PlatformError> {
@@ -0,0 +1,116 @@
+//! Hardware colour cursors
+//!
+//! A cursor drawn into the back buffer only moves when a frame is
+//! presented. An SDL colour cursor is composited by the OS, so it follows
+//! the mouse at input rate whatever the game's frame rate. Cursors are
+//! created once per image and kept by handle; switching between them is
+//! just `SDL_SetCursor`.
+
+use once_cell::sync::Lazy;
+use sdl2::sys;
+use std::ffi::c_void;
+use std::sync::Mutex;
+
+/// Returned by `create` on failure
+pub const INVALID_CURSOR_HANDLE: i32 = -1;
+
+struct CursorSlot(*mut sys::SDL_Cursor);
+
+// SDL cursors are only touched on the main thread; the mutex guards the table
+unsafe impl Send for CursorSlot {}
+
+static CURSORS: Lazy<Mutex<Vec<Option<CursorSlot>>>> = Lazy::new(|| Mutex::new(Vec::new()));
+
+/// Create a cursor from ARGB8888 pixels (alpha 0 = transparent)
+pub fn create(argb: &[u32], width: i32, height: i32, hot_x: i32, hot_y: i32) -> i32 {
+    if width <= 0 || height <= 0 || argb.len() < (width * height) as usize {
+        return INVALID_CURSOR_HANDLE;
+    }
+
+    let cursor = unsafe {
+        let surface = sys::SDL_CreateRGBSurfaceFrom(
+            argb.as_ptr() as *mut c_void,
+            width,
+            height,
+            32,
+            width * 4,
+            0x00FF_0000,
+            0x0000_FF00,
+            0x0000_00FF,
+            0xFF00_0000,
+        );
+        if surface.is_null() {
+            return INVALID_CURSOR_HANDLE;
+        }
+        // SDL copies the pixels, so the surface can go straight away
+        let cursor = sys::SDL_CreateColorCursor(
+            surface,
+            hot_x.clamp(0, width - 1),
+            hot_y.clamp(0, height - 1),
+        );
+        sys::SDL_FreeSurface(surface);
+        cursor
+    };
+    if cursor.is_null() {
+        return INVALID_CURSOR_HANDLE;
+    }
+
+    let mut cursors = CURSORS.lock().unwrap();
+    let slot = match cursors.iter().position(|c| c.is_none()) {
+        Some(i) => i,
+        None => {
+            cursors.push(None);
+            cursors.len() - 1
+        }
+    };
+    cursors[slot] = Some(CursorSlot(cursor));
+    slot as i32
+}
+
+/// Make a cursor current and visible
+pub fn set(handle: i32) -> bool {
+    let cursors = CURSORS.lock().unwrap();
+    match cursors.get(handle as usize) {
+        Some(Some(slot)) if handle >= 0 => {
+            unsafe {
+                sys::SDL_SetCursor(slot.0);
+                sys::SDL_ShowCursor(sys::SDL_ENABLE as i32);
+            }
+            true
+        }
+        _ => false,
+    }
+}
+
+/// Back to the system arrow
+pub fn set_default() {
+    unsafe {
+        let cursor = sys::SDL_GetDefaultCursor();
+        if !cursor.is_null() {
+            sys::SDL_SetCursor(cursor);
+        }
+    }
+}
+
+/// Free a cursor; if it is current, the system arrow replaces it
+pub fn destroy(handle: i32) {
+    if handle < 0 {
+        return;
+    }
+    let mut cursors = CURSORS.lock().unwrap();
+    if let Some(entry) = cursors.get_mut(handle as usize) {
+        if let Some(slot) = entry.take() {
+            unsafe {
+                if sys::SDL_GetCursor() == slot.0 {
+                    set_default();
+                }
+                sys::SDL_FreeCursor(slot.0);
+            }
+        }
+    }
+}
+
+/// Number of live cursors
+pub fn count() -> usize {
+    CURSORS.lock().unwrap().iter().filter(|c| c.is_some()).count()
+}
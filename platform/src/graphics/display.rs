@@ -181,7 +181,7 @@ use std::os::raw::c_int;
 #[no_mangle]
 pub extern "C" fn Platform_IsRetinaDisplay() -> c_int {
     super::with_graphics(|state| {
-        if is_retina_display(state.canvas.window()) {
+        if state.window().map_or(false, is_retina_display) {
             1
         } else {
             0
@@ -208,7 +208,7 @@ pub unsafe extern "C" fn Platform_GetDisplayScale(
     scale_y: *mut f32,
 ) -> c_int {
     match super::with_graphics(|state| {
-        get_display_scale(state.canvas.window())
+        state.window().map_or(DisplayScale::unity(), get_display_scale)
     }) {
         Some(scale) => {
             if !scale_x.is_null() {
@@ -233,7 +233,7 @@ pub unsafe extern "C" fn Platform_GetDisplayScale(
 #[no_mangle]
 pub extern "C" fn Platform_ToggleFullscreen() -> c_int {
     super::with_graphics(|state| {
-        if toggle_fullscreen(state.canvas.window_mut()) {
+        if state.window_mut().map_or(false, toggle_fullscreen) {
             0
         } else {
             -1
@@ -253,7 +253,7 @@ pub extern "C" fn Platform_ToggleFullscreen() -> c_int {
 #[no_mangle]
 pub extern "C" fn Platform_SetFullscreen(fullscreen: c_int) -> c_int {
     super::with_graphics(|state| {
-        if set_fullscreen(state.canvas.window_mut(), fullscreen != 0) {
+        if state.window_mut().map_or(false, |window| set_fullscreen(window, fullscreen != 0)) {
             0
         } else {
             -1
@@ -271,7 +271,7 @@ pub extern "C" fn Platform_SetFullscreen(fullscreen: c_int) -> c_int {
 #[no_mangle]
 pub extern "C" fn Platform_IsFullscreen() -> c_int {
     super::with_graphics(|state| {
-        if is_fullscreen(state.canvas.window()) {
+        if state.window().map_or(false, is_fullscreen) {
             1
         } else {
             0
@@ -295,7 +295,11 @@ pub unsafe extern "C" fn Platform_GetWindowSize(
     height: *mut c_int,
 ) -> c_int {
     match super::with_graphics(|state| {
-        get_window_size(state.canvas.window())
+        // Headless, the "window" is the game resolution
+        state.window().map_or(
+            WindowSize { width: state.display_mode.width, height: state.display_mode.height },
+            get_window_size,
+        )
     }) {
         Some(size) => {
             if !width.is_null() {
@@ -327,7 +331,10 @@ pub unsafe extern "C" fn Platform_GetDrawableSize(
     height: *mut c_int,
 ) -> c_int {
     match super::with_graphics(|state| {
-        get_drawable_size(state.canvas.window())
+        state.window().map_or(
+            DrawableSize { width: state.display_mode.width, height: state.display_mode.height },
+            get_drawable_size,
+        )
     }) {
         Some(size) => {
             if !width.is_null() {
@@ -352,7 +359,7 @@ pub unsafe extern "C" fn Platform_GetDrawableSize(
 #[no_mangle]
 pub extern "C" fn Platform_GetFullscreenState() -> c_int {
     super::with_graphics(|state| {
-        get_fullscreen_state(state.canvas.window()) as c_int
+        state.window().map_or(FullscreenState::Windowed, get_fullscreen_state) as c_int
     })
     .unwrap_or(-1)
 }
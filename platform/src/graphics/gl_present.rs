@@ -0,0 +1,332 @@
+//! GPU palette lookup presentation
+//!
+//! Presents the 8-bit back buffer without converting it on the CPU: the
+//! back buffer is uploaded as a one-channel texture, the palette LUT as a
+//! 256x1 texture, and a fragment shader looks each pixel up while the
+//! quad is scaled to the window. A flip uploads a quarter of the bytes of
+//! an ARGB frame, and a palette change (color cycling, fades) costs a 1 KB
+//! palette upload instead of reconverting every pixel that shows it.
+//!
+//! This talks to OpenGL 2.1 directly (SDL_Renderer has no custom shaders),
+//! with the few entry points it needs loaded through SDL_GL_GetProcAddress.
+//! Anything that fails here makes the caller fall back to the renderer.
+
+use crate::blit::ClipRect;
+use crate::error::PlatformError;
+use super::DisplayMode;
+use sdl2::video::{GLContext, GLProfile, SwapInterval, Window};
+use sdl2::VideoSubsystem;
+use std::ffi::{c_char, c_void, CString};
+
+// OpenGL enums
+const GL_TEXTURE_2D: u32 = 0x0DE1;
+const GL_TEXTURE_MAG_FILTER: u32 = 0x2800;
+const GL_TEXTURE_MIN_FILTER: u32 = 0x2801;
+const GL_TEXTURE_WRAP_S: u32 = 0x2802;
+const GL_TEXTURE_WRAP_T: u32 = 0x2803;
+const GL_NEAREST: i32 = 0x2600;
+const GL_CLAMP_TO_EDGE: i32 = 0x812F;
+const GL_UNPACK_ROW_LENGTH: u32 = 0x0CF2;
+const GL_UNPACK_ALIGNMENT: u32 = 0x0CF5;
+const GL_UNSIGNED_BYTE: u32 = 0x1401;
+const GL_FLOAT: u32 = 0x1406;
+const GL_LUMINANCE: u32 = 0x1909;
+const GL_RGBA: u32 = 0x1908;
+const GL_BGRA: u32 = 0x80E1;
+const GL_UNSIGNED_INT_8_8_8_8_REV: u32 = 0x8367;
+const GL_TEXTURE0: u32 = 0x84C0;
+const GL_FRAGMENT_SHADER: u32 = 0x8B30;
+const GL_VERTEX_SHADER: u32 = 0x8B31;
+const GL_COMPILE_STATUS: u32 = 0x8B81;
+const GL_LINK_STATUS: u32 = 0x8B82;
+const GL_TRIANGLE_STRIP: u32 = 0x0005;
+const GL_COLOR_BUFFER_BIT: u32 = 0x4000;
+
+const VERTEX_SHADER: &str = "#version 120
+attribute vec2 position;
+varying vec2 uv;
+void main() {
+    uv = vec2(position.x * 0.5 + 0.5, 0.5 - position.y * 0.5);
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+";
+
+// Index i arrives as i/255; texel i of the palette is centered at (i+0.5)/256
+const FRAGMENT_SHADER: &str = "#version 120
+uniform sampler2D screen;
+uniform sampler2D palette;
+varying vec2 uv;
+void main() {
+    float index = texture2D(screen, uv).r * 255.0;
+    gl_FragColor = vec4(texture2D(palette, vec2((index + 0.5) / 256.0, 0.5)).rgb, 1.0);
+}
+";
+
+/// Full-window quad as a triangle strip
+const QUAD: [f32; 8] = [-1.0, -1.0, 1.0, -1.0, -1.0, 1.0, 1.0, 1.0];
+
+/// Position attribute slot, bound before linking
+const POSITION_ATTRIB: u32 = 0;
+
+macro_rules! gl_functions {
+    ($($field:ident: $name:literal fn($($arg:ty),*) $(-> $ret:ty)?;)*) => {
+        /// The OpenGL entry points used here
+        struct Gl {
+            $($field: unsafe extern "system" fn($($arg),*) $(-> $ret)?,)*
+        }
+
+        impl Gl {
+            fn load(video: &VideoSubsystem) -> Result<Self, PlatformError> {
+                Ok(Self {
+                    $($field: unsafe {
+                        let address = video.gl_get_proc_address($name);
+                        if address.is_null() {
+                            return Err(PlatformError::Graphics(format!("{} not available", $name)));
+                        }
+                        std::mem::transmute::<*const (), unsafe extern "system" fn($($arg),*) $(-> $ret)?>(address)
+                    },)*
+                })
+            }
+        }
+    };
+}
+
+gl_functions! {
+    active_texture: "glActiveTexture" fn(u32);
+    attach_shader: "glAttachShader" fn(u32, u32);
+    bind_attrib_location: "glBindAttribLocation" fn(u32, u32, *const c_char);
+    bind_texture: "glBindTexture" fn(u32, u32);
+    clear: "glClear" fn(u32);
+    clear_color: "glClearColor" fn(f32, f32, f32, f32);
+    compile_shader: "glCompileShader" fn(u32);
+    create_program: "glCreateProgram" fn() -> u32;
+    create_shader: "glCreateShader" fn(u32) -> u32;
+    delete_program: "glDeleteProgram" fn(u32);
+    delete_shader: "glDeleteShader" fn(u32);
+    delete_textures: "glDeleteTextures" fn(i32, *const u32);
+    draw_arrays: "glDrawArrays" fn(u32, i32, i32);
+    enable_vertex_attrib_array: "glEnableVertexAttribArray" fn(u32);
+    gen_textures: "glGenTextures" fn(i32, *mut u32);
+    get_program_info_log: "glGetProgramInfoLog" fn(u32, i32, *mut i32, *mut c_char);
+    get_programiv: "glGetProgramiv" fn(u32, u32, *mut i32);
+    get_shader_info_log: "glGetShaderInfoLog" fn(u32, i32, *mut i32, *mut c_char);
+    get_shaderiv: "glGetShaderiv" fn(u32, u32, *mut i32);
+    get_uniform_location: "glGetUniformLocation" fn(u32, *const c_char) -> i32;
+    link_program: "glLinkProgram" fn(u32);
+    pixel_storei: "glPixelStorei" fn(u32, i32);
+    shader_source: "glShaderSource" fn(u32, i32, *const *const c_char, *const i32);
+    tex_image_2d: "glTexImage2D" fn(u32, i32, i32, i32, i32, i32, u32, u32, *const c_void);
+    tex_parameteri: "glTexParameteri" fn(u32, u32, i32);
+    tex_sub_image_2d: "glTexSubImage2D" fn(u32, i32, i32, i32, i32, i32, u32, u32, *const c_void);
+    uniform_1i: "glUniform1i" fn(i32, i32);
+    use_program: "glUseProgram" fn(u32);
+    vertex_attrib_pointer: "glVertexAttribPointer" fn(u32, i32, u32, u8, i32, *const c_void);
+    viewport: "glViewport" fn(i32, i32, i32, i32);
+}
+
+/// An OpenGL window presenting through the palette shader
+pub struct GlOutput {
+    gl: Gl,
+    program: u32,
+    /// Back buffer indices (GL_LUMINANCE, game resolution)
+    screen_texture: u32,
+    /// Palette LUT (256x1 RGBA)
+    palette_texture: u32,
+    width: i32,
+    height: i32,
+    // Dropped in this order: the context before its window
+    context: GLContext,
+    window: Window,
+}
+
+impl GlOutput {
+    /// Create the window with a GL 2.1 context and the shader program
+    pub fn new(video: &VideoSubsystem, title: &str, mode: DisplayMode) -> Result<Self, PlatformError> {
+        let (width, height) = (mode.width, mode.height);
+        let attr = video.gl_attr();
+        attr.set_context_profile(GLProfile::Compatibility);
+        attr.set_context_version(2, 1);
+        attr.set_double_buffer(true);
+
+        let (window_w, window_h) = mode.window_size();
+        let window = video
+            .window(title, window_w, window_h)
+            .position_centered()
+            .resizable()
+            .opengl()
+            .build()
+            .map_err(|e| PlatformError::Graphics(e.to_string()))?;
+        let context = window.gl_create_context().map_err(PlatformError::Graphics)?;
+        window.gl_make_current(&context).map_err(PlatformError::Graphics)?;
+        let _ = video.gl_set_swap_interval(SwapInterval::VSync);
+
+        let gl = Gl::load(video)?;
+        let mut output = Self {
+            gl,
+            program: 0,
+            screen_texture: 0,
+            palette_texture: 0,
+            width,
+            height,
+            context,
+            window,
+        };
+        unsafe { output.create_objects()? };
+        Ok(output)
+    }
+
+    unsafe fn create_objects(&mut self) -> Result<(), PlatformError> {
+        let gl = &self.gl;
+
+        let vertex = self.compile(GL_VERTEX_SHADER, VERTEX_SHADER)?;
+        let fragment = match self.compile(GL_FRAGMENT_SHADER, FRAGMENT_SHADER) {
+            Ok(shader) => shader,
+            Err(e) => {
+                (gl.delete_shader)(vertex);
+                return Err(e);
+            }
+        };
+        self.program = (gl.create_program)();
+        (gl.attach_shader)(self.program, vertex);
+        (gl.attach_shader)(self.program, fragment);
+        (gl.bind_attrib_location)(self.program, POSITION_ATTRIB, b"position\0".as_ptr() as *const c_char);
+        (gl.link_program)(self.program);
+        (gl.delete_shader)(vertex);
+        (gl.delete_shader)(fragment);
+
+        let mut linked = 0;
+        (gl.get_programiv)(self.program, GL_LINK_STATUS, &mut linked);
+        if linked == 0 {
+            let mut log = [0 as c_char; 512];
+            (gl.get_program_info_log)(self.program, log.len() as i32, std::ptr::null_mut(), log.as_mut_ptr());
+            return Err(PlatformError::Graphics(format!(
+                "Palette shader link failed: {}",
+                std::ffi::CStr::from_ptr(log.as_ptr()).to_string_lossy()
+            )));
+        }
+
+        (gl.use_program)(self.program);
+        (gl.uniform_1i)((gl.get_uniform_location)(self.program, b"screen\0".as_ptr() as *const c_char), 0);
+        (gl.uniform_1i)((gl.get_uniform_location)(self.program, b"palette\0".as_ptr() as *const c_char), 1);
+
+        // Client-side vertex array: a GL 2.1 compatibility context allows it
+        (gl.enable_vertex_attrib_array)(POSITION_ATTRIB);
+        (gl.vertex_attrib_pointer)(POSITION_ATTRIB, 2, GL_FLOAT, 0, 0, QUAD.as_ptr() as *const c_void);
+
+        let mut textures = [0u32; 2];
+        (gl.gen_textures)(2, textures.as_mut_ptr());
+        self.screen_texture = textures[0];
+        self.palette_texture = textures[1];
+
+        (gl.active_texture)(GL_TEXTURE0);
+        self.init_texture(self.screen_texture, GL_LUMINANCE, self.width, self.height, GL_LUMINANCE, GL_UNSIGNED_BYTE);
+        (gl.active_texture)(GL_TEXTURE0 + 1);
+        self.init_texture(self.palette_texture, GL_RGBA, 256, 1, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV);
+
+        // Index rows are tightly packed bytes
+        (gl.pixel_storei)(GL_UNPACK_ALIGNMENT, 1);
+        (gl.clear_color)(0.0, 0.0, 0.0, 1.0);
+        Ok(())
+    }
+
+    unsafe fn init_texture(&self, texture: u32, internal: u32, width: i32, height: i32, format: u32, kind: u32) {
+        let gl = &self.gl;
+        (gl.bind_texture)(GL_TEXTURE_2D, texture);
+        (gl.tex_parameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        (gl.tex_parameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        (gl.tex_parameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        (gl.tex_parameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        (gl.tex_image_2d)(GL_TEXTURE_2D, 0, internal as i32, width, height, 0, format, kind, std::ptr::null());
+    }
+
+    unsafe fn compile(&self, kind: u32, source: &str) -> Result<u32, PlatformError> {
+        let gl = &self.gl;
+        let shader = (gl.create_shader)(kind);
+        let source = CString::new(source).unwrap();
+        (gl.shader_source)(shader, 1, &source.as_ptr(), std::ptr::null());
+        (gl.compile_shader)(shader);
+
+        let mut compiled = 0;
+        (gl.get_shaderiv)(shader, GL_COMPILE_STATUS, &mut compiled);
+        if compiled == 0 {
+            let mut log = [0 as c_char; 512];
+            (gl.get_shader_info_log)(shader, log.len() as i32, std::ptr::null_mut(), log.as_mut_ptr());
+            (gl.delete_shader)(shader);
+            return Err(PlatformError::Graphics(format!(
+                "Palette shader compile failed: {}",
+                std::ffi::CStr::from_ptr(log.as_ptr()).to_string_lossy()
+            )));
+        }
+        Ok(shader)
+    }
+
+    pub fn window(&self) -> &Window {
+        &self.window
+    }
+
+    pub fn window_mut(&mut self) -> &mut Window {
+        &mut self.window
+    }
+
+    /// Upload one clipped rectangle of the back buffer (`width` pixels per row)
+    pub fn upload_rect(&mut self, back_buffer: &[u8], r: &ClipRect) {
+        let offset = r.y as usize * self.width as usize + r.x as usize;
+        let gl = &self.gl;
+        unsafe {
+            (gl.active_texture)(GL_TEXTURE0);
+            (gl.bind_texture)(GL_TEXTURE_2D, self.screen_texture);
+            (gl.pixel_storei)(GL_UNPACK_ROW_LENGTH, self.width);
+            (gl.tex_sub_image_2d)(GL_TEXTURE_2D, 0, r.x, r.y, r.width, r.height,
+                                  GL_LUMINANCE, GL_UNSIGNED_BYTE,
+                                  back_buffer[offset..].as_ptr() as *const c_void);
+            (gl.pixel_storei)(GL_UNPACK_ROW_LENGTH, 0);
+        }
+    }
+
+    /// Upload the palette LUT (ARGB8888 entries)
+    pub fn upload_palette(&mut self, lut: &[u32; 256]) {
+        let gl = &self.gl;
+        unsafe {
+            (gl.active_texture)(GL_TEXTURE0 + 1);
+            (gl.bind_texture)(GL_TEXTURE_2D, self.palette_texture);
+            (gl.tex_sub_image_2d)(GL_TEXTURE_2D, 0, 0, 0, 256, 1,
+                                  GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                                  lut.as_ptr() as *const c_void);
+        }
+    }
+
+    /// Draw the screen through the palette, scaled to the whole window
+    pub fn draw(&mut self) {
+        let (width, height) = self.window.drawable_size();
+        let gl = &self.gl;
+        unsafe {
+            (gl.viewport)(0, 0, width as i32, height as i32);
+            (gl.clear)(GL_COLOR_BUFFER_BIT);
+            (gl.active_texture)(GL_TEXTURE0);
+            (gl.bind_texture)(GL_TEXTURE_2D, self.screen_texture);
+            (gl.active_texture)(GL_TEXTURE0 + 1);
+            (gl.bind_texture)(GL_TEXTURE_2D, self.palette_texture);
+            (gl.draw_arrays)(GL_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+
+    /// Show the drawn frame (waits for vsync)
+    pub fn present(&mut self) {
+        self.window.gl_swap_window();
+    }
+}
+
+impl Drop for GlOutput {
+    fn drop(&mut self) {
+        if self.window.gl_make_current(&self.context).is_err() {
+            return;
+        }
+        let textures = [self.screen_texture, self.palette_texture];
+        unsafe {
+            (self.gl.delete_textures)(2, textures.as_ptr());
+            if self.program != 0 {
+                (self.gl.delete_program)(self.program);
+            }
+        }
+    }
+}
@@ -1,7 +1,11 @@
 //! Graphics subsystem using SDL2
 
+pub mod convert;
+pub mod cursor;
 pub mod display;
+pub mod gl_present;
 pub mod palette;
+pub mod png;
 pub mod surface;
 
 pub use palette::{Palette, PaletteEntry};
@@ -27,13 +31,17 @@ pub use display::{
     Platform_GetFullscreenState,
 };
 
+use crate::blit::ClipRect;
 use crate::error::PlatformError;
 use crate::input;
 use sdl2::pixels::{Color, PixelFormatEnum};
 use sdl2::render::{Canvas, TextureCreator};
 use sdl2::video::{Window, WindowContext};
 use sdl2::Sdl;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicU32, Ordering};
 use std::sync::Mutex;
+use std::time::Instant;
 use once_cell::sync::Lazy;
 
 /// Display mode configuration
@@ -55,6 +63,59 @@ impl Default for DisplayMode {
     }
 }
 
+impl DisplayMode {
+    /// Smallest and largest internal resolutions accepted
+    pub const MIN_SIZE: (i32, i32) = (320, 200);
+    pub const MAX_SIZE: (i32, i32) = (3840, 2160);
+
+    /// An 8-bit mode of the given size, if within MIN_SIZE..=MAX_SIZE
+    pub fn with_size(width: i32, height: i32) -> Option<Self> {
+        let (min_w, min_h) = Self::MIN_SIZE;
+        let (max_w, max_h) = Self::MAX_SIZE;
+        if !(min_w..=max_w).contains(&width) || !(min_h..=max_h).contains(&height) {
+            return None;
+        }
+        Some(Self { width, height, ..Self::default() })
+    }
+
+    /// Parse "WIDTHxHEIGHT", as in PLATFORM_RESOLUTION
+    pub fn parse(text: &str) -> Option<Self> {
+        let (w, h) = text.trim().split_once(|c| c == 'x' || c == 'X')?;
+        Self::with_size(w.trim().parse().ok()?, h.trim().parse().ok()?)
+    }
+
+    /// Initial window size: 2x for the classic resolutions, 1x once the
+    /// internal resolution is already large enough for modern monitors
+    pub fn window_size(&self) -> (u32, u32) {
+        let scale = if self.width <= 960 && self.height <= 600 { 2 } else { 1 };
+        ((self.width * scale) as u32, (self.height * scale) as u32)
+    }
+}
+
+/// CPU-side timing of the last flip, in microseconds
+///
+/// SDL_Renderer has no GPU timer queries, so each stage is bracketed with
+/// host timestamps. `present_us` includes the vsync wait and any driver
+/// stall, so a large value points at presentation rather than drawing.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct FlipTiming {
+    /// Palette conversion of the back buffer
+    pub convert_us: u32,
+    /// Streaming texture upload
+    pub upload_us: u32,
+    /// Canvas clear and scaled texture copy
+    pub scale_us: u32,
+    /// SDL_RenderPresent (includes vsync)
+    pub present_us: u32,
+    /// Whole flip
+    pub total_us: u32,
+    /// Flips measured so far
+    pub flip_count: u32,
+    /// Back buffer pixels converted and uploaded by the last flip
+    pub pixels_converted: u32,
+}
+
 /// Wrapper to make SDL context Send+Sync
 /// SAFETY: SDL operations must only be called from the main thread
 struct SendSyncSdl(Sdl);
@@ -73,28 +134,132 @@ unsafe impl Sync for SendSyncGraphics {}
 /// Global graphics state
 static GRAPHICS: Lazy<Mutex<Option<SendSyncGraphics>>> = Lazy::new(|| Mutex::new(None));
 
-pub struct GraphicsState {
+/// Headless graphics: requested by Platform_Graphics_SetHeadless or the
+/// PLATFORM_HEADLESS environment variable, read at init
+static HEADLESS: Lazy<Mutex<Option<HeadlessConfig>>> = Lazy::new(|| Mutex::new(None));
+
+/// Palette lookup on the GPU: requested by Platform_Graphics_SetGpuPalette
+/// or the PLATFORM_GPU_PALETTE environment variable, read at init
+static GPU_PALETTE: Lazy<Mutex<Option<bool>>> = Lazy::new(|| Mutex::new(None));
+
+/// Internal resolution: set by Platform_Graphics_SetResolution or the
+/// PLATFORM_RESOLUTION environment variable ("1920x1080"), read at init
+static RESOLUTION: Lazy<Mutex<Option<DisplayMode>>> = Lazy::new(|| Mutex::new(None));
+
+/// Events poll_events() has handled, window exposes included
+static EVENT_COUNT: AtomicU32 = AtomicU32::new(0);
+
+/// Title of the game window
+const WINDOW_TITLE: &str = "Command & Conquer: Red Alert";
+
+#[derive(Clone, Debug, Default)]
+struct HeadlessConfig {
+    /// Directory to write each flipped frame to as a PNG
+    dump_dir: Option<PathBuf>,
+}
+
+/// The window, renderer and screen texture a flip presents through
+pub struct WindowOutput {
     pub canvas: Canvas<Window>,
     pub texture_creator: TextureCreator<WindowContext>,
     /// Raw pointer to screen texture (lifetime managed manually)
     screen_texture_ptr: *mut sdl2::sys::SDL_Texture,
+}
+
+impl Drop for WindowOutput {
+    fn drop(&mut self) {
+        // Clean up the manually managed texture
+        if !self.screen_texture_ptr.is_null() {
+            unsafe {
+                sdl2::sys::SDL_DestroyTexture(self.screen_texture_ptr);
+            }
+        }
+    }
+}
+
+pub struct GraphicsState {
+    /// None when headless: the back buffer is plain memory, flips convert
+    /// it through the palette and stop there (or dump it as a PNG)
+    pub output: Option<WindowOutput>,
+    /// Set instead of `output` when presenting through the palette shader
+    gl_output: Option<gl_present::GlOutput>,
+    headless_dump: Option<PathBuf>,
     pub display_mode: DisplayMode,
     pub back_buffer: Vec<u8>,
     pub palette: Palette,
     pub argb_buffer: Vec<u32>,
+    pub flip_timing: FlipTiming,
+    /// Palette generation the texture was last fully converted with;
+    /// None until the first full flip (texture contents undefined)
+    texture_generation: Option<u32>,
+    /// Scratch for clipped flip rectangles
+    flip_rects: Vec<ClipRect>,
+    /// Palette conversion, with its worker threads
+    converter: convert::Converter,
 }
 
 impl GraphicsState {
-    pub fn new(sdl: &Sdl, mode: DisplayMode) -> Result<Self, PlatformError> {
+    /// Open the game window; with `gpu_palette`, present through the
+    /// palette shader if OpenGL allows, else through SDL_Renderer
+    pub fn new(sdl: &Sdl, mode: DisplayMode, gpu_palette: bool) -> Result<Self, PlatformError> {
+        let mut state = Self::new_headless(mode, None);
+        if gpu_palette {
+            let video = sdl.video().map_err(|e| PlatformError::Sdl(e.to_string()))?;
+            match gl_present::GlOutput::new(&video, WINDOW_TITLE, mode) {
+                Ok(output) => {
+                    state.gl_output = Some(output);
+                    Self::set_vsync_pacing(sdl);
+                    return Ok(state);
+                }
+                Err(e) => eprintln!("[WARN] GPU palette unavailable, converting on the CPU: {}", e),
+            }
+        }
+        state.output = Some(Self::open_window(sdl, mode)?);
+        Self::set_vsync_pacing(sdl);
+        Ok(state)
+    }
+
+    /// Both outputs present with vsync: tell the frame pacer the refresh
+    /// rate it waits for
+    fn set_vsync_pacing(sdl: &Sdl) {
+        let refresh = sdl
+            .video()
+            .ok()
+            .and_then(|video| video.current_display_mode(0).ok())
+            .map(|display| display.refresh_rate.max(0) as u32)
+            .unwrap_or(0);
+        crate::timer::with_frame_controller(|fc| fc.set_vsync_refresh(refresh));
+    }
+
+    /// Graphics without a window or SDL video: nothing to present to
+    pub fn new_headless(mode: DisplayMode, dump_dir: Option<PathBuf>) -> Self {
+        let buffer_size = (mode.width * mode.height) as usize;
+
+        // Nothing waits for vsync until a window opens
+        crate::timer::with_frame_controller(|fc| fc.set_vsync_refresh(0));
+
+        Self {
+            output: None,
+            gl_output: None,
+            headless_dump: dump_dir,
+            display_mode: mode,
+            back_buffer: vec![0; buffer_size],
+            palette: Palette::new(),
+            argb_buffer: vec![0; buffer_size],
+            flip_timing: FlipTiming::default(),
+            texture_generation: None,
+            flip_rects: Vec::new(),
+            converter: convert::Converter::new(),
+        }
+    }
+
+    fn open_window(sdl: &Sdl, mode: DisplayMode) -> Result<WindowOutput, PlatformError> {
         let video = sdl.video().map_err(|e| PlatformError::Sdl(e.to_string()))?;
 
-        // Create window at 2x scale for better visibility on modern displays
+        // Classic resolutions open at 2x for better visibility on modern displays
+        let (window_w, window_h) = mode.window_size();
         let window = video
-            .window(
-                "Command & Conquer: Red Alert",
-                (mode.width * 2) as u32,
-                (mode.height * 2) as u32,
-            )
+            .window(WINDOW_TITLE, window_w, window_h)
             .position_centered()
             .resizable()
             .build()
@@ -122,19 +287,37 @@ impl GraphicsState {
         let screen_texture_ptr = screen_texture.raw();
         std::mem::forget(screen_texture);
 
-        let buffer_size = (mode.width * mode.height) as usize;
-
-        Ok(Self {
+        Ok(WindowOutput {
             canvas,
             texture_creator,
             screen_texture_ptr,
-            display_mode: mode,
-            back_buffer: vec![0; buffer_size],
-            palette: Palette::new(),
-            argb_buffer: vec![0; buffer_size],
         })
     }
 
+    pub fn is_headless(&self) -> bool {
+        self.output.is_none() && self.gl_output.is_none()
+    }
+
+    /// Whether flips present through the palette shader
+    pub fn is_gpu_palette(&self) -> bool {
+        self.gl_output.is_some()
+    }
+
+    /// The game window; None when headless
+    pub fn window(&self) -> Option<&Window> {
+        match &self.gl_output {
+            Some(gl) => Some(gl.window()),
+            None => self.output.as_ref().map(|o| o.canvas.window()),
+        }
+    }
+
+    pub fn window_mut(&mut self) -> Option<&mut Window> {
+        match &mut self.gl_output {
+            Some(gl) => Some(gl.window_mut()),
+            None => self.output.as_mut().map(|o| o.canvas.window_mut()),
+        }
+    }
+
     /// Get pointer to back buffer for direct pixel access
     pub fn get_back_buffer(&mut self) -> (*mut u8, i32, i32, i32) {
         let ptr = self.back_buffer.as_mut_ptr();
@@ -159,13 +342,14 @@ impl GraphicsState {
     pub fn update_texture(&mut self, argb_data: &[u32]) -> Result<(), PlatformError> {
         let width = self.display_mode.width as usize;
         let height = self.display_mode.height as usize;
+        let Some(output) = &self.output else { return Ok(()) };
 
         unsafe {
             let mut pixels_ptr: *mut std::ffi::c_void = std::ptr::null_mut();
             let mut texture_pitch: i32 = 0;
 
             let ret = sdl2::sys::SDL_LockTexture(
-                self.screen_texture_ptr,
+                output.screen_texture_ptr,
                 std::ptr::null(),
                 &mut pixels_ptr,
                 &mut texture_pitch,
@@ -199,7 +383,7 @@ impl GraphicsState {
                 }
             }
 
-            sdl2::sys::SDL_UnlockTexture(self.screen_texture_ptr);
+            sdl2::sys::SDL_UnlockTexture(output.screen_texture_ptr);
         }
 
         Ok(())
@@ -207,13 +391,23 @@ impl GraphicsState {
 
     /// Render texture to screen
     pub fn present_texture(&mut self) -> Result<(), PlatformError> {
-        self.canvas.clear();
+        self.copy_texture_to_canvas()?;
+        if let Some(output) = &mut self.output {
+            output.canvas.present();
+        }
+        Ok(())
+    }
+
+    /// Clear the canvas and draw the screen texture scaled to the window
+    fn copy_texture_to_canvas(&mut self) -> Result<(), PlatformError> {
+        let Some(output) = &mut self.output else { return Ok(()) };
+        output.canvas.clear();
 
         unsafe {
-            let renderer = self.canvas.raw();
+            let renderer = output.canvas.raw();
             let ret = sdl2::sys::SDL_RenderCopy(
                 renderer,
-                self.screen_texture_ptr,
+                output.screen_texture_ptr,
                 std::ptr::null(),
                 std::ptr::null(),
             );
@@ -226,36 +420,308 @@ impl GraphicsState {
             }
         }
 
-        self.canvas.present();
         Ok(())
     }
 
     /// Clear screen with a color (for testing)
     pub fn clear(&mut self, r: u8, g: u8, b: u8) {
-        self.canvas.set_draw_color(Color::RGB(r, g, b));
-        self.canvas.clear();
+        if let Some(output) = &mut self.output {
+            output.canvas.set_draw_color(Color::RGB(r, g, b));
+            output.canvas.clear();
+        }
     }
 
     /// Present the canvas
     pub fn present(&mut self) {
-        self.canvas.present();
+        if let Some(output) = &mut self.output {
+            output.canvas.present();
+        }
+        if let Some(gl) = &mut self.gl_output {
+            gl.present();
+        }
     }
 
     /// Complete flip operation:
-    /// 1. Convert 8-bit back buffer to 32-bit ARGB using palette
-    /// 2. Upload to streaming texture
+    /// 1. Convert 8-bit back buffer to 32-bit ARGB using palette, straight
+    ///    into the locked streaming texture
+    /// 2. Unlock (upload) the texture
     /// 3. Render texture to canvas
     /// 4. Present (with VSync)
+    ///
+    /// Each step is timed into `flip_timing`. Headless, only step 1 runs,
+    /// into `argb_buffer`. With the palette shader there is no step 1.
     pub fn flip(&mut self) -> Result<(), PlatformError> {
-        // Step 1: Convert back buffer using palette LUT
+        if self.is_gpu_palette() {
+            return self.flip_gl(None);
+        }
+
+        let start = Instant::now();
         self.palette.ensure_lut();
-        self.palette.convert_buffer(&self.back_buffer, &mut self.argb_buffer);
+        let pixels = self.back_buffer.len() as u32;
+
+        if self.is_headless() {
+            let all = ClipRect::from_dimensions(self.display_mode.width, self.display_mode.height);
+            self.convert_rect_to_argb(&all);
+            let converted = Instant::now();
+            self.texture_generation = Some(self.palette.generation());
+            self.palette.take_changed();
+            return self.finish_headless_flip(start, converted, pixels);
+        }
+
+        // Step 1: Convert back buffer using palette LUT into the texture
+        let (texture, pitch) = self.lock_texture()?;
+        unsafe {
+            self.converter.convert(self.back_buffer.as_ptr(), self.display_mode.width as usize,
+                                   texture, pitch,
+                                   self.display_mode.width as usize, self.display_mode.height as usize,
+                                   self.palette.get_lut());
+        }
+        let converted = Instant::now();
+
+        // Step 2: Upload
+        self.unlock_texture();
+        self.texture_generation = Some(self.palette.generation());
+        self.palette.take_changed();
+        let uploaded = Instant::now();
+
+        // Step 3: Render texture to canvas (scaled to the window)
+        self.copy_texture_to_canvas()?;
+        let scaled = Instant::now();
+
+        // Step 4: Present
+        self.present();
+        let presented = Instant::now();
+
+        let us = |from: Instant, to: Instant| to.duration_since(from).as_micros() as u32;
+        self.flip_timing = FlipTiming {
+            convert_us: us(start, converted),
+            upload_us: us(converted, uploaded),
+            scale_us: us(uploaded, scaled),
+            present_us: us(scaled, presented),
+            total_us: us(start, presented),
+            flip_count: self.flip_timing.flip_count.wrapping_add(1),
+            pixels_converted: pixels,
+        };
+        Ok(())
+    }
+
+    /// Lock the whole screen texture for writing: its pixels and pitch
+    fn lock_texture(&mut self) -> Result<(*mut u8, usize), PlatformError> {
+        let Some(output) = &self.output else {
+            return Err(PlatformError::Graphics("No screen texture".into()));
+        };
+
+        let mut pixels: *mut std::ffi::c_void = std::ptr::null_mut();
+        let mut pitch: i32 = 0;
+        let ret = unsafe {
+            sdl2::sys::SDL_LockTexture(output.screen_texture_ptr, std::ptr::null(), &mut pixels, &mut pitch)
+        };
+        if ret != 0 {
+            return Err(PlatformError::Graphics(unsafe {
+                std::ffi::CStr::from_ptr(sdl2::sys::SDL_GetError())
+                    .to_string_lossy()
+                    .into_owned()
+            }));
+        }
+        Ok((pixels as *mut u8, pitch as usize))
+    }
+
+    fn unlock_texture(&mut self) {
+        if let Some(output) = &self.output {
+            unsafe { sdl2::sys::SDL_UnlockTexture(output.screen_texture_ptr) };
+        }
+    }
+
+    /// Convert one clipped rectangle of the back buffer into the same
+    /// rectangle of `argb_buffer`
+    fn convert_rect_to_argb(&mut self, r: &ClipRect) {
+        let stride = self.display_mode.width as usize;
+        let offset = r.y as usize * stride + r.x as usize;
+        unsafe {
+            self.converter.convert(self.back_buffer.as_ptr().add(offset), stride,
+                                   self.argb_buffer.as_mut_ptr().add(offset) as *mut u8, stride * 4,
+                                   r.width as usize, r.height as usize,
+                                   self.palette.get_lut());
+        }
+    }
+
+    /// Flip only the given back buffer rectangles
+    ///
+    /// Converts and uploads just those regions with partial texture
+    /// updates; the rest of the texture keeps last frame's pixels. An
+    /// empty list re-presents the previous frame. Falls back to a full
+    /// flip when the texture has never been filled.
+    ///
+    /// When the palette changed since the last flip, only rows that show
+    /// a changed index are reconverted as well. A color cycle on water
+    /// that is off screen costs a scan of the back buffer and no upload.
+    pub fn flip_rects(&mut self, rects: &[ClipRect]) -> Result<(), PlatformError> {
+        if self.is_gpu_palette() {
+            return self.flip_gl(Some(rects));
+        }
 
-        // Step 2: Update texture with converted pixels
-        self.update_texture(&self.argb_buffer.clone())?;
+        self.palette.ensure_lut();
+        if self.texture_generation.is_none() {
+            return self.flip();
+        }
+
+        let start = Instant::now();
+        let width = self.display_mode.width;
+        let height = self.display_mode.height;
+        let bounds = ClipRect::from_dimensions(width, height);
+
+        // Step 1: Convert only the dirty regions, plus any rows that
+        // show palette indices whose color changed
+        let mut clipped = std::mem::take(&mut self.flip_rects);
+        clipped.clear();
+        if self.texture_generation != Some(self.palette.generation()) {
+            let changed = self.palette.take_changed();
+            collect_changed_rows(&self.back_buffer, width as usize, &changed, &mut clipped);
+            self.texture_generation = Some(self.palette.generation());
+        }
+        clipped.extend(rects.iter().filter_map(|r| r.intersect(&bounds)));
+
+        let mut pixels: u32 = 0;
+        for r in &clipped {
+            self.convert_rect_to_argb(r);
+            pixels += (r.width * r.height) as u32;
+        }
+        let converted = Instant::now();
+
+        if self.is_headless() {
+            self.flip_rects = clipped;
+            return self.finish_headless_flip(start, converted, pixels);
+        }
+
+        // Step 2: Partial texture updates
+        let mut result = Ok(());
+        for r in &clipped {
+            result = self.update_texture_rect(r);
+            if result.is_err() {
+                break;
+            }
+        }
+        self.flip_rects = clipped;
+        result?;
+        let uploaded = Instant::now();
+
+        // Step 3/4: The whole texture is still scaled and presented
+        self.copy_texture_to_canvas()?;
+        let scaled = Instant::now();
+        self.present();
+        let presented = Instant::now();
+
+        let us = |from: Instant, to: Instant| to.duration_since(from).as_micros() as u32;
+        self.flip_timing = FlipTiming {
+            convert_us: us(start, converted),
+            upload_us: us(converted, uploaded),
+            scale_us: us(uploaded, scaled),
+            present_us: us(scaled, presented),
+            total_us: us(start, presented),
+            flip_count: self.flip_timing.flip_count.wrapping_add(1),
+            pixels_converted: pixels,
+        };
+        Ok(())
+    }
+
+    /// Flip through the palette shader: upload the palette if it changed,
+    /// then the given back buffer rectangles (all of it for None, or on
+    /// the first flip), then draw
+    ///
+    /// Pixels whose palette color changed need no upload at all: the
+    /// shader picks up the new palette.
+    fn flip_gl(&mut self, rects: Option<&[ClipRect]>) -> Result<(), PlatformError> {
+        let start = Instant::now();
+        self.palette.ensure_lut();
+        let Some(gl) = &mut self.gl_output else { return Ok(()) };
+        let bounds = ClipRect::from_dimensions(self.display_mode.width, self.display_mode.height);
+
+        let full = rects.is_none() || self.texture_generation.is_none();
+        if self.texture_generation != Some(self.palette.generation()) {
+            gl.upload_palette(self.palette.get_lut());
+            self.palette.take_changed();
+            self.texture_generation = Some(self.palette.generation());
+        }
+
+        let mut pixels: u32 = 0;
+        if full {
+            gl.upload_rect(&self.back_buffer, &bounds);
+            pixels = (bounds.width * bounds.height) as u32;
+        } else {
+            for r in rects.unwrap_or(&[]).iter().filter_map(|r| r.intersect(&bounds)) {
+                gl.upload_rect(&self.back_buffer, &r);
+                pixels += (r.width * r.height) as u32;
+            }
+        }
+        let uploaded = Instant::now();
+
+        gl.draw();
+        let scaled = Instant::now();
+        gl.present();
+        let presented = Instant::now();
+
+        let us = |from: Instant, to: Instant| to.duration_since(from).as_micros() as u32;
+        self.flip_timing = FlipTiming {
+            convert_us: 0,
+            upload_us: us(start, uploaded),
+            scale_us: us(uploaded, scaled),
+            present_us: us(scaled, presented),
+            total_us: us(start, presented),
+            flip_count: self.flip_timing.flip_count.wrapping_add(1),
+            pixels_converted: pixels,
+        };
+        Ok(())
+    }
 
-        // Step 3 & 4: Render texture to canvas and present
-        self.present_texture()
+    /// A headless flip ends after the conversion: write the frame out if
+    /// dumping, and time it like a flip whose upload, scale and present
+    /// took no time
+    fn finish_headless_flip(&mut self, start: Instant, converted: Instant, pixels: u32) -> Result<(), PlatformError> {
+        let flip_count = self.flip_timing.flip_count.wrapping_add(1);
+        if let Some(dir) = &self.headless_dump {
+            let path = dir.join(format!("frame_{:06}.png", flip_count));
+            png::write_indexed(&path, self.display_mode.width as usize, self.display_mode.height as usize,
+                               &self.back_buffer, self.palette.get_lut())
+                .map_err(|e| PlatformError::Io(format!("{}: {}", path.display(), e)))?;
+        }
+
+        let total_us = Instant::now().duration_since(start).as_micros() as u32;
+        self.flip_timing = FlipTiming {
+            convert_us: converted.duration_since(start).as_micros() as u32,
+            upload_us: 0,
+            scale_us: 0,
+            present_us: 0,
+            total_us,
+            flip_count,
+            pixels_converted: pixels,
+        };
+        Ok(())
+    }
+
+    /// Upload one already-converted rectangle of `argb_buffer`
+    fn update_texture_rect(&mut self, r: &ClipRect) -> Result<(), PlatformError> {
+        let Some(output) = &self.output else { return Ok(()) };
+        let stride = self.display_mode.width as usize;
+        let offset = r.y as usize * stride + r.x as usize;
+        let rect = sdl2::sys::SDL_Rect { x: r.x, y: r.y, w: r.width, h: r.height };
+
+        // argb_buffer holds native-endian ARGB8888, the texture's format
+        let ret = unsafe {
+            sdl2::sys::SDL_UpdateTexture(
+                output.screen_texture_ptr,
+                &rect,
+                self.argb_buffer[offset..].as_ptr() as *const std::ffi::c_void,
+                (stride * 4) as i32,
+            )
+        };
+        if ret != 0 {
+            return Err(PlatformError::Graphics(unsafe {
+                std::ffi::CStr::from_ptr(sdl2::sys::SDL_GetError())
+                    .to_string_lossy()
+                    .into_owned()
+            }));
+        }
+        Ok(())
     }
 
     /// Draw directly to back buffer - vertical color bars for testing
@@ -288,7 +754,8 @@ impl GraphicsState {
     /// Scale mouse coordinates from window space to game space
     /// Window may be scaled (default 2x) or resized
     pub fn scale_mouse_coords(&self, window_x: i32, window_y: i32) -> (i32, i32) {
-        let (window_w, window_h) = self.canvas.window().size();
+        let Some(window) = self.window() else { return (window_x, window_y) };
+        let (window_w, window_h) = window.size();
         let game_w = self.display_mode.width as u32;
         let game_h = self.display_mode.height as u32;
 
@@ -300,17 +767,6 @@ impl GraphicsState {
     }
 }
 
-impl Drop for GraphicsState {
-    fn drop(&mut self) {
-        // Clean up the manually managed texture
-        if !self.screen_texture_ptr.is_null() {
-            unsafe {
-                sdl2::sys::SDL_DestroyTexture(self.screen_texture_ptr);
-            }
-        }
-    }
-}
-
 /// Initialize SDL context
 pub fn init_sdl() -> Result<(), PlatformError> {
     let sdl = sdl2::init().map_err(|e| PlatformError::Sdl(e))?;
@@ -330,22 +786,117 @@ where
     SDL_CONTEXT.lock().ok().and_then(|guard| guard.as_ref().map(|s| f(&s.0)))
 }
 
+/// Ask for (or stop asking for) headless graphics at the next init()
+///
+/// `dump_dir`, if given, receives every flipped frame as frame_NNNNNN.png.
+pub fn set_headless(headless: bool, dump_dir: Option<PathBuf>) {
+    if let Ok(mut guard) = HEADLESS.lock() {
+        *guard = if headless { Some(HeadlessConfig { dump_dir }) } else { None };
+    }
+}
+
+/// Headless settings for init(): set_headless(), else PLATFORM_HEADLESS
+/// set to anything but "0" (PLATFORM_HEADLESS_DUMP names a dump directory)
+fn headless_config() -> Option<HeadlessConfig> {
+    if let Some(config) = HEADLESS.lock().ok().and_then(|guard| guard.clone()) {
+        return Some(config);
+    }
+    match std::env::var("PLATFORM_HEADLESS") {
+        Ok(value) if !value.is_empty() && value != "0" => Some(HeadlessConfig {
+            dump_dir: std::env::var_os("PLATFORM_HEADLESS_DUMP").map(PathBuf::from),
+        }),
+        _ => None,
+    }
+}
+
+/// Ask for (or against) palette lookup on the GPU at the next init()
+///
+/// The window then presents through an OpenGL palette shader; if OpenGL
+/// can't provide it, flips fall back to converting on the CPU.
+pub fn set_gpu_palette(enabled: bool) {
+    if let Ok(mut guard) = GPU_PALETTE.lock() {
+        *guard = Some(enabled);
+    }
+}
+
+/// GPU palette setting for init(): set_gpu_palette(), else
+/// PLATFORM_GPU_PALETTE set to anything but "0"
+fn gpu_palette_requested() -> bool {
+    if let Some(enabled) = GPU_PALETTE.lock().ok().and_then(|guard| *guard) {
+        return enabled;
+    }
+    matches!(std::env::var("PLATFORM_GPU_PALETTE"), Ok(value) if !value.is_empty() && value != "0")
+}
+
+/// Set the internal resolution used from the next init()
+///
+/// Returns false (and changes nothing) if the size is outside
+/// DisplayMode::MIN_SIZE..=MAX_SIZE.
+pub fn set_resolution(width: i32, height: i32) -> bool {
+    let Some(mode) = DisplayMode::with_size(width, height) else {
+        return false;
+    };
+    if let Ok(mut guard) = RESOLUTION.lock() {
+        *guard = Some(mode);
+    }
+    true
+}
+
+/// Mode for init(): set_resolution(), else PLATFORM_RESOLUTION, else 640x400
+fn requested_mode() -> DisplayMode {
+    if let Some(mode) = RESOLUTION.lock().ok().and_then(|guard| *guard) {
+        return mode;
+    }
+    match std::env::var("PLATFORM_RESOLUTION") {
+        Ok(value) => DisplayMode::parse(&value).unwrap_or_else(|| {
+            eprintln!("[WARN] Ignoring PLATFORM_RESOLUTION={}", value);
+            DisplayMode::default()
+        }),
+        Err(_) => DisplayMode::default(),
+    }
+}
+
 /// Initialize graphics subsystem
 pub fn init() -> Result<(), PlatformError> {
-    let mode = DisplayMode::default();
+    let mode = requested_mode();
 
-    let state = with_sdl(|sdl| GraphicsState::new(sdl, mode))
-        .ok_or(PlatformError::NotInitialized)??;
+    let state = match headless_config() {
+        Some(config) => {
+            if let Some(dir) = &config.dump_dir {
+                std::fs::create_dir_all(dir)
+                    .map_err(|e| PlatformError::Io(format!("{}: {}", dir.display(), e)))?;
+            }
+            GraphicsState::new_headless(mode, config.dump_dir)
+        }
+        None => {
+            let gpu_palette = gpu_palette_requested();
+            with_sdl(|sdl| GraphicsState::new(sdl, mode, gpu_palette))
+                .ok_or(PlatformError::NotInitialized)??
+        }
+    };
+    let headless = state.is_headless();
+    let gpu_palette = state.is_gpu_palette();
 
     if let Ok(mut guard) = GRAPHICS.lock() {
         *guard = Some(SendSyncGraphics(state));
     }
 
-    eprintln!("[INFO] Graphics initialized: {}x{}x{}",
-              mode.width, mode.height, mode.bits_per_pixel);
+    eprintln!("[INFO] Graphics initialized: {}x{}x{}{}",
+              mode.width, mode.height, mode.bits_per_pixel,
+              if headless { " (headless)" } else if gpu_palette { " (GPU palette)" } else { "" });
     Ok(())
 }
 
+/// Check if graphics is running without a window
+pub fn is_headless() -> bool {
+    with_graphics(|state| state.is_headless()).unwrap_or(false)
+}
+
+/// Check if flips present through the palette shader
+pub fn is_gpu_palette() -> bool {
+    with_graphics(|state| state.is_gpu_palette()).unwrap_or(false)
+}
+
 /// Shutdown graphics subsystem
 pub fn shutdown() {
     if let Ok(mut guard) = GRAPHICS.lock() {
@@ -384,6 +935,7 @@ pub fn poll_events() -> bool {
         };
 
         for event in event_pump.poll_iter() {
+            EVENT_COUNT.fetch_add(1, Ordering::Relaxed);
             match event {
                 sdl2::event::Event::Quit { .. } => {
                     input::request_quit();
@@ -417,13 +969,51 @@ pub fn poll_events() -> bool {
                 sdl2::event::Event::MouseWheel { y, .. } => {
                     input::with_input(|state| state.handle_mouse_wheel(y));
                 }
-                _ => {}
+                sdl2::event::Event::Window { win_event, .. } => {
+                    handle_window_event(win_event);
+                }
+                other => {
+                    crate::app::handle_app_event(&other);
+                }
             }
         }
         input::should_quit()
     }).unwrap_or(false)
 }
 
+/// A window nobody can see or type into counts as in the background
+fn handle_window_event(win_event: sdl2::event::WindowEvent) {
+    use crate::app::{get_app_state, set_app_state, AppState};
+    use sdl2::event::WindowEvent;
+
+    match (win_event, get_app_state()) {
+        (WindowEvent::Minimized | WindowEvent::Hidden | WindowEvent::FocusLost, AppState::Active) => {
+            set_app_state(AppState::Background);
+        }
+        (WindowEvent::Restored | WindowEvent::Shown | WindowEvent::FocusGained, AppState::Background) => {
+            set_app_state(AppState::Active);
+        }
+        _ => {}
+    }
+}
+
+/// Events poll_events() has handled so far
+pub fn event_count() -> u32 {
+    EVENT_COUNT.load(Ordering::Relaxed)
+}
+
+/// Sleep until an event is queued or the timeout passes, leaving the
+/// event for poll_events(); true if one is queued
+pub fn wait_events(timeout_ms: u32) -> bool {
+    if with_sdl(|_| ()).is_none() {
+        delay(timeout_ms);
+        return false;
+    }
+    // The context lock is not held while waiting; other threads read ticks
+    let timeout = timeout_ms.min(i32::MAX as u32) as i32;
+    unsafe { sdl2::sys::SDL_WaitEventTimeout(std::ptr::null_mut(), timeout) == 1 }
+}
+
 /// Get current tick count in milliseconds
 pub fn get_ticks() -> u32 {
     with_sdl(|sdl| {
@@ -435,3 +1025,51 @@ pub fn get_ticks() -> u32 {
 pub fn delay(ms: u32) {
     std::thread::sleep(std::time::Duration::from_millis(ms as u64));
 }
+
+/// Append full-width bands covering every back buffer row that contains
+/// an index set in `changed` (bit i & 63 of word i >> 6)
+fn collect_changed_rows(back: &[u8], width: usize, changed: &[u64; 4], out: &mut Vec<ClipRect>) {
+    if width == 0 || changed.iter().all(|&w| w == 0) {
+        return;
+    }
+
+    let mut band_start: Option<usize> = None;
+    let rows = back.len() / width;
+    for y in 0..=rows {
+        let hit = y < rows && back[y * width..(y + 1) * width]
+            .iter()
+            .any(|&p| (changed[(p >> 6) as usize] >> (p & 63)) & 1 != 0);
+
+        match (hit, band_start) {
+            (true, None) => band_start = Some(y),
+            (false, Some(y0)) => {
+                out.push(ClipRect::new(0, y0 as i32, width as i32, (y - y0) as i32));
+                band_start = None;
+            }
+            _ => {}
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_display_mode_parse() {
+        let mode = DisplayMode::parse("1920x1080").unwrap();
+        assert_eq!((mode.width, mode.height, mode.bits_per_pixel), (1920, 1080, 8));
+        let mode = DisplayMode::parse(" 1280 X 800 ").unwrap();
+        assert_eq!((mode.width, mode.height), (1280, 800));
+
+        assert!(DisplayMode::parse("1920").is_none());
+        assert!(DisplayMode::parse("100x100").is_none());
+        assert!(DisplayMode::parse("8000x4000").is_none());
+    }
+
+    #[test]
+    fn test_display_mode_window_size() {
+        assert_eq!(DisplayMode::default().window_size(), (1280, 800));
+        assert_eq!(DisplayMode::with_size(1920, 1080).unwrap().window_size(), (1920, 1080));
+    }
+}
@@ -28,6 +28,10 @@ pub struct Palette {
     argb_lut: [u32; 256],
     /// Flag indicating LUT needs rebuild
     dirty: bool,
+    /// Bumped whenever the LUT changes (rebuild or fade)
+    generation: u32,
+    /// Indices whose LUT color changed since the last `take_changed()`
+    changed: [u64; 4],
 }
 
 impl Default for Palette {
@@ -43,6 +47,8 @@ impl Palette {
             entries: [PaletteEntry::default(); 256],
             argb_lut: [0; 256],
             dirty: true,
+            generation: 0,
+            changed: [0; 4],
         };
 
         // Initialize with grayscale palette
@@ -81,10 +87,36 @@ impl Palette {
 
     /// Rebuild the ARGB lookup table
     pub fn rebuild_lut(&mut self) {
+        let mut any = false;
         for i in 0..256 {
-            self.argb_lut[i] = self.entries[i].to_argb();
+            any |= self.store_lut(i, self.entries[i].to_argb());
         }
         self.dirty = false;
+        if any {
+            self.generation = self.generation.wrapping_add(1);
+        }
+    }
+
+    /// Write one LUT entry, marking it changed if the color differs
+    fn store_lut(&mut self, index: usize, argb: u32) -> bool {
+        if self.argb_lut[index] == argb {
+            return false;
+        }
+        self.argb_lut[index] = argb;
+        self.changed[index >> 6] |= 1u64 << (index & 63);
+        true
+    }
+
+    /// Take the mask of indices changed since the last call
+    ///
+    /// Bit (i & 63) of word (i >> 6) is set for index i.
+    pub fn take_changed(&mut self) -> [u64; 4] {
+        std::mem::take(&mut self.changed)
+    }
+
+    /// LUT generation; changes whenever converted colors would change
+    pub fn generation(&self) -> u32 {
+        self.generation
     }
 
     /// Ensure LUT is up to date
@@ -111,16 +143,39 @@ impl Palette {
         }
     }
 
+    /// Convert one rectangle of an 8-bit buffer into the matching
+    /// rectangle of a 32-bit buffer (both `stride` pixels wide)
+    ///
+    /// The rectangle must already be clipped to the buffers.
+    pub fn convert_rect(&mut self, src: &[u8], dst: &mut [u32], stride: usize,
+                        x: usize, y: usize, width: usize, height: usize) {
+        self.ensure_lut();
+        let lut = &self.argb_lut;
+
+        for row in y..y + height {
+            let start = row * stride + x;
+            let src_row = &src[start..start + width];
+            let dst_row = &mut dst[start..start + width];
+            for (d, &index) in dst_row.iter_mut().zip(src_row) {
+                *d = lut[index as usize];
+            }
+        }
+    }
+
     /// Fade palette towards black (factor 0.0 = black, 1.0 = full color)
     pub fn fade(&mut self, factor: f32) {
         let factor = factor.clamp(0.0, 1.0);
+        let mut any = false;
         for i in 0..256 {
-            let entry = &self.entries[i];
-            self.argb_lut[i] = PaletteEntry::new(
+            let entry = self.entries[i];
+            any |= self.store_lut(i, PaletteEntry::new(
                 (entry.r as f32 * factor) as u8,
                 (entry.g as f32 * factor) as u8,
                 (entry.b as f32 * factor) as u8,
-            ).to_argb();
+            ).to_argb());
+        }
+        if any {
+            self.generation = self.generation.wrapping_add(1);
         }
     }
 
@@ -175,4 +230,54 @@ mod tests {
         palette.restore();
         assert_eq!(palette.get_lut()[100], 0xFF_C8_64_32);
     }
+
+    #[test]
+    fn test_palette_convert_rect() {
+        let mut palette = Palette::new();
+        palette.set(7, PaletteEntry::new(0, 255, 0));
+
+        // 4x3 buffer, convert the 2x2 rect at (1, 1)
+        let src = [7u8; 12];
+        let mut dst = [0u32; 12];
+        palette.convert_rect(&src, &mut dst, 4, 1, 1, 2, 2);
+
+        assert_eq!(dst[0], 0);
+        assert_eq!(dst[5], 0xFF_00_FF_00);
+        assert_eq!(dst[10], 0xFF_00_FF_00);
+        assert_eq!(dst[7], 0);
+    }
+
+    #[test]
+    fn test_palette_generation() {
+        let mut palette = Palette::new();
+        let start = palette.generation();
+
+        palette.set(1, PaletteEntry::new(1, 2, 3));
+        assert_eq!(palette.generation(), start);
+        palette.ensure_lut();
+        assert_ne!(palette.generation(), start);
+
+        let rebuilt = palette.generation();
+        palette.fade(0.5);
+        assert_ne!(palette.generation(), rebuilt);
+
+        // Re-sending identical colors does not invalidate converted pixels
+        palette.restore();
+        let restored = palette.generation();
+        palette.set_range(0, &[PaletteEntry::new(0, 0, 0)]);
+        palette.ensure_lut();
+        assert_eq!(palette.generation(), restored);
+    }
+
+    #[test]
+    fn test_palette_changed_mask() {
+        let mut palette = Palette::new();
+        palette.take_changed();
+
+        palette.set_range(70, &[PaletteEntry::new(9, 9, 9), PaletteEntry::new(1, 2, 3)]);
+        palette.ensure_lut();
+        let changed = palette.take_changed();
+        assert_eq!(changed, [0, (1u64 << 6) | (1u64 << 7), 0, 0]);
+        assert_eq!(palette.take_changed(), [0; 4]);
+    }
 }
@@ -0,0 +1,122 @@
+//! Minimal PNG writer for headless frame dumps
+//!
+//! Writes the 8-bit back buffer as an indexed PNG with the current
+//! palette. The image data goes into stored (uncompressed) deflate blocks:
+//! dumps are for looking at, not for keeping, and this needs no codec.
+
+use crate::util::crc::{crc32_finalize, crc32_update, CRC_INIT};
+use std::fs::File;
+use std::io::{self, BufWriter, Write};
+use std::path::Path;
+
+/// Largest stored deflate block
+const STORED_BLOCK_MAX: usize = 65535;
+
+fn write_chunk<W: Write>(out: &mut W, kind: &[u8; 4], data: &[u8]) -> io::Result<()> {
+    out.write_all(&(data.len() as u32).to_be_bytes())?;
+    out.write_all(kind)?;
+    out.write_all(data)?;
+    let crc = crc32_finalize(crc32_update(crc32_update(CRC_INIT, kind), data));
+    out.write_all(&crc.to_be_bytes())
+}
+
+/// Encode `pixels` (one byte per pixel, `width` per row) as an indexed PNG
+/// whose palette is `lut` (ARGB8888, alpha ignored)
+pub fn encode_indexed(width: usize, height: usize, pixels: &[u8], lut: &[u32; 256]) -> Vec<u8> {
+    let mut out = Vec::with_capacity(pixels.len() + pixels.len() / 64 + 1024);
+    out.extend_from_slice(b"\x89PNG\r\n\x1a\n");
+
+    let mut header = Vec::with_capacity(13);
+    header.extend_from_slice(&(width as u32).to_be_bytes());
+    header.extend_from_slice(&(height as u32).to_be_bytes());
+    header.extend_from_slice(&[8, 3, 0, 0, 0]); // 8-bit, indexed, no interlace
+    let _ = write_chunk(&mut out, b"IHDR", &header);
+
+    let mut palette = Vec::with_capacity(768);
+    for &argb in lut.iter() {
+        palette.extend_from_slice(&[(argb >> 16) as u8, (argb >> 8) as u8, argb as u8]);
+    }
+    let _ = write_chunk(&mut out, b"PLTE", &palette);
+
+    // Scanlines, each behind a filter byte of 0 (none)
+    let mut raw = Vec::with_capacity((width + 1) * height);
+    for row in pixels.chunks(width).take(height) {
+        raw.push(0);
+        raw.extend_from_slice(row);
+    }
+
+    // zlib stream of stored blocks
+    let mut zlib = Vec::with_capacity(raw.len() + raw.len() / STORED_BLOCK_MAX * 5 + 16);
+    zlib.extend_from_slice(&[0x78, 0x01]);
+    let mut blocks = raw.chunks(STORED_BLOCK_MAX).peekable();
+    if blocks.peek().is_none() {
+        zlib.extend_from_slice(&[1, 0, 0, 0xFF, 0xFF]);
+    }
+    while let Some(block) = blocks.next() {
+        let last = blocks.peek().is_none();
+        let len = block.len() as u16;
+        zlib.push(last as u8);
+        zlib.extend_from_slice(&len.to_le_bytes());
+        zlib.extend_from_slice(&(!len).to_le_bytes());
+        zlib.extend_from_slice(block);
+    }
+    let (mut a, mut b) = (1u32, 0u32);
+    for chunk in raw.chunks(5552) {
+        for &byte in chunk {
+            a += byte as u32;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    zlib.extend_from_slice(&((b << 16) | a).to_be_bytes());
+    let _ = write_chunk(&mut out, b"IDAT", &zlib);
+
+    let _ = write_chunk(&mut out, b"IEND", &[]);
+    out
+}
+
+/// Write an indexed PNG to `path`
+pub fn write_indexed(path: &Path, width: usize, height: usize, pixels: &[u8], lut: &[u32; 256]) -> io::Result<()> {
+    let mut file = BufWriter::new(File::create(path)?);
+    file.write_all(&encode_indexed(width, height, pixels, lut))?;
+    file.flush()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::util::crc::crc32;
+
+    #[test]
+    fn test_png_structure() {
+        let mut lut = [0u32; 256];
+        lut[1] = 0xFF112233;
+        let pixels = [0u8, 1, 1, 0, 0, 1];
+        let png = encode_indexed(3, 2, &pixels, &lut);
+
+        assert_eq!(&png[..8], b"\x89PNG\r\n\x1a\n");
+        assert_eq!(&png[12..16], b"IHDR");
+        assert_eq!(u32::from_be_bytes([png[16], png[17], png[18], png[19]]), 3);
+        assert_eq!(u32::from_be_bytes([png[20], png[21], png[22], png[23]]), 2);
+        assert_eq!(png[25], 3);
+
+        // PLTE follows IHDR (8 + 4+4+13+4) and carries the LUT colors
+        let plte = 8 + 25;
+        assert_eq!(&png[plte + 4..plte + 8], b"PLTE");
+        assert_eq!(&png[plte + 8 + 3..plte + 8 + 6], &[0x11, 0x22, 0x33]);
+
+        // Chunk CRCs cover type and data
+        let crc = u32::from_be_bytes([png[29], png[30], png[31], png[32]]);
+        assert_eq!(crc, crc32(&png[12..29]));
+
+        // IDAT holds the filtered rows in one stored block
+        let idat = plte + 12 + 768;
+        assert_eq!(&png[idat + 4..idat + 8], b"IDAT");
+        let data = &png[idat + 8..];
+        assert_eq!(&data[..3], &[0x78, 0x01, 1]);
+        assert_eq!(&data[7..15], &[0, 0, 1, 1, 0, 0, 0, 1]);
+
+        assert_eq!(&png[png.len() - 8..png.len() - 4], b"IEND");
+    }
+}
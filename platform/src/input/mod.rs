@@ -3,6 +3,7 @@
 use sdl2::keyboard::Keycode;
 use std::collections::VecDeque;
 use std::sync::Mutex;
+use std::time::Instant;
 use once_cell::sync::Lazy;
 
 /// Key codes (matching Windows VK_* values for compatibility)
@@ -64,6 +65,44 @@ pub struct KeyEvent {
     pub released: bool,
 }
 
+/// Kind of input event
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum InputEventType {
+    KeyDown = 0,
+    KeyUp = 1,
+    MouseDown = 2,
+    MouseUp = 3,
+    MouseMove = 4,
+    MouseWheel = 5,
+}
+
+/// Timestamped input event, as queued for Platform_Input_PollEvents
+///
+/// `code` is the KeyCode or MouseButton; `x`/`y` the mouse position (the
+/// wheel delta in `y` for MouseWheel). `time_us` is when the platform saw
+/// the event, on the Platform_Input_GetTimeUs clock.
+#[repr(C)]
+#[derive(Clone, Copy, Debug)]
+pub struct InputEvent {
+    pub kind: InputEventType,
+    pub code: i32,
+    pub x: i32,
+    pub y: i32,
+    pub time_us: u64,
+}
+
+/// Events held between polls; older ones are dropped past this
+pub const EVENT_QUEUE_CAPACITY: usize = 256;
+
+/// Zero point of event timestamps
+static INPUT_EPOCH: Lazy<Instant> = Lazy::new(Instant::now);
+
+/// Microseconds since the input clock started
+pub fn time_us() -> u64 {
+    INPUT_EPOCH.elapsed().as_micros() as u64
+}
+
 /// Double-click detection constants
 const DOUBLE_CLICK_TIME: u32 = 500;  // ms
 const DOUBLE_CLICK_DISTANCE: i32 = 4; // pixels
@@ -95,6 +134,11 @@ pub struct InputState {
     pub ctrl_down: bool,
     pub alt_down: bool,
 
+    // Event queue (only filled while enabled)
+    pub events_enabled: bool,
+    pub events: VecDeque<InputEvent>,
+    pub events_overflowed: bool,
+
     // Quit flag
     pub should_quit: bool,
 }
@@ -118,10 +162,50 @@ impl InputState {
             shift_down: false,
             ctrl_down: false,
             alt_down: false,
+            events_enabled: false,
+            events: VecDeque::with_capacity(EVENT_QUEUE_CAPACITY),
+            events_overflowed: false,
             should_quit: false,
         }
     }
 
+    /// Queue an event if the event queue is on
+    fn push_event(&mut self, kind: InputEventType, code: i32, x: i32, y: i32) {
+        if !self.events_enabled {
+            return;
+        }
+        if self.events.len() >= EVENT_QUEUE_CAPACITY {
+            // The consumer has fallen behind; it resyncs from full state
+            self.events.pop_front();
+            self.events_overflowed = true;
+        }
+        self.events.push_back(InputEvent { kind, code, x, y, time_us: time_us() });
+    }
+
+    /// Turn the event queue on or off (either way it starts empty)
+    pub fn set_events_enabled(&mut self, enabled: bool) {
+        self.events_enabled = enabled;
+        self.events.clear();
+        self.events_overflowed = false;
+    }
+
+    /// Move up to `out.len()` queued events into `out`
+    ///
+    /// Returns the number moved, or None if events were dropped since the
+    /// last poll (the queue is then emptied).
+    pub fn poll_events(&mut self, out: &mut [InputEvent]) -> Option<usize> {
+        if self.events_overflowed {
+            self.events.clear();
+            self.events_overflowed = false;
+            return None;
+        }
+        let count = out.len().min(self.events.len());
+        for (slot, event) in out.iter_mut().zip(self.events.drain(..count)) {
+            *slot = event;
+        }
+        Some(count)
+    }
+
     /// Called at start of each frame to update previous state
     pub fn begin_frame(&mut self) {
         self.keys_previous = self.keys_current;
@@ -142,6 +226,7 @@ impl InputState {
             if idx < 256 {
                 self.keys_current[idx] = true;
                 self.key_queue.push_back(KeyEvent { key: code, released: false });
+                self.push_event(InputEventType::KeyDown, idx as i32, self.mouse_x, self.mouse_y);
             }
 
             // Track modifiers
@@ -161,6 +246,7 @@ impl InputState {
             if idx < 256 {
                 self.keys_current[idx] = false;
                 self.key_queue.push_back(KeyEvent { key: code, released: true });
+                self.push_event(InputEventType::KeyUp, idx as i32, self.mouse_x, self.mouse_y);
             }
 
             // Track modifiers
@@ -215,6 +301,7 @@ impl InputState {
     pub fn handle_mouse_motion(&mut self, x: i32, y: i32) {
         self.mouse_x = x;
         self.mouse_y = y;
+        self.push_event(InputEventType::MouseMove, 0, x, y);
     }
 
     /// Handle mouse button down event
@@ -224,6 +311,7 @@ impl InputState {
 
         self.mouse_buttons[btn] = true;
         self.mouse_clicked[btn] = true;
+        self.push_event(InputEventType::MouseDown, btn as i32, x, y);
 
         // Double-click detection
         let dx = (x - self.last_click_x[btn]).abs();
@@ -244,11 +332,13 @@ impl InputState {
         let btn = button as usize;
         if btn >= 3 { return; }
         self.mouse_buttons[btn] = false;
+        self.push_event(InputEventType::MouseUp, btn as i32, self.mouse_x, self.mouse_y);
     }
 
     /// Handle mouse wheel event
     pub fn handle_mouse_wheel(&mut self, y: i32) {
         self.mouse_wheel = y;
+        self.push_event(InputEventType::MouseWheel, 0, self.mouse_x, y);
     }
 
     /// Check if mouse button is pressed
@@ -402,3 +492,51 @@ pub fn was_mouse_double_clicked(button: MouseButton) -> bool {
 pub fn get_mouse_wheel() -> i32 {
     with_input(|s| s.mouse_wheel).unwrap_or(0)
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_events_off_by_default() {
+        let mut state = InputState::new();
+        state.handle_mouse_motion(10, 20);
+        let mut out = [InputEvent { kind: InputEventType::MouseMove, code: 0, x: 0, y: 0, time_us: 0 }; 4];
+        assert_eq!(state.poll_events(&mut out), Some(0));
+    }
+
+    #[test]
+    fn test_events_in_order() {
+        let mut state = InputState::new();
+        state.set_events_enabled(true);
+        state.handle_mouse_motion(10, 20);
+        state.handle_mouse_down(MouseButton::Right, 11, 21, 0);
+        state.handle_mouse_up(MouseButton::Right);
+        state.handle_mouse_wheel(-1);
+
+        let mut out = [InputEvent { kind: InputEventType::MouseMove, code: 0, x: 0, y: 0, time_us: 0 }; 3];
+        assert_eq!(state.poll_events(&mut out), Some(3));
+        assert_eq!(out[0].kind, InputEventType::MouseMove);
+        assert_eq!((out[0].x, out[0].y), (10, 20));
+        assert_eq!(out[1].kind, InputEventType::MouseDown);
+        assert_eq!(out[1].code, MouseButton::Right as i32);
+        assert_eq!(out[2].kind, InputEventType::MouseUp);
+        assert!(out[0].time_us <= out[1].time_us && out[1].time_us <= out[2].time_us);
+
+        assert_eq!(state.poll_events(&mut out), Some(1));
+        assert_eq!(out[0].kind, InputEventType::MouseWheel);
+        assert_eq!(out[0].y, -1);
+    }
+
+    #[test]
+    fn test_event_overflow_reported() {
+        let mut state = InputState::new();
+        state.set_events_enabled(true);
+        for i in 0..(EVENT_QUEUE_CAPACITY as i32 + 1) {
+            state.handle_mouse_motion(i, i);
+        }
+        let mut out = [InputEvent { kind: InputEventType::MouseMove, code: 0, x: 0, y: 0, time_us: 0 }; 8];
+        assert_eq!(state.poll_events(&mut out), None);
+        assert_eq!(state.poll_events(&mut out), Some(0));
+    }
+}
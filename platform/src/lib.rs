@@ -71,6 +71,9 @@ pub use logging::{
     Platform_Log_SetLevel,
     Platform_Log_GetLevel,
     Platform_Log_Flush,
+    Platform_Log_SetAsync,
+    Platform_Log_IsAsync,
+    Platform_Log_GetDropped,
 };
 
 // Re-export display FFI functions
@@ -4,16 +4,22 @@
 //! - Multiple log levels (Error, Warn, Info, Debug, Trace)
 //! - Timestamped entries
 //! - Thread-safe file output
+//! - An optional async mode, where callers only format into a lock-free
+//!   ring and a writer thread does the I/O
 //! - FFI exports for C++ code
 
+mod ring;
+
 use log::{Level, LevelFilter, Log, Metadata, Record};
 use once_cell::sync::OnceCell;
+use ring::LogRing;
 use std::fs::File;
 use std::io::{BufWriter, Write};
 use std::os::raw::c_char;
-use std::sync::atomic::{AtomicU8, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicU8, AtomicUsize, Ordering};
 use std::sync::Mutex;
-use std::time::SystemTime;
+use std::thread::{self, JoinHandle};
+use std::time::{Duration, Instant, SystemTime};
 
 /// Global logger instance
 static LOGGER: OnceCell<GameLogger> = OnceCell::new();
@@ -24,6 +30,37 @@ static LOG_LEVEL: AtomicU8 = AtomicU8::new(2); // Default: Info
 /// Log file handle
 static LOG_FILE: OnceCell<Mutex<Option<BufWriter<File>>>> = OnceCell::new();
 
+/// Records in the async ring (ring::RECORD_BYTES each, made on first use)
+const ASYNC_RING_RECORDS: usize = 1024;
+
+/// The writer gathers up to this much before writing it out
+const WRITER_BATCH_BYTES: usize = 64 * 1024;
+
+/// How long the writer sleeps when the ring is empty
+const WRITER_POLL_MS: u64 = 5;
+
+/// Longest a flush waits on the writer
+const FLUSH_TIMEOUT_MS: u64 = 1000;
+
+/// Lines go through the ring rather than straight to the outputs
+static ASYNC_ENABLED: AtomicBool = AtomicBool::new(false);
+
+static ASYNC_RING: OnceCell<LogRing> = OnceCell::new();
+
+/// The writer thread, while async mode is on
+static ASYNC_WRITER: Mutex<Option<JoinHandle<()>>> = Mutex::new(None);
+
+static WRITER_STOP: AtomicBool = AtomicBool::new(false);
+
+/// Ring tickets the writer has written out
+static WRITTEN: AtomicUsize = AtomicUsize::new(0);
+
+/// Lines turned away by a full ring, not yet reported in the log
+static DROPPED: AtomicU64 = AtomicU64::new(0);
+
+/// Lines turned away by a full ring since startup
+static DROPPED_TOTAL: AtomicU64 = AtomicU64::new(0);
+
 /// The custom logger implementation
 pub struct GameLogger {
     /// Whether to write to stderr
@@ -40,47 +77,13 @@ impl GameLogger {
             file_enabled,
         }
     }
-}
-
-impl Log for GameLogger {
-    fn enabled(&self, metadata: &Metadata) -> bool {
-        let current_level = LOG_LEVEL.load(Ordering::Relaxed);
-        metadata.level() as u8 <= current_level + 1
-    }
-
-    fn log(&self, record: &Record) {
-        if !self.enabled(record.metadata()) {
-            return;
-        }
-
-        // Format the log message
-        let now = SystemTime::now()
-            .duration_since(SystemTime::UNIX_EPOCH)
-            .unwrap_or_default();
-        let secs = now.as_secs();
-        let millis = now.subsec_millis();
-
-        // Calculate time components (simple UTC)
-        let total_secs = secs % 86400; // seconds since midnight
-        let hours = total_secs / 3600;
-        let minutes = (total_secs % 3600) / 60;
-        let seconds = total_secs % 60;
-
-        let message = format!(
-            "[{:02}:{:02}:{:02}.{:03}] [{:5}] [{}] {}\n",
-            hours,
-            minutes,
-            seconds,
-            millis,
-            record.level(),
-            record.target(),
-            record.args()
-        );
 
+    /// Write finished lines to the console and the file
+    fn write_out(&self, lines: &[u8]) {
         // Write to console
         if self.console_enabled {
             // Use stderr so it doesn't interfere with stdout
-            eprint!("{}", message);
+            let _ = std::io::stderr().lock().write_all(lines);
         }
 
         // Write to file
@@ -88,7 +91,7 @@ impl Log for GameLogger {
             if let Some(file_mutex) = LOG_FILE.get() {
                 if let Ok(mut guard) = file_mutex.lock() {
                     if let Some(ref mut writer) = *guard {
-                        let _ = writer.write_all(message.as_bytes());
+                        let _ = writer.write_all(lines);
                         // Don't flush every write for performance
                         // Flush periodically or on shutdown
                     }
@@ -96,6 +99,61 @@ impl Log for GameLogger {
             }
         }
     }
+}
+
+/// Format one timestamped log line, newline included
+fn format_line(w: &mut dyn Write, record: &Record) {
+    let now = SystemTime::now()
+        .duration_since(SystemTime::UNIX_EPOCH)
+        .unwrap_or_default();
+    let secs = now.as_secs();
+    let millis = now.subsec_millis();
+
+    // Calculate time components (simple UTC)
+    let total_secs = secs % 86400; // seconds since midnight
+    let hours = total_secs / 3600;
+    let minutes = (total_secs % 3600) / 60;
+    let seconds = total_secs % 60;
+
+    let _ = writeln!(
+        w,
+        "[{:02}:{:02}:{:02}.{:03}] [{:5}] [{}] {}",
+        hours,
+        minutes,
+        seconds,
+        millis,
+        record.level(),
+        record.target(),
+        record.args()
+    );
+}
+
+impl Log for GameLogger {
+    fn enabled(&self, metadata: &Metadata) -> bool {
+        let current_level = LOG_LEVEL.load(Ordering::Relaxed);
+        metadata.level() as u8 <= current_level + 1
+    }
+
+    fn log(&self, record: &Record) {
+        if !self.enabled(record.metadata()) {
+            return;
+        }
+
+        // Async: the caller only formats; the writer thread does the I/O
+        if ASYNC_ENABLED.load(Ordering::Acquire) {
+            if let Some(ring) = ASYNC_RING.get() {
+                if !ring.push_with(|w| format_line(w, record)) {
+                    DROPPED.fetch_add(1, Ordering::Relaxed);
+                    DROPPED_TOTAL.fetch_add(1, Ordering::Relaxed);
+                }
+                return;
+            }
+        }
+
+        let mut line = Vec::with_capacity(128);
+        format_line(&mut line, record);
+        self.write_out(&line);
+    }
 
     fn flush(&self) {
         if let Some(file_mutex) = LOG_FILE.get() {
@@ -171,6 +229,9 @@ pub fn shutdown() {
     // Log shutdown message first
     log::info!("Logging system shutting down");
 
+    // Write out whatever the ring still holds
+    set_async(false);
+
     // Flush and close file
     if let Some(file_mutex) = LOG_FILE.get() {
         if let Ok(mut guard) = file_mutex.lock() {
@@ -199,7 +260,13 @@ pub fn get_level() -> u8 {
 }
 
 /// Flush the log buffer to disk
+///
+/// In async mode this is a barrier: every line logged before the call is
+/// written out before it returns.
 pub fn flush() {
+    if ASYNC_ENABLED.load(Ordering::Acquire) {
+        wait_for_writer();
+    }
     if let Some(logger) = LOGGER.get() {
         logger.flush();
     }
@@ -218,6 +285,142 @@ fn update_max_level() {
     log::set_max_level(filter);
 }
 
+// =============================================================================
+// Async Mode
+// =============================================================================
+
+/// Turn async logging on or off
+///
+/// On, a log call formats its line into a preallocated ring record and
+/// returns; the "log-writer" thread writes the lines out in batches. A
+/// full ring drops the line (counted, and reported in the log) rather
+/// than stall the caller. Turning it off stops the writer and writes out
+/// what is left.
+///
+/// # Returns
+/// `false` if the writer thread could not be started
+pub fn set_async(enabled: bool) -> bool {
+    let mut writer = ASYNC_WRITER.lock().unwrap_or_else(|e| e.into_inner());
+    if enabled {
+        if writer.is_some() {
+            return true;
+        }
+        let ring = ASYNC_RING.get_or_init(|| LogRing::new(ASYNC_RING_RECORDS));
+        WRITER_STOP.store(false, Ordering::Release);
+        WRITTEN.store(ring.dequeued(), Ordering::Release);
+        match thread::Builder::new()
+            .name("log-writer".to_string())
+            .spawn(run_writer)
+        {
+            Ok(handle) => {
+                *writer = Some(handle);
+                ASYNC_ENABLED.store(true, Ordering::Release);
+                true
+            }
+            Err(e) => {
+                log::warn!("Async logging unavailable: {}", e);
+                false
+            }
+        }
+    } else {
+        ASYNC_ENABLED.store(false, Ordering::Release);
+        if let Some(handle) = writer.take() {
+            WRITER_STOP.store(true, Ordering::Release);
+            handle.thread().unpark();
+            let _ = handle.join();
+        }
+        // Lines from callers that saw async on as the writer stopped
+        if let Some(ring) = ASYNC_RING.get() {
+            let mut batch = Vec::new();
+            drain_ring(ring, &mut batch, usize::MAX);
+            write_batch(&batch);
+        }
+        true
+    }
+}
+
+/// Whether async logging is on
+pub fn is_async() -> bool {
+    ASYNC_ENABLED.load(Ordering::Acquire)
+}
+
+/// Lines dropped by a full async ring since startup
+pub fn dropped_count() -> u64 {
+    DROPPED_TOTAL.load(Ordering::Relaxed)
+}
+
+/// Pop published lines into batch until it holds max_bytes
+fn drain_ring(ring: &LogRing, batch: &mut Vec<u8>, max_bytes: usize) {
+    while batch.len() < max_bytes && ring.pop_with(|line| batch.extend_from_slice(line)).is_some() {}
+
+    let dropped = DROPPED.swap(0, Ordering::Relaxed);
+    if dropped > 0 {
+        let _ = writeln!(batch, "[log] {} lines dropped, async ring full", dropped);
+    }
+}
+
+fn write_batch(batch: &[u8]) {
+    if batch.is_empty() {
+        return;
+    }
+    if let Some(logger) = LOGGER.get() {
+        logger.write_out(batch);
+    }
+}
+
+/// The writer thread: drain, write, and sleep when there is nothing to do
+fn run_writer() {
+    let ring = match ASYNC_RING.get() {
+        Some(ring) => ring,
+        None => return,
+    };
+    let mut batch = Vec::with_capacity(WRITER_BATCH_BYTES + ring::RECORD_BYTES);
+    loop {
+        // Read before draining, so nothing logged before the stop is left
+        let stopping = WRITER_STOP.load(Ordering::Acquire);
+
+        drain_ring(ring, &mut batch, WRITER_BATCH_BYTES);
+        let wrote = !batch.is_empty();
+        write_batch(&batch);
+        batch.clear();
+        WRITTEN.store(ring.dequeued(), Ordering::Release);
+
+        if wrote {
+            continue;
+        }
+        if stopping {
+            break;
+        }
+        thread::park_timeout(Duration::from_millis(WRITER_POLL_MS));
+    }
+}
+
+/// Wait until the writer has written every line logged so far
+fn wait_for_writer() {
+    let ring = match ASYNC_RING.get() {
+        Some(ring) => ring,
+        None => return,
+    };
+    let writer = match ASYNC_WRITER.lock() {
+        Ok(guard) => guard.as_ref().map(|handle| handle.thread().clone()),
+        Err(_) => None,
+    };
+    let writer = match writer {
+        Some(thread) => thread,
+        None => return,
+    };
+
+    let target = ring.enqueued();
+    let deadline = Instant::now() + Duration::from_millis(FLUSH_TIMEOUT_MS);
+    while (target.wrapping_sub(WRITTEN.load(Ordering::Acquire)) as isize) > 0 {
+        if Instant::now() >= deadline {
+            break;
+        }
+        writer.unpark();
+        thread::sleep(Duration::from_micros(200));
+    }
+}
+
 /// Log a message at the specified level
 ///
 /// This is primarily for FFI use. Rust code should use the log macros.
@@ -353,12 +556,45 @@ pub extern "C" fn Platform_Log_GetLevel() -> i32 {
 /// Flush log buffer to disk
 ///
 /// Call this periodically or before program exit to ensure
-/// all log messages are written to the file.
+/// all log messages are written to the file. In async mode it also
+/// waits until the writer thread has written every line logged
+/// before the call.
 #[no_mangle]
 pub extern "C" fn Platform_Log_Flush() {
     flush();
 }
 
+/// Turn async logging on or off
+///
+/// On, log calls only format into a lock-free ring of preallocated
+/// records and a background thread writes them out in batches;
+/// Platform_Log_Flush waits for it. A full ring drops lines rather than
+/// block (see Platform_Log_GetDropped).
+///
+/// # Returns
+/// - 0 on success
+/// - -1 if the writer thread could not be started
+#[no_mangle]
+pub extern "C" fn Platform_Log_SetAsync(enabled: i32) -> i32 {
+    if set_async(enabled != 0) {
+        0
+    } else {
+        -1
+    }
+}
+
+/// Whether async logging is on (1) or off (0)
+#[no_mangle]
+pub extern "C" fn Platform_Log_IsAsync() -> i32 {
+    is_async() as i32
+}
+
+/// Lines dropped because the async ring was full, since startup
+#[no_mangle]
+pub extern "C" fn Platform_Log_GetDropped() -> u64 {
+    dropped_count()
+}
+
 // =============================================================================
 // Unit Tests
 // =============================================================================
@@ -446,6 +682,34 @@ mod tests {
         Platform_Log_Flush();
     }
 
+    #[test]
+    fn test_async_toggle_and_flush() {
+        assert_eq!(Platform_Log_SetAsync(1), 0);
+        assert_eq!(Platform_Log_IsAsync(), 1);
+        // Enabling twice keeps the one writer
+        assert_eq!(Platform_Log_SetAsync(1), 0);
+
+        // Not the registered logger, so this works without init()
+        let logger = GameLogger::new(false, false);
+        for i in 0..100 {
+            logger.log(
+                &Record::builder()
+                    .args(format_args!("Async message {}", i))
+                    .level(Level::Info)
+                    .target("test")
+                    .build(),
+            );
+        }
+        Platform_Log_Flush();
+        let ring = ASYNC_RING.get().unwrap();
+        assert!(ring.enqueued() >= 100);
+        assert_eq!(WRITTEN.load(Ordering::Acquire), ring.enqueued());
+
+        assert_eq!(Platform_Log_SetAsync(0), 0);
+        assert_eq!(Platform_Log_IsAsync(), 0);
+        assert_eq!(ring.dequeued(), ring.enqueued());
+    }
+
     #[test]
     fn test_shutdown_without_init() {
         // Should not crash
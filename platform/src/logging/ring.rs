@@ -0,0 +1,262 @@
+//! Multi-producer single-consumer ring of log records
+//!
+//! Any thread formats its line straight into a preallocated record and
+//! publishes it with one compare-and-swap; the log writer thread drains
+//! them in order. Nothing allocates or locks after the ring is made, and
+//! a full ring turns the line away rather than making the caller wait.
+//!
+//! Each slot carries a sequence number (the bounded MPMC queue design):
+//! a slot is free for ticket `n` when its sequence is `n`, readable when
+//! it is `n + 1`, and goes back to the producers as `n + capacity`.
+
+use std::cell::UnsafeCell;
+use std::io::Write;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Bytes in one record; longer lines are cut short
+pub(crate) const RECORD_BYTES: usize = 512;
+
+struct Record {
+    len: usize,
+    bytes: [u8; RECORD_BYTES],
+}
+
+struct Slot {
+    sequence: AtomicUsize,
+    record: UnsafeCell<Record>,
+}
+
+/// Fixed-size ring of formatted log lines
+pub struct LogRing {
+    slots: Box<[Slot]>,
+    mask: usize,
+    /// Next ticket to hand a producer
+    enqueue: AtomicUsize,
+    /// Next ticket to read (consumer-owned)
+    dequeue: AtomicUsize,
+}
+
+// A record is written only by the producer holding its ticket and read
+// only by the consumer once the sequence has published it
+unsafe impl Sync for LogRing {}
+unsafe impl Send for LogRing {}
+
+/// `Write` into a fixed buffer that keeps what fits and drops the rest
+struct Truncating<'a> {
+    buf: &'a mut [u8],
+    len: usize,
+}
+
+impl Write for Truncating<'_> {
+    fn write(&mut self, data: &[u8]) -> std::io::Result<usize> {
+        let take = data.len().min(self.buf.len() - self.len);
+        self.buf[self.len..self.len + take].copy_from_slice(&data[..take]);
+        self.len += take;
+        Ok(data.len())
+    }
+
+    fn flush(&mut self) -> std::io::Result<()> {
+        Ok(())
+    }
+}
+
+impl LogRing {
+    /// Make a ring of at least `capacity` records (rounded up to a power
+    /// of two)
+    pub fn new(capacity: usize) -> Self {
+        let capacity = capacity.max(2).next_power_of_two();
+        let slots: Vec<Slot> = (0..capacity)
+            .map(|i| Slot {
+                sequence: AtomicUsize::new(i),
+                record: UnsafeCell::new(Record {
+                    len: 0,
+                    bytes: [0; RECORD_BYTES],
+                }),
+            })
+            .collect();
+        Self {
+            slots: slots.into_boxed_slice(),
+            mask: capacity - 1,
+            enqueue: AtomicUsize::new(0),
+            dequeue: AtomicUsize::new(0),
+        }
+    }
+
+    pub fn capacity(&self) -> usize {
+        self.mask + 1
+    }
+
+    /// Claim a record, let `format` write the line into it, and publish it
+    ///
+    /// A line longer than RECORD_BYTES is cut short and ends in a newline.
+    ///
+    /// # Returns
+    /// `false` (and `format` is not called) if the ring is full
+    pub fn push_with<F: FnOnce(&mut dyn Write)>(&self, format: F) -> bool {
+        let mut ticket = self.enqueue.load(Ordering::Relaxed);
+        let slot = loop {
+            let slot = &self.slots[ticket & self.mask];
+            let sequence = slot.sequence.load(Ordering::Acquire);
+            let lag = sequence.wrapping_sub(ticket) as isize;
+            if lag == 0 {
+                match self.enqueue.compare_exchange_weak(
+                    ticket,
+                    ticket.wrapping_add(1),
+                    Ordering::Relaxed,
+                    Ordering::Relaxed,
+                ) {
+                    Ok(_) => break slot,
+                    Err(current) => ticket = current,
+                }
+            } else if lag < 0 {
+                // Still holds a line from the last lap
+                return false;
+            } else {
+                ticket = self.enqueue.load(Ordering::Relaxed);
+            }
+        };
+
+        // This ticket is ours alone until the sequence is published
+        let record = unsafe { &mut *slot.record.get() };
+        let mut writer = Truncating {
+            buf: &mut record.bytes,
+            len: 0,
+        };
+        format(&mut writer);
+        let mut len = writer.len;
+        if len == RECORD_BYTES && record.bytes[len - 1] != b'\n' {
+            record.bytes[len - 1] = b'\n';
+        }
+        if len == 0 {
+            record.bytes[0] = b'\n';
+            len = 1;
+        }
+        record.len = len;
+        slot.sequence.store(ticket.wrapping_add(1), Ordering::Release);
+        true
+    }
+
+    /// Read the oldest published line in place and release its record
+    ///
+    /// Only one thread may pop.
+    ///
+    /// # Returns
+    /// What `read` returned, or `None` if the next line is not published yet
+    pub fn pop_with<R, F: FnOnce(&[u8]) -> R>(&self, read: F) -> Option<R> {
+        let ticket = self.dequeue.load(Ordering::Relaxed);
+        let slot = &self.slots[ticket & self.mask];
+        if slot.sequence.load(Ordering::Acquire) != ticket.wrapping_add(1) {
+            return None;
+        }
+
+        let record = unsafe { &*slot.record.get() };
+        let result = read(&record.bytes[..record.len]);
+        slot.sequence
+            .store(ticket.wrapping_add(self.capacity()), Ordering::Release);
+        self.dequeue.store(ticket.wrapping_add(1), Ordering::Release);
+        Some(result)
+    }
+
+    /// Tickets handed out so far; a line pushed before this call has a
+    /// ticket below it
+    pub fn enqueued(&self) -> usize {
+        self.enqueue.load(Ordering::Acquire)
+    }
+
+    /// Tickets read so far
+    pub fn dequeued(&self) -> usize {
+        self.dequeue.load(Ordering::Acquire)
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+    use std::thread;
+
+    fn pop_string(ring: &LogRing) -> Option<String> {
+        ring.pop_with(|bytes| String::from_utf8_lossy(bytes).into_owned())
+    }
+
+    #[test]
+    fn test_fifo_and_full() {
+        let ring = LogRing::new(3);
+        assert_eq!(ring.capacity(), 4);
+        for i in 0..4 {
+            assert!(ring.push_with(|w| {
+                let _ = writeln!(w, "line {}", i);
+            }));
+        }
+        assert!(!ring.push_with(|_| panic!("full ring must not format")));
+
+        assert_eq!(pop_string(&ring).as_deref(), Some("line 0\n"));
+        assert!(ring.push_with(|w| {
+            let _ = writeln!(w, "line 4");
+        }));
+        for i in 1..5 {
+            assert_eq!(pop_string(&ring), Some(format!("line {}\n", i)));
+        }
+        assert_eq!(pop_string(&ring), None);
+        assert_eq!(ring.enqueued(), ring.dequeued());
+    }
+
+    #[test]
+    fn test_long_line_truncated() {
+        let ring = LogRing::new(2);
+        let long = "x".repeat(RECORD_BYTES * 2);
+        assert!(ring.push_with(|w| {
+            let _ = writeln!(w, "{}", long);
+        }));
+        let line = pop_string(&ring).unwrap();
+        assert_eq!(line.len(), RECORD_BYTES);
+        assert!(line.ends_with('\n'));
+    }
+
+    #[test]
+    fn test_many_producers() {
+        const THREADS: usize = 4;
+        const LINES: usize = 2000;
+        let ring = Arc::new(LogRing::new(64));
+
+        let producers: Vec<_> = (0..THREADS)
+            .map(|t| {
+                let ring = Arc::clone(&ring);
+                thread::spawn(move || {
+                    for i in 0..LINES {
+                        while !ring.push_with(|w| {
+                            let _ = write!(w, "{} {}", t, i);
+                        }) {
+                            thread::yield_now();
+                        }
+                    }
+                })
+            })
+            .collect();
+
+        // Every line arrives once, each producer's in its own order
+        let mut next = [0usize; THREADS];
+        let mut received = 0;
+        while received < THREADS * LINES {
+            match pop_string(&ring) {
+                Some(line) => {
+                    let mut parts = line.split(' ');
+                    let t: usize = parts.next().unwrap().parse().unwrap();
+                    let i: usize = parts.next().unwrap().parse().unwrap();
+                    assert_eq!(i, next[t]);
+                    next[t] += 1;
+                    received += 1;
+                }
+                None => thread::yield_now(),
+            }
+        }
+        for producer in producers {
+            producer.join().unwrap();
+        }
+        assert_eq!(pop_string(&ring), None);
+    }
+}
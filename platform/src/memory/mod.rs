@@ -1,15 +1,13 @@
 //! Memory management module
 //!
 //! Provides C-compatible allocation functions backed by Rust's allocator.
+//! Blocks requested with `MemFlags::HUGE` are mapped directly from the OS
+//! on 2 MB pages where available (see Large Pages below).
 
 use std::alloc::{Layout, alloc, dealloc, realloc};
-use std::sync::atomic::{AtomicUsize, Ordering};
-
-#[cfg(debug_assertions)]
 use std::collections::HashMap;
-#[cfg(debug_assertions)]
 use std::sync::Mutex;
-#[cfg(debug_assertions)]
+use std::sync::atomic::{AtomicUsize, Ordering};
 use once_cell::sync::Lazy;
 
 #[cfg(debug_assertions)]
@@ -41,10 +39,18 @@ pub struct MemFlags;
 impl MemFlags {
     pub const NORMAL: u32 = 0x0000;
     pub const TEMP: u32 = 0x0001;
-    pub const LOCK: u32 = 0x0002;  // Ignored on modern systems
+    pub const LOCK: u32 = 0x0002;  // mlock; only honoured together with HUGE
     pub const CLEAR: u32 = 0x0004;
+    pub const HUGE: u32 = 0x0008;  // Back with 2 MB pages where available
 }
 
+/// Platform_Alloc flag: pin a `PLATFORM_MEM_HUGE_PAGES` block in RAM
+pub const PLATFORM_MEM_LOCK: u32 = 0x0002;
+
+/// Platform_Alloc flag: back the block with 2 MB pages where the OS allows,
+/// falling back to ordinary memory
+pub const PLATFORM_MEM_HUGE_PAGES: u32 = 0x0008;
+
 // =============================================================================
 // Allocation Functions
 // =============================================================================
@@ -58,6 +64,13 @@ pub fn mem_alloc(size: usize, flags: u32) -> *mut u8 {
         return std::ptr::null_mut();
     }
 
+    if flags & MemFlags::HUGE != 0 {
+        if let Some(ptr) = large_page_alloc(size, flags) {
+            track_alloc(ptr as usize, size);
+            return ptr;
+        }
+    }
+
     // Use proper alignment for the size
     let layout = match Layout::from_size_align(size, std::mem::align_of::<usize>()) {
         Ok(l) => l,
@@ -95,6 +108,10 @@ pub fn mem_free(ptr: *mut u8, size: usize) {
     if size > 0 {
         track_free(ptr as usize, size);
 
+        if large_page_free(ptr) {
+            return;
+        }
+
         let layout = match Layout::from_size_align(size, std::mem::align_of::<usize>()) {
             Ok(l) => l,
             Err(_) => return,
@@ -124,6 +141,18 @@ pub fn mem_realloc(ptr: *mut u8, old_size: usize, new_size: usize) -> *mut u8 {
         return mem_alloc(new_size, MemFlags::NORMAL);
     }
 
+    // Mapped blocks move to a fresh mapping with the same flags
+    if let Some(flags) = large_page_flags(ptr) {
+        let new_ptr = mem_alloc(new_size, flags);
+        if !new_ptr.is_null() {
+            unsafe {
+                std::ptr::copy_nonoverlapping(ptr, new_ptr, old_size.min(new_size));
+            }
+            mem_free(ptr, old_size);
+        }
+        return new_ptr;
+    }
+
     let old_layout = match Layout::from_size_align(old_size, std::mem::align_of::<usize>()) {
         Ok(l) => l,
         Err(_) => return std::ptr::null_mut(),
@@ -140,6 +169,175 @@ pub fn mem_realloc(ptr: *mut u8, old_size: usize, new_size: usize) -> *mut u8 {
     }
 }
 
+// =============================================================================
+// Large Pages
+// =============================================================================
+//
+// Big long-lived buffers touched every frame (screen surface, map cells)
+// walk through memory linearly, so on 4 KB pages they churn the TLB. A
+// HUGE request is mapped straight from the OS, rounded up to whole 2 MB
+// pages: reserved hugetlbfs pages first, else a 2 MB-aligned anonymous
+// mapping advised for transparent huge pages. With LOCK it is also
+// mlock'd so it can never be paged out. Every outcome is logged once per
+// allocation so a deployment can confirm what it actually got.
+
+/// Huge page size used for rounding and alignment
+pub(crate) const HUGE_PAGE_SIZE: usize = 2 * 1024 * 1024;
+
+struct LargePageBlock {
+    len: usize,
+    flags: u32,
+}
+
+static LARGE_PAGE_BLOCKS: Lazy<Mutex<HashMap<usize, LargePageBlock>>> =
+    Lazy::new(|| Mutex::new(HashMap::new()));
+
+/// Live large-page blocks; lets mem_free skip the lock in the common case
+static LARGE_PAGE_COUNT: AtomicUsize = AtomicUsize::new(0);
+static LARGE_PAGE_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+/// Map a zeroed block of at least `size` bytes on large pages
+///
+/// Returns None (after logging why) when the OS cannot provide one; the
+/// caller then falls back to the normal allocator.
+fn large_page_alloc(size: usize, flags: u32) -> Option<*mut u8> {
+    let len = size.checked_add(HUGE_PAGE_SIZE - 1)? & !(HUGE_PAGE_SIZE - 1);
+
+    let (ptr, kind) = match map_large_pages(len) {
+        Some(mapped) => mapped,
+        None => {
+            log::warn!("Large pages unavailable for {} byte block, using normal memory", size);
+            return None;
+        }
+    };
+
+    let mut locked = false;
+    if flags & MemFlags::LOCK != 0 {
+        locked = lock_pages(ptr, len);
+        if !locked {
+            log::warn!("mlock of {} byte block failed (RLIMIT_MEMLOCK?), left pageable", len);
+        }
+    }
+    log::info!("Mapped {} byte block on {}{}", len, kind, if locked { ", locked" } else { "" });
+
+    if let Ok(mut blocks) = LARGE_PAGE_BLOCKS.lock() {
+        blocks.insert(ptr as usize, LargePageBlock { len, flags });
+    }
+    LARGE_PAGE_COUNT.fetch_add(1, Ordering::Relaxed);
+    LARGE_PAGE_BYTES.fetch_add(len, Ordering::Relaxed);
+    Some(ptr)
+}
+
+/// Unmap ptr if it is a large-page block; false if it came from the heap
+fn large_page_free(ptr: *mut u8) -> bool {
+    if LARGE_PAGE_COUNT.load(Ordering::Relaxed) == 0 {
+        return false;
+    }
+    let block = match LARGE_PAGE_BLOCKS.lock() {
+        Ok(mut blocks) => blocks.remove(&(ptr as usize)),
+        Err(_) => None,
+    };
+    match block {
+        Some(block) => {
+            unmap_large_pages(ptr, block.len);
+            LARGE_PAGE_COUNT.fetch_sub(1, Ordering::Relaxed);
+            LARGE_PAGE_BYTES.fetch_sub(block.len, Ordering::Relaxed);
+            true
+        }
+        None => false,
+    }
+}
+
+/// Flags a large-page block was allocated with, None for heap blocks
+fn large_page_flags(ptr: *mut u8) -> Option<u32> {
+    if LARGE_PAGE_COUNT.load(Ordering::Relaxed) == 0 {
+        return None;
+    }
+    LARGE_PAGE_BLOCKS.lock().ok()?.get(&(ptr as usize)).map(|block| block.flags)
+}
+
+/// Bytes currently mapped for HUGE allocations (whole 2 MB pages)
+pub fn get_large_page_bytes() -> usize {
+    LARGE_PAGE_BYTES.load(Ordering::Relaxed)
+}
+
+#[cfg(target_os = "linux")]
+fn map_large_pages(len: usize) -> Option<(*mut u8, &'static str)> {
+    unsafe {
+        let ptr = libc::mmap(
+            std::ptr::null_mut(),
+            len,
+            libc::PROT_READ | libc::PROT_WRITE,
+            libc::MAP_PRIVATE | libc::MAP_ANONYMOUS | libc::MAP_HUGETLB,
+            -1,
+            0,
+        );
+        if ptr != libc::MAP_FAILED {
+            return Some((ptr as *mut u8, "reserved huge pages"));
+        }
+
+        // No hugetlbfs pool: over-map, trim to 2 MB alignment, ask for THP
+        let span = len + HUGE_PAGE_SIZE;
+        let raw = libc::mmap(
+            std::ptr::null_mut(),
+            span,
+            libc::PROT_READ | libc::PROT_WRITE,
+            libc::MAP_PRIVATE | libc::MAP_ANONYMOUS,
+            -1,
+            0,
+        );
+        if raw == libc::MAP_FAILED {
+            return None;
+        }
+        let start = raw as usize;
+        let aligned = (start + HUGE_PAGE_SIZE - 1) & !(HUGE_PAGE_SIZE - 1);
+        if aligned > start {
+            libc::munmap(raw, aligned - start);
+        }
+        let tail = start + span - (aligned + len);
+        if tail > 0 {
+            libc::munmap((aligned + len) as *mut libc::c_void, tail);
+        }
+
+        let ptr = aligned as *mut libc::c_void;
+        if libc::madvise(ptr, len, libc::MADV_HUGEPAGE) == 0 {
+            Some((ptr as *mut u8, "transparent huge pages"))
+        } else {
+            Some((ptr as *mut u8, "4 KB pages (transparent huge pages disabled)"))
+        }
+    }
+}
+
+#[cfg(all(unix, not(target_os = "linux")))]
+fn map_large_pages(_len: usize) -> Option<(*mut u8, &'static str)> {
+    None
+}
+
+#[cfg(not(unix))]
+fn map_large_pages(_len: usize) -> Option<(*mut u8, &'static str)> {
+    None
+}
+
+#[cfg(target_os = "linux")]
+fn unmap_large_pages(ptr: *mut u8, len: usize) {
+    unsafe {
+        libc::munmap(ptr as *mut libc::c_void, len);
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn unmap_large_pages(_ptr: *mut u8, _len: usize) {}
+
+#[cfg(target_os = "linux")]
+fn lock_pages(ptr: *mut u8, len: usize) -> bool {
+    unsafe { libc::mlock(ptr as *const libc::c_void, len) == 0 }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn lock_pages(_ptr: *mut u8, _len: usize) -> bool {
+    false
+}
+
 // =============================================================================
 // Basic Tracking
 // =============================================================================
@@ -208,9 +406,30 @@ pub fn get_count() -> usize {
     ALLOCATION_COUNT.load(Ordering::Relaxed)
 }
 
-/// Get estimated free RAM (returns large value for compatibility)
+/// Fallback when the system's free RAM cannot be read
+const FALLBACK_FREE_RAM: usize = 256 * 1024 * 1024; // 256 MB
+
+/// Get free RAM
+///
+/// On Linux this is MemAvailable from /proc/meminfo (memory the system can
+/// hand out without swapping, page cache included); elsewhere, or if that
+/// cannot be read, a large value for compatibility.
 pub fn get_free_ram() -> usize {
-    256 * 1024 * 1024 // 256 MB
+    #[cfg(target_os = "linux")]
+    {
+        if let Some(bytes) = read_meminfo_available() {
+            return bytes;
+        }
+    }
+    FALLBACK_FREE_RAM
+}
+
+#[cfg(target_os = "linux")]
+fn read_meminfo_available() -> Option<usize> {
+    let meminfo = std::fs::read_to_string("/proc/meminfo").ok()?;
+    let line = meminfo.lines().find(|line| line.starts_with("MemAvailable:"))?;
+    let kb: usize = line.split_whitespace().nth(1)?.parse().ok()?;
+    Some(kb * 1024)
 }
 
 /// Get total RAM (returns reasonable estimate)
@@ -244,3 +463,36 @@ pub fn dump_leaks() {
 pub fn dump_leaks() {
     // No-op in release builds
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_huge_alloc_round_trip() {
+        let size = 3 * 1024 * 1024 + 17;
+        let ptr = mem_alloc(size, MemFlags::HUGE | MemFlags::CLEAR);
+        assert!(!ptr.is_null());
+        unsafe {
+            assert_eq!(*ptr, 0);
+            assert_eq!(*ptr.add(size - 1), 0);
+            *ptr.add(size - 1) = 7;
+        }
+
+        let grown = mem_realloc(ptr, size, size * 2);
+        assert!(!grown.is_null());
+        unsafe {
+            assert_eq!(*grown.add(size - 1), 7);
+        }
+        mem_free(grown, size * 2);
+        assert!(large_page_flags(grown).is_none());
+    }
+
+    #[test]
+    fn test_normal_alloc_not_large_page() {
+        let ptr = mem_alloc(64, MemFlags::CLEAR);
+        assert!(!ptr.is_null());
+        assert!(large_page_flags(ptr).is_none());
+        mem_free(ptr, 64);
+    }
+}
@@ -0,0 +1,463 @@
+//! Outgoing message batching
+//!
+//! Every enet packet pays for a UDP/IP header, enet's protocol header and
+//! a GamePacketHeader. Game events sent one packet each at tick rate are
+//! mostly overhead, so the batcher packs one tick's messages for a channel
+//! into datagrams that share a single header:
+//!
+//! ```text
+//! GamePacketHeader (code = MessageBatch)
+//! message*: code (u8) | handle delta (zigzag varint) | length (varint) | body
+//! ```
+//!
+//! Each message may carry a handle (unit, building, player...). It is sent
+//! as the difference from the previous message's handle in the datagram,
+//! so a run of orders for nearby units costs a byte or two per handle
+//! rather than four. Messages without one use handle 0.
+
+use super::packet::GamePacketHeader;
+
+/// Datagrams are closed once the next message would take them past this
+/// size, keeping them under a typical path MTU (a single larger message
+/// still gets a datagram of its own)
+pub(crate) const MAX_DATAGRAM_SIZE: usize = 1200;
+
+/// Channels the batcher keeps queues for
+pub(crate) const BATCH_CHANNELS: usize = 2;
+
+/// Worst-case framing for one message: code + two 5-byte varints
+const MAX_MESSAGE_OVERHEAD: usize = 11;
+
+// =============================================================================
+// Encoding helpers
+// =============================================================================
+
+fn write_varint(out: &mut Vec<u8>, mut value: u32) {
+    while value >= 0x80 {
+        out.push((value as u8) | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+fn read_varint(data: &[u8], pos: &mut usize) -> Option<u32> {
+    let mut value = 0u32;
+    for shift in (0..35).step_by(7) {
+        let byte = *data.get(*pos)?;
+        *pos += 1;
+        value |= ((byte & 0x7F) as u32) << shift;
+        if byte & 0x80 == 0 {
+            return Some(value);
+        }
+    }
+    None
+}
+
+fn zigzag_delta(prev: u32, handle: u32) -> u32 {
+    let delta = handle.wrapping_sub(prev) as i32;
+    ((delta << 1) ^ (delta >> 31)) as u32
+}
+
+fn apply_zigzag_delta(prev: u32, encoded: u32) -> u32 {
+    let delta = ((encoded >> 1) as i32) ^ -((encoded & 1) as i32);
+    prev.wrapping_add(delta as u32)
+}
+
+// =============================================================================
+// MessageBatcher
+// =============================================================================
+
+/// One datagram being filled
+#[derive(Debug, Default)]
+struct Datagram {
+    /// Header space followed by framed messages
+    bytes: Vec<u8>,
+    /// Handle of the last message, base for the next delta
+    last_handle: u32,
+    messages: u32,
+}
+
+/// Datagrams queued for one channel; `datagrams[..open]` are in use and
+/// the rest are kept for their capacity
+#[derive(Debug, Default)]
+struct ChannelQueue {
+    datagrams: Vec<Datagram>,
+    open: usize,
+}
+
+impl ChannelQueue {
+    fn start_datagram(&mut self) -> &mut Datagram {
+        if self.open == self.datagrams.len() {
+            self.datagrams.push(Datagram::default());
+        }
+        let datagram = &mut self.datagrams[self.open];
+        self.open += 1;
+
+        datagram.bytes.clear();
+        datagram.bytes.resize(GamePacketHeader::SIZE, 0);
+        datagram.last_handle = 0;
+        datagram.messages = 0;
+        datagram
+    }
+}
+
+/// Collects a tick's outgoing messages into framed datagrams per channel
+#[derive(Debug, Default)]
+pub struct MessageBatcher {
+    channels: [ChannelQueue; BATCH_CHANNELS],
+}
+
+impl MessageBatcher {
+    /// Create an empty batcher
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Queue a message for the next flush
+    ///
+    /// # Returns
+    /// `false` if `channel` is out of range
+    pub fn push(&mut self, channel: u8, code: u8, handle: u32, body: &[u8]) -> bool {
+        let queue = match self.channels.get_mut(channel as usize) {
+            Some(queue) => queue,
+            None => return false,
+        };
+
+        let needed = MAX_MESSAGE_OVERHEAD + body.len();
+        let datagram = match queue.open {
+            0 => queue.start_datagram(),
+            open => {
+                let current = &queue.datagrams[open - 1];
+                if current.messages > 0 && current.bytes.len() + needed > MAX_DATAGRAM_SIZE {
+                    queue.start_datagram()
+                } else {
+                    &mut queue.datagrams[open - 1]
+                }
+            }
+        };
+
+        datagram.bytes.push(code);
+        write_varint(&mut datagram.bytes, zigzag_delta(datagram.last_handle, handle));
+        write_varint(&mut datagram.bytes, body.len() as u32);
+        datagram.bytes.extend_from_slice(body);
+        datagram.last_handle = handle;
+        datagram.messages += 1;
+        true
+    }
+
+    /// True if nothing is queued
+    pub fn is_empty(&self) -> bool {
+        self.channels.iter().all(|queue| queue.open == 0)
+    }
+
+    /// Number of messages queued on all channels
+    pub fn message_count(&self) -> usize {
+        self.channels
+            .iter()
+            .flat_map(|queue| &queue.datagrams[..queue.open])
+            .map(|datagram| datagram.messages as usize)
+            .sum()
+    }
+
+    /// Hand every queued datagram to `send` and empty the queues
+    ///
+    /// `send` receives the channel and the datagram, whose first
+    /// `GamePacketHeader::SIZE` bytes are left for it to fill in.
+    ///
+    /// # Returns
+    /// Number of datagrams handed out
+    pub fn drain<F: FnMut(u8, &mut [u8])>(&mut self, mut send: F) -> usize {
+        let mut count = 0;
+        for (channel, queue) in self.channels.iter_mut().enumerate() {
+            for datagram in &mut queue.datagrams[..queue.open] {
+                send(channel as u8, &mut datagram.bytes);
+                count += 1;
+            }
+            queue.open = 0;
+        }
+        count
+    }
+
+    /// Drop everything queued
+    pub fn clear(&mut self) {
+        for queue in &mut self.channels {
+            queue.open = 0;
+        }
+    }
+}
+
+// =============================================================================
+// BatchReader
+// =============================================================================
+
+/// A message unpacked from a batch datagram
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct BatchMessage<'a> {
+    pub code: u8,
+    pub handle: u32,
+    pub body: &'a [u8],
+}
+
+/// Iterates the messages in a batch payload (the bytes after the header)
+///
+/// Stops at the end of the payload or at the first malformed message.
+#[derive(Debug, Clone)]
+pub struct BatchReader<'a> {
+    payload: &'a [u8],
+    pos: usize,
+    handle: u32,
+}
+
+impl<'a> BatchReader<'a> {
+    pub fn new(payload: &'a [u8]) -> Self {
+        Self {
+            payload,
+            pos: 0,
+            handle: 0,
+        }
+    }
+
+    /// Byte offset of the next message and the handle it is relative to
+    pub fn position(&self) -> (usize, u32) {
+        (self.pos, self.handle)
+    }
+
+    /// Resume reading from a saved `position()`
+    pub fn resume(payload: &'a [u8], pos: usize, handle: u32) -> Self {
+        Self {
+            payload,
+            pos,
+            handle,
+        }
+    }
+}
+
+impl<'a> Iterator for BatchReader<'a> {
+    type Item = BatchMessage<'a>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let mut pos = self.pos;
+        let code = *self.payload.get(pos)?;
+        pos += 1;
+        let handle = apply_zigzag_delta(self.handle, read_varint(self.payload, &mut pos)?);
+        let size = read_varint(self.payload, &mut pos)? as usize;
+        let body = self.payload.get(pos..pos.checked_add(size)?)?;
+
+        self.pos = pos + size;
+        self.handle = handle;
+        Some(BatchMessage { code, handle, body })
+    }
+}
+
+// =============================================================================
+// FFI Exports
+// =============================================================================
+
+/// Read position within a batch payload, for Platform_Packet_NextBatchMessage
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default)]
+pub struct BatchCursor {
+    /// Byte offset of the next message (start at 0)
+    pub offset: u32,
+    /// Handle of the previous message (start at 0)
+    pub handle: u32,
+}
+
+/// Read the next message from a batch payload
+///
+/// # Arguments
+/// * `payload` - Batch payload (from Platform_Packet_GetPayload)
+/// * `size` - Payload size
+/// * `cursor` - Read position, zeroed before the first call and advanced
+/// * `out_code` - Output: message code
+/// * `out_handle` - Output: message handle
+/// * `out_body_size` - Output: body size
+///
+/// # Returns
+/// * Pointer to the message body (inside `payload`)
+/// * null at the end of the payload, on a malformed message or on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Packet_NextBatchMessage(
+    payload: *const u8,
+    size: i32,
+    cursor: *mut BatchCursor,
+    out_code: *mut u8,
+    out_handle: *mut u32,
+    out_body_size: *mut i32,
+) -> *const u8 {
+    if payload.is_null() || size <= 0 || cursor.is_null() {
+        return std::ptr::null();
+    }
+
+    let slice = std::slice::from_raw_parts(payload, size as usize);
+    let mut reader = BatchReader::resume(slice, (*cursor).offset as usize, (*cursor).handle);
+    let message = match reader.next() {
+        Some(message) => message,
+        None => return std::ptr::null(),
+    };
+
+    let (offset, handle) = reader.position();
+    (*cursor).offset = offset as u32;
+    (*cursor).handle = handle;
+
+    if !out_code.is_null() {
+        *out_code = message.code;
+    }
+    if !out_handle.is_null() {
+        *out_handle = message.handle;
+    }
+    if !out_body_size.is_null() {
+        *out_body_size = message.body.len() as i32;
+    }
+    message.body.as_ptr()
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn drain_all(batcher: &mut MessageBatcher) -> Vec<(u8, Vec<u8>)> {
+        let mut out = Vec::new();
+        batcher.drain(|channel, datagram| out.push((channel, datagram.to_vec())));
+        out
+    }
+
+    #[test]
+    fn test_varint_round_trip() {
+        for &value in &[0u32, 1, 127, 128, 300, 16384, u32::MAX] {
+            let mut bytes = Vec::new();
+            write_varint(&mut bytes, value);
+            let mut pos = 0;
+            assert_eq!(read_varint(&bytes, &mut pos), Some(value));
+            assert_eq!(pos, bytes.len());
+        }
+        assert_eq!(read_varint(&[0x80, 0x80], &mut 0), None);
+    }
+
+    #[test]
+    fn test_zigzag_delta() {
+        for &(prev, handle) in &[(0u32, 0u32), (10, 11), (11, 10), (0, u32::MAX), (u32::MAX, 0)] {
+            assert_eq!(apply_zigzag_delta(prev, zigzag_delta(prev, handle)), handle);
+        }
+        assert_eq!(zigzag_delta(100, 101), 2);
+        assert_eq!(zigzag_delta(101, 100), 1);
+    }
+
+    #[test]
+    fn test_one_datagram_per_channel() {
+        let mut batcher = MessageBatcher::new();
+        assert!(batcher.push(0, 30, 500, b"move"));
+        assert!(batcher.push(0, 30, 501, b"move"));
+        assert!(batcher.push(1, 32, 0, b"sync"));
+        assert!(!batcher.push(BATCH_CHANNELS as u8, 30, 0, b"bad"));
+        assert_eq!(batcher.message_count(), 3);
+
+        let datagrams = drain_all(&mut batcher);
+        assert!(batcher.is_empty());
+        assert_eq!(datagrams.len(), 2);
+        assert_eq!(datagrams[0].0, 0);
+        assert_eq!(datagrams[1].0, 1);
+
+        let payload = &datagrams[0].1[GamePacketHeader::SIZE..];
+        let messages: Vec<_> = BatchReader::new(payload).collect();
+        assert_eq!(messages.len(), 2);
+        assert_eq!(messages[0], BatchMessage { code: 30, handle: 500, body: b"move" });
+        assert_eq!(messages[1].handle, 501);
+
+        // Second handle costs one byte: code, delta, length, body
+        assert_eq!(payload.len(), (1 + 2 + 1 + 4) + (1 + 1 + 1 + 4));
+    }
+
+    #[test]
+    fn test_splits_at_datagram_size() {
+        let mut batcher = MessageBatcher::new();
+        let body = [7u8; 100];
+        for handle in 0..40 {
+            batcher.push(0, 30, handle, &body);
+        }
+
+        let datagrams = drain_all(&mut batcher);
+        assert!(datagrams.len() > 1);
+        let mut handle = 0;
+        for (_, datagram) in &datagrams {
+            assert!(datagram.len() <= MAX_DATAGRAM_SIZE);
+            for message in BatchReader::new(&datagram[GamePacketHeader::SIZE..]) {
+                assert_eq!(message.handle, handle);
+                assert_eq!(message.body, &body[..]);
+                handle += 1;
+            }
+        }
+        assert_eq!(handle, 40);
+    }
+
+    #[test]
+    fn test_oversized_message_gets_own_datagram() {
+        let mut batcher = MessageBatcher::new();
+        let big = vec![1u8; MAX_DATAGRAM_SIZE * 2];
+        batcher.push(0, 21, 0, b"small");
+        batcher.push(0, 21, 0, &big);
+        batcher.push(0, 21, 0, b"small");
+
+        let datagrams = drain_all(&mut batcher);
+        assert_eq!(datagrams.len(), 3);
+        let message = BatchReader::new(&datagrams[1].1[GamePacketHeader::SIZE..])
+            .next()
+            .unwrap();
+        assert_eq!(message.body.len(), big.len());
+    }
+
+    #[test]
+    fn test_reader_stops_on_truncation() {
+        let mut batcher = MessageBatcher::new();
+        batcher.push(0, 30, 1, b"abcdef");
+        let datagram = drain_all(&mut batcher).remove(0).1;
+        let payload = &datagram[GamePacketHeader::SIZE..datagram.len() - 1];
+        assert_eq!(BatchReader::new(payload).count(), 0);
+    }
+
+    #[test]
+    fn test_ffi_next_message() {
+        let mut batcher = MessageBatcher::new();
+        batcher.push(0, 30, 42, b"one");
+        batcher.push(0, 31, 40, b"two");
+        let datagram = drain_all(&mut batcher).remove(0).1;
+        let payload = &datagram[GamePacketHeader::SIZE..];
+
+        unsafe {
+            let mut cursor = BatchCursor::default();
+            let mut code = 0u8;
+            let mut handle = 0u32;
+            let mut size = 0i32;
+            let mut bodies = Vec::new();
+            loop {
+                let body = Platform_Packet_NextBatchMessage(
+                    payload.as_ptr(),
+                    payload.len() as i32,
+                    &mut cursor,
+                    &mut code,
+                    &mut handle,
+                    &mut size,
+                );
+                if body.is_null() {
+                    break;
+                }
+                bodies.push((code, handle, std::slice::from_raw_parts(body, size as usize)));
+            }
+            assert_eq!(bodies, vec![(30, 42, &b"one"[..]), (31, 40, &b"two"[..])]);
+
+            assert!(Platform_Packet_NextBatchMessage(
+                std::ptr::null(),
+                0,
+                &mut cursor,
+                std::ptr::null_mut(),
+                std::ptr::null_mut(),
+                std::ptr::null_mut()
+            )
+            .is_null());
+        }
+    }
+}
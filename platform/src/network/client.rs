@@ -5,9 +5,9 @@
 //! - Sends packets to server
 //! - Receives packets from server
 
+use super::receive_arena::{PacketView, ReceiveArena};
 use super::{NetworkError, NetworkResult, ENET_HANDLE};
 use enet::{Address, BandwidthLimit, ChannelLimit, Event, Host, Packet, PacketMode};
-use std::collections::VecDeque;
 use std::net::Ipv4Addr;
 use std::time::{Duration, Instant};
 
@@ -72,8 +72,8 @@ pub enum ClientEvent {
 pub struct PlatformClient {
     /// The underlying enet host (in client mode)
     host: Host<()>,
-    /// Queue of received packets
-    received_packets: VecDeque<Vec<u8>>,
+    /// Received packets
+    received_packets: ReceiveArena,
     /// Current connection state
     state: ClientState,
     /// Last event for FFI
@@ -135,7 +135,7 @@ impl PlatformClient {
 
         Ok(Self {
             host,
-            received_packets: VecDeque::new(),
+            received_packets: ReceiveArena::new(),
             state: ClientState::Disconnected,
             last_event: ClientEvent::None,
             server_address: String::new(),
@@ -274,7 +274,7 @@ impl PlatformClient {
                             ref packet,
                             ..
                         } => {
-                            self.received_packets.push_back(packet.data().to_vec());
+                            self.received_packets.push(0, channel_id, packet.data());
                             self.last_channel = channel_id;
                             self.last_event = ClientEvent::PacketReceived;
                         }
@@ -346,7 +346,33 @@ impl PlatformClient {
     /// * `Some(Vec<u8>)` if a packet is available
     /// * `None` if no packets in queue
     pub fn receive(&mut self) -> Option<Vec<u8>> {
-        self.received_packets.pop_front()
+        self.received_packets.pop().map(|(_, _, data)| data)
+    }
+
+    /// Receive data from server into a caller buffer
+    ///
+    /// # Returns
+    /// * `Some(bytes copied)` if a packet was available (truncated to fit)
+    /// * `None` if no packets in queue
+    pub fn receive_into(&mut self, buffer: &mut [u8]) -> Option<usize> {
+        self.received_packets
+            .pop_into(buffer)
+            .map(|(copied, _, _)| copied)
+    }
+
+    /// Receive waiting packets as views into the receive arena
+    ///
+    /// Views stay valid until `release_batch()`; see `ReceiveArena`.
+    ///
+    /// # Returns
+    /// Number of views written to `out`
+    pub fn receive_batch(&mut self, out: &mut [PacketView]) -> usize {
+        self.received_packets.receive_batch(out)
+    }
+
+    /// Release the packets handed out by `receive_batch()`
+    pub fn release_batch(&mut self) {
+        self.received_packets.release_batch();
     }
 
     /// Check if there are packets waiting
@@ -609,16 +635,51 @@ pub unsafe extern "C" fn Platform_Client_Receive(
         return -1;
     }
 
-    match (*client).receive() {
-        Some(data) => {
-            let copy_size = std::cmp::min(data.len(), buffer_size as usize);
-            std::ptr::copy_nonoverlapping(data.as_ptr(), buffer, copy_size);
-            copy_size as i32
-        }
+    let buffer_slice = std::slice::from_raw_parts_mut(buffer, buffer_size as usize);
+
+    match (*client).receive_into(buffer_slice) {
+        Some(copy_size) => copy_size as i32,
         None => 0,
     }
 }
 
+/// Receive waiting packets without copying them
+///
+/// Fills `packets` with descriptors pointing into the client's receive
+/// arena. The data stays valid until Platform_Client_ReleaseBatch; call
+/// that once per frame after handling the packets. Calling again before
+/// the release continues through the same batch.
+///
+/// # Arguments
+/// * `client` - Client pointer
+/// * `packets` - Descriptor array to fill
+/// * `max_packets` - Capacity of `packets`
+///
+/// # Returns
+/// * Number of descriptors written (0 if no packets)
+/// * -1: error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Client_ReceiveBatch(
+    client: *mut PlatformClient,
+    packets: *mut PacketView,
+    max_packets: i32,
+) -> i32 {
+    if client.is_null() || packets.is_null() || max_packets <= 0 {
+        return -1;
+    }
+
+    let views = std::slice::from_raw_parts_mut(packets, max_packets as usize);
+    (*client).receive_batch(views) as i32
+}
+
+/// Release the packets returned by Platform_Client_ReceiveBatch
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Client_ReleaseBatch(client: *mut PlatformClient) {
+    if !client.is_null() {
+        (*client).release_batch();
+    }
+}
+
 /// Check if client has packets waiting
 #[no_mangle]
 pub unsafe extern "C" fn Platform_Client_HasPackets(client: *mut PlatformClient) -> i32 {
@@ -748,6 +809,13 @@ mod tests {
                 -1
             );
 
+            let mut views = [PacketView::default(); 4];
+            assert_eq!(
+                Platform_Client_ReceiveBatch(std::ptr::null_mut(), views.as_mut_ptr(), 4),
+                -1
+            );
+            Platform_Client_ReleaseBatch(std::ptr::null_mut()); // Should not panic
+
             Platform_Client_Disconnect(std::ptr::null_mut()); // Should not panic
             Platform_Client_Flush(std::ptr::null_mut()); // Should not panic
             Platform_Client_Destroy(std::ptr::null_mut()); // Should not panic
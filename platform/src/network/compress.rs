@@ -0,0 +1,374 @@
+//! Packet payload compression
+//!
+//! Command traffic is small and repetitive: fixed-layout command headers
+//! full of zero high bytes, runs of adjacent unit handles, and the same
+//! frame number and target repeated across a batch. A general-purpose
+//! compressor's framing would eat most of the gain on a 40-byte payload,
+//! so this is a minimal LZ77 in the style of an LZ4 block, primed with a
+//! tiny static dictionary of those patterns so that even the first bytes
+//! of a payload can find a match:
+//!
+//! ```text
+//! sequence*: token | literal length ext* | literals | offset (u16) | match length ext*
+//! token:     high nibble = literal length, low nibble = match length - MIN_MATCH
+//! ```
+//!
+//! A nibble of 15 continues in extension bytes, each added to it, 255
+//! meaning another follows. The last sequence carries literals only.
+//! Offsets count back from the current output position through the
+//! output and then the dictionary.
+//!
+//! A compressed packet has PACKET_FLAG_COMPRESSED set in its header and
+//! its payload replaced. The sender only sets it when the payload gets
+//! smaller, so anything that doesn't compress goes out raw.
+
+use super::packet::{GamePacketHeader, PACKET_FLAG_COMPRESSED};
+
+/// Shortest match worth an offset
+pub(crate) const MIN_MATCH: usize = 4;
+
+/// Largest payload decompress_payload() will produce
+pub(crate) const MAX_DECOMPRESSED_SIZE: usize = 64 * 1024;
+
+/// Farthest back a match can reach
+const MAX_OFFSET: usize = u16::MAX as usize;
+
+const HASH_BITS: u32 = 12;
+const NO_POSITION: u32 = u32::MAX;
+
+/// Byte patterns common in command payloads: zero high bytes and empty
+/// fields, adjacent-handle deltas, and -1 / all-ones fields. Both ends
+/// must agree on it, so changing it is a protocol change.
+pub static PAYLOAD_DICTIONARY: [u8; 32] = [
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+];
+
+fn hash(bytes: &[u8]) -> usize {
+    let value = u32::from_le_bytes([bytes[0], bytes[1], bytes[2], bytes[3]]);
+    (value.wrapping_mul(2_654_435_761) >> (32 - HASH_BITS)) as usize
+}
+
+fn write_length(out: &mut Vec<u8>, mut length: usize) {
+    while length >= 255 {
+        out.push(255);
+        length -= 255;
+    }
+    out.push(length as u8);
+}
+
+fn read_length(nibble: u8, data: &[u8], pos: &mut usize) -> Option<usize> {
+    let mut length = nibble as usize;
+    if nibble == 15 {
+        loop {
+            let byte = *data.get(*pos)?;
+            *pos += 1;
+            length += byte as usize;
+            if byte != 255 {
+                break;
+            }
+        }
+    }
+    Some(length)
+}
+
+fn write_sequence(out: &mut Vec<u8>, literals: &[u8], matched: Option<(usize, usize)>) {
+    let literal_code = literals.len();
+    let match_code = matched.map_or(0, |(_, length)| length - MIN_MATCH);
+    out.push(((literal_code.min(15) as u8) << 4) | match_code.min(15) as u8);
+    if literal_code >= 15 {
+        write_length(out, literal_code - 15);
+    }
+    out.extend_from_slice(literals);
+    if let Some((offset, _)) = matched {
+        out.extend_from_slice(&(offset as u16).to_le_bytes());
+        if match_code >= 15 {
+            write_length(out, match_code - 15);
+        }
+    }
+}
+
+// =============================================================================
+// PayloadCompressor
+// =============================================================================
+
+/// Greedy single-probe compressor; keeps its buffers between packets
+#[derive(Debug)]
+pub struct PayloadCompressor {
+    /// Dictionary followed by the payload being compressed
+    window: Vec<u8>,
+    /// Last window position seen for each 4-byte hash
+    table: Vec<u32>,
+}
+
+impl PayloadCompressor {
+    /// Create a compressor
+    pub fn new() -> Self {
+        Self {
+            window: Vec::new(),
+            table: vec![NO_POSITION; 1 << HASH_BITS],
+        }
+    }
+
+    /// Compress `input`, appending to `out`
+    ///
+    /// # Returns
+    /// `false`, with `out` as it was, if the result would not be smaller
+    pub fn compress(&mut self, input: &[u8], out: &mut Vec<u8>) -> bool {
+        if input.len() <= MIN_MATCH || input.len() > MAX_DECOMPRESSED_SIZE {
+            return false;
+        }
+
+        let Self { window, table } = self;
+        window.clear();
+        window.extend_from_slice(&PAYLOAD_DICTIONARY);
+        window.extend_from_slice(input);
+        table.fill(NO_POSITION);
+
+        let start = out.len();
+        let end = window.len();
+        let last_match = end - MIN_MATCH;
+        for pos in 0..=PAYLOAD_DICTIONARY.len() - MIN_MATCH {
+            table[hash(&window[pos..])] = pos as u32;
+        }
+
+        let mut pos = PAYLOAD_DICTIONARY.len();
+        let mut literal_start = pos;
+        while pos <= last_match {
+            let slot = hash(&window[pos..]);
+            let candidate = table[slot];
+            table[slot] = pos as u32;
+
+            let candidate = candidate as usize;
+            if candidate == NO_POSITION as usize
+                || pos - candidate > MAX_OFFSET
+                || window[candidate..candidate + MIN_MATCH] != window[pos..pos + MIN_MATCH]
+            {
+                pos += 1;
+                continue;
+            }
+
+            let mut length = MIN_MATCH;
+            while pos + length < end && window[candidate + length] == window[pos + length] {
+                length += 1;
+            }
+            write_sequence(out, &window[literal_start..pos], Some((pos - candidate, length)));
+            for inside in pos + 1..(pos + length).min(last_match + 1) {
+                table[hash(&window[inside..])] = inside as u32;
+            }
+            pos += length;
+            literal_start = pos;
+
+            if out.len() - start >= input.len() {
+                out.truncate(start);
+                return false;
+            }
+        }
+        write_sequence(out, &window[literal_start..], None);
+
+        if out.len() - start >= input.len() {
+            out.truncate(start);
+            return false;
+        }
+        true
+    }
+}
+
+impl Default for PayloadCompressor {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Decompress a payload written by PayloadCompressor, appending to `out`
+///
+/// # Returns
+/// `false`, with `out` as it was, if `input` is malformed or would
+/// decompress past MAX_DECOMPRESSED_SIZE
+pub fn decompress_payload(input: &[u8], out: &mut Vec<u8>) -> bool {
+    let start = out.len();
+    if decompress_into(input, out, start).is_some() {
+        true
+    } else {
+        out.truncate(start);
+        false
+    }
+}
+
+fn decompress_into(input: &[u8], out: &mut Vec<u8>, start: usize) -> Option<()> {
+    let dictionary = PAYLOAD_DICTIONARY.len();
+    let mut pos = 0;
+    loop {
+        let token = *input.get(pos)?;
+        pos += 1;
+
+        let literal_length = read_length(token >> 4, input, &mut pos)?;
+        let literals = input.get(pos..pos.checked_add(literal_length)?)?;
+        if out.len() - start + literal_length > MAX_DECOMPRESSED_SIZE {
+            return None;
+        }
+        out.extend_from_slice(literals);
+        pos += literal_length;
+        if pos == input.len() {
+            return Some(());
+        }
+
+        let offset = u16::from_le_bytes([*input.get(pos)?, *input.get(pos + 1)?]) as usize;
+        pos += 2;
+        let length = read_length(token & 0x0F, input, &mut pos)? + MIN_MATCH;
+        let produced = out.len() - start;
+        if offset == 0 || offset > dictionary + produced || produced + length > MAX_DECOMPRESSED_SIZE {
+            return None;
+        }
+
+        // Byte at a time: a match may overlap the bytes it produces
+        let mut from = dictionary + produced - offset;
+        for _ in 0..length {
+            let byte = if from < dictionary {
+                PAYLOAD_DICTIONARY[from]
+            } else {
+                out[start + from - dictionary]
+            };
+            out.push(byte);
+            from += 1;
+        }
+    }
+}
+
+// =============================================================================
+// Whole packets
+// =============================================================================
+
+/// Write `packet` to `out` with its payload compressed and the header
+/// flagged
+///
+/// # Returns
+/// `false` if the packet has no valid header or its payload doesn't
+/// shrink; send `packet` as it is then
+pub fn compress_packet(compressor: &mut PayloadCompressor, packet: &[u8], out: &mut Vec<u8>) -> bool {
+    let mut header = match GamePacketHeader::from_bytes(packet) {
+        Some(header) if header.is_valid() && header.flags & PACKET_FLAG_COMPRESSED == 0 => header,
+        _ => return false,
+    };
+    header.flags |= PACKET_FLAG_COMPRESSED;
+
+    out.clear();
+    out.extend_from_slice(&header.to_bytes());
+    compressor.compress(&packet[GamePacketHeader::SIZE..], out)
+}
+
+/// Write a flagged packet to `out` with its payload restored and the
+/// flag cleared
+///
+/// # Returns
+/// `false` if the packet is not compressed or its payload is corrupt
+pub fn decompress_packet(packet: &[u8], out: &mut Vec<u8>) -> bool {
+    let mut header = match GamePacketHeader::from_bytes(packet) {
+        Some(header) if header.is_valid() && header.flags & PACKET_FLAG_COMPRESSED != 0 => header,
+        _ => return false,
+    };
+    header.flags &= !PACKET_FLAG_COMPRESSED;
+
+    out.clear();
+    out.extend_from_slice(&header.to_bytes());
+    decompress_payload(&packet[GamePacketHeader::SIZE..], out)
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::network::packet::{serialize_packet, GamePacketCode};
+
+    /// Three move orders in the CommandPacket wire layout, as one batch
+    fn command_batch() -> Vec<u8> {
+        let mut payload = Vec::new();
+        for unit in 0..3u32 {
+            payload.extend_from_slice(&[1, 1, 0, 0]);
+            payload.extend_from_slice(&1200u32.to_le_bytes());
+            payload.extend_from_slice(&240u32.to_le_bytes());
+            payload.extend_from_slice(&288u32.to_le_bytes());
+            payload.extend_from_slice(&[10, 0, 12, 0, 0, 0, 0, 0, 4, 0]);
+            payload.extend_from_slice(&[(2000 + unit * 4) as u8, 1, 1, 1]);
+        }
+        payload
+    }
+
+    #[test]
+    fn test_round_trip() {
+        let payload = command_batch();
+        let mut compressor = PayloadCompressor::new();
+        let mut packed = vec![0xAA];
+        assert!(compressor.compress(&payload, &mut packed));
+        assert!(packed.len() - 1 < payload.len() * 2 / 3);
+
+        let mut unpacked = vec![0xBB];
+        assert!(decompress_payload(&packed[1..], &mut unpacked));
+        assert_eq!(&unpacked[1..], &payload[..]);
+    }
+
+    #[test]
+    fn test_long_runs_and_literals() {
+        let mut payload = vec![0u8; 700];
+        payload.extend((0..300u32).map(|i| (i * 7 + i / 3) as u8));
+        let mut compressor = PayloadCompressor::new();
+        let mut packed = Vec::new();
+        assert!(compressor.compress(&payload, &mut packed));
+
+        let mut unpacked = Vec::new();
+        assert!(decompress_payload(&packed, &mut unpacked));
+        assert_eq!(unpacked, payload);
+    }
+
+    #[test]
+    fn test_incompressible_stays_raw() {
+        let payload: Vec<u8> = (0..64u32).map(|i| (i * 37 + 11) as u8).collect();
+        let mut compressor = PayloadCompressor::new();
+        let mut packed = vec![1, 2, 3];
+        assert!(!compressor.compress(&payload, &mut packed));
+        assert_eq!(packed, [1, 2, 3]);
+        assert!(!compressor.compress(b"abc", &mut packed));
+    }
+
+    #[test]
+    fn test_corrupt_input_rejected() {
+        let mut compressor = PayloadCompressor::new();
+        let mut packed = Vec::new();
+        assert!(compressor.compress(&command_batch(), &mut packed));
+
+        let mut out = vec![9];
+        assert!(!decompress_payload(&packed[..packed.len() - 3], &mut out));
+        assert_eq!(out, [9]);
+        // A match reaching back past the dictionary
+        assert!(!decompress_payload(&[0x00, 0xFF, 0x00], &mut out));
+        assert!(!decompress_payload(&[], &mut out));
+        assert_eq!(out, [9]);
+    }
+
+    #[test]
+    fn test_packet_flag() {
+        let header = GamePacketHeader::new(GamePacketCode::MessageBatch, 7, 2);
+        let packet = serialize_packet(&header, &command_batch());
+        let mut compressor = PayloadCompressor::new();
+
+        let mut wire = Vec::new();
+        assert!(compress_packet(&mut compressor, &packet, &mut wire));
+        assert!(wire.len() < packet.len());
+        let parsed = GamePacketHeader::from_bytes(&wire).unwrap();
+        assert_eq!(parsed.flags, PACKET_FLAG_COMPRESSED);
+        assert_eq!(parsed.sequence, 7);
+
+        let mut restored = Vec::new();
+        assert!(decompress_packet(&wire, &mut restored));
+        assert_eq!(restored, packet);
+
+        // Raw packets are left alone, and don't compress twice
+        assert!(!decompress_packet(&packet, &mut restored));
+        assert!(!compress_packet(&mut compressor, &wire, &mut restored));
+    }
+}
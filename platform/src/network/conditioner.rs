@@ -0,0 +1,544 @@
+//! Network conditioner for testing under bad links
+//!
+//! Sits between a socket and whoever reads from it and makes a clean link
+//! behave like a poor one: every packet is held for the configured
+//! latency plus random jitter, some are lost, some are held back long
+//! enough to arrive after later ones, and a bandwidth cap makes packets
+//! queue behind each other the way they would on a slow uplink.
+//!
+//! Reliable packets are never lost outright. enet would resend them, so a
+//! "lost" reliable packet arrives a retransmit timeout late instead, and
+//! reliable packets on a channel keep their order, as enet delivers them.
+//! Unreliable packets are the ones dropped and reordered.
+//!
+//! Time is passed in rather than read, so tests and benchmarks can run
+//! the conditioner on a simulated clock. Randomness comes from a seeded
+//! generator, so a run with the same seed and the same traffic loses and
+//! delays the same packets.
+//!
+//! `NetworkManager::set_conditions` applies a conditioner to everything a
+//! session receives; `Platform_Conditioner_*` exposes a standalone one
+//! for C++ tests that move packets between simulated peers themselves.
+
+use std::cmp::Ordering;
+use std::collections::BinaryHeap;
+
+/// Channels whose reliable order is tracked; higher ones share the last
+pub(crate) const CONDITIONER_CHANNELS: usize = 8;
+
+/// Shortest delay a "lost" reliable packet is given (enet's resend floor)
+const MIN_RETRANSMIT_US: u64 = 50_000;
+
+/// Resends after which a reliable packet is assumed through
+const MAX_RETRANSMITS: u32 = 8;
+
+/// Extra hold for a reordered packet when there is no jitter to go by
+const MIN_REORDER_HOLD_US: u64 = 10_000;
+
+/// Backlog behind the bandwidth cap beyond which unreliable packets are
+/// dropped, like a full router queue
+const MAX_BACKLOG_US: u64 = 500_000;
+
+/// Link conditions to simulate (all zero = a perfect link)
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct NetConditions {
+    /// One-way delay added to every packet
+    pub latency_ms: u32,
+    /// Random extra delay, up to this much, per packet
+    pub jitter_ms: u32,
+    /// Chance a packet is lost, in percent
+    pub loss_percent: u32,
+    /// Chance an unreliable packet is held back past later ones, in percent
+    pub reorder_percent: u32,
+    /// Link speed in kilobits per second (0 = unlimited)
+    pub bandwidth_kbps: u32,
+    /// Random seed (0 picks a fixed default)
+    pub seed: u32,
+}
+
+impl NetConditions {
+    /// Whether these conditions change anything
+    pub fn is_perfect(&self) -> bool {
+        self.latency_ms == 0
+            && self.jitter_ms == 0
+            && self.loss_percent == 0
+            && self.reorder_percent == 0
+            && self.bandwidth_kbps == 0
+    }
+}
+
+/// What a conditioner did to the traffic through it
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ConditionerStats {
+    /// Packets submitted
+    pub packets_in: u64,
+    /// Packets handed back out
+    pub packets_out: u64,
+    /// Bytes handed back out
+    pub bytes_out: u64,
+    /// Unreliable packets lost, or dropped at a full bandwidth backlog
+    pub dropped: u64,
+    /// Reliable packets delayed by a simulated resend
+    pub retransmitted: u64,
+    /// Unreliable packets held back past later ones
+    pub reordered: u64,
+    /// Packets waiting to be released
+    pub queued: u32,
+}
+
+/// A packet waiting for its release time
+struct HeldPacket<T> {
+    release_us: u64,
+    /// Submission order, so packets due at once come out in order
+    order: u64,
+    item: T,
+}
+
+impl<T> PartialEq for HeldPacket<T> {
+    fn eq(&self, other: &Self) -> bool {
+        self.release_us == other.release_us && self.order == other.order
+    }
+}
+
+impl<T> Eq for HeldPacket<T> {}
+
+impl<T> PartialOrd for HeldPacket<T> {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl<T> Ord for HeldPacket<T> {
+    /// Reversed, so the heap's top is the packet due first
+    fn cmp(&self, other: &Self) -> Ordering {
+        (other.release_us, other.order).cmp(&(self.release_us, self.order))
+    }
+}
+
+/// Delays, drops and reorders packets of type `T`
+pub struct NetConditioner<T> {
+    conditions: NetConditions,
+    rng: u32,
+    held: BinaryHeap<HeldPacket<T>>,
+    next_order: u64,
+    /// When the simulated link finishes sending what it has been given
+    link_free_us: u64,
+    /// Release time of the last reliable packet, per channel
+    reliable_release_us: [u64; CONDITIONER_CHANNELS],
+    stats: ConditionerStats,
+}
+
+impl<T> NetConditioner<T> {
+    /// Create a conditioner simulating `conditions`
+    pub fn new(conditions: NetConditions) -> Self {
+        let mut conditioner = Self {
+            conditions,
+            rng: 0,
+            held: BinaryHeap::new(),
+            next_order: 0,
+            link_free_us: 0,
+            reliable_release_us: [0; CONDITIONER_CHANNELS],
+            stats: ConditionerStats::default(),
+        };
+        conditioner.set_conditions(conditions);
+        conditioner
+    }
+
+    /// Change the simulated conditions
+    ///
+    /// Packets already held keep the release times they were given.
+    pub fn set_conditions(&mut self, conditions: NetConditions) {
+        self.conditions = conditions;
+        self.rng = if conditions.seed != 0 { conditions.seed } else { 0x9E37_79B9 };
+    }
+
+    pub fn conditions(&self) -> NetConditions {
+        self.conditions
+    }
+
+    pub fn stats(&self) -> ConditionerStats {
+        ConditionerStats {
+            queued: self.held.len() as u32,
+            ..self.stats
+        }
+    }
+
+    /// Packets waiting to be released
+    pub fn queued(&self) -> usize {
+        self.held.len()
+    }
+
+    /// Take a packet of `size` bytes arriving at `now_us`
+    ///
+    /// Returns false if the packet was lost; it will never come out.
+    pub fn submit(&mut self, now_us: u64, item: T, size: usize, channel: u8, reliable: bool) -> bool {
+        self.stats.packets_in += 1;
+        let c = self.conditions;
+
+        // The link sends one packet at a time, so a cap makes packets queue
+        let mut release_us = now_us;
+        if c.bandwidth_kbps > 0 {
+            let start_us = self.link_free_us.max(now_us);
+            if !reliable && start_us - now_us > MAX_BACKLOG_US {
+                self.stats.dropped += 1;
+                return false;
+            }
+            let send_us = (size as u64 * 8_000) / c.bandwidth_kbps as u64;
+            self.link_free_us = start_us + send_us;
+            release_us = self.link_free_us;
+        }
+
+        release_us += c.latency_ms as u64 * 1000;
+        if c.jitter_ms > 0 {
+            release_us += self.next_random() as u64 % (c.jitter_ms as u64 * 1000 + 1);
+        }
+
+        if self.roll(c.loss_percent) {
+            if !reliable {
+                self.stats.dropped += 1;
+                return false;
+            }
+            // Resent after a timeout, possibly more than once
+            let timeout_us = (c.latency_ms as u64 * 2000).max(MIN_RETRANSMIT_US);
+            let mut resends = 1;
+            while resends < MAX_RETRANSMITS && self.roll(c.loss_percent) {
+                resends += 1;
+            }
+            release_us += timeout_us * resends as u64;
+            self.stats.retransmitted += 1;
+        }
+
+        if reliable {
+            let slot = &mut self.reliable_release_us[(channel as usize).min(CONDITIONER_CHANNELS - 1)];
+            release_us = release_us.max(*slot);
+            *slot = release_us;
+        } else if self.roll(c.reorder_percent) {
+            release_us += (c.jitter_ms as u64 * 1000).max(MIN_REORDER_HOLD_US);
+            self.stats.reordered += 1;
+        }
+
+        self.held.push(HeldPacket {
+            release_us,
+            order: self.next_order,
+            item,
+        });
+        self.next_order += 1;
+        true
+    }
+
+    /// Next packet whose release time has come, if any
+    pub fn pop_due(&mut self, now_us: u64) -> Option<T> {
+        if self.held.peek()?.release_us > now_us {
+            return None;
+        }
+        self.stats.packets_out += 1;
+        self.held.pop().map(|held| held.item)
+    }
+
+    /// Count bytes handed out (the conditioner doesn't know `T`'s size)
+    pub fn count_out(&mut self, bytes: usize) {
+        self.stats.bytes_out += bytes as u64;
+    }
+
+    /// When the next packet is due, if any is held
+    pub fn next_release_us(&self) -> Option<u64> {
+        self.held.peek().map(|held| held.release_us)
+    }
+
+    /// Hand back every held packet at once, in release order
+    pub fn drain(&mut self) -> Vec<T> {
+        let mut items = Vec::with_capacity(self.held.len());
+        while let Some(held) = self.held.pop() {
+            items.push(held.item);
+        }
+        self.stats.packets_out += items.len() as u64;
+        self.link_free_us = 0;
+        self.reliable_release_us = [0; CONDITIONER_CHANNELS];
+        items
+    }
+
+    /// Forget every held packet
+    pub fn clear(&mut self) {
+        self.held.clear();
+        self.link_free_us = 0;
+        self.reliable_release_us = [0; CONDITIONER_CHANNELS];
+    }
+
+    fn roll(&mut self, percent: u32) -> bool {
+        percent > 0 && self.next_random() % 100 < percent
+    }
+
+    /// xorshift32
+    fn next_random(&mut self) -> u32 {
+        let mut x = self.rng;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        self.rng = x;
+        x
+    }
+}
+
+// =============================================================================
+// FFI
+// =============================================================================
+
+/// Standalone conditioner for C++ tests: packets go in with a time, come
+/// out once due
+pub struct PacketConditioner(NetConditioner<(u8, Vec<u8>)>);
+
+/// Create a conditioner; null conditions mean a perfect link
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_Create(
+    conditions: *const NetConditions,
+) -> *mut PacketConditioner {
+    let conditions = conditions.as_ref().copied().unwrap_or_default();
+    Box::into_raw(Box::new(PacketConditioner(NetConditioner::new(conditions))))
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_Destroy(conditioner: *mut PacketConditioner) {
+    if !conditioner.is_null() {
+        drop(Box::from_raw(conditioner));
+    }
+}
+
+/// Change the simulated conditions; held packets keep their release times
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_SetConditions(
+    conditioner: *mut PacketConditioner,
+    conditions: *const NetConditions,
+) {
+    if let (Some(conditioner), Some(conditions)) = (conditioner.as_mut(), conditions.as_ref()) {
+        conditioner.0.set_conditions(*conditions);
+    }
+}
+
+/// Put a packet on the simulated link at `now_us`
+///
+/// Returns 0 if it will be delivered, 1 if it was lost, -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_Submit(
+    conditioner: *mut PacketConditioner,
+    now_us: u64,
+    channel: u8,
+    data: *const u8,
+    size: i32,
+    reliable: i32,
+) -> i32 {
+    if conditioner.is_null() || data.is_null() || size < 0 {
+        return -1;
+    }
+    let bytes = std::slice::from_raw_parts(data, size as usize).to_vec();
+    let delivered = (*conditioner).0.submit(now_us, (channel, bytes), size as usize, channel, reliable != 0);
+    if delivered {
+        0
+    } else {
+        1
+    }
+}
+
+/// Take the next packet due by `now_us`
+///
+/// Returns its size (0 if none is due), or -1 on error or if `buffer` is
+/// too small; a packet that doesn't fit is dropped.
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_Receive(
+    conditioner: *mut PacketConditioner,
+    now_us: u64,
+    buffer: *mut u8,
+    buffer_size: i32,
+    channel: *mut u8,
+) -> i32 {
+    if conditioner.is_null() || buffer.is_null() || buffer_size < 0 {
+        return -1;
+    }
+    let conditioner = &mut (*conditioner).0;
+    let Some((packet_channel, bytes)) = conditioner.pop_due(now_us) else {
+        return 0;
+    };
+    if bytes.len() > buffer_size as usize {
+        return -1;
+    }
+    std::ptr::copy_nonoverlapping(bytes.as_ptr(), buffer, bytes.len());
+    if !channel.is_null() {
+        *channel = packet_channel;
+    }
+    conditioner.count_out(bytes.len());
+    bytes.len() as i32
+}
+
+/// Time the next held packet is due, or 0 if none is held
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_NextRelease(conditioner: *mut PacketConditioner) -> u64 {
+    conditioner
+        .as_ref()
+        .and_then(|c| c.0.next_release_us())
+        .unwrap_or(0)
+}
+
+/// Returns 0 on success, -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Conditioner_GetStats(
+    conditioner: *mut PacketConditioner,
+    stats: *mut ConditionerStats,
+) -> i32 {
+    match (conditioner.as_ref(), stats.as_mut()) {
+        (Some(conditioner), Some(stats)) => {
+            *stats = conditioner.0.stats();
+            0
+        }
+        _ => -1,
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn conditions(latency_ms: u32, jitter_ms: u32, loss: u32, reorder: u32, kbps: u32) -> NetConditions {
+        NetConditions {
+            latency_ms,
+            jitter_ms,
+            loss_percent: loss,
+            reorder_percent: reorder,
+            bandwidth_kbps: kbps,
+            seed: 1234,
+        }
+    }
+
+    fn drain_at(conditioner: &mut NetConditioner<u32>, now_us: u64) -> Vec<u32> {
+        let mut out = Vec::new();
+        while let Some(item) = conditioner.pop_due(now_us) {
+            out.push(item);
+        }
+        out
+    }
+
+    #[test]
+    fn test_perfect_link_passes_through() {
+        let mut conditioner = NetConditioner::new(NetConditions::default());
+        assert!(conditioner.conditions().is_perfect());
+        for i in 0..10 {
+            assert!(conditioner.submit(100, i, 64, 1, false));
+        }
+        assert_eq!(drain_at(&mut conditioner, 100), (0..10).collect::<Vec<_>>());
+        assert_eq!(conditioner.stats().dropped, 0);
+    }
+
+    #[test]
+    fn test_latency_holds_packets() {
+        let mut conditioner = NetConditioner::new(conditions(50, 0, 0, 0, 0));
+        assert!(conditioner.submit(1_000, 7u32, 64, 0, true));
+        assert_eq!(conditioner.next_release_us(), Some(51_000));
+        assert_eq!(conditioner.pop_due(50_999), None);
+        assert_eq!(conditioner.pop_due(51_000), Some(7));
+    }
+
+    #[test]
+    fn test_jitter_stays_in_range() {
+        let mut conditioner = NetConditioner::new(conditions(20, 10, 0, 0, 0));
+        for i in 0..200 {
+            conditioner.submit(0, i, 32, 1, false);
+        }
+        assert!(drain_at(&mut conditioner, 19_999).is_empty());
+        assert_eq!(drain_at(&mut conditioner, 30_000).len(), 200);
+    }
+
+    #[test]
+    fn test_loss_drops_unreliable_only() {
+        let mut conditioner = NetConditioner::new(conditions(10, 0, 30, 0, 0));
+        let mut lost = 0;
+        for i in 0..1000 {
+            if !conditioner.submit(0, i, 32, 1, false) {
+                lost += 1;
+            }
+        }
+        assert!(lost > 200 && lost < 400, "lost {}", lost);
+        assert_eq!(conditioner.stats().dropped, lost);
+
+        // Reliable packets all arrive, some late, still in order
+        let mut conditioner = NetConditioner::new(conditions(10, 0, 30, 0, 0));
+        for i in 0..100 {
+            assert!(conditioner.submit(i as u64 * 1000, i, 32, 0, true));
+        }
+        assert!(conditioner.stats().retransmitted > 0);
+        assert_eq!(drain_at(&mut conditioner, u64::MAX), (0..100).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_reorder_unreliable() {
+        let mut conditioner = NetConditioner::new(conditions(10, 0, 0, 20, 0));
+        for i in 0..100 {
+            conditioner.submit(i as u64 * 1000, i, 32, 1, false);
+        }
+        let out = drain_at(&mut conditioner, u64::MAX);
+        assert_eq!(out.len(), 100);
+        assert!(out.windows(2).any(|w| w[0] > w[1]));
+        assert!(conditioner.stats().reordered > 0);
+    }
+
+    #[test]
+    fn test_bandwidth_queues_packets() {
+        // 80 kbps = 10 bytes per millisecond
+        let mut conditioner = NetConditioner::new(conditions(0, 0, 0, 0, 80));
+        for i in 0..4 {
+            conditioner.submit(0, i, 1000, 0, true);
+        }
+        assert_eq!(drain_at(&mut conditioner, 99_999), Vec::<u32>::new());
+        assert_eq!(drain_at(&mut conditioner, 100_000), vec![0]);
+        assert_eq!(drain_at(&mut conditioner, 400_000), vec![1, 2, 3]);
+
+        // Unreliable packets are dropped once the backlog is too long
+        let mut conditioner = NetConditioner::new(conditions(0, 0, 0, 0, 80));
+        let sent = (0..20).filter(|&i| conditioner.submit(0, i, 1000, 1, false)).count();
+        assert!(sent < 20);
+        assert_eq!(conditioner.stats().dropped, 20 - sent as u64);
+    }
+
+    #[test]
+    fn test_same_seed_same_outcome() {
+        let run = || {
+            let mut conditioner = NetConditioner::new(conditions(30, 20, 10, 10, 0));
+            let lost: Vec<bool> = (0..100).map(|i| conditioner.submit(0, i, 32, 1, false)).collect();
+            (lost, drain_at(&mut conditioner, u64::MAX))
+        };
+        assert_eq!(run(), run());
+    }
+
+    #[test]
+    fn test_ffi_conditioner() {
+        unsafe {
+            let conditions = conditions(5, 0, 0, 0, 0);
+            let conditioner = Platform_Conditioner_Create(&conditions);
+            assert!(!conditioner.is_null());
+
+            let data = [1u8, 2, 3, 4];
+            assert_eq!(Platform_Conditioner_Submit(conditioner, 0, 1, data.as_ptr(), 4, 0), 0);
+            assert_eq!(Platform_Conditioner_NextRelease(conditioner), 5_000);
+
+            let mut buffer = [0u8; 16];
+            let mut channel = 0u8;
+            assert_eq!(Platform_Conditioner_Receive(conditioner, 4_999, buffer.as_mut_ptr(), 16, &mut channel), 0);
+            assert_eq!(Platform_Conditioner_Receive(conditioner, 5_000, buffer.as_mut_ptr(), 16, &mut channel), 4);
+            assert_eq!(&buffer[..4], &data);
+            assert_eq!(channel, 1);
+
+            let mut stats = ConditionerStats::default();
+            assert_eq!(Platform_Conditioner_GetStats(conditioner, &mut stats), 0);
+            assert_eq!((stats.packets_in, stats.packets_out, stats.bytes_out), (1, 1, 4));
+
+            Platform_Conditioner_Destroy(conditioner);
+
+            assert_eq!(Platform_Conditioner_Submit(std::ptr::null_mut(), 0, 0, data.as_ptr(), 4, 0), -1);
+            assert_eq!(Platform_Conditioner_NextRelease(std::ptr::null_mut()), 0);
+            Platform_Conditioner_Destroy(std::ptr::null_mut());
+        }
+    }
+}
@@ -0,0 +1,625 @@
+//! LAN game discovery
+//!
+//! Replaces the original's IPX broadcast game listing. A game being
+//! hosted advertises a compact beacon over UDP multicast and broadcast
+//! about once a second. Browsers send a query the moment they start or
+//! refresh, and advertisers answer it directly, so a lobby fills in
+//! within a round trip rather than a beacon interval. Everything runs on a
+//! `discovery` thread of its own. The lobby only reads the cache, which
+//! never blocks on the network.
+//!
+//! ```text
+//! header:  magic (u32) | kind (u8) | protocol (u8) | instance (u32)
+//! beacon:  version (u32) | map crc (u32) | port (u16) | players (u8) |
+//!          max players (u8) | name length (u8) | name
+//! query:   header only
+//! ```
+//!
+//! The instance token is random per `LanDiscovery`, so a game never lists
+//! its own beacon. Cached games expire when their beacons stop.
+//!
+//! Only one process per machine can hold DISCOVERY_PORT. A second one
+//! binds any free port instead. It still finds games, because answers to
+//! its queries come back to whatever port it sent from. Its own game is
+//! then only seen through its beacons.
+
+use super::{NetworkError, NetworkResult};
+use std::hash::{BuildHasher, Hasher};
+use std::net::{Ipv4Addr, SocketAddrV4, UdpSocket};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread::{self, JoinHandle};
+use std::time::Duration;
+
+/// Port beacons and queries are sent to
+pub const DISCOVERY_PORT: u16 = 5554;
+
+/// Multicast group beacons and queries are sent to (site-local scope)
+pub const DISCOVERY_GROUP: Ipv4Addr = Ipv4Addr::new(239, 255, 82, 65);
+
+/// Games the cache holds
+pub const MAX_DISCOVERED_GAMES: usize = 64;
+
+/// Longest session name carried in a beacon (not counting the NUL)
+pub const MAX_SESSION_NAME: usize = 31;
+
+/// How often advertisers beacon and browsers re-query
+const BEACON_INTERVAL_US: u64 = 1_000_000;
+
+/// A game is dropped after this long without a beacon (three missed)
+const EXPIRY_US: u64 = 3_500_000;
+
+/// Longest the thread waits for a datagram before checking its timers
+const RECEIVE_WAIT: Duration = Duration::from_millis(50);
+
+const DISCOVERY_MAGIC: u32 = 0x5644_4152; // "RADV"
+const DISCOVERY_PROTOCOL: u8 = 1;
+const KIND_BEACON: u8 = 1;
+const KIND_QUERY: u8 = 2;
+const HEADER_SIZE: usize = 10;
+const BEACON_FIXED_SIZE: usize = 13;
+
+/// What a hosted game advertises
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SessionBeacon {
+    /// Session name, NUL-terminated
+    pub name: [u8; MAX_SESSION_NAME + 1],
+    /// CRC of the scenario being played
+    pub map_crc: u32,
+    /// Game build; joining across versions desyncs
+    pub version: u32,
+    /// Port the game is hosted on
+    pub port: u16,
+    /// Players in the session
+    pub players: u8,
+    /// Player slots
+    pub max_players: u8,
+}
+
+impl Default for SessionBeacon {
+    fn default() -> Self {
+        Self {
+            name: [0; MAX_SESSION_NAME + 1],
+            map_crc: 0,
+            version: 0,
+            port: 0,
+            players: 0,
+            max_players: 0,
+        }
+    }
+}
+
+impl SessionBeacon {
+    /// Set the session name (truncated to MAX_SESSION_NAME bytes)
+    pub fn set_name(&mut self, name: &str) {
+        let bytes = name.as_bytes();
+        let len = bytes.len().min(MAX_SESSION_NAME);
+        self.name = [0; MAX_SESSION_NAME + 1];
+        self.name[..len].copy_from_slice(&bytes[..len]);
+    }
+
+    fn name_len(&self) -> usize {
+        self.name.iter().position(|&b| b == 0).unwrap_or(MAX_SESSION_NAME).min(MAX_SESSION_NAME)
+    }
+}
+
+/// A game found on the LAN
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct DiscoveredGame {
+    /// The beacon as last received
+    pub beacon: SessionBeacon,
+    /// Host address in dotted form, NUL-terminated (for JoinGame)
+    pub address: [u8; 16],
+    /// Time since the last beacon, milliseconds
+    pub age_ms: u32,
+}
+
+// =============================================================================
+// Wire format
+// =============================================================================
+
+fn write_header(out: &mut Vec<u8>, kind: u8, instance: u32) {
+    out.extend_from_slice(&DISCOVERY_MAGIC.to_le_bytes());
+    out.push(kind);
+    out.push(DISCOVERY_PROTOCOL);
+    out.extend_from_slice(&instance.to_le_bytes());
+}
+
+fn encode_beacon(out: &mut Vec<u8>, instance: u32, beacon: &SessionBeacon) {
+    out.clear();
+    write_header(out, KIND_BEACON, instance);
+    out.extend_from_slice(&beacon.version.to_le_bytes());
+    out.extend_from_slice(&beacon.map_crc.to_le_bytes());
+    out.extend_from_slice(&beacon.port.to_le_bytes());
+    out.push(beacon.players);
+    out.push(beacon.max_players);
+    let len = beacon.name_len();
+    out.push(len as u8);
+    out.extend_from_slice(&beacon.name[..len]);
+}
+
+fn encode_query(out: &mut Vec<u8>, instance: u32) {
+    out.clear();
+    write_header(out, KIND_QUERY, instance);
+}
+
+/// What a datagram turned out to be
+#[derive(Debug, PartialEq, Eq)]
+enum Message {
+    Beacon(u32, SessionBeacon),
+    Query(u32),
+}
+
+fn decode(data: &[u8]) -> Option<Message> {
+    if data.len() < HEADER_SIZE
+        || u32::from_le_bytes([data[0], data[1], data[2], data[3]]) != DISCOVERY_MAGIC
+        || data[5] != DISCOVERY_PROTOCOL
+    {
+        return None;
+    }
+    let instance = u32::from_le_bytes([data[6], data[7], data[8], data[9]]);
+
+    match data[4] {
+        KIND_QUERY => Some(Message::Query(instance)),
+        KIND_BEACON => {
+            let body = data.get(HEADER_SIZE..HEADER_SIZE + BEACON_FIXED_SIZE)?;
+            let name_len = body[12] as usize;
+            if name_len > MAX_SESSION_NAME {
+                return None;
+            }
+            let name = data.get(HEADER_SIZE + BEACON_FIXED_SIZE..)?.get(..name_len)?;
+
+            let mut beacon = SessionBeacon {
+                version: u32::from_le_bytes([body[0], body[1], body[2], body[3]]),
+                map_crc: u32::from_le_bytes([body[4], body[5], body[6], body[7]]),
+                port: u16::from_le_bytes([body[8], body[9]]),
+                players: body[10],
+                max_players: body[11],
+                ..SessionBeacon::default()
+            };
+            beacon.name[..name_len].copy_from_slice(name);
+            Some(Message::Beacon(instance, beacon))
+        }
+        _ => None,
+    }
+}
+
+// =============================================================================
+// DiscoveryCache
+// =============================================================================
+
+#[derive(Debug, Clone, Copy)]
+struct CacheEntry {
+    instance: u32,
+    address: Ipv4Addr,
+    beacon: SessionBeacon,
+    last_seen_us: u64,
+}
+
+/// Games heard from recently, keyed by the advertiser's instance token
+///
+/// One beacon can arrive by multicast, broadcast and loopback, from
+/// different source addresses; they all count as the same game.
+#[derive(Debug, Default)]
+pub struct DiscoveryCache {
+    entries: Vec<CacheEntry>,
+}
+
+impl DiscoveryCache {
+    /// Record a beacon; a full cache drops it
+    pub fn update(&mut self, instance: u32, address: Ipv4Addr, beacon: &SessionBeacon, now_us: u64) {
+        match self.entries.iter().position(|e| e.instance == instance) {
+            Some(index) => {
+                let entry = &mut self.entries[index];
+                // A routable address is more use to the lobby than loopback
+                if entry.address.is_loopback() {
+                    entry.address = address;
+                }
+                entry.beacon = *beacon;
+                entry.last_seen_us = now_us;
+            }
+            None if self.entries.len() < MAX_DISCOVERED_GAMES => {
+                self.entries.push(CacheEntry {
+                    instance,
+                    address,
+                    beacon: *beacon,
+                    last_seen_us: now_us,
+                });
+            }
+            None => {}
+        }
+    }
+
+    /// Drop games whose beacons have stopped
+    pub fn expire(&mut self, now_us: u64) {
+        self.entries.retain(|e| now_us.saturating_sub(e.last_seen_us) < EXPIRY_US);
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Copy out the live games, oldest first
+    ///
+    /// # Returns
+    /// Games written (at most `out.len()`)
+    pub fn list(&self, now_us: u64, out: &mut [DiscoveredGame]) -> usize {
+        let live = self
+            .entries
+            .iter()
+            .filter(|e| now_us.saturating_sub(e.last_seen_us) < EXPIRY_US);
+        let mut count = 0;
+        for (slot, entry) in out.iter_mut().zip(live) {
+            let text = entry.address.to_string();
+            let mut address = [0u8; 16];
+            address[..text.len()].copy_from_slice(text.as_bytes());
+            *slot = DiscoveredGame {
+                beacon: entry.beacon,
+                address,
+                age_ms: (now_us.saturating_sub(entry.last_seen_us) / 1000) as u32,
+            };
+            count += 1;
+        }
+        count
+    }
+}
+
+// =============================================================================
+// LanDiscovery
+// =============================================================================
+
+/// State shared between the game and the discovery thread
+struct Shared {
+    running: AtomicBool,
+    refresh: AtomicBool,
+    advertised: Mutex<Option<SessionBeacon>>,
+    cache: Mutex<DiscoveryCache>,
+}
+
+fn make_instance_token() -> u32 {
+    let mut hasher = std::collections::hash_map::RandomState::new().build_hasher();
+    hasher.write_u64(crate::input::time_us());
+    (hasher.finish() as u32).max(1)
+}
+
+/// Bind the discovery port, or any port if another process holds it
+fn open_socket() -> std::io::Result<UdpSocket> {
+    let socket = UdpSocket::bind(SocketAddrV4::new(Ipv4Addr::UNSPECIFIED, DISCOVERY_PORT))
+        .or_else(|_| UdpSocket::bind(SocketAddrV4::new(Ipv4Addr::UNSPECIFIED, 0)))?;
+    socket.set_read_timeout(Some(RECEIVE_WAIT))?;
+    // Best effort: a host without multicast routes still has broadcast
+    let _ = socket.set_broadcast(true);
+    let _ = socket.set_multicast_loop_v4(true);
+    let _ = socket.join_multicast_v4(&DISCOVERY_GROUP, &Ipv4Addr::UNSPECIFIED);
+    Ok(socket)
+}
+
+/// Send to the multicast group, the broadcast address and this machine;
+/// any that has no route just fails
+fn send_everywhere(socket: &UdpSocket, data: &[u8]) {
+    let targets = [DISCOVERY_GROUP, Ipv4Addr::BROADCAST, Ipv4Addr::LOCALHOST];
+    for target in targets {
+        let _ = socket.send_to(data, SocketAddrV4::new(target, DISCOVERY_PORT));
+    }
+}
+
+fn run(socket: UdpSocket, shared: Arc<Shared>, instance: u32) {
+    let mut out = Vec::with_capacity(64);
+    let mut buffer = [0u8; 512];
+    let mut next_beacon_us = 0;
+    let mut next_query_us = 0;
+
+    while shared.running.load(Ordering::Acquire) {
+        let now = crate::input::time_us();
+        let advertised = *shared.advertised.lock().unwrap();
+
+        if let Some(ref beacon) = advertised {
+            if now >= next_beacon_us {
+                encode_beacon(&mut out, instance, beacon);
+                send_everywhere(&socket, &out);
+                next_beacon_us = now + BEACON_INTERVAL_US;
+            }
+        }
+        if shared.refresh.swap(false, Ordering::AcqRel) || now >= next_query_us {
+            encode_query(&mut out, instance);
+            send_everywhere(&socket, &out);
+            next_query_us = now + BEACON_INTERVAL_US;
+        }
+
+        match socket.recv_from(&mut buffer) {
+            Ok((size, std::net::SocketAddr::V4(from))) => match decode(&buffer[..size]) {
+                Some(Message::Beacon(sender, beacon)) if sender != instance => {
+                    let now = crate::input::time_us();
+                    shared.cache.lock().unwrap().update(sender, *from.ip(), &beacon, now);
+                }
+                Some(Message::Query(sender)) if sender != instance => {
+                    // Answer the asker directly; it may not hold the port
+                    if let Some(ref beacon) = advertised {
+                        encode_beacon(&mut out, instance, beacon);
+                        let _ = socket.send_to(&out, from);
+                    }
+                }
+                _ => {}
+            },
+            Ok(_) => {}
+            Err(ref e)
+                if e.kind() == std::io::ErrorKind::WouldBlock
+                    || e.kind() == std::io::ErrorKind::TimedOut => {}
+            Err(e) => {
+                log::warn!("Discovery receive failed: {}", e);
+                thread::sleep(RECEIVE_WAIT);
+            }
+        }
+
+        shared.cache.lock().unwrap().expire(crate::input::time_us());
+    }
+}
+
+/// LAN game browser and advertiser, serviced on its own thread
+pub struct LanDiscovery {
+    shared: Arc<Shared>,
+    handle: Option<JoinHandle<()>>,
+    port: u16,
+}
+
+impl LanDiscovery {
+    /// Start browsing (and, once advertise() is called, advertising)
+    pub fn start() -> NetworkResult<Self> {
+        let socket = open_socket()
+            .map_err(|e| NetworkError::HostCreationFailed(format!("Discovery: {}", e)))?;
+        let port = socket.local_addr().map(|a| a.port()).unwrap_or(0);
+
+        let shared = Arc::new(Shared {
+            running: AtomicBool::new(true),
+            refresh: AtomicBool::new(true),
+            advertised: Mutex::new(None),
+            cache: Mutex::new(DiscoveryCache::default()),
+        });
+        let instance = make_instance_token();
+        let thread_shared = Arc::clone(&shared);
+        let handle = thread::Builder::new()
+            .name("discovery".to_string())
+            .spawn(move || run(socket, thread_shared, instance))
+            .map_err(|e| NetworkError::HostCreationFailed(format!("Thread: {}", e)))?;
+
+        log::info!("LAN discovery started on port {}", port);
+        Ok(Self { shared, handle: Some(handle), port })
+    }
+
+    /// Port the discovery socket is bound to (DISCOVERY_PORT unless taken)
+    pub fn port(&self) -> u16 {
+        self.port
+    }
+
+    /// Advertise a hosted game, or stop advertising with `None`
+    pub fn advertise(&self, beacon: Option<SessionBeacon>) {
+        *self.shared.advertised.lock().unwrap() = beacon;
+    }
+
+    /// Query for games now instead of at the next interval
+    pub fn refresh(&self) {
+        self.shared.refresh.store(true, Ordering::Release);
+    }
+
+    /// Copy out the games found so far
+    ///
+    /// # Returns
+    /// Games written (at most `out.len()`)
+    pub fn games(&self, out: &mut [DiscoveredGame]) -> usize {
+        let now = crate::input::time_us();
+        self.shared.cache.lock().unwrap().list(now, out)
+    }
+
+    /// Stop the thread and wait for it
+    pub fn stop(&mut self) {
+        if let Some(handle) = self.handle.take() {
+            self.shared.running.store(false, Ordering::Release);
+            let _ = handle.join();
+            log::info!("LAN discovery stopped");
+        }
+    }
+}
+
+impl Drop for LanDiscovery {
+    fn drop(&mut self) {
+        self.stop();
+    }
+}
+
+// =============================================================================
+// FFI Exports
+// =============================================================================
+
+/// Start browsing the LAN for games
+///
+/// # Returns
+/// * Pointer to LanDiscovery on success
+/// * null if no socket could be bound
+#[no_mangle]
+pub extern "C" fn Platform_Discovery_Start() -> *mut LanDiscovery {
+    match LanDiscovery::start() {
+        Ok(discovery) => Box::into_raw(Box::new(discovery)),
+        Err(e) => {
+            log::error!("Failed to start LAN discovery: {}", e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Stop browsing and advertising, and free the discovery
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Discovery_Stop(discovery: *mut LanDiscovery) {
+    if !discovery.is_null() {
+        drop(Box::from_raw(discovery));
+    }
+}
+
+/// Advertise a hosted game, or stop advertising with a null beacon
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Discovery_Advertise(
+    discovery: *mut LanDiscovery,
+    beacon: *const SessionBeacon,
+) {
+    if let Some(discovery) = discovery.as_ref() {
+        discovery.advertise(beacon.as_ref().copied());
+    }
+}
+
+/// Query for games now instead of at the next interval
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Discovery_Refresh(discovery: *mut LanDiscovery) {
+    if let Some(discovery) = discovery.as_ref() {
+        discovery.refresh();
+    }
+}
+
+/// Copy out the games found so far; never blocks on the network
+///
+/// Returns games written (at most `max_games`), or -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Discovery_GetGames(
+    discovery: *mut LanDiscovery,
+    games: *mut DiscoveredGame,
+    max_games: i32,
+) -> i32 {
+    if discovery.is_null() || games.is_null() || max_games < 0 {
+        return -1;
+    }
+    let out = std::slice::from_raw_parts_mut(games, max_games as usize);
+    (*discovery).games(out) as i32
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sample_beacon() -> SessionBeacon {
+        let mut beacon = SessionBeacon {
+            map_crc: 0xDEAD_BEEF,
+            version: 3,
+            port: 5555,
+            players: 2,
+            max_players: 4,
+            ..SessionBeacon::default()
+        };
+        beacon.set_name("Tanya's Skirmish");
+        beacon
+    }
+
+    #[test]
+    fn test_beacon_round_trip() {
+        let beacon = sample_beacon();
+        let mut wire = Vec::new();
+        encode_beacon(&mut wire, 42, &beacon);
+        assert_eq!(wire.len(), HEADER_SIZE + BEACON_FIXED_SIZE + 16);
+        assert_eq!(decode(&wire), Some(Message::Beacon(42, beacon)));
+
+        encode_query(&mut wire, 7);
+        assert_eq!(decode(&wire), Some(Message::Query(7)));
+    }
+
+    #[test]
+    fn test_malformed_rejected() {
+        let mut wire = Vec::new();
+        encode_beacon(&mut wire, 42, &sample_beacon());
+        assert_eq!(decode(&wire[..wire.len() - 1]), None);
+        assert_eq!(decode(&wire[..HEADER_SIZE + 4]), None);
+
+        wire[5] = DISCOVERY_PROTOCOL + 1;
+        assert_eq!(decode(&wire), None);
+        assert_eq!(decode(b"not a beacon"), None);
+    }
+
+    #[test]
+    fn test_long_name_truncated() {
+        let mut beacon = SessionBeacon::default();
+        beacon.set_name(&"N".repeat(50));
+        assert_eq!(beacon.name_len(), MAX_SESSION_NAME);
+        assert_eq!(beacon.name[MAX_SESSION_NAME], 0);
+    }
+
+    #[test]
+    fn test_cache_update_and_expiry() {
+        let mut cache = DiscoveryCache::default();
+        let host = Ipv4Addr::new(192, 168, 1, 20);
+        let mut beacon = sample_beacon();
+
+        cache.update(1, Ipv4Addr::LOCALHOST, &beacon, 1_000_000);
+        beacon.players = 3;
+        cache.update(1, host, &beacon, 2_000_000);
+        beacon.port = 5556;
+        cache.update(2, host, &beacon, 2_500_000);
+        assert_eq!(cache.len(), 2);
+
+        let mut games = [DiscoveredGame::default(); 4];
+        assert_eq!(cache.list(3_000_000, &mut games), 2);
+        assert_eq!(games[0].beacon.players, 3);
+        assert_eq!(games[0].age_ms, 1000);
+        assert_eq!(&games[0].address[..13], b"192.168.1.20\0");
+
+        // The first game's beacons stop; it drops out after EXPIRY_US
+        cache.expire(2_000_000 + EXPIRY_US);
+        assert_eq!(cache.len(), 1);
+        assert_eq!(cache.list(2_500_000 + EXPIRY_US, &mut games), 0);
+    }
+
+    #[test]
+    fn test_cache_full() {
+        let mut cache = DiscoveryCache::default();
+        let beacon = sample_beacon();
+        for i in 0..MAX_DISCOVERED_GAMES as u32 + 4 {
+            cache.update(i + 1, Ipv4Addr::from(0x0A00_0000 + i), &beacon, 1);
+        }
+        assert_eq!(cache.len(), MAX_DISCOVERED_GAMES);
+    }
+
+    #[test]
+    fn test_query_answered_on_loopback() {
+        let host = LanDiscovery::start().unwrap();
+        if host.port() != DISCOVERY_PORT {
+            return; // Another process holds the port
+        }
+        host.advertise(Some(sample_beacon()));
+
+        // The browser can't get the port, so it only hears answers
+        let browser = LanDiscovery::start().unwrap();
+        assert_ne!(browser.port(), DISCOVERY_PORT);
+        browser.refresh();
+
+        let mut games = [DiscoveredGame::default(); 4];
+        let mut found = 0;
+        for _ in 0..100 {
+            found = browser.games(&mut games);
+            if found > 0 {
+                break;
+            }
+            thread::sleep(Duration::from_millis(20));
+        }
+        assert_eq!(found, 1);
+        assert_eq!(games[0].beacon, sample_beacon());
+
+        // A game never lists itself
+        assert_eq!(host.games(&mut games), 0);
+    }
+
+    #[test]
+    fn test_ffi_null_safety() {
+        unsafe {
+            let mut games = [DiscoveredGame::default(); 1];
+            assert_eq!(Platform_Discovery_GetGames(std::ptr::null_mut(), games.as_mut_ptr(), 1), -1);
+            Platform_Discovery_Advertise(std::ptr::null_mut(), std::ptr::null());
+            Platform_Discovery_Refresh(std::ptr::null_mut());
+            Platform_Discovery_Stop(std::ptr::null_mut());
+        }
+    }
+}
@@ -0,0 +1,538 @@
+//! Adaptive lockstep frame delay
+//!
+//! The original lockstep (SESSION.CPP / QUEUE.CPP) stamps each command
+//! with `Frame + MaxAhead` and stalls when a player's commands for the
+//! current frame haven't arrived. MaxAhead was fixed per session and sized
+//! for the worst connection the game expected, so LAN games paid for WAN
+//! input lag.
+//!
+//! `FrameDelayScheduler` derives the delay from measured round trips
+//! instead: each peer gets a smoothed RTT and RTT variance (RFC 6298), and
+//! the slowest peer sets the budget. A command relayed through the host
+//! travels one hop in and one hop out, so the budget is a full round trip
+//! plus four deviations, rounded up to ticks, plus `MIN_FRAME_DELAY` for
+//! the ticks spent sending and executing. On a LAN that comes to 2-3 ticks.
+//!
+//! The delay rises as soon as the budget grows or the simulation stalls
+//! waiting for commands. It falls one tick at a time, and only after the
+//! link has gone a while without needing more, so a jittery connection
+//! doesn't flap between values. Commands carry their execution frame, so
+//! peers needn't agree on the delay; a change applies to commands issued
+//! after it.
+
+/// Peers tracked at once
+pub(crate) const MAX_LATENCY_PEERS: usize = 16;
+
+/// Smallest delay: one tick to send the command, one to execute it
+pub(crate) const MIN_FRAME_DELAY: u32 = 2;
+
+/// Largest delay the scheduler will pick
+pub(crate) const MAX_FRAME_DELAY: u32 = 30;
+
+/// Delay used before any round trip has been measured (the original
+/// MaxAhead default)
+pub(crate) const DEFAULT_FRAME_DELAY: u32 = 5;
+
+/// Simulation ticks per second assumed until set_tick_rate()
+pub(crate) const DEFAULT_TICK_RATE: u32 = 15;
+
+/// Time without a raise or stall before the delay may come down
+const LOWER_HOLD_US: u64 = 5_000_000;
+
+/// Time between single-tick decreases
+const LOWER_STEP_US: u64 = 1_000_000;
+
+/// A peer with no sample for this long no longer counts
+const PEER_TIMEOUT_US: u64 = 5_000_000;
+
+/// Outstanding pings remembered for matching pongs
+const PENDING_PINGS: usize = 16;
+
+/// Round trip estimate for one peer
+#[derive(Debug, Clone, Copy, Default)]
+struct PeerLatency {
+    /// Peer identifier (0 = slot unused)
+    id: u32,
+    /// Smoothed round trip time
+    srtt_us: u64,
+    /// Smoothed mean deviation of the round trip time
+    rttvar_us: u64,
+    /// When the last sample arrived
+    last_sample_us: u64,
+    /// Pings answered, newest in bit 0
+    answered: u64,
+    /// Pings sent since the peer was first heard from (at most 64)
+    tracked: u32,
+}
+
+impl PeerLatency {
+    fn add_sample(&mut self, rtt_us: u64, now_us: u64) {
+        if self.last_sample_us == 0 {
+            self.srtt_us = rtt_us;
+            self.rttvar_us = rtt_us / 2;
+        } else {
+            let deviation = self.srtt_us.abs_diff(rtt_us);
+            self.rttvar_us = (3 * self.rttvar_us + deviation) / 4;
+            self.srtt_us = (7 * self.srtt_us + rtt_us) / 8;
+        }
+        self.last_sample_us = now_us.max(1);
+    }
+
+    /// Time a command needs to reach every player through this peer
+    fn budget_us(&self) -> u64 {
+        self.srtt_us + 4 * self.rttvar_us
+    }
+
+    fn is_live(&self, now_us: u64) -> bool {
+        self.id != 0 && now_us.saturating_sub(self.last_sample_us) < PEER_TIMEOUT_US
+    }
+
+    /// Share of pings that went unanswered, in tenths of a percent
+    ///
+    /// The newest ping is left out; its pong may still be on the way.
+    fn loss_permille(&self) -> u32 {
+        if self.tracked <= 1 {
+            return 0;
+        }
+        let considered = self.tracked - 1;
+        let mask = if self.tracked >= 64 { !1u64 } else { ((1u64 << self.tracked) - 1) & !1 };
+        let answered = (self.answered & mask).count_ones();
+        (considered - answered) * 1000 / considered
+    }
+}
+
+/// Round trip and loss figures for one peer
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct PeerLatencyStats {
+    /// Peer identifier (its ping token)
+    pub peer_id: u32,
+    /// Smoothed round trip time, microseconds
+    pub rtt_us: u32,
+    /// Round trip deviation, microseconds
+    pub jitter_us: u32,
+    /// Pings unanswered over the last 64, in tenths of a percent
+    pub loss_permille: u32,
+}
+
+/// Frame delay and stall statistics
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct FrameDelayStats {
+    /// Ticks between issuing a command and executing it
+    pub frame_delay: u32,
+    /// Delay the current round trip estimates call for
+    pub target_delay: u32,
+    /// Smoothed round trip time of the slowest peer, microseconds
+    pub rtt_us: u32,
+    /// Round trip deviation of the slowest peer, microseconds
+    pub jitter_us: u32,
+    /// Peers with a current estimate
+    pub peer_count: u32,
+    /// Number of stalls reported
+    pub stall_count: u32,
+    /// Total time spent stalled, microseconds
+    pub stall_us: u64,
+    /// Length of the most recent stall, microseconds
+    pub last_stall_us: u64,
+}
+
+/// Picks the lockstep command delay from measured round trips
+#[derive(Debug, Clone)]
+pub struct FrameDelayScheduler {
+    peers: [PeerLatency; MAX_LATENCY_PEERS],
+    /// (sequence, send time, ping number) of recent pings; send time 0 = empty
+    pending: [(u32, u64, u32); PENDING_PINGS],
+    /// Pings sent so far
+    pings_sent: u32,
+    tick_us: u64,
+    delay: u32,
+    last_raise_us: u64,
+    last_lower_us: u64,
+    stall_count: u32,
+    stall_us: u64,
+    last_stall_us: u64,
+}
+
+impl FrameDelayScheduler {
+    /// Create a scheduler at the default delay and tick rate
+    pub fn new() -> Self {
+        Self {
+            peers: [PeerLatency::default(); MAX_LATENCY_PEERS],
+            pending: [(0, 0, 0); PENDING_PINGS],
+            pings_sent: 0,
+            tick_us: 1_000_000 / DEFAULT_TICK_RATE as u64,
+            delay: DEFAULT_FRAME_DELAY,
+            last_raise_us: 0,
+            last_lower_us: 0,
+            stall_count: 0,
+            stall_us: 0,
+            last_stall_us: 0,
+        }
+    }
+
+    /// Forget all peers and statistics; keeps the tick rate
+    pub fn reset(&mut self) {
+        let tick_us = self.tick_us;
+        *self = Self::new();
+        self.tick_us = tick_us;
+    }
+
+    /// Set the simulation rate the delay is measured in
+    pub fn set_tick_rate(&mut self, ticks_per_second: u32) {
+        self.tick_us = 1_000_000 / ticks_per_second.max(1) as u64;
+    }
+
+    /// Current command delay in ticks
+    pub fn frame_delay(&self) -> u32 {
+        self.delay
+    }
+
+    /// Remember when ping `sequence` went out
+    pub fn ping_sent(&mut self, sequence: u32, now_us: u64) {
+        self.pending[sequence as usize % PENDING_PINGS] = (sequence, now_us.max(1), self.pings_sent);
+        self.pings_sent = self.pings_sent.wrapping_add(1);
+        for peer in self.peers.iter_mut().filter(|p| p.id != 0) {
+            peer.answered <<= 1;
+            peer.tracked = (peer.tracked + 1).min(64);
+        }
+    }
+
+    /// Match a pong against its ping and record the round trip
+    ///
+    /// A broadcast ping is answered by every peer, so the ping stays
+    /// pending until it is overwritten.
+    ///
+    /// # Returns
+    /// The round trip time, or `None` if the ping is unknown or too old
+    pub fn pong_received(&mut self, peer_id: u32, sequence: u32, now_us: u64) -> Option<u64> {
+        let (pending_sequence, sent_us, ping) = self.pending[sequence as usize % PENDING_PINGS];
+        if sent_us == 0 || pending_sequence != sequence || now_us < sent_us || peer_id == 0 {
+            return None;
+        }
+        let rtt_us = now_us - sent_us;
+        self.add_rtt_sample(peer_id, rtt_us, now_us);
+
+        // Mark the ping answered; a new peer starts counting from it
+        let age = self.pings_sent.wrapping_sub(ping).wrapping_sub(1);
+        if let Some(peer) = self.peers.iter_mut().find(|p| p.id == peer_id) {
+            if peer.tracked == 0 {
+                peer.tracked = (age + 1).min(64);
+            }
+            if age < 64 {
+                peer.answered |= 1 << age;
+            }
+        }
+        Some(rtt_us)
+    }
+
+    /// Record a round trip measured to `peer_id` (must be nonzero)
+    pub fn add_rtt_sample(&mut self, peer_id: u32, rtt_us: u64, now_us: u64) {
+        if peer_id == 0 {
+            return;
+        }
+        let slot = match self.peers.iter().position(|p| p.id == peer_id) {
+            Some(slot) => slot,
+            None => {
+                // Take a free slot, else the one heard from least recently
+                let slot = self
+                    .peers
+                    .iter()
+                    .enumerate()
+                    .min_by_key(|(_, p)| if p.id == 0 { 0 } else { p.last_sample_us })
+                    .map(|(slot, _)| slot)
+                    .unwrap_or(0);
+                self.peers[slot] = PeerLatency {
+                    id: peer_id,
+                    ..Default::default()
+                };
+                slot
+            }
+        };
+        self.peers[slot].add_sample(rtt_us, now_us);
+    }
+
+    /// Stop counting a peer that left
+    pub fn remove_peer(&mut self, peer_id: u32) {
+        for peer in self.peers.iter_mut().filter(|p| p.id == peer_id) {
+            *peer = PeerLatency::default();
+        }
+    }
+
+    /// Report that the simulation waited `stall_us` for commands
+    ///
+    /// The delay goes up a tick straight away; the commands already in
+    /// flight were scheduled too tight.
+    pub fn record_stall(&mut self, stall_us: u64, now_us: u64) {
+        if stall_us == 0 {
+            return;
+        }
+        self.stall_count = self.stall_count.saturating_add(1);
+        self.stall_us = self.stall_us.saturating_add(stall_us);
+        self.last_stall_us = stall_us;
+
+        if self.delay < MAX_FRAME_DELAY {
+            self.delay += 1;
+        }
+        self.last_raise_us = now_us;
+    }
+
+    /// Delay the current round trip estimates call for, or `None` before
+    /// any peer has been measured
+    pub fn target_delay(&self, now_us: u64) -> Option<u32> {
+        let budget_us = self
+            .peers
+            .iter()
+            .filter(|p| p.is_live(now_us))
+            .map(PeerLatency::budget_us)
+            .max()?;
+        let ticks = budget_us.div_ceil(self.tick_us) as u32;
+        Some((MIN_FRAME_DELAY + ticks).min(MAX_FRAME_DELAY))
+    }
+
+    /// Move the delay toward the target; call once per tick
+    ///
+    /// # Returns
+    /// The command delay to schedule this tick's commands with
+    pub fn update(&mut self, now_us: u64) -> u32 {
+        let target = match self.target_delay(now_us) {
+            Some(target) => target,
+            None => return self.delay,
+        };
+
+        if target > self.delay {
+            self.delay = target;
+            self.last_raise_us = now_us;
+        } else if target < self.delay
+            && now_us.saturating_sub(self.last_raise_us) >= LOWER_HOLD_US
+            && now_us.saturating_sub(self.last_lower_us) >= LOWER_STEP_US
+        {
+            self.delay -= 1;
+            self.last_lower_us = now_us;
+        }
+        self.delay
+    }
+
+    /// Fill `out` with figures for each peer heard from recently
+    ///
+    /// # Returns
+    /// Number of entries written
+    pub fn peer_stats(&self, now_us: u64, out: &mut [PeerLatencyStats]) -> usize {
+        let live = self.peers.iter().filter(|p| p.is_live(now_us));
+        let mut count = 0;
+        for (slot, peer) in out.iter_mut().zip(live) {
+            *slot = PeerLatencyStats {
+                peer_id: peer.id,
+                rtt_us: peer.srtt_us.min(u32::MAX as u64) as u32,
+                jitter_us: peer.rttvar_us.min(u32::MAX as u64) as u32,
+                loss_permille: peer.loss_permille(),
+            };
+            count += 1;
+        }
+        count
+    }
+
+    /// Current delay, slowest-peer estimate and stall totals
+    pub fn stats(&self, now_us: u64) -> FrameDelayStats {
+        let slowest = self
+            .peers
+            .iter()
+            .filter(|p| p.is_live(now_us))
+            .max_by_key(|p| p.budget_us());
+        FrameDelayStats {
+            frame_delay: self.delay,
+            target_delay: self.target_delay(now_us).unwrap_or(self.delay),
+            rtt_us: slowest.map_or(0, |p| p.srtt_us.min(u32::MAX as u64) as u32),
+            jitter_us: slowest.map_or(0, |p| p.rttvar_us.min(u32::MAX as u64) as u32),
+            peer_count: self.peers.iter().filter(|p| p.is_live(now_us)).count() as u32,
+            stall_count: self.stall_count,
+            stall_us: self.stall_us,
+            last_stall_us: self.last_stall_us,
+        }
+    }
+}
+
+impl Default for FrameDelayScheduler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const START_US: u64 = 1_000_000;
+
+    /// Feed `count` samples to one peer, a tick apart
+    fn feed(scheduler: &mut FrameDelayScheduler, peer: u32, rtt_us: u64, count: u64, from_us: u64) -> u64 {
+        let mut now = from_us;
+        for _ in 0..count {
+            scheduler.add_rtt_sample(peer, rtt_us, now);
+            scheduler.update(now);
+            now += 66_667;
+        }
+        now
+    }
+
+    #[test]
+    fn test_default_until_measured() {
+        let mut scheduler = FrameDelayScheduler::new();
+        assert_eq!(scheduler.update(START_US), DEFAULT_FRAME_DELAY);
+        assert_eq!(scheduler.target_delay(START_US), None);
+    }
+
+    #[test]
+    fn test_lan_settles_low() {
+        let mut scheduler = FrameDelayScheduler::new();
+        let now = feed(&mut scheduler, 1, 1_000, 200, START_US);
+        let delay = scheduler.update(now);
+        assert!((MIN_FRAME_DELAY..=3).contains(&delay), "LAN delay {}", delay);
+    }
+
+    #[test]
+    fn test_wan_raises_immediately() {
+        let mut scheduler = FrameDelayScheduler::new();
+        feed(&mut scheduler, 1, 300_000, 1, START_US);
+        // 300ms + 4 * 150ms deviation = 900ms -> 14 ticks, plus 2
+        assert_eq!(scheduler.frame_delay(), 16);
+    }
+
+    #[test]
+    fn test_slowest_peer_sets_delay() {
+        let mut scheduler = FrameDelayScheduler::new();
+        let mut now = START_US;
+        for _ in 0..200 {
+            scheduler.add_rtt_sample(1, 1_000, now);
+            scheduler.add_rtt_sample(2, 150_000, now);
+            scheduler.update(now);
+            now += 66_667;
+        }
+        let stats = scheduler.stats(now);
+        assert_eq!(stats.peer_count, 2);
+        assert!(stats.rtt_us >= 140_000);
+        assert_eq!(scheduler.frame_delay(), stats.target_delay);
+        assert!(scheduler.frame_delay() >= MIN_FRAME_DELAY + 3);
+
+        // The slow peer leaves; the delay steps back down
+        scheduler.remove_peer(2);
+        let now = feed(&mut scheduler, 1, 1_000, 300, now);
+        assert!(scheduler.update(now) <= 3);
+    }
+
+    #[test]
+    fn test_lowering_is_gradual() {
+        let mut scheduler = FrameDelayScheduler::new();
+        let now = feed(&mut scheduler, 1, 1_000, 200, START_US);
+        let settled = scheduler.frame_delay();
+
+        // A lag spike raises at once...
+        scheduler.add_rtt_sample(1, 400_000, now);
+        let raised = scheduler.update(now);
+        assert!(raised > settled + 2);
+
+        // ...but it takes the hold time and one step per second to recover
+        let after = feed(&mut scheduler, 1, 1_000, 30, now + 66_667);
+        assert!(scheduler.update(after) >= raised - 1);
+        let later = feed(&mut scheduler, 1, 1_000, 300, after);
+        assert_eq!(scheduler.update(later), settled);
+    }
+
+    #[test]
+    fn test_stall_raises_and_counts() {
+        let mut scheduler = FrameDelayScheduler::new();
+        let now = feed(&mut scheduler, 1, 1_000, 100, START_US);
+        let before = scheduler.frame_delay();
+
+        scheduler.record_stall(0, now);
+        assert_eq!(scheduler.frame_delay(), before);
+        scheduler.record_stall(20_000, now);
+        scheduler.record_stall(30_000, now);
+        assert_eq!(scheduler.frame_delay(), before + 2);
+
+        let stats = scheduler.stats(now);
+        assert_eq!(stats.stall_count, 2);
+        assert_eq!(stats.stall_us, 50_000);
+        assert_eq!(stats.last_stall_us, 30_000);
+
+        // Held for a while after a stall
+        assert_eq!(scheduler.update(now + 1_000_000), before + 2);
+    }
+
+    #[test]
+    fn test_ping_pong_matching() {
+        let mut scheduler = FrameDelayScheduler::new();
+        scheduler.ping_sent(7, START_US);
+
+        // Every peer answers a broadcast ping
+        assert_eq!(scheduler.pong_received(11, 7, START_US + 2_000), Some(2_000));
+        assert_eq!(scheduler.pong_received(12, 7, START_US + 3_000), Some(3_000));
+        assert_eq!(scheduler.pong_received(11, 8, START_US + 3_000), None);
+
+        // Overwritten by a later ping in the same slot
+        scheduler.ping_sent(7 + PENDING_PINGS as u32, START_US + 10_000);
+        assert_eq!(scheduler.pong_received(11, 7, START_US + 11_000), None);
+        assert_eq!(scheduler.stats(START_US + 11_000).peer_count, 2);
+    }
+
+    #[test]
+    fn test_loss_from_unanswered_pings() {
+        let mut scheduler = FrameDelayScheduler::new();
+        let mut now = START_US;
+        for sequence in 0..40u32 {
+            scheduler.ping_sent(sequence, now);
+            now += 1_000;
+            // Peer 1 answers every ping, peer 2 every other one
+            scheduler.pong_received(1, sequence, now);
+            if sequence % 2 == 0 {
+                scheduler.pong_received(2, sequence, now);
+            }
+        }
+        // One more in flight: not counted as lost
+        scheduler.ping_sent(40, now);
+
+        let mut stats = [PeerLatencyStats::default(); 4];
+        assert_eq!(scheduler.peer_stats(now, &mut stats), 2);
+        let peer1 = stats.iter().find(|s| s.peer_id == 1).unwrap();
+        let peer2 = stats.iter().find(|s| s.peer_id == 2).unwrap();
+        assert_eq!(peer1.loss_permille, 0);
+        assert_eq!(peer1.rtt_us, 1_000);
+        assert_eq!(peer2.loss_permille, 500);
+
+        // Only the last 64 pings count
+        for sequence in 41..200u32 {
+            scheduler.ping_sent(sequence, now);
+            scheduler.pong_received(2, sequence, now + 1_000);
+        }
+        scheduler.peer_stats(now, &mut stats);
+        let peer2 = stats.iter().find(|s| s.peer_id == 2).unwrap();
+        assert_eq!(peer2.loss_permille, 0);
+    }
+
+    #[test]
+    fn test_silent_peers_expire() {
+        let mut scheduler = FrameDelayScheduler::new();
+        scheduler.add_rtt_sample(1, 500_000, START_US);
+        assert!(scheduler.target_delay(START_US).is_some());
+        assert_eq!(scheduler.target_delay(START_US + PEER_TIMEOUT_US), None);
+        assert_eq!(scheduler.stats(START_US + PEER_TIMEOUT_US).peer_count, 0);
+    }
+
+    #[test]
+    fn test_reset_keeps_tick_rate() {
+        let mut scheduler = FrameDelayScheduler::new();
+        scheduler.set_tick_rate(60);
+        scheduler.record_stall(1_000, START_US);
+        scheduler.reset();
+        assert_eq!(scheduler.frame_delay(), DEFAULT_FRAME_DELAY);
+        assert_eq!(scheduler.stats(START_US).stall_count, 0);
+
+        // 20ms round trip at 60 ticks/s: 20ms + 40ms deviation -> 4 ticks
+        scheduler.add_rtt_sample(1, 20_000, START_US);
+        assert_eq!(scheduler.target_delay(START_US), Some(MIN_FRAME_DELAY + 4));
+    }
+}
@@ -6,9 +6,9 @@
 //! - Broadcasts packets to all connected peers
 //! - Receives packets from peers
 
+use super::receive_arena::{PacketView, ReceiveArena};
 use super::{NetworkError, NetworkResult, ENET_HANDLE};
 use enet::{Address, BandwidthLimit, ChannelLimit, Event, Host, Packet, PacketMode};
-use std::collections::VecDeque;
 use std::net::Ipv4Addr;
 
 /// Configuration for creating a network host
@@ -70,8 +70,8 @@ pub enum HostEvent {
 pub struct PlatformHost {
     /// The underlying enet host
     host: Host<u32>, // User data is peer index
-    /// Queue of received packets
-    received_packets: VecDeque<ReceivedPacket>,
+    /// Received packets
+    received_packets: ReceiveArena,
     /// Number of currently connected peers
     peer_count: u32,
     /// Maximum allowed peers
@@ -142,7 +142,7 @@ impl PlatformHost {
 
         Ok(Self {
             host,
-            received_packets: VecDeque::new(),
+            received_packets: ReceiveArena::new(),
             peer_count: 0,
             max_peers: config.max_clients,
             last_event: HostEvent::None,
@@ -194,11 +194,11 @@ impl PlatformHost {
                             ref packet,
                         } => {
                             // Queue the packet for later retrieval
-                            self.received_packets.push_back(ReceivedPacket {
-                                peer_index: 0, // Would need proper tracking
-                                channel: channel_id,
-                                data: packet.data().to_vec(),
-                            });
+                            self.received_packets.push(
+                                0, // Would need proper tracking
+                                channel_id,
+                                packet.data(),
+                            );
                             self.last_event = HostEvent::PacketReceived;
                         }
                     }
@@ -228,7 +228,38 @@ impl PlatformHost {
     /// * `Some(ReceivedPacket)` if a packet is available
     /// * `None` if the queue is empty
     pub fn receive(&mut self) -> Option<ReceivedPacket> {
-        self.received_packets.pop_front()
+        self.received_packets
+            .pop()
+            .map(|(peer_index, channel, data)| ReceivedPacket {
+                peer_index,
+                channel,
+                data,
+            })
+    }
+
+    /// Get the next received packet by copying it into a caller buffer
+    ///
+    /// # Returns
+    /// * `Some((bytes copied, peer index, channel))` if a packet was
+    ///   available (truncated to fit)
+    /// * `None` if the queue is empty
+    pub fn receive_into(&mut self, buffer: &mut [u8]) -> Option<(usize, u32, u8)> {
+        self.received_packets.pop_into(buffer)
+    }
+
+    /// Receive waiting packets as views into the receive arena
+    ///
+    /// Views stay valid until `release_batch()`; see `ReceiveArena`.
+    ///
+    /// # Returns
+    /// Number of views written to `out`
+    pub fn receive_batch(&mut self, out: &mut [PacketView]) -> usize {
+        self.received_packets.receive_batch(out)
+    }
+
+    /// Release the packets handed out by `receive_batch()`
+    pub fn release_batch(&mut self) {
+        self.received_packets.release_batch();
     }
 
     /// Check if there are packets waiting to be received
@@ -398,17 +429,15 @@ pub unsafe extern "C" fn Platform_Host_Receive(
         return -1;
     }
 
-    match (*host).receive() {
-        Some(packet) => {
-            let copy_size = std::cmp::min(packet.data.len(), buffer_size as usize);
-
-            std::ptr::copy_nonoverlapping(packet.data.as_ptr(), buffer, copy_size);
+    let buffer_slice = std::slice::from_raw_parts_mut(buffer, buffer_size as usize);
 
+    match (*host).receive_into(buffer_slice) {
+        Some((copy_size, packet_peer, packet_channel)) => {
             if !peer_index.is_null() {
-                *peer_index = packet.peer_index;
+                *peer_index = packet_peer;
             }
             if !channel.is_null() {
-                *channel = packet.channel;
+                *channel = packet_channel;
             }
 
             copy_size as i32
@@ -417,6 +446,43 @@ pub unsafe extern "C" fn Platform_Host_Receive(
     }
 }
 
+/// Receive waiting packets without copying them
+///
+/// Fills `packets` with descriptors pointing into the host's receive
+/// arena. The data stays valid until Platform_Host_ReleaseBatch; call
+/// that once per frame after handling the packets. Calling again before
+/// the release continues through the same batch.
+///
+/// # Arguments
+/// * `host` - Host pointer
+/// * `packets` - Descriptor array to fill
+/// * `max_packets` - Capacity of `packets`
+///
+/// # Returns
+/// * Number of descriptors written (0 if no packets)
+/// * -1: error or null pointers
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Host_ReceiveBatch(
+    host: *mut PlatformHost,
+    packets: *mut PacketView,
+    max_packets: i32,
+) -> i32 {
+    if host.is_null() || packets.is_null() || max_packets <= 0 {
+        return -1;
+    }
+
+    let views = std::slice::from_raw_parts_mut(packets, max_packets as usize);
+    (*host).receive_batch(views) as i32
+}
+
+/// Release the packets returned by Platform_Host_ReceiveBatch
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Host_ReleaseBatch(host: *mut PlatformHost) {
+    if !host.is_null() {
+        (*host).release_batch();
+    }
+}
+
 /// Check if host has packets waiting
 ///
 /// # Returns
@@ -600,6 +666,13 @@ mod tests {
                 -1
             );
 
+            let mut views = [PacketView::default(); 4];
+            assert_eq!(
+                Platform_Host_ReceiveBatch(std::ptr::null_mut(), views.as_mut_ptr(), 4),
+                -1
+            );
+            Platform_Host_ReleaseBatch(std::ptr::null_mut()); // Should not panic
+
             Platform_Host_Destroy(std::ptr::null_mut()); // Should not panic
             Platform_Host_Flush(std::ptr::null_mut()); // Should not panic
         }
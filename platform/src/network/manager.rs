@@ -3,11 +3,25 @@
 //! Provides a high-level interface for game networking that wraps
 //! the lower-level host and client implementations.
 
+use super::batch::MessageBatcher;
 use super::client::{ConnectConfig, PlatformClient};
+use super::compress::{compress_packet, decompress_packet, PayloadCompressor};
+use super::conditioner::{ConditionerStats, NetConditioner, NetConditions};
+use super::frame_delay::{FrameDelayScheduler, FrameDelayStats, PeerLatencyStats};
 use super::host::{HostConfig, PlatformHost};
-use super::packet::{serialize_packet, GamePacketCode, GamePacketHeader};
+use super::packet::{
+    deserialize_packet, serialize_packet, DeliveryMode, GamePacketCode, GamePacketHeader,
+    PACKET_FLAG_COMPRESSED,
+};
 use super::{NetworkError, NetworkResult};
 use std::collections::VecDeque;
+use std::hash::{BuildHasher, Hasher};
+
+/// How often latency pings go out
+const PING_INTERVAL_US: u64 = 250_000;
+
+/// Window the traffic rates are averaged over
+const TRAFFIC_WINDOW_US: u64 = 1_000_000;
 
 /// Network operating mode
 #[repr(C)]
@@ -33,6 +47,82 @@ pub struct NetworkPacket {
     pub data: Vec<u8>,
 }
 
+/// Traffic through the manager
+///
+/// Counts game data handed to and received from enet, pings included;
+/// enet's own headers, acks and resends are not counted. A host broadcast
+/// counts once per peer.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct TrafficStats {
+    /// Bytes received per second, over the last full second
+    pub bytes_in_per_sec: u32,
+    /// Bytes sent per second, over the last full second
+    pub bytes_out_per_sec: u32,
+    /// Packets received per second
+    pub packets_in_per_sec: u32,
+    /// Packets sent per second
+    pub packets_out_per_sec: u32,
+    /// Bytes received this session
+    pub bytes_in: u64,
+    /// Bytes sent this session
+    pub bytes_out: u64,
+    /// Bytes payload compression kept off the wire this session
+    pub bytes_out_saved: u64,
+}
+
+/// Session totals plus the counts since the current window began
+#[derive(Debug, Clone, Copy, Default)]
+struct TrafficMeter {
+    stats: TrafficStats,
+    window_start_us: u64,
+    window_bytes_in: u64,
+    window_bytes_out: u64,
+    window_packets_in: u64,
+    window_packets_out: u64,
+}
+
+impl TrafficMeter {
+    fn count_in(&mut self, bytes: usize) {
+        self.stats.bytes_in += bytes as u64;
+        self.window_bytes_in += bytes as u64;
+        self.window_packets_in += 1;
+    }
+
+    fn count_out(&mut self, bytes: usize, copies: u32) {
+        let total = bytes as u64 * copies as u64;
+        self.stats.bytes_out += total;
+        self.window_bytes_out += total;
+        self.window_packets_out += copies as u64;
+    }
+
+    fn count_saved(&mut self, bytes: usize, copies: u32) {
+        self.stats.bytes_out_saved += bytes as u64 * copies as u64;
+    }
+
+    /// Turn the window's counts into rates once it has run its length
+    fn update(&mut self, now_us: u64) {
+        if self.window_start_us == 0 {
+            self.window_start_us = now_us;
+            return;
+        }
+        let elapsed = now_us.saturating_sub(self.window_start_us);
+        if elapsed < TRAFFIC_WINDOW_US {
+            return;
+        }
+        let rate = |count: u64| (count * 1_000_000 / elapsed).min(u32::MAX as u64) as u32;
+        self.stats.bytes_in_per_sec = rate(self.window_bytes_in);
+        self.stats.bytes_out_per_sec = rate(self.window_bytes_out);
+        self.stats.packets_in_per_sec = rate(self.window_packets_in);
+        self.stats.packets_out_per_sec = rate(self.window_packets_out);
+        self.window_start_us = now_us;
+        self.window_bytes_in = 0;
+        self.window_bytes_out = 0;
+        self.window_packets_in = 0;
+        self.window_packets_out = 0;
+    }
+}
+
 /// Game session information
 #[repr(C)]
 #[derive(Debug, Clone)]
@@ -93,6 +183,23 @@ pub struct NetworkManager {
     received_packets: VecDeque<NetworkPacket>,
     /// Packet sequence counter
     sequence: u32,
+    /// Messages queued for the next flush_messages()
+    batcher: MessageBatcher,
+    /// Lockstep command delay, driven by ping round trips
+    frame_delay: FrameDelayScheduler,
+    /// Identifies our pings and pongs among broadcast ones
+    ping_token: u32,
+    /// When the last ping went out
+    last_ping_us: u64,
+    /// Bytes and packets in and out
+    traffic: TrafficMeter,
+    /// Compress outgoing game packets when it helps
+    compression: bool,
+    compressor: PayloadCompressor,
+    /// Compressed copy of the packet being sent
+    compress_buffer: Vec<u8>,
+    /// Simulated bad link applied to received packets (testing only)
+    conditioner: Option<NetConditioner<NetworkPacket>>,
 }
 
 impl NetworkManager {
@@ -105,6 +212,15 @@ impl NetworkManager {
             session: GameSessionInfo::default(),
             received_packets: VecDeque::new(),
             sequence: 0,
+            batcher: MessageBatcher::new(),
+            frame_delay: FrameDelayScheduler::new(),
+            ping_token: Self::make_ping_token(),
+            last_ping_us: 0,
+            traffic: TrafficMeter::default(),
+            compression: true,
+            compressor: PayloadCompressor::new(),
+            compress_buffer: Vec::new(),
+            conditioner: None,
         }
     }
 
@@ -237,11 +353,21 @@ impl NetworkManager {
         self.mode = NetworkMode::None;
         self.session = GameSessionInfo::default();
         self.received_packets.clear();
+        self.batcher.clear();
+        self.frame_delay.reset();
+        self.last_ping_us = 0;
+        self.traffic = TrafficMeter::default();
+        if let Some(ref mut conditioner) = self.conditioner {
+            conditioner.clear();
+        }
     }
 
     /// Update network state - call every frame
     ///
-    /// Processes incoming packets and connection events.
+    /// Processes incoming packets and connection events, answers and
+    /// times latency pings, and updates the frame delay. Ping and pong
+    /// packets are consumed here and never reach receive(). A peer that
+    /// leaves stops counting toward the delay once its pongs stop.
     /// Returns the number of packets received.
     pub fn update(&mut self) -> NetworkResult<usize> {
         let initial_count = self.received_packets.len();
@@ -284,9 +410,213 @@ impl NetworkManager {
             }
         }
 
+        for packet in self.received_packets.range(initial_count..) {
+            self.traffic.count_in(packet.data.len());
+        }
+
+        let now_us = crate::input::time_us();
+        self.condition_received(initial_count, now_us);
+        self.decompress_received(initial_count);
+
+        let mut index = initial_count;
+        while index < self.received_packets.len() {
+            if self.handle_latency_packet(index, now_us) {
+                self.received_packets.remove(index);
+            } else {
+                index += 1;
+            }
+        }
+
+        if self.is_connected() {
+            if now_us.saturating_sub(self.last_ping_us) >= PING_INTERVAL_US {
+                self.send_ping(now_us);
+            }
+            self.frame_delay.update(now_us);
+            self.traffic.update(now_us);
+        }
+
         Ok(self.received_packets.len() - initial_count)
     }
 
+    /// Pass the packets from `start` on through the conditioner, putting
+    /// back only those it has released by now
+    fn condition_received(&mut self, start: usize, now_us: u64) {
+        let Some(ref mut conditioner) = self.conditioner else {
+            return;
+        };
+        for packet in self.received_packets.drain(start..) {
+            let size = packet.data.len();
+            let channel = packet.channel;
+            let reliable = channel == DeliveryMode::Reliable.to_channel();
+            conditioner.submit(now_us, packet, size, channel, reliable);
+        }
+        while let Some(packet) = conditioner.pop_due(now_us) {
+            conditioner.count_out(packet.data.len());
+            self.received_packets.push_back(packet);
+        }
+    }
+
+    /// Simulate a bad link on everything this session receives, or go
+    /// back to the real link with `None`
+    ///
+    /// For testing and benchmarking only. Applied on receive, so the
+    /// conditions hold in both directions when both ends set them, and
+    /// latency pings see them too. Packets still held when the
+    /// conditioner is removed are delivered at once.
+    pub fn set_conditions(&mut self, conditions: Option<NetConditions>) {
+        match (conditions, self.conditioner.as_mut()) {
+            (Some(conditions), Some(conditioner)) => conditioner.set_conditions(conditions),
+            (Some(conditions), None) => self.conditioner = Some(NetConditioner::new(conditions)),
+            (None, _) => {
+                if let Some(mut conditioner) = self.conditioner.take() {
+                    self.received_packets.extend(conditioner.drain());
+                }
+            }
+        }
+    }
+
+    /// What the conditioner has done, if one is set
+    pub fn conditioner_stats(&self) -> Option<ConditionerStats> {
+        self.conditioner.as_ref().map(|c| c.stats())
+    }
+
+    /// Restore compressed payloads among the packets from `start` on, so
+    /// receive() only ever returns raw packets; drops corrupt ones
+    fn decompress_received(&mut self, start: usize) {
+        let mut index = start;
+        while index < self.received_packets.len() {
+            let data = &self.received_packets[index].data;
+            if data.len() <= GamePacketHeader::SIZE || data[8] & PACKET_FLAG_COMPRESSED == 0 {
+                index += 1;
+                continue;
+            }
+            let mut restored = Vec::with_capacity(data.len() * 2);
+            if decompress_packet(data, &mut restored) {
+                self.received_packets[index].data = restored;
+                index += 1;
+            } else {
+                log::warn!("Dropping corrupt compressed packet");
+                self.received_packets.remove(index);
+            }
+        }
+    }
+
+    /// Enable or disable compressing outgoing game packets (on by default)
+    ///
+    /// Receiving compressed packets always works.
+    pub fn set_compression(&mut self, enabled: bool) {
+        self.compression = enabled;
+    }
+
+    /// Lockstep command delay in ticks
+    ///
+    /// Commands issued on frame F should be scheduled for F + frame_delay().
+    /// Starts at the classic MaxAhead of 5 and adapts once round trips
+    /// have been measured.
+    pub fn frame_delay(&self) -> u32 {
+        self.frame_delay.frame_delay()
+    }
+
+    /// Set the simulation rate the frame delay is counted in
+    pub fn set_tick_rate(&mut self, ticks_per_second: u32) {
+        self.frame_delay.set_tick_rate(ticks_per_second);
+    }
+
+    /// Report time the simulation spent waiting for remote commands
+    ///
+    /// Raises the frame delay and adds to the stall totals.
+    pub fn record_stall(&mut self, stall_us: u64) {
+        self.frame_delay.record_stall(stall_us, crate::input::time_us());
+    }
+
+    /// Frame delay, round trip and stall statistics
+    pub fn frame_delay_stats(&self) -> FrameDelayStats {
+        self.frame_delay.stats(crate::input::time_us())
+    }
+
+    /// Bytes and packets per second in each direction, and session totals
+    pub fn traffic_stats(&self) -> TrafficStats {
+        self.traffic.stats
+    }
+
+    /// Fill `out` with round trip, jitter and loss for each peer
+    ///
+    /// # Returns
+    /// Number of entries written
+    pub fn peer_stats(&self, out: &mut [PeerLatencyStats]) -> usize {
+        self.frame_delay.peer_stats(crate::input::time_us(), out)
+    }
+
+    /// Answer a ping or time a pong
+    ///
+    /// Ping payload: the sender's token. Pong payload: the pinger's token,
+    /// then the responder's. The host broadcasts, so a pong for another
+    /// player's ping can arrive here; the token tells them apart.
+    ///
+    /// # Returns
+    /// true if the packet was a ping or pong
+    fn handle_latency_packet(&mut self, index: usize, now_us: u64) -> bool {
+        let packet = &self.received_packets[index];
+        let (header, payload) = match deserialize_packet(&packet.data) {
+            Some(parsed) => parsed,
+            None => return false,
+        };
+        let token = |offset: usize| {
+            payload
+                .get(offset..offset + 4)
+                .map(|b| u32::from_le_bytes([b[0], b[1], b[2], b[3]]))
+        };
+
+        match header.packet_code() {
+            GamePacketCode::Ping => {
+                if let Some(pinger) = token(0) {
+                    let mut reply = [0u8; 8];
+                    reply[..4].copy_from_slice(&pinger.to_le_bytes());
+                    reply[4..].copy_from_slice(&self.ping_token.to_le_bytes());
+                    let header = GamePacketHeader::new(
+                        GamePacketCode::Pong,
+                        header.sequence,
+                        self.session.local_player_id,
+                    );
+                    let pong = serialize_packet(&header, &reply);
+                    let _ = self.send_data(DeliveryMode::Unreliable.to_channel(), &pong, false);
+                }
+                true
+            }
+            GamePacketCode::Pong => {
+                if let (Some(pinger), Some(responder)) = (token(0), token(4)) {
+                    if pinger == self.ping_token {
+                        self.frame_delay.pong_received(responder, header.sequence, now_us);
+                    }
+                }
+                true
+            }
+            _ => false,
+        }
+    }
+
+    /// Send a latency ping to every peer
+    fn send_ping(&mut self, now_us: u64) {
+        let sequence = self.next_sequence();
+        let header =
+            GamePacketHeader::new(GamePacketCode::Ping, sequence, self.session.local_player_id);
+        let ping = serialize_packet(&header, &self.ping_token.to_le_bytes());
+        if self
+            .send_data(DeliveryMode::Unreliable.to_channel(), &ping, false)
+            .is_ok()
+        {
+            self.frame_delay.ping_sent(sequence, now_us);
+        }
+        self.last_ping_us = now_us;
+    }
+
+    /// Nonzero token unlikely to match another player's
+    fn make_ping_token() -> u32 {
+        let mut hasher = std::collections::hash_map::RandomState::new().build_hasher();
+        hasher.write_u64(crate::input::time_us());
+        (hasher.finish() as u32).max(1)
+    }
+
     /// Send data to peers
     ///
     /// When hosting: broadcasts to all clients
@@ -297,7 +627,9 @@ impl NetworkManager {
 
             NetworkMode::Hosting => {
                 if let Some(ref mut host) = self.host {
-                    host.broadcast(channel, data, reliable)
+                    host.broadcast(channel, data, reliable)?;
+                    self.traffic.count_out(data.len(), host.peer_count());
+                    Ok(())
                 } else {
                     Err(NetworkError::NotInitialized)
                 }
@@ -305,7 +637,9 @@ impl NetworkManager {
 
             NetworkMode::Joined => {
                 if let Some(ref mut client) = self.client {
-                    client.send(channel, data, reliable)
+                    client.send(channel, data, reliable)?;
+                    self.traffic.count_out(data.len(), 1);
+                    Ok(())
                 } else {
                     Err(NetworkError::Disconnected)
                 }
@@ -324,7 +658,114 @@ impl NetworkManager {
             GamePacketHeader::new(code, self.next_sequence(), self.session.local_player_id);
         let packet = serialize_packet(&header, payload);
         let channel = if reliable { 0 } else { 1 };
-        self.send_data(channel, &packet, reliable)
+
+        let mut compressed = std::mem::take(&mut self.compress_buffer);
+        let result = if self.compression
+            && compress_packet(&mut self.compressor, &packet, &mut compressed)
+        {
+            let saved = packet.len() - compressed.len();
+            let copies = self.peer_count();
+            self.send_data(channel, &compressed, reliable)
+                .map(|()| self.traffic.count_saved(saved, copies))
+        } else {
+            self.send_data(channel, &packet, reliable)
+        };
+        self.compress_buffer = compressed;
+        result
+    }
+
+    /// Queue a message for this tick's batch
+    ///
+    /// Nothing is sent until flush_messages(), which packs everything
+    /// queued on a channel into as few datagrams as fit.
+    ///
+    /// # Arguments
+    /// * `channel` - Channel to send on (0 reliable, 1 unreliable)
+    /// * `code` - Message code, returned to the receiver
+    /// * `handle` - Unit/object handle (delta-encoded), or 0
+    /// * `body` - Message body
+    pub fn queue_message(
+        &mut self,
+        channel: u8,
+        code: u8,
+        handle: u32,
+        body: &[u8],
+    ) -> NetworkResult<()> {
+        if self.mode == NetworkMode::None {
+            return Err(NetworkError::NotInitialized);
+        }
+        if !self.batcher.push(channel, code, handle, body) {
+            return Err(NetworkError::SendFailed);
+        }
+        Ok(())
+    }
+
+    /// Send the queued messages, one MessageBatch packet per datagram,
+    /// then flush the host or client
+    ///
+    /// # Returns
+    /// Number of packets sent
+    pub fn flush_messages(&mut self) -> NetworkResult<usize> {
+        if self.batcher.is_empty() {
+            return Ok(0);
+        }
+
+        let mode = self.mode;
+        let player_id = self.session.local_player_id;
+        let host = &mut self.host;
+        let client = &mut self.client;
+        let sequence = &mut self.sequence;
+        let traffic = &mut self.traffic;
+        let compression = self.compression;
+        let compressor = &mut self.compressor;
+        let compressed = &mut self.compress_buffer;
+        let mut result = Ok(());
+
+        let sent = self.batcher.drain(|channel, raw| {
+            let header = GamePacketHeader::new(GamePacketCode::MessageBatch, *sequence, player_id);
+            *sequence = sequence.wrapping_add(1);
+            raw[..GamePacketHeader::SIZE].copy_from_slice(&header.to_bytes());
+
+            let datagram: &[u8] = if compression && compress_packet(compressor, raw, compressed) {
+                &compressed[..]
+            } else {
+                raw
+            };
+            let saved = raw.len() - datagram.len();
+
+            let reliable = channel == DeliveryMode::Reliable.to_channel();
+            let status = match mode {
+                NetworkMode::Hosting => host
+                    .as_mut()
+                    .map_or(Err(NetworkError::NotInitialized), |h| {
+                        h.broadcast(channel, datagram, reliable).map(|()| {
+                            traffic.count_out(datagram.len(), h.peer_count());
+                            traffic.count_saved(saved, h.peer_count());
+                        })
+                    }),
+                NetworkMode::Joined => client
+                    .as_mut()
+                    .map_or(Err(NetworkError::Disconnected), |c| {
+                        c.send(channel, datagram, reliable).map(|()| {
+                            traffic.count_out(datagram.len(), 1);
+                            traffic.count_saved(saved, 1);
+                        })
+                    }),
+                NetworkMode::None => Err(NetworkError::NotInitialized),
+            };
+            if result.is_ok() {
+                result = status;
+            }
+        });
+
+        if let Some(ref mut host) = self.host {
+            host.flush();
+        }
+        if let Some(ref mut client) = self.client {
+            client.flush();
+        }
+
+        result.map(|()| sent)
     }
 
     /// Receive next packet
@@ -572,6 +1013,175 @@ pub unsafe extern "C" fn Platform_NetworkManager_SendData(
     }
 }
 
+/// Queue a message for the next Platform_NetworkManager_FlushMessages
+///
+/// # Arguments
+/// * `channel` - Channel to send on (0 reliable, 1 unreliable)
+/// * `code` - Message code
+/// * `handle` - Unit/object handle (delta-encoded), or 0
+/// * `data` - Message body (may be null when `size` is 0)
+/// * `size` - Body size
+///
+/// Returns 0 on success, -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_QueueMessage(
+    manager: *mut NetworkManager,
+    channel: u8,
+    code: u8,
+    handle: u32,
+    data: *const u8,
+    size: i32,
+) -> i32 {
+    if manager.is_null() || size < 0 || (data.is_null() && size > 0) {
+        return -1;
+    }
+
+    let slice = if size > 0 {
+        std::slice::from_raw_parts(data, size as usize)
+    } else {
+        &[]
+    };
+
+    match (*manager).queue_message(channel, code, handle, slice) {
+        Ok(()) => 0,
+        Err(_) => -1,
+    }
+}
+
+/// Send the messages queued this tick and flush
+///
+/// Returns packets sent, or -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_FlushMessages(manager: *mut NetworkManager) -> i32 {
+    if manager.is_null() {
+        return -1;
+    }
+
+    match (*manager).flush_messages() {
+        Ok(sent) => sent as i32,
+        Err(_) => -1,
+    }
+}
+
+/// Get the lockstep command delay in ticks
+///
+/// Returns the delay, or -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_GetFrameDelay(manager: *mut NetworkManager) -> i32 {
+    if manager.is_null() {
+        return -1;
+    }
+    (*manager).frame_delay() as i32
+}
+
+/// Set the simulation tick rate the frame delay is counted in
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_SetTickRate(
+    manager: *mut NetworkManager,
+    ticks_per_second: i32,
+) {
+    if !manager.is_null() && ticks_per_second > 0 {
+        (*manager).set_tick_rate(ticks_per_second as u32);
+    }
+}
+
+/// Report time the simulation spent waiting for remote commands
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_RecordStall(
+    manager: *mut NetworkManager,
+    stall_us: u32,
+) {
+    if !manager.is_null() {
+        (*manager).record_stall(stall_us as u64);
+    }
+}
+
+/// Get frame delay, round trip and stall statistics
+///
+/// Returns 0 on success, -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_GetFrameDelayStats(
+    manager: *mut NetworkManager,
+    stats: *mut FrameDelayStats,
+) -> i32 {
+    if manager.is_null() || stats.is_null() {
+        return -1;
+    }
+    *stats = (*manager).frame_delay_stats();
+    0
+}
+
+/// Enable or disable compressing outgoing game packets (on by default)
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_SetCompression(
+    manager: *mut NetworkManager,
+    enabled: i32,
+) {
+    if let Some(manager) = manager.as_mut() {
+        manager.set_compression(enabled != 0);
+    }
+}
+
+/// Simulate a bad link on everything the session receives (testing
+/// only); null conditions go back to the real link
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_SetConditions(
+    manager: *mut NetworkManager,
+    conditions: *const NetConditions,
+) {
+    if let Some(manager) = manager.as_mut() {
+        manager.set_conditions(conditions.as_ref().copied());
+    }
+}
+
+/// Get what the simulated link has done
+///
+/// Returns 0 on success, -1 on error or if no conditions are set
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_GetConditionerStats(
+    manager: *mut NetworkManager,
+    stats: *mut ConditionerStats,
+) -> i32 {
+    match (manager.as_ref().and_then(|m| m.conditioner_stats()), stats.as_mut()) {
+        (Some(current), Some(stats)) => {
+            *stats = current;
+            0
+        }
+        _ => -1,
+    }
+}
+
+/// Get traffic rates and totals
+///
+/// Returns 0 on success, -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_GetTrafficStats(
+    manager: *mut NetworkManager,
+    stats: *mut TrafficStats,
+) -> i32 {
+    if manager.is_null() || stats.is_null() {
+        return -1;
+    }
+    *stats = (*manager).traffic_stats();
+    0
+}
+
+/// Get round trip, jitter and loss for each peer heard from recently
+///
+/// Returns entries written (at most `max_peers`), or -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetworkManager_GetPeerStats(
+    manager: *mut NetworkManager,
+    stats: *mut PeerLatencyStats,
+    max_peers: i32,
+) -> i32 {
+    if manager.is_null() || stats.is_null() || max_peers < 0 {
+        return -1;
+    }
+    let out = std::slice::from_raw_parts_mut(stats, max_peers as usize);
+    (*manager).peer_stats(out) as i32
+}
+
 /// Receive data
 ///
 /// Returns bytes copied, 0 if no data, -1 on error
@@ -650,6 +1260,11 @@ mod tests {
         assert!(!manager.is_host());
         assert!(!manager.is_connected());
         assert_eq!(manager.peer_count(), 0);
+        assert_eq!(
+            manager.queue_message(0, 30, 1, b"move"),
+            Err(NetworkError::NotInitialized)
+        );
+        assert_eq!(manager.flush_messages(), Ok(0));
     }
 
     #[test]
@@ -666,6 +1281,14 @@ mod tests {
                 assert!(manager.is_connected());
                 assert_eq!(manager.session_info().get_name(), "Test Game");
                 assert_eq!(manager.session_info().port, 16000);
+
+                // A tick's messages go out as one packet per channel
+                assert!(manager.queue_message(0, 30, 7, b"move").is_ok());
+                assert!(manager.queue_message(0, 30, 8, b"move").is_ok());
+                assert!(manager.queue_message(1, 32, 0, b"sync").is_ok());
+                assert!(manager.queue_message(9, 30, 0, b"bad").is_err());
+                assert_eq!(manager.flush_messages(), Ok(2));
+                assert_eq!(manager.flush_messages(), Ok(0));
                 manager.disconnect();
             }
             Err(e) => {
@@ -700,6 +1323,21 @@ mod tests {
 
             Platform_NetworkManager_Disconnect(manager); // Should not panic
 
+            assert_eq!(Platform_NetworkManager_GetFrameDelay(manager), 5);
+            Platform_NetworkManager_SetTickRate(manager, 30);
+            Platform_NetworkManager_RecordStall(manager, 40_000);
+            let mut stats = FrameDelayStats::default();
+            assert_eq!(Platform_NetworkManager_GetFrameDelayStats(manager, &mut stats), 0);
+            assert_eq!(stats.frame_delay, 6);
+            assert_eq!(stats.stall_count, 1);
+            assert_eq!(stats.stall_us, 40_000);
+
+            let mut traffic = TrafficStats::default();
+            assert_eq!(Platform_NetworkManager_GetTrafficStats(manager, &mut traffic), 0);
+            assert_eq!(traffic, TrafficStats::default());
+            let mut peers = [PeerLatencyStats::default(); 4];
+            assert_eq!(Platform_NetworkManager_GetPeerStats(manager, peers.as_mut_ptr(), 4), 0);
+
             Platform_NetworkManager_Destroy(manager);
         }
     }
@@ -712,11 +1350,131 @@ mod tests {
             assert_eq!(Platform_NetworkManager_IsConnected(std::ptr::null_mut()), 0);
             assert_eq!(Platform_NetworkManager_PeerCount(std::ptr::null_mut()), 0);
 
+            assert_eq!(
+                Platform_NetworkManager_QueueMessage(std::ptr::null_mut(), 0, 30, 0, std::ptr::null(), 0),
+                -1
+            );
+            assert_eq!(Platform_NetworkManager_FlushMessages(std::ptr::null_mut()), -1);
+            assert_eq!(Platform_NetworkManager_GetFrameDelay(std::ptr::null_mut()), -1);
+            assert_eq!(
+                Platform_NetworkManager_GetFrameDelayStats(std::ptr::null_mut(), std::ptr::null_mut()),
+                -1
+            );
+            Platform_NetworkManager_RecordStall(std::ptr::null_mut(), 1); // Should not panic
+            assert_eq!(
+                Platform_NetworkManager_GetTrafficStats(std::ptr::null_mut(), std::ptr::null_mut()),
+                -1
+            );
+            assert_eq!(
+                Platform_NetworkManager_GetPeerStats(std::ptr::null_mut(), std::ptr::null_mut(), 0),
+                -1
+            );
+
             Platform_NetworkManager_Disconnect(std::ptr::null_mut()); // Should not panic
             Platform_NetworkManager_Destroy(std::ptr::null_mut()); // Should not panic
         }
     }
 
+    #[test]
+    fn test_latency_packets_consumed() {
+        let mut manager = NetworkManager::new();
+        manager.ping_token = 0x1234;
+        manager.frame_delay.ping_sent(9, 1);
+
+        // Our pong, answered by peer token 77
+        let header = GamePacketHeader::new(GamePacketCode::Pong, 9, 1);
+        let mut payload = 0x1234u32.to_le_bytes().to_vec();
+        payload.extend_from_slice(&77u32.to_le_bytes());
+        let pong = serialize_packet(&header, &payload);
+
+        // Someone else's pong, relayed by the host
+        let mut other = 0x9999u32.to_le_bytes().to_vec();
+        other.extend_from_slice(&78u32.to_le_bytes());
+        let foreign = serialize_packet(&header, &other);
+
+        let chat = serialize_packet(&GamePacketHeader::new(GamePacketCode::ChatMessage, 3, 1), b"hi");
+        for data in [pong, chat, foreign] {
+            manager.received_packets.push_back(NetworkPacket { peer_id: 0, channel: 1, data });
+        }
+
+        assert!(manager.handle_latency_packet(0, 5_001));
+        assert!(!manager.handle_latency_packet(1, 5_001));
+        assert!(manager.handle_latency_packet(2, 5_001));
+        assert_eq!(manager.frame_delay.stats(5_001).peer_count, 1);
+        assert_eq!(manager.frame_delay.stats(5_001).rtt_us, 5_000);
+    }
+
+    #[test]
+    fn test_compressed_packets_restored() {
+        let mut manager = NetworkManager::new();
+        let header = GamePacketHeader::new(GamePacketCode::GameCommands, 4, 1);
+        let packet = serialize_packet(&header, &[0u8; 64]);
+        let mut wire = Vec::new();
+        assert!(compress_packet(&mut PayloadCompressor::new(), &packet, &mut wire));
+
+        let mut corrupt = wire.clone();
+        corrupt.truncate(wire.len() - 1);
+        let chat = serialize_packet(&GamePacketHeader::new(GamePacketCode::ChatMessage, 3, 1), b"hi");
+        for data in [chat.clone(), wire, corrupt] {
+            manager.received_packets.push_back(NetworkPacket { peer_id: 0, channel: 0, data });
+        }
+
+        manager.decompress_received(0);
+        assert_eq!(manager.packet_count(), 2);
+        assert_eq!(manager.receive().unwrap().data, chat);
+        assert_eq!(manager.receive().unwrap().data, packet);
+    }
+
+    #[test]
+    fn test_conditioned_receive() {
+        let mut manager = NetworkManager::new();
+        manager.set_conditions(Some(NetConditions {
+            latency_ms: 40,
+            ..Default::default()
+        }));
+
+        for seq in 0..3u8 {
+            manager.received_packets.push_back(NetworkPacket { peer_id: 0, channel: 1, data: vec![seq] });
+        }
+        manager.condition_received(0, 1_000);
+        assert_eq!(manager.packet_count(), 0);
+        manager.condition_received(0, 41_000);
+        assert_eq!(manager.packet_count(), 3);
+        assert_eq!(manager.conditioner_stats().unwrap().packets_out, 3);
+
+        // Removing the conditioner hands over what it still held
+        manager.received_packets.push_back(NetworkPacket { peer_id: 0, channel: 0, data: vec![9] });
+        manager.condition_received(3, 50_000);
+        assert_eq!(manager.packet_count(), 3);
+        manager.set_conditions(None);
+        assert_eq!(manager.packet_count(), 4);
+        assert!(manager.conditioner_stats().is_none());
+    }
+
+    #[test]
+    fn test_traffic_rates() {
+        let mut meter = TrafficMeter::default();
+        meter.update(1_000_000);
+        meter.count_in(100);
+        meter.count_in(300);
+        meter.count_out(50, 3);
+
+        // Rates wait for a full window
+        meter.update(1_500_000);
+        assert_eq!(meter.stats.bytes_in_per_sec, 0);
+        meter.update(3_000_000);
+        assert_eq!(meter.stats.bytes_in_per_sec, 200);
+        assert_eq!(meter.stats.packets_in_per_sec, 1);
+        assert_eq!(meter.stats.bytes_out_per_sec, 75);
+        assert_eq!(meter.stats.bytes_in, 400);
+        assert_eq!(meter.stats.bytes_out, 150);
+
+        // An idle window reads zero; totals stay
+        meter.update(4_000_000);
+        assert_eq!(meter.stats.bytes_in_per_sec, 0);
+        assert_eq!(meter.stats.bytes_in, 400);
+    }
+
     #[test]
     fn test_session_info() {
         let mut info = GameSessionInfo::default();
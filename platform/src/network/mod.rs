@@ -11,18 +11,36 @@
 //! - Cross-platform support (macOS, Linux, Windows)
 //! - Reliable and unreliable packet delivery
 //! - Connection management
+//! - LAN game discovery (replacing IPX broadcasts)
+//! - Simulated latency, loss and bandwidth caps for testing
 
+pub mod batch;
 pub mod client;
+pub mod compress;
+pub mod conditioner;
+pub mod discovery;
+pub mod frame_delay;
 pub mod host;
 pub mod manager;
 pub mod packet;
+pub mod receive_arena;
+pub mod service_thread;
+pub mod spsc;
 
+pub use batch::{BatchCursor, BatchMessage, BatchReader, MessageBatcher};
 pub use client::{ClientEvent, ClientState, ConnectConfig, PlatformClient};
+pub use compress::PayloadCompressor;
+pub use conditioner::{ConditionerStats, NetConditioner, NetConditions};
+pub use discovery::{DiscoveredGame, DiscoveryCache, LanDiscovery, SessionBeacon};
+pub use frame_delay::{FrameDelayScheduler, FrameDelayStats, PeerLatencyStats};
 pub use host::{HostConfig, HostEvent, PlatformHost, ReceivedPacket};
-pub use manager::{GameSessionInfo, NetworkManager, NetworkMode, NetworkPacket};
+pub use receive_arena::{PacketView, ReceiveArena};
+pub use service_thread::{NetThreadStats, NetThreadStatus, NetworkThread};
+pub use manager::{GameSessionInfo, NetworkManager, NetworkMode, NetworkPacket, TrafficStats};
 pub use packet::{
     create_chat_packet, create_ping_packet, create_pong_packet, deserialize_packet,
-    serialize_packet, DeliveryMode, GamePacket, GamePacketCode, GamePacketHeader, PACKET_MAGIC,
+    serialize_packet, DeliveryMode, GamePacket, GamePacketCode, GamePacketHeader,
+    PACKET_FLAG_COMPRESSED, PACKET_MAGIC,
 };
 
 // Re-export host FFI functions for cbindgen
@@ -35,6 +53,8 @@ pub use host::{
     Platform_Host_HasPackets,
     Platform_Host_PeerCount,
     Platform_Host_Receive,
+    Platform_Host_ReceiveBatch,
+    Platform_Host_ReleaseBatch,
     Platform_Host_Service,
 };
 
@@ -50,14 +70,52 @@ pub use client::{
     Platform_Client_HasPackets,
     Platform_Client_IsConnected,
     Platform_Client_Receive,
+    Platform_Client_ReceiveBatch,
+    Platform_Client_ReleaseBatch,
     Platform_Client_Send,
     Platform_Client_Service,
 };
 
+// Re-export conditioner FFI functions for cbindgen
+pub use conditioner::{
+    Platform_Conditioner_Create,
+    Platform_Conditioner_Destroy,
+    Platform_Conditioner_GetStats,
+    Platform_Conditioner_NextRelease,
+    Platform_Conditioner_Receive,
+    Platform_Conditioner_SetConditions,
+    Platform_Conditioner_Submit,
+};
+
+// Re-export discovery FFI functions for cbindgen
+pub use discovery::{
+    Platform_Discovery_Advertise,
+    Platform_Discovery_GetGames,
+    Platform_Discovery_Refresh,
+    Platform_Discovery_Start,
+    Platform_Discovery_Stop,
+};
+
+// Re-export service thread FFI functions for cbindgen
+pub use service_thread::{
+    Platform_NetThread_GetStats,
+    Platform_NetThread_GetStatus,
+    Platform_NetThread_PacketCount,
+    Platform_NetThread_PeerCount,
+    Platform_NetThread_Receive,
+    Platform_NetThread_Send,
+    Platform_NetThread_StartClient,
+    Platform_NetThread_StartHost,
+    Platform_NetThread_Stop,
+};
+
 // Re-export packet FFI functions for cbindgen
+pub use batch::Platform_Packet_NextBatchMessage;
 pub use packet::{
     Platform_Packet_Build,
+    Platform_Packet_BuildCompressed,
     Platform_Packet_CreateHeader,
+    Platform_Packet_DecodePayload,
     Platform_Packet_GetPayload,
     Platform_Packet_HeaderSize,
     Platform_Packet_ParseHeader,
@@ -69,8 +127,13 @@ pub use manager::{
     Platform_NetworkManager_Create,
     Platform_NetworkManager_Destroy,
     Platform_NetworkManager_Disconnect,
+    Platform_NetworkManager_GetConditionerStats,
+    Platform_NetworkManager_GetFrameDelay,
+    Platform_NetworkManager_GetFrameDelayStats,
     Platform_NetworkManager_GetLocalPlayerId,
     Platform_NetworkManager_GetMode,
+    Platform_NetworkManager_GetPeerStats,
+    Platform_NetworkManager_GetTrafficStats,
     Platform_NetworkManager_HasPackets,
     Platform_NetworkManager_HostGame,
     Platform_NetworkManager_Init,
@@ -78,9 +141,15 @@ pub use manager::{
     Platform_NetworkManager_IsHost,
     Platform_NetworkManager_JoinGame,
     Platform_NetworkManager_JoinGameAsync,
+    Platform_NetworkManager_FlushMessages,
     Platform_NetworkManager_PeerCount,
+    Platform_NetworkManager_QueueMessage,
     Platform_NetworkManager_ReceiveData,
+    Platform_NetworkManager_RecordStall,
     Platform_NetworkManager_SendData,
+    Platform_NetworkManager_SetCompression,
+    Platform_NetworkManager_SetConditions,
+    Platform_NetworkManager_SetTickRate,
     Platform_NetworkManager_Shutdown,
     Platform_NetworkManager_Update,
 };
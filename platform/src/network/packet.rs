@@ -7,6 +7,8 @@
 //!
 //! We adapt this to work with enet's reliable/unreliable channels.
 
+use super::compress::{decompress_payload, PayloadCompressor};
+
 /// Packet delivery mode
 #[repr(C)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
@@ -44,6 +46,9 @@ impl DeliveryMode {
 /// Original: 0xDABD for serial, various for network
 pub const PACKET_MAGIC: u16 = 0xC0DE;
 
+/// Header flag: the payload is compressed (see compress.rs)
+pub const PACKET_FLAG_COMPRESSED: u8 = 0x01;
+
 /// Game packet header
 ///
 /// Based on original CommHeaderType but adapted for cross-platform use.
@@ -59,7 +64,7 @@ pub struct GamePacketHeader {
     pub sequence: u32,
     /// Source player ID (1 byte)
     pub player_id: u8,
-    /// Flags (1 byte) - reserved for future use
+    /// Flags (1 byte) - PACKET_FLAG_*
     pub flags: u8,
 }
 
@@ -204,6 +209,9 @@ pub enum GamePacketCode {
     /// Game over / results
     GameOver = 33,
 
+    /// Several framed messages sharing one header (see batch.rs)
+    MessageBatch = 34,
+
     // =========================
     // Keep-alive
     // =========================
@@ -246,6 +254,7 @@ impl From<u8> for GamePacketCode {
             31 => GamePacketCode::GameSync,
             32 => GamePacketCode::FrameSync,
             33 => GamePacketCode::GameOver,
+            34 => GamePacketCode::MessageBatch,
             100 => GamePacketCode::Ping,
             101 => GamePacketCode::Pong,
             200 => GamePacketCode::Disconnect,
@@ -460,7 +469,8 @@ pub unsafe extern "C" fn Platform_Packet_ParseHeader(
 
 /// Get pointer to payload data within a packet
 ///
-/// Returns pointer to payload start, or null on error
+/// Returns pointer to payload start, or null on error or if the payload
+/// is compressed (use Platform_Packet_DecodePayload for those)
 /// Sets out_payload_size to payload size
 #[no_mangle]
 pub unsafe extern "C" fn Platform_Packet_GetPayload(
@@ -468,7 +478,10 @@ pub unsafe extern "C" fn Platform_Packet_GetPayload(
     size: i32,
     out_payload_size: *mut i32,
 ) -> *const u8 {
-    if data.is_null() || size <= GamePacketHeader::SIZE as i32 {
+    if data.is_null()
+        || size <= GamePacketHeader::SIZE as i32
+        || *data.add(8) & PACKET_FLAG_COMPRESSED != 0
+    {
         if !out_payload_size.is_null() {
             *out_payload_size = 0;
         }
@@ -519,6 +532,86 @@ pub unsafe extern "C" fn Platform_Packet_Build(
     total_size as i32
 }
 
+/// Build a packet like Platform_Packet_Build, compressing the payload
+/// when that makes it smaller
+///
+/// The packet goes out raw otherwise, so the buffer must still fit the
+/// uncompressed packet.
+///
+/// Returns bytes written, or -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Packet_BuildCompressed(
+    code: u8,
+    sequence: u32,
+    player_id: u8,
+    payload: *const u8,
+    payload_size: i32,
+    out_buffer: *mut u8,
+    buffer_size: i32,
+) -> i32 {
+    let total_size = GamePacketHeader::SIZE + payload_size.max(0) as usize;
+    if out_buffer.is_null() || buffer_size < total_size as i32 {
+        return -1;
+    }
+    if payload.is_null() || payload_size <= 0 {
+        return Platform_Packet_Build(code, sequence, player_id, payload, 0, out_buffer, buffer_size);
+    }
+
+    let input = std::slice::from_raw_parts(payload, payload_size as usize);
+    let mut header = GamePacketHeader::new(GamePacketCode::from(code), sequence, player_id);
+    header.flags = PACKET_FLAG_COMPRESSED;
+    let mut packet = header.to_bytes().to_vec();
+    if !PayloadCompressor::new().compress(input, &mut packet) {
+        return Platform_Packet_Build(
+            code, sequence, player_id, payload, payload_size, out_buffer, buffer_size,
+        );
+    }
+
+    std::ptr::copy_nonoverlapping(packet.as_ptr(), out_buffer, packet.len());
+    packet.len() as i32
+}
+
+/// Copy a packet's payload out, decompressing it if flagged
+///
+/// Works on raw packets too, so receivers can use it for everything.
+///
+/// Returns payload bytes written, or -1 on error (bad header, corrupt
+/// payload, or a buffer too small for it)
+#[no_mangle]
+pub unsafe extern "C" fn Platform_Packet_DecodePayload(
+    data: *const u8,
+    size: i32,
+    out_payload: *mut u8,
+    payload_capacity: i32,
+) -> i32 {
+    if data.is_null() || out_payload.is_null() || size < GamePacketHeader::SIZE as i32 {
+        return -1;
+    }
+
+    let slice = std::slice::from_raw_parts(data, size as usize);
+    let header = match GamePacketHeader::from_bytes(slice) {
+        Some(h) if h.is_valid() => h,
+        _ => return -1,
+    };
+
+    let body = &slice[GamePacketHeader::SIZE..];
+    let mut decoded = Vec::new();
+    let payload = if header.flags & PACKET_FLAG_COMPRESSED != 0 {
+        if !decompress_payload(body, &mut decoded) {
+            return -1;
+        }
+        &decoded[..]
+    } else {
+        body
+    };
+
+    if payload.len() > payload_capacity.max(0) as usize {
+        return -1;
+    }
+    std::ptr::copy_nonoverlapping(payload.as_ptr(), out_payload, payload.len());
+    payload.len() as i32
+}
+
 // =============================================================================
 // Unit Tests
 // =============================================================================
@@ -698,4 +791,59 @@ mod tests {
             assert_eq!(extracted, payload);
         }
     }
+
+    #[test]
+    fn test_ffi_packet_build_compressed() {
+        unsafe {
+            let payload = [0u8; 48];
+            let mut buffer = [0u8; 64];
+
+            let result = Platform_Packet_BuildCompressed(
+                GamePacketCode::GameCommands as u8,
+                5,
+                1,
+                payload.as_ptr(),
+                payload.len() as i32,
+                buffer.as_mut_ptr(),
+                buffer.len() as i32,
+            );
+            assert!(result > 0 && (result as usize) < GamePacketHeader::SIZE + payload.len());
+            assert_eq!(Platform_Packet_ValidateHeader(buffer.as_ptr(), result), 1);
+            assert!(Platform_Packet_GetPayload(buffer.as_ptr(), result, std::ptr::null_mut()).is_null());
+
+            let mut decoded = [0xAAu8; 48];
+            let size = Platform_Packet_DecodePayload(
+                buffer.as_ptr(),
+                result,
+                decoded.as_mut_ptr(),
+                decoded.len() as i32,
+            );
+            assert_eq!(size, 48);
+            assert_eq!(decoded, payload);
+            assert_eq!(
+                Platform_Packet_DecodePayload(buffer.as_ptr(), result, decoded.as_mut_ptr(), 47),
+                -1
+            );
+
+            // A payload that doesn't shrink goes out raw
+            let text = b"test";
+            let result = Platform_Packet_BuildCompressed(
+                GamePacketCode::ChatMessage as u8,
+                6,
+                1,
+                text.as_ptr(),
+                text.len() as i32,
+                buffer.as_mut_ptr(),
+                buffer.len() as i32,
+            );
+            assert_eq!(result as usize, GamePacketHeader::SIZE + text.len());
+            let size = Platform_Packet_DecodePayload(
+                buffer.as_ptr(),
+                result,
+                decoded.as_mut_ptr(),
+                decoded.len() as i32,
+            );
+            assert_eq!(&decoded[..size as usize], text);
+        }
+    }
 }
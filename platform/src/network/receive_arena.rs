@@ -0,0 +1,302 @@
+//! Receive arena for batched packet delivery
+//!
+//! Received packets are appended back to back into a byte buffer instead
+//! of each getting its own `Vec<u8>`. The buffers keep their capacity, so
+//! once a session has warmed up, receiving allocates nothing.
+//!
+//! Two buffers take turns: `service()` fills the incoming one while the
+//! game reads the other through `PacketView`s. A batch receive swaps them,
+//! and the views stay valid until the batch is released, because nothing
+//! is written to the lent buffer in the meantime.
+
+/// Packet descriptor filled by the batch receive calls
+///
+/// `data` points into the receive arena and is valid until the batch is
+/// released.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct PacketView {
+    /// Packet bytes
+    pub data: *const u8,
+    /// Packet size in bytes
+    pub size: u32,
+    /// Index of the peer that sent the packet (0 = host, for clients)
+    pub peer_index: u32,
+    /// Channel the packet was received on
+    pub channel: u8,
+}
+
+impl Default for PacketView {
+    fn default() -> Self {
+        Self {
+            data: std::ptr::null(),
+            size: 0,
+            peer_index: 0,
+            channel: 0,
+        }
+    }
+}
+
+/// Where a packet sits in a buffer
+#[derive(Debug, Clone, Copy)]
+struct Slot {
+    offset: usize,
+    size: usize,
+    peer_index: u32,
+    channel: u8,
+}
+
+/// Packets stored back to back, read front to back
+#[derive(Debug, Default)]
+struct Buffer {
+    bytes: Vec<u8>,
+    slots: Vec<Slot>,
+    read: usize,
+}
+
+impl Buffer {
+    fn pending(&self) -> usize {
+        self.slots.len() - self.read
+    }
+
+    fn clear(&mut self) {
+        self.bytes.clear();
+        self.slots.clear();
+        self.read = 0;
+    }
+
+    fn pop(&mut self) -> Option<(Slot, &[u8])> {
+        let slot = *self.slots.get(self.read)?;
+        self.read += 1;
+        Some((slot, &self.bytes[slot.offset..slot.offset + slot.size]))
+    }
+}
+
+/// Double-buffered store for received packets
+#[derive(Debug, Default)]
+pub struct ReceiveArena {
+    /// Filled by service()
+    incoming: Buffer,
+    /// Handed out by receive_batch(); holds the older packets
+    lent: Buffer,
+    /// Views into `lent` may be outstanding
+    batch_open: bool,
+}
+
+impl ReceiveArena {
+    /// Create an empty arena
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Queue a received packet
+    pub fn push(&mut self, peer_index: u32, channel: u8, data: &[u8]) {
+        let offset = self.incoming.bytes.len();
+        self.incoming.bytes.extend_from_slice(data);
+        self.incoming.slots.push(Slot {
+            offset,
+            size: data.len(),
+            peer_index,
+            channel,
+        });
+    }
+
+    /// Number of packets not yet received
+    pub fn len(&self) -> usize {
+        self.lent.pending() + self.incoming.pending()
+    }
+
+    /// True if no packets are waiting
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Receive the next packet by copying it into `buffer`
+    ///
+    /// # Returns
+    /// `(bytes copied, peer index, channel)`, or `None` if no packet is
+    /// waiting. A packet larger than `buffer` is truncated.
+    pub fn pop_into(&mut self, buffer: &mut [u8]) -> Option<(usize, u32, u8)> {
+        let (slot, data) = match self.lent.pop() {
+            Some(packet) => packet,
+            None => self.incoming.pop()?,
+        };
+        let copied = data.len().min(buffer.len());
+        buffer[..copied].copy_from_slice(&data[..copied]);
+        self.recycle();
+        Some((copied, slot.peer_index, slot.channel))
+    }
+
+    /// Receive the next packet as an owned vector
+    ///
+    /// Allocates; kept for callers that hold on to packets.
+    pub fn pop(&mut self) -> Option<(u32, u8, Vec<u8>)> {
+        let (slot, data) = match self.lent.pop() {
+            Some(packet) => packet,
+            None => self.incoming.pop()?,
+        };
+        let packet = (slot.peer_index, slot.channel, data.to_vec());
+        self.recycle();
+        Some(packet)
+    }
+
+    /// Fill `out` with views of the waiting packets
+    ///
+    /// Packets queued since the last release are taken as one batch;
+    /// calling again before `release_batch()` continues through the same
+    /// batch. Views stay valid until `release_batch()`.
+    ///
+    /// # Returns
+    /// Number of views written
+    pub fn receive_batch(&mut self, out: &mut [PacketView]) -> usize {
+        if !self.batch_open && self.lent.pending() == 0 {
+            self.lent.clear();
+            std::mem::swap(&mut self.lent, &mut self.incoming);
+        }
+        self.batch_open = true;
+
+        let mut count = 0;
+        while count < out.len() {
+            let (slot, data) = match self.lent.pop() {
+                Some(packet) => packet,
+                None => break,
+            };
+            out[count] = PacketView {
+                data: data.as_ptr(),
+                size: slot.size as u32,
+                peer_index: slot.peer_index,
+                channel: slot.channel,
+            };
+            count += 1;
+        }
+        count
+    }
+
+    /// End the batch: views from `receive_batch()` are no longer valid
+    pub fn release_batch(&mut self) {
+        self.batch_open = false;
+        self.recycle();
+    }
+
+    /// Reset buffers that have been read through
+    fn recycle(&mut self) {
+        if !self.batch_open && self.lent.pending() == 0 {
+            self.lent.clear();
+        }
+        if self.incoming.pending() == 0 {
+            self.incoming.clear();
+        }
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn view_bytes(view: &PacketView) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(view.data, view.size as usize) }
+    }
+
+    #[test]
+    fn test_pop_in_order() {
+        let mut arena = ReceiveArena::new();
+        arena.push(1, 0, b"first");
+        arena.push(2, 1, b"second");
+        assert_eq!(arena.len(), 2);
+
+        let mut buffer = [0u8; 16];
+        assert_eq!(arena.pop_into(&mut buffer), Some((5, 1, 0)));
+        assert_eq!(&buffer[..5], b"first");
+        assert_eq!(arena.pop(), Some((2, 1, b"second".to_vec())));
+        assert!(arena.is_empty());
+        assert_eq!(arena.pop_into(&mut buffer), None);
+    }
+
+    #[test]
+    fn test_pop_truncates() {
+        let mut arena = ReceiveArena::new();
+        arena.push(0, 0, b"truncated");
+
+        let mut buffer = [0u8; 4];
+        assert_eq!(arena.pop_into(&mut buffer), Some((4, 0, 0)));
+        assert_eq!(&buffer, b"trun");
+    }
+
+    #[test]
+    fn test_batch_views_survive_new_packets() {
+        let mut arena = ReceiveArena::new();
+        arena.push(0, 0, b"one");
+        arena.push(3, 1, b"two");
+
+        let mut views = [PacketView::default(); 8];
+        assert_eq!(arena.receive_batch(&mut views), 2);
+
+        // Packets arriving mid-batch go to the other buffer
+        for i in 0..1000u32 {
+            arena.push(i, 0, &i.to_le_bytes());
+        }
+        assert_eq!(view_bytes(&views[0]), b"one");
+        assert_eq!(view_bytes(&views[1]), b"two");
+        assert_eq!(views[1].peer_index, 3);
+        assert_eq!(views[1].channel, 1);
+
+        // They wait for the next batch
+        assert_eq!(arena.receive_batch(&mut views), 0);
+        arena.release_batch();
+        assert_eq!(arena.len(), 1000);
+        assert_eq!(arena.receive_batch(&mut views), 8);
+        assert_eq!(view_bytes(&views[7]), &7u32.to_le_bytes());
+    }
+
+    #[test]
+    fn test_batch_continues_across_calls() {
+        let mut arena = ReceiveArena::new();
+        for i in 0..5u8 {
+            arena.push(0, 0, &[i]);
+        }
+
+        let mut views = [PacketView::default(); 2];
+        assert_eq!(arena.receive_batch(&mut views), 2);
+        assert_eq!(arena.receive_batch(&mut views), 2);
+        assert_eq!(view_bytes(&views[1]), &[3]);
+        arena.release_batch();
+
+        // The unread packet is still first in line
+        let mut buffer = [0u8; 1];
+        assert_eq!(arena.pop_into(&mut buffer), Some((1, 0, 0)));
+        assert_eq!(buffer[0], 4);
+        assert!(arena.is_empty());
+    }
+
+    #[test]
+    fn test_capacity_reused() {
+        let mut arena = ReceiveArena::new();
+        let mut views = [PacketView::default(); 4];
+        let payload = [0xAAu8; 64];
+
+        for _ in 0..3 {
+            for _ in 0..4 {
+                arena.push(0, 0, &payload);
+            }
+            assert_eq!(arena.receive_batch(&mut views), 4);
+            arena.release_batch();
+        }
+
+        // Both buffers have warmed up; later frames stay in place
+        let lent = arena.lent.bytes.as_ptr();
+        let incoming = arena.incoming.bytes.as_ptr();
+        for _ in 0..2 {
+            for _ in 0..4 {
+                arena.push(0, 0, &payload);
+            }
+            assert_eq!(arena.receive_batch(&mut views), 4);
+            arena.release_batch();
+        }
+        let now = [arena.lent.bytes.as_ptr(), arena.incoming.bytes.as_ptr()];
+        assert!(now.contains(&lent) && now.contains(&incoming));
+    }
+}
@@ -0,0 +1,722 @@
+//! Network service thread
+//!
+//! With `NetworkManager` the game loop pumps enet, so a long frame or a
+//! loading screen delays acks and keepalives and adds its length to every
+//! packet's latency. `NetworkThread` moves the host or client onto a
+//! thread of its own that services enet about once a millisecond and
+//! trades packets with the game through two SPSC rings.
+//!
+//! Packets are stamped on arrival with the input clock
+//! (`Platform_Input_GetTimeUs`), so the game can see how long they waited
+//! for it; the thread keeps an inter-arrival jitter estimate alongside.
+
+use super::client::{ClientState, ConnectConfig, PlatformClient};
+use super::host::{HostConfig, PlatformHost};
+use super::receive_arena::PacketView;
+use super::spsc::{spsc_ring, Consumer, Producer};
+use super::{NetworkError, NetworkResult};
+use std::sync::atomic::{AtomicBool, AtomicI32, AtomicU32, Ordering};
+use std::sync::{mpsc, Arc};
+use std::thread::{self, JoinHandle};
+
+/// Packets each ring holds; a full outgoing ring fails the send, a full
+/// incoming ring leaves packets with enet until the game catches up
+pub(crate) const NET_THREAD_RING_SIZE: usize = 1024;
+
+/// Longest the thread blocks in enet before checking for outgoing packets
+const SERVICE_WAIT_MS: u32 = 1;
+
+/// Received packets moved to the ring per pass
+const RECEIVE_BATCH: usize = 64;
+
+/// Service thread status
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum NetThreadStatus {
+    /// Thread starting
+    Starting = 0,
+    /// Client connecting to the server
+    Connecting = 1,
+    /// Hosting, or connected to the server
+    Running = 2,
+    /// Host creation or connection failed
+    Failed = 3,
+    /// Server connection lost
+    Disconnected = 4,
+    /// Thread stopped
+    Stopped = 5,
+}
+
+impl From<i32> for NetThreadStatus {
+    fn from(value: i32) -> Self {
+        match value {
+            0 => NetThreadStatus::Starting,
+            1 => NetThreadStatus::Connecting,
+            2 => NetThreadStatus::Running,
+            3 => NetThreadStatus::Failed,
+            4 => NetThreadStatus::Disconnected,
+            _ => NetThreadStatus::Stopped,
+        }
+    }
+}
+
+/// Service thread counters
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct NetThreadStats {
+    /// Packets handed to the game
+    pub packets_received: u32,
+    /// Packets passed to enet
+    pub packets_sent: u32,
+    /// Sends refused because the outgoing ring was full
+    pub send_overflows: u32,
+    /// Arrival-to-read time of the last packet read, microseconds
+    pub last_queue_delay_us: u32,
+    /// Longest arrival-to-read time, microseconds
+    pub max_queue_delay_us: u32,
+    /// Smoothed variation between packet inter-arrival times, microseconds
+    pub jitter_us: u32,
+}
+
+/// A packet travelling from the game to the thread
+#[derive(Debug, Default)]
+pub struct OutgoingPacket {
+    pub channel: u8,
+    pub reliable: bool,
+    pub data: Vec<u8>,
+}
+
+/// A packet travelling from the thread to the game
+#[derive(Debug, Default)]
+pub struct IncomingPacket {
+    /// Sending peer (0 = host, for clients)
+    pub peer_index: u32,
+    pub channel: u8,
+    /// When the thread took the packet from enet (input clock)
+    pub arrival_us: u64,
+    pub data: Vec<u8>,
+}
+
+/// State the thread publishes to the game
+struct Shared {
+    running: AtomicBool,
+    status: AtomicI32,
+    peer_count: AtomicU32,
+    packets_received: AtomicU32,
+    packets_sent: AtomicU32,
+    jitter_us: AtomicU32,
+}
+
+impl Shared {
+    fn set_status(&self, status: NetThreadStatus) {
+        self.status.store(status as i32, Ordering::Release);
+    }
+}
+
+/// What the thread services
+enum Endpoint {
+    Host(PlatformHost),
+    Client(PlatformClient),
+}
+
+impl Endpoint {
+    fn send(&mut self, packet: &OutgoingPacket) -> NetworkResult<()> {
+        match self {
+            Endpoint::Host(host) => host.broadcast(packet.channel, &packet.data, packet.reliable),
+            Endpoint::Client(client) => client.send(packet.channel, &packet.data, packet.reliable),
+        }
+    }
+
+    fn service(&mut self, timeout_ms: u32) {
+        let result = match self {
+            Endpoint::Host(host) => host.service(timeout_ms).map(|_| ()),
+            Endpoint::Client(client) => client.service(timeout_ms).map(|_| ()),
+        };
+        if let Err(e) = result {
+            log::warn!("Network thread service failed: {}", e);
+        }
+    }
+
+    fn receive_batch(&mut self, out: &mut [PacketView]) -> usize {
+        match self {
+            Endpoint::Host(host) => host.receive_batch(out),
+            Endpoint::Client(client) => client.receive_batch(out),
+        }
+    }
+
+    fn release_batch(&mut self) {
+        match self {
+            Endpoint::Host(host) => host.release_batch(),
+            Endpoint::Client(client) => client.release_batch(),
+        }
+    }
+
+    fn publish(&self, shared: &Shared) {
+        match self {
+            Endpoint::Host(host) => {
+                shared.set_status(NetThreadStatus::Running);
+                shared.peer_count.store(host.peer_count(), Ordering::Relaxed);
+            }
+            Endpoint::Client(client) => {
+                let status = match client.state() {
+                    ClientState::Connecting => NetThreadStatus::Connecting,
+                    ClientState::Connected => NetThreadStatus::Running,
+                    ClientState::Failed => NetThreadStatus::Failed,
+                    ClientState::Disconnected => NetThreadStatus::Disconnected,
+                };
+                shared.set_status(status);
+                let peers = if client.is_connected() { 1 } else { 0 };
+                shared.peer_count.store(peers, Ordering::Relaxed);
+            }
+        }
+    }
+}
+
+/// Inter-arrival jitter, smoothed over 16 packets as in RFC 3550
+#[derive(Default)]
+struct JitterEstimate {
+    last_arrival_us: u64,
+    last_interval_us: u64,
+    jitter_us: u64,
+}
+
+impl JitterEstimate {
+    fn add(&mut self, arrival_us: u64) -> u32 {
+        if self.last_arrival_us != 0 {
+            let interval = arrival_us.saturating_sub(self.last_arrival_us);
+            let deviation = interval.abs_diff(self.last_interval_us);
+            self.jitter_us = (self.jitter_us * 15 + deviation) / 16;
+            self.last_interval_us = interval;
+        }
+        self.last_arrival_us = arrival_us;
+        self.jitter_us.min(u32::MAX as u64) as u32
+    }
+}
+
+fn run(
+    mut endpoint: Endpoint,
+    shared: Arc<Shared>,
+    mut outgoing: Consumer<OutgoingPacket>,
+    mut incoming: Producer<IncomingPacket>,
+) {
+    let mut views = [PacketView::default(); RECEIVE_BATCH];
+    let mut jitter = JitterEstimate::default();
+
+    while shared.running.load(Ordering::Acquire) {
+        // Send what the game queued since the last pass
+        let mut sent = 0;
+        while let Some(result) = outgoing.pop_with(|packet| endpoint.send(packet)) {
+            if result.is_ok() {
+                sent += 1;
+            }
+        }
+        if sent > 0 {
+            shared.packets_sent.fetch_add(sent, Ordering::Relaxed);
+        }
+
+        // Wait briefly for traffic, then take whatever else is pending
+        endpoint.service(SERVICE_WAIT_MS);
+        endpoint.service(0);
+        endpoint.publish(&shared);
+
+        // Move received packets to the game, as many as the ring has room for
+        let mut received = 0;
+        loop {
+            let room = NET_THREAD_RING_SIZE - incoming.len();
+            let count = endpoint.receive_batch(&mut views[..room.min(RECEIVE_BATCH)]);
+            if count == 0 {
+                break;
+            }
+
+            let now = crate::input::time_us();
+            for view in &views[..count] {
+                let data = unsafe { std::slice::from_raw_parts(view.data, view.size as usize) };
+                incoming.push_with(|slot| {
+                    slot.peer_index = view.peer_index;
+                    slot.channel = view.channel;
+                    slot.arrival_us = now;
+                    slot.data.clear();
+                    slot.data.extend_from_slice(data);
+                });
+                shared.jitter_us.store(jitter.add(now), Ordering::Relaxed);
+            }
+            received += count as u32;
+        }
+        endpoint.release_batch();
+        if received > 0 {
+            shared.packets_received.fetch_add(received, Ordering::Relaxed);
+        }
+    }
+
+    // Dropping a client disconnects it; push out what's left first
+    if let Endpoint::Client(ref mut client) = endpoint {
+        client.disconnect();
+    }
+    shared.set_status(NetThreadStatus::Stopped);
+}
+
+// =============================================================================
+// NetworkThread
+// =============================================================================
+
+/// A host or client serviced on its own thread
+///
+/// Owned by the game thread. Sends queue to the thread; received packets
+/// wait in a ring until read.
+pub struct NetworkThread {
+    shared: Arc<Shared>,
+    outgoing: Producer<OutgoingPacket>,
+    incoming: Consumer<IncomingPacket>,
+    handle: Option<JoinHandle<()>>,
+    send_overflows: u32,
+    last_queue_delay_us: u32,
+    max_queue_delay_us: u32,
+}
+
+impl NetworkThread {
+    /// Start a thread hosting a game
+    ///
+    /// # Returns
+    /// * `Ok(NetworkThread)` once the host is listening
+    /// * `Err(NetworkError)` if the host could not be created
+    pub fn start_host(config: HostConfig) -> NetworkResult<Self> {
+        Self::start(move || PlatformHost::new(&config).map(Endpoint::Host))
+    }
+
+    /// Start a thread connecting to a server
+    ///
+    /// Returns once the connection attempt is under way; watch `status()`
+    /// for `Running` or `Failed`.
+    pub fn start_client(address: String, port: u16, config: ConnectConfig) -> NetworkResult<Self> {
+        Self::start(move || {
+            let mut client = PlatformClient::new(&config)?;
+            client.connect_async(&address, port, config.channel_count)?;
+            Ok(Endpoint::Client(client))
+        })
+    }
+
+    fn start<F>(create: F) -> NetworkResult<Self>
+    where
+        F: FnOnce() -> NetworkResult<Endpoint> + Send + 'static,
+    {
+        let shared = Arc::new(Shared {
+            running: AtomicBool::new(true),
+            status: AtomicI32::new(NetThreadStatus::Starting as i32),
+            peer_count: AtomicU32::new(0),
+            packets_received: AtomicU32::new(0),
+            packets_sent: AtomicU32::new(0),
+            jitter_us: AtomicU32::new(0),
+        });
+        let (outgoing, thread_outgoing) = spsc_ring(NET_THREAD_RING_SIZE);
+        let (thread_incoming, incoming) = spsc_ring(NET_THREAD_RING_SIZE);
+
+        // enet hosts stay on the thread that made them
+        let (ready_tx, ready_rx) = mpsc::channel();
+        let thread_shared = Arc::clone(&shared);
+        let handle = thread::Builder::new()
+            .name("network".to_string())
+            .spawn(move || match create() {
+                Ok(endpoint) => {
+                    endpoint.publish(&thread_shared);
+                    let _ = ready_tx.send(Ok(()));
+                    run(endpoint, thread_shared, thread_outgoing, thread_incoming);
+                }
+                Err(e) => {
+                    thread_shared.set_status(NetThreadStatus::Failed);
+                    let _ = ready_tx.send(Err(e));
+                }
+            })
+            .map_err(|e| NetworkError::HostCreationFailed(format!("Thread: {}", e)))?;
+
+        let ready = ready_rx
+            .recv()
+            .unwrap_or_else(|_| Err(NetworkError::HostCreationFailed("Thread exited".to_string())));
+        if let Err(e) = ready {
+            let _ = handle.join();
+            return Err(e);
+        }
+
+        log::info!("Network thread started");
+        Ok(Self {
+            shared,
+            outgoing,
+            incoming,
+            handle: Some(handle),
+            send_overflows: 0,
+            last_queue_delay_us: 0,
+            max_queue_delay_us: 0,
+        })
+    }
+
+    /// Queue a packet for the thread to send (broadcast when hosting)
+    ///
+    /// # Returns
+    /// `false` if the outgoing ring is full or the thread has stopped
+    pub fn send(&mut self, channel: u8, data: &[u8], reliable: bool) -> bool {
+        if self.handle.is_none() {
+            return false;
+        }
+        let queued = self.outgoing.push_with(|slot| {
+            slot.channel = channel;
+            slot.reliable = reliable;
+            slot.data.clear();
+            slot.data.extend_from_slice(data);
+        });
+        if !queued {
+            self.send_overflows = self.send_overflows.saturating_add(1);
+        }
+        queued
+    }
+
+    /// Read the next received packet in place
+    ///
+    /// # Returns
+    /// What `read` returned, or `None` if no packet is waiting
+    pub fn receive_with<R, F: FnOnce(&IncomingPacket) -> R>(&mut self, read: F) -> Option<R> {
+        let mut arrival_us = 0;
+        let result = self.incoming.pop_with(|packet| {
+            arrival_us = packet.arrival_us;
+            read(packet)
+        })?;
+
+        let delay = crate::input::time_us().saturating_sub(arrival_us);
+        self.last_queue_delay_us = delay.min(u32::MAX as u64) as u32;
+        self.max_queue_delay_us = self.max_queue_delay_us.max(self.last_queue_delay_us);
+        Some(result)
+    }
+
+    /// Number of received packets waiting
+    pub fn packet_count(&self) -> usize {
+        self.incoming.len()
+    }
+
+    /// Current thread status
+    pub fn status(&self) -> NetThreadStatus {
+        NetThreadStatus::from(self.shared.status.load(Ordering::Acquire))
+    }
+
+    /// Connected peers (the server counts as one for clients)
+    pub fn peer_count(&self) -> u32 {
+        self.shared.peer_count.load(Ordering::Relaxed)
+    }
+
+    /// Counters from both sides of the rings
+    pub fn stats(&self) -> NetThreadStats {
+        NetThreadStats {
+            packets_received: self.shared.packets_received.load(Ordering::Relaxed),
+            packets_sent: self.shared.packets_sent.load(Ordering::Relaxed),
+            send_overflows: self.send_overflows,
+            last_queue_delay_us: self.last_queue_delay_us,
+            max_queue_delay_us: self.max_queue_delay_us,
+            jitter_us: self.shared.jitter_us.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Stop the thread and wait for it (packets still queued are dropped)
+    pub fn stop(&mut self) {
+        if let Some(handle) = self.handle.take() {
+            self.shared.running.store(false, Ordering::Release);
+            let _ = handle.join();
+            log::info!("Network thread stopped");
+        }
+    }
+}
+
+impl Drop for NetworkThread {
+    fn drop(&mut self) {
+        self.stop();
+    }
+}
+
+// =============================================================================
+// FFI Exports
+// =============================================================================
+
+/// Start a network thread hosting a game
+///
+/// # Returns
+/// * Pointer to NetworkThread on success
+/// * null on failure
+#[no_mangle]
+pub extern "C" fn Platform_NetThread_StartHost(
+    port: u16,
+    max_clients: i32,
+    channel_count: i32,
+) -> *mut NetworkThread {
+    let config = HostConfig {
+        port,
+        max_clients: max_clients.max(1) as u32,
+        channel_count: channel_count.max(1) as usize,
+        ..Default::default()
+    };
+
+    match NetworkThread::start_host(config) {
+        Ok(thread) => Box::into_raw(Box::new(thread)),
+        Err(e) => {
+            log::error!("Failed to start network thread: {}", e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Start a network thread connecting to a server
+///
+/// Poll Platform_NetThread_GetStatus for the connection result.
+///
+/// # Returns
+/// * Pointer to NetworkThread on success
+/// * null on failure
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_StartClient(
+    address: *const std::os::raw::c_char,
+    port: u16,
+) -> *mut NetworkThread {
+    if address.is_null() {
+        return std::ptr::null_mut();
+    }
+
+    let addr_str = match std::ffi::CStr::from_ptr(address).to_str() {
+        Ok(s) => s.to_string(),
+        Err(_) => return std::ptr::null_mut(),
+    };
+
+    match NetworkThread::start_client(addr_str, port, ConnectConfig::default()) {
+        Ok(thread) => Box::into_raw(Box::new(thread)),
+        Err(e) => {
+            log::error!("Failed to start network thread: {}", e);
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Stop a network thread and free it
+///
+/// # Safety
+/// * `thread` must be a valid pointer from Platform_NetThread_Start*
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_Stop(thread: *mut NetworkThread) {
+    if !thread.is_null() {
+        let _ = Box::from_raw(thread);
+    }
+}
+
+/// Get the thread status
+///
+/// # Returns
+/// * 0 = Starting, 1 = Connecting, 2 = Running, 3 = Failed,
+///   4 = Disconnected, 5 = Stopped
+/// * -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_GetStatus(thread: *mut NetworkThread) -> i32 {
+    if thread.is_null() {
+        return -1;
+    }
+    (*thread).status() as i32
+}
+
+/// Queue a packet for the thread to send (broadcast when hosting)
+///
+/// # Returns
+/// * 0 on success
+/// * -1 if the outgoing ring is full or on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_Send(
+    thread: *mut NetworkThread,
+    channel: u8,
+    data: *const u8,
+    size: i32,
+    reliable: i32,
+) -> i32 {
+    if thread.is_null() || data.is_null() || size <= 0 {
+        return -1;
+    }
+
+    let data_slice = std::slice::from_raw_parts(data, size as usize);
+    if (*thread).send(channel, data_slice, reliable != 0) {
+        0
+    } else {
+        -1
+    }
+}
+
+/// Receive the next packet
+///
+/// # Arguments
+/// * `thread` - Thread pointer
+/// * `peer_index` - Output: sending peer
+/// * `channel` - Output: channel received on
+/// * `arrival_us` - Output: arrival time on the Platform_Input_GetTimeUs clock
+/// * `buffer` - Buffer to copy packet data into
+/// * `buffer_size` - Size of buffer
+///
+/// # Returns
+/// * Positive: bytes copied (truncated to fit)
+/// * 0: no packet available
+/// * -1: error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_Receive(
+    thread: *mut NetworkThread,
+    peer_index: *mut u32,
+    channel: *mut u8,
+    arrival_us: *mut u64,
+    buffer: *mut u8,
+    buffer_size: i32,
+) -> i32 {
+    if thread.is_null() || buffer.is_null() || buffer_size <= 0 {
+        return -1;
+    }
+
+    let buffer_slice = std::slice::from_raw_parts_mut(buffer, buffer_size as usize);
+    let copied = (*thread).receive_with(|packet| {
+        let copy_size = packet.data.len().min(buffer_slice.len());
+        buffer_slice[..copy_size].copy_from_slice(&packet.data[..copy_size]);
+        if !peer_index.is_null() {
+            *peer_index = packet.peer_index;
+        }
+        if !channel.is_null() {
+            *channel = packet.channel;
+        }
+        if !arrival_us.is_null() {
+            *arrival_us = packet.arrival_us;
+        }
+        copy_size
+    });
+
+    copied.map_or(0, |size| size as i32)
+}
+
+/// Number of received packets waiting
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_PacketCount(thread: *mut NetworkThread) -> i32 {
+    if thread.is_null() {
+        return -1;
+    }
+    (*thread).packet_count() as i32
+}
+
+/// Number of connected peers
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_PeerCount(thread: *mut NetworkThread) -> i32 {
+    if thread.is_null() {
+        return 0;
+    }
+    (*thread).peer_count() as i32
+}
+
+/// Read the thread's counters
+///
+/// # Returns
+/// * 0 on success
+/// * -1 on error
+#[no_mangle]
+pub unsafe extern "C" fn Platform_NetThread_GetStats(
+    thread: *mut NetworkThread,
+    stats: *mut NetThreadStats,
+) -> i32 {
+    if thread.is_null() || stats.is_null() {
+        return -1;
+    }
+    *stats = (*thread).stats();
+    0
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ensure_init() {
+        let _ = super::super::init();
+    }
+
+    #[test]
+    fn test_host_thread_lifecycle() {
+        ensure_init();
+
+        let config = HostConfig {
+            port: 16100,
+            ..Default::default()
+        };
+        match NetworkThread::start_host(config) {
+            Ok(mut thread) => {
+                assert_eq!(thread.status(), NetThreadStatus::Running);
+                assert_eq!(thread.peer_count(), 0);
+                assert!(thread.send(0, b"hello", true));
+                assert_eq!(thread.receive_with(|_| ()), None);
+
+                thread.stop();
+                assert_eq!(thread.status(), NetThreadStatus::Stopped);
+                assert!(!thread.send(0, b"late", true));
+            }
+            Err(e) => {
+                // May fail if the port is in use; the lifecycle is not testable then
+                log::warn!("Host thread failed (port in use?): {}", e);
+            }
+        }
+    }
+
+    #[test]
+    fn test_jitter_estimate() {
+        let mut jitter = JitterEstimate::default();
+
+        // Evenly spaced packets settle to no jitter
+        for i in 1..=64 {
+            jitter.add(i * 1000);
+        }
+        let steady = jitter.add(65 * 1000);
+        assert!(steady < 100);
+
+        // Alternating 0.5ms/1.5ms spacing shows up
+        let mut t = 65 * 1000;
+        let mut last = 0;
+        for i in 0..64 {
+            t += if i % 2 == 0 { 500 } else { 1500 };
+            last = jitter.add(t);
+        }
+        assert!(last > 500);
+    }
+
+    #[test]
+    fn test_status_conversion() {
+        assert_eq!(NetThreadStatus::from(2), NetThreadStatus::Running);
+        assert_eq!(NetThreadStatus::from(3), NetThreadStatus::Failed);
+        assert_eq!(NetThreadStatus::from(42), NetThreadStatus::Stopped);
+    }
+
+    #[test]
+    fn test_ffi_null_safety() {
+        unsafe {
+            assert!(Platform_NetThread_StartClient(std::ptr::null(), 5555).is_null());
+            assert_eq!(Platform_NetThread_GetStatus(std::ptr::null_mut()), -1);
+            assert_eq!(Platform_NetThread_PacketCount(std::ptr::null_mut()), -1);
+            assert_eq!(Platform_NetThread_PeerCount(std::ptr::null_mut()), 0);
+
+            let data = [1u8; 4];
+            assert_eq!(
+                Platform_NetThread_Send(std::ptr::null_mut(), 0, data.as_ptr(), 4, 1),
+                -1
+            );
+
+            let mut buffer = [0u8; 16];
+            assert_eq!(
+                Platform_NetThread_Receive(
+                    std::ptr::null_mut(),
+                    std::ptr::null_mut(),
+                    std::ptr::null_mut(),
+                    std::ptr::null_mut(),
+                    buffer.as_mut_ptr(),
+                    16
+                ),
+                -1
+            );
+
+            let mut stats = NetThreadStats::default();
+            assert_eq!(Platform_NetThread_GetStats(std::ptr::null_mut(), &mut stats), -1);
+
+            Platform_NetThread_Stop(std::ptr::null_mut()); // Should not panic
+        }
+    }
+}
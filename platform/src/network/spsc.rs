@@ -0,0 +1,198 @@
+//! Single-producer single-consumer ring buffer
+//!
+//! Hands packets between the network thread and the game thread without
+//! locks. Slots are filled and read in place, so slot types that own a
+//! buffer (a `Vec<u8>`, say) keep their capacity from lap to lap and the
+//! steady state allocates nothing.
+//!
+//! `spsc_ring()` returns the two ends; each can move to its own thread
+//! but neither can be cloned, which is what makes the unsynchronized slot
+//! access sound.
+
+use std::cell::UnsafeCell;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Arc;
+
+struct Ring<T> {
+    slots: Box<[UnsafeCell<T>]>,
+    mask: usize,
+    /// Slots written (producer-owned)
+    head: AtomicUsize,
+    /// Slots read (consumer-owned)
+    tail: AtomicUsize,
+}
+
+// Each slot is touched by one side at a time, handed over by head/tail
+unsafe impl<T: Send> Sync for Ring<T> {}
+
+impl<T> Ring<T> {
+    fn len(&self) -> usize {
+        let head = self.head.load(Ordering::Acquire);
+        let tail = self.tail.load(Ordering::Acquire);
+        head.wrapping_sub(tail)
+    }
+}
+
+/// Writing end of an SPSC ring
+pub struct Producer<T> {
+    ring: Arc<Ring<T>>,
+}
+
+/// Reading end of an SPSC ring
+pub struct Consumer<T> {
+    ring: Arc<Ring<T>>,
+}
+
+/// Create a ring holding at least `capacity` items (rounded up to a power
+/// of two)
+pub fn spsc_ring<T: Default + Send>(capacity: usize) -> (Producer<T>, Consumer<T>) {
+    let capacity = capacity.max(2).next_power_of_two();
+    let slots: Vec<UnsafeCell<T>> = (0..capacity).map(|_| UnsafeCell::new(T::default())).collect();
+    let ring = Arc::new(Ring {
+        slots: slots.into_boxed_slice(),
+        mask: capacity - 1,
+        head: AtomicUsize::new(0),
+        tail: AtomicUsize::new(0),
+    });
+    (
+        Producer {
+            ring: Arc::clone(&ring),
+        },
+        Consumer { ring },
+    )
+}
+
+impl<T> Producer<T> {
+    /// Fill the next free slot in place and publish it
+    ///
+    /// The slot still holds whatever was last read from it; `fill` should
+    /// overwrite every field it relies on.
+    ///
+    /// # Returns
+    /// `false` (and `fill` is not called) if the ring is full
+    pub fn push_with<F: FnOnce(&mut T)>(&mut self, fill: F) -> bool {
+        let ring = &*self.ring;
+        let head = ring.head.load(Ordering::Relaxed);
+        let tail = ring.tail.load(Ordering::Acquire);
+        if head.wrapping_sub(tail) > ring.mask {
+            return false;
+        }
+
+        // The consumer is done with this slot until head moves past it
+        fill(unsafe { &mut *ring.slots[head & ring.mask].get() });
+        ring.head.store(head.wrapping_add(1), Ordering::Release);
+        true
+    }
+
+    /// Items waiting to be read
+    pub fn len(&self) -> usize {
+        self.ring.len()
+    }
+
+    pub fn is_full(&self) -> bool {
+        self.ring.len() > self.ring.mask
+    }
+}
+
+impl<T> Consumer<T> {
+    /// Read the oldest item in place and release its slot
+    ///
+    /// # Returns
+    /// What `read` returned, or `None` if the ring is empty
+    pub fn pop_with<R, F: FnOnce(&mut T) -> R>(&mut self, read: F) -> Option<R> {
+        let ring = &*self.ring;
+        let tail = ring.tail.load(Ordering::Relaxed);
+        let head = ring.head.load(Ordering::Acquire);
+        if tail == head {
+            return None;
+        }
+
+        // The producer won't reuse this slot until tail moves past it
+        let result = read(unsafe { &mut *ring.slots[tail & ring.mask].get() });
+        ring.tail.store(tail.wrapping_add(1), Ordering::Release);
+        Some(result)
+    }
+
+    /// Items waiting to be read
+    pub fn len(&self) -> usize {
+        self.ring.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.ring.len() == 0
+    }
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::thread;
+
+    #[test]
+    fn test_fifo_and_full() {
+        let (mut producer, mut consumer) = spsc_ring::<u32>(3);
+        for i in 0..4 {
+            assert!(producer.push_with(|slot| *slot = i));
+        }
+        assert!(producer.is_full());
+        assert!(!producer.push_with(|slot| *slot = 99));
+
+        for i in 0..4 {
+            assert_eq!(consumer.pop_with(|slot| *slot), Some(i));
+        }
+        assert!(consumer.is_empty());
+        assert_eq!(consumer.pop_with(|slot| *slot), None);
+    }
+
+    #[test]
+    fn test_slot_buffers_reused() {
+        let (mut producer, mut consumer) = spsc_ring::<Vec<u8>>(2);
+        for _ in 0..2 {
+            producer.push_with(|slot| {
+                slot.clear();
+                slot.extend_from_slice(&[1u8; 64]);
+            });
+        }
+        let first = consumer.pop_with(|slot| slot.as_ptr()).unwrap();
+        consumer.pop_with(|_| ());
+
+        producer.push_with(|slot| {
+            slot.clear();
+            slot.extend_from_slice(&[2u8; 32]);
+        });
+        assert_eq!(consumer.pop_with(|slot| slot.as_ptr()), Some(first));
+    }
+
+    #[test]
+    fn test_across_threads() {
+        let (mut producer, mut consumer) = spsc_ring::<u64>(16);
+        const COUNT: u64 = 100_000;
+
+        let writer = thread::spawn(move || {
+            let mut next = 0;
+            while next < COUNT {
+                if producer.push_with(|slot| *slot = next) {
+                    next += 1;
+                } else {
+                    thread::yield_now();
+                }
+            }
+        });
+
+        let mut expected = 0;
+        while expected < COUNT {
+            match consumer.pop_with(|slot| *slot) {
+                Some(value) => {
+                    assert_eq!(value, expected);
+                    expected += 1;
+                }
+                None => thread::yield_now(),
+            }
+        }
+        writer.join().unwrap();
+    }
+}
@@ -15,7 +15,7 @@ use super::{
     GamePacketHeader, GamePacketCode, GamePacket, DeliveryMode,
     serialize_packet, deserialize_packet, create_ping_packet, create_pong_packet,
     PACKET_MAGIC,
-    NetworkManager, NetworkMode,
+    NetworkManager, NetworkMode, NetConditions,
     // FFI functions
     Platform_Network_Init, Platform_Network_Shutdown, Platform_Network_IsInitialized,
     Platform_Host_Create, Platform_Host_Destroy, Platform_Host_Service,
@@ -663,6 +663,59 @@ fn test_network_manager_ffi() {
     teardown();
 }
 
+#[test]
+fn test_network_manager_conditioned_link() {
+    setup();
+
+    let mut host = NetworkManager::new();
+    host.host_game("Conditioned", 16032, 4).expect("Failed to host game");
+    host.set_conditions(Some(NetConditions {
+        latency_ms: 80,
+        jitter_ms: 10,
+        seed: 7,
+        ..Default::default()
+    }));
+
+    let mut client = NetworkManager::new();
+    client.join_game_async("127.0.0.1", 16032).expect("Connect failed");
+    for _ in 0..50 {
+        let _ = host.update();
+        let _ = client.update();
+        if client.is_connected() {
+            break;
+        }
+        thread::sleep(Duration::from_millis(10));
+    }
+    assert!(client.is_connected(), "Client failed to connect");
+
+    // Drop anything that arrived while connecting
+    let _ = host.update();
+    while host.receive().is_some() {}
+
+    let sent = std::time::Instant::now();
+    client.send_packet(GamePacketCode::ChatMessage, b"slow link", true).expect("Send failed");
+    let mut arrived = None;
+    for _ in 0..100 {
+        let _ = client.update();
+        let _ = host.update();
+        if let Some(packet) = host.receive() {
+            arrived = Some((sent.elapsed(), packet));
+            break;
+        }
+        thread::sleep(Duration::from_millis(5));
+    }
+
+    let (elapsed, packet) = arrived.expect("Host did not receive the packet");
+    assert!(elapsed >= Duration::from_millis(80), "Arrived after only {:?}", elapsed);
+    let (_, payload) = deserialize_packet(&packet.data).expect("Bad packet");
+    assert_eq!(payload, b"slow link");
+    assert_eq!(host.conditioner_stats().unwrap().dropped, 0);
+
+    client.disconnect();
+    host.disconnect();
+    teardown();
+}
+
 // =============================================================================
 // Stress Tests
 // =============================================================================
@@ -164,27 +164,97 @@ pub fn create_timer_c(
 static FRAME_CONTROLLER: Lazy<Mutex<FrameRateController>> =
     Lazy::new(|| Mutex::new(FrameRateController::new(60)));
 
+/// How much of a frame's wait is spun rather than slept, by default
+/// (microseconds). Covers the usual sleep overshoot on desktop kernels.
+pub(crate) const DEFAULT_SPIN_THRESHOLD_US: u32 = 1000;
+
+/// Frame intervals kept for FramePacingStats
+const PACING_HISTORY: usize = 120;
+
+/// How regularly frames have been ending, over the last PACING_HISTORY
+///
+/// An interval is the time from one end_frame() return to the next, so
+/// it is what the display sees, pacing wait included.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct FramePacingStats {
+    /// Last frame interval (ms)
+    pub last_ms: f64,
+    /// Mean frame interval (ms)
+    pub mean_ms: f64,
+    /// Standard deviation of the frame interval (ms)
+    pub stddev_ms: f64,
+    /// Shortest and longest frame interval (ms)
+    pub min_ms: f64,
+    pub max_ms: f64,
+    /// Mean time sleep returned past its wake-up time (us)
+    pub sleep_overshoot_us: f64,
+    /// Mean time spun per frame (us)
+    pub spin_us: f64,
+    /// Frames that ended more than a period past their deadline
+    pub late_frames: u32,
+    /// Intervals the stats cover
+    pub frames: u32,
+}
+
 /// Frame rate controller for game loop
+///
+/// Frames are held to deadlines one period apart on the performance
+/// counter, so a frame that ends early doesn't pull the next one in and
+/// millisecond rounding doesn't add up. The wait sleeps until
+/// `spin_threshold` before the deadline and spins the rest.
+///
+/// With vsync, presents already wait for the display: at a target the
+/// display reaches on its own nothing is slept, and below it the period
+/// is rounded to whole refreshes and the wait ends half a refresh early,
+/// so the present makes the intended vblank rather than the one after.
 pub struct FrameRateController {
     frame_start: Instant,
     target_fps: u32,
+    /// Sleep in end_frame; off when the caller paces frames itself
+    limiter: bool,
+    spin_threshold_ns: u64,
+    /// Display refresh when presents wait for vsync, else 0
+    vsync_refresh_hz: u32,
+    /// When the current frame should end (performance counter, ns)
+    deadline_ns: u64,
+    /// When the last end_frame returned (0 = not yet)
+    last_end_ns: u64,
     frame_time: f64,
     fps: f64,
     fps_samples: [f64; 60],
     fps_sample_index: usize,
     fps_sample_count: usize,
+    intervals_ms: [f64; PACING_HISTORY],
+    overshoot_ns: [u32; PACING_HISTORY],
+    spin_ns: [u32; PACING_HISTORY],
+    late: [bool; PACING_HISTORY],
+    pacing_index: usize,
+    pacing_count: usize,
 }
 
 impl FrameRateController {
     pub fn new(target_fps: u32) -> Self {
+        let target_fps = target_fps.max(1);
         Self {
             frame_start: Instant::now(),
             target_fps,
+            limiter: true,
+            spin_threshold_ns: DEFAULT_SPIN_THRESHOLD_US as u64 * 1000,
+            vsync_refresh_hz: 0,
+            deadline_ns: 0,
+            last_end_ns: 0,
             frame_time: 1.0 / target_fps as f64,
             fps: target_fps as f64,
             fps_samples: [0.0; 60],
             fps_sample_index: 0,
             fps_sample_count: 0,
+            intervals_ms: [0.0; PACING_HISTORY],
+            overshoot_ns: [0; PACING_HISTORY],
+            spin_ns: [0; PACING_HISTORY],
+            late: [false; PACING_HISTORY],
+            pacing_index: 0,
+            pacing_count: 0,
         }
     }
 
@@ -193,17 +263,33 @@ impl FrameRateController {
         self.frame_start = Instant::now();
     }
 
-    /// Call at end of frame - handles sleeping and FPS calculation
+    /// Call at end of frame - waits for the frame's deadline and updates
+    /// the FPS and pacing stats
     pub fn end_frame(&mut self) {
-        let elapsed = self.frame_start.elapsed().as_secs_f64();
+        let period_ns = self.period_ns();
+        let now = get_performance_counter();
+        if self.deadline_ns == 0 {
+            self.deadline_ns = now + period_ns;
+        }
 
-        // Calculate target frame time
-        let target_time = 1.0 / self.target_fps as f64;
+        // More than a period behind: start the schedule again from here
+        // rather than rush frames out to catch up
+        let late = now > self.deadline_ns + period_ns;
+        if late {
+            self.deadline_ns = now;
+        }
+
+        let (mut overshoot_ns, mut spin_ns) = (0, 0);
+        if self.limiter {
+            if let Some(wake_ns) = self.wake_ns() {
+                (overshoot_ns, spin_ns) = self.wait_until(wake_ns);
+            }
+        }
 
-        // Sleep if we're running too fast
-        let sleep_time = target_time - elapsed;
-        if sleep_time > 0.001 {
-            thread::sleep(Duration::from_secs_f64(sleep_time));
+        let end = get_performance_counter();
+        self.deadline_ns += period_ns;
+        if self.deadline_ns < end {
+            self.deadline_ns = end;
         }
 
         // Recalculate actual frame time
@@ -220,11 +306,135 @@ impl FrameRateController {
             let sum: f64 = self.fps_samples[..self.fps_sample_count].iter().sum();
             self.fps = sum / self.fps_sample_count as f64;
         }
+
+        if self.last_end_ns != 0 {
+            let i = self.pacing_index;
+            self.intervals_ms[i] = (end - self.last_end_ns) as f64 / 1_000_000.0;
+            self.overshoot_ns[i] = overshoot_ns.min(u32::MAX as u64) as u32;
+            self.spin_ns[i] = spin_ns.min(u32::MAX as u64) as u32;
+            self.late[i] = late;
+            self.pacing_index = (i + 1) % PACING_HISTORY;
+            self.pacing_count = (self.pacing_count + 1).min(PACING_HISTORY);
+        }
+        self.last_end_ns = end;
     }
 
-    /// Set target FPS
+    /// Frame period in ns; whole refreshes when vsync paces the display
+    fn period_ns(&self) -> u64 {
+        let period = 1_000_000_000 / self.target_fps as u64;
+        if self.vsync_refresh_hz == 0 {
+            return period;
+        }
+        let refresh = 1_000_000_000 / self.vsync_refresh_hz as u64;
+        let refreshes = ((period + refresh / 2) / refresh).max(1);
+        refreshes * refresh
+    }
+
+    /// When the wait should end, or None if the present's vsync wait
+    /// paces the frame by itself
+    fn wake_ns(&self) -> Option<u64> {
+        if self.vsync_refresh_hz == 0 {
+            return Some(self.deadline_ns);
+        }
+        let refresh = 1_000_000_000 / self.vsync_refresh_hz as u64;
+        if self.period_ns() <= refresh {
+            return None;
+        }
+        Some(self.deadline_ns.saturating_sub(refresh / 2))
+    }
+
+    /// Sleep, then spin, until the performance counter reaches wake_ns
+    ///
+    /// Returns (how far the sleep overshot its wake-up, time spun) in ns.
+    fn wait_until(&self, wake_ns: u64) -> (u64, u64) {
+        let mut now = get_performance_counter();
+        let mut overshoot = 0;
+        if wake_ns > now + self.spin_threshold_ns {
+            let sleep_until = wake_ns - self.spin_threshold_ns;
+            thread::sleep(Duration::from_nanos(sleep_until - now));
+            now = get_performance_counter();
+            overshoot = now.saturating_sub(sleep_until);
+        }
+
+        let spin_start = now;
+        let mut spins = 0u32;
+        while now < wake_ns {
+            std::hint::spin_loop();
+            // Let another thread have the core now and then
+            spins += 1;
+            if spins % 64 == 0 {
+                thread::yield_now();
+            }
+            now = get_performance_counter();
+        }
+        (overshoot, now.saturating_sub(spin_start))
+    }
+
+    /// Set target FPS (starts the pacing stats over)
     pub fn set_target_fps(&mut self, fps: u32) {
-        self.target_fps = fps;
+        self.target_fps = fps.max(1);
+        self.deadline_ns = 0;
+        self.last_end_ns = 0;
+        self.pacing_index = 0;
+        self.pacing_count = 0;
+    }
+
+    /// Get target FPS
+    pub fn target_fps(&self) -> u32 {
+        self.target_fps
+    }
+
+    /// Turn the end_frame sleep on or off (FPS is measured either way)
+    pub fn set_limiter(&mut self, enabled: bool) {
+        self.limiter = enabled;
+        self.deadline_ns = 0;
+    }
+
+    /// How much of the wait to spin instead of sleep (microseconds); 0
+    /// sleeps all of it
+    pub fn set_spin_threshold_us(&mut self, us: u32) {
+        self.spin_threshold_ns = us as u64 * 1000;
+    }
+
+    pub fn spin_threshold_us(&self) -> u32 {
+        (self.spin_threshold_ns / 1000) as u32
+    }
+
+    /// Tell the pacer presents wait for vsync at this refresh rate (0 =
+    /// they don't, or the rate is unknown)
+    pub fn set_vsync_refresh(&mut self, hz: u32) {
+        self.vsync_refresh_hz = hz;
+        self.deadline_ns = 0;
+    }
+
+    pub fn vsync_refresh(&self) -> u32 {
+        self.vsync_refresh_hz
+    }
+
+    /// Frame interval regularity over the recent frames
+    pub fn pacing_stats(&self) -> FramePacingStats {
+        let count = self.pacing_count;
+        if count == 0 {
+            return FramePacingStats::default();
+        }
+        let intervals = &self.intervals_ms[..count];
+        let mean = intervals.iter().sum::<f64>() / count as f64;
+        let variance = intervals.iter().map(|t| (t - mean) * (t - mean)).sum::<f64>() / count as f64;
+        let last = (self.pacing_index + PACING_HISTORY - 1) % PACING_HISTORY;
+
+        FramePacingStats {
+            last_ms: self.intervals_ms[last],
+            mean_ms: mean,
+            stddev_ms: variance.sqrt(),
+            min_ms: intervals.iter().cloned().fold(f64::INFINITY, f64::min),
+            max_ms: intervals.iter().cloned().fold(0.0, f64::max),
+            sleep_overshoot_us: self.overshoot_ns[..count].iter().map(|&n| n as f64).sum::<f64>()
+                / count as f64
+                / 1000.0,
+            spin_us: self.spin_ns[..count].iter().map(|&n| n as f64).sum::<f64>() / count as f64 / 1000.0,
+            late_frames: self.late[..count].iter().filter(|&&l| l).count() as u32,
+            frames: count as u32,
+        }
     }
 
     /// Get frame time in seconds
@@ -355,3 +565,76 @@ impl Default for CountdownTimer {
         Self::new()
     }
 }
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_vsync_period_rounds_to_refreshes() {
+        let mut fc = FrameRateController::new(60);
+        assert_eq!(fc.period_ns(), 16_666_666);
+
+        // 60 on a 144 Hz display: two refreshes is the nearest
+        fc.set_vsync_refresh(144);
+        assert_eq!(fc.period_ns(), 2 * (1_000_000_000 / 144));
+        assert!(fc.wake_ns().is_some());
+
+        // The display's own rate: vsync alone paces it
+        fc.set_target_fps(144);
+        assert_eq!(fc.period_ns(), 1_000_000_000 / 144);
+        assert!(fc.wake_ns().is_none());
+
+        // Above the refresh rate still means one refresh a frame
+        fc.set_target_fps(240);
+        assert_eq!(fc.period_ns(), 1_000_000_000 / 144);
+    }
+
+    #[test]
+    fn test_paced_frames_hit_target() {
+        let mut fc = FrameRateController::new(120);
+        for _ in 0..40 {
+            fc.begin_frame();
+            fc.end_frame();
+        }
+
+        let stats = fc.pacing_stats();
+        assert_eq!(stats.frames, 39);
+        let target_ms = 1000.0 / 120.0;
+        assert!((stats.mean_ms - target_ms).abs() < 0.5, "mean {} ms", stats.mean_ms);
+        assert!(stats.min_ms > 0.0 && stats.max_ms >= stats.min_ms);
+    }
+
+    #[test]
+    fn test_spin_threshold_and_limiter() {
+        let mut fc = FrameRateController::new(60);
+        assert_eq!(fc.spin_threshold_us(), DEFAULT_SPIN_THRESHOLD_US);
+        fc.set_spin_threshold_us(250);
+        assert_eq!(fc.spin_threshold_us(), 250);
+
+        // Unlimited frames don't wait at all
+        fc.set_limiter(false);
+        let start = Instant::now();
+        for _ in 0..10 {
+            fc.begin_frame();
+            fc.end_frame();
+        }
+        assert!(start.elapsed() < Duration::from_millis(50));
+        assert_eq!(fc.pacing_stats().spin_us, 0.0);
+    }
+
+    #[test]
+    fn test_stats_empty_before_two_frames() {
+        let mut fc = FrameRateController::new(60);
+        assert_eq!(fc.pacing_stats().frames, 0);
+        fc.set_limiter(false);
+        fc.end_frame();
+        assert_eq!(fc.pacing_stats().frames, 0);
+        fc.end_frame();
+        assert_eq!(fc.pacing_stats().frames, 1);
+    }
+}
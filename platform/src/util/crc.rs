@@ -5,15 +5,25 @@
 //! This module provides two CRC algorithms:
 //! 1. Standard IEEE CRC32 (for network sync, file validation)
 //! 2. Westwood CRC (rotate-and-add, for MIX file lookups)
+//!
+//! CRC32 runs slicing-by-8: eight tables let one round of lookups consume
+//! eight bytes, with the plain byte loop left for the tail. The Westwood
+//! hash is a serial rotate-and-add chain, so it is taken a whole word at a
+//! time and filenames are uppercased four letters at once on the way in,
+//! without the String the old lookup allocated.
 
 use once_cell::sync::Lazy;
 
 /// CRC32 polynomial (reversed bit order)
 const CRC32_POLYNOMIAL: u32 = 0xEDB88320;
 
-/// Pre-computed CRC32 lookup table
-static CRC_TABLE: Lazy<[u32; 256]> = Lazy::new(|| {
-    let mut table = [0u32; 256];
+/// Pre-computed CRC32 lookup tables for slicing-by-8
+///
+/// Table 0 is the classic byte table; table k advances a byte's CRC
+/// through k further zero bytes, so byte i of an 8-byte block is looked
+/// up in table 7 - i.
+static CRC_TABLES: Lazy<[[u32; 256]; 8]> = Lazy::new(|| {
+    let mut tables = [[0u32; 256]; 8];
 
     for i in 0..256 {
         let mut crc = i as u32;
@@ -24,12 +34,45 @@ static CRC_TABLE: Lazy<[u32; 256]> = Lazy::new(|| {
                 crc >>= 1;
             }
         }
-        table[i] = crc;
+        tables[0][i] = crc;
+    }
+
+    for i in 0..256 {
+        let mut crc = tables[0][i];
+        for k in 1..8 {
+            crc = tables[0][(crc & 0xFF) as usize] ^ (crc >> 8);
+            tables[k][i] = crc;
+        }
     }
 
-    table
+    tables
 });
 
+/// Advance an unfinalized CRC32 over `data`
+fn crc32_slice8(mut crc: u32, data: &[u8]) -> u32 {
+    let tables = &*CRC_TABLES;
+    let mut blocks = data.chunks_exact(8);
+
+    for block in &mut blocks {
+        let lo = crc ^ u32::from_le_bytes([block[0], block[1], block[2], block[3]]);
+        let hi = u32::from_le_bytes([block[4], block[5], block[6], block[7]]);
+        crc = tables[7][(lo & 0xFF) as usize]
+            ^ tables[6][((lo >> 8) & 0xFF) as usize]
+            ^ tables[5][((lo >> 16) & 0xFF) as usize]
+            ^ tables[4][(lo >> 24) as usize]
+            ^ tables[3][(hi & 0xFF) as usize]
+            ^ tables[2][((hi >> 8) & 0xFF) as usize]
+            ^ tables[1][((hi >> 16) & 0xFF) as usize]
+            ^ tables[0][(hi >> 24) as usize];
+    }
+
+    for &byte in blocks.remainder() {
+        crc = tables[0][((crc ^ byte as u32) & 0xFF) as usize] ^ (crc >> 8);
+    }
+
+    crc
+}
+
 /// Calculate CRC32 of a byte slice
 ///
 /// # Arguments
@@ -38,14 +81,7 @@ static CRC_TABLE: Lazy<[u32; 256]> = Lazy::new(|| {
 /// # Returns
 /// 32-bit CRC value
 pub fn crc32(data: &[u8]) -> u32 {
-    let mut crc = 0xFFFFFFFF_u32;
-
-    for &byte in data {
-        let index = ((crc ^ byte as u32) & 0xFF) as usize;
-        crc = CRC_TABLE[index] ^ (crc >> 8);
-    }
-
-    crc ^ 0xFFFFFFFF
+    crc32_slice8(0xFFFFFFFF, data) ^ 0xFFFFFFFF
 }
 
 /// Update existing CRC with more data
@@ -59,14 +95,7 @@ pub fn crc32(data: &[u8]) -> u32 {
 /// # Returns
 /// Updated CRC value (not finalized - call crc32_finalize when done)
 pub fn crc32_update(crc: u32, data: &[u8]) -> u32 {
-    let mut crc = crc;
-
-    for &byte in data {
-        let index = ((crc ^ byte as u32) & 0xFF) as usize;
-        crc = CRC_TABLE[index] ^ (crc >> 8);
-    }
-
-    crc
+    crc32_slice8(crc, data)
 }
 
 /// Initial CRC value for streaming calculation
@@ -126,6 +155,43 @@ impl Default for Crc32 {
 // The filename is converted to uppercase before hashing.
 // The result is a signed 32-bit integer used as a key in binary search.
 
+/// Fold whole little-endian words into a Westwood CRC, passing each
+/// through `map` first; a trailing partial word is zero-padded
+#[inline(always)]
+fn westwood_words<F: Fn(u32) -> u32>(mut crc: u32, data: &[u8], map: F) -> u32 {
+    let mut words = data.chunks_exact(4);
+    for word in &mut words {
+        let word = u32::from_le_bytes([word[0], word[1], word[2], word[3]]);
+        crc = crc.rotate_left(1).wrapping_add(map(word));
+    }
+
+    let tail = words.remainder();
+    if !tail.is_empty() {
+        let mut staging = [0u8; 4];
+        staging[..tail.len()].copy_from_slice(tail);
+        crc = crc.rotate_left(1).wrapping_add(map(u32::from_le_bytes(staging)));
+    }
+    crc
+}
+
+/// Uppercase the ASCII letters in four packed bytes, leaving every other
+/// byte (including anything at 0x80 and up) as it is
+#[inline(always)]
+fn ascii_upper_word(word: u32) -> u32 {
+    const ONES: u32 = 0x0101_0101;
+    const HIGH: u32 = 0x8080_8080;
+
+    // With the top bit cleared, adding 0x1F carries into it from 'a' up
+    // and adding 0x05 from past 'z'; neither can carry out of the byte
+    let low7 = word & !HIGH;
+    let from_a = low7.wrapping_add(ONES * (0x80 - b'a' as u32));
+    let past_z = low7.wrapping_add(ONES * (0x80 - b'z' as u32 - 1));
+    let lower = from_a & !past_z & !word & HIGH;
+
+    // 0x80 >> 2 is the 0x20 between cases
+    word - (lower >> 2)
+}
+
 /// Calculate Westwood CRC of a byte slice.
 ///
 /// This is the rotate-and-add algorithm used by MIX files for filename hashing.
@@ -137,54 +203,7 @@ impl Default for Crc32 {
 /// # Returns
 /// 32-bit hash value (can be interpreted as signed for binary search)
 pub fn westwood_crc(data: &[u8]) -> u32 {
-    let mut crc: u32 = 0;
-    let mut staging: u32 = 0;
-    let mut index: usize = 0;
-    let mut bytes_remaining = data.len();
-    let mut data_ptr = 0;
-
-    // Process leading bytes until we're aligned to 4-byte boundary
-    // Also handles case where total data < 4 bytes
-    while bytes_remaining > 0 && index < 4 {
-        staging |= (data[data_ptr] as u32) << (index * 8);
-        index += 1;
-        data_ptr += 1;
-        bytes_remaining -= 1;
-
-        if index == 4 {
-            crc = crc.rotate_left(1).wrapping_add(staging);
-            staging = 0;
-            index = 0;
-        }
-    }
-
-    // Process 4-byte chunks
-    while bytes_remaining >= 4 {
-        let chunk = u32::from_le_bytes([
-            data[data_ptr],
-            data[data_ptr + 1],
-            data[data_ptr + 2],
-            data[data_ptr + 3],
-        ]);
-        crc = crc.rotate_left(1).wrapping_add(chunk);
-        data_ptr += 4;
-        bytes_remaining -= 4;
-    }
-
-    // Handle remaining bytes (< 4)
-    while bytes_remaining > 0 {
-        staging |= (data[data_ptr] as u32) << (index * 8);
-        index += 1;
-        data_ptr += 1;
-        bytes_remaining -= 1;
-    }
-
-    // If there are any remaining bytes in staging buffer, incorporate them
-    if index > 0 {
-        crc = crc.rotate_left(1).wrapping_add(staging);
-    }
-
-    crc
+    westwood_words(0, data, |word| word)
 }
 
 /// Calculate Westwood CRC of an uppercase ASCII string.
@@ -198,8 +217,15 @@ pub fn westwood_crc(data: &[u8]) -> u32 {
 /// # Returns
 /// 32-bit hash value for MIX file lookup
 pub fn westwood_crc_filename(name: &str) -> u32 {
-    let upper = name.to_ascii_uppercase();
-    westwood_crc(upper.as_bytes())
+    westwood_crc_filename_bytes(name.as_bytes())
+}
+
+/// Calculate Westwood CRC of a filename given as raw bytes.
+///
+/// ASCII letters are uppercased as they are hashed; other bytes are hashed
+/// unchanged, so this matches `westwood_crc_filename` on any `&str`.
+pub fn westwood_crc_filename_bytes(name: &[u8]) -> u32 {
+    westwood_words(0, name, ascii_upper_word)
 }
 
 /// Streaming Westwood CRC calculator
@@ -223,15 +249,31 @@ impl WestwoodCrc {
 
     /// Update with more data
     pub fn update(&mut self, data: &[u8]) {
-        for &byte in data {
-            self.staging |= (byte as u32) << (self.index * 8);
-            self.index += 1;
+        let mut data = data;
 
-            if self.index == 4 {
-                self.crc = self.crc.rotate_left(1).wrapping_add(self.staging);
-                self.staging = 0;
-                self.index = 0;
-            }
+        // Top up a word left partial by the last update
+        while self.index > 0 && !data.is_empty() {
+            self.push_byte(data[0]);
+            data = &data[1..];
+        }
+
+        // Whole words straight through, the last few bytes held back
+        let whole = data.len() & !3;
+        self.crc = westwood_words(self.crc, &data[..whole], |word| word);
+        for &byte in &data[whole..] {
+            self.push_byte(byte);
+        }
+    }
+
+    #[inline]
+    fn push_byte(&mut self, byte: u8) {
+        self.staging |= (byte as u32) << (self.index * 8);
+        self.index += 1;
+
+        if self.index == 4 {
+            self.crc = self.crc.rotate_left(1).wrapping_add(self.staging);
+            self.staging = 0;
+            self.index = 0;
         }
     }
 
@@ -440,6 +482,90 @@ mod tests {
         assert_ne!(crc_a, crc_b);
     }
 
+    /// The byte-at-a-time CRC32 the sliced version replaced
+    fn crc32_bytewise(data: &[u8]) -> u32 {
+        let table = &CRC_TABLES[0];
+        let mut crc = 0xFFFFFFFF_u32;
+        for &byte in data {
+            crc = table[((crc ^ byte as u32) & 0xFF) as usize] ^ (crc >> 8);
+        }
+        crc ^ 0xFFFFFFFF
+    }
+
+    /// The byte-staging Westwood CRC the word version replaced
+    fn westwood_crc_bytewise(data: &[u8]) -> u32 {
+        let mut crc: u32 = 0;
+        let mut staging: u32 = 0;
+        let mut index = 0;
+        for &byte in data {
+            staging |= (byte as u32) << (index * 8);
+            index += 1;
+            if index == 4 {
+                crc = crc.rotate_left(1).wrapping_add(staging);
+                staging = 0;
+                index = 0;
+            }
+        }
+        if index > 0 {
+            crc = crc.rotate_left(1).wrapping_add(staging);
+        }
+        crc
+    }
+
+    fn pattern(len: usize) -> Vec<u8> {
+        let mut seed = 0x2545F491_u32;
+        (0..len)
+            .map(|_| {
+                seed = seed.wrapping_mul(1664525).wrapping_add(1013904223);
+                (seed >> 24) as u8
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_fast_paths_match_bytewise() {
+        let data = pattern(1024 + 7);
+        for start in 0..8 {
+            for len in (0..64).chain([255, 256, 1000].into_iter()) {
+                let slice = &data[start..start + len];
+                assert_eq!(crc32(slice), crc32_bytewise(slice), "crc32 len {}", len);
+                assert_eq!(westwood_crc(slice), westwood_crc_bytewise(slice), "westwood len {}", len);
+
+                // Streamed in uneven pieces
+                let mut crc = CRC_INIT;
+                let mut ww = WestwoodCrc::new();
+                for piece in slice.chunks(start + 3) {
+                    crc = crc32_update(crc, piece);
+                    ww.update(piece);
+                }
+                assert_eq!(crc32_finalize(crc), crc32(slice));
+                assert_eq!(ww.finalize(), westwood_crc(slice));
+            }
+        }
+    }
+
+    #[test]
+    fn test_filename_uppercase_every_byte() {
+        // Each byte value in every lane matches the String-based uppercase
+        for value in 0..=255u8 {
+            for lane in 0..5 {
+                let mut name = *b"abcde";
+                name[lane] = value;
+                assert_eq!(
+                    westwood_crc_filename_bytes(&name),
+                    westwood_crc(&name.to_ascii_uppercase()),
+                    "byte {:#04x} at {}",
+                    value,
+                    lane
+                );
+            }
+        }
+        assert_eq!(
+            westwood_crc_filename("conquer.mix"),
+            westwood_crc(b"CONQUER.MIX")
+        );
+    }
+
     #[test]
     fn test_westwood_crc_reset() {
         let mut crc = WestwoodCrc::new();
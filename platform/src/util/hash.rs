@@ -0,0 +1,189 @@
+//! Fast 64-bit hashing
+//!
+//! For keys and checksums that stay inside the engine: asset cache keys,
+//! game state hashes, lookup tables. Nothing here has to match a Westwood
+//! format, so it can use whatever the hardware is quickest at; use
+//! `crc::westwood_crc` for MIX lookups and `crc::crc32` for anything
+//! stored or sent.
+//!
+//! The construction follows wyhash: each 16 bytes of input are folded in
+//! with one 64x64->128 multiply (three streams side by side on long
+//! input), which mixes far better per cycle than table or shift/xor
+//! schemes. It is
+//! not cryptographic and not seed-secret; don't key anything an opponent
+//! controls on it. Values are stable across platforms and runs (inputs are
+//! read little-endian), so they can be compared between peers.
+
+const SECRET: [u64; 4] = [
+    0xA076_1D64_78BD_642F,
+    0xE703_7ED1_A0B4_28DB,
+    0x8EBC_6AF0_9C88_C6E3,
+    0x5899_65CC_7537_4CC3,
+];
+
+/// Multiply to 128 bits and fold the halves together
+#[inline(always)]
+fn mix(a: u64, b: u64) -> u64 {
+    let product = (a as u128).wrapping_mul(b as u128);
+    (product as u64) ^ ((product >> 64) as u64)
+}
+
+#[inline(always)]
+fn read64(data: &[u8], at: usize) -> u64 {
+    u64::from_le_bytes([
+        data[at],
+        data[at + 1],
+        data[at + 2],
+        data[at + 3],
+        data[at + 4],
+        data[at + 5],
+        data[at + 6],
+        data[at + 7],
+    ])
+}
+
+#[inline(always)]
+fn read32(data: &[u8], at: usize) -> u64 {
+    u32::from_le_bytes([data[at], data[at + 1], data[at + 2], data[at + 3]]) as u64
+}
+
+/// Hash a byte slice to 64 bits
+///
+/// # Arguments
+/// * `data` - Bytes to hash
+/// * `seed` - Selects an independent hash function; 0 is fine
+pub fn hash64(data: &[u8], seed: u64) -> u64 {
+    let len = data.len();
+    let mut seed = seed ^ mix(seed ^ SECRET[0], SECRET[1]);
+    let (a, b);
+
+    if len <= 16 {
+        if len >= 4 {
+            // Two overlapping reads from each end cover 4..=16 bytes
+            let quarter = (len >> 3) << 2;
+            a = (read32(data, 0) << 32) | read32(data, quarter);
+            b = (read32(data, len - 4) << 32) | read32(data, len - 4 - quarter);
+        } else if len > 0 {
+            a = ((data[0] as u64) << 16) | ((data[len >> 1] as u64) << 8) | data[len - 1] as u64;
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        let mut at = 0;
+        let mut remaining = len;
+        if remaining > 48 {
+            // Three independent lanes keep the multipliers busy
+            let mut lane1 = seed;
+            let mut lane2 = seed;
+            while remaining > 48 {
+                seed = mix(read64(data, at) ^ SECRET[1], read64(data, at + 8) ^ seed);
+                lane1 = mix(read64(data, at + 16) ^ SECRET[2], read64(data, at + 24) ^ lane1);
+                lane2 = mix(read64(data, at + 32) ^ SECRET[3], read64(data, at + 40) ^ lane2);
+                at += 48;
+                remaining -= 48;
+            }
+            seed ^= lane1 ^ lane2;
+        }
+        while remaining > 16 {
+            seed = mix(read64(data, at) ^ SECRET[1], read64(data, at + 8) ^ seed);
+            at += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes, overlapping what came before
+        a = read64(data, len - 16);
+        b = read64(data, len - 8);
+    }
+
+    let a = a ^ SECRET[1];
+    let b = b ^ seed;
+    let product = (a as u128).wrapping_mul(b as u128);
+    mix((product as u64) ^ SECRET[0] ^ len as u64, ((product >> 64) as u64) ^ SECRET[1])
+}
+
+/// Hash a 64-bit value, for integer-keyed tables
+#[inline]
+pub fn hash64_u64(value: u64, seed: u64) -> u64 {
+    hash64(&value.to_le_bytes(), seed)
+}
+
+// =============================================================================
+// Unit Tests
+// =============================================================================
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::HashSet;
+
+    fn pattern(len: usize) -> Vec<u8> {
+        let mut seed = 0x9E37_79B9_u32;
+        (0..len)
+            .map(|_| {
+                seed = seed.wrapping_mul(1664525).wrapping_add(1013904223);
+                (seed >> 24) as u8
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_deterministic_and_seeded() {
+        let data = pattern(100);
+        assert_eq!(hash64(&data, 0), hash64(&data, 0));
+        assert_ne!(hash64(&data, 0), hash64(&data, 1));
+        assert_ne!(hash64(&[], 0), hash64(&[], 1));
+    }
+
+    #[test]
+    fn test_every_length_distinct() {
+        // Prefixes of one buffer, including zero-filled ones, never collide
+        // across the short, medium and bulk paths
+        let data = pattern(300);
+        let zeros = [0u8; 300];
+        let mut seen = HashSet::new();
+        assert!(seen.insert(hash64(&[], 7)));
+        for len in 1..=300 {
+            assert!(seen.insert(hash64(&data[..len], 7)), "collision at len {}", len);
+            assert!(seen.insert(hash64(&zeros[..len], 7)), "zero collision at len {}", len);
+        }
+    }
+
+    #[test]
+    fn test_alignment_independent() {
+        let data = pattern(200);
+        for len in [3, 8, 17, 49, 120] {
+            let expected = hash64(&data[..len], 0);
+            for shift in 1..8 {
+                let mut moved = vec![0u8; shift];
+                moved.extend_from_slice(&data[..len]);
+                assert_eq!(hash64(&moved[shift..], 0), expected);
+            }
+        }
+    }
+
+    #[test]
+    fn test_single_bit_flips_spread() {
+        // Flipping any one input bit changes about half the output bits
+        for len in [1, 8, 16, 40, 100] {
+            let data = pattern(len);
+            let base = hash64(&data, 0);
+            let mut total = 0;
+            for bit in 0..len * 8 {
+                let mut flipped = data.clone();
+                flipped[bit / 8] ^= 1 << (bit % 8);
+                let changed = (hash64(&flipped, 0) ^ base).count_ones();
+                assert!(changed > 8, "len {} bit {} changed only {}", len, bit, changed);
+                total += changed;
+            }
+            let mean = total as f64 / (len * 8) as f64;
+            assert!((24.0..40.0).contains(&mean), "len {} mean {}", len, mean);
+        }
+    }
+
+    #[test]
+    fn test_u64_helper() {
+        assert_eq!(hash64_u64(42, 3), hash64(&42u64.to_le_bytes(), 3));
+        assert_ne!(hash64_u64(1, 0), hash64_u64(2, 0));
+    }
+}
@@ -1,6 +1,7 @@
 //! Utility modules
 //!
-//! CRC32 and random number generation
+//! CRC32, fast hashing and random number generation
 
 pub mod crc;
+pub mod hash;
 pub mod random;
@@ -46,15 +46,23 @@ run_test() {
 # Build all test targets
 echo "Building test suite..."
 cd "$BUILD_DIR"
-cmake --build . --target UnitTests IntegrationTests VisualTests PerformanceTests GameplayTests RegressionTests 2>/dev/null || true
-
-# Run all test executables
-run_test "UnitTests" "$BUILD_DIR/UnitTests"
-run_test "IntegrationTests" "$BUILD_DIR/IntegrationTests"
-run_test "VisualTests" "$BUILD_DIR/VisualTests"
-run_test "GameplayTests" "$BUILD_DIR/GameplayTests"
-run_test "PerformanceTests" "$BUILD_DIR/PerformanceTests"
-run_test "RegressionTests" "$BUILD_DIR/RegressionTests"
+cmake --build . --target AllTests 2>/dev/null || true
+
+# Every suite in one process with the platform brought up once (set
+# TEST_JOBS to spread categories over cores); the separate executables
+# are the fallback when the combined one didn't build
+if [ -f "$BUILD_DIR/AllTests" ]; then
+    run_test "AllTests" "$BUILD_DIR/AllTests"
+else
+    cmake --build . --target UnitTests IntegrationTests VisualTests PerformanceTests GameplayTests RegressionTests 2>/dev/null || true
+
+    run_test "UnitTests" "$BUILD_DIR/UnitTests"
+    run_test "IntegrationTests" "$BUILD_DIR/IntegrationTests"
+    run_test "VisualTests" "$BUILD_DIR/VisualTests"
+    run_test "GameplayTests" "$BUILD_DIR/GameplayTests"
+    run_test "PerformanceTests" "$BUILD_DIR/PerformanceTests"
+    run_test "RegressionTests" "$BUILD_DIR/RegressionTests"
+fi
 
 # Run release tests if available
 if [ -f "$BUILD_DIR/ReleaseTests" ]; then
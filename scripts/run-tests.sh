@@ -2,6 +2,12 @@
 # Master test runner script
 #
 # Usage: ./scripts/run-tests.sh [--quick] [--rust-only] [--cpp-only]
+#        ./scripts/run-tests.sh --perf [--update-baseline] [--baseline FILE]
+#
+# --perf runs PerformanceTests and RedAlertBench with JSON output and
+# compares them with the baseline recorded for this host (PerfCompare).
+# Significant regressions fail the run and are filed in build/perf/bugs.txt.
+# --update-baseline records this run as the host's baseline instead.
 
 set -e
 
@@ -12,8 +18,13 @@ ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
 QUICK=""
 RUST_TESTS=true
 CPP_TESTS=true
+PERF=false
+UPDATE_BASELINE=""
+BASELINE="$ROOT_DIR/perf/baselines.json"
+PERF_REPEAT="${PERF_REPEAT:-5}"
 
-for arg in "$@"; do
+while [ $# -gt 0 ]; do
+    arg="$1"
     case "$arg" in
         --quick|-q)
             QUICK="--quick"
@@ -24,9 +35,60 @@ for arg in "$@"; do
         --cpp-only)
             RUST_TESTS=false
             ;;
+        --perf)
+            PERF=true
+            ;;
+        --update-baseline)
+            PERF=true
+            UPDATE_BASELINE="--update"
+            ;;
+        --baseline)
+            shift
+            BASELINE="$1"
+            ;;
     esac
+    shift
 done
 
+# Performance comparison mode
+if [ "$PERF" = true ]; then
+    cd "$ROOT_DIR"
+
+    if [ ! -d "build" ]; then
+        echo "Building project..."
+        cmake -B build -G Ninja -DCMAKE_BUILD_TYPE=Release
+    fi
+    cmake --build build --target PerformanceTests RedAlertBench PerfCompare
+
+    export SDL_VIDEODRIVER=dummy
+    export SDL_AUDIODRIVER=dummy
+
+    mkdir -p build/perf "$(dirname "$BASELINE")"
+    rm -f build/perf/performance.json build/perf/bench.json
+
+    echo "=== Performance Tests (x$PERF_REPEAT) ==="
+    build/PerformanceTests --category Performance --jobs 1 --repeat "$PERF_REPEAT" \
+        --json build/perf/performance.json || true
+    echo ""
+    echo "=== Rendering Benchmarks ==="
+    build/RedAlertBench --json build/perf/bench.json || true
+    echo ""
+
+    RESULTS=""
+    for f in build/perf/performance.json build/perf/bench.json; do
+        [ -f "$f" ] && RESULTS="$RESULTS $f"
+    done
+    if [ -z "$RESULTS" ]; then
+        echo "No performance results were written"
+        exit 1
+    fi
+
+    echo "=== Baseline Comparison ==="
+    # shellcheck disable=SC2086
+    exec build/PerfCompare --baseline "$BASELINE" $UPDATE_BASELINE \
+        --bugs build/perf/bugs.txt $RESULTS
+fi
+
 echo "============================================"
 echo "Running Platform Tests"
 echo "============================================"
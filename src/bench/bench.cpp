@@ -0,0 +1,230 @@
+/**
+ * Red Alert Bench - Microbenchmark Entry Point
+ *
+ * Runs the rendering kernel and hashing benchmarks headless. Only the asset system is
+ * brought up (for tile templates); nothing opens a window.
+ */
+
+#include "bench/bench.h"
+#include "game/game.h"
+#include "platform.h"
+#include "test/perf_baseline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// =============================================================================
+// Timing
+// =============================================================================
+
+uint64_t Bench_Now_Ns() {
+    uint64_t counter = Platform_Timer_GetPerformanceCounter();
+    uint64_t frequency = Platform_Timer_GetPerformanceFrequency();
+    if (frequency == 1000000000ull || frequency == 0) {
+        return counter;
+    }
+    return (counter / frequency) * 1000000000ull + (counter % frequency) * 1000000000ull / frequency;
+}
+
+static volatile uint64_t g_bench_sink = 0;
+
+void Bench_Keep(uint64_t value) {
+    g_bench_sink = g_bench_sink + value;
+}
+
+// =============================================================================
+// BenchRunner
+// =============================================================================
+
+BenchRunner::BenchRunner(const BenchOptions& options)
+    : options_(options) {
+    if (options_.repetitions < 1) {
+        options_.repetitions = 1;
+    }
+    samples_.reserve(options_.repetitions);
+}
+
+bool BenchRunner::Matches(const char* name) const {
+    return options_.filter.empty() || strstr(name, options_.filter.c_str()) != nullptr;
+}
+
+void BenchRunner::Print_Header() {
+    if (header_printed_) {
+        return;
+    }
+    header_printed_ = true;
+    if (options_.csv) {
+        printf("name,batch,median_ns,p99_ns,min_ns,bytes,mb_per_sec\n");
+    } else {
+        printf("%-40s %12s %12s %12s %10s\n", "Benchmark", "median ns", "p99 ns", "min ns", "MB/s");
+        printf("%-40s %12s %12s %12s %10s\n", "---------", "---------", "------", "------", "----");
+    }
+}
+
+void BenchRunner::Report(const char* name, uint64_t bytes, uint64_t batch) {
+    std::sort(samples_.begin(), samples_.end());
+    size_t count = samples_.size();
+
+    BenchResult result;
+    result.name = name;
+    result.batch = batch;
+    result.bytes = bytes;
+    result.min_ns = samples_[0];
+    result.median_ns = (count % 2) ? samples_[count / 2]
+                                   : (samples_[count / 2 - 1] + samples_[count / 2]) / 2.0;
+    // Nearest rank
+    size_t rank = static_cast<size_t>(std::ceil(0.99 * count));
+    result.p99_ns = samples_[std::max<size_t>(rank, 1) - 1];
+    if (bytes > 0 && result.median_ns > 0.0) {
+        result.mb_per_sec = bytes * 1000.0 / result.median_ns;   // bytes/ns * 1e9 / 1e6
+    }
+    result.samples_ns = samples_;
+    results_.push_back(result);
+
+    Print_Header();
+    if (options_.csv) {
+        printf("%s,%llu,%.1f,%.1f,%.1f,%llu,%.1f\n", name,
+               static_cast<unsigned long long>(batch), result.median_ns, result.p99_ns,
+               result.min_ns, static_cast<unsigned long long>(bytes), result.mb_per_sec);
+    } else if (bytes > 0) {
+        printf("%-40s %12.1f %12.1f %12.1f %10.1f\n", name,
+               result.median_ns, result.p99_ns, result.min_ns, result.mb_per_sec);
+    } else {
+        printf("%-40s %12.1f %12.1f %12.1f %10s\n", name,
+               result.median_ns, result.p99_ns, result.min_ns, "-");
+    }
+    fflush(stdout);
+}
+
+void BenchRunner::Skip(const char* name, const char* reason) {
+    if (!Matches(name)) {
+        return;
+    }
+    Print_Header();
+    if (options_.csv) {
+        printf("%s,skipped,,,,,\n", name);
+    } else {
+        printf("%-40s skipped: %s\n", name, reason);
+    }
+}
+
+bool BenchRunner::Expect_Not_Slower(const char* name, const char* baseline, double slack) {
+    const BenchResult* result = nullptr;
+    const BenchResult* base = nullptr;
+    for (const BenchResult& r : results_) {
+        if (r.name == name) result = &r;
+        if (r.name == baseline) base = &r;
+    }
+    if (!result || !base || result->median_ns <= base->median_ns * slack) {
+        return true;
+    }
+
+    failures_++;
+    fprintf(stderr, "RedAlertBench: %s is %.2fx slower than %s\n",
+            name, result->median_ns / base->median_ns, baseline);
+    return false;
+}
+
+bool BenchRunner::Write_Json(const std::string& path) const {
+    PerfRun run;
+    run.host = Perf_Host_Fingerprint();
+    for (const BenchResult& result : results_) {
+        PerfSeries series;
+        series.name = result.name;
+        series.unit = "ns";
+        series.samples = result.samples_ns;
+        run.series.push_back(series);
+    }
+    return run.save_to_file(path);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+/**
+ * Parse command line arguments
+ *
+ * @return false on an unknown argument
+ */
+static bool Parse_Args(int argc, char* argv[], BenchOptions* options, bool* show_help) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            *show_help = true;
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && has_value) {
+            options->filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--reps") == 0 && has_value) {
+            options->repetitions = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+            options->warmup_ms = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--data") == 0 && has_value) {
+            options->data_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--csv") == 0) {
+            options->csv = true;
+        }
+        else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            options->json_path = argv[++i];
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void Show_Help() {
+    printf("Red Alert - Rendering Kernel Benchmarks\n");
+    printf("\n");
+    printf("Usage: RedAlertBench [options]\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --filter TEXT   Run only benchmarks whose name contains TEXT\n");
+    printf("  --reps N        Timed samples per benchmark (default 31)\n");
+    printf("  --warmup MS     Untimed warmup per benchmark (default 50)\n");
+    printf("  --data PATH     Directory with the MIX files (default gamedata)\n");
+    printf("  --csv           Print CSV instead of a table\n");
+    printf("  --json FILE     Also write every sample to FILE for PerfCompare\n");
+    printf("\n");
+    printf("Exits with 1 if the AVX2 blit kernel is slower than SSE2.\n");
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    bool show_help = false;
+    if (!Parse_Args(argc, argv, &options, &show_help)) {
+        fprintf(stderr, "RedAlertBench: Unknown option (see --help)\n");
+        return 1;
+    }
+    if (show_help) {
+        Show_Help();
+        return 0;
+    }
+
+    // Tile templates come from the theater MIX files; without them the
+    // tile benchmarks are skipped
+    Platform_Assets_Init();
+    Game_Register_Mix_Files(options.data_path.c_str());
+
+    BenchRunner runner(options);
+    Bench_Blits(runner);
+    Bench_Shapes(runner);
+    Bench_Tiles(runner);
+    Bench_Palette(runner);
+    Bench_Dirty_Rects(runner);
+    Bench_Hashing(runner);
+
+    if (!options.json_path.empty() && !runner.Write_Json(options.json_path)) {
+        fprintf(stderr, "RedAlertBench: Could not write %s\n", options.json_path.c_str());
+        return 1;
+    }
+    return runner.Get_Failures() > 0 ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * Bench - Microbenchmark harness for RedAlertBench
+ *
+ * Times one operation many times over and reports the spread, not just
+ * an average, so a kernel change can be judged on numbers that hold
+ * still between runs:
+ *
+ *   - timing uses the nanosecond performance counter
+ *   - each case warms up first (caches, branch predictors, lazy tables),
+ *     which also sizes a batch so one sample spans well above the
+ *     counter's resolution
+ *   - the batch is then timed repeatedly; the median, p99 and best time
+ *     per operation are reported, with throughput from the median
+ *
+ * Usage:
+ *   BenchRunner runner(options);
+ *   runner.Run("Blit/Trans/64x64", 64 * 64, [&] {
+ *       dst.Blit_From_Trans(src, 0, 0, 0, 0, 64, 64);
+ *   });
+ */
+
+#ifndef BENCH_BENCH_H
+#define BENCH_BENCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * BenchOptions - How hard to measure, and what
+ */
+struct BenchOptions {
+    int repetitions = 31;               // Samples per case
+    int warmup_ms = 50;                 // Untimed running before sampling
+    uint64_t min_sample_ns = 200000;    // Smallest batch duration
+    bool csv = false;                   // Machine-readable output
+    std::string json_path;              // Also write samples here as JSON
+    std::string filter;                 // Run only names containing this
+    std::string data_path = "gamedata"; // MIX files, for cases that need them
+};
+
+/**
+ * BenchResult - One case's timings, per operation
+ */
+struct BenchResult {
+    std::string name;
+    uint64_t batch = 0;                 // Operations per sample
+    double median_ns = 0.0;
+    double p99_ns = 0.0;
+    double min_ns = 0.0;
+    uint64_t bytes = 0;                 // Per operation, 0 if not meaningful
+    double mb_per_sec = 0.0;            // From the median
+    std::vector<double> samples_ns;     // Every sample, sorted
+};
+
+/**
+ * Nanoseconds from the platform performance counter
+ */
+uint64_t Bench_Now_Ns();
+
+/**
+ * Keep a computed value from being optimized away
+ */
+void Bench_Keep(uint64_t value);
+
+// =============================================================================
+// BenchRunner
+// =============================================================================
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options);
+
+    const BenchOptions& Get_Options() const { return options_; }
+
+    /**
+     * Whether a case would run under the filter
+     */
+    bool Matches(const char* name) const;
+
+    /**
+     * Time fn and report it
+     *
+     * @param name   Case name, "Group/Operation/Size"
+     * @param bytes  Bytes processed per call, 0 if throughput doesn't apply
+     * @param fn     One operation
+     */
+    template <typename Fn>
+    void Run(const char* name, uint64_t bytes, Fn&& fn) {
+        if (!Matches(name)) {
+            return;
+        }
+
+        // Warm up, doubling the batch until a sample is long enough
+        uint64_t batch = 1;
+        uint64_t warm_end = Bench_Now_Ns() + static_cast<uint64_t>(options_.warmup_ms) * 1000000;
+        for (;;) {
+            uint64_t start = Bench_Now_Ns();
+            for (uint64_t i = 0; i < batch; i++) {
+                fn();
+            }
+            uint64_t end = Bench_Now_Ns();
+            if (end - start < options_.min_sample_ns && batch < MAX_BATCH) {
+                batch *= 2;
+            } else if (end >= warm_end) {
+                break;
+            }
+        }
+
+        samples_.clear();
+        for (int rep = 0; rep < options_.repetitions; rep++) {
+            uint64_t start = Bench_Now_Ns();
+            for (uint64_t i = 0; i < batch; i++) {
+                fn();
+            }
+            samples_.push_back(static_cast<double>(Bench_Now_Ns() - start) / batch);
+        }
+        Report(name, bytes, batch);
+    }
+
+    /**
+     * Note a case that could not run, and why
+     */
+    void Skip(const char* name, const char* reason);
+
+    /**
+     * Fail the run if a case's median is over slack times a baseline's
+     *
+     * For a faster path that must earn its place, e.g. a wider kernel
+     * against the narrower one. Cases that did not run are not checked.
+     *
+     * @return false if the case regressed
+     */
+    bool Expect_Not_Slower(const char* name, const char* baseline, double slack);
+
+    int Get_Failures() const { return failures_; }
+
+    const std::vector<BenchResult>& Get_Results() const { return results_; }
+
+    /**
+     * Write every case's samples in the perf baseline result format
+     *
+     * @return false if the file could not be written
+     */
+    bool Write_Json(const std::string& path) const;
+
+private:
+    static constexpr uint64_t MAX_BATCH = 1ull << 24;
+
+    void Report(const char* name, uint64_t bytes, uint64_t batch);
+    void Print_Header();
+
+    BenchOptions options_;
+    std::vector<double> samples_;
+    std::vector<BenchResult> results_;
+    bool header_printed_ = false;
+    int failures_ = 0;
+};
+
+// =============================================================================
+// Suites (bench_graphics.cpp)
+// =============================================================================
+
+void Bench_Blits(BenchRunner& runner);
+void Bench_Shapes(BenchRunner& runner);
+void Bench_Tiles(BenchRunner& runner);
+void Bench_Palette(BenchRunner& runner);
+void Bench_Dirty_Rects(BenchRunner& runner);
+
+// =============================================================================
+// Suites (bench_hash.cpp)
+// =============================================================================
+
+void Bench_Hashing(BenchRunner& runner);
+
+#endif // BENCH_BENCH_H
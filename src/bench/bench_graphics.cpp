@@ -0,0 +1,381 @@
+/**
+ * Rendering Kernel Benchmarks
+ *
+ * Sizes follow what a frame actually draws: 24x24 cells and infantry,
+ * 48x48 vehicles, 96x96 buildings, a 320x200 sidebar-sized region and the
+ * full 640x400 view.
+ */
+
+#include "bench/bench.h"
+#include "game/graphics/blit_kernels.h"
+#include "game/graphics/graphics_buffer.h"
+#include "game/graphics/palette_manager.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/tile_renderer.h"
+#include "graphics/dirty_rect.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const int VIEW_WIDTH = 640;
+const int VIEW_HEIGHT = 400;
+
+struct Size {
+    int width;
+    int height;
+};
+
+const Size REGION_SIZES[] = {{24, 24}, {64, 64}, {320, 200}, {640, 400}};
+
+/**
+ * Fill a buffer with sprite-like content: about a third transparent,
+ * in runs, the rest in a few color ramps
+ */
+void Fill_Pattern(GraphicsBuffer& buffer) {
+    buffer.Lock();
+    uint8_t* pixels = buffer.Get_Buffer();
+    int pitch = buffer.Get_Pitch();
+    uint32_t seed = 0x1234567u;
+    for (int y = 0; y < buffer.Get_Height(); y++) {
+        for (int x = 0; x < buffer.Get_Width(); x++) {
+            seed = seed * 1664525u + 1013904223u;
+            bool clear = ((x / 5 + y / 3) % 3) == 0;
+            pixels[y * pitch + x] = clear ? 0 : static_cast<uint8_t>(16 + (seed >> 28) + ((x / 8) % 4) * 16);
+        }
+    }
+    buffer.Unlock();
+}
+
+/**
+ * A table shifting the unit color ramp, like a house remap
+ */
+void Build_Remap(uint8_t* table, int shift) {
+    for (int i = 0; i < 256; i++) {
+        table[i] = static_cast<uint8_t>(i);
+    }
+    for (int i = 80; i < 96; i++) {
+        table[i] = static_cast<uint8_t>(i + shift);
+    }
+}
+
+/**
+ * An uncompressed SHP file of frame_count frames: a rounded silhouette
+ * with transparent corners and a few holes, as unit art has
+ */
+std::vector<uint8_t> Build_Shape(int width, int height, int frame_count) {
+    const int header = 8 + frame_count * 8;
+    const int frame_size = width * height;
+    std::vector<uint8_t> data(header + frame_count * frame_size, 0);
+
+    auto put16 = [&](int at, int value) {
+        data[at] = static_cast<uint8_t>(value);
+        data[at + 1] = static_cast<uint8_t>(value >> 8);
+    };
+    put16(0, frame_count);
+    put16(4, width);
+    put16(6, height);
+
+    for (int frame = 0; frame < frame_count; frame++) {
+        int offset = header + frame * frame_size;
+        int entry = 8 + frame * 8;
+        data[entry] = static_cast<uint8_t>(offset);
+        data[entry + 1] = static_cast<uint8_t>(offset >> 8);
+        data[entry + 2] = static_cast<uint8_t>(offset >> 16);
+        data[entry + 3] = static_cast<uint8_t>(offset >> 24);
+        data[entry + 4] = 0;    // Raw
+
+        int cx = width / 2;
+        int cy = height / 2;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int dx = (x - cx) * 100 / cx;
+                int dy = (y - cy) * 100 / cy;
+                bool inside = dx * dx + dy * dy < 9000;
+                bool hole = ((x + frame) % 7 == 0) && ((y + frame) % 5 == 0);
+                data[offset + y * width + x] =
+                    (inside && !hole) ? static_cast<uint8_t>(80 + (x + y + frame) % 16) : 0;
+            }
+        }
+    }
+    return data;
+}
+
+} // namespace
+
+// =============================================================================
+// Blits
+// =============================================================================
+
+void Bench_Blits(BenchRunner& runner) {
+    GraphicsBuffer src(VIEW_WIDTH, VIEW_HEIGHT);
+    GraphicsBuffer dst(VIEW_WIDTH, VIEW_HEIGHT);
+    Fill_Pattern(src);
+
+    uint8_t remap[256];
+    Build_Remap(remap, 48);
+
+    const BlitKernelLevel levels[] = {
+        BLIT_KERNEL_SCALAR, BLIT_KERNEL_SSE2, BLIT_KERNEL_AVX2, BLIT_KERNEL_NEON,
+    };
+    BlitKernelLevel detected = DetectBlitKernelLevel();
+
+    src.Lock();
+    dst.Lock();
+    for (BlitKernelLevel level : levels) {
+        if (!SetBlitKernelLevel(level)) {
+            continue;
+        }
+        const char* kernel = GetBlitKernels().name;
+        char name[96];
+        for (const Size& size : REGION_SIZES) {
+            uint64_t bytes = static_cast<uint64_t>(size.width) * size.height;
+
+            snprintf(name, sizeof(name), "Blit/Trans/%s/%dx%d", kernel, size.width, size.height);
+            runner.Run(name, bytes, [&] {
+                dst.Blit_From_Trans(src, 0, 0, 0, 0, size.width, size.height);
+            });
+
+            snprintf(name, sizeof(name), "Blit/Remap/%s/%dx%d", kernel, size.width, size.height);
+            runner.Run(name, bytes, [&] {
+                dst.Remap(0, 0, size.width, size.height, remap);
+            });
+        }
+    }
+    dst.Unlock();
+    src.Unlock();
+
+    SetBlitKernelLevel(detected);
+
+    // AVX2 is the default where the CPU has it, so its transparent copy
+    // (the one kernel it widens) must not lose to SSE2 at any size
+    for (const Size& size : REGION_SIZES) {
+        char avx2[96];
+        char sse2[96];
+        snprintf(avx2, sizeof(avx2), "Blit/Trans/avx2/%dx%d", size.width, size.height);
+        snprintf(sse2, sizeof(sse2), "Blit/Trans/sse2/%dx%d", size.width, size.height);
+        runner.Expect_Not_Slower(avx2, sse2, 1.1);
+    }
+}
+
+// =============================================================================
+// Shapes
+// =============================================================================
+
+void Bench_Shapes(BenchRunner& runner) {
+    const Size sizes[] = {{24, 24}, {48, 48}, {96, 96}};
+    const int FRAMES = 8;
+
+    GraphicsBuffer buffer(VIEW_WIDTH, VIEW_HEIGHT);
+    uint8_t remap[256];
+    uint8_t shadow[256];
+    uint8_t fade[256];
+    Build_Remap(remap, 48);
+    for (int i = 0; i < 256; i++) {
+        shadow[i] = static_cast<uint8_t>(i / 2);
+        fade[i] = static_cast<uint8_t>(i * 3 / 4);
+    }
+
+    buffer.Lock();
+    for (const Size& size : sizes) {
+        std::vector<uint8_t> shp = Build_Shape(size.width, size.height, FRAMES);
+        uint64_t bytes = static_cast<uint64_t>(size.width) * size.height;
+        int x = VIEW_WIDTH / 2;
+        int y = VIEW_HEIGHT / 2;
+        int frame = 0;
+        char name[96];
+
+        // Frames decoded to dense pixels on first draw
+        ShapeRenderer dense;
+        if (!dense.LoadFromMemory(shp.data(), static_cast<int32_t>(shp.size()), "BENCH.SHP")) {
+            runner.Skip("Shape", "synthetic shape failed to load");
+            break;
+        }
+        snprintf(name, sizeof(name), "Shape/Draw/dense/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            dense.Draw(buffer, x, y, frame);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        // The game precaches its shapes, so every mode is timed on spans
+        ShapeRenderer shape;
+        shape.LoadFromMemory(shp.data(), static_cast<int32_t>(shp.size()), "BENCH.SHP");
+        shape.PrecacheAllFrames();
+
+        snprintf(name, sizeof(name), "Shape/Draw/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.Draw(buffer, x, y, frame);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawFlipX/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.Draw(buffer, x, y, frame, SHAPE_FLIP_X);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawClipped/%dx%d", size.width, size.height);
+        runner.Run(name, bytes / 2, [&] {
+            shape.Draw(buffer, -size.width / 2, y, frame);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawRemapped/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawRemapped(buffer, x, y, frame, remap);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawShadow/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawShadow(buffer, x, y, frame, shadow);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawGhost/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawGhost(buffer, x, y, frame, frame & 1);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawFading/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawFading(buffer, x, y, frame, fade, 8);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawPredator/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawPredator(buffer, x, y, frame, frame);
+            frame = (frame + 1) % FRAMES;
+        });
+
+        snprintf(name, sizeof(name), "Shape/DrawFlat/%dx%d", size.width, size.height);
+        runner.Run(name, bytes, [&] {
+            shape.DrawFlat(buffer, x, y, frame, 15);
+            frame = (frame + 1) % FRAMES;
+        });
+    }
+    buffer.Unlock();
+}
+
+// =============================================================================
+// Tiles
+// =============================================================================
+
+void Bench_Tiles(BenchRunner& runner) {
+    const int CELLS_X = VIEW_WIDTH / TILE_WIDTH;
+    const int CELLS_Y = VIEW_HEIGHT / TILE_HEIGHT;
+
+    TileRenderer& tiles = TileRenderer::Instance();
+    if (!tiles.SetTheater(THEATER_TEMPERATE) || tiles.GetTileCount(TEMPLATE_CLEAR1) <= 0) {
+        runner.Skip("Tile/DrawTile", "no theater data (see --data)");
+        runner.Skip("Tile/DrawTileRun", "no theater data (see --data)");
+        return;
+    }
+    int icons = tiles.GetTileCount(TEMPLATE_CLEAR1);
+
+    GraphicsBuffer buffer(VIEW_WIDTH, VIEW_HEIGHT);
+    buffer.Lock();
+
+    runner.Run("Tile/DrawTile/24x24", TILE_SIZE, [&, icon = 0]() mutable {
+        tiles.DrawTile(buffer, 48, 48, TEMPLATE_CLEAR1, icon);
+        icon = (icon + 1) % icons;
+    });
+
+    // A whole view of cells, as the map layer draws it
+    char name[96];
+    snprintf(name, sizeof(name), "Tile/DrawTile/view%dx%d", CELLS_X, CELLS_Y);
+    runner.Run(name, static_cast<uint64_t>(TILE_SIZE) * CELLS_X * CELLS_Y, [&] {
+        for (int cy = 0; cy < CELLS_Y; cy++) {
+            for (int cx = 0; cx < CELLS_X; cx++) {
+                tiles.DrawTile(buffer, cx * TILE_WIDTH, cy * TILE_HEIGHT,
+                               TEMPLATE_CLEAR1, (cx + cy) % icons);
+            }
+        }
+    });
+
+    std::vector<TileRunEntry> row(CELLS_X);
+    for (int cx = 0; cx < CELLS_X; cx++) {
+        row[cx].tmpl = TEMPLATE_CLEAR1;
+        row[cx].icon = cx % icons;
+        row[cx].seed = static_cast<uint32_t>(cx);
+    }
+    snprintf(name, sizeof(name), "Tile/DrawTileRun/view%dx%d", CELLS_X, CELLS_Y);
+    runner.Run(name, static_cast<uint64_t>(TILE_SIZE) * CELLS_X * CELLS_Y, [&] {
+        for (int cy = 0; cy < CELLS_Y; cy++) {
+            tiles.DrawTileRun(buffer, 0, cy * TILE_HEIGHT, row.data(), CELLS_X);
+        }
+    });
+
+    buffer.Unlock();
+}
+
+// =============================================================================
+// Palette
+// =============================================================================
+
+void Bench_Palette(BenchRunner& runner) {
+    PaletteManager& palette = PaletteManager::Instance();
+    palette.Init();
+
+    PaletteColor colors[256];
+    for (int i = 0; i < 256; i++) {
+        colors[i] = PaletteColor(static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i),
+                                 static_cast<uint8_t>((i * 7) & 0xFF));
+    }
+    palette.SetPalette(colors);
+
+    // Each fade step runs ApplyEffects over the whole palette
+    runner.Run("Palette/ApplyEffects/fade", 256 * 3, [&] {
+        if (!palette.IsFading()) {
+            palette.StartFadeOut(1000);
+        }
+        palette.Update();
+    });
+
+    runner.Run("Palette/ApplyEffects/flash", 256 * 3, [&] {
+        if (!palette.IsFlashing()) {
+            palette.StartFlash(FlashType::Red, 1000);
+        }
+        palette.Update();
+    });
+
+    palette.StopFlash();
+    palette.SetPalette(colors);
+    palette.Update();
+}
+
+// =============================================================================
+// Dirty Rects
+// =============================================================================
+
+void Bench_Dirty_Rects(BenchRunner& runner) {
+    const int counts[] = {8, 64, 256};
+
+    DirtyRectTracker tracker(VIEW_WIDTH, VIEW_HEIGHT);
+    for (int count : counts) {
+        // Units and effects scattered over the view, sized 24 to 72
+        std::vector<Rect> rects(count);
+        uint32_t seed = 0xC0FFEEu + static_cast<uint32_t>(count);
+        for (Rect& rect : rects) {
+            seed = seed * 1664525u + 1013904223u;
+            rect.width = 24 + static_cast<int>((seed >> 8) % 49);
+            rect.height = 24 + static_cast<int>((seed >> 16) % 49);
+            rect.x = static_cast<int>((seed >> 4) % VIEW_WIDTH) - 12;
+            rect.y = static_cast<int>((seed >> 12) % VIEW_HEIGHT) - 12;
+        }
+
+        // Mark, then build the merged list, as once per frame
+        char name[96];
+        snprintf(name, sizeof(name), "DirtyRect/Merge/%d", count);
+        runner.Run(name, 0, [&] {
+            for (const Rect& rect : rects) {
+                tracker.mark_dirty(rect);
+            }
+            Bench_Keep(tracker.get_dirty_rects().size());
+            tracker.clear();
+        });
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Checksum and Hash Benchmarks
+ *
+ * Filename cases are MIX lookups as the game makes them; the byte sizes
+ * run from a cache key (16) through a shape frame (4K) to a scenario or
+ * save-sized state block (64K).
+ */
+
+#include "bench/bench.h"
+#include "platform.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const int HASH_SIZES[] = {16, 256, 4096, 65536};
+
+const char* const FILENAMES[] = {"e1.shp", "CONQUER.MIX", "temperat.palette"};
+
+std::vector<uint8_t> Build_Bytes(int size) {
+    std::vector<uint8_t> data(size);
+    uint32_t seed = 0xBADC0DEu;
+    for (uint8_t& byte : data) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    return data;
+}
+
+} // namespace
+
+// =============================================================================
+// Hashing
+// =============================================================================
+
+void Bench_Hashing(BenchRunner& runner) {
+    char name[96];
+
+    for (const char* filename : FILENAMES) {
+        snprintf(name, sizeof(name), "Hash/WestwoodFilename/%s", filename);
+        runner.Run(name, 0, [&] {
+            Bench_Keep(Platform_Westwood_CRC_Filename(filename));
+        });
+    }
+
+    for (int size : HASH_SIZES) {
+        std::vector<uint8_t> data = Build_Bytes(size);
+        const uint8_t* bytes = data.data();
+
+        snprintf(name, sizeof(name), "Hash/WestwoodCRC/%d", size);
+        runner.Run(name, size, [&] {
+            Bench_Keep(Platform_Westwood_CRC(bytes, size));
+        });
+
+        snprintf(name, sizeof(name), "Hash/CRC32/%d", size);
+        runner.Run(name, size, [&] {
+            Bench_Keep(Platform_CRC32(bytes, size));
+        });
+
+        snprintf(name, sizeof(name), "Hash/Hash64/%d", size);
+        runner.Run(name, size, [&] {
+            Bench_Keep(Platform_Hash64(bytes, size, 0));
+        });
+    }
+}
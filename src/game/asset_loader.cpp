@@ -0,0 +1,225 @@
+/**
+ * AssetLoader Implementation
+ *
+ * One mutex guards the queues and the finished list; workers only hold
+ * it to pop a job and to hand it back. Work and completions always run
+ * unlocked, so a completion may Submit() follow-up loads.
+ */
+
+#include "game/asset_loader.h"
+#include "platform/io_stats.h"
+#include <algorithm>
+#include <utility>
+
+// =============================================================================
+// Lifecycle
+// =============================================================================
+
+AssetLoader& AssetLoader::Instance() {
+    static AssetLoader loader;
+    return loader;
+}
+
+AssetLoader::~AssetLoader() {
+    Stop();
+}
+
+void AssetLoader::Start(int worker_count) {
+    if (IsRunning()) {
+        return;
+    }
+
+    if (worker_count <= 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        worker_count = std::min(std::max(hardware - 1, 1), 4);
+    }
+
+    workers_.reserve(worker_count);
+    for (int i = 0; i < worker_count; i++) {
+        workers_.emplace_back([this]() { WorkerMain(); });
+    }
+}
+
+void AssetLoader::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& queue : queues_) {
+            queue.clear();
+        }
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+}
+
+// =============================================================================
+// Requests
+// =============================================================================
+
+AssetJobId AssetLoader::Submit(AssetPriority priority, Task work, Task done) {
+    if (priority < 0 || priority >= ASSET_PRIORITY_COUNT) {
+        priority = ASSET_PRIORITY_PREFETCH;
+    }
+
+    Job job;
+    job.work = std::move(work);
+    job.done = std::move(done);
+
+    if (!IsRunning()) {
+        // No workers: do the work now, keep the completion for Pump()
+        if (job.work) {
+            job.work();
+            job.work = Task();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        job.id = next_id_++;
+        AssetJobId id = job.id;
+        finished_.push_back(std::move(job));
+        return id;
+    }
+
+    AssetJobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job.id = next_id_++;
+        id = job.id;
+        queues_[priority].push_back(std::move(job));
+    }
+    wake_.notify_one();
+    return id;
+}
+
+bool AssetLoader::Cancel(AssetJobId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& queue : queues_) {
+        auto it = std::find_if(queue.begin(), queue.end(),
+                               [id](const Job& job) { return job.id == id; });
+        if (it != queue.end()) {
+            queue.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t AssetLoader::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& queue : queues_) {
+        count += queue.size();
+    }
+    return count;
+}
+
+bool AssetLoader::IsIdle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_ > 0 || !finished_.empty()) {
+        return false;
+    }
+    for (const auto& queue : queues_) {
+        if (!queue.empty()) return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// Main Thread Handoff
+// =============================================================================
+
+int AssetLoader::Pump(int max_completions) {
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_.empty()) {
+            return 0;
+        }
+
+        if (max_completions <= 0 || static_cast<size_t>(max_completions) >= finished_.size()) {
+            ready.swap(finished_);
+        } else {
+            ready.assign(std::make_move_iterator(finished_.begin()),
+                         std::make_move_iterator(finished_.begin() + max_completions));
+            finished_.erase(finished_.begin(), finished_.begin() + max_completions);
+        }
+    }
+
+    for (Job& job : ready) {
+        if (job.done) {
+            job.done();
+        }
+        completed_++;
+    }
+    return static_cast<int>(ready.size());
+}
+
+void AssetLoader::Flush() {
+    // Completions may queue follow-up work, so repeat until nothing is left
+    while (true) {
+        if (IsRunning()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.wait(lock, [this]() {
+                if (active_ > 0) return false;
+                for (const auto& queue : queues_) {
+                    if (!queue.empty()) return false;
+                }
+                return true;
+            });
+        }
+        if (Pump() == 0) {
+            break;
+        }
+    }
+}
+
+// =============================================================================
+// Workers
+// =============================================================================
+
+void AssetLoader::WorkerMain() {
+    IoScope io(IoTag::ASSETS);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        std::deque<Job>* queue = nullptr;
+        wake_.wait(lock, [&]() {
+            if (stopping_) return true;
+            for (auto& q : queues_) {
+                if (!q.empty()) {
+                    queue = &q;
+                    return true;
+                }
+            }
+            return false;
+        });
+        if (stopping_) {
+            break;
+        }
+
+        Job job = std::move(queue->front());
+        queue->pop_front();
+        active_++;
+        lock.unlock();
+
+        if (job.work) {
+            job.work();
+            job.work = Task();      // Release captured state off the main thread
+        }
+
+        lock.lock();
+        active_--;
+        finished_.push_back(std::move(job));
+        idle_.notify_all();
+    }
+}
@@ -0,0 +1,424 @@
+/**
+ * AssetManifest Implementation
+ *
+ * First-use log format (one entry per line, '#' starts a comment):
+ *   shape MTNK.SHP
+ *   eva 12
+ *   voice 3 1
+ *   sound 14
+ * Voice and sound ids are the enum values; a log written by an older
+ * build may name the wrong one, which only costs a wasted prefetch.
+ */
+
+#include "game/asset_manifest.h"
+#include "game/audio/audio_system.h"
+#include "game/audio/sound_manager.h"
+#include "game/audio/voice_manager.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/types/buildingtype.h"
+#include "game/types/unittype.h"
+#include "platform.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+AssetManifest* AssetManifest::recording_ = nullptr;
+
+// =============================================================================
+// INI Helpers
+// =============================================================================
+
+namespace {
+
+// Scenario sections whose values are "House,Type,..."
+const char* const OBJECT_SECTIONS[] = { "UNITS", "INFANTRY", "SHIPS", "STRUCTURES" };
+
+// Selection, movement and attack responses for the player's units
+constexpr UnitVoice FIRST_RESPONSE = UnitVoice::REPORTING;
+constexpr UnitVoice LAST_RESPONSE = UnitVoice::FOR_KING_COUNTRY;
+
+std::string Trim_Upper(const char* begin, const char* end) {
+    while (begin < end && isspace(static_cast<unsigned char>(*begin))) begin++;
+    while (end > begin && isspace(static_cast<unsigned char>(end[-1]))) end--;
+
+    std::string out(begin, end);
+    for (char& c : out) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+// Field `index` of a comma-separated value
+std::string Field(const std::string& value, int index) {
+    size_t start = 0;
+    for (int i = 0; i < index; i++) {
+        start = value.find(',', start);
+        if (start == std::string::npos) {
+            return std::string();
+        }
+        start++;
+    }
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) {
+        end = value.size();
+    }
+    return Trim_Upper(value.c_str() + start, value.c_str() + end);
+}
+
+bool Is_Object_Section(const std::string& section) {
+    for (const char* name : OBJECT_SECTIONS) {
+        if (section == name) return true;
+    }
+    return false;
+}
+
+TheaterType Theater_From_Name(const std::string& name) {
+    for (int i = 0; i < THEATER_COUNT; i++) {
+        if (name == TheaterNames[i]) {
+            return static_cast<TheaterType>(i);
+        }
+    }
+    return THEATER_NONE;
+}
+
+VoiceFaction Faction_For_House(HousesType house) {
+    switch (House_Side(house)) {
+        case SIDE_ALLIED: return VoiceFaction::ALLIED;
+        case SIDE_SOVIET: return VoiceFaction::SOVIET;
+        default:          return VoiceFaction::NEUTRAL;
+    }
+}
+
+} // namespace
+
+// =============================================================================
+// Scenario Parsing
+// =============================================================================
+
+bool AssetManifest::Parse_Scenario(const char* text, size_t length) {
+    if (!text) {
+        return false;
+    }
+
+    const char* pos = text;
+    const char* end = text + length;
+    std::string section;
+    bool found_section = false;
+
+    while (pos < end) {
+        const char* line_end = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        if (!line_end) line_end = end;
+
+        const char* comment = static_cast<const char*>(memchr(pos, ';', line_end - pos));
+        std::string line = Trim_Upper(pos, comment ? comment : line_end);
+        pos = line_end + 1;
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            size_t close = line.find(']');
+            section = line.substr(1, close == std::string::npos ? std::string::npos : close - 1);
+            found_section = true;
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        std::string key = Trim_Upper(line.c_str(), line.c_str() + eq);
+        std::string value = Trim_Upper(line.c_str() + eq + 1, line.c_str() + line.size());
+
+        if (section == "BASIC" && key == "PLAYER") {
+            player_ = House_From_Name(value.c_str());
+        } else if (section == "MAP" && key == "THEATER") {
+            theater_ = Theater_From_Name(value);
+        } else if (section == "TERRAIN") {
+            terrain_.push_back(Field(value, 0));
+        } else if (Is_Object_Section(section)) {
+            Add_Placed_Type(Field(value, 1).c_str(), section == "STRUCTURES");
+        }
+    }
+
+    // Terrain art is per theater (T01.TEM, T01.SNO)
+    if (theater_ != THEATER_NONE) {
+        for (const std::string& name : terrain_) {
+            if (!name.empty()) {
+                Add_Shape((name + "." + TheaterFileSuffix[theater_]).c_str());
+            }
+        }
+    }
+    terrain_.clear();
+
+    Add_Player_Voices();
+    return found_section;
+}
+
+void AssetManifest::Add_Placed_Type(const char* type_name, bool is_structure) {
+    if (!type_name || !type_name[0]) {
+        return;
+    }
+
+    const char* shape = nullptr;
+    if (is_structure) {
+        BuildingType type = Building_Type_From_Name(type_name);
+        if (type != BUILDING_NONE) shape = BuildingTypes[type].Get_Shape_Name();
+    } else {
+        UnitType type = Unit_Type_From_Name(type_name);
+        if (type != UNIT_NONE) shape = UnitTypes[type].Get_Shape_Name();
+    }
+
+    // Types without a table entry use their INI name as the shape name
+    if (!shape || !shape[0]) {
+        shape = type_name;
+    }
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%s.SHP", shape);
+    Add_Shape(filename);
+}
+
+void AssetManifest::Add_Player_Voices() {
+    if (player_ == HOUSE_NONE) {
+        return;
+    }
+
+    VoiceFaction faction = Faction_For_House(player_);
+    for (int v = static_cast<int>(FIRST_RESPONSE); v <= static_cast<int>(LAST_RESPONSE); v++) {
+        UnitVoice voice = static_cast<UnitVoice>(v);
+        if (GetUnitVoiceFilename(voice, faction)) {
+            Add_Unit_Voice(voice, faction);
+        }
+    }
+}
+
+// =============================================================================
+// Entries
+// =============================================================================
+
+bool AssetManifest::Add(AssetKind kind, int16_t id, uint8_t faction, const char* name) {
+    std::string upper = name ? Trim_Upper(name, name + strlen(name)) : std::string();
+    if (kind == ASSET_KIND_SHAPE && upper.empty()) {
+        return false;
+    }
+
+    for (const AssetManifestEntry& entry : entries_) {
+        if (entry.kind == kind && entry.id == id && entry.faction == faction &&
+            entry.name == upper) {
+            return false;
+        }
+    }
+
+    entries_.push_back({kind, id, faction, std::move(upper)});
+    return true;
+}
+
+bool AssetManifest::Add_Shape(const char* filename) {
+    return Add(ASSET_KIND_SHAPE, 0, 0, filename);
+}
+
+bool AssetManifest::Add_Eva(EvaVoice voice) {
+    if (voice <= EvaVoice::NONE || voice >= EvaVoice::COUNT) {
+        return false;
+    }
+    return Add(ASSET_KIND_EVA, static_cast<int16_t>(voice), 0, nullptr);
+}
+
+bool AssetManifest::Add_Unit_Voice(UnitVoice voice, VoiceFaction faction) {
+    if (voice <= UnitVoice::NONE || voice >= UnitVoice::COUNT) {
+        return false;
+    }
+    return Add(ASSET_KIND_UNIT_VOICE, static_cast<int16_t>(voice),
+               static_cast<uint8_t>(faction), nullptr);
+}
+
+bool AssetManifest::Add_Sound(SoundEffect sfx) {
+    if (sfx <= SoundEffect::NONE || sfx >= SoundEffect::COUNT) {
+        return false;
+    }
+    return Add(ASSET_KIND_SOUND, static_cast<int16_t>(sfx), 0, nullptr);
+}
+
+void AssetManifest::Merge(const AssetManifest& other) {
+    for (const AssetManifestEntry& entry : other.entries_) {
+        Add(entry.kind, entry.id, entry.faction, entry.name.c_str());
+    }
+    if (theater_ == THEATER_NONE) theater_ = other.theater_;
+    if (player_ == HOUSE_NONE) player_ = other.player_;
+}
+
+void AssetManifest::Clear() {
+    entries_.clear();
+    terrain_.clear();
+    theater_ = THEATER_NONE;
+    player_ = HOUSE_NONE;
+}
+
+int AssetManifest::Prefetch(AssetPriority priority) const {
+    ShapeCache& shapes = ShapeCache::Instance();
+    VoiceManager& voices = VoiceManager::Instance();
+    SoundManager& sounds = SoundManager::Instance();
+    auto audio_lock = AudioSystem::Instance().LockState();
+    int queued = 0;
+
+    // Acknowledgements for the player's side, plus the shared lines
+    if (voices.IsInitialized()) {
+        voices.PreloadCommonVoices(VoiceFactionBit(VoiceFaction::NEUTRAL) |
+                                   VoiceFactionBit(Faction_For_House(player_)));
+    }
+
+    for (const AssetManifestEntry& entry : entries_) {
+        switch (entry.kind) {
+            case ASSET_KIND_SHAPE:
+                if (shapes.PreloadAsync(entry.name.c_str(), priority)) queued++;
+                break;
+
+            case ASSET_KIND_EVA:
+                if (voices.IsInitialized() &&
+                    voices.PreloadEvaAsync(static_cast<EvaVoice>(entry.id))) {
+                    queued++;
+                }
+                break;
+
+            case ASSET_KIND_UNIT_VOICE:
+                if (voices.IsInitialized() &&
+                    voices.PreloadUnitAsync(static_cast<UnitVoice>(entry.id),
+                                            static_cast<VoiceFaction>(entry.faction))) {
+                    queued++;
+                }
+                break;
+
+            case ASSET_KIND_SOUND:
+                if (sounds.IsInitialized() &&
+                    sounds.Preload(static_cast<SoundEffect>(entry.id), true)) {
+                    queued++;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    return queued;
+}
+
+// =============================================================================
+// First-Use Log
+// =============================================================================
+
+bool AssetManifest::Load_Log(const char* path) {
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_READ) : nullptr;
+    if (!file) {
+        return false;
+    }
+
+    int64_t size = Platform_File_Size(file);
+    std::string text(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+    int32_t read = text.empty() ? 0 : Platform_File_Read(file, &text[0], static_cast<int32_t>(text.size()));
+    Platform_File_Close(file);
+    text.resize(read > 0 ? static_cast<size_t>(read) : 0);
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t line_end = text.find('\n', pos);
+        if (line_end == std::string::npos) line_end = text.size();
+        std::string line = text.substr(pos, line_end - pos);
+        pos = line_end + 1;
+
+        char name[64];
+        int id = 0;
+        int faction = 0;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line.c_str(), "shape %63s", name) == 1) {
+            Add_Shape(name);
+        } else if (sscanf(line.c_str(), "eva %d", &id) == 1) {
+            Add_Eva(static_cast<EvaVoice>(id));
+        } else if (sscanf(line.c_str(), "voice %d %d", &id, &faction) == 2) {
+            Add_Unit_Voice(static_cast<UnitVoice>(id), static_cast<VoiceFaction>(faction));
+        } else if (sscanf(line.c_str(), "sound %d", &id) == 1) {
+            Add_Sound(static_cast<SoundEffect>(id));
+        }
+        // Anything else (a kind from a newer build) is skipped
+    }
+    return true;
+}
+
+bool AssetManifest::Save_Log(const char* path) const {
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_WRITE) : nullptr;
+    if (!file) {
+        return false;
+    }
+
+    std::string text = "# First-use log\n";
+    char line[96];
+    for (const AssetManifestEntry& entry : entries_) {
+        switch (entry.kind) {
+            case ASSET_KIND_SHAPE:
+                snprintf(line, sizeof(line), "shape %s\n", entry.name.c_str());
+                break;
+            case ASSET_KIND_EVA:
+                snprintf(line, sizeof(line), "eva %d\n", entry.id);
+                break;
+            case ASSET_KIND_UNIT_VOICE:
+                snprintf(line, sizeof(line), "voice %d %d\n", entry.id, entry.faction);
+                break;
+            case ASSET_KIND_SOUND:
+                snprintf(line, sizeof(line), "sound %d\n", entry.id);
+                break;
+            default:
+                continue;
+        }
+        text += line;
+    }
+
+    int32_t written = Platform_File_Write(file, text.data(), static_cast<int32_t>(text.size()));
+    Platform_File_Close(file);
+    return written == static_cast<int32_t>(text.size());
+}
+
+// =============================================================================
+// First-Use Recording
+// =============================================================================
+
+// Sounds and voices load on the audio thread when it runs
+static std::mutex record_mutex;
+
+void AssetManifest::Begin_Recording(AssetManifest* log) {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    recording_ = log;
+}
+
+void AssetManifest::End_Recording() {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    recording_ = nullptr;
+}
+
+bool AssetManifest::Is_Recording() {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    return recording_ != nullptr;
+}
+
+void AssetManifest::Record_Shape(const char* filename) {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    if (recording_) recording_->Add_Shape(filename);
+}
+
+void AssetManifest::Record_Eva(EvaVoice voice) {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    if (recording_) recording_->Add_Eva(voice);
+}
+
+void AssetManifest::Record_Unit_Voice(UnitVoice voice, VoiceFaction faction) {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    if (recording_) recording_->Add_Unit_Voice(voice, faction);
+}
+
+void AssetManifest::Record_Sound(SoundEffect sfx) {
+    std::lock_guard<std::mutex> lock(record_mutex);
+    if (recording_) recording_->Add_Sound(sfx);
+}
@@ -0,0 +1,499 @@
+/**
+ * AssetPack Implementation
+ *
+ * The pack is read in place, so every table is checked against the
+ * mapping before anything points into it: Open() checks the header and
+ * index, and each typed lookup checks its own blob. Fields are written
+ * in host order, which is little-endian on every supported platform.
+ */
+
+#include "game/asset_pack.h"
+#include "game/audio/aud_file.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/tile_renderer.h"
+#include "platform.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char PACK_MAGIC[4] = { 'R', 'A', 'P', 'K' };
+
+// Uppercase copy of a name; false if it does not fit an entry
+bool Pack_Name(const char* name, char* out, size_t out_size) {
+    if (!name || !name[0]) {
+        return false;
+    }
+    size_t length = strlen(name);
+    if (length >= out_size) {
+        return false;
+    }
+    memset(out, 0, out_size);
+    for (size_t i = 0; i < length; i++) {
+        out[i] = static_cast<char>(toupper(static_cast<unsigned char>(name[i])));
+    }
+    return true;
+}
+
+size_t Align(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+void Put(std::vector<uint8_t>& out, size_t offset, const T& value) {
+    memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+bool In_Blob(const AssetPackBlob& blob, uint64_t offset, uint64_t size) {
+    return offset <= blob.size && size <= blob.size - offset;
+}
+
+} // namespace
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+AssetPack& AssetPack::Instance() {
+    static AssetPack pack;
+    return pack;
+}
+
+bool AssetPack::Open(const char* path) {
+    Close();
+    if (!path) {
+        return false;
+    }
+
+    int64_t size = 0;
+    const uint8_t* data = Platform_File_Map(path, &size);
+    if (!data) {
+        return false;
+    }
+
+    data_ = data;
+    size_ = static_cast<size_t>(size);
+    mapped_ = true;
+    if (!Validate()) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "AssetPack: Ignoring malformed pack %s", path);
+        Platform_LogInfo(msg);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetPack::OpenMemory(const uint8_t* data, size_t size) {
+    Close();
+    if (!data) {
+        return false;
+    }
+
+    data_ = data;
+    size_ = size;
+    if (!Validate()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetPack::Close() {
+    if (mapped_) {
+        Platform_File_Unmap(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    entries_ = nullptr;
+    entry_count_ = 0;
+}
+
+bool AssetPack::Validate() {
+    AssetPackHeader header;
+    if (size_ < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data_, sizeof(header));
+
+    if (memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 ||
+        header.version != ASSET_PACK_VERSION ||
+        header.file_size != size_ ||
+        header.index_offset % alignof(AssetPackEntry) != 0 ||
+        header.index_offset > size_ ||
+        header.entry_count > (size_ - header.index_offset) / sizeof(AssetPackEntry)) {
+        return false;
+    }
+
+    const AssetPackEntry* entries =
+        reinterpret_cast<const AssetPackEntry*>(data_ + header.index_offset);
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.offset % alignof(uint64_t) != 0 ||
+            entry.offset > size_ || entry.size > size_ - entry.offset ||
+            entry.name[ASSET_PACK_NAME_SIZE - 1] != '\0' ||
+            (i > 0 && entries[i - 1].crc > entry.crc)) {
+            return false;
+        }
+    }
+
+    entries_ = entries;
+    entry_count_ = header.entry_count;
+    return true;
+}
+
+const AssetPackEntry* AssetPack::GetEntry(uint32_t index) const {
+    return index < entry_count_ ? &entries_[index] : nullptr;
+}
+
+AssetPackBlob AssetPack::Find(const char* name, AssetPackKind kind) const {
+    AssetPackBlob blob;
+    char key[ASSET_PACK_NAME_SIZE];
+    if (!entries_ || !Pack_Name(name, key, sizeof(key))) {
+        return blob;
+    }
+
+    uint32_t crc = Platform_Westwood_CRC_Filename(key);
+    const AssetPackEntry* end = entries_ + entry_count_;
+    const AssetPackEntry* it = std::lower_bound(entries_, end, crc,
+        [](const AssetPackEntry& entry, uint32_t value) { return entry.crc < value; });
+
+    // CRCs can collide, so check every entry with this one
+    for (; it != end && it->crc == crc; ++it) {
+        if (it->kind == kind && strcmp(it->name, key) == 0) {
+            blob.data = data_ + it->offset;
+            blob.size = static_cast<size_t>(it->size);
+            break;
+        }
+    }
+    return blob;
+}
+
+const AssetPackShape* AssetPack::FindShape(const char* name, AssetPackBlob* out) const {
+    AssetPackBlob blob = Find(name, ASSET_PACK_SHAPE);
+    if (!blob || blob.size < sizeof(AssetPackShape)) {
+        return nullptr;
+    }
+
+    const AssetPackShape* shape = reinterpret_cast<const AssetPackShape*>(blob.data);
+    if (!In_Blob(blob, sizeof(AssetPackShape),
+                 static_cast<uint64_t>(shape->frame_count) * sizeof(AssetPackFrame))) {
+        return nullptr;
+    }
+
+    const AssetPackFrame* frames = reinterpret_cast<const AssetPackFrame*>(shape + 1);
+    for (int i = 0; i < shape->frame_count; i++) {
+        const AssetPackFrame& frame = frames[i];
+        if (frame.width <= 0 || frame.height <= 0) {
+            continue;   // Empty frame
+        }
+        if (!In_Blob(blob, frame.spans_offset, frame.spans_size) ||
+            !In_Blob(blob, frame.rows_offset, (frame.height + 1) * sizeof(uint32_t))) {
+            return nullptr;
+        }
+    }
+
+    if (out) *out = blob;
+    return shape;
+}
+
+const AssetPackAtlas* AssetPack::FindAtlas(const char* name, AssetPackBlob* out) const {
+    AssetPackBlob blob = Find(name, ASSET_PACK_ATLAS);
+    if (!blob || blob.size < sizeof(AssetPackAtlas)) {
+        return nullptr;
+    }
+
+    const AssetPackAtlas* atlas = reinterpret_cast<const AssetPackAtlas*>(blob.data);
+    if (!In_Blob(blob, sizeof(AssetPackAtlas),
+                 static_cast<uint64_t>(atlas->template_count) * sizeof(AssetPackTemplate)) ||
+        !In_Blob(blob, atlas->tiles_offset, static_cast<uint64_t>(atlas->tile_count) * TILE_SIZE)) {
+        return nullptr;
+    }
+
+    const AssetPackTemplate* templates = reinterpret_cast<const AssetPackTemplate*>(atlas + 1);
+    for (uint32_t i = 0; i < atlas->template_count; i++) {
+        const AssetPackTemplate& tmpl = templates[i];
+        if (tmpl.name[sizeof(tmpl.name) - 1] != '\0' ||
+            tmpl.first_tile > atlas->tile_count ||
+            tmpl.tile_count > atlas->tile_count - tmpl.first_tile) {
+            return nullptr;
+        }
+    }
+
+    if (out) *out = blob;
+    return atlas;
+}
+
+const AssetPackAudio* AssetPack::FindAudio(const char* name, AssetPackBlob* out) const {
+    AssetPackBlob blob = Find(name, ASSET_PACK_AUDIO);
+    if (!blob || blob.size < sizeof(AssetPackAudio)) {
+        return nullptr;
+    }
+
+    const AssetPackAudio* audio = reinterpret_cast<const AssetPackAudio*>(blob.data);
+    if (audio->pcm_offset % sizeof(int16_t) != 0 ||
+        !In_Blob(blob, audio->pcm_offset, audio->pcm_size) ||
+        audio->sample_rate == 0 || audio->channels < 1 || audio->channels > 2) {
+        return nullptr;
+    }
+
+    if (out) *out = blob;
+    return audio;
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+bool AssetPackWriter::Has(const char* name, AssetPackKind kind) const {
+    char key[ASSET_PACK_NAME_SIZE];
+    if (!Pack_Name(name, key, sizeof(key))) {
+        return false;
+    }
+    for (const Blob& blob : blobs_) {
+        if (blob.entry.kind == kind && strcmp(blob.entry.name, key) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AssetPackWriter::Add(const char* name, AssetPackKind kind, std::vector<uint8_t> data) {
+    Blob blob;
+    memset(&blob.entry, 0, sizeof(blob.entry));
+    if (!Pack_Name(name, blob.entry.name, sizeof(blob.entry.name))) {
+        return false;
+    }
+
+    if (Has(blob.entry.name, kind)) {
+        return false;
+    }
+
+    blob.entry.crc = Platform_Westwood_CRC_Filename(blob.entry.name);
+    blob.entry.kind = kind;
+    blob.entry.size = data.size();
+    blob.data = std::move(data);
+    blobs_.push_back(std::move(blob));
+    return true;
+}
+
+int AssetPackWriter::AddPack(const AssetPack& pack) {
+    int added = 0;
+    for (uint32_t i = 0; i < pack.GetEntryCount(); i++) {
+        const AssetPackEntry* entry = pack.GetEntry(i);
+        AssetPackKind kind = static_cast<AssetPackKind>(entry->kind);
+        AssetPackBlob blob = pack.Find(entry->name, kind);
+        if (blob && Add(entry->name, kind, std::vector<uint8_t>(blob.data, blob.data + blob.size))) {
+            added++;
+        }
+    }
+    return added;
+}
+
+bool AssetPackWriter::AddShape(const char* name, ShapeRenderer& shape) {
+    int frame_count = shape.GetFrameCount();
+    if (!shape.IsLoaded() || frame_count <= 0 || frame_count > UINT16_MAX) {
+        return false;
+    }
+
+    // Encode every frame first to size the blob
+    std::vector<ShapeFrame> frames(frame_count);
+    for (int i = 0; i < frame_count; i++) {
+        ShapeFrame& frame = frames[i];
+        int w = 0, h = 0, x = 0, y = 0;
+        if (!shape.GetFrameSize(i, &w, &h) || !shape.GetFrameOffset(i, &x, &y)) {
+            continue;
+        }
+        frame.x_offset = static_cast<int16_t>(x);
+        frame.y_offset = static_cast<int16_t>(y);
+        frame.width = static_cast<int16_t>(w);
+        frame.height = static_cast<int16_t>(h);
+        frame.pixels.resize(frame.GetSize());
+        if (!shape.CopyFramePixels(i, frame.pixels.data(), w) || !frame.BuildSpans(true)) {
+            frame = ShapeFrame();
+        }
+    }
+
+    return AddFrames(name, frames, shape.GetWidth(), shape.GetHeight());
+}
+
+bool AssetPackWriter::AddFrames(const char* name, const std::vector<ShapeFrame>& frames,
+                                int width, int height) {
+    int frame_count = static_cast<int>(frames.size());
+    if (frame_count <= 0 || frame_count > UINT16_MAX) {
+        return false;
+    }
+
+    size_t size = sizeof(AssetPackShape) + frames.size() * sizeof(AssetPackFrame);
+    for (const ShapeFrame& frame : frames) {
+        if (!frame.HasSpans()) {
+            continue;
+        }
+        if (frame.row_offsets.size() != static_cast<size_t>(frame.height) + 1) {
+            return false;
+        }
+        size = Align(size + frame.spans.size(), sizeof(uint32_t));
+        size += frame.row_offsets.size() * sizeof(uint32_t);
+    }
+
+    std::vector<uint8_t> data(size, 0);
+    AssetPackShape header = {};
+    header.frame_count = static_cast<uint16_t>(frame_count);
+    header.width = static_cast<uint16_t>(width);
+    header.height = static_cast<uint16_t>(height);
+    Put(data, 0, header);
+
+    size_t pos = sizeof(AssetPackShape) + frames.size() * sizeof(AssetPackFrame);
+    for (int i = 0; i < frame_count; i++) {
+        const ShapeFrame& frame = frames[i];
+        AssetPackFrame entry = {};
+        if (frame.HasSpans()) {
+            entry.x_offset = frame.x_offset;
+            entry.y_offset = frame.y_offset;
+            entry.width = frame.width;
+            entry.height = frame.height;
+
+            entry.spans_offset = static_cast<uint32_t>(pos);
+            entry.spans_size = static_cast<uint32_t>(frame.spans.size());
+            if (!frame.spans.empty()) {
+                memcpy(data.data() + pos, frame.spans.data(), frame.spans.size());
+            }
+            pos = Align(pos + frame.spans.size(), sizeof(uint32_t));
+
+            entry.rows_offset = static_cast<uint32_t>(pos);
+            memcpy(data.data() + pos, frame.row_offsets.data(),
+                   frame.row_offsets.size() * sizeof(uint32_t));
+            pos += frame.row_offsets.size() * sizeof(uint32_t);
+        }
+        Put(data, sizeof(AssetPackShape) + i * sizeof(AssetPackFrame), entry);
+    }
+
+    return Add(name, ASSET_PACK_SHAPE, std::move(data));
+}
+
+bool AssetPackWriter::AddAtlas(const char* name, const std::vector<std::string>& names,
+                               const std::vector<const TemplateData*>& templates, int tile_size) {
+    if (names.size() != templates.size() || tile_size != TILE_SIZE) {
+        return false;
+    }
+
+    uint32_t tile_count = 0;
+    for (const TemplateData* tmpl : templates) {
+        if (tmpl) tile_count += static_cast<uint32_t>(tmpl->tile_count);
+    }
+
+    size_t tiles_offset = Align(sizeof(AssetPackAtlas) + templates.size() * sizeof(AssetPackTemplate),
+                                sizeof(uint32_t));
+    std::vector<uint8_t> data(tiles_offset + static_cast<size_t>(tile_count) * tile_size, 0);
+
+    uint32_t template_count = 0;
+    uint32_t next_tile = 0;
+    for (size_t i = 0; i < templates.size(); i++) {
+        const TemplateData* tmpl = templates[i];
+        AssetPackTemplate entry = {};
+        if (!tmpl || !tmpl->tiles || tmpl->tile_count <= 0 ||
+            !Pack_Name(names[i].c_str(), entry.name, sizeof(entry.name))) {
+            continue;
+        }
+
+        entry.first_tile = next_tile;
+        entry.tile_count = static_cast<uint32_t>(tmpl->tile_count);
+        memcpy(data.data() + tiles_offset + static_cast<size_t>(next_tile) * tile_size,
+               tmpl->tiles, static_cast<size_t>(tmpl->tile_count) * tile_size);
+        next_tile += entry.tile_count;
+
+        Put(data, sizeof(AssetPackAtlas) + template_count * sizeof(AssetPackTemplate), entry);
+        template_count++;
+    }
+    if (template_count == 0) {
+        return false;
+    }
+
+    AssetPackAtlas header = {};
+    header.template_count = template_count;
+    header.tile_count = next_tile;
+    header.tiles_offset = static_cast<uint32_t>(tiles_offset);
+    Put(data, 0, header);
+
+    return Add(name, ASSET_PACK_ATLAS, std::move(data));
+}
+
+bool AssetPackWriter::AddAudio(const char* name, const AudFile& aud) {
+    if (!aud.IsLoaded() || aud.GetPCMDataSize() == 0 || aud.GetPCMDataSize() > UINT32_MAX) {
+        return false;
+    }
+
+    std::vector<uint8_t> data(sizeof(AssetPackAudio) + aud.GetPCMDataSize());
+    AssetPackAudio header = {};
+    header.sample_rate = aud.GetSampleRate();
+    header.channels = static_cast<uint8_t>(aud.GetChannels());
+    header.compression = static_cast<uint8_t>(aud.GetCompressionType());
+    header.pcm_size = static_cast<uint32_t>(aud.GetPCMDataSize());
+    header.pcm_offset = sizeof(AssetPackAudio);
+    Put(data, 0, header);
+    memcpy(data.data() + sizeof(AssetPackAudio), aud.GetPCMDataBytes(), aud.GetPCMDataSize());
+
+    return Add(name, ASSET_PACK_AUDIO, std::move(data));
+}
+
+std::vector<uint8_t> AssetPackWriter::Build() const {
+    // Index order is CRC order; blobs follow in the same order
+    std::vector<const Blob*> order;
+    order.reserve(blobs_.size());
+    for (const Blob& blob : blobs_) {
+        order.push_back(&blob);
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [](const Blob* a, const Blob* b) { return a->entry.crc < b->entry.crc; });
+
+    size_t index_offset = sizeof(AssetPackHeader);
+    size_t pos = index_offset + order.size() * sizeof(AssetPackEntry);
+    std::vector<AssetPackEntry> entries;
+    entries.reserve(order.size());
+    for (const Blob* blob : order) {
+        AssetPackEntry entry = blob->entry;
+        pos = Align(pos, ASSET_PACK_PAGE_SIZE);
+        entry.offset = pos;
+        pos += blob->data.size();
+        entries.push_back(entry);
+    }
+
+    std::vector<uint8_t> out(pos, 0);
+    AssetPackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = ASSET_PACK_VERSION;
+    header.entry_count = static_cast<uint32_t>(entries.size());
+    header.page_size = ASSET_PACK_PAGE_SIZE;
+    header.index_offset = index_offset;
+    header.file_size = out.size();
+    Put(out, 0, header);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        Put(out, index_offset + i * sizeof(AssetPackEntry), entries[i]);
+        if (!order[i]->data.empty()) {
+            memcpy(out.data() + entries[i].offset, order[i]->data.data(), order[i]->data.size());
+        }
+    }
+    return out;
+}
+
+bool AssetPackWriter::Write(const char* path) const {
+    std::vector<uint8_t> data = Build();
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_WRITE) : nullptr;
+    if (!file) {
+        return false;
+    }
+
+    // Platform writes take 32-bit sizes
+    const size_t CHUNK = 1 << 20;
+    bool ok = true;
+    for (size_t pos = 0; ok && pos < data.size(); pos += CHUNK) {
+        int32_t count = static_cast<int32_t>(std::min(CHUNK, data.size() - pos));
+        ok = Platform_File_Write(file, data.data() + pos, count) == count;
+    }
+    Platform_File_Close(file);
+    return ok;
+}
@@ -3,7 +3,11 @@
 // Task 17a - AUD File Format Parser
 
 #include "game/audio/aud_file.h"
+#include "game/asset_pack.h"
+#include "game/shared_asset_cache.h"
+#include "game/mix_view.h"
 #include "platform.h"
+#include "platform/io_stats.h"
 #include <cstring>
 #include <algorithm>
 #include <cstdio>
@@ -13,7 +17,7 @@
 //=============================================================================
 
 // Westwood ADPCM step size table (89 values)
-static const int16_t WW_STEP_TABLE[89] = {
+static constexpr int16_t WW_STEP_TABLE[89] = {
     7,     8,     9,    10,    11,    12,    13,    14,
     16,    17,    19,    21,    23,    25,    28,    31,
     34,    37,    41,    45,    50,    55,    60,    66,
@@ -28,60 +32,85 @@ static const int16_t WW_STEP_TABLE[89] = {
 };
 
 // Westwood ADPCM index adjustment table
-static const int8_t WW_INDEX_TABLE[16] = {
+static constexpr int8_t WW_INDEX_TABLE[16] = {
     -1, -1, -1, -1, 2, 4, 6, 8,
     -1, -1, -1, -1, 2, 4, 6, 8
 };
 
+// WW ADPCM chunk layout
+static const uint32_t WW_CHUNK_SIZE = 16;
+static const uint32_t WW_NIBBLE_BYTES = 12;
+static const uint32_t WW_SAMPLES_PER_CHUNK = 1 + (WW_NIBBLE_BYTES * 2);
+
 //=============================================================================
-// AudFile Implementation
+// ADPCM Nibble Decoder
 //=============================================================================
 
-AudFile::AudFile()
-    : loaded_(false) {
-    memset(&header_, 0, sizeof(header_));
-}
+// WW and IMA ADPCM share the tables and the per-nibble math; IMA carries
+// the state through the whole file, WW reloads it from each chunk header.
+//
+// The step and index tables are folded into one table of signed predictor
+// changes and next step indices, so a nibble costs one load and a
+// branch-free clamp instead of four bit tests.
+struct AdpcmCode {
+    int32_t diff;           // Signed change to the predictor
+    int32_t next_index;     // Step index for the following nibble
+};
 
-AudFile::~AudFile() {
-    Clear();
-}
+struct AdpcmCodeTable {
+    AdpcmCode codes[89][16];
+};
 
-AudFile::AudFile(AudFile&& other) noexcept
-    : header_(other.header_)
-    , pcm_data_(std::move(other.pcm_data_))
-    , filename_(std::move(other.filename_))
-    , loaded_(other.loaded_) {
-    other.loaded_ = false;
-    memset(&other.header_, 0, sizeof(other.header_));
+static constexpr AdpcmCodeTable BuildAdpcmCodeTable() {
+    AdpcmCodeTable table{};
+    for (int index = 0; index < 89; index++) {
+        int32_t step = WW_STEP_TABLE[index];
+        for (int nibble = 0; nibble < 16; nibble++) {
+            int32_t diff = step >> 3;
+            if (nibble & 1) diff += step >> 2;
+            if (nibble & 2) diff += step >> 1;
+            if (nibble & 4) diff += step;
+            if (nibble & 8) diff = -diff;
+
+            int32_t next = index + WW_INDEX_TABLE[nibble];
+            table.codes[index][nibble].diff = diff;
+            table.codes[index][nibble].next_index = next < 0 ? 0 : (next > 88 ? 88 : next);
+        }
+    }
+    return table;
 }
 
-AudFile& AudFile::operator=(AudFile&& other) noexcept {
-    if (this != &other) {
-        header_ = other.header_;
-        pcm_data_ = std::move(other.pcm_data_);
-        filename_ = std::move(other.filename_);
-        loaded_ = other.loaded_;
+static constexpr AdpcmCodeTable ADPCM_CODES = BuildAdpcmCodeTable();
 
-        other.loaded_ = false;
-        memset(&other.header_, 0, sizeof(other.header_));
-    }
-    return *this;
+static inline int16_t DecodeAdpcmNibble(WwAdpcmState& state, uint32_t nibble) {
+    const AdpcmCode& code = ADPCM_CODES.codes[state.step_index][nibble];
+    state.predictor = std::min(std::max(state.predictor + code.diff, -32768), 32767);
+    state.step_index = code.next_index;
+    return static_cast<int16_t>(state.predictor);
 }
 
-void AudFile::Clear() {
-    pcm_data_.clear();
-    pcm_data_.shrink_to_fit();
-    filename_.clear();
-    memset(&header_, 0, sizeof(header_));
-    loaded_ = false;
+// Two samples per byte, low nibble first; `stride` spaces interleaved output
+static inline void DecodeAdpcmByte(WwAdpcmState& state, uint8_t byte, int16_t* out, size_t stride) {
+    out[0] = DecodeAdpcmNibble(state, byte & 0x0F);
+    out[stride] = DecodeAdpcmNibble(state, byte >> 4);
 }
 
 //=============================================================================
-// Loading Methods
+// AudDecoder Implementation
 //=============================================================================
 
-bool AudFile::LoadFromData(const uint8_t* data, uint32_t size) {
-    Clear();
+AudDecoder::AudDecoder()
+    : src_(nullptr)
+    , src_size_(0)
+    , src_pos_(0)
+    , total_samples_(0)
+    , pending_pos_(0)
+    , pending_count_(0) {
+    memset(&header_, 0, sizeof(header_));
+}
+
+bool AudDecoder::Open(const uint8_t* data, uint32_t size) {
+    Close();
 
     // Validate minimum size for header
     if (!data || size < sizeof(AudHeader)) {
@@ -89,24 +118,24 @@ bool AudFile::LoadFromData(const uint8_t* data, uint32_t size) {
         return false;
     }
 
-    // Copy header
-    memcpy(&header_, data, sizeof(AudHeader));
+    AudHeader header;
+    memcpy(&header, data, sizeof(AudHeader));
 
     // Validate header
-    if (header_.sample_rate == 0 || header_.sample_rate > 48000) {
+    if (header.sample_rate == 0 || header.sample_rate > 48000) {
         char msg[128];
-        snprintf(msg, sizeof(msg), "AudFile: Invalid sample rate %u", header_.sample_rate);
+        snprintf(msg, sizeof(msg), "AudFile: Invalid sample rate %u", header.sample_rate);
         Platform_LogInfo(msg);
         return false;
     }
 
-    if (header_.compressed_size == 0) {
+    if (header.compressed_size == 0) {
         Platform_LogInfo("AudFile: Zero compressed size");
         return false;
     }
 
     // Check we have enough data
-    uint32_t expected_size = sizeof(AudHeader) + header_.compressed_size;
+    uint32_t expected_size = sizeof(AudHeader) + header.compressed_size;
     if (size < expected_size) {
         char msg[128];
         snprintf(msg, sizeof(msg), "AudFile: Insufficient data (%u < %u)", size, expected_size);
@@ -114,324 +143,331 @@ bool AudFile::LoadFromData(const uint8_t* data, uint32_t size) {
         return false;
     }
 
-    // Get pointer to audio data (after header)
-    const uint8_t* audio_data = data + sizeof(AudHeader);
-    uint32_t audio_size = header_.compressed_size;
+    uint32_t audio_size = header.compressed_size;
+    bool stereo = (header.flags & AUD_FLAG_STEREO) != 0;
 
-    // Decode based on compression type
-    bool success = false;
-
-    switch (header_.compression) {
+    switch (header.compression) {
         case AUD_COMPRESS_NONE:
-            success = DecodeUncompressed(audio_data, audio_size);
+            total_samples_ = (header.flags & AUD_FLAG_16BIT) ? audio_size / 2 : audio_size;
             break;
 
         case AUD_COMPRESS_WW:
-            success = DecodeWwAdpcm(audio_data, audio_size);
+            if (audio_size < WW_CHUNK_SIZE) {
+                Platform_LogInfo("AudFile: WW ADPCM data too small");
+                return false;
+            }
+            // Stereo files alternate left and right chunks
+            total_samples_ = stereo
+                ? (audio_size / (WW_CHUNK_SIZE * 2)) * WW_SAMPLES_PER_CHUNK * 2
+                : (audio_size / WW_CHUNK_SIZE) * WW_SAMPLES_PER_CHUNK;
             break;
 
         case AUD_COMPRESS_IMA:
-            success = DecodeImaAdpcm(audio_data, audio_size);
+            // Each byte produces 2 samples
+            total_samples_ = static_cast<size_t>(audio_size) * 2;
             break;
 
         default:
             {
                 char msg[128];
-                snprintf(msg, sizeof(msg), "AudFile: Unknown compression type %u", header_.compression);
+                snprintf(msg, sizeof(msg), "AudFile: Unknown compression type %u", header.compression);
                 Platform_LogInfo(msg);
             }
             return false;
     }
 
-    if (success) {
-        loaded_ = true;
-    }
+    header_ = header;
+    src_ = data + sizeof(AudHeader);
+    src_size_ = audio_size;
+    Rewind();
+    return true;
+}
 
-    return success;
+void AudDecoder::Close() {
+    memset(&header_, 0, sizeof(header_));
+    src_ = nullptr;
+    src_size_ = 0;
+    total_samples_ = 0;
+    Rewind();
 }
 
-bool AudFile::LoadFromMix(const char* filename) {
-    if (!filename) return false;
+void AudDecoder::Rewind() {
+    src_pos_ = 0;
+    state_[0].Reset();
+    state_[1].Reset();
+    pending_pos_ = 0;
+    pending_count_ = 0;
+}
 
-    // Check if file exists in any loaded MIX
-    int32_t file_size = Platform_Mix_GetSize(filename);
-    if (file_size <= 0) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "AudFile: File not found in MIX: %s", filename);
-        Platform_LogInfo(msg);
-        return false;
+uint32_t AudDecoder::BlockBytes() const {
+    switch (header_.compression) {
+        case AUD_COMPRESS_WW:  return WW_CHUNK_SIZE * GetChannels();
+        case AUD_COMPRESS_IMA: return 1;
+        default:               return (header_.flags & AUD_FLAG_16BIT) ? 2 : 1;
     }
+}
 
-    // Allocate buffer and read file
-    std::vector<uint8_t> buffer(static_cast<size_t>(file_size));
-    int32_t bytes_read = Platform_Mix_Read(filename, buffer.data(), file_size);
-
-    if (bytes_read != file_size) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "AudFile: Failed to read %s (got %d, expected %d)",
-                 filename, bytes_read, file_size);
-        Platform_LogInfo(msg);
-        return false;
-    }
+size_t AudDecoder::BlockSamples() const {
+    return header_.compression == AUD_COMPRESS_WW ? WW_SAMPLES_PER_CHUNK * GetChannels() : 2;
+}
 
-    filename_ = filename;
-    return LoadFromData(buffer.data(), static_cast<uint32_t>(file_size));
+bool AudDecoder::IsFinished() const {
+    return !src_ || (pending_pos_ >= pending_count_ && src_size_ - src_pos_ < BlockBytes());
 }
 
-//=============================================================================
-// Decode Uncompressed PCM
-//=============================================================================
+size_t AudDecoder::Decode(int16_t* out, size_t max_samples) {
+    if (!src_ || !out) {
+        return 0;
+    }
 
-bool AudFile::DecodeUncompressed(const uint8_t* src, uint32_t src_size) {
-    if (Is16Bit()) {
-        // 16-bit PCM - copy directly
-        size_t sample_count = src_size / 2;
-        pcm_data_.resize(sample_count);
+    if (header_.compression == AUD_COMPRESS_NONE) {
+        return DecodeUncompressed(out, max_samples);
+    }
 
-        const int16_t* src16 = reinterpret_cast<const int16_t*>(src);
-        for (size_t i = 0; i < sample_count; i++) {
-            pcm_data_[i] = src16[i];
+    size_t written = 0;
+    while (written < max_samples) {
+        // Finish the block a previous call had to split
+        if (pending_pos_ < pending_count_) {
+            size_t count = std::min(pending_count_ - pending_pos_, max_samples - written);
+            memcpy(out + written, pending_ + pending_pos_, count * sizeof(int16_t));
+            pending_pos_ += count;
+            written += count;
+            continue;
         }
-    } else {
-        // 8-bit unsigned PCM - convert to 16-bit signed
-        size_t sample_count = src_size;
-        pcm_data_.resize(sample_count);
-
-        for (size_t i = 0; i < sample_count; i++) {
-            // Convert unsigned 8-bit [0..255] to signed 16-bit [-32768..32767]
-            int16_t sample = (static_cast<int16_t>(src[i]) - 128) * 256;
-            pcm_data_[i] = sample;
+
+        if (src_size_ - src_pos_ < BlockBytes()) {
+            break;
+        }
+
+        size_t room = max_samples - written;
+        if (header_.compression == AUD_COMPRESS_IMA && room >= 2) {
+            // No block structure: run straight through the bytes
+            size_t bytes = std::min<size_t>(room / 2, src_size_ - src_pos_);
+            const uint8_t* src = src_ + src_pos_;
+            int16_t* dst = out + written;
+            for (size_t i = 0; i < bytes; i++) {
+                DecodeAdpcmByte(state_[0], src[i], dst + i * 2, 1);
+            }
+            src_pos_ += static_cast<uint32_t>(bytes);
+            written += bytes * 2;
+        } else if (room >= BlockSamples()) {
+            written += DecodeBlock(out + written);
+        } else {
+            pending_count_ = DecodeBlock(pending_);
+            pending_pos_ = 0;
         }
     }
 
-    return true;
+    return written;
 }
 
-//=============================================================================
-// WW ADPCM Decoder
-//=============================================================================
-
-int16_t AudFile::DecodeWwNibble(WwAdpcmState& state, uint8_t nibble) {
-    // Get step size from table
-    int32_t step = WW_STEP_TABLE[state.step_index];
+size_t AudDecoder::DecodeBlock(int16_t* out) {
+    const uint8_t* block = src_ + src_pos_;
+    src_pos_ += BlockBytes();
 
-    // Calculate difference
-    int32_t diff = step >> 3;
-
-    if (nibble & 1) diff += step >> 2;
-    if (nibble & 2) diff += step >> 1;
-    if (nibble & 4) diff += step;
-
-    // Apply sign bit
-    if (nibble & 8) {
-        diff = -diff;
+    if (header_.compression == AUD_COMPRESS_IMA) {
+        DecodeAdpcmByte(state_[0], block[0], out, 1);
+        return 2;
     }
 
-    // Update predictor
-    state.predictor += diff;
-
-    // Clamp to 16-bit range
-    if (state.predictor > 32767) state.predictor = 32767;
-    if (state.predictor < -32768) state.predictor = -32768;
-
-    // Update step index
-    state.step_index += WW_INDEX_TABLE[nibble & 0x0F];
-
-    // Clamp step index
-    if (state.step_index < 0) state.step_index = 0;
-    if (state.step_index > 88) state.step_index = 88;
-
-    return static_cast<int16_t>(state.predictor);
-}
-
-bool AudFile::DecodeWwAdpcm(const uint8_t* src, uint32_t src_size) {
-    // WW ADPCM works in 16-byte chunks:
+    // WW ADPCM works in 16-byte chunks, one per channel (left first):
     //   - 2 bytes: initial predictor (int16)
     //   - 1 byte: initial step index
     //   - 1 byte: reserved (0)
     //   - 12 bytes: ADPCM nibbles (24 samples)
     // Total: 25 samples per 16-byte chunk
-
-    const uint32_t CHUNK_SIZE = 16;
-    const uint32_t NIBBLE_BYTES = 12;
-    const uint32_t SAMPLES_PER_CHUNK = 1 + (NIBBLE_BYTES * 2);
-
-    if (src_size < CHUNK_SIZE) {
-        Platform_LogInfo("AudFile: WW ADPCM data too small");
-        return false;
+    int channels = GetChannels();
+    for (int ch = 0; ch < channels; ch++) {
+        const uint8_t* chunk = block + ch * WW_CHUNK_SIZE;
+
+        // Chunks may be unaligned inside a MIX view
+        int16_t initial;
+        memcpy(&initial, chunk, sizeof(initial));
+        state_[ch].predictor = initial;
+        state_[ch].step_index = std::min(static_cast<int32_t>(chunk[2]), 88);
+        out[ch] = initial;
     }
 
-    // Calculate expected output size
-    uint32_t num_chunks = src_size / CHUNK_SIZE;
-    uint32_t expected_samples = num_chunks * SAMPLES_PER_CHUNK;
-
-    if (IsStereo()) {
-        num_chunks /= 2;
-        expected_samples = num_chunks * SAMPLES_PER_CHUNK * 2;
+    const uint8_t* nibbles_l = block + 4;
+    int16_t* dst = out + channels;
+    if (channels == 1) {
+        for (uint32_t i = 0; i < WW_NIBBLE_BYTES; i++) {
+            DecodeAdpcmByte(state_[0], nibbles_l[i], dst + i * 2, 1);
+        }
+    } else {
+        // The two channels are independent, so decoding them side by side
+        // overlaps their dependency chains
+        const uint8_t* nibbles_r = nibbles_l + WW_CHUNK_SIZE;
+        for (uint32_t i = 0; i < WW_NIBBLE_BYTES; i++) {
+            DecodeAdpcmByte(state_[0], nibbles_l[i], dst + i * 4, 2);
+            DecodeAdpcmByte(state_[1], nibbles_r[i], dst + i * 4 + 1, 2);
+        }
     }
 
-    pcm_data_.reserve(expected_samples);
+    return WW_SAMPLES_PER_CHUNK * channels;
+}
 
-    if (IsStereo()) {
-        // Stereo decoding - interleave L/R samples
-        WwAdpcmState state_l, state_r;
+size_t AudDecoder::DecodeUncompressed(int16_t* out, size_t max_samples) {
+    const uint8_t* src = src_ + src_pos_;
+    uint32_t remaining = src_size_ - src_pos_;
 
-        const uint8_t* ptr = src;
-        const uint8_t* end = src + src_size;
+    if (header_.flags & AUD_FLAG_16BIT) {
+        // 16-bit PCM - copy directly (src may be unaligned inside a MIX view)
+        size_t count = std::min<size_t>(max_samples, remaining / 2);
+        memcpy(out, src, count * sizeof(int16_t));
+        src_pos_ += static_cast<uint32_t>(count * 2);
+        return count;
+    }
 
-        while (ptr + CHUNK_SIZE * 2 <= end) {
-            // Left channel chunk
-            int16_t initial_l = *reinterpret_cast<const int16_t*>(ptr);
-            uint8_t index_l = ptr[2];
-            const uint8_t* nibbles_l = ptr + 4;
-            ptr += CHUNK_SIZE;
+    // 8-bit unsigned PCM - convert to 16-bit signed
+    size_t count = std::min<size_t>(max_samples, remaining);
+    for (size_t i = 0; i < count; i++) {
+        // Convert unsigned 8-bit [0..255] to signed 16-bit [-32768..32767]
+        out[i] = static_cast<int16_t>((static_cast<int16_t>(src[i]) - 128) * 256);
+    }
+    src_pos_ += static_cast<uint32_t>(count);
+    return count;
+}
 
-            // Right channel chunk
-            int16_t initial_r = *reinterpret_cast<const int16_t*>(ptr);
-            uint8_t index_r = ptr[2];
-            const uint8_t* nibbles_r = ptr + 4;
-            ptr += CHUNK_SIZE;
+//=============================================================================
+// AudStream Implementation
+//=============================================================================
 
-            // Initialize states
-            state_l.predictor = initial_l;
-            state_l.step_index = std::min(static_cast<int32_t>(index_l), 88);
-            state_r.predictor = initial_r;
-            state_r.step_index = std::min(static_cast<int32_t>(index_r), 88);
+bool AudStream::Open(const char* filename) {
+    Close();
 
-            // Output initial samples (interleaved)
-            pcm_data_.push_back(initial_l);
-            pcm_data_.push_back(initial_r);
+    if (!view_.Open(filename)) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "AudFile: File not found in MIX: %s", filename ? filename : "(null)");
+        Platform_LogInfo(msg);
+        return false;
+    }
 
-            // Decode nibbles
-            for (uint32_t i = 0; i < NIBBLE_BYTES; i++) {
-                int16_t sample_l1 = DecodeWwNibble(state_l, nibbles_l[i] & 0x0F);
-                int16_t sample_r1 = DecodeWwNibble(state_r, nibbles_r[i] & 0x0F);
-                pcm_data_.push_back(sample_l1);
-                pcm_data_.push_back(sample_r1);
+    if (!decoder_.Open(view_.Data(), static_cast<uint32_t>(view_.Size()))) {
+        view_.Close();
+        return false;
+    }
+    return true;
+}
 
-                int16_t sample_l2 = DecodeWwNibble(state_l, (nibbles_l[i] >> 4) & 0x0F);
-                int16_t sample_r2 = DecodeWwNibble(state_r, (nibbles_r[i] >> 4) & 0x0F);
-                pcm_data_.push_back(sample_l2);
-                pcm_data_.push_back(sample_r2);
-            }
-        }
-    } else {
-        // Mono decoding
-        WwAdpcmState state;
+void AudStream::Close() {
+    decoder_.Close();
+    view_.Close();
+}
 
-        const uint8_t* ptr = src;
-        const uint8_t* end = src + src_size;
+//=============================================================================
+// AudFile Implementation
+//=============================================================================
 
-        while (ptr + CHUNK_SIZE <= end) {
-            // Read chunk header
-            int16_t initial = *reinterpret_cast<const int16_t*>(ptr);
-            uint8_t index = ptr[2];
-            const uint8_t* nibbles = ptr + 4;
-            ptr += CHUNK_SIZE;
+AudFile::AudFile()
+    : loaded_(false) {
+    memset(&header_, 0, sizeof(header_));
+}
 
-            // Initialize state from chunk header
-            state.predictor = initial;
-            state.step_index = std::min(static_cast<int32_t>(index), 88);
+AudFile::~AudFile() {
+    Clear();
+}
 
-            // Output initial sample
-            pcm_data_.push_back(initial);
+AudFile::AudFile(AudFile&& other) noexcept
+    : header_(other.header_)
+    , pcm_data_(std::move(other.pcm_data_))
+    , filename_(std::move(other.filename_))
+    , loaded_(other.loaded_) {
+    other.loaded_ = false;
+    memset(&other.header_, 0, sizeof(other.header_));
+}
 
-            // Decode nibbles
-            for (uint32_t i = 0; i < NIBBLE_BYTES; i++) {
-                int16_t sample1 = DecodeWwNibble(state, nibbles[i] & 0x0F);
-                pcm_data_.push_back(sample1);
+AudFile& AudFile::operator=(AudFile&& other) noexcept {
+    if (this != &other) {
+        header_ = other.header_;
+        pcm_data_ = std::move(other.pcm_data_);
+        filename_ = std::move(other.filename_);
+        loaded_ = other.loaded_;
 
-                int16_t sample2 = DecodeWwNibble(state, (nibbles[i] >> 4) & 0x0F);
-                pcm_data_.push_back(sample2);
-            }
-        }
+        other.loaded_ = false;
+        memset(&other.header_, 0, sizeof(other.header_));
     }
+    return *this;
+}
 
-    return !pcm_data_.empty();
+void AudFile::Clear() {
+    pcm_data_.clear();
+    pcm_data_.shrink_to_fit();
+    filename_.clear();
+    memset(&header_, 0, sizeof(header_));
+    loaded_ = false;
 }
 
 //=============================================================================
-// IMA ADPCM Decoder
+// Loading Methods
 //=============================================================================
 
-bool AudFile::DecodeImaAdpcm(const uint8_t* src, uint32_t src_size) {
-    // Each byte produces 2 samples
-    size_t expected_samples = src_size * 2;
-
-    pcm_data_.resize(expected_samples);
-
-    // IMA ADPCM tables (same as WW)
-    static const int16_t ima_step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
-        19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
-        50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
-        130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
-        337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
-        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
-        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
-        5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
-        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
-    };
-
-    static const int8_t ima_index_table[16] = {
-        -1, -1, -1, -1, 2, 4, 6, 8,
-        -1, -1, -1, -1, 2, 4, 6, 8
-    };
-
-    int32_t predictor = 0;
-    int32_t step_index = 0;
-    size_t out_idx = 0;
-
-    for (uint32_t i = 0; i < src_size && out_idx < expected_samples; i++) {
-        uint8_t byte = src[i];
-
-        // Decode low nibble
-        {
-            uint8_t nibble = byte & 0x0F;
-            int32_t step = ima_step_table[step_index];
+bool AudFile::LoadFromData(const uint8_t* data, uint32_t size) {
+    Clear();
 
-            int32_t diff = step >> 3;
-            if (nibble & 1) diff += step >> 2;
-            if (nibble & 2) diff += step >> 1;
-            if (nibble & 4) diff += step;
-            if (nibble & 8) diff = -diff;
+    AudDecoder decoder;
+    if (!decoder.Open(data, size)) {
+        return false;
+    }
+    header_ = decoder.GetHeader();
 
-            predictor += diff;
-            if (predictor > 32767) predictor = 32767;
-            if (predictor < -32768) predictor = -32768;
+    pcm_data_.resize(decoder.GetTotalSamples());
+    pcm_data_.resize(decoder.Decode(pcm_data_.data(), pcm_data_.size()));
 
-            pcm_data_[out_idx++] = static_cast<int16_t>(predictor);
+    // ADPCM data too short for a single block decodes to nothing
+    if (pcm_data_.empty() && header_.compression != AUD_COMPRESS_NONE) {
+        return false;
+    }
 
-            step_index += ima_index_table[nibble];
-            if (step_index < 0) step_index = 0;
-            if (step_index > 88) step_index = 88;
-        }
+    loaded_ = true;
+    return true;
+}
 
-        // Decode high nibble
-        {
-            uint8_t nibble = (byte >> 4) & 0x0F;
-            int32_t step = ima_step_table[step_index];
+bool AudFile::LoadFromMix(const char* filename) {
+    if (!filename) return false;
 
-            int32_t diff = step >> 3;
-            if (nibble & 1) diff += step >> 2;
-            if (nibble & 2) diff += step >> 1;
-            if (nibble & 4) diff += step;
-            if (nibble & 8) diff = -diff;
+    if (LoadFromPack(filename)) {
+        return true;
+    }
 
-            predictor += diff;
-            if (predictor > 32767) predictor = 32767;
-            if (predictor < -32768) predictor = -32768;
+    // Parse straight from the archive
+    IoScope io(IoTag::AUDIO);
+    MixView view(filename);
+    if (!view) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "AudFile: File not found in MIX: %s", filename);
+        Platform_LogInfo(msg);
+        return false;
+    }
 
-            pcm_data_[out_idx++] = static_cast<int16_t>(predictor);
+    filename_ = filename;
+    if (!LoadFromData(view.Data(), static_cast<uint32_t>(view.Size()))) {
+        return false;
+    }
+    SharedAssetCache::Note_Audio(filename);
+    return true;
+}
 
-            step_index += ima_index_table[nibble];
-            if (step_index < 0) step_index = 0;
-            if (step_index > 88) step_index = 88;
-        }
+bool AudFile::LoadFromPack(const char* filename) {
+    AssetPackBlob blob;
+    const AssetPackAudio* packed = filename ? AssetPack::Instance().FindAudio(filename, &blob) : nullptr;
+    if (!packed) {
+        return false;
     }
 
-    pcm_data_.resize(out_idx);
-    return !pcm_data_.empty();
+    Clear();
+    header_.sample_rate = packed->sample_rate;
+    header_.uncompressed_size = packed->pcm_size;
+    header_.compressed_size = packed->pcm_size;
+    header_.flags = static_cast<uint8_t>(AUD_FLAG_16BIT | (packed->channels == 2 ? AUD_FLAG_STEREO : 0));
+    header_.compression = packed->compression;
+
+    pcm_data_.resize(packed->pcm_size / sizeof(int16_t));
+    memcpy(pcm_data_.data(), blob.data + packed->pcm_offset, pcm_data_.size() * sizeof(int16_t));
+
+    filename_ = filename;
+    loaded_ = true;
+    return true;
 }
 
 //=============================================================================
@@ -542,3 +578,10 @@ bool GetAudInfo(const uint8_t* data, uint32_t size, AudHeader* out_header) {
 
     return true;
 }
+
+void DecodeImaAdpcm(WwAdpcmState& state, const uint8_t* data, size_t bytes,
+                    int16_t* out, size_t stride) {
+    for (size_t i = 0; i < bytes; i++) {
+        DecodeAdpcmByte(state, data[i], out + i * 2 * stride, stride);
+    }
+}
@@ -0,0 +1,48 @@
+// src/game/audio/audio_event_batch.cpp
+// Per-tick coalescing of positional audio events
+
+#include "game/audio/audio_event_batch.h"
+#include <algorithm>
+#include <cmath>
+
+bool AudioEventBatch::Add(AudioEventType type, SoundEffect sfx, int world_x, int world_y) {
+    static const int64_t MERGE_RADIUS_SQ = static_cast<int64_t>(MERGE_RADIUS) * MERGE_RADIUS;
+
+    for (int i = 0; i < count_; i++) {
+        CoalescedAudioEvent& entry = entries_[i];
+        if (entry.type != type || entry.sfx != sfx) {
+            continue;
+        }
+        int64_t dx = world_x - entry.anchor_x;
+        int64_t dy = world_y - entry.anchor_y;
+        if (dx * dx + dy * dy <= MERGE_RADIUS_SQ) {
+            entry.sum_x += world_x;
+            entry.sum_y += world_y;
+            entry.count++;
+            return true;
+        }
+    }
+
+    if (count_ >= MAX_ENTRIES) {
+        return false;
+    }
+
+    CoalescedAudioEvent& entry = entries_[count_++];
+    entry.type = type;
+    entry.sfx = sfx;
+    entry.anchor_x = world_x;
+    entry.anchor_y = world_y;
+    entry.sum_x = world_x;
+    entry.sum_y = world_y;
+    entry.count = 1;
+    return true;
+}
+
+float AudioEventBatch::GetVolumeForCount(int count) {
+    // Loudness grows with the square root of the number of sources,
+    // as for uncorrelated sounds summing in the mixer
+    if (count <= 1) {
+        return 1.0f;
+    }
+    return std::min(std::sqrt(static_cast<float>(count)), MAX_VOLUME_BOOST);
+}
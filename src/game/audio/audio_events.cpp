@@ -4,6 +4,7 @@
 
 #include "game/audio/audio_events.h"
 #include "game/audio/event_rate_limiter.h"
+#include "game/audio/audio_event_batch.h"
 #include "game/audio/audio_system.h"
 #include "game/audio/sound_effect.h"
 #include "game/audio/voice_event.h"
@@ -17,8 +18,12 @@
 
 static uint32_t s_total_triggered = 0;
 static uint32_t s_total_rate_limited = 0;
+static uint32_t s_total_coalesced = 0;
 static bool s_initialized = false;
 
+// Positional combat events raised this tick, played by AudioEvents_FlushTick()
+static AudioEventBatch s_batch;
+
 //=============================================================================
 // Helper Macros
 //=============================================================================
@@ -32,11 +37,11 @@ static bool s_initialized = false;
         return; \
     }
 
-#define RATE_LIMITED_POSITION_EVENT(event_type, cx, cy) \
+// Queue for the end of the tick; if the batch is full, play right away
+#define BATCHED_POSITION_EVENT(event_type, sfx, wx, wy) \
     s_total_triggered++; \
-    if (!GetEventRateLimiter().CanFireGlobalAndPosition(static_cast<int>(event_type), cx, cy)) { \
-        s_total_rate_limited++; \
-        return; \
+    if (!s_batch.Add(event_type, sfx, wx, wy)) { \
+        FirePositionEvent(event_type, sfx, wx, wy, 1); \
     }
 
 #define RATE_LIMITED_OBJECT_EVENT(event_type, obj_id) \
@@ -55,6 +60,17 @@ static inline int WorldToCell(int world_coord) {
     return world_coord / 24;  // 24 pixels per cell (ICON_PIXEL_W)
 }
 
+// Rate limit and play a (possibly coalesced) positional event
+static void FirePositionEvent(AudioEventType type, SoundEffect sfx, int world_x, int world_y, int count) {
+    if (!GetEventRateLimiter().CanFireGlobalAndPosition(static_cast<int>(type),
+                                                        WorldToCell(world_x), WorldToCell(world_y))) {
+        s_total_rate_limited += count;
+        return;
+    }
+    s_total_coalesced += count - 1;
+    AudioSystem::Instance().PlaySoundAt(sfx, world_x, world_y, AudioEventBatch::GetVolumeForCount(count));
+}
+
 // Get object ID for rate limiting (use pointer as ID for now)
 static inline ObjectKey GetObjectId(void* obj) {
     return static_cast<ObjectKey>(reinterpret_cast<uintptr_t>(obj));
@@ -150,6 +166,8 @@ void AudioEvents_Init() {
 
     s_total_triggered = 0;
     s_total_rate_limited = 0;
+    s_total_coalesced = 0;
+    s_batch.Clear();
     s_initialized = true;
 
     Platform_LogInfo("AudioEvents: Initialized with rate limiters");
@@ -161,6 +179,7 @@ void AudioEvents_Shutdown() {
     }
 
     GetEventRateLimiter().Reset();
+    s_batch.Clear();
     s_initialized = false;
 
     printf("AudioEvents: Shutdown (triggered: %u, rate-limited: %u)\n",
@@ -176,15 +195,10 @@ void AudioEvent_Damage(ObjectClass* obj, int damage, int source_x, int source_y)
 
     if (!obj) return;
 
-    int cx = WorldToCell(source_x);
-    int cy = WorldToCell(source_y);
-
     if (damage > 50) {
-        RATE_LIMITED_POSITION_EVENT(AudioEventType::DAMAGE_LARGE, cx, cy);
-        AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_LARGE, source_x, source_y);
+        BATCHED_POSITION_EVENT(AudioEventType::DAMAGE_LARGE, SoundEffect::EXPLODE_LARGE, source_x, source_y);
     } else if (damage > 10) {
-        RATE_LIMITED_POSITION_EVENT(AudioEventType::DAMAGE_SMALL, cx, cy);
-        AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_SMALL, source_x, source_y);
+        BATCHED_POSITION_EVENT(AudioEventType::DAMAGE_SMALL, SoundEffect::EXPLODE_SMALL, source_x, source_y);
     }
     // Very small damage doesn't play sound
 }
@@ -192,44 +206,37 @@ void AudioEvent_Damage(ObjectClass* obj, int damage, int source_x, int source_y)
 void AudioEvent_Explosion(int world_x, int world_y, int size) {
     CHECK_INITIALIZED();
 
-    int cx = WorldToCell(world_x);
-    int cy = WorldToCell(world_y);
-
     if (size >= 2) {
-        RATE_LIMITED_POSITION_EVENT(AudioEventType::EXPLOSION_LARGE, cx, cy);
-        AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_LARGE, world_x, world_y);
+        BATCHED_POSITION_EVENT(AudioEventType::EXPLOSION_LARGE, SoundEffect::EXPLODE_LARGE, world_x, world_y);
     } else if (size >= 1) {
-        RATE_LIMITED_POSITION_EVENT(AudioEventType::EXPLOSION_SMALL, cx, cy);
-        AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_MEDIUM, world_x, world_y);
+        BATCHED_POSITION_EVENT(AudioEventType::EXPLOSION_SMALL, SoundEffect::EXPLODE_MEDIUM, world_x, world_y);
     } else {
-        RATE_LIMITED_POSITION_EVENT(AudioEventType::EXPLOSION_SMALL, cx, cy);
-        AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_SMALL, world_x, world_y);
+        BATCHED_POSITION_EVENT(AudioEventType::EXPLOSION_SMALL, SoundEffect::EXPLODE_SMALL, world_x, world_y);
     }
 }
 
 void AudioEvent_WeaponFire(WeaponTypeClass* weapon, int world_x, int world_y) {
     CHECK_INITIALIZED();
 
-    int cx = WorldToCell(world_x);
-    int cy = WorldToCell(world_y);
-
-    RATE_LIMITED_POSITION_EVENT(AudioEventType::WEAPON_FIRE, cx, cy);
-
     // In real implementation, get weapon sound from WeaponTypeClass
     // For now, play generic weapon sound
-    AudioSystem::Instance().PlaySoundAt(SoundEffect::WEAPON_MGUN, world_x, world_y);
+    BATCHED_POSITION_EVENT(AudioEventType::WEAPON_FIRE, SoundEffect::WEAPON_MGUN, world_x, world_y);
 }
 
 void AudioEvent_ProjectileImpact(BulletClass* bullet, int world_x, int world_y) {
     CHECK_INITIALIZED();
 
-    int cx = WorldToCell(world_x);
-    int cy = WorldToCell(world_y);
+    // In real implementation, get impact sound from bullet type
+    BATCHED_POSITION_EVENT(AudioEventType::PROJECTILE_IMPACT, SoundEffect::IMPACT_SHELL, world_x, world_y);
+}
 
-    RATE_LIMITED_POSITION_EVENT(AudioEventType::PROJECTILE_IMPACT, cx, cy);
+void AudioEvents_FlushTick() {
+    CHECK_INITIALIZED();
 
-    // In real implementation, get impact sound from bullet type
-    AudioSystem::Instance().PlaySoundAt(SoundEffect::IMPACT_SHELL, world_x, world_y);
+    // One limiter check and one voice per merged group
+    s_batch.Flush([](const CoalescedAudioEvent& event) {
+        FirePositionEvent(event.type, event.sfx, event.GetCenterX(), event.GetCenterY(), event.count);
+    });
 }
 
 //=============================================================================
@@ -283,13 +290,9 @@ void AudioEvent_UnitDeath(ObjectClass* obj) {
     // For now, use 0,0 as placeholder
     int wx = 0;
     int wy = 0;
-    int cx = WorldToCell(wx);
-    int cy = WorldToCell(wy);
-
-    RATE_LIMITED_POSITION_EVENT(AudioEventType::UNIT_DEATH, cx, cy);
 
     // Play death sound - in real implementation, based on unit type
-    AudioSystem::Instance().PlaySoundAt(SoundEffect::EXPLODE_SMALL, wx, wy);
+    BATCHED_POSITION_EVENT(AudioEventType::UNIT_DEATH, SoundEffect::EXPLODE_SMALL, wx, wy);
 }
 
 void AudioEvent_UnitCreated(ObjectClass* obj, HouseClass* house) {
@@ -640,6 +643,8 @@ void AudioEvents_PrintStats() {
     printf("  Initialized: %s\n", s_initialized ? "yes" : "no");
     printf("  Total Triggered: %u\n", s_total_triggered);
     printf("  Total Rate-Limited: %u\n", s_total_rate_limited);
+    printf("  Total Coalesced: %u\n", s_total_coalesced);
+    printf("  Pending This Tick: %d\n", s_batch.GetPendingCount());
 
     if (s_total_triggered > 0) {
         float rate = (float)s_total_rate_limited / (float)s_total_triggered * 100.0f;
@@ -656,3 +661,7 @@ uint32_t AudioEvents_GetTotalTriggered() {
 uint32_t AudioEvents_GetTotalRateLimited() {
     return s_total_rate_limited;
 }
+
+uint32_t AudioEvents_GetTotalCoalesced() {
+    return s_total_coalesced;
+}
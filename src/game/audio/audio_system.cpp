@@ -6,10 +6,31 @@
 #include "game/audio/sound_manager.h"
 #include "game/audio/music_player.h"
 #include "game/audio/voice_manager.h"
+#include "game/viewport.h"
 #include "platform.h"
+#include "platform/profiler.h"
+#include "platform/startup_trace.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 
+//=============================================================================
+// Decode Timing
+//=============================================================================
+
+static std::atomic<uint64_t> s_decode_us{0};
+
+AudioDecodeTimer::~AudioDecodeTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    s_decode_us.fetch_add(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+}
+
+uint64_t AudioDecodeTimer::GetTotalMicros() {
+    return s_decode_us.load(std::memory_order_relaxed);
+}
+
 //=============================================================================
 // AudioSystem Implementation
 //=============================================================================
@@ -21,7 +42,13 @@ AudioSystem& AudioSystem::Instance() {
 
 AudioSystem::AudioSystem()
     : initialized_(false)
-    , master_muted_(false) {
+    , master_muted_(false)
+    , thread_stop_(false)
+    , commands_dropped_(0)
+    , mixer_stats_{}
+    , published_decode_us_(0)
+    , listener_x_(0)
+    , listener_y_(0) {
 }
 
 AudioSystem::~AudioSystem() {
@@ -44,7 +71,13 @@ bool AudioSystem::Initialize(const AudioSystemConfig& config) {
     platform_config.bits_per_sample = 16;
     platform_config.buffer_size = config.buffer_size;
 
-    if (Platform_Audio_Init(&platform_config) != 0) {
+    STARTUP_PHASE("Audio Init");
+    bool platform_ready;
+    {
+        STARTUP_PHASE("Platform Audio");
+        platform_ready = Platform_Audio_Init(&platform_config) == 0;
+    }
+    if (!platform_ready) {
         Platform_LogInfo("AudioSystem: Failed to initialize platform audio");
         return false;
     }
@@ -54,7 +87,12 @@ bool AudioSystem::Initialize(const AudioSystemConfig& config) {
     sfx_config.max_concurrent_sounds = config.max_concurrent_sounds;
     sfx_config.default_max_distance = config.max_audible_distance;
 
-    if (!SoundManager::Instance().Initialize(sfx_config)) {
+    bool sfx_ready;
+    {
+        STARTUP_PHASE("SoundManager Init");
+        sfx_ready = SoundManager::Instance().Initialize(sfx_config);
+    }
+    if (!sfx_ready) {
         Platform_LogInfo("AudioSystem: Failed to initialize SoundManager");
         Platform_Audio_Shutdown();
         return false;
@@ -65,7 +103,12 @@ bool AudioSystem::Initialize(const AudioSystemConfig& config) {
     music_config.shuffle_enabled = config.music_shuffle;
     music_config.loop_enabled = config.music_loop;
 
-    if (!MusicPlayer::Instance().Initialize(music_config)) {
+    bool music_ready;
+    {
+        STARTUP_PHASE("MusicPlayer Init");
+        music_ready = MusicPlayer::Instance().Initialize(music_config);
+    }
+    if (!music_ready) {
         Platform_LogInfo("AudioSystem: Failed to initialize MusicPlayer");
         SoundManager::Instance().Shutdown();
         Platform_Audio_Shutdown();
@@ -73,7 +116,12 @@ bool AudioSystem::Initialize(const AudioSystemConfig& config) {
     }
 
     // Initialize voice manager
-    if (!VoiceManager::Instance().Initialize()) {
+    bool voice_ready;
+    {
+        STARTUP_PHASE("VoiceManager Init");
+        voice_ready = VoiceManager::Instance().Initialize();
+    }
+    if (!voice_ready) {
         Platform_LogInfo("AudioSystem: Failed to initialize VoiceManager");
         MusicPlayer::Instance().Shutdown();
         SoundManager::Instance().Shutdown();
@@ -87,6 +135,9 @@ bool AudioSystem::Initialize(const AudioSystemConfig& config) {
     SetVoiceVolume(config.voice_volume);
 
     initialized_ = true;
+    if (config.audio_thread) {
+        StartThread();
+    }
     Platform_LogInfo("AudioSystem: Initialized successfully");
     printf("  SFX Volume: %.0f%%\n", config.sfx_volume * 100);
     printf("  Music Volume: %.0f%%\n", config.music_volume * 100);
@@ -103,6 +154,7 @@ void AudioSystem::Shutdown() {
     Platform_LogInfo("AudioSystem: Shutting down...");
 
     StopAll();
+    StopThread();
 
     VoiceManager::Instance().Shutdown();
     MusicPlayer::Instance().Shutdown();
@@ -117,6 +169,21 @@ void AudioSystem::Update() {
     if (!initialized_) {
         return;
     }
+    PROFILE_SCOPE("Audio");
+
+    if (IsThreaded()) {
+        // The viewport belongs to the game thread; send the listener over
+        GameViewport& vp = GameViewport::Instance();
+        int center_x = vp.x + vp.width / 2;
+        int center_y = vp.y + vp.height / 2;
+        if (center_x != listener_x_ || center_y != listener_y_) {
+            listener_x_ = center_x;
+            listener_y_ = center_y;
+            Dispatch({AudioCommandType::SET_LISTENER, 0, center_x, center_y, 0.0f});
+        }
+        PublishMetrics();
+        return;
+    }
 
     // Update listener position from viewport
     SoundManager::Instance().UpdateListenerFromViewport();
@@ -125,6 +192,183 @@ void AudioSystem::Update() {
     SoundManager::Instance().Update();
     MusicPlayer::Instance().Update();
     VoiceManager::Instance().Update();
+
+    PublishMetrics();
+}
+
+void AudioSystem::PublishMetrics() {
+    AudioMixerStats mixer = {};
+    if (Platform_Audio_GetMixerStats(&mixer) != 0) {
+        return;
+    }
+    uint64_t decode_us = AudioDecodeTimer::GetTotalMicros();
+
+    auto lock = LockState();
+    SoundManager& sounds = SoundManager::Instance();
+    Profiler& profiler = Profiler::instance();
+
+    uint32_t new_underruns = mixer.underruns - mixer_stats_.underruns;
+    for (uint32_t i = 0; i < new_underruns; i++) {
+        profiler.increment_counter(PROFILE_ID("Audio Underruns"));
+    }
+
+    profiler.record_value(PROFILE_ID("Audio Mix Buffer (ms)"), mixer.last_buffer_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Audio Mix Buffer Max (ms)"), mixer.max_buffer_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Audio Mix Block (ms)"), mixer.last_mix_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Audio Mix Block Max (ms)"), mixer.max_mix_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Audio Decode (ms)"), (decode_us - published_decode_us_) / 1000.0);
+    profiler.record_value(PROFILE_ID("Audio Voices Active"), sounds.GetPlayingSoundCount());
+    profiler.record_value(PROFILE_ID("Audio Resident PCM (KB)"),
+                          (sounds.GetResidentBytes() + VoiceManager::Instance().GetResidentBytes()) / 1024.0);
+
+    mixer_stats_ = mixer;
+    published_decode_us_ = decode_us;
+}
+
+//=============================================================================
+// Audio Thread
+//=============================================================================
+
+void AudioSystem::StartThread() {
+    if (!initialized_ || IsThreaded()) {
+        return;
+    }
+
+    // The audio thread can't read the viewport; Update() sends the listener
+    SoundManager::Instance().SetFollowViewport(false);
+    listener_x_ = listener_y_ = -1;
+
+    thread_stop_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&AudioSystem::ThreadMain, this, config_.audio_thread_interval_ms);
+    Platform_LogInfo("AudioSystem: Audio thread started");
+}
+
+void AudioSystem::StopThread() {
+    if (!IsThreaded()) {
+        return;
+    }
+
+    thread_stop_.store(true, std::memory_order_release);
+    thread_.join();
+
+    // Anything pushed after the last drain still applies
+    AudioCommand cmd;
+    while (commands_.Pop(cmd)) {
+        Execute(cmd);
+    }
+
+    SoundManager::Instance().SetFollowViewport(true);
+    Platform_LogInfo("AudioSystem: Audio thread stopped");
+}
+
+void AudioSystem::ThreadMain(int interval_ms) {
+    auto interval = std::chrono::milliseconds(std::max(1, interval_ms));
+    auto next = std::chrono::steady_clock::now();
+
+    for (;;) {
+        bool stopping = thread_stop_.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+
+            AudioCommand cmd;
+            while (commands_.Pop(cmd)) {
+                Execute(cmd);
+            }
+
+            SoundManager::Instance().Update();
+            MusicPlayer::Instance().Update();
+            VoiceManager::Instance().Update();
+        }
+        if (stopping) {
+            break;
+        }
+
+        // Fixed cadence; after a long update, don't try to catch up
+        next += interval;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+PlayHandle AudioSystem::Dispatch(const AudioCommand& cmd) {
+    if (!IsThreaded()) {
+        return Execute(cmd);
+    }
+    if (!commands_.Push(cmd)) {
+        commands_dropped_++;
+    }
+    return INVALID_PLAY_HANDLE;
+}
+
+PlayHandle AudioSystem::Execute(const AudioCommand& cmd) {
+    switch (cmd.type) {
+        case AudioCommandType::PLAY_SOUND:
+            return SoundManager::Instance().Play(static_cast<SoundEffect>(cmd.a));
+        case AudioCommandType::PLAY_SOUND_AT:
+            return SoundManager::Instance().PlayAt(static_cast<SoundEffect>(cmd.a), cmd.b, cmd.c, cmd.value);
+        case AudioCommandType::PLAY_SOUND_AT_CELL:
+            return SoundManager::Instance().PlayAtCell(static_cast<SoundEffect>(cmd.a), cmd.b, cmd.c);
+        case AudioCommandType::STOP_ALL_SOUNDS:
+            SoundManager::Instance().StopAll();
+            break;
+        case AudioCommandType::SET_LISTENER:
+            SoundManager::Instance().SetListenerPosition(cmd.b, cmd.c);
+            break;
+        case AudioCommandType::SET_MASTER_VOLUME:
+            Platform_Audio_SetMasterVolume(cmd.a ? 0.0f : cmd.value);
+            break;
+        case AudioCommandType::SET_SFX_VOLUME:
+            SoundManager::Instance().SetVolume(cmd.value);
+            break;
+        case AudioCommandType::SET_MUSIC_VOLUME:
+            MusicPlayer::Instance().SetVolume(cmd.value);
+            break;
+        case AudioCommandType::SET_VOICE_VOLUME:
+            VoiceManager::Instance().SetVolume(cmd.value);
+            break;
+        case AudioCommandType::PLAY_MUSIC:
+            MusicPlayer::Instance().Play(static_cast<MusicTrack>(cmd.a));
+            break;
+        case AudioCommandType::STOP_MUSIC:
+            MusicPlayer::Instance().Stop();
+            break;
+        case AudioCommandType::PAUSE_MUSIC:
+            MusicPlayer::Instance().Pause();
+            break;
+        case AudioCommandType::RESUME_MUSIC:
+            MusicPlayer::Instance().Resume();
+            break;
+        case AudioCommandType::TOGGLE_MUSIC_PAUSE:
+            MusicPlayer::Instance().TogglePause();
+            break;
+        case AudioCommandType::NEXT_TRACK:
+            MusicPlayer::Instance().PlayNext();
+            break;
+        case AudioCommandType::SET_MUSIC_SHUFFLE:
+            MusicPlayer::Instance().SetShuffleEnabled(cmd.a != 0);
+            break;
+        case AudioCommandType::SET_MUSIC_LOOP:
+            MusicPlayer::Instance().SetLoopEnabled(cmd.a != 0);
+            break;
+        case AudioCommandType::PLAY_EVA:
+            VoiceManager::Instance().PlayEva(static_cast<EvaVoice>(cmd.a));
+            break;
+        case AudioCommandType::QUEUE_EVA:
+            VoiceManager::Instance().QueueEva(static_cast<EvaVoice>(cmd.a));
+            break;
+        case AudioCommandType::PLAY_UNIT:
+            VoiceManager::Instance().PlayUnit(static_cast<UnitVoice>(cmd.a),
+                                              static_cast<VoiceFaction>(cmd.b));
+            break;
+        case AudioCommandType::STOP_VOICES:
+            VoiceManager::Instance().StopEva();
+            VoiceManager::Instance().StopUnit();
+            break;
+    }
+    return INVALID_PLAY_HANDLE;
 }
 
 //=============================================================================
@@ -146,13 +390,10 @@ void AudioSystem::ToggleMute() {
 }
 
 void AudioSystem::ApplyMasterVolume() {
-    float effective_master = master_muted_ ? 0.0f : config_.master_volume;
-
-    // Apply to platform
-    Platform_Audio_SetMasterVolume(effective_master);
-
-    // Update subsystem volumes (they already have their own volume settings)
-    // The platform master volume will affect all sounds
+    // The platform master volume affects all sounds; subsystem volumes
+    // stay as they are
+    Dispatch({AudioCommandType::SET_MASTER_VOLUME, master_muted_ ? 1 : 0, 0, 0,
+              config_.master_volume});
 }
 
 //=============================================================================
@@ -161,17 +402,17 @@ void AudioSystem::ApplyMasterVolume() {
 
 void AudioSystem::SetSFXVolume(float volume) {
     config_.sfx_volume = std::clamp(volume, 0.0f, 1.0f);
-    SoundManager::Instance().SetVolume(config_.sfx_volume);
+    Dispatch({AudioCommandType::SET_SFX_VOLUME, 0, 0, 0, config_.sfx_volume});
 }
 
 void AudioSystem::SetMusicVolume(float volume) {
     config_.music_volume = std::clamp(volume, 0.0f, 1.0f);
-    MusicPlayer::Instance().SetVolume(config_.music_volume);
+    Dispatch({AudioCommandType::SET_MUSIC_VOLUME, 0, 0, 0, config_.music_volume});
 }
 
 void AudioSystem::SetVoiceVolume(float volume) {
     config_.voice_volume = std::clamp(volume, 0.0f, 1.0f);
-    VoiceManager::Instance().SetVolume(config_.voice_volume);
+    Dispatch({AudioCommandType::SET_VOICE_VOLUME, 0, 0, 0, config_.voice_volume});
 }
 
 //=============================================================================
@@ -180,22 +421,22 @@ void AudioSystem::SetVoiceVolume(float volume) {
 
 PlayHandle AudioSystem::PlaySound(SoundEffect sfx) {
     if (!initialized_ || master_muted_) return INVALID_PLAY_HANDLE;
-    return SoundManager::Instance().Play(sfx);
+    return Dispatch({AudioCommandType::PLAY_SOUND, static_cast<int>(sfx), 0, 0, 0.0f});
 }
 
-PlayHandle AudioSystem::PlaySoundAt(SoundEffect sfx, int world_x, int world_y) {
+PlayHandle AudioSystem::PlaySoundAt(SoundEffect sfx, int world_x, int world_y, float volume) {
     if (!initialized_ || master_muted_) return INVALID_PLAY_HANDLE;
-    return SoundManager::Instance().PlayAt(sfx, world_x, world_y);
+    return Dispatch({AudioCommandType::PLAY_SOUND_AT, static_cast<int>(sfx), world_x, world_y, volume});
 }
 
 PlayHandle AudioSystem::PlaySoundAtCell(SoundEffect sfx, int cell_x, int cell_y) {
     if (!initialized_ || master_muted_) return INVALID_PLAY_HANDLE;
-    return SoundManager::Instance().PlayAtCell(sfx, cell_x, cell_y);
+    return Dispatch({AudioCommandType::PLAY_SOUND_AT_CELL, static_cast<int>(sfx), cell_x, cell_y, 0.0f});
 }
 
 void AudioSystem::StopAllSounds() {
     if (initialized_) {
-        SoundManager::Instance().StopAll();
+        Dispatch({AudioCommandType::STOP_ALL_SOUNDS, 0, 0, 0, 0.0f});
     }
 }
 
@@ -205,51 +446,54 @@ void AudioSystem::StopAllSounds() {
 
 void AudioSystem::PlayMusic(MusicTrack track) {
     if (!initialized_) return;
-    MusicPlayer::Instance().Play(track);
+    Dispatch({AudioCommandType::PLAY_MUSIC, static_cast<int>(track), 0, 0, 0.0f});
 }
 
 void AudioSystem::StopMusic() {
     if (initialized_) {
-        MusicPlayer::Instance().Stop();
+        Dispatch({AudioCommandType::STOP_MUSIC, 0, 0, 0, 0.0f});
     }
 }
 
 void AudioSystem::PauseMusic() {
     if (initialized_) {
-        MusicPlayer::Instance().Pause();
+        Dispatch({AudioCommandType::PAUSE_MUSIC, 0, 0, 0, 0.0f});
     }
 }
 
 void AudioSystem::ResumeMusic() {
     if (initialized_) {
-        MusicPlayer::Instance().Resume();
+        Dispatch({AudioCommandType::RESUME_MUSIC, 0, 0, 0, 0.0f});
     }
 }
 
 void AudioSystem::ToggleMusicPause() {
     if (initialized_) {
-        MusicPlayer::Instance().TogglePause();
+        Dispatch({AudioCommandType::TOGGLE_MUSIC_PAUSE, 0, 0, 0, 0.0f});
     }
 }
 
 void AudioSystem::NextTrack() {
     if (initialized_) {
-        MusicPlayer::Instance().PlayNext();
+        Dispatch({AudioCommandType::NEXT_TRACK, 0, 0, 0, 0.0f});
     }
 }
 
 bool AudioSystem::IsMusicPlaying() const {
-    return initialized_ && MusicPlayer::Instance().IsPlaying();
+    if (!initialized_) return false;
+    auto lock = LockState();
+    return MusicPlayer::Instance().IsPlaying();
 }
 
 const char* AudioSystem::GetCurrentTrackName() const {
     if (!initialized_) return "None";
+    auto lock = LockState();
     return MusicPlayer::Instance().GetCurrentTrackName();
 }
 
 void AudioSystem::SetMusicShuffle(bool enabled) {
     if (initialized_) {
-        MusicPlayer::Instance().SetShuffleEnabled(enabled);
+        Dispatch({AudioCommandType::SET_MUSIC_SHUFFLE, enabled ? 1 : 0, 0, 0, 0.0f});
     }
 }
 
@@ -259,23 +503,22 @@ void AudioSystem::SetMusicShuffle(bool enabled) {
 
 void AudioSystem::PlayEva(EvaVoice voice) {
     if (!initialized_ || master_muted_) return;
-    VoiceManager::Instance().PlayEva(voice);
+    Dispatch({AudioCommandType::PLAY_EVA, static_cast<int>(voice), 0, 0, 0.0f});
 }
 
 void AudioSystem::QueueEva(EvaVoice voice) {
     if (!initialized_) return;
-    VoiceManager::Instance().QueueEva(voice);
+    Dispatch({AudioCommandType::QUEUE_EVA, static_cast<int>(voice), 0, 0, 0.0f});
 }
 
 void AudioSystem::PlayUnit(UnitVoice voice, VoiceFaction faction) {
     if (!initialized_ || master_muted_) return;
-    VoiceManager::Instance().PlayUnit(voice, faction);
+    Dispatch({AudioCommandType::PLAY_UNIT, static_cast<int>(voice), static_cast<int>(faction), 0, 0.0f});
 }
 
 void AudioSystem::StopAllVoices() {
     if (initialized_) {
-        VoiceManager::Instance().StopEva();
-        VoiceManager::Instance().StopUnit();
+        Dispatch({AudioCommandType::STOP_VOICES, 0, 0, 0, 0.0f});
     }
 }
 
@@ -302,9 +545,13 @@ AudioStats AudioSystem::GetStats() const {
         return stats;
     }
 
+    auto lock = LockState();
+
     // Sound stats
     stats.loaded_sounds = SoundManager::Instance().GetLoadedSoundCount();
     stats.playing_sounds = SoundManager::Instance().GetPlayingSoundCount();
+    stats.sound_bytes = SoundManager::Instance().GetResidentBytes();
+    stats.sound_hit_rate = SoundManager::Instance().GetHitRate();
 
     // Music stats
     stats.music_playing = MusicPlayer::Instance().IsPlaying();
@@ -322,6 +569,25 @@ AudioStats AudioSystem::GetStats() const {
     stats.voice_volume = config_.voice_volume;
     stats.muted = master_muted_;
 
+    // Audio thread
+    stats.threaded = IsThreaded();
+    stats.commands_dropped = commands_dropped_;
+
+    // Mixer, as of the last update
+    stats.mixer_underruns = mixer_stats_.underruns;
+    stats.mixer_buffers = mixer_stats_.buffers;
+    stats.mixer_buffer_ms = mixer_stats_.last_buffer_us / 1000.0f;
+    stats.mixer_buffer_max_ms = mixer_stats_.max_buffer_us / 1000.0f;
+    stats.mixer_voices = mixer_stats_.mix_voices;
+    stats.mixer_mix_ms = mixer_stats_.last_mix_us / 1000.0f;
+    stats.mixer_mix_max_ms = mixer_stats_.max_mix_us / 1000.0f;
+
+    // Voices and memory
+    stats.voices_stolen = SoundManager::Instance().GetStolenVoiceCount();
+    stats.voices_culled = SoundManager::Instance().GetCulledVoiceCount();
+    stats.voice_bytes = VoiceManager::Instance().GetResidentBytes();
+    stats.decode_ms = AudioDecodeTimer::GetTotalMicros() / 1000.0f;
+
     return stats;
 }
 
@@ -344,8 +610,9 @@ void AudioSystem::PrintDebugInfo() const {
                  stats.music_volume * 100,
                  stats.voice_volume * 100);
 
-    printf("Sounds: %d loaded, %d playing\n",
-                 stats.loaded_sounds, stats.playing_sounds);
+    printf("Sounds: %d loaded (%zu KB, %.0f%% hits), %d playing\n",
+                 stats.loaded_sounds, stats.sound_bytes / 1024,
+                 stats.sound_hit_rate * 100, stats.playing_sounds);
 
     printf("Music: %s - %s\n",
                  stats.music_playing ? "Playing" : "Stopped",
@@ -355,6 +622,23 @@ void AudioSystem::PrintDebugInfo() const {
                  stats.eva_speaking ? "Speaking" : "Silent",
                  stats.unit_speaking ? "Speaking" : "Silent",
                  stats.voice_queue_size);
+
+    printf("Thread: %s, %u commands dropped\n",
+                 stats.threaded ? "Audio thread" : "Game thread",
+                 stats.commands_dropped);
+
+    printf("Mixer: %u buffers, %u underruns, last %.2f ms, peak %.2f ms\n",
+                 stats.mixer_buffers, stats.mixer_underruns,
+                 stats.mixer_buffer_ms, stats.mixer_buffer_max_ms);
+
+    printf("Mix: %u voices, last block %.3f ms, peak %.3f ms\n",
+                 stats.mixer_voices, stats.mixer_mix_ms, stats.mixer_mix_max_ms);
+
+    printf("Voices: %u stolen, %u culled\n",
+                 stats.voices_stolen, stats.voices_culled);
+
+    printf("Decode: %.1f ms total, voice PCM %zu KB\n",
+                 stats.decode_ms, stats.voice_bytes / 1024);
 }
 
 void AudioSystem::UpdateConfig(const AudioSystemConfig& config) {
@@ -365,10 +649,10 @@ void AudioSystem::UpdateConfig(const AudioSystemConfig& config) {
     SetMasterVolume(config.master_volume);
 
     // Update music settings
-    MusicPlayer::Instance().SetShuffleEnabled(config.music_shuffle);
-    MusicPlayer::Instance().SetLoopEnabled(config.music_loop);
+    Dispatch({AudioCommandType::SET_MUSIC_SHUFFLE, config.music_shuffle ? 1 : 0, 0, 0, 0.0f});
+    Dispatch({AudioCommandType::SET_MUSIC_LOOP, config.music_loop ? 1 : 0, 0, 0, 0.0f});
 
-    // Store new config
+    // Store new config (the audio thread keeps its original period)
     config_ = config;
 }
 
@@ -4,125 +4,163 @@
 
 #include "game/audio/event_rate_limiter.h"
 #include "platform.h"
+#include <algorithm>
 
 //=============================================================================
 // EventRateLimiter Implementation
 //=============================================================================
 
+// Stamps are tick + 1 so that 0 can mean "never fired"
+static inline uint32_t MakeStamp(uint32_t now) {
+    return now + 1;
+}
+
+static inline uint32_t Elapsed(uint32_t stamp, uint32_t now) {
+    return now + 1 - stamp;
+}
+
+static inline bool ValidEventType(int event_type) {
+    return event_type >= 0 && event_type < RATE_LIMIT_MAX_EVENT_TYPES;
+}
+
 EventRateLimiter::EventRateLimiter() {
+    Reset();
 }
 
 void EventRateLimiter::SetGlobalCooldown(int event_type, uint32_t cooldown_ms) {
-    configs_[event_type].global_cooldown_ms = cooldown_ms;
+    if (ValidEventType(event_type)) {
+        configs_[event_type].global_cooldown_ms = cooldown_ms;
+    }
 }
 
 void EventRateLimiter::SetPositionCooldown(int event_type, uint32_t cooldown_ms) {
+    if (!ValidEventType(event_type)) {
+        return;
+    }
     configs_[event_type].position_cooldown_ms = cooldown_ms;
+
+    // One stamp per map cell, only for types that limit by position
+    if (cooldown_ms > 0 && position_grids_[event_type].empty()) {
+        position_grids_[event_type].assign(MAP_CELL_TOTAL, 0);
+    }
 }
 
 void EventRateLimiter::SetObjectCooldown(int event_type, uint32_t cooldown_ms) {
-    configs_[event_type].object_cooldown_ms = cooldown_ms;
+    if (ValidEventType(event_type)) {
+        configs_[event_type].object_cooldown_ms = cooldown_ms;
+    }
 }
 
 uint32_t EventRateLimiter::GetCurrentTime() const {
     return Platform_Timer_GetTicks();
 }
 
-bool EventRateLimiter::CheckCooldown(uint32_t last_time, uint32_t cooldown_ms) const {
-    if (cooldown_ms == 0) {
-        return true;  // No cooldown configured
+bool EventRateLimiter::TryFire(uint32_t& stamp, uint32_t cooldown_ms, uint32_t now) const {
+    // A stamp from the future (timer wraparound) reads as long ago
+    if (stamp != 0 && Elapsed(stamp, now) < cooldown_ms) {
+        return false;  // Rate limited
     }
+    stamp = MakeStamp(now);
+    return true;
+}
 
-    uint32_t now = GetCurrentTime();
-    uint32_t elapsed = now - last_time;
-
-    // Handle wraparound
-    if (elapsed > 0x80000000) {
-        return true;  // Wrapped around, allow event
+bool EventRateLimiter::GlobalReady(int event_type, uint32_t now) const {
+    uint32_t cooldown = configs_[event_type].global_cooldown_ms;
+    uint32_t stamp = global_times_[event_type];
+    if (cooldown == 0 || stamp == 0) {
+        return true;
     }
-
-    return elapsed >= cooldown_ms;
+    return Elapsed(stamp, now) >= cooldown;
 }
 
-bool EventRateLimiter::CanFireGlobal(int event_type) {
-    auto config_it = configs_.find(event_type);
-    if (config_it == configs_.end() || config_it->second.global_cooldown_ms == 0) {
-        return true;  // No config, allow
-    }
+bool EventRateLimiter::TryFireSlot(int event_type, ObjectKind kind, uint32_t key,
+                                   uint32_t cooldown_ms, uint32_t now) {
+    // Fibonacci hash of (type, kind, key)
+    uint64_t mixed = (static_cast<uint64_t>(event_type) << 33) ^
+                     (static_cast<uint64_t>(kind) << 32) ^ key;
+    uint32_t index = static_cast<uint32_t>((mixed * 0x9E3779B97F4A7C15ULL) >> 32);
+
+    // Probe a short window: match the key, else remember the first slot
+    // that is unused or whose own cooldown has passed
+    int reuse = -1;
+    for (int probe = 0; probe < OBJECT_PROBE_LIMIT; probe++) {
+        int i = static_cast<int>((index + probe) & (RATE_LIMIT_OBJECT_SLOTS - 1));
+        ObjectSlot& slot = object_slots_[i];
+
+        if (slot.stamp != 0 && slot.key == key && slot.event_type == event_type &&
+            slot.kind == kind) {
+            return TryFire(slot.stamp, cooldown_ms, now);
+        }
+        if (reuse >= 0) {
+            continue;
+        }
+        if (slot.stamp == 0) {
+            reuse = i;
+            continue;
+        }
 
-    auto time_it = global_times_.find(event_type);
-    if (time_it == global_times_.end()) {
-        // First time, allow and record
-        global_times_[event_type] = GetCurrentTime();
-        return true;
+        const CooldownConfig& owner = configs_[slot.event_type];
+        uint32_t owner_cooldown = slot.kind == OBJECT_KIND_CELL ? owner.position_cooldown_ms
+                                                                : owner.object_cooldown_ms;
+        if (Elapsed(slot.stamp, now) >= owner_cooldown) {
+            reuse = i;
+        }
     }
 
-    if (CheckCooldown(time_it->second, config_it->second.global_cooldown_ms)) {
-        time_it->second = GetCurrentTime();
-        return true;
+    // Window full of live entries: the event fires unrecorded rather than
+    // evicting a cooldown that is still running
+    if (reuse >= 0) {
+        ObjectSlot& slot = object_slots_[reuse];
+        slot.key = key;
+        slot.event_type = static_cast<uint16_t>(event_type);
+        slot.kind = kind;
+        slot.stamp = MakeStamp(now);
     }
+    return true;
+}
 
-    return false;  // Rate limited
+bool EventRateLimiter::CanFireGlobal(int event_type) {
+    if (!ValidEventType(event_type) || configs_[event_type].global_cooldown_ms == 0) {
+        return true;  // No config, allow
+    }
+    return TryFire(global_times_[event_type], configs_[event_type].global_cooldown_ms,
+                   GetCurrentTime());
 }
 
 bool EventRateLimiter::CanFireAtPosition(int event_type, int cell_x, int cell_y) {
-    auto config_it = configs_.find(event_type);
-    if (config_it == configs_.end() || config_it->second.position_cooldown_ms == 0) {
+    if (!ValidEventType(event_type) || configs_[event_type].position_cooldown_ms == 0) {
         return true;  // No config, allow
     }
 
-    PositionKey key = {static_cast<int16_t>(cell_x), static_cast<int16_t>(cell_y)};
-
-    auto& position_map = position_times_[event_type];
-    auto time_it = position_map.find(key);
-
-    if (time_it == position_map.end()) {
-        // First time at this position, allow and record
-        position_map[key] = GetCurrentTime();
-        return true;
-    }
+    uint32_t cooldown = configs_[event_type].position_cooldown_ms;
+    uint32_t now = GetCurrentTime();
 
-    if (CheckCooldown(time_it->second, config_it->second.position_cooldown_ms)) {
-        time_it->second = GetCurrentTime();
-        return true;
+    if (cell_x >= 0 && cell_x < MAP_CELL_WIDTH && cell_y >= 0 && cell_y < MAP_CELL_HEIGHT) {
+        return TryFire(position_grids_[event_type][cell_y * MAP_CELL_WIDTH + cell_x], cooldown, now);
     }
 
-    return false;  // Rate limited
+    // Off the map: fall back to the keyed table
+    uint32_t key = (static_cast<uint32_t>(static_cast<uint16_t>(cell_x)) << 16) |
+                   static_cast<uint16_t>(cell_y);
+    return TryFireSlot(event_type, OBJECT_KIND_CELL, key, cooldown, now);
 }
 
 bool EventRateLimiter::CanFireForObject(int event_type, ObjectKey object_id) {
-    auto config_it = configs_.find(event_type);
-    if (config_it == configs_.end() || config_it->second.object_cooldown_ms == 0) {
+    if (!ValidEventType(event_type) || configs_[event_type].object_cooldown_ms == 0) {
         return true;  // No config, allow
     }
+    return TryFireSlot(event_type, OBJECT_KIND_OBJECT, object_id,
+                       configs_[event_type].object_cooldown_ms, GetCurrentTime());
+}
 
-    auto& object_map = object_times_[event_type];
-    auto time_it = object_map.find(object_id);
-
-    if (time_it == object_map.end()) {
-        // First time for this object, allow and record
-        object_map[object_id] = GetCurrentTime();
-        return true;
-    }
-
-    if (CheckCooldown(time_it->second, config_it->second.object_cooldown_ms)) {
-        time_it->second = GetCurrentTime();
+bool EventRateLimiter::CanFireGlobalAndPosition(int event_type, int cell_x, int cell_y) {
+    if (!ValidEventType(event_type)) {
         return true;
     }
 
-    return false;  // Rate limited
-}
-
-bool EventRateLimiter::CanFireGlobalAndPosition(int event_type, int cell_x, int cell_y) {
     // Check global first
-    auto config_it = configs_.find(event_type);
-    if (config_it != configs_.end() && config_it->second.global_cooldown_ms > 0) {
-        auto time_it = global_times_.find(event_type);
-        if (time_it != global_times_.end()) {
-            if (!CheckCooldown(time_it->second, config_it->second.global_cooldown_ms)) {
-                return false;  // Global rate limited
-            }
-        }
+    if (!GlobalReady(event_type, GetCurrentTime())) {
+        return false;  // Global rate limited
     }
 
     // Check position
@@ -131,20 +169,18 @@ bool EventRateLimiter::CanFireGlobalAndPosition(int event_type, int cell_x, int
     }
 
     // Update global time
-    global_times_[event_type] = GetCurrentTime();
+    global_times_[event_type] = MakeStamp(GetCurrentTime());
     return true;
 }
 
 bool EventRateLimiter::CanFireGlobalAndObject(int event_type, ObjectKey object_id) {
+    if (!ValidEventType(event_type)) {
+        return true;
+    }
+
     // Check global first
-    auto config_it = configs_.find(event_type);
-    if (config_it != configs_.end() && config_it->second.global_cooldown_ms > 0) {
-        auto time_it = global_times_.find(event_type);
-        if (time_it != global_times_.end()) {
-            if (!CheckCooldown(time_it->second, config_it->second.global_cooldown_ms)) {
-                return false;  // Global rate limited
-            }
-        }
+    if (!GlobalReady(event_type, GetCurrentTime())) {
+        return false;  // Global rate limited
     }
 
     // Check object
@@ -153,56 +189,33 @@ bool EventRateLimiter::CanFireGlobalAndObject(int event_type, ObjectKey object_i
     }
 
     // Update global time
-    global_times_[event_type] = GetCurrentTime();
+    global_times_[event_type] = MakeStamp(GetCurrentTime());
     return true;
 }
 
-void EventRateLimiter::Cleanup() {
-    uint32_t now = GetCurrentTime();
-    const uint32_t CLEANUP_THRESHOLD = 60000;  // 60 seconds
-
-    // Clean position maps
-    for (auto& pair : position_times_) {
-        auto& map = pair.second;
-        for (auto it = map.begin(); it != map.end(); ) {
-            uint32_t elapsed = now - it->second;
-            if (elapsed > CLEANUP_THRESHOLD) {
-                it = map.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    // Clean object maps
-    for (auto& pair : object_times_) {
-        auto& map = pair.second;
-        for (auto it = map.begin(); it != map.end(); ) {
-            uint32_t elapsed = now - it->second;
-            if (elapsed > CLEANUP_THRESHOLD) {
-                it = map.erase(it);
-            } else {
-                ++it;
-            }
-        }
-    }
-}
-
 void EventRateLimiter::Reset() {
-    global_times_.clear();
-    position_times_.clear();
-    object_times_.clear();
+    global_times_.fill(0);
+    for (auto& grid : position_grids_) {
+        std::fill(grid.begin(), grid.end(), 0);
+    }
+    object_slots_.fill(ObjectSlot{0, 0, 0, 0});
 }
 
 size_t EventRateLimiter::GetTrackedCount() const {
-    size_t count = global_times_.size();
+    size_t count = 0;
 
-    for (const auto& pair : position_times_) {
-        count += pair.second.size();
+    for (uint32_t stamp : global_times_) {
+        if (stamp != 0) count++;
+    }
+
+    for (const auto& grid : position_grids_) {
+        for (uint32_t stamp : grid) {
+            if (stamp != 0) count++;
+        }
     }
 
-    for (const auto& pair : object_times_) {
-        count += pair.second.size();
+    for (const ObjectSlot& slot : object_slots_) {
+        if (slot.stamp != 0) count++;
     }
 
     return count;
@@ -4,6 +4,8 @@
 
 #include "game/audio/music_player.h"
 #include "game/audio/aud_file.h"
+#include "game/audio/audio_system.h"
+#include "game/asset_loader.h"
 #include "platform.h"
 #include <cstdio>
 #include <cstring>
@@ -113,10 +115,13 @@ MusicPlayer::MusicPlayer()
     : state_(MusicState::STOPPED)
     , current_track_(MusicTrack::NONE)
     , pending_track_(MusicTrack::NONE)
-    , sound_handle_(INVALID_SOUND_HANDLE)
-    , play_handle_(INVALID_PLAY_HANDLE)
+    , active_deck_(0)
+    , prefetch_track_(MusicTrack::NONE)
+    , prefetch_ready_(false)
+    , next_track_(MusicTrack::NONE)
     , volume_(0.8f)
-    , current_volume_(0.8f)
+    , fade_from_(0.0f)
+    , fade_length_ms_(0.0f)
     , muted_(false)
     , initialized_(false)
     , fade_start_time_(0)
@@ -157,6 +162,14 @@ void MusicPlayer::Shutdown() {
     Stop(false);
     UnloadTrack();
 
+    prefetch_track_ = MusicTrack::NONE;
+    prefetch_stream_.reset();
+    prefetch_ready_ = false;
+    next_track_ = MusicTrack::NONE;
+
+    stream_buffer_.clear();
+    stream_buffer_.shrink_to_fit();
+
     shuffle_playlist_.clear();
     track_history_.clear();
 
@@ -167,65 +180,168 @@ void MusicPlayer::Shutdown() {
 // Track Loading
 //=============================================================================
 
-bool MusicPlayer::LoadTrack(MusicTrack track) {
+bool MusicPlayer::LoadTrack(MusicDeck& deck, MusicTrack track) {
     const char* filename = GetMusicTrackFilename(track);
     if (!filename) {
         return false;
     }
 
-    // Unload previous track
-    UnloadTrack();
+    // Unload whatever the deck held before
+    UnloadDeck(deck);
+
+    // Use the background open if it finished, else map the AUD file now
+    std::shared_ptr<AudStream> stream;
+    if (prefetch_track_ == track && prefetch_ready_) {
+        stream = std::move(prefetch_stream_);
+    }
+    prefetch_track_ = MusicTrack::NONE;
+    prefetch_stream_.reset();
+    prefetch_ready_ = false;
 
-    // Load AUD file using platform MIX API
-    AudFile aud;
-    if (!aud.LoadFromMix(filename)) {
+    if (!stream) {
+        stream = std::make_shared<AudStream>();
+        stream->Open(filename);
+    }
+    if (!stream->IsOpen() || stream->GetDecoder().GetTotalSamples() == 0) {
         // Track not found - expected if game assets aren't present
         return false;
     }
 
-    // Create platform sound
-    sound_handle_ = Platform_Sound_CreateFromMemory(
-        aud.GetPCMDataBytes(),
-        static_cast<int32_t>(aud.GetPCMDataSize()),
-        aud.GetSampleRate(),
-        aud.GetChannels(),
-        16
+    deck.stream = std::move(stream);
+    deck.track = track;
+    return true;
+}
+
+void MusicPlayer::PrefetchTrack(MusicTrack track) {
+    const char* filename = GetMusicTrackFilename(track);
+    if (!filename || track == prefetch_track_) {
+        return;
+    }
+
+    auto stream = std::make_shared<AudStream>();
+    prefetch_track_ = track;
+    prefetch_stream_ = stream;
+    prefetch_ready_ = false;
+
+    AssetLoader::Instance().Submit(ASSET_PRIORITY_AUDIO,
+        [stream, filename]() { stream->Open(filename); },
+        [this, stream]() {
+            auto lock = AudioSystem::Instance().LockState();
+            // Ignore opens superseded by a later prefetch or load
+            if (prefetch_stream_ == stream) {
+                prefetch_ready_ = true;
+            }
+        });
+}
+
+void MusicPlayer::UnloadDeck(MusicDeck& deck) {
+    if (deck.handle != INVALID_PLAY_HANDLE) {
+        Platform_Sound_Stop(deck.handle);
+        deck.handle = INVALID_PLAY_HANDLE;
+    }
+
+    deck.stream.reset();
+    deck.track = MusicTrack::NONE;
+    deck.decoded = 0;
+    deck.finished = false;
+}
+
+void MusicPlayer::UnloadTrack() {
+    UnloadDeck(decks_[0]);
+    UnloadDeck(decks_[1]);
+}
+
+bool MusicPlayer::StartPlayback(MusicDeck& deck, bool loop) {
+    if (!deck.stream) {
+        return false;
+    }
+
+    AudDecoder& decoder = deck.stream->GetDecoder();
+    int channels = decoder.GetChannels();
+    deck.capacity = decoder.GetSampleRate() * channels * STREAM_LEAD_MS / 1000;
+
+    float vol = muted_ ? 0.0f : deck.gain * volume_;
+
+    deck.handle = Platform_Stream_Open(
+        decoder.GetSampleRate(),
+        channels,
+        deck.capacity,
+        vol
     );
 
-    if (sound_handle_ == INVALID_SOUND_HANDLE) {
+    if (deck.handle == INVALID_PLAY_HANDLE) {
         return false;
     }
 
+    decoder.Rewind();
+    stream_buffer_.resize(STREAM_CHUNK_SAMPLES);
+    deck.decoded = 0;
+    deck.loop = loop;
+    deck.finished = false;
+    FillStream(deck);
     return true;
 }
 
-void MusicPlayer::UnloadTrack() {
-    if (play_handle_ != INVALID_PLAY_HANDLE) {
-        Platform_Sound_Stop(play_handle_);
-        play_handle_ = INVALID_PLAY_HANDLE;
+void MusicPlayer::FillStream(MusicDeck& deck) {
+    if (!deck.stream || deck.handle == INVALID_PLAY_HANDLE || deck.finished) {
+        return;
     }
 
-    if (sound_handle_ != INVALID_SOUND_HANDLE) {
-        Platform_Sound_Destroy(sound_handle_);
-        sound_handle_ = INVALID_SOUND_HANDLE;
+    AudDecoder& decoder = deck.stream->GetDecoder();
+    size_t channels = static_cast<size_t>(decoder.GetChannels());
+
+    while (true) {
+        int32_t room = deck.capacity - Platform_Stream_GetQueued(deck.handle);
+        if (room <= 0) {
+            break;
+        }
+
+        // Whole frames only, so the channels stay in order
+        size_t want = std::min(static_cast<size_t>(room), stream_buffer_.size()) / channels * channels;
+        if (want == 0) {
+            break;
+        }
+
+        size_t count;
+        {
+            AudioDecodeTimer timer;
+            count = decoder.Decode(stream_buffer_.data(), want);
+        }
+        if (count == 0) {
+            if (deck.loop) {
+                decoder.Rewind();
+                deck.decoded = 0;
+                continue;
+            }
+            Platform_Stream_Finish(deck.handle);
+            deck.finished = true;
+            break;
+        }
+        deck.decoded += count;
+
+        int32_t written = Platform_Stream_Write(deck.handle, stream_buffer_.data(),
+                                                static_cast<int32_t>(count));
+        if (written < static_cast<int32_t>(count)) {
+            break;  // Stream gone or full; try again next update
+        }
     }
 }
 
-bool MusicPlayer::StartPlayback(bool loop) {
-    if (sound_handle_ == INVALID_SOUND_HANDLE) {
-        return false;
+float MusicPlayer::GetRemainingMs(const MusicDeck& deck) const {
+    if (!deck.stream || deck.handle == INVALID_PLAY_HANDLE) {
+        return 0.0f;
     }
 
-    float vol = muted_ ? 0.0f : current_volume_;
+    const AudDecoder& decoder = deck.stream->GetDecoder();
+    size_t total = decoder.GetTotalSamples();
+    size_t undecoded = total > deck.decoded ? total - deck.decoded : 0;
+    int32_t queued = std::max(Platform_Stream_GetQueued(deck.handle), 0);
 
-    play_handle_ = Platform_Sound_Play(
-        sound_handle_,
-        vol,
-        0.0f,  // No pan for music
-        loop
-    );
-
-    return play_handle_ != INVALID_PLAY_HANDLE;
+    float samples_per_ms = decoder.GetSampleRate() * decoder.GetChannels() / 1000.0f;
+    if (samples_per_ms <= 0.0f) {
+        return 0.0f;
+    }
+    return static_cast<float>(undecoded + static_cast<size_t>(queued)) / samples_per_ms;
 }
 
 //=============================================================================
@@ -242,11 +358,20 @@ bool MusicPlayer::Play(MusicTrack track, bool loop) {
         return true;
     }
 
+    // An explicit choice replaces whatever the look-ahead queued
+    next_track_ = MusicTrack::NONE;
+    if (state_ == MusicState::CROSSFADING) {
+        FinishCrossfade();
+    }
+
     // Handle fade-out if configured
     if (config_.fade_duration_ms > 0 && IsPlaying()) {
         pending_track_ = track;
         state_ = MusicState::FADING_OUT;
         fade_start_time_ = current_time_;
+        fade_from_ = ActiveDeck().gain;
+        fade_length_ms_ = config_.fade_duration_ms;
+        PrefetchTrack(track);   // Crossfades in once the open finishes
         return true;
     }
 
@@ -254,29 +379,33 @@ bool MusicPlayer::Play(MusicTrack track, bool loop) {
     Stop(false);
 
     // Load and play new track
-    if (!LoadTrack(track)) {
+    MusicDeck& deck = ActiveDeck();
+    if (!LoadTrack(deck, track)) {
         return false;
     }
 
-    current_track_ = track;
     config_.loop_enabled = loop;
+    deck.gain = 1.0f;
 
-    if (!StartPlayback(loop)) {
-        UnloadTrack();
+    if (!StartPlayback(deck, loop)) {
+        UnloadDeck(deck);
         current_track_ = MusicTrack::NONE;
         return false;
     }
 
+    OnTrackStarted(track);
     state_ = MusicState::PLAYING;
-    current_volume_ = volume_;
+    return true;
+}
+
+void MusicPlayer::OnTrackStarted(MusicTrack track) {
+    current_track_ = track;
 
     // Add to history
     track_history_.push_back(track);
     if (track_history_.size() > MAX_HISTORY) {
         track_history_.erase(track_history_.begin());
     }
-
-    return true;
 }
 
 void MusicPlayer::Stop(bool fade) {
@@ -284,28 +413,34 @@ void MusicPlayer::Stop(bool fade) {
         return;
     }
 
+    next_track_ = MusicTrack::NONE;
+    if (state_ == MusicState::CROSSFADING) {
+        FinishCrossfade();
+    }
+
     if (fade && config_.fade_duration_ms > 0) {
         pending_track_ = MusicTrack::NONE;
         state_ = MusicState::FADING_OUT;
         fade_start_time_ = current_time_;
+        fade_from_ = ActiveDeck().gain;
+        fade_length_ms_ = config_.fade_duration_ms;
         return;
     }
 
-    if (play_handle_ != INVALID_PLAY_HANDLE) {
-        Platform_Sound_Stop(play_handle_);
-        play_handle_ = INVALID_PLAY_HANDLE;
-    }
-
+    UnloadTrack();
     state_ = MusicState::STOPPED;
 }
 
 void MusicPlayer::Pause() {
+    if (state_ == MusicState::CROSSFADING) {
+        FinishCrossfade();
+    }
     if (state_ != MusicState::PLAYING) {
         return;
     }
 
-    if (play_handle_ != INVALID_PLAY_HANDLE) {
-        Platform_Sound_Pause(play_handle_);
+    if (ActiveDeck().handle != INVALID_PLAY_HANDLE) {
+        Platform_Sound_Pause(ActiveDeck().handle);
     }
 
     state_ = MusicState::PAUSED;
@@ -316,8 +451,8 @@ void MusicPlayer::Resume() {
         return;
     }
 
-    if (play_handle_ != INVALID_PLAY_HANDLE) {
-        Platform_Sound_Resume(play_handle_);
+    if (ActiveDeck().handle != INVALID_PLAY_HANDLE) {
+        Platform_Sound_Resume(ActiveDeck().handle);
     }
 
     state_ = MusicState::PLAYING;
@@ -332,7 +467,8 @@ void MusicPlayer::TogglePause() {
 }
 
 void MusicPlayer::PlayNext() {
-    MusicTrack next = GetNextTrackToPlay();
+    // Prefer the track the look-ahead already opened
+    MusicTrack next = next_track_ != MusicTrack::NONE ? next_track_ : GetNextTrackToPlay();
     if (next != MusicTrack::NONE) {
         Play(next, config_.loop_enabled);
     }
@@ -371,10 +507,8 @@ const char* MusicPlayer::GetCurrentTrackName() const {
 void MusicPlayer::SetVolume(float volume) {
     volume_ = std::clamp(volume, 0.0f, 1.0f);
 
-    if (state_ == MusicState::PLAYING) {
-        current_volume_ = volume_;
-        ApplyVolume();
-    }
+    // Deck gains are relative to volume_, so fades keep their shape
+    ApplyVolume();
 }
 
 void MusicPlayer::SetMuted(bool muted) {
@@ -383,9 +517,11 @@ void MusicPlayer::SetMuted(bool muted) {
 }
 
 void MusicPlayer::ApplyVolume() {
-    if (play_handle_ != INVALID_PLAY_HANDLE) {
-        float vol = muted_ ? 0.0f : current_volume_;
-        Platform_Sound_SetVolume(play_handle_, vol);
+    for (const MusicDeck& deck : decks_) {
+        if (deck.handle != INVALID_PLAY_HANDLE) {
+            float vol = muted_ ? 0.0f : deck.gain * volume_;
+            Platform_Sound_SetVolume(deck.handle, vol);
+        }
     }
 }
 
@@ -455,6 +591,36 @@ void MusicPlayer::SetAutoAdvance(bool enabled) {
     config_.auto_advance = enabled;
 }
 
+void MusicPlayer::SetCrossfadeDuration(float ms) {
+    config_.crossfade_ms = std::max(ms, 0.0f);
+}
+
+//=============================================================================
+// Memory
+//=============================================================================
+
+size_t MusicPlayer::GetResidentBytes() const {
+    size_t samples = stream_buffer_.capacity();
+    for (const MusicDeck& deck : decks_) {
+        if (deck.handle != INVALID_PLAY_HANDLE) {
+            samples += static_cast<size_t>(deck.capacity);
+        }
+    }
+    return samples * sizeof(int16_t);
+}
+
+size_t MusicPlayer::Release(size_t bytes) {
+    (void)bytes;
+    size_t before = GetResidentBytes();
+
+    // The scratch is rebuilt when a deck next opens
+    if (decks_[0].handle == INVALID_PLAY_HANDLE && decks_[1].handle == INVALID_PLAY_HANDLE) {
+        stream_buffer_.clear();
+        stream_buffer_.shrink_to_fit();
+    }
+    return before - GetResidentBytes();
+}
+
 //=============================================================================
 // Update
 //=============================================================================
@@ -467,68 +633,164 @@ void MusicPlayer::Update() {
     current_time_ = Platform_GetTicks();
 
     // Update fade effect
-    if (state_ == MusicState::FADING_OUT || state_ == MusicState::FADING_IN) {
+    if (state_ == MusicState::FADING_OUT || state_ == MusicState::FADING_IN ||
+        state_ == MusicState::CROSSFADING) {
         UpdateFade();
     }
 
+    // Keep the streams ahead of playback (a no-op while paused and full)
+    if (state_ != MusicState::STOPPED) {
+        FillStream(decks_[0]);
+        FillStream(decks_[1]);
+    }
+
+    if (state_ == MusicState::PLAYING) {
+        UpdateLookahead();
+    }
+
     // Check for track completion
     if (state_ == MusicState::PLAYING) {
-        if (play_handle_ != INVALID_PLAY_HANDLE &&
-            !Platform_Sound_IsPlaying(play_handle_)) {
+        PlayHandle handle = ActiveDeck().handle;
+        if (handle != INVALID_PLAY_HANDLE && !Platform_Sound_IsPlaying(handle)) {
             OnTrackComplete();
         }
     }
 }
 
-void MusicPlayer::UpdateFade() {
-    if (config_.fade_duration_ms <= 0) {
+void MusicPlayer::UpdateLookahead() {
+    MusicDeck& deck = ActiveDeck();
+    if (!config_.auto_advance || deck.loop || !IsMusicTrackInGame(current_track_)) {
         return;
     }
 
-    float elapsed = static_cast<float>(current_time_ - fade_start_time_);
-    float progress = elapsed / config_.fade_duration_ms;
-    progress = std::clamp(progress, 0.0f, 1.0f);
+    float remaining = GetRemainingMs(deck);
+
+    // Pick the follower early and open it on a worker, so the switch
+    // itself never touches the disk
+    if (next_track_ == MusicTrack::NONE) {
+        if (remaining > config_.lookahead_ms) {
+            return;
+        }
+        next_track_ = GetNextTrackToPlay();
+        PrefetchTrack(next_track_);
+    }
+
+    // Overlap the tail of this track with the head of the next
+    bool next_ready = prefetch_ready_ && prefetch_track_ == next_track_;
+    if (config_.crossfade_ms > 0 && remaining <= config_.crossfade_ms && next_ready) {
+        BeginCrossfade(next_track_, remaining);
+    }
+}
+
+bool MusicPlayer::BeginCrossfade(MusicTrack track, float fade_ms) {
+    MusicDeck& incoming = IdleDeck();
+    if (!LoadTrack(incoming, track)) {
+        return false;
+    }
+
+    incoming.gain = fade_ms > 0 ? 0.0f : 1.0f;
+    if (!StartPlayback(incoming, config_.loop_enabled)) {
+        UnloadDeck(incoming);
+        return false;
+    }
+
+    next_track_ = MusicTrack::NONE;
+    fade_from_ = ActiveDeck().gain;
+    active_deck_ ^= 1;
+    OnTrackStarted(track);
+
+    if (fade_ms <= 0) {
+        UnloadDeck(IdleDeck());
+        state_ = MusicState::PLAYING;
+        return true;
+    }
+
+    state_ = MusicState::CROSSFADING;
+    fade_start_time_ = current_time_;
+    fade_length_ms_ = fade_ms;
+    return true;
+}
+
+void MusicPlayer::FinishCrossfade() {
+    UnloadDeck(IdleDeck());
+    ActiveDeck().gain = 1.0f;
+    ApplyVolume();
+    state_ = MusicState::PLAYING;
+}
+
+void MusicPlayer::UpdateFade() {
+    float progress = 1.0f;
+    if (fade_length_ms_ > 0) {
+        float elapsed = static_cast<float>(current_time_ - fade_start_time_);
+        progress = std::clamp(elapsed / fade_length_ms_, 0.0f, 1.0f);
+    }
 
     if (state_ == MusicState::FADING_OUT) {
-        current_volume_ = volume_ * (1.0f - progress);
+        ActiveDeck().gain = fade_from_ * (1.0f - progress);
         ApplyVolume();
 
+        // Next track opened in the background: overlap instead of waiting
+        // for silence
+        if (pending_track_ != MusicTrack::NONE &&
+            prefetch_track_ == pending_track_ && prefetch_ready_) {
+            MusicTrack next = pending_track_;
+            pending_track_ = MusicTrack::NONE;
+            if (BeginCrossfade(next, config_.fade_duration_ms)) {
+                return;
+            }
+        }
+
         if (progress >= 1.0f) {
             // Fade-out complete
             Stop(false);
 
             if (pending_track_ != MusicTrack::NONE) {
-                // Start next track with fade-in
+                // Open didn't finish in time; load now and fade in
                 MusicTrack next = pending_track_;
                 pending_track_ = MusicTrack::NONE;
 
-                if (LoadTrack(next)) {
-                    current_track_ = next;
-                    current_volume_ = 0.0f;
-                    StartPlayback(config_.loop_enabled);
-                    state_ = MusicState::FADING_IN;
-                    fade_start_time_ = current_time_;
+                MusicDeck& deck = ActiveDeck();
+                if (LoadTrack(deck, next)) {
+                    deck.gain = 0.0f;
+                    if (StartPlayback(deck, config_.loop_enabled)) {
+                        OnTrackStarted(next);
+                        state_ = MusicState::FADING_IN;
+                        fade_start_time_ = current_time_;
+                        fade_length_ms_ = config_.fade_duration_ms;
+                    }
                 }
             }
         }
     }
     else if (state_ == MusicState::FADING_IN) {
-        current_volume_ = volume_ * progress;
+        ActiveDeck().gain = progress;
         ApplyVolume();
 
         if (progress >= 1.0f) {
-            current_volume_ = volume_;
             state_ = MusicState::PLAYING;
         }
     }
+    else if (state_ == MusicState::CROSSFADING) {
+        IdleDeck().gain = fade_from_ * (1.0f - progress);
+        ActiveDeck().gain = progress;
+        ApplyVolume();
+
+        if (progress >= 1.0f) {
+            FinishCrossfade();
+        }
+    }
 }
 
 void MusicPlayer::OnTrackComplete() {
     if (config_.auto_advance && IsMusicTrackInGame(current_track_)) {
-        PlayNext();
-    } else {
-        state_ = MusicState::STOPPED;
+        // The look-ahead has normally opened the next track already, so
+        // this starts it back-to-back without loading
+        MusicTrack next = next_track_ != MusicTrack::NONE ? next_track_ : GetNextTrackToPlay();
+        if (next != MusicTrack::NONE && BeginCrossfade(next, 0.0f)) {
+            return;
+        }
     }
+    Stop(false);
 }
 
 MusicTrack MusicPlayer::GetNextTrackToPlay() {
@@ -551,11 +813,15 @@ void MusicPlayer::PrintStatus() const {
         case MusicState::PAUSED:     state_str = "Paused"; break;
         case MusicState::FADING_OUT: state_str = "Fading Out"; break;
         case MusicState::FADING_IN:  state_str = "Fading In"; break;
+        case MusicState::CROSSFADING: state_str = "Crossfading"; break;
     }
 
     printf("MusicPlayer Status:\n");
     printf("  State: %s\n", state_str);
     printf("  Track: %s\n", GetCurrentTrackName());
+    if (next_track_ != MusicTrack::NONE) {
+        printf("  Up Next: %s\n", GetMusicTrackDisplayName(next_track_));
+    }
     printf("  Volume: %.0f%%\n", volume_ * 100);
     printf("  Muted: %s\n", muted_ ? "yes" : "no");
     printf("  Shuffle: %s\n", config_.shuffle_enabled ? "on" : "off");
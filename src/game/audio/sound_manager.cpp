@@ -4,12 +4,20 @@
 
 #include "game/audio/sound_manager.h"
 #include "game/audio/aud_file.h"
+#include "game/audio/audio_system.h"
+#include "game/asset_loader.h"
+#include "game/asset_manifest.h"
+#include "game/asset_pack.h"
+#include "game/mix_view.h"
 #include "game/viewport.h"
 #include "platform.h"
+#include "platform/profiler.h"
+#include "platform/startup_trace.h"
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
 #include <cmath>
+#include <memory>
 
 //=============================================================================
 // Sound Info Database
@@ -108,6 +116,25 @@ static const SoundInfo SOUND_INFO[] = {
 static_assert(sizeof(SOUND_INFO) / sizeof(SOUND_INFO[0]) == static_cast<size_t>(SoundEffect::COUNT),
               "SOUND_INFO table size mismatch");
 
+//=============================================================================
+// Distance Falloff
+//=============================================================================
+
+// Linear falloff 1 - d/max, indexed by (d/max)^2 so lookups need no sqrt
+static const int FALLOFF_STEPS = 1024;
+
+struct FalloffTable {
+    float values[FALLOFF_STEPS + 1];
+
+    FalloffTable() {
+        for (int i = 0; i <= FALLOFF_STEPS; i++) {
+            values[i] = 1.0f - std::sqrt(static_cast<float>(i) / FALLOFF_STEPS);
+        }
+    }
+};
+
+static const FalloffTable FALLOFF_TABLE;
+
 //=============================================================================
 // Sound Info Accessors
 //=============================================================================
@@ -143,19 +170,40 @@ SoundManager::SoundManager()
     , listener_x_(0)
     , listener_y_(0)
     , max_distance_(1200)
+    , follow_viewport_(true)
+    , spatial_count_(0)
+    , max_distance_sq_(1200 * 1200)
+    , falloff_scale_(0.0f)
     , initialized_(false)
-    , current_time_(0) {
+    , current_time_(0)
+    , load_generation_(0)
+    , resident_bytes_(0)
+    , use_clock_(0)
+    , cache_hits_(0)
+    , cache_misses_(0)
+    , eviction_count_(0)
+    , voices_stolen_(0)
+    , voices_culled_(0)
+    , voice_limit_(0) {
 
     // Initialize all sounds as unloaded
     for (auto& sound : sounds_) {
         sound.platform_handle = INVALID_SOUND_HANDLE;
         sound.loaded = false;
+        sound.pending = false;
+        sound.pinned = false;
+        sound.played = false;
         sound.last_play_time = 0;
+        sound.last_use = 0;
+        sound.pcm_bytes = 0;
         sound.current_play_count = 0;
     }
 
     // Initialize category volumes
     category_volumes_.fill(1.0f);
+
+    spatial_index_.fill(-1);
+    SetMaxDistance(max_distance_);
 }
 
 SoundManager::~SoundManager() {
@@ -170,11 +218,12 @@ bool SoundManager::Initialize(const SoundManagerConfig& config) {
     Platform_LogInfo("SoundManager: Initializing...");
 
     config_ = config;
-    max_distance_ = config.default_max_distance;
-
-    // Load all sounds
-    LoadAllSounds();
+    SetMaxDistance(config.default_max_distance);
+    voices_.Reset(config.max_concurrent_sounds);
+    spatial_index_.fill(-1);
+    spatial_count_ = 0;
 
+    // Sounds load on first play or through Preload()
     initialized_ = true;
     Platform_LogInfo("SoundManager: Initialization complete");
 
@@ -195,18 +244,11 @@ void SoundManager::Shutdown() {
 }
 
 void SoundManager::LoadAllSounds() {
+    STARTUP_PHASE("Load All Sounds");
     Platform_LogInfo("SoundManager: Loading sound effects...");
 
-    int loaded = 0;
-    int failed = 0;
-
     for (int i = 1; i < static_cast<int>(SoundEffect::COUNT); i++) {
-        SoundEffect sfx = static_cast<SoundEffect>(i);
-        if (LoadSound(sfx)) {
-            loaded++;
-        } else {
-            failed++;
-        }
+        Preload(static_cast<SoundEffect>(i));
     }
 
     // Log results (simple string version - counts available via GetLoadedSoundCount)
@@ -214,13 +256,11 @@ void SoundManager::LoadAllSounds() {
 }
 
 void SoundManager::UnloadAllSounds() {
-    for (auto& sound : sounds_) {
-        if (sound.loaded && sound.platform_handle != INVALID_SOUND_HANDLE) {
-            Platform_Sound_Destroy(sound.platform_handle);
-        }
-        sound.platform_handle = INVALID_SOUND_HANDLE;
-        sound.loaded = false;
+    for (size_t i = 0; i < sounds_.size(); i++) {
+        ReleaseSound(static_cast<int>(i));
+        sounds_[i].pending = false;
     }
+    load_generation_++;     // Drop completions of loads still in flight
 }
 
 bool SoundManager::LoadSound(SoundEffect sfx) {
@@ -233,10 +273,40 @@ bool SoundManager::LoadSound(SoundEffect sfx) {
     if (!info.filename) {
         return false;
     }
+    if (sounds_[idx].loaded) {
+        return true;
+    }
+
+    // Packed PCM goes to the platform straight from the mapping
+    AssetPackBlob blob;
+    if (const AssetPackAudio* packed = AssetPack::Instance().FindAudio(info.filename, &blob)) {
+        SoundHandle handle = Platform_Sound_CreateFromMemory(
+            blob.data + packed->pcm_offset,
+            static_cast<int32_t>(packed->pcm_size),
+            packed->sample_rate,
+            packed->channels,
+            16
+        );
+        if (handle == INVALID_SOUND_HANDLE) {
+            return false;
+        }
+        AdoptSound(idx, handle, packed->pcm_size);
+        return true;
+    }
+
+    // Nothing to decode up front when it can stay compressed
+    if (config_.keep_compressed && LoadCompressed(idx, info.filename)) {
+        return true;
+    }
 
     // Load AUD file using platform MIX API
     AudFile aud;
-    if (!aud.LoadFromMix(info.filename)) {
+    bool decoded;
+    {
+        AudioDecodeTimer timer;
+        decoded = aud.LoadFromMix(info.filename);
+    }
+    if (!decoded) {
         // Sound file not found - this is expected if game assets aren't present
         return false;
     }
@@ -255,12 +325,230 @@ bool SoundManager::LoadSound(SoundEffect sfx) {
         return false;
     }
 
-    sounds_[idx].platform_handle = handle;
-    sounds_[idx].loaded = true;
+    AdoptSound(idx, handle, aud.GetPCMDataSize());
+    return true;
+}
+
+bool SoundManager::LoadSoundAsync(SoundEffect sfx) {
+    int idx = static_cast<int>(sfx);
+    if (idx <= 0 || idx >= static_cast<int>(SoundEffect::COUNT)) {
+        return false;
+    }
+
+    const SoundInfo& info = SOUND_INFO[idx];
+    if (!info.filename || sounds_[idx].loaded || sounds_[idx].pending) {
+        return sounds_[idx].loaded || sounds_[idx].pending;
+    }
+
+    // Nothing to decode; a worker would only add a frame of latency
+    if (AssetPack::Instance().FindAudio(info.filename, nullptr) ||
+        (config_.keep_compressed && LoadCompressed(idx, info.filename))) {
+        return LoadSound(sfx);
+    }
+
+    const char* filename = info.filename;
+    uint32_t generation = load_generation_;
+    auto aud = std::make_shared<AudFile>();
+    sounds_[idx].pending = true;
+
+    AssetLoader::Instance().Submit(ASSET_PRIORITY_AUDIO,
+        [aud, filename]() {
+            AudioDecodeTimer timer;
+            aud->LoadFromMix(filename);
+        },
+        [this, aud, idx, generation]() {
+            auto lock = AudioSystem::Instance().LockState();
+            LoadedSound& sound = sounds_[idx];
+            if (generation != load_generation_ || !sound.pending) {
+                return;
+            }
+            sound.pending = false;
+            if (!aud->IsLoaded()) {
+                return;
+            }
+
+            SoundHandle handle = Platform_Sound_CreateFromMemory(
+                aud->GetPCMDataBytes(),
+                static_cast<int32_t>(aud->GetPCMDataSize()),
+                aud->GetSampleRate(),
+                aud->GetChannels(),
+                16
+            );
+            if (handle != INVALID_SOUND_HANDLE) {
+                AdoptSound(idx, handle, aud->GetPCMDataSize());
+            }
+        });
 
     return true;
 }
 
+bool SoundManager::LoadCompressed(int idx, const char* filename) {
+    MixView view(filename);
+    AudHeader header;
+    if (!view || !GetAudInfo(view.Data(), static_cast<uint32_t>(view.Size()), &header) ||
+        header.compression != AUD_COMPRESS_IMA ||
+        header.compressed_size > view.Size() - sizeof(AudHeader)) {
+        return false;
+    }
+
+    // IMA runs one decoder state through the whole file, from zero
+    SoundHandle handle = Platform_Sound_CreateCompressedADPCM(
+        view.Data() + sizeof(AudHeader),
+        static_cast<int32_t>(header.compressed_size),
+        header.sample_rate,
+        (header.flags & AUD_FLAG_STEREO) ? 2 : 1,
+        0,
+        0
+    );
+    if (handle == INVALID_SOUND_HANDLE) {
+        return false;
+    }
+
+    AdoptSound(idx, handle, header.compressed_size);
+    return true;
+}
+
+void SoundManager::AdoptSound(int idx, SoundHandle handle, size_t pcm_bytes) {
+    LoadedSound& sound = sounds_[idx];
+    sound.platform_handle = handle;
+    sound.loaded = true;
+    sound.pending = false;      // A background copy still in flight is dropped
+    sound.pcm_bytes = pcm_bytes;
+    sound.last_use = ++use_clock_;
+    resident_bytes_ += pcm_bytes;
+
+    EnforceBudget(idx);
+}
+
+void SoundManager::ReleaseSound(int idx) {
+    LoadedSound& sound = sounds_[idx];
+    if (sound.loaded && sound.platform_handle != INVALID_SOUND_HANDLE) {
+        Platform_Sound_Destroy(sound.platform_handle);
+    }
+    resident_bytes_ -= std::min(resident_bytes_, sound.pcm_bytes);
+    sound.platform_handle = INVALID_SOUND_HANDLE;
+    sound.loaded = false;
+    sound.pcm_bytes = 0;
+}
+
+bool SoundManager::AcquireSound(int idx) {
+    LoadedSound& sound = sounds_[idx];
+    if (sound.loaded) {
+        cache_hits_++;
+        sound.last_use = ++use_clock_;
+        return true;
+    }
+
+    // Evicted or never prefetched: decode now, and prefetch it next time
+    cache_misses_++;
+    SoundEffect sfx = static_cast<SoundEffect>(idx);
+    if (!LoadSound(sfx)) {
+        return false;
+    }
+    AssetManifest::Record_Sound(sfx);
+    return true;
+}
+
+//=============================================================================
+// Sound Cache
+//=============================================================================
+
+bool SoundManager::Preload(SoundEffect sfx, bool pinned) {
+    int idx = static_cast<int>(sfx);
+    if (idx <= 0 || idx >= static_cast<int>(SoundEffect::COUNT)) {
+        return false;
+    }
+    if (pinned) {
+        sounds_[idx].pinned = true;
+    }
+
+    // With workers running, decoding happens in the background and the
+    // sound becomes playable as the loader is pumped
+    if (AssetLoader::Instance().IsRunning()) {
+        return LoadSoundAsync(sfx);
+    }
+    return LoadSound(sfx);
+}
+
+void SoundManager::Pin(SoundEffect sfx) {
+    int idx = static_cast<int>(sfx);
+    if (idx > 0 && idx < static_cast<int>(SoundEffect::COUNT)) {
+        sounds_[idx].pinned = true;
+    }
+}
+
+void SoundManager::Unpin(SoundEffect sfx) {
+    int idx = static_cast<int>(sfx);
+    if (idx > 0 && idx < static_cast<int>(SoundEffect::COUNT)) {
+        sounds_[idx].pinned = false;
+    }
+}
+
+bool SoundManager::IsPinned(SoundEffect sfx) const {
+    int idx = static_cast<int>(sfx);
+    if (idx <= 0 || idx >= static_cast<int>(SoundEffect::COUNT)) {
+        return false;
+    }
+    return sounds_[idx].pinned;
+}
+
+void SoundManager::UnpinAll() {
+    for (auto& sound : sounds_) {
+        sound.pinned = false;
+    }
+}
+
+void SoundManager::SetCacheBudget(size_t bytes) {
+    config_.cache_budget = bytes;
+    EnforceBudget(-1);
+}
+
+void SoundManager::Trim() {
+    EnforceBudget(-1);
+}
+
+bool SoundManager::IsEvictable(const LoadedSound& sound) const {
+    if (!sound.loaded || sound.pinned || sound.current_play_count > 0) {
+        return false;
+    }
+    return !sound.played || current_time_ - sound.last_play_time >= config_.pin_recent_ms;
+}
+
+size_t SoundManager::Release(size_t bytes) {
+    return EvictTo(resident_bytes_ > bytes ? resident_bytes_ - bytes : 0, -1);
+}
+
+void SoundManager::EnforceBudget(int keep) {
+    if (config_.cache_budget == 0) {
+        return;
+    }
+    EvictTo(config_.cache_budget, keep);
+}
+
+size_t SoundManager::EvictTo(size_t limit, int keep) {
+    size_t start = resident_bytes_;
+    while (resident_bytes_ > limit) {
+        // About 70 sounds; a scan is cheaper than keeping a list in order
+        int victim = -1;
+        for (int i = 1; i < static_cast<int>(sounds_.size()); i++) {
+            if (i == keep || !IsEvictable(sounds_[i])) {
+                continue;
+            }
+            if (victim < 0 || sounds_[i].last_use < sounds_[victim].last_use) {
+                victim = i;
+            }
+        }
+
+        if (victim < 0) {
+            break;  // Everything left is pinned, playing or recently played
+        }
+
+        ReleaseSound(victim);
+        eviction_count_++;
+    }
+    return start - resident_bytes_;
+}
+
 //=============================================================================
 // Playback
 //=============================================================================
@@ -279,44 +567,28 @@ PlayHandle SoundManager::Play(SoundEffect sfx, float volume) {
         return INVALID_PLAY_HANDLE;
     }
 
-    if (!sounds_[idx].loaded) {
-        return INVALID_PLAY_HANDLE;
-    }
-
     if (!CanPlaySound(sfx)) {
         return INVALID_PLAY_HANDLE;
     }
 
     float final_volume = GetFinalVolume(sfx, volume);
     if (final_volume < config_.min_audible_volume) {
+        CountCulledVoice();
         return INVALID_PLAY_HANDLE;
     }
 
-    PlayHandle play_handle = Platform_Sound_Play(
-        sounds_[idx].platform_handle,
-        final_volume,
-        0.0f,   // No pan
-        false   // Not looping
-    );
-
-    if (play_handle != INVALID_PLAY_HANDLE) {
-        // Track playing sound
-        PlayingSoundInfo info;
-        info.play_handle = play_handle;
-        info.sound_id = sfx;
-        info.start_time_ms = current_time_;
-        info.positional = false;
-        info.world_x = 0;
-        info.world_y = 0;
-        info.volume = final_volume;
-        playing_sounds_.push_back(info);
+    uint8_t priority = GetVoicePriority(sfx, volume);
+    int steal = -1;
+    if (!ReserveVoice(priority, steal)) {
+        return INVALID_PLAY_HANDLE;
+    }
 
-        // Update tracking
-        sounds_[idx].last_play_time = current_time_;
-        sounds_[idx].current_play_count++;
+    if (!AcquireSound(idx)) {
+        return INVALID_PLAY_HANDLE;
     }
 
-    return play_handle;
+    int slot = StartVoice(idx, steal, final_volume, 0.0f, false, 0, 0, priority);
+    return slot >= 0 ? voices_.Get(slot).play_handle : INVALID_PLAY_HANDLE;
 }
 
 PlayHandle SoundManager::PlayAt(SoundEffect sfx, int world_x, int world_y, float volume) {
@@ -329,22 +601,32 @@ PlayHandle SoundManager::PlayAt(SoundEffect sfx, int world_x, int world_y, float
         return INVALID_PLAY_HANDLE;
     }
 
-    if (!sounds_[idx].loaded) {
-        return INVALID_PLAY_HANDLE;
+    // Cull out-of-range sounds before anything else looks at them
+    int64_t dist_sq = DistanceSquared(world_x, world_y);
+    if (dist_sq >= max_distance_sq_) {
+        CountCulledVoice();
+        return INVALID_PLAY_HANDLE;  // Too far to hear
     }
 
     if (!CanPlaySound(sfx)) {
         return INVALID_PLAY_HANDLE;
     }
 
-    // Calculate distance-based volume
-    float distance_factor = CalculateDistanceVolume(world_x, world_y);
-    if (distance_factor <= 0.0f) {
-        return INVALID_PLAY_HANDLE;  // Too far to hear
+    float distance_factor = FalloffForDistanceSquared(dist_sq);
+    float mix_volume = GetFinalVolume(sfx, volume);
+    float final_volume = mix_volume * distance_factor;
+    if (final_volume < config_.min_audible_volume) {
+        CountCulledVoice();
+        return INVALID_PLAY_HANDLE;
     }
 
-    float final_volume = GetFinalVolume(sfx, volume * distance_factor);
-    if (final_volume < config_.min_audible_volume) {
+    uint8_t priority = GetVoicePriority(sfx, volume * distance_factor);
+    int steal = -1;
+    if (!ReserveVoice(priority, steal)) {
+        return INVALID_PLAY_HANDLE;
+    }
+
+    if (!AcquireSound(idx)) {
         return INVALID_PLAY_HANDLE;
     }
 
@@ -356,29 +638,20 @@ PlayHandle SoundManager::PlayAt(SoundEffect sfx, int world_x, int world_y, float
         pan = std::clamp(pan, -1.0f, 1.0f);
     }
 
-    PlayHandle play_handle = Platform_Sound_Play(
-        sounds_[idx].platform_handle,
-        final_volume,
-        pan,
-        false
-    );
-
-    if (play_handle != INVALID_PLAY_HANDLE) {
-        PlayingSoundInfo info;
-        info.play_handle = play_handle;
-        info.sound_id = sfx;
-        info.start_time_ms = current_time_;
-        info.positional = true;
-        info.world_x = world_x;
-        info.world_y = world_y;
-        info.volume = final_volume;
-        playing_sounds_.push_back(info);
-
-        sounds_[idx].last_play_time = current_time_;
-        sounds_[idx].current_play_count++;
+    int slot = StartVoice(idx, steal, final_volume, pan, true, world_x, world_y, priority);
+    if (slot < 0) {
+        return INVALID_PLAY_HANDLE;
     }
 
-    return play_handle;
+    SpatialVoice& spatial = spatial_[spatial_count_];
+    spatial.world_x = world_x;
+    spatial.world_y = world_y;
+    spatial.mix_volume = mix_volume;
+    spatial.base_volume = volume;
+    spatial.slot = slot;
+    spatial_index_[slot] = static_cast<int8_t>(spatial_count_++);
+
+    return voices_.Get(slot).play_handle;
 }
 
 PlayHandle SoundManager::PlayAtCell(SoundEffect sfx, int cell_x, int cell_y, float volume) {
@@ -394,22 +667,7 @@ void SoundManager::Stop(PlayHandle handle) {
     }
 
     Platform_Sound_Stop(handle);
-
-    // Remove from playing list
-    auto it = std::find_if(playing_sounds_.begin(), playing_sounds_.end(),
-        [handle](const PlayingSoundInfo& info) {
-            return info.play_handle == handle;
-        });
-
-    if (it != playing_sounds_.end()) {
-        int idx = static_cast<int>(it->sound_id);
-        if (idx > 0 && idx < static_cast<int>(SoundEffect::COUNT)) {
-            if (sounds_[idx].current_play_count > 0) {
-                sounds_[idx].current_play_count--;
-            }
-        }
-        playing_sounds_.erase(it);
-    }
+    ReleaseVoice(voices_.Find(handle));
 }
 
 void SoundManager::StopAll() {
@@ -420,7 +678,9 @@ void SoundManager::StopAll() {
         sound.current_play_count = 0;
     }
 
-    playing_sounds_.clear();
+    voices_.Reset(config_.max_concurrent_sounds);
+    spatial_index_.fill(-1);
+    spatial_count_ = 0;
 }
 
 bool SoundManager::IsPlaying(PlayHandle handle) const {
@@ -465,8 +725,12 @@ void SoundManager::SetMuted(bool muted) {
 //=============================================================================
 
 void SoundManager::SetListenerPosition(int world_x, int world_y) {
+    if (world_x == listener_x_ && world_y == listener_y_) {
+        return;
+    }
     listener_x_ = world_x;
     listener_y_ = world_y;
+    UpdateSpatialVoices();
 }
 
 void SoundManager::GetListenerPosition(int& world_x, int& world_y) const {
@@ -486,6 +750,9 @@ void SoundManager::UpdateListenerFromViewport() {
 
 void SoundManager::SetMaxDistance(int distance) {
     max_distance_ = std::max(1, distance);
+    max_distance_sq_ = static_cast<int64_t>(max_distance_) * max_distance_;
+    falloff_scale_ = static_cast<float>(FALLOFF_STEPS) / static_cast<float>(max_distance_sq_);
+    UpdateSpatialVoices();
 }
 
 //=============================================================================
@@ -500,10 +767,17 @@ void SoundManager::Update() {
     current_time_ = Platform_GetTicks();
 
     // Update listener from viewport
-    UpdateListenerFromViewport();
+    if (follow_viewport_) {
+        UpdateListenerFromViewport();
+    }
 
     // Clean up finished sounds
     CleanupFinishedSounds();
+
+    // Sounds drop out of the recent window as time passes
+    if (config_.cache_budget > 0 && resident_bytes_ > config_.cache_budget) {
+        EnforceBudget(-1);
+    }
 }
 
 //=============================================================================
@@ -511,15 +785,48 @@ void SoundManager::Update() {
 //=============================================================================
 
 float SoundManager::CalculateDistanceVolume(int world_x, int world_y) const {
-    int dx = world_x - listener_x_;
-    int dy = world_y - listener_y_;
-    float distance = std::sqrt(static_cast<float>(dx * dx + dy * dy));
-
-    if (distance >= static_cast<float>(max_distance_)) {
+    int64_t dist_sq = DistanceSquared(world_x, world_y);
+    if (dist_sq >= max_distance_sq_) {
         return 0.0f;
     }
+    return FalloffForDistanceSquared(dist_sq);
+}
+
+int64_t SoundManager::DistanceSquared(int world_x, int world_y) const {
+    int64_t dx = world_x - listener_x_;
+    int64_t dy = world_y - listener_y_;
+    return dx * dx + dy * dy;
+}
+
+float SoundManager::FalloffForDistanceSquared(int64_t dist_sq) const {
+    int step = static_cast<int>(static_cast<float>(dist_sq) * falloff_scale_);
+    return FALLOFF_TABLE.values[std::min(step, FALLOFF_STEPS)];
+}
+
+void SoundManager::UpdateSpatialVoices() {
+    // Backwards, so releasing an entry only moves ones already visited
+    for (int i = spatial_count_ - 1; i >= 0; i--) {
+        const SpatialVoice& spatial = spatial_[i];
+        int slot = spatial.slot;
+
+        int64_t dist_sq = DistanceSquared(spatial.world_x, spatial.world_y);
+        if (dist_sq >= max_distance_sq_) {
+            // Out of range: free the mixer channel rather than mix silence
+            Platform_Sound_Stop(voices_.Get(slot).play_handle);
+            ReleaseVoice(slot);
+            CountCulledVoice();
+            continue;
+        }
 
-    return 1.0f - (distance / static_cast<float>(max_distance_));
+        float factor = FalloffForDistanceSquared(dist_sq);
+        PlayingSoundInfo& info = voices_.Get(slot);
+        float volume = spatial.mix_volume * factor;
+        if (std::fabs(volume - info.volume) >= 1.0f / 256.0f) {
+            Platform_Sound_SetVolume(info.play_handle, volume);
+            info.volume = volume;
+        }
+        voices_.SetPriority(slot, GetVoicePriority(info.sound_id, spatial.base_volume * factor));
+    }
 }
 
 bool SoundManager::CanPlaySound(SoundEffect sfx) const {
@@ -543,30 +850,112 @@ bool SoundManager::CanPlaySound(SoundEffect sfx) const {
         }
     }
 
-    // Check total concurrent sounds
-    if (static_cast<int>(playing_sounds_.size()) >= config_.max_concurrent_sounds) {
-        return false;
+    return true;
+}
+
+uint8_t SoundManager::GetVoicePriority(SoundEffect sfx, float volume) {
+    // Floor per SoundCategory; the sound's own priority fills the rest
+    static const int CATEGORY_FLOOR[] = { 96, 32, 16, 0, 64 };  // UI, COMBAT, UNIT, AMBIENT, SPECIAL
+    static const float PRIORITY_SCALE = (255.0f - 96.0f) / 255.0f;
+
+    const SoundInfo& info = GetSoundInfo(sfx);
+    int category = static_cast<int>(info.category);
+    int floor = (category >= 0 && category < 5) ? CATEGORY_FLOOR[category] : 0;
+
+    float scaled = info.priority * std::clamp(volume, 0.0f, 1.0f) * PRIORITY_SCALE;
+    return static_cast<uint8_t>(std::min(255, floor + static_cast<int>(scaled)));
+}
+
+bool SoundManager::ReserveVoice(uint8_t priority, int& steal) const {
+    steal = -1;
+    bool full = voices_.IsFull() ||
+                (voice_limit_ > 0 && voices_.GetActiveCount() >= voice_limit_);
+    if (!full) {
+        return true;
     }
 
+    // Steal only from a strictly lower priority, so a burst of equal
+    // sounds doesn't keep cutting itself off
+    int lowest = voices_.FindLowest();
+    if (lowest < 0 || voices_.GetPriority(lowest) >= priority) {
+        return false;
+    }
+    steal = lowest;
     return true;
 }
 
-void SoundManager::CleanupFinishedSounds() {
-    auto it = playing_sounds_.begin();
-    while (it != playing_sounds_.end()) {
-        if (!Platform_Sound_IsPlaying(it->play_handle)) {
-            // Update play count
-            int idx = static_cast<int>(it->sound_id);
-            if (idx > 0 && idx < static_cast<int>(SoundEffect::COUNT)) {
-                if (sounds_[idx].current_play_count > 0) {
-                    sounds_[idx].current_play_count--;
-                }
-            }
-            it = playing_sounds_.erase(it);
-        } else {
-            ++it;
+void SoundManager::CountCulledVoice() {
+    voices_culled_++;
+    Profiler::instance().increment_counter(PROFILE_ID("Audio Voices Culled"));
+}
+
+int SoundManager::StartVoice(int idx, int steal, float volume, float pan,
+                                    bool positional, int world_x, int world_y, uint8_t priority) {
+    // Stop the stolen voice first so the platform mixer has a free channel
+    if (steal >= 0) {
+        Platform_Sound_Stop(voices_.Get(steal).play_handle);
+        ReleaseVoice(steal);
+        voices_stolen_++;
+        Profiler::instance().increment_counter(PROFILE_ID("Audio Voices Stolen"));
+    }
+
+    PlayHandle play_handle = Platform_Sound_Play(
+        sounds_[idx].platform_handle,
+        volume,
+        pan,
+        false   // Not looping
+    );
+
+    if (play_handle == INVALID_PLAY_HANDLE) {
+        return -1;
+    }
+
+    PlayingSoundInfo info;
+    info.play_handle = play_handle;
+    info.sound_id = static_cast<SoundEffect>(idx);
+    info.start_time_ms = current_time_;
+    info.positional = positional;
+    info.world_x = world_x;
+    info.world_y = world_y;
+    info.volume = volume;
+    int slot = voices_.Allocate(info, priority);
+
+    sounds_[idx].last_play_time = current_time_;
+    sounds_[idx].played = true;
+    sounds_[idx].current_play_count++;
+
+    return slot;
+}
+
+void SoundManager::ReleaseVoice(int slot) {
+    if (!voices_.IsActive(slot)) {
+        return;
+    }
+
+    int idx = static_cast<int>(voices_.Get(slot).sound_id);
+    if (idx > 0 && idx < static_cast<int>(SoundEffect::COUNT)) {
+        if (sounds_[idx].current_play_count > 0) {
+            sounds_[idx].current_play_count--;
         }
     }
+
+    // Keep the spatial array packed: the last entry fills the hole
+    int entry = spatial_index_[slot];
+    if (entry >= 0) {
+        spatial_[entry] = spatial_[--spatial_count_];
+        spatial_index_[spatial_[entry].slot] = static_cast<int8_t>(entry);
+        spatial_index_[slot] = -1;
+    }
+
+    voices_.Release(slot);
+}
+
+void SoundManager::CleanupFinishedSounds() {
+    voices_.ForEachActive([this](int slot) {
+        if (!Platform_Sound_IsPlaying(voices_.Get(slot).play_handle)) {
+            ReleaseVoice(slot);
+        }
+    });
 }
 
 float SoundManager::GetFinalVolume(SoundEffect sfx, float base_volume) const {
@@ -575,7 +964,8 @@ float SoundManager::GetFinalVolume(SoundEffect sfx, float base_volume) const {
     float category_vol = GetCategoryVolume(info.category);
     float default_vol = info.default_volume;
 
-    return base_volume * default_vol * category_vol * sfx_volume_;
+    // Coalesced events may boost base_volume past 1.0; never exceed full scale
+    return std::min(base_volume * default_vol * category_vol * sfx_volume_, 1.0f);
 }
 
 //=============================================================================
@@ -590,8 +980,16 @@ int SoundManager::GetLoadedSoundCount() const {
     return count;
 }
 
+float SoundManager::GetHitRate() const {
+    uint32_t lookups = cache_hits_ + cache_misses_;
+    if (lookups == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(cache_hits_) / static_cast<float>(lookups);
+}
+
 int SoundManager::GetPlayingSoundCount() const {
-    return static_cast<int>(playing_sounds_.size());
+    return voices_.GetActiveCount();
 }
 
 bool SoundManager::IsSoundLoaded(SoundEffect sfx) const {
@@ -606,8 +1004,12 @@ void SoundManager::PrintStats() const {
     printf("SoundManager Stats:\n");
     printf("  Loaded sounds: %d / %d\n",
            GetLoadedSoundCount(), static_cast<int>(SoundEffect::COUNT) - 1);
-    printf("  Playing sounds: %d / %d\n",
-           GetPlayingSoundCount(), config_.max_concurrent_sounds);
+    printf("  Resident: %zu KB / %zu KB budget\n",
+           resident_bytes_ / 1024, config_.cache_budget / 1024);
+    printf("  Cache: %u hits, %u misses (%.0f%% hit rate), %u evicted\n",
+           cache_hits_, cache_misses_, GetHitRate() * 100.0f, eviction_count_);
+    printf("  Playing sounds: %d / %d voices, %u stolen, %u culled\n",
+           GetPlayingSoundCount(), voices_.GetCapacity(), voices_stolen_, voices_culled_);
     printf("  SFX Volume: %.0f%%\n", sfx_volume_ * 100.0f);
     printf("  Listener: (%d, %d)\n", listener_x_, listener_y_);
     printf("  Muted: %s\n", muted_ ? "yes" : "no");
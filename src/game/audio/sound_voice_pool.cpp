@@ -0,0 +1,134 @@
+// src/game/audio/sound_voice_pool.cpp
+// Fixed-size pool of sound effect voices with priority stealing
+
+#include "game/audio/sound_voice_pool.h"
+#include <algorithm>
+
+SoundVoicePool::SoundVoicePool()
+    : free_head_(-1)
+    , capacity_(0)
+    , active_count_(0) {
+    Reset(MAX_VOICES);
+}
+
+void SoundVoicePool::Reset(int capacity) {
+    capacity_ = std::clamp(capacity, 1, MAX_VOICES);
+    active_count_ = 0;
+
+    bucket_head_.fill(-1);
+    bucket_tail_.fill(-1);
+    for (uint64_t& bits : bucket_bits_) {
+        bits = 0;
+    }
+
+    // Free list in slot order, so voices pack at the front
+    free_head_ = -1;
+    for (int i = MAX_VOICES - 1; i >= 0; i--) {
+        Slot& slot = slots_[i];
+        slot.info = PlayingSoundInfo();
+        slot.info.play_handle = INVALID_PLAY_HANDLE;
+        slot.priority = 0;
+        slot.active = false;
+        slot.prev = -1;
+        slot.next = -1;
+        if (i < capacity_) {
+            slot.next = free_head_;
+            free_head_ = static_cast<int8_t>(i);
+        }
+    }
+}
+
+int SoundVoicePool::Allocate(const PlayingSoundInfo& info, uint8_t priority) {
+    if (free_head_ < 0) {
+        return -1;
+    }
+
+    int slot = free_head_;
+    free_head_ = slots_[slot].next;
+
+    slots_[slot].info = info;
+    slots_[slot].active = true;
+    Link(slot, priority);
+    active_count_++;
+    return slot;
+}
+
+void SoundVoicePool::Release(int slot) {
+    if (!IsActive(slot)) {
+        return;
+    }
+
+    Unlink(slot);
+    slots_[slot].active = false;
+    slots_[slot].info.play_handle = INVALID_PLAY_HANDLE;
+    slots_[slot].next = free_head_;
+    free_head_ = static_cast<int8_t>(slot);
+    active_count_--;
+}
+
+int SoundVoicePool::FindLowest() const {
+    for (int word = 0; word < 4; word++) {
+        if (bucket_bits_[word]) {
+            int bucket = (word << 6) + __builtin_ctzll(bucket_bits_[word]);
+            return bucket_head_[bucket];
+        }
+    }
+    return -1;
+}
+
+int SoundVoicePool::Find(PlayHandle handle) const {
+    if (handle == INVALID_PLAY_HANDLE) {
+        return -1;
+    }
+    for (int i = 0; i < capacity_; i++) {
+        if (slots_[i].active && slots_[i].info.play_handle == handle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void SoundVoicePool::SetPriority(int slot, uint8_t priority) {
+    if (!IsActive(slot) || slots_[slot].priority == priority) {
+        return;
+    }
+    Unlink(slot);
+    Link(slot, priority);
+}
+
+void SoundVoicePool::Link(int slot, uint8_t priority) {
+    Slot& s = slots_[slot];
+    s.priority = priority;
+    s.next = -1;
+    s.prev = bucket_tail_[priority];
+
+    if (s.prev >= 0) {
+        slots_[s.prev].next = static_cast<int8_t>(slot);
+    } else {
+        bucket_head_[priority] = static_cast<int8_t>(slot);
+        bucket_bits_[priority >> 6] |= 1ULL << (priority & 63);
+    }
+    bucket_tail_[priority] = static_cast<int8_t>(slot);
+}
+
+void SoundVoicePool::Unlink(int slot) {
+    Slot& s = slots_[slot];
+    uint8_t priority = s.priority;
+
+    if (s.prev >= 0) {
+        slots_[s.prev].next = s.next;
+    } else {
+        bucket_head_[priority] = s.next;
+    }
+    if (s.next >= 0) {
+        slots_[s.next].prev = s.prev;
+    } else {
+        bucket_tail_[priority] = s.prev;
+    }
+
+    if (bucket_head_[priority] < 0) {
+        bucket_bits_[priority >> 6] &= ~(1ULL << (priority & 63));
+    }
+    s.prev = -1;
+    s.next = -1;
+}
@@ -4,9 +4,14 @@
 
 #include "game/audio/voice_manager.h"
 #include "game/audio/aud_file.h"
+#include "game/audio/audio_system.h"
+#include "game/asset_loader.h"
+#include "game/asset_manifest.h"
 #include "platform.h"
+#include "platform/startup_trace.h"
 #include <algorithm>
 #include <cstdio>
+#include <memory>
 
 //=============================================================================
 // Voice Info Tables
@@ -155,21 +160,13 @@ const char* GetUnitVoiceFilename(UnitVoice voice, VoiceFaction faction) {
 // VoiceManager Implementation
 //=============================================================================
 
-// Priority queue comparator (higher priority first)
-static bool QueueComparator(const QueuedVoice& a, const QueuedVoice& b) {
-    if (a.priority != b.priority) {
-        return a.priority < b.priority;  // Lower priority comes first (min-heap)
-    }
-    return a.queue_time > b.queue_time;  // Earlier time has priority
-}
-
 VoiceManager& VoiceManager::Instance() {
     static VoiceManager instance;
     return instance;
 }
 
 VoiceManager::VoiceManager()
-    : eva_queue_(QueueComparator)
+    : eva_collapsed_(0)
     , eva_play_handle_(INVALID_PLAY_HANDLE)
     , current_eva_(EvaVoice::NONE)
     , eva_last_play_time_(0)
@@ -179,7 +176,10 @@ VoiceManager::VoiceManager()
     , volume_(1.0f)
     , muted_(false)
     , initialized_(false)
-    , current_time_(0) {
+    , current_time_(0)
+    , load_generation_(0) {
+    eva_last_played_.fill(NEVER_PLAYED);
+    unit_last_played_.fill(NEVER_PLAYED);
 }
 
 VoiceManager::~VoiceManager() {
@@ -194,10 +194,10 @@ bool VoiceManager::Initialize() {
     Platform_LogInfo("VoiceManager: Initializing...");
 
     // Clear any existing data
-    eva_voices_.clear();
-    unit_voices_.clear();
-    eva_last_played_.clear();
-    unit_last_played_.clear();
+    ResetVoiceTables();
+    eva_last_played_.fill(NEVER_PLAYED);
+    unit_last_played_.fill(NEVER_PLAYED);
+    eva_collapsed_ = 0;
 
     initialized_ = true;
     Platform_LogInfo("VoiceManager: Initialized");
@@ -216,29 +216,48 @@ void VoiceManager::Shutdown() {
     StopUnit();
 
     // Destroy all loaded voices
-    for (auto& pair : eva_voices_) {
-        if (pair.second.loaded && pair.second.handle != INVALID_SOUND_HANDLE) {
-            Platform_Sound_Destroy(pair.second.handle);
+    ResetVoiceTables();
+    load_generation_++;     // Drop completions of loads still in flight
+
+    // Clear queue
+    ClearEvaQueue();
+
+    initialized_ = false;
+}
+
+void VoiceManager::ResetVoiceTables() {
+    for (LoadedVoice& entry : eva_voices_) {
+        if (entry.loaded && entry.handle != INVALID_SOUND_HANDLE) {
+            Platform_Sound_Destroy(entry.handle);
         }
+        entry = LoadedVoice();
     }
-    eva_voices_.clear();
 
-    for (auto& pair : unit_voices_) {
-        if (pair.second.loaded && pair.second.handle != INVALID_SOUND_HANDLE) {
-            Platform_Sound_Destroy(pair.second.handle);
+    for (auto& faction : unit_voices_) {
+        for (LoadedVoice& entry : faction) {
+            if (entry.loaded && entry.handle != INVALID_SOUND_HANDLE) {
+                Platform_Sound_Destroy(entry.handle);
+            }
+            entry = LoadedVoice();
         }
     }
-    unit_voices_.clear();
+}
 
-    // Clear queue
-    while (!eva_queue_.empty()) {
-        eva_queue_.pop();
+size_t VoiceManager::GetResidentBytes() const {
+    size_t total = 0;
+    for (const LoadedVoice& entry : eva_voices_) {
+        total += entry.pcm_bytes;
     }
-
-    initialized_ = false;
+    for (const auto& faction : unit_voices_) {
+        for (const LoadedVoice& entry : faction) {
+            total += entry.pcm_bytes;
+        }
+    }
+    return total;
 }
 
-void VoiceManager::PreloadCommonVoices() {
+void VoiceManager::PreloadCommonVoices(uint8_t faction_mask) {
+    STARTUP_PHASE("Preload Common Voices");
     Platform_LogInfo("VoiceManager: Preloading common voices...");
 
     // Preload frequently used EVA voices
@@ -248,13 +267,15 @@ void VoiceManager::PreloadCommonVoices() {
         EvaVoice::BASE_UNDER_ATTACK,
         EvaVoice::LOW_POWER,
         EvaVoice::INSUFFICIENT_FUNDS,
+        EvaVoice::UNIT_LOST,
+        EvaVoice::BUILDING_LOST,
     };
 
     for (EvaVoice v : common_eva) {
-        LoadEvaVoice(v);
+        PreloadEvaAsync(v);
     }
 
-    // Preload common unit voices
+    // Preload common unit voices for each faction in play
     static const UnitVoice common_unit[] = {
         UnitVoice::REPORTING,
         UnitVoice::ACKNOWLEDGED,
@@ -263,8 +284,14 @@ void VoiceManager::PreloadCommonVoices() {
         UnitVoice::ATTACKING,
     };
 
-    for (UnitVoice v : common_unit) {
-        LoadUnitVoice(v, VoiceFaction::NEUTRAL);
+    for (int f = 0; f < VOICE_FACTION_COUNT; f++) {
+        VoiceFaction faction = static_cast<VoiceFaction>(f);
+        if (!(faction_mask & VoiceFactionBit(faction))) {
+            continue;
+        }
+        for (UnitVoice v : common_unit) {
+            PreloadUnitAsync(v, faction);
+        }
     }
 }
 
@@ -272,23 +299,54 @@ void VoiceManager::PreloadCommonVoices() {
 // Voice Loading
 //=============================================================================
 
-bool VoiceManager::LoadEvaVoice(EvaVoice voice) {
-    int key = static_cast<int>(voice);
+VoiceManager::LoadedVoice* VoiceManager::GetEvaEntry(EvaVoice voice) {
+    int idx = static_cast<int>(voice);
+    if (idx <= 0 || idx >= EVA_VOICE_COUNT) {
+        return nullptr;
+    }
+    return &eva_voices_[idx];
+}
+
+VoiceManager::LoadedVoice* VoiceManager::GetUnitEntry(UnitVoice voice, VoiceFaction faction) {
+    int idx = static_cast<int>(voice);
+    int f = static_cast<int>(faction);
+    if (idx <= 0 || idx >= UNIT_VOICE_COUNT || f < 0 || f >= VOICE_FACTION_COUNT) {
+        return nullptr;
+    }
+    return &unit_voices_[f][idx];
+}
+
+bool VoiceManager::IsEvaLoaded(EvaVoice voice) const {
+    int idx = static_cast<int>(voice);
+    return idx > 0 && idx < EVA_VOICE_COUNT && eva_voices_[idx].loaded;
+}
+
+bool VoiceManager::IsUnitLoaded(UnitVoice voice, VoiceFaction faction) const {
+    int idx = static_cast<int>(voice);
+    int f = static_cast<int>(faction);
+    return idx > 0 && idx < UNIT_VOICE_COUNT && f >= 0 && f < VOICE_FACTION_COUNT &&
+           unit_voices_[f][idx].loaded;
+}
 
+bool VoiceManager::LoadVoice(LoadedVoice& entry, const char* filename) {
     // Already loaded?
-    auto it = eva_voices_.find(key);
-    if (it != eva_voices_.end() && it->second.loaded) {
+    if (entry.loaded) {
         return true;
     }
-
-    const char* filename = GetEvaVoiceFilename(voice);
     if (!filename) {
         return false;
     }
 
+    // A queued decode still in flight is superseded by this load
+    entry.pending = false;
+
     AudFile aud;
-    if (!aud.LoadFromMix(filename)) {
-        eva_voices_[key] = {INVALID_SOUND_HANDLE, false};
+    bool decoded;
+    {
+        AudioDecodeTimer timer;
+        decoded = aud.LoadFromMix(filename);
+    }
+    if (!decoded) {
         return false;
     }
 
@@ -301,85 +359,118 @@ bool VoiceManager::LoadEvaVoice(EvaVoice voice) {
     );
 
     if (handle == INVALID_SOUND_HANDLE) {
-        eva_voices_[key] = {INVALID_SOUND_HANDLE, false};
         return false;
     }
 
-    eva_voices_[key] = {handle, true};
+    entry.handle = handle;
+    entry.pcm_bytes = aud.GetPCMDataSize();
+    entry.loaded = true;
     return true;
 }
 
+bool VoiceManager::LoadEvaVoice(EvaVoice voice) {
+    LoadedVoice* entry = GetEvaEntry(voice);
+    return entry && LoadVoice(*entry, GetEvaVoiceFilename(voice));
+}
+
 bool VoiceManager::LoadUnitVoice(UnitVoice voice, VoiceFaction faction) {
-    int key = GetUnitVoiceKey(voice, faction);
+    LoadedVoice* entry = GetUnitEntry(voice, faction);
+    return entry && LoadVoice(*entry, GetUnitVoiceFilename(voice, faction));
+}
 
-    auto it = unit_voices_.find(key);
-    if (it != unit_voices_.end() && it->second.loaded) {
-        return true;
-    }
+bool VoiceManager::PreloadEvaAsync(EvaVoice voice) {
+    LoadedVoice* entry = GetEvaEntry(voice);
+    return entry && QueueVoiceLoad(*entry, GetEvaVoiceFilename(voice));
+}
 
-    const char* filename = GetUnitVoiceFilename(voice, faction);
-    if (!filename) {
-        return false;
-    }
+bool VoiceManager::PreloadUnitAsync(UnitVoice voice, VoiceFaction faction) {
+    LoadedVoice* entry = GetUnitEntry(voice, faction);
+    return entry && QueueVoiceLoad(*entry, GetUnitVoiceFilename(voice, faction));
+}
 
-    AudFile aud;
-    if (!aud.LoadFromMix(filename)) {
-        unit_voices_[key] = {INVALID_SOUND_HANDLE, false};
+bool VoiceManager::QueueVoiceLoad(LoadedVoice& entry, const char* filename) {
+    if (!filename) {
         return false;
     }
-
-    SoundHandle handle = Platform_Sound_CreateFromMemory(
-        aud.GetPCMDataBytes(),
-        static_cast<int32_t>(aud.GetPCMDataSize()),
-        aud.GetSampleRate(),
-        aud.GetChannels(),
-        16
-    );
-
-    if (handle == INVALID_SOUND_HANDLE) {
-        unit_voices_[key] = {INVALID_SOUND_HANDLE, false};
-        return false;
+    if (entry.loaded || entry.pending) {
+        return true;
     }
+    entry.pending = true;
+
+    // Table entries live as long as the manager, so the completion can
+    // hold a pointer; the generation check covers Shutdown() in between
+    LoadedVoice* target = &entry;
+    auto aud = std::make_shared<AudFile>();
+    uint32_t generation = load_generation_;
+
+    AssetLoader::Instance().Submit(ASSET_PRIORITY_AUDIO,
+        [aud, filename]() {
+            AudioDecodeTimer timer;
+            aud->LoadFromMix(filename);
+        },
+        [this, target, aud, generation]() {
+            auto lock = AudioSystem::Instance().LockState();
+            // A synchronous load may have beaten us to it
+            if (generation != load_generation_ || !target->pending) {
+                return;
+            }
+            target->pending = false;
+            if (!aud->IsLoaded()) {
+                return;
+            }
+
+            SoundHandle handle = Platform_Sound_CreateFromMemory(
+                aud->GetPCMDataBytes(),
+                static_cast<int32_t>(aud->GetPCMDataSize()),
+                aud->GetSampleRate(),
+                aud->GetChannels(),
+                16
+            );
+            if (handle != INVALID_SOUND_HANDLE) {
+                target->handle = handle;
+                target->pcm_bytes = aud->GetPCMDataSize();
+                target->loaded = true;
+            }
+        });
 
-    unit_voices_[key] = {handle, true};
     return true;
 }
 
 SoundHandle VoiceManager::GetEvaSound(EvaVoice voice) {
-    int key = static_cast<int>(voice);
-
-    auto it = eva_voices_.find(key);
-    if (it != eva_voices_.end() && it->second.loaded) {
-        return it->second.handle;
+    LoadedVoice* entry = GetEvaEntry(voice);
+    if (!entry) {
+        return INVALID_SOUND_HANDLE;
+    }
+    if (entry->loaded) {
+        return entry->handle;
     }
 
-    // Try to load
-    if (LoadEvaVoice(voice)) {
-        return eva_voices_[key].handle;
+    // Not preloaded: load now
+    if (LoadVoice(*entry, GetEvaVoiceFilename(voice))) {
+        AssetManifest::Record_Eva(voice);
+        return entry->handle;
     }
 
     return INVALID_SOUND_HANDLE;
 }
 
 SoundHandle VoiceManager::GetUnitSound(UnitVoice voice, VoiceFaction faction) {
-    int key = GetUnitVoiceKey(voice, faction);
-
-    auto it = unit_voices_.find(key);
-    if (it != unit_voices_.end() && it->second.loaded) {
-        return it->second.handle;
+    LoadedVoice* entry = GetUnitEntry(voice, faction);
+    if (!entry) {
+        return INVALID_SOUND_HANDLE;
+    }
+    if (entry->loaded) {
+        return entry->handle;
     }
 
-    if (LoadUnitVoice(voice, faction)) {
-        return unit_voices_[key].handle;
+    if (LoadVoice(*entry, GetUnitVoiceFilename(voice, faction))) {
+        AssetManifest::Record_Unit_Voice(voice, faction);
+        return entry->handle;
     }
 
     return INVALID_SOUND_HANDLE;
 }
 
-int VoiceManager::GetUnitVoiceKey(UnitVoice voice, VoiceFaction faction) const {
-    return static_cast<int>(voice) * 10 + static_cast<int>(faction);
-}
-
 //=============================================================================
 // EVA Voice Playback
 //=============================================================================
@@ -415,7 +506,16 @@ bool VoiceManager::PlayEva(EvaVoice voice) {
 }
 
 void VoiceManager::QueueEva(EvaVoice voice) {
-    if (voice == EvaVoice::NONE) return;
+    int idx = static_cast<int>(voice);
+    if (idx <= 0 || idx >= EVA_VOICE_COUNT) return;
+
+    // One copy of each line is enough: "unit lost" ten times in a row
+    // collapses into a single announcement
+    if (eva_queued_.test(idx)) {
+        eva_collapsed_++;
+        return;
+    }
+    eva_queued_.set(idx);
 
     const EvaVoiceInfo& info = GetEvaVoiceInfo(voice);
 
@@ -439,7 +539,7 @@ bool VoiceManager::DoPlayEva(EvaVoice voice) {
     if (eva_play_handle_ != INVALID_PLAY_HANDLE) {
         current_eva_ = voice;
         eva_last_play_time_ = current_time_;
-        eva_last_played_[static_cast<int>(voice)] = current_time_;
+        eva_last_played_[static_cast<size_t>(voice)] = current_time_;
         return true;
     }
 
@@ -465,17 +565,17 @@ void VoiceManager::ClearEvaQueue() {
     while (!eva_queue_.empty()) {
         eva_queue_.pop();
     }
+    eva_queued_.reset();
 }
 
 bool VoiceManager::CanPlayEva(EvaVoice voice) const {
-    int key = static_cast<int>(voice);
-    auto it = eva_last_played_.find(key);
-    if (it == eva_last_played_.end()) {
+    int idx = static_cast<int>(voice);
+    if (idx < 0 || idx >= EVA_VOICE_COUNT || eva_last_played_[idx] == NEVER_PLAYED) {
         return true;
     }
 
     const EvaVoiceInfo& info = GetEvaVoiceInfo(voice);
-    return (current_time_ - it->second) >= info.min_interval_ms;
+    return (current_time_ - eva_last_played_[idx]) >= info.min_interval_ms;
 }
 
 void VoiceManager::ProcessEvaQueue() {
@@ -486,6 +586,7 @@ void VoiceManager::ProcessEvaQueue() {
     // Get highest priority voice
     QueuedVoice qv = eva_queue_.top();
     eva_queue_.pop();
+    eva_queued_.reset(static_cast<size_t>(qv.voice));
 
     // Check if still rate-limited
     if (CanPlayEva(qv.voice)) {
@@ -523,7 +624,7 @@ PlayHandle VoiceManager::PlayUnit(UnitVoice voice, VoiceFaction faction) {
     if (unit_play_handle_ != INVALID_PLAY_HANDLE) {
         current_unit_ = voice;
         unit_last_play_time_ = current_time_;
-        unit_last_played_[static_cast<int>(voice)] = current_time_;
+        unit_last_played_[static_cast<size_t>(voice)] = current_time_;
     }
 
     return unit_play_handle_;
@@ -553,14 +654,13 @@ bool VoiceManager::IsUnitSpeaking() const {
 }
 
 bool VoiceManager::CanPlayUnit(UnitVoice voice) const {
-    int key = static_cast<int>(voice);
-    auto it = unit_last_played_.find(key);
-    if (it == unit_last_played_.end()) {
+    int idx = static_cast<int>(voice);
+    if (idx < 0 || idx >= UNIT_VOICE_COUNT || unit_last_played_[idx] == NEVER_PLAYED) {
         return true;
     }
 
     const UnitVoiceInfo& info = GetUnitVoiceInfo(voice);
-    return (current_time_ - it->second) >= info.min_interval_ms;
+    return (current_time_ - unit_last_played_[idx]) >= info.min_interval_ms;
 }
 
 //=============================================================================
@@ -630,7 +730,7 @@ void VoiceManager::PrintStatus() const {
     if (current_eva_ != EvaVoice::NONE) {
         printf("  Current EVA: %s\n", GetEvaVoiceInfo(current_eva_).description);
     }
-    printf("  EVA Queue: %zu\n", eva_queue_.size());
+    printf("  EVA Queue: %zu (collapsed: %u)\n", eva_queue_.size(), eva_collapsed_);
     printf("  Unit Speaking: %s\n", IsUnitSpeaking() ? "yes" : "no");
     printf("  Volume: %.0f%%\n", volume_ * 100);
     printf("  Muted: %s\n", muted_ ? "yes" : "no");
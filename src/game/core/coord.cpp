@@ -7,7 +7,9 @@
 
 #include "game/coord.h"
 #include "game/facing.h"
-#include <cmath>
+#include "game/fixed.h"
+#include <algorithm>
+#include <array>
 
 // =============================================================================
 // Direction Offset Tables
@@ -32,6 +34,102 @@ const int16_t FacingOffset_Cell[8] = {
     -MAP_CELL_WIDTH - 1   // NW: y-1, x-1
 };
 
+// =============================================================================
+// Generated Direction Tables
+// =============================================================================
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Octant atan table resolution: minor/major ratio steps in [0, 1]
+constexpr int ATAN_STEPS = 256;
+
+// C++17 has no constexpr <cmath>, so the tables are built from series
+
+constexpr double Series_Sin(double x) {
+    // Taylor series; accurate to double precision for |x| <= PI
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 20; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double Series_Atan(double x) {
+    // atan(x) = PI/4 + atan((x-1)/(x+1)) keeps the series argument small
+    bool shifted = x > 0.4142;
+    double t = shifted ? (x - 1.0) / (x + 1.0) : x;
+    double power = t;
+    double sum = 0.0;
+    for (int n = 0; n < 30; n++) {
+        sum += (n & 1 ? -power : power) / (2 * n + 1);
+        power *= t * t;
+    }
+    return shifted ? PI / 4 + sum : sum;
+}
+
+struct DirTables {
+    std::array<int16_t, 256> x_factor;  // sin * 256, truncated toward zero
+    std::array<int16_t, 256> y_factor;  // -cos * 256
+    uint8_t octant[ATAN_STEPS + 1];     // Directions off the major axis for ratio i/ATAN_STEPS
+
+    constexpr DirTables() : x_factor(), y_factor(), octant() {
+        // One quadrant from the series, the rest by symmetry, so the
+        // axes come out exact
+        for (int dir = 0; dir <= 64; dir++) {
+            int value = dir == 64 ? 256 : static_cast<int>(Series_Sin(dir * PI / 128) * 256);
+            x_factor[dir] = static_cast<int16_t>(value);
+            x_factor[(128 - dir) & 255] = static_cast<int16_t>(value);
+            x_factor[(128 + dir) & 255] = static_cast<int16_t>(-value);
+            x_factor[(256 - dir) & 255] = static_cast<int16_t>(-value);
+        }
+        for (int dir = 0; dir < 256; dir++) {
+            y_factor[dir] = x_factor[(dir - 64) & 255];
+        }
+        for (int i = 0; i <= ATAN_STEPS; i++) {
+            double angle = Series_Atan(static_cast<double>(i) / ATAN_STEPS);
+            octant[i] = static_cast<uint8_t>(angle * 128 / PI + 0.5);
+        }
+    }
+};
+
+constexpr DirTables Tables;
+
+static_assert(Tables.x_factor[64] == 256 && Tables.y_factor[0] == -256, "axis factors");
+static_assert(Tables.octant[0] == 0 && Tables.octant[ATAN_STEPS] == 32, "octant ends");
+
+/**
+ * Direction of (dx, dy), rounded to the nearest of 256, by octant lookup
+ */
+inline uint8_t Delta_Direction(int dx, int dy) {
+    int ax = dx < 0 ? -dx : dx;
+    int ay = dy < 0 ? -dy : dy;
+    if ((ax | ay) == 0) {
+        return 0;
+    }
+
+    // Angle clockwise from the vertical axis within the quadrant
+    int angle;
+    if (ax <= ay) {
+        angle = Tables.octant[(ax * ATAN_STEPS + (ay >> 1)) / ay];
+    } else {
+        angle = 64 - Tables.octant[(ay * ATAN_STEPS + (ax >> 1)) / ax];
+    }
+
+    if (dx >= 0) {
+        return static_cast<uint8_t>(dy < 0 ? angle : 128 - angle);
+    }
+    return static_cast<uint8_t>(dy >= 0 ? 128 + angle : 256 - angle);
+}
+
+} // namespace
+
+const std::array<int16_t, 256> DirXFactorTable = Tables.x_factor;
+const std::array<int16_t, 256> DirYFactorTable = Tables.y_factor;
+
 // =============================================================================
 // Coordinate Conversion Functions
 // =============================================================================
@@ -120,18 +218,17 @@ uint8_t Coord_Direction(COORDINATE from, COORDINATE to) {
         return 0;
     }
 
-    int dx = Coord_X(to) - Coord_X(from);
-    int dy = Coord_Y(to) - Coord_Y(from);
-
-    // atan2 returns -PI to PI, we need 0-255
     // North (up) = 0, East = 64, South = 128, West = 192
-    double angle = atan2((double)dx, (double)-dy);
-
-    // Convert to 0-255 range
-    int dir = (int)((angle / 3.14159265358979) * 128.0);
-    if (dir < 0) dir += 256;
+    return Delta_Direction(Coord_X(to) - Coord_X(from), Coord_Y(to) - Coord_Y(from));
+}
 
-    return (uint8_t)dir;
+/**
+ * Resolve directions for count coordinate pairs
+ */
+void Coord_Direction_Batch(const COORDINATE* from, const COORDINATE* to, uint8_t* dirs, int count) {
+    for (int i = 0; i < count; i++) {
+        dirs[i] = Coord_Direction(from[i], to[i]);
+    }
 }
 
 /**
@@ -142,11 +239,9 @@ COORDINATE Coord_Move(COORDINATE coord, uint8_t direction, int distance) {
         return coord;
     }
 
-    // Direction to radians (0 = north/up = -Y)
-    double angle = (direction / 128.0) * 3.14159265358979;
-
-    int dx = (int)(sin(angle) * distance);
-    int dy = (int)(-cos(angle) * distance);
+    // Factors are sine and -cosine in 8.8 (0 = north/up = -Y)
+    int dx = (fixed::From_Raw(Tables.x_factor[direction] * 256) * distance).To_Int();
+    int dy = (fixed::From_Raw(Tables.y_factor[direction] * 256) * distance).To_Int();
 
     int x = Coord_X(coord) + dx;
     int y = Coord_Y(coord) + dy;
@@ -211,6 +306,22 @@ COORDINATE Coord_Snap(COORDINATE coord) {
     return Cell_Coord(Coord_Cell(coord));
 }
 
+/**
+ * Interpolate between two coordinates
+ */
+COORDINATE Coord_Lerp(COORDINATE from, COORDINATE to, float t) {
+    if (from == COORD_NONE || to == COORD_NONE || from == to) {
+        return to;
+    }
+
+    int x0 = Coord_X(from);
+    int y0 = Coord_Y(from);
+    int x = x0 + (int)((Coord_X(to) - x0) * t);
+    int y = y0 + (int)((Coord_Y(to) - y0) * t);
+
+    return XY_Coord(x, y);
+}
+
 /**
  * Convert pixel coordinates to world coordinate
  *
@@ -288,25 +399,15 @@ int8_t Dir_Delta(DirType from, DirType to) {
 }
 
 DirType Dir_From_XY(int dx, int dy) {
-    if (dx == 0 && dy == 0) return DIR_N;
-
-    double angle = atan2((double)dx, (double)-dy);
-    int dir = (int)((angle / 3.14159265358979) * 128.0);
-    if (dir < 0) dir += 256;
-
-    return (DirType)dir;
+    return (DirType)Delta_Direction(dx, dy);
 }
 
 int Dir_X_Factor(DirType dir) {
-    // sin(dir * 2 * PI / 256) * 256
-    double angle = (dir / 128.0) * 3.14159265358979;
-    return (int)(sin(angle) * 256);
+    return Tables.x_factor[dir];
 }
 
 int Dir_Y_Factor(DirType dir) {
-    // -cos(dir * 2 * PI / 256) * 256
-    double angle = (dir / 128.0) * 3.14159265358979;
-    return (int)(-cos(angle) * 256);
+    return Tables.y_factor[dir];
 }
 
 } // extern "C"
@@ -355,6 +456,17 @@ bool FacingClass::Rotate() {
     return true;
 }
 
+void FacingClass::Rotate_Batch(DirType* current, const DirType* desired,
+                               const uint8_t* rate, int count) {
+    // Branch-free form of Rotate() so the loop vectorizes
+    for (int i = 0; i < count; i++) {
+        int diff = (int8_t)(uint8_t)(desired[i] - current[i]);
+        int limit = rate[i] ? rate[i] : 128;
+        int step = std::clamp(diff, -limit, limit);
+        current[i] = (DirType)(current[i] + step);
+    }
+}
+
 // =============================================================================
 // Direction Tables
 // =============================================================================
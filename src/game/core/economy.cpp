@@ -0,0 +1,221 @@
+/**
+ * HouseEconomy Implementation
+ *
+ * Original location: CODE/HOUSE.CPP, CODE/FACTORY.CPP
+ */
+
+#include "game/economy.h"
+#include <algorithm>
+
+// =============================================================================
+// Buildings
+// =============================================================================
+
+int HouseEconomy::Building_Storage(BuildingType type) {
+    switch (type) {
+        case BUILDING_PROC:
+            return 2000;
+        case BUILDING_SILO:
+            return 1500;
+        default:
+            return 0;
+    }
+}
+
+void HouseEconomy::Reset() {
+    *this = HouseEconomy();
+    events_ = ECON_CREDITS | ECON_POWER | ECON_STORAGE | ECON_FACTORY;
+}
+
+void HouseEconomy::Building_Added(BuildingType type) {
+    const BuildingTypeClass* building = Building_Type(type);
+    if (building == nullptr) {
+        return;
+    }
+
+    int power = building->Get_Power();
+    Set_Power(power_output_ + std::max(power, 0), power_drain_ + std::max(-power, 0));
+    Set_Capacity(capacity_ + Building_Storage(type));
+}
+
+void HouseEconomy::Building_Removed(BuildingType type) {
+    const BuildingTypeClass* building = Building_Type(type);
+    if (building == nullptr) {
+        return;
+    }
+
+    int power = building->Get_Power();
+    Set_Power(power_output_ - std::max(power, 0), power_drain_ - std::max(-power, 0));
+    Set_Capacity(capacity_ - Building_Storage(type));
+}
+
+void HouseEconomy::Set_Power(int output, int drain) {
+    output = std::max(output, 0);
+    drain = std::max(drain, 0);
+    if (output != power_output_ || drain != power_drain_) {
+        power_output_ = output;
+        power_drain_ = drain;
+        events_ |= ECON_POWER;
+    }
+}
+
+void HouseEconomy::Set_Capacity(int capacity) {
+    capacity = std::max(capacity, 0);
+    if (capacity == capacity_) {
+        return;
+    }
+    capacity_ = capacity;
+    events_ |= ECON_STORAGE;
+
+    // Ore with nowhere to go is lost
+    if (ore_ > capacity_) {
+        ore_ = capacity_;
+        events_ |= ECON_CREDITS;
+    }
+}
+
+// =============================================================================
+// Money
+// =============================================================================
+
+void HouseEconomy::Refund_Money(int amount) {
+    if (amount > 0) {
+        credits_ += amount;
+        events_ |= ECON_CREDITS;
+    }
+}
+
+bool HouseEconomy::Spend_Money(int amount) {
+    if (amount <= 0) {
+        return true;
+    }
+    if (amount > Available_Money()) {
+        return false;
+    }
+
+    int from_ore = std::min(amount, ore_);
+    ore_ -= from_ore;
+    credits_ -= amount - from_ore;
+    events_ |= ECON_CREDITS;
+    return true;
+}
+
+int HouseEconomy::Harvest(int amount) {
+    int stored = std::min(std::max(amount, 0), capacity_ - ore_);
+    if (stored > 0) {
+        ore_ += stored;
+        events_ |= ECON_CREDITS;
+    }
+    return stored;
+}
+
+// =============================================================================
+// Production
+// =============================================================================
+
+bool HouseEconomy::Start_Production(FactoryKind kind, int type_id, int cost, int ticks) {
+    FactoryState& factory = factories_[kind];
+    if (factory.Is_Busy() || type_id < 0) {
+        return false;
+    }
+
+    if (ticks <= 0) {
+        ticks = Build_Ticks(cost);
+    }
+    factory = FactoryState();
+    factory.type_id = type_id;
+    factory.cost = std::max(cost, 0);
+    factory.ticks_per_step = std::max(ticks / FactoryState::STEP_COUNT, 1);
+    events_ |= ECON_FACTORY;
+    return true;
+}
+
+void HouseEconomy::Set_On_Hold(FactoryKind kind, bool on_hold) {
+    FactoryState& factory = factories_[kind];
+    if (factory.Is_Busy() && factory.on_hold != on_hold) {
+        factory.on_hold = on_hold;
+        events_ |= ECON_FACTORY;
+    }
+}
+
+void HouseEconomy::Abandon_Production(FactoryKind kind) {
+    FactoryState& factory = factories_[kind];
+    if (!factory.Is_Busy()) {
+        return;
+    }
+    Refund_Money(factory.spent);
+    factory = FactoryState();
+    events_ |= ECON_FACTORY;
+}
+
+int HouseEconomy::Take_Completed(FactoryKind kind) {
+    FactoryState& factory = factories_[kind];
+    if (!factory.Is_Done()) {
+        return -1;
+    }
+    int type_id = factory.type_id;
+    factory = FactoryState();
+    events_ |= ECON_FACTORY;
+    return type_id;
+}
+
+void HouseEconomy::AI() {
+    // Low power: factories only work every other tick
+    if (Is_Low_Power()) {
+        low_power_tick_ = !low_power_tick_;
+        if (low_power_tick_) {
+            return;
+        }
+    }
+
+    for (FactoryState& factory : factories_) {
+        if (!factory.Is_Busy() || factory.on_hold || factory.Is_Done()) {
+            continue;
+        }
+        if (++factory.ticks < factory.ticks_per_step) {
+            continue;
+        }
+
+        // Each step costs its share; the shares add up to the exact cost
+        int paid_after = factory.cost * (factory.step + 1) / FactoryState::STEP_COUNT;
+        int share = paid_after - factory.spent;
+        if (!Spend_Money(share)) {
+            factory.ticks = factory.ticks_per_step - 1;     // Try again next tick
+            continue;
+        }
+        factory.spent = paid_after;
+        factory.step++;
+        factory.ticks = 0;
+        events_ |= ECON_FACTORY;
+    }
+}
+
+// =============================================================================
+// Houses
+// =============================================================================
+
+namespace {
+
+HouseEconomy Economies[HOUSE_COUNT];
+
+} // namespace
+
+HouseEconomy& House_Economy(HousesType house) {
+    // Out-of-range houses share the neutral house's economy
+    if (house < 0 || house >= HOUSE_COUNT) {
+        house = HOUSE_NEUTRAL;
+    }
+    return Economies[house];
+}
+
+void Reset_Economies() {
+    for (HouseEconomy& economy : Economies) {
+        economy.Reset();
+    }
+}
+
+void Economy_AI() {
+    for (HouseEconomy& economy : Economies) {
+        economy.AI();
+    }
+}
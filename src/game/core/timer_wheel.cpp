@@ -0,0 +1,179 @@
+/**
+ * TimerWheel Implementation
+ */
+
+#include "game/timer_wheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel()
+    : free_(NIL)
+    , now_(0)
+    , sequence_(0)
+    , count_(0)
+{
+    std::fill(heads_, heads_ + LEVELS * SLOTS, NIL);
+    std::fill(tails_, tails_ + LEVELS * SLOTS, NIL);
+}
+
+void TimerWheel::Clear() {
+    // Keep the nodes, so ids handed out before stay stale after
+    free_ = NIL;
+    for (int32_t i = static_cast<int32_t>(nodes_.size()) - 1; i >= 0; i--) {
+        if (nodes_[i].slot != NIL) {
+            nodes_[i].generation++;
+            nodes_[i].slot = NIL;
+        }
+        nodes_[i].next = free_;
+        free_ = i;
+    }
+    std::fill(heads_, heads_ + LEVELS * SLOTS, NIL);
+    std::fill(tails_, tails_ + LEVELS * SLOTS, NIL);
+    due_.clear();
+    now_ = 0;
+    sequence_ = 0;
+    count_ = 0;
+}
+
+// =============================================================================
+// Timers
+// =============================================================================
+
+int32_t TimerWheel::Live(TimerId id) const {
+    int32_t index = static_cast<int32_t>(id & INDEX_MASK) - 1;
+    if (index < 0 || index >= static_cast<int32_t>(nodes_.size())) {
+        return NIL;
+    }
+    const Node& node = nodes_[index];
+    if (node.slot == NIL || node.generation != static_cast<uint16_t>(id >> INDEX_BITS)) {
+        return NIL;
+    }
+    return index;
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(uint32_t delay, uint32_t payload) {
+    int32_t index = free_;
+    if (index != NIL) {
+        free_ = nodes_[index].next;
+    } else {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.push_back(Node());
+        nodes_[index].slot = NIL;
+    }
+
+    Node& node = nodes_[index];
+    node.due = now_ + std::max<uint32_t>(delay, 1);
+    node.payload = payload;
+    node.sequence = sequence_++;
+    File(index);
+    count_++;
+    return Make_Id(index, node.generation);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    int32_t index = Live(id);
+    if (index == NIL) {
+        return false;
+    }
+    if (nodes_[index].slot != SLOT_DUE) {
+        Unlink(index);
+    }
+    Free(index);
+    return true;
+}
+
+uint32_t TimerWheel::Due(TimerId id) const {
+    int32_t index = Live(id);
+    return index != NIL ? nodes_[index].due : 0;
+}
+
+void TimerWheel::Free(int32_t index) {
+    Node& node = nodes_[index];
+    node.generation++;
+    node.slot = NIL;
+    node.next = free_;
+    free_ = index;
+    count_--;
+}
+
+// =============================================================================
+// Slots
+// =============================================================================
+
+void TimerWheel::File(int32_t index) {
+    Node& node = nodes_[index];
+    uint32_t delta = node.due - now_;
+
+    // Finest level whose span covers the delay; beyond the top level's
+    // span, its current slot, which comes round again last
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1u << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    uint32_t tick = delta >> (SLOT_BITS * LEVELS) ? now_ : node.due;
+    int slot = level * SLOTS + static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    // Append, so a slot keeps its timers in the order they were filed
+    node.slot = static_cast<int16_t>(slot);
+    node.next = NIL;
+    node.prev = tails_[slot];
+    if (tails_[slot] != NIL) {
+        nodes_[tails_[slot]].next = index;
+    } else {
+        heads_[slot] = index;
+    }
+    tails_[slot] = index;
+}
+
+void TimerWheel::Unlink(int32_t index) {
+    Node& node = nodes_[index];
+    int slot = node.slot;
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[slot] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    } else {
+        tails_[slot] = node.prev;
+    }
+}
+
+void TimerWheel::Cascade(int level) {
+    int slot = level * SLOTS + static_cast<int>((now_ >> (SLOT_BITS * level)) & (SLOTS - 1));
+    int32_t index = heads_[slot];
+    heads_[slot] = NIL;
+    tails_[slot] = NIL;
+    while (index != NIL) {
+        int32_t next = nodes_[index].next;
+        File(index);
+        index = next;
+    }
+}
+
+void TimerWheel::Collect() {
+    // Each level's current slot empties into the levels below when every
+    // level below it has wrapped; coarsest first, so nothing is skipped
+    int wrapped = 0;
+    while (wrapped < LEVELS - 1 && ((now_ >> (SLOT_BITS * wrapped)) & (SLOTS - 1)) == 0) {
+        wrapped++;
+    }
+    for (int level = wrapped; level > 0; level--) {
+        Cascade(level);
+    }
+
+    int slot = static_cast<int>(now_ & (SLOTS - 1));
+    for (int32_t index = heads_[slot]; index != NIL; index = nodes_[index].next) {
+        nodes_[index].slot = SLOT_DUE;
+        due_.push_back(index);
+    }
+    heads_[slot] = NIL;
+    tails_[slot] = NIL;
+
+    // Cascading may have put an earlier-scheduled timer after a later one
+    if (due_.size() > 1) {
+        std::sort(due_.begin(), due_.end(), [this](int32_t a, int32_t b) {
+            return nodes_[a].sequence < nodes_[b].sequence;
+        });
+    }
+}
@@ -0,0 +1,259 @@
+/**
+ * TriggerEngine Implementation
+ *
+ * Original location: CODE/TRIGGER.CPP, CODE/TEVENT.CPP
+ */
+
+#include "game/trigger.h"
+#include "game/economy.h"
+#include "game/object.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// last_money_ before a house's credits have been looked at
+constexpr int32_t MONEY_UNSEEN = INT32_MIN;
+
+} // namespace
+
+TriggerEngine& TriggerEngine::Instance() {
+    static TriggerEngine instance;
+    return instance;
+}
+
+TriggerEngine::TriggerEngine() {
+    Clear();
+}
+
+void TriggerEngine::Clear() {
+    triggers_.clear();
+    std::memset(cell_bits_, 0, sizeof(cell_bits_));
+    by_cell_.clear();
+    by_object_.clear();
+    timers_.Clear();
+    for (int house = 0; house < HOUSE_COUNT; house++) {
+        by_house_[house].clear();
+        last_money_[house] = MONEY_UNSEEN;
+    }
+    pending_.clear();
+    tick_ = 0;
+    evaluations_ = 0;
+}
+
+// =============================================================================
+// Subscriptions
+// =============================================================================
+
+int TriggerEngine::Add(const TriggerType& type) {
+    int id = Count();
+    Trigger trigger;
+    trigger.type = type;
+    triggers_.push_back(trigger);
+
+    Arm_Timer(id);
+
+    const TEventClass* events[2] = {&type.event1, &type.event2};
+    for (uint8_t bit = 0; bit < 2; bit++) {
+        const TEventClass& event = *events[bit];
+        if (event.type != TEVENT_CREDITS || event.house < 0 || event.house >= HOUSE_COUNT) {
+            continue;
+        }
+        by_house_[event.house].push_back({id, event.data, bit});
+        last_money_[event.house] = MONEY_UNSEEN;    // Check on the next Update
+    }
+    return id;
+}
+
+void TriggerEngine::Attach_Cell(int id, CELL cell) {
+    if (id < 0 || id >= Count() || cell < 0) {
+        return;
+    }
+
+    CellWatch watch = {cell, id};
+    auto at = std::lower_bound(by_cell_.begin(), by_cell_.end(), watch,
+        [](const CellWatch& a, const CellWatch& b) {
+            return a.cell != b.cell ? a.cell < b.cell : a.id < b.id;
+        });
+    if (at != by_cell_.end() && at->cell == cell && at->id == id) {
+        return;
+    }
+    by_cell_.insert(at, watch);
+    cell_bits_[cell >> 6] |= uint64_t(1) << (cell & 63);
+}
+
+void TriggerEngine::Attach_Object(int id, const ObjectClass* obj) {
+    if (id < 0 || id >= Count() || obj == nullptr) {
+        return;
+    }
+    ObjectHandle handle = Object_Handle(obj);
+    if (!handle.Is_None()) {
+        by_object_.emplace(Key(handle), id);
+    }
+}
+
+void TriggerEngine::Arm_Timer(int id) {
+    Trigger& trigger = triggers_[id];
+    const TEventClass* events[2] = {&trigger.type.event1, &trigger.type.event2};
+    for (uint8_t bit = 0; bit < 2; bit++) {
+        // A rearmed trigger counts from now, whatever was still pending
+        timers_.Cancel(trigger.timer[bit]);
+        trigger.timer[bit] = TimerWheel::TIMER_NONE;
+        if (events[bit]->type != TEVENT_TIME) {
+            continue;
+        }
+        uint32_t delay = static_cast<uint32_t>(std::max(events[bit]->data, 1));
+        trigger.timer[bit] = timers_.Schedule(delay, static_cast<uint32_t>(id) << 1 | bit);
+    }
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+void TriggerEngine::Cell_Entered(CELL cell, HousesType house) {
+    if (!Is_Cell_Watched(cell)) {
+        return;
+    }
+
+    auto first = std::lower_bound(by_cell_.begin(), by_cell_.end(), cell,
+        [](const CellWatch& a, CELL c) { return a.cell < c; });
+    for (auto it = first; it != by_cell_.end() && it->cell == cell; ++it) {
+        Spring(it->id, TEVENT_ENTERED, house);
+    }
+}
+
+void TriggerEngine::Object_Destroyed(const ObjectClass* obj) {
+    if (by_object_.empty() || obj == nullptr) {
+        return;
+    }
+    ObjectHandle handle = Object_Handle(obj);
+    if (handle.Is_None()) {
+        return;
+    }
+
+    // The object is gone, so its subscriptions go with it
+    auto range = by_object_.equal_range(Key(handle));
+    for (auto it = range.first; it != range.second; ++it) {
+        Spring(it->second, TEVENT_DESTROYED, HOUSE_NONE);
+    }
+    by_object_.erase(range.first, range.second);
+}
+
+void TriggerEngine::Spring(int id, TEventType type, HousesType house) {
+    Trigger& trigger = triggers_[id];
+    if (!trigger.active) {
+        return;
+    }
+
+    const TEventClass* events[2] = {&trigger.type.event1, &trigger.type.event2};
+    uint8_t sprung = 0;
+    for (int bit = 0; bit < 2; bit++) {
+        const TEventClass& event = *events[bit];
+        if (event.type != type) {
+            continue;
+        }
+        if (type == TEVENT_ENTERED && event.house != HOUSE_NONE && event.house != house) {
+            continue;
+        }
+        sprung |= 1 << bit;
+    }
+    if (sprung != 0) {
+        trigger.sprung |= sprung;
+        Queue(id);
+    }
+}
+
+void TriggerEngine::Queue(int id) {
+    Trigger& trigger = triggers_[id];
+    if (!trigger.queued) {
+        trigger.queued = true;
+        pending_.push_back(id);
+    }
+}
+
+// =============================================================================
+// Update
+// =============================================================================
+
+void TriggerEngine::Check_Credits() {
+    for (int house = 0; house < HOUSE_COUNT; house++) {
+        if (by_house_[house].empty()) {
+            continue;
+        }
+        int32_t money = House_Economy(static_cast<HousesType>(house)).Available_Money();
+        if (money == last_money_[house]) {
+            continue;
+        }
+        last_money_[house] = money;
+
+        for (const CreditWatch& watch : by_house_[house]) {
+            Trigger& trigger = triggers_[watch.id];
+            if (trigger.active && money >= watch.amount) {
+                trigger.sprung |= 1 << watch.bit;
+                Queue(watch.id);
+            }
+        }
+    }
+}
+
+bool TriggerEngine::Is_Satisfied(const Trigger& trigger) const {
+    switch (trigger.type.logic) {
+        case TRIGGER_AND:
+            return (trigger.sprung & 3) == 3;
+        case TRIGGER_OR:
+            return (trigger.sprung & 3) != 0;
+        default:
+            return (trigger.sprung & 1) != 0;
+    }
+}
+
+void TriggerEngine::Update() {
+    tick_++;
+
+    timers_.Advance([this](uint32_t payload) {
+        int id = static_cast<int>(payload >> 1);
+        int bit = payload & 1;
+        Trigger& trigger = triggers_[id];
+        trigger.timer[bit] = TimerWheel::TIMER_NONE;
+        if (trigger.active) {
+            trigger.sprung |= 1 << bit;
+            Queue(id);
+        }
+    });
+
+    Check_Credits();
+
+    if (pending_.empty()) {
+        return;
+    }
+
+    // Actions may spring or add triggers; those wait for the next tick
+    std::vector<int> ready;
+    ready.swap(pending_);
+    std::sort(ready.begin(), ready.end());
+
+    for (int id : ready) {
+        Trigger& trigger = triggers_[id];
+        trigger.queued = false;
+        evaluations_++;
+        if (!trigger.active || !Is_Satisfied(trigger)) {
+            continue;
+        }
+
+        trigger.fired++;
+        if (trigger.type.persist == TRIGGER_PERSISTENT) {
+            trigger.sprung = 0;
+            Arm_Timer(id);
+        } else {
+            trigger.active = false;
+        }
+
+        // The handler may add triggers, so don't hold a reference across it
+        TriggerType type = trigger.type;
+        if (action_) {
+            action_(id, type);
+        }
+    }
+}
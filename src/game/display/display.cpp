@@ -8,8 +8,14 @@
 #include "game/cell.h"
 #include "game/graphics/tile_renderer.h"
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/radar_render.h"
+#include "game/graphics/selection_overlay.h"
+#include "game/graphics/shroud_edges.h"
+#include "game/sim_pipeline.h"
 #include "platform.h"
+#include "platform/profiler.h"
 #include <algorithm>
+#include <cstdlib>
 
 // =============================================================================
 // Global Display Pointer
@@ -30,6 +36,19 @@ DisplayClass::DisplayClass()
     , cursor_cell_(CELL_NONE)
     , scroll_constrained_(true)
     , need_full_redraw_(true)
+    , terrain_target_(nullptr)
+    , cache_scroll_x_(0)
+    , cache_scroll_y_(0)
+    , cache_valid_(false)
+    , interior_x0_(0)
+    , interior_y0_(0)
+    , interior_x1_(0)
+    , interior_y1_(0)
+    , drawing_interior_(false)
+    , radar_(nullptr)
+    , object_snapshot_(nullptr)
+    , snapshot_alpha_(1.0f)
+    , terrain_prepared_(false)
 {
 }
 
@@ -43,6 +62,12 @@ DisplayClass::~DisplayClass() {
 void DisplayClass::One_Time() {
     MapClass::One_Time();
 
+    // The tactical view fills whatever internal resolution graphics came
+    // up at; the terrain cache follows it on the next frame
+    if (Get_Width() > 0 && Get_Height() > TACTICAL_Y) {
+        Set_Tactical_Area(TACTICAL_X, TACTICAL_Y, Get_Width(), Get_Height() - TACTICAL_Y);
+    }
+
     Platform_LogInfo("DisplayClass::One_Time complete");
 }
 
@@ -64,6 +89,17 @@ void DisplayClass::Render() {
         return;
     }
 
+    Draw_Frame();
+
+    // Present frame (via base class)
+    GScreenClass::Flip();
+}
+
+void DisplayClass::Draw_Frame() {
+    if (!Is_Initialized()) {
+        return;
+    }
+
     // Lock buffer for drawing
     Lock();
 
@@ -71,13 +107,21 @@ void DisplayClass::Render() {
     Draw_Tactical();
 
     // Draw cursor highlight
-    Draw_Cursor();
+    {
+        PROFILE_SCOPE("Render Cursor");
+        Draw_Cursor();
+    }
+
+    // Selection brackets, health bars and the cursor box in one pass
+    {
+        PROFILE_SCOPE("Render Selection");
+        SelectionOverlay& overlay = SelectionOverlay::Instance();
+        overlay.Draw(Get_Buffer(), Get_Pitch(), Get_Width(), Get_Height(), 0);
+        overlay.Clear();
+    }
 
     // Unlock buffer
     Unlock();
-
-    // Present frame (via base class)
-    GScreenClass::Flip();
 }
 
 // =============================================================================
@@ -146,8 +190,9 @@ void DisplayClass::Scroll(int dx, int dy) {
         if (new_y > max_y) new_y = max_y;
     }
 
+    // The terrain cache picks up the new position on the next frame and
+    // only redraws the exposed strip
     tactical_pos_ = XY_Coord(new_x, new_y);
-    need_full_redraw_ = true;
 }
 
 void DisplayClass::Center_On(COORDINATE coord) {
@@ -161,8 +206,6 @@ void DisplayClass::Center_On(COORDINATE coord) {
     if (scroll_constrained_) {
         Scroll(0, 0); // This will clamp to bounds
     }
-
-    need_full_redraw_ = true;
 }
 
 void DisplayClass::Center_On(CELL cell) {
@@ -183,6 +226,38 @@ void DisplayClass::Edge_Scroll(int edge, int speed) {
     }
 }
 
+int DisplayClass::Prefetch_Cells(int start_x, int start_y, int end_x, int end_y) {
+    const CellLayers* layers = Get_Cell_Layers();
+    if (layers == nullptr) {
+        return 0;
+    }
+
+    start_x = std::max(start_x, 0);
+    start_y = std::max(start_y, 0);
+    end_x = std::min(end_x, MAP_CELL_WIDTH);
+    end_y = std::min(end_y, MAP_CELL_HEIGHT);
+
+    // A strip is mostly a few templates over and over; ask once for each
+    TileRenderer& renderer = TileRenderer::Instance();
+    bool asked[TEMPLATE_COUNT] = {};
+    int queued = 0;
+    for (int cy = start_y; cy < end_y; cy++) {
+        for (int cx = start_x; cx < end_x; cx++) {
+            int index = Layer_Index(cx, cy);
+            uint8_t tmpl = layers->template_type[index];
+            if (tmpl == 0xFF || tmpl >= TEMPLATE_COUNT || asked[tmpl] ||
+                layers->visibility[index] == CELL_SHROUD) {
+                continue;
+            }
+            asked[tmpl] = true;
+            if (renderer.LoadTemplateAsync(static_cast<TemplateType>(tmpl), ASSET_PRIORITY_PREFETCH)) {
+                queued++;
+            }
+        }
+    }
+    return queued;
+}
+
 // =============================================================================
 // Coordinate Conversion
 // =============================================================================
@@ -256,11 +331,8 @@ void DisplayClass::Draw_Selection_Box(int x1, int y1, int x2, int y2, uint8_t co
     if (x1 > x2) std::swap(x1, x2);
     if (y1 > y2) std::swap(y1, y2);
 
-    // Draw box outline
-    Draw_Line(x1, y1, x2, y1, color); // Top
-    Draw_Line(x1, y2, x2, y2, color); // Bottom
-    Draw_Line(x1, y1, x1, y2, color); // Left
-    Draw_Line(x2, y1, x2, y2, color); // Right
+    // Drawn with the frame's other selection overlays
+    SelectionOverlay::Instance().Add_Box(x1, y1, x2 - x1 + 1, y2 - y1 + 1, color);
 }
 
 void DisplayClass::Highlight_Cell(CELL cell, uint8_t color) {
@@ -283,6 +355,19 @@ void DisplayClass::Draw_Cursor() {
 // Tactical Rendering
 // =============================================================================
 
+void DisplayClass::Prepare_Frame() {
+    PROFILE_SCOPE("Render Terrain");
+    frame_stats_.Reset();
+    int scroll_x = Coord_XPixel(tactical_pos_);
+    int scroll_y = Coord_YPixel(tactical_pos_);
+
+    // Terrain layers come from the cache, which redraws only what changed
+    Update_Terrain_Cache(scroll_x, scroll_y);
+    Forward_Changed_Cells();
+    Clear_Changed_Cells();
+    terrain_prepared_ = true;
+}
+
 void DisplayClass::Draw_Tactical() {
     int start_x, start_y, end_x, end_y;
     Get_Visible_Cells(start_x, start_y, end_x, end_y);
@@ -290,21 +375,305 @@ void DisplayClass::Draw_Tactical() {
     int scroll_x = Coord_XPixel(tactical_pos_);
     int scroll_y = Coord_YPixel(tactical_pos_);
 
-    // Draw each visible cell
+    if (!terrain_prepared_) {
+        Prepare_Frame();
+    }
+    terrain_prepared_ = false;
+
+    if (terrain_cache_ && terrain_cache_->Lock()) {
+        PROFILE_SCOPE("Render Terrain");
+        GraphicsBuffer& screen = GraphicsBuffer::Screen();
+        if (screen.Lock()) {
+            screen.Blit_From(*terrain_cache_, 0, 0, tactical_x_, tactical_y_);
+            screen.Unlock();
+        }
+        terrain_cache_->Unlock();
+    }
+
+    // Objects move every frame, so they are drawn over the cached terrain.
+    PROFILE_SCOPE("Render Objects");
+    if (object_snapshot_) {
+        Draw_Snapshot_Objects(scroll_x, scroll_y);
+        return;
+    }
+
+    // The packed visibility layer skips shrouded cells without touching them.
+    const CellLayers* layers = Get_Cell_Layers();
     for (int cy = start_y; cy < end_y; cy++) {
         for (int cx = start_x; cx < end_x; cx++) {
-            CELL cell = XY_Cell(cx, cy);
+            if (layers && layers->visibility[Layer_Index(cx, cy)] == CELL_SHROUD) {
+                continue;
+            }
+
+            CellClass& c = (*this)[XY_Cell(cx, cy)];
+            if (!c.Is_Occupied() || c.Is_Shrouded()) {
+                continue;
+            }
 
-            // Calculate screen position
             int screen_x = (cx * CELL_PIXEL_SIZE) - scroll_x + tactical_x_;
             int screen_y = (cy * CELL_PIXEL_SIZE) - scroll_y + tactical_y_;
+            Draw_Objects(c, screen_x, screen_y);
+            frame_stats_.objects_drawn++;
+        }
+    }
+}
+
+void DisplayClass::Draw_Snapshot_Objects(int scroll_x, int scroll_y) {
+    // Same marker as Draw_Objects(), placed at the interpolated position
+    const int margin = 3;
+    for (const ObjectSnapshot& obj : object_snapshot_->Objects()) {
+        COORDINATE coord = Coord_Lerp(obj.prev_coord, obj.coord, snapshot_alpha_);
+        int cx = Coord_XPixel(coord) - scroll_x + tactical_x_;
+        int cy = Coord_YPixel(coord) - scroll_y + tactical_y_;
+        if (cx < tactical_x_ + margin || cx >= tactical_x_ + tactical_width_ - margin ||
+            cy < tactical_y_ + margin || cy >= tactical_y_ + tactical_height_ - margin) {
+            continue;
+        }
+
+        Put_Pixel(cx, cy - 3, 15);
+        Put_Pixel(cx - 3, cy, 15);
+        Put_Pixel(cx + 3, cy, 15);
+        Put_Pixel(cx, cy + 3, 15);
+        frame_stats_.objects_drawn++;
+    }
+}
+
+// =============================================================================
+// Terrain Cache
+// =============================================================================
+
+void DisplayClass::Update_Terrain_Cache(int scroll_x, int scroll_y) {
+    int w = tactical_width_;
+    int h = tactical_height_;
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    if (!terrain_cache_ || terrain_cache_->Get_Width() != w ||
+        terrain_cache_->Get_Height() != h) {
+        terrain_cache_ = std::make_unique<GraphicsBuffer>(w, h);
+        cache_valid_ = false;
+    }
+
+    if (!terrain_cache_->Lock()) {
+        cache_valid_ = false;
+        return;
+    }
+    terrain_target_ = terrain_cache_.get();
+    Classify_Interior_Cells(scroll_x, scroll_y, w, h);
+
+    int dx = scroll_x - cache_scroll_x_;
+    int dy = scroll_y - cache_scroll_y_;
+
+    if (!cache_valid_ || need_full_redraw_ || std::abs(dx) >= w || std::abs(dy) >= h) {
+        Redraw_Terrain_Rect(0, 0, w, h, scroll_x, scroll_y);
+    } else {
+        if (dx != 0 || dy != 0) {
+            // Content moves opposite to the view; redraw the exposed strips
+            terrain_cache_->Shift(-dx, -dy);
+
+            if (dx > 0) {
+                Redraw_Terrain_Rect(w - dx, 0, dx, h, scroll_x, scroll_y);
+            } else if (dx < 0) {
+                Redraw_Terrain_Rect(0, 0, -dx, h, scroll_x, scroll_y);
+            }
+
+            if (dy > 0) {
+                Redraw_Terrain_Rect(0, h - dy, w, dy, scroll_x, scroll_y);
+            } else if (dy < 0) {
+                Redraw_Terrain_Rect(0, 0, w, -dy, scroll_x, scroll_y);
+            }
+        }
+
+        if (Has_Changed_Cells()) {
+            Redraw_Changed_Cells(scroll_x, scroll_y);
+        }
+    }
+
+    cache_scroll_x_ = scroll_x;
+    cache_scroll_y_ = scroll_y;
+    cache_valid_ = true;
+    need_full_redraw_ = false;
+
+    terrain_target_ = nullptr;
+    terrain_cache_->Unlock();
+}
+
+void DisplayClass::Redraw_Terrain_Rect(int x, int y, int w, int h, int scroll_x, int scroll_y) {
+    // Clear first so pixels beyond the map edge don't keep stale terrain
+    Terrain_Target().Fill_Rect(x, y, w, h, 0);
+    frame_stats_.dirty_rects_count++;
+    frame_stats_.pixels_filled += w * h;
+
+    int start_x, start_y, end_x, end_y;
+    Cells_In_Rect(scroll_x + x, scroll_y + y, w, h, start_x, start_y, end_x, end_y);
+
+    for (int cy = start_y; cy < end_y; cy++) {
+        Draw_Cell_Row(cy, start_x, end_x, scroll_x, scroll_y);
+    }
+}
+
+void DisplayClass::Draw_Cell_Row(int cy, int start_x, int end_x, int scroll_x, int scroll_y) {
+    TileRenderer& renderer = TileRenderer::Instance();
+    GraphicsBuffer& buffer = Terrain_Target();
+    int screen_y = cy * CELL_PIXEL_SIZE - scroll_y;
+
+    // Templates go down in runs broken only by shrouded cells
+    TileRunEntry run[MAP_CELL_WIDTH];
+    int run_start = start_x;
+    int run_count = 0;
+    frame_stats_.terrain_tiles_drawn += std::max(0, end_x - start_x);
+
+    auto flush = [&]() {
+        if (run_count > 0) {
+            renderer.DrawTileRun(buffer, run_start * CELL_PIXEL_SIZE - scroll_x, screen_y,
+                                 run, run_count);
+            run_count = 0;
+        }
+    };
+
+    for (int cx = start_x; cx < end_x; cx++) {
+        CellClass& c = (*this)[XY_Cell(cx, cy)];
+        if (c.Is_Shrouded()) {
+            flush();
+            Draw_Shroud(c, cx * CELL_PIXEL_SIZE - scroll_x, screen_y);
+            continue;
+        }
+
+        if (run_count == 0) {
+            run_start = cx;
+        }
+        TileRunEntry& entry = run[run_count++];
+        uint8_t tmpl = c.Get_Template();
+        entry.tmpl = (tmpl == 0xFF || !c.Has_Template())
+            ? TEMPLATE_NONE : static_cast<TemplateType>(tmpl);
+        entry.icon = c.Get_Icon();
+        entry.seed = c.Get_Cell_Index();
+    }
+    flush();
+
+    // Overlays sit on top of their own tile; tiles don't overlap
+    for (int cx = start_x; cx < end_x; cx++) {
+        CellClass& c = (*this)[XY_Cell(cx, cy)];
+        if (!c.Is_Shrouded() && c.Has_Overlay()) {
+            Draw_Overlay(c, cx * CELL_PIXEL_SIZE - scroll_x, screen_y);
+        }
+    }
+
+    // Rows with no fog, shroud or edges are the common case: skip them whole
+    const CellLayers* layers = Get_Cell_Layers();
+    if (layers == nullptr || start_x >= end_x) {
+        return;
+    }
+    int row = Layer_Index(start_x, cy);
+    uint8_t pending = 0;
+    for (int i = row; i < row + (end_x - start_x); i++) {
+        pending |= layers->fog_edge[i] | (layers->visibility[i] ^ CELL_VISIBLE);
+    }
+    if (pending == 0) {
+        return;
+    }
+
+    for (int cx = start_x; cx < end_x; cx++) {
+        Draw_Shroud_Edges(cx, cy, cx * CELL_PIXEL_SIZE - scroll_x, screen_y);
+    }
+}
+
+void DisplayClass::Draw_Shroud_Edges(int cx, int cy, int screen_x, int screen_y) {
+    const CellLayers* layers = Get_Cell_Layers();
+    if (layers == nullptr) {
+        return;
+    }
+
+    int index = Layer_Index(cx, cy);
+    uint8_t vis = layers->visibility[index];
+    if (vis == CELL_SHROUD) {
+        return;     // Already solid black
+    }
+
+    GraphicsBuffer& buffer = Terrain_Target();
+    if (vis != CELL_VISIBLE) {
+        buffer.Mask_Tile24(Fog_Fill_Shape(), screen_x, screen_y);
+    } else {
+        int fog = Shroud_Edge_Frame(layers->fog_edge[index]);
+        if (fog != 0) {
+            buffer.Mask_Tile24(Fog_Edge_Shape(fog), screen_x, screen_y);
+        }
+    }
+
+    int shroud = Shroud_Edge_Frame(layers->shroud_edge[index]);
+    if (shroud != 0) {
+        buffer.Mask_Tile24(Shroud_Edge_Shape(shroud), screen_x, screen_y);
+    }
+}
+
+void DisplayClass::Redraw_Changed_Cells(int scroll_x, int scroll_y) {
+    int start_x, start_y, end_x, end_y;
+    Cells_In_Rect(scroll_x, scroll_y, tactical_width_, tactical_height_,
+                  start_x, start_y, end_x, end_y);
 
-            // Draw the cell
-            Draw_Cell(cell, screen_x, screen_y);
+    for (int cy = start_y; cy < end_y; cy++) {
+        for (int cx = start_x; cx < end_x; cx++) {
+            if (Is_Cell_Changed(cx, cy)) {
+                Draw_Cache_Cell(cx, cy, scroll_x, scroll_y);
+                frame_stats_.terrain_tiles_drawn++;
+                frame_stats_.dirty_rects_count++;
+                frame_stats_.pixels_filled += CELL_PIXEL_SIZE * CELL_PIXEL_SIZE;
+            }
         }
     }
 }
 
+void DisplayClass::Classify_Interior_Cells(int scroll_x, int scroll_y, int w, int h) {
+    // First cell starting at or after pixel 0, last one ending by w/h
+    auto first = [](int scroll) {
+        return scroll > 0 ? (scroll + CELL_PIXEL_SIZE - 1) / CELL_PIXEL_SIZE : 0;
+    };
+    auto last = [](int scroll, int size) {
+        int end = scroll + size;
+        return end > 0 ? end / CELL_PIXEL_SIZE : 0;
+    };
+
+    interior_x0_ = first(scroll_x);
+    interior_y0_ = first(scroll_y);
+    interior_x1_ = last(scroll_x, w);
+    interior_y1_ = last(scroll_y, h);
+}
+
+void DisplayClass::Draw_Cache_Cell(int cx, int cy, int scroll_x, int scroll_y) {
+    drawing_interior_ = cx >= interior_x0_ && cx < interior_x1_ &&
+                        cy >= interior_y0_ && cy < interior_y1_;
+    Draw_Cell(XY_Cell(cx, cy),
+              cx * CELL_PIXEL_SIZE - scroll_x,
+              cy * CELL_PIXEL_SIZE - scroll_y);
+    drawing_interior_ = false;
+}
+
+void DisplayClass::Cells_In_Rect(int world_x, int world_y, int w, int h,
+                                 int& start_x, int& start_y, int& end_x, int& end_y) {
+    start_x = std::max(0, world_x / CELL_PIXEL_SIZE);
+    start_y = std::max(0, world_y / CELL_PIXEL_SIZE);
+    end_x = std::min(MAP_CELL_WIDTH, (world_x + w + CELL_PIXEL_SIZE - 1) / CELL_PIXEL_SIZE);
+    end_y = std::min(MAP_CELL_HEIGHT, (world_y + h + CELL_PIXEL_SIZE - 1) / CELL_PIXEL_SIZE);
+}
+
+void DisplayClass::Forward_Changed_Cells() {
+    if (radar_ == nullptr) {
+        return;
+    }
+    For_Each_Changed_Cell([this](int x, int y) {
+        radar_->InvalidateCell(x, y);
+    });
+}
+
+GraphicsBuffer& DisplayClass::Terrain_Target() {
+    return terrain_target_ ? *terrain_target_ : GraphicsBuffer::Screen();
+}
+
+// =============================================================================
+// Cell Layers
+// =============================================================================
+
 void DisplayClass::Draw_Cell(CELL cell, int screen_x, int screen_y) {
     CellClass& c = (*this)[cell];
 
@@ -322,21 +691,13 @@ void DisplayClass::Draw_Cell(CELL cell, int screen_x, int screen_y) {
         Draw_Overlay(c, screen_x, screen_y);
     }
 
-    // Draw objects
-    if (c.Is_Occupied()) {
-        Draw_Objects(c, screen_x, screen_y);
-    }
-
-    // Draw fog if explored but not visible
-    if (!c.Is_Visible()) {
-        // Draw semi-transparent fog overlay
-        // (Placeholder - actual fog rendering is more complex)
-    }
+    // Fog and the edges of neighbouring shroud
+    Draw_Shroud_Edges(Cell_X(cell), Cell_Y(cell), screen_x, screen_y);
 }
 
 void DisplayClass::Draw_Template(CellClass& cell, int screen_x, int screen_y) {
     TileRenderer& renderer = TileRenderer::Instance();
-    GraphicsBuffer& buffer = GraphicsBuffer::Screen();
+    GraphicsBuffer& buffer = Terrain_Target();
 
     // Get template type and icon from cell
     uint8_t tmpl = cell.Get_Template();
@@ -352,7 +713,10 @@ void DisplayClass::Draw_Template(CellClass& cell, int screen_x, int screen_y) {
 
     // Try to draw the tile using TileRenderer
     TemplateType tile_type = static_cast<TemplateType>(tmpl);
-    if (!renderer.DrawTile(buffer, screen_x, screen_y, tile_type, icon)) {
+    bool drawn = drawing_interior_
+        ? renderer.DrawTileInterior(buffer, screen_x, screen_y, tile_type, icon)
+        : renderer.DrawTile(buffer, screen_x, screen_y, tile_type, icon);
+    if (!drawn) {
         // Fallback: draw clear terrain if template loading failed
         renderer.DrawClear(buffer, screen_x, screen_y, cell.Get_Cell_Index());
     }
@@ -360,18 +724,19 @@ void DisplayClass::Draw_Template(CellClass& cell, int screen_x, int screen_y) {
 
 void DisplayClass::Draw_Overlay(CellClass& cell, int screen_x, int screen_y) {
     // Placeholder: Draw overlay indicator
+    GraphicsBuffer& buffer = Terrain_Target();
     if (cell.Is_Tiberium()) {
         // Draw tiberium crystal pattern
         int cx = screen_x + CELL_PIXEL_SIZE / 2;
         int cy = screen_y + CELL_PIXEL_SIZE / 2;
-        Put_Pixel(cx, cy, 113); // Green
-        Put_Pixel(cx - 2, cy, 113);
-        Put_Pixel(cx + 2, cy, 113);
-        Put_Pixel(cx, cy - 2, 113);
-        Put_Pixel(cx, cy + 2, 113);
+        buffer.Put_Pixel(cx, cy, 113); // Green
+        buffer.Put_Pixel(cx - 2, cy, 113);
+        buffer.Put_Pixel(cx + 2, cy, 113);
+        buffer.Put_Pixel(cx, cy - 2, 113);
+        buffer.Put_Pixel(cx, cy + 2, 113);
     } else if (cell.Is_Wall()) {
         // Draw wall outline
-        Draw_Rect(screen_x + 2, screen_y + 2, CELL_PIXEL_SIZE - 4, CELL_PIXEL_SIZE - 4, 8);
+        buffer.Fill_Rect(screen_x + 2, screen_y + 2, CELL_PIXEL_SIZE - 4, CELL_PIXEL_SIZE - 4, 8);
     }
 }
 
@@ -393,5 +758,5 @@ void DisplayClass::Draw_Objects(CellClass& cell, int screen_x, int screen_y) {
 void DisplayClass::Draw_Shroud(CellClass& cell, int screen_x, int screen_y) {
     (void)cell;
     // Draw black for unexplored areas
-    Draw_Rect(screen_x, screen_y, CELL_PIXEL_SIZE, CELL_PIXEL_SIZE, 0);
+    Terrain_Target().Fill_Rect(screen_x, screen_y, CELL_PIXEL_SIZE, CELL_PIXEL_SIZE, 0);
 }
@@ -6,6 +6,7 @@
 
 #include "game/gadget.h"
 #include "game/gscreen.h"
+#include "game/graphics/text_cache.h"
 #include <cstring>
 
 // =============================================================================
@@ -21,12 +22,40 @@ GadgetClass::GadgetClass(int x, int y, int w, int h, uint16_t flags, int id)
     , id_(id)
     , is_dirty_(true)
     , is_pressed_(false)
+    , is_hover_(false)
     , next_(nullptr)
+    , screen_(nullptr)
+    , order_(0)
+    , is_queued_(false)
 {
 }
 
 GadgetClass::~GadgetClass() {
-    // Nothing to clean up
+    // Don't leave the screen pointing at us
+    if (screen_ != nullptr) {
+        screen_->Remove_Gadget(this);
+    }
+}
+
+void GadgetClass::Set_Dirty() {
+    is_dirty_ = true;
+    if (screen_ != nullptr && !is_queued_) {
+        screen_->Queue_Gadget_Draw(this);
+    }
+}
+
+void GadgetClass::Layout_Changed() {
+    Set_Dirty();
+    if (screen_ != nullptr) {
+        screen_->Gadget_Layout_Changed();
+    }
+}
+
+void GadgetClass::Set_Hover(bool hover) {
+    if (is_hover_ != hover) {
+        is_hover_ = hover;
+        Set_Dirty();
+    }
 }
 
 bool GadgetClass::Is_Point_In(int px, int py) const {
@@ -122,7 +151,7 @@ void ButtonClass::Draw(GScreenClass* screen, bool forced) {
     }
 
     // Button colors
-    uint8_t face_color = Is_Enabled() ? 8 : 7;  // Light grey or darker
+    uint8_t face_color = !Is_Enabled() ? 7 : (is_hover_ ? 15 : 8);  // Darker, highlight or light grey
     uint8_t text_color = Is_Enabled() ? 0 : 8;  // Black or grey
 
     // Draw button face
@@ -182,15 +211,14 @@ void TextClass::Set_Text(const char* text) {
     if (text) {
         strncpy(text_, text, sizeof(text_) - 1);
         text_[sizeof(text_) - 1] = '\0';
-        // Update size based on text length (placeholder - 8 pixels per char)
-        width_ = (int)strlen(text_) * 8;
-        height_ = 8;
+        width_ = TextCache::Text_Width(text_, TEXT_FONT_MENU);
+        height_ = TextCache::Text_Height(TEXT_FONT_MENU);
     } else {
         text_[0] = '\0';
         width_ = 0;
         height_ = 0;
     }
-    Set_Dirty();
+    Layout_Changed();
 }
 
 void TextClass::Draw(GScreenClass* screen, bool forced) {
@@ -202,10 +230,13 @@ void TextClass::Draw(GScreenClass* screen, bool forced) {
         return;
     }
 
-    // TODO: Draw text (requires font system)
-    // For now, draw a horizontal line as placeholder
-    if (width_ > 0) {
-        screen->Draw_Line(x_, y_ + 4, x_ + width_ - 1, y_ + 4, color_);
+    const TextLayout* layout = TextCache::Instance().Get_Layout(text_, TEXT_FONT_MENU, color_);
+    if (layout) {
+        for (const TextSpan& span : layout->spans) {
+            int x = x_ + span.x;
+            int y = y_ + span.y;
+            screen->Draw_Line(x, y, x + span.length - 1, y, color_);
+        }
     }
 
     is_dirty_ = false;
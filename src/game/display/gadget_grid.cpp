@@ -0,0 +1,96 @@
+/**
+ * GadgetGrid Implementation
+ */
+
+#include "game/gadget_grid.h"
+#include "game/gadget.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// Cells a gadget covers, inclusive, relative to the grid origin
+struct CellSpan {
+    int x0, y0, x1, y1;
+};
+
+CellSpan Span_Of(const GadgetClass* gadget, int origin_x, int origin_y) {
+    int right = gadget->Get_X() + std::max(gadget->Get_Width(), 1) - 1;
+    int bottom = gadget->Get_Y() + std::max(gadget->Get_Height(), 1) - 1;
+    return {(gadget->Get_X() - origin_x) >> GadgetGrid::CELL_SHIFT,
+            (gadget->Get_Y() - origin_y) >> GadgetGrid::CELL_SHIFT,
+            (right - origin_x) >> GadgetGrid::CELL_SHIFT,
+            (bottom - origin_y) >> GadgetGrid::CELL_SHIFT};
+}
+
+} // namespace
+
+void GadgetGrid::Clear() {
+    origin_x_ = 0;
+    origin_y_ = 0;
+    columns_ = 0;
+    rows_ = 0;
+    cell_start_.clear();
+    entries_.clear();
+}
+
+void GadgetGrid::Build(GadgetClass* head) {
+    Clear();
+    if (head == nullptr) {
+        return;
+    }
+
+    // Bounding box of every gadget
+    int min_x = INT_MAX;
+    int min_y = INT_MAX;
+    int max_x = INT_MIN;
+    int max_y = INT_MIN;
+    for (GadgetClass* gadget = head; gadget != nullptr; gadget = gadget->Get_Next()) {
+        min_x = std::min(min_x, gadget->Get_X());
+        min_y = std::min(min_y, gadget->Get_Y());
+        max_x = std::max(max_x, gadget->Get_X() + std::max(gadget->Get_Width(), 1) - 1);
+        max_y = std::max(max_y, gadget->Get_Y() + std::max(gadget->Get_Height(), 1) - 1);
+    }
+    origin_x_ = min_x;
+    origin_y_ = min_y;
+    columns_ = ((max_x - min_x) >> CELL_SHIFT) + 1;
+    rows_ = ((max_y - min_y) >> CELL_SHIFT) + 1;
+
+    // Count, then place; walking the list in order keeps each cell in
+    // list order
+    cell_start_.assign(static_cast<size_t>(columns_) * rows_ + 1, 0);
+    for (GadgetClass* gadget = head; gadget != nullptr; gadget = gadget->Get_Next()) {
+        CellSpan span = Span_Of(gadget, origin_x_, origin_y_);
+        for (int y = span.y0; y <= span.y1; y++) {
+            for (int x = span.x0; x <= span.x1; x++) {
+                cell_start_[y * columns_ + x + 1]++;
+            }
+        }
+    }
+    for (size_t i = 1; i < cell_start_.size(); i++) {
+        cell_start_[i] += cell_start_[i - 1];
+    }
+
+    entries_.resize(cell_start_.back());
+    std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (GadgetClass* gadget = head; gadget != nullptr; gadget = gadget->Get_Next()) {
+        CellSpan span = Span_Of(gadget, origin_x_, origin_y_);
+        for (int y = span.y0; y <= span.y1; y++) {
+            for (int x = span.x0; x <= span.x1; x++) {
+                entries_[fill[y * columns_ + x]++] = gadget;
+            }
+        }
+    }
+}
+
+GadgetGrid::Range GadgetGrid::At(int x, int y) const {
+    int column = (x - origin_x_) >> CELL_SHIFT;
+    int row = (y - origin_y_) >> CELL_SHIFT;
+    if (x < origin_x_ || y < origin_y_ || column >= columns_ || row >= rows_) {
+        return {nullptr, nullptr};
+    }
+
+    int cell = row * columns_ + column;
+    GadgetClass* const* base = entries_.data();
+    return {base + cell_start_[cell], base + cell_start_[cell + 1]};
+}
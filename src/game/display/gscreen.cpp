@@ -7,6 +7,7 @@
 #include "game/gscreen.h"
 #include "game/gadget.h"
 #include "platform.h"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
@@ -29,6 +30,8 @@ GScreenClass::GScreenClass()
     , is_initialized_(false)
     , theater_(0)
     , gadget_head_(nullptr)
+    , gadget_layout_dirty_(false)
+    , gadget_hover_(nullptr)
 {
 }
 
@@ -296,36 +299,54 @@ done:
 // =============================================================================
 
 void GScreenClass::Add_Gadget(GadgetClass* gadget) {
-    if (gadget == nullptr) {
+    if (gadget == nullptr || gadget->screen_ == this) {
         return;
     }
+    if (gadget->screen_ != nullptr) {
+        gadget->screen_->Remove_Gadget(gadget);
+    }
 
     // Add to front of list
     gadget->Set_Next(gadget_head_);
     gadget_head_ = gadget;
+    gadget->screen_ = this;
+    gadget_layout_dirty_ = true;
+
+    // New to this screen, so it has never been drawn here
+    gadget->Set_Dirty();
 }
 
 void GScreenClass::Remove_Gadget(GadgetClass* gadget) {
-    if (gadget == nullptr || gadget_head_ == nullptr) {
+    if (gadget == nullptr || gadget->screen_ != this) {
         return;
     }
 
     // Remove from list
     if (gadget_head_ == gadget) {
         gadget_head_ = gadget->Get_Next();
-        gadget->Set_Next(nullptr);
-        return;
-    }
-
-    GadgetClass* prev = gadget_head_;
-    while (prev->Get_Next() != nullptr) {
-        if (prev->Get_Next() == gadget) {
-            prev->Set_Next(gadget->Get_Next());
-            gadget->Set_Next(nullptr);
-            return;
+    } else {
+        GadgetClass* prev = gadget_head_;
+        while (prev->Get_Next() != gadget) {
+            prev = prev->Get_Next();
         }
-        prev = prev->Get_Next();
+        prev->Set_Next(gadget->Get_Next());
     }
+    gadget->Set_Next(nullptr);
+
+    // Forget every reference to it
+    auto forget = [gadget](std::vector<GadgetClass*>& list) {
+        list.erase(std::remove(list.begin(), list.end(), gadget), list.end());
+    };
+    forget(gadget_dirty_);
+    forget(gadget_pressed_);
+    forget(gadget_keyboard_);
+    if (gadget_hover_ == gadget) {
+        gadget_hover_ = nullptr;
+    }
+    gadget->is_hover_ = false;
+    gadget->screen_ = nullptr;
+    gadget->is_queued_ = false;
+    gadget_layout_dirty_ = true;
 }
 
 void GScreenClass::Remove_All_Gadgets() {
@@ -333,8 +354,35 @@ void GScreenClass::Remove_All_Gadgets() {
     while (gadget_head_ != nullptr) {
         GadgetClass* next = gadget_head_->Get_Next();
         gadget_head_->Set_Next(nullptr);
+        gadget_head_->screen_ = nullptr;
+        gadget_head_->is_queued_ = false;
         gadget_head_ = next;
     }
+
+    gadget_grid_.Clear();
+    gadget_layout_dirty_ = false;
+    gadget_hover_ = nullptr;
+    gadget_dirty_.clear();
+    gadget_pressed_.clear();
+    gadget_keyboard_.clear();
+}
+
+void GScreenClass::Queue_Gadget_Draw(GadgetClass* gadget) {
+    gadget->is_queued_ = true;
+    gadget_dirty_.push_back(gadget);
+}
+
+void GScreenClass::Rebuild_Gadget_Index() {
+    gadget_keyboard_.clear();
+    int order = 0;
+    for (GadgetClass* gadget = gadget_head_; gadget != nullptr; gadget = gadget->Get_Next()) {
+        gadget->order_ = order++;
+        if (gadget->Get_Flags() & GADGET_KEYBOARD) {
+            gadget_keyboard_.push_back(gadget);
+        }
+    }
+    gadget_grid_.Build(gadget_head_);
+    gadget_layout_dirty_ = false;
 }
 
 int GScreenClass::Process_Gadgets(int input) {
@@ -360,31 +408,100 @@ int GScreenClass::Process_Gadgets(int input) {
     gi.right_held = Platform_Mouse_IsPressed(MOUSE_BUTTON_RIGHT);
     gi.key_code = 0; // TODO: Get from keyboard
 
+    return Process_Gadgets(gi);
+}
+
+int GScreenClass::Process_Gadgets(const GadgetInput& gi) {
+    if (gadget_layout_dirty_) {
+        Rebuild_Gadget_Index();
+    }
+
+    // Gadgets under the mouse, topmost (earliest in the list) first
+    gadget_scratch_.clear();
+    GadgetClass* hover = nullptr;
+    for (GadgetClass* gadget : gadget_grid_.At(gi.mouse_x, gi.mouse_y)) {
+        if (gadget->Is_Point_In(gi.mouse_x, gi.mouse_y)) {
+            gadget_scratch_.push_back(gadget);
+            if (hover == nullptr && gadget->Is_Visible()) {
+                hover = gadget;
+            }
+        }
+    }
+
+    if (hover != gadget_hover_) {
+        if (gadget_hover_ != nullptr) {
+            gadget_hover_->Set_Hover(false);
+        }
+        if (hover != nullptr) {
+            hover->Set_Hover(true);
+        }
+        gadget_hover_ = hover;
+    }
+
+    // A press elsewhere still gets its release, and keys go to keyboard
+    // gadgets wherever the mouse is
+    bool merged = !gadget_pressed_.empty() || (gi.key_code != 0 && !gadget_keyboard_.empty());
+    gadget_scratch_.insert(gadget_scratch_.end(), gadget_pressed_.begin(), gadget_pressed_.end());
+    if (gi.key_code != 0) {
+        gadget_scratch_.insert(gadget_scratch_.end(), gadget_keyboard_.begin(), gadget_keyboard_.end());
+    }
+    if (merged) {
+        std::sort(gadget_scratch_.begin(), gadget_scratch_.end(),
+                  [](const GadgetClass* a, const GadgetClass* b) { return a->order_ < b->order_; });
+        gadget_scratch_.erase(std::unique(gadget_scratch_.begin(), gadget_scratch_.end()),
+                              gadget_scratch_.end());
+    }
+
     // Process each gadget
-    GadgetClass* gadget = gadget_head_;
-    while (gadget != nullptr) {
-        int result = gadget->Process_Input(gi);
+    int result = 0;
+    for (GadgetClass* gadget : gadget_scratch_) {
+        result = gadget->Process_Input(gi);
         if (result != 0) {
-            return result; // Gadget was activated
+            break; // Gadget was activated
         }
-        gadget = gadget->Get_Next();
     }
 
-    return 0;
+    gadget_pressed_.clear();
+    for (GadgetClass* gadget : gadget_scratch_) {
+        if (gadget->Is_Pressed()) {
+            gadget_pressed_.push_back(gadget);
+        }
+    }
+
+    return result;
 }
 
-void GScreenClass::Draw_Gadgets() {
+void GScreenClass::Draw_Gadgets(bool forced) {
     bool was_locked = is_locked_;
     if (!was_locked) Lock();
 
-    // Draw each gadget (in reverse order so first added is on top)
-    GadgetClass* gadget = gadget_head_;
-    while (gadget != nullptr) {
-        if (gadget->Is_Visible()) {
-            gadget->Draw(this, false);
+    if (forced) {
+        // Draw each gadget (in reverse order so first added is on top)
+        for (GadgetClass* gadget = gadget_head_; gadget != nullptr; gadget = gadget->Get_Next()) {
+            if (gadget->Is_Visible()) {
+                gadget->Draw(this, true);
+            }
         }
-        gadget = gadget->Get_Next();
+    } else if (!gadget_dirty_.empty()) {
+        if (gadget_layout_dirty_) {
+            Rebuild_Gadget_Index();
+        }
+
+        // Same order as a full redraw
+        std::sort(gadget_dirty_.begin(), gadget_dirty_.end(),
+                  [](const GadgetClass* a, const GadgetClass* b) { return a->order_ < b->order_; });
+        for (GadgetClass* gadget : gadget_dirty_) {
+            if (gadget->Is_Visible()) {
+                gadget->Draw(this, false);
+            }
+        }
+    }
+
+    // A hidden gadget stays dirty and is queued again when shown
+    for (GadgetClass* gadget : gadget_dirty_) {
+        gadget->is_queued_ = false;
     }
+    gadget_dirty_.clear();
 
     if (!was_locked) Unlock();
 }
@@ -5,9 +5,18 @@
  */
 
 #include "game/map.h"
+#include "game/build_map.h"
 #include "game/cell.h"
+#include "game/object.h"
+#include "game/state_hash.h"
+#include "game/tiberium.h"
+#include "game/vision_map.h"
+#include "game/zone_map.h"
 #include "platform.h"
+#include "platform/large_pages.h"
+#include <algorithm>
 #include <cstring>
+#include <new>
 
 // =============================================================================
 // Theater Data
@@ -45,20 +54,44 @@ MapClass::MapClass()
     : GScreenClass()
     , cells_(nullptr)
     , cells_owned_(false)
+    , cell_layout_(CELL_LAYOUT_LINEAR)
+    , layers_(nullptr)
+    , zones_(nullptr)
+    , vision_(nullptr)
+    , build_(nullptr)
+    , tiberium_(nullptr)
+    , ore_fields_(nullptr)
     , map_x_(1)
     , map_y_(1)
     , map_width_(MAP_CELL_WIDTH - 2)
     , map_height_(MAP_CELL_HEIGHT - 2)
+    , land_revision_(0)
+    , cell_hash_(0)
     , theater_type_(THEATER_NONE)
     , tactical_pos_(0)
+    , any_cell_changed_(false)
 {
+    memset(changed_cells_, 0, sizeof(changed_cells_));
+    memset(block_occupancy_, 0, sizeof(block_occupancy_));
 }
 
 MapClass::~MapClass() {
     if (cells_owned_ && cells_ != nullptr) {
-        delete[] cells_;
+        Free_Cell_Array(cells_);
         cells_ = nullptr;
     }
+    delete layers_;
+    layers_ = nullptr;
+    delete zones_;
+    zones_ = nullptr;
+    delete vision_;
+    vision_ = nullptr;
+    delete build_;
+    build_ = nullptr;
+    delete tiberium_;
+    tiberium_ = nullptr;
+    delete ore_fields_;
+    ore_fields_ = nullptr;
 }
 
 // =============================================================================
@@ -69,24 +102,68 @@ void MapClass::One_Time() {
     // Call base class first
     GScreenClass::One_Time();
 
-    // Allocate cell array
-    if (cells_ == nullptr) {
-        cells_ = new CellClass[MAP_CELL_TOTAL];
-        cells_owned_ = true;
+    if (Alloc_Cells()) {
+        Platform_LogInfo("MapClass::One_Time: Cells allocated");
+    }
+}
 
-        if (cells_ == nullptr) {
-            Platform_LogError("MapClass::One_Time: Failed to allocate cells");
-            return;
-        }
+// The cell array is scanned every tick, so it is one large-page block
+// (when the platform has them) rather than a plain new[]
+CellClass* MapClass::Alloc_Cell_Array() {
+    void* block = LargePages::instance().allocate(sizeof(CellClass) * MAP_CELL_TOTAL, "Map cells");
+    if (block == nullptr) {
+        return nullptr;
+    }
+    CellClass* cells = static_cast<CellClass*>(block);
+    for (int i = 0; i < MAP_CELL_TOTAL; i++) {
+        new (cells + i) CellClass();
+    }
+    return cells;
+}
 
-        // Initialize all cells
-        for (int i = 0; i < MAP_CELL_TOTAL; i++) {
-            cells_[i].Clear();
-            cells_[i].Set_Cell_Index((CELL)i);
-        }
+void MapClass::Free_Cell_Array(CellClass* cells) {
+    for (int i = 0; i < MAP_CELL_TOTAL; i++) {
+        cells[i].~CellClass();
+    }
+    Platform_Free(cells, sizeof(CellClass) * MAP_CELL_TOTAL);
+}
 
-        Platform_LogInfo("MapClass::One_Time: Cells allocated");
+bool MapClass::Alloc_Cells() {
+    if (cells_ != nullptr) {
+        return true;
+    }
+
+    cells_ = Alloc_Cell_Array();
+    cells_owned_ = true;
+
+    if (cells_ == nullptr) {
+        Platform_LogError("MapClass::Alloc_Cells: Failed to allocate cells");
+        return false;
+    }
+
+    if (layers_ == nullptr) {
+        layers_ = new CellLayers();
+        cell_hash_ = Recompute_Cell_Hash();
+    }
+    if (zones_ == nullptr) {
+        zones_ = new ZoneMap();
+    }
+    if (vision_ == nullptr) {
+        vision_ = new VisionMap();
+    }
+    if (build_ == nullptr) {
+        build_ = new BuildMap();
     }
+    if (tiberium_ == nullptr) {
+        tiberium_ = new TiberiumGrowth();
+    }
+    if (ore_fields_ == nullptr) {
+        ore_fields_ = new OreFields();
+    }
+
+    // Initialize all cells
+    Clear_Map();
+    return true;
 }
 
 void MapClass::Init(int theater) {
@@ -123,10 +200,10 @@ CellClass& MapClass::operator[](CELL cell) {
     if (!Is_Valid_Cell(cell) || cells_ == nullptr) {
         return dummy_cell_;
     }
-    // Convert CELL format (Y<<8|X) to array index (Y*128+X)
+    // Convert CELL format (Y<<8|X) to array index
     int x = Cell_X(cell);
     int y = Cell_Y(cell);
-    return cells_[y * MAP_CELL_WIDTH + x];
+    return cells_[Cell_Storage_Index(x, y)];
 }
 
 const CellClass& MapClass::operator[](CELL cell) const {
@@ -135,21 +212,21 @@ const CellClass& MapClass::operator[](CELL cell) const {
     }
     int x = Cell_X(cell);
     int y = Cell_Y(cell);
-    return cells_[y * MAP_CELL_WIDTH + x];
+    return cells_[Cell_Storage_Index(x, y)];
 }
 
 CellClass* MapClass::Cell_At(int x, int y) {
     if (!Is_Valid_XY(x, y) || cells_ == nullptr) {
         return nullptr;
     }
-    return &cells_[y * MAP_CELL_WIDTH + x];
+    return &cells_[Cell_Storage_Index(x, y)];
 }
 
 const CellClass* MapClass::Cell_At(int x, int y) const {
     if (!Is_Valid_XY(x, y) || cells_ == nullptr) {
         return nullptr;
     }
-    return &cells_[y * MAP_CELL_WIDTH + x];
+    return &cells_[Cell_Storage_Index(x, y)];
 }
 
 CellClass* MapClass::Get_Cell_At_Coord(COORDINATE coord) {
@@ -193,6 +270,11 @@ void MapClass::Set_Map_Bounds(int x, int y, int w, int h) {
     map_y_ = y;
     map_width_ = w;
     map_height_ = h;
+    land_revision_++;
+    Rebuild_Zones();
+    if (build_ != nullptr) {
+        build_->Set_Bounds(map_x_, map_y_, map_width_, map_height_);
+    }
 
     Platform_LogInfo("MapClass: Bounds set");
 }
@@ -232,10 +314,52 @@ void MapClass::Clear_Map() {
         return;
     }
 
-    for (int i = 0; i < MAP_CELL_TOTAL; i++) {
-        cells_[i].Clear();
-        cells_[i].Set_Cell_Index((CELL)i);
+    // Storage order depends on the layout, so index cells by X,Y
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            CellClass& cell = cells_[Cell_Storage_Index(x, y)];
+            cell.Clear();
+            cell.Set_Cell_Index(XY_Cell(x, y));
+        }
+    }
+
+    // Cleared cells hold no objects and nobody has seen them
+    memset(block_occupancy_, 0, sizeof(block_occupancy_));
+    overflow_.clear();
+    if (vision_ != nullptr) {
+        vision_->Clear();
+    }
+    if (build_ != nullptr) {
+        build_->Clear();
+        build_->Set_Bounds(map_x_, map_y_, map_width_, map_height_);
+    }
+
+    Sync_All_Layers();
+    Flag_All_Cells_Changed();
+}
+
+void MapClass::Load_Cells(const uint8_t* templates, const uint8_t* icons,
+                          const uint8_t* overlays, const uint8_t* overlay_data,
+                          const uint8_t* visibility) {
+    if (cells_ == nullptr) {
+        return;
+    }
+
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            int index = Layer_Index(x, y);
+            CellClass& cell = cells_[Cell_Storage_Index(x, y)];
+            cell.Load_Terrain(templates[index], icons[index],
+                              static_cast<OverlayType>(static_cast<int8_t>(overlays[index])),
+                              overlay_data[index]);
+            if (visibility != nullptr) {
+                cell.Load_Visibility(static_cast<CellVisibility>(visibility[index]));
+            }
+        }
     }
+
+    Sync_All_Layers();
+    Flag_All_Cells_Changed();
 }
 
 void MapClass::Recalc_All() {
@@ -246,9 +370,480 @@ void MapClass::Recalc_All() {
     // Iterate through all cells in bounds and recalculate
     for (int y = map_y_; y < map_y_ + map_height_; y++) {
         for (int x = map_x_; x < map_x_ + map_width_; x++) {
-            cells_[y * MAP_CELL_WIDTH + x].Recalc();
+            cells_[Cell_Storage_Index(x, y)].Recalc();
+        }
+    }
+
+    Sync_All_Layers();
+}
+
+void MapClass::Reveal_Area(CELL center, int radius, bool make_visible) {
+    if (!Is_Valid_Cell(center) || cells_ == nullptr || radius < 0) {
+        return;
+    }
+
+    int cx = Cell_X(center);
+    int cy = Cell_Y(center);
+    int x1 = std::max(0, cx - radius);
+    int y1 = std::max(0, cy - radius);
+    int x2 = std::min(MAP_CELL_WIDTH - 1, cx + radius);
+    int y2 = std::min(MAP_CELL_HEIGHT - 1, cy + radius);
+    int radius_sq = radius * radius;
+
+    for (int y = y1; y <= y2; y++) {
+        int dy = y - cy;
+        for (int x = x1; x <= x2; x++) {
+            int dx = x - cx;
+            if (dx * dx + dy * dy <= radius_sq) {
+                cells_[Cell_Storage_Index(x, y)].Reveal(make_visible);
+            }
+        }
+    }
+}
+
+// =============================================================================
+// Vision
+// =============================================================================
+
+void MapClass::Update_Vision(HousesType player) {
+    if (vision_ == nullptr) {
+        return;
+    }
+
+    bool tracked = cells_ != nullptr && player >= 0 && player < HOUSE_COUNT;
+    uint64_t before[VisionMap::PLANE_WORDS];
+    if (tracked) {
+        memcpy(before, vision_->Get_Visible(player), sizeof(before));
+    }
+
+    uint32_t rebuilt = vision_->Update();
+    if (!tracked || (rebuilt & (1u << player)) == 0) {
+        return;
+    }
+
+    const uint64_t* after = vision_->Get_Visible(player);
+    for (int word = 0; word < VisionMap::PLANE_WORDS; word++) {
+        uint64_t gained = after[word] & ~before[word];
+        uint64_t lost = before[word] & ~after[word];
+        uint64_t changed = gained | lost;
+        while (changed != 0) {
+            int bit = __builtin_ctzll(changed);
+            int x = (word % VisionMap::ROW_WORDS) * 64 + bit;
+            int y = word / VisionMap::ROW_WORDS;
+            CellClass& cell = cells_[Cell_Storage_Index(x, y)];
+            if ((gained >> bit) & 1) {
+                cell.Reveal(true);
+            } else {
+                cell.Shroud();
+            }
+            changed &= changed - 1;
+        }
+    }
+}
+
+// =============================================================================
+// Tiberium
+// =============================================================================
+
+void MapClass::Grow_Tiberium() {
+    if (tiberium_ != nullptr && cells_ != nullptr) {
+        tiberium_->Update(*this);
+    }
+}
+
+// =============================================================================
+// Object Occupancy
+// =============================================================================
+
+namespace {
+
+inline int Block_Index(int x, int y) {
+    return (y >> CELL_TILE_SHIFT) * CELL_TILES_PER_ROW + (x >> CELL_TILE_SHIFT);
+}
+
+} // namespace
+
+void MapClass::Occupy_Cell(CELL cell, ObjectClass* obj) {
+    if (!Is_Valid_Cell(cell) || cells_ == nullptr || obj == nullptr) {
+        return;
+    }
+
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    CellClass& target = cells_[Cell_Storage_Index(x, y)];
+    if (!target.Add_Object(obj)) {
+        overflow_.push_back({cell, obj});
+    }
+    block_occupancy_[Block_Index(x, y)]++;
+    if (build_ != nullptr) {
+        build_->Occupied_Changed(x, y, !target.Is_Clear_To_Build());
+    }
+}
+
+void MapClass::Vacate_Cell(CELL cell, ObjectClass* obj) {
+    if (!Is_Valid_Cell(cell) || cells_ == nullptr || obj == nullptr) {
+        return;
+    }
+
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    CellClass& target = cells_[Cell_Storage_Index(x, y)];
+    bool removed = target.Remove_Object(obj);
+    if (!removed) {
+        for (size_t i = 0; i < overflow_.size(); i++) {
+            if (overflow_[i].cell == cell && overflow_[i].object == obj) {
+                overflow_[i] = overflow_.back();
+                overflow_.pop_back();
+                removed = true;
+                break;
+            }
+        }
+    }
+    if (removed) {
+        block_occupancy_[Block_Index(x, y)]--;
+    }
+    if (build_ != nullptr) {
+        build_->Occupied_Changed(x, y, !target.Is_Clear_To_Build());
+    }
+}
+
+int MapClass::Get_Block_Occupancy(int x, int y) const {
+    if (!Is_Valid_XY(x, y)) {
+        return 0;
+    }
+    return block_occupancy_[Block_Index(x, y)];
+}
+
+int MapClass::Objects_In_Radius(COORDINATE coord, int range, std::vector<ObjectClass*>& out,
+                                ObjectFilter filter) const {
+    if (cells_ == nullptr || coord == COORD_NONE || range < 0) {
+        return 0;
+    }
+
+    size_t first = out.size();
+    auto consider = [&](ObjectClass* obj) {
+        if (Coord_Distance(coord, obj->Get_Coord()) <= range && (!filter || filter(obj))) {
+            out.push_back(obj);
+        }
+    };
+
+    // Coord_Distance never undercuts the larger axis distance, so the
+    // square of cells around coord holds every match
+    int lx = Coord_X(coord);
+    int ly = Coord_Y(coord);
+    int x1 = std::max(0, (lx - range) >> LEPTON_SHIFT);
+    int y1 = std::max(0, (ly - range) >> LEPTON_SHIFT);
+    int x2 = std::min(MAP_CELL_WIDTH - 1, (lx + range) >> LEPTON_SHIFT);
+    int y2 = std::min(MAP_CELL_HEIGHT - 1, (ly + range) >> LEPTON_SHIFT);
+
+    for (int by = y1 >> CELL_TILE_SHIFT; by <= y2 >> CELL_TILE_SHIFT; by++) {
+        for (int bx = x1 >> CELL_TILE_SHIFT; bx <= x2 >> CELL_TILE_SHIFT; bx++) {
+            if (block_occupancy_[by * CELL_TILES_PER_ROW + bx] == 0) {
+                continue;
+            }
+
+            int cy1 = std::max(y1, by << CELL_TILE_SHIFT);
+            int cy2 = std::min(y2, (by << CELL_TILE_SHIFT) + CELL_TILE_MASK);
+            int cx1 = std::max(x1, bx << CELL_TILE_SHIFT);
+            int cx2 = std::min(x2, (bx << CELL_TILE_SHIFT) + CELL_TILE_MASK);
+            for (int y = cy1; y <= cy2; y++) {
+                for (int x = cx1; x <= cx2; x++) {
+                    const CellClass& cell = cells_[Cell_Storage_Index(x, y)];
+                    for (int i = 0; i < CELL_MAX_OBJECTS; i++) {
+                        ObjectClass* obj = cell.Get_Object(i);
+                        if (obj == nullptr) {
+                            break;  // Slots are packed
+                        }
+                        consider(obj);
+                    }
+                }
+            }
         }
     }
+
+    for (const OverflowEntry& entry : overflow_) {
+        int x = Cell_X(entry.cell);
+        int y = Cell_Y(entry.cell);
+        if (x >= x1 && x <= x2 && y >= y1 && y <= y2) {
+            consider(entry.object);
+        }
+    }
+
+    return static_cast<int>(out.size() - first);
+}
+
+// =============================================================================
+// Cell Storage Layout
+// =============================================================================
+
+void MapClass::Set_Cell_Layout(CellLayoutType layout) {
+    if (layout == cell_layout_) {
+        return;
+    }
+
+    if (cells_ == nullptr) {
+        cell_layout_ = layout;
+        return;
+    }
+
+    // Permute existing cells into the new order
+    CellClass* reordered = Alloc_Cell_Array();
+    if (reordered == nullptr) {
+        Platform_LogError("MapClass::Set_Cell_Layout: Failed to allocate cells");
+        return;
+    }
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            reordered[Storage_Index(layout, x, y)] = cells_[Cell_Storage_Index(x, y)];
+        }
+    }
+
+    if (cells_owned_) {
+        Free_Cell_Array(cells_);
+    }
+    cells_ = reordered;
+    cells_owned_ = true;
+    cell_layout_ = layout;
+}
+
+// =============================================================================
+// Packed Cell Layers
+// =============================================================================
+
+void MapClass::Sync_Cell_Layers(CELL cell) {
+    if (layers_ == nullptr || cells_ == nullptr || !Is_Valid_Cell(cell)) {
+        return;
+    }
+
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    uint8_t old_vis = Copy_Cell_Fields(x, y);
+    uint8_t new_vis = layers_->visibility[Layer_Index(x, y)];
+    if (old_vis != new_vis) {
+        Update_Edge_Masks(x, y, old_vis, new_vis);
+    }
+}
+
+void MapClass::Sync_All_Layers() {
+    if (layers_ == nullptr || cells_ == nullptr) {
+        return;
+    }
+
+    // One relabel at the end instead of one per changed cell
+    if (zones_ != nullptr) {
+        zones_->Invalidate();
+    }
+
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            Copy_Cell_Fields(x, y);
+        }
+    }
+    Rebuild_Edge_Masks();
+    Rebuild_Zones();
+    land_revision_++;
+}
+
+uint64_t MapClass::Recompute_Cell_Hash() const {
+    if (layers_ == nullptr) {
+        return 0;
+    }
+    uint64_t hash = 0;
+    for (int index = 0; index < MAP_CELL_TOTAL; index++) {
+        hash ^= StateHash::Cell_Term(index, layers_->template_type[index], layers_->icon[index],
+                                     layers_->overlay[index], layers_->overlay_data[index]);
+    }
+    return hash;
+}
+
+void MapClass::Rebuild_Zones() {
+    if (zones_ == nullptr || layers_ == nullptr) {
+        return;
+    }
+    zones_->Rebuild(layers_->land, map_x_, map_y_, map_x_ + map_width_ - 1, map_y_ + map_height_ - 1);
+}
+
+uint8_t MapClass::Copy_Cell_Fields(int x, int y) {
+    // Re-read our own cell; the caller may be a cell outside this map
+    const CellClass& c = cells_[Cell_Storage_Index(x, y)];
+    int index = Layer_Index(x, y);
+    uint8_t old_vis = layers_->visibility[index];
+    uint8_t overlay = (uint8_t)c.Get_Overlay();
+
+    // Swap this cell's state hash term, old fields out and new in
+    if (layers_->template_type[index] != c.Get_Template() || layers_->icon[index] != c.Get_Icon() ||
+        layers_->overlay[index] != overlay || layers_->overlay_data[index] != c.Get_Overlay_Data()) {
+        cell_hash_ ^= StateHash::Cell_Term(index, layers_->template_type[index], layers_->icon[index],
+                                           layers_->overlay[index], layers_->overlay_data[index]) ^
+                      StateHash::Cell_Term(index, c.Get_Template(), c.Get_Icon(),
+                                           overlay, c.Get_Overlay_Data());
+    }
+
+    layers_->template_type[index] = c.Get_Template();
+    layers_->icon[index] = c.Get_Icon();
+    layers_->overlay_data[index] = c.Get_Overlay_Data();
+    if (layers_->overlay[index] != overlay) {
+        if (tiberium_ != nullptr) {
+            tiberium_->Overlay_Changed(XY_Cell(x, y), layers_->overlay[index], overlay);
+        }
+        if (ore_fields_ != nullptr) {
+            ore_fields_->Overlay_Changed(XY_Cell(x, y), layers_->overlay[index], overlay);
+        }
+        layers_->overlay[index] = overlay;
+    }
+    uint8_t land = (uint8_t)c.Get_Land();
+    if (layers_->land[index] != land) {
+        uint8_t old_land = layers_->land[index];
+        layers_->land[index] = land;
+        land_revision_++;
+        if (zones_ != nullptr) {
+            zones_->Land_Changed(x, y, old_land, land);
+        }
+        if (build_ != nullptr) {
+            build_->Land_Changed(x, y, static_cast<LandType>(land));
+        }
+    }
+    layers_->visibility[index] = (uint8_t)c.Get_Visibility();
+    return old_vis;
+}
+
+uint8_t MapClass::Get_Shroud_Edge(int x, int y) const {
+    if (layers_ == nullptr || !Is_Valid_XY(x, y)) {
+        return 0;
+    }
+    return layers_->shroud_edge[Layer_Index(x, y)];
+}
+
+uint8_t MapClass::Get_Fog_Edge(int x, int y) const {
+    if (layers_ == nullptr || !Is_Valid_XY(x, y)) {
+        return 0;
+    }
+    return layers_->fog_edge[Layer_Index(x, y)];
+}
+
+// Neighbour offsets in FacingType order
+static const int EDGE_DX[FACING_COUNT] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const int EDGE_DY[FACING_COUNT] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+void MapClass::Update_Edge_Masks(int x, int y, uint8_t old_vis, uint8_t new_vis) {
+    bool shroud_changed = (old_vis == CELL_SHROUD) != (new_vis == CELL_SHROUD);
+    bool fog_changed = (old_vis != CELL_VISIBLE) != (new_vis != CELL_VISIBLE);
+    if (!shroud_changed && !fog_changed) {
+        return;
+    }
+
+    for (int facing = 0; facing < FACING_COUNT; facing++) {
+        int nx = x + EDGE_DX[facing];
+        int ny = y + EDGE_DY[facing];
+        if (!Is_Valid_XY(nx, ny)) {
+            continue;
+        }
+
+        // The neighbour sees this cell from the opposite direction
+        int index = Layer_Index(nx, ny);
+        uint8_t bit = (uint8_t)(1 << ((facing + 4) & 7));
+        uint8_t old_shroud = layers_->shroud_edge[index];
+        uint8_t old_fog = layers_->fog_edge[index];
+
+        if (shroud_changed) {
+            if (new_vis == CELL_SHROUD) {
+                layers_->shroud_edge[index] |= bit;
+            } else {
+                layers_->shroud_edge[index] &= (uint8_t)~bit;
+            }
+        }
+        if (fog_changed) {
+            if (new_vis != CELL_VISIBLE) {
+                layers_->fog_edge[index] |= bit;
+            } else {
+                layers_->fog_edge[index] &= (uint8_t)~bit;
+            }
+        }
+
+        // Shrouded neighbours draw solid black; edges don't show there
+        bool changed = layers_->shroud_edge[index] != old_shroud ||
+                       layers_->fog_edge[index] != old_fog;
+        if (changed && layers_->visibility[index] != CELL_SHROUD) {
+            changed_cells_[index >> 6] |= (uint64_t)1 << (index & 63);
+            any_cell_changed_ = true;
+        }
+    }
+}
+
+void MapClass::Rebuild_Edge_Masks() {
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            uint8_t shroud = 0;
+            uint8_t fog = 0;
+            for (int facing = 0; facing < FACING_COUNT; facing++) {
+                int nx = x + EDGE_DX[facing];
+                int ny = y + EDGE_DY[facing];
+                if (!Is_Valid_XY(nx, ny)) {
+                    continue;
+                }
+                uint8_t vis = layers_->visibility[Layer_Index(nx, ny)];
+                if (vis == CELL_SHROUD) shroud |= (uint8_t)(1 << facing);
+                if (vis != CELL_VISIBLE) fog |= (uint8_t)(1 << facing);
+            }
+            int index = Layer_Index(x, y);
+            layers_->shroud_edge[index] = shroud;
+            layers_->fog_edge[index] = fog;
+        }
+    }
+}
+
+bool MapClass::Is_Cell_Passable(int x, int y, bool is_naval, bool is_infantry) const {
+    if (!Is_Valid_XY(x, y)) {
+        return false;
+    }
+    if (layers_ == nullptr) {
+        return cells_ != nullptr &&
+               cells_[Cell_Storage_Index(x, y)].Is_Passable(is_naval, is_infantry);
+    }
+    return CellClass::Is_Land_Passable((LandType)(int8_t)layers_->land[Layer_Index(x, y)],
+                                       is_naval, is_infantry);
+}
+
+// =============================================================================
+// Change Tracking
+// =============================================================================
+
+void MapClass::Flag_Cell_Changed(CELL cell) {
+    if (!Is_Valid_Cell(cell)) {
+        return;
+    }
+    int index = Cell_Y(cell) * MAP_CELL_WIDTH + Cell_X(cell);
+    changed_cells_[index >> 6] |= (uint64_t)1 << (index & 63);
+    any_cell_changed_ = true;
+
+    Sync_Cell_Layers(cell);
+}
+
+void MapClass::Flag_All_Cells_Changed() {
+    memset(changed_cells_, 0xFF, sizeof(changed_cells_));
+    any_cell_changed_ = true;
+}
+
+bool MapClass::Is_Cell_Changed(CELL cell) const {
+    if (!Is_Valid_Cell(cell)) {
+        return false;
+    }
+    return Is_Cell_Changed(Cell_X(cell), Cell_Y(cell));
+}
+
+bool MapClass::Is_Cell_Changed(int x, int y) const {
+    if (!Is_Valid_XY(x, y)) {
+        return false;
+    }
+    int index = y * MAP_CELL_WIDTH + x;
+    return (changed_cells_[index >> 6] >> (index & 63)) & 1;
+}
+
+void MapClass::Clear_Changed_Cells() {
+    if (any_cell_changed_) {
+        memset(changed_cells_, 0, sizeof(changed_cells_));
+        any_cell_changed_ = false;
+    }
 }
 
 // =============================================================================
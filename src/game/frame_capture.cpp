@@ -0,0 +1,276 @@
+/**
+ * FrameCapture Implementation
+ */
+
+#include "game/frame_capture.h"
+#include "game/io/lzo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+FrameCapture& FrameCapture::Instance() {
+    static FrameCapture instance;
+    return instance;
+}
+
+FrameCapture::~FrameCapture() {
+    Stop();
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+bool FrameCapture::Start(const char* path, int width, int height) {
+    if (Is_Recording() || !path || width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) {
+        return false;
+    }
+
+    PlatformFile* file = Platform_File_Open(path, FILE_MODE_WRITE);
+    if (file == nullptr) {
+        return false;
+    }
+    CaptureHeader header = {CAPTURE_MAGIC, CAPTURE_VERSION, static_cast<uint16_t>(width),
+                            static_cast<uint16_t>(height), KEY_INTERVAL};
+    if (Platform_File_Write(file, &header, sizeof(header)) != static_cast<int32_t>(sizeof(header))) {
+        Platform_File_Close(file);
+        return false;
+    }
+
+    // Everything a frame needs is allocated here, not while playing
+    size_t frame_size = static_cast<size_t>(width) * height;
+    for (Slot& slot : ring_) {
+        slot.pixels.assign(frame_size, 0);
+    }
+    previous_.assign(frame_size, 0);
+    delta_.assign(frame_size, 0);
+    packed_.assign(LZO_Max_Compressed_Size(static_cast<int>(frame_size)), 0);
+    dict_.assign(LZO_DICT_SIZE, 0);
+    memset(last_palette_, 0, sizeof(last_palette_));
+    frames_encoded_ = 0;
+
+    file_ = file;
+    path_ = path;
+    width_ = width;
+    height_ = height;
+    head_ = tail_ = queued_ = 0;
+    stopping_ = false;
+    stats_ = {};
+    encoder_ = std::thread(&FrameCapture::Encoder_Main, this);
+    return true;
+}
+
+void FrameCapture::Stop() {
+    if (!Is_Recording()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    encoder_.join();
+
+    Platform_File_Close(file_);
+    file_ = nullptr;
+
+    char msg[700];
+    snprintf(msg, sizeof(msg), "Frame capture: %u frames (%u dropped), %.1f MB, %.2f ms encode each, to %s",
+             stats_.written, stats_.dropped, stats_.bytes_written / (1024.0 * 1024.0),
+             stats_.written > 0 ? stats_.encode_ms / stats_.written : 0.0, path_.c_str());
+    Platform_LogInfo(msg);
+}
+
+bool FrameCapture::Capture(const uint8_t* pixels, int pitch, const PaletteEntry* palette, uint32_t time_ms) {
+    if (!Is_Recording() || pixels == nullptr) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_ == RING_FRAMES) {
+            stats_.dropped++;
+            return false;
+        }
+    }
+
+    // The encoder doesn't touch this slot until it is counted in queued_
+    Slot& slot = ring_[head_];
+    if (pitch == width_) {
+        memcpy(slot.pixels.data(), pixels, slot.pixels.size());
+    } else {
+        for (int y = 0; y < height_; y++) {
+            memcpy(slot.pixels.data() + static_cast<size_t>(y) * width_,
+                   pixels + static_cast<size_t>(y) * pitch, width_);
+        }
+    }
+    if (palette != nullptr) {
+        memcpy(slot.palette, palette, sizeof(slot.palette));
+    } else {
+        memcpy(slot.palette, last_palette_, sizeof(slot.palette));
+    }
+    slot.time_ms = time_ms;
+    head_ = (head_ + 1) % RING_FRAMES;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_++;
+        stats_.captured++;
+    }
+    wake_.notify_one();
+    return true;
+}
+
+bool FrameCapture::Capture_Screen(uint32_t time_ms) {
+    uint8_t* buffer = nullptr;
+    int32_t width = 0, height = 0, pitch = 0;
+    if (!Is_Recording() || Platform_Graphics_GetBackBuffer(&buffer, &width, &height, &pitch) != 0 ||
+        width != width_ || height != height_) {
+        return false;
+    }
+
+    PaletteEntry palette[256];
+    Platform_Graphics_GetPalette(palette, 0, 256);
+    return Capture(buffer, pitch, palette, time_ms);
+}
+
+FrameCapture::Stats FrameCapture::Get_Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// =============================================================================
+// Encoding
+// =============================================================================
+
+void FrameCapture::Encoder_Main() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return queued_ > 0 || stopping_; });
+            if (queued_ == 0) {
+                return;     // Stopping, and everything queued is written
+            }
+        }
+
+        Encode(ring_[tail_]);
+        tail_ = (tail_ + 1) % RING_FRAMES;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_--;
+    }
+}
+
+void FrameCapture::Encode(const Slot& slot) {
+    auto start = std::chrono::steady_clock::now();
+    int size = static_cast<int>(slot.pixels.size());
+
+    CaptureFrameHeader header = {};
+    header.time_ms = slot.time_ms;
+    bool key = frames_encoded_ % KEY_INTERVAL == 0;
+    if (key) {
+        header.flags |= CAPTURE_FRAME_KEY;
+    }
+    if (key || memcmp(slot.palette, last_palette_, sizeof(last_palette_)) != 0) {
+        header.flags |= CAPTURE_FRAME_PALETTE;
+    }
+
+    // What didn't change since the last frame turns into zeros
+    const uint8_t* source = slot.pixels.data();
+    if (!key) {
+        for (int i = 0; i < size; i++) {
+            delta_[i] = slot.pixels[i] ^ previous_[i];
+        }
+        source = delta_.data();
+    }
+    int packed = LZO_Compress(source, size, packed_.data(), dict_.data());
+    header.size = static_cast<uint32_t>(packed);
+
+    bool ok = Platform_File_Write(file_, &header, sizeof(header)) == static_cast<int32_t>(sizeof(header));
+    if (ok && (header.flags & CAPTURE_FRAME_PALETTE)) {
+        ok = Platform_File_Write(file_, slot.palette, sizeof(slot.palette)) ==
+             static_cast<int32_t>(sizeof(slot.palette));
+    }
+    ok = ok && Platform_File_Write(file_, packed_.data(), packed) == packed;
+
+    memcpy(previous_.data(), slot.pixels.data(), slot.pixels.size());
+    memcpy(last_palette_, slot.palette, sizeof(last_palette_));
+    frames_encoded_++;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.encode_ms += ms;
+    if (ok) {
+        stats_.written++;
+        stats_.bytes_written += sizeof(header) + packed +
+                                ((header.flags & CAPTURE_FRAME_PALETTE) ? sizeof(slot.palette) : 0);
+    }
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+bool FrameCaptureReader::Open(const char* path) {
+    Close();
+    file_ = path ? Platform_File_Open(path, FILE_MODE_READ) : nullptr;
+    if (file_ == nullptr) {
+        return false;
+    }
+
+    if (Platform_File_Read(file_, &header_, sizeof(header_)) != static_cast<int32_t>(sizeof(header_)) ||
+        header_.magic != CAPTURE_MAGIC || header_.version != CAPTURE_VERSION ||
+        header_.width == 0 || header_.height == 0) {
+        Close();
+        return false;
+    }
+
+    size_t frame_size = static_cast<size_t>(header_.width) * header_.height;
+    pixels_.assign(frame_size, 0);
+    delta_.assign(frame_size, 0);
+    return true;
+}
+
+void FrameCaptureReader::Close() {
+    if (file_ != nullptr) {
+        Platform_File_Close(file_);
+        file_ = nullptr;
+    }
+    header_ = {};
+}
+
+bool FrameCaptureReader::Next() {
+    CaptureFrameHeader header;
+    if (file_ == nullptr ||
+        Platform_File_Read(file_, &header, sizeof(header)) != static_cast<int32_t>(sizeof(header))) {
+        return false;
+    }
+    if ((header.flags & CAPTURE_FRAME_PALETTE) &&
+        Platform_File_Read(file_, palette_, sizeof(palette_)) != static_cast<int32_t>(sizeof(palette_))) {
+        return false;
+    }
+
+    int size = static_cast<int>(pixels_.size());
+    if (header.size > static_cast<uint32_t>(LZO_Max_Compressed_Size(size))) {
+        return false;
+    }
+    packed_.resize(header.size);
+    if (Platform_File_Read(file_, packed_.data(), static_cast<int32_t>(header.size)) !=
+        static_cast<int32_t>(header.size)) {
+        return false;
+    }
+
+    bool key = (header.flags & CAPTURE_FRAME_KEY) != 0;
+    uint8_t* out = key ? pixels_.data() : delta_.data();
+    if (LZO_Decompress(packed_.data(), static_cast<int>(header.size), out, size) != size) {
+        return false;
+    }
+    if (!key) {
+        for (int i = 0; i < size; i++) {
+            pixels_[i] ^= delta_[i];
+        }
+    }
+    time_ms_ = header.time_ms;
+    return true;
+}
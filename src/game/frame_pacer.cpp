@@ -0,0 +1,104 @@
+/**
+ * Frame Pacer Implementation
+ */
+
+#include "game/frame_pacer.h"
+#include "platform.h"
+#include <algorithm>
+#include <thread>
+
+// Timer_Delay can overshoot by a scheduler quantum; the rest is spun
+static const uint64_t SPIN_US = 2000;
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+FramePacer::FramePacer()
+    : low_latency_(false)
+    , max_frames_queued_(1)
+    , margin_us_(DEFAULT_MARGIN_US)
+    , work_head_(0)
+    , work_count_(0)
+    , predicted_us_(0)
+    , next_present_us_(0)
+{
+}
+
+void FramePacer::Set_Low_Latency(bool enabled) {
+    low_latency_ = enabled;
+    Reset();
+}
+
+void FramePacer::Set_Max_Frames_Queued(int frames) {
+    max_frames_queued_ = std::max(1, std::min(frames, MAX_FRAMES_QUEUED));
+}
+
+void FramePacer::Reset() {
+    work_head_ = 0;
+    work_count_ = 0;
+    predicted_us_ = 0;
+    next_present_us_ = 0;
+}
+
+// =============================================================================
+// Pacing
+// =============================================================================
+
+uint64_t FramePacer::Get_Input_Wait_Us(uint64_t now_us, uint32_t period_us) const {
+    if (!low_latency_ || next_present_us_ == 0 || work_count_ == 0) {
+        return 0;
+    }
+
+    // Input must be in hand this long before the present is due
+    uint64_t lead = static_cast<uint64_t>(predicted_us_) + margin_us_ +
+                    static_cast<uint64_t>(max_frames_queued_ - 1) * period_us;
+    if (next_present_us_ <= now_us + lead) {
+        return 0;
+    }
+    return std::min<uint64_t>(next_present_us_ - lead - now_us, period_us);
+}
+
+uint64_t FramePacer::Wait_For_Input(uint32_t period_us) {
+    uint64_t start = Platform_Input_GetTimeUs();
+    uint64_t wait = Get_Input_Wait_Us(start, period_us);
+    if (wait == 0) {
+        return 0;
+    }
+
+    uint64_t wake = start + wait;
+    if (wait > SPIN_US) {
+        Platform_Timer_Delay(static_cast<uint32_t>((wait - SPIN_US) / 1000));
+    }
+    uint64_t now = Platform_Input_GetTimeUs();
+    while (now < wake) {
+        std::this_thread::yield();
+        now = Platform_Input_GetTimeUs();
+    }
+    return now - start;
+}
+
+void FramePacer::End_Frame(uint64_t now_us, uint32_t period_us, double work_ms, double present_ms) {
+    uint32_t work_us = work_ms > 0.0 ? static_cast<uint32_t>(work_ms * 1000.0) : 0;
+    work_us_[work_head_] = work_us;
+    work_head_ = (work_head_ + 1) % HISTORY;
+    if (work_count_ < HISTORY) {
+        work_count_++;
+    }
+
+    // A high percentile, so one slow frame in ten still makes its present
+    uint32_t sorted[HISTORY];
+    std::copy(work_us_, work_us_ + work_count_, sorted);
+    int index = work_count_ * 9 / 10;
+    std::nth_element(sorted, sorted + index, sorted + work_count_);
+    predicted_us_ = sorted[index];
+
+    // A present that waited returned at a refresh: lock the schedule to it.
+    // Otherwise keep the cadence, unless the frame ran past its slot.
+    bool blocked = present_ms * 1000.0 >= BLOCKED_PRESENT_US;
+    if (blocked || next_present_us_ == 0 || now_us >= next_present_us_ + period_us) {
+        next_present_us_ = now_us + period_us;
+    } else {
+        next_present_us_ += period_us;
+    }
+}
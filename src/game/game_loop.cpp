@@ -6,12 +6,55 @@
 
 #include "game/game.h"
 #include "game/object.h"
+#include "game/object_heap.h"
+#include "game/movement.h"
+#include "game/combat.h"
+#include "game/economy.h"
+#include "game/projectile.h"
+#include "game/splash_damage.h"
+#include "game/random.h"
+#include "game/replay.h"
+#include "game/resync.h"
+#include "game/job_system.h"
+#include "game/memory_budget.h"
+#include "game/quality_governor.h"
 #include "game/cell.h"
+#include "game/asset_loader.h"
+#include "game/asset_pack.h"
+#include "game/audio/audio_events.h"
+#include "game/audio/audio_system.h"
+#include "game/audio/music_player.h"
+#include "game/audio/sound_manager.h"
+#include "game/graphics/palette_manager.h"
+#include "game/graphics/radar_render.h"
+#include "game/graphics/render_pipeline.h"
+#include "game/graphics/shape_renderer.h"
 #include "game/graphics/tile_renderer.h"
+#include "game/mix_view.h"
+#include "game/scenario.h"
+#include "game/scenario_arena.h"
+#include "game/shared_asset_cache.h"
+#include "game/flow_field.h"
+#include "game/frame_capture.h"
+#include "game/frame_pacer.h"
+#include "game/sim_pipeline.h"
+#include "game/state_hash.h"
+#include "game/trigger.h"
 #include "game/ui/main_menu.h"
+#include "game/input/input_latency.h"
 #include "platform.h"
+#include "platform/profiler.h"
+#include "platform/memory_arena.h"
+#include "platform/alloc_tracker.h"
+#include "platform/large_pages.h"
+#include "platform/startup_trace.h"
+#include "platform/io_stats.h"
+#include "platform/sampling_profiler.h"
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <sstream>
 
 // =============================================================================
 // Game Speed Table
@@ -25,6 +68,41 @@ const uint32_t GameSpeedTicks[5] = {
     33      // GAME_SPEED_FASTEST - 30 FPS
 };
 
+// Scenario started from the main menu
+static const char* const DEFAULT_SCENARIO = "SCG01EA.INI";
+
+// Longest the load screen waits for the prefetch
+static const uint32_t LOAD_SCREEN_MAX_MS = 5000;
+
+// Startup work per frame once the menu shows, and longest the menu
+// sounds are waited for before audio counts as ready without them
+static const double DEFERRED_STARTUP_BUDGET_MS = 2.0;
+static const uint32_t MENU_SOUNDS_MAX_MS = 2000;
+
+// Kept loaded from the first menu frame on
+static const SoundEffect MENU_SOUNDS[] = {
+    SoundEffect::UI_CLICK, SoundEffect::UI_BEEP, SoundEffect::UI_CANCEL, SoundEffect::UI_ERROR,
+};
+
+// Scenario load work per frame, and objects created per step call
+static const double LOAD_STEP_BUDGET_MS = 8.0;
+static const size_t LOAD_OBJECTS_PER_STEP = 32;
+
+// Load screen progress bar
+static const int LOAD_BAR_X = 200;
+static const int LOAD_BAR_Y = 194;
+static const int LOAD_BAR_WIDTH = 240;
+static const int LOAD_BAR_HEIGHT = 12;
+
+// First-use recording covers the first minute of a mission (at normal speed)
+static const uint32_t FIRST_USE_LOG_TICKS = 60 * 1000 / 66;
+
+// Caches start giving memory back when the system has less than this free
+static const size_t MIN_FREE_RAM = 64 * 1024 * 1024;
+
+// Where F12 writes its sampling profile when no --sample-profile was given
+static const char* const DEFAULT_SAMPLE_PROFILE = "sample_profile.folded";
+
 // =============================================================================
 // Global Instance
 // =============================================================================
@@ -41,11 +119,20 @@ GameClass::GameClass()
     , is_initialized_(false)
     , frame_(0)
     , tick_(0)
-    , last_tick_time_(0)
+    , state_hash_(0)
     , last_frame_time_(0)
+    , render_alpha_(1.0f)
     , player_house_(HOUSE_GOOD)
     , display_(nullptr)
     , menu_(nullptr)
+    , ready_(0)
+    , startup_time_(0.0)
+    , load_map_(nullptr)
+    , load_next_object_(0)
+    , loading_start_time_(0)
+    , first_use_end_tick_(0)
+    , sample_path_(DEFAULT_SAMPLE_PROFILE)
+    , sample_rate_hz_(SamplingProfiler::DEFAULT_RATE_HZ)
 {
 }
 
@@ -54,29 +141,10 @@ GameClass::~GameClass() {
 }
 
 // =============================================================================
-// Lifecycle
+// MIX Registration
 // =============================================================================
 
-bool GameClass::Initialize() {
-    if (is_initialized_) {
-        return true;
-    }
-
-    Platform_LogInfo("GameClass::Initialize: Starting...");
-
-    // Initialize platform
-    if (Platform_Init() != PLATFORM_RESULT_SUCCESS) {
-        Platform_LogError("Failed to initialize platform");
-        return false;
-    }
-
-    // Register MIX files from gamedata directory
-    Platform_LogInfo("Registering MIX files...");
-
-    // Get the data path (should find gamedata directory)
-    char data_path[512];
-    Platform_GetDataPath(data_path, sizeof(data_path));
-
+int Game_Register_Mix_Files(const char* data_path) {
     char mix_path[512];
     int mix_count = 0;
 
@@ -111,10 +179,158 @@ bool GameClass::Initialize() {
     snprintf(mix_path, sizeof(mix_path), "%s/temperat.mix", data_path);
     Platform_Mix_Register(mix_path);
 
+    return mix_count;
+}
+
+// =============================================================================
+// Memory Budget
+// =============================================================================
+
+// Reload cost per byte, relative: cached MIX data falls back to the mapped
+// file, shapes and sounds decode again, tiles are redrawn every frame
+static void Register_Memory_Caches() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+    registered = true;
+
+    MemoryBudget& budget = MemoryBudget::Instance();
+    budget.Set_Min_Free_Ram(MIN_FREE_RAM);
+
+    budget.Register("MIX", 1,
+        []() { return static_cast<size_t>(Platform_Mix_GetCachedBytes()); },
+        [](size_t) { return static_cast<size_t>(Platform_Mix_ReleaseCaches()); });
+
+    budget.Register("Shapes", 2,
+        []() { return ShapeCache::Instance().GetMemoryUsage(); },
+        [](size_t bytes) { return ShapeCache::Instance().Release(bytes); });
+
+    // The audio thread mixes from these; hold its lock
+    budget.Register("Sounds", 4,
+        []() {
+            auto lock = AudioSystem::Instance().LockState();
+            return SoundManager::Instance().GetResidentBytes();
+        },
+        [](size_t bytes) {
+            auto lock = AudioSystem::Instance().LockState();
+            return SoundManager::Instance().Release(bytes);
+        });
+
+    budget.Register("Music", 4,
+        []() {
+            auto lock = AudioSystem::Instance().LockState();
+            return MusicPlayer::Instance().GetResidentBytes();
+        },
+        [](size_t bytes) {
+            auto lock = AudioSystem::Instance().LockState();
+            return MusicPlayer::Instance().Release(bytes);
+        });
+
+    // All or nothing; templates reload as they are next drawn
+    budget.Register("Tiles", 8,
+        []() { return TileRenderer::Instance().GetCacheSize(); },
+        [](size_t) {
+            size_t size = TileRenderer::Instance().GetCacheSize();
+            TileRenderer::Instance().ClearCache();
+            return size;
+        });
+}
+
+// Optional work the quality governor cuts when frames run over budget;
+// none of it changes the simulation
+static void Register_Quality_Knobs() {
+    QualityGovernor::Instance().Set_Apply([](const QualityGovernor::Knobs& knobs) {
+        ProjectileSystem::Instance().Set_Anim_Density(knobs.anim_density);
+        RenderPipeline& pipeline = RenderPipeline::Instance();
+        pipeline.SetShadowsEnabled(knobs.shadows);
+        if (pipeline.GetRadarRenderer() != nullptr) {
+            pipeline.GetRadarRenderer()->SetRefreshInterval(knobs.radar_interval);
+        }
+        PaletteManager::Instance().SetAnimationDivisor(knobs.palette_divisor);
+
+        auto lock = AudioSystem::Instance().LockState();
+        SoundManager::Instance().SetVoiceLimit(knobs.voice_limit);
+    });
+}
+
+// =============================================================================
+// Lifecycle
+// =============================================================================
+
+bool GameClass::Initialize() {
+    if (is_initialized_) {
+        return true;
+    }
+
+    Platform_LogInfo("GameClass::Initialize: Starting...");
+
+    // Time each step from here to the main menu (see --startup-report)
+    StartupTrace& startup = StartupTrace::instance();
+    if (!startup.is_active()) {
+        startup.start();
+    }
+    IoScope startup_io(IoTag::STARTUP);
+
+    // Initialize platform
+    {
+        STARTUP_PHASE("Platform Init");
+        if (Platform_Init() != PLATFORM_RESULT_SUCCESS) {
+            Platform_LogError("Failed to initialize platform");
+            startup.finish();
+            return false;
+        }
+    }
+    startup_time_ = Platform_Timer_GetTime();
+
+    // Register MIX files from gamedata directory
+    Platform_LogInfo("Registering MIX files...");
+
+    // Get the data path (should find gamedata directory)
+    char data_path[512];
+    Platform_GetDataPath(data_path, sizeof(data_path));
+    int mix_count;
+    {
+        STARTUP_PHASE("MIX Registration");
+        mix_count = Game_Register_Mix_Files(data_path);
+    }
+
     char msg[64];
     snprintf(msg, sizeof(msg), "Registered %d primary MIX files", mix_count);
     Platform_LogInfo(msg);
 
+    // Pre-decoded assets, if PackAssets has been run; the MIX files
+    // still serve anything the pack doesn't have
+    char pack_path[512];
+    snprintf(pack_path, sizeof(pack_path), "%s/%s", data_path, ASSET_PACK_FILENAME);
+    bool pack_open;
+    {
+        STARTUP_PHASE("Asset Pack");
+        pack_open = AssetPack::Instance().Open(pack_path);
+    }
+    if (pack_open) {
+        snprintf(msg, sizeof(msg), "Asset pack: %u entries",
+                 AssetPack::Instance().GetEntryCount());
+        Platform_LogInfo(msg);
+    }
+
+    // Otherwise, with --shared-assets, what earlier instances decoded
+    if (!pack_open) {
+        STARTUP_PHASE("Shared Assets");
+        SharedAssetCache::Instance().Open(data_path);
+    }
+
+    {
+        STARTUP_PHASE("Workers");
+
+        // Background asset loads need the archives registered first
+        AssetLoader::Instance().Start();
+
+        // Caches report to one budget from here on
+        Register_Memory_Caches();
+        Register_Quality_Knobs();
+    }
+
     // Create display
     display_ = new DisplayClass();
     if (display_ == nullptr) {
@@ -124,7 +340,10 @@ bool GameClass::Initialize() {
     }
 
     // Initialize display
-    display_->One_Time();
+    {
+        STARTUP_PHASE("Display");
+        display_->One_Time();
+    }
 
     // Set as global
     Display = display_;
@@ -132,14 +351,19 @@ bool GameClass::Initialize() {
     TheScreen = display_;
 
     // Initialize timing
-    last_tick_time_ = Platform_Timer_GetTicks();
-    last_frame_time_ = last_tick_time_;
+    last_frame_time_ = Platform_Timer_GetTicks();
+    tick_clock_.Reset(last_frame_time_);
     frame_ = 0;
     tick_ = 0;
 
     // Create and initialize main menu
     menu_ = std::make_unique<MainMenu>();
-    if (!menu_->Initialize()) {
+    bool menu_ready;
+    {
+        STARTUP_PHASE("Main Menu");
+        menu_ready = menu_->Initialize();
+    }
+    if (!menu_ready) {
         Platform_LogWarn("MainMenu initialization failed, using fallback");
         // Set a default palette so something is visible
         PaletteEntry default_palette[256];
@@ -154,9 +378,13 @@ bool GameClass::Initialize() {
         Platform_Graphics_SetPalette(default_palette, 0, 256);
     }
 
+    // Audio, network and the tick workers come up behind the menu
+    Defer_Startup();
+
     // Start in menu mode
     mode_ = GAME_MODE_MENU;
     is_initialized_ = true;
+    startup.finish();
 
     Platform_LogInfo("GameClass::Initialize: Complete");
     return true;
@@ -169,9 +397,51 @@ void GameClass::Shutdown() {
 
     Platform_LogInfo("GameClass::Shutdown: Starting...");
 
+    // Objects must not be ticking while they are torn down
+    Set_Pipelined(false);
+    JobSystem::Instance().Stop();
+
+    End_First_Use_Log();
+
+    if (SamplingProfiler::instance().is_running()) {
+        Toggle_Sample_Profile();
+    }
+
+    if (ReplayRecorder::Instance().Is_Recording()) {
+        if (!ReplayRecorder::Instance().Stop().Save(record_path_.c_str())) {
+            Platform_LogWarn("Failed to save replay");
+        }
+    }
+    ResyncLog::Instance().Stop();
+    FrameCapture::Instance().Stop();
+
+    MemoryBudget::Instance().Log_Report();
+
+    // Finish running loads; queued ones are dropped
+    AssetLoader::Instance().Stop();
+    SharedAssetCache::Instance().Save();
+    deferred_startup_.Clear();
+    ready_ = 0;
+
+    // A load cut short; its parallel steps have finished with the workers
+    scenario_load_.Clear();
+    load_ini_.Close();
+
+    // Drop everything that points into the asset pack before unmapping it
+    AudioSystem::Instance().Shutdown();
+    ShapeCache::Instance().Clear();
+    TileRenderer::Instance().ClearCache();
+    SharedAssetCache::Instance().Close();
+    AssetPack::Instance().Close();
+
     // Clean up main menu
     menu_.reset();
 
+    // Objects unmark their cells as they go, so free them before the map
+    End_Scenario();
+    ProjectileSystem::Instance().Clear();
+    SplashDamage::Instance().Clear();
+
     // Clean up display
     if (display_ != nullptr) {
         delete display_;
@@ -202,9 +472,46 @@ int GameClass::Run() {
 
     Platform_LogInfo("GameClass::Run: Entering main loop");
 
+    // Keep recent frame history and dump a trace when a frame hitches
+    Profiler& profiler = Profiler::instance();
+    profiler.enable_flight_recorder(10.0, 2.0 * Get_Tick_Interval());
+
     while (Is_Running()) {
         // Start frame timing
         Platform_Frame_Begin();
+        profiler.begin_frame();
+        GPUProfiler::instance().begin_frame();
+
+        // Low latency: the frame's idle time goes here, before input,
+        // instead of after the present
+        uint32_t period_us = 1000000 / std::max(Platform_Frame_GetTargetFPS(), 1u);
+        double pacing_wait_ms = 0.0;
+        if (frame_pacer_.Is_Low_Latency()) {
+            PROFILE_SCOPE("Pacing Wait");
+            pacing_wait_ms = frame_pacer_.Wait_For_Input(period_us) / 1000.0;
+        }
+
+        // Release last frame's scratch (render commands, temporaries)
+        FrameAllocator::instance().begin_frame();
+
+        {
+            AllocScope assets(AllocTag::ASSETS);
+
+            // Swap in theater tiles once the background decode finishes
+            TileRenderer::Instance().UpdateTheaterLoad();
+
+            // Install shapes, templates and sounds decoded by the asset loader
+            AssetLoader::Instance().Pump();
+            if (mode_ == GAME_MODE_LOADING) {
+                Update_Loading();
+            }
+            if (!deferred_startup_.Is_Done()) {
+                deferred_startup_.Pump(DEFERRED_STARTUP_BUDGET_MS);
+            }
+        }
+
+        // Listener and mixer metrics; nothing until audio is up
+        AudioSystem::Instance().Update();
 
         // Update input state BEFORE polling events
         // This saves current key state as previous, so we can detect "just pressed"
@@ -217,33 +524,151 @@ int GameClass::Run() {
         }
 
         // Process input (game-specific handling)
-        Process_Input();
+        {
+            PROFILE_SCOPE("Input");
+            Process_Input();
+        }
+
+        // The menu only changes on input; a background window runs slowly
+        bool static_screen = mode_ == GAME_MODE_MENU && deferred_startup_.Is_Done() &&
+                             AssetLoader::Instance().IsIdle();
+        bool draw = power_saver_.Begin_Frame(Platform_Timer_GetTicks(), Platform_IsAppBackground() != 0,
+                                             static_screen, Platform_GetEventCount());
 
         // Update logic (if time for tick)
         uint32_t now = Platform_Timer_GetTicks();
         uint32_t tick_interval = Get_Tick_Interval();
 
-        while (now - last_tick_time_ >= tick_interval) {
-            if (!Is_Paused() && mode_ == GAME_MODE_PLAYING) {
+        // Capped, so a stall slows the game down instead of stacking up ticks
+        uint32_t dropped_before = tick_clock_.Get_Dropped_Time();
+        int ticks = tick_clock_.Advance(now, tick_interval);
+        if (tick_clock_.Get_Dropped_Time() != dropped_before) {
+            profiler.increment_counter(PROFILE_ID("Ticks Dropped"));
+        }
+
+        bool simulating = !Is_Paused() && mode_ == GAME_MODE_PLAYING;
+
+        // Nothing moves while stopped, so draw exactly where things are
+        float alpha = simulating ? tick_clock_.Alpha(now, tick_interval) : 1.0f;
+
+        if (sim_pipeline_) {
+            // Gadgets are UI and stay on this thread
+            int sim_ticks = simulating ? ticks : 0;
+            for (int i = 0; i < sim_ticks && display_; i++) {
+                display_->Process_Gadgets(0);
+            }
+
+            // Terrain is read before the sim thread may touch the map
+            if (display_ && mode_ != GAME_MODE_MENU) {
+                display_->Prepare_Frame();
+            }
+
+            uint32_t tick_before = tick_;
+            if (sim_ticks > 0) {
+                sim_pipeline_->Kick(sim_ticks);
+            } else {
+                // Input may still have changed selection and the like
+                sim_pipeline_->Capture_Now(tick_);
+            }
+
+            // Draws the previous tick while the sim thread runs the next
+            if (draw) {
+                Render_Frame(alpha);
+            }
+
+            {
+                PROFILE_SCOPE("Sim Wait");
+                sim_pipeline_->Wait();
+            }
+            if (tick_before < first_use_end_tick_ && tick_ >= first_use_end_tick_) {
+                End_First_Use_Log();
+            }
+        } else {
+            for (int i = 0; i < ticks && simulating; i++) {
                 Update_Logic();
                 tick_++;
+                ReplayRecorder::Instance().End_Tick();
+                if (Map != nullptr) {
+                    ResyncLog::Instance().End_Tick(tick_, *Map);
+                }
+                if (tick_ == first_use_end_tick_) {
+                    End_First_Use_Log();
+                }
             }
-            last_tick_time_ += tick_interval;
-        }
 
-        // Render frame
-        Render_Frame();
+            if (draw) {
+                Render_Frame(alpha);
+            }
+        }
         frame_++;
         last_frame_time_ = now;
 
-        // End frame (may sleep for vsync)
+        // Split flip cost into upload/scale/present
+        GPUProfiler::instance().end_frame();
+
+        // Heap allocations per subsystem, as profiler counter tracks
+        AllocTracker::instance().end_frame();
+
+        // File and MIX bytes read per caller tag
+        IoStats::instance().end_frame();
+
+        // What idle frames save shows here
+        power_saver_.Sample_Cpu(StartupTrace::get_wall_ns(), StartupTrace::get_cpu_ns());
+        profiler.record_value(PROFILE_ID("CPU (ms/s)"), power_saver_.Get_Cpu_Ms_Per_Second());
+
+        // Cache sizes, trimmed to their budgets and the process cap
+        MemoryBudget::Instance().Update();
+
+        // Spike budget follows the game speed
+        profiler.set_spike_threshold_ms(2.0 * tick_interval);
+        profiler.end_frame();
+
+        // Cut or restore optional work to hold the frame rate
+        QualityGovernor& governor = QualityGovernor::Instance();
+        governor.Set_Budget_Ms(period_us / 1000.0);
+        governor.Update();
+
+        if (frame_pacer_.Is_Low_Latency()) {
+            double present_ms = GPUProfiler::instance().get_present_time_ms();
+            double work_ms = profiler.get_frame_time_ms() - pacing_wait_ms - present_ms;
+            frame_pacer_.End_Frame(Platform_Input_GetTimeUs(), period_us, work_ms, present_ms);
+        }
+
+        // Static screens and background windows sleep until an event or their next frame
+        uint32_t idle_ms = power_saver_.Get_Wait_Ms(Platform_Timer_GetTicks());
+        if (idle_ms > 0) {
+            Platform_WaitEvents(idle_ms);
+        }
+
+        // End frame (may sleep for vsync; never in low-latency mode)
         Platform_Frame_End();
+
+        // Frame-to-frame regularity, shown with the next frame's profile
+        FramePacingStats pacing;
+        Platform_Frame_GetPacingStats(&pacing);
+        if (pacing.frames > 0) {
+            profiler.record_histogram(PROFILE_ID("Frame Interval"), pacing.last_ms);
+            profiler.record_value(PROFILE_ID("Frame Interval StdDev"), pacing.stddev_ms);
+            profiler.record_value(PROFILE_ID("Pacing Spin (us)"), pacing.spin_us);
+        }
+
+        // This frame is on screen now: time the input it shows
+        if (draw) {
+            InputLatency::Instance().Present(Platform_Input_GetTimeUs());
+        }
     }
 
     Platform_LogInfo("GameClass::Run: Exiting main loop");
     return 0;
 }
 
+void GameClass::Set_Low_Latency(bool enabled) {
+    frame_pacer_.Set_Low_Latency(enabled);
+
+    // The pacer takes over the sleep that keeps the target FPS
+    Platform_Frame_SetLimiter(!enabled);
+}
+
 uint32_t GameClass::Get_Tick_Interval() const {
     if (speed_ < 0 || speed_ > GAME_SPEED_FASTEST) {
         return GameSpeedTicks[GAME_SPEED_NORMAL];
@@ -251,11 +676,115 @@ uint32_t GameClass::Get_Tick_Interval() const {
     return GameSpeedTicks[speed_];
 }
 
+// =============================================================================
+// Pipelining
+// =============================================================================
+
+void GameClass::Set_Pipelined(bool enabled) {
+    if (enabled == Is_Pipelined()) {
+        return;
+    }
+
+    // The render reads what the simulation thread wrote a frame earlier
+    FrameAllocator::instance().set_double_buffered(enabled);
+
+    if (!enabled) {
+        sim_pipeline_->Stop();
+        sim_pipeline_.reset();
+        if (display_) {
+            display_->Set_Object_Snapshot(nullptr, 1.0f);
+        }
+        Platform_LogInfo("GameClass: Simulation thread stopped");
+        return;
+    }
+
+    sim_pipeline_ = std::make_unique<SimPipeline>();
+    sim_pipeline_->Capture_Now(tick_);
+    sim_pipeline_->Start([this]() {
+        Update_Simulation();
+        ReplayRecorder::Instance().End_Tick();
+        uint32_t tick = ++tick_;
+        if (Map != nullptr) {
+            ResyncLog::Instance().End_Tick(tick, *Map);
+        }
+        return tick;
+    });
+    Platform_LogInfo("GameClass: Simulation thread started");
+}
+
+const RenderSnapshot* GameClass::Get_Render_Snapshot() const {
+    return sim_pipeline_ ? &sim_pipeline_->Front() : nullptr;
+}
+
+// =============================================================================
+// Profiling
+// =============================================================================
+
+void GameClass::Start_Sample_Profile(const char* path, int rate_hz) {
+    if (path && *path) {
+        sample_path_ = path;
+    }
+    if (rate_hz > 0) {
+        sample_rate_hz_ = rate_hz;
+    }
+    if (!SamplingProfiler::instance().is_running()) {
+        Toggle_Sample_Profile();
+    }
+}
+
+bool GameClass::Start_Capture(const char* path) {
+    uint8_t* pixels = nullptr;
+    int32_t width = 0, height = 0, pitch = 0;
+    if (Platform_Graphics_GetBackBuffer(&pixels, &width, &height, &pitch) != 0 ||
+        !FrameCapture::Instance().Start(path, width, height)) {
+        Platform_LogError((std::string("Failed to start frame capture to ") + path).c_str());
+        return false;
+    }
+    return true;
+}
+
+void GameClass::Toggle_Sample_Profile() {
+    SamplingProfiler& profiler = SamplingProfiler::instance();
+    char msg[512];
+
+    if (!profiler.is_running()) {
+        profiler.clear();
+        if (!profiler.start(sample_rate_hz_)) {
+            Platform_LogWarn("Sampling profiler is not supported on this platform");
+            return;
+        }
+        snprintf(msg, sizeof(msg), "Sampling profiler started (%d Hz)", sample_rate_hz_);
+        Platform_LogInfo(msg);
+        return;
+    }
+
+    profiler.stop();
+    if (profiler.save_folded(sample_path_)) {
+        snprintf(msg, sizeof(msg), "Sampling profile written to %s", sample_path_.c_str());
+        Platform_LogInfo(msg);
+    } else {
+        snprintf(msg, sizeof(msg), "Could not write sampling profile to %s", sample_path_.c_str());
+        Platform_LogWarn(msg);
+    }
+
+    // The hottest functions, one log line each
+    std::istringstream top(profiler.format_top(10));
+    std::string line;
+    while (std::getline(top, line)) {
+        Platform_LogInfo(line.c_str());
+    }
+}
+
 // =============================================================================
 // Input Processing
 // =============================================================================
 
 void GameClass::Process_Input() {
+    // Sampling profiler on/off, in any mode and any build
+    if (Platform_Key_WasPressed(KEY_CODE_F12)) {
+        Toggle_Sample_Profile();
+    }
+
     // Handle mode-specific input
     // Note: Platform_Input_Update() is called in the main loop before Platform_PollEvents()
     switch (mode_) {
@@ -294,10 +823,11 @@ void GameClass::Process_Menu() {
             if (selection == MenuResult::START_NEW_GAME) {
                 Platform_LogInfo("Loading theater and initializing TileRenderer...");
 
-                // Initialize TileRenderer with the theater (this loads palette and templates)
+                // Initialize TileRenderer with the theater. The palette loads
+                // now; templates decode on a worker and load on demand until then.
                 TileRenderer& renderer = TileRenderer::Instance();
-                if (!renderer.SetTheater(THEATER_TEMPERATE)) {
-                    Platform_LogError("TileRenderer::SetTheater failed");
+                if (!renderer.BeginTheaterLoad(THEATER_TEMPERATE)) {
+                    Platform_LogError("TileRenderer::BeginTheaterLoad failed");
                 } else {
                     Platform_LogInfo("TileRenderer initialized for TEMPERATE theater");
                 }
@@ -347,8 +877,7 @@ void GameClass::Process_Menu() {
                     display_->Center_On(XY_Cell(40, 30));
                 }
 
-                mode_ = GAME_MODE_PLAYING;
-                Platform_LogInfo("Starting gameplay");
+                Begin_Scenario_Load(DEFAULT_SCENARIO);
 
             } else if (selection == MenuResult::EXIT_GAME) {
                 mode_ = GAME_MODE_QUIT;
@@ -357,6 +886,239 @@ void GameClass::Process_Menu() {
     }
 }
 
+// =============================================================================
+// Deferred Startup
+// =============================================================================
+
+void GameClass::Defer_Startup() {
+    IncrementalLoader& startup = deferred_startup_;
+    startup.Clear();
+    ready_ = 0;
+
+    startup.Add("Audio", [this]() {
+        AudioSystemConfig config;
+        config.audio_thread = true;
+        if (!AudioSystem::Instance().Initialize(config)) {
+            Platform_LogWarn("Audio unavailable; continuing without sound");
+        }
+        Set_Ready(STARTUP_AUDIO, "Audio");
+        return true;
+    });
+
+    // Decoded on the asset loader; a sound missing from the data never
+    // loads, so stop waiting after a while
+    startup.Add("Menu Sounds", [this, queued = std::vector<SoundEffect>(), start = uint32_t(0)]() mutable {
+        AudioSystem& audio = AudioSystem::Instance();
+        if (!audio.IsInitialized()) {
+            Set_Ready(STARTUP_SOUNDS, "Menu sounds (no audio)");
+            return true;
+        }
+
+        auto lock = audio.LockState();
+        SoundManager& sounds = SoundManager::Instance();
+        if (start == 0) {
+            start = std::max(Platform_Timer_GetTicks(), 1u);
+            for (SoundEffect sfx : MENU_SOUNDS) {
+                if (sounds.Preload(sfx, true)) {
+                    queued.push_back(sfx);
+                }
+            }
+        }
+
+        bool loaded = std::all_of(queued.begin(), queued.end(),
+                                  [&](SoundEffect sfx) { return sounds.IsSoundLoaded(sfx); });
+        if (!loaded && Platform_Timer_GetTicks() - start < MENU_SOUNDS_MAX_MS) {
+            return false;
+        }
+        Set_Ready(STARTUP_SOUNDS, "Menu sounds");
+        return true;
+    });
+
+    // The lobby reads what discovery has found by the time it opens
+    startup.Add("Network", [this]() {
+        if (menu_) {
+            menu_->StartDiscovery();
+        }
+        Set_Ready(STARTUP_NETWORK, "LAN discovery");
+        return true;
+    });
+
+    // Until then Parallel_For runs the tick's phases inline
+    startup.Add("Workers", [this]() {
+        JobSystem::Instance().Start();
+        Set_Ready(STARTUP_WORKERS, "Job system");
+        return true;
+    });
+}
+
+void GameClass::Set_Ready(uint32_t systems, const char* name) {
+    ready_ |= systems;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s ready %.0f ms after launch", name,
+             (Platform_Timer_GetTime() - startup_time_) * 1000.0);
+    Platform_LogInfo(msg);
+}
+
+void GameClass::Finish_Startup() {
+    while (!deferred_startup_.Pump(DEFERRED_STARTUP_BUDGET_MS)) {
+        AssetLoader::Instance().Pump();
+        Platform_Timer_Delay(1);
+    }
+}
+
+// =============================================================================
+// Scenario Prefetch
+// =============================================================================
+
+void GameClass::Begin_Scenario_Load(const char* scenario) {
+    load_name_ = scenario;
+    load_ini_ = MixView(scenario);
+    load_manifest_.Clear();
+    load_map_ = nullptr;
+    load_next_object_ = 0;
+
+    // What earlier runs loaded on demand in the first minute
+    char cache_path[512];
+    first_use_path_.clear();
+    if (Platform_GetCachePath(cache_path, sizeof(cache_path)) > 0) {
+        first_use_path_ = std::string(cache_path) + "/" +
+                          load_name_.substr(0, load_name_.rfind('.')) + ".use";
+    }
+
+    IncrementalLoader& load = scenario_load_;
+    load.Clear();
+
+    // The map and the manifest each only read the INI, so decode them side by side
+    load.Add_Parallel("Scenario Map", [this]() {
+        IoScope io(IoTag::SCENARIO);
+        if (load_ini_ && display_) {
+            // Terrain and objects, read from the binary cache after the first run
+            load_map_ = ScenarioLoader::Instance().Read(
+                load_name_.c_str(), reinterpret_cast<const char*>(load_ini_.Data()),
+                static_cast<size_t>(load_ini_.Size()));
+        }
+    });
+    load.Add_Parallel("Asset Manifest", [this]() {
+        IoScope io(IoTag::SCENARIO);
+        if (load_ini_) {
+            load_manifest_.Parse_Scenario(reinterpret_cast<const char*>(load_ini_.Data()),
+                                          static_cast<size_t>(load_ini_.Size()));
+        }
+        first_use_.Clear();
+        if (!first_use_path_.empty()) {
+            first_use_.Load_Log(first_use_path_.c_str());
+            load_manifest_.Merge(first_use_);
+        }
+    });
+
+    load.Add("Map", [this]() {
+        load_ini_.Close();
+        if (load_map_ != nullptr) {
+            // Objects unmark their cells as they go, so free them before Init clears the map
+            End_Scenario();
+            scenario_scope_ = std::make_unique<ScenarioScope>();
+            ScenarioArena::Instance().At_Scope_End([](void*) { FlowField::Flush_Cache(); }, nullptr);
+            display_->Init(load_map_->theater);
+            ScenarioLoader::Apply_Map(*load_map_, *display_);
+            Platform_LogInfo(ScenarioLoader::Instance().Was_Cached() ? "Scenario map loaded from cache"
+                                                                     : "Scenario map parsed and cached");
+        }
+        return true;
+    });
+
+    load.Add("Objects", [this]() {
+        if (load_map_ == nullptr) {
+            return true;
+        }
+        load_next_object_ = ScenarioLoader::Apply_Objects(*load_map_, *display_, load_next_object_,
+                                                          LOAD_OBJECTS_PER_STEP);
+        if (load_next_object_ < load_map_->placements.size()) {
+            return false;
+        }
+        display_->Center_On(XY_Cell(display_->Map_Bounds_X() + display_->Map_Bounds_Width() / 2,
+                                    display_->Map_Bounds_Y() + display_->Map_Bounds_Height() / 2));
+        return true;
+    });
+
+    // Otherwise the radar builds its terrain image in the first frame drawn
+    load.Add("Radar", [this]() {
+        RadarRenderer* radar = RenderPipeline::Instance().GetRadarRenderer();
+        if (load_map_ != nullptr && radar != nullptr) {
+            radar->UpdateTerrainImage();
+        }
+        return true;
+    });
+
+    load.Add("Prefetch", [this]() {
+        // The last scenario's sounds may go once this one's are pinned
+        {
+            auto audio_lock = AudioSystem::Instance().LockState();
+            SoundManager::Instance().UnpinAll();
+        }
+        int queued = load_manifest_.Prefetch();
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Prefetching %d of %d assets for %s",
+                 queued, static_cast<int>(load_manifest_.Size()), load_name_.c_str());
+        Platform_LogInfo(msg);
+        loading_start_time_ = Platform_Timer_GetTicks();
+        return true;
+    });
+
+    mode_ = GAME_MODE_LOADING;
+}
+
+void GameClass::End_Scenario() {
+    // Objects go first; anything they point at may be in the arena
+    Destroy_All_Objects();
+    scenario_scope_.reset();
+}
+
+void GameClass::Update_Loading() {
+    if (!scenario_load_.Pump(LOAD_STEP_BUDGET_MS)) {
+        return;
+    }
+
+    bool settled = AssetLoader::Instance().IsIdle();
+    if (!settled && Platform_Timer_GetTicks() - loading_start_time_ < LOAD_SCREEN_MAX_MS) {
+        return;
+    }
+
+    // Anything still loading on demand from here is logged for next time
+    if (!first_use_path_.empty()) {
+        AssetManifest::Begin_Recording(&first_use_);
+        first_use_end_tick_ = tick_ + FIRST_USE_LOG_TICKS;
+    }
+
+    // From the world as it starts, so playback needs nothing else
+    if (!record_path_.empty() && Map != nullptr &&
+        !ReplayRecorder::Instance().Start(Sim_Random().Get_Seed(), *Map)) {
+        Platform_LogWarn("Failed to start replay recording");
+    }
+
+    scenario_load_.Clear();
+    load_manifest_.Clear();
+    load_map_ = nullptr;
+
+    mode_ = GAME_MODE_PLAYING;
+    Platform_LogInfo("Starting gameplay");
+}
+
+void GameClass::End_First_Use_Log() {
+    if (!AssetManifest::Is_Recording()) {
+        return;
+    }
+
+    AssetManifest::End_Recording();
+    Platform_EnsureDirectories();
+    if (!first_use_path_.empty() && !first_use_.Save_Log(first_use_path_.c_str())) {
+        Platform_LogWarn("Failed to save first-use log");
+    }
+
+    // What this instance decoded so far, for instances started later
+    SharedAssetCache::Instance().Save_Async();
+}
+
 void GameClass::Process_Gameplay() {
     if (!display_) return;
 
@@ -367,8 +1129,8 @@ void GameClass::Process_Gameplay() {
     }
 
     // Arrow keys to scroll
-    int scroll_x = 0;
-    int scroll_y = 0;
+    float scroll_x = 0.0f;
+    float scroll_y = 0.0f;
 
     if (Platform_Key_IsPressed(KEY_CODE_UP)) {
         scroll_y = -SCROLL_SPEED_NORMAL;
@@ -383,8 +1145,22 @@ void GameClass::Process_Gameplay() {
         scroll_x = SCROLL_SPEED_NORMAL;
     }
 
-    if (scroll_x != 0 || scroll_y != 0) {
-        display_->Scroll(scroll_x, scroll_y);
+    int dx, dy;
+    scroll_motion_.Step(scroll_x, scroll_y, dx, dy);
+    if (dx != 0 || dy != 0) {
+        display_->Scroll(dx, dy);
+    }
+
+    // Decode the terrain the view is heading into before it shows
+    if (scroll_motion_.IsMoving()) {
+        COORDINATE pos = display_->Get_Tactical_Position();
+        ScrollCellRange ahead[2];
+        int count = scroll_motion_.LeadCells(Coord_XPixel(pos), Coord_YPixel(pos),
+                                             display_->Tactical_Width(), display_->Tactical_Height(),
+                                             ScrollMotion::DEFAULT_LOOKAHEAD_FRAMES, ahead);
+        for (int i = 0; i < count; i++) {
+            display_->Prefetch_Cells(ahead[i].start_x, ahead[i].start_y, ahead[i].end_x, ahead[i].end_y);
+        }
     }
 
     // Update cursor cell based on mouse
@@ -418,31 +1194,189 @@ void GameClass::Process_Gameplay() {
 // =============================================================================
 
 void GameClass::Update_Logic() {
-    // Update all game objects
-    FOR_ALL_OBJECTS(obj) {
-        if (obj->Is_Active()) {
-            obj->AI();
-        }
-    }
+    Update_Simulation();
 
     // Process gadgets
     if (display_) {
         display_->Process_Gadgets(0);
     }
+}
+
+void GameClass::Update_Simulation() {
+    // Runs on the simulation thread when pipelined, which keeps its own tags
+    AllocScope sim(AllocTag::SIM);
+    PROFILE_SCOPE("Sim");
+
+    // Pick targets, aim and fire; the read-only phases run on the job
+    // workers, the results are applied in a fixed order
+    CombatSystem::Instance().Update();
+
+    // Update all game objects a kind at a time, remembering where they
+    // were for interpolation
+    AI_All_Objects();
+
+    // Turn and drive every moving unit in one batch
+    MovementSystem::Instance().Update();
+
+    // Fly bullets and play animations, all in one pass over their pool
+    ProjectileSystem::Instance().Update();
+
+    // Deal this tick's explosions together, one hit per object
+    SplashDamage::Instance().Resolve();
+
+    // Step every house's factories; power and money totals are kept
+    // current as they change, so nothing is summed here
+    Economy_AI();
+
+    // Redraw sight for houses whose units changed cells, then let a
+    // few ore cells grow
+    if (Map != nullptr) {
+        Map->Update_Vision(player_house_);
+        Map->Grow_Tiberium();
+    }
+
+    // Play this tick's combat sounds, merged per area
+    {
+        AllocScope audio(AllocTag::AUDIO);
+        PROFILE_SCOPE("Audio");
+        AudioEvents_FlushTick();
+    }
+
+    // Kept current by every mutation, so reading it each tick is free
+    state_hash_ = StateHash::Instance().Value();
+
+    // Run scenario triggers whose events fired this tick; the rest cost nothing
+    TriggerEngine::Instance().Update();
 
     // Additional logic updates would go here:
-    // - House income
-    // - Production queues
-    // - Trigger events
     // - Pathfinding
 }
 
+// =============================================================================
+// Replays and Resync
+// =============================================================================
+
+bool GameClass::Play_Replay(const Replay& replay, ReplayStats* stats) {
+    // Ticks run here, not on the simulation thread
+    Set_Pipelined(false);
+
+    // Without a map of the game's, the replay brings its own
+    MapClass* previous_map = Map;
+    ScenarioScope replay_scope;
+    bool own_map = Map == nullptr;
+    if (own_map) {
+        Map = ScenarioArena::Instance().Create<MapClass>();
+        Map->Alloc_Cells();
+
+        // The next replay's map may land at the same address
+        ScenarioArena::Instance().At_Scope_End([](void*) { FlowField::Flush_Cache(); }, nullptr);
+    }
+
+    ReplayPlayer player;
+    ReplayStats result;
+    bool ok = player.Start(replay, *Map);
+    if (ok) {
+        double start = Platform_Timer_GetTime();
+        while (!player.Is_Finished()) {
+            result.commands += player.Begin_Tick();
+            Update_Logic();
+            tick_++;
+            player.End_Tick();
+        }
+        result.seconds = Platform_Timer_GetTime() - start;
+        result.ticks = player.Get_Tick();
+        result.ticks_per_second = result.seconds > 0.0 ? result.ticks / result.seconds : 0.0;
+        result.state_hash = state_hash_;
+    }
+
+    if (own_map) {
+        // Objects unmark their cells as they go, so free them before the
+        // map (which goes with replay_scope)
+        Destroy_All_Objects();
+        ProjectileSystem::Instance().Clear();
+        SplashDamage::Instance().Clear();
+        Map = previous_map;
+    }
+
+    if (stats) {
+        *stats = result;
+    }
+    return ok;
+}
+
+void GameClass::Run_Ticks(int count) {
+    // Ticks run here, not on the simulation thread
+    Set_Pipelined(false);
+
+    for (int i = 0; i < count; i++) {
+        Update_Simulation();
+        tick_++;
+    }
+}
+
+bool GameClass::Resync(const ResyncPackage& package, ResyncStats* stats) {
+    ResyncStats result;
+    if (Map == nullptr) {
+        if (stats) *stats = result;
+        return false;
+    }
+
+    // Ticks run here, not on the simulation thread
+    bool pipelined = Is_Pipelined();
+    Set_Pipelined(false);
+
+    // The packets about to be reissued are in the package already
+    ResyncLog& log = ResyncLog::Instance();
+    bool logging = log.Is_Active();
+    log.Stop();
+
+    double start = Platform_Timer_GetTime();
+    ResyncPlayer player;
+    bool ok = player.Start(package, *Map);
+    if (ok) {
+        tick_ = package.base_tick;
+        while (!player.Is_Finished()) {
+            result.packets += player.Begin_Tick();
+            Update_Simulation();
+            tick_++;
+            player.End_Tick();
+        }
+        result.ticks = package.live_tick - package.base_tick;
+        state_hash_ = StateHash::Instance().Value();
+        result.hash_matched = state_hash_ == package.state_hash;
+        ok = result.hash_matched;
+    }
+    result.seconds = Platform_Timer_GetTime() - start;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "GameClass: Resync ran %u ticks in %.3f s, hash %s",
+             result.ticks, result.seconds, result.hash_matched ? "matched" : "differs");
+    Platform_LogInfo(msg);
+
+    if (logging && !log.Start(tick_, *Map)) {
+        Platform_LogWarn("Failed to restart resync log");
+    }
+    if (pipelined) {
+        Set_Pipelined(true);
+    }
+
+    if (stats) {
+        *stats = result;
+    }
+    return ok;
+}
+
 // =============================================================================
 // Rendering
 // =============================================================================
 
-void GameClass::Render_Frame() {
+void GameClass::Render_Frame(float alpha) {
     if (!display_) return;
+    AllocScope graphics(AllocTag::GRAPHICS);
+
+    // Object drawing reads it back through Get_Render_Alpha()
+    render_alpha_ = alpha;
+    display_->Set_Object_Snapshot(Get_Render_Snapshot(), alpha);
 
     // Render based on mode
     switch (mode_) {
@@ -474,6 +1408,20 @@ void GameClass::Render_Frame() {
             }
             break;
 
+        case GAME_MODE_LOADING: {
+            // Progress bar, with a marker sweeping along it so a long step still shows movement
+            int filled = static_cast<int>(scenario_load_.Get_Progress() * LOAD_BAR_WIDTH);
+            int marker = static_cast<int>(frame_ * 4 % (LOAD_BAR_WIDTH - 8));
+            display_->Lock();
+            display_->Clear(0);
+            display_->Draw_Rect(LOAD_BAR_X, LOAD_BAR_Y, LOAD_BAR_WIDTH, LOAD_BAR_HEIGHT, 176);
+            display_->Draw_Rect(LOAD_BAR_X, LOAD_BAR_Y, filled, LOAD_BAR_HEIGHT, 154);
+            display_->Draw_Rect(LOAD_BAR_X + marker, LOAD_BAR_Y + 4, 8, LOAD_BAR_HEIGHT - 8, 255);
+            display_->Unlock();
+            display_->Flip();
+            break;
+        }
+
         default:
             // Just clear
             display_->Lock();
@@ -482,6 +1430,12 @@ void GameClass::Render_Frame() {
             display_->Flip();
             break;
     }
+
+    // The frame just presented; the encoding happens on the capture thread
+    if (FrameCapture::Instance().Is_Recording()) {
+        PROFILE_SCOPE("Frame Capture");
+        FrameCapture::Instance().Capture_Screen(Platform_Timer_GetTicks());
+    }
 }
 
 // =============================================================================
@@ -508,9 +1462,112 @@ void Game_Shutdown() {
     }
 }
 
+/**
+ * Log where launch-to-menu time went, and what was read from disk, and
+ * save it as a Chrome trace
+ */
+static void Game_Startup_Report(const char* path) {
+    const StartupTrace& startup = StartupTrace::instance();
+    std::string report = startup.format_report() + "\n" + IoStats::instance().format_report();
+    size_t begin = 0;
+    while (begin < report.size()) {
+        size_t end = report.find('\n', begin);
+        if (end == std::string::npos) end = report.size();
+        Platform_LogInfo(report.substr(begin, end - begin).c_str());
+        begin = end + 1;
+    }
+
+    if (!startup.save_chrome_trace(path)) {
+        Platform_LogWarn("Failed to write startup trace");
+    }
+}
+
+/**
+ * Play a replay headless and report simulation throughput
+ */
+static int Game_Benchmark_Replay(const char* path) {
+    Replay replay;
+    if (!replay.Load(path)) {
+        Platform_LogError("Failed to load replay");
+        return 1;
+    }
+
+    // Parallel phases as in a real game; no window, no audio
+    JobSystem::Instance().Start();
+
+    GameClass game;
+    ReplayStats stats;
+    bool ok = game.Play_Replay(replay, &stats);
+
+    JobSystem::Instance().Stop();
+
+    if (!ok) {
+        Platform_LogError("Replay snapshot did not load");
+        return 1;
+    }
+
+    printf("%s: %u ticks, %u commands in %.3f s (%.1f ticks/sec), state hash %016llx\n",
+           path, stats.ticks, stats.commands, stats.seconds, stats.ticks_per_second,
+           static_cast<unsigned long long>(stats.state_hash));
+    return 0;
+}
+
 int Game_Main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+    // From launch; GameClass::Initialize finishes it at the main menu
+    StartupTrace::instance().start();
+
+    const char* replay_path = nullptr;
+    const char* record_path = nullptr;
+    const char* startup_report_path = nullptr;
+    const char* sample_profile_path = nullptr;
+    const char* capture_path = nullptr;
+    int sample_rate_hz = 0;
+    bool low_latency = false;
+    bool power_saver = true;
+    int max_frames_queued = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--no-large-pages") == 0) {
+            LargePages::instance().set_enabled(false);
+        } else if (strcmp(argv[i], "--lock-memory") == 0) {
+            LargePages::instance().set_locked(true);
+        } else if (strcmp(argv[i], "--shared-assets") == 0) {
+            SharedAssetCache::Instance().Set_Enabled(true);
+        } else if (strcmp(argv[i], "--cache-limit") == 0 && i + 1 < argc) {
+            size_t megabytes = strtoul(argv[++i], nullptr, 10);
+            MemoryBudget::Instance().Set_Limit(megabytes * 1024 * 1024);
+        } else if (strcmp(argv[i], "--low-latency") == 0) {
+            low_latency = true;
+        } else if (strcmp(argv[i], "--no-power-saver") == 0) {
+            power_saver = false;
+        } else if (strcmp(argv[i], "--max-frames-queued") == 0 && i + 1 < argc) {
+            max_frames_queued = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--startup-report") == 0 && i + 1 < argc) {
+            startup_report_path = argv[++i];
+        } else if (strcmp(argv[i], "--sample-profile") == 0 && i + 1 < argc) {
+            sample_profile_path = argv[++i];
+        } else if (strcmp(argv[i], "--sample-rate") == 0 && i + 1 < argc) {
+            sample_rate_hz = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capture_path = argv[++i];
+        } else if (strcmp(argv[i], "--gpu-palette") == 0) {
+            Platform_Graphics_SetGpuPalette(true);
+        } else if (strcmp(argv[i], "--resolution") == 0 && i + 1 < argc) {
+            int width = 0, height = 0;
+            const char* size = argv[++i];
+            if (sscanf(size, "%dx%d", &width, &height) != 2 ||
+                Platform_Graphics_SetResolution(width, height) != 0) {
+                Platform_LogError((std::string("Ignoring --resolution ") + size).c_str());
+            }
+        }
+    }
+
+    if (replay_path != nullptr) {
+        return Game_Benchmark_Replay(replay_path);
+    }
 
     Platform_LogInfo("Red Alert - Starting...");
 
@@ -519,6 +1576,20 @@ int Game_Main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (startup_report_path != nullptr) {
+        Game_Startup_Report(startup_report_path);
+    }
+
+    Game->Set_Record_Path(record_path);
+    Game->Set_Max_Frames_Queued(max_frames_queued);
+    Game->Set_Low_Latency(low_latency);
+    Game->Set_Power_Saver(power_saver);
+    if (sample_profile_path != nullptr) {
+        Game->Start_Sample_Profile(sample_profile_path, sample_rate_hz);
+    }
+    if (capture_path != nullptr) {
+        Game->Start_Capture(capture_path);
+    }
     int result = Game->Run();
 
     Game_Shutdown();
@@ -0,0 +1,83 @@
+/**
+ * BlitBatch Implementation
+ */
+
+#include "game/graphics/blit_batch.h"
+#include "game/graphics/graphics_buffer.h"
+
+PlatformBlitOp& BlitBatch::Push(uint8_t kind) {
+    if (count_ == CAPACITY) {
+        Flush();
+    }
+    PlatformBlitOp& op = ops_[count_++];
+    op = PlatformBlitOp();
+    op.kind = kind;
+    return op;
+}
+
+void BlitBatch::Fill_Rect(int x, int y, int w, int h, uint8_t color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    PlatformBlitOp& op = Push(PLATFORM_BLIT_FILL);
+    op.color = color;
+    op.x = x;
+    op.y = y;
+    op.width = w;
+    op.height = h;
+}
+
+void BlitBatch::Draw_Rect(int x, int y, int w, int h, uint8_t color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    Draw_HLine(x, y, w, color);              // Top
+    Draw_HLine(x, y + h - 1, w, color);      // Bottom
+    Draw_VLine(x, y, h, color);              // Left
+    Draw_VLine(x + w - 1, y, h, color);      // Right
+}
+
+void BlitBatch::Blit_Raw(const uint8_t* src_pixels, int src_pitch,
+                         int src_x, int src_y, int src_w, int src_h,
+                         int dst_x, int dst_y, int w, int h,
+                         bool trans, uint8_t trans_color) {
+    if (!src_pixels || w <= 0 || h <= 0) {
+        return;
+    }
+    PlatformBlitOp& op = Push(trans ? PLATFORM_BLIT_COPY_TRANS : PLATFORM_BLIT_COPY);
+    op.color = trans_color;
+    op.x = dst_x;
+    op.y = dst_y;
+    op.width = w;
+    op.height = h;
+    op.src = src_pixels;
+    op.src_pitch = src_pitch;
+    op.src_width = src_w;
+    op.src_height = src_h;
+    op.src_x = src_x;
+    op.src_y = src_y;
+}
+
+void BlitBatch::Remap(int x, int y, int w, int h, const uint8_t* remap_table, bool trans) {
+    if (!remap_table || w <= 0 || h <= 0) {
+        return;
+    }
+    PlatformBlitOp& op = Push(trans ? PLATFORM_BLIT_REMAP_TRANS : PLATFORM_BLIT_REMAP);
+    op.x = x;
+    op.y = y;
+    op.width = w;
+    op.height = h;
+    op.src = remap_table;
+}
+
+void BlitBatch::Flush() {
+    if (count_ == 0) {
+        return;
+    }
+    uint8_t* pixels = target_.Get_Buffer();
+    if (pixels) {
+        Platform_Buffer_Execute(pixels, target_.Get_Pitch(), target_.Get_Width(), target_.Get_Height(),
+                                ops_, count_);
+    }
+    count_ = 0;
+}
@@ -0,0 +1,344 @@
+/**
+ * Blit Kernels Implementation
+ *
+ * There is no byte gather before AVX-512, so remaps still do one table
+ * load per pixel. The vector paths win by testing 16/32 pixels for
+ * transparency at once: fully transparent blocks are skipped, fully
+ * opaque blocks are stored without per-pixel branches, and mixed blocks
+ * are merged with a masked blend.
+ */
+
+#include "game/graphics/blit_kernels.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BLIT_HAVE_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define BLIT_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// =============================================================================
+// Scalar Kernels
+// =============================================================================
+
+static void Copy_Trans_Scalar(uint8_t* dst, const uint8_t* src, int count, uint8_t key) {
+    for (int i = 0; i < count; i++) {
+        uint8_t pixel = src[i];
+        if (pixel != key) {
+            dst[i] = pixel;
+        }
+    }
+}
+
+static void Copy_Remap_Scalar(uint8_t* dst, const uint8_t* src, int count,
+                              const uint8_t* table) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        dst[i + 0] = table[src[i + 0]];
+        dst[i + 1] = table[src[i + 1]];
+        dst[i + 2] = table[src[i + 2]];
+        dst[i + 3] = table[src[i + 3]];
+    }
+    for (; i < count; i++) {
+        dst[i] = table[src[i]];
+    }
+}
+
+static void Copy_Remap_Trans_Scalar(uint8_t* dst, const uint8_t* src, int count,
+                                    const uint8_t* table, uint8_t key) {
+    for (int i = 0; i < count; i++) {
+        uint8_t pixel = src[i];
+        if (pixel != key) {
+            dst[i] = table[pixel];
+        }
+    }
+}
+
+static void Remap_Inplace_Scalar(uint8_t* row, int count, const uint8_t* table) {
+    Copy_Remap_Scalar(row, row, count, table);
+}
+
+static void Remap_Masked_Scalar(uint8_t* row, const uint8_t* mask, int count,
+                                const uint8_t* table, uint8_t key) {
+    for (int i = 0; i < count; i++) {
+        if (mask[i] != key) {
+            row[i] = table[row[i]];
+        }
+    }
+}
+
+// =============================================================================
+// SSE2 / AVX2 Kernels
+// =============================================================================
+
+#if BLIT_HAVE_X86
+
+static void Copy_Trans_SSE2(uint8_t* dst, const uint8_t* src, int count, uint8_t key) {
+    const __m128i keyv = _mm_set1_epi8(static_cast<char>(key));
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i mask = _mm_cmpeq_epi8(s, keyv);   // 0xFF where transparent
+        int bits = _mm_movemask_epi8(mask);
+        if (bits == 0xFFFF) {
+            continue;
+        }
+        __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+        if (bits == 0) {
+            _mm_storeu_si128(d, s);
+        } else {
+            __m128i old = _mm_loadu_si128(d);
+            _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(mask, old),
+                                             _mm_andnot_si128(mask, s)));
+        }
+    }
+    Copy_Trans_Scalar(dst + i, src + i, count - i, key);
+}
+
+static void Copy_Remap_Trans_SSE2(uint8_t* dst, const uint8_t* src, int count,
+                                  const uint8_t* table, uint8_t key) {
+    const __m128i keyv = _mm_set1_epi8(static_cast<char>(key));
+    alignas(16) uint8_t mapped[16];
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i mask = _mm_cmpeq_epi8(s, keyv);
+        int bits = _mm_movemask_epi8(mask);
+        if (bits == 0xFFFF) {
+            continue;
+        }
+        Copy_Remap_Scalar(mapped, src + i, 16, table);
+        __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(mapped));
+        __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+        if (bits == 0) {
+            _mm_storeu_si128(d, m);
+        } else {
+            __m128i old = _mm_loadu_si128(d);
+            _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(mask, old),
+                                             _mm_andnot_si128(mask, m)));
+        }
+    }
+    Copy_Remap_Trans_Scalar(dst + i, src + i, count - i, table, key);
+}
+
+static void Remap_Masked_SSE2(uint8_t* row, const uint8_t* mask, int count,
+                              const uint8_t* table, uint8_t key) {
+    const __m128i keyv = _mm_set1_epi8(static_cast<char>(key));
+    alignas(16) uint8_t mapped[16];
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        __m128i clear = _mm_cmpeq_epi8(m, keyv);   // 0xFF where unmasked
+        int bits = _mm_movemask_epi8(clear);
+        if (bits == 0xFFFF) {
+            continue;
+        }
+        Copy_Remap_Scalar(mapped, row + i, 16, table);
+        __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(mapped));
+        __m128i* d = reinterpret_cast<__m128i*>(row + i);
+        if (bits == 0) {
+            _mm_storeu_si128(d, r);
+        } else {
+            __m128i old = _mm_loadu_si128(d);
+            _mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(clear, old),
+                                             _mm_andnot_si128(clear, r)));
+        }
+    }
+    Remap_Masked_Scalar(row + i, mask + i, count - i, table, key);
+}
+
+// The tail stays in this function: calling the SSE2 kernel would run
+// legacy-encoded SSE with the upper YMM halves dirty, and the AVX->SSE
+// transition costs more than a short row takes to draw
+__attribute__((target("avx2")))
+static void Copy_Trans_AVX2(uint8_t* dst, const uint8_t* src, int count, uint8_t key) {
+    const __m256i keyv = _mm256_set1_epi8(static_cast<char>(key));
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i mask = _mm256_cmpeq_epi8(s, keyv);
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_epi8(mask));
+        if (bits == 0xFFFFFFFFu) {
+            continue;
+        }
+        __m256i* d = reinterpret_cast<__m256i*>(dst + i);
+        if (bits == 0) {
+            _mm256_storeu_si256(d, s);
+        } else {
+            __m256i old = _mm256_loadu_si256(d);
+            _mm256_storeu_si256(d, _mm256_blendv_epi8(s, old, mask));
+        }
+    }
+
+    // One 16-byte step (VEX-encoded here), then bytes
+    if (i + 16 <= count) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i mask = _mm_cmpeq_epi8(s, _mm256_castsi256_si128(keyv));
+        int bits = _mm_movemask_epi8(mask);
+        if (bits != 0xFFFF) {
+            __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+            __m128i old = _mm_loadu_si128(d);
+            _mm_storeu_si128(d, _mm_blendv_epi8(s, old, mask));
+        }
+        i += 16;
+    }
+    for (; i < count; i++) {
+        if (src[i] != key) {
+            dst[i] = src[i];
+        }
+    }
+    _mm256_zeroupper();
+}
+
+#endif // BLIT_HAVE_X86
+
+// =============================================================================
+// NEON Kernels
+// =============================================================================
+
+#if BLIT_HAVE_NEON
+
+static void Copy_Trans_NEON(uint8_t* dst, const uint8_t* src, int count, uint8_t key) {
+    const uint8x16_t keyv = vdupq_n_u8(key);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t mask = vceqq_u8(s, keyv);
+        if (vminvq_u8(mask) == 0xFF) {
+            continue;  // All transparent
+        }
+        if (vmaxvq_u8(mask) == 0) {
+            vst1q_u8(dst + i, s);
+        } else {
+            uint8x16_t old = vld1q_u8(dst + i);
+            vst1q_u8(dst + i, vbslq_u8(mask, old, s));
+        }
+    }
+    Copy_Trans_Scalar(dst + i, src + i, count - i, key);
+}
+
+static void Copy_Remap_Trans_NEON(uint8_t* dst, const uint8_t* src, int count,
+                                  const uint8_t* table, uint8_t key) {
+    const uint8x16_t keyv = vdupq_n_u8(key);
+    uint8_t mapped[16];
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t mask = vceqq_u8(s, keyv);
+        if (vminvq_u8(mask) == 0xFF) {
+            continue;
+        }
+        Copy_Remap_Scalar(mapped, src + i, 16, table);
+        uint8x16_t m = vld1q_u8(mapped);
+        if (vmaxvq_u8(mask) == 0) {
+            vst1q_u8(dst + i, m);
+        } else {
+            uint8x16_t old = vld1q_u8(dst + i);
+            vst1q_u8(dst + i, vbslq_u8(mask, old, m));
+        }
+    }
+    Copy_Remap_Trans_Scalar(dst + i, src + i, count - i, table, key);
+}
+
+static void Remap_Masked_NEON(uint8_t* row, const uint8_t* mask, int count,
+                              const uint8_t* table, uint8_t key) {
+    const uint8x16_t keyv = vdupq_n_u8(key);
+    uint8_t mapped[16];
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t clear = vceqq_u8(vld1q_u8(mask + i), keyv);
+        if (vminvq_u8(clear) == 0xFF) {
+            continue;
+        }
+        Copy_Remap_Scalar(mapped, row + i, 16, table);
+        uint8x16_t r = vld1q_u8(mapped);
+        if (vmaxvq_u8(clear) == 0) {
+            vst1q_u8(row + i, r);
+        } else {
+            vst1q_u8(row + i, vbslq_u8(clear, vld1q_u8(row + i), r));
+        }
+    }
+    Remap_Masked_Scalar(row + i, mask + i, count - i, table, key);
+}
+
+#endif // BLIT_HAVE_NEON
+
+// =============================================================================
+// Dispatch
+// =============================================================================
+
+static const BlitKernels kScalarKernels = {
+    Copy_Trans_Scalar, Copy_Remap_Scalar, Copy_Remap_Trans_Scalar,
+    Remap_Inplace_Scalar, Remap_Masked_Scalar, BLIT_KERNEL_SCALAR, "scalar"
+};
+
+#if BLIT_HAVE_X86
+static const BlitKernels kSSE2Kernels = {
+    Copy_Trans_SSE2, Copy_Remap_Scalar, Copy_Remap_Trans_SSE2,
+    Remap_Inplace_Scalar, Remap_Masked_SSE2, BLIT_KERNEL_SSE2, "sse2"
+};
+
+// Only the transparent copy is wider: the remaps are bound by their
+// byte-wise table lookups, so AVX2 shares the SSE2 and scalar ones
+static const BlitKernels kAVX2Kernels = {
+    Copy_Trans_AVX2, Copy_Remap_Scalar, Copy_Remap_Trans_SSE2,
+    Remap_Inplace_Scalar, Remap_Masked_SSE2, BLIT_KERNEL_AVX2, "avx2"
+};
+#endif
+
+#if BLIT_HAVE_NEON
+static const BlitKernels kNEONKernels = {
+    Copy_Trans_NEON, Copy_Remap_Scalar, Copy_Remap_Trans_NEON,
+    Remap_Inplace_Scalar, Remap_Masked_NEON, BLIT_KERNEL_NEON, "neon"
+};
+#endif
+
+static const BlitKernels* Kernels_For_Level(BlitKernelLevel level) {
+    switch (level) {
+        case BLIT_KERNEL_SCALAR:
+            return &kScalarKernels;
+#if BLIT_HAVE_X86
+        case BLIT_KERNEL_SSE2:
+            return &kSSE2Kernels;
+        case BLIT_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? &kAVX2Kernels : nullptr;
+#endif
+#if BLIT_HAVE_NEON
+        case BLIT_KERNEL_NEON:
+            return &kNEONKernels;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+static const BlitKernels*& Active_Kernels() {
+    static const BlitKernels* active = Kernels_For_Level(DetectBlitKernelLevel());
+    return active;
+}
+
+BlitKernelLevel DetectBlitKernelLevel() {
+#if BLIT_HAVE_X86
+    // SSE2 is part of the x86-64 baseline
+    return __builtin_cpu_supports("avx2") ? BLIT_KERNEL_AVX2 : BLIT_KERNEL_SSE2;
+#elif BLIT_HAVE_NEON
+    return BLIT_KERNEL_NEON;
+#else
+    return BLIT_KERNEL_SCALAR;
+#endif
+}
+
+const BlitKernels& GetBlitKernels() {
+    return *Active_Kernels();
+}
+
+bool SetBlitKernelLevel(BlitKernelLevel level) {
+    const BlitKernels* kernels = Kernels_For_Level(level);
+    if (!kernels) {
+        return false;
+    }
+    Active_Kernels() = kernels;
+    return true;
+}
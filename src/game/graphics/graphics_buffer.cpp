@@ -5,7 +5,10 @@
  */
 
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/blit_kernels.h"
+#include "graphics/dirty_rect.h"
 #include "platform.h"
+#include "platform/large_pages.h"
 #include <cstring>
 
 // =============================================================================
@@ -40,8 +43,9 @@ GraphicsBuffer::GraphicsBuffer()
     , is_screen_(true)
     , owns_buffer_(false)
 {
-    // Don't get buffer here - wait for Lock()
-    // Platform might not be initialized yet
+    // Take the platform's resolution if it is up; the pointer is fetched
+    // again at each Lock() since graphics may be re-initialized
+    RefreshScreenBuffer();
 }
 
 // Create off-screen buffer
@@ -55,11 +59,9 @@ GraphicsBuffer::GraphicsBuffer(int width, int height)
     , owns_buffer_(true)
 {
     if (width > 0 && height > 0) {
+        // Screen-sized surfaces go on large pages; the block comes back zeroed
         size_t size = static_cast<size_t>(pitch_) * height_;
-        pixels_ = static_cast<uint8_t*>(Platform_Alloc(size, 0));
-        if (pixels_) {
-            Platform_ZeroMemory(pixels_, size);
-        }
+        pixels_ = static_cast<uint8_t*>(LargePages::instance().allocate(size, "Off-screen buffer"));
     }
 }
 
@@ -323,11 +325,13 @@ void GraphicsBuffer::Blit_From_Trans(const GraphicsBuffer& src,
         return;
     }
 
-    // Use platform transparent blit
-    Platform_Buffer_ToBufferTrans(
-        pixels_, pitch_, width_, height_,
-        src.pixels_, src.pitch_, src.width_, src.height_,
-        dst_x, dst_y, src_x, src_y, width, height);
+    // Vectorized key-color copy, one row at a time
+    const BlitKernels& kernels = GetBlitKernels();
+    for (int row = 0; row < height; row++) {
+        kernels.copy_trans(pixels_ + (dst_y + row) * pitch_ + dst_x,
+                           src.pixels_ + (src_y + row) * src.pitch_ + src_x,
+                           width, TRANSPARENT_COLOR);
+    }
 }
 
 void GraphicsBuffer::Blit_From_Raw(const uint8_t* src_pixels, int src_pitch,
@@ -350,6 +354,52 @@ void GraphicsBuffer::Blit_From_Raw(const uint8_t* src_pixels, int src_pitch,
         dst_x, dst_y, src_x, src_y, width, height);
 }
 
+void GraphicsBuffer::Blit_Tile24_Clipped(const uint8_t* src, int x, int y) {
+    if (!IsLocked() || !src) return;
+
+    int src_x = 0;
+    int src_y = 0;
+    int width = TILE24;
+    int height = TILE24;
+    if (!ClipBlit(src_x, src_y, TILE24, TILE24,
+                  x, y, width_, height_,
+                  width, height)) {
+        return;
+    }
+
+    const uint8_t* s = src + src_y * TILE24 + src_x;
+    uint8_t* d = pixels_ + y * pitch_ + x;
+    for (int row = 0; row < height; row++) {
+        memcpy(d, s, width);
+        s += TILE24;
+        d += pitch_;
+    }
+}
+
+void GraphicsBuffer::Mask_Tile24(const uint8_t* keep, int x, int y) {
+    if (!IsLocked() || !keep) return;
+
+    int src_x = 0;
+    int src_y = 0;
+    int width = TILE24;
+    int height = TILE24;
+    if (!ClipBlit(src_x, src_y, TILE24, TILE24,
+                  x, y, width_, height_,
+                  width, height)) {
+        return;
+    }
+
+    const uint8_t* s = keep + src_y * TILE24 + src_x;
+    uint8_t* d = pixels_ + y * pitch_ + x;
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col++) {
+            d[col] &= s[col];
+        }
+        s += TILE24;
+        d += pitch_;
+    }
+}
+
 void GraphicsBuffer::Blit_From_Raw_Trans(const uint8_t* src_pixels, int src_pitch,
                                          int src_x, int src_y, int src_w, int src_h,
                                          int dst_x, int dst_y,
@@ -364,12 +414,38 @@ void GraphicsBuffer::Blit_From_Raw_Trans(const uint8_t* src_pixels, int src_pitc
         return;
     }
 
-    // Use platform transparent blit with custom key
-    Platform_Buffer_ToBufferTransKey(
-        pixels_, pitch_, width_, height_,
-        src_pixels, src_pitch, src_w, src_h,
-        dst_x, dst_y, src_x, src_y, width, height,
-        trans_color);
+    // Vectorized key-color copy, one row at a time
+    const BlitKernels& kernels = GetBlitKernels();
+    for (int row = 0; row < height; row++) {
+        kernels.copy_trans(pixels_ + (dst_y + row) * pitch_ + dst_x,
+                           src_pixels + (src_y + row) * src_pitch + src_x,
+                           width, trans_color);
+    }
+}
+
+void GraphicsBuffer::Shift(int dx, int dy) {
+    if (!IsLocked() || (dx == 0 && dy == 0)) return;
+    if (dx <= -width_ || dx >= width_ || dy <= -height_ || dy >= height_) return;
+
+    int copy_w = width_ - (dx < 0 ? -dx : dx);
+    int copy_h = height_ - (dy < 0 ? -dy : dy);
+    int src_x = dx < 0 ? -dx : 0;
+    int dst_x = dx > 0 ? dx : 0;
+
+    // Walk rows away from the destination so a row is read before it is
+    // overwritten; memmove handles the horizontal overlap within a row.
+    if (dy > 0) {
+        for (int row = copy_h - 1; row >= 0; row--) {
+            memmove(pixels_ + (row + dy) * pitch_ + dst_x,
+                    pixels_ + row * pitch_ + src_x, copy_w);
+        }
+    } else {
+        int src_row = -dy;
+        for (int row = 0; row < copy_h; row++) {
+            memmove(pixels_ + row * pitch_ + dst_x,
+                    pixels_ + (row + src_row) * pitch_ + src_x, copy_w);
+        }
+    }
 }
 
 // =============================================================================
@@ -380,8 +456,10 @@ void GraphicsBuffer::Remap(int x, int y, int w, int h, const uint8_t* remap_tabl
     if (!IsLocked() || !remap_table) return;
     if (!ClipRect(x, y, w, h)) return;
 
-    // Use platform remap
-    Platform_Buffer_Remap(pixels_, pitch_, x, y, w, h, remap_table);
+    const BlitKernels& kernels = GetBlitKernels();
+    for (int row = 0; row < h; row++) {
+        kernels.remap_inplace(pixels_ + (y + row) * pitch_ + x, w, remap_table);
+    }
 }
 
 void GraphicsBuffer::Blit_Remap(const GraphicsBuffer& src,
@@ -399,27 +477,16 @@ void GraphicsBuffer::Blit_Remap(const GraphicsBuffer& src,
         return;
     }
 
-    // Use platform remap copy
-    // Note: For transparent + remap, we need to handle this manually
-    // since Platform_Buffer_RemapCopy doesn't have transparency option
+    const BlitKernels& kernels = GetBlitKernels();
+    for (int row = 0; row < height; row++) {
+        const uint8_t* src_row = src.pixels_ + (src_y + row) * src.pitch_ + src_x;
+        uint8_t* dst_row = pixels_ + (dst_y + row) * pitch_ + dst_x;
 
-    if (!transparent) {
-        Platform_Buffer_RemapCopy(
-            pixels_, pitch_, dst_x, dst_y,
-            src.pixels_, src.pitch_, src_x, src_y,
-            width, height, remap_table);
-    } else {
-        // Manual transparent remap - slightly slower but correct
-        for (int row = 0; row < height; row++) {
-            const uint8_t* src_row = src.pixels_ + (src_y + row) * src.pitch_ + src_x;
-            uint8_t* dst_row = pixels_ + (dst_y + row) * pitch_ + dst_x;
-
-            for (int col = 0; col < width; col++) {
-                uint8_t pixel = src_row[col];
-                if (pixel != TRANSPARENT_COLOR) {
-                    dst_row[col] = remap_table[pixel];
-                }
-            }
+        if (transparent) {
+            kernels.copy_remap_trans(dst_row, src_row, width, remap_table,
+                                     TRANSPARENT_COLOR);
+        } else {
+            kernels.copy_remap(dst_row, src_row, width, remap_table);
         }
     }
 }
@@ -442,6 +509,27 @@ bool GraphicsBuffer::Flip() {
     return Platform_Graphics_Flip() == 0;
 }
 
+// Rect and ClipRect are both {x, y, width, height} in int32
+static_assert(sizeof(Rect) == sizeof(ClipRect), "Rect must match ClipRect");
+static_assert(offsetof(Rect, x) == offsetof(ClipRect, x) &&
+              offsetof(Rect, y) == offsetof(ClipRect, y) &&
+              offsetof(Rect, width) == offsetof(ClipRect, width) &&
+              offsetof(Rect, height) == offsetof(ClipRect, height),
+              "Rect must match ClipRect");
+
+bool GraphicsBuffer::Flip(const std::vector<Rect>& rects) {
+    if (!is_screen_) {
+        return false;  // Can only flip screen buffer
+    }
+
+    if (lock_count_ > 0) {
+        lock_count_ = 0;
+    }
+
+    return Platform_Graphics_FlipRects(reinterpret_cast<const ::ClipRect*>(rects.data()),
+                                       static_cast<int32_t>(rects.size())) == 0;
+}
+
 // =============================================================================
 // Clipping Helpers
 // =============================================================================
@@ -0,0 +1,104 @@
+/**
+ * MapTerrainProvider Implementation
+ */
+
+#include "game/graphics/map_terrain.h"
+#include "game/map.h"
+#include "game/cell.h"
+#include "game/object.h"
+#include "game/spatial_grid.h"
+#include "game/graphics/radar_render.h"
+#include "game/graphics/remap_tables.h"
+
+int MapTerrainProvider::GetTerrainTile(int cell_x, int cell_y) const {
+    if (!IsValidCell(cell_x, cell_y)) {
+        return -1;
+    }
+
+    uint8_t tile;
+    const CellLayers* layers = map_->Get_Cell_Layers();
+    if (layers) {
+        tile = layers->template_type[MapClass::Layer_Index(cell_x, cell_y)];
+    } else {
+        tile = map_->Cell_At(cell_x, cell_y)->Get_Template();
+    }
+
+    // Cells without a template draw as clear terrain
+    return (tile == CELL_TEMPLATE_NONE) ? CELL_TEMPLATE_CLEAR : tile;
+}
+
+int MapTerrainProvider::GetTerrainIcon(int cell_x, int cell_y) const {
+    if (!IsValidCell(cell_x, cell_y)) {
+        return 0;
+    }
+
+    const CellLayers* layers = map_->Get_Cell_Layers();
+    if (layers) {
+        return layers->icon[MapClass::Layer_Index(cell_x, cell_y)];
+    }
+    return map_->Cell_At(cell_x, cell_y)->Get_Icon();
+}
+
+bool MapTerrainProvider::IsValidCell(int cell_x, int cell_y) const {
+    return map_ != nullptr && map_->Is_Valid_XY(cell_x, cell_y) &&
+           map_->Cell_At(cell_x, cell_y) != nullptr;
+}
+
+void MapTerrainProvider::GetMapSize(int* width, int* height) const {
+    if (width) *width = MAP_CELL_WIDTH;
+    if (height) *height = MAP_CELL_HEIGHT;
+}
+
+bool MapTerrainProvider::IsCellShrouded(int cell_x, int cell_y) const {
+    if (!IsValidCell(cell_x, cell_y)) {
+        return false;
+    }
+
+    const CellLayers* layers = map_->Get_Cell_Layers();
+    if (layers) {
+        return layers->visibility[MapClass::Layer_Index(cell_x, cell_y)] == CELL_SHROUD;
+    }
+    return map_->Cell_At(cell_x, cell_y)->Is_Shrouded();
+}
+
+const uint8_t* MapTerrainProvider::GetTemplateLayer(int* pitch) const {
+    const CellLayers* layers = map_ ? map_->Get_Cell_Layers() : nullptr;
+    if (!layers) {
+        return nullptr;
+    }
+    if (pitch) *pitch = MAP_CELL_WIDTH;
+    return layers->template_type;
+}
+
+// =============================================================================
+// Object Blips
+// =============================================================================
+
+void AddObjectRadarBlips(RadarRenderer& radar, int player_house) {
+    const CellLayers* layers = Map ? Map->Get_Cell_Layers() : nullptr;
+
+    Object_Grid().ForEach([&](ObjectClass* object, int px, int py) {
+        if (!object->Is_Active()) return;
+
+        int cell_x = px / CELL_PIXEL_SIZE;
+        int cell_y = py / CELL_PIXEL_SIZE;
+        int owner = object->Get_Owner();
+
+        bool is_enemy = (owner != player_house);
+        if (is_enemy && layers &&
+            layers->visibility[MapClass::Layer_Index(cell_x, cell_y)] != CELL_VISIBLE) {
+            return;
+        }
+
+        // Mid-range of the primary house color band (80-95)
+        uint8_t color = 88;
+        if (owner >= 0) {
+            color = GetHouseRemapTable(owner % HOUSE_COLOR_COUNT)[88];
+        }
+
+        RadarBlip blip(cell_x, cell_y, color, object->Is_Building());
+        blip.is_selected = object->Is_Selected();
+        blip.is_enemy = is_enemy;
+        radar.AddBlip(blip);
+    });
+}
@@ -6,6 +6,7 @@
 #include "game/graphics/graphics_buffer.h"
 #include "game/graphics/shape_renderer.h"
 #include "platform.h"
+#include <cstring>
 
 // =============================================================================
 // Static Data
@@ -31,7 +32,16 @@ MouseCursor::MouseCursor()
     , anim_delay_(4)
     , anim_counter_(0)
     , scale_(2)
+    , hardware_mode_(false)
+    , hw_frame_(-1)
+    , hw_shown_(false)
+    , save_x_(0)
+    , save_y_(0)
+    , save_w_(0)
+    , save_h_(0)
+    , save_valid_(false)
 {
+    memset(hw_palette_, 0, sizeof(hw_palette_));
     InitHotspots();
 }
 
@@ -111,13 +121,22 @@ bool MouseCursor::Load(const char* filename) {
         return false;
     }
 
-    // Hide system cursor
+    hw_cursors_.assign(shape_->GetFrameCount(), -1);
+    hw_frame_ = -1;
+
+    // The OS shows our cursor, or none while we draw it
+    if (hardware_mode_ && ApplyHardwareCursor()) {
+        return true;
+    }
+    hardware_mode_ = false;
     Platform_Mouse_Hide();
 
     return true;
 }
 
 void MouseCursor::Unload() {
+    InvalidateHardwareCursors();
+    hw_cursors_.clear();
     shape_.reset();
 
     // Show system cursor
@@ -149,10 +168,16 @@ void MouseCursor::SetType(CursorType type) {
 
 void MouseCursor::Show() {
     state_ &= ~CURSOR_STATE_HIDDEN;
+    if (hardware_mode_ && IsLoaded()) {
+        ApplyHardwareCursor();
+    }
 }
 
 void MouseCursor::Hide() {
     state_ |= CURSOR_STATE_HIDDEN;
+    if (hardware_mode_ && IsLoaded()) {
+        ApplyHardwareCursor();
+    }
 }
 
 void MouseCursor::Lock() {
@@ -199,6 +224,18 @@ const CursorHotspot& MouseCursor::GetHotspot() const {
     return s_hotspots[type];
 }
 
+void MouseCursor::SetScale(int scale) {
+    if (scale < 1 || scale == scale_) return;
+
+    scale_ = scale;
+    if (hardware_mode_) {
+        InvalidateHardwareCursors();
+        if (IsLoaded()) {
+            ApplyHardwareCursor();
+        }
+    }
+}
+
 void MouseCursor::GetClickPosition(int* x, int* y) const {
     int mx, my;
     GetPosition(&mx, &my);
@@ -267,24 +304,28 @@ void MouseCursor::GetAnimationInfo(CursorType type, int* base_frame, int* frame_
 void MouseCursor::Update() {
     if (!IsAnimated()) {
         current_type_ = base_type_;
-        return;
-    }
+    } else {
+        // Advance animation
+        anim_counter_++;
+        if (anim_counter_ >= anim_delay_) {
+            anim_counter_ = 0;
 
-    // Advance animation
-    anim_counter_++;
-    if (anim_counter_ >= anim_delay_) {
-        anim_counter_ = 0;
+            int base_frame, frame_count;
+            GetAnimationInfo(base_type_, &base_frame, &frame_count);
 
-        int base_frame, frame_count;
-        GetAnimationInfo(base_type_, &base_frame, &frame_count);
+            anim_frame_ = (anim_frame_ + 1) % frame_count;
+            current_type_ = static_cast<CursorType>(base_frame + anim_frame_);
+        }
+    }
 
-        anim_frame_ = (anim_frame_ + 1) % frame_count;
-        current_type_ = static_cast<CursorType>(base_frame + anim_frame_);
+    if (hardware_mode_ && IsLoaded() && !ApplyHardwareCursor()) {
+        Platform_LogWarn("MouseCursor: Hardware cursor failed, drawing in software");
+        SetHardwareMode(false);
     }
 }
 
 void MouseCursor::Draw(GraphicsBuffer& buffer) {
-    if (IsHidden() || !IsLoaded()) return;
+    if (IsHidden() || !IsLoaded() || hardware_mode_) return;
 
     int x, y;
     GetPosition(&x, &y);
@@ -304,6 +345,205 @@ void MouseCursor::DrawAt(GraphicsBuffer& buffer, int x, int y) {
     shape_->Draw(buffer, draw_x, draw_y, frame);
 }
 
+// =============================================================================
+// Save-Under
+// =============================================================================
+
+bool MouseCursor::GetDrawRect(int x, int y, int* rx, int* ry, int* rw, int* rh) const {
+    // The OS draws a hardware cursor; nothing of it is in the buffer
+    if (IsHidden() || !IsLoaded() || hardware_mode_) return false;
+
+    int frame = GetFrameForType(current_type_);
+    int w = 0, h = 0, ox = 0, oy = 0;
+    if (!shape_->GetFrameSize(frame, &w, &h) || w <= 0 || h <= 0) {
+        return false;
+    }
+    shape_->GetFrameOffset(frame, &ox, &oy);
+
+    const CursorHotspot& hotspot = GetHotspot();
+    if (rx) *rx = x - hotspot.x + ox;
+    if (ry) *ry = y - hotspot.y + oy;
+    if (rw) *rw = w;
+    if (rh) *rh = h;
+    return true;
+}
+
+void MouseCursor::DrawSaved(GraphicsBuffer& buffer) {
+    save_valid_ = false;
+    if (hardware_mode_) return;
+
+    int x, y;
+    GetPosition(&x, &y);
+
+    int rx, ry, rw, rh;
+    if (!buffer.IsLocked() || !GetDrawRect(x, y, &rx, &ry, &rw, &rh)) {
+        return;
+    }
+
+    // Clip to the buffer; only what is on screen needs saving
+    int x0 = rx < 0 ? 0 : rx;
+    int y0 = ry < 0 ? 0 : ry;
+    int x1 = rx + rw > buffer.Get_Width() ? buffer.Get_Width() : rx + rw;
+    int y1 = ry + rh > buffer.Get_Height() ? buffer.Get_Height() : ry + rh;
+
+    if (x0 < x1 && y0 < y1) {
+        save_x_ = x0;
+        save_y_ = y0;
+        save_w_ = x1 - x0;
+        save_h_ = y1 - y0;
+        save_pixels_.resize(static_cast<size_t>(save_w_) * save_h_);
+
+        const uint8_t* src = buffer.Get_Buffer() + y0 * buffer.Get_Pitch() + x0;
+        for (int row = 0; row < save_h_; row++) {
+            memcpy(&save_pixels_[static_cast<size_t>(row) * save_w_],
+                   src + row * buffer.Get_Pitch(), save_w_);
+        }
+        save_valid_ = true;
+    }
+
+    DrawAt(buffer, x, y);
+}
+
+bool MouseCursor::RestoreUnder(GraphicsBuffer& buffer, int* x, int* y, int* w, int* h) {
+    if (!save_valid_ || !buffer.IsLocked() ||
+        save_x_ + save_w_ > buffer.Get_Width() || save_y_ + save_h_ > buffer.Get_Height()) {
+        save_valid_ = false;
+        return false;
+    }
+
+    uint8_t* dst = buffer.Get_Buffer() + save_y_ * buffer.Get_Pitch() + save_x_;
+    for (int row = 0; row < save_h_; row++) {
+        memcpy(dst + row * buffer.Get_Pitch(),
+               &save_pixels_[static_cast<size_t>(row) * save_w_], save_w_);
+    }
+
+    if (x) *x = save_x_;
+    if (y) *y = save_y_;
+    if (w) *w = save_w_;
+    if (h) *h = save_h_;
+    save_valid_ = false;
+    return true;
+}
+
+// =============================================================================
+// Hardware Cursor
+// =============================================================================
+
+bool MouseCursor::SetHardwareMode(bool enabled) {
+    if (enabled == hardware_mode_) return true;
+
+    if (!enabled) {
+        hardware_mode_ = false;
+        InvalidateHardwareCursors();
+        Platform_Cursor_SetDefault();
+        if (IsLoaded()) {
+            Platform_Mouse_Hide();
+        } else {
+            Platform_Mouse_Show();
+        }
+        return true;
+    }
+
+    hardware_mode_ = true;
+    save_valid_ = false;
+    if (IsLoaded() && !ApplyHardwareCursor()) {
+        hardware_mode_ = false;
+        InvalidateHardwareCursors();
+        Platform_Cursor_SetDefault();
+        Platform_Mouse_Hide();
+        return false;
+    }
+    return true;
+}
+
+void MouseCursor::InvalidateHardwareCursors() {
+    for (int32_t& handle : hw_cursors_) {
+        if (handle >= 0) {
+            Platform_Cursor_Destroy(handle);
+            handle = -1;
+        }
+    }
+    hw_frame_ = -1;
+}
+
+int MouseCursor::GetHardwareCursorCount() const {
+    int count = 0;
+    for (int32_t handle : hw_cursors_) {
+        if (handle >= 0) count++;
+    }
+    return count;
+}
+
+bool MouseCursor::ApplyHardwareCursor() {
+    if (IsHidden()) {
+        if (hw_shown_) {
+            Platform_Mouse_Hide();
+            hw_shown_ = false;
+        }
+        return true;
+    }
+
+    // A palette change recolours every cursor
+    PaletteEntry palette[256];
+    static_assert(sizeof(palette) == sizeof(hw_palette_), "PaletteEntry must be packed RGB");
+    Platform_Graphics_GetPalette(palette, 0, 256);
+    if (memcmp(palette, hw_palette_, sizeof(hw_palette_)) != 0) {
+        InvalidateHardwareCursors();
+        memcpy(hw_palette_, palette, sizeof(hw_palette_));
+    }
+
+    int frame = GetFrameForType(current_type_);
+    if (frame < 0 || frame >= static_cast<int>(hw_cursors_.size())) {
+        return false;
+    }
+    if (frame == hw_frame_ && hw_shown_) {
+        return true;
+    }
+
+    if (hw_cursors_[frame] < 0) {
+        hw_cursors_[frame] = BuildHardwareCursor(frame);
+    }
+    if (hw_cursors_[frame] < 0 || !Platform_Cursor_Set(hw_cursors_[frame])) {
+        return false;
+    }
+    hw_frame_ = frame;
+    hw_shown_ = true;
+    return true;
+}
+
+int32_t MouseCursor::BuildHardwareCursor(int frame) {
+    int w = 0, h = 0, ox = 0, oy = 0;
+    if (!shape_->GetFrameSize(frame, &w, &h) || w <= 0 || h <= 0) {
+        return -1;
+    }
+    shape_->GetFrameOffset(frame, &ox, &oy);
+
+    std::vector<uint8_t> indices(static_cast<size_t>(w) * h);
+    if (!shape_->CopyFramePixels(frame, indices.data(), w)) {
+        return -1;
+    }
+
+    // Index 0 is transparent; scaled by pixel repetition like the window
+    const PaletteEntry* palette = reinterpret_cast<const PaletteEntry*>(hw_palette_);
+    int sw = w * scale_;
+    int sh = h * scale_;
+    std::vector<uint32_t> argb(static_cast<size_t>(sw) * sh);
+    for (int y = 0; y < sh; y++) {
+        const uint8_t* src = &indices[static_cast<size_t>(y / scale_) * w];
+        uint32_t* dst = &argb[static_cast<size_t>(y) * sw];
+        for (int x = 0; x < sw; x++) {
+            uint8_t index = src[x / scale_];
+            const PaletteEntry& c = palette[index];
+            dst[x] = index == 0 ? 0 : 0xFF000000u | (c.r << 16) | (c.g << 8) | c.b;
+        }
+    }
+
+    // Hotspot relative to the frame's top-left; frame index equals type
+    CursorHotspot hotspot = frame < CURSOR_COUNT ? s_hotspots[frame] : CursorHotspot{0, 0};
+    return Platform_Cursor_Create(argb.data(), sw, sh,
+                                  (hotspot.x - ox) * scale_, (hotspot.y - oy) * scale_);
+}
+
 int MouseCursor::GetFrameForType(CursorType type) const {
     // Direct mapping - frame index equals cursor type
     return static_cast<int>(type);
@@ -4,7 +4,10 @@
 
 #include "game/graphics/palette_manager.h"
 #include "game/graphics/tile_renderer.h"  // For TheaterType
+#include "game/mix_view.h"
 #include "platform.h"
+#include "platform/startup_trace.h"
+#include "platform/io_stats.h"
 #include <cstring>
 #include <algorithm>
 
@@ -18,7 +21,8 @@ PaletteManager& PaletteManager::Instance() {
 }
 
 PaletteManager::PaletteManager()
-    : fade_state_(FadeState::None)
+    : lookup_dirty_(true)
+    , fade_state_(FadeState::None)
     , fade_progress_(1.0f)
     , fade_step_(0.0f)
     , flash_active_(false)
@@ -27,10 +31,17 @@ PaletteManager::PaletteManager()
     , flash_duration_(0)
     , flash_frame_(0)
     , anim_range_count_(0)
+    , anim_divisor_(1)
+    , anim_skipped_(0)
     , water_anim_enabled_(false)
     , fire_anim_enabled_(false)
     , needs_apply_(false)
 {
+    // No index matches yet, so Init() marks the whole palette changed
+    memset(packed_, 0, sizeof(packed_));
+    memset(changed_mask_, 0, sizeof(changed_mask_));
+    memset(flash_table_, 0, sizeof(flash_table_));
+
     // Initialize with grayscale palette
     Init();
 }
@@ -48,18 +59,18 @@ void PaletteManager::Init() {
         original_[i] = PaletteColor(static_cast<uint8_t>(i),
                                      static_cast<uint8_t>(i),
                                      static_cast<uint8_t>(i));
-        current_[i] = original_[i];
     }
 
     // Index 0 is always black (transparent)
     original_[0] = PaletteColor(0, 0, 0);
-    current_[0] = PaletteColor(0, 0, 0);
 
     fade_state_ = FadeState::None;
     fade_progress_ = 1.0f;
     flash_active_ = false;
     anim_range_count_ = 0;
 
+    BuildFadeTables();
+    ApplyEffects();
     needs_apply_ = true;
     Apply();
 }
@@ -81,23 +92,30 @@ bool PaletteManager::LoadTheaterPalette(TheaterType theater) {
             return false;
     }
 
-    return LoadPalette(filename);
+    if (!LoadPalette(filename)) {
+        return false;
+    }
+
+    // Build house, shadow and fade remaps now rather than on first use
+    uint8_t raw[PALETTE_BYTES];
+    GetOriginalRaw(raw);
+    InitRemapTables(raw);
+    return true;
 }
 
 bool PaletteManager::LoadPalette(const char* filename) {
     if (!filename) return false;
+    STARTUP_PHASE("Palette Load");
+    IoScope io(IoTag::GRAPHICS);
 
     uint8_t raw_data[PALETTE_BYTES];
     if (Platform_Palette_Load(filename, raw_data) != 0) {
         // Try without conversion (already 8-bit)
-        int32_t size = Platform_Mix_GetSize(filename);
-        if (size != PALETTE_BYTES) {
+        MixView view(filename);
+        if (view.Size() != PALETTE_BYTES) {
             return false;
         }
-        if (Platform_Mix_Read(filename, raw_data, PALETTE_BYTES) != PALETTE_BYTES) {
-            return false;
-        }
-        LoadPaletteFromMemory(raw_data, false);
+        LoadPaletteFromMemory(view.Data(), false);
     } else {
         // Platform_Palette_Load already converted to 8-bit
         LoadPaletteFromMemory(raw_data, false);
@@ -126,6 +144,7 @@ void PaletteManager::LoadPaletteFromMemory(const uint8_t* data, bool is_6bit) {
     original_[0] = PaletteColor(0, 0, 0);
 
     // Apply current effects
+    BuildFadeTables();
     ApplyEffects();
     needs_apply_ = true;
 }
@@ -135,6 +154,7 @@ void PaletteManager::SetPalette(const PaletteColor* colors) {
         original_[i] = colors[i];
     }
     original_[0] = PaletteColor(0, 0, 0);
+    BuildFadeTables();
     ApplyEffects();
     needs_apply_ = true;
 }
@@ -146,6 +166,8 @@ void PaletteManager::SetPalette(const PaletteColor* colors) {
 void PaletteManager::SetColor(int index, const PaletteColor& color) {
     if (index >= 0 && index < PALETTE_SIZE) {
         original_[index] = color;
+        BuildFadeColumn(index);
+        lookup_dirty_ = true;
         ApplyEffects();
         needs_apply_ = true;
     }
@@ -170,6 +192,7 @@ void PaletteManager::StartFadeIn(int frames, std::function<void()> callback) {
     fade_progress_ = 0.0f;
     fade_step_ = 1.0f / frames;
     fade_callback_ = callback;
+    ApplyEffects();
     needs_apply_ = true;
 }
 
@@ -180,6 +203,7 @@ void PaletteManager::StartFadeOut(int frames, std::function<void()> callback) {
     fade_progress_ = 1.0f;
     fade_step_ = 1.0f / frames;
     fade_callback_ = callback;
+    ApplyEffects();
     needs_apply_ = true;
 }
 
@@ -230,6 +254,8 @@ void PaletteManager::StartFlash(const PaletteColor& color, int duration, float i
     flash_current_ = flash_intensity_;
     flash_duration_ = std::max(1, duration);
     flash_frame_ = 0;
+    BuildFlashTable();
+    ApplyEffects();
     needs_apply_ = true;
 }
 
@@ -306,11 +332,17 @@ void PaletteManager::Update() {
     UpdateAnimations();
 
     if (needs_apply_) {
-        Apply();
+        ApplyChanges();
     }
 }
 
 void PaletteManager::UpdateFade() {
+    if (fade_state_ != FadeState::FadingIn && fade_state_ != FadeState::FadingOut) {
+        return;
+    }
+
+    int level = GetFadeLevel();
+
     if (fade_state_ == FadeState::FadingIn) {
         fade_progress_ += fade_step_;
         if (fade_progress_ >= 1.0f) {
@@ -321,10 +353,8 @@ void PaletteManager::UpdateFade() {
                 fade_callback_ = nullptr;
             }
         }
-        ApplyEffects();
-        needs_apply_ = true;
     }
-    else if (fade_state_ == FadeState::FadingOut) {
+    else {
         fade_progress_ -= fade_step_;
         if (fade_progress_ <= 0.0f) {
             fade_progress_ = 0.0f;
@@ -334,6 +364,10 @@ void PaletteManager::UpdateFade() {
                 fade_callback_ = nullptr;
             }
         }
+    }
+
+    // Slow fades hold each table level for several frames
+    if (GetFadeLevel() != level) {
         ApplyEffects();
         needs_apply_ = true;
     }
@@ -342,6 +376,7 @@ void PaletteManager::UpdateFade() {
 void PaletteManager::UpdateFlash() {
     if (!flash_active_) return;
 
+    int level = GetFlashLevel();
     flash_frame_++;
 
     // Flash decays over duration
@@ -353,11 +388,18 @@ void PaletteManager::UpdateFlash() {
         flash_current_ = 0.0f;
     }
 
-    ApplyEffects();
-    needs_apply_ = true;
+    if (GetFlashLevel() != level) {
+        ApplyEffects();
+        needs_apply_ = true;
+    }
 }
 
 void PaletteManager::UpdateAnimations() {
+    if (++anim_skipped_ < anim_divisor_) {
+        return;
+    }
+    anim_skipped_ = 0;
+
     for (int i = 0; i < anim_range_count_; i++) {
         AnimationRange& range = anim_ranges_[i];
         range.current_frame++;
@@ -389,34 +431,90 @@ void PaletteManager::RotateRange(int start, int count, bool forward) {
         }
         original_[start + count - 1] = temp;
     }
+
+    for (int i = 0; i < count; i++) {
+        BuildFadeColumn(start + i);
+    }
 }
 
 void PaletteManager::ApplyEffects() {
-    // Start with original palette
+    int fade = GetFadeLevel();
+    int flash = GetFlashLevel();
+
+    // Flash blends towards its color: the base keeps the remaining share
+    const uint32_t* scene = fade_table_[fade * (FADE_LEVELS - flash) / FADE_LEVELS];
+    const uint32_t* ui = fade_table_[FADE_LEVELS - flash];
+    uint32_t flash_rgb = flash_table_[flash];
+
+    // Index 0 is always black
+    CommitColor(0, PaletteColor(0, 0, 0));
+
+    for (int i = 1; i < PALETTE_SIZE; i++) {
+        // Protected UI range ignores the fade
+        uint32_t rgb = (i >= UI_RANGE_START && i <= UI_RANGE_END) ? ui[i] : scene[i];
+        rgb += flash_rgb;
+
+        CommitColor(i, PaletteColor(static_cast<uint8_t>(rgb >> 16),
+                                    static_cast<uint8_t>(rgb >> 8),
+                                    static_cast<uint8_t>(rgb)));
+    }
+}
+
+void PaletteManager::BuildFadeTables() {
     for (int i = 0; i < PALETTE_SIZE; i++) {
-        current_[i] = original_[i];
+        BuildFadeColumn(i);
     }
+    lookup_dirty_ = true;
+}
 
-    // Apply fade
-    if (fade_progress_ < 1.0f) {
-        for (int i = 0; i < PALETTE_SIZE; i++) {
-            // Skip protected UI range during fade
-            if (i >= UI_RANGE_START && i <= UI_RANGE_END) {
-                continue;
-            }
-            current_[i] = current_[i].Scaled(fade_progress_);
-        }
+void PaletteManager::BuildFadeColumn(int index) {
+    const PaletteColor& c = original_[index];
+    for (int level = 0; level <= FADE_LEVELS; level++) {
+        fade_table_[level][index] = (static_cast<uint32_t>(c.r * level / FADE_LEVELS) << 16) |
+                                    (static_cast<uint32_t>(c.g * level / FADE_LEVELS) << 8) |
+                                    static_cast<uint32_t>(c.b * level / FADE_LEVELS);
     }
+}
 
-    // Apply flash
-    if (flash_active_ && flash_current_ > 0.0f) {
-        for (int i = 1; i < PALETTE_SIZE; i++) {  // Skip index 0
-            current_[i] = PaletteColor::Lerp(current_[i], flash_color_, flash_current_);
-        }
+void PaletteManager::BuildFlashTable() {
+    const PaletteColor& c = flash_color_;
+    for (int level = 0; level <= FADE_LEVELS; level++) {
+        flash_table_[level] = (static_cast<uint32_t>(c.r * level / FADE_LEVELS) << 16) |
+                              (static_cast<uint32_t>(c.g * level / FADE_LEVELS) << 8) |
+                              static_cast<uint32_t>(c.b * level / FADE_LEVELS);
     }
+}
 
-    // Index 0 is always black
-    current_[0] = PaletteColor(0, 0, 0);
+int PaletteManager::GetFadeLevel() const {
+    int level = static_cast<int>(fade_progress_ * FADE_LEVELS + 0.5f);
+    return std::max(0, std::min(FADE_LEVELS, level));
+}
+
+int PaletteManager::GetFlashLevel() const {
+    if (!flash_active_) return 0;
+    int level = static_cast<int>(flash_current_ * FADE_LEVELS + 0.5f);
+    return std::max(0, std::min(FADE_LEVELS, level));
+}
+
+void PaletteManager::CommitColor(int index, const PaletteColor& color) {
+    uint32_t packed = 0xFF000000u |
+                      (static_cast<uint32_t>(color.r) << 16) |
+                      (static_cast<uint32_t>(color.g) << 8) |
+                      static_cast<uint32_t>(color.b);
+
+    current_[index] = color;
+    if (packed_[index] != packed) {
+        packed_[index] = packed;
+        changed_mask_[index >> 6] |= 1ULL << (index & 63);
+    }
+}
+
+int PaletteManager::GetChangedCount() const {
+    int count = 0;
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        if (IsIndexChanged(i)) count++;
+    }
+    return count;
 }
 
 void PaletteManager::Apply() {
@@ -429,6 +527,33 @@ void PaletteManager::Apply() {
     }
 
     Platform_Graphics_SetPalette(entries, 0, PALETTE_SIZE);
+    memset(changed_mask_, 0, sizeof(changed_mask_));
+    needs_apply_ = false;
+}
+
+void PaletteManager::ApplyChanges() {
+    // Send each run of changed indices. A color cycle touches one or two
+    // short ranges, so the platform only sees the entries that moved.
+    int i = 0;
+    while (i < PALETTE_SIZE) {
+        if (!IsIndexChanged(i)) {
+            i++;
+            continue;
+        }
+
+        int start = i;
+        PaletteEntry entries[PALETTE_SIZE];
+        while (i < PALETTE_SIZE && IsIndexChanged(i)) {
+            entries[i - start].r = current_[i].r;
+            entries[i - start].g = current_[i].g;
+            entries[i - start].b = current_[i].b;
+            i++;
+        }
+
+        Platform_Graphics_SetPalette(entries, start, i - start);
+    }
+
+    memset(changed_mask_, 0, sizeof(changed_mask_));
     needs_apply_ = false;
 }
 
@@ -437,50 +562,44 @@ void PaletteManager::Apply() {
 // =============================================================================
 
 void PaletteManager::GenerateHouseRemap(int house, uint8_t* output) const {
-    // This would use the same logic as remap_tables.cpp
-    // For now, just return identity
-    for (int i = 0; i < PALETTE_SIZE; i++) {
-        output[i] = static_cast<uint8_t>(i);
-    }
-
-    // TODO: Implement house color remapping
-    (void)house;
+    uint8_t raw[PALETTE_BYTES];
+    GetOriginalRaw(raw);
+    GetCachedHouseRemap(raw, house, output);
 }
 
 void PaletteManager::GenerateShadowTable(uint8_t* output, float intensity) const {
-    float factor = 1.0f - intensity;
-
-    for (int i = 0; i < PALETTE_SIZE; i++) {
-        if (i == 0) {
-            output[i] = 0;
-            continue;
-        }
+    uint8_t raw[PALETTE_BYTES];
+    GetOriginalRaw(raw);
+    GetCachedShadowTable(raw, intensity, output);
+}
 
-        // Find darkened color
-        int r = static_cast<int>(original_[i].r * factor);
-        int g = static_cast<int>(original_[i].g * factor);
-        int b = static_cast<int>(original_[i].b * factor);
+int PaletteManager::FindClosestColor(int r, int g, int b, bool skip_zero) const {
+    if (lookup_dirty_) {
+        uint8_t raw[PALETTE_BYTES];
+        GetOriginalRaw(raw);
+        lookup_.Build(raw);
+        lookup_dirty_ = false;
+    }
 
-        output[i] = static_cast<uint8_t>(FindClosestColor(r, g, b, true));
+    int best_index = lookup_.Find(r, g, b);
+    if (skip_zero) {
+        return best_index;
     }
+
+    // The lookup never returns 0; check it separately (wins ties)
+    auto dist = [r, g, b](const PaletteColor& c) {
+        int dr = r - c.r;
+        int dg = g - c.g;
+        int db = b - c.b;
+        return dr * dr + dg * dg + db * db;
+    };
+    return dist(original_[0]) <= dist(original_[best_index]) ? 0 : best_index;
 }
 
-int PaletteManager::FindClosestColor(int r, int g, int b, bool skip_zero) const {
-    int best_index = skip_zero ? 1 : 0;
-    int best_dist = 0x7FFFFFFF;
-
-    int start = skip_zero ? 1 : 0;
-    for (int i = start; i < PALETTE_SIZE; i++) {
-        int dr = r - original_[i].r;
-        int dg = g - original_[i].g;
-        int db = b - original_[i].b;
-        int dist = dr * dr + dg * dg + db * db;
-
-        if (dist < best_dist) {
-            best_dist = dist;
-            best_index = i;
-        }
+void PaletteManager::GetOriginalRaw(uint8_t* output) const {
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        output[i * 3 + 0] = original_[i].r;
+        output[i * 3 + 1] = original_[i].g;
+        output[i * 3 + 2] = original_[i].b;
     }
-
-    return best_index;
 }
@@ -34,6 +34,11 @@ RadarRenderer::RadarRenderer()
     , blink_rate_(8)
     , blink_state_(false)
     , static_frame_(0)
+    , panel_dirty_(true)
+    , panel_redraws_(0)
+    , drawn_blink_(false)
+    , refresh_interval_(1)
+    , refresh_skipped_(0)
 {
 }
 
@@ -56,6 +61,7 @@ bool RadarRenderer::Initialize(int map_width, int map_height) {
     scale_y_ = static_cast<float>(radar_height_) / static_cast<float>(map_height);
 
     // Create terrain buffer
+    BuildLookupTables();
     CreateTerrainBuffer();
 
     initialized_ = true;
@@ -64,6 +70,10 @@ bool RadarRenderer::Initialize(int map_width, int map_height) {
 
 void RadarRenderer::Shutdown() {
     terrain_buffer_.reset();
+    dirty_cells_.clear();
+    panel_.reset();
+    drawn_blips_.clear();
+    panel_dirty_ = true;
     terrain_ = nullptr;
     initialized_ = false;
 }
@@ -75,11 +85,51 @@ void RadarRenderer::CreateTerrainBuffer() {
     terrain_dirty_ = true;
 }
 
+void RadarRenderer::BuildLookupTables() {
+    // Same float mapping as before, evaluated once per row/column
+    radar_to_cell_x_.resize(static_cast<size_t>(radar_width_));
+    radar_to_cell_y_.resize(static_cast<size_t>(radar_height_));
+    for (int x = 0; x < radar_width_; x++) {
+        radar_to_cell_x_[x] = static_cast<int>(static_cast<float>(x) / scale_x_);
+    }
+    for (int y = 0; y < radar_height_; y++) {
+        radar_to_cell_y_[y] = static_cast<int>(static_cast<float>(y) / scale_y_);
+    }
+
+    cell_to_radar_x_.resize(static_cast<size_t>(map_width_));
+    cell_to_radar_y_.resize(static_cast<size_t>(map_height_));
+    for (int cx = 0; cx < map_width_; cx++) {
+        cell_to_radar_x_[cx] = static_cast<int>(static_cast<float>(cx) * scale_x_);
+    }
+    for (int cy = 0; cy < map_height_; cy++) {
+        cell_to_radar_y_[cy] = static_cast<int>(static_cast<float>(cy) * scale_y_);
+    }
+
+    // Radar->cell is monotonic, so each cell covers one contiguous span
+    // (possibly empty when the map is larger than the radar)
+    cell_span_x_.assign(static_cast<size_t>(map_width_ + 1), radar_width_);
+    cell_span_y_.assign(static_cast<size_t>(map_height_ + 1), radar_height_);
+    for (int x = radar_width_ - 1; x >= 0; x--) {
+        for (int cx = radar_to_cell_x_[x]; cx >= 0 && cell_span_x_[cx] > x; cx--) {
+            cell_span_x_[cx] = x;
+        }
+    }
+    for (int y = radar_height_ - 1; y >= 0; y--) {
+        for (int cy = radar_to_cell_y_[y]; cy >= 0 && cell_span_y_[cy] > y; cy--) {
+            cell_span_y_[cy] = y;
+        }
+    }
+}
+
 // =============================================================================
 // Viewport
 // =============================================================================
 
 void RadarRenderer::SetViewport(int cell_x, int cell_y, int width_cells, int height_cells) {
+    if (cell_x != viewport_x_ || cell_y != viewport_y_ ||
+        width_cells != viewport_width_ || height_cells != viewport_height_) {
+        panel_dirty_ = true;
+    }
     viewport_x_ = cell_x;
     viewport_y_ = cell_y;
     viewport_width_ = width_cells;
@@ -96,15 +146,23 @@ bool RadarRenderer::RadarToCell(int radar_x, int radar_y, int* cell_x, int* cell
         return false;
     }
 
-    if (cell_x) *cell_x = static_cast<int>(static_cast<float>(local_x) / scale_x_);
-    if (cell_y) *cell_y = static_cast<int>(static_cast<float>(local_y) / scale_y_);
+    if (cell_x) *cell_x = radar_to_cell_x_[local_x];
+    if (cell_y) *cell_y = radar_to_cell_y_[local_y];
 
     return true;
 }
 
 void RadarRenderer::CellToRadar(int cell_x, int cell_y, int* radar_x, int* radar_y) const {
-    if (radar_x) *radar_x = radar_x_ + static_cast<int>(static_cast<float>(cell_x) * scale_x_);
-    if (radar_y) *radar_y = radar_y_ + static_cast<int>(static_cast<float>(cell_y) * scale_y_);
+    if (radar_x) {
+        *radar_x = radar_x_ + ((cell_x >= 0 && cell_x < map_width_ && !cell_to_radar_x_.empty())
+            ? cell_to_radar_x_[cell_x]
+            : static_cast<int>(static_cast<float>(cell_x) * scale_x_));
+    }
+    if (radar_y) {
+        *radar_y = radar_y_ + ((cell_y >= 0 && cell_y < map_height_ && !cell_to_radar_y_.empty())
+            ? cell_to_radar_y_[cell_y]
+            : static_cast<int>(static_cast<float>(cell_y) * scale_y_));
+    }
 }
 
 // =============================================================================
@@ -133,19 +191,84 @@ void RadarRenderer::AddBlip(int cell_x, int cell_y, uint8_t color, bool is_build
 void RadarRenderer::UpdateTerrainImage() {
     if (!terrain_buffer_ || !terrain_) return;
 
+    TerrainSource source = GetTerrainSource();
+
     // Fill terrain buffer from map data
     for (int y = 0; y < radar_height_; y++) {
-        int cell_y = static_cast<int>(static_cast<float>(y) / scale_y_);
+        int cell_y = radar_to_cell_y_[y];
+        uint8_t* row = terrain_buffer_.get() + static_cast<size_t>(y * radar_width_);
 
         for (int x = 0; x < radar_width_; x++) {
-            int cell_x = static_cast<int>(static_cast<float>(x) / scale_x_);
-
-            uint8_t color = GetTerrainColor(cell_x, cell_y);
-            terrain_buffer_[static_cast<size_t>(y * radar_width_ + x)] = color;
+            row[x] = CellColor(source, radar_to_cell_x_[x], cell_y);
         }
     }
 
     terrain_dirty_ = false;
+    dirty_cells_.clear();
+}
+
+void RadarRenderer::InvalidateCell(int cell_x, int cell_y) {
+    panel_dirty_ = true;
+    if (terrain_dirty_) return;  // Full rebuild already pending
+    if (cell_x < 0 || cell_x >= map_width_ || cell_y < 0 || cell_y >= map_height_) return;
+
+    // Past this many cells a full rebuild is cheaper than tracking them
+    if (dirty_cells_.size() >= MAX_DIRTY_CELLS) {
+        InvalidateTerrain();
+        return;
+    }
+    dirty_cells_.push_back((static_cast<uint32_t>(cell_y) << 16) | static_cast<uint32_t>(cell_x));
+}
+
+void RadarRenderer::InvalidateTerrain() {
+    terrain_dirty_ = true;
+    panel_dirty_ = true;
+    dirty_cells_.clear();
+}
+
+void RadarRenderer::UpdateDirtyCells() {
+    if (!terrain_buffer_ || !terrain_) return;
+
+    TerrainSource source = GetTerrainSource();
+
+    for (uint32_t packed : dirty_cells_) {
+        int cell_x = static_cast<int>(packed & 0xFFFF);
+        int cell_y = static_cast<int>(packed >> 16);
+        uint8_t color = CellColor(source, cell_x, cell_y);
+
+        // Rewrite just the pixels this cell maps to
+        for (int y = cell_span_y_[cell_y]; y < cell_span_y_[cell_y + 1]; y++) {
+            uint8_t* row = terrain_buffer_.get() + static_cast<size_t>(y * radar_width_);
+            for (int x = cell_span_x_[cell_x]; x < cell_span_x_[cell_x + 1]; x++) {
+                row[x] = color;
+            }
+        }
+    }
+
+    dirty_cells_.clear();
+}
+
+RadarRenderer::TerrainSource RadarRenderer::GetTerrainSource() const {
+    // Packed template bytes avoid two virtual calls per radar pixel
+    TerrainSource source = { nullptr, 0, 0, 0 };
+    if (terrain_) {
+        source.layer = terrain_->GetTemplateLayer(&source.pitch);
+        if (source.layer) {
+            terrain_->GetMapSize(&source.width, &source.height);
+        }
+    }
+    return source;
+}
+
+uint8_t RadarRenderer::CellColor(const TerrainSource& source, int cell_x, int cell_y) const {
+    if (!source.layer) {
+        return GetTerrainColor(cell_x, cell_y);
+    }
+    if (cell_x >= source.width || cell_y >= source.height) {
+        return 0;
+    }
+    uint8_t tile = source.layer[cell_y * source.pitch + cell_x];
+    return TileColor(tile == 0xFF ? 0 : tile);
 }
 
 uint8_t RadarRenderer::GetTerrainColor(int cell_x, int cell_y) const {
@@ -153,11 +276,12 @@ uint8_t RadarRenderer::GetTerrainColor(int cell_x, int cell_y) const {
         return 0;  // Black for invalid
     }
 
-    // Get terrain tile and return appropriate color
-    // These colors approximate C&C radar colors
-    int tile = terrain_->GetTerrainTile(cell_x, cell_y);
+    return TileColor(terrain_->GetTerrainTile(cell_x, cell_y));
+}
 
+uint8_t RadarRenderer::TileColor(int tile) {
     // Simple color mapping based on tile type
+    // These colors approximate C&C radar colors
     // In the real game, this would be based on theater palette
     if (tile < 0) return 0;       // Invalid
     if (tile < 16) return 175;    // Clear - light green
@@ -194,6 +318,7 @@ void RadarRenderer::Update() {
     // Update static animation for jammed state
     if (state_ == RadarState::JAMMED) {
         static_frame_ = (static_frame_ + 1) % 8;
+        panel_dirty_ = true;
     }
 }
 
@@ -201,9 +326,50 @@ void RadarRenderer::Update() {
 // Rendering
 // =============================================================================
 
+void RadarRenderer::SetState(RadarState state) {
+    if (state != state_) {
+        state_ = state;
+        panel_dirty_ = true;
+    }
+}
+
 void RadarRenderer::Draw(GraphicsBuffer& buffer) {
     if (!initialized_) return;
 
+    // Between refreshes the cached panel stands in as is
+    bool refresh = panel_dirty_ || !panel_ || ++refresh_skipped_ >= refresh_interval_;
+    if (refresh) {
+        refresh_skipped_ = 0;
+    }
+
+    bool live = refresh && (state_ == RadarState::ACTIVE || state_ == RadarState::SPYING);
+    if (live && blip_source_) {
+        ClearBlips();
+        blip_source_(*this);
+    }
+
+    if (!panel_dirty_ && refresh) {
+        if (terrain_ && (terrain_dirty_ || !dirty_cells_.empty())) {
+            panel_dirty_ = true;
+        } else if (live && (BlipsChanged() ||
+                            (blink_state_ != drawn_blink_ && HasSelectedBlips()))) {
+            panel_dirty_ = true;
+        }
+    }
+
+    if (panel_dirty_) {
+        RenderPanel();
+    }
+
+    if (panel_ && panel_->Lock()) {
+        buffer.Blit_From(*panel_, 0, 0, radar_x_ - 1, radar_y_ - 1);
+        panel_->Unlock();
+    } else {
+        DrawContents(buffer);
+    }
+}
+
+void RadarRenderer::DrawContents(GraphicsBuffer& buffer) {
     DrawFrame(buffer);
 
     switch (state_) {
@@ -225,6 +391,55 @@ void RadarRenderer::Draw(GraphicsBuffer& buffer) {
     }
 }
 
+void RadarRenderer::RenderPanel() {
+    int w = radar_width_ + 2;
+    int h = radar_height_ + 2;
+    if (!panel_ || panel_->Get_Width() != w || panel_->Get_Height() != h) {
+        panel_ = std::make_unique<GraphicsBuffer>(w, h);
+    }
+    if (!panel_->Lock()) {
+        return;
+    }
+
+    // Draw as if the radar sat at (1, 1); the frame takes the outer ring
+    int saved_x = radar_x_;
+    int saved_y = radar_y_;
+    radar_x_ = 1;
+    radar_y_ = 1;
+    DrawContents(*panel_);
+    radar_x_ = saved_x;
+    radar_y_ = saved_y;
+
+    panel_->Unlock();
+
+    drawn_blips_.assign(blips_, blips_ + blip_count_);
+    drawn_blink_ = blink_state_;
+    panel_dirty_ = false;
+    panel_redraws_++;
+}
+
+bool RadarRenderer::BlipsChanged() const {
+    if (static_cast<int>(drawn_blips_.size()) != blip_count_) {
+        return true;
+    }
+    for (int i = 0; i < blip_count_; i++) {
+        const RadarBlip& a = blips_[i];
+        const RadarBlip& b = drawn_blips_[static_cast<size_t>(i)];
+        if (a.cell_x != b.cell_x || a.cell_y != b.cell_y || a.color != b.color ||
+            a.is_building != b.is_building || a.is_selected != b.is_selected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RadarRenderer::HasSelectedBlips() const {
+    for (int i = 0; i < blip_count_; i++) {
+        if (blips_[i].is_selected) return true;
+    }
+    return false;
+}
+
 void RadarRenderer::DrawFrame(GraphicsBuffer& buffer) {
     // Draw border around radar
     int x1 = radar_x_ - 1;
@@ -245,17 +460,18 @@ void RadarRenderer::DrawTerrain(GraphicsBuffer& buffer) {
     if (!terrain_buffer_) return;
 
     // Update terrain if dirty
-    if (terrain_dirty_ && terrain_) {
-        UpdateTerrainImage();
+    if (terrain_) {
+        if (terrain_dirty_) {
+            UpdateTerrainImage();
+        } else if (!dirty_cells_.empty()) {
+            UpdateDirtyCells();
+        }
     }
 
     // Copy terrain buffer to screen
-    for (int y = 0; y < radar_height_; y++) {
-        for (int x = 0; x < radar_width_; x++) {
-            uint8_t color = terrain_buffer_[static_cast<size_t>(y * radar_width_ + x)];
-            buffer.Put_Pixel(radar_x_ + x, radar_y_ + y, color);
-        }
-    }
+    buffer.Blit_From_Raw(terrain_buffer_.get(), radar_width_,
+                         0, 0, radar_width_, radar_height_,
+                         radar_x_, radar_y_, radar_width_, radar_height_);
 }
 
 void RadarRenderer::DrawBlips(GraphicsBuffer& buffer) {
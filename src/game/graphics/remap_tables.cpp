@@ -4,7 +4,10 @@
 
 #include "game/graphics/remap_tables.h"
 #include "platform.h"
+#include <array>
 #include <cstring>
+#include <memory>
+#include <unordered_map>
 
 // =============================================================================
 // Table Storage
@@ -27,24 +30,88 @@ static uint8_t s_fade_tables[16 * 256];
 // Ghost table
 static uint8_t s_ghost_table[256];
 
+// Cache of generated tables, key = (crc << 32) | (kind << 24) | (house << 16) | intensity
+enum RemapCacheKind : uint64_t {
+    CACHE_HOUSE = 1,
+    CACHE_SHADOW = 2,
+};
+
+static const size_t MAX_CACHED_TABLES = 512;
+static const size_t MAX_CACHED_LOOKUPS = 4;
+
+static std::unordered_map<uint64_t, std::array<uint8_t, 256>> s_table_cache;
+static std::unordered_map<uint32_t, std::unique_ptr<ColorLookup>> s_lookups;
+
 // =============================================================================
 // Color Matching
 // =============================================================================
 
-// Find closest palette color to given RGB
-static uint8_t FindClosestColor(const uint8_t* palette, int r, int g, int b) {
-    int best_index = 0;
-    int best_dist = 0x7FFFFFFF;
+void ColorLookup::Build(const uint8_t* palette) {
+    memcpy(palette_, palette, sizeof(palette_));
+
+    // Squared distance from each color channel value to the nearest and
+    // farthest point of each cell along that channel
+    static const int CELL_SIZE = 256 / CELLS;
+    std::vector<uint32_t> near_d(3 * 256 * CELLS);
+    std::vector<uint32_t> far_d(3 * 256 * CELLS);
+    auto at = [](int ch, int i, int c) { return (ch * 256 + i) * CELLS + c; };
+    for (int ch = 0; ch < 3; ch++) {
+        for (int i = 1; i < 256; i++) {
+            int v = palette[i * 3 + ch];
+            for (int c = 0; c < CELLS; c++) {
+                int lo = c * CELL_SIZE;
+                int hi = lo + CELL_SIZE - 1;
+                int n = v < lo ? lo - v : (v > hi ? v - hi : 0);
+                int f = v - lo > hi - v ? v - lo : hi - v;
+                near_d[at(ch, i, c)] = static_cast<uint32_t>(n * n);
+                far_d[at(ch, i, c)] = static_cast<uint32_t>(f * f);
+            }
+        }
+    }
+
+    offsets_.assign(CELLS * CELLS * CELLS + 1, 0);
+    candidates_.clear();
+
+    for (int rc = 0; rc < CELLS; rc++) {
+        for (int gc = 0; gc < CELLS; gc++) {
+            for (int bc = 0; bc < CELLS; bc++) {
+                // Whatever point of the cell is queried, its nearest color
+                // is no farther than the best worst case
+                uint32_t bound = 0xFFFFFFFF;
+                for (int i = 1; i < 256; i++) {
+                    uint32_t d = far_d[at(0, i, rc)] + far_d[at(1, i, gc)] + far_d[at(2, i, bc)];
+                    if (d < bound) bound = d;
+                }
+
+                int cell = (rc << (2 * CELL_BITS)) | (gc << CELL_BITS) | bc;
+                offsets_[cell] = static_cast<uint32_t>(candidates_.size());
+                for (int i = 1; i < 256; i++) {
+                    uint32_t d = near_d[at(0, i, rc)] + near_d[at(1, i, gc)] + near_d[at(2, i, bc)];
+                    if (d <= bound) {
+                        candidates_.push_back(static_cast<uint8_t>(i));
+                    }
+                }
+            }
+        }
+    }
+    offsets_[CELLS * CELLS * CELLS] = static_cast<uint32_t>(candidates_.size());
+}
+
+uint8_t ColorLookup::Find(int r, int g, int b) const {
+    r = r > 255 ? 255 : (r < 0 ? 0 : r);
+    g = g > 255 ? 255 : (g < 0 ? 0 : g);
+    b = b > 255 ? 255 : (b < 0 ? 0 : b);
 
-    for (int i = 1; i < 256; i++) {  // Skip index 0 (transparent)
-        int pr = palette[i * 3 + 0];
-        int pg = palette[i * 3 + 1];
-        int pb = palette[i * 3 + 2];
+    static const int SHIFT = 8 - CELL_BITS;
+    int cell = ((r >> SHIFT) << (2 * CELL_BITS)) | ((g >> SHIFT) << CELL_BITS) | (b >> SHIFT);
 
-        // Simple RGB distance (could use LAB for better results)
-        int dr = r - pr;
-        int dg = g - pg;
-        int db = b - pb;
+    int best_index = 1;
+    int best_dist = 0x7FFFFFFF;
+    for (uint32_t c = offsets_[cell]; c < offsets_[cell + 1]; c++) {
+        int i = candidates_[c];
+        int dr = r - palette_[i * 3 + 0];
+        int dg = g - palette_[i * 3 + 1];
+        int db = b - palette_[i * 3 + 2];
         int dist = dr * dr + dg * dg + db * db;
 
         if (dist < best_dist) {
@@ -56,6 +123,33 @@ static uint8_t FindClosestColor(const uint8_t* palette, int r, int g, int b) {
     return static_cast<uint8_t>(best_index);
 }
 
+uint32_t GetPaletteCRC(const uint8_t* palette) {
+    return Platform_CRC32(palette, 768);
+}
+
+// Lookup for a palette, built the first time the palette is seen
+static const ColorLookup& AcquireLookup(const uint8_t* palette, uint32_t crc) {
+    auto it = s_lookups.find(crc);
+    if (it != s_lookups.end()) {
+        return *it->second;
+    }
+
+    if (s_lookups.size() >= MAX_CACHED_LOOKUPS) {
+        s_lookups.clear();
+    }
+
+    std::unique_ptr<ColorLookup> lookup(new ColorLookup());
+    lookup->Build(palette);
+    const ColorLookup& result = *lookup;
+    s_lookups[crc] = std::move(lookup);
+    return result;
+}
+
+// Find closest palette color to given RGB
+static uint8_t FindClosestColor(const ColorLookup& lookup, int r, int g, int b) {
+    return lookup.Find(r, g, b);
+}
+
 // =============================================================================
 // House Colors
 // =============================================================================
@@ -77,7 +171,7 @@ static const int HOUSE_REMAP_START = 80;
 static const int HOUSE_REMAP_END = 95;
 static const int HOUSE_REMAP_COUNT = HOUSE_REMAP_END - HOUSE_REMAP_START + 1;
 
-static void GenerateHouseTable(int house, const uint8_t* palette, uint8_t* output) {
+static void GenerateHouseTable(int house, const ColorLookup& lookup, uint8_t* output) {
     // Start with identity
     for (int i = 0; i < 256; i++) {
         output[i] = static_cast<uint8_t>(i);
@@ -107,7 +201,7 @@ static void GenerateHouseTable(int house, const uint8_t* palette, uint8_t* outpu
         b = b > 255 ? 255 : (b < 0 ? 0 : b);
 
         // Find closest palette color
-        output[src_index] = FindClosestColor(palette, r, g, b);
+        output[src_index] = FindClosestColor(lookup, r, g, b);
     }
 }
 
@@ -137,7 +231,8 @@ const uint8_t* GetPlayerRemapTable(int player, bool is_multiplayer) {
 // Shadow Tables
 // =============================================================================
 
-void GenerateShadowTable(const uint8_t* palette, uint8_t* output, float intensity) {
+static void GenerateShadowTable(const uint8_t* palette, const ColorLookup& lookup,
+                                uint8_t* output, float intensity) {
     // Clamp intensity
     if (intensity < 0.0f) intensity = 0.0f;
     if (intensity > 1.0f) intensity = 1.0f;
@@ -161,10 +256,15 @@ void GenerateShadowTable(const uint8_t* palette, uint8_t* output, float intensit
         b = static_cast<int>(b * factor);
 
         // Find closest palette color
-        output[i] = FindClosestColor(palette, r, g, b);
+        output[i] = FindClosestColor(lookup, r, g, b);
     }
 }
 
+void GenerateShadowTable(const uint8_t* palette, uint8_t* output, float intensity) {
+    GenerateShadowTable(palette, AcquireLookup(palette, GetPaletteCRC(palette)),
+                        output, intensity);
+}
+
 const uint8_t* GetShadowTable() {
     return s_shadow_table;
 }
@@ -174,6 +274,8 @@ const uint8_t* GetShadowTable() {
 // =============================================================================
 
 void GenerateFadeTables(const uint8_t* palette, uint8_t* output) {
+    const ColorLookup& lookup = AcquireLookup(palette, GetPaletteCRC(palette));
+
     for (int level = 0; level < 16; level++) {
         uint8_t* table = output + level * 256;
 
@@ -197,7 +299,7 @@ void GenerateFadeTables(const uint8_t* palette, uint8_t* output) {
             b = static_cast<int>(b * factor);
 
             // Find closest palette color
-            table[i] = FindClosestColor(palette, r, g, b);
+            table[i] = FindClosestColor(lookup, r, g, b);
         }
     }
 }
@@ -210,7 +312,8 @@ const uint8_t* GetFadeTables() {
 // Ghost Table
 // =============================================================================
 
-static void GenerateGhostTable(const uint8_t* palette, uint8_t* output) {
+static void GenerateGhostTable(const uint8_t* palette, const ColorLookup& lookup,
+                               uint8_t* output) {
     // Ghost effect lightens colors
     for (int i = 0; i < 256; i++) {
         if (i == 0) {
@@ -228,7 +331,7 @@ static void GenerateGhostTable(const uint8_t* palette, uint8_t* output) {
         g = g + (255 - g) / 2;
         b = b + (255 - b) / 2;
 
-        output[i] = FindClosestColor(palette, r, g, b);
+        output[i] = FindClosestColor(lookup, r, g, b);
     }
 }
 
@@ -236,6 +339,66 @@ const uint8_t* GetGhostTable() {
     return s_ghost_table;
 }
 
+// =============================================================================
+// Cached Tables
+// =============================================================================
+
+static uint64_t CacheKey(uint32_t crc, uint64_t kind, int house, int intensity) {
+    return (static_cast<uint64_t>(crc) << 32) | (kind << 24) |
+           (static_cast<uint64_t>(house & 0xFF) << 16) | static_cast<uint64_t>(intensity & 0xFFFF);
+}
+
+// Cache slot for a key; fill is called only on a miss
+template <typename Fill>
+static const uint8_t* CachedTable(uint64_t key, Fill fill) {
+    auto it = s_table_cache.find(key);
+    if (it != s_table_cache.end()) {
+        return it->second.data();
+    }
+
+    if (s_table_cache.size() >= MAX_CACHED_TABLES) {
+        s_table_cache.clear();
+    }
+
+    std::array<uint8_t, 256>& table = s_table_cache[key];
+    fill(table.data());
+    return table.data();
+}
+
+void GetCachedHouseRemap(const uint8_t* palette, int house, uint8_t* output) {
+    if (house < 0 || house >= HOUSE_COLOR_COUNT) {
+        for (int i = 0; i < 256; i++) {
+            output[i] = static_cast<uint8_t>(i);
+        }
+        return;
+    }
+
+    uint32_t crc = GetPaletteCRC(palette);
+    const uint8_t* table = CachedTable(CacheKey(crc, CACHE_HOUSE, house, 0),
+        [&](uint8_t* fill) {
+            GenerateHouseTable(house, AcquireLookup(palette, crc), fill);
+        });
+    memcpy(output, table, 256);
+}
+
+void GetCachedShadowTable(const uint8_t* palette, float intensity, uint8_t* output) {
+    if (intensity < 0.0f) intensity = 0.0f;
+    if (intensity > 1.0f) intensity = 1.0f;
+    int level = static_cast<int>(intensity * 256.0f + 0.5f);
+
+    uint32_t crc = GetPaletteCRC(palette);
+    const uint8_t* table = CachedTable(CacheKey(crc, CACHE_SHADOW, 0, level),
+        [&](uint8_t* fill) {
+            GenerateShadowTable(palette, AcquireLookup(palette, crc), fill, level / 256.0f);
+        });
+    memcpy(output, table, 256);
+}
+
+void ClearRemapCache() {
+    s_table_cache.clear();
+    s_lookups.clear();
+}
+
 // =============================================================================
 // Identity Table
 // =============================================================================
@@ -258,19 +421,23 @@ void InitRemapTables(const uint8_t* palette) {
         s_identity_table[i] = static_cast<uint8_t>(i);
     }
 
+    // Build (or reuse) the palette's color lookup once for every table
+    uint32_t crc = GetPaletteCRC(palette);
+    const ColorLookup& lookup = AcquireLookup(palette, crc);
+
     // Generate house color tables
     for (int h = 0; h < HOUSE_COLOR_COUNT; h++) {
-        GenerateHouseTable(h, palette, s_house_tables[h]);
+        GetCachedHouseRemap(palette, h, s_house_tables[h]);
     }
 
     // Generate shadow table (50% darkening)
-    GenerateShadowTable(palette, s_shadow_table, 0.5f);
+    GetCachedShadowTable(palette, 0.5f, s_shadow_table);
 
     // Generate fade tables
     GenerateFadeTables(palette, s_fade_tables);
 
     // Generate ghost table
-    GenerateGhostTable(palette, s_ghost_table);
+    GenerateGhostTable(palette, lookup, s_ghost_table);
 
     s_tables_initialized = true;
 }
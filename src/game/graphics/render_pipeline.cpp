@@ -3,16 +3,323 @@
  */
 
 #include "game/graphics/render_pipeline.h"
+#include "game/graphics/blit_batch.h"
+#include "graphics/dirty_rect.h"
 #include "game/graphics/sidebar_render.h"
 #include "game/graphics/radar_render.h"
+#include "game/graphics/selection_overlay.h"
 #include "game/graphics/tile_renderer.h"
 #include "game/graphics/mouse_cursor.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/text_cache.h"
+#include "game/job_system.h"
+#include "game/projectile.h"
+#include "game/quality_governor.h"
+#include "platform/memory_arena.h"
+#include "platform/profiler.h"
 #include "platform.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 
 // Use enum RenderLayer from header (it's an enum class)
 using LayerType = RenderLayer;
 
+// =============================================================================
+// Render Jobs
+// =============================================================================
+
+/**
+ * RenderJob - One frame handed to the render thread
+ *
+ * Everything the scene stages read is copied in, so the game thread can
+ * record the next frame (and reset the frame arena) while this one draws.
+ */
+namespace {
+
+// Culling works on map cells, the terrain grid
+constexpr int CULL_CELL_SIZE = 24;
+
+int Floor_Div(int value, int divisor) {
+    int q = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? q - 1 : q;
+}
+
+// Screen area one queued command covers
+struct CommandRect {
+    int32_t x, y, width, height;
+};
+
+// Shapes go by their frame, placed as ShapeRenderer places it; objects by
+// GetBounds(). Empty if the frame is unknown.
+CommandRect Command_Bounds(const RenderCommand& cmd, ShapeRenderer* renderer) {
+    CommandRect rect = {cmd.screen_x, cmd.screen_y, 0, 0};
+    if (cmd.object) {
+        int bx, by, bw, bh;
+        cmd.object->GetBounds(bx, by, bw, bh);
+        rect.x += bx;
+        rect.y += by;
+        rect.width = bw;
+        rect.height = bh;
+        return rect;
+    }
+
+    int width, height, x_offset, y_offset;
+    if (renderer && renderer->GetFrameSize(cmd.frame, &width, &height) &&
+        renderer->GetFrameOffset(cmd.frame, &x_offset, &y_offset)) {
+        rect.x += x_offset;
+        rect.y += y_offset;
+        if (cmd.flags & SHAPE_CENTER) {
+            rect.x -= width / 2;
+            rect.y -= height / 2;
+        }
+        rect.width = width;
+        rect.height = height;
+    }
+    return rect;
+}
+
+} // namespace
+
+/**
+ * OcclusionMap - What hides each cell of the view this frame
+ *
+ * Per cell: the lowest layer that covers all of it with opaque pixels
+ * (0 = none, which hides nothing), with SHROUDED set for shroud, which
+ * covers from the shroud layer on and is filled black there.
+ */
+struct RenderPipeline::OcclusionMap {
+    static constexpr uint8_t SHROUDED = 0x80;
+    static constexpr uint8_t LAYER_MASK = 0x7F;
+
+    bool active = false;        // Anything hidden at all
+    int columns = 0;
+    int rows = 0;
+    int origin_x = 0;           // Screen position of cell (0, 0)
+    int origin_y = 0;
+    std::vector<uint8_t> cells;
+
+    uint8_t Cover(int column, int row) const {
+        return cells[static_cast<size_t>(row) * columns + column] & LAYER_MASK;
+    }
+
+    // Drawn entirely in cells covered by higher layers?
+    bool Hides(const CommandRect& rect, int layer) const {
+        if (rect.width <= 0 || rect.height <= 0) {
+            return false;
+        }
+        int c0 = Floor_Div(rect.x - origin_x, CULL_CELL_SIZE);
+        int c1 = Floor_Div(rect.x + rect.width - 1 - origin_x, CULL_CELL_SIZE);
+        int r0 = Floor_Div(rect.y - origin_y, CULL_CELL_SIZE);
+        int r1 = Floor_Div(rect.y + rect.height - 1 - origin_y, CULL_CELL_SIZE);
+        if (c0 < 0 || r0 < 0 || c1 >= columns || r1 >= rows) {
+            return false;
+        }
+        for (int row = r0; row <= r1; row++) {
+            for (int column = c0; column <= c1; column++) {
+                if (Cover(column, row) <= layer) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Black out shrouded cells within a target whose row 0 is screen row band_top
+    void Fill_Shroud(GraphicsBuffer& target, int band_top) const {
+        BlitBatch batch(target);
+        for (int row = 0; row < rows; row++) {
+            int y = origin_y + row * CULL_CELL_SIZE - band_top;
+            if (y + CULL_CELL_SIZE <= 0 || y >= target.Get_Height()) {
+                continue;
+            }
+            const uint8_t* cell = &cells[static_cast<size_t>(row) * columns];
+            for (int column = 0; column < columns; column++) {
+                // Runs of shroud in one fill
+                if (!(cell[column] & SHROUDED)) {
+                    continue;
+                }
+                int run = column;
+                while (run + 1 < columns && (cell[run + 1] & SHROUDED)) {
+                    run++;
+                }
+                batch.Fill_Rect(origin_x + column * CULL_CELL_SIZE, y,
+                                (run - column + 1) * CULL_CELL_SIZE, CULL_CELL_SIZE, 0);
+                column = run;
+            }
+        }
+    }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float Elapsed_Ms(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+// Overdraw heatmap colors for 0, 1, 2, ... writes: black, grey, green,
+// bright green, dark red, then bright red for anything more
+constexpr uint8_t OVERDRAW_COLORS[] = {0, 176, 120, 250, 196, 252};
+constexpr int OVERDRAW_LEVELS = sizeof(OVERDRAW_COLORS) / sizeof(OVERDRAW_COLORS[0]);
+
+// Draw one queued command; y is its screen row minus the target's first row
+bool Draw_Command(GraphicsBuffer& target, const RenderCommand& cmd,
+                  ShapeRenderer* renderer, int y) {
+    if (cmd.object) {
+        cmd.object->Draw(target, cmd.screen_x, y);
+        return true;
+    }
+    return renderer &&
+           renderer->DrawRemapped(target, cmd.screen_x, y, cmd.frame, cmd.remap, cmd.flags);
+}
+
+// Sorted by layer, so each layer is one contiguous range
+void Index_Layers(const RenderCommand* commands, size_t count, uint32_t* layer_start) {
+    const uint32_t layer_count = static_cast<uint32_t>(LayerType::COUNT);
+    uint32_t index = 0;
+    for (uint32_t layer = 0; layer <= layer_count; layer++) {
+        while (index < count && commands[index].layer < layer) {
+            index++;
+        }
+        layer_start[layer] = index;
+    }
+}
+
+// Account one draw covering screen rect (x, y, w, h) in a target holding
+// screen rows [band_top, band_top + rows) of a screen width pixels wide:
+// its pixels there go to the layer, and each is counted in overdraw (a
+// screen-sized array, row 0 = screen row 0) if that is set
+void Count_Draw(LayerStats& layer, int x, int y, int w, int h,
+                int width, int band_top, int rows, uint8_t* overdraw) {
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + w, width);
+    int y0 = std::max(y, band_top);
+    int y1 = std::min(y + h, band_top + rows);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    layer.pixels += (x1 - x0) * (y1 - y0);
+    if (overdraw) {
+        for (int row = y0; row < y1; row++) {
+            uint8_t* count = overdraw + static_cast<size_t>(row) * width;
+            for (int col = x0; col < x1; col++) {
+                if (count[col] < 255) count[col]++;
+            }
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * ShadowMask - Shadows darkened once per pixel, in one pass
+ *
+ * A run of shadow draws (SHAPE_SHADOW with the same table) only marks
+ * its pixels in a target-sized mask; Flush() then darkens the marked
+ * area through Platform_Buffer_ShadowMask. Overlapping shadows no longer
+ * stack, and the target is walked once per run instead of per shadow.
+ * Anything else drawn flushes the run first, so draw order holds.
+ */
+struct RenderPipeline::ShadowMask {
+    std::vector<uint8_t> pixels;            // All 0 outside the marked area
+    int width = 0;
+    int height = 0;
+    const uint8_t* table = nullptr;         // Shadow table of the pending run
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;     // Marked area, empty if x0 >= x1
+
+    // Start on a target of this size (screen or band)
+    void Begin(int target_width, int target_height) {
+        width = target_width;
+        height = target_height;
+        table = nullptr;
+        x0 = y0 = x1 = y1 = 0;
+    }
+
+    // Draw one command at target row y, as Draw_Command() would
+    bool Draw(GraphicsBuffer& target, const RenderCommand& cmd, ShapeRenderer* renderer, int y) {
+        bool shadow = !cmd.object && renderer && cmd.remap && (cmd.flags & SHAPE_SHADOW);
+        if (!shadow || cmd.remap != table) {
+            Flush(target);
+        }
+        if (!shadow) {
+            return Draw_Command(target, cmd, renderer, y);
+        }
+
+        size_t size = static_cast<size_t>(width) * height;
+        if (pixels.size() < size) {
+            pixels.resize(size, 0);
+        }
+        GraphicsBuffer mask(pixels.data(), width, height, width);
+        mask.Lock();
+        bool drawn = renderer->DrawMask(mask, cmd.screen_x, y, cmd.frame, cmd.flags);
+        mask.Unlock();
+        if (!drawn) {
+            return false;
+        }
+        table = cmd.remap;
+
+        CommandRect rect = Command_Bounds(cmd, renderer);
+        int top = rect.y + y - cmd.screen_y;
+        int left = std::max(rect.x, 0);
+        int right = std::min(rect.x + rect.width, width);
+        int bottom = std::min(top + rect.height, height);
+        top = std::max(top, 0);
+        if (left >= right || top >= bottom) {
+            return true;
+        }
+        if (x0 >= x1) {
+            x0 = left; y0 = top; x1 = right; y1 = bottom;
+        } else {
+            x0 = std::min(x0, left);
+            y0 = std::min(y0, top);
+            x1 = std::max(x1, right);
+            y1 = std::max(y1, bottom);
+        }
+        return true;
+    }
+
+    // Darken the pending run and clear its marks
+    void Flush(GraphicsBuffer& target) {
+        if (table && x0 < x1) {
+            Platform_Buffer_ShadowMask(target.Get_Buffer(), target.Get_Pitch(),
+                                       target.Get_Width(), target.Get_Height(),
+                                       &pixels[static_cast<size_t>(y0) * width + x0], width,
+                                       x0, y0, x1 - x0, y1 - y0, table);
+            for (int row = y0; row < y1; row++) {
+                memset(&pixels[static_cast<size_t>(row) * width + x0], 0, x1 - x0);
+            }
+        }
+        table = nullptr;
+        x0 = y0 = x1 = y1 = 0;
+    }
+};
+
+struct RenderPipeline::RenderJob {
+    std::vector<RenderCommand> commands;        // Sorted draw order
+    std::vector<ShapeRenderer*> renderers;      // Resolved on the game thread
+    std::vector<CommandRect> rects;             // Screen bounds per command
+    uint32_t layer_start[static_cast<int>(LayerType::COUNT) + 1] = {};
+    Viewport viewport;
+    int scroll_x = 0;
+    int scroll_y = 0;
+    bool terrain = false;                       // A tile renderer was set
+    std::vector<uint8_t> terrain_tile;          // Its tile, copied; empty = clear fill
+    OcclusionMap occlusion;
+    RenderStats stats;                          // Counted by the render thread
+    SelectionOverlay overlay;                   // Drawn after the selection layer
+    std::unique_ptr<GraphicsBuffer> target;     // Screen-sized scene
+    std::vector<uint8_t> overdraw;              // Writes per pixel, if counted
+
+    // Band binning (see SetRasterBands), reused between frames
+    std::vector<uint32_t> bins[MAX_RASTER_BANDS];
+    RenderStats band_stats[MAX_RASTER_BANDS];
+    ShadowMask band_shadows[MAX_RASTER_BANDS];
+};
+
 // =============================================================================
 // Singleton
 // =============================================================================
@@ -36,10 +343,13 @@ RenderPipeline::RenderPipeline()
     , debug_mode_(false)
 {
     tactical_viewport_ = Viewport(0, 0, DEFAULT_TACTICAL_WIDTH, DEFAULT_TACTICAL_HEIGHT);
+    dirty_tracker_.reset(new DirtyRectTracker(screen_width_, screen_height_));
+    dirty_tracker_->set_max_rects(MAX_DIRTY_RECTS);
 }
 
 RenderPipeline::~RenderPipeline() {
     Shutdown();
+    SetThreaded(false);
 }
 
 // =============================================================================
@@ -47,25 +357,38 @@ RenderPipeline::~RenderPipeline() {
 // =============================================================================
 
 bool RenderPipeline::Initialize(int screen_width, int screen_height) {
-    if (initialized_) {
+    if (screen_width <= SIDEBAR_WIDTH || screen_height <= 0) {
+        return false;
+    }
+    if (initialized_ && screen_width == screen_width_ && screen_height == screen_height_) {
         return true;
     }
 
+    // A new resolution: what was drawn and saved at the old one is stale
+    Finish();
+    queued_slot_ = -1;
+    ready_slot_ = -1;
+    scene_drawn_ = false;
+    cursor_drawn_ = false;
+    MouseCursor::Instance().DiscardSaveUnder();
+
     screen_width_ = screen_width;
     screen_height_ = screen_height;
 
     // Set default tactical viewport (left side, excluding sidebar)
     tactical_viewport_ = Viewport(0, 0, screen_width - SIDEBAR_WIDTH, screen_height);
 
-    // Reserve space for dirty rects and render queue
-    dirty_rects_.reserve(MAX_DIRTY_RECTS);
-    render_queue_.reserve(256);
+    // Dirty tiles cover the whole screen (render queue lives in the frame arena)
+    dirty_tracker_.reset(new DirtyRectTracker(screen_width, screen_height));
+    dirty_tracker_->set_max_rects(MAX_DIRTY_RECTS);
 
     // Start with full redraw
     full_redraw_pending_ = true;
 
     initialized_ = true;
-    Platform_LogInfo("Render pipeline initialized");
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Render pipeline initialized (%dx%d)", screen_width, screen_height);
+    Platform_LogInfo(msg);
 
     return true;
 }
@@ -73,13 +396,18 @@ bool RenderPipeline::Initialize(int screen_width, int screen_height) {
 void RenderPipeline::Shutdown() {
     if (!initialized_) return;
 
-    dirty_rects_.clear();
-    render_queue_.clear();
+    SetThreaded(false);
+    dirty_tracker_->clear();
+    ClearRenderables();
 
     tile_renderer_ = nullptr;
     sidebar_ = nullptr;
     radar_ = nullptr;
 
+    scene_drawn_ = false;
+    cursor_drawn_ = false;
+    MouseCursor::Instance().DiscardSaveUnder();
+
     initialized_ = false;
     Platform_LogInfo("Render pipeline shutdown");
 }
@@ -125,6 +453,13 @@ void RenderPipeline::ScreenToWorld(int screen_x, int screen_y, int* world_x, int
     if (world_y) *world_y = screen_y - tactical_viewport_.y + scroll_y_;
 }
 
+bool RenderPipeline::IsShrouded(int world_x, int world_y) const {
+    if (!terrain_ || world_x < 0 || world_y < 0) {
+        return false;
+    }
+    return terrain_->IsCellShrouded(world_x / CULL_CELL_SIZE, world_y / CULL_CELL_SIZE);
+}
+
 bool RenderPipeline::IsVisible(int world_x, int world_y, int width, int height) const {
     // Convert to screen coordinates
     int screen_x = world_x - scroll_x_ + tactical_viewport_.x;
@@ -144,32 +479,8 @@ bool RenderPipeline::IsVisible(int world_x, int world_y, int width, int height)
 void RenderPipeline::AddDirtyRect(int x, int y, int width, int height) {
     if (!dirty_rect_enabled_ || full_redraw_pending_) return;
 
-    DirtyRect rect(x, y, width, height);
-    ClipToViewport(rect);
-
-    if (rect.IsEmpty()) return;
-
-    // Check for merge with existing rects
-    for (auto& existing : dirty_rects_) {
-        if (existing.Overlaps(rect)) {
-            existing.Merge(rect);
-            return;
-        }
-    }
-
-    // Add new rect if under limit
-    if (dirty_rects_.size() < MAX_DIRTY_RECTS) {
-        dirty_rects_.push_back(rect);
-    } else {
-        // Too many rects, merge into existing
-        MergeDirtyRects();
-        if (dirty_rects_.size() < MAX_DIRTY_RECTS) {
-            dirty_rects_.push_back(rect);
-        } else {
-            // Still too many, force full redraw
-            MarkFullRedraw();
-        }
-    }
+    // Clipped and merged by the tracker
+    dirty_tracker_->mark_dirty(x, y, width, height);
 }
 
 void RenderPipeline::AddDirtyWorldRect(int world_x, int world_y, int width, int height) {
@@ -180,52 +491,76 @@ void RenderPipeline::AddDirtyWorldRect(int world_x, int world_y, int width, int
 
 void RenderPipeline::MarkFullRedraw() {
     full_redraw_pending_ = true;
-    dirty_rects_.clear();
+    dirty_tracker_->clear();
+    dirty_tracker_->mark_all_dirty();
 }
 
 void RenderPipeline::ClearDirtyRects() {
-    dirty_rects_.clear();
+    dirty_tracker_->clear();
     full_redraw_pending_ = false;
 }
 
-void RenderPipeline::MergeDirtyRects() {
-    // Simple greedy merge of overlapping rects
-    bool merged;
-    do {
-        merged = false;
-        for (size_t i = 0; i < dirty_rects_.size() && !merged; i++) {
-            for (size_t j = i + 1; j < dirty_rects_.size() && !merged; j++) {
-                if (dirty_rects_[i].Overlaps(dirty_rects_[j])) {
-                    dirty_rects_[i].Merge(dirty_rects_[j]);
-                    dirty_rects_.erase(dirty_rects_.begin() + static_cast<long>(j));
-                    merged = true;
-                }
-            }
-        }
-    } while (merged && dirty_rects_.size() > MAX_DIRTY_RECTS / 2);
+int RenderPipeline::GetDirtyRectCount() const {
+    if (!dirty_tracker_->has_dirty_rects()) return 0;
+    return dirty_tracker_->get_merged_rect_count();
 }
 
-void RenderPipeline::ClipToViewport(DirtyRect& rect) const {
-    // Clip to screen bounds
-    if (rect.x < 0) {
-        rect.width += rect.x;
-        rect.x = 0;
+bool RenderPipeline::IsFullRedraw() const {
+    return full_redraw_pending_ || dirty_tracker_->is_full_redraw();
+}
+
+// =============================================================================
+// Renderable Management
+// =============================================================================
+
+bool RenderPipeline::SubmitShape(ShapeId shape, int frame, int world_x, int world_y,
+                                 LayerType layer, int sort_y,
+                                 const uint8_t* remap, uint32_t flags,
+                                 uint8_t render_flags) {
+    if ((flags & SHAPE_SHADOW) && !shadows_enabled_) {
+        return false;
     }
-    if (rect.y < 0) {
-        rect.height += rect.y;
-        rect.y = 0;
+    ShapeRenderer* renderer = ShapeCache::Instance().Get(shape);
+    if (!renderer) return false;
+
+    int width, height, x_offset, y_offset;
+    if (!renderer->GetFrameSize(frame, &width, &height) ||
+        !renderer->GetFrameOffset(frame, &x_offset, &y_offset)) {
+        return false;
     }
-    if (rect.x + rect.width > screen_width_) {
-        rect.width = screen_width_ - rect.x;
+
+    // Cull with the same placement ShapeRenderer uses
+    int left = world_x + x_offset;
+    int top = world_y + y_offset;
+    if (flags & SHAPE_CENTER) {
+        left -= width / 2;
+        top -= height / 2;
     }
-    if (rect.y + rect.height > screen_height_) {
-        rect.height = screen_height_ - rect.y;
+    if (!IsVisible(left, top, width, height)) {
+        return false;
     }
+    if (IsShrouded(world_x, world_y)) {
+        stats_shards_.local().objects_culled++;
+        return false;
+    }
+
+    RenderCommand* cmd = AppendCommand();
+    cmd->sort_key = Make_Render_Sort_Key(static_cast<int>(layer), sort_y,
+                                         static_cast<uint32_t>(shape));
+    cmd->object = nullptr;
+    cmd->remap = remap;
+    WorldToScreen(world_x, world_y, &cmd->screen_x, &cmd->screen_y);
+    cmd->shape = shape;
+    cmd->flags = flags;
+    cmd->frame = static_cast<uint16_t>(frame);
+    cmd->layer = static_cast<uint8_t>(layer);
+    cmd->render_flags = render_flags;
+    return true;
 }
 
-// =============================================================================
-// Renderable Management
-// =============================================================================
+void RenderPipeline::SubmitCommand(const RenderCommand& command) {
+    *AppendCommand() = command;
+}
 
 void RenderPipeline::AddRenderable(IRenderable* obj) {
     if (!obj) return;
@@ -239,17 +574,146 @@ void RenderPipeline::AddRenderable(IRenderable* obj) {
     if (!IsVisible(world_x + bx, world_y + by, bw, bh)) {
         return;  // Object not visible, skip
     }
+    if (IsShrouded(world_x, world_y)) {
+        stats_shards_.local().objects_culled++;
+        return;
+    }
 
-    // Add to render queue
-    render_queue_.emplace_back(obj, obj->GetSortY(), obj->GetRenderLayer());
+    LayerType layer = obj->GetRenderLayer();
+
+    RenderCommand* cmd = AppendCommand();
+    cmd->sort_key = Make_Render_Sort_Key(static_cast<int>(layer), obj->GetSortY(), 0);
+    cmd->object = obj;
+    cmd->remap = nullptr;
+    WorldToScreen(world_x, world_y, &cmd->screen_x, &cmd->screen_y);
+    cmd->shape = SHAPE_ID_NONE;
+    cmd->flags = 0;
+    cmd->frame = 0;
+    cmd->layer = static_cast<uint8_t>(layer);
+    cmd->render_flags = obj->IsOccluder() ? RENDER_OCCLUDER : 0;
 }
 
 void RenderPipeline::ClearRenderables() {
-    render_queue_.clear();
+    // Arena memory is reclaimed by FrameAllocator::begin_frame
+    commands_ = nullptr;
+    command_count_ = 0;
+    command_capacity_ = 0;
+    memset(layer_start_, 0, sizeof(layer_start_));
+}
+
+RenderCommand* RenderPipeline::AppendCommand() {
+    if (command_count_ == command_capacity_) {
+        // Arena blocks are not contiguous: move to a larger array (the old
+        // one is released with the rest of the frame)
+        size_t capacity = command_capacity_ ? command_capacity_ * 2 : 256;
+        RenderCommand* grown = static_cast<RenderCommand*>(
+            FrameAllocator::instance().allocate(capacity * sizeof(RenderCommand),
+                                                alignof(RenderCommand)));
+        if (command_count_) {
+            memcpy(grown, commands_, command_count_ * sizeof(RenderCommand));
+        }
+        commands_ = grown;
+        command_capacity_ = capacity;
+    }
+    return &commands_[command_count_++];
 }
 
 void RenderPipeline::SortRenderQueue() {
-    std::sort(render_queue_.begin(), render_queue_.end());
+    size_t count = command_count_;
+
+    if (count >= 2) {
+        sorter_.Begin(count);
+        for (size_t i = 0; i < count; i++) {
+            sorter_.Add(commands_[i].sort_key);
+        }
+
+        const uint32_t* order = sorter_.Sort();
+        if (sorter_.Get_Last_Path() != RenderSorter::SORT_PATH_ORDERED) {
+            RenderCommand* sorted = static_cast<RenderCommand*>(
+                FrameAllocator::instance().allocate(count * sizeof(RenderCommand),
+                                                    alignof(RenderCommand)));
+            for (size_t i = 0; i < count; i++) {
+                sorted[i] = commands_[order[i]];
+            }
+            commands_ = sorted;
+            command_capacity_ = count;
+        }
+    }
+
+    Index_Layers(commands_, count, layer_start_);
+}
+
+void RenderPipeline::CullOccluded() {
+    if (!occlusion_) {
+        occlusion_.reset(new OcclusionMap());
+    }
+    OcclusionMap& map = *occlusion_;
+
+    // The cells DrawTerrain() covers
+    int start_x = scroll_x_ / CULL_CELL_SIZE;
+    int start_y = scroll_y_ / CULL_CELL_SIZE;
+    map.columns = (scroll_x_ + tactical_viewport_.width + CULL_CELL_SIZE - 1) / CULL_CELL_SIZE - start_x + 1;
+    map.rows = (scroll_y_ + tactical_viewport_.height + CULL_CELL_SIZE - 1) / CULL_CELL_SIZE - start_y + 1;
+    map.origin_x = tactical_viewport_.x - scroll_x_ % CULL_CELL_SIZE;
+    map.origin_y = tactical_viewport_.y - scroll_y_ % CULL_CELL_SIZE;
+    map.cells.assign(static_cast<size_t>(map.columns) * map.rows, 0);
+    map.active = false;
+
+    // Shroud hides everything under the shroud layer
+    const uint8_t shroud = OcclusionMap::SHROUDED | static_cast<uint8_t>(LayerType::SHROUD);
+    if (terrain_) {
+        for (int row = 0; row < map.rows; row++) {
+            for (int column = 0; column < map.columns; column++) {
+                if (terrain_->IsCellShrouded(start_x + column, start_y + row)) {
+                    map.cells[static_cast<size_t>(row) * map.columns + column] = shroud;
+                    map.active = true;
+                }
+            }
+        }
+    }
+
+    // Occluders hide what is under their layer in the cells they fill
+    ShapeCache& cache = ShapeCache::Instance();
+    for (size_t i = 0; i < command_count_; i++) {
+        const RenderCommand& cmd = commands_[i];
+        if (!(cmd.render_flags & RENDER_OCCLUDER)) {
+            continue;
+        }
+        CommandRect rect = Command_Bounds(cmd, cmd.object ? nullptr : cache.Get(cmd.shape));
+        int c0 = std::max(Floor_Div(rect.x - map.origin_x + CULL_CELL_SIZE - 1, CULL_CELL_SIZE), 0);
+        int c1 = std::min(Floor_Div(rect.x + rect.width - map.origin_x, CULL_CELL_SIZE), map.columns);
+        int r0 = std::max(Floor_Div(rect.y - map.origin_y + CULL_CELL_SIZE - 1, CULL_CELL_SIZE), 0);
+        int r1 = std::min(Floor_Div(rect.y + rect.height - map.origin_y, CULL_CELL_SIZE), map.rows);
+        for (int row = r0; row < r1; row++) {
+            for (int column = c0; column < c1; column++) {
+                uint8_t& cell = map.cells[static_cast<size_t>(row) * map.columns + column];
+                if ((cell & OcclusionMap::LAYER_MASK) < cmd.layer) {
+                    cell = static_cast<uint8_t>((cell & OcclusionMap::SHROUDED) | cmd.layer);
+                    map.active = true;
+                }
+            }
+        }
+    }
+    if (!map.active) {
+        return;
+    }
+
+    // Drop hidden draws; the queue stays sorted
+    RenderStats& stats = stats_shards_.local();
+    size_t kept = 0;
+    for (size_t i = 0; i < command_count_; i++) {
+        const RenderCommand& cmd = commands_[i];
+        if (cmd.layer < static_cast<uint8_t>(LayerType::SHROUD)) {
+            CommandRect rect = Command_Bounds(cmd, cmd.object ? nullptr : cache.Get(cmd.shape));
+            if (map.Hides(rect, cmd.layer)) {
+                stats.objects_culled++;
+                continue;
+            }
+        }
+        commands_[kept++] = cmd;
+    }
+    command_count_ = kept;
+    Index_Layers(commands_, command_count_, layer_start_);
 }
 
 // =============================================================================
@@ -257,8 +721,15 @@ void RenderPipeline::SortRenderQueue() {
 // =============================================================================
 
 void RenderPipeline::BeginFrame() {
-    stats_.Reset();
+    ResetStats();
     ClearRenderables();
+
+    // Counted afresh by the stages (by the render job when threaded)
+    if (debug_mode_ && overdraw_heatmap_ && !IsThreaded()) {
+        overdraw_.assign(static_cast<size_t>(screen_width_) * screen_height_, 0);
+    } else {
+        overdraw_.clear();
+    }
 }
 
 void RenderPipeline::RenderFrame() {
@@ -266,8 +737,17 @@ void RenderPipeline::RenderFrame() {
 
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
 
-    // Sort all renderables
+    // Bullets and animations queue straight from their pool
+    ProjectileSystem::Instance().Submit(*this);
+
+    // Sort all renderables, then drop the draws shroud or occluders hide
     SortRenderQueue();
+    CullOccluded();
+
+    if (IsThreaded()) {
+        QueueRenderJob();
+        return;
+    }
 
     screen.Lock();
 
@@ -287,28 +767,97 @@ void RenderPipeline::RenderFrame() {
     RenderUI();
     RenderCursor();
 
+    if (network_) {
+        PublishNetworkStats();
+    }
+
     // Debug overlay
     if (debug_mode_) {
         DrawDebugOverlay();
     }
 
     screen.Unlock();
+    scene_drawn_ = true;
+    stats_ = stats_shards_.merge();
 }
 
 void RenderPipeline::EndFrame() {
+    if (IsThreaded()) {
+        // The scene is redrawn whole, so flips are too
+        if (ready_slot_ >= 0) {
+            PresentJob(ready_slot_);
+            ready_slot_ = -1;
+        }
+        ClearDirtyRects();
+        return;
+    }
+
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
-    screen.Flip();
+    if (dirty_flip_enabled_ && dirty_rect_enabled_ && !IsFullRedraw()) {
+        // Convert and upload only what changed
+        screen.Flip(dirty_tracker_->get_dirty_rects());
+    } else {
+        screen.Flip();
+    }
 
     // Clear dirty state for next frame
     ClearDirtyRects();
 }
 
 void RenderPipeline::DrawFrame() {
+    if (dirty_flip_enabled_ && dirty_rect_enabled_ && DrawCursorFrame()) {
+        return;
+    }
     BeginFrame();
     RenderFrame();
     EndFrame();
 }
 
+bool RenderPipeline::DrawCursorFrame() {
+    if (!initialized_ || !scene_drawn_ || IsFullRedraw() || GetDirtyRectCount() > 0) {
+        return false;
+    }
+
+    // Nothing changed since the frame still on the render thread: show it
+    if (queued_slot_ >= 0) {
+        Finish();
+        PresentJob(queued_slot_);
+        queued_slot_ = -1;
+        ClearDirtyRects();
+        return true;
+    }
+
+    ResetStats();
+    MouseCursor& cursor = MouseCursor::Instance();
+
+    int x, y;
+    cursor.GetPosition(&x, &y);
+    int rx = 0, ry = 0, rw = 0, rh = 0;
+    bool visible = cursor.GetDrawRect(x, y, &rx, &ry, &rw, &rh);
+
+    // Same place, same shape: nothing to present
+    if (visible == cursor_drawn_ &&
+        (!visible || (rx == cursor_x_ && ry == cursor_y_ && rw == cursor_w_ &&
+                      rh == cursor_h_ && cursor.GetType() == cursor_frame_type_))) {
+        return true;
+    }
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    screen.Lock();
+
+    int ox, oy, ow, oh;
+    if (cursor.RestoreUnder(screen, &ox, &oy, &ow, &oh)) {
+        dirty_tracker_->mark_dirty(ox, oy, ow, oh);
+    }
+    RenderCursor();
+
+    screen.Unlock();
+    screen.Flip(dirty_tracker_->get_dirty_rects());
+    ClearDirtyRects();
+    stats_ = stats_shards_.merge();
+    return true;
+}
+
 // =============================================================================
 // Individual Render Stages
 // =============================================================================
@@ -316,30 +865,57 @@ void RenderPipeline::DrawFrame() {
 void RenderPipeline::RenderTerrain() {
     if (!tile_renderer_) return;
 
-    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    DrawTerrain(GraphicsBuffer::Screen(), tactical_viewport_, scroll_x_, scroll_y_, 0,
+                tile_renderer_->GetTilePixels(TEMPLATE_CLEAR1, 0),
+                stats_shards_.local(), OverdrawCounts(), occlusion_.get());
+}
+
+void RenderPipeline::DrawTerrain(GraphicsBuffer& target, const Viewport& viewport,
+                                 int scroll_x, int scroll_y, int band_top, const uint8_t* tile,
+                                 RenderStats& stats, uint8_t* overdraw,
+                                 const OcclusionMap* occlusion) {
+    Clock::time_point start = Clock::now();
+    LayerStats& layer = stats.layers[static_cast<int>(LayerType::TERRAIN)];
 
     // Calculate visible cell range
     int cell_size = 24;  // Tile size in pixels
-    int start_cell_x = scroll_x_ / cell_size;
-    int start_cell_y = scroll_y_ / cell_size;
-    int end_cell_x = (scroll_x_ + tactical_viewport_.width + cell_size - 1) / cell_size;
-    int end_cell_y = (scroll_y_ + tactical_viewport_.height + cell_size - 1) / cell_size;
+    int start_cell_x = scroll_x / cell_size;
+    int start_cell_y = scroll_y / cell_size;
+    int end_cell_x = (scroll_x + viewport.width + cell_size - 1) / cell_size;
+    int end_cell_y = (scroll_y + viewport.height + cell_size - 1) / cell_size;
 
     // Offset for partial cell at edges
-    int offset_x = -(scroll_x_ % cell_size);
-    int offset_y = -(scroll_y_ % cell_size);
+    int offset_x = -(scroll_x % cell_size);
+    int offset_y = -(scroll_y % cell_size);
 
-    // Draw visible tiles
+    // Draw visible tiles (rows outside the target's band, and cells under
+    // shroud or an occluder, are skipped)
+    bool culling = occlusion && occlusion->active;
+    int band_bottom = band_top + target.Get_Height();
     for (int cy = start_cell_y; cy <= end_cell_y; cy++) {
+        int screen_y = viewport.y + (cy - start_cell_y) * cell_size + offset_y;
+        if (screen_y + cell_size <= band_top || screen_y >= band_bottom) {
+            continue;
+        }
         for (int cx = start_cell_x; cx <= end_cell_x; cx++) {
-            int screen_x = tactical_viewport_.x + (cx - start_cell_x) * cell_size + offset_x;
-            int screen_y = tactical_viewport_.y + (cy - start_cell_y) * cell_size + offset_y;
+            int screen_x = viewport.x + (cx - start_cell_x) * cell_size + offset_x;
+            if (culling && occlusion->Cover(cx - start_cell_x, cy - start_cell_y) > 0) {
+                continue;
+            }
 
-            // Draw tile (tile renderer handles out-of-bounds)
-            tile_renderer_->DrawTile(screen, screen_x, screen_y, TEMPLATE_CLEAR1, 0);  // Clear terrain as placeholder
-            stats_.terrain_tiles_drawn++;
+            // Draw tile (clipped to the target); clear terrain as placeholder
+            TileRenderer::DrawTilePixels(target, screen_x, screen_y - band_top, tile);
+            Count_Draw(layer, screen_x, screen_y, cell_size, cell_size,
+                       target.Get_Width(), band_top, target.Get_Height(), overdraw);
+
+            // A tile spanning bands is counted by the first
+            if (std::max(screen_y, 0) >= band_top) {
+                stats.terrain_tiles_drawn++;
+                layer.commands++;
+            }
         }
     }
+    layer.time_ms += Elapsed_Ms(start, Clock::now());
 }
 
 void RenderPipeline::RenderSmudges() {
@@ -380,58 +956,471 @@ void RenderPipeline::RenderEffects() {
 
 void RenderPipeline::RenderSelection() {
     RenderLayer(RenderLayer::SELECTION);
+
+    // Brackets and health bars recorded by the objects drawn this frame
+    SelectionOverlay& overlay = SelectionOverlay::Instance();
+    Clock::time_point start = Clock::now();
+    LayerStats& layer = stats_shards_.local().layers[static_cast<int>(LayerType::SELECTION)];
+    layer.commands += overlay.Draw(GraphicsBuffer::Screen());
+    overlay.Clear();
+    layer.time_ms += Elapsed_Ms(start, Clock::now());
 }
 
 void RenderPipeline::RenderShroud() {
+    if (occlusion_ && occlusion_->active) {
+        occlusion_->Fill_Shroud(GraphicsBuffer::Screen(), 0);
+    }
     RenderLayer(RenderLayer::SHROUD);
 }
 
 void RenderPipeline::RenderUI() {
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    Clock::time_point start = Clock::now();
+    LayerStats& layer = stats_shards_.local().layers[static_cast<int>(LayerType::UI)];
 
     // Render sidebar
     if (sidebar_) {
         sidebar_->Draw(screen);
+        layer.commands++;
     }
 
     // Render radar
     if (radar_) {
         radar_->Draw(screen);
+        layer.commands++;
     }
+    layer.time_ms += Elapsed_Ms(start, Clock::now());
 }
 
 void RenderPipeline::RenderCursor() {
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
-    MouseCursor::Instance().Draw(screen);
+    MouseCursor& cursor = MouseCursor::Instance();
+
+    // The old position shows scene pixels again; flip it with the new one
+    if (cursor_drawn_) {
+        AddDirtyRect(cursor_x_, cursor_y_, cursor_w_, cursor_h_);
+    }
+
+    Clock::time_point start = Clock::now();
+    cursor.DrawSaved(screen);
+
+    int x, y;
+    cursor.GetPosition(&x, &y);
+    cursor_drawn_ = cursor.GetDrawRect(x, y, &cursor_x_, &cursor_y_, &cursor_w_, &cursor_h_);
+    cursor_frame_type_ = cursor.GetType();
+
+    LayerStats& layer = stats_shards_.local().layers[static_cast<int>(LayerType::CURSOR)];
+    if (cursor_drawn_) {
+        AddDirtyRect(cursor_x_, cursor_y_, cursor_w_, cursor_h_);
+        Count_Draw(layer, cursor_x_, cursor_y_, cursor_w_, cursor_h_,
+                   screen.Get_Width(), 0, screen.Get_Height(), nullptr);
+        layer.commands++;
+    }
+    layer.time_ms += Elapsed_Ms(start, Clock::now());
 }
 
 void RenderPipeline::RenderLayer(enum RenderLayer layer) {
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    ShapeCache& cache = ShapeCache::Instance();
+    Clock::time_point start = Clock::now();
+
+    int index = static_cast<int>(layer);
+    uint32_t end = layer_start_[index + 1];
+
+    // Consecutive commands usually share a shape; resolve it once per run
+    ShapeId current_shape = SHAPE_ID_NONE;
+    ShapeRenderer* renderer = nullptr;
+    RenderStats& stats = stats_shards_.local();
+    LayerStats& layer_stats = stats.layers[index];
+    uint8_t* overdraw = OverdrawCounts();
+    if (!shadow_mask_) {
+        shadow_mask_.reset(new ShadowMask());
+    }
+    ShadowMask& shadows = *shadow_mask_;
+    shadows.Begin(screen.Get_Width(), screen.Get_Height());
+
+    for (uint32_t i = layer_start_[index]; i < end; i++) {
+        const RenderCommand& cmd = commands_[i];
+
+        if (!cmd.object && cmd.shape != current_shape) {
+            current_shape = cmd.shape;
+            renderer = cache.Get(current_shape);
+        }
+        if (shadows.Draw(screen, cmd, renderer, cmd.screen_y)) {
+            CommandRect rect = Command_Bounds(cmd, renderer);
+            Count_Draw(layer_stats, rect.x, rect.y, rect.width, rect.height,
+                       screen.Get_Width(), 0, screen.Get_Height(), overdraw);
+            layer_stats.commands++;
+            stats.objects_drawn++;
+        }
+    }
+    shadows.Flush(screen);
+    layer_stats.time_ms += Elapsed_Ms(start, Clock::now());
+}
 
-    for (const auto& entry : render_queue_) {
-        if (entry.layer != layer) continue;
+// =============================================================================
+// Threaded Rendering
+// =============================================================================
+
+void RenderPipeline::SetThreaded(bool enabled) {
+    if (enabled == IsThreaded()) return;
+
+    if (enabled) {
+        for (std::unique_ptr<RenderJob>& job : jobs_) {
+            if (!job) job.reset(new RenderJob());
+        }
+        if (!band_jobs_) {
+            band_jobs_.reset(new JobSystem());
+        }
+        band_jobs_->Start();
+        render_stop_ = false;
+        render_thread_ = std::thread(&RenderPipeline::RenderThreadMain, this);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(render_mutex_);
+        render_stop_ = true;
+    }
+    render_wake_.notify_one();
+    render_thread_.join();
+    band_jobs_->Stop();
+    if (shapes_held_) {
+        ShapeCache::Instance().ReleaseEviction();
+        shapes_held_ = false;
+    }
+
+    // Frames never presented are dropped; the next one is drawn in full
+    queued_slot_ = -1;
+    ready_slot_ = -1;
+    MarkFullRedraw();
+}
+
+void RenderPipeline::SetRasterBands(int bands) {
+    Finish();
+    raster_bands_ = std::max(0, std::min(bands, MAX_RASTER_BANDS));
+}
+
+int RenderPipeline::BandCount(int height) const {
+    if (raster_bands_ > 0) {
+        return std::min(raster_bands_, std::max(1, height));
+    }
+    int workers = band_jobs_ ? band_jobs_->Get_Worker_Count() : 0;
+    int bands = std::min(workers + 1, height / MIN_RASTER_BAND_ROWS);
+    return std::max(1, std::min(bands, MAX_RASTER_BANDS));
+}
+
+void RenderPipeline::Finish() {
+    std::unique_lock<std::mutex> lock(render_mutex_);
+    render_done_.wait(lock, [this] { return render_job_ < 0; });
+}
 
-        // Convert world to screen coordinates
-        int world_x = entry.object->GetWorldX();
-        int world_y = entry.object->GetWorldY();
-        int screen_x, screen_y;
+void RenderPipeline::QueueRenderJob() {
+    // One frame in flight: the last one is drawn before this is queued,
+    // and becomes the one EndFrame() presents
+    Finish();
+    ready_slot_ = queued_slot_;
+    int slot = (ready_slot_ == 0) ? 1 : 0;
+    RenderJob& job = *jobs_[slot];
+
+    // The job keeps raw renderers until it is drawn, so budget eviction
+    // waits: the last job's hold ends now that it is done (evicting what
+    // is over budget), and this one's starts before the first Get()
+    ShapeCache& cache = ShapeCache::Instance();
+    if (shapes_held_) {
+        cache.ReleaseEviction();
+    }
+    cache.HoldEviction();
+    shapes_held_ = true;
+
+    job.commands.assign(commands_, commands_ + command_count_);
+    memcpy(job.layer_start, layer_start_, sizeof(job.layer_start));
+    job.viewport = tactical_viewport_;
+    job.scroll_x = scroll_x_;
+    job.scroll_y = scroll_y_;
+
+    // Templates load on first use and the cache may be evicted or swapped
+    // for another theater while the job draws, so it gets its own tile
+    job.terrain = tile_renderer_ != nullptr;
+    const uint8_t* tile = job.terrain ? tile_renderer_->GetTilePixels(TEMPLATE_CLEAR1, 0) : nullptr;
+    if (tile) {
+        job.terrain_tile.assign(tile, tile + TILE_SIZE);
+    } else {
+        job.terrain_tile.clear();
+    }
+
+    job.overlay = SelectionOverlay::Instance();
+    SelectionOverlay::Instance().Clear();
+    if (occlusion_) {
+        job.occlusion = *occlusion_;
+    } else {
+        job.occlusion.active = false;
+    }
+
+    // The shape cache belongs to this thread, so look renderers up here,
+    // and cache each frame now so the render thread's draws only read it.
+    // The bounds of each command are what band binning goes by.
+    job.renderers.resize(command_count_);
+    job.rects.resize(command_count_);
+    ShapeId current_shape = SHAPE_ID_NONE;
+    ShapeRenderer* renderer = nullptr;
+    for (size_t i = 0; i < command_count_; i++) {
+        const RenderCommand& cmd = commands_[i];
+        if (cmd.object) {
+            job.renderers[i] = nullptr;
+            job.rects[i] = Command_Bounds(cmd, nullptr);
+            continue;
+        }
 
-        if (WorldToScreen(world_x, world_y, &screen_x, &screen_y)) {
-            entry.object->Draw(screen, screen_x, screen_y);
-            stats_.objects_drawn++;
+        if (cmd.shape != current_shape) {
+            current_shape = cmd.shape;
+            renderer = cache.Get(current_shape);
+        }
+        job.renderers[i] = renderer;
+        if (renderer && renderer->PrepareFrame(cmd.frame, cmd.flags)) {
+            job.rects[i] = Command_Bounds(cmd, renderer);
+        } else {
+            job.rects[i] = CommandRect{cmd.screen_x, cmd.screen_y, 0, 0};
         }
     }
+
+    if (!job.target || job.target->Get_Width() != screen_width_ ||
+        job.target->Get_Height() != screen_height_) {
+        job.target.reset(new GraphicsBuffer(screen_width_, screen_height_));
+    }
+    job.overdraw.clear();
+    if (debug_mode_ && overdraw_heatmap_) {
+        job.overdraw.resize(static_cast<size_t>(screen_width_) * screen_height_);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(render_mutex_);
+        render_job_ = slot;
+    }
+    render_wake_.notify_one();
+    queued_slot_ = slot;
+}
+
+void RenderPipeline::RasterizeJob(RenderJob& job) {
+    PROFILE_SCOPE("Render Thread Frame");
+    GraphicsBuffer& target = *job.target;
+    job.stats.Reset();
+
+    int height = target.Get_Height();
+    int bands = BandCount(height);
+    int band_rows = (height + bands - 1) / bands;
+
+    // Bin the scene layers' commands into each band they overlap, in
+    // queue order; a command with no rows (unknown frame) draws nothing
+    uint32_t begin = job.layer_start[static_cast<int>(LayerType::SMUDGE)];
+    uint32_t end = job.layer_start[static_cast<int>(LayerType::SHROUD) + 1];
+    for (int band = 0; band < bands; band++) {
+        job.bins[band].clear();
+    }
+    for (uint32_t i = begin; i < end; i++) {
+        const CommandRect& rect = job.rects[i];
+        int top = std::max(rect.y, 0);
+        int bottom = std::min(rect.y + rect.height, height);
+        if (top >= bottom) {
+            continue;
+        }
+        for (int band = top / band_rows; band <= (bottom - 1) / band_rows; band++) {
+            job.bins[band].push_back(i);
+        }
+    }
+
+    target.Lock();
+    band_jobs_->Parallel_For(bands, 1, [&](int first, int last) {
+        for (int band = first; band < last; band++) {
+            RasterizeBand(job, band, band_rows);
+        }
+    });
+    target.Unlock();
+
+    for (int band = 0; band < bands; band++) {
+        job.stats += job.band_stats[band];
+    }
+}
+
+void RenderPipeline::RasterizeBand(RenderJob& job, int band, int band_rows) {
+    GraphicsBuffer& target = *job.target;
+    int top = band * band_rows;
+    int rows = std::min(band_rows, target.Get_Height() - top);
+    RenderStats& stats = job.band_stats[band];
+    stats.Reset();
+    if (rows <= 0) {
+        return;
+    }
+
+    // This band's rows; the buffer's own clipping keeps draws inside them
+    GraphicsBuffer view(target.Get_Buffer() + static_cast<size_t>(top) * target.Get_Pitch(),
+                        target.Get_Width(), rows, target.Get_Pitch());
+    view.Lock();
+    view.Clear();
+    uint8_t* overdraw = job.overdraw.empty() ? nullptr : job.overdraw.data();
+    if (job.terrain) {
+        const uint8_t* tile = job.terrain_tile.empty() ? nullptr : job.terrain_tile.data();
+        DrawTerrain(view, job.viewport, job.scroll_x, job.scroll_y, top, tile, stats, overdraw,
+                    &job.occlusion);
+    }
+
+    // Smudges through shroud, as the RenderFrame() stages draw them; each
+    // layer's time runs until the next layer's first command, and its
+    // shadows are darkened by then. The selection overlay goes down once
+    // the selection layer is done, and shrouded cells are filled just
+    // before the shroud layer.
+    const int selection_layer = static_cast<int>(LayerType::SELECTION);
+    const int shroud_layer = static_cast<int>(LayerType::SHROUD);
+    bool overlay_drawn = false;
+    bool shroud_filled = !job.occlusion.active;
+    auto draw_overlay = [&]() {
+        Clock::time_point begin = Clock::now();
+        LayerStats& overlay_stats = stats.layers[selection_layer];
+        overlay_stats.commands += job.overlay.Draw(view.Get_Buffer(), view.Get_Pitch(),
+                                                   view.Get_Width(), rows, top);
+        overlay_stats.time_ms += Elapsed_Ms(begin, Clock::now());
+    };
+    ShadowMask& shadows = job.band_shadows[band];
+    shadows.Begin(view.Get_Width(), rows);
+    Clock::time_point start = Clock::now();
+    int layer = -1;
+    for (uint32_t i : job.bins[band]) {
+        const RenderCommand& cmd = job.commands[i];
+        if (cmd.layer != layer) {
+            shadows.Flush(view);
+            Clock::time_point now = Clock::now();
+            if (layer >= 0) {
+                stats.layers[layer].time_ms += Elapsed_Ms(start, now);
+            }
+            start = now;
+            layer = cmd.layer;
+        }
+        if (!overlay_drawn && cmd.layer > selection_layer) {
+            draw_overlay();
+            overlay_drawn = true;
+        }
+        if (!shroud_filled && cmd.layer >= shroud_layer) {
+            job.occlusion.Fill_Shroud(view, top);
+            shroud_filled = true;
+        }
+
+        if (!shadows.Draw(view, cmd, job.renderers[i], cmd.screen_y - top)) {
+            continue;
+        }
+        const CommandRect& rect = job.rects[i];
+        LayerStats& layer_stats = stats.layers[layer];
+        Count_Draw(layer_stats, rect.x, rect.y, rect.width, rect.height,
+                   view.Get_Width(), top, rows, overdraw);
+
+        // Counted once, by the band holding the command's first row
+        if (std::max(rect.y, 0) / band_rows == band) {
+            layer_stats.commands++;
+            stats.objects_drawn++;
+        }
+    }
+    shadows.Flush(view);
+    if (layer >= 0) {
+        stats.layers[layer].time_ms += Elapsed_Ms(start, Clock::now());
+    }
+    if (!overlay_drawn) {
+        draw_overlay();
+    }
+    if (!shroud_filled) {
+        job.occlusion.Fill_Shroud(view, top);
+    }
+    view.Unlock();
+}
+
+void RenderPipeline::PresentJob(int slot) {
+    RenderJob& job = *jobs_[slot];
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+
+    screen.Lock();
+    screen.Blit_From(*job.target, 0, 0, 0, 0);
+
+    // The pixels under the cursor are scene pixels again
+    cursor_drawn_ = false;
+    MouseCursor::Instance().DiscardSaveUnder();
+
+    RenderUI();
+    RenderCursor();
+    if (network_) {
+        PublishNetworkStats();
+    }
+    if (debug_mode_) {
+        // The job's counts are this frame's
+        overdraw_.swap(job.overdraw);
+        DrawDebugOverlay();
+    }
+    screen.Unlock();
+    screen.Flip();
+
+    scene_drawn_ = true;
+    stats_ = stats_shards_.merge();
+    stats_ += job.stats;
+}
+
+void RenderPipeline::RenderThreadMain() {
+    Profiler::instance().set_thread_name("Render");
+
+    std::unique_lock<std::mutex> lock(render_mutex_);
+    for (;;) {
+        render_wake_.wait(lock, [this] { return render_stop_ || render_job_ >= 0; });
+        if (render_job_ < 0) {
+            return;
+        }
+
+        int slot = render_job_;
+        lock.unlock();
+        RasterizeJob(*jobs_[slot]);
+        lock.lock();
+
+        render_job_ = -1;
+        render_done_.notify_all();
+    }
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+void RenderPipeline::ResetStats() {
+    stats_shards_.reset();
+    stats_.Reset();
 }
 
 // =============================================================================
 // Debug
 // =============================================================================
 
+uint8_t* RenderPipeline::OverdrawCounts() {
+    return overdraw_.empty() ? nullptr : overdraw_.data();
+}
+
 void RenderPipeline::DrawDebugOverlay() {
     GraphicsBuffer& screen = GraphicsBuffer::Screen();
 
+    // Overdraw heatmap over the tactical view, from this frame's counts
+    if (overdraw_heatmap_ &&
+        overdraw_.size() == static_cast<size_t>(screen_width_) * screen_height_) {
+        uint8_t* pixels = screen.Get_Buffer();
+        int x0 = std::max(tactical_viewport_.x, 0);
+        int y0 = std::max(tactical_viewport_.y, 0);
+        int x1 = std::min({tactical_viewport_.x + tactical_viewport_.width,
+                           screen_width_, screen.Get_Width()});
+        int y1 = std::min({tactical_viewport_.y + tactical_viewport_.height,
+                           screen_height_, screen.Get_Height()});
+        for (int y = y0; pixels && y < y1; y++) {
+            const uint8_t* count = overdraw_.data() + static_cast<size_t>(y) * screen_width_;
+            uint8_t* row = pixels + static_cast<size_t>(y) * screen.Get_Pitch();
+            for (int x = x0; x < x1; x++) {
+                row[x] = OVERDRAW_COLORS[std::min<int>(count[x], OVERDRAW_LEVELS - 1)];
+            }
+        }
+    }
+
     // Draw dirty rectangles in red
-    for (const auto& rect : dirty_rects_) {
+    for (const Rect& rect : dirty_tracker_->get_dirty_rects()) {
         // Top line
         screen.Draw_HLine(rect.x, rect.y, rect.width, 252);
         // Bottom line
@@ -441,7 +1430,7 @@ void RenderPipeline::DrawDebugOverlay() {
         // Right line
         screen.Draw_VLine(rect.x + rect.width - 1, rect.y, rect.height, 252);
 
-        stats_.dirty_rects_count++;
+        stats_shards_.local().dirty_rects_count++;
     }
 
     // Draw viewport border in green
@@ -453,4 +1442,102 @@ void RenderPipeline::DrawDebugOverlay() {
                       tactical_viewport_.height, 250);
     screen.Draw_VLine(tactical_viewport_.x + tactical_viewport_.width - 1, tactical_viewport_.y,
                       tactical_viewport_.height, 250);
+
+    if (network_) {
+        DrawNetworkStats(screen);
+    }
+
+    // Quality level, along the bottom of the tactical view
+    const QualityGovernor& governor = QualityGovernor::Instance();
+    if (governor.Get_Budget_Ms() > 0.0) {
+        char line[64];
+        std::snprintf(line, sizeof(line), "QUALITY %d P%d %.1f MS BUDGET %.1f MS",
+                      governor.Get_Level(), QualityGovernor::PERCENTILE,
+                      governor.Get_Frame_Ms(), governor.Get_Budget_Ms());
+        int y = tactical_viewport_.y + tactical_viewport_.height -
+                TextCache::Text_Height(TEXT_FONT_MENU) - 4;
+        TextCache::Instance().Draw(screen, line, tactical_viewport_.x + 4, y, TEXT_FONT_MENU,
+                                   governor.Get_Level() > 0 ? 252 : 250);
+    }
+}
+
+// =============================================================================
+// Network Stats
+// =============================================================================
+
+namespace {
+
+constexpr int NET_STATS_MAX_PEERS = 8;
+constexpr uint8_t NET_STATS_COLOR = 250;
+constexpr uint8_t NET_STATS_WARN_COLOR = 252;
+
+}  // namespace
+
+void RenderPipeline::PublishNetworkStats() {
+    FrameDelayStats delay = {};
+    TrafficStats traffic = {};
+    if (Platform_NetworkManager_GetFrameDelayStats(network_, &delay) != 0 ||
+        Platform_NetworkManager_GetTrafficStats(network_, &traffic) != 0) {
+        return;
+    }
+    PeerLatencyStats peers[NET_STATS_MAX_PEERS];
+    int peer_count = Platform_NetworkManager_GetPeerStats(network_, peers, NET_STATS_MAX_PEERS);
+
+    uint32_t worst_loss = 0;
+    for (int i = 0; i < peer_count; i++) {
+        worst_loss = std::max(worst_loss, peers[i].loss_permille);
+    }
+
+    Profiler& profiler = Profiler::instance();
+    for (uint32_t i = network_stalls_; i < delay.stall_count; i++) {
+        profiler.increment_counter(PROFILE_ID("Net Stalls"));
+    }
+    network_stalls_ = delay.stall_count;
+
+    profiler.record_value(PROFILE_ID("Net RTT (ms)"), delay.rtt_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Net Jitter (ms)"), delay.jitter_us / 1000.0);
+    profiler.record_value(PROFILE_ID("Net Loss (%)"), worst_loss / 10.0);
+    profiler.record_value(PROFILE_ID("Net Frame Delay"), delay.frame_delay);
+    profiler.record_value(PROFILE_ID("Net In (KB/s)"), traffic.bytes_in_per_sec / 1024.0);
+    profiler.record_value(PROFILE_ID("Net Out (KB/s)"), traffic.bytes_out_per_sec / 1024.0);
+}
+
+void RenderPipeline::DrawNetworkStats(GraphicsBuffer& screen) {
+    FrameDelayStats delay = {};
+    TrafficStats traffic = {};
+    if (Platform_NetworkManager_GetFrameDelayStats(network_, &delay) != 0 ||
+        Platform_NetworkManager_GetTrafficStats(network_, &traffic) != 0) {
+        return;
+    }
+    PeerLatencyStats peers[NET_STATS_MAX_PEERS];
+    int peer_count = Platform_NetworkManager_GetPeerStats(network_, peers, NET_STATS_MAX_PEERS);
+
+    // The menu font has digits, letters, '-' and '.', nothing else
+    TextCache& text = TextCache::Instance();
+    int line_height = TextCache::Text_Height(TEXT_FONT_MENU) + 2;
+    int x = tactical_viewport_.x + 4;
+    int y = tactical_viewport_.y + 4;
+    char line[96];
+
+    std::snprintf(line, sizeof(line), "NET DELAY %u STALLS %u %.1f S",
+                  delay.frame_delay, delay.stall_count, delay.stall_us / 1000000.0);
+    text.Draw(screen, line, x, y, TEXT_FONT_MENU,
+              delay.frame_delay > delay.target_delay ? NET_STATS_WARN_COLOR : NET_STATS_COLOR);
+    y += line_height;
+
+    std::snprintf(line, sizeof(line), "IN %.1f KBPS %u PPS  OUT %.1f KBPS %u PPS",
+                  traffic.bytes_in_per_sec / 1024.0, traffic.packets_in_per_sec,
+                  traffic.bytes_out_per_sec / 1024.0, traffic.packets_out_per_sec);
+    text.Draw(screen, line, x, y, TEXT_FONT_MENU, NET_STATS_COLOR);
+    y += line_height;
+
+    for (int i = 0; i < peer_count; i++) {
+        const PeerLatencyStats& peer = peers[i];
+        std::snprintf(line, sizeof(line), "PEER %d RTT %.1f MS JIT %.1f MS LOSS %.1f PCT",
+                      i + 1, peer.rtt_us / 1000.0, peer.jitter_us / 1000.0,
+                      peer.loss_permille / 10.0);
+        text.Draw(screen, line, x, y, TEXT_FONT_MENU,
+                  peer.loss_permille >= 50 ? NET_STATS_WARN_COLOR : NET_STATS_COLOR);
+        y += line_height;
+    }
 }
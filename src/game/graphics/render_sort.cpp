@@ -0,0 +1,113 @@
+/**
+ * Render Sort Implementation
+ *
+ * One pass over the keys builds all eight byte histograms. Bytes that
+ * are the same in every key (bucket count == n) need no pass. Layers
+ * and textures only use a few values, so most queues sort in three or
+ * four scatter passes.
+ */
+
+#include "game/graphics/render_sort.h"
+#include <cstring>
+#include <utility>
+
+// =============================================================================
+// RenderSorter
+// =============================================================================
+
+void RenderSorter::Begin(size_t expected) {
+    keys_.clear();
+    if (expected > keys_.capacity()) {
+        keys_.reserve(expected);
+    }
+}
+
+const uint32_t* RenderSorter::Sort() {
+    size_t n = keys_.size();
+    last_passes_ = 0;
+
+    if (n == 0) {
+        last_path_ = SORT_PATH_NONE;
+        prev_keys_.clear();
+        order_.clear();
+        return order_.data();
+    }
+
+    // Nothing moved since last frame: the old order still holds
+    if (prev_keys_.size() == n && order_.size() == n &&
+        memcmp(prev_keys_.data(), keys_.data(), n * sizeof(uint64_t)) == 0) {
+        last_path_ = SORT_PATH_REUSED;
+        return order_.data();
+    }
+
+    prev_keys_.assign(keys_.begin(), keys_.end());
+    order_.resize(n);
+
+    bool ordered = true;
+    for (size_t i = 1; i < n; i++) {
+        if (keys_[i] < keys_[i - 1]) {
+            ordered = false;
+            break;
+        }
+    }
+
+    if (ordered) {
+        for (size_t i = 0; i < n; i++) {
+            order_[i] = static_cast<uint32_t>(i);
+        }
+        last_path_ = SORT_PATH_ORDERED;
+        return order_.data();
+    }
+
+    Radix_Sort();
+    last_path_ = SORT_PATH_RADIX;
+    return order_.data();
+}
+
+void RenderSorter::Radix_Sort() {
+    size_t n = keys_.size();
+
+    uint32_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = keys_[i];
+        for (int b = 0; b < 8; b++) {
+            counts[b][(key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    sort_keys_.assign(keys_.begin(), keys_.end());
+    for (size_t i = 0; i < n; i++) {
+        order_[i] = static_cast<uint32_t>(i);
+    }
+    tmp_keys_.resize(n);
+    tmp_order_.resize(n);
+
+    for (int b = 0; b < 8; b++) {
+        uint32_t* count = counts[b];
+        int shift = b * 8;
+
+        // Every key has the same digit here
+        if (count[(sort_keys_[0] >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            uint32_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key = sort_keys_[i];
+            uint32_t dst = count[(key >> shift) & 0xFF]++;
+            tmp_keys_[dst] = key;
+            tmp_order_[dst] = order_[i];
+        }
+
+        sort_keys_.swap(tmp_keys_);
+        order_.swap(tmp_order_);
+        last_passes_++;
+    }
+}
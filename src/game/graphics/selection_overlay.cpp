@@ -0,0 +1,170 @@
+/**
+ * SelectionOverlay Implementation
+ */
+
+#include "game/graphics/selection_overlay.h"
+#include "game/graphics/graphics_buffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Records this far off screen are dropped rather than stored in int16
+constexpr int COORD_LIMIT = 16384;
+
+// Fill [x, x + length) of one row, clipped to the row
+inline void Span(uint8_t* line, int width, int x, int length, uint8_t color) {
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + length, width);
+    if (x0 < x1) {
+        memset(line + x0, color, x1 - x0);
+    }
+}
+
+} // namespace
+
+SelectionOverlay& SelectionOverlay::Instance() {
+    static SelectionOverlay instance;
+    return instance;
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void SelectionOverlay::Push(RecordKind kind, int x, int y, int w, int h, int extra,
+                            uint8_t color, uint8_t fill_color) {
+    if (w <= 0 || h <= 0 || w >= COORD_LIMIT || h >= COORD_LIMIT ||
+        x <= -COORD_LIMIT || x >= COORD_LIMIT || y <= -COORD_LIMIT || y >= COORD_LIMIT) {
+        return;
+    }
+
+    Record record;
+    record.x = static_cast<int16_t>(x);
+    record.y = static_cast<int16_t>(y);
+    record.w = static_cast<int16_t>(w);
+    record.h = static_cast<int16_t>(h);
+    record.extra = static_cast<int16_t>(extra);
+    record.kind = kind;
+    record.color = color;
+    record.fill_color = fill_color;
+    records_.push_back(record);
+}
+
+void SelectionOverlay::Add_Brackets(int x, int y, int w, int h, uint8_t color) {
+    // Arms a quarter of the shorter side, so small boxes still show corners
+    int arm = std::max(std::min(w, h) / 4, 2);
+    Push(RECORD_BRACKETS, x, y, w, h, std::min(arm, std::min(w, h)), color);
+}
+
+void SelectionOverlay::Add_Box(int x, int y, int w, int h, uint8_t color) {
+    Push(RECORD_BOX, x, y, w, h, 0, color);
+}
+
+void SelectionOverlay::Add_Health_Bar(int x, int y, int w, int percent) {
+    if (w < 3) {
+        return;
+    }
+    percent = std::clamp(percent, 0, 100);
+    int inside = w - 2;
+    int fill = inside * percent / 100;
+    if (fill == 0 && percent > 0) {
+        fill = 1;       // Anything alive shows
+    }
+
+    uint8_t fill_color = OVERLAY_COLOR_RED;
+    if (percent > 50) {
+        fill_color = OVERLAY_COLOR_GREEN;
+    } else if (percent > 25) {
+        fill_color = OVERLAY_COLOR_YELLOW;
+    }
+    Push(RECORD_HEALTH, x, y, w, HEALTH_BAR_HEIGHT, fill, OVERLAY_COLOR_BLACK, fill_color);
+}
+
+// =============================================================================
+// Rasterizing
+// =============================================================================
+
+void SelectionOverlay::Draw_Row(const Record& record, int row, uint8_t* line, int width) {
+    int x = record.x;
+    int w = record.w;
+    int from_top = row - record.y;
+    int from_bottom = record.y + record.h - 1 - row;
+    bool edge = (from_top == 0 || from_bottom == 0);
+
+    switch (record.kind) {
+        case RECORD_BRACKETS: {
+            int arm = record.extra;
+            if (edge) {
+                Span(line, width, x, arm, record.color);
+                Span(line, width, x + w - arm, arm, record.color);
+            } else if (from_top < arm || from_bottom < arm) {
+                Span(line, width, x, 1, record.color);
+                Span(line, width, x + w - 1, 1, record.color);
+            }
+            break;
+        }
+
+        case RECORD_BOX:
+            if (edge) {
+                Span(line, width, x, w, record.color);
+            } else {
+                Span(line, width, x, 1, record.color);
+                Span(line, width, x + w - 1, 1, record.color);
+            }
+            break;
+
+        case RECORD_HEALTH: {
+            if (edge) {
+                Span(line, width, x, w, record.color);
+                break;
+            }
+            int fill = record.extra;
+            Span(line, width, x, 1, record.color);
+            Span(line, width, x + 1, fill, record.fill_color);
+            Span(line, width, x + 1 + fill, w - 1 - fill, record.color);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+int SelectionOverlay::Draw(uint8_t* pixels, int pitch, int width, int rows, int top) const {
+    if (!pixels || records_.empty() || rows <= 0 || width <= 0) {
+        return 0;
+    }
+
+    int bottom = top + rows;
+    int drawn = 0;
+    for (const Record& record : records_) {
+        int first = std::max<int>(record.y, 0);
+        if (first >= top && first < bottom && first < record.y + record.h &&
+            record.x < width && record.x + record.w > 0) {
+            drawn++;
+        }
+    }
+
+    // Band by band, so each band's rows stay in cache while every record
+    // crossing them is cut into spans
+    for (int band_top = top; band_top < bottom; band_top += BAND_ROWS) {
+        int band_bottom = std::min(band_top + BAND_ROWS, bottom);
+        for (const Record& record : records_) {
+            int r0 = std::max<int>(record.y, band_top);
+            int r1 = std::min<int>(record.y + record.h, band_bottom);
+            if (r0 >= r1 || record.x >= width || record.x + record.w <= 0) {
+                continue;
+            }
+            for (int row = r0; row < r1; row++) {
+                Draw_Row(record, row, pixels + static_cast<size_t>(row - top) * pitch, width);
+            }
+        }
+    }
+    return drawn;
+}
+
+int SelectionOverlay::Draw(GraphicsBuffer& target) const {
+    return Draw(target.Get_Buffer(), target.Get_Pitch(), target.Get_Width(),
+                target.Get_Height(), 0);
+}
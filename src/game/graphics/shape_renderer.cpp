@@ -4,8 +4,235 @@
 
 #include "game/graphics/shape_renderer.h"
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/blit_kernels.h"
+#include "game/asset_manifest.h"
+#include "game/asset_pack.h"
+#include "game/shared_asset_cache.h"
 #include "platform.h"
+#include "platform/startup_trace.h"
+#include "platform/io_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstring>
+#include <thread>
+
+// =============================================================================
+// ShapeFrame - Span Encoding
+// =============================================================================
+
+namespace {
+
+/**
+ * Walk the opaque runs of a span-encoded frame inside a clip rectangle
+ *
+ * The op is called as op(col, row, pixels, count) where col/row are
+ * relative to the clipped destination origin.
+ */
+template <typename SpanOp>
+void For_Each_Span(const ShapeFrameView& frame, int src_x, int src_y,
+                   int width, int height, SpanOp op) {
+    const uint8_t* data = frame.spans;
+    const int clip_r = src_x + width;
+
+    for (int row = 0; row < height; row++) {
+        int sy = src_y + row;
+        const uint8_t* p = data + frame.row_offsets[sy];
+        const uint8_t* end = data + frame.row_offsets[sy + 1];
+        int fx = 0;
+
+        while (p < end) {
+            fx += p[0];
+            int count = p[1];
+            const uint8_t* pix = p + 2;
+            p += 2 + count;
+
+            int run_start = fx;
+            int run_end = fx + count;
+            fx = run_end;
+
+            if (run_end <= src_x) continue;
+            if (run_start >= clip_r) break;
+
+            int start = std::max(run_start, src_x);
+            int stop = std::min(run_end, clip_r);
+            op(start - src_x, row, pix + (start - run_start), stop - start);
+        }
+    }
+}
+
+/**
+ * Write a span-encoded frame out densely (dst: width * height bytes)
+ */
+void Expand_Spans(const ShapeFrameView& frame, uint8_t* dst) {
+    const int w = frame.width;
+    memset(dst, 0, frame.GetSize());
+    For_Each_Span(frame, 0, 0, frame.width, frame.height,
+        [dst, w](int col, int row, const uint8_t* pix, int count) {
+            memcpy(dst + static_cast<size_t>(row) * w + col, pix, count);
+        });
+}
+
+} // namespace
+
+bool ShapeFrame::BuildSpans(bool release_pixels) {
+    if (pixels.size() < GetSize() || !BuildSpansFrom(pixels.data())) {
+        return false;
+    }
+
+    if (release_pixels) {
+        pixels.clear();
+        pixels.shrink_to_fit();
+    }
+    return true;
+}
+
+bool ShapeFrame::BuildSpansFrom(const uint8_t* source) {
+    if (width <= 0 || height <= 0 || source == nullptr) {
+        return false;
+    }
+
+    spans.clear();
+    row_offsets.clear();
+    row_offsets.reserve(static_cast<size_t>(height) + 1);
+
+    for (int y = 0; y < height; y++) {
+        row_offsets.push_back(static_cast<uint32_t>(spans.size()));
+        const uint8_t* row = source + static_cast<size_t>(y) * width;
+        int x = 0;
+
+        while (x < width) {
+            int skip = 0;
+            while (x < width && row[x] == 0) {
+                x++;
+                skip++;
+            }
+            if (x >= width) {
+                break;  // Trailing transparency is implicit
+            }
+
+            while (skip > 255) {
+                spans.push_back(255);
+                spans.push_back(0);
+                skip -= 255;
+            }
+
+            int run_start = x;
+            while (x < width && row[x] != 0 && x - run_start < 255) {
+                x++;
+            }
+
+            spans.push_back(static_cast<uint8_t>(skip));
+            spans.push_back(static_cast<uint8_t>(x - run_start));
+            spans.insert(spans.end(), row + run_start, row + x);
+        }
+    }
+    row_offsets.push_back(static_cast<uint32_t>(spans.size()));
+    spans.shrink_to_fit();
+    return true;
+}
+
+bool ShapeFrame::ExpandSpans() {
+    if (HasPixels()) {
+        return true;
+    }
+    if (!HasSpans() || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    ShapeFrameView view = View();
+    pixels.resize(GetSize());
+    Expand_Spans(view, pixels.data());
+    return true;
+}
+
+size_t ShapeFrame::GetMemoryUsage() const {
+    return pixels.capacity() + spans.capacity() +
+           row_offsets.capacity() * sizeof(uint32_t);
+}
+
+ShapeFrameView ShapeFrame::View() const {
+    ShapeFrameView view;
+    view.x_offset = x_offset;
+    view.y_offset = y_offset;
+    view.width = width;
+    view.height = height;
+    if (HasPixels()) {
+        view.pixels = pixels.data();
+    } else if (HasSpans()) {
+        view.spans = spans.data();
+        view.row_offsets = row_offsets.data();
+    }
+    return view;
+}
+
+// =============================================================================
+// ShapeFrameSlab
+// =============================================================================
+
+ShapeFrameSlab::ShapeFrameSlab(ShapeFrameSlab&& other) noexcept
+    : data_(std::move(other.data_))
+    , size_(other.size_)
+    , capacity_(other.capacity_)
+{
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+ShapeFrameSlab& ShapeFrameSlab::operator=(ShapeFrameSlab&& other) noexcept {
+    if (this != &other) {
+        data_ = std::move(other.data_);
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+    return *this;
+}
+
+size_t ShapeFrameSlab::GetFrameBytes(int height, size_t spans_size) {
+    // Padded so the next frame's row offsets stay 4-byte aligned
+    size_t bytes = (static_cast<size_t>(height) + 1) * sizeof(uint32_t) + spans_size;
+    return (bytes + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+}
+
+void ShapeFrameSlab::Reserve(size_t bytes) {
+    if (size_ + bytes > capacity_) {
+        Grow(size_ + bytes);
+    }
+}
+
+uint32_t ShapeFrameSlab::Append(const ShapeFrame& frame) {
+    size_t bytes = GetFrameBytes(frame.height, frame.spans.size());
+    if (size_ + bytes > capacity_) {
+        Grow(std::max(size_ + bytes, capacity_ * 2));
+    }
+
+    uint32_t offset = static_cast<uint32_t>(size_);
+    uint8_t* dst = data_.get() + offset;
+    size_t rows_bytes = frame.row_offsets.size() * sizeof(uint32_t);
+    memcpy(dst, frame.row_offsets.data(), rows_bytes);
+    if (!frame.spans.empty()) {
+        memcpy(dst + rows_bytes, frame.spans.data(), frame.spans.size());
+    }
+    size_ += bytes;
+    return offset;
+}
+
+void ShapeFrameSlab::Clear() {
+    data_.reset();
+    size_ = 0;
+    capacity_ = 0;
+}
+
+void ShapeFrameSlab::Grow(size_t capacity) {
+    std::unique_ptr<uint8_t[]> data(new uint8_t[capacity]);
+    if (size_ > 0) {
+        memcpy(data.get(), data_.get(), size_);
+    }
+    data_ = std::move(data);
+    capacity_ = capacity;
+}
 
 // =============================================================================
 // ShapeRenderer - Construction
@@ -13,6 +240,7 @@
 
 ShapeRenderer::ShapeRenderer()
     : shape_(nullptr)
+    , packed_(nullptr)
     , width_(0)
     , height_(0)
     , frame_count_(0)
@@ -25,13 +253,19 @@ ShapeRenderer::~ShapeRenderer() {
 
 ShapeRenderer::ShapeRenderer(ShapeRenderer&& other) noexcept
     : shape_(other.shape_)
-    , name_(std::move(other.name_))
+    , packed_(other.packed_)
+    , name_(other.name_)
     , width_(other.width_)
     , height_(other.height_)
     , frame_count_(other.frame_count_)
     , frame_cache_(std::move(other.frame_cache_))
+    , slab_(std::move(other.slab_))
+    , flipped_cache_(std::move(other.flipped_cache_))
+    , flipped_slab_(std::move(other.flipped_slab_))
 {
     other.shape_ = nullptr;
+    other.packed_ = nullptr;
+    other.name_.clear();
     other.width_ = 0;
     other.height_ = 0;
     other.frame_count_ = 0;
@@ -42,13 +276,19 @@ ShapeRenderer& ShapeRenderer::operator=(ShapeRenderer&& other) noexcept {
         Unload();
 
         shape_ = other.shape_;
-        name_ = std::move(other.name_);
+        packed_ = other.packed_;
+        name_ = other.name_;
         width_ = other.width_;
         height_ = other.height_;
         frame_count_ = other.frame_count_;
         frame_cache_ = std::move(other.frame_cache_);
+        slab_ = std::move(other.slab_);
+        flipped_cache_ = std::move(other.flipped_cache_);
+        flipped_slab_ = std::move(other.flipped_slab_);
 
         other.shape_ = nullptr;
+        other.packed_ = nullptr;
+        other.name_.clear();
         other.width_ = 0;
         other.height_ = 0;
         other.frame_count_ = 0;
@@ -67,6 +307,11 @@ bool ShapeRenderer::Load(const char* filename) {
         return false;
     }
 
+    if (LoadPacked(filename)) {
+        return true;
+    }
+
+    IoScope io(IoTag::GRAPHICS);
     shape_ = Platform_Shape_Load(filename);
     if (!shape_) {
         return false;
@@ -84,6 +329,7 @@ bool ShapeRenderer::Load(const char* filename) {
     // Initialize frame cache (empty frames)
     frame_cache_.resize(frame_count_);
 
+    SharedAssetCache::Note_Shape(filename);
     return true;
 }
 
@@ -114,16 +360,36 @@ bool ShapeRenderer::LoadFromMemory(const uint8_t* data, int32_t size, const char
     return true;
 }
 
+bool ShapeRenderer::LoadPacked(const char* filename) {
+    AssetPackBlob blob;
+    const AssetPackShape* packed = AssetPack::Instance().FindShape(filename, &blob);
+    if (!packed) {
+        return false;
+    }
+
+    packed_ = blob.data;
+    name_ = filename;
+    width_ = packed->width;
+    height_ = packed->height;
+    frame_count_ = packed->frame_count;
+    frame_cache_.resize(frame_count_);
+    return true;
+}
+
 void ShapeRenderer::Unload() {
     if (shape_) {
         Platform_Shape_Free(shape_);
         shape_ = nullptr;
     }
+    packed_ = nullptr;
     name_.clear();
     width_ = 0;
     height_ = 0;
     frame_count_ = 0;
     frame_cache_.clear();
+    slab_.Clear();
+    flipped_cache_.clear();
+    flipped_slab_.Clear();
 }
 
 // =============================================================================
@@ -153,13 +419,13 @@ bool ShapeRenderer::GetFrameSize(int frame, int* width, int* height) const {
     }
 
     // Need to get frame data to know dimensions
-    const ShapeFrame* f = const_cast<ShapeRenderer*>(this)->GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = const_cast<ShapeRenderer*>(this)->GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    if (width) *width = f->width;
-    if (height) *height = f->height;
+    if (width) *width = f.width;
+    if (height) *height = f.height;
     return true;
 }
 
@@ -168,13 +434,13 @@ bool ShapeRenderer::GetFrameOffset(int frame, int* x_offset, int* y_offset) cons
         return false;
     }
 
-    const ShapeFrame* f = const_cast<ShapeRenderer*>(this)->GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = const_cast<ShapeRenderer*>(this)->GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    if (x_offset) *x_offset = f->x_offset;
-    if (y_offset) *y_offset = f->y_offset;
+    if (x_offset) *x_offset = f.x_offset;
+    if (y_offset) *y_offset = f.y_offset;
     return true;
 }
 
@@ -182,82 +448,342 @@ bool ShapeRenderer::GetFrameOffset(int frame, int* x_offset, int* y_offset) cons
 // Frame Cache
 // =============================================================================
 
-const ShapeFrame* ShapeRenderer::GetFrame(int frame) {
+ShapeFrameView ShapeRenderer::GetFrame(int frame) {
     if (frame < 0 || frame >= frame_count_) {
-        return nullptr;
+        return ShapeFrameView();
     }
 
-    ShapeFrame& cached = frame_cache_[frame];
-
-    // Return cached frame if already loaded
-    if (cached.IsValid()) {
-        return &cached;
-    }
-
-    // Need to decompress frame from platform shape
-    if (!shape_) {
-        return nullptr;
+    FrameSlot& slot = frame_cache_[frame];
+    if (!slot.IsCached()) {
+        ShapeFrame built;
+        if (!shape_) {
+            // Packed frames are spans already
+            if (!BuildFrameSpans(frame, built)) {
+                return ShapeFrameView();
+            }
+            StoreSpans(slot, slab_, built);
+        } else {
+            if (!DecodeFrame(frame, built)) {
+                return ShapeFrameView();
+            }
+            slot.x_offset = built.x_offset;
+            slot.y_offset = built.y_offset;
+            slot.width = built.width;
+            slot.height = built.height;
+            slot.pixels = std::move(built.pixels);
+        }
     }
+    return ViewOf(slot, slab_);
+}
 
-    // Get frame data from platform layer
-    // First, allocate max possible size
+bool ShapeRenderer::DecodeFrame(int frame, ShapeFrame& out) const {
+    // Sized for the largest frame, trimmed to what the platform wrote
     size_t max_size = static_cast<size_t>(width_) * height_;
-    std::vector<uint8_t> temp_buffer(max_size);
+    out.pixels.resize(max_size);
 
     int32_t bytes = Platform_Shape_GetFrame(shape_, frame,
-                                             temp_buffer.data(),
+                                             out.pixels.data(),
                                              static_cast<int32_t>(max_size));
     if (bytes <= 0) {
-        return nullptr;
+        out.pixels.clear();
+        return false;
     }
 
     // Set frame dimensions from shape max size
     // The platform layer returns raw pixel data
-    cached.x_offset = 0;
-    cached.y_offset = 0;
-    cached.width = static_cast<int16_t>(width_);
-    cached.height = static_cast<int16_t>(height_);
+    out.x_offset = 0;
+    out.y_offset = 0;
+    out.width = static_cast<int16_t>(width_);
+    out.height = static_cast<int16_t>(height_);
 
     // Adjust height if we got fewer bytes than expected
     int expected = width_ * height_;
     if (bytes < expected) {
-        cached.height = static_cast<int16_t>(bytes / width_);
-        if (cached.height <= 0) cached.height = 1;
+        out.height = static_cast<int16_t>(bytes / width_);
+        if (out.height <= 0) out.height = 1;
+    }
+    out.pixels.resize(static_cast<size_t>(bytes));
+    return true;
+}
+
+bool ShapeRenderer::BuildFrameSpans(int frame, ShapeFrame& out) const {
+    if (frame < 0 || frame >= frame_count_) {
+        return false;
+    }
+
+    // Drawn before, so already decoded
+    const FrameSlot& slot = frame_cache_[frame];
+    if (!slot.pixels.empty()) {
+        out.x_offset = slot.x_offset;
+        out.y_offset = slot.y_offset;
+        out.width = slot.width;
+        out.height = slot.height;
+        out.pixels = slot.pixels;
+        return out.BuildSpans(true);
+    }
+
+    if (shape_) {
+        return DecodeFrame(frame, out) && out.BuildSpans(true);
+    }
+    if (!packed_) {
+        return false;
+    }
+
+    // Copy out of the mapping, checking the offsets on the way
+    const AssetPackFrame* frames =
+        reinterpret_cast<const AssetPackFrame*>(packed_ + sizeof(AssetPackShape));
+    const AssetPackFrame& src = frames[frame];
+    if (src.width <= 0 || src.height <= 0) {
+        return false;
+    }
+
+    std::vector<uint32_t> rows(static_cast<size_t>(src.height) + 1);
+    memcpy(rows.data(), packed_ + src.rows_offset, rows.size() * sizeof(uint32_t));
+    if (rows[0] != 0 || rows.back() != src.spans_size ||
+        !std::is_sorted(rows.begin(), rows.end())) {
+        return false;
+    }
+
+    out.x_offset = src.x_offset;
+    out.y_offset = src.y_offset;
+    out.width = src.width;
+    out.height = src.height;
+    out.spans.assign(packed_ + src.spans_offset, packed_ + src.spans_offset + src.spans_size);
+    out.row_offsets.swap(rows);
+    return true;
+}
+
+void ShapeRenderer::StoreSpans(FrameSlot& slot, ShapeFrameSlab& slab, const ShapeFrame& frame) {
+    slot.x_offset = frame.x_offset;
+    slot.y_offset = frame.y_offset;
+    slot.width = frame.width;
+    slot.height = frame.height;
+    slot.slab_offset = slab.Append(frame);
+    std::vector<uint8_t>().swap(slot.pixels);
+}
+
+ShapeFrameView ShapeRenderer::ViewOf(const FrameSlot& slot, const ShapeFrameSlab& slab) {
+    ShapeFrameView view;
+    view.x_offset = slot.x_offset;
+    view.y_offset = slot.y_offset;
+    view.width = slot.width;
+    view.height = slot.height;
+    if (slot.InSlab()) {
+        view.row_offsets = slab.Rows(slot.slab_offset);
+        view.spans = slab.Spans(slot.slab_offset, slot.height);
+    } else if (!slot.pixels.empty()) {
+        view.pixels = slot.pixels.data();
+    }
+    return view;
+}
+
+ShapeFrameView ShapeRenderer::GetFlippedFrame(int frame, uint32_t flags) {
+    int variant = ((flags & SHAPE_FLIP_X) ? 1 : 0) | ((flags & SHAPE_FLIP_Y) ? 2 : 0);
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid() || variant == 0) {
+        return f;
     }
 
-    // Copy pixel data
-    cached.pixels.assign(temp_buffer.begin(), temp_buffer.begin() + bytes);
+    if (flipped_cache_.empty()) {
+        flipped_cache_.resize(static_cast<size_t>(frame_count_) * FLIP_VARIANTS);
+    }
+
+    FrameSlot& slot = flipped_cache_[frame * FLIP_VARIANTS + (variant - 1)];
+    if (slot.IsCached()) {
+        return ViewOf(slot, flipped_slab_);
+    }
 
-    return &cached;
+    // Need dense source pixels to mirror from
+    std::vector<uint8_t> expanded;
+    const uint8_t* source = f.pixels;
+    if (!source) {
+        expanded.resize(f.GetSize());
+        Expand_Spans(f, expanded.data());
+        source = expanded.data();
+    }
+
+    const int w = f.width;
+    const int h = f.height;
+    ShapeFrame mirrored;
+    mirrored.x_offset = f.x_offset;
+    mirrored.y_offset = f.y_offset;
+    mirrored.width = f.width;
+    mirrored.height = f.height;
+    mirrored.pixels.resize(f.GetSize());
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t* src_row = source + static_cast<size_t>(y) * w;
+        int dy = (variant & 2) ? (h - 1 - y) : y;
+        uint8_t* dst_row = mirrored.pixels.data() + static_cast<size_t>(dy) * w;
+        if (variant & 1) {
+            std::reverse_copy(src_row, src_row + w, dst_row);
+        } else {
+            memcpy(dst_row, src_row, w);
+        }
+    }
+
+    // Keep the same representation as the original frame; mirrors have a
+    // slab of their own so f (in slab_) stays put
+    if (f.HasSpans() && mirrored.BuildSpans(true)) {
+        StoreSpans(slot, flipped_slab_, mirrored);
+    } else {
+        slot.x_offset = mirrored.x_offset;
+        slot.y_offset = mirrored.y_offset;
+        slot.width = mirrored.width;
+        slot.height = mirrored.height;
+        slot.pixels = std::move(mirrored.pixels);
+    }
+    return ViewOf(slot, flipped_slab_);
 }
 
-void ShapeRenderer::PrecacheAllFrames() {
+void ShapeRenderer::PrecacheAllFrames(int worker_count) {
+    if (worker_count <= 0) {
+        worker_count = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    }
+    worker_count = std::min(worker_count, frame_count_ / PRECACHE_MIN_FRAMES_PER_WORKER);
+
+    // Shapes from MIX files are decoded in one pass, frames in order, so
+    // each delta frame builds on the frame decoded just before it instead
+    // of replaying its chain from the keyframe
+    std::vector<uint8_t> dense;
+    size_t frame_size = static_cast<size_t>(width_) * height_;
+    if (shape_ && frame_size > 0 && frame_size * frame_count_ <= INT32_MAX) {
+        dense.resize(frame_size * frame_count_);
+        int32_t decoded = Platform_Shape_DecodeRange(shape_, 0, frame_count_, dense.data(),
+                                                     static_cast<int32_t>(dense.size()));
+        if (decoded != frame_count_) {
+            dense.clear();
+        }
+    }
+
+    // Encode every frame not yet in the slab...
+    std::vector<ShapeFrame> built(frame_count_);
+    auto build = [this, &built, &dense, frame_size](int i) {
+        if (frame_cache_[i].InSlab()) {
+            return;
+        }
+        ShapeFrame& frame = built[i];
+        bool ok;
+        if (!dense.empty()) {
+            frame.width = static_cast<int16_t>(width_);
+            frame.height = static_cast<int16_t>(height_);
+            ok = frame.BuildSpansFrom(dense.data() + frame_size * i);
+        } else {
+            ok = BuildFrameSpans(i, frame);
+        }
+        if (!ok) {
+            frame = ShapeFrame();
+        }
+    };
+
+    if (worker_count <= 1) {
+        for (int i = 0; i < frame_count_; i++) {
+            build(i);
+        }
+    } else {
+        // Batches are claimed as workers free up, since frame sizes (and
+        // so decode times) vary widely within a shape. Each frame only
+        // touches its own slot of built.
+        std::atomic<int> next_frame{0};
+        auto work = [this, &next_frame, &build]() {
+            int start;
+            while ((start = next_frame.fetch_add(PRECACHE_BATCH_FRAMES, std::memory_order_relaxed)) < frame_count_) {
+                int end = std::min(start + PRECACHE_BATCH_FRAMES, frame_count_);
+                for (int i = start; i < end; i++) {
+                    build(i);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(worker_count - 1);
+        for (int i = 1; i < worker_count; i++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // ...then copy them in, in frame order, with one allocation
+    size_t bytes = 0;
+    for (const ShapeFrame& frame : built) {
+        if (frame.HasSpans()) {
+            bytes += ShapeFrameSlab::GetFrameBytes(frame.height, frame.spans.size());
+        }
+    }
+    slab_.Reserve(bytes);
     for (int i = 0; i < frame_count_; i++) {
-        GetFrame(i);
+        if (built[i].HasSpans()) {
+            StoreSpans(frame_cache_[i], slab_, built[i]);
+            built[i] = ShapeFrame();
+        }
     }
 }
 
 void ShapeRenderer::PrecacheFrame(int frame) {
-    GetFrame(frame);
+    if (frame < 0 || frame >= frame_count_ || frame_cache_[frame].InSlab()) {
+        return;
+    }
+
+    // Convert to span form once; the dense copy is no longer needed
+    ShapeFrame built;
+    if (BuildFrameSpans(frame, built)) {
+        StoreSpans(frame_cache_[frame], slab_, built);
+    }
+}
+
+bool ShapeRenderer::PrepareFrame(int frame, uint32_t flags) {
+    return GetFlippedFrame(frame, flags).IsValid();
 }
 
 void ShapeRenderer::ClearCache() {
-    for (auto& frame : frame_cache_) {
-        frame.pixels.clear();
-        frame.pixels.shrink_to_fit();
-        frame.width = 0;
-        frame.height = 0;
+    for (FrameSlot& slot : frame_cache_) {
+        slot = FrameSlot();
     }
+    slab_.Clear();
+    flipped_cache_.clear();
+    flipped_cache_.shrink_to_fit();
+    flipped_slab_.Clear();
 }
 
 size_t ShapeRenderer::GetCacheSize() const {
-    size_t total = 0;
-    for (const auto& frame : frame_cache_) {
-        total += frame.pixels.capacity();
+    size_t total = slab_.GetCapacity() + flipped_slab_.GetCapacity();
+    for (const FrameSlot& slot : frame_cache_) {
+        total += slot.pixels.capacity();
+    }
+    for (const FrameSlot& slot : flipped_cache_) {
+        total += slot.pixels.capacity();
     }
     return total;
 }
 
+bool ShapeRenderer::CopyFramePixels(int frame, uint8_t* dst, int pitch) {
+    ShapeFrameView data = GetFrame(frame);
+    if (!data.IsValid() || !dst) {
+        return false;
+    }
+
+    const int w = data.width;
+    if (data.HasPixels()) {
+        for (int row = 0; row < data.height; row++) {
+            memcpy(dst + static_cast<size_t>(row) * pitch,
+                   data.pixels + static_cast<size_t>(row) * w, w);
+        }
+        return true;
+    }
+
+    for (int row = 0; row < data.height; row++) {
+        memset(dst + static_cast<size_t>(row) * pitch, 0, w);
+    }
+    For_Each_Span(data, 0, 0, w, data.height,
+        [dst, pitch](int col, int row, const uint8_t* pix, int count) {
+            memcpy(dst + static_cast<size_t>(row) * pitch + col, pix, count);
+        });
+    return true;
+}
+
 // =============================================================================
 // Drawing - Basic
 // =============================================================================
@@ -269,12 +795,14 @@ bool ShapeRenderer::Draw(GraphicsBuffer& buffer, int x, int y, int frame,
 
 bool ShapeRenderer::DrawRemapped(GraphicsBuffer& buffer, int x, int y, int frame,
                                   const uint8_t* remap_table, uint32_t flags) {
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFlippedFrame(frame, flags);
+    if (!f.IsValid()) {
         return false;
     }
 
-    return DrawInternal(buffer, x, y, *f, remap_table, flags, 0);
+    // The mirrored frame already encodes the flip
+    flags &= ~static_cast<uint32_t>(SHAPE_FLIP_X | SHAPE_FLIP_Y);
+    return DrawInternal(buffer, x, y, f, remap_table, flags, 0);
 }
 
 bool ShapeRenderer::DrawShadow(GraphicsBuffer& buffer, int x, int y, int frame,
@@ -283,12 +811,24 @@ bool ShapeRenderer::DrawShadow(GraphicsBuffer& buffer, int x, int y, int frame,
         return false;
     }
 
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    return DrawInternal(buffer, x, y, *f, shadow_table, SHAPE_SHADOW, 0);
+    return DrawInternal(buffer, x, y, f, shadow_table, SHAPE_SHADOW, 0);
+}
+
+bool ShapeRenderer::DrawMask(GraphicsBuffer& mask, int x, int y, int frame,
+                              uint32_t flags) {
+    ShapeFrameView f = GetFlippedFrame(frame, flags);
+    if (!f.IsValid()) {
+        return false;
+    }
+
+    // The mirrored frame already encodes the flip; no mode but flat
+    flags &= static_cast<uint32_t>(SHAPE_CENTER);
+    return DrawInternal(mask, x, y, f, nullptr, flags | SHAPE_FLAT, 1);
 }
 
 // =============================================================================
@@ -297,12 +837,12 @@ bool ShapeRenderer::DrawShadow(GraphicsBuffer& buffer, int x, int y, int frame,
 
 bool ShapeRenderer::DrawGhost(GraphicsBuffer& buffer, int x, int y, int frame,
                                int phase) {
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    return DrawInternal(buffer, x, y, *f, nullptr, SHAPE_GHOST, phase & 1);
+    return DrawInternal(buffer, x, y, f, nullptr, SHAPE_GHOST, phase & 1);
 }
 
 bool ShapeRenderer::DrawFading(GraphicsBuffer& buffer, int x, int y, int frame,
@@ -311,35 +851,35 @@ bool ShapeRenderer::DrawFading(GraphicsBuffer& buffer, int x, int y, int frame,
         return Draw(buffer, x, y, frame);
     }
 
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
     // Fade table is actually 16 tables of 256 entries each
     // Index by: fade_table[fade_level * 256 + color]
     const uint8_t* level_table = fade_table + (fade_level & 0x0F) * 256;
-    return DrawInternal(buffer, x, y, *f, level_table, SHAPE_FADING, 0);
+    return DrawInternal(buffer, x, y, f, level_table, SHAPE_FADING, 0);
 }
 
 bool ShapeRenderer::DrawPredator(GraphicsBuffer& buffer, int x, int y, int frame,
                                   int phase) {
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    return DrawInternal(buffer, x, y, *f, nullptr, SHAPE_PREDATOR, static_cast<uint8_t>(phase));
+    return DrawInternal(buffer, x, y, f, nullptr, SHAPE_PREDATOR, static_cast<uint8_t>(phase));
 }
 
 bool ShapeRenderer::DrawFlat(GraphicsBuffer& buffer, int x, int y, int frame,
                               uint8_t color) {
-    const ShapeFrame* f = GetFrame(frame);
-    if (!f || !f->IsValid()) {
+    ShapeFrameView f = GetFrame(frame);
+    if (!f.IsValid()) {
         return false;
     }
 
-    return DrawInternal(buffer, x, y, *f, nullptr, SHAPE_FLAT, color);
+    return DrawInternal(buffer, x, y, f, nullptr, SHAPE_FLAT, color);
 }
 
 // =============================================================================
@@ -347,7 +887,7 @@ bool ShapeRenderer::DrawFlat(GraphicsBuffer& buffer, int x, int y, int frame,
 // =============================================================================
 
 bool ShapeRenderer::DrawInternal(GraphicsBuffer& buffer, int x, int y,
-                                  const ShapeFrame& frame,
+                                  const ShapeFrameView& frame,
                                   const uint8_t* remap_table,
                                   uint32_t flags,
                                   uint8_t flat_color) {
@@ -406,60 +946,40 @@ bool ShapeRenderer::DrawInternal(GraphicsBuffer& buffer, int x, int y,
         return true;  // Success - just nothing visible
     }
 
-    const uint8_t* src = frame.pixels.data();
-    int src_pitch = frame.width;
-
-    // Handle horizontal flip
-    int x_step = 1;
-    int x_start = src_x;
-    if (flags & SHAPE_FLIP_X) {
-        x_step = -1;
-        x_start = frame.width - 1 - src_x;
+    // Span-encoded frames skip transparent pixels entirely
+    if (frame.HasSpans()) {
+        DrawSpans(buffer, frame, draw_x, draw_y, src_x, src_y,
+                  width, height, remap_table, flags, flat_color);
+        return true;
     }
 
-    // Handle vertical flip
-    int y_step = 1;
-    int y_start = src_y;
-    if (flags & SHAPE_FLIP_Y) {
-        y_step = -1;
-        y_start = frame.height - 1 - src_y;
-    }
+    // Flipped draws arrive here as pre-mirrored frames (GetFlippedFrame),
+    // so every mode reads source rows front to back.
+    const uint8_t* src = frame.pixels + src_y * frame.width + src_x;
+    int src_pitch = frame.width;
 
     // Draw based on mode
     if (flags & SHAPE_SHADOW) {
         // Shadow mode: darken destination pixels using shape as mask
+        const BlitKernels& kernels = GetBlitKernels();
         for (int row = 0; row < height; row++) {
-            int sy = y_start + row * y_step;
-            const uint8_t* src_row = src + sy * src_pitch;
-            uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
-
-            for (int col = 0; col < width; col++) {
-                int sx = x_start + col * x_step;
-                uint8_t pixel = src_row[sx];
-
-                if (pixel != 0) {  // Non-transparent
-                    // Apply shadow table to destination
-                    dst_row[col] = remap_table[dst_row[col]];
-                }
-            }
+            kernels.remap_masked(dest + (draw_y + row) * dest_pitch + draw_x,
+                                 src + row * src_pitch,
+                                 width, remap_table, 0);
         }
     }
     else if (flags & SHAPE_GHOST) {
         // Ghost mode: checkerboard transparency
         for (int row = 0; row < height; row++) {
-            int sy = y_start + row * y_step;
-            const uint8_t* src_row = src + sy * src_pitch;
+            const uint8_t* src_row = src + row * src_pitch;
             uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
 
-            for (int col = 0; col < width; col++) {
-                // Checkerboard pattern based on position and phase
-                if (((draw_x + col + draw_y + row + flat_color) & 1) == 0) {
-                    int sx = x_start + col * x_step;
-                    uint8_t pixel = src_row[sx];
-
-                    if (pixel != 0) {
-                        dst_row[col] = remap_table ? remap_table[pixel] : pixel;
-                    }
+            // Checkerboard pattern based on position and phase
+            int col = (draw_x + draw_y + row + flat_color) & 1;
+            for (; col < width; col += 2) {
+                uint8_t pixel = src_row[col];
+                if (pixel != 0) {
+                    dst_row[col] = remap_table ? remap_table[pixel] : pixel;
                 }
             }
         }
@@ -470,15 +990,11 @@ bool ShapeRenderer::DrawInternal(GraphicsBuffer& buffer, int x, int y,
         int shimmer_y = (flat_color % 5) - 2;  // -2 to 2
 
         for (int row = 0; row < height; row++) {
-            int sy = y_start + row * y_step;
-            const uint8_t* src_row = src + sy * src_pitch;
+            const uint8_t* src_row = src + row * src_pitch;
             uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
 
             for (int col = 0; col < width; col++) {
-                int sx = x_start + col * x_step;
-                uint8_t pixel = src_row[sx];
-
-                if (pixel != 0) {
+                if (src_row[col] != 0) {
                     // Sample from offset position in destination
                     int sample_x = draw_x + col + shimmer_x;
                     int sample_y = draw_y + row + shimmer_y;
@@ -494,69 +1010,110 @@ bool ShapeRenderer::DrawInternal(GraphicsBuffer& buffer, int x, int y,
     else if (flags & SHAPE_FLAT) {
         // Flat mode: single color using shape as mask
         for (int row = 0; row < height; row++) {
-            int sy = y_start + row * y_step;
-            const uint8_t* src_row = src + sy * src_pitch;
+            const uint8_t* src_row = src + row * src_pitch;
             uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
 
             for (int col = 0; col < width; col++) {
-                int sx = x_start + col * x_step;
-                if (src_row[sx] != 0) {
+                if (src_row[col] != 0) {
                     dst_row[col] = flat_color;
                 }
             }
         }
     }
+    else if (remap_table) {
+        // Normal or Fading mode with remapping
+        const BlitKernels& kernels = GetBlitKernels();
+        for (int row = 0; row < height; row++) {
+            kernels.copy_remap_trans(dest + (draw_y + row) * dest_pitch + draw_x,
+                                     src + row * src_pitch,
+                                     width, remap_table, 0);
+        }
+    }
     else {
-        // Normal or Fading mode: transparent blit with optional remap
-        if (remap_table) {
-            // With remapping
-            for (int row = 0; row < height; row++) {
-                int sy = y_start + row * y_step;
-                const uint8_t* src_row = src + sy * src_pitch;
-                uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
-
-                for (int col = 0; col < width; col++) {
-                    int sx = x_start + col * x_step;
-                    uint8_t pixel = src_row[sx];
-
-                    if (pixel != 0) {
-                        dst_row[col] = remap_table[pixel];
-                    }
+        // Normal mode: transparent blit
+        buffer.Blit_From_Raw_Trans(
+            frame.pixels, src_pitch,
+            src_x, src_y, frame.width, frame.height,
+            draw_x, draw_y,
+            width, height,
+            0  // Transparent color
+        );
+    }
+
+    return true;
+}
+
+void ShapeRenderer::DrawSpans(GraphicsBuffer& buffer,
+                              const ShapeFrameView& frame,
+                              int draw_x, int draw_y,
+                              int src_x, int src_y,
+                              int width, int height,
+                              const uint8_t* remap_table,
+                              uint32_t flags,
+                              uint8_t flat_color) {
+    uint8_t* dest = buffer.Get_Buffer();
+    const int dest_w = buffer.Get_Width();
+    const int dest_h = buffer.Get_Height();
+    const int dest_pitch = buffer.Get_Pitch();
+    uint8_t* origin = dest + draw_y * dest_pitch + draw_x;
+
+    const BlitKernels& kernels = GetBlitKernels();
+
+    if (flags & SHAPE_SHADOW) {
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=, &kernels](int col, int row, const uint8_t*, int count) {
+                kernels.remap_inplace(origin + row * dest_pitch + col, count, remap_table);
+            });
+    }
+    else if (flags & SHAPE_GHOST) {
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=](int col, int row, const uint8_t* pix, int count) {
+                uint8_t* d = origin + row * dest_pitch + col;
+                // Start on the first pixel of the checkerboard phase
+                int i = (draw_x + col + draw_y + row + flat_color) & 1;
+                for (; i < count; i += 2) {
+                    d[i] = remap_table ? remap_table[pix[i]] : pix[i];
                 }
-            }
-        } else {
-            // No remapping - use platform blit for speed
-            // But we need to handle flipping manually if requested
-            if ((flags & (SHAPE_FLIP_X | SHAPE_FLIP_Y)) == 0) {
-                // No flipping - can use fast path
-                buffer.Blit_From_Raw_Trans(
-                    src, src_pitch,
-                    src_x, src_y, frame.width, frame.height,
-                    draw_x, draw_y,
-                    width, height,
-                    0  // Transparent color
-                );
-            } else {
-                // Manual loop for flipping
-                for (int row = 0; row < height; row++) {
-                    int sy = y_start + row * y_step;
-                    const uint8_t* src_row = src + sy * src_pitch;
-                    uint8_t* dst_row = dest + (draw_y + row) * dest_pitch + draw_x;
-
-                    for (int col = 0; col < width; col++) {
-                        int sx = x_start + col * x_step;
-                        uint8_t pixel = src_row[sx];
-
-                        if (pixel != 0) {
-                            dst_row[col] = pixel;
-                        }
+            });
+    }
+    else if (flags & SHAPE_PREDATOR) {
+        int shimmer_x = (flat_color % 3) - 1;
+        int shimmer_y = (flat_color % 5) - 2;
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=](int col, int row, const uint8_t*, int count) {
+                uint8_t* d = origin + row * dest_pitch + col;
+                int sample_y = draw_y + row + shimmer_y;
+                if (sample_y < 0 || sample_y >= dest_h) {
+                    return;
+                }
+                const uint8_t* sample_row = dest + sample_y * dest_pitch;
+                for (int i = 0; i < count; i++) {
+                    int sample_x = draw_x + col + i + shimmer_x;
+                    if (sample_x >= 0 && sample_x < dest_w) {
+                        d[i] = sample_row[sample_x];
                     }
                 }
-            }
-        }
+            });
+    }
+    else if (flags & SHAPE_FLAT) {
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=](int col, int row, const uint8_t*, int count) {
+                memset(origin + row * dest_pitch + col, flat_color, count);
+            });
+    }
+    else if (remap_table) {
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=, &kernels](int col, int row, const uint8_t* pix, int count) {
+                kernels.copy_remap(origin + row * dest_pitch + col, pix, count, remap_table);
+            });
+    }
+    else {
+        // Runs are fully opaque - straight copy
+        For_Each_Span(frame, src_x, src_y, width, height,
+            [=](int col, int row, const uint8_t* pix, int count) {
+                memcpy(origin + row * dest_pitch + col, pix, count);
+            });
     }
-
-    return true;
 }
 
 // =============================================================================
@@ -573,6 +1130,15 @@ bool Draw_Shape(GraphicsBuffer& buffer, const char* filename,
     return renderer->Draw(buffer, x, y, frame, flags);
 }
 
+bool Draw_Shape(GraphicsBuffer& buffer, ShapeId id,
+                int x, int y, int frame, uint32_t flags) {
+    ShapeRenderer* renderer = ShapeCache::Instance().Get(id);
+    if (!renderer) {
+        return false;
+    }
+    return renderer->Draw(buffer, x, y, frame, flags);
+}
+
 // =============================================================================
 // ShapeCache Implementation
 // =============================================================================
@@ -586,24 +1152,45 @@ ShapeCache::~ShapeCache() {
     Clear();
 }
 
-ShapeCache::CacheEntry* ShapeCache::Find(const char* filename) {
-    for (auto& pair : cache_) {
-        if (pair.first == filename) {
-            return &pair.second;
+static bool Shape_Name_Equal(const std::string& a, const char* b) {
+    size_t i = 0;
+    for (; i < a.size() && b[i]; i++) {
+        if (toupper(static_cast<unsigned char>(a[i])) !=
+            toupper(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return i == a.size() && b[i] == '\0';
+}
+
+ShapeCache::CacheEntry* ShapeCache::Find(uint32_t key, const char* filename) {
+    auto range = cache_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (Shape_Name_Equal(it->second.name, filename)) {
+            return &it->second;
         }
     }
     return nullptr;
 }
 
+ShapeCache::CacheEntry* ShapeCache::Find(const char* filename) {
+    if (!filename || !filename[0]) {
+        return nullptr;
+    }
+    return Find(Platform_Westwood_CRC_Filename(filename), filename);
+}
+
 ShapeRenderer* ShapeCache::Get(const char* filename) {
     if (!filename || !filename[0]) {
         return nullptr;
     }
 
     // Check cache
-    CacheEntry* entry = Find(filename);
+    uint32_t key = Platform_Westwood_CRC_Filename(filename);
+    CacheEntry* entry = Find(key, filename);
     if (entry) {
         entry->access_count++;
+        entry->last_access = ++access_clock_;
         return entry->renderer.get();
     }
 
@@ -613,25 +1200,157 @@ ShapeRenderer* ShapeCache::Get(const char* filename) {
         return nullptr;
     }
 
-    // Add to cache
+    // A first-use hitch worth prefetching next time
+    AssetManifest::Record_Shape(filename);
+
+    return Insert(key, filename, std::move(renderer));
+}
+
+ShapeRenderer* ShapeCache::Insert(uint32_t key, const char* filename,
+                                  std::unique_ptr<ShapeRenderer> renderer) {
     CacheEntry new_entry;
+    new_entry.name = filename;
     new_entry.renderer = std::move(renderer);
     new_entry.access_count = 1;
+    new_entry.last_access = ++access_clock_;
+    new_entry.pinned = false;
+    new_entry.id = FindHandle(key, filename);
+
+    auto it = cache_.emplace(key, std::move(new_entry));
+    if (it->second.id != SHAPE_ID_NONE) {
+        handles_[it->second.id].entry = &it->second;
+    }
+    EnforceBudget(&it->second);
+
+    return it->second.renderer.get();
+}
+
+ShapeRenderer* ShapeCache::Get(ShapeId id) {
+    if (id < 0 || id >= static_cast<ShapeId>(handles_.size())) {
+        return nullptr;
+    }
+
+    HandleSlot& slot = handles_[id];
+    if (slot.entry) {
+        slot.entry->access_count++;
+        slot.entry->last_access = ++access_clock_;
+        return slot.entry->renderer.get();
+    }
+
+    // Not resident (never loaded, evicted, or cleared) - load by name
+    return Get(slot.name.c_str());
+}
+
+ShapeId ShapeCache::Register(const char* filename) {
+    if (!filename || !filename[0]) {
+        return SHAPE_ID_NONE;
+    }
+
+    uint32_t key = Platform_Westwood_CRC_Filename(filename);
+    ShapeId id = FindHandle(key, filename);
+    if (id != SHAPE_ID_NONE) {
+        return id;
+    }
+
+    id = static_cast<ShapeId>(handles_.size());
+    HandleSlot slot;
+    slot.name = filename;
+    slot.key = key;
+    slot.entry = Find(key, filename);
+    if (slot.entry) {
+        slot.entry->id = id;
+    }
+    handles_.push_back(std::move(slot));
+    return id;
+}
+
+const char* ShapeCache::Get_Name(ShapeId id) const {
+    if (id < 0 || id >= static_cast<ShapeId>(handles_.size())) {
+        return "";
+    }
+    return handles_[id].name.c_str();
+}
+
+ShapeId ShapeCache::FindHandle(uint32_t key, const char* filename) const {
+    for (size_t i = 0; i < handles_.size(); i++) {
+        if (handles_[i].key == key && Shape_Name_Equal(handles_[i].name, filename)) {
+            return static_cast<ShapeId>(i);
+        }
+    }
+    return SHAPE_ID_NONE;
+}
 
-    ShapeRenderer* ptr = new_entry.renderer.get();
-    cache_.push_back({filename, std::move(new_entry)});
+void ShapeCache::Erase(std::unordered_multimap<uint32_t, CacheEntry>::iterator it) {
+    if (it->second.id != SHAPE_ID_NONE) {
+        handles_[it->second.id].entry = nullptr;
+    }
+    cache_.erase(it);
+}
 
-    return ptr;
+bool ShapeCache::Preload(const char* filename, bool pinned) {
+    STARTUP_PHASE("Shape Preload");
+    if (!Get(filename)) {
+        return false;
+    }
+    if (pinned) {
+        Pin(filename);
+    }
+    return true;
 }
 
-bool ShapeCache::Preload(const char* filename) {
-    return Get(filename) != nullptr;
+bool ShapeCache::PreloadAsync(const char* filename, AssetPriority priority, bool pinned) {
+    if (!filename || !filename[0] || Find(filename) || IsLoading(filename)) {
+        return false;
+    }
+
+    std::string name = filename;
+    loading_.push_back(name);
+
+    // The worker only touches its own renderer
+    auto renderer = std::make_shared<ShapeRenderer>();
+    AssetLoader::Instance().Submit(priority,
+        [renderer, name]() { renderer->Load(name.c_str()); },
+        [this, renderer, name, pinned]() {
+            auto it = std::find_if(loading_.begin(), loading_.end(),
+                                   [&](const std::string& n) { return Shape_Name_Equal(n, name.c_str()); });
+            if (it != loading_.end()) {
+                loading_.erase(it);
+            }
+
+            if (!renderer->IsLoaded() || Find(name.c_str())) {
+                return;
+            }
+            uint32_t key = Platform_Westwood_CRC_Filename(name.c_str());
+            Insert(key, name.c_str(), std::make_unique<ShapeRenderer>(std::move(*renderer)));
+            if (pinned) {
+                Pin(name.c_str());
+            }
+        });
+    return true;
+}
+
+bool ShapeCache::IsLoading(const char* filename) const {
+    if (!filename) {
+        return false;
+    }
+    for (const std::string& name : loading_) {
+        if (Shape_Name_Equal(name, filename)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void ShapeCache::Remove(const char* filename) {
-    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
-        if (it->first == filename) {
-            cache_.erase(it);
+    if (!filename || !filename[0]) {
+        return;
+    }
+
+    uint32_t key = Platform_Westwood_CRC_Filename(filename);
+    auto range = cache_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (Shape_Name_Equal(it->second.name, filename)) {
+            Erase(it);
             return;
         }
     }
@@ -639,6 +1358,94 @@ void ShapeCache::Remove(const char* filename) {
 
 void ShapeCache::Clear() {
     cache_.clear();
+    for (auto& slot : handles_) {
+        slot.entry = nullptr;
+    }
+}
+
+bool ShapeCache::Pin(const char* filename) {
+    CacheEntry* entry = Find(filename);
+    if (!entry) {
+        return false;
+    }
+    entry->pinned = true;
+    return true;
+}
+
+bool ShapeCache::Unpin(const char* filename) {
+    CacheEntry* entry = Find(filename);
+    if (!entry) {
+        return false;
+    }
+    entry->pinned = false;
+    return true;
+}
+
+bool ShapeCache::IsPinned(const char* filename) {
+    CacheEntry* entry = Find(filename);
+    return entry && entry->pinned;
+}
+
+void ShapeCache::SetMemoryBudget(size_t bytes) {
+    memory_budget_ = bytes;
+    EnforceBudget(nullptr);
+}
+
+void ShapeCache::Trim() {
+    EnforceBudget(nullptr);
+}
+
+size_t ShapeCache::Release(size_t bytes) {
+    if (eviction_holds_ > 0) {
+        return 0;
+    }
+    size_t usage = GetMemoryUsage();
+    return EvictTo(usage > bytes ? usage - bytes : 0, nullptr);
+}
+
+void ShapeCache::ReleaseEviction() {
+    if (eviction_holds_ > 0 && --eviction_holds_ == 0) {
+        EnforceBudget(nullptr);
+    }
+}
+
+void ShapeCache::EnforceBudget(const CacheEntry* keep) {
+    if (memory_budget_ == 0 || eviction_holds_ > 0) {
+        return;
+    }
+    EvictTo(memory_budget_, keep);
+}
+
+size_t ShapeCache::EvictTo(size_t limit, const CacheEntry* keep) {
+    size_t usage = GetMemoryUsage();
+    size_t freed = 0;
+    while (usage > limit) {
+        // Least recently used first; fewer total accesses breaks ties
+        auto victim = cache_.end();
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            const CacheEntry& e = it->second;
+            if (e.pinned || &e == keep) {
+                continue;
+            }
+            if (victim == cache_.end() ||
+                e.last_access < victim->second.last_access ||
+                (e.last_access == victim->second.last_access &&
+                 e.access_count < victim->second.access_count)) {
+                victim = it;
+            }
+        }
+
+        if (victim == cache_.end()) {
+            break;  // Everything left is pinned or in use
+        }
+
+        size_t size = victim->second.renderer->GetCacheSize();
+        usage -= size;
+        freed += size;
+        Erase(victim);
+        eviction_count_++;
+    }
+    return freed;
 }
 
 int ShapeCache::GetCount() const {
@@ -0,0 +1,139 @@
+/**
+ * Shroud Edges Implementation
+ *
+ * Shapes are distance bands from each covered side or corner: the inner
+ * half of the band is fully covered, the outer half is dithered. Fog
+ * uses the same bands with a lighter pattern, and its covered part is
+ * the same dither as a fogged cell so the two join without a seam.
+ */
+
+#include "game/graphics/shroud_edges.h"
+#include "game/coord.h"
+#include "game/graphics/tile_renderer.h"
+#include <cmath>
+
+// =============================================================================
+// Frame Tables
+// =============================================================================
+
+namespace {
+
+constexpr int EDGE_BAND = 8;            // Pixels an edge reaches into the cell
+constexpr uint8_t SIDE_BITS = (1 << FACING_N) | (1 << FACING_E) |
+                              (1 << FACING_S) | (1 << FACING_W);
+
+struct EdgeTables {
+    uint8_t frame[256];                                 // Mask -> frame
+    uint8_t shroud[SHROUD_EDGE_FRAMES][TILE_SIZE];
+    uint8_t fog[SHROUD_EDGE_FRAMES][TILE_SIZE];
+    uint8_t fog_fill[TILE_SIZE];
+
+    EdgeTables();
+};
+
+bool Has(uint8_t mask, FacingType facing) {
+    return (mask >> facing) & 1;
+}
+
+// Distance from pixel centre to the nearest covered side or corner
+float Edge_Distance(uint8_t reduced, int px, int py) {
+    float cx = px + 0.5f;
+    float cy = py + 0.5f;
+    float far = static_cast<float>(TILE_WIDTH);
+    float d = far;
+
+    if (Has(reduced, FACING_N)) d = std::fmin(d, cy);
+    if (Has(reduced, FACING_S)) d = std::fmin(d, far - cy);
+    if (Has(reduced, FACING_W)) d = std::fmin(d, cx);
+    if (Has(reduced, FACING_E)) d = std::fmin(d, far - cx);
+
+    if (Has(reduced, FACING_NE)) d = std::fmin(d, std::hypot(far - cx, cy));
+    if (Has(reduced, FACING_SE)) d = std::fmin(d, std::hypot(far - cx, far - cy));
+    if (Has(reduced, FACING_SW)) d = std::fmin(d, std::hypot(cx, far - cy));
+    if (Has(reduced, FACING_NW)) d = std::fmin(d, std::hypot(cx, cy));
+    return d;
+}
+
+EdgeTables::EdgeTables() {
+    uint8_t frame_mask[SHROUD_EDGE_FRAMES] = {};
+    int frames = 0;
+
+    for (int mask = 0; mask < 256; mask++) {
+        uint8_t reduced = Shroud_Edge_Reduce(static_cast<uint8_t>(mask));
+        int f = 0;
+        while (f < frames && frame_mask[f] != reduced) {
+            f++;
+        }
+        if (f == frames && frames < SHROUD_EDGE_FRAMES) {
+            frame_mask[frames++] = reduced;
+        }
+        frame[mask] = static_cast<uint8_t>(f < SHROUD_EDGE_FRAMES ? f : 0);
+    }
+
+    for (int py = 0; py < TILE_HEIGHT; py++) {
+        for (int px = 0; px < TILE_WIDTH; px++) {
+            int i = py * TILE_WIDTH + px;
+            bool checker = ((px + py) & 1) != 0;
+            bool sparse = (px & 1) && (py & 1);
+            fog_fill[i] = checker ? 0x00 : 0xFF;
+
+            for (int f = 0; f < SHROUD_EDGE_FRAMES; f++) {
+                float d = Edge_Distance(frame_mask[f], px, py);
+                if (d < EDGE_BAND / 2) {
+                    shroud[f][i] = 0x00;
+                    fog[f][i] = fog_fill[i];
+                } else if (d < EDGE_BAND) {
+                    shroud[f][i] = checker ? 0x00 : 0xFF;
+                    fog[f][i] = sparse ? 0x00 : 0xFF;
+                } else {
+                    shroud[f][i] = 0xFF;
+                    fog[f][i] = 0xFF;
+                }
+            }
+        }
+    }
+}
+
+const EdgeTables& Tables() {
+    static const EdgeTables tables;
+    return tables;
+}
+
+} // namespace
+
+// =============================================================================
+// Public Interface
+// =============================================================================
+
+uint8_t Shroud_Edge_Reduce(uint8_t mask) {
+    uint8_t reduced = mask & SIDE_BITS;
+
+    auto corner = [&](FacingType c, FacingType a, FacingType b) {
+        if (Has(mask, c) && !Has(mask, a) && !Has(mask, b)) {
+            reduced |= static_cast<uint8_t>(1 << c);
+        }
+    };
+    corner(FACING_NE, FACING_N, FACING_E);
+    corner(FACING_SE, FACING_S, FACING_E);
+    corner(FACING_SW, FACING_S, FACING_W);
+    corner(FACING_NW, FACING_N, FACING_W);
+    return reduced;
+}
+
+int Shroud_Edge_Frame(uint8_t mask) {
+    return Tables().frame[mask];
+}
+
+const uint8_t* Shroud_Edge_Shape(int frame) {
+    if (frame < 0 || frame >= SHROUD_EDGE_FRAMES) return nullptr;
+    return Tables().shroud[frame];
+}
+
+const uint8_t* Fog_Edge_Shape(int frame) {
+    if (frame < 0 || frame >= SHROUD_EDGE_FRAMES) return nullptr;
+    return Tables().fog[frame];
+}
+
+const uint8_t* Fog_Fill_Shape() {
+    return Tables().fog_fill;
+}
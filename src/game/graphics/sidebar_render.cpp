@@ -3,8 +3,13 @@
  */
 
 #include "game/graphics/sidebar_render.h"
+#include "game/graphics/blit_batch.h"
 #include "game/graphics/shape_renderer.h"
+#include "game/graphics/text_cache.h"
+#include "game/economy.h"
 #include "platform.h"
+#include <algorithm>
+#include <cstdio>
 
 // =============================================================================
 // Construction
@@ -17,9 +22,14 @@ SidebarRenderer::SidebarRenderer()
     , sidebar_height_(400)
     , active_tab_(SidebarTab::STRUCTURE)
     , scroll_position_(0)
+    , credits_(0)
+    , power_output_(0)
+    , power_drain_(0)
     , repair_state_(ButtonState::NORMAL)
     , sell_state_(ButtonState::NORMAL)
     , map_state_(ButtonState::NORMAL)
+    , panel_dirty_(true)
+    , panel_redraws_(0)
 {
 }
 
@@ -42,6 +52,7 @@ bool SidebarRenderer::Initialize(int screen_height) {
         build_items_[i].clear();
     }
 
+    panel_dirty_ = true;
     initialized_ = true;
     return true;
 }
@@ -63,12 +74,15 @@ bool SidebarRenderer::LoadGraphics(const char* icons_filename, const char* butto
         }
     }
 
+    panel_dirty_ = true;
     return true;
 }
 
 void SidebarRenderer::Shutdown() {
     icons_.reset();
     buttons_.reset();
+    panel_.reset();
+    panel_dirty_ = true;
 
     for (int i = 0; i < static_cast<int>(SidebarTab::COUNT); i++) {
         build_items_[i].clear();
@@ -83,6 +97,9 @@ void SidebarRenderer::Shutdown() {
 
 void SidebarRenderer::SetActiveTab(SidebarTab tab) {
     if (tab >= SidebarTab::STRUCTURE && tab < SidebarTab::COUNT) {
+        if (tab != active_tab_) {
+            panel_dirty_ = true;
+        }
         active_tab_ = tab;
         scroll_position_ = 0;  // Reset scroll when changing tabs
     }
@@ -90,7 +107,11 @@ void SidebarRenderer::SetActiveTab(SidebarTab tab) {
 
 void SidebarRenderer::SetScrollPosition(int position) {
     int max_scroll = GetMaxScrollPosition();
-    scroll_position_ = (position < 0) ? 0 : (position > max_scroll) ? max_scroll : position;
+    int clamped = (position < 0) ? 0 : (position > max_scroll) ? max_scroll : position;
+    if (clamped != scroll_position_) {
+        scroll_position_ = clamped;
+        panel_dirty_ = true;
+    }
 }
 
 int SidebarRenderer::GetMaxScrollPosition() const {
@@ -104,12 +125,14 @@ int SidebarRenderer::GetMaxScrollPosition() const {
 void SidebarRenderer::ScrollUp() {
     if (scroll_position_ > 0) {
         scroll_position_--;
+        panel_dirty_ = true;
     }
 }
 
 void SidebarRenderer::ScrollDown() {
     if (scroll_position_ < GetMaxScrollPosition()) {
         scroll_position_++;
+        panel_dirty_ = true;
     }
 }
 
@@ -117,9 +140,18 @@ void SidebarRenderer::ScrollDown() {
 // Build Queue
 // =============================================================================
 
+// Width of the progress fill as drawn by DrawBuildIcon (-1 = no bar)
+static int Progress_Pixels(float progress) {
+    if (!(progress > 0.0f && progress < 1.0f)) {
+        return -1;
+    }
+    return static_cast<int>(static_cast<float>(ICON_WIDTH - 4 - 2) * progress);
+}
+
 void SidebarRenderer::ClearBuildItems() {
     build_items_[static_cast<int>(active_tab_)].clear();
     scroll_position_ = 0;
+    panel_dirty_ = true;
 }
 
 void SidebarRenderer::AddBuildItem(int type_id, int icon_frame) {
@@ -131,28 +163,92 @@ void SidebarRenderer::AddBuildItem(int type_id, int icon_frame) {
     item.queue_count = 0;
 
     build_items_[static_cast<int>(active_tab_)].push_back(item);
+    panel_dirty_ = true;
 }
 
 void SidebarRenderer::SetBuildProgress(int type_id, float progress) {
     auto& items = build_items_[static_cast<int>(active_tab_)];
     for (auto& item : items) {
         if (item.type_id == type_id) {
+            // Most ticks don't move the bar by a whole pixel
+            if (Progress_Pixels(item.progress) != Progress_Pixels(progress)) {
+                panel_dirty_ = true;
+            }
             item.progress = progress;
             break;
         }
     }
 }
 
+void SidebarRenderer::SetItemState(BuildQueueItem& item, float progress, bool on_hold) {
+    if (Progress_Pixels(item.progress) != Progress_Pixels(progress) || item.on_hold != on_hold) {
+        panel_dirty_ = true;
+    }
+    item.progress = progress;
+    item.on_hold = on_hold;
+}
+
 void SidebarRenderer::SetBuildOnHold(int type_id, bool on_hold) {
     auto& items = build_items_[static_cast<int>(active_tab_)];
     for (auto& item : items) {
         if (item.type_id == type_id) {
+            if (item.on_hold != on_hold) {
+                panel_dirty_ = true;
+            }
             item.on_hold = on_hold;
             break;
         }
     }
 }
 
+// =============================================================================
+// Economy
+// =============================================================================
+
+void SidebarRenderer::SetCredits(int credits) {
+    if (credits != credits_) {
+        credits_ = credits;
+        panel_dirty_ = true;
+    }
+}
+
+void SidebarRenderer::SetPower(int output, int drain) {
+    if (output != power_output_ || drain != power_drain_) {
+        power_output_ = output;
+        power_drain_ = drain;
+        panel_dirty_ = true;
+    }
+}
+
+void SidebarRenderer::ApplyEconomy(const HouseEconomy& economy, uint32_t events) {
+    if (events & ECON_CREDITS) {
+        SetCredits(economy.Available_Money());
+    }
+    if (events & ECON_POWER) {
+        SetPower(economy.Power_Output(), economy.Power_Drain());
+    }
+    if (!(events & ECON_FACTORY)) {
+        return;
+    }
+
+    for (int tab = 0; tab < static_cast<int>(SidebarTab::COUNT); tab++) {
+        for (BuildQueueItem& item : build_items_[tab]) {
+            float progress = 0.0f;
+            bool on_hold = false;
+            for (int kind = 0; kind < FACTORY_KIND_COUNT; kind++) {
+                bool on_tab = (kind == FACTORY_BUILDING) == (tab == static_cast<int>(SidebarTab::STRUCTURE));
+                const FactoryState& factory = economy.Factory(static_cast<FactoryKind>(kind));
+                if (on_tab && factory.Is_Busy() && factory.type_id == item.type_id) {
+                    progress = factory.Progress();
+                    on_hold = factory.on_hold;
+                    break;
+                }
+            }
+            SetItemState(item, progress, on_hold);
+        }
+    }
+}
+
 // =============================================================================
 // Rendering
 // =============================================================================
@@ -160,22 +256,61 @@ void SidebarRenderer::SetBuildOnHold(int type_id, bool on_hold) {
 void SidebarRenderer::Draw(GraphicsBuffer& buffer) {
     if (!initialized_) return;
 
+    if (panel_dirty_) {
+        RenderPanel();
+    }
+
+    if (panel_ && panel_->Lock()) {
+        buffer.Blit_From(*panel_, 0, 0, sidebar_x_, sidebar_y_);
+        panel_->Unlock();
+    } else {
+        DrawContents(buffer);
+    }
+}
+
+void SidebarRenderer::RenderPanel() {
+    if (!panel_ || panel_->Get_Height() != sidebar_height_) {
+        panel_ = std::make_unique<GraphicsBuffer>(SIDEBAR_WIDTH, sidebar_height_);
+    }
+    if (!panel_->Lock()) {
+        return;
+    }
+
+    // Layout is in screen coordinates; draw with the sidebar at the origin
+    int saved_x = sidebar_x_;
+    int saved_y = sidebar_y_;
+    sidebar_x_ = 0;
+    sidebar_y_ = 0;
+    DrawContents(*panel_);
+    sidebar_x_ = saved_x;
+    sidebar_y_ = saved_y;
+
+    panel_->Unlock();
+    panel_dirty_ = false;
+    panel_redraws_++;
+}
+
+void SidebarRenderer::DrawContents(GraphicsBuffer& buffer) {
     DrawBackground(buffer);
     DrawTabs(buffer);
     DrawBuildIcons(buffer);
     DrawScrollArrows(buffer);
+    DrawEconomy(buffer);
     DrawButtons(buffer);
 }
 
 void SidebarRenderer::DrawBackground(GraphicsBuffer& buffer) {
+    BlitBatch batch(buffer);
+
     // Fill sidebar background with dark gray
-    buffer.Fill_Rect(sidebar_x_, sidebar_y_, SIDEBAR_WIDTH, sidebar_height_, 14);
+    batch.Fill_Rect(sidebar_x_, sidebar_y_, SIDEBAR_WIDTH, sidebar_height_, 14);
 
     // Draw border line on left edge
-    buffer.Draw_VLine(sidebar_x_, sidebar_y_, sidebar_height_, 0);
+    batch.Draw_VLine(sidebar_x_, sidebar_y_, sidebar_height_, 0);
 }
 
 void SidebarRenderer::DrawTabs(GraphicsBuffer& buffer) {
+    BlitBatch batch(buffer);
     int tab_y = sidebar_y_;
 
     for (int i = 0; i < static_cast<int>(SidebarTab::COUNT); i++) {
@@ -184,17 +319,14 @@ void SidebarRenderer::DrawTabs(GraphicsBuffer& buffer) {
 
         // Draw tab background
         uint8_t bg_color = active ? static_cast<uint8_t>(15) : static_cast<uint8_t>(13);
-        buffer.Fill_Rect(tab_x, tab_y, TAB_WIDTH, TAB_HEIGHT, bg_color);
+        batch.Fill_Rect(tab_x, tab_y, TAB_WIDTH, TAB_HEIGHT, bg_color);
 
         // Draw tab border
-        buffer.Draw_HLine(tab_x, tab_y, TAB_WIDTH, 0);
-        buffer.Draw_HLine(tab_x, tab_y + TAB_HEIGHT - 1, TAB_WIDTH, 0);
-        buffer.Draw_VLine(tab_x, tab_y, TAB_HEIGHT, 0);
-        buffer.Draw_VLine(tab_x + TAB_WIDTH - 1, tab_y, TAB_HEIGHT, 0);
+        batch.Draw_Rect(tab_x, tab_y, TAB_WIDTH, TAB_HEIGHT, 0);
 
         // Active tab highlight
         if (active) {
-            buffer.Draw_HLine(tab_x + 1, tab_y + 1, TAB_WIDTH - 2, 253);
+            batch.Draw_HLine(tab_x + 1, tab_y + 1, TAB_WIDTH - 2, 253);
         }
     }
 }
@@ -207,59 +339,81 @@ void SidebarRenderer::DrawBuildIcons(GraphicsBuffer& buffer) {
     int icon_area_y = start_y;
 
     int visible_start = scroll_position_ * ICON_COLUMNS;
-    int visible_end = visible_start + (ICONS_PER_COLUMN * ICON_COLUMNS);
+    int visible_end = std::min(visible_start + (ICONS_PER_COLUMN * ICON_COLUMNS),
+                               static_cast<int>(items.size()));
 
-    for (int i = visible_start; i < visible_end && i < static_cast<int>(items.size()); i++) {
-        int local_index = i - visible_start;
-        int row = local_index / ICON_COLUMNS;
-        int col = local_index % ICON_COLUMNS;
+    auto for_each_icon = [&](auto fn) {
+        for (int i = visible_start; i < visible_end; i++) {
+            int local_index = i - visible_start;
+            int row = local_index / ICON_COLUMNS;
+            int col = local_index % ICON_COLUMNS;
 
-        int icon_x = icon_area_x + col * (ICON_WIDTH + 4);
-        int icon_y = icon_area_y + row * (ICON_HEIGHT + 4);
+            int icon_x = icon_area_x + col * (ICON_WIDTH + 4);
+            int icon_y = icon_area_y + row * (ICON_HEIGHT + 4);
 
-        DrawBuildIcon(buffer, icon_x, icon_y, items[static_cast<size_t>(i)]);
+            fn(icon_x, icon_y, items[static_cast<size_t>(i)]);
+        }
+    };
+
+    // Every icon's frame in one batch, the shapes over them, then every
+    // progress bar and hold mark in a second batch. Icons don't overlap,
+    // so each still draws frame, shape, status in that order.
+    BlitBatch batch(buffer);
+    for_each_icon([&](int x, int y, const BuildQueueItem&) {
+        DrawBuildIconFrame(batch, x, y);
+    });
+    batch.Flush();
+
+    if (icons_) {
+        for_each_icon([&](int x, int y, const BuildQueueItem& item) {
+            if (item.icon_frame >= 0) {
+                icons_->Draw(buffer, x + 2, y + 2, item.icon_frame);
+            }
+        });
     }
+
+    for_each_icon([&](int x, int y, const BuildQueueItem& item) {
+        DrawBuildIconStatus(batch, x, y, item);
+    });
 }
 
-void SidebarRenderer::DrawBuildIcon(GraphicsBuffer& buffer, int x, int y, const BuildQueueItem& item) {
+void SidebarRenderer::DrawBuildIconFrame(BlitBatch& batch, int x, int y) {
     // Draw icon background
-    buffer.Fill_Rect(x, y, ICON_WIDTH, ICON_HEIGHT, 12);
+    batch.Fill_Rect(x, y, ICON_WIDTH, ICON_HEIGHT, 12);
 
     // Draw icon border
-    buffer.Draw_HLine(x, y, ICON_WIDTH, 253);
-    buffer.Draw_HLine(x, y + ICON_HEIGHT - 1, ICON_WIDTH, 0);
-    buffer.Draw_VLine(x, y, ICON_HEIGHT, 253);
-    buffer.Draw_VLine(x + ICON_WIDTH - 1, y, ICON_HEIGHT, 0);
-
-    // Draw icon shape if loaded
-    if (icons_ && item.icon_frame >= 0) {
-        icons_->Draw(buffer, x + 2, y + 2, item.icon_frame);
-    }
+    batch.Draw_HLine(x, y, ICON_WIDTH, 253);
+    batch.Draw_HLine(x, y + ICON_HEIGHT - 1, ICON_WIDTH, 0);
+    batch.Draw_VLine(x, y, ICON_HEIGHT, 253);
+    batch.Draw_VLine(x + ICON_WIDTH - 1, y, ICON_HEIGHT, 0);
+}
 
+void SidebarRenderer::DrawBuildIconStatus(BlitBatch& batch, int x, int y, const BuildQueueItem& item) {
     // Draw progress bar if building
     if (item.progress > 0.0f && item.progress < 1.0f) {
-        DrawProgressBar(buffer, x + 2, y + ICON_HEIGHT - 6, ICON_WIDTH - 4, item.progress);
+        DrawProgressBar(batch, x + 2, y + ICON_HEIGHT - 6, ICON_WIDTH - 4, item.progress);
     }
 
     // Draw "on hold" indicator
     if (item.on_hold) {
         // Simple cross pattern
-        buffer.Draw_HLine(x + 8, y + ICON_HEIGHT / 2, ICON_WIDTH - 16, 252);
+        batch.Draw_HLine(x + 8, y + ICON_HEIGHT / 2, ICON_WIDTH - 16, 252);
     }
 }
 
-void SidebarRenderer::DrawProgressBar(GraphicsBuffer& buffer, int x, int y, int width, float progress) {
+void SidebarRenderer::DrawProgressBar(BlitBatch& batch, int x, int y, int width, float progress) {
     // Background
-    buffer.Fill_Rect(x, y, width, 4, 0);
+    batch.Fill_Rect(x, y, width, 4, 0);
 
     // Progress fill
     int fill_width = static_cast<int>(static_cast<float>(width - 2) * progress);
     if (fill_width > 0) {
-        buffer.Fill_Rect(x + 1, y + 1, fill_width, 2, 250);  // Green
+        batch.Fill_Rect(x + 1, y + 1, fill_width, 2, 250);  // Green
     }
 }
 
 void SidebarRenderer::DrawScrollArrows(GraphicsBuffer& buffer) {
+    BlitBatch batch(buffer);
     int arrow_x = sidebar_x_ + SIDEBAR_WIDTH - 20;
     int up_y = sidebar_y_ + TAB_HEIGHT + 4;
     int down_y = sidebar_y_ + TAB_HEIGHT + 4 + (ICONS_PER_COLUMN * (ICON_HEIGHT + 4)) + 4;
@@ -267,22 +421,49 @@ void SidebarRenderer::DrawScrollArrows(GraphicsBuffer& buffer) {
     // Up arrow
     bool can_scroll_up = (scroll_position_ > 0);
     uint8_t up_color = can_scroll_up ? static_cast<uint8_t>(253) : static_cast<uint8_t>(8);
-    buffer.Fill_Rect(arrow_x, up_y, 16, 12, 14);
+    batch.Fill_Rect(arrow_x, up_y, 16, 12, 14);
     // Simple triangle pointing up
     for (int i = 0; i < 5; i++) {
-        buffer.Draw_HLine(arrow_x + 8 - i, up_y + 2 + i, 1 + i * 2, up_color);
+        batch.Draw_HLine(arrow_x + 8 - i, up_y + 2 + i, 1 + i * 2, up_color);
     }
 
     // Down arrow
     bool can_scroll_down = (scroll_position_ < GetMaxScrollPosition());
     uint8_t down_color = can_scroll_down ? static_cast<uint8_t>(253) : static_cast<uint8_t>(8);
-    buffer.Fill_Rect(arrow_x, down_y, 16, 12, 14);
+    batch.Fill_Rect(arrow_x, down_y, 16, 12, 14);
     // Simple triangle pointing down
     for (int i = 0; i < 5; i++) {
-        buffer.Draw_HLine(arrow_x + 4 + i, down_y + 2 + i, 9 - i * 2, down_color);
+        batch.Draw_HLine(arrow_x + 4 + i, down_y + 2 + i, 9 - i * 2, down_color);
     }
 }
 
+void SidebarRenderer::DrawEconomy(GraphicsBuffer& buffer) {
+    // Power bar: filled to output, with a notch at drain; red when drain
+    // exceeds output
+    {
+        BlitBatch batch(buffer);
+        int bar_x = sidebar_x_ + POWER_BAR_X;
+        int bar_top = sidebar_y_ + TAB_HEIGHT + 4;
+        int bar_height = REPAIR_BUTTON_Y - 4 - bar_top;
+        batch.Fill_Rect(bar_x, bar_top, POWER_BAR_WIDTH, bar_height, 0);
+
+        int scale = std::max(std::max(power_output_, power_drain_), 1);
+        int fill = bar_height * power_output_ / scale;
+        uint8_t fill_color = power_drain_ > power_output_ ? static_cast<uint8_t>(252) : static_cast<uint8_t>(250);
+        if (fill > 0) {
+            batch.Fill_Rect(bar_x, bar_top + bar_height - fill, POWER_BAR_WIDTH, fill, fill_color);
+        }
+        if (power_drain_ > 0) {
+            int notch = bar_top + bar_height - bar_height * power_drain_ / scale;
+            batch.Draw_HLine(bar_x, std::max(notch, bar_top), POWER_BAR_WIDTH, 15);
+        }
+    }
+
+    char credits[16];
+    snprintf(credits, sizeof(credits), "%d", credits_);
+    TextCache::Instance().Draw(buffer, credits, sidebar_x_ + 8, sidebar_y_ + CREDITS_Y, TEXT_FONT_MENU, 15);
+}
+
 void SidebarRenderer::DrawButtons(GraphicsBuffer& buffer) {
     int button_x = sidebar_x_ + 8;
     int button_width = 48;
@@ -0,0 +1,278 @@
+/**
+ * Text Cache Implementation
+ *
+ * Glyphs are stored as 7 rows of 5 bits (bit 4 = leftmost pixel) and
+ * decoded once into runs. A string's layout is its glyph runs shifted
+ * by the pen position, so a miss costs one pass over the characters.
+ */
+
+#include "game/graphics/text_cache.h"
+#include "game/graphics/graphics_buffer.h"
+#include <cstring>
+
+// =============================================================================
+// Menu Font
+// =============================================================================
+
+namespace {
+
+constexpr int MENU_GLYPH_WIDTH = 5;
+constexpr int MENU_GLYPH_HEIGHT = 7;
+constexpr int MENU_GLYPH_ADVANCE = 6;       // 5 pixels + 1 spacing
+constexpr int MENU_FIRST_CHAR = ' ';
+constexpr int GLYPH_MAX_SPANS = MENU_GLYPH_HEIGHT * 3;
+
+// Glyphs from ASCII 32 (space) to 90 (Z); unused symbols are blank
+const uint8_t FONT_DATA[][7] = {
+    // Space (32)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // ! (33)
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},
+    // " (34) - skip for now
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // # - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // $ - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // % - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // & (38)
+    {0x08, 0x14, 0x14, 0x08, 0x15, 0x12, 0x0D},
+    // ' - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // ( - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // ) - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // * - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // + - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // , - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // - (45)
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},
+    // . (46)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04},
+    // / - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // 0-9 (48-57)
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+    // : - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // ; - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // < - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // = - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // > - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // ? - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // @ - skip
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    // A-Z (65-90)
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // A
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+    {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+};
+
+constexpr int MENU_GLYPH_COUNT = sizeof(FONT_DATA) / sizeof(FONT_DATA[0]);
+
+struct GlyphSpans {
+    uint8_t count;
+    TextSpan spans[GLYPH_MAX_SPANS];
+};
+
+struct GlyphTable {
+    int8_t index[256];                      // Character -> glyph, -1 = none
+    GlyphSpans glyphs[MENU_GLYPH_COUNT];
+
+    GlyphTable();
+};
+
+GlyphTable::GlyphTable() {
+    memset(index, -1, sizeof(index));
+    for (int i = 0; i < MENU_GLYPH_COUNT; i++) {
+        index[MENU_FIRST_CHAR + i] = static_cast<int8_t>(i);
+    }
+    // Lowercase draws as uppercase
+    for (int c = 'a'; c <= 'z'; c++) {
+        index[c] = index[c - 'a' + 'A'];
+    }
+
+    for (int g = 0; g < MENU_GLYPH_COUNT; g++) {
+        GlyphSpans& glyph = glyphs[g];
+        glyph.count = 0;
+        for (int row = 0; row < MENU_GLYPH_HEIGHT; row++) {
+            uint8_t bits = FONT_DATA[g][row];
+            int col = 0;
+            while (col < MENU_GLYPH_WIDTH) {
+                if (!(bits & (0x10 >> col))) {
+                    col++;
+                    continue;
+                }
+                int start = col;
+                while (col < MENU_GLYPH_WIDTH && (bits & (0x10 >> col))) {
+                    col++;
+                }
+                TextSpan& span = glyph.spans[glyph.count++];
+                span.x = static_cast<int16_t>(start);
+                span.y = static_cast<uint8_t>(row);
+                span.length = static_cast<uint8_t>(col - start);
+            }
+        }
+    }
+}
+
+const GlyphTable& Menu_Glyphs() {
+    static const GlyphTable table;
+    return table;
+}
+
+} // namespace
+
+// =============================================================================
+// TextCache
+// =============================================================================
+
+TextCache::TextCache(size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1) {
+    entries_.reserve(capacity_);
+}
+
+TextCache& TextCache::Instance() {
+    static TextCache cache;
+    return cache;
+}
+
+int TextCache::Text_Width(const char* text, TextFontType font) {
+    if (!text || font != TEXT_FONT_MENU) return 0;
+    size_t length = strlen(text);
+    if (length == 0) return 0;
+    return static_cast<int>(length) * MENU_GLYPH_ADVANCE - 1;
+}
+
+int TextCache::Text_Height(TextFontType font) {
+    return font == TEXT_FONT_MENU ? MENU_GLYPH_HEIGHT : 0;
+}
+
+uint32_t TextCache::Hash(const char* text, TextFontType font, uint8_t color) {
+    // FNV-1a over the text, then font and colour
+    uint32_t hash = 2166136261u;
+    for (const char* p = text; *p; p++) {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 16777619u;
+    }
+    hash = (hash ^ font) * 16777619u;
+    hash = (hash ^ color) * 16777619u;
+    return hash;
+}
+
+void TextCache::Build_Layout(const char* text, TextFontType font, TextLayout& layout) {
+    const GlyphTable& table = Menu_Glyphs();
+
+    layout.spans.clear();
+    layout.width = Text_Width(text, font);
+    layout.height = Text_Height(font);
+
+    int pen = 0;
+    for (const char* p = text; *p; p++, pen += MENU_GLYPH_ADVANCE) {
+        int g = table.index[static_cast<uint8_t>(*p)];
+        if (g < 0) continue;
+
+        const GlyphSpans& glyph = table.glyphs[g];
+        for (int i = 0; i < glyph.count; i++) {
+            TextSpan span = glyph.spans[i];
+            span.x = static_cast<int16_t>(span.x + pen);
+            layout.spans.push_back(span);
+        }
+    }
+}
+
+const TextLayout* TextCache::Get_Layout(const char* text, TextFontType font, uint8_t color) {
+    if (!text || font >= TEXT_FONT_COUNT) return nullptr;
+
+    uint32_t hash = Hash(text, font, color);
+    clock_++;
+
+    for (Entry& entry : entries_) {
+        if (entry.hash == hash && entry.font == font && entry.color == color &&
+            entry.text == text) {
+            entry.last_used = clock_;
+            hits_++;
+            return &entry.layout;
+        }
+    }
+
+    misses_++;
+
+    // Reuse the least recently used slot once full (keeps its buffers)
+    Entry* slot;
+    if (entries_.size() < capacity_) {
+        entries_.emplace_back();
+        slot = &entries_.back();
+    } else {
+        slot = &entries_[0];
+        for (Entry& entry : entries_) {
+            if (entry.last_used < slot->last_used) {
+                slot = &entry;
+            }
+        }
+    }
+
+    slot->hash = hash;
+    slot->font = font;
+    slot->color = color;
+    slot->last_used = clock_;
+    slot->text.assign(text);
+    Build_Layout(text, font, slot->layout);
+    slot->layout.color = color;
+    return &slot->layout;
+}
+
+void TextCache::Draw(GraphicsBuffer& buffer, const char* text, int x, int y,
+                     TextFontType font, uint8_t color) {
+    const TextLayout* layout = Get_Layout(text, font, color);
+    if (!layout) return;
+
+    for (const TextSpan& span : layout->spans) {
+        buffer.Draw_HLine(x + span.x, y + span.y, span.length, color);
+    }
+}
+
+void TextCache::Clear() {
+    entries_.clear();
+}
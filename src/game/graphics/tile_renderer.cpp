@@ -4,9 +4,15 @@
 
 #include "game/graphics/tile_renderer.h"
 #include "game/graphics/graphics_buffer.h"
+#include "game/asset_pack.h"
+#include "game/mix_view.h"
+#include "game/shared_asset_cache.h"
 #include "platform.h"
+#include "platform/io_stats.h"
+#include <atomic>
 #include <cstring>
 #include <cstdlib>
+#include <thread>
 
 // =============================================================================
 // Theater Info
@@ -90,6 +96,210 @@ static const char* OVERLAY_FILENAMES[] = {
     "FENC",     // OVERLAY_WOOD_FENCE
 };
 
+// =============================================================================
+// Template Parsing
+// =============================================================================
+
+static std::string Template_Filename(TheaterType theater, TemplateType tmpl) {
+    if (tmpl < 0 || tmpl >= TEMPLATE_COUNT) {
+        return "";
+    }
+
+    std::string filename = TEMPLATE_FILENAMES[tmpl];
+    filename += Theater_Extension(theater);
+    return filename;
+}
+
+// Read and parse a template file (caller frees with Platform_Template_Free).
+// Only touches the MIX manager, which is safe to read from any thread.
+static PlatformTemplate* Open_Template(TheaterType theater, TemplateType tmpl) {
+    std::string filename = Template_Filename(theater, tmpl);
+    if (filename.empty()) {
+        return nullptr;
+    }
+
+    IoScope io(IoTag::GRAPHICS);
+    MixView view(filename.c_str());
+    if (!view) {
+        // Try with .TMP extension if theater-specific failed
+        filename = TEMPLATE_FILENAMES[tmpl];
+        filename += ".TMP";
+        if (!view.Open(filename.c_str())) {
+            return nullptr;
+        }
+    }
+
+    // Parse template straight from the archive
+    return Platform_Template_LoadFromMemory(view.Data(), view.Size(), TILE_WIDTH, TILE_HEIGHT);
+}
+
+// Land type of every tile, by template type (defaults to LAND_CLEAR)
+static void Assign_Land_Types(TemplateData& data) {
+    data.land.assign(data.tile_count, LAND_CLEAR);
+
+    // Set land types based on template type
+    switch (data.type) {
+        case TEMPLATE_WATER1:
+        case TEMPLATE_WATER2:
+            std::fill(data.land.begin(), data.land.end(), LAND_WATER);
+            break;
+        case TEMPLATE_SHORE1:
+        case TEMPLATE_SHORE2:
+        case TEMPLATE_SHORE3:
+        case TEMPLATE_SHORE4:
+        case TEMPLATE_SHORE5:
+        case TEMPLATE_SHORE6:
+        case TEMPLATE_SHORE7:
+        case TEMPLATE_SHORE8:
+            std::fill(data.land.begin(), data.land.end(), LAND_BEACH);
+            break;
+        case TEMPLATE_CLIFF1:
+        case TEMPLATE_CLIFF2:
+            std::fill(data.land.begin(), data.land.end(), LAND_ROCK);
+            break;
+        case TEMPLATE_ROAD1:
+        case TEMPLATE_ROAD2:
+        case TEMPLATE_ROAD3:
+            std::fill(data.land.begin(), data.land.end(), LAND_ROAD);
+            break;
+        case TEMPLATE_ROUGH1:
+        case TEMPLATE_ROUGH2:
+            std::fill(data.land.begin(), data.land.end(), LAND_ROUGH);
+            break;
+        default:
+            break;
+    }
+}
+
+// Fill in everything but the pixels, then copy tiles to dst
+static std::unique_ptr<TemplateData> Build_Template(PlatformTemplate* platform_tmpl,
+                                                    TemplateType tmpl, uint8_t* dst) {
+    auto data = std::make_unique<TemplateData>();
+    data->type = tmpl;
+    data->tile_count = Platform_Template_GetTileCount(platform_tmpl);
+    data->width = 1;
+    data->height = 1;
+    data->tiles = dst;
+
+    // Read all tiles
+    for (int i = 0; i < data->tile_count; i++) {
+        Platform_Template_GetTile(platform_tmpl,
+                                  i,
+                                  dst + i * TILE_SIZE,
+                                  TILE_SIZE);
+    }
+
+    Assign_Land_Types(*data);
+    return data;
+}
+
+// =============================================================================
+// Theater Loading
+// =============================================================================
+
+/**
+ * One theater's templates being decoded into a tile atlas
+ *
+ * The worker only writes atlas/templates and the atomics; the main
+ * thread reads the results after seeing finished, then joins.
+ */
+struct TheaterLoadJob {
+    TheaterType theater = THEATER_NONE;
+    std::thread thread;
+    std::atomic<int> steps_done{0};       // Of TOTAL_STEPS
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancel{false};
+
+    std::vector<uint8_t> atlas;
+    std::unordered_map<int, std::unique_ptr<TemplateData>> templates;
+
+    // Read/parse then copy out, once per template
+    static constexpr int TOTAL_STEPS = TEMPLATE_COUNT * 2;
+};
+
+static void Decode_Theater(TheaterLoadJob& job) {
+    PlatformTemplate* opened[TEMPLATE_COUNT] = {};
+    size_t offsets[TEMPLATE_COUNT] = {};
+    size_t total = 0;
+
+    // Pass 1: read and parse every template, sizing the atlas
+    for (int i = 0; i < TEMPLATE_COUNT && !job.cancel.load(std::memory_order_relaxed); i++) {
+        opened[i] = Open_Template(job.theater, static_cast<TemplateType>(i));
+        if (opened[i]) {
+            offsets[i] = total;
+            total += static_cast<size_t>(Platform_Template_GetTileCount(opened[i])) * TILE_SIZE;
+        }
+        job.steps_done.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Pass 2: copy tiles end to end into one allocation
+    if (!job.cancel.load(std::memory_order_relaxed)) {
+        job.atlas.resize(total);
+    }
+    for (int i = 0; i < TEMPLATE_COUNT; i++) {
+        if (!opened[i]) continue;
+        if (!job.cancel.load(std::memory_order_relaxed)) {
+            job.templates[i] = Build_Template(opened[i], static_cast<TemplateType>(i),
+                                              job.atlas.data() + offsets[i]);
+            job.steps_done.fetch_add(1, std::memory_order_relaxed);
+        }
+        Platform_Template_Free(opened[i]);
+    }
+
+    job.finished.store(true, std::memory_order_release);
+}
+
+// The theater's atlas in the open AssetPack, or null
+static const AssetPackAtlas* Find_Packed_Atlas(TheaterType theater, AssetPackBlob* blob) {
+    if (!AssetPack::Instance().IsOpen()) {
+        return nullptr;
+    }
+    return AssetPack::Instance().FindAtlas(TileRenderer::GetPackedAtlasName(theater).c_str(), blob);
+}
+
+// Template whose tiles live in a packed atlas (pixels stays empty)
+static std::unique_ptr<TemplateData> Packed_Template(const AssetPackBlob& blob, TheaterType theater,
+                                                     TemplateType tmpl) {
+    const AssetPackAtlas* atlas = reinterpret_cast<const AssetPackAtlas*>(blob.data);
+    const AssetPackTemplate* entries = reinterpret_cast<const AssetPackTemplate*>(atlas + 1);
+    std::string filename = Template_Filename(theater, tmpl);
+
+    for (uint32_t i = 0; i < atlas->template_count; i++) {
+        if (filename != entries[i].name) {
+            continue;
+        }
+        auto data = std::make_unique<TemplateData>();
+        data->type = tmpl;
+        data->tile_count = static_cast<int>(entries[i].tile_count);
+        data->width = 1;
+        data->height = 1;
+        data->tiles = blob.data + atlas->tiles_offset +
+                      static_cast<size_t>(entries[i].first_tile) * TILE_SIZE;
+        Assign_Land_Types(*data);
+        return data;
+    }
+    return nullptr;
+}
+
+// Fill a job from the packed atlas instead of decoding
+static bool Load_Packed_Theater(TheaterLoadJob& job) {
+    AssetPackBlob blob;
+    if (!Find_Packed_Atlas(job.theater, &blob)) {
+        return false;
+    }
+
+    for (int i = 0; i < TEMPLATE_COUNT; i++) {
+        std::unique_ptr<TemplateData> data =
+            Packed_Template(blob, job.theater, static_cast<TemplateType>(i));
+        if (data) {
+            job.templates[i] = std::move(data);
+        }
+    }
+    job.steps_done.store(TheaterLoadJob::TOTAL_STEPS, std::memory_order_relaxed);
+    job.finished.store(true, std::memory_order_release);
+    return true;
+}
+
 // =============================================================================
 // TileRenderer Singleton
 // =============================================================================
@@ -102,9 +312,11 @@ TileRenderer& TileRenderer::Instance() {
 TileRenderer::TileRenderer()
     : current_theater_(THEATER_NONE)
 {
+    ClearCache();
 }
 
 TileRenderer::~TileRenderer() {
+    CancelTheaterLoad();
     ClearCache();
 }
 
@@ -122,6 +334,7 @@ bool TileRenderer::SetTheater(TheaterType theater) {
     }
 
     // Clear existing cache
+    CancelTheaterLoad();
     ClearCache();
 
     // Load theater palette
@@ -144,130 +357,281 @@ bool TileRenderer::SetTheater(TheaterType theater) {
     return true;
 }
 
-// =============================================================================
-// Template Loading
-// =============================================================================
+bool TileRenderer::BeginTheaterLoad(TheaterType theater) {
+    if (!SetTheater(theater)) {
+        return false;
+    }
 
-std::string TileRenderer::GetTemplateFilename(TemplateType tmpl) const {
-    if (tmpl < 0 || tmpl >= TEMPLATE_COUNT) {
-        return "";
+    // Already decoding, or already decoded
+    if (load_job_ || !tile_atlas_.empty() || atlas_packed_) {
+        return true;
     }
 
-    std::string filename = TEMPLATE_FILENAMES[tmpl];
-    filename += Theater_Extension(current_theater_);
-    return filename;
+    // A packed atlas needs no decoding
+    if (InstallPackedTheater()) {
+        return true;
+    }
+
+    load_job_.reset(new TheaterLoadJob());
+    load_job_->theater = theater;
+    TheaterLoadJob* job = load_job_.get();
+    job->thread = std::thread([job]() { Decode_Theater(*job); });
+    return true;
 }
 
-TemplateData* TileRenderer::LoadTemplate(TemplateType tmpl) {
-    if (current_theater_ == THEATER_NONE) {
-        return nullptr;
+bool TileRenderer::UpdateTheaterLoad() {
+    if (!load_job_) {
+        return false;
+    }
+    if (!load_job_->finished.load(std::memory_order_acquire)) {
+        return true;
     }
 
-    std::string filename = GetTemplateFilename(tmpl);
-    if (filename.empty()) {
-        return nullptr;
+    load_job_->thread.join();
+    InstallTheaterLoad(*load_job_);
+    load_job_.reset();
+    return false;
+}
+
+void TileRenderer::WaitForTheaterLoad() {
+    if (!load_job_) {
+        return;
     }
 
-    // Get file size
-    int32_t size = Platform_Mix_GetSize(filename.c_str());
-    if (size <= 0) {
-        // Try with .TMP extension if theater-specific failed
-        filename = TEMPLATE_FILENAMES[tmpl];
-        filename += ".TMP";
-        size = Platform_Mix_GetSize(filename.c_str());
-        if (size <= 0) {
-            return nullptr;
+    load_job_->thread.join();
+    InstallTheaterLoad(*load_job_);
+    load_job_.reset();
+}
+
+bool TileRenderer::IsTheaterLoading() const {
+    return load_job_ != nullptr;
+}
+
+float TileRenderer::GetTheaterLoadProgress() const {
+    if (!load_job_) {
+        return 1.0f;
+    }
+    return static_cast<float>(load_job_->steps_done.load(std::memory_order_relaxed)) /
+           TheaterLoadJob::TOTAL_STEPS;
+}
+
+void TileRenderer::CancelTheaterLoad() {
+    if (!load_job_) {
+        return;
+    }
+
+    load_job_->cancel.store(true, std::memory_order_relaxed);
+    load_job_->thread.join();
+    load_job_.reset();
+}
+
+bool TileRenderer::InstallPackedTheater() {
+    TheaterLoadJob job;
+    job.theater = current_theater_;
+    if (!Load_Packed_Theater(job)) {
+        return false;
+    }
+
+    CancelTheaterLoad();
+    InstallTheaterLoad(job);
+    atlas_packed_ = true;
+    return true;
+}
+
+void TileRenderer::InstallTheaterLoad(TheaterLoadJob& job) {
+    if (job.theater != current_theater_) {
+        return;
+    }
+
+    // Drop entries backed by the old atlas; keep on-demand ones the job
+    // could not load
+    for (auto it = template_cache_.begin(); it != template_cache_.end();) {
+        if (it->second->pixels.empty() || job.templates.count(it->first)) {
+            it = template_cache_.erase(it);
+        } else {
+            ++it;
         }
     }
 
-    // Read file data
-    std::vector<uint8_t> file_data(size);
-    if (Platform_Mix_Read(filename.c_str(), file_data.data(), size) != size) {
-        return nullptr;
+    tile_atlas_.swap(job.atlas);
+    for (auto& pair : job.templates) {
+        template_cache_[pair.first] = std::move(pair.second);
+    }
+    RebuildTileTable();
+
+    // Decoded rather than packed: worth sharing with other instances
+    if (!tile_atlas_.empty()) {
+        SharedAssetCache::Note_Theater(job.theater);
     }
+}
 
-    // Parse template using platform layer
-    PlatformTemplate* platform_tmpl = Platform_Template_LoadFromMemory(
-        file_data.data(), size, TILE_WIDTH, TILE_HEIGHT);
+void TileRenderer::RebuildTileTable() {
+    tile_table_.clear();
+    tile_land_.clear();
 
-    if (!platform_tmpl) {
-        return nullptr;
+    for (int t = 0; t < TEMPLATE_COUNT; t++) {
+        auto it = template_cache_.find(t);
+        const TemplateData* data = it != template_cache_.end() ? it->second.get() : nullptr;
+
+        template_table_[t] = data;
+        tile_base_[t] = static_cast<int>(tile_table_.size());
+        if (!data) {
+            continue;
+        }
+
+        template_missing_[t] = false;
+        for (int i = 0; i < data->tile_count; i++) {
+            tile_table_.push_back(data->GetTile(i));
+            tile_land_.push_back(data->GetLandType(i));
+        }
     }
+    tile_base_[TEMPLATE_COUNT] = static_cast<int>(tile_table_.size());
+}
 
-    // Create template data
-    auto data = std::make_unique<TemplateData>();
-    data->type = tmpl;
-    data->tile_count = Platform_Template_GetTileCount(platform_tmpl);
+// =============================================================================
+// Template Loading
+// =============================================================================
 
-    int32_t tw, th;
-    Platform_Template_GetTileSize(platform_tmpl, &tw, &th);
-    data->width = 1;
-    data->height = 1;
+std::string TileRenderer::GetTemplateFilename(TemplateType tmpl) const {
+    return Template_Filename(current_theater_, tmpl);
+}
 
-    // Allocate pixel storage
-    data->pixels.resize(data->tile_count * TILE_SIZE);
+std::string TileRenderer::GetPackedAtlasName(TheaterType theater) {
+    return std::string(Theater_Name(theater)) + ".ATL";
+}
 
-    // Read all tiles
-    for (int i = 0; i < data->tile_count; i++) {
-        Platform_Template_GetTile(platform_tmpl,
-                                  i,
-                                  data->pixels.data() + i * TILE_SIZE,
-                                  TILE_SIZE);
+bool TileRenderer::PackTheater(TheaterType theater, AssetPackWriter& writer) {
+    if (theater < 0 || theater >= THEATER_COUNT) {
+        return false;
     }
 
-    // Initialize land types (default to LAND_CLEAR)
-    data->land.resize(data->tile_count, LAND_CLEAR);
+    TheaterLoadJob job;
+    job.theater = theater;
+    Decode_Theater(job);
 
-    // Set land types based on template type
-    switch (tmpl) {
-        case TEMPLATE_WATER1:
-        case TEMPLATE_WATER2:
-            std::fill(data->land.begin(), data->land.end(), LAND_WATER);
-            break;
-        case TEMPLATE_SHORE1:
-        case TEMPLATE_SHORE2:
-        case TEMPLATE_SHORE3:
-        case TEMPLATE_SHORE4:
-        case TEMPLATE_SHORE5:
-        case TEMPLATE_SHORE6:
-        case TEMPLATE_SHORE7:
-        case TEMPLATE_SHORE8:
-            std::fill(data->land.begin(), data->land.end(), LAND_BEACH);
-            break;
-        case TEMPLATE_CLIFF1:
-        case TEMPLATE_CLIFF2:
-            std::fill(data->land.begin(), data->land.end(), LAND_ROCK);
-            break;
-        case TEMPLATE_ROAD1:
-        case TEMPLATE_ROAD2:
-        case TEMPLATE_ROAD3:
-            std::fill(data->land.begin(), data->land.end(), LAND_ROAD);
-            break;
-        case TEMPLATE_ROUGH1:
-        case TEMPLATE_ROUGH2:
-            std::fill(data->land.begin(), data->land.end(), LAND_ROUGH);
-            break;
-        default:
-            break;
+    std::vector<std::string> names;
+    std::vector<const TemplateData*> templates;
+    for (int i = 0; i < TEMPLATE_COUNT; i++) {
+        auto it = job.templates.find(i);
+        if (it != job.templates.end() && it->second) {
+            names.push_back(Template_Filename(theater, static_cast<TemplateType>(i)));
+            templates.push_back(it->second.get());
+        }
     }
+    return !templates.empty() &&
+           writer.AddAtlas(GetPackedAtlasName(theater).c_str(), names, templates, TILE_SIZE);
+}
+
+TemplateData* TileRenderer::LoadTemplate(TemplateType tmpl) {
+    if (current_theater_ == THEATER_NONE) {
+        return nullptr;
+    }
+
+    // Packed templates point into the mapped atlas
+    AssetPackBlob blob;
+    if (Find_Packed_Atlas(current_theater_, &blob)) {
+        std::unique_ptr<TemplateData> data = Packed_Template(blob, current_theater_, tmpl);
+        if (!data) {
+            return nullptr;
+        }
+        TemplateData* ptr = data.get();
+        template_cache_[static_cast<int>(tmpl)] = std::move(data);
+        RebuildTileTable();
+        return ptr;
+    }
+
+    PlatformTemplate* platform_tmpl = Open_Template(current_theater_, tmpl);
+    if (!platform_tmpl) {
+        return nullptr;
+    }
+
+    // Own the pixels; the atlas only holds preloaded templates
+    std::vector<uint8_t> pixels(
+        static_cast<size_t>(Platform_Template_GetTileCount(platform_tmpl)) * TILE_SIZE);
+    std::unique_ptr<TemplateData> data = Build_Template(platform_tmpl, tmpl, pixels.data());
+    data->pixels.swap(pixels);
+    data->tiles = data->pixels.data();
 
     Platform_Template_Free(platform_tmpl);
 
     // Store in cache and return
     TemplateData* ptr = data.get();
     template_cache_[static_cast<int>(tmpl)] = std::move(data);
+    RebuildTileTable();
     return ptr;
 }
 
+bool TileRenderer::LoadTemplateAsync(TemplateType tmpl, AssetPriority priority) {
+    if (tmpl < 0 || tmpl >= TEMPLATE_COUNT || current_theater_ == THEATER_NONE) {
+        return false;
+    }
+    if (template_table_[tmpl] || template_missing_[tmpl] || template_pending_[tmpl] || load_job_) {
+        return false;
+    }
+
+    // Nothing to decode; take it from the pack now
+    AssetPackBlob blob;
+    if (Find_Packed_Atlas(current_theater_, &blob)) {
+        GetTemplate(tmpl);
+        return false;
+    }
+
+    template_pending_[tmpl] = true;
+    TheaterType theater = current_theater_;
+    uint32_t generation = cache_generation_;
+    auto result = std::make_shared<std::unique_ptr<TemplateData>>();
+
+    // The worker only touches the MIX manager and its own TemplateData
+    AssetLoader::Instance().Submit(priority,
+        [result, theater, tmpl]() {
+            PlatformTemplate* platform_tmpl = Open_Template(theater, tmpl);
+            if (!platform_tmpl) {
+                return;
+            }
+            std::vector<uint8_t> pixels(
+                static_cast<size_t>(Platform_Template_GetTileCount(platform_tmpl)) * TILE_SIZE);
+            *result = Build_Template(platform_tmpl, tmpl, pixels.data());
+            (*result)->pixels.swap(pixels);
+            (*result)->tiles = (*result)->pixels.data();
+            Platform_Template_Free(platform_tmpl);
+        },
+        [this, result, theater, tmpl, generation]() {
+            if (generation != cache_generation_ || theater != current_theater_) {
+                return;
+            }
+            template_pending_[tmpl] = false;
+            if (template_table_[tmpl]) {
+                return;     // Loaded synchronously meanwhile
+            }
+            if (!*result) {
+                template_missing_[tmpl] = true;
+                return;
+            }
+            template_cache_[static_cast<int>(tmpl)] = std::move(*result);
+            RebuildTileTable();
+        });
+    return true;
+}
+
 const TemplateData* TileRenderer::GetTemplate(TemplateType tmpl) {
+    if (tmpl < 0 || tmpl >= TEMPLATE_COUNT) {
+        return nullptr;
+    }
+
     // Check cache first
-    auto it = template_cache_.find(static_cast<int>(tmpl));
-    if (it != template_cache_.end()) {
-        return it->second.get();
+    if (template_table_[tmpl]) {
+        return template_table_[tmpl];
+    }
+    if (template_missing_[tmpl] || current_theater_ == THEATER_NONE) {
+        return nullptr;
     }
 
     // Load and cache
-    return LoadTemplate(tmpl);
+    TemplateData* data = LoadTemplate(tmpl);
+    if (!data) {
+        template_missing_[tmpl] = true;
+    }
+    return data;
 }
 
 int TileRenderer::GetTileCount(TemplateType tmpl) {
@@ -299,22 +663,10 @@ bool TileRenderer::DrawTileWithLand(GraphicsBuffer& buffer, int x, int y,
         return true;
     }
 
-    const TemplateData* data = GetTemplate(tmpl);
-    if (!data) {
-        // Template not found - draw clear
-        DrawClear(buffer, x, y, x ^ y);
-        if (land_out) *land_out = LAND_CLEAR;
-        return false;
-    }
-
-    // Validate icon index
-    if (icon < 0 || icon >= data->tile_count) {
-        icon = 0;  // Default to first tile
-    }
-
-    // Get tile pixels
-    const uint8_t* tile_pixels = data->GetTile(icon);
+    LandType land = LAND_CLEAR;
+    const uint8_t* tile_pixels = LookupTile(tmpl, icon, &land);
     if (!tile_pixels) {
+        // Template not found - draw clear
         DrawClear(buffer, x, y, x ^ y);
         if (land_out) *land_out = LAND_CLEAR;
         return false;
@@ -322,7 +674,7 @@ bool TileRenderer::DrawTileWithLand(GraphicsBuffer& buffer, int x, int y,
 
     // Get land type
     if (land_out) {
-        *land_out = data->GetLandType(icon);
+        *land_out = land;
     }
 
     // Check if buffer is locked
@@ -330,50 +682,90 @@ bool TileRenderer::DrawTileWithLand(GraphicsBuffer& buffer, int x, int y,
         return false;
     }
 
-    // Clip to buffer bounds
-    int buf_w = buffer.Get_Width();
-    int buf_h = buffer.Get_Height();
+    // Fully visible: fixed-size copy; otherwise clip (off-screen draws nothing)
+    if (x >= 0 && y >= 0 &&
+        x + TILE_WIDTH <= buffer.Get_Width() && y + TILE_HEIGHT <= buffer.Get_Height()) {
+        buffer.Blit_Tile24(tile_pixels, x, y);
+    } else {
+        buffer.Blit_Tile24_Clipped(tile_pixels, x, y);
+    }
 
-    // Completely off-screen?
-    if (x >= buf_w || y >= buf_h || x + TILE_WIDTH <= 0 || y + TILE_HEIGHT <= 0) {
-        return true;  // Nothing to draw, but not an error
+    return true;
+}
+
+bool TileRenderer::DrawTileInterior(GraphicsBuffer& buffer, int x, int y,
+                                    TemplateType tmpl, int icon) {
+    const uint8_t* tile_pixels = LookupTile(tmpl, icon, nullptr);
+    if (!tile_pixels || !buffer.IsLocked()) {
+        return false;
     }
 
-    // Calculate clipping
-    int src_x = 0;
-    int src_y = 0;
-    int dst_x = x;
-    int dst_y = y;
-    int width = TILE_WIDTH;
-    int height = TILE_HEIGHT;
+    buffer.Blit_Tile24(tile_pixels, x, y);
+    return true;
+}
 
-    if (x < 0) {
-        src_x = -x;
-        width += x;
-        dst_x = 0;
+int TileRenderer::DrawTileRun(GraphicsBuffer& buffer, int x, int y,
+                              const TileRunEntry* tiles, int count) {
+    if (!tiles || count <= 0 || !buffer.IsLocked()) {
+        return 0;
     }
-    if (y < 0) {
-        src_y = -y;
-        height += y;
-        dst_y = 0;
+
+    // Resolve every tile first so the copy loop below is only blits
+    run_pixels_.resize(count);
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        const uint8_t* pixels = nullptr;
+        if (tiles[i].tmpl != TEMPLATE_NONE) {
+            pixels = LookupTile(tiles[i].tmpl, tiles[i].icon, nullptr);
+        }
+        if (pixels) {
+            found++;
+        }
+        run_pixels_[i] = pixels;
     }
-    if (dst_x + width > buf_w) {
-        width = buf_w - dst_x;
+
+    bool inside = x >= 0 && y >= 0 &&
+                  x + count * TILE_WIDTH <= buffer.Get_Width() &&
+                  y + TILE_HEIGHT <= buffer.Get_Height();
+
+    for (int i = 0; i < count; i++, x += TILE_WIDTH) {
+        const uint8_t* pixels = run_pixels_[i];
+        if (!pixels) {
+            DrawClear(buffer, x, y, tiles[i].seed);
+        } else if (inside) {
+            buffer.Blit_Tile24(pixels, x, y);
+        } else {
+            buffer.Blit_Tile24_Clipped(pixels, x, y);
+        }
     }
-    if (dst_y + height > buf_h) {
-        height = buf_h - dst_y;
+
+    return found;
+}
+
+const uint8_t* TileRenderer::LookupTile(TemplateType tmpl, int icon, LandType* land_out) {
+    if (tmpl < 0 || tmpl >= TEMPLATE_COUNT) {
+        return nullptr;
     }
 
-    if (width <= 0 || height <= 0) {
-        return true;
+    // One table load finds the tile; first use of a template loads it
+    if (!template_table_[tmpl]) {
+        GetTemplate(tmpl);
     }
 
-    // Blit tile to buffer (opaque - tiles fill entire cell)
-    buffer.Blit_From_Raw(tile_pixels, TILE_WIDTH,
-                         src_x, src_y, TILE_WIDTH, TILE_HEIGHT,
-                         dst_x, dst_y, width, height);
+    int base = tile_base_[tmpl];
+    int count = tile_base_[tmpl + 1] - base;
+    if (count <= 0) {
+        return nullptr;
+    }
 
-    return true;
+    // Validate icon index
+    if (icon < 0 || icon >= count) {
+        icon = 0;  // Default to first tile
+    }
+    if (land_out) {
+        *land_out = tile_land_[base + icon];
+    }
+    return tile_table_[base + icon];
 }
 
 void TileRenderer::DrawClear(GraphicsBuffer& buffer, int x, int y, uint32_t seed) {
@@ -382,67 +774,42 @@ void TileRenderer::DrawClear(GraphicsBuffer& buffer, int x, int y, uint32_t seed
 
     // Try to draw clear1 template
     const TemplateData* data = GetTemplate(TEMPLATE_CLEAR1);
+    const uint8_t* tile_pixels = nullptr;
     if (data && data->tile_count > 0) {
-        int icon = variation % data->tile_count;
-        const uint8_t* tile_pixels = data->GetTile(icon);
-        if (tile_pixels && buffer.IsLocked()) {
-            int buf_w = buffer.Get_Width();
-            int buf_h = buffer.Get_Height();
-
-            // Check bounds
-            if (x < buf_w && y < buf_h && x + TILE_WIDTH > 0 && y + TILE_HEIGHT > 0) {
-                // Calculate clipping
-                int src_x = 0;
-                int src_y = 0;
-                int dst_x = x;
-                int dst_y = y;
-                int width = TILE_WIDTH;
-                int height = TILE_HEIGHT;
-
-                if (x < 0) {
-                    src_x = -x;
-                    width += x;
-                    dst_x = 0;
-                }
-                if (y < 0) {
-                    src_y = -y;
-                    height += y;
-                    dst_y = 0;
-                }
-                if (dst_x + width > buf_w) {
-                    width = buf_w - dst_x;
-                }
-                if (dst_y + height > buf_h) {
-                    height = buf_h - dst_y;
-                }
-
-                if (width > 0 && height > 0) {
-                    buffer.Blit_From_Raw(tile_pixels, TILE_WIDTH,
-                                         src_x, src_y, TILE_WIDTH, TILE_HEIGHT,
-                                         dst_x, dst_y, width, height);
-                    return;
-                }
-            }
+        tile_pixels = data->GetTile(variation % data->tile_count);
+    }
+    DrawTilePixels(buffer, x, y, tile_pixels);
+}
+
+void TileRenderer::DrawTilePixels(GraphicsBuffer& buffer, int x, int y, const uint8_t* pixels) {
+    if (!buffer.IsLocked()) {
+        return;
+    }
+
+    if (pixels) {
+        if (x >= 0 && y >= 0 &&
+            x + TILE_WIDTH <= buffer.Get_Width() && y + TILE_HEIGHT <= buffer.Get_Height()) {
+            buffer.Blit_Tile24(pixels, x, y);
+        } else {
+            buffer.Blit_Tile24_Clipped(pixels, x, y);
         }
+        return;
     }
 
-    // Fallback: solid color
-    if (buffer.IsLocked()) {
-        // Calculate clipped rect
-        int dst_x = x < 0 ? 0 : x;
-        int dst_y = y < 0 ? 0 : y;
-        int width = TILE_WIDTH - (x < 0 ? -x : 0);
-        int height = TILE_HEIGHT - (y < 0 ? -y : 0);
+    // Fallback: solid color, clipped
+    int dst_x = x < 0 ? 0 : x;
+    int dst_y = y < 0 ? 0 : y;
+    int width = TILE_WIDTH - (x < 0 ? -x : 0);
+    int height = TILE_HEIGHT - (y < 0 ? -y : 0);
 
-        int buf_w = buffer.Get_Width();
-        int buf_h = buffer.Get_Height();
+    int buf_w = buffer.Get_Width();
+    int buf_h = buffer.Get_Height();
 
-        if (dst_x + width > buf_w) width = buf_w - dst_x;
-        if (dst_y + height > buf_h) height = buf_h - dst_y;
+    if (dst_x + width > buf_w) width = buf_w - dst_x;
+    if (dst_y + height > buf_h) height = buf_h - dst_y;
 
-        if (width > 0 && height > 0) {
-            buffer.Fill_Rect(dst_x, dst_y, width, height, 21);  // Green-ish
-        }
+    if (width > 0 && height > 0) {
+        buffer.Fill_Rect(dst_x, dst_y, width, height, 21);  // Green-ish
     }
 }
 
@@ -467,6 +834,7 @@ bool TileRenderer::LoadOverlay(OverlayType overlay) {
     }
 
     // Load shape file
+    IoScope io(IoTag::GRAPHICS);
     PlatformShape* shape = Platform_Shape_Load(filename.c_str());
     if (!shape) {
         return false;
@@ -478,13 +846,20 @@ bool TileRenderer::LoadOverlay(OverlayType overlay) {
         return false;
     }
 
-    // Cache all frames
+    // Cache all frames; tile-sized shapes decode in one pass, in order
     std::vector<uint8_t> all_frames(frame_count * TILE_SIZE);
 
-    for (int i = 0; i < frame_count; i++) {
-        Platform_Shape_GetFrame(shape, i,
-                                all_frames.data() + i * TILE_SIZE,
-                                TILE_SIZE);
+    int32_t width = 0;
+    int32_t height = 0;
+    Platform_Shape_GetSize(shape, &width, &height);
+    if (width * height != TILE_SIZE ||
+        Platform_Shape_DecodeRange(shape, 0, frame_count, all_frames.data(),
+                                   static_cast<int32_t>(all_frames.size())) != frame_count) {
+        for (int i = 0; i < frame_count; i++) {
+            Platform_Shape_GetFrame(shape, i,
+                                    all_frames.data() + i * TILE_SIZE,
+                                    TILE_SIZE);
+        }
     }
 
     Platform_Shape_Free(shape);
@@ -535,18 +910,41 @@ bool TileRenderer::DrawOverlay(GraphicsBuffer& buffer, int x, int y,
 // =============================================================================
 
 void TileRenderer::PreloadAllTemplates() {
-    for (int i = 0; i < TEMPLATE_COUNT; i++) {
-        GetTemplate(static_cast<TemplateType>(i));
+    if (current_theater_ == THEATER_NONE) {
+        return;
+    }
+
+    // Finish an in-flight load rather than decoding twice
+    if (load_job_) {
+        WaitForTheaterLoad();
+        return;
+    }
+    if (atlas_packed_ || InstallPackedTheater()) {
+        return;
     }
+
+    TheaterLoadJob job;
+    job.theater = current_theater_;
+    Decode_Theater(job);
+    InstallTheaterLoad(job);
 }
 
 void TileRenderer::ClearCache() {
     template_cache_.clear();
+    tile_atlas_.clear();
+    atlas_packed_ = false;
     overlay_cache_.clear();
+
+    for (int t = 0; t < TEMPLATE_COUNT; t++) {
+        template_missing_[t] = false;
+        template_pending_[t] = false;
+    }
+    cache_generation_++;
+    RebuildTileTable();
 }
 
 size_t TileRenderer::GetCacheSize() const {
-    size_t total = 0;
+    size_t total = tile_atlas_.size();
 
     for (const auto& pair : template_cache_) {
         total += pair.second->pixels.size();
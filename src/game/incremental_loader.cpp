@@ -0,0 +1,92 @@
+/**
+ * IncrementalLoader Implementation
+ */
+
+#include "game/incremental_loader.h"
+#include "game/asset_loader.h"
+#include "platform.h"
+#include <utility>
+
+void IncrementalLoader::Add(const char* name, StepFn step) {
+    steps_.push_back({name, std::move(step), WorkFn()});
+}
+
+void IncrementalLoader::Add_Parallel(const char* name, WorkFn work) {
+    steps_.push_back({name, StepFn(), std::move(work)});
+}
+
+void IncrementalLoader::Clear() {
+    steps_.clear();
+    next_ = 0;
+    group_end_ = 0;
+    running_.reset();
+}
+
+// =============================================================================
+// Running
+// =============================================================================
+
+bool IncrementalLoader::Pump(double budget_ms) {
+    double start = Platform_Timer_GetTime();
+    bool called = false;
+
+    while (next_ < steps_.size()) {
+        if (!steps_[next_].step) {
+            if (!Join_Group()) {
+                return false;   // Waiting on workers; the budget is no use to them
+            }
+            continue;
+        }
+
+        if (called && (Platform_Timer_GetTime() - start) * 1000.0 >= budget_ms) {
+            break;
+        }
+        called = true;
+        if (steps_[next_].step()) {
+            next_++;
+        }
+    }
+    return Is_Done();
+}
+
+bool IncrementalLoader::Join_Group() {
+    // Hand out the whole run of parallel steps at once
+    if (!running_) {
+        group_end_ = next_;
+        while (group_end_ < steps_.size() && !steps_[group_end_].step) {
+            group_end_++;
+        }
+
+        running_ = std::make_shared<std::atomic<int>>(static_cast<int>(group_end_ - next_));
+        for (size_t i = next_; i < group_end_; i++) {
+            std::shared_ptr<std::atomic<int>> running = running_;
+            WorkFn work = steps_[i].work;
+            AssetLoader::Instance().Submit(ASSET_PRIORITY_VISIBLE, [running, work]() {
+                work();
+                running->fetch_sub(1, std::memory_order_release);
+            });
+        }
+    }
+
+    if (running_->load(std::memory_order_acquire) > 0) {
+        return false;
+    }
+    running_.reset();
+    next_ = group_end_;
+    return true;
+}
+
+// =============================================================================
+// Progress
+// =============================================================================
+
+float IncrementalLoader::Get_Progress() const {
+    if (steps_.empty()) {
+        return 1.0f;
+    }
+    return static_cast<float>(next_) / static_cast<float>(steps_.size());
+}
+
+const char* IncrementalLoader::Get_Step_Name() const {
+    return Is_Done() ? "" : steps_[next_].name.c_str();
+}
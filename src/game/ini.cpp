@@ -0,0 +1,310 @@
+/**
+ * INIClass Implementation
+ */
+
+#include "game/ini.h"
+#include "platform.h"
+#include <cstring>
+
+// =============================================================================
+// Name Hashing
+// =============================================================================
+
+bool INI_Equal(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        char ca = a[i];
+        char cb = b[i];
+        if (ca >= 'a' && ca <= 'z') ca = static_cast<char>(ca - ('a' - 'A'));
+        if (cb >= 'a' && cb <= 'z') cb = static_cast<char>(cb - ('a' - 'A'));
+        if (ca != cb) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void NameIndex::Reset(int count) {
+    // Keep the table at most half full
+    size_t size = 16;
+    while (size < static_cast<size_t>(count) * 2) {
+        size <<= 1;
+    }
+    slots_.assign(size, Slot{0, -1});
+    mask_ = size - 1;
+    count_ = 0;
+}
+
+void NameIndex::Add(uint32_t hash, int index) {
+    if ((count_ + 1) * 2 > slots_.size()) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        Reset(static_cast<int>(old.size()));
+        for (const Slot& s : old) {
+            if (s.index >= 0) {
+                Add(s.hash, s.index);
+            }
+        }
+    }
+
+    size_t slot = hash & mask_;
+    while (slots_[slot].index >= 0) {
+        slot = (slot + 1) & mask_;
+    }
+    slots_[slot] = Slot{hash, index};
+    count_++;
+}
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+namespace {
+
+bool Is_Blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view Trim(const char* begin, const char* end) {
+    while (begin < end && Is_Blank(*begin)) begin++;
+    while (end > begin && Is_Blank(end[-1])) end--;
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+}
+
+} // namespace
+
+INIClass::~INIClass() {
+    Clear();
+}
+
+void INIClass::Clear() {
+    sections_.clear();
+    entries_.clear();
+    section_index_ = NameIndex();
+    entry_index_ = NameIndex();
+    if (mapped_ != nullptr) {
+        Platform_File_Unmap(mapped_);
+        mapped_ = nullptr;
+    }
+}
+
+bool INIClass::Load_File(const char* path) {
+    Clear();
+
+    int64_t size = 0;
+    const uint8_t* data = path ? Platform_File_Map(path, &size) : nullptr;
+    if (data == nullptr) {
+        return false;
+    }
+
+    bool ok = Load(reinterpret_cast<const char*>(data), static_cast<size_t>(size));
+    mapped_ = data;     // After Load, which clears it
+    return ok;
+}
+
+bool INIClass::Load(const char* text, size_t length) {
+    Clear();
+    if (text == nullptr) {
+        return false;
+    }
+
+    // A rough guess saves most of the rehashing
+    size_t lines = 1;
+    for (const char* p = text; (p = static_cast<const char*>(memchr(p, '\n', text + length - p))) != nullptr; p++) {
+        lines++;
+    }
+    entries_.reserve(lines);
+    entry_index_.Reset(static_cast<int>(lines));
+
+    int section = -1;
+    const char* pos = text;
+    const char* end = text + length;
+    while (pos < end) {
+        const char* line_end = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        if (!line_end) line_end = end;
+        const char* comment = static_cast<const char*>(memchr(pos, ';', line_end - pos));
+        std::string_view line = Trim(pos, comment ? comment : line_end);
+        pos = line_end + 1;
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            size_t close = line.find(']');
+            std::string_view name = Trim(line.data() + 1, line.data() + (close == std::string_view::npos ? line.size() : close));
+            section = Find_Section(name);
+            if (section < 0) {
+                section = static_cast<int>(sections_.size());
+                sections_.push_back(Section{name, {}});
+                section_index_.Add(INI_Hash(name), section);
+            }
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (section < 0 || eq == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = Trim(line.data(), line.data() + eq);
+        std::string_view value = Trim(line.data() + eq + 1, line.data() + line.size());
+        if (key.empty()) {
+            continue;
+        }
+
+        int existing = Find_Entry(section, key);
+        if (existing >= 0) {
+            entries_[existing].value = value;
+            continue;
+        }
+        int index = static_cast<int>(entries_.size());
+        entries_.push_back(Entry{key, value, section});
+        sections_[section].entries.push_back(index);
+        entry_index_.Add(Entry_Hash(section, key), index);
+    }
+
+    return !sections_.empty();
+}
+
+// =============================================================================
+// Lookup
+// =============================================================================
+
+int INIClass::Find_Section(std::string_view section) const {
+    return section_index_.Find(INI_Hash(section), [&](int index) {
+        return INI_Equal(sections_[index].name, section);
+    });
+}
+
+int INIClass::Find_Entry(int section, std::string_view entry) const {
+    return entry_index_.Find(Entry_Hash(section, entry), [&](int index) {
+        return entries_[index].section == section && INI_Equal(entries_[index].key, entry);
+    });
+}
+
+int INIClass::Find_Entry(std::string_view section, std::string_view entry) const {
+    int s = Find_Section(section);
+    return s < 0 ? -1 : Find_Entry(s, entry);
+}
+
+bool INIClass::Is_Present(std::string_view section, std::string_view entry) const {
+    return Find_Entry(section, entry) >= 0;
+}
+
+int INIClass::Entry_Count(std::string_view section) const {
+    int s = Find_Section(section);
+    return s < 0 ? 0 : static_cast<int>(sections_[s].entries.size());
+}
+
+std::string_view INIClass::Get_Entry(std::string_view section, int index) const {
+    int s = Find_Section(section);
+    if (s < 0 || index < 0 || index >= static_cast<int>(sections_[s].entries.size())) {
+        return std::string_view();
+    }
+    return entries_[sections_[s].entries[index]].key;
+}
+
+// =============================================================================
+// Values
+// =============================================================================
+
+std::string_view INIClass::Get_String(std::string_view section, std::string_view entry,
+                                      std::string_view def) const {
+    int index = Find_Entry(section, entry);
+    return index < 0 ? def : entries_[index].value;
+}
+
+int INIClass::Get_Int(std::string_view section, std::string_view entry, int def) const {
+    std::string_view value = Get_String(section, entry);
+    if (value.empty()) {
+        return def;
+    }
+
+    size_t i = 0;
+    bool negative = false;
+    if (value[0] == '-' || value[0] == '+') {
+        negative = value[0] == '-';
+        i++;
+    }
+    int base = 10;
+    if (i < value.size() && value[i] == '$') {
+        base = 16;
+        i++;
+    }
+
+    int64_t result = 0;
+    size_t digits = 0;
+    for (; i < value.size(); i++, digits++) {
+        char c = value[i];
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (base == 16 && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (base == 16 && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else break;
+        result = result * base + digit;
+        if (result > INT32_MAX) {
+            return def;
+        }
+    }
+    if (digits == 0) {
+        return def;
+    }
+    return static_cast<int>(negative ? -result : result);
+}
+
+bool INIClass::Get_Bool(std::string_view section, std::string_view entry, bool def) const {
+    std::string_view value = Get_String(section, entry);
+    if (value.empty()) {
+        return def;
+    }
+    switch (value[0]) {
+        case 'y': case 'Y': case 't': case 'T': case '1':
+            return true;
+        case 'n': case 'N': case 'f': case 'F': case '0':
+            return false;
+        default:
+            return def;
+    }
+}
+
+fixed INIClass::Get_Fixed(std::string_view section, std::string_view entry, fixed def) const {
+    std::string_view value = Get_String(section, entry);
+    if (value.empty()) {
+        return def;
+    }
+
+    // Whole and fractional digits as one integer over a power of ten
+    int64_t number = 0;
+    int64_t scale = 1;
+    bool fraction = false;
+    bool digits = false;
+    size_t i = 0;
+    for (; i < value.size(); i++) {
+        char c = value[i];
+        if (c == '.' && !fraction) {
+            fraction = true;
+        } else if (c >= '0' && c <= '9') {
+            if (scale < 1000000) {
+                number = number * 10 + (c - '0');
+                if (fraction) scale *= 10;
+            } else if (!fraction) {
+                return def;     // Too large for 16.16
+            }
+            digits = true;
+        } else {
+            break;
+        }
+    }
+    if (!digits) {
+        return def;
+    }
+    if (i < value.size() && value[i] == '%') {
+        scale *= 100;
+    }
+    if (number / scale > 0x7FFF) {
+        return def;
+    }
+    return fixed::Ratio(static_cast<int>(number), static_cast<int>(scale));
+}
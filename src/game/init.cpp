@@ -5,8 +5,9 @@
  */
 
 #include "game/game.h"
-#include "game/types/unittype.h"
-#include "game/types/buildingtype.h"
+#include "game/ini.h"
+#include "game/mix_view.h"
+#include "game/types/type_tables.h"
 #include "platform.h"
 #include <cstdio>
 
@@ -20,8 +21,7 @@
 static bool Init_Types() {
     Platform_LogInfo("Initializing type classes...");
 
-    // Unit types are statically initialized
-    // Just verify they're valid
+    // Types start as the constexpr table defaults; just verify them
     for (int i = 0; i < UNIT_COUNT; i++) {
         if (UnitTypes[i].Get_Name()[0] == '\0') {
             char msg[64];
@@ -39,6 +39,19 @@ static bool Init_Types() {
     snprintf(msg2, sizeof(msg2), "  %d building types loaded", BUILDING_COUNT);
     Platform_LogInfo(msg2);
 
+    // RULES.INI only overrides what it mentions
+    MixView rules_file;
+    if (rules_file.Open("RULES.INI")) {
+        INIClass rules;
+        rules.Load(reinterpret_cast<const char*>(rules_file.Data()), static_cast<size_t>(rules_file.Size()));
+        char msg3[64];
+        snprintf(msg3, sizeof(msg3), "  RULES.INI overrides %d types", Apply_Type_Rules(rules));
+        Platform_LogInfo(msg3);
+    }
+
+    // Resolve shape handles once so draws never look shapes up by name
+    Init_Type_Shapes();
+
     return true;
 }
 
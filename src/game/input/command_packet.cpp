@@ -0,0 +1,155 @@
+// src/game/input/command_packet.cpp
+// Command packet wire format
+// Task 16f - Command System
+
+#include "game/input/command_packet.h"
+#include <algorithm>
+
+//=============================================================================
+// Little-endian and varint helpers
+//=============================================================================
+
+static void Put16(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void Put32(std::vector<uint8_t>& out, uint32_t value) {
+    Put16(out, value & 0xFFFF);
+    Put16(out, value >> 16);
+}
+
+static void PutVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static uint32_t Get16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t Get32(const uint8_t* p) {
+    return Get16(p) | (Get16(p + 2) << 16);
+}
+
+// Returns bytes used, 0 if the value runs off the end or past 32 bits
+static size_t GetVarint(const uint8_t* p, size_t size, uint32_t& value) {
+    value = 0;
+    for (size_t i = 0; i < size && i < 5; i++) {
+        value |= static_cast<uint32_t>(p[i] & 0x7F) << (7 * i);
+        if ((p[i] & 0x80) == 0) {
+            return (i == 4 && p[i] > 0x0F) ? 0 : i + 1;
+        }
+    }
+    return 0;
+}
+
+//=============================================================================
+// CommandPacket
+//=============================================================================
+
+void CommandPacket::Clear() {
+    frame = 0;
+    type = CommandType::NONE;
+    flags = CMD_FLAG_NONE;
+    target_type = CommandTarget::Type::NONE;
+    world_x = world_y = 0;
+    cell_x = cell_y = 0;
+    object_id = 0;
+    units.clear();
+}
+
+void CommandPacket::SetCommand(const Command& cmd) {
+    type = cmd.type;
+    flags = cmd.flags;
+    target_type = cmd.target.type;
+    world_x = cmd.target.world_x;
+    world_y = cmd.target.world_y;
+    cell_x = static_cast<int16_t>(cmd.target.cell_x);
+    cell_y = static_cast<int16_t>(cmd.target.cell_y);
+    object_id = cmd.target.object_id;
+}
+
+Command CommandPacket::GetCommand() const {
+    Command cmd;
+    cmd.Clear();
+    cmd.type = type;
+    cmd.flags = flags;
+    cmd.source_count = static_cast<int>(units.size());
+    cmd.target.type = target_type;
+    cmd.target.world_x = world_x;
+    cmd.target.world_y = world_y;
+    cmd.target.cell_x = cell_x;
+    cmd.target.cell_y = cell_y;
+    cmd.target.object_id = object_id;
+    return cmd;
+}
+
+void CommandPacket::SetUnits(const uint32_t* ids, int count) {
+    units.assign(ids, ids + count);
+    std::sort(units.begin(), units.end());
+    units.erase(std::unique(units.begin(), units.end()), units.end());
+    if (units.size() > static_cast<size_t>(MAX_UNITS)) {
+        units.resize(MAX_UNITS);
+    }
+}
+
+size_t CommandPacket::Write(std::vector<uint8_t>& out) const {
+    size_t start = out.size();
+    out.push_back(static_cast<uint8_t>(type));
+    out.push_back(static_cast<uint8_t>(target_type));
+    Put16(out, flags & 0xFFFF);
+    Put32(out, frame);
+    Put32(out, static_cast<uint32_t>(world_x));
+    Put32(out, static_cast<uint32_t>(world_y));
+    Put16(out, static_cast<uint16_t>(cell_x));
+    Put16(out, static_cast<uint16_t>(cell_y));
+    Put32(out, object_id);
+    Put16(out, static_cast<uint32_t>(units.size()));
+
+    uint32_t previous = 0;
+    for (uint32_t id : units) {
+        PutVarint(out, id - previous);
+        previous = id;
+    }
+    return out.size() - start;
+}
+
+size_t CommandPacket::Read(const uint8_t* data, size_t size) {
+    if (size < HEADER_SIZE || data[0] >= static_cast<uint8_t>(CommandType::COUNT) ||
+        data[1] > static_cast<uint8_t>(CommandTarget::Type::OBJECT)) {
+        return 0;
+    }
+
+    type = static_cast<CommandType>(data[0]);
+    target_type = static_cast<CommandTarget::Type>(data[1]);
+    flags = Get16(data + 2);
+    frame = Get32(data + 4);
+    world_x = static_cast<int32_t>(Get32(data + 8));
+    world_y = static_cast<int32_t>(Get32(data + 12));
+    cell_x = static_cast<int16_t>(Get16(data + 16));
+    cell_y = static_cast<int16_t>(Get16(data + 18));
+    object_id = Get32(data + 20);
+    uint32_t count = Get16(data + 24);
+
+    size_t offset = HEADER_SIZE;
+    units.clear();
+    units.reserve(count);
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t delta;
+        size_t used = GetVarint(data + offset, size - offset, delta);
+        // Ids strictly ascend after the first
+        if (used == 0 || (i > 0 && delta == 0) || previous + delta < previous) {
+            units.clear();
+            return 0;
+        }
+        offset += used;
+        previous += delta;
+        units.push_back(previous);
+    }
+    return offset;
+}
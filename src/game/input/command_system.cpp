@@ -4,6 +4,11 @@
 
 #include "game/input/command_system.h"
 #include "game/input/selection_manager.h"
+#include "game/input/input_latency.h"
+#include "game/input/input_state.h"
+#include "game/flow_field.h"
+#include "game/replay.h"
+#include "game/resync.h"
 #include "platform.h"
 #include <algorithm>
 #include <cstdio>
@@ -63,14 +68,19 @@ CommandSystem& CommandSystem::Instance() {
 CommandSystem::CommandSystem()
     : initialized_(false)
     , last_result_(CommandResult::SUCCESS)
+    , pending_count_(0)
+    , packet_frame_(0)
     , assign_mission_(nullptr)
+    , assign_batch_(nullptr)
     , can_perform_(nullptr)
     , is_enemy_(nullptr)
     , is_own_(nullptr)
     , is_transport_(nullptr)
     , is_building_(nullptr)
-    , on_command_(nullptr) {
+    , on_command_(nullptr)
+    , send_packets_(nullptr) {
     last_command_.Clear();
+    last_packet_.Clear();
 }
 
 CommandSystem::~CommandSystem() {
@@ -84,6 +94,9 @@ bool CommandSystem::Initialize() {
 
     last_command_.Clear();
     last_result_ = CommandResult::SUCCESS;
+    last_packet_.Clear();
+    pending_packets_.clear();
+    pending_count_ = 0;
 
     initialized_ = true;
     Platform_LogInfo("CommandSystem: Initialized");
@@ -210,25 +223,71 @@ CommandResult CommandSystem::IssueCommand(const Command& cmd) {
         return CommandResult::INVALID_TARGET;
     }
 
-    CommandResult result = ExecuteOnSelection(cmd);
+    // Replays reissue this on the same selection, which redoes what follows
+    ReplayRecorder::Instance().Record(cmd);
 
-    last_command_ = cmd;
+    // Large groups moving to one place share a flow field rather than
+    // searching a path each
+    Command issued = cmd;
+    bool is_move = cmd.type == CommandType::MOVE || cmd.type == CommandType::ATTACK_MOVE;
+    if (is_move && SelectionManager::Instance().GetSelectionCount() > FLOW_FIELD_THRESHOLD) {
+        issued.flags |= CMD_FLAG_FLOW_FIELD;
+    }
+
+    // One packet carries the order for the whole group, here and on the wire
+    auto& selection = SelectionManager::Instance();
+    packet_ids_.clear();
+    for (auto* obj : selection.GetSelection()) {
+        if (obj) packet_ids_.push_back(obj->id);
+    }
+    last_packet_.Clear();
+    last_packet_.SetCommand(issued);
+    if (issued.target.type == CommandTarget::Type::OBJECT && issued.target.object != nullptr) {
+        // Object targets come from the cursor context, which holds SelectableObjects
+        last_packet_.object_id = static_cast<const SelectableObject*>(issued.target.object)->id;
+    }
+    last_packet_.SetUnits(packet_ids_.data(), static_cast<int>(packet_ids_.size()));
+    last_packet_.frame = packet_frame_;
+
+    // A peer catching up runs the packet on the same tick
+    ResyncLog::Instance().Record(last_packet_);
+
+    CommandResult result = CommandResult::INVALID_SELECTION;
+    if (selection.HasSelection()) {
+        result = ExecuteOnUnits(issued, selection.GetSelection().data(),
+                                static_cast<int>(selection.GetSelection().size()));
+    }
+
+    last_command_ = issued;
+    last_command_.source_count = static_cast<int>(last_packet_.units.size());
     last_result_ = result;
 
+    if (result == CommandResult::SUCCESS && send_packets_) {
+        last_packet_.Write(pending_packets_);
+        pending_count_++;
+    }
+
     if (on_command_) {
-        on_command_(cmd.type, result);
+        on_command_(issued.type, result);
+    }
+
+    // Shown from the next present on (unit response, move marker)
+    if (result == CommandResult::SUCCESS) {
+        InputLatency::Instance().Mark(LatencyEffect::COMMAND, cmd.input_time_us);
     }
 
     return result;
 }
 
-CommandResult CommandSystem::ExecuteOnSelection(const Command& cmd) {
-    auto& selection = SelectionManager::Instance();
-
-    if (!selection.HasSelection()) {
-        return CommandResult::INVALID_SELECTION;
+CommandResult CommandSystem::IssueInputCommand(Command& cmd) {
+    if (cmd.input_time_us == 0) {
+        cmd.input_time_us = InputState::Instance().GetInputTimeUs();
     }
+    return IssueCommand(cmd);
+}
 
+CommandResult CommandSystem::ExecuteOnUnits(const Command& cmd,
+                                            SelectableObject* const* units, int count) {
     MissionType mission = CommandToMission(cmd.type);
     if (mission == MISSION_NONE) {
         char msg[128];
@@ -241,26 +300,48 @@ CommandResult CommandSystem::ExecuteOnSelection(const Command& cmd) {
     int success_count = 0;
     int fail_count = 0;
 
-    for (auto* obj : selection.GetSelection()) {
-        if (!obj) continue;
+    // A flow-field move gives each locomotion its own field, so its units
+    // go out one locomotion at a time; any other order is a single batch
+    bool use_fields = (cmd.flags & CMD_FLAG_FLOW_FIELD) != 0;
+    CELL field_target = XY_Cell(cmd.target.cell_x, cmd.target.cell_y);
+    int passes = use_fields ? LOCO_COUNT : 1;
+
+    for (int pass = 0; pass < passes; pass++) {
+        batch_.clear();
+        for (int i = 0; i < count; i++) {
+            SelectableObject* obj = units[i];
+            if (!obj) continue;
+            if (use_fields && Locomotion_Of(static_cast<RTTIType>(obj->rtti_type)) != pass) continue;
+
+            // Check if unit can perform this command
+            if (can_perform_ && !can_perform_(obj, cmd.type)) {
+                fail_count++;
+                continue;
+            }
+            batch_.push_back(obj);
+        }
+        if (batch_.empty()) continue;
 
-        // Check if unit can perform this command
-        if (can_perform_ && !can_perform_(obj, cmd.type)) {
-            fail_count++;
-            continue;
+        CommandTarget target = cmd.target;
+        if (use_fields && pass != LOCO_FLY) {
+            target.flow_field = FlowField::Acquire(field_target, static_cast<LocomotionType>(pass));
         }
 
-        // Assign the mission
-        if (assign_mission_) {
-            if (assign_mission_(obj, mission, cmd.target)) {
-                success_count++;
-            } else {
-                fail_count++;
+        int batch_count = static_cast<int>(batch_.size());
+        int assigned = 0;
+        if (assign_batch_) {
+            assigned = std::max(0, std::min(batch_count,
+                                             assign_batch_(batch_.data(), batch_count, mission, target)));
+        } else if (assign_mission_) {
+            for (void* unit : batch_) {
+                if (assign_mission_(unit, mission, target)) assigned++;
             }
         } else {
             // No callback - assume success for testing
-            success_count++;
+            assigned = batch_count;
         }
+        success_count += assigned;
+        fail_count += batch_count - assigned;
     }
 
     char msg[128];
@@ -275,6 +356,62 @@ CommandResult CommandSystem::ExecuteOnSelection(const Command& cmd) {
     return CommandResult::SUCCESS;
 }
 
+//=============================================================================
+// Command Packets
+//=============================================================================
+
+CommandResult CommandSystem::ExecutePacket(const CommandPacket& packet) {
+    ResyncLog::Instance().Record(packet);
+
+    Command cmd = packet.GetCommand();
+    if (cmd.type == CommandType::NONE) {
+        return CommandResult::INVALID_TARGET;
+    }
+
+    auto& selection = SelectionManager::Instance();
+    if (cmd.target.type == CommandTarget::Type::OBJECT) {
+        cmd.target.object = selection.FindObject(packet.object_id);
+        if (!cmd.target.object) {
+            return CommandResult::INVALID_TARGET;
+        }
+    }
+
+    int count = selection.FindObjects(packet.units.data(),
+                                      static_cast<int>(packet.units.size()), resolved_);
+    if (count == 0) {
+        return CommandResult::INVALID_SELECTION;
+    }
+    return ExecuteOnUnits(cmd, resolved_.data(), count);
+}
+
+int CommandSystem::ExecutePackets(const uint8_t* data, size_t size) {
+    CommandPacket packet;
+    packet.Clear();
+
+    int executed = 0;
+    size_t offset = 0;
+    while (offset < size) {
+        size_t used = packet.Read(data + offset, size - offset);
+        if (used == 0) {
+            Platform_LogInfo("CommandSystem: Malformed command packet");
+            break;
+        }
+        ExecutePacket(packet);
+        offset += used;
+        executed++;
+    }
+    return executed;
+}
+
+void CommandSystem::FlushPackets() {
+    if (pending_count_ > 0 && send_packets_) {
+        send_packets_(pending_packets_.data(), pending_packets_.size(), pending_count_);
+    }
+    pending_packets_.clear();
+    pending_count_ = 0;
+    packet_frame_++;
+}
+
 //=============================================================================
 // Convenience Command Methods
 //=============================================================================
@@ -286,7 +423,7 @@ CommandResult CommandSystem::IssueMoveCommand(int world_x, int world_y, bool que
     cmd.target.SetGround(world_x, world_y);
     if (queued) cmd.flags |= CMD_FLAG_QUEUED;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueAttackCommand(void* target, bool queued) {
@@ -298,7 +435,7 @@ CommandResult CommandSystem::IssueAttackCommand(void* target, bool queued) {
     cmd.target.SetObject(target, 0);  // ID would come from object
     if (queued) cmd.flags |= CMD_FLAG_QUEUED;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueAttackGroundCommand(int world_x, int world_y, bool queued) {
@@ -309,7 +446,7 @@ CommandResult CommandSystem::IssueAttackGroundCommand(int world_x, int world_y,
     cmd.flags |= CMD_FLAG_FORCED;
     if (queued) cmd.flags |= CMD_FLAG_QUEUED;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueGuardCommand(bool queued) {
@@ -318,7 +455,7 @@ CommandResult CommandSystem::IssueGuardCommand(bool queued) {
     cmd.type = CommandType::GUARD;
     if (queued) cmd.flags |= CMD_FLAG_QUEUED;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueStopCommand() {
@@ -326,7 +463,7 @@ CommandResult CommandSystem::IssueStopCommand() {
     cmd.Clear();
     cmd.type = CommandType::STOP;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueScatterCommand() {
@@ -334,7 +471,7 @@ CommandResult CommandSystem::IssueScatterCommand() {
     cmd.Clear();
     cmd.type = CommandType::SCATTER;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueEnterCommand(void* transport) {
@@ -345,7 +482,7 @@ CommandResult CommandSystem::IssueEnterCommand(void* transport) {
     cmd.type = CommandType::ENTER;
     cmd.target.SetObject(transport, 0);
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueDeployCommand() {
@@ -353,7 +490,7 @@ CommandResult CommandSystem::IssueDeployCommand() {
     cmd.Clear();
     cmd.type = CommandType::DEPLOY;
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueHarvestCommand(int cell_x, int cell_y) {
@@ -362,7 +499,7 @@ CommandResult CommandSystem::IssueHarvestCommand(int cell_x, int cell_y) {
     cmd.type = CommandType::HARVEST;
     cmd.target.SetCell(cell_x, cell_y);
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueSellCommand(void* building) {
@@ -373,7 +510,7 @@ CommandResult CommandSystem::IssueSellCommand(void* building) {
     cmd.type = CommandType::SELL;
     cmd.target.SetObject(building, 0);
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 CommandResult CommandSystem::IssueRepairCommand(void* building) {
@@ -384,7 +521,7 @@ CommandResult CommandSystem::IssueRepairCommand(void* building) {
     cmd.type = CommandType::REPAIR;
     cmd.target.SetObject(building, 0);
 
-    return IssueCommand(cmd);
+    return IssueInputCommand(cmd);
 }
 
 //=============================================================================
@@ -35,8 +35,15 @@ bool InputSystem::Initialize() {
 
     Platform_LogInfo("InputSystem: Initializing all subsystems...");
 
-    // Initialize GameViewport first if needed
-    GameViewport::Instance().Initialize();
+    // Initialize GameViewport first if needed, laid out for whatever
+    // resolution graphics came up at
+    GameViewport& viewport = GameViewport::Instance();
+    uint8_t* pixels = nullptr;
+    int32_t screen_w = 0, screen_h = 0, pitch = 0;
+    if (Platform_Graphics_GetBackBuffer(&pixels, &screen_w, &screen_h, &pitch) == 0) {
+        viewport.SetScreenSize(screen_w, screen_h);
+    }
+    viewport.Initialize();
 
     // Initialize subsystems in dependency order
     // Note: InputState is now initialized through Input_Init() global function
@@ -45,6 +52,9 @@ bool InputSystem::Initialize() {
         return false;
     }
 
+    // Apply key/mouse changes as queued events instead of sampling every key
+    InputState::Instance().SetEventMode(true);
+
     if (!InputMapper::Instance().Initialize()) {
         Platform_LogInfo("InputSystem: InputMapper init failed");
         return false;
@@ -65,6 +75,14 @@ bool InputSystem::Initialize() {
         return false;
     }
 
+    // Cursor queries are cached against selection and cell occupancy
+    MouseHandler::Instance().SetSelectionGenerationQuery([]() {
+        return SelectionManager::Instance().GetGeneration();
+    });
+    MouseHandler::Instance().SetCellGenerationQuery([](int cell_x, int cell_y) {
+        return SelectionManager::Instance().GetCellGeneration(cell_x, cell_y);
+    });
+
     if (!CommandSystem::Instance().Initialize()) {
         Platform_LogInfo("InputSystem: CommandSystem init failed");
         return false;
@@ -153,6 +171,9 @@ void InputSystem::Process() {
             // Minimal input processing when paused
             break;
     }
+
+    // This frame's orders leave as one batch of packets
+    CommandSystem::Instance().FlushPackets();
 }
 
 //=============================================================================
@@ -262,6 +283,7 @@ void InputSystem::HandleCommandClicks() {
             ctx, IsShiftDown(), IsCtrlDown(), IsAltDown());
 
         if (cmd.type != CommandType::NONE) {
+            cmd.input_time_us = InputState::Instance().GetMouseButtonPressTimeUs(INPUT_MOUSE_RIGHT);
             CommandSystem::Instance().IssueCommand(cmd);
         }
     }
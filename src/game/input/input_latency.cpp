@@ -0,0 +1,75 @@
+// src/game/input/input_latency.cpp
+// Input-to-present latency tracing implementation
+// Task 18h - Performance Optimization
+
+#include "game/input/input_latency.h"
+#include "platform/profiler.h"
+
+//=============================================================================
+// InputLatency Implementation
+//=============================================================================
+
+InputLatency& InputLatency::Instance() {
+    static InputLatency instance;
+    return instance;
+}
+
+InputLatency::InputLatency() {
+    for (int e = 0; e < EFFECT_COUNT; e++) {
+        histogram_ids_[e] = Profiler::instance().register_sample(
+            GetHistogramName(static_cast<LatencyEffect>(e)));
+    }
+    Reset();
+}
+
+void InputLatency::Mark(LatencyEffect effect, uint64_t input_time_us) {
+    int e = static_cast<int>(effect);
+    if (e < 0 || e >= EFFECT_COUNT || input_time_us == 0) {
+        return;
+    }
+    if (pending_us_[e] == 0 || input_time_us < pending_us_[e]) {
+        pending_us_[e] = input_time_us;
+    }
+}
+
+void InputLatency::Present(uint64_t present_time_us) {
+    for (int e = 0; e < EFFECT_COUNT; e++) {
+        uint64_t stamp = pending_us_[e];
+        if (stamp == 0) {
+            continue;
+        }
+        pending_us_[e] = 0;
+
+        double latency_ms = stamp < present_time_us ? (present_time_us - stamp) / 1000.0 : 0.0;
+        last_latency_ms_[e] = latency_ms;
+        Profiler::instance().record_histogram(histogram_ids_[e], latency_ms);
+    }
+}
+
+uint64_t InputLatency::GetPending(LatencyEffect effect) const {
+    int e = static_cast<int>(effect);
+    if (e < 0 || e >= EFFECT_COUNT) return 0;
+    return pending_us_[e];
+}
+
+double InputLatency::GetLastLatencyMs(LatencyEffect effect) const {
+    int e = static_cast<int>(effect);
+    if (e < 0 || e >= EFFECT_COUNT) return 0.0;
+    return last_latency_ms_[e];
+}
+
+const char* InputLatency::GetHistogramName(LatencyEffect effect) {
+    switch (effect) {
+        case LatencyEffect::CURSOR: return "Input Latency: Cursor";
+        case LatencyEffect::SELECTION: return "Input Latency: Selection";
+        case LatencyEffect::COMMAND: return "Input Latency: Command";
+        default: return "Input Latency";
+    }
+}
+
+void InputLatency::Reset() {
+    for (int e = 0; e < EFFECT_COUNT; e++) {
+        pending_us_[e] = 0;
+        last_latency_ms_[e] = 0.0;
+    }
+}
@@ -102,13 +102,17 @@ InputMapper& InputMapper::Instance() {
 }
 
 InputMapper::InputMapper()
-    : debug_enabled_(false)
+    : full_pass_(true)
+    , debug_enabled_(false)
     , initialized_(false) {
     memset(bindings_, 0, sizeof(bindings_));
-    memset(action_active_, 0, sizeof(action_active_));
-    memset(action_triggered_, 0, sizeof(action_triggered_));
-    memset(action_released_, 0, sizeof(action_released_));
-    memset(action_active_prev_, 0, sizeof(action_active_prev_));
+    memset(binding_table_, 0, sizeof(binding_table_));
+    memset(key_actions_, 0, sizeof(key_actions_));
+    memset(&continuous_, 0, sizeof(continuous_));
+    memset(&active_, 0, sizeof(active_));
+    memset(&triggered_, 0, sizeof(triggered_));
+    memset(&released_, 0, sizeof(released_));
+    memset(keys_down_, 0, sizeof(keys_down_));
 }
 
 InputMapper::~InputMapper() {
@@ -251,74 +255,130 @@ void InputMapper::SetupDefaultBindings() {
     Bind(GameAction::DEBUG_ADD_MONEY,     KEY_M, MOD_CTRL | MOD_SHIFT, MOD_NONE, false);
     Bind(GameAction::DEBUG_INSTANT_BUILD, KEY_B, MOD_CTRL | MOD_SHIFT, MOD_NONE, false);
     Bind(GameAction::DEBUG_GOD_MODE,      KEY_G, MOD_CTRL | MOD_SHIFT, MOD_NONE, false);
-}
-
-void InputMapper::ProcessFrame() {
-    if (!initialized_) {
-        return;
-    }
-
-    // Save previous states
-    memcpy(action_active_prev_, action_active_, sizeof(action_active_));
-
-    // Clear triggered/released states
-    memset(action_triggered_, 0, sizeof(action_triggered_));
-    memset(action_released_, 0, sizeof(action_released_));
 
-    // Update all action states
-    UpdateActionStates();
+    CompileBindings();
 }
 
-void InputMapper::UpdateActionStates() {
-    InputState& input = InputState::Instance();
-    uint8_t current_mods = input.GetModifiers();
+void InputMapper::CompileBindings() {
+    memset(binding_table_, 0, sizeof(binding_table_));
+    memset(key_actions_, 0, sizeof(key_actions_));
+    memset(&continuous_, 0, sizeof(continuous_));
 
     for (int i = 0; i < MAX_ACTIONS; i++) {
-        GameAction action = static_cast<GameAction>(i);
-
-        // Skip debug actions if not enabled
-        if (IsDebugAction(action) && !debug_enabled_) {
-            action_active_[i] = false;
+        const KeyBinding& binding = bindings_[i];
+        int key = binding.key_code;
+        if (key <= 0 || key >= KEY_CODE_MAX) {
             continue;
         }
 
-        const KeyBinding& binding = bindings_[i];
+        uint64_t bit = 1ull << (i & 63);
+        int word = i >> 6;
+        key_actions_[key].bits[word] |= bit;
+        if (binding.is_continuous) {
+            continuous_.bits[word] |= bit;
+        }
 
-        // Skip unbound actions
-        if (binding.key_code == 0) {
-            action_active_[i] = false;
+        // A disabled debug action stays out of the table
+        if (IsDebugAction(static_cast<GameAction>(i)) && !debug_enabled_) {
             continue;
         }
-
-        // Check if required modifiers are present
-        bool mods_ok = (current_mods & binding.required_mods) == binding.required_mods;
-
-        // Check if excluded modifiers are absent
-        if (binding.excluded_mods != MOD_NONE) {
-            if (current_mods & binding.excluded_mods) {
-                mods_ok = false;
+        for (int mods = 0; mods < MOD_COMBOS; mods++) {
+            if ((mods & binding.required_mods) == binding.required_mods &&
+                (mods & binding.excluded_mods) == 0) {
+                binding_table_[mods][key].bits[word] |= bit;
             }
         }
+    }
 
-        // Check key state
-        bool key_down = input.IsKeyDown(binding.key_code);
-        bool key_pressed = input.WasKeyPressed(binding.key_code);
+    full_pass_ = true;
+}
 
-        if (binding.is_continuous) {
-            // Continuous action - active while key held with correct mods
-            action_active_[i] = key_down && mods_ok;
-        } else {
-            // One-shot action - triggered on key press with correct mods
-            action_active_[i] = key_pressed && mods_ok;
+void InputMapper::ProcessFrame() {
+    if (!initialized_) {
+        return;
+    }
+
+    // A modifier change can flip any binding that uses or excludes it
+    InputState& input = InputState::Instance();
+    bool rescan = full_pass_ || input.IsFullUpdate() || input.ModifiersChanged();
+    ResolveActions(rescan);
+    full_pass_ = false;
+}
+
+void InputMapper::ResolveActions(bool rescan) {
+    InputState& input = InputState::Instance();
+    const ActionMask* table = binding_table_[input.GetModifiers() & (MOD_COMBOS - 1)];
+
+    ActionMask prev = active_;
+    ActionMask held;
+    ActionMask pressed = {};
+
+    // Track the held keys from the changed list, or resample them all
+    if (input.IsFullUpdate()) {
+        memset(keys_down_, 0, sizeof(keys_down_));
+        for (int key = 1; key < KEY_CODE_MAX; key++) {
+            if (input.IsKeyDown(key)) {
+                keys_down_[key >> 6] |= 1ull << (key & 63);
+            }
         }
+    } else {
+        for (int c = 0; c < input.GetChangedKeyCount(); c++) {
+            int key = input.GetChangedKey(c);
+            uint64_t bit = 1ull << (key & 63);
+            if (input.IsKeyDown(key)) {
+                keys_down_[key >> 6] |= bit;
+            } else {
+                keys_down_[key >> 6] &= ~bit;
+            }
+        }
+    }
 
-        // Detect triggered/released
-        if (action_active_[i] && !action_active_prev_[i]) {
-            action_triggered_[i] = true;
+    if (rescan) {
+        // Every held key, looked up afresh under the current modifiers
+        memset(&held, 0, sizeof(held));
+        for (int w = 0; w < KEY_CODE_MAX / 64; w++) {
+            for (uint64_t down = keys_down_[w]; down != 0; down &= down - 1) {
+                int key = (w << 6) | __builtin_ctzll(down);
+                for (int a = 0; a < ACTION_WORDS; a++) {
+                    held.bits[a] |= table[key].bits[a];
+                }
+                if (input.WasKeyPressed(key)) {
+                    for (int a = 0; a < ACTION_WORDS; a++) {
+                        pressed.bits[a] |= table[key].bits[a];
+                    }
+                }
+            }
         }
-        if (!action_active_[i] && action_active_prev_[i]) {
-            action_released_[i] = true;
+        for (int a = 0; a < ACTION_WORDS; a++) {
+            held.bits[a] &= continuous_.bits[a];
         }
+    } else {
+        // Only the changed keys can differ; the rest keep their held actions
+        for (int a = 0; a < ACTION_WORDS; a++) {
+            held.bits[a] = active_.bits[a] & continuous_.bits[a];
+        }
+        for (int c = 0; c < input.GetChangedKeyCount(); c++) {
+            int key = input.GetChangedKey(c);
+            bool down = input.IsKeyDown(key);
+            for (int a = 0; a < ACTION_WORDS; a++) {
+                held.bits[a] &= ~key_actions_[key].bits[a];
+                if (down) {
+                    held.bits[a] |= table[key].bits[a] & continuous_.bits[a];
+                }
+            }
+            if (input.WasKeyPressed(key)) {
+                for (int a = 0; a < ACTION_WORDS; a++) {
+                    pressed.bits[a] |= table[key].bits[a];
+                }
+            }
+        }
+    }
+
+    // Continuous actions are active while held, one-shots on the press
+    for (int a = 0; a < ACTION_WORDS; a++) {
+        active_.bits[a] = held.bits[a] | (pressed.bits[a] & ~continuous_.bits[a]);
+        triggered_.bits[a] = active_.bits[a] & ~prev.bits[a];
+        released_.bits[a] = prev.bits[a] & ~active_.bits[a];
     }
 }
 
@@ -329,19 +389,19 @@ void InputMapper::UpdateActionStates() {
 bool InputMapper::IsActionActive(GameAction action) const {
     int idx = static_cast<int>(action);
     if (idx < 0 || idx >= MAX_ACTIONS) return false;
-    return action_active_[idx];
+    return (active_.bits[idx >> 6] >> (idx & 63)) & 1;
 }
 
 bool InputMapper::WasActionTriggered(GameAction action) const {
     int idx = static_cast<int>(action);
     if (idx < 0 || idx >= MAX_ACTIONS) return false;
-    return action_triggered_[idx];
+    return (triggered_.bits[idx >> 6] >> (idx & 63)) & 1;
 }
 
 bool InputMapper::WasActionReleased(GameAction action) const {
     int idx = static_cast<int>(action);
     if (idx < 0 || idx >= MAX_ACTIONS) return false;
-    return action_released_[idx];
+    return (released_.bits[idx >> 6] >> (idx & 63)) & 1;
 }
 
 GameAction InputMapper::GetActiveScrollAction() const {
@@ -355,7 +415,7 @@ GameAction InputMapper::GetActiveScrollAction() const {
 GameAction InputMapper::GetTriggeredGroupSelectAction() const {
     for (int i = static_cast<int>(GameAction::GROUP_SELECT_1);
          i <= static_cast<int>(GameAction::GROUP_SELECT_0); i++) {
-        if (action_triggered_[i]) {
+        if ((triggered_.bits[i >> 6] >> (i & 63)) & 1) {
             return static_cast<GameAction>(i);
         }
     }
@@ -365,7 +425,7 @@ GameAction InputMapper::GetTriggeredGroupSelectAction() const {
 GameAction InputMapper::GetTriggeredGroupCreateAction() const {
     for (int i = static_cast<int>(GameAction::GROUP_CREATE_1);
          i <= static_cast<int>(GameAction::GROUP_CREATE_0); i++) {
-        if (action_triggered_[i]) {
+        if ((triggered_.bits[i >> 6] >> (i & 63)) & 1) {
             return static_cast<GameAction>(i);
         }
     }
@@ -375,7 +435,7 @@ GameAction InputMapper::GetTriggeredGroupCreateAction() const {
 GameAction InputMapper::GetTriggeredGroupAddAction() const {
     for (int i = static_cast<int>(GameAction::GROUP_ADD_1);
          i <= static_cast<int>(GameAction::GROUP_ADD_0); i++) {
-        if (action_triggered_[i]) {
+        if ((triggered_.bits[i >> 6] >> (i & 63)) & 1) {
             return static_cast<GameAction>(i);
         }
     }
@@ -394,6 +454,7 @@ bool InputMapper::RebindAction(GameAction action, int new_key, uint8_t new_mods)
 
     bindings_[idx].key_code = new_key;
     bindings_[idx].required_mods = new_mods;
+    CompileBindings();
     return true;
 }
 
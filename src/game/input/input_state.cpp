@@ -3,8 +3,10 @@
 // Task 16a - Input Foundation
 
 #include "game/input/input_state.h"
+#include "game/input/input_latency.h"
 #include "game/viewport.h"
 #include "platform.h"
+#include "platform/log.h"
 #include <cstring>
 #include <algorithm>
 
@@ -15,7 +17,12 @@
 void KeyboardState::Clear() {
     memset(keys_down, 0, sizeof(keys_down));
     memset(keys_down_prev, 0, sizeof(keys_down_prev));
+    memset(key_press_time_us, 0, sizeof(key_press_time_us));
+    memset(changed_keys, 0, sizeof(changed_keys));
+    memset(key_listed, 0, sizeof(key_listed));
+    changed_count = 0;
     modifiers = MOD_NONE;
+    modifiers_changed = false;
     memset(key_buffer, 0, sizeof(key_buffer));
     buffer_head = 0;
     buffer_tail = 0;
@@ -23,6 +30,50 @@ void KeyboardState::Clear() {
 
 void KeyboardState::SavePreviousState() {
     memcpy(keys_down_prev, keys_down, sizeof(keys_down));
+    memset(key_listed, 0, sizeof(key_listed));
+    changed_count = 0;
+    modifiers_changed = false;
+}
+
+void KeyboardState::SavePreviousChanges() {
+    for (int i = 0; i < changed_count; i++) {
+        int k = changed_keys[i];
+        keys_down_prev[k] = keys_down[k];
+        key_listed[k] = false;
+    }
+    changed_count = 0;
+    modifiers_changed = false;
+}
+
+void KeyboardState::SetKey(int key_code, bool down) {
+    if (key_code < 0 || key_code >= KEY_CODE_MAX || keys_down[key_code] == down) {
+        return;
+    }
+    keys_down[key_code] = down;
+    if (!key_listed[key_code]) {
+        key_listed[key_code] = true;
+        changed_keys[changed_count++] = static_cast<uint8_t>(key_code);
+    }
+    if (key_code == KEY_SHIFT || key_code == KEY_CONTROL || key_code == KEY_ALT) {
+        UpdateModifiers();
+    }
+}
+
+void KeyboardState::UpdateModifiers() {
+    uint8_t mods = MOD_NONE;
+    if (keys_down[KEY_SHIFT]) {
+        mods |= MOD_SHIFT;
+    }
+    if (keys_down[KEY_CONTROL]) {
+        mods |= MOD_CTRL;
+    }
+    if (keys_down[KEY_ALT]) {
+        mods |= MOD_ALT;
+    }
+    if (mods != modifiers) {
+        modifiers = mods;
+        modifiers_changed = true;
+    }
 }
 
 void KeyboardState::BufferKey(int key_code) {
@@ -63,6 +114,7 @@ void MouseState::Clear() {
 
     memset(buttons_down, 0, sizeof(buttons_down));
     memset(buttons_down_prev, 0, sizeof(buttons_down_prev));
+    memset(button_press_time_us, 0, sizeof(button_press_time_us));
     memset(last_click_time, 0, sizeof(last_click_time));
     memset(last_click_x, 0, sizeof(last_click_x));
     memset(last_click_y, 0, sizeof(last_click_y));
@@ -115,6 +167,12 @@ InputState& InputState::Instance() {
 InputState::InputState()
     : initialized_(false)
     , window_scale_(2)
+    , event_mode_(false)
+    , resync_(false)
+    , full_update_(true)
+    , event_count_(0)
+    , update_time_us_(0)
+    , input_time_us_(0)
     , current_time_ms_(0) {
     keyboard_.Clear();
     mouse_.Clear();
@@ -152,6 +210,11 @@ void InputState::Shutdown() {
     }
 
     Platform_LogInfo("InputState: Shutting down...");
+    if (event_mode_) {
+        Platform_Input_EnableEvents(false);
+        event_mode_ = false;
+    }
+    full_update_ = true;
     Platform_Input_Shutdown();
 
     keyboard_.Clear();
@@ -165,19 +228,134 @@ void InputState::Update() {
         return;
     }
 
-    // Get current time for double-click detection
-    current_time_ms_ = Platform_GetTicks();
-
-    // Save previous states for edge detection
-    keyboard_.SavePreviousState();
+    // Same clock as the event timestamps, so double-clicks can be timed
+    // from either
+    update_time_us_ = Platform_Input_GetTimeUs();
+    current_time_ms_ = update_time_us_ / 1000;
+
+    // Save previous states for edge detection; after an event frame only
+    // the keys that changed differ from their previous state
+    if (full_update_) {
+        keyboard_.SavePreviousState();
+    } else {
+        keyboard_.SavePreviousChanges();
+    }
     mouse_.SavePreviousState();
+    event_count_ = 0;
+    input_time_us_ = 0;
 
     // Update platform input state
     Platform_Input_Update();
 
-    // Sample new states
-    UpdateKeyboardState();
-    UpdateMouseState();
+    if (event_mode_ && resync_) {
+        // Start the queue from the state sampled below
+        Platform_Input_EnableEvents(true);
+        resync_ = false;
+        full_update_ = true;
+    } else {
+        full_update_ = !event_mode_ || !ApplyPlatformEvents();
+    }
+
+    if (full_update_) {
+        // Sample new states; no event times, so the sample is the stamp
+        int prev_x = mouse_.raw_x;
+        int prev_y = mouse_.raw_y;
+        UpdateKeyboardState();
+        UpdateMouseState();
+        input_time_us_ = update_time_us_;
+        if (mouse_.raw_x != prev_x || mouse_.raw_y != prev_y) {
+            InputLatency::Instance().Mark(LatencyEffect::CURSOR, update_time_us_);
+        }
+    } else {
+        UpdateMouseCoordinates();
+        UpdateDragState();
+    }
+}
+
+void InputState::SetEventMode(bool enabled) {
+    if (enabled == event_mode_) {
+        return;
+    }
+    event_mode_ = enabled;
+    resync_ = enabled;
+    if (!enabled) {
+        Platform_Input_EnableEvents(false);
+    }
+}
+
+bool InputState::ApplyPlatformEvents() {
+    static constexpr int EVENT_BATCH = 64;
+    InputEvent events[EVENT_BATCH];
+
+    int count;
+    do {
+        count = Platform_Input_PollEvents(events, EVENT_BATCH);
+        if (count < 0) {
+            // Events were dropped; the caller resamples everything
+            LOG_DEBUG("InputState: Event queue overflowed, resyncing");
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            ApplyEvent(events[i]);
+        }
+    } while (count == EVENT_BATCH);
+
+    return true;
+}
+
+void InputState::ApplyEvent(const InputEvent& event) {
+    event_count_++;
+    if (input_time_us_ == 0 || event.time_us < input_time_us_) {
+        input_time_us_ = event.time_us;
+    }
+
+    switch (event.kind) {
+        case INPUT_EVENT_TYPE_KEY_DOWN:
+            if (event.code >= 0 && event.code < KEY_CODE_MAX) {
+                keyboard_.SetKey(event.code, true);
+                keyboard_.key_press_time_us[event.code] = event.time_us;
+                keyboard_.BufferKey(event.code);
+            }
+            break;
+
+        case INPUT_EVENT_TYPE_KEY_UP:
+            keyboard_.SetKey(event.code, false);
+            break;
+
+        case INPUT_EVENT_TYPE_MOUSE_DOWN:
+        case INPUT_EVENT_TYPE_MOUSE_UP: {
+            int b = event.code;
+            if (b < 0 || b >= INPUT_MOUSE_MAX) {
+                break;
+            }
+            SetMousePosition(event.x, event.y);
+            bool down = event.kind == INPUT_EVENT_TYPE_MOUSE_DOWN;
+            mouse_.buttons_down[b] = down;
+            if (down) {
+                mouse_.button_press_time_us[b] = event.time_us;
+                CheckDoubleClick(b, event.time_us / 1000);
+            }
+            break;
+        }
+
+        case INPUT_EVENT_TYPE_MOUSE_MOVE:
+            SetMousePosition(event.x, event.y);
+            InputLatency::Instance().Mark(LatencyEffect::CURSOR, event.time_us);
+            break;
+
+        case INPUT_EVENT_TYPE_MOUSE_WHEEL:
+            mouse_.wheel_delta += event.y;
+            break;
+    }
+}
+
+void InputState::SetMousePosition(int raw_x, int raw_y) {
+    mouse_.raw_x = raw_x;
+    mouse_.raw_y = raw_y;
+
+    // Apply window scale to get screen coordinates
+    mouse_.screen_x = raw_x / window_scale_;
+    mouse_.screen_y = raw_y / window_scale_;
 }
 
 void InputState::UpdateKeyboardState() {
@@ -188,6 +366,7 @@ void InputState::UpdateKeyboardState() {
     }
 
     // Update modifier flags
+    uint8_t prev_mods = keyboard_.modifiers;
     keyboard_.modifiers = MOD_NONE;
     if (Platform_Key_ShiftDown()) {
         keyboard_.modifiers |= MOD_SHIFT;
@@ -199,9 +378,12 @@ void InputState::UpdateKeyboardState() {
         keyboard_.modifiers |= MOD_ALT;
     }
 
+    keyboard_.modifiers_changed = keyboard_.modifiers != prev_mods;
+
     // Buffer any newly pressed keys (for text input)
     for (int k = 0; k < KEY_CODE_MAX; k++) {
         if (keyboard_.keys_down[k] && !keyboard_.keys_down_prev[k]) {
+            keyboard_.key_press_time_us[k] = update_time_us_;
             keyboard_.BufferKey(k);
         }
     }
@@ -211,12 +393,7 @@ void InputState::UpdateMouseState() {
     // Get raw position from platform
     int32_t raw_x, raw_y;
     Platform_Mouse_GetPosition(&raw_x, &raw_y);
-    mouse_.raw_x = raw_x;
-    mouse_.raw_y = raw_y;
-
-    // Apply window scale to get screen coordinates
-    mouse_.screen_x = raw_x / window_scale_;
-    mouse_.screen_y = raw_y / window_scale_;
+    SetMousePosition(raw_x, raw_y);
 
     // Update button states
     mouse_.buttons_down[INPUT_MOUSE_LEFT] = Platform_Mouse_IsPressed(MOUSE_BUTTON_LEFT);
@@ -235,7 +412,8 @@ void InputState::UpdateMouseState() {
     // Check for double clicks
     for (int b = 0; b < INPUT_MOUSE_MAX; b++) {
         if (WasMouseButtonPressed(b)) {
-            CheckDoubleClick(b);
+            mouse_.button_press_time_us[b] = update_time_us_;
+            CheckDoubleClick(b, current_time_ms_);
         }
     }
 }
@@ -303,12 +481,12 @@ void InputState::UpdateDragState() {
     }
 }
 
-void InputState::CheckDoubleClick(int button) {
+void InputState::CheckDoubleClick(int button, uint64_t time_ms) {
     if (button < 0 || button >= INPUT_MOUSE_MAX) {
         return;
     }
 
-    uint64_t now = current_time_ms_;
+    uint64_t now = time_ms;
     uint64_t last = mouse_.last_click_time[button];
 
     // Check time window
@@ -409,6 +587,20 @@ bool InputState::WasMouseDoubleClicked(int button) const {
     return mouse_.double_clicked[button];
 }
 
+uint64_t InputState::GetKeyPressTimeUs(int key_code) const {
+    if (key_code < 0 || key_code >= KEY_CODE_MAX) {
+        return 0;
+    }
+    return keyboard_.key_press_time_us[key_code];
+}
+
+uint64_t InputState::GetMouseButtonPressTimeUs(int button) const {
+    if (button < 0 || button >= INPUT_MOUSE_MAX) {
+        return 0;
+    }
+    return mouse_.button_press_time_us[button];
+}
+
 void InputState::GetDragRect(int& x1, int& y1, int& x2, int& y2) const {
     x1 = std::min(mouse_.drag_start_x, mouse_.drag_current_x);
     y1 = std::min(mouse_.drag_start_y, mouse_.drag_current_y);
@@ -185,7 +185,16 @@ MouseHandler::MouseHandler()
     , get_object_at_(nullptr)
     , is_passable_(nullptr)
     , is_visible_(nullptr)
-    , has_selection_(nullptr) {
+    , has_selection_(nullptr)
+    , selection_generation_(nullptr)
+    , cell_generation_(nullptr)
+    , object_cache_valid_(false)
+    , cached_cell_x_(0), cached_cell_y_(0)
+    , cached_cell_generation_(0)
+    , cached_object_(nullptr)
+    , selection_cache_valid_(false)
+    , cached_selection_generation_(0)
+    , cached_has_selection_(false) {
     drag_.Clear();
     context_.Clear();
 }
@@ -202,6 +211,7 @@ bool MouseHandler::Initialize() {
     drag_.Clear();
     context_.Clear();
     cursor_shape_ = CursorShape::ARROW;
+    InvalidateContext();
 
     initialized_ = true;
     Platform_LogInfo("MouseHandler: Initialized");
@@ -243,8 +253,9 @@ void MouseHandler::UpdatePosition() {
     // Clamp to screen bounds
     if (screen_x_ < 0) screen_x_ = 0;
     if (screen_y_ < 0) screen_y_ = 0;
-    if (screen_x_ >= VP_SCREEN_WIDTH) screen_x_ = VP_SCREEN_WIDTH - 1;
-    if (screen_y_ >= VP_SCREEN_HEIGHT) screen_y_ = VP_SCREEN_HEIGHT - 1;
+    const GameViewport& screen = GameViewport::Instance();
+    if (screen_x_ >= screen.GetScreenWidth()) screen_x_ = screen.GetScreenWidth() - 1;
+    if (screen_y_ >= screen.GetScreenHeight()) screen_y_ = screen.GetScreenHeight() - 1;
 
     // Convert to world coordinates (only in tactical area)
     if (IsInTacticalArea()) {
@@ -271,9 +282,11 @@ void MouseHandler::UpdateRegion() {
     // Determine which screen region the mouse is in
     if (screen_y_ < VP_TAB_HEIGHT) {
         current_region_ = ScreenRegion::TAB_BAR;
-    } else if (screen_x_ >= TACTICAL_WIDTH) {
-        // In sidebar area - determine specific region
-        if (screen_x_ >= RADAR_X && screen_x_ < RADAR_X + RADAR_SIZE &&
+    } else if (screen_x_ >= GameViewport::Instance().width) {
+        // In sidebar area - determine specific region (the sidebar sits
+        // against the right edge, whatever the screen width)
+        int radar_x = GameViewport::Instance().width + (RADAR_X - TACTICAL_WIDTH);
+        if (screen_x_ >= radar_x && screen_x_ < radar_x + RADAR_SIZE &&
             screen_y_ >= RADAR_Y && screen_y_ < RADAR_Y + RADAR_SIZE) {
             current_region_ = ScreenRegion::RADAR;
         } else {
@@ -362,9 +375,23 @@ void MouseHandler::UpdateContext() {
         context_.is_visible = is_visible_(cell_x_, cell_y_);
     }
 
-    // Query object at position
+    // Query object at position, unless this cell's occupants are unchanged
     if (get_object_at_) {
-        context_.object = get_object_at_(cell_x_, cell_y_);
+        bool cached = false;
+        uint32_t generation = 0;
+        if (cell_generation_) {
+            generation = cell_generation_(cell_x_, cell_y_);
+            cached = object_cache_valid_ && cached_cell_x_ == cell_x_ &&
+                     cached_cell_y_ == cell_y_ && cached_cell_generation_ == generation;
+        }
+        if (!cached) {
+            cached_object_ = get_object_at_(cell_x_, cell_y_);
+            cached_cell_x_ = cell_x_;
+            cached_cell_y_ = cell_y_;
+            cached_cell_generation_ = generation;
+            object_cache_valid_ = cell_generation_ != nullptr;
+        }
+        context_.object = cached_object_;
         if (context_.object) {
             // TODO: Fill in object details when integrated with game code
             context_.is_selectable = true;
@@ -398,7 +425,20 @@ CursorContextType MouseHandler::DetermineContextType() {
 }
 
 void MouseHandler::UpdateCursorShape() {
-    bool has_sel = has_selection_ ? has_selection_() : false;
+    bool has_sel = false;
+    if (has_selection_) {
+        if (!selection_generation_) {
+            has_sel = has_selection_();
+        } else {
+            uint32_t generation = selection_generation_();
+            if (!selection_cache_valid_ || cached_selection_generation_ != generation) {
+                cached_has_selection_ = has_selection_();
+                cached_selection_generation_ = generation;
+                selection_cache_valid_ = true;
+            }
+            has_sel = cached_has_selection_;
+        }
+    }
     cursor_shape_ = GetCursorShapeForContext(context_, has_sel);
 }
 
@@ -411,11 +451,12 @@ bool MouseHandler::IsAtScreenEdge(int& dx, int& dy) const {
     }
 
     // Check edges
+    const GameViewport& vp = GameViewport::Instance();
     if (screen_x_ < EDGE_ZONE) dx = -1;
-    else if (screen_x_ >= TACTICAL_WIDTH - EDGE_ZONE) dx = 1;
+    else if (screen_x_ >= vp.width - EDGE_ZONE) dx = 1;
 
     if (screen_y_ < VP_TAB_HEIGHT + EDGE_ZONE) dy = -1;
-    else if (screen_y_ >= VP_SCREEN_HEIGHT - EDGE_ZONE) dy = 1;
+    else if (screen_y_ >= vp.GetScreenHeight() - EDGE_ZONE) dy = 1;
 
     return dx != 0 || dy != 0;
 }
@@ -30,8 +30,11 @@ ScrollProcessor::ScrollProcessor()
     , combined_direction_(SCROLLDIR_NONE)
     , scroll_delta_x_(0)
     , scroll_delta_y_(0)
+    , prefetch_frames_(ScrollMotion::DEFAULT_LOOKAHEAD_FRAMES)
+    , prefetched_count_(0)
     , apply_scroll_(nullptr)
-    , can_scroll_(nullptr) {
+    , can_scroll_(nullptr)
+    , prefetch_(nullptr) {
 }
 
 ScrollProcessor::~ScrollProcessor() {
@@ -47,6 +50,8 @@ bool ScrollProcessor::Initialize() {
     keyboard_direction_ = SCROLLDIR_NONE;
     combined_direction_ = SCROLLDIR_NONE;
     scroll_delta_x_ = scroll_delta_y_ = 0;
+    motion_.Reset();
+    prefetched_count_ = 0;
 
     initialized_ = true;
     Platform_LogInfo("ScrollProcessor: Initialized");
@@ -75,14 +80,17 @@ void ScrollProcessor::ProcessFrame() {
     combined_direction_ = static_cast<ScrollDir>(
         static_cast<uint8_t>(edge_direction_) | static_cast<uint8_t>(keyboard_direction_));
 
-    // Calculate and apply scroll if any direction active
-    if (combined_direction_ != SCROLLDIR_NONE) {
+    // Calculate and apply scroll; with no direction the motion eases out
+    if (combined_direction_ != SCROLLDIR_NONE || motion_.IsMoving()) {
         // Check if fast scroll (Shift held)
-        bool fast = InputMapper::Instance().IsActionActive(GameAction::SCROLL_FAST);
+        bool fast = combined_direction_ != SCROLLDIR_NONE &&
+                    InputMapper::Instance().IsActionActive(GameAction::SCROLL_FAST);
 
         CalculateScrollDelta(combined_direction_, fast);
         ApplyScroll();
     }
+
+    PrefetchAhead();
 }
 
 //=============================================================================
@@ -102,17 +110,18 @@ ScrollDir ScrollProcessor::DetectEdgeScroll() {
 
     uint8_t direction = SCROLLDIR_NONE;
 
-    // Check horizontal edges (within tactical area only, x < TACTICAL_WIDTH)
+    // Check horizontal edges (within tactical area only, x < viewport width)
+    const GameViewport& vp = GameViewport::Instance();
     if (sx < edge_zone_size_) {
         direction |= SCROLLDIR_W;
-    } else if (sx >= TACTICAL_WIDTH - edge_zone_size_) {
+    } else if (sx >= vp.width - edge_zone_size_) {
         direction |= SCROLLDIR_E;
     }
 
     // Check vertical edges (accounting for tab bar)
     if (sy < VP_TAB_HEIGHT + edge_zone_size_) {
         direction |= SCROLLDIR_N;
-    } else if (sy >= VP_SCREEN_HEIGHT - edge_zone_size_) {
+    } else if (sy >= vp.GetScreenHeight() - edge_zone_size_) {
         direction |= SCROLLDIR_S;
     }
 
@@ -150,27 +159,30 @@ ScrollDir ScrollProcessor::DetectKeyboardScroll() {
 //=============================================================================
 
 void ScrollProcessor::CalculateScrollDelta(ScrollDir dir, bool fast) {
-    int speed = fast ? scroll_speed_fast_ : scroll_speed_normal_;
+    float speed = static_cast<float>(fast ? scroll_speed_fast_ : scroll_speed_normal_);
 
-    scroll_delta_x_ = 0;
-    scroll_delta_y_ = 0;
+    float target_x = 0.0f;
+    float target_y = 0.0f;
 
     // Horizontal
     if (dir & SCROLLDIR_W) {
-        scroll_delta_x_ = -speed;
+        target_x = -speed;
     } else if (dir & SCROLLDIR_E) {
-        scroll_delta_x_ = speed;
+        target_x = speed;
     }
 
     // Vertical
     if (dir & SCROLLDIR_N) {
-        scroll_delta_y_ = -speed;
+        target_y = -speed;
     } else if (dir & SCROLLDIR_S) {
-        scroll_delta_y_ = speed;
+        target_y = speed;
     }
 
     // Note: Diagonal movement is faster by sqrt(2) but most RTS games don't normalize
     // Could optionally divide by 1.414 for true diagonal normalization
+
+    // Speed eases toward the target; fractions of a pixel carry over
+    motion_.Step(target_x, target_y, scroll_delta_x_, scroll_delta_y_);
 }
 
 void ScrollProcessor::ApplyScroll() {
@@ -178,8 +190,10 @@ void ScrollProcessor::ApplyScroll() {
         return;
     }
 
-    // Check if scroll is allowed
+    // Check if scroll is allowed; a blocked scroll stops dead
     if (can_scroll_ && !can_scroll_(scroll_delta_x_, scroll_delta_y_)) {
+        motion_.Reset();
+        scroll_delta_x_ = scroll_delta_y_ = 0;
         return;
     }
 
@@ -193,6 +207,26 @@ void ScrollProcessor::ApplyScroll() {
     }
 }
 
+void ScrollProcessor::PrefetchAhead() {
+    if (!prefetch_ || !motion_.IsMoving()) {
+        prefetched_count_ = 0;
+        return;
+    }
+
+    const GameViewport& vp = GameViewport::Instance();
+    ScrollCellRange ranges[2];
+    int count = motion_.LeadCells(vp.x, vp.y, vp.width, vp.height, prefetch_frames_, ranges);
+
+    for (int i = 0; i < count; i++) {
+        if (i < prefetched_count_ && ranges[i] == prefetched_[i]) {
+            continue;
+        }
+        prefetch_(ranges[i].start_x, ranges[i].start_y, ranges[i].end_x, ranges[i].end_y);
+        prefetched_[i] = ranges[i];
+    }
+    prefetched_count_ = count;
+}
+
 //=============================================================================
 // Configuration
 //=============================================================================
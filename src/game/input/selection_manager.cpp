@@ -3,6 +3,9 @@
 // Task 16e - Selection System
 
 #include "game/input/selection_manager.h"
+#include "game/input/input_latency.h"
+#include "game/input/input_state.h"
+#include "game/viewport.h"
 #include "platform.h"
 #include <algorithm>
 #include <cstdio>
@@ -35,6 +38,21 @@ static bool SelectionPriorityCompare(const SelectableObject* a, const Selectable
     return GetSelectionPriority(a) > GetSelectionPriority(b);
 }
 
+//=============================================================================
+// Object Enumeration
+//=============================================================================
+
+template <typename Fn>
+void SelectionManager::ForEachObject(Fn fn) const {
+    if (get_all_objects_) {
+        for (auto* obj : get_all_objects_()) {
+            fn(obj);
+        }
+        return;
+    }
+    grid_.ForEach([&](SelectableObject* obj, int, int) { fn(obj); });
+}
+
 //=============================================================================
 // SelectionManager Singleton
 //=============================================================================
@@ -47,11 +65,13 @@ SelectionManager& SelectionManager::Instance() {
 SelectionManager::SelectionManager()
     : initialized_(false)
     , player_house_(0)
+    , generation_(0)
+    , cell_generations_()
+    , group_sums_()
     , on_selection_changed_(nullptr)
     , get_objects_in_rect_(nullptr)
     , get_object_at_(nullptr)
     , get_all_objects_(nullptr) {
-    selected_.reserve(MAX_SELECTION);
 }
 
 SelectionManager::~SelectionManager() {
@@ -64,12 +84,14 @@ bool SelectionManager::Initialize() {
     Platform_LogInfo("SelectionManager: Initializing...");
 
     selected_.clear();
-    selected_.reserve(MAX_SELECTION);
+    selected_flags_.clear();
 
     // Clear all control groups
     for (auto& group : groups_) {
         group.clear();
     }
+    grouped_.clear();
+    group_sums_.fill(GroupSums{0, 0});
 
     initialized_ = true;
     Platform_LogInfo("SelectionManager: Initialized");
@@ -82,9 +104,19 @@ void SelectionManager::Shutdown() {
     Platform_LogInfo("SelectionManager: Shutting down");
 
     selected_.clear();
+    selected_flags_.clear();
     for (auto& group : groups_) {
         group.clear();
     }
+    grouped_.clear();
+    group_sums_.fill(GroupSums{0, 0});
+    grid_.Clear();
+
+    // Anything cached against the old state is stale
+    generation_++;
+    for (uint32_t& cell : cell_generations_) {
+        cell++;
+    }
 
     initialized_ = false;
 }
@@ -96,6 +128,7 @@ void SelectionManager::Shutdown() {
 void SelectionManager::Clear() {
     if (selected_.empty()) return;
 
+    UnmarkSelection();
     selected_.clear();
     NotifySelectionChanged(SelectionEvent::CLEARED);
 }
@@ -103,8 +136,10 @@ void SelectionManager::Clear() {
 void SelectionManager::Select(SelectableObject* obj) {
     if (!CanSelect(obj)) return;
 
+    UnmarkSelection();
     selected_.clear();
     selected_.push_back(obj);
+    MarkSelection();
     NotifySelectionChanged(SelectionEvent::REPLACED);
 }
 
@@ -118,6 +153,7 @@ void SelectionManager::AddToSelection(SelectableObject* obj) {
     if (static_cast<int>(selected_.size()) >= MAX_SELECTION) return;
 
     selected_.push_back(obj);
+    SetSelectedFlag(obj->id, true);
     SortSelection();
     NotifySelectionChanged(SelectionEvent::ADDED);
 }
@@ -125,7 +161,9 @@ void SelectionManager::AddToSelection(SelectableObject* obj) {
 void SelectionManager::RemoveFromSelection(SelectableObject* obj) {
     auto it = std::find(selected_.begin(), selected_.end(), obj);
     if (it != selected_.end()) {
+        UnmarkSelection();
         selected_.erase(it);
+        MarkSelection();
         NotifySelectionChanged(SelectionEvent::REMOVED);
     }
 }
@@ -140,7 +178,7 @@ void SelectionManager::ToggleSelection(SelectableObject* obj) {
 
 void SelectionManager::SelectInBox(int screen_x1, int screen_y1,
                                     int screen_x2, int screen_y2) {
-    if (!get_objects_in_rect_) {
+    if (!get_objects_in_rect_ && grid_.Size() == 0) {
         Platform_LogInfo("SelectionManager: No objects_in_rect query set");
         return;
     }
@@ -149,50 +187,79 @@ void SelectionManager::SelectInBox(int screen_x1, int screen_y1,
     if (screen_x1 > screen_x2) std::swap(screen_x1, screen_x2);
     if (screen_y1 > screen_y2) std::swap(screen_y1, screen_y2);
 
-    // Get all objects in the rectangle
-    auto objects = get_objects_in_rect_(screen_x1, screen_y1, screen_x2, screen_y2);
-
-    // Filter to only player's units (not buildings)
-    std::vector<SelectableObject*> selectable;
-    for (auto* obj : objects) {
+    // Filter to only player's units (not buildings). The grid is walked in
+    // place so a drag never builds an intermediate list
+    SmallVector<SelectableObject*, MAX_SELECTION> selectable;
+    auto consider = [&](SelectableObject* obj) {
         if (obj && obj->is_unit && obj->owner == player_house_ && obj->is_active) {
             selectable.push_back(obj);
         }
+    };
+    if (get_objects_in_rect_) {
+        for (auto* obj : get_objects_in_rect_(screen_x1, screen_y1, screen_x2, screen_y2)) {
+            consider(obj);
+        }
+    } else {
+        int x1, y1, x2, y2;
+        ScreenRectToWorld(screen_x1, screen_y1, screen_x2, screen_y2, x1, y1, x2, y2);
+        grid_.ForEachInRect(x1, y1, x2, y2, [&](SelectableObject* obj, int, int) {
+            consider(obj);
+        });
     }
 
-    if (selectable.empty()) return;
-
-    // Sort by priority
-    std::sort(selectable.begin(), selectable.end(), SelectionPriorityCompare);
-
-    // Clear and add new selection
-    selected_.clear();
-    for (auto* obj : selectable) {
-        if (static_cast<int>(selected_.size()) >= MAX_SELECTION) break;
-        selected_.push_back(obj);
-    }
-
-    NotifySelectionChanged(SelectionEvent::REPLACED);
+    SelectObjects(selectable.data(), static_cast<int>(selectable.size()));
 }
 
 void SelectionManager::SelectAllOfType(int rtti_type) {
     if (!get_all_objects_) return;
 
-    auto all = get_all_objects_();
+    // Every match is a candidate, so the trim keeps the highest priority
+    std::vector<SelectableObject*> matches;
+    ForEachObject([&](SelectableObject* obj) {
+        if (obj && (rtti_type < 0 || obj->rtti_type == rtti_type)) {
+            matches.push_back(obj);
+        }
+    });
+    SelectObjects(matches.data(), static_cast<int>(matches.size()));
+}
+
+void SelectionManager::SelectObjects(SelectableObject* const* objs, int count) {
+    int first = 0;
+    while (first < count && !CanSelect(objs[first])) {
+        first++;
+    }
+    if (first == count) return;
 
+    UnmarkSelection();
     selected_.clear();
-    for (auto* obj : all) {
-        if (obj && obj->rtti_type == rtti_type &&
-            obj->owner == player_house_ && obj->is_active) {
-            if (static_cast<int>(selected_.size()) >= MAX_SELECTION) break;
+    for (int i = first; i < count; i++) {
+        SelectableObject* obj = objs[i];
+        if (CanSelect(obj) && !HasSelectedFlag(obj->id)) {
             selected_.push_back(obj);
+            SetSelectedFlag(obj->id, true);
         }
     }
+    SortSelection();
+    TrimSelection();
 
-    if (!selected_.empty()) {
-        SortSelection();
-        NotifySelectionChanged(SelectionEvent::REPLACED);
+    NotifySelectionChanged(SelectionEvent::REPLACED);
+}
+
+void SelectionManager::AddObjectsToSelection(SelectableObject* const* objs, int count) {
+    size_t before = selected_.size();
+    for (int i = 0; i < count; i++) {
+        SelectableObject* obj = objs[i];
+        if (CanSelect(obj) && !HasSelectedFlag(obj->id)) {
+            selected_.push_back(obj);
+            SetSelectedFlag(obj->id, true);
+        }
     }
+    if (selected_.size() == before) return;
+
+    SortSelection();
+    TrimSelection();
+
+    NotifySelectionChanged(SelectionEvent::ADDED);
 }
 
 void SelectionManager::SelectAllVisible(int rtti_type) {
@@ -206,15 +273,12 @@ void SelectionManager::SelectAllVisible(int rtti_type) {
 //=============================================================================
 
 bool SelectionManager::IsSelected(const SelectableObject* obj) const {
-    if (!obj) return false;
+    if (!obj || !HasSelectedFlag(obj->id)) return false;
     return std::find(selected_.begin(), selected_.end(), obj) != selected_.end();
 }
 
 bool SelectionManager::IsSelected(uint32_t object_id) const {
-    for (const auto* obj : selected_) {
-        if (obj && obj->id == object_id) return true;
-    }
-    return false;
+    return HasSelectedFlag(object_id);
 }
 
 SelectableObject* SelectionManager::GetPrimarySelection() const {
@@ -261,10 +325,10 @@ int SelectionManager::GetSelectedType() const {
 void SelectionManager::SaveGroup(int group_num) {
     if (group_num < 0 || group_num >= NUM_CONTROL_GROUPS) return;
 
-    groups_[group_num].clear();
-    for (const auto* obj : selected_) {
+    ClearGroup(group_num);
+    for (auto* obj : selected_) {
         if (obj) {
-            groups_[group_num].push_back(obj->id);
+            AddToGroup(group_num, obj);
         }
     }
 
@@ -281,58 +345,76 @@ void SelectionManager::RecallGroup(int group_num) {
 
     if (groups_[group_num].empty()) return;
 
-    // Rebuild selection from stored IDs
+    // Rebuild selection from the members, keeping group order
+    UnmarkSelection();
     selected_.clear();
-
-    if (get_all_objects_) {
-        auto all = get_all_objects_();
-
-        for (uint32_t id : groups_[group_num]) {
-            for (auto* obj : all) {
-                if (obj && obj->id == id && obj->is_active) {
-                    selected_.push_back(obj);
-                    break;
-                }
-            }
+    SmallVector<uint32_t, MAX_SELECTION> gone;
+    for (uint32_t id : groups_[group_num]) {
+        auto it = grouped_.find(id);
+        SelectableObject* obj = it != grouped_.end() ? it->second.obj : nullptr;
+        if (obj && obj->is_active) {
+            selected_.push_back(obj);
+        } else {
+            gone.push_back(id);
         }
     }
+    MarkSelection();
 
-    // Clean up group - remove invalid IDs
-    std::vector<uint32_t> valid_ids;
-    for (const auto* obj : selected_) {
-        if (obj) valid_ids.push_back(obj->id);
+    // Clean up group - drop members no longer active
+    for (uint32_t id : gone) {
+        RemoveFromGroups(id, static_cast<uint16_t>(1u << group_num));
     }
-    groups_[group_num] = valid_ids;
 
     if (!selected_.empty()) {
         NotifySelectionChanged(SelectionEvent::GROUP_RECALLED);
     }
 }
 
+SelectableObject* SelectionManager::FindObject(uint32_t object_id) const {
+    SelectableObject* found = nullptr;
+    ForEachObject([&](SelectableObject* obj) {
+        if (!found && obj && obj->id == object_id && obj->is_active) found = obj;
+    });
+    return found;
+}
+
+int SelectionManager::FindObjects(const uint32_t* sorted_ids, int count,
+                                  std::vector<SelectableObject*>& out) const {
+    out.clear();
+    if (count <= 0) return 0;
+    ForEachObject([&](SelectableObject* obj) {
+        if (obj && obj->is_active && std::binary_search(sorted_ids, sorted_ids + count, obj->id)) {
+            out.push_back(obj);
+        }
+    });
+    return static_cast<int>(out.size());
+}
+
+void SelectionManager::SelectIds(const uint32_t* ids, int count) {
+    UnmarkSelection();
+    selected_.clear();
+    for (int i = 0; i < count && static_cast<int>(selected_.size()) < MAX_SELECTION; i++) {
+        SelectableObject* obj = FindObject(ids[i]);
+        if (obj) selected_.push_back(obj);
+    }
+    MarkSelection();
+    NotifySelectionChanged(SelectionEvent::REPLACED, false);
+}
+
 void SelectionManager::AddGroupToSelection(int group_num) {
     if (group_num < 0 || group_num >= NUM_CONTROL_GROUPS) return;
 
     if (groups_[group_num].empty()) return;
 
-    if (!get_all_objects_) return;
-
-    auto all = get_all_objects_();
-
+    SmallVector<SelectableObject*, MAX_SELECTION> members;
     for (uint32_t id : groups_[group_num]) {
-        if (static_cast<int>(selected_.size()) >= MAX_SELECTION) break;
-
-        for (auto* obj : all) {
-            if (obj && obj->id == id && obj->is_active && !IsSelected(obj)) {
-                selected_.push_back(obj);
-                break;
-            }
+        auto it = grouped_.find(id);
+        SelectableObject* obj = it != grouped_.end() ? it->second.obj : nullptr;
+        if (obj && obj->is_active) {
+            members.push_back(obj);
         }
     }
-
-    if (!selected_.empty()) {
-        SortSelection();
-        NotifySelectionChanged(SelectionEvent::ADDED);
-    }
+    AddObjectsToSelection(members.data(), static_cast<int>(members.size()));
 }
 
 bool SelectionManager::HasGroup(int group_num) const {
@@ -349,27 +431,9 @@ bool SelectionManager::GetGroupCenter(int group_num, int& out_x, int& out_y) con
     if (group_num < 0 || group_num >= NUM_CONTROL_GROUPS) return false;
     if (groups_[group_num].empty()) return false;
 
-    if (!get_all_objects_) return false;
-
-    auto all = get_all_objects_();
-
-    int total_x = 0, total_y = 0, count = 0;
-
-    for (uint32_t id : groups_[group_num]) {
-        for (const auto* obj : all) {
-            if (obj && obj->id == id && obj->is_active) {
-                total_x += obj->pixel_x;
-                total_y += obj->pixel_y;
-                count++;
-                break;
-            }
-        }
-    }
-
-    if (count == 0) return false;
-
-    out_x = total_x / count;
-    out_y = total_y / count;
+    int64_t count = static_cast<int64_t>(groups_[group_num].size());
+    out_x = static_cast<int>(group_sums_[group_num].x / count);
+    out_y = static_cast<int>(group_sums_[group_num].y / count);
     return true;
 }
 
@@ -379,10 +443,20 @@ bool SelectionManager::GetGroupCenter(int group_num, int& out_x, int& out_y) con
 
 void SelectionManager::OnObjectDestroyed(SelectableObject* obj) {
     if (!obj) return;
+    UntrackObject(obj);
     OnObjectDestroyed(obj->id);
 }
 
 void SelectionManager::OnObjectDestroyed(uint32_t object_id) {
+    // Drop tracked copies too (the pointer may already be dangling)
+    SmallVector<SelectableObject*, 8> tracked;
+    grid_.ForEach([&](SelectableObject* obj, int, int) {
+        if (obj->id == object_id) tracked.push_back(obj);
+    });
+    for (auto* obj : tracked) {
+        UntrackObject(obj);
+    }
+
     // Remove from selection
     auto it = std::remove_if(selected_.begin(), selected_.end(),
         [object_id](const SelectableObject* obj) {
@@ -391,21 +465,117 @@ void SelectionManager::OnObjectDestroyed(uint32_t object_id) {
 
     if (it != selected_.end()) {
         selected_.erase(it, selected_.end());
-        NotifySelectionChanged(SelectionEvent::REMOVED);
+        SetSelectedFlag(object_id, false);
+        NotifySelectionChanged(SelectionEvent::REMOVED, false);
     }
 
-    // Remove from all control groups
-    for (auto& group : groups_) {
-        auto git = std::remove(group.begin(), group.end(), object_id);
-        group.erase(git, group.end());
+    // Only the groups it is in
+    RemoveFromGroups(object_id, 0xFFFF);
+}
+
+//=============================================================================
+// Spatial Index
+//=============================================================================
+
+void SelectionManager::TrackObject(SelectableObject* obj) {
+    if (!obj) return;
+    UpdateObject(obj);
+}
+
+void SelectionManager::UpdateObject(SelectableObject* obj) {
+    if (!obj) return;
+
+    // Occupancy changes only when the object changes cell
+    const auto* tracked = grid_.Find(obj);
+    if (!tracked || tracked->x / CELL_PIXEL_SIZE != obj->pixel_x / CELL_PIXEL_SIZE ||
+        tracked->y / CELL_PIXEL_SIZE != obj->pixel_y / CELL_PIXEL_SIZE) {
+        if (tracked) TouchCell(tracked->x, tracked->y);
+        TouchCell(obj->pixel_x, obj->pixel_y);
+    }
+    grid_.Move(obj, obj->pixel_x, obj->pixel_y);
+
+    // Shift the centroids of its groups by the move
+    auto it = grouped_.find(obj->id);
+    if (it == grouped_.end()) return;
+
+    GroupedObject& entry = it->second;
+    int dx = obj->pixel_x - entry.pixel_x;
+    int dy = obj->pixel_y - entry.pixel_y;
+    for (int g = 0; g < NUM_CONTROL_GROUPS; g++) {
+        if (entry.groups & (1u << g)) {
+            group_sums_[g].x += dx;
+            group_sums_[g].y += dy;
+        }
+    }
+    entry.obj = obj;
+    entry.pixel_x = obj->pixel_x;
+    entry.pixel_y = obj->pixel_y;
+}
+
+void SelectionManager::UntrackObject(SelectableObject* obj) {
+    const auto* entry = grid_.Find(obj);
+    if (!entry) return;
+    TouchCell(entry->x, entry->y);
+    grid_.Remove(obj);
+}
+
+uint32_t SelectionManager::GetCellGeneration(int cell_x, int cell_y) const {
+    return cell_generations_[(cell_y & 31) * 32 + (cell_x & 31)];
+}
+
+void SelectionManager::TouchCell(int pixel_x, int pixel_y) {
+    int cell_x = pixel_x / CELL_PIXEL_SIZE;
+    int cell_y = pixel_y / CELL_PIXEL_SIZE;
+    cell_generations_[(cell_y & 31) * 32 + (cell_x & 31)]++;
+}
+
+std::vector<SelectableObject*> SelectionManager::GetObjectsInRect(int screen_x1, int screen_y1,
+                                                                  int screen_x2, int screen_y2) const {
+    if (get_objects_in_rect_) {
+        return get_objects_in_rect_(screen_x1, screen_y1, screen_x2, screen_y2);
+    }
+
+    int x1, y1, x2, y2;
+    ScreenRectToWorld(screen_x1, screen_y1, screen_x2, screen_y2, x1, y1, x2, y2);
+
+    std::vector<SelectableObject*> result;
+    grid_.QueryRect(x1, y1, x2, y2, result);
+    return result;
+}
+
+SelectableObject* SelectionManager::GetObjectAt(int cell_x, int cell_y) const {
+    if (get_object_at_) {
+        return get_object_at_(cell_x, cell_y);
     }
+
+    // Only the buckets around this cell are visited
+    SelectableObject* found = nullptr;
+    int px = cell_x * CELL_PIXEL_SIZE;
+    int py = cell_y * CELL_PIXEL_SIZE;
+    grid_.ForEachInRect(px, py, px + CELL_PIXEL_SIZE - 1, py + CELL_PIXEL_SIZE - 1,
+                        [&](SelectableObject* obj, int, int) {
+        if (!found && obj->is_active && obj->cell_x == cell_x && obj->cell_y == cell_y) {
+            found = obj;
+        }
+    });
+    return found;
 }
 
 //=============================================================================
 // Private Methods
 //=============================================================================
 
-void SelectionManager::NotifySelectionChanged(SelectionEvent event) {
+void SelectionManager::NotifySelectionChanged(SelectionEvent event, bool from_input) {
+    if (event != SelectionEvent::GROUP_SAVED) {
+        generation_++;
+    }
+
+    // Saving a group changes nothing on screen
+    if (from_input && event != SelectionEvent::GROUP_SAVED) {
+        InputLatency::Instance().Mark(LatencyEffect::SELECTION,
+                                      InputState::Instance().GetInputTimeUs());
+    }
+
     if (on_selection_changed_) {
         on_selection_changed_(event);
     }
@@ -423,9 +593,114 @@ void SelectionManager::SortSelection() {
 }
 
 void SelectionManager::TrimSelection() {
+    if (static_cast<int>(selected_.size()) <= MAX_SELECTION) return;
+
+    UnmarkSelection();
     while (static_cast<int>(selected_.size()) > MAX_SELECTION) {
         selected_.pop_back();
     }
+    MarkSelection();
+}
+
+void SelectionManager::AddToGroup(int group_num, SelectableObject* obj) {
+    uint16_t bit = static_cast<uint16_t>(1u << group_num);
+    GroupedObject& entry = grouped_[obj->id];
+    if (entry.groups & bit) return;
+
+    // One position per object, shared by all its groups
+    if (entry.groups == 0) {
+        entry.pixel_x = obj->pixel_x;
+        entry.pixel_y = obj->pixel_y;
+    }
+    entry.obj = obj;
+    entry.groups |= bit;
+
+    groups_[group_num].push_back(obj->id);
+    group_sums_[group_num].x += entry.pixel_x;
+    group_sums_[group_num].y += entry.pixel_y;
+}
+
+void SelectionManager::RemoveFromGroups(uint32_t object_id, uint16_t group_mask) {
+    auto it = grouped_.find(object_id);
+    if (it == grouped_.end()) return;
+
+    GroupedObject& entry = it->second;
+    for (int g = 0; g < NUM_CONTROL_GROUPS; g++) {
+        if (!(entry.groups & group_mask & (1u << g))) continue;
+
+        auto& group = groups_[g];
+        group.erase(std::remove(group.begin(), group.end(), object_id), group.end());
+        group_sums_[g].x -= entry.pixel_x;
+        group_sums_[g].y -= entry.pixel_y;
+    }
+    entry.groups &= ~group_mask;
+    if (entry.groups == 0) {
+        grouped_.erase(it);
+    }
+}
+
+void SelectionManager::ClearGroup(int group_num) {
+    uint16_t bit = static_cast<uint16_t>(1u << group_num);
+    for (uint32_t id : groups_[group_num]) {
+        auto it = grouped_.find(id);
+        if (it == grouped_.end()) continue;
+        it->second.groups &= ~bit;
+        if (it->second.groups == 0) {
+            grouped_.erase(it);
+        }
+    }
+    groups_[group_num].clear();
+    group_sums_[group_num] = GroupSums{0, 0};
+}
+
+void SelectionManager::MarkSelection() {
+    for (const auto* obj : selected_) {
+        if (obj) SetSelectedFlag(obj->id, true);
+    }
+}
+
+void SelectionManager::UnmarkSelection() {
+    for (const auto* obj : selected_) {
+        if (obj) SetSelectedFlag(obj->id, false);
+    }
+}
+
+void SelectionManager::SetSelectedFlag(uint32_t object_id, bool selected) {
+    if (object_id >= MAX_FLAGGED_OBJECT_ID) return;
+
+    size_t word = object_id / 64;
+    uint64_t bit = uint64_t(1) << (object_id % 64);
+    if (word >= selected_flags_.size()) {
+        if (!selected) return;
+        selected_flags_.resize(word + 1, 0);
+    }
+    if (selected) {
+        selected_flags_[word] |= bit;
+    } else {
+        selected_flags_[word] &= ~bit;
+    }
+}
+
+bool SelectionManager::HasSelectedFlag(uint32_t object_id) const {
+    if (object_id >= MAX_FLAGGED_OBJECT_ID) {
+        for (const auto* obj : selected_) {
+            if (obj && obj->id == object_id) return true;
+        }
+        return false;
+    }
+
+    size_t word = object_id / 64;
+    return word < selected_flags_.size() &&
+           (selected_flags_[word] >> (object_id % 64)) & 1;
+}
+
+void SelectionManager::ScreenRectToWorld(int screen_x1, int screen_y1, int screen_x2, int screen_y2,
+                                         int& x1, int& y1, int& x2, int& y2) {
+    GameViewport& viewport = GameViewport::Instance();
+    viewport.ScreenToWorld(screen_x1, screen_y1, x1, y1);
+    viewport.ScreenToWorld(screen_x2, screen_y2, x2, y2);
+    if (x1 > x2) std::swap(x1, x2);
+    if (y1 > y2) std::swap(y1, y2);
 }
 
 //=============================================================================
@@ -0,0 +1,375 @@
+/**
+ * LZO1X Implementation
+ *
+ * Instruction bytes (t), as the decompressor sees them:
+ *   0-15   literal run, or after literals an M1 match (short/near)
+ *   16-31  M4 match: 16K-48K back; 16 with zero offset ends the stream
+ *   32-63  M3 match: up to 16K back, any length
+ *   64-255 M2 match: up to 2K back, 3-8 bytes
+ * The low two bits of a match's second-to-last byte give 0-3 literals
+ * that follow it, saving an instruction for short runs.
+ *
+ * The compressor keeps dictionary entries as offsets into the block
+ * rather than pointers, so a stale entry from an earlier call is just a
+ * candidate that fails the range or byte check.
+ */
+
+#include "game/io/lzo.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t M2_MAX_OFFSET = 0x0800;
+constexpr uint32_t M3_MAX_OFFSET = 0x4000;
+constexpr uint32_t M4_MAX_OFFSET = 0xbfff;
+
+constexpr uint8_t M3_MARKER = 32;
+constexpr uint8_t M4_MARKER = 16;
+
+// Shortest input worth searching; smaller blocks are stored as literals
+constexpr int MIN_MATCH_INPUT = 9 + 4;
+
+// Rolling hash of the 3 bytes at p
+inline uint32_t Hash_First(const uint8_t* p) {
+    return (((static_cast<uint32_t>(p[2]) << 5) ^ p[1]) << 5) ^ p[0];
+}
+
+inline uint32_t Hash_Next(uint32_t dv, const uint8_t* p) {
+    dv ^= p[-1];
+    return (dv >> 5) ^ (static_cast<uint32_t>(p[2]) << 10);
+}
+
+inline uint32_t Hash_Index(uint32_t dv) {
+    return ((40799u * dv) >> 5) & (LZO_DICT_SIZE - 1);
+}
+
+// Emit a run of `count` literals. Runs of 1-3 after a match ride in the
+// low bits of the match's offset byte two back.
+uint8_t* Store_Literals(uint8_t* op, const uint8_t* literals, uint32_t count) {
+    if (count <= 3) {
+        op[-2] |= static_cast<uint8_t>(count);
+    } else if (count <= 18) {
+        *op++ = static_cast<uint8_t>(count - 3);
+    } else {
+        uint32_t rest = count - 18;
+        *op++ = 0;
+        while (rest > 255) {
+            rest -= 255;
+            *op++ = 0;
+        }
+        *op++ = static_cast<uint8_t>(rest);
+    }
+    memcpy(op, literals, count);
+    return op + count;
+}
+
+// Extended length: zero bytes each add 255, the final byte adds itself
+uint8_t* Store_Length(uint8_t* op, uint32_t length) {
+    while (length > 255) {
+        length -= 255;
+        *op++ = 0;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+// Compress in_len > MIN_MATCH_INPUT bytes, without the end code
+uint8_t* Compress_Block(const uint8_t* in, int in_len, uint8_t* out, uint32_t* dict) {
+    const uint8_t* const in_end = in + in_len;
+    const uint8_t* const ip_end = in_end - MIN_MATCH_INPUT;
+    const uint8_t* ip = in;
+    const uint8_t* ii = in;         // Start of the pending literal run
+    uint8_t* op = out;
+
+    uint32_t dv = Hash_First(ip);
+    dict[Hash_Index(dv)] = 0;
+    for (int i = 1; i < 4; i++) {
+        ip++;
+        dv = Hash_Next(dv, ip);
+        dict[Hash_Index(dv)] = static_cast<uint32_t>(ip - in);
+    }
+    ip++;
+    dv = Hash_Next(dv, ip);
+
+    while (true) {
+        uint32_t pos = static_cast<uint32_t>(ip - in);
+        uint32_t index = Hash_Index(dv);
+        uint32_t candidate = dict[index];
+        dict[index] = pos;
+
+        uint32_t m_off = 0;
+        const uint8_t* m_pos = nullptr;
+        bool found = false;
+        if (candidate < pos && pos - candidate <= M4_MAX_OFFSET) {
+            m_off = pos - candidate;
+            m_pos = in + candidate;
+            if (m_pos[0] == ip[0] && m_pos[1] == ip[1] && m_pos[2] == ip[2]) {
+                // Far 3-byte matches only pay off when they absorb 3 literals
+                found = m_off <= M2_MAX_OFFSET || ip - ii == 3 || m_pos[3] == ip[3];
+            }
+        }
+
+        if (!found) {
+            ++ip;
+            if (ip >= ip_end) {
+                break;
+            }
+            dv = Hash_Next(dv, ip);
+            continue;
+        }
+
+        if (ip > ii) {
+            op = Store_Literals(op, ii, static_cast<uint32_t>(ip - ii));
+        }
+
+        // Up to 8 bytes codes as a short match; longer ones scan on
+        const uint8_t* m = m_pos + 3;
+        const uint8_t* p = ip + 3;
+        int extra = 0;
+        while (extra < 6 && m[extra] == p[extra]) {
+            extra++;
+        }
+
+        if (extra < 6) {
+            uint32_t m_len = 3 + extra;
+            ip += m_len;
+
+            if (m_off <= M2_MAX_OFFSET) {
+                m_off -= 1;
+                *op++ = static_cast<uint8_t>(((m_len - 1) << 5) | ((m_off & 7) << 2));
+                *op++ = static_cast<uint8_t>(m_off >> 3);
+                ii = ip;
+                if (ip >= ip_end) {
+                    break;
+                }
+                dv = Hash_First(ip);
+                continue;
+            }
+
+            if (m_off <= M3_MAX_OFFSET) {
+                m_off -= 1;
+                *op++ = static_cast<uint8_t>(M3_MARKER | (m_len - 2));
+            } else {
+                m_off -= 0x4000;
+                *op++ = static_cast<uint8_t>(M4_MARKER | ((m_off & 0x4000) >> 11) | (m_len - 2));
+            }
+        } else {
+            m += 6;
+            p += 6;
+            while (p < in_end && *m == *p) {
+                m++;
+                p++;
+            }
+            uint32_t m_len = static_cast<uint32_t>(p - ip);
+            ip = p;
+
+            if (m_off <= M3_MAX_OFFSET) {
+                m_off -= 1;
+                if (m_len <= 33) {
+                    *op++ = static_cast<uint8_t>(M3_MARKER | (m_len - 2));
+                } else {
+                    *op++ = M3_MARKER;
+                    op = Store_Length(op, m_len - 33);
+                }
+            } else {
+                m_off -= 0x4000;
+                uint8_t marker = static_cast<uint8_t>(M4_MARKER | ((m_off & 0x4000) >> 11));
+                if (m_len <= 9) {
+                    *op++ = static_cast<uint8_t>(marker | (m_len - 2));
+                } else {
+                    *op++ = marker;
+                    op = Store_Length(op, m_len - 9);
+                }
+            }
+        }
+
+        *op++ = static_cast<uint8_t>((m_off & 63) << 2);
+        *op++ = static_cast<uint8_t>(m_off >> 6);
+
+        ii = ip;
+        if (ip >= ip_end) {
+            break;
+        }
+        dv = Hash_First(ip);
+    }
+
+    // Final literal run
+    uint32_t count = static_cast<uint32_t>(in_end - ii);
+    if (count > 0) {
+        if (op == out && count <= 238) {
+            *op++ = static_cast<uint8_t>(17 + count);
+            memcpy(op, ii, count);
+            op += count;
+        } else {
+            op = Store_Literals(op, ii, count);
+        }
+    }
+    return op;
+}
+
+} // namespace
+
+// =============================================================================
+// Compression
+// =============================================================================
+
+int LZO_Compress(const uint8_t* source, int length, uint8_t* dest, uint32_t* dict) {
+    uint8_t* op = dest;
+
+    if (length > MIN_MATCH_INPUT) {
+        op = Compress_Block(source, length, dest, dict);
+    } else if (length > 0) {
+        *op++ = static_cast<uint8_t>(17 + length);
+        memcpy(op, source, length);
+        op += length;
+    }
+
+    // End of stream: an M4 match with no offset
+    *op++ = M4_MARKER | 1;
+    *op++ = 0;
+    *op++ = 0;
+    return static_cast<int>(op - dest);
+}
+
+// =============================================================================
+// Decompression
+// =============================================================================
+
+int LZO_Decompress(const uint8_t* source, int length, uint8_t* dest, int dest_size) {
+    if (!source || length < 3 || !dest || dest_size < 0) {
+        return -1;
+    }
+
+    const uint8_t* ip = source;
+    const uint8_t* const ip_end = source + length;
+    uint8_t* op = dest;
+    uint8_t* const op_end = dest + dest_size;
+
+    // What the last instruction was decides how t < 16 reads
+    enum { AFTER_MATCH, AFTER_RUN, AFTER_SHORT_RUN } state = AFTER_MATCH;
+
+    auto copy_literals = [&](uint32_t count) {
+        if (count > static_cast<size_t>(ip_end - ip) || count > static_cast<size_t>(op_end - op)) {
+            return false;
+        }
+        memcpy(op, ip, count);
+        ip += count;
+        op += count;
+        return true;
+    };
+
+    // Adds the zero-byte length extension after a zero length field
+    auto read_length = [&](uint32_t base, uint32_t* out) {
+        uint32_t value = base;
+        while (ip < ip_end && *ip == 0) {
+            value += 255;
+            ip++;
+            if (value > static_cast<uint32_t>(dest_size)) {
+                return false;
+            }
+        }
+        if (ip >= ip_end) {
+            return false;
+        }
+        *out = value + *ip++;
+        return true;
+    };
+
+    if (*ip > 17) {
+        if (!copy_literals(*ip++ - 17u)) {
+            return -1;
+        }
+        state = AFTER_RUN;
+    }
+
+    while (ip < ip_end) {
+        uint32_t t = *ip++;
+        uint32_t distance;
+        uint32_t count;
+
+        if (t < 16) {
+            if (state == AFTER_MATCH) {
+                if (t == 0 && !read_length(15, &t)) {
+                    return -1;
+                }
+                if (!copy_literals(t + 3)) {
+                    return -1;
+                }
+                state = AFTER_RUN;
+                continue;
+            }
+
+            // M1: two bytes close by, or three just past M2 range after a long run
+            if (ip >= ip_end) {
+                return -1;
+            }
+            distance = 1 + (t >> 2) + (static_cast<uint32_t>(*ip++) << 2);
+            count = 2;
+            if (state == AFTER_RUN) {
+                distance += M2_MAX_OFFSET;
+                count = 3;
+            }
+        } else if (t >= 64) {
+            if (ip >= ip_end) {
+                return -1;
+            }
+            distance = 1 + ((t >> 2) & 7) + (static_cast<uint32_t>(*ip++) << 3);
+            count = (t >> 5) + 1;
+        } else if (t >= 32) {
+            count = t & 31;
+            if (count == 0 && !read_length(31, &count)) {
+                return -1;
+            }
+            count += 2;
+            if (ip_end - ip < 2) {
+                return -1;
+            }
+            distance = 1 + (ip[0] >> 2) + (static_cast<uint32_t>(ip[1]) << 6);
+            ip += 2;
+        } else {
+            distance = (t & 8) << 11;
+            count = t & 7;
+            if (count == 0 && !read_length(7, &count)) {
+                return -1;
+            }
+            count += 2;
+            if (ip_end - ip < 2) {
+                return -1;
+            }
+            distance += (ip[0] >> 2) + (static_cast<uint32_t>(ip[1]) << 6);
+            ip += 2;
+            if (distance == 0) {
+                // End of stream; anything after it means the length was wrong
+                return ip == ip_end ? static_cast<int>(op - dest) : -1;
+            }
+            distance += 0x4000;
+        }
+
+        if (distance > static_cast<size_t>(op - dest) || count > static_cast<size_t>(op_end - op)) {
+            return -1;
+        }
+        const uint8_t* m_pos = op - distance;
+        if (distance >= count) {
+            memcpy(op, m_pos, count);
+            op += count;
+        } else {
+            // Overlapping: each byte may be one this match just wrote
+            for (uint32_t i = 0; i < count; i++) {
+                *op++ = *m_pos++;
+            }
+        }
+
+        uint32_t trailing = ip[-2] & 3;
+        if (trailing == 0) {
+            state = AFTER_MATCH;
+        } else {
+            if (!copy_literals(trailing)) {
+                return -1;
+            }
+            state = AFTER_SHORT_RUN;
+        }
+    }
+
+    // Ran out of input without the end code
+    return -1;
+}
@@ -0,0 +1,297 @@
+/**
+ * LZOPipe / LZOStraw Implementation
+ *
+ * Whole blocks are compressed straight out of the caller's data and
+ * decompressed straight into the caller's buffer whenever they line up;
+ * the stage buffers are only used for pieces that straddle a block.
+ */
+
+#include "game/io/lzo_pipe.h"
+#include "game/io/lzo.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+int Clamp_Block_Size(int block_size) {
+    return std::min(std::max(block_size, 1), LZO_MAX_BLOCK_SIZE);
+}
+
+void Write_Header(uint8_t* header, int comp_count, int uncomp_count) {
+    header[0] = static_cast<uint8_t>(comp_count);
+    header[1] = static_cast<uint8_t>(comp_count >> 8);
+    header[2] = static_cast<uint8_t>(uncomp_count);
+    header[3] = static_cast<uint8_t>(uncomp_count >> 8);
+}
+
+void Read_Header(const uint8_t* header, uint16_t* comp_count, uint16_t* uncomp_count) {
+    *comp_count = static_cast<uint16_t>(header[0] | (header[1] << 8));
+    *uncomp_count = static_cast<uint16_t>(header[2] | (header[3] << 8));
+}
+
+// A block always carries at least the 3-byte end code
+bool Valid_Header(uint16_t comp_count, uint16_t uncomp_count) {
+    return comp_count >= 3 && comp_count <= LZO_Max_Compressed_Size(uncomp_count);
+}
+
+} // namespace
+
+// =============================================================================
+// LZOPipe
+// =============================================================================
+
+LZOPipe::LZOPipe(CompControl control, int block_size)
+    : control_(control)
+    , block_size_(Clamp_Block_Size(block_size))
+{
+    if (control_ == COMPRESS) {
+        buffer_.resize(block_size_);
+        output_.resize(LZO_BLOCK_HEADER_SIZE + LZO_Max_Compressed_Size(block_size_));
+        dict_.assign(LZO_DICT_SIZE, 0);
+    } else {
+        buffer_.resize(LZO_BLOCK_HEADER_SIZE);
+    }
+}
+
+int LZOPipe::Put(const void* source, int length) {
+    if (!source || length < 1) {
+        return Pipe::Put(source, length);
+    }
+
+    const uint8_t* in = static_cast<const uint8_t*>(source);
+    int total = 0;
+
+    if (control_ == DECOMPRESS) {
+        while (length > 0 && !error_) {
+            if (!have_header_) {
+                int count = std::min(length, LZO_BLOCK_HEADER_SIZE - counter_);
+                memcpy(&buffer_[counter_], in, count);
+                in += count;
+                length -= count;
+                counter_ += count;
+                if (counter_ < LZO_BLOCK_HEADER_SIZE) {
+                    break;
+                }
+
+                Read_Header(buffer_.data(), &comp_count_, &uncomp_count_);
+                counter_ = 0;
+                have_header_ = true;
+                if (!Valid_Header(comp_count_, uncomp_count_)) {
+                    error_ = true;
+                }
+                continue;
+            }
+
+            // A whole block in hand decodes in place
+            if (counter_ == 0 && length >= comp_count_) {
+                total += Put_Decompressed(in);
+                in += comp_count_;
+                length -= comp_count_;
+                continue;
+            }
+
+            if (buffer_.size() < comp_count_) {
+                buffer_.resize(comp_count_);
+            }
+            int count = std::min(length, comp_count_ - counter_);
+            memcpy(&buffer_[counter_], in, count);
+            in += count;
+            length -= count;
+            counter_ += count;
+            if (counter_ == comp_count_) {
+                total += Put_Decompressed(buffer_.data());
+            }
+        }
+        return total;
+    }
+
+    // Top up a partial block first
+    if (counter_ > 0) {
+        int count = std::min(length, block_size_ - counter_);
+        memcpy(&buffer_[counter_], in, count);
+        in += count;
+        length -= count;
+        counter_ += count;
+        if (counter_ < block_size_) {
+            return total;
+        }
+        total += Put_Block(buffer_.data(), block_size_);
+        counter_ = 0;
+    }
+
+    while (length >= block_size_) {
+        total += Put_Block(in, block_size_);
+        in += block_size_;
+        length -= block_size_;
+    }
+
+    if (length > 0) {
+        memcpy(buffer_.data(), in, length);
+        counter_ = length;
+    }
+    return total;
+}
+
+int LZOPipe::Flush() {
+    int total = 0;
+
+    if (control_ == COMPRESS) {
+        if (counter_ > 0) {
+            total += Put_Block(buffer_.data(), counter_);
+            counter_ = 0;
+        }
+    } else if (have_header_ || counter_ > 0) {
+        // The data stopped partway through a block
+        error_ = true;
+        have_header_ = false;
+        counter_ = 0;
+    }
+
+    total += Pipe::Flush();
+    return total;
+}
+
+int LZOPipe::Put_Block(const uint8_t* data, int length) {
+    int size = LZO_Compress(data, length, &output_[LZO_BLOCK_HEADER_SIZE], dict_.data());
+    Write_Header(output_.data(), size, length);
+    return Pipe::Put(output_.data(), LZO_BLOCK_HEADER_SIZE + size);
+}
+
+int LZOPipe::Put_Decompressed(const uint8_t* data) {
+    have_header_ = false;
+    counter_ = 0;
+
+    if (output_.size() < std::max<size_t>(uncomp_count_, 1)) {
+        output_.resize(std::max<size_t>(uncomp_count_, 1));
+    }
+    int count = LZO_Decompress(data, comp_count_, output_.data(), uncomp_count_);
+    if (count != uncomp_count_) {
+        error_ = true;
+        return 0;
+    }
+    return Pipe::Put(output_.data(), count);
+}
+
+// =============================================================================
+// LZOStraw
+// =============================================================================
+
+LZOStraw::LZOStraw(CompControl control, int block_size)
+    : control_(control)
+    , block_size_(Clamp_Block_Size(block_size))
+{
+    if (control_ == COMPRESS) {
+        input_.resize(block_size_);
+        output_.resize(LZO_BLOCK_HEADER_SIZE + LZO_Max_Compressed_Size(block_size_));
+        dict_.assign(LZO_DICT_SIZE, 0);
+    }
+}
+
+int LZOStraw::Get(void* dest, int length) {
+    if (!dest || length < 1) {
+        return 0;
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(dest);
+    int total = 0;
+
+    while (length > 0) {
+        if (counter_ > 0) {
+            int count = std::min(length, counter_);
+            memcpy(out, &output_[pos_], count);
+            out += count;
+            length -= count;
+            total += count;
+            pos_ += count;
+            counter_ -= count;
+            continue;
+        }
+
+        int direct = 0;
+        if (!Next_Block(out, length, &direct)) {
+            break;
+        }
+        out += direct;
+        length -= direct;
+        total += direct;
+    }
+    return total;
+}
+
+int LZOStraw::Get_Full(void* dest, int length) {
+    uint8_t* out = static_cast<uint8_t*>(dest);
+    int total = 0;
+    while (total < length) {
+        int count = Straw::Get(out + total, length - total);
+        if (count <= 0) {
+            break;
+        }
+        total += count;
+    }
+    return total;
+}
+
+bool LZOStraw::Next_Block(uint8_t* direct, int direct_size, int* direct_count) {
+    *direct_count = 0;
+    if (error_) {
+        return false;
+    }
+
+    if (control_ == COMPRESS) {
+        int count = Get_Full(input_.data(), block_size_);
+        if (count == 0) {
+            return false;
+        }
+        int size = LZO_Compress(input_.data(), count, &output_[LZO_BLOCK_HEADER_SIZE], dict_.data());
+        Write_Header(output_.data(), size, count);
+        counter_ = LZO_BLOCK_HEADER_SIZE + size;
+        pos_ = 0;
+        return true;
+    }
+
+    uint8_t header[LZO_BLOCK_HEADER_SIZE];
+    int count = Get_Full(header, LZO_BLOCK_HEADER_SIZE);
+    if (count == 0) {
+        return false;               // Clean end of data
+    }
+
+    uint16_t comp_count = 0;
+    uint16_t uncomp_count = 0;
+    if (count == LZO_BLOCK_HEADER_SIZE) {
+        Read_Header(header, &comp_count, &uncomp_count);
+    }
+    if (count != LZO_BLOCK_HEADER_SIZE || !Valid_Header(comp_count, uncomp_count)) {
+        error_ = true;
+        return false;
+    }
+
+    if (input_.size() < comp_count) {
+        input_.resize(comp_count);
+    }
+    if (Get_Full(input_.data(), comp_count) != comp_count) {
+        error_ = true;
+        return false;
+    }
+
+    // Decode straight into the caller when the whole block fits
+    uint8_t* target = direct;
+    if (uncomp_count > direct_size) {
+        if (output_.size() < uncomp_count) {
+            output_.resize(uncomp_count);
+        }
+        target = output_.data();
+    }
+
+    if (LZO_Decompress(input_.data(), comp_count, target, uncomp_count) != uncomp_count) {
+        error_ = true;
+        return false;
+    }
+
+    if (target == direct) {
+        *direct_count = uncomp_count;
+    } else {
+        counter_ = uncomp_count;
+        pos_ = 0;
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * Pipe Implementation
+ */
+
+#include "game/io/pipe.h"
+#include "platform.h"
+
+// =============================================================================
+// Pipe
+// =============================================================================
+
+Pipe::~Pipe() {
+    // Splice this segment out so the neighbours stay linked
+    if (chain_to_) {
+        chain_to_->chain_from_ = chain_from_;
+    }
+    if (chain_from_) {
+        chain_from_->chain_to_ = chain_to_;
+    }
+    chain_to_ = nullptr;
+    chain_from_ = nullptr;
+}
+
+void Pipe::Put_To(Pipe* pipe) {
+    if (chain_to_ == pipe) {
+        return;
+    }
+
+    if (pipe && pipe->chain_from_) {
+        pipe->chain_from_->Put_To(nullptr);
+    }
+    if (chain_to_) {
+        chain_to_->chain_from_ = nullptr;
+        chain_to_->Flush();
+    }
+
+    chain_to_ = pipe;
+    if (chain_to_) {
+        chain_to_->chain_from_ = this;
+    }
+}
+
+int Pipe::Put(const void* source, int length) {
+    if (chain_to_) {
+        return chain_to_->Put(source, length);
+    }
+    return length;
+}
+
+int Pipe::Flush() {
+    if (chain_to_) {
+        return chain_to_->Flush();
+    }
+    return 0;
+}
+
+// =============================================================================
+// Sinks
+// =============================================================================
+
+int BufferPipe::Put(const void* source, int length) {
+    if (!source || length < 1) {
+        return 0;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(source);
+    data_.insert(data_.end(), bytes, bytes + length);
+    return length;
+}
+
+int FilePipe::Put(const void* source, int length) {
+    if (!source || length < 1 || !file_) {
+        return 0;
+    }
+    int32_t written = Platform_File_Write(file_, source, length);
+    if (written != length) {
+        error_ = true;
+    }
+    return written > 0 ? written : 0;
+}
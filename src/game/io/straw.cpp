@@ -0,0 +1,72 @@
+/**
+ * Straw Implementation
+ */
+
+#include "game/io/straw.h"
+#include "platform.h"
+#include <algorithm>
+#include <cstring>
+
+// =============================================================================
+// Straw
+// =============================================================================
+
+Straw::~Straw() {
+    if (chain_to_) {
+        chain_to_->chain_from_ = chain_from_;
+    }
+    if (chain_from_) {
+        chain_from_->chain_to_ = chain_to_;
+    }
+    chain_to_ = nullptr;
+    chain_from_ = nullptr;
+}
+
+void Straw::Get_From(Straw* straw) {
+    if (chain_to_ == straw) {
+        return;
+    }
+
+    if (straw && straw->chain_from_) {
+        straw->chain_from_->Get_From(nullptr);
+    }
+    if (chain_to_) {
+        chain_to_->chain_from_ = nullptr;
+    }
+
+    chain_to_ = straw;
+    if (chain_to_) {
+        chain_to_->chain_from_ = this;
+    }
+}
+
+int Straw::Get(void* dest, int length) {
+    if (chain_to_) {
+        return chain_to_->Get(dest, length);
+    }
+    return 0;
+}
+
+// =============================================================================
+// Sources
+// =============================================================================
+
+int BufferStraw::Get(void* dest, int length) {
+    if (!dest || length < 1) {
+        return 0;
+    }
+    size_t count = std::min(static_cast<size_t>(length), size_ - pos_);
+    if (count > 0) {
+        memcpy(dest, data_ + pos_, count);
+        pos_ += count;
+    }
+    return static_cast<int>(count);
+}
+
+int FileStraw::Get(void* dest, int length) {
+    if (!dest || length < 1 || !file_) {
+        return 0;
+    }
+    int32_t count = Platform_File_Read(file_, dest, length);
+    return count > 0 ? count : 0;
+}
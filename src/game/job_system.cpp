@@ -0,0 +1,118 @@
+/**
+ * JobSystem Implementation
+ */
+
+#include "game/job_system.h"
+#include <algorithm>
+
+JobSystem& JobSystem::Instance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem() {
+    Stop();
+}
+
+void JobSystem::Start(int worker_count) {
+    if (Is_Running()) {
+        return;
+    }
+
+    if (worker_count <= 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        worker_count = std::min(hardware - 1, 7);
+    }
+
+    // Workers start level with the jobs already run, so the next one
+    // posted is the first they take part in
+    stopping_ = false;
+    uint32_t serial = job_serial_;
+    workers_.reserve(std::max(worker_count, 0));
+    for (int i = 0; i < worker_count; i++) {
+        workers_.emplace_back([this, serial]() { Worker_Main(serial); });
+    }
+}
+
+void JobSystem::Stop() {
+    if (!Is_Running()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void JobSystem::Parallel_For(int count, int grain, RangeFn fn) {
+    if (count <= 0) {
+        return;
+    }
+
+    grain = std::max(grain, 1);
+    int chunks = (count + grain - 1) / grain;
+    if (!Is_Running() || chunks == 1) {
+        for (int begin = 0; begin < count; begin += grain) {
+            fn(begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    job_fn_ = fn;
+    job_count_ = count;
+    job_grain_ = grain;
+    job_chunks_ = chunks;
+    next_chunk_.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_serial_++;
+        busy_ = static_cast<int>(workers_.size());
+    }
+    wake_.notify_all();
+
+    // The caller works too rather than sleeping through the job
+    Run_Chunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return busy_ == 0; });
+    job_fn_ = RangeFn();
+}
+
+void JobSystem::Run_Chunks() {
+    for (;;) {
+        int chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= job_chunks_) {
+            return;
+        }
+        int begin = chunk * job_grain_;
+        job_fn_(begin, std::min(begin + job_grain_, job_count_));
+    }
+}
+
+void JobSystem::Worker_Main(uint32_t seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen]() { return stopping_ || job_serial_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = job_serial_;
+        }
+
+        Run_Chunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_--;
+        }
+        done_.notify_one();
+    }
+}
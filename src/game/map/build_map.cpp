@@ -0,0 +1,303 @@
+/**
+ * BuildMap Implementation
+ */
+
+#include "game/build_map.h"
+#include "game/types/type_tables.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// One plane row shifted so bit x holds cell x + shift
+inline void Shift_Row(const uint64_t* row, int shift, uint64_t* out) {
+    for (int i = 0; i < BuildMap::ROW_WORDS; i++) {
+        uint64_t value = row[i] >> shift;
+        if (shift != 0 && i + 1 < BuildMap::ROW_WORDS) {
+            value |= row[i + 1] << (64 - shift);
+        }
+        out[i] = value;
+    }
+}
+
+} // namespace
+
+BuildMap::BuildMap() {
+    Clear();
+}
+
+void BuildMap::Clear() {
+    memset(land_, 0xFF, sizeof(land_));
+    memset(bounds_, 0xFF, sizeof(bounds_));
+    memset(occupied_, 0, sizeof(occupied_));
+    memset(footprint_, 0, sizeof(footprint_));
+    memcpy(free_, land_, sizeof(free_));
+    memset(near_, 0, sizeof(near_));
+    for (std::vector<Placed>& list : buildings_) {
+        list.clear();
+    }
+    dirty_ = 0;
+}
+
+// =============================================================================
+// Bits
+// =============================================================================
+
+bool BuildMap::Test(const uint64_t* plane, int x, int y) {
+    if (!Is_XY(x, y)) {
+        return false;
+    }
+    return (plane[y * ROW_WORDS + (x >> 6)] >> (x & 63)) & 1;
+}
+
+void BuildMap::Set(uint64_t* plane, int x, int y, bool value) {
+    uint64_t& word = plane[y * ROW_WORDS + (x >> 6)];
+    uint64_t bit = uint64_t(1) << (x & 63);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+uint64_t BuildMap::Row_Bits(const uint64_t* plane, int x, int y) {
+    if (y < 0 || y >= MAP_CELL_HEIGHT || x >= MAP_CELL_WIDTH || x <= -8) {
+        return 0;
+    }
+    if (x < 0) {
+        return (Row_Bits(plane, 0, y) << -x) & 0xFF;
+    }
+
+    const uint64_t* row = plane + y * ROW_WORDS;
+    int word = x >> 6;
+    int bit = x & 63;
+    uint64_t value = row[word] >> bit;
+    if (bit > 56 && word + 1 < ROW_WORDS) {
+        value |= row[word + 1] << (64 - bit);
+    }
+    return value & 0xFF;
+}
+
+void BuildMap::Or_Row(uint64_t* plane, int x, int y, uint8_t bits) {
+    if (y < 0 || y >= MAP_CELL_HEIGHT || x >= MAP_CELL_WIDTH || x <= -8) {
+        return;
+    }
+    uint64_t value = bits;
+    if (x < 0) {
+        value >>= -x;
+        x = 0;
+    }
+
+    uint64_t* row = plane + y * ROW_WORDS;
+    int word = x >> 6;
+    int bit = x & 63;
+    row[word] |= value << bit;
+    if (bit > 56 && word + 1 < ROW_WORDS) {
+        row[word + 1] |= value >> (64 - bit);
+    }
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+void BuildMap::Refresh(int x, int y) {
+    bool free = Test(land_, x, y) && Test(bounds_, x, y) && !Test(occupied_, x, y) &&
+                footprint_[y * MAP_CELL_WIDTH + x] == 0;
+    Set(free_, x, y, free);
+}
+
+void BuildMap::Land_Changed(int x, int y, LandType land) {
+    if (!Is_XY(x, y)) {
+        return;
+    }
+    Set(land_, x, y, Is_Buildable_Land(land));
+    Refresh(x, y);
+}
+
+void BuildMap::Occupied_Changed(int x, int y, bool occupied) {
+    if (!Is_XY(x, y)) {
+        return;
+    }
+    Set(occupied_, x, y, occupied);
+    Refresh(x, y);
+}
+
+void BuildMap::Set_Bounds(int x, int y, int w, int h) {
+    memset(bounds_, 0, sizeof(bounds_));
+    for (int cy = std::max(y, 0); cy < std::min(y + h, MAP_CELL_HEIGHT); cy++) {
+        for (int cx = std::max(x, 0); cx < std::min(x + w, MAP_CELL_WIDTH); cx++) {
+            Set(bounds_, cx, cy, true);
+        }
+    }
+    for (int cy = 0; cy < MAP_CELL_HEIGHT; cy++) {
+        for (int cx = 0; cx < MAP_CELL_WIDTH; cx++) {
+            Refresh(cx, cy);
+        }
+    }
+}
+
+void BuildMap::Add_Footprint(BuildingType type, CELL cell, int delta) {
+    const OccupyList& occupy = Building_Occupy(type);
+    for (int i = 0; i < occupy.count; i++) {
+        int x = Cell_X(cell) + occupy.cells[i].x;
+        int y = Cell_Y(cell) + occupy.cells[i].y;
+        if (!Is_XY(x, y)) {
+            continue;
+        }
+        uint8_t& count = footprint_[y * MAP_CELL_WIDTH + x];
+        count = static_cast<uint8_t>(std::max(count + delta, 0));
+        Refresh(x, y);
+    }
+}
+
+void BuildMap::Or_Near(uint64_t* plane, BuildingType type, CELL cell) const {
+    const FootprintMask& mask = Building_Footprint(type);
+    for (int r = 0; r < mask.height + 2; r++) {
+        Or_Row(plane, Cell_X(cell) - 1, Cell_Y(cell) - 1 + r, mask.near[r]);
+    }
+}
+
+void BuildMap::Building_Added(HousesType house, BuildingType type, CELL cell) {
+    if (!Is_House(house) || type < 0 || type >= BUILDING_COUNT || cell == CELL_NONE) {
+        return;
+    }
+    buildings_[house].push_back({cell, type});
+    Add_Footprint(type, cell, 1);
+
+    // Growing the plane needs no rebuild
+    if (!(dirty_ & (1u << house))) {
+        Or_Near(near_[house], type, cell);
+    }
+}
+
+void BuildMap::Building_Removed(HousesType house, BuildingType type, CELL cell) {
+    if (!Is_House(house) || type < 0 || type >= BUILDING_COUNT || cell == CELL_NONE) {
+        return;
+    }
+
+    std::vector<Placed>& list = buildings_[house];
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].cell == cell && list[i].type == type) {
+            list[i] = list.back();
+            list.pop_back();
+            Add_Footprint(type, cell, -1);
+            dirty_ |= 1u << house;
+            return;
+        }
+    }
+}
+
+void BuildMap::Rebuild_Near(HousesType house) {
+    // Another building may still reach the cells the lost one did, so
+    // rebuild from what is left rather than clearing its area
+    memset(near_[house], 0, sizeof(near_[house]));
+    for (const Placed& placed : buildings_[house]) {
+        Or_Near(near_[house], placed.type, placed.cell);
+    }
+    dirty_ &= ~(1u << house);
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+const uint64_t* BuildMap::Get_Near(HousesType house) {
+    if (!Is_House(house)) {
+        house = HOUSE_NEUTRAL;
+    }
+    if (dirty_ & (1u << house)) {
+        Rebuild_Near(house);
+    }
+    return near_[house];
+}
+
+bool BuildMap::Is_Near(HousesType house, int x, int y) {
+    return Is_House(house) && Test(Get_Near(house), x, y);
+}
+
+bool BuildMap::Can_Place(HousesType house, BuildingType type, int x, int y) {
+    if (!Is_House(house) || type < 0 || type >= BUILDING_COUNT) {
+        return false;
+    }
+    const FootprintMask& mask = Building_Footprint(type);
+    if (x < 0 || y < 0 || x + mask.width > MAP_CELL_WIDTH || y + mask.height > MAP_CELL_HEIGHT) {
+        return false;
+    }
+
+    const uint64_t* near = Get_Near(house);
+    bool touches = false;
+    for (int r = 0; r < mask.height; r++) {
+        if ((Row_Bits(free_, x, y + r) & mask.rows[r]) != mask.rows[r]) {
+            return false;
+        }
+        touches = touches || (Row_Bits(near, x, y + r) & mask.rows[r]) != 0;
+    }
+    return touches;
+}
+
+int BuildMap::Legal_Placements(HousesType house, BuildingType type, uint64_t* out) {
+    memset(out, 0, sizeof(uint64_t) * PLANE_WORDS);
+    if (!Is_House(house) || type < 0 || type >= BUILDING_COUNT) {
+        return 0;
+    }
+
+    const FootprintMask& mask = Building_Footprint(type);
+    const uint64_t* near = Get_Near(house);
+    int count = 0;
+    for (int y = 0; y + mask.height <= MAP_CELL_HEIGHT; y++) {
+        // Bit x of fits: every footprint cell free with the top-left at x;
+        // of touches: some footprint cell near the house
+        uint64_t fits[ROW_WORDS];
+        uint64_t touches[ROW_WORDS] = {};
+        std::fill(fits, fits + ROW_WORDS, ~uint64_t(0));
+        for (int r = 0; r < mask.height; r++) {
+            const uint64_t* free_row = free_ + (y + r) * ROW_WORDS;
+            const uint64_t* near_row = near + (y + r) * ROW_WORDS;
+            for (int k = 0; k < mask.width; k++) {
+                if (!(mask.rows[r] & (1 << k))) {
+                    continue;
+                }
+                uint64_t shifted[ROW_WORDS];
+                Shift_Row(free_row, k, shifted);
+                for (int i = 0; i < ROW_WORDS; i++) {
+                    fits[i] &= shifted[i];
+                }
+                Shift_Row(near_row, k, shifted);
+                for (int i = 0; i < ROW_WORDS; i++) {
+                    touches[i] |= shifted[i];
+                }
+            }
+        }
+
+        for (int i = 0; i < ROW_WORDS; i++) {
+            uint64_t legal = fits[i] & touches[i];
+            out[y * ROW_WORDS + i] = legal;
+            count += __builtin_popcountll(legal);
+        }
+    }
+    return count;
+}
+
+CELL BuildMap::Find_Placement(HousesType house, BuildingType type, CELL near) {
+    uint64_t legal[PLANE_WORDS];
+    if (Legal_Placements(house, type, legal) == 0) {
+        return CELL_NONE;
+    }
+
+    int nx = Cell_X(near);
+    int ny = Cell_Y(near);
+    CELL best = CELL_NONE;
+    int best_distance = 0x7FFFFFFF;
+    for (int word = 0; word < PLANE_WORDS; word++) {
+        uint64_t bits = legal[word];
+        while (bits != 0) {
+            int index = (word << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            int x = index % MAP_CELL_WIDTH;
+            int y = index / MAP_CELL_WIDTH;
+            int distance = (x - nx) * (x - nx) + (y - ny) * (y - ny);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = XY_Cell(x, y);
+            }
+        }
+    }
+    return best;
+}
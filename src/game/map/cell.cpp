@@ -5,6 +5,8 @@
  */
 
 #include "game/cell.h"
+#include "game/map.h"
+#include "game/techno.h"
 #include <cstring>
 
 // =============================================================================
@@ -51,6 +53,9 @@ CellClass::CellClass()
     , is_bridge_(false)
     , is_waypoint_(false)
     , is_flag_(false)
+    , object_count_(0)
+    , occupancy_(0)
+    , techno_slot_(-1)
 {
     memset(objects_, 0, sizeof(objects_));
 }
@@ -66,6 +71,9 @@ void CellClass::Clear() {
     is_waypoint_ = false;
     is_flag_ = false;
     memset(objects_, 0, sizeof(objects_));
+    object_count_ = 0;
+    occupancy_ = 0;
+    techno_slot_ = -1;
 }
 
 // =============================================================================
@@ -76,6 +84,7 @@ void CellClass::Set_Template(uint8_t template_type, uint8_t icon) {
     template_type_ = template_type;
     template_icon_ = icon;
     Recalc_Land();
+    Flag_Changed();
 }
 
 // =============================================================================
@@ -86,6 +95,7 @@ void CellClass::Set_Overlay(OverlayType type, uint8_t data) {
     overlay_type_ = type;
     overlay_data_ = data;
     Recalc_Land();
+    Flag_Changed();
 }
 
 bool CellClass::Is_Tiberium() const {
@@ -124,9 +134,18 @@ void CellClass::Reduce_Tiberium(int amount) {
         overlay_type_ = OVERLAY_NONE_TYPE;
         overlay_data_ = 0;
         Recalc_Land();
+        Flag_Changed();
     }
 }
 
+void CellClass::Load_Terrain(uint8_t template_type, uint8_t icon, OverlayType overlay, uint8_t data) {
+    template_type_ = template_type;
+    template_icon_ = icon;
+    overlay_type_ = overlay;
+    overlay_data_ = data;
+    Recalc_Land();
+}
+
 // =============================================================================
 // Land Type
 // =============================================================================
@@ -146,6 +165,12 @@ void CellClass::Recalc_Land() {
         return;
     }
 
+    // A bridge deck is road whatever runs underneath
+    if (is_bridge_) {
+        land_type_ = LAND_ROAD;
+        return;
+    }
+
     // Check terrain template
     // (In full implementation, this would look up template land type)
     // For now, use simple heuristics based on template
@@ -156,14 +181,26 @@ void CellClass::Recalc_Land() {
     // Different templates map to water, rock, road, etc.
 }
 
+void CellClass::Set_Bridge(bool val) {
+    if (is_bridge_ != val) {
+        is_bridge_ = val;
+        Recalc_Land();
+        Flag_Changed();
+    }
+}
+
 bool CellClass::Is_Passable(bool is_naval, bool is_infantry) const {
+    return Is_Land_Passable(land_type_, is_naval, is_infantry);
+}
+
+bool CellClass::Is_Land_Passable(LandType land, bool is_naval, bool is_infantry) {
     if (is_naval) {
         // Naval units can only go on water
-        return (land_type_ == LAND_WATER);
+        return (land == LAND_WATER);
     }
 
     // Ground units
-    switch (land_type_) {
+    switch (land) {
         case LAND_WATER:
         case LAND_ROCK:
         case LAND_RIVER:
@@ -187,23 +224,46 @@ int CellClass::Get_Speed_Multiplier() const {
 
 void CellClass::Recalc() {
     Recalc_Land();
+
+    // Land type is mirrored in the map's packed layers
+    if (Map != nullptr) {
+        Map->Sync_Cell_Layers(cell_index_);
+    }
 }
 
 // =============================================================================
 // Visibility
 // =============================================================================
 
+void CellClass::Set_Visibility(CellVisibility vis) {
+    if (visibility_ != vis) {
+        visibility_ = vis;
+        Flag_Changed();
+    }
+}
+
 void CellClass::Reveal(bool make_visible) {
     if (make_visible) {
-        visibility_ = CELL_VISIBLE;
+        Set_Visibility(CELL_VISIBLE);
     } else if (visibility_ == CELL_SHROUD) {
-        visibility_ = CELL_EXPLORED;
+        Set_Visibility(CELL_EXPLORED);
     }
 }
 
 void CellClass::Shroud() {
     if (visibility_ == CELL_VISIBLE) {
-        visibility_ = CELL_EXPLORED;  // Was visible, now fogged
+        Set_Visibility(CELL_EXPLORED);  // Was visible, now fogged
+    }
+}
+
+// =============================================================================
+// Change Tracking
+// =============================================================================
+
+void CellClass::Flag_Changed() {
+    // Only the global map keeps a redraw bitmap; standalone cells are ignored
+    if (Map != nullptr) {
+        Map->Flag_Cell_Changed(cell_index_);
     }
 }
 
@@ -211,37 +271,130 @@ void CellClass::Shroud() {
 // Occupancy
 // =============================================================================
 
-bool CellClass::Add_Object(ObjectClass* obj) {
-    if (obj == nullptr) {
-        return false;
+namespace {
+
+// Where each spot stands within its cell, in leptons
+const uint8_t SpotLepton_X[SPOT_COUNT] = {0x80, 0x40, 0xC0, 0x40, 0xC0};
+const uint8_t SpotLepton_Y[SPOT_COUNT] = {0x80, 0x40, 0x40, 0xC0, 0xC0};
+
+} // namespace
+
+CellSpot CellClass::Coord_Spot(COORDINATE coord) {
+    int x = Coord_X(coord) & (LEPTON_PER_CELL - 1);
+    int y = Coord_Y(coord) & (LEPTON_PER_CELL - 1);
+
+    CellSpot best = SPOT_CENTER;
+    int best_distance = 0x7FFFFFFF;
+    for (int spot = 0; spot < SPOT_COUNT; spot++) {
+        int dx = x - SpotLepton_X[spot];
+        int dy = y - SpotLepton_Y[spot];
+        int distance = dx * dx + dy * dy;
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = static_cast<CellSpot>(spot);
+        }
     }
+    return best;
+}
 
-    // Find empty slot
-    for (int i = 0; i < CELL_MAX_OBJECTS; i++) {
-        if (objects_[i] == nullptr) {
-            objects_[i] = obj;
-            return true;
+COORDINATE CellClass::Spot_Coord(CELL cell, CellSpot spot) {
+    if (spot < 0 || spot >= SPOT_COUNT) {
+        spot = SPOT_CENTER;
+    }
+    return XY_Coord(Cell_X(cell) * LEPTON_PER_CELL + SpotLepton_X[spot],
+                    Cell_Y(cell) * LEPTON_PER_CELL + SpotLepton_Y[spot]);
+}
+
+CellSpot CellClass::Closest_Free_Spot(COORDINATE coord) const {
+    if (occupancy_ & OCCUPY_SOLID) {
+        return SPOT_NONE;
+    }
+
+    CellSpot preferred = Coord_Spot(coord);
+    if (!(occupancy_ & (1 << preferred))) {
+        return preferred;
+    }
+
+    // Nearest of the free ones, center first on ties
+    int x = Coord_X(coord) & (LEPTON_PER_CELL - 1);
+    int y = Coord_Y(coord) & (LEPTON_PER_CELL - 1);
+    CellSpot best = SPOT_NONE;
+    int best_distance = 0x7FFFFFFF;
+    for (int spot = 0; spot < SPOT_COUNT; spot++) {
+        if (occupancy_ & (1 << spot)) {
+            continue;
+        }
+        int dx = x - SpotLepton_X[spot];
+        int dy = y - SpotLepton_Y[spot];
+        int distance = dx * dx + dy * dy;
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = static_cast<CellSpot>(spot);
         }
     }
+    return best;
+}
 
-    return false;  // Cell full
+void CellClass::Occupy(const ObjectClass* obj, int slot) {
+    switch (obj->What_Am_I()) {
+        case RTTI_INFANTRY:
+            occupancy_ |= static_cast<uint8_t>(1 << Coord_Spot(obj->Get_Coord()));
+            break;
+        case RTTI_UNIT:
+        case RTTI_VESSEL:
+            occupancy_ |= OCCUPY_VEHICLE;
+            break;
+        case RTTI_BUILDING:
+            occupancy_ |= OCCUPY_BUILDING;
+            break;
+        case RTTI_AIRCRAFT:
+            occupancy_ |= OCCUPY_AIRCRAFT;
+            break;
+        default:
+            return;
+    }
+    if (techno_slot_ < 0) {
+        techno_slot_ = static_cast<int8_t>(slot);
+    }
 }
 
-void CellClass::Remove_Object(ObjectClass* obj) {
+bool CellClass::Add_Object(ObjectClass* obj) {
+    if (obj == nullptr || object_count_ == CELL_MAX_OBJECTS) {
+        return false;  // Cell full
+    }
+
+    int slot = object_count_++;
+    objects_[slot] = obj;
+    Occupy(obj, slot);
+    return true;
+}
+
+bool CellClass::Remove_Object(ObjectClass* obj) {
     if (obj == nullptr) {
-        return;
+        return false;
     }
 
-    for (int i = 0; i < CELL_MAX_OBJECTS; i++) {
+    for (int i = 0; i < object_count_; i++) {
         if (objects_[i] == obj) {
             // Shift remaining objects
             for (int j = i; j < CELL_MAX_OBJECTS - 1; j++) {
                 objects_[j] = objects_[j + 1];
             }
             objects_[CELL_MAX_OBJECTS - 1] = nullptr;
-            return;
+            object_count_--;
+
+            // Two infantry can report the same spot, so rebuild from the
+            // objects left rather than clearing the removed one's bit
+            occupancy_ = 0;
+            techno_slot_ = -1;
+            for (int j = 0; j < object_count_; j++) {
+                Occupy(objects_[j], j);
+            }
+            return true;
         }
     }
+
+    return false;
 }
 
 ObjectClass* CellClass::Get_Object(int index) const {
@@ -251,18 +404,9 @@ ObjectClass* CellClass::Get_Object(int index) const {
     return objects_[index];
 }
 
-int CellClass::Object_Count() const {
-    int count = 0;
-    for (int i = 0; i < CELL_MAX_OBJECTS; i++) {
-        if (objects_[i] != nullptr) {
-            count++;
-        }
-    }
-    return count;
-}
-
 TechnoClass* CellClass::Find_Techno() const {
-    // This would check each object's RTTI and return first techno
-    // For now, return nullptr (requires ObjectClass implementation)
-    return nullptr;
+    if (techno_slot_ < 0) {
+        return nullptr;
+    }
+    return static_cast<TechnoClass*>(objects_[techno_slot_]);
 }
@@ -0,0 +1,617 @@
+/**
+ * PathFinder Implementation
+ *
+ * Original location: CODE/FINDPATH.CPP
+ */
+
+#include "game/findpath.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include "game/zone_map.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+constexpr uint8_t FROM_NONE = 0xFF;
+
+inline int Index_X(int index) { return index % MAP_CELL_WIDTH; }
+inline int Index_Y(int index) { return index / MAP_CELL_WIDTH; }
+
+// Heap order for std::push_heap/pop_heap: lowest f first, then nearest
+// the goal so ties resolve toward it
+struct WorseNode {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a.f > b.f || (a.f == b.f && a.h > b.h);
+    }
+};
+
+} // namespace
+
+LocomotionType Locomotion_Of(RTTIType rtti) {
+    switch (rtti) {
+        case RTTI_INFANTRY:
+            return LOCO_FOOT;
+        case RTTI_VESSEL:
+            return LOCO_FLOAT;
+        case RTTI_AIRCRAFT:
+            return LOCO_FLY;
+        default:
+            return LOCO_TRACK;
+    }
+}
+
+int Land_Step_Cost(LocomotionType loco, int land) {
+    if (land < 0 || land >= LAND_COUNT) {
+        return 0;
+    }
+    if (loco == LOCO_FLY) {
+        return STEP_COST;
+    }
+    if (!CellClass::Is_Land_Passable((LandType)land, loco == LOCO_FLOAT, loco == LOCO_FOOT)) {
+        return 0;
+    }
+
+    // Slower ground costs more to cross; ships and wall-hopping infantry
+    // have no multiplier for what they cross
+    int multiplier = LandSpeedMultiplier[land];
+    if (loco == LOCO_FLOAT || multiplier <= 0) {
+        return STEP_COST;
+    }
+    return STEP_COST * 100 / multiplier;
+}
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+PathFinder& PathFinder::Instance() {
+    static PathFinder instance;
+    return instance;
+}
+
+PathFinder::PathFinder()
+    : map_(nullptr)
+    , map_revision_(0)
+    , land_(nullptr)
+    , map_bounds_{0, 0, -1, -1}
+    , search_gen_(0)
+    , seen_(MAP_CELL_TOTAL, 0)
+    , closed_(MAP_CELL_TOTAL, 0)
+    , cost_(MAP_CELL_TOTAL, 0)
+    , from_(MAP_CELL_TOTAL, FROM_NONE)
+    , stats_()
+{
+    for (int loco = 0; loco < LOCO_COUNT; loco++) {
+        min_cost_[loco] = STEP_COST;
+        for (int land = 0; land < 256; land++) {
+            int cost = Land_Step_Cost((LocomotionType)loco, land);
+            if (cost > 0) {
+                min_cost_[loco] = std::min<uint32_t>(min_cost_[loco], cost);
+            }
+            land_cost_[loco][land] = (uint16_t)cost;
+        }
+    }
+}
+
+void PathFinder::Invalidate() {
+    for (Graph& graph : graphs_) {
+        graph.built = false;
+        graph.nodes.clear();
+        for (std::vector<uint16_t>& ids : graph.cluster_nodes) {
+            ids.clear();
+        }
+    }
+    cache_.clear();
+    cache_index_.clear();
+}
+
+bool PathFinder::Sync_Map() {
+    if (Map == nullptr || Map->Get_Cell_Layers() == nullptr) {
+        return false;
+    }
+
+    // Any passability or bounds change makes the graphs and routes stale
+    if (Map != map_ || Map->Get_Land_Revision() != map_revision_) {
+        Invalidate();
+        map_ = Map;
+        map_revision_ = Map->Get_Land_Revision();
+        land_ = Map->Get_Cell_Layers()->land;
+        map_bounds_.x0 = Map->Map_Bounds_X();
+        map_bounds_.y0 = Map->Map_Bounds_Y();
+        map_bounds_.x1 = Map->Map_Bounds_X() + Map->Map_Bounds_Width() - 1;
+        map_bounds_.y1 = Map->Map_Bounds_Y() + Map->Map_Bounds_Height() - 1;
+    }
+    return true;
+}
+
+// =============================================================================
+// Cell Search
+// =============================================================================
+
+int PathFinder::Cell_Cost(LocomotionType loco, int index) const {
+    return land_cost_[loco][land_[index]];
+}
+
+uint32_t PathFinder::Heuristic(LocomotionType loco, int from, int to) const {
+    // Octile distance at the cheapest terrain, so it never overestimates
+    int dx = std::abs(Index_X(from) - Index_X(to));
+    int dy = std::abs(Index_Y(from) - Index_Y(to));
+    int straight = std::max(dx, dy);
+    int diagonal = std::min(dx, dy);
+    return min_cost_[loco] * (straight * 100 + diagonal * (DIAGONAL_PERCENT - 100)) / 100;
+}
+
+uint32_t PathFinder::Next_Generation() {
+    // Bumping the generation forgets the last search without clearing
+    if (++search_gen_ == 0) {
+        std::fill(seen_.begin(), seen_.end(), 0);
+        std::fill(closed_.begin(), closed_.end(), 0);
+        search_gen_ = 1;
+    }
+    return search_gen_;
+}
+
+bool PathFinder::Search(int start, int goal, LocomotionType loco, const Bounds& bounds) {
+    uint32_t gen = Next_Generation();
+    open_.clear();
+
+    seen_[start] = gen;
+    cost_[start] = 0;
+    from_[start] = FROM_NONE;
+    uint32_t h = goal >= 0 ? Heuristic(loco, start, goal) : 0;
+    open_.push_back({h, h, (uint16_t)start});
+
+    while (!open_.empty()) {
+        std::pop_heap(open_.begin(), open_.end(), WorseNode());
+        int index = open_.back().index;
+        open_.pop_back();
+
+        // Stale entry for a cell already reached more cheaply
+        if (closed_[index] == gen) {
+            continue;
+        }
+        closed_[index] = gen;
+        stats_.cells_expanded++;
+
+        if (index == goal) {
+            return true;
+        }
+
+        int x = Index_X(index);
+        int y = Index_Y(index);
+        uint32_t g = cost_[index];
+
+        for (int dir = 0; dir < FACING_COUNT; dir++) {
+            int nx = x + FacingOffset_X[dir];
+            int ny = y + FacingOffset_Y[dir];
+            if (nx < bounds.x0 || nx > bounds.x1 || ny < bounds.y0 || ny > bounds.y1) {
+                continue;
+            }
+
+            int next = ny * MAP_CELL_WIDTH + nx;
+            if (closed_[next] == gen) {
+                continue;
+            }
+
+            uint32_t step = Cell_Cost(loco, next);
+            if (step == 0) {
+                continue;
+            }
+            if (dir & 1) {
+                // No cutting corners past blocked cells
+                if (Cell_Cost(loco, y * MAP_CELL_WIDTH + nx) == 0 ||
+                    Cell_Cost(loco, ny * MAP_CELL_WIDTH + x) == 0) {
+                    continue;
+                }
+                step = step * DIAGONAL_PERCENT / 100;
+            }
+
+            uint32_t next_cost = g + step;
+            if (seen_[next] == gen && next_cost >= cost_[next]) {
+                continue;
+            }
+            seen_[next] = gen;
+            cost_[next] = next_cost;
+            from_[next] = (uint8_t)dir;
+
+            uint32_t next_h = goal >= 0 ? Heuristic(loco, next, goal) : 0;
+            open_.push_back({next_cost + next_h, next_h, (uint16_t)next});
+            std::push_heap(open_.begin(), open_.end(), WorseNode());
+        }
+    }
+
+    // Without a goal the search floods the bounds, which is the point
+    return goal < 0;
+}
+
+void PathFinder::Trace(int start, int goal, std::vector<CELL>& path) const {
+    size_t first = path.size();
+    for (int index = goal; index != start; ) {
+        path.push_back(XY_Cell(Index_X(index), Index_Y(index)));
+        int dir = from_[index];
+        index -= FacingOffset_Y[dir] * MAP_CELL_WIDTH + FacingOffset_X[dir];
+    }
+    std::reverse(path.begin() + first, path.end());
+}
+
+PathFinder::Bounds PathFinder::Cluster_Bounds(int cluster) const {
+    int x0 = (cluster % CLUSTERS_PER_ROW) * CLUSTER_SIZE;
+    int y0 = (cluster / CLUSTERS_PER_ROW) * CLUSTER_SIZE;
+    Bounds bounds;
+    bounds.x0 = std::max(x0, map_bounds_.x0);
+    bounds.y0 = std::max(y0, map_bounds_.y0);
+    bounds.x1 = std::min(x0 + CLUSTER_SIZE - 1, map_bounds_.x1);
+    bounds.y1 = std::min(y0 + CLUSTER_SIZE - 1, map_bounds_.y1);
+    return bounds;
+}
+
+int PathFinder::Cluster_Of(int index) {
+    return (Index_Y(index) >> CLUSTER_SHIFT) * CLUSTERS_PER_ROW + (Index_X(index) >> CLUSTER_SHIFT);
+}
+
+// =============================================================================
+// Cluster Graph
+// =============================================================================
+
+PathFinder::Graph& PathFinder::Get_Graph(LocomotionType loco) {
+    Graph& graph = graphs_[loco];
+    if (!graph.built) {
+        Build_Graph(loco, graph);
+    }
+    return graph;
+}
+
+int PathFinder::Graph_Node_Count(LocomotionType loco) {
+    if (loco >= LOCO_FLY || !Sync_Map()) {
+        return 0;
+    }
+    return static_cast<int>(Get_Graph(loco).nodes.size());
+}
+
+int PathFinder::Add_Entrance(Graph& graph, std::vector<int>& node_at, int index) {
+    if (node_at[index] >= 0) {
+        return node_at[index];
+    }
+
+    int id = static_cast<int>(graph.nodes.size());
+    GraphNode node;
+    node.index = (uint16_t)index;
+    node.cluster = (uint8_t)Cluster_Of(index);
+    graph.nodes.push_back(node);
+    graph.cluster_nodes[node.cluster].push_back((uint16_t)id);
+    node_at[index] = id;
+    return id;
+}
+
+void PathFinder::Link_Border(LocomotionType loco, Graph& graph, std::vector<int>& node_at,
+                             int ax, int ay, int bx, int by, int dx, int dy, int length) {
+    // Walk two facing rows of cells along a cluster border; each open run
+    // becomes an entrance pair, with one at each end of long runs
+    auto open_at = [&](int i) {
+        int x0 = ax + i * dx, y0 = ay + i * dy;
+        int x1 = bx + i * dx, y1 = by + i * dy;
+        if (x0 < map_bounds_.x0 || y0 < map_bounds_.y0 ||
+            x1 > map_bounds_.x1 || y1 > map_bounds_.y1) {
+            return false;
+        }
+        return Cell_Cost(loco, y0 * MAP_CELL_WIDTH + x0) != 0 &&
+               Cell_Cost(loco, y1 * MAP_CELL_WIDTH + x1) != 0;
+    };
+
+    auto link = [&](int i) {
+        int a = (ay + i * dy) * MAP_CELL_WIDTH + (ax + i * dx);
+        int b = (by + i * dy) * MAP_CELL_WIDTH + (bx + i * dx);
+        int na = Add_Entrance(graph, node_at, a);
+        int nb = Add_Entrance(graph, node_at, b);
+        graph.nodes[na].edges.push_back({(uint16_t)nb, (uint32_t)Cell_Cost(loco, b)});
+        graph.nodes[nb].edges.push_back({(uint16_t)na, (uint32_t)Cell_Cost(loco, a)});
+    };
+
+    int run_start = -1;
+    for (int i = 0; i <= length; i++) {
+        bool open = i < length && open_at(i);
+        if (open && run_start < 0) {
+            run_start = i;
+        } else if (!open && run_start >= 0) {
+            int run_end = i - 1;
+            if (run_end - run_start + 1 >= CLUSTER_SIZE / 2) {
+                link(run_start);
+                link(run_end);
+            } else {
+                link((run_start + run_end) / 2);
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void PathFinder::Build_Graph(LocomotionType loco, Graph& graph) {
+    graph.nodes.clear();
+    for (std::vector<uint16_t>& ids : graph.cluster_nodes) {
+        ids.clear();
+    }
+
+    // Entrances on every border between neighbouring clusters
+    std::vector<int> node_at(MAP_CELL_TOTAL, -1);
+    int rows = MAP_CELL_HEIGHT / CLUSTER_SIZE;
+    for (int cy = 0; cy < rows; cy++) {
+        for (int cx = 0; cx < CLUSTERS_PER_ROW; cx++) {
+            int x0 = cx * CLUSTER_SIZE;
+            int y0 = cy * CLUSTER_SIZE;
+            if (cx + 1 < CLUSTERS_PER_ROW) {
+                Link_Border(loco, graph, node_at, x0 + CLUSTER_SIZE - 1, y0, x0 + CLUSTER_SIZE, y0,
+                            0, 1, CLUSTER_SIZE);
+            }
+            if (cy + 1 < rows) {
+                Link_Border(loco, graph, node_at, x0, y0 + CLUSTER_SIZE - 1, x0, y0 + CLUSTER_SIZE,
+                            1, 0, CLUSTER_SIZE);
+            }
+        }
+    }
+
+    // Costs between entrances of the same cluster: one flood per entrance,
+    // kept inside the cluster
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        const std::vector<uint16_t>& ids = graph.cluster_nodes[cluster];
+        if (ids.size() < 2) {
+            continue;
+        }
+
+        Bounds bounds = Cluster_Bounds(cluster);
+        for (uint16_t from : ids) {
+            Search(graph.nodes[from].index, -1, loco, bounds);
+            for (uint16_t to : ids) {
+                int index = graph.nodes[to].index;
+                if (to != from && closed_[index] == search_gen_) {
+                    graph.nodes[from].edges.push_back({to, cost_[index]});
+                }
+            }
+        }
+    }
+
+    graph.built = true;
+}
+
+bool PathFinder::Plan_Route(int start, int goal, LocomotionType loco, std::vector<uint16_t>& route) {
+    Graph& graph = Get_Graph(loco);
+    int start_cluster = Cluster_Of(start);
+    int goal_cluster = Cluster_Of(goal);
+    int count = static_cast<int>(graph.nodes.size());
+    int target = count;     // Virtual node standing for the goal cell
+
+    std::vector<uint32_t> cost(count + 1, UINT32_MAX);
+    std::vector<uint32_t> to_goal(count, UINT32_MAX);
+    std::vector<int> parent(count + 1, -1);
+    std::vector<uint8_t> done(count + 1, 0);
+    std::vector<OpenNode> open;
+
+    auto heuristic = [&](int id) {
+        return id == target ? 0u : Heuristic(loco, graph.nodes[id].index, goal);
+    };
+    auto relax = [&](int id, int from, uint32_t next_cost) {
+        if (next_cost < cost[id]) {
+            cost[id] = next_cost;
+            parent[id] = from;
+            uint32_t h = heuristic(id);
+            open.push_back({next_cost + h, h, (uint16_t)id});
+            std::push_heap(open.begin(), open.end(), WorseNode());
+        }
+    };
+
+    // Cost of reaching each goal-cluster entrance's exit to the goal,
+    // measured from the goal end (close enough for planning)
+    Search(goal, -1, loco, Cluster_Bounds(goal_cluster));
+    for (uint16_t id : graph.cluster_nodes[goal_cluster]) {
+        int index = graph.nodes[id].index;
+        if (closed_[index] == search_gen_) {
+            to_goal[id] = cost_[index];
+        }
+    }
+
+    // Start from every entrance reachable inside the start cluster
+    Search(start, -1, loco, Cluster_Bounds(start_cluster));
+    for (uint16_t id : graph.cluster_nodes[start_cluster]) {
+        int index = graph.nodes[id].index;
+        if (closed_[index] == search_gen_) {
+            relax(id, -1, cost_[index]);
+        }
+    }
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), WorseNode());
+        int id = open.back().index;
+        open.pop_back();
+
+        if (done[id]) {
+            continue;
+        }
+        done[id] = 1;
+
+        if (id == target) {
+            break;
+        }
+        if (to_goal[id] != UINT32_MAX) {
+            relax(target, id, cost[id] + to_goal[id]);
+        }
+        for (const Edge& edge : graph.nodes[id].edges) {
+            if (!done[edge.to]) {
+                relax(edge.to, id, cost[id] + edge.cost);
+            }
+        }
+    }
+
+    if (!done[target]) {
+        return false;
+    }
+
+    route.clear();
+    for (int id = parent[target]; id >= 0; id = parent[id]) {
+        route.push_back((uint16_t)id);
+    }
+    std::reverse(route.begin(), route.end());
+    return true;
+}
+
+bool PathFinder::Refine(int start, int goal, LocomotionType loco, const std::vector<uint16_t>& route,
+                        std::vector<CELL>& path) {
+    const Graph& graph = graphs_[loco];
+    path.clear();
+
+    // Every leg stays inside one cluster or steps across one border
+    auto leg = [&](int from, int to) {
+        Bounds a = Cluster_Bounds(Cluster_Of(from));
+        Bounds b = Cluster_Bounds(Cluster_Of(to));
+        Bounds bounds = { std::min(a.x0, b.x0), std::min(a.y0, b.y0),
+                          std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+        if (!Search(from, to, loco, bounds)) {
+            return false;
+        }
+        Trace(from, to, path);
+        return true;
+    };
+
+    int current = start;
+    for (uint16_t id : route) {
+        int next = graph.nodes[id].index;
+        if (next == current) {
+            continue;
+        }
+        if (!leg(current, next)) {
+            return false;
+        }
+        current = next;
+    }
+    return current == goal || leg(current, goal);
+}
+
+// =============================================================================
+// Route Cache
+// =============================================================================
+
+const std::vector<uint16_t>* PathFinder::Cache_Find(uint32_t key) {
+    auto it = cache_index_.find(key);
+    if (it == cache_index_.end()) {
+        return nullptr;
+    }
+    cache_.splice(cache_.begin(), cache_, it->second);
+    return &it->second->route;
+}
+
+void PathFinder::Cache_Store(uint32_t key, const std::vector<uint16_t>& route) {
+    auto it = cache_index_.find(key);
+    if (it != cache_index_.end()) {
+        it->second->route = route;
+        cache_.splice(cache_.begin(), cache_, it->second);
+        return;
+    }
+
+    cache_.push_front({key, route});
+    cache_index_[key] = cache_.begin();
+    if (static_cast<int>(cache_.size()) > CACHE_SIZE) {
+        cache_index_.erase(cache_.back().key);
+        cache_.pop_back();
+    }
+}
+
+// =============================================================================
+// Find_Path
+// =============================================================================
+
+bool PathFinder::Find_Path(CELL start, CELL goal, LocomotionType loco, std::vector<CELL>& path) {
+    stats_.paths++;
+    path.clear();
+
+    if (start == CELL_NONE || goal == CELL_NONE) {
+        return false;
+    }
+    if (loco == LOCO_FLY) {
+        path.push_back(goal);
+        return true;
+    }
+    if (!Sync_Map()) {
+        return false;
+    }
+
+    int gx = Cell_X(goal);
+    int gy = Cell_Y(goal);
+    if (gx < map_bounds_.x0 || gx > map_bounds_.x1 || gy < map_bounds_.y0 || gy > map_bounds_.y1) {
+        return false;
+    }
+
+    int from = MapClass::Layer_Index(Cell_X(start), Cell_Y(start));
+    int to = MapClass::Layer_Index(gx, gy);
+    if (Cell_Cost(loco, to) == 0) {
+        return false;
+    }
+    if (from == to) {
+        return true;
+    }
+
+    // Goals in another zone would flood the whole map only to fail
+    const ZoneMap* zones = Map->Get_Zones();
+    if (zones && !zones->Can_Reach(loco, start, goal)) {
+        stats_.unreachable++;
+        return false;
+    }
+
+    // Nearby goals: a plain search is cheaper than going through the graph
+    int start_cluster = Cluster_Of(from);
+    int goal_cluster = Cluster_Of(to);
+    int cluster_dx = std::abs(start_cluster % CLUSTERS_PER_ROW - goal_cluster % CLUSTERS_PER_ROW);
+    int cluster_dy = std::abs(start_cluster / CLUSTERS_PER_ROW - goal_cluster / CLUSTERS_PER_ROW);
+    if (std::max(cluster_dx, cluster_dy) <= 1) {
+        if (!Search(from, to, loco, map_bounds_)) {
+            return false;
+        }
+        Trace(from, to, path);
+        return true;
+    }
+
+    uint32_t key = (uint32_t)start_cluster | ((uint32_t)goal_cluster << 8) | ((uint32_t)loco << 16);
+    Get_Graph(loco);
+    const std::vector<uint16_t>* cached = Cache_Find(key);
+    if (cached && Refine(from, to, loco, *cached, path)) {
+        stats_.cache_hits++;
+        return true;
+    }
+
+    stats_.cache_misses++;
+    std::vector<uint16_t> route;
+    if (!Plan_Route(from, to, loco, route)) {
+        path.clear();
+        return false;
+    }
+    Cache_Store(key, route);
+    return Refine(from, to, loco, route, path);
+}
+
+// =============================================================================
+// Waypoints
+// =============================================================================
+
+int Path_Waypoints(CELL start, const std::vector<CELL>& path, COORDINATE dest,
+                   COORDINATE* out, int max) {
+    int count = 0;
+    CELL prev = start;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        int in_x = Cell_X(path[i]) - Cell_X(prev);
+        int in_y = Cell_Y(path[i]) - Cell_Y(prev);
+        int out_x = Cell_X(path[i + 1]) - Cell_X(path[i]);
+        int out_y = Cell_Y(path[i + 1]) - Cell_Y(path[i]);
+        if (in_x != out_x || in_y != out_y) {
+            if (count == max) {
+                return count;
+            }
+            out[count++] = Cell_Coord(path[i]);
+        }
+        prev = path[i];
+    }
+
+    if (count < max) {
+        out[count++] = dest;
+    }
+    return count;
+}
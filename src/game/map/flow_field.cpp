@@ -0,0 +1,261 @@
+/**
+ * FlowField Implementation
+ */
+
+#include "game/flow_field.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include <algorithm>
+
+namespace {
+
+struct FloodNode {
+    uint32_t cost;
+    uint16_t index;
+
+    bool operator>(const FloodNode& other) const { return cost > other.cost; }
+};
+
+// Most recently used first
+std::vector<std::shared_ptr<FlowField>>& Field_Cache() {
+    static std::vector<std::shared_ptr<FlowField>> cache;
+    return cache;
+}
+
+} // namespace
+
+// =============================================================================
+// Cache
+// =============================================================================
+
+std::shared_ptr<const FlowField> FlowField::Acquire(CELL target, LocomotionType loco) {
+    std::vector<std::shared_ptr<FlowField>>& cache = Field_Cache();
+    for (size_t i = 0; i < cache.size(); i++) {
+        std::shared_ptr<FlowField> field = cache[i];
+        if (field->target_ == target && field->loco_ == loco && field->Is_Current()) {
+            cache.erase(cache.begin() + i);
+            cache.insert(cache.begin(), field);
+            return field;
+        }
+    }
+
+    std::shared_ptr<FlowField> field = std::make_shared<FlowField>();
+    if (!field->Build(target, loco)) {
+        return nullptr;
+    }
+
+    // Units still following an evicted field keep it alive themselves
+    cache.insert(cache.begin(), field);
+    if (static_cast<int>(cache.size()) > CACHE_SIZE) {
+        cache.pop_back();
+    }
+    return field;
+}
+
+void FlowField::Flush_Cache() {
+    Field_Cache().clear();
+}
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+FlowField::FlowField()
+    : target_(CELL_NONE)
+    , loco_(LOCO_TRACK)
+    , map_(nullptr)
+    , revision_(0)
+{
+}
+
+bool FlowField::Is_Current() const {
+    return map_ != nullptr && map_ == Map && map_->Get_Land_Revision() == revision_;
+}
+
+bool FlowField::Build(CELL target, LocomotionType loco) {
+    target_ = CELL_NONE;
+    map_ = nullptr;
+    if (Map == nullptr || Map->Get_Cell_Layers() == nullptr || !Map->Is_In_Bounds(target)) {
+        return false;
+    }
+
+    const uint8_t* land = Map->Get_Cell_Layers()->land;
+    uint32_t step_cost[256];
+    for (int i = 0; i < 256; i++) {
+        step_cost[i] = Land_Step_Cost(loco, i);
+    }
+
+    int tx = Cell_X(target);
+    int ty = Cell_Y(target);
+    int target_index = MapClass::Layer_Index(tx, ty);
+    if (step_cost[land[target_index]] == 0) {
+        return false;
+    }
+
+    int x0 = Map->Map_Bounds_X();
+    int y0 = Map->Map_Bounds_Y();
+    int x1 = x0 + Map->Map_Bounds_Width() - 1;
+    int y1 = y0 + Map->Map_Bounds_Height() - 1;
+    auto in_bounds = [&](int x, int y) { return x >= x0 && x <= x1 && y >= y0 && y <= y1; };
+
+    cost_.assign(MAP_CELL_TOTAL, UNREACHABLE);
+    flow_.assign(MAP_CELL_TOTAL, NO_FLOW);
+
+    // Integration: flood outward from the target. A neighbour's cost is
+    // this cell's plus the price of stepping into this cell from there.
+    std::vector<FloodNode> open;
+    open.push_back({0, (uint16_t)target_index});
+    cost_[target_index] = 0;
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<FloodNode>());
+        FloodNode node = open.back();
+        open.pop_back();
+        if (node.cost > cost_[node.index]) {
+            continue;
+        }
+
+        int x = node.index % MAP_CELL_WIDTH;
+        int y = node.index / MAP_CELL_WIDTH;
+        uint32_t enter = step_cost[land[node.index]];
+
+        for (int dir = 0; dir < FACING_COUNT; dir++) {
+            int nx = x + FacingOffset_X[dir];
+            int ny = y + FacingOffset_Y[dir];
+            if (!in_bounds(nx, ny)) {
+                continue;
+            }
+            int next = MapClass::Layer_Index(nx, ny);
+            if (step_cost[land[next]] == 0) {
+                continue;
+            }
+
+            uint32_t step = enter;
+            if (dir & 1) {
+                // Same corner rule as PathFinder
+                if (step_cost[land[MapClass::Layer_Index(nx, y)]] == 0 ||
+                    step_cost[land[MapClass::Layer_Index(x, ny)]] == 0) {
+                    continue;
+                }
+                step = step * DIAGONAL_PERCENT / 100;
+            }
+
+            uint32_t next_cost = node.cost + step;
+            if (next_cost < cost_[next]) {
+                cost_[next] = next_cost;
+                open.push_back({next_cost, (uint16_t)next});
+                std::push_heap(open.begin(), open.end(), std::greater<FloodNode>());
+            }
+        }
+    }
+
+    // Flow: every reachable cell points at the neighbour it was reached
+    // through, i.e. the one whose cost plus the step there is least
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            int index = MapClass::Layer_Index(x, y);
+            if (index == target_index || cost_[index] == UNREACHABLE) {
+                continue;
+            }
+
+            uint32_t best = UNREACHABLE;
+            for (int dir = 0; dir < FACING_COUNT; dir++) {
+                int nx = x + FacingOffset_X[dir];
+                int ny = y + FacingOffset_Y[dir];
+                if (!in_bounds(nx, ny)) {
+                    continue;
+                }
+                int next = MapClass::Layer_Index(nx, ny);
+                if (cost_[next] == UNREACHABLE) {
+                    continue;
+                }
+
+                uint32_t step = step_cost[land[next]];
+                if (dir & 1) {
+                    if (step_cost[land[MapClass::Layer_Index(nx, y)]] == 0 ||
+                        step_cost[land[MapClass::Layer_Index(x, ny)]] == 0) {
+                        continue;
+                    }
+                    step = step * DIAGONAL_PERCENT / 100;
+                }
+                if (cost_[next] + step < best) {
+                    best = cost_[next] + step;
+                    flow_[index] = (uint8_t)dir;
+                }
+            }
+        }
+    }
+
+    target_ = target;
+    loco_ = loco;
+    map_ = Map;
+    revision_ = Map->Get_Land_Revision();
+    return true;
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+bool FlowField::In_Field(CELL cell) {
+    return cell != CELL_NONE && Cell_X(cell) < MAP_CELL_WIDTH && Cell_Y(cell) < MAP_CELL_HEIGHT;
+}
+
+uint32_t FlowField::Cost(CELL cell) const {
+    if (cost_.empty() || !In_Field(cell)) {
+        return UNREACHABLE;
+    }
+    return cost_[MapClass::Layer_Index(Cell_X(cell), Cell_Y(cell))];
+}
+
+uint8_t FlowField::Next_Direction(CELL cell) const {
+    if (flow_.empty() || !In_Field(cell)) {
+        return NO_FLOW;
+    }
+    return flow_[MapClass::Layer_Index(Cell_X(cell), Cell_Y(cell))];
+}
+
+CELL FlowField::Next_Cell(CELL cell) const {
+    uint8_t dir = Next_Direction(cell);
+    if (dir == NO_FLOW) {
+        return CELL_NONE;
+    }
+    return XY_Cell(Cell_X(cell) + FacingOffset_X[dir], Cell_Y(cell) + FacingOffset_Y[dir]);
+}
+
+bool FlowField::Trace(CELL start, std::vector<CELL>& path) const {
+    path.clear();
+    if (target_ == CELL_NONE || !In_Field(start)) {
+        return false;
+    }
+
+    CELL cell = start;
+    if (!Is_Reachable(cell)) {
+        // Standing somewhere impassable (a doorway, a wreck): step off to
+        // the cheapest reachable neighbour first
+        CELL best = CELL_NONE;
+        for (int dir = 0; dir < FACING_COUNT; dir++) {
+            int nx = Cell_X(start) + FacingOffset_X[dir];
+            int ny = Cell_Y(start) + FacingOffset_Y[dir];
+            if (nx < 0 || ny < 0 || nx >= MAP_CELL_WIDTH || ny >= MAP_CELL_HEIGHT) {
+                continue;
+            }
+            CELL next = XY_Cell(nx, ny);
+            if (Cost(next) < Cost(best)) {
+                best = next;
+            }
+        }
+        if (best == CELL_NONE) {
+            return false;
+        }
+        cell = best;
+        path.push_back(cell);
+    }
+
+    // Costs fall strictly along the flow, so this ends at the target
+    while (cell != target_) {
+        cell = Next_Cell(cell);
+        path.push_back(cell);
+    }
+    return true;
+}
@@ -0,0 +1,329 @@
+/**
+ * TiberiumGrowth and OreFields Implementation
+ */
+
+#include "game/tiberium.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include <algorithm>
+#include <cstring>
+
+TiberiumGrowth::TiberiumGrowth()
+    : slot_(MAP_CELL_TOTAL, -1)
+    , cursor_(0)
+    , spread_turn_(0)
+    , budget_(TIBERIUM_GROWTH_BUDGET)
+    , stats_()
+{
+}
+
+void TiberiumGrowth::Clear() {
+    for (CELL cell : cells_) {
+        slot_[Index(cell)] = -1;
+    }
+    cells_.clear();
+    cursor_ = 0;
+    spread_turn_ = 0;
+}
+
+bool TiberiumGrowth::Contains(CELL cell) const {
+    return Is_Map_Cell(cell) && slot_[Index(cell)] >= 0;
+}
+
+// =============================================================================
+// Set Maintenance
+// =============================================================================
+
+bool TiberiumGrowth::Is_Growing(uint8_t overlay) {
+    return overlay <= OVERLAY_GOLD4;
+}
+
+void TiberiumGrowth::Overlay_Changed(CELL cell, uint8_t old_overlay, uint8_t new_overlay) {
+    bool was = Is_Growing(old_overlay);
+    bool is = Is_Growing(new_overlay);
+    if (is && !was) {
+        Add(cell);
+    } else if (was && !is) {
+        Remove(cell);
+    }
+}
+
+void TiberiumGrowth::Add(CELL cell) {
+    if (!Is_Map_Cell(cell) || slot_[Index(cell)] >= 0) {
+        return;
+    }
+    slot_[Index(cell)] = static_cast<int16_t>(cells_.size());
+    cells_.push_back(cell);
+}
+
+void TiberiumGrowth::Remove(CELL cell) {
+    if (!Contains(cell)) {
+        return;
+    }
+
+    // Swap the last cell into the hole; the order is only a visiting order
+    int index = slot_[Index(cell)];
+    CELL last = cells_.back();
+    cells_[index] = last;
+    slot_[Index(last)] = static_cast<int16_t>(index);
+    cells_.pop_back();
+    slot_[Index(cell)] = -1;
+}
+
+// =============================================================================
+// Growth
+// =============================================================================
+
+void TiberiumGrowth::Update(MapClass& map) {
+    // Cells seeded this pass join the end of the round
+    int visits = std::min(budget_, Count());
+    for (int i = 0; i < visits && !cells_.empty(); i++) {
+        if (cursor_ >= cells_.size()) {
+            cursor_ = 0;
+        }
+        CELL cell = cells_[cursor_++];
+        stats_.visited++;
+
+        if (map[cell].Get_Overlay() < OVERLAY_GOLD4) {
+            Grow(map, cell);
+        } else {
+            Spread(map, cell);
+        }
+    }
+}
+
+void TiberiumGrowth::Grow(MapClass& map, CELL cell) {
+    CellClass& c = map[cell];
+    c.Set_Overlay(static_cast<OverlayType>(c.Get_Overlay() + 1), c.Get_Overlay_Data());
+    stats_.grown++;
+}
+
+void TiberiumGrowth::Spread(MapClass& map, CELL cell) {
+    const CellLayers* layers = map.Get_Cell_Layers();
+    if (layers == nullptr) {
+        return;
+    }
+
+    // Start from a different side each time so fields grow round
+    int first = static_cast<int>(spread_turn_++ & 7);
+    int cx = Cell_X(cell);
+    int cy = Cell_Y(cell);
+    for (int i = 0; i < 8; i++) {
+        int facing = (first + i) & 7;
+        int x = cx + FacingOffset_X[facing];
+        int y = cy + FacingOffset_Y[facing];
+        if (!map.Is_In_Bounds(x, y)) {
+            continue;
+        }
+
+        int index = MapClass::Layer_Index(x, y);
+        if (layers->land[index] != LAND_CLEAR || layers->overlay[index] != static_cast<uint8_t>(OVERLAY_NONE_TYPE)) {
+            continue;
+        }
+        CellClass& target = map[XY_Cell(x, y)];
+        if (target.Is_Occupied()) {
+            continue;
+        }
+
+        target.Set_Overlay(OVERLAY_GOLD1, map[cell].Get_Overlay_Data());
+        stats_.spread++;
+        return;
+    }
+}
+
+// =============================================================================
+// OreFields
+// =============================================================================
+
+OreFields::OreFields()
+    : field_slot_(BLOCK_TOTAL, -1)
+    , count_(0)
+    , total_value_(0)
+{
+    memset(blocks_, 0, sizeof(blocks_));
+}
+
+void OreFields::Clear() {
+    for (int16_t block : fields_) {
+        blocks_[block] = Block();
+        field_slot_[block] = -1;
+    }
+    fields_.clear();
+    count_ = 0;
+    total_value_ = 0;
+}
+
+int OreFields::Overlay_Value(uint8_t overlay) {
+    if (overlay <= OVERLAY_GOLD4) {
+        return 25 * (overlay - OVERLAY_GOLD1 + 1);
+    }
+    if (overlay <= OVERLAY_GEMS4) {
+        return 50 * (overlay - OVERLAY_GEMS1 + 1);
+    }
+    return 0;
+}
+
+bool OreFields::Contains(CELL cell) const {
+    if (!Is_Map_Cell(cell)) {
+        return false;
+    }
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    return (blocks_[Block_Of(x, y)].mask >> Bit_Of(x, y)) & 1;
+}
+
+void OreFields::Overlay_Changed(CELL cell, uint8_t old_overlay, uint8_t new_overlay) {
+    if (!Is_Map_Cell(cell)) {
+        return;
+    }
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    int index = Block_Of(x, y);
+    Block& block = blocks_[index];
+    uint64_t bit = uint64_t(1) << Bit_Of(x, y);
+    bool was = (block.mask & bit) != 0;
+    int value = Overlay_Value(new_overlay);
+
+    // The old overlay only counts if this cell was tracked; the layers start
+    // out zeroed, which reads as ore that was never there
+    int old_value = was ? Overlay_Value(old_overlay) : 0;
+    block.value += value - old_value;
+    total_value_ += value - old_value;
+
+    if (value > 0 && !was) {
+        block.mask |= bit;
+        block.sum_x += x;
+        block.sum_y += y;
+        count_++;
+        if (field_slot_[index] < 0) {
+            field_slot_[index] = static_cast<int16_t>(fields_.size());
+            fields_.push_back(static_cast<int16_t>(index));
+        }
+    } else if (value == 0 && was) {
+        block.mask &= ~bit;
+        block.sum_x -= x;
+        block.sum_y -= y;
+        count_--;
+        if (block.mask == 0) {
+            int slot = field_slot_[index];
+            int16_t last = fields_.back();
+            fields_[slot] = last;
+            field_slot_[last] = static_cast<int16_t>(slot);
+            fields_.pop_back();
+            field_slot_[index] = -1;
+        }
+    }
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+void OreFields::Scan_Block(int block, uint64_t mask, int x, int y, CELL& best, int& best_d2) {
+    int base_x = (block % BLOCKS_PER_ROW) << BLOCK_SHIFT;
+    int base_y = (block / BLOCKS_PER_ROW) << BLOCK_SHIFT;
+    while (mask != 0) {
+        int bit = __builtin_ctzll(mask);
+        mask &= mask - 1;
+        int cx = base_x + (bit & (BLOCK_SIZE - 1));
+        int cy = base_y + (bit >> BLOCK_SHIFT);
+        int dx = cx - x;
+        int dy = cy - y;
+        int d2 = dx * dx + dy * dy;
+        CELL cell = XY_Cell(cx, cy);
+        if (d2 < best_d2 || (d2 == best_d2 && cell < best)) {
+            best = cell;
+            best_d2 = d2;
+        }
+    }
+}
+
+CELL OreFields::Nearest_Ore(CELL from, int max_range) const {
+    if (!Is_Map_Cell(from) || count_ == 0 || max_range < 0) {
+        return CELL_NONE;
+    }
+
+    int x = Cell_X(from);
+    int y = Cell_Y(from);
+    int bx = x >> BLOCK_SHIFT;
+    int by = y >> BLOCK_SHIFT;
+    int rows = MAP_CELL_HEIGHT / BLOCK_SIZE;
+
+    CELL best = CELL_NONE;
+    int best_d2 = max_range * max_range + 1;
+    for (int ring = 0; ring < BLOCKS_PER_ROW || ring < rows; ring++) {
+        // Every cell of ring r is at least (r - 1) * 8 + 1 cells away on one axis
+        if (ring > 0) {
+            int near = (ring - 1) * BLOCK_SIZE + 1;
+            if (near * near > best_d2) {
+                break;
+            }
+        }
+
+        for (int ry = by - ring; ry <= by + ring; ry++) {
+            if (ry < 0 || ry >= rows) {
+                continue;
+            }
+            // Whole rows at the top and bottom of the ring, two blocks between
+            bool edge = (ry == by - ring || ry == by + ring);
+            int step = edge ? 1 : 2 * ring;
+            for (int rx = bx - ring; rx <= bx + ring; rx += step) {
+                if (rx < 0 || rx >= BLOCKS_PER_ROW) {
+                    continue;
+                }
+                int block = ry * BLOCKS_PER_ROW + rx;
+                if (blocks_[block].mask != 0) {
+                    Scan_Block(block, blocks_[block].mask, x, y, best, best_d2);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+OreFields::Field OreFields::Make_Field(int block) const {
+    const Block& b = blocks_[block];
+    int cells = __builtin_popcountll(b.mask);
+    int cx = (b.sum_x + cells / 2) / cells;
+    int cy = (b.sum_y + cells / 2) / cells;
+
+    Field field;
+    field.centroid = CELL_NONE;
+    int d2 = INT32_MAX;
+    Scan_Block(block, b.mask, cx, cy, field.centroid, d2);
+    field.cells = cells;
+    field.value = b.value;
+    return field;
+}
+
+bool OreFields::Richest_Field(CELL from, int max_range, Field& out) const {
+    if (!Is_Map_Cell(from) || fields_.empty()) {
+        return false;
+    }
+
+    int x = Cell_X(from);
+    int y = Cell_Y(from);
+    int range2 = max_range * max_range;
+    bool found = false;
+    int best_d2 = 0;
+    for (int16_t block : fields_) {
+        const Block& b = blocks_[block];
+        if (found && b.value < out.value) {
+            continue;
+        }
+        Field field = Make_Field(block);
+        int dx = Cell_X(field.centroid) - x;
+        int dy = Cell_Y(field.centroid) - y;
+        int d2 = dx * dx + dy * dy;
+        if (d2 > range2) {
+            continue;
+        }
+        if (!found || field.value > out.value || d2 < best_d2 ||
+            (d2 == best_d2 && field.centroid < out.centroid)) {
+            out = field;
+            best_d2 = d2;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,155 @@
+/**
+ * VisionMap Implementation
+ */
+
+#include "game/vision_map.h"
+#include <algorithm>
+#include <cstring>
+
+VisionMap::VisionMap(int width, int height)
+    : width_(std::max(width, 0))
+    , height_(std::max(height, 0))
+    , row_words_((width_ + 63) / 64)
+    , plane_words_(row_words_ * height_)
+    , visible_(static_cast<size_t>(HOUSE_COUNT) * plane_words_)
+    , explored_(static_cast<size_t>(HOUSE_COUNT) * plane_words_) {
+    // Same circle as MapClass::Reveal_Area: dx*dx + dy*dy <= r*r
+    for (int r = 0; r <= MAX_SIGHT; r++) {
+        for (int dy = -MAX_SIGHT; dy <= MAX_SIGHT; dy++) {
+            int half = -1;
+            if (dy >= -r && dy <= r) {
+                half = 0;
+                while ((half + 1) * (half + 1) + dy * dy <= r * r) {
+                    half++;
+                }
+            }
+            span_[r][dy + MAX_SIGHT] = static_cast<int8_t>(half);
+        }
+    }
+    Clear();
+}
+
+void VisionMap::Clear() {
+    std::fill(visible_.begin(), visible_.end(), 0);
+    std::fill(explored_.begin(), explored_.end(), 0);
+    for (std::vector<Sighter>& list : sighters_) {
+        list.clear();
+    }
+    dirty_ = 0;
+}
+
+void VisionMap::Load_Planes(HousesType house, const uint64_t* visible, const uint64_t* explored) {
+    if (!Is_House(house)) {
+        return;
+    }
+    memcpy(Plane(visible_, house), visible, plane_words_ * sizeof(uint64_t));
+    memcpy(Plane(explored_, house), explored, plane_words_ * sizeof(uint64_t));
+}
+
+// =============================================================================
+// Sighters
+// =============================================================================
+
+void VisionMap::Add_Sight(HousesType house, CELL cell, int range) {
+    if (cell != CELL_NONE) {
+        Add_Sight(house, Cell_X(cell), Cell_Y(cell), range);
+    }
+}
+
+void VisionMap::Remove_Sight(HousesType house, CELL cell, int range) {
+    if (cell != CELL_NONE) {
+        Remove_Sight(house, Cell_X(cell), Cell_Y(cell), range);
+    }
+}
+
+void VisionMap::Explore(HousesType house, CELL cell, int range) {
+    if (cell != CELL_NONE) {
+        Explore(house, Cell_X(cell), Cell_Y(cell), range);
+    }
+}
+
+void VisionMap::Add_Sight(HousesType house, int x, int y, int range) {
+    if (!Is_House(house) || x < 0 || x >= width_ || y < 0 || y >= height_ || range <= 0) {
+        return;
+    }
+    sighters_[house].push_back({XY_Wide_Cell(x, y), std::min(range, MAX_SIGHT)});
+    dirty_ |= 1u << house;
+}
+
+void VisionMap::Remove_Sight(HousesType house, int x, int y, int range) {
+    if (!Is_House(house) || x < 0 || x >= width_ || y < 0 || y >= height_ || range <= 0) {
+        return;
+    }
+
+    WIDE_CELL cell = XY_Wide_Cell(x, y);
+    range = std::min(range, MAX_SIGHT);
+    std::vector<Sighter>& list = sighters_[house];
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].cell == cell && list[i].range == range) {
+            list[i] = list.back();
+            list.pop_back();
+            dirty_ |= 1u << house;
+            return;
+        }
+    }
+}
+
+void VisionMap::Explore(HousesType house, int x, int y, int range) {
+    if (!Is_House(house) || x < 0 || x >= width_ || y < 0 || y >= height_ || range < 0) {
+        return;
+    }
+    Or_Circle(Plane(explored_, house), x, y, std::min(range, MAX_SIGHT));
+}
+
+uint32_t VisionMap::Update() {
+    uint32_t rebuilt = dirty_;
+    for (int house = 0; house < HOUSE_COUNT; house++) {
+        if ((rebuilt & (1u << house)) == 0) {
+            continue;
+        }
+
+        uint64_t* visible = Plane(visible_, static_cast<HousesType>(house));
+        uint64_t* explored = Plane(explored_, static_cast<HousesType>(house));
+        memset(visible, 0, plane_words_ * sizeof(uint64_t));
+        for (const Sighter& sighter : sighters_[house]) {
+            Or_Circle(visible, Wide_Cell_X(sighter.cell), Wide_Cell_Y(sighter.cell), sighter.range);
+        }
+        for (int i = 0; i < plane_words_; i++) {
+            explored[i] |= visible[i];
+        }
+    }
+    dirty_ = 0;
+    return rebuilt;
+}
+
+// =============================================================================
+// Bit Operations
+// =============================================================================
+
+bool VisionMap::Test(const std::vector<uint64_t>& planes, HousesType house, int x, int y) const {
+    if (!Is_House(house) || x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return false;
+    }
+    return (Plane(planes, house)[y * row_words_ + (x >> 6)] >> (x & 63)) & 1;
+}
+
+void VisionMap::Or_Circle(uint64_t* plane, int cx, int cy, int range) const {
+    const int8_t* span = span_[range] + MAX_SIGHT;
+
+    int y1 = std::max(0, cy - range);
+    int y2 = std::min(height_ - 1, cy + range);
+    for (int y = y1; y <= y2; y++) {
+        int half = span[y - cy];
+        int x1 = std::max(0, cx - half);
+        int x2 = std::min(width_ - 1, cx + half);
+        uint64_t* row = plane + y * row_words_;
+
+        // Set bits x1..x2, one word at a time
+        for (int word = x1 >> 6; word <= x2 >> 6; word++) {
+            int lo = std::max(x1, word << 6) & 63;
+            int hi = std::min(x2, (word << 6) + 63) & 63;
+            uint64_t bits = (hi == 63 ? ~0ull : (1ull << (hi + 1)) - 1) & (~0ull << lo);
+            row[word] |= bits;
+        }
+    }
+}
@@ -0,0 +1,325 @@
+/**
+ * ZoneMap Implementation
+ */
+
+#include "game/zone_map.h"
+#include "game/map.h"
+#include <algorithm>
+
+// Orthogonal neighbours; zones never join through a diagonal alone
+static const int ORTHO_DX[4] = { 0, 1, 0, -1 };
+static const int ORTHO_DY[4] = { -1, 0, 1, 0 };
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+ZoneMap::ZoneMap()
+    : valid_(false)
+    , land_(nullptr)
+    , x0_(0)
+    , y0_(0)
+    , x1_(-1)
+    , y1_(-1)
+    , relabelled_(0)
+    , mark_gen_(0)
+{
+    for (int loco = 0; loco < ZONED_COUNT; loco++) {
+        for (int land = 0; land < 256; land++) {
+            open_[loco][land] = Land_Step_Cost((LocomotionType)loco, land) > 0;
+        }
+    }
+}
+
+void ZoneMap::Rebuild(const uint8_t* land, int x0, int y0, int x1, int y1) {
+    land_ = land;
+    x0_ = x0;
+    y0_ = y0;
+    x1_ = x1;
+    y1_ = y1;
+    relabelled_ = 0;
+    valid_ = land != nullptr;
+    if (!valid_) {
+        return;
+    }
+
+    queue_.reserve(MAP_CELL_TOTAL);
+    mark_.assign(MAP_CELL_TOTAL, 0);
+    mark_gen_ = 0;
+
+    for (int loco = 0; loco < ZONED_COUNT; loco++) {
+        Layer& layer = layers_[loco];
+        layer.zone.assign(MAP_CELL_TOTAL, NO_ZONE);
+        layer.size.assign(1, 0);
+
+        for (int y = y0_; y <= y1_; y++) {
+            for (int x = x0_; x <= x1_; x++) {
+                int index = MapClass::Layer_Index(x, y);
+                if (layer.zone[index] == NO_ZONE && Is_Open(loco, x, y)) {
+                    uint16_t zone = New_Zone(layer);
+                    layer.size[zone] = Relabel(loco, index, zone);
+                }
+            }
+        }
+    }
+    relabelled_ = 0;
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+bool ZoneMap::Is_Open(int loco, int x, int y) const {
+    return In_Bounds(x, y) && open_[loco][land_[MapClass::Layer_Index(x, y)]];
+}
+
+uint16_t ZoneMap::Get_Zone(LocomotionType loco, int x, int y) const {
+    if (!valid_ || loco >= ZONED_COUNT || !In_Bounds(x, y)) {
+        return NO_ZONE;
+    }
+    return layers_[loco].zone[MapClass::Layer_Index(x, y)];
+}
+
+bool ZoneMap::Can_Reach(LocomotionType loco, CELL from, CELL to) const {
+    if (!valid_ || loco >= ZONED_COUNT) {
+        return true;
+    }
+    if (from == CELL_NONE || to == CELL_NONE) {
+        return false;
+    }
+
+    uint16_t goal = Get_Zone(loco, Cell_X(to), Cell_Y(to));
+    if (goal == NO_ZONE) {
+        return false;
+    }
+
+    int x = Cell_X(from);
+    int y = Cell_Y(from);
+    uint16_t start = Get_Zone(loco, x, y);
+    if (start != NO_ZONE) {
+        return start == goal;
+    }
+
+    // Standing somewhere blocked: any open side will do
+    for (int side = 0; side < 4; side++) {
+        if (Get_Zone(loco, x + ORTHO_DX[side], y + ORTHO_DY[side]) == goal) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ZoneMap::Zone_Count(LocomotionType loco) const {
+    if (!valid_ || loco >= ZONED_COUNT) {
+        return 0;
+    }
+    const std::vector<uint32_t>& size = layers_[loco].size;
+    return static_cast<int>(std::count_if(size.begin(), size.end(), [](uint32_t n) { return n > 0; }));
+}
+
+// =============================================================================
+// Labelling
+// =============================================================================
+
+uint16_t ZoneMap::New_Zone(Layer& layer) {
+    layer.size.push_back(0);
+    return static_cast<uint16_t>(layer.size.size() - 1);
+}
+
+uint32_t ZoneMap::Relabel(int loco, int seed, uint16_t zone) {
+    // Flood the 4-connected open cells that share seed's current label
+    Layer& layer = layers_[loco];
+    uint16_t from = layer.zone[seed];
+    if (from == zone) {
+        return 0;
+    }
+
+    queue_.clear();
+    queue_.push_back((uint16_t)seed);
+    layer.zone[seed] = zone;
+
+    for (size_t head = 0; head < queue_.size(); head++) {
+        int index = queue_[head];
+        int x = index % MAP_CELL_WIDTH;
+        int y = index / MAP_CELL_WIDTH;
+        for (int side = 0; side < 4; side++) {
+            int nx = x + ORTHO_DX[side];
+            int ny = y + ORTHO_DY[side];
+            if (!Is_Open(loco, nx, ny)) {
+                continue;
+            }
+            int next = MapClass::Layer_Index(nx, ny);
+            if (layer.zone[next] == from) {
+                layer.zone[next] = zone;
+                queue_.push_back((uint16_t)next);
+            }
+        }
+    }
+    return static_cast<uint32_t>(queue_.size());
+}
+
+// =============================================================================
+// Incremental Updates
+// =============================================================================
+
+void ZoneMap::Land_Changed(int x, int y, uint8_t old_land, uint8_t new_land) {
+    if (!valid_ || !In_Bounds(x, y)) {
+        return;
+    }
+
+    // Zone numbers are never reused; renumber before they run out
+    for (const Layer& layer : layers_) {
+        if (layer.size.size() >= 0xFFFF - 4) {
+            Rebuild(land_, x0_, y0_, x1_, y1_);
+            return;
+        }
+    }
+
+    for (int loco = 0; loco < ZONED_COUNT; loco++) {
+        bool was_open = open_[loco][old_land];
+        bool now_open = open_[loco][new_land];
+        if (was_open == now_open) {
+            continue;
+        }
+
+        if (now_open) {
+            Cell_Opened(loco, x, y);
+        } else {
+            Cell_Closed(loco, x, y, layers_[loco].zone[MapClass::Layer_Index(x, y)]);
+        }
+    }
+}
+
+void ZoneMap::Cell_Opened(int loco, int x, int y) {
+    Layer& layer = layers_[loco];
+    int index = MapClass::Layer_Index(x, y);
+
+    // The cell joins the largest zone beside it; the others are relabelled
+    int seeds[4];
+    uint16_t zones[4];
+    int count = 0;
+    uint16_t best = NO_ZONE;
+    for (int side = 0; side < 4; side++) {
+        int nx = x + ORTHO_DX[side];
+        int ny = y + ORTHO_DY[side];
+        if (!In_Bounds(nx, ny)) {
+            continue;
+        }
+        int next = MapClass::Layer_Index(nx, ny);
+        uint16_t zone = layer.zone[next];
+        if (zone == NO_ZONE || std::find(zones, zones + count, zone) != zones + count) {
+            continue;
+        }
+        seeds[count] = next;
+        zones[count] = zone;
+        count++;
+        if (best == NO_ZONE || layer.size[zone] > layer.size[best]) {
+            best = zone;
+        }
+    }
+
+    if (best == NO_ZONE) {
+        best = New_Zone(layer);
+    }
+    layer.zone[index] = best;
+    layer.size[best]++;
+
+    for (int i = 0; i < count; i++) {
+        if (zones[i] != best) {
+            uint32_t moved = Relabel(loco, seeds[i], best);
+            layer.size[best] += moved;
+            layer.size[zones[i]] = 0;
+            relabelled_ += moved;
+        }
+    }
+}
+
+void ZoneMap::Cell_Closed(int loco, int x, int y, uint16_t zone) {
+    Layer& layer = layers_[loco];
+    layer.zone[MapClass::Layer_Index(x, y)] = NO_ZONE;
+    if (zone == NO_ZONE) {
+        return;
+    }
+    layer.size[zone]--;
+
+    // Walk the 8 cells around in FacingType order; each neighbour in that
+    // ring touches the next. Open sides in one unbroken run of the ring
+    // are still joined, so only sides in separate runs can be split.
+    bool ring[FACING_COUNT];
+    int closed_at = -1;
+    for (int dir = 0; dir < FACING_COUNT; dir++) {
+        int nx = x + FacingOffset_X[dir];
+        int ny = y + FacingOffset_Y[dir];
+        ring[dir] = In_Bounds(nx, ny) && layer.zone[MapClass::Layer_Index(nx, ny)] != NO_ZONE;
+        if (!ring[dir]) {
+            closed_at = dir;
+        }
+    }
+    if (closed_at < 0) {
+        return;
+    }
+
+    int seeds[4];
+    int count = 0;
+    bool run_has_seed = false;
+    for (int step = 1; step <= FACING_COUNT; step++) {
+        int dir = (closed_at + step) % FACING_COUNT;
+        if (!ring[dir]) {
+            run_has_seed = false;
+            continue;
+        }
+        if ((dir & 1) == 0 && !run_has_seed) {
+            seeds[count++] = MapClass::Layer_Index(x + FacingOffset_X[dir], y + FacingOffset_Y[dir]);
+            run_has_seed = true;
+        }
+    }
+    if (count <= 1) {
+        return;
+    }
+
+    // The runs may still meet further out. Flood from the first until
+    // every other run is found or the zone is exhausted.
+    if (++mark_gen_ == 0) {
+        std::fill(mark_.begin(), mark_.end(), 0);
+        mark_gen_ = 1;
+    }
+    int found = 1;
+    queue_.clear();
+    queue_.push_back((uint16_t)seeds[0]);
+    mark_[seeds[0]] = mark_gen_;
+
+    for (size_t head = 0; head < queue_.size() && found < count; head++) {
+        int index = queue_[head];
+        int cx = index % MAP_CELL_WIDTH;
+        int cy = index / MAP_CELL_WIDTH;
+        for (int side = 0; side < 4; side++) {
+            int nx = cx + ORTHO_DX[side];
+            int ny = cy + ORTHO_DY[side];
+            if (!In_Bounds(nx, ny)) {
+                continue;
+            }
+            int next = MapClass::Layer_Index(nx, ny);
+            if (layer.zone[next] != zone || mark_[next] == mark_gen_) {
+                continue;
+            }
+            mark_[next] = mark_gen_;
+            queue_.push_back((uint16_t)next);
+            found += std::count(seeds + 1, seeds + count, next) > 0;
+        }
+    }
+    if (found == count) {
+        return;
+    }
+
+    // Split: every run the flood didn't reach becomes a zone of its own
+    for (int i = 1; i < count; i++) {
+        if (mark_[seeds[i]] == mark_gen_ || layer.zone[seeds[i]] != zone) {
+            continue;
+        }
+        uint16_t split = New_Zone(layer);
+        uint32_t moved = Relabel(loco, seeds[i], split);
+        layer.size[split] = moved;
+        layer.size[zone] -= moved;
+        relabelled_ += moved;
+    }
+}
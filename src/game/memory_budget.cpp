@@ -0,0 +1,176 @@
+/**
+ * Memory Budget Implementation
+ */
+
+#include "game/memory_budget.h"
+#include "platform.h"
+#include "platform/profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+// =============================================================================
+// Registration
+// =============================================================================
+
+MemoryBudget& MemoryBudget::Instance() {
+    static MemoryBudget instance;
+    return instance;
+}
+
+int MemoryBudget::Register(const char* name, int reload_cost, BytesFn bytes, EvictFn evict) {
+    Cache cache;
+    cache.stats.name = name ? name : "Cache";
+    cache.stats.reload_cost = std::max(reload_cost, 1);
+    cache.bytes = std::move(bytes);
+    cache.evict = std::move(evict);
+    cache.active = true;
+
+    std::string track = "Mem " + cache.stats.name;
+    cache.profile_id = Profiler::instance().register_sample(track.c_str());
+
+    caches_.push_back(std::move(cache));
+    return static_cast<int>(caches_.size()) - 1;
+}
+
+void MemoryBudget::Unregister(int id) {
+    if (id < 0 || id >= Get_Cache_Count()) {
+        return;
+    }
+    Cache& cache = caches_[id];
+    cache.active = false;
+    cache.bytes = nullptr;
+    cache.evict = nullptr;
+    cache.stats.bytes = 0;
+}
+
+void MemoryBudget::Set_Budget(int id, size_t bytes) {
+    if (id >= 0 && id < Get_Cache_Count()) {
+        caches_[id].stats.budget = bytes;
+    }
+}
+
+const MemoryBudget::CacheStats* MemoryBudget::Get_Stats(int id) const {
+    if (id < 0 || id >= Get_Cache_Count() || !caches_[id].active) {
+        return nullptr;
+    }
+    return &caches_[id].stats;
+}
+
+// =============================================================================
+// Enforcement
+// =============================================================================
+
+size_t MemoryBudget::Update() {
+    size_t evicted = 0;
+    Recount();
+
+    // Caches over their own budget give back the excess first
+    for (Cache& cache : caches_) {
+        if (cache.active && cache.stats.budget > 0 && cache.stats.bytes > cache.stats.budget) {
+            evicted += Evict_From(cache, cache.stats.bytes - cache.stats.budget);
+        }
+    }
+    if (evicted > 0) {
+        Recount();
+    }
+
+    // Then the total against the process cap and the system's free RAM
+    size_t over = 0;
+    if (limit_ > 0 && total_bytes_ > limit_) {
+        over = total_bytes_ - limit_;
+    }
+    over = std::max(over, Ram_Shortfall());
+    if (over > 0) {
+        size_t freed = Evict(over);
+        ram_shortfall_ -= std::min(ram_shortfall_, freed);
+        evicted += freed;
+        Recount();
+    }
+
+    for (const Cache& cache : caches_) {
+        if (cache.active) {
+            Profiler::instance().record_value(cache.profile_id, static_cast<double>(cache.stats.bytes));
+        }
+    }
+    return evicted;
+}
+
+size_t MemoryBudget::Evict(size_t bytes) {
+    // Most bytes per unit of reload cost first
+    order_.clear();
+    for (int i = 0; i < Get_Cache_Count(); i++) {
+        if (caches_[i].active && caches_[i].stats.bytes > 0) {
+            order_.push_back(i);
+        }
+    }
+    std::sort(order_.begin(), order_.end(), [this](int a, int b) {
+        const CacheStats& sa = caches_[a].stats;
+        const CacheStats& sb = caches_[b].stats;
+        return sa.bytes / sa.reload_cost > sb.bytes / sb.reload_cost;
+    });
+
+    size_t freed = 0;
+    for (int id : order_) {
+        if (freed >= bytes) {
+            break;
+        }
+        freed += Evict_From(caches_[id], bytes - freed);
+    }
+    return freed;
+}
+
+size_t MemoryBudget::Recount() {
+    total_bytes_ = 0;
+    for (Cache& cache : caches_) {
+        if (cache.active) {
+            cache.stats.bytes = cache.bytes ? cache.bytes() : 0;
+            total_bytes_ += cache.stats.bytes;
+        }
+    }
+    return total_bytes_;
+}
+
+size_t MemoryBudget::Evict_From(Cache& cache, size_t bytes) {
+    if (!cache.evict || bytes == 0) {
+        return 0;
+    }
+    size_t freed = cache.evict(bytes);
+    cache.stats.evicted_bytes += freed;
+    evicted_bytes_ += freed;
+    return freed;
+}
+
+size_t MemoryBudget::Ram_Shortfall() {
+    if (min_free_ram_ == 0) {
+        return 0;
+    }
+    // Free RAM is a system call away; polled, not read every frame
+    if (++frames_since_poll_ >= RAM_POLL_FRAMES) {
+        frames_since_poll_ = 0;
+        size_t free_ram = Platform_Ram_Free();
+        ram_shortfall_ = free_ram < min_free_ram_ ? min_free_ram_ - free_ram : 0;
+    }
+    return ram_shortfall_;
+}
+
+// =============================================================================
+// Reporting
+// =============================================================================
+
+void MemoryBudget::Log_Report() const {
+    char msg[160];
+    snprintf(msg, sizeof(msg), "MemoryBudget: %zu KB resident, limit %zu KB, %llu KB evicted",
+             total_bytes_ / 1024, limit_ / 1024,
+             static_cast<unsigned long long>(evicted_bytes_ / 1024));
+    Platform_LogInfo(msg);
+
+    for (const Cache& cache : caches_) {
+        if (!cache.active) {
+            continue;
+        }
+        snprintf(msg, sizeof(msg), "  %-10s %8zu KB  budget %8zu KB  evicted %8llu KB",
+                 cache.stats.name.c_str(), cache.stats.bytes / 1024, cache.stats.budget / 1024,
+                 static_cast<unsigned long long>(cache.stats.evicted_bytes / 1024));
+        Platform_LogInfo(msg);
+    }
+}
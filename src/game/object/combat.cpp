@@ -0,0 +1,265 @@
+/**
+ * CombatSystem Implementation
+ *
+ * Original location: CODE/TECHNO.CPP
+ */
+
+#include "game/combat.h"
+#include "game/job_system.h"
+#include "game/object_heap.h"
+#include "game/object_dispatch.h"
+#include "game/map.h"
+#include "game/techno.h"
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+namespace {
+
+// Equal distances go to the older object, so the pick never depends on
+// the order objects sit in a cell
+bool Picked_Before(const ObjectClass* a, const ObjectClass* b) {
+    ObjectHandle ha = Object_Handle(a);
+    ObjectHandle hb = Object_Handle(b);
+    if (ha.rtti != hb.rtti) {
+        return ha.rtti < hb.rtti;
+    }
+    return ha.slot < hb.slot;
+}
+
+template <typename T>
+bool Is_Moving(const T* techno) {
+    if constexpr (std::is_base_of_v<FootClass, T>) {
+        return techno->Is_Moving();
+    } else {
+        return false;
+    }
+}
+
+} // namespace
+
+CombatSystem& CombatSystem::Instance() {
+    static CombatSystem instance;
+    return instance;
+}
+
+// =============================================================================
+// Update
+// =============================================================================
+
+void CombatSystem::Update() {
+    Gather();
+    int count = static_cast<int>(technos_.size());
+    if (count == 0) {
+        return;
+    }
+
+    JobSystem& jobs = JobSystem::Instance();
+    jobs.Parallel_For(count, JOB_GRAIN, [this](int begin, int end) { Acquire_Targets(begin, end); });
+    jobs.Parallel_For(count, JOB_GRAIN, [this](int begin, int end) { Plan_Intent(begin, end); });
+    jobs.Parallel_For(count, JOB_GRAIN, [this](int begin, int end) { Plan_Fire(begin, end); });
+    Apply();
+}
+
+void CombatSystem::Gather() {
+    technos_.clear();
+    runs_.clear();
+    for (int rtti = RTTI_UNIT; rtti <= RTTI_BUILDING; rtti++) {
+        ObjectHeapBase* heap = Object_Heap(static_cast<RTTIType>(rtti));
+        int run_begin = static_cast<int>(technos_.size());
+        for (int i = 0; i < heap->Count(); i++) {
+            ObjectClass* obj = heap->Active(i);
+            if (obj->Is_Active() && obj->Get_Coord() != COORD_NONE) {
+                TechnoClass* techno = static_cast<TechnoClass*>(obj);
+                if (techno->arm_ > 0) {
+                    techno->arm_--;     // Rearm before Fire looks at it
+                }
+                if (techno->scan_wait_ > 0) {
+                    techno->scan_wait_--;
+                }
+                technos_.push_back(techno);
+            }
+        }
+        int run_end = static_cast<int>(technos_.size());
+        if (run_end > run_begin) {
+            runs_.push_back({static_cast<RTTIType>(rtti), run_begin, run_end});
+        }
+    }
+
+    size_t count = technos_.size();
+    targets_.resize(count);
+    scan_wait_.resize(count);
+    aim_.resize(count);
+    in_range_.resize(count);
+    damage_.resize(count);
+}
+
+// =============================================================================
+// Phases
+// =============================================================================
+
+template <typename Fn>
+void CombatSystem::For_Each_Run(int begin, int end, Fn fn) const {
+    for (const KindRun& run : runs_) {
+        int run_begin = std::max(begin, run.begin);
+        int run_end = std::min(end, run.end);
+        if (run_begin >= run_end) {
+            continue;
+        }
+        With_Techno_Kind(run.rtti, [&](auto* tag) {
+            fn(tag, run_begin, run_end);
+        });
+    }
+}
+
+// Each run calls T's functions directly: every techno in it is exactly a T
+
+template <typename T>
+void CombatSystem::Acquire_Run(int begin, int end) {
+    std::vector<ObjectClass*> nearby;   // Reused across this run
+
+    for (int i = begin; i < end; i++) {
+        T* techno = static_cast<T*>(technos_[i]);
+        ObjectClass* current = techno->target_;
+        int range = techno->T::Weapon_Range();
+        scan_wait_[i] = NO_SCAN;
+
+        // Hold on to a target as long as it can be attacked; chasing one
+        // out of range is the mission's business
+        if (range <= 0 || (current != nullptr && techno->T::Can_Attack(current))) {
+            targets_[i] = current;
+            continue;
+        }
+
+        // Standing idle since a scan found nothing: wait for its turn
+        if (current == nullptr && techno->scan_wait_ > 0 && !Is_Moving(techno)) {
+            targets_[i] = nullptr;
+            continue;
+        }
+
+        COORDINATE coord = techno->Get_Coord();
+        ObjectClass* best = nullptr;
+        int best_distance = 0;
+
+        nearby.clear();
+        if (Map != nullptr) {
+            Map->Objects_In_Radius(coord, range, nearby);
+        }
+        for (ObjectClass* obj : nearby) {
+            if (obj == techno || !obj->Is_Techno() || obj->Get_Owner() == techno->Get_Owner() ||
+                !techno->T::Can_Attack(obj)) {
+                continue;
+            }
+            int distance = Coord_Distance(coord, obj->Get_Coord());
+            if (best == nullptr || distance < best_distance ||
+                (distance == best_distance && Picked_Before(obj, best))) {
+                best = obj;
+                best_distance = distance;
+            }
+        }
+
+        targets_[i] = best;
+        scan_wait_[i] = best != nullptr ? 0
+                                        : SCAN_WAIT_MIN + Object_Handle(techno).slot % SCAN_WAIT_SPREAD;
+    }
+}
+
+template <typename T>
+void CombatSystem::Intent_Run(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const T* techno = static_cast<const T*>(technos_[i]);
+        const ObjectClass* target = targets_[i];
+        if (target == nullptr || !target->Is_Active()) {
+            aim_[i] = NO_AIM;
+            in_range_[i] = 0;
+            continue;
+        }
+
+        COORDINATE from = techno->Get_Coord();
+        COORDINATE to = target->Get_Coord();
+        aim_[i] = Coord_Direction(from, to);
+        in_range_[i] = Coord_Distance(from, to) <= techno->T::Weapon_Range();
+    }
+}
+
+template <typename T>
+void CombatSystem::Fire_Run(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const T* techno = static_cast<const T*>(technos_[i]);
+        damage_[i] = 0;
+        if (aim_[i] == NO_AIM || !in_range_[i] || techno->arm_ > 0) {
+            continue;
+        }
+
+        // The gun is the turret if there is one, the body otherwise
+        DirType gun = techno->T::Has_Turret() ? techno->Get_Turret_Facing() : techno->Get_Facing();
+        int off = static_cast<int8_t>(static_cast<uint8_t>(gun - aim_[i]));
+        if (std::abs(off) <= AIM_TOLERANCE) {
+            damage_[i] = techno->T::Weapon_Damage();
+        }
+    }
+}
+
+template <typename T>
+void CombatSystem::Apply_Run(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        T* techno = static_cast<T*>(technos_[i]);
+        if (!techno->Is_Active()) {
+            continue;   // Destroyed earlier this tick
+        }
+        stats_.technos++;
+
+        if (scan_wait_[i] != NO_SCAN) {
+            techno->scan_wait_ = static_cast<uint8_t>(scan_wait_[i]);
+            stats_.scans++;
+        }
+
+        if (techno->target_ != targets_[i]) {
+            techno->target_ = targets_[i];
+            stats_.acquired += targets_[i] != nullptr;
+        }
+
+        if (aim_[i] != NO_AIM) {
+            DirType aim = static_cast<DirType>(aim_[i]);
+            if (!techno->T::Is_Steered()) {
+                techno->body_facing_.Set_Desired(aim);
+            }
+            if (techno->T::Has_Turret()) {
+                techno->turret_facing_.Set_Desired(aim);
+            }
+        }
+
+        // An earlier shot this tick may already have finished the target
+        ObjectClass* target = targets_[i];
+        if (damage_[i] > 0 && target->Is_Active()) {
+            techno->arm_ = techno->T::Rearm_Delay();
+            Dispatch_Take_Damage(target, damage_[i], techno);
+            stats_.shots++;
+        }
+    }
+}
+
+void CombatSystem::Acquire_Targets(int begin, int end) {
+    For_Each_Run(begin, end, [this](auto* tag, int run_begin, int run_end) {
+        Acquire_Run<std::remove_pointer_t<decltype(tag)>>(run_begin, run_end);
+    });
+}
+
+void CombatSystem::Plan_Intent(int begin, int end) {
+    For_Each_Run(begin, end, [this](auto* tag, int run_begin, int run_end) {
+        Intent_Run<std::remove_pointer_t<decltype(tag)>>(run_begin, run_end);
+    });
+}
+
+void CombatSystem::Plan_Fire(int begin, int end) {
+    For_Each_Run(begin, end, [this](auto* tag, int run_begin, int run_end) {
+        Fire_Run<std::remove_pointer_t<decltype(tag)>>(run_begin, run_end);
+    });
+}
+
+void CombatSystem::Apply() {
+    // Heap order, so every machine resolves simultaneous shots alike
+    For_Each_Run(0, static_cast<int>(technos_.size()), [this](auto* tag, int run_begin, int run_end) {
+        Apply_Run<std::remove_pointer_t<decltype(tag)>>(run_begin, run_end);
+    });
+}
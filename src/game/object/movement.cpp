@@ -0,0 +1,263 @@
+/**
+ * MovementSystem Implementation
+ *
+ * Original location: CODE/DRIVE.CPP, CODE/FOOT.CPP
+ */
+
+#include "game/movement.h"
+#include "game/techno.h"
+#include <algorithm>
+
+MovementSystem& MovementSystem::Instance() {
+    static MovementSystem instance;
+    return instance;
+}
+
+MovementSystem::~MovementSystem() {
+    // Units still alive at exit must not call back into a dead system
+    Clear();
+}
+
+// =============================================================================
+// Registration
+// =============================================================================
+
+int MovementSystem::Add(FootClass* unit) {
+    int index = Count();
+    COORDINATE coord = unit->Get_Coord();
+
+    units_.push_back(unit);
+    x_.push_back(Coord_X(coord));
+    y_.push_back(Coord_Y(coord));
+    dest_x_.push_back(Coord_X(coord));
+    dest_y_.push_back(Coord_Y(coord));
+    speed_.push_back(unit->speed_);
+    facing_.push_back(unit->body_facing_.Current());
+    desired_.push_back(unit->body_facing_.Desired());
+    rate_.push_back(unit->body_facing_.Rate());
+    cell_.push_back(Coord_Cell(coord));
+    path_cursor_.push_back(0);
+    path_length_.push_back(0);
+    path_.resize(path_.size() + MAX_WAYPOINTS, COORD_NONE);
+    arrived_.push_back(0);
+    new_cell_.push_back(CELL_NONE);
+
+    unit->move_index_ = index;
+    return index;
+}
+
+void MovementSystem::Erase(int index) {
+    // Fill the hole with the last unit so the arrays stay packed
+    int last = Count() - 1;
+    units_[index]->move_index_ = -1;
+    if (index != last) {
+        units_[index] = units_[last];
+        x_[index] = x_[last];
+        y_[index] = y_[last];
+        dest_x_[index] = dest_x_[last];
+        dest_y_[index] = dest_y_[last];
+        speed_[index] = speed_[last];
+        facing_[index] = facing_[last];
+        desired_[index] = desired_[last];
+        rate_[index] = rate_[last];
+        cell_[index] = cell_[last];
+        path_cursor_[index] = path_cursor_[last];
+        path_length_[index] = path_length_[last];
+        std::copy_n(&path_[last * MAX_WAYPOINTS], MAX_WAYPOINTS, &path_[index * MAX_WAYPOINTS]);
+        arrived_[index] = arrived_[last];
+        new_cell_[index] = new_cell_[last];
+        units_[index]->move_index_ = index;
+    }
+
+    units_.pop_back();
+    x_.pop_back();
+    y_.pop_back();
+    dest_x_.pop_back();
+    dest_y_.pop_back();
+    speed_.pop_back();
+    facing_.pop_back();
+    desired_.pop_back();
+    rate_.pop_back();
+    cell_.pop_back();
+    path_cursor_.pop_back();
+    path_length_.pop_back();
+    path_.resize(path_.size() - MAX_WAYPOINTS);
+    arrived_.pop_back();
+    new_cell_.pop_back();
+}
+
+bool MovementSystem::Set_Path(FootClass* unit, const COORDINATE* points, int count) {
+    if (unit == nullptr || points == nullptr || count <= 0) {
+        return false;
+    }
+    if (unit->Get_Coord() == COORD_NONE) {
+        return false;
+    }
+
+    int index = unit->move_index_ >= 0 ? unit->move_index_ : Add(unit);
+    int length = std::min(count, MAX_WAYPOINTS);
+
+    std::copy_n(points, length, &path_[index * MAX_WAYPOINTS]);
+    path_length_[index] = static_cast<uint8_t>(length);
+    path_cursor_[index] = 0;
+    dest_x_[index] = Coord_X(points[0]);
+    dest_y_[index] = Coord_Y(points[0]);
+    Aim(index);
+
+    unit->destination_ = points[length - 1];
+    return true;
+}
+
+void MovementSystem::Stop(FootClass* unit) {
+    if (unit == nullptr || unit->move_index_ < 0) {
+        return;
+    }
+
+    Erase(unit->move_index_);
+    unit->destination_ = COORD_NONE;
+}
+
+void MovementSystem::Set_Speed(FootClass* unit, int speed) {
+    if (unit && unit->move_index_ >= 0) {
+        speed_[unit->move_index_] = speed;
+    }
+}
+
+void MovementSystem::Remove(FootClass* unit) {
+    if (unit && unit->move_index_ >= 0) {
+        Erase(unit->move_index_);
+    }
+}
+
+void MovementSystem::Clear() {
+    for (FootClass* unit : units_) {
+        unit->move_index_ = -1;
+    }
+
+    units_.clear();
+    x_.clear();
+    y_.clear();
+    dest_x_.clear();
+    dest_y_.clear();
+    speed_.clear();
+    facing_.clear();
+    desired_.clear();
+    rate_.clear();
+    cell_.clear();
+    path_cursor_.clear();
+    path_length_.clear();
+    path_.clear();
+    arrived_.clear();
+    new_cell_.clear();
+    cell_transitions_ = 0;
+}
+
+// =============================================================================
+// Steering
+// =============================================================================
+
+void MovementSystem::Aim(int index) {
+    int dx = dest_x_[index] - x_[index];
+    int dy = dest_y_[index] - y_[index];
+    if (dx != 0 || dy != 0) {
+        desired_[index] = Dir_From_XY(dx, dy);
+    }
+}
+
+void MovementSystem::Next_Waypoint(int index) {
+    int cursor = path_cursor_[index] + 1;
+    if (cursor >= path_length_[index]) {
+        // Path done; the unit stays where it is and leaves the system
+        FootClass* unit = units_[index];
+        Erase(index);
+
+        // Only part of a long route fitted; plan the next part from here.
+        // The unit is re-added at the end, past everything this tick visits.
+        if (unit->destination_ != COORD_NONE && unit->destination_ != unit->coord_) {
+            unit->Set_Destination(unit->destination_);
+        }
+        return;
+    }
+
+    COORDINATE point = path_[index * MAX_WAYPOINTS + cursor];
+    path_cursor_[index] = static_cast<uint8_t>(cursor);
+    dest_x_[index] = Coord_X(point);
+    dest_y_[index] = Coord_Y(point);
+    Aim(index);
+}
+
+// =============================================================================
+// Update
+// =============================================================================
+
+void MovementSystem::Update() {
+    int count = Count();
+    if (count == 0) {
+        return;
+    }
+
+    // Turn every body toward its waypoint
+    FacingClass::Rotate_Batch(facing_.data(), desired_.data(), rate_.data(), count);
+
+    // Drive: units only move once they face their waypoint. A unit that
+    // is within a step of it, or has just driven past it, snaps onto it.
+    int32_t* x = x_.data();
+    int32_t* y = y_.data();
+    const int32_t* dest_x = dest_x_.data();
+    const int32_t* dest_y = dest_y_.data();
+    const int32_t* speed = speed_.data();
+    const DirType* facing = facing_.data();
+    const DirType* desired = desired_.data();
+    uint8_t* arrived = arrived_.data();
+    CELL* new_cell = new_cell_.data();
+
+    for (int i = 0; i < count; i++) {
+        int dir = facing[i];
+        int step = (facing[i] == desired[i]) ? speed[i] : 0;
+        int step_x = (DirSineTable[dir] * step + 64) >> 7;
+        int step_y = -((DirCosineTable[dir] * step + 64) >> 7);
+
+        int rx = dest_x[i] - x[i];
+        int ry = dest_y[i] - y[i];
+        int reach = std::max(std::abs(rx), std::abs(ry));
+        int passed = (step > 0) & (rx * step_x + ry * step_y < 0);
+        int arrive = (reach <= step) | passed;
+
+        x[i] += arrive ? rx : step_x;
+        y[i] += arrive ? ry : step_y;
+        arrived[i] = static_cast<uint8_t>(arrive);
+        new_cell[i] = XY_Cell(x[i] >> LEPTON_SHIFT, y[i] >> LEPTON_SHIFT);
+    }
+
+    // Write back. Walked back to front so units finishing their path can
+    // be swapped out without skipping anyone.
+    for (int i = count - 1; i >= 0; i--) {
+        FootClass* unit = units_[i];
+        COORDINATE coord = XY_Coord(x_[i], y_[i]);
+
+        FacingClass body(facing_[i]);
+        body.Set_Desired(desired_[i]);
+        body.Set_Rate(rate_[i]);
+        unit->body_facing_ = body;
+
+        if (new_cell_[i] != cell_[i]) {
+            // Only a cell change touches the spatial grid
+            unit->ObjectClass::Set_Coord(coord);
+            cell_[i] = new_cell_[i];
+            cell_transitions_++;
+
+            // Re-aim to wash out the error of the 256-step heading
+            if (!arrived_[i]) {
+                Aim(i);
+            }
+        } else {
+            unit->Toggle_State_Hash();
+            unit->coord_ = coord;
+            unit->Toggle_State_Hash();
+        }
+
+        if (arrived_[i]) {
+            Next_Waypoint(i);
+        }
+    }
+}
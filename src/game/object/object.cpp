@@ -9,14 +9,27 @@
 #include "game/cell.h"
 #include "game/mission.h"
 #include "game/core/rtti.h"
+#include "game/spatial_grid.h"
+#include "game/findpath.h"
+#include "game/flow_field.h"
+#include "game/graphics/selection_overlay.h"
+#include "game/map.h"
+#include "game/movement.h"
+#include "game/state_hash.h"
+#include "game/trigger.h"
+#include "game/vision_map.h"
 #include <cstring>
 #include <algorithm>
 
 // =============================================================================
-// Global Object List
+// Spatial Index
 // =============================================================================
 
-ObjectClass* AllObjects = nullptr;
+SpatialGrid<ObjectClass>& Object_Grid() {
+    // Function-local so objects placed during static init find it ready
+    static SpatialGrid<ObjectClass> grid;
+    return grid;
+}
 
 // =============================================================================
 // RTTI Names
@@ -63,11 +76,10 @@ const char* Mission_Name(MissionType mission) {
 ObjectClass::ObjectClass()
     : AbstractClass()
     , coord_(COORD_NONE)
+    , prev_coord_(COORD_NONE)
     , strength_(0)
     , owner_(HOUSE_NONE)
     , is_selected_(false)
-    , next_(nullptr)
-    , prev_(nullptr)
 {
     rtti_type_ = RTTI_NONE;
 }
@@ -75,9 +87,6 @@ ObjectClass::ObjectClass()
 ObjectClass::~ObjectClass() {
     // Remove from cell occupancy
     Unmark_Cell();
-
-    // Remove from global list
-    Unlink_From_List();
 }
 
 // =============================================================================
@@ -86,17 +95,39 @@ ObjectClass::~ObjectClass() {
 
 void ObjectClass::Set_Coord(COORDINATE coord) {
     if (coord_ != coord) {
+        CELL old_cell = Get_Cell();
+
         // Remove from old cell
         Unmark_Cell();
 
         // Update position
+        Toggle_State_Hash();
         coord_ = coord;
+        Toggle_State_Hash();
 
         // Add to new cell
         Mark_Cell();
+
+        // Units and infantry walking into a cell a trigger watches; for
+        // every other cell this is one bit test
+        CELL cell = Get_Cell();
+        if (cell != old_cell && Is_Foot()) {
+            TriggerEngine& triggers = TriggerEngine::Instance();
+            if (triggers.Is_Cell_Watched(cell)) {
+                triggers.Cell_Entered(cell, owner_);
+            }
+        }
     }
 }
 
+COORDINATE ObjectClass::Render_Coord(float alpha) const {
+    // Teleports and placements snap rather than slide across the map
+    if (Coord_Distance(prev_coord_, coord_) > LEPTON_PER_CELL) {
+        return coord_;
+    }
+    return Coord_Lerp(prev_coord_, coord_, alpha);
+}
+
 void ObjectClass::Set_Cell(CELL cell) {
     Set_Coord(Cell_Coord(cell));
 }
@@ -106,18 +137,21 @@ void ObjectClass::Mark_Cell() {
     CELL cell = Get_Cell();
     if (cell == CELL_NONE) return;
 
-    // This would add us to the cell's object list
-    // Requires MapClass integration
-    // For now, just a placeholder
+    // The map's cell lists answer range queries; the spatial grid is
+    // what radar and selection query
+    if (Map != nullptr) {
+        Map->Occupy_Cell(cell, this);
+    }
+    Object_Grid().Insert(this, Coord_XPixel(coord_), Coord_YPixel(coord_));
 }
 
 void ObjectClass::Unmark_Cell() {
-    // Get cell at our position
-    CELL cell = Get_Cell();
-    if (cell == CELL_NONE) return;
+    if (Map != nullptr && coord_ != COORD_NONE) {
+        Map->Vacate_Cell(Get_Cell(), this);
+    }
 
-    // This would remove us from the cell's object list
-    // Requires MapClass integration
+    // Remove unconditionally so a stale entry can never outlive the object
+    Object_Grid().Remove(this);
 }
 
 // =============================================================================
@@ -130,8 +164,16 @@ int ObjectClass::Health_Percent() const {
     return (strength_ * 100) / max;
 }
 
+fixed ObjectClass::Health_Ratio() const {
+    int max = Max_Strength();
+    if (max <= 0) return fixed(0);
+    return fixed::Ratio(strength_, max);
+}
+
 void ObjectClass::Set_Strength(int str) {
+    Toggle_State_Hash();
     strength_ = std::clamp(str, 0, Max_Strength());
+    Toggle_State_Hash();
 }
 
 void ObjectClass::Heal(int amount) {
@@ -140,6 +182,28 @@ void ObjectClass::Heal(int amount) {
     }
 }
 
+// =============================================================================
+// Owner
+// =============================================================================
+
+void ObjectClass::Set_Owner(HousesType house) {
+    Toggle_State_Hash();
+    owner_ = house;
+    Toggle_State_Hash();
+}
+
+// =============================================================================
+// State Hash
+// =============================================================================
+
+void ObjectClass::Toggle_State_Hash() const {
+    if (handle_slot_ < 0) {
+        return;
+    }
+    StateHash::Instance().Toggle_Object(StateHash::Object_Term(rtti_type_, handle_slot_, coord_,
+                                                               strength_, owner_));
+}
+
 // =============================================================================
 // Drawing
 // =============================================================================
@@ -152,22 +216,22 @@ void ObjectClass::Draw(int x, int y, void* window) {
 
     if (is_selected_) {
         Draw_Selection(x, y);
+        Draw_Health(x, y);
     }
 }
 
 void ObjectClass::Draw_Selection(int x, int y) {
-    // Draw selection box corners
-    // This would use GScreenClass drawing methods
-    // For now, just a placeholder
-    (void)x;
-    (void)y;
+    // Recorded for the frame's overlay pass rather than drawn line by line
+    int half = CELL_PIXEL_SIZE / 2;
+    SelectionOverlay::Instance().Add_Brackets(x - half, y - half, CELL_PIXEL_SIZE, CELL_PIXEL_SIZE,
+                                              OVERLAY_COLOR_WHITE);
 }
 
 void ObjectClass::Draw_Health(int x, int y) {
-    // Draw health bar above object
-    // This would use GScreenClass drawing methods
-    (void)x;
-    (void)y;
+    // Just above the selection brackets
+    int half = CELL_PIXEL_SIZE / 2;
+    SelectionOverlay::Instance().Add_Health_Bar(x - half, y - half - SelectionOverlay::HEALTH_BAR_HEIGHT - 1,
+                                                CELL_PIXEL_SIZE, Health_Percent());
 }
 
 // =============================================================================
@@ -197,7 +261,9 @@ int ObjectClass::Take_Damage(int damage, ObjectClass* source, int warhead) {
     }
 
     int actual = std::min(damage, strength_);
+    Toggle_State_Hash();
     strength_ -= actual;
+    Toggle_State_Hash();
 
     if (strength_ <= 0) {
         Destroyed();
@@ -213,40 +279,14 @@ void ObjectClass::Destroyed() {
     // Deselect
     is_selected_ = false;
 
-    // Remove from cell
-    Unmark_Cell();
-}
-
-// =============================================================================
-// Object List
-// =============================================================================
-
-void ObjectClass::Link_To_List() {
-    // Add to front of global list
-    next_ = AllObjects;
-    prev_ = nullptr;
-
-    if (AllObjects != nullptr) {
-        AllObjects->prev_ = this;
-    }
-
-    AllObjects = this;
-}
-
-void ObjectClass::Unlink_From_List() {
-    // Remove from list
-    if (prev_ != nullptr) {
-        prev_->next_ = next_;
-    } else if (AllObjects == this) {
-        AllObjects = next_;
+    // Spring triggers attached to this object
+    TriggerEngine& triggers = TriggerEngine::Instance();
+    if (triggers.Is_Watching_Objects()) {
+        triggers.Object_Destroyed(this);
     }
 
-    if (next_ != nullptr) {
-        next_->prev_ = prev_;
-    }
-
-    next_ = nullptr;
-    prev_ = nullptr;
+    // Remove from cell
+    Unmark_Cell();
 }
 
 // =============================================================================
@@ -261,14 +301,63 @@ TechnoClass::TechnoClass()
     , primary_weapon_(WEAPON_NONE)
     , secondary_weapon_(WEAPON_NONE)
     , target_(nullptr)
+    , arm_(0)
+    , scan_wait_(0)
+    , sight_range_(TECHNO_SIGHT_RANGE)
+    , sight_cell_(CELL_NONE)
+    , sight_house_(HOUSE_NONE)
     , is_cloaked_(false)
 {
 }
 
 TechnoClass::~TechnoClass() {
+    // ~ObjectClass only reaches its own Unmark_Cell
+    Unmark_Sight();
     target_ = nullptr;
 }
 
+void TechnoClass::Set_Sight_Range(int range) {
+    bool placed = sight_cell_ != CELL_NONE;
+    Unmark_Sight();
+    sight_range_ = range;
+    if (placed) {
+        Mark_Sight();
+    }
+}
+
+void TechnoClass::Mark_Cell() {
+    ObjectClass::Mark_Cell();
+    Mark_Sight();
+}
+
+void TechnoClass::Unmark_Cell() {
+    Unmark_Sight();
+    ObjectClass::Unmark_Cell();
+}
+
+void TechnoClass::Mark_Sight() {
+    CELL cell = Get_Cell();
+    if (Map == nullptr || Map->Get_Vision() == nullptr || cell == CELL_NONE || sight_cell_ != CELL_NONE) {
+        return;
+    }
+
+    // Remember what was registered so an owner change cannot strand it
+    Map->Get_Vision()->Add_Sight(owner_, cell, sight_range_);
+    sight_cell_ = cell;
+    sight_house_ = owner_;
+}
+
+void TechnoClass::Unmark_Sight() {
+    if (sight_cell_ == CELL_NONE) {
+        return;
+    }
+    if (Map != nullptr && Map->Get_Vision() != nullptr) {
+        Map->Get_Vision()->Remove_Sight(sight_house_, sight_cell_, sight_range_);
+    }
+    sight_cell_ = CELL_NONE;
+    sight_house_ = HOUSE_NONE;
+}
+
 bool TechnoClass::Can_Attack(ObjectClass* target) const {
     if (target == nullptr || !target->Is_Active()) {
         return false;
@@ -282,22 +371,31 @@ bool TechnoClass::Can_Attack(ObjectClass* target) const {
     return true;
 }
 
+void TechnoClass::Set_Weapons(WeaponType primary, WeaponType secondary) {
+    primary_weapon_ = primary;
+    secondary_weapon_ = secondary;
+}
+
+int TechnoClass::Weapon_Range() const {
+    bool armed = primary_weapon_ != WEAPON_NONE || secondary_weapon_ != WEAPON_NONE;
+    return armed ? TECHNO_WEAPON_RANGE : 0;
+}
+
+int TechnoClass::Weapon_Damage() const {
+    bool armed = primary_weapon_ != WEAPON_NONE || secondary_weapon_ != WEAPON_NONE;
+    return armed ? TECHNO_WEAPON_DAMAGE : 0;
+}
+
 void TechnoClass::AI() {
     ObjectClass::AI();
 
-    // Update facing towards target
-    if (target_ != nullptr && target_->Is_Active()) {
-        // Calculate direction to target
-        DirType desired = Coord_Direction(coord_, target_->Get_Coord());
-        body_facing_.Set_Desired(desired);
-
-        if (Has_Turret()) {
-            turret_facing_.Set_Desired(desired);
-        }
-    }
+    // Facing toward the target is set by the CombatSystem
+    bool steered = Is_Steered();
 
     // Rotate towards desired facing
-    body_facing_.Rotate();
+    if (!steered) {
+        body_facing_.Rotate();
+    }
     if (Has_Turret()) {
         turret_facing_.Rotate();
     }
@@ -311,8 +409,69 @@ FootClass::FootClass()
     : TechnoClass()
     , speed_(0)
     , destination_(COORD_NONE)
+    , move_index_(-1)
 {
 }
 
 FootClass::~FootClass() {
+    if (move_index_ >= 0) {
+        MovementSystem::Instance().Remove(this);
+    }
+}
+
+void FootClass::Set_Speed(int speed) {
+    speed_ = speed;
+    MovementSystem::Instance().Set_Speed(this, speed);
+}
+
+void FootClass::Set_Destination(COORDINATE dest) {
+    // A shared field only leads to its own target
+    if (flow_field_ && (dest == COORD_NONE || flow_field_->Get_Target() != Coord_Cell(dest) ||
+                        !flow_field_->Is_Current())) {
+        flow_field_.reset();
+    }
+
+    if (dest == COORD_NONE) {
+        MovementSystem::Instance().Stop(this);
+        destination_ = COORD_NONE;
+        return;
+    }
+
+    // Without a map there is no terrain to route around
+    if (Map == nullptr || Map->Get_Cell_Layers() == nullptr || coord_ == COORD_NONE) {
+        destination_ = dest;
+        MovementSystem::Instance().Move_To(this, dest);
+        return;
+    }
+
+    std::vector<CELL> cells;
+    bool found = flow_field_
+        ? flow_field_->Trace(Get_Cell(), cells)
+        : PathFinder::Instance().Find_Path(Get_Cell(), Coord_Cell(dest),
+                                           Locomotion_Of(What_Am_I()), cells);
+    if (!found) {
+        MovementSystem::Instance().Stop(this);
+        destination_ = COORD_NONE;
+        return;
+    }
+
+    COORDINATE points[MovementSystem::MAX_WAYPOINTS];
+    int count = Path_Waypoints(Get_Cell(), cells, dest, points, MovementSystem::MAX_WAYPOINTS);
+    MovementSystem::Instance().Set_Path(this, points, count);
+
+    // Long routes arrive in pieces; the movement system replans from the
+    // last waypoint until this is reached
+    destination_ = dest;
+}
+
+void FootClass::Follow_Flow_Field(std::shared_ptr<const FlowField> field, COORDINATE dest) {
+    flow_field_ = std::move(field);
+    Set_Destination(dest);
+}
+
+void FootClass::Set_Coord(COORDINATE coord) {
+    if (move_index_ >= 0 && coord != coord_) {
+        MovementSystem::Instance().Stop(this);
+    }
+    ObjectClass::Set_Coord(coord);
 }
@@ -0,0 +1,58 @@
+/**
+ * ObjectDispatch Implementation
+ */
+
+#include "game/object_dispatch.h"
+
+namespace {
+
+// Entries for kind R call T's implementation directly
+template <RTTIType R>
+struct KindThunks {
+    using T = typename ObjectKind<R>::Type;
+
+    static void AI(ObjectClass* obj) {
+        static_cast<T*>(obj)->T::AI();
+    }
+    static void Draw(ObjectClass* obj, int x, int y, void* window) {
+        static_cast<T*>(obj)->T::Draw(x, y, window);
+    }
+    static int Take_Damage(ObjectClass* obj, int damage, ObjectClass* source, int warhead) {
+        return static_cast<T*>(obj)->T::Take_Damage(damage, source, warhead);
+    }
+
+    static constexpr ObjectDispatch TABLE = {&AI, &Draw, &Take_Damage};
+};
+
+// Objects whose class is not known from their RTTI
+struct VirtualThunks {
+    static void AI(ObjectClass* obj) { obj->AI(); }
+    static void Draw(ObjectClass* obj, int x, int y, void* window) { obj->Draw(x, y, window); }
+    static int Take_Damage(ObjectClass* obj, int damage, ObjectClass* source, int warhead) {
+        return obj->Take_Damage(damage, source, warhead);
+    }
+
+    static constexpr ObjectDispatch TABLE = {&AI, &Draw, &Take_Damage};
+};
+
+const ObjectDispatch DISPATCH[RTTI_TRIGGER] = {
+    KindThunks<RTTI_UNIT>::TABLE,
+    KindThunks<RTTI_INFANTRY>::TABLE,
+    KindThunks<RTTI_VESSEL>::TABLE,
+    KindThunks<RTTI_AIRCRAFT>::TABLE,
+    KindThunks<RTTI_BUILDING>::TABLE,
+    KindThunks<RTTI_BULLET>::TABLE,
+    KindThunks<RTTI_ANIM>::TABLE,
+    KindThunks<RTTI_TERRAIN>::TABLE,
+    KindThunks<RTTI_OVERLAY>::TABLE,
+    KindThunks<RTTI_SMUDGE>::TABLE,
+};
+
+} // namespace
+
+const ObjectDispatch& Object_Dispatch(RTTIType rtti) {
+    if (rtti < RTTI_UNIT || rtti >= RTTI_TRIGGER) {
+        return VirtualThunks::TABLE;
+    }
+    return DISPATCH[rtti];
+}
@@ -0,0 +1,152 @@
+/**
+ * ObjectHeap Implementation
+ *
+ * Original location: CODE/HEAP.CPP
+ */
+
+#include "game/object_heap.h"
+#include "game/object_dispatch.h"
+#include "game/spatial_grid.h"
+
+// =============================================================================
+// ObjectHeapBase
+// =============================================================================
+
+void ObjectHeapBase::Track(ObjectClass* obj, int slot) {
+    obj->rtti_type_ = rtti_;
+    obj->heap_id_ = Count();
+    obj->handle_slot_ = slot;
+    active_.push_back(obj);
+    obj->Toggle_State_Hash();
+}
+
+int ObjectHeapBase::Untrack(ObjectClass* obj) {
+    int id = obj->heap_id_;
+    if (id < 0 || id >= Count() || active_[id] != obj) {
+        return -1;
+    }
+
+    // Fill the hole with the last object so the array stays dense
+    ObjectClass* last = active_.back();
+    active_[id] = last;
+    last->heap_id_ = id;
+    active_.pop_back();
+    obj->heap_id_ = -1;
+
+    // The pool retires the slot's generation, so outstanding handles stop resolving
+    obj->Toggle_State_Hash();
+    int slot = obj->handle_slot_;
+    obj->handle_slot_ = -1;
+    return slot;
+}
+
+int ObjectHeapBase::Slot_Of(const ObjectClass* obj) {
+    return obj->handle_slot_;
+}
+
+void ObjectHeapBase::Free_All() {
+    while (!active_.empty()) {
+        Free_Object(active_.back());
+    }
+}
+
+// =============================================================================
+// Heaps
+// =============================================================================
+
+namespace {
+
+// One heap per object kind, each holding that kind's ObjectKind class
+template <RTTIType R, size_t BlockSize = 64>
+using KindHeap = ObjectHeap<typename ObjectKind<R>::Type, BlockSize>;
+
+struct ObjectHeaps {
+    KindHeap<RTTI_UNIT> units{RTTI_UNIT};
+    KindHeap<RTTI_INFANTRY> infantry{RTTI_INFANTRY};
+    KindHeap<RTTI_VESSEL> vessels{RTTI_VESSEL};
+    KindHeap<RTTI_AIRCRAFT> aircraft{RTTI_AIRCRAFT};
+    KindHeap<RTTI_BUILDING> buildings{RTTI_BUILDING};
+    KindHeap<RTTI_BULLET, 128> bullets{RTTI_BULLET};
+    KindHeap<RTTI_ANIM, 128> anims{RTTI_ANIM};
+    KindHeap<RTTI_TERRAIN, 128> terrain{RTTI_TERRAIN};
+    KindHeap<RTTI_OVERLAY, 128> overlays{RTTI_OVERLAY};
+    KindHeap<RTTI_SMUDGE, 128> smudges{RTTI_SMUDGE};
+
+    ObjectHeapBase* by_rtti[RTTI_TRIGGER] = {
+        &units, &infantry, &vessels, &aircraft, &buildings,
+        &bullets, &anims, &terrain, &overlays, &smudges
+    };
+};
+
+ObjectHeaps& Heaps() {
+    // Objects leave the grid when freed, so the grid must outlive the heaps
+    Object_Grid();
+
+    // Function-local so objects created during static init find it ready
+    static ObjectHeaps heaps;
+    return heaps;
+}
+
+} // namespace
+
+ObjectHeapBase* Object_Heap(RTTIType rtti) {
+    if (rtti < RTTI_UNIT || rtti >= RTTI_TRIGGER) {
+        return nullptr;
+    }
+    return Heaps().by_rtti[rtti];
+}
+
+// =============================================================================
+// Object Creation
+// =============================================================================
+
+ObjectClass* Create_Object(RTTIType rtti) {
+    ObjectHeapBase* heap = Object_Heap(rtti);
+    if (heap == nullptr) {
+        return nullptr;
+    }
+
+    return heap->Alloc_Object();
+}
+
+void Destroy_Object(ObjectClass* obj) {
+    if (obj == nullptr) {
+        return;
+    }
+
+    // The destructor clears its cell
+    ObjectHeapBase* heap = Object_Heap(obj->What_Am_I());
+    if (heap) {
+        heap->Free_Object(obj);
+    }
+}
+
+ObjectHandle Object_Handle(const ObjectClass* obj) {
+    ObjectHeapBase* heap = obj ? Object_Heap(obj->What_Am_I()) : nullptr;
+    return heap ? heap->Handle_Of(obj) : ObjectHandle();
+}
+
+ObjectClass* Resolve_Object(ObjectHandle handle) {
+    ObjectHeapBase* heap = Object_Heap(handle.rtti);
+    return heap ? heap->Resolve(handle) : nullptr;
+}
+
+int Object_Count() {
+    int count = 0;
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        count += Object_Heap(static_cast<RTTIType>(rtti))->Count();
+    }
+    return count;
+}
+
+void AI_All_Objects() {
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        Object_Heap(static_cast<RTTIType>(rtti))->AI_Pass();
+    }
+}
+
+void Destroy_All_Objects() {
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        Object_Heap(static_cast<RTTIType>(rtti))->Free_All();
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * ProjectileSystem Implementation
+ *
+ * Original location: CODE/BULLET.CPP, CODE/ANIM.CPP
+ */
+
+#include "game/projectile.h"
+#include "game/audio/audio_events.h"
+#include "game/graphics/render_pipeline.h"
+#include "game/graphics/shape_renderer.h"
+#include <algorithm>
+
+ProjectileSystem& ProjectileSystem::Instance() {
+    static ProjectileSystem instance;
+    return instance;
+}
+
+ProjectileSystem::ProjectileSystem()
+    : x_(PROJECTILE_CAPACITY)
+    , y_(PROJECTILE_CAPACITY)
+    , vx_(PROJECTILE_CAPACITY)
+    , vy_(PROJECTILE_CAPACITY)
+    , life_(PROJECTILE_CAPACITY)
+    , shape_(PROJECTILE_CAPACITY)
+    , frame_(PROJECTILE_CAPACITY)
+    , frame_step_(PROJECTILE_CAPACITY)
+    , layer_(PROJECTILE_CAPACITY)
+    , impact_shape_(PROJECTILE_CAPACITY)
+    , impact_frames_(PROJECTILE_CAPACITY)
+    , count_(0)
+    , stats_()
+    , anim_density_(256)
+{
+    impacts_.reserve(PROJECTILE_CAPACITY);
+}
+
+void ProjectileSystem::Clear() {
+    count_ = 0;
+    impacts_.clear();
+}
+
+COORDINATE ProjectileSystem::Get_Coord(int index) const {
+    return XY_Coord(x_[index] >> SUB_BITS, y_[index] >> SUB_BITS);
+}
+
+// =============================================================================
+// Spawning
+// =============================================================================
+
+int ProjectileSystem::Append(ShapeId shape, int frame, COORDINATE at, RenderLayer layer) {
+    if (count_ >= PROJECTILE_CAPACITY) {
+        stats_.dropped++;
+        return -1;
+    }
+
+    int i = count_++;
+    x_[i] = Coord_X(at) * (1 << SUB_BITS);
+    y_[i] = Coord_Y(at) * (1 << SUB_BITS);
+    vx_[i] = 0;
+    vy_[i] = 0;
+    life_[i] = 1;
+    shape_[i] = shape;
+    frame_[i] = static_cast<uint16_t>(frame);
+    frame_step_[i] = 0;
+    layer_[i] = static_cast<uint8_t>(layer);
+    impact_shape_[i] = SHAPE_ID_NONE;
+    impact_frames_[i] = 0;
+    stats_.spawned++;
+    return i;
+}
+
+int ProjectileSystem::Fire(ShapeId shape, int frame, COORDINATE from, COORDINATE to, int speed,
+                           ShapeId impact, int impact_frames) {
+    int i = Append(shape, frame, to, RenderLayer::PROJECTILE);
+    if (i < 0) {
+        return -1;
+    }
+
+    speed = std::max(speed, 1);
+    int ticks = (Coord_Distance(from, to) + speed - 1) / speed;
+    ticks = std::min(std::max(ticks, 1), 0xFFFF);
+
+    // Step back from the target by whole steps: the last step lands on
+    // it exactly, and the start is off by less than a lepton
+    vx_[i] = (Coord_X(to) - Coord_X(from)) * (1 << SUB_BITS) / ticks;
+    vy_[i] = (Coord_Y(to) - Coord_Y(from)) * (1 << SUB_BITS) / ticks;
+    x_[i] -= vx_[i] * ticks;
+    y_[i] -= vy_[i] * ticks;
+    life_[i] = static_cast<uint16_t>(ticks);
+    impact_shape_[i] = impact;
+    impact_frames_[i] = static_cast<uint16_t>(std::min(std::max(impact_frames, 0), 0xFFFF));
+    return i;
+}
+
+int ProjectileSystem::Spawn_Anim(ShapeId shape, COORDINATE at, int frames, int first_frame) {
+    if (frames <= 0) {
+        return -1;
+    }
+
+    int i = Append(shape, first_frame, at, RenderLayer::EFFECT);
+    if (i < 0) {
+        return -1;
+    }
+    life_[i] = static_cast<uint16_t>(std::min(frames, 0xFFFF));
+    frame_step_[i] = 1;
+    return i;
+}
+
+void ProjectileSystem::Remove(int index) {
+    int last = --count_;
+    x_[index] = x_[last];
+    y_[index] = y_[last];
+    vx_[index] = vx_[last];
+    vy_[index] = vy_[last];
+    life_[index] = life_[last];
+    shape_[index] = shape_[last];
+    frame_[index] = frame_[last];
+    frame_step_[index] = frame_step_[last];
+    layer_[index] = layer_[last];
+    impact_shape_[index] = impact_shape_[last];
+    impact_frames_[index] = impact_frames_[last];
+    stats_.expired++;
+}
+
+// =============================================================================
+// Update
+// =============================================================================
+
+void ProjectileSystem::Update() {
+    impacts_.clear();
+
+    // The entry moved into a removed slot has not been stepped yet, so
+    // the same index is visited again
+    int i = 0;
+    while (i < count_) {
+        x_[i] += vx_[i];
+        y_[i] += vy_[i];
+        if (--life_[i] > 0) {
+            frame_[i] = static_cast<uint16_t>(frame_[i] + frame_step_[i]);
+            i++;
+            continue;
+        }
+
+        if (frame_step_[i] == 0) {
+            impacts_.push_back({x_[i], y_[i], impact_shape_[i], impact_frames_[i]});
+        }
+        Remove(i);
+    }
+
+    // Arrivals start their animations next tick, after this loop
+    for (const Impact& impact : impacts_) {
+        COORDINATE at = XY_Coord(impact.x >> SUB_BITS, impact.y >> SUB_BITS);
+        stats_.impacts++;
+        AudioEvent_ProjectileImpact(nullptr, Coord_XPixel(at), Coord_YPixel(at));
+        if (impact.shape != SHAPE_ID_NONE) {
+            Spawn_Anim(impact.shape, at, impact.frames);
+        }
+    }
+}
+
+// =============================================================================
+// Drawing
+// =============================================================================
+
+int ProjectileSystem::Submit(RenderPipeline& pipeline) const {
+    int queued = 0;
+    for (int i = 0; i < count_; i++) {
+        if (anim_density_ < 256 && frame_step_[i] != 0) {
+            // Anims stay put, so the spot picks the same ones every frame
+            uint32_t spot = static_cast<uint32_t>(x_[i]) ^ (static_cast<uint32_t>(y_[i]) * 0x9E3779B1u);
+            if (static_cast<int>((spot * 0x85EBCA6Bu) >> 24) >= anim_density_) {
+                continue;
+            }
+        }
+        COORDINATE coord = Get_Coord(i);
+        int px = Coord_XPixel(coord);
+        int py = Coord_YPixel(coord);
+        queued += pipeline.SubmitShape(shape_[i], frame_[i], px, py,
+                                       static_cast<RenderLayer>(layer_[i]), py,
+                                       nullptr, SHAPE_CENTER);
+    }
+    return queued;
+}
@@ -0,0 +1,125 @@
+/**
+ * SplashDamage Implementation
+ *
+ * Original location: CODE/COMBAT.CPP
+ */
+
+#include "game/splash_damage.h"
+#include "game/audio/audio_events.h"
+#include "game/map.h"
+#include "game/object.h"
+#include "game/object_dispatch.h"
+#include <algorithm>
+
+SplashDamage& SplashDamage::Instance() {
+    static SplashDamage instance;
+    return instance;
+}
+
+void SplashDamage::Add_Impact(COORDINATE at, int damage, int range, int warhead, ObjectClass* source) {
+    if (damage <= 0 || range < 0 || at == COORD_NONE) {
+        return;
+    }
+    ObjectHandle handle = source != nullptr ? Object_Handle(source) : ObjectHandle();
+    impacts_.push_back({at, damage, range, warhead, handle});
+}
+
+int SplashDamage::Falloff(int damage, int distance, int range) {
+    if (distance > range || damage <= 0) {
+        return 0;
+    }
+    if (range <= 0) {
+        return damage;
+    }
+    // Full at the center, half at the edge, never nothing inside the blast
+    return std::max(damage - damage * distance / (2 * range), 1);
+}
+
+// =============================================================================
+// Resolve
+// =============================================================================
+
+int SplashDamage::Resolve() {
+    if (impacts_.empty()) {
+        return 0;
+    }
+
+    Gather();
+    int damaged = Apply();
+
+    stats_.impacts += static_cast<uint32_t>(impacts_.size());
+    impacts_.clear();
+    hits_.clear();
+    return damaged;
+}
+
+void SplashDamage::Gather() {
+    if (Map == nullptr) {
+        return;
+    }
+
+    for (int i = 0; i < static_cast<int>(impacts_.size()); i++) {
+        const Impact& impact = impacts_[i];
+        nearby_.clear();
+        Map->Objects_In_Radius(impact.at, impact.range, nearby_);
+
+        for (ObjectClass* obj : nearby_) {
+            if (!obj->Is_Active()) {
+                continue;
+            }
+            int amount = Falloff(impact.damage, Coord_Distance(impact.at, obj->Get_Coord()), impact.range);
+            ObjectHandle handle = Object_Handle(obj);
+            if (amount <= 0 || handle.Is_None()) {
+                continue;
+            }
+
+            std::vector<int32_t>& index = index_[handle.rtti];
+            if (index.size() <= handle.slot) {
+                index.resize(handle.slot + 1, -1);
+            }
+            if (index[handle.slot] < 0) {
+                index[handle.slot] = static_cast<int32_t>(hits_.size());
+                hits_.push_back({handle, obj, 0, 0, i, -1});
+            }
+
+            Hit& hit = hits_[index[handle.slot]];
+            if (hit.last_impact == i) {
+                continue;
+            }
+            hit.last_impact = i;
+            hit.total += amount;
+            if (amount > hit.heaviest) {
+                hit.heaviest = amount;
+                hit.impact = i;
+            }
+            stats_.hits++;
+        }
+    }
+}
+
+int SplashDamage::Apply() {
+    // Handle order, so every machine deals the totals alike whatever
+    // order the impacts landed in
+    std::sort(hits_.begin(), hits_.end(), [](const Hit& a, const Hit& b) {
+        return a.handle.rtti != b.handle.rtti ? a.handle.rtti < b.handle.rtti
+                                              : a.handle.slot < b.handle.slot;
+    });
+
+    int damaged = 0;
+    for (const Hit& hit : hits_) {
+        index_[hit.handle.rtti][hit.handle.slot] = -1;
+
+        // A building's destruction may already have taken others with it
+        if (!hit.obj->Is_Active()) {
+            continue;
+        }
+        const Impact& impact = impacts_[hit.impact];
+        int dealt = Dispatch_Take_Damage(hit.obj, hit.total, Resolve_Object(impact.source), impact.warhead);
+        if (dealt > 0) {
+            damaged++;
+            AudioEvent_Damage(hit.obj, dealt, Coord_XPixel(impact.at), Coord_YPixel(impact.at));
+        }
+    }
+    stats_.damaged += damaged;
+    return damaged;
+}
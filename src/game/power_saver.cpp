@@ -0,0 +1,67 @@
+/**
+ * Power Saver Implementation
+ */
+
+#include "game/power_saver.h"
+
+bool PowerSaver::Begin_Frame(uint32_t now, bool background, bool static_screen, uint32_t events) {
+    State state = POWER_ACTIVE;
+    if (enabled_) {
+        if (static_screen) {
+            state = POWER_STATIC;
+        } else if (background) {
+            state = POWER_BACKGROUND;
+        }
+    }
+
+    bool draw = true;
+    if (state == POWER_STATIC) {
+        draw = state_ != POWER_STATIC || dirty_ || events != events_ ||
+               now - last_draw_ >= STATIC_REDRAW_MS;
+    }
+
+    state_ = state;
+    draw_ = draw;
+    dirty_ = false;
+    events_ = events;
+    frame_start_ = now;
+    if (draw) {
+        last_draw_ = now;
+        stats_.frames_drawn++;
+    } else {
+        stats_.frames_skipped++;
+    }
+    return draw;
+}
+
+uint32_t PowerSaver::Get_Wait_Ms(uint32_t now) const {
+    switch (state_) {
+        case POWER_STATIC: {
+            uint32_t since = now - last_draw_;
+            return since < STATIC_REDRAW_MS ? STATIC_REDRAW_MS - since : 0;
+        }
+        case POWER_BACKGROUND: {
+            uint32_t period = 1000 / BACKGROUND_FPS;
+            uint32_t since = now - frame_start_;
+            return since < period ? period - since : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+void PowerSaver::Sample_Cpu(int64_t wall_ns, int64_t cpu_ns) {
+    if (cpu_wall_ns_ < 0) {
+        cpu_wall_ns_ = wall_ns;
+        cpu_ns_ = cpu_ns;
+        return;
+    }
+
+    int64_t elapsed = wall_ns - cpu_wall_ns_;
+    if (elapsed < static_cast<int64_t>(CPU_WINDOW_MS) * 1000000) {
+        return;
+    }
+    cpu_ms_per_s_ = static_cast<double>(cpu_ns - cpu_ns_) * 1000.0 / static_cast<double>(elapsed);
+    cpu_wall_ns_ = wall_ns;
+    cpu_ns_ = cpu_ns;
+}
@@ -0,0 +1,106 @@
+/**
+ * Quality Governor Implementation
+ */
+
+#include "game/quality_governor.h"
+#include "platform/profiler.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Effects thin out first, then shadows go, then the slower cadences and
+// fewer voices; the last levels only tighten what is already cut
+const QualityGovernor::Knobs LEVEL_KNOBS[QualityGovernor::MAX_LEVEL + 1] = {
+    // density  shadows  palette  radar  voices
+    {  256,     true,    1,       1,     0  },
+    {  192,     true,    1,       2,     0  },
+    {  128,     false,   2,       4,     12 },
+    {  64,      false,   3,       8,     8  },
+    {  32,      false,   4,       15,    6  },
+};
+
+}  // namespace
+
+QualityGovernor& QualityGovernor::Instance() {
+    static QualityGovernor instance;
+    return instance;
+}
+
+const QualityGovernor::Knobs& QualityGovernor::Get_Knobs(int level) {
+    return LEVEL_KNOBS[std::clamp(level, 0, MAX_LEVEL)];
+}
+
+void QualityGovernor::Set_Apply(ApplyFn apply) {
+    apply_ = std::move(apply);
+    if (apply_) {
+        apply_(Get_Knobs(level_));
+    }
+}
+
+// =============================================================================
+// Judgement
+// =============================================================================
+
+int QualityGovernor::Update() {
+    Profiler& profiler = Profiler::instance();
+    times_ = profiler.get_frame_times(WINDOW_FRAMES);
+    if (!times_.empty()) {
+        size_t nth = std::min(times_.size() * PERCENTILE / 100, times_.size() - 1);
+        std::nth_element(times_.begin(), times_.begin() + nth, times_.end());
+        Evaluate(times_[nth]);
+    }
+    profiler.record_value(PROFILE_ID("Quality Level"), level_);
+    return level_;
+}
+
+int QualityGovernor::Evaluate(double frame_ms) {
+    frame_ms_ = frame_ms;
+    if (budget_ms_ <= 0.0) {
+        if (level_ != 0) {
+            Set_Level(0);
+        }
+        return level_;
+    }
+
+    // The window still holds frames from before the last change
+    if (hold_ > 0) {
+        hold_--;
+        return level_;
+    }
+
+    if (frame_ms > budget_ms_) {
+        under_ = 0;
+        if (++over_ >= OVER_FRAMES && level_ < MAX_LEVEL) {
+            stats_.cuts++;
+            Change(level_ + 1);
+        }
+    } else if (frame_ms < budget_ms_ * RECOVER_RATIO) {
+        over_ = 0;
+        if (++under_ >= UNDER_FRAMES && level_ > 0) {
+            stats_.restores++;
+            Change(level_ - 1);
+        }
+    } else {
+        over_ = 0;
+        under_ = 0;
+    }
+    return level_;
+}
+
+void QualityGovernor::Set_Level(int level) {
+    Change(std::clamp(level, 0, MAX_LEVEL));
+}
+
+void QualityGovernor::Change(int level) {
+    over_ = 0;
+    under_ = 0;
+    hold_ = WINDOW_FRAMES;
+    if (level == level_) {
+        return;
+    }
+    level_ = level;
+    if (apply_) {
+        apply_(Get_Knobs(level_));
+    }
+}
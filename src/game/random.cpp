@@ -0,0 +1,75 @@
+/**
+ * Random Streams Implementation
+ */
+
+#include "game/random.h"
+#include "platform.h"
+
+namespace {
+
+const int LANES = 8;
+
+/**
+ * Multiplier and increment that step the LCG k times in one go:
+ * seed_k = A_k * seed + C_k
+ */
+struct Jump {
+    uint32_t mul[LANES + 1];
+    uint32_t add[LANES + 1];
+};
+
+constexpr Jump Make_Jump() {
+    Jump jump = {};
+    jump.mul[0] = 1;
+    jump.add[0] = 0;
+    for (int k = 1; k <= LANES; k++) {
+        jump.mul[k] = jump.mul[k - 1] * RandomStream::MULTIPLIER;
+        jump.add[k] = jump.add[k - 1] * RandomStream::MULTIPLIER + RandomStream::INCREMENT;
+    }
+    return jump;
+}
+
+constexpr Jump JUMP = Make_Jump();
+
+} // namespace
+
+// =============================================================================
+// RandomStream
+// =============================================================================
+
+void RandomStream::Fill(uint32_t* out, size_t count) {
+    uint32_t seed = seed_;
+    size_t i = 0;
+
+    // Lane k of a block is k + 1 steps past the block's starting seed
+    for (; i + LANES <= count; i += LANES) {
+        for (int k = 0; k < LANES; k++) {
+            out[i + k] = ((JUMP.mul[k + 1] * seed + JUMP.add[k + 1]) >> 16) & MAX_VALUE;
+        }
+        seed = JUMP.mul[LANES] * seed + JUMP.add[LANES];
+    }
+
+    seed_ = seed;
+    for (; i < count; i++) {
+        out[i] = Next();
+    }
+}
+
+// =============================================================================
+// Streams
+// =============================================================================
+
+RandomStream& Sim_Random() {
+    static RandomStream stream;
+    return stream;
+}
+
+RandomStream& Fx_Random() {
+    static RandomStream stream(0x5EED0F1Au);
+    return stream;
+}
+
+void Sim_Random_Seed(uint32_t seed) {
+    Sim_Random().Seed(seed);
+    Platform_Random_Seed(seed);
+}
@@ -0,0 +1,129 @@
+/**
+ * Relay Implementation
+ */
+
+#include "game/relay.h"
+#include "platform.h"
+#include <cstdio>
+
+// =============================================================================
+// RelayMatch
+// =============================================================================
+
+RelayMatch::~RelayMatch() {
+    Close();
+}
+
+bool RelayMatch::Open(uint16_t port, int max_players) {
+    Close();
+
+    host_ = Platform_Host_Create(port, max_players, CHANNELS);
+    if (host_ == nullptr) {
+        return false;
+    }
+    port_ = Platform_Host_GetPort(host_);
+    stats_ = RelayStats();
+    stats_.matches = 1;
+    return true;
+}
+
+void RelayMatch::Close() {
+    if (host_ != nullptr) {
+        Platform_Host_Destroy(host_);
+        host_ = nullptr;
+    }
+    stats_.matches = 0;
+    stats_.active_matches = 0;
+    stats_.peers = 0;
+}
+
+int RelayMatch::Get_Peer_Count() const {
+    return host_ ? Platform_Host_PeerCount(host_) : 0;
+}
+
+int RelayMatch::Service() {
+    if (host_ == nullptr) {
+        return 0;
+    }
+
+    Platform_Host_Service(host_, 0);
+    int peers = Platform_Host_PeerCount(host_);
+    stats_.peers = static_cast<uint32_t>(peers > 0 ? peers : 0);
+    stats_.active_matches = peers > 0 ? 1 : 0;
+
+    // Views point into the host's arena; each call continues the batch
+    PacketView views[BATCH_PACKETS];
+    int relayed = 0;
+    int count;
+    do {
+        count = Platform_Host_ReceiveBatch(host_, views, BATCH_PACKETS);
+        for (int i = 0; i < count; i++) {
+            const PacketView& view = views[i];
+            int reliable = view.channel == 0 ? 1 : 0;
+            if (Platform_Host_Broadcast(host_, view.channel, view.data,
+                                        static_cast<int32_t>(view.size), reliable) == 0) {
+                stats_.bytes_out += static_cast<uint64_t>(view.size) * stats_.peers;
+            }
+            stats_.packets_in++;
+            stats_.bytes_in += view.size;
+        }
+        relayed += count > 0 ? count : 0;
+    } while (count == BATCH_PACKETS);
+    Platform_Host_ReleaseBatch(host_);
+
+    if (relayed > 0) {
+        Platform_Host_Flush(host_);
+    }
+    return relayed;
+}
+
+// =============================================================================
+// RelayServer
+// =============================================================================
+
+int RelayServer::Start(uint16_t base_port, int match_count, int players_per_match) {
+    Stop();
+
+    for (int i = 0; i < match_count; i++) {
+        uint16_t port = static_cast<uint16_t>(base_port + i);
+        RelayMatch* match = new RelayMatch();
+        if (!match->Open(port, players_per_match)) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "RelayServer: Could not listen on port %u", port);
+            Platform_LogWarn(msg);
+            delete match;
+            continue;
+        }
+        matches_.push_back(match);
+    }
+    return static_cast<int>(matches_.size());
+}
+
+void RelayServer::Stop() {
+    for (RelayMatch* match : matches_) {
+        delete match;
+    }
+    matches_.clear();
+}
+
+int RelayServer::Service() {
+    int relayed = 0;
+    for (RelayMatch* match : matches_) {
+        relayed += match->Service();
+    }
+    return relayed;
+}
+
+RelayStats RelayServer::Get_Stats() const {
+    RelayStats total;
+    for (const RelayMatch* match : matches_) {
+        const RelayStats& stats = match->Get_Stats();
+        total.matches += stats.matches;
+        total.active_matches += stats.active_matches;
+        total.peers += stats.peers;
+        total.packets_in += stats.packets_in;
+        total.bytes_in += stats.bytes_in;
+        total.bytes_out += stats.bytes_out;
+    }
+    return total;
+}
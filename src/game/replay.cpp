@@ -0,0 +1,228 @@
+/**
+ * Replay Implementation
+ */
+
+#include "game/replay.h"
+#include "game/map.h"
+#include "game/random.h"
+#include "game/saveload.h"
+#include "game/input/command_system.h"
+#include "game/input/selection_manager.h"
+#include "game/io/pipe.h"
+#include "game/io/straw.h"
+#include "platform.h"
+#include "platform/io_stats.h"
+#include <cstring>
+#include <utility>
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+void Replay::Clear() {
+    seed = 0;
+    tick_count = 0;
+    snapshot.clear();
+    commands.clear();
+    ids.clear();
+}
+
+bool Replay::Save(const char* path) const {
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_WRITE) : nullptr;
+    if (file == nullptr) {
+        return false;
+    }
+
+    ReplayHeader header;
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.seed = seed;
+    header.tick_count = tick_count;
+    header.command_count = static_cast<uint32_t>(commands.size());
+    header.id_count = static_cast<uint32_t>(ids.size());
+    header.snapshot_size = static_cast<uint32_t>(snapshot.size());
+
+    FilePipe pipe(file);
+    pipe.Put(&header, sizeof(header));
+    pipe.Put(snapshot.data(), static_cast<int>(snapshot.size()));
+    pipe.Put(commands.data(), static_cast<int>(commands.size() * sizeof(ReplayCommand)));
+    pipe.Put(ids.data(), static_cast<int>(ids.size() * sizeof(uint32_t)));
+    bool ok = !pipe.HasError();
+    Platform_File_Close(file);
+    return ok;
+}
+
+bool Replay::Load(const char* path) {
+    Clear();
+    IoScope io(IoTag::SAVE);
+
+    int64_t size = 0;
+    const uint8_t* data = path ? Platform_File_Map(path, &size) : nullptr;
+    if (data == nullptr) {
+        return false;
+    }
+
+    ReplayHeader header;
+    bool ok = static_cast<size_t>(size) >= sizeof(header);
+    if (ok) {
+        memcpy(&header, data, sizeof(header));
+        uint64_t expected = sizeof(header) + static_cast<uint64_t>(header.snapshot_size) +
+                            static_cast<uint64_t>(header.command_count) * sizeof(ReplayCommand) +
+                            static_cast<uint64_t>(header.id_count) * sizeof(uint32_t);
+        ok = header.magic == REPLAY_MAGIC && header.version == REPLAY_VERSION &&
+             expected == static_cast<uint64_t>(size);
+    }
+
+    if (ok) {
+        const uint8_t* pos = data + sizeof(header);
+        snapshot.assign(pos, pos + header.snapshot_size);
+        pos += header.snapshot_size;
+        commands.resize(header.command_count);
+        if (!commands.empty()) {
+            memcpy(commands.data(), pos, commands.size() * sizeof(ReplayCommand));
+        }
+        pos += commands.size() * sizeof(ReplayCommand);
+        ids.resize(header.id_count);
+        if (!ids.empty()) {
+            memcpy(ids.data(), pos, ids.size() * sizeof(uint32_t));
+        }
+        seed = header.seed;
+        tick_count = header.tick_count;
+
+        // Commands must be in tick order and name ids that exist
+        uint32_t last_tick = 0;
+        for (const ReplayCommand& cmd : commands) {
+            if (cmd.tick < last_tick || cmd.first_id > ids.size() ||
+                cmd.id_count > ids.size() - cmd.first_id) {
+                ok = false;
+                break;
+            }
+            last_tick = cmd.tick;
+        }
+    }
+
+    Platform_File_Unmap(data);
+    if (!ok) {
+        Clear();
+    }
+    return ok;
+}
+
+// =============================================================================
+// ReplayRecorder
+// =============================================================================
+
+ReplayRecorder& ReplayRecorder::Instance() {
+    static ReplayRecorder instance;
+    return instance;
+}
+
+bool ReplayRecorder::Start(uint32_t seed, const MapClass& map) {
+    replay_.Clear();
+    recording_ = false;
+
+    BufferPipe pipe;
+    if (!SaveLoad::Save(pipe, map)) {
+        return false;
+    }
+
+    replay_.seed = seed;
+    replay_.snapshot = pipe.GetData();
+    Sim_Random_Seed(seed);
+    recording_ = true;
+    return true;
+}
+
+Replay ReplayRecorder::Stop() {
+    recording_ = false;
+    Replay replay;
+    std::swap(replay, replay_);
+    return replay;
+}
+
+void ReplayRecorder::Record(const Command& cmd) {
+    if (!recording_) {
+        return;
+    }
+
+    ReplayCommand record;
+    record.tick = replay_.tick_count;
+    record.type = static_cast<int32_t>(cmd.type);
+    record.flags = cmd.flags;
+    record.target_type = static_cast<int32_t>(cmd.target.type);
+    record.world_x = cmd.target.world_x;
+    record.world_y = cmd.target.world_y;
+    record.cell_x = cmd.target.cell_x;
+    record.cell_y = cmd.target.cell_y;
+    record.object_id = cmd.target.object_id;
+    if (cmd.target.type == CommandTarget::Type::OBJECT && cmd.target.object != nullptr) {
+        // Object targets come from the cursor context, which holds SelectableObjects
+        record.object_id = static_cast<const SelectableObject*>(cmd.target.object)->id;
+    }
+
+    const auto& selection = SelectionManager::Instance().GetSelection();
+    record.first_id = static_cast<uint32_t>(replay_.ids.size());
+    record.id_count = 0;
+    for (const SelectableObject* obj : selection) {
+        if (obj) {
+            replay_.ids.push_back(obj->id);
+            record.id_count++;
+        }
+    }
+
+    replay_.commands.push_back(record);
+}
+
+// =============================================================================
+// ReplayPlayer
+// =============================================================================
+
+bool ReplayPlayer::Start(const Replay& replay, MapClass& map) {
+    replay_ = nullptr;
+    tick_ = 0;
+    next_ = 0;
+
+    BufferStraw straw(replay.snapshot.data(), replay.snapshot.size());
+    if (!SaveLoad::Load(straw, map)) {
+        return false;
+    }
+
+    Sim_Random_Seed(replay.seed);
+    replay_ = &replay;
+    return true;
+}
+
+int ReplayPlayer::Begin_Tick() {
+    if (replay_ == nullptr) {
+        return 0;
+    }
+
+    SelectionManager& selection = SelectionManager::Instance();
+    CommandSystem& commands = CommandSystem::Instance();
+    int issued = 0;
+
+    while (next_ < replay_->commands.size() && replay_->commands[next_].tick <= tick_) {
+        const ReplayCommand& record = replay_->commands[next_++];
+
+        selection.SelectIds(replay_->ids.data() + record.first_id, static_cast<int>(record.id_count));
+
+        Command cmd;
+        cmd.Clear();
+        cmd.type = static_cast<CommandType>(record.type);
+        cmd.flags = record.flags;
+        cmd.target.type = static_cast<CommandTarget::Type>(record.target_type);
+        cmd.target.world_x = record.world_x;
+        cmd.target.world_y = record.world_y;
+        cmd.target.cell_x = record.cell_x;
+        cmd.target.cell_y = record.cell_y;
+        cmd.target.object_id = record.object_id;
+        if (cmd.target.type == CommandTarget::Type::OBJECT) {
+            cmd.target.object = selection.FindObject(record.object_id);
+        }
+
+        commands.IssueCommand(cmd);
+        issued++;
+    }
+
+    return issued;
+}
@@ -0,0 +1,218 @@
+/**
+ * Resync Implementation
+ */
+
+#include "game/resync.h"
+#include "game/map.h"
+#include "game/random.h"
+#include "game/saveload.h"
+#include "game/input/command_packet.h"
+#include "game/input/command_system.h"
+#include "game/io/pipe.h"
+#include "game/io/straw.h"
+#include "platform.h"
+#include <cstring>
+
+// =============================================================================
+// ResyncPackage
+// =============================================================================
+
+void ResyncPackage::Clear() {
+    base_tick = 0;
+    live_tick = 0;
+    seed = 0;
+    state_hash = 0;
+    snapshot.clear();
+    log.clear();
+}
+
+void ResyncPackage::Write(std::vector<uint8_t>& out) const {
+    ResyncHeader header;
+    header.magic = RESYNC_MAGIC;
+    header.version = RESYNC_VERSION;
+    header.base_tick = base_tick;
+    header.live_tick = live_tick;
+    header.seed = seed;
+    header.snapshot_size = static_cast<uint32_t>(snapshot.size());
+    header.log_size = static_cast<uint32_t>(log.size());
+    header.reserved = 0;
+    header.state_hash = state_hash;
+
+    size_t start = out.size();
+    out.resize(start + sizeof(header) + snapshot.size() + log.size());
+    uint8_t* pos = out.data() + start;
+    memcpy(pos, &header, sizeof(header));
+    pos += sizeof(header);
+    if (!snapshot.empty()) {
+        memcpy(pos, snapshot.data(), snapshot.size());
+        pos += snapshot.size();
+    }
+    if (!log.empty()) {
+        memcpy(pos, log.data(), log.size());
+    }
+}
+
+bool ResyncPackage::Read(const uint8_t* data, size_t size) {
+    Clear();
+
+    ResyncHeader header;
+    if (data == nullptr || size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    uint64_t expected = sizeof(header) + static_cast<uint64_t>(header.snapshot_size) +
+                        static_cast<uint64_t>(header.log_size);
+    if (header.magic != RESYNC_MAGIC || header.version != RESYNC_VERSION ||
+        expected != static_cast<uint64_t>(size) || header.live_tick < header.base_tick) {
+        return false;
+    }
+
+    // Tick blocks must tile the log, in order, within the ticks to run
+    const uint8_t* log_data = data + sizeof(header) + header.snapshot_size;
+    uint32_t span = header.live_tick - header.base_tick;
+    uint32_t last_tick = 0;
+    size_t offset = 0;
+    while (offset < header.log_size) {
+        ResyncTick tag;
+        if (header.log_size - offset < sizeof(tag)) {
+            return false;
+        }
+        memcpy(&tag, log_data + offset, sizeof(tag));
+        offset += sizeof(tag);
+        if (tag.tick < last_tick || tag.tick >= span || tag.size > header.log_size - offset) {
+            return false;
+        }
+        last_tick = tag.tick;
+        offset += tag.size;
+    }
+
+    base_tick = header.base_tick;
+    live_tick = header.live_tick;
+    seed = header.seed;
+    state_hash = header.state_hash;
+    snapshot.assign(data + sizeof(header), log_data);
+    log.assign(log_data, log_data + header.log_size);
+    return true;
+}
+
+// =============================================================================
+// ResyncLog
+// =============================================================================
+
+ResyncLog& ResyncLog::Instance() {
+    static ResyncLog instance;
+    return instance;
+}
+
+bool ResyncLog::Start(uint32_t tick, const MapClass& map) {
+    active_ = Checkpoint(tick, map);
+    return active_;
+}
+
+void ResyncLog::Stop() {
+    active_ = false;
+    package_.Clear();
+    open_block_ = SIZE_MAX;
+}
+
+bool ResyncLog::Checkpoint(uint32_t tick, const MapClass& map) {
+    BufferPipe pipe;
+    if (!SaveLoad::Save(pipe, map)) {
+        return false;
+    }
+
+    package_.Clear();
+    package_.snapshot = pipe.GetData();
+    package_.seed = Sim_Random().Get_Seed();
+    package_.base_tick = tick;
+    tick_ = tick;
+    open_block_ = SIZE_MAX;
+    return true;
+}
+
+void ResyncLog::Record(const CommandPacket& packet) {
+    if (!active_) {
+        return;
+    }
+
+    // Packets run before the same tick share one block
+    ResyncTick tag;
+    uint32_t tick = tick_ - package_.base_tick;
+    if (open_block_ == SIZE_MAX) {
+        tag.tick = tick;
+        tag.size = 0;
+        open_block_ = package_.log.size();
+        package_.log.resize(open_block_ + sizeof(tag));
+    } else {
+        memcpy(&tag, package_.log.data() + open_block_, sizeof(tag));
+    }
+
+    tag.size += static_cast<uint32_t>(packet.Write(package_.log));
+    memcpy(package_.log.data() + open_block_, &tag, sizeof(tag));
+}
+
+void ResyncLog::End_Tick(uint32_t tick, const MapClass& map) {
+    if (!active_) {
+        return;
+    }
+
+    tick_ = tick;
+    open_block_ = SIZE_MAX;
+
+    // A failed checkpoint keeps the old one; the log just grows longer
+    if (tick - package_.base_tick >= interval_ && !Checkpoint(tick, map)) {
+        Platform_LogWarn("ResyncLog: Checkpoint failed");
+    }
+}
+
+bool ResyncLog::Build(uint32_t live_tick, uint64_t state_hash, ResyncPackage& out) const {
+    if (!active_ || live_tick < package_.base_tick) {
+        return false;
+    }
+
+    out = package_;
+    out.live_tick = live_tick;
+    out.state_hash = state_hash;
+    return true;
+}
+
+// =============================================================================
+// ResyncPlayer
+// =============================================================================
+
+bool ResyncPlayer::Start(const ResyncPackage& package, MapClass& map) {
+    package_ = nullptr;
+    tick_ = 0;
+    next_ = 0;
+
+    BufferStraw straw(package.snapshot.data(), package.snapshot.size());
+    if (!SaveLoad::Load(straw, map)) {
+        return false;
+    }
+
+    Sim_Random_Seed(package.seed);
+    package_ = &package;
+    return true;
+}
+
+int ResyncPlayer::Begin_Tick() {
+    if (package_ == nullptr) {
+        return 0;
+    }
+
+    CommandSystem& commands = CommandSystem::Instance();
+    const std::vector<uint8_t>& log = package_->log;
+    int run = 0;
+
+    while (next_ < log.size()) {
+        ResyncTick tag;
+        memcpy(&tag, log.data() + next_, sizeof(tag));
+        if (tag.tick > tick_) {
+            break;
+        }
+        run += commands.ExecutePackets(log.data() + next_ + sizeof(tag), tag.size);
+        next_ += sizeof(tag) + tag.size;
+    }
+
+    return run;
+}
@@ -0,0 +1,493 @@
+/**
+ * SaveLoad Implementation
+ */
+
+#include "game/saveload.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include "game/object_heap.h"
+#include "game/projectile.h"
+#include "game/splash_damage.h"
+#include "game/techno.h"
+#include "game/vision_map.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/io/lzo_pipe.h"
+#include "game/io/pipe.h"
+#include "game/io/straw.h"
+#include "platform.h"
+#include "platform/io_stats.h"
+#include <cstring>
+#include <string>
+
+namespace {
+
+constexpr int MAP_PLANES = 5;       // Template, icon, overlay, overlay data, visibility
+constexpr size_t VISION_PLANE_BYTES = VisionMap::PLANE_WORDS * sizeof(uint64_t);
+constexpr size_t MAP_BLOCK_SIZE = 4 * sizeof(int16_t) + MAP_PLANES * MAP_CELL_TOTAL +
+                                  HOUSE_COUNT * 2 * VISION_PLANE_BYTES;
+constexpr int OBJECT_HEAP_COUNT = RTTI_TRIGGER - RTTI_UNIT;
+
+// Bytes per projectile across all the arrays
+constexpr size_t PROJECTILE_BYTES = 4 * sizeof(int32_t) + 3 * sizeof(uint16_t) +
+                                    2 * sizeof(int16_t) + 2 * sizeof(uint8_t);
+
+void Put(std::vector<uint8_t>& out, const void* source, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(source);
+    out.insert(out.end(), bytes, bytes + length);
+}
+
+template <typename T>
+void Put(std::vector<uint8_t>& out, const T& value) {
+    Put(out, &value, sizeof(value));
+}
+
+void Put_Block(std::vector<uint8_t>& out, SaveBlockType id, size_t size) {
+    Put(out, SaveBlock{id, static_cast<uint32_t>(size)});
+}
+
+/**
+ * Reader - Bounds-checked cursor over the decoded body
+ */
+struct Reader {
+    const uint8_t* pos;
+    size_t left;
+
+    bool Get(void* dest, size_t length) {
+        if (length > left) {
+            return false;
+        }
+        if (length == 0) {
+            return true;        // dest may be an empty vector's nullptr
+        }
+        memcpy(dest, pos, length);
+        pos += length;
+        left -= length;
+        return true;
+    }
+
+    template <typename T>
+    bool Get(T& value) { return Get(&value, sizeof(value)); }
+
+    template <typename T>
+    bool Get_Array(std::vector<T>& values, int count) {
+        values.resize(count);
+        return Get(values.data(), count * sizeof(T));
+    }
+};
+
+// Shape handles are only good for this process, so save indices into a
+// table of the shapes' names
+int16_t Shape_Index(ShapeId id, std::vector<ShapeId>& table) {
+    if (id == SHAPE_ID_NONE) {
+        return -1;
+    }
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table[i] == id) {
+            return static_cast<int16_t>(i);
+        }
+    }
+    table.push_back(id);
+    return static_cast<int16_t>(table.size() - 1);
+}
+
+} // namespace
+
+/**
+ * Snapshot - A save decoded and checked but not yet applied
+ */
+struct SaveLoad::Snapshot {
+    int16_t x, y, width, height;
+    std::vector<uint8_t> planes;            // MAP_PLANES row-major planes
+    std::vector<uint64_t> vision;           // Per house: visible, explored
+    std::vector<SaveObject> objects[OBJECT_HEAP_COUNT];
+
+    int projectile_count = 0;
+    std::vector<std::string> shape_names;
+    std::vector<int32_t> px, py, vx, vy;
+    std::vector<uint16_t> life, frame, impact_frames;
+    std::vector<int16_t> shape, impact_shape;
+    std::vector<uint8_t> frame_step, layer;
+};
+
+// =============================================================================
+// Writing
+// =============================================================================
+
+void SaveLoad::Write_Body(std::vector<uint8_t>& out, const MapClass& map) {
+    const CellLayers* layers = map.Get_Cell_Layers();
+
+    // Map: the layers already hold the planes in file order
+    Put_Block(out, SAVE_BLOCK_MAP, MAP_BLOCK_SIZE);
+    Put(out, static_cast<int16_t>(map.Map_Bounds_X()));
+    Put(out, static_cast<int16_t>(map.Map_Bounds_Y()));
+    Put(out, static_cast<int16_t>(map.Map_Bounds_Width()));
+    Put(out, static_cast<int16_t>(map.Map_Bounds_Height()));
+    Put(out, layers->template_type, MAP_CELL_TOTAL);
+    Put(out, layers->icon, MAP_CELL_TOTAL);
+    Put(out, layers->overlay, MAP_CELL_TOTAL);
+    Put(out, layers->overlay_data, MAP_CELL_TOTAL);
+    Put(out, layers->visibility, MAP_CELL_TOTAL);
+
+    const VisionMap* vision = map.Get_Vision();
+    static const uint64_t no_plane[VisionMap::PLANE_WORDS] = {};
+    for (int house = 0; house < HOUSE_COUNT; house++) {
+        HousesType h = static_cast<HousesType>(house);
+        Put(out, vision ? vision->Get_Visible(h) : no_plane, VISION_PLANE_BYTES);
+        Put(out, vision ? vision->Get_Explored(h) : no_plane, VISION_PLANE_BYTES);
+    }
+
+    // Objects: one record per live object, in heap order
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        const ObjectHeapBase* heap = Object_Heap(static_cast<RTTIType>(rtti));
+        int count = heap->Count();
+        Put_Block(out, SAVE_BLOCK_OBJECTS, sizeof(int32_t) * 2 + count * sizeof(SaveObject));
+        Put(out, static_cast<int32_t>(rtti));
+        Put(out, static_cast<int32_t>(count));
+
+        for (int i = 0; i < count; i++) {
+            const ObjectClass* obj = heap->Active(i);
+            SaveObject record = {};
+            record.coord = obj->Get_Coord();
+            record.destination = COORD_NONE;
+            record.strength = obj->Get_Strength();
+            record.target_index = -1;
+            record.target_rtti = RTTI_NONE;
+            record.owner = static_cast<int8_t>(obj->Get_Owner());
+            record.flags = (obj->Is_Active() ? SAVE_OBJECT_ACTIVE : 0) |
+                           (obj->Is_Selected() ? SAVE_OBJECT_SELECTED : 0);
+            record.armor = ARMOR_NONE;
+            record.primary_weapon = WEAPON_NONE;
+            record.secondary_weapon = WEAPON_NONE;
+
+            if (obj->Is_Techno()) {
+                const TechnoClass* techno = static_cast<const TechnoClass*>(obj);
+                record.arm = techno->arm_;
+                record.scan_wait = techno->scan_wait_;
+                record.sight_range = static_cast<uint8_t>(techno->sight_range_);
+                record.body_current = techno->body_facing_.Current();
+                record.body_desired = techno->body_facing_.Desired();
+                record.body_rate = techno->body_facing_.Rate();
+                record.turret_current = techno->turret_facing_.Current();
+                record.turret_desired = techno->turret_facing_.Desired();
+                record.turret_rate = techno->turret_facing_.Rate();
+                record.armor = static_cast<int8_t>(techno->armor_);
+                record.primary_weapon = static_cast<int8_t>(techno->primary_weapon_);
+                record.secondary_weapon = static_cast<int8_t>(techno->secondary_weapon_);
+                if (techno->Is_Cloaked()) {
+                    record.flags |= SAVE_OBJECT_CLOAKED;
+                }
+
+                // A target is saved as where it sits in its heap, which is
+                // where the loader will recreate it
+                ObjectHandle target = Object_Handle(techno->target_);
+                if (!target.Is_None()) {
+                    record.target_rtti = static_cast<int8_t>(target.rtti);
+                    record.target_index = techno->target_->Get_Heap_ID();
+                }
+            }
+            if (obj->Is_Foot()) {
+                const FootClass* foot = static_cast<const FootClass*>(obj);
+                record.speed = foot->Get_Speed();
+                record.destination = foot->Get_Destination();
+            }
+            Put(out, record);
+        }
+    }
+
+    // Projectiles: the live part of each array, shapes as name indices
+    const ProjectileSystem& projectiles = ProjectileSystem::Instance();
+    int count = projectiles.count_;
+    std::vector<ShapeId> shape_ids;
+    std::vector<int16_t> shapes(count);
+    std::vector<int16_t> impact_shapes(count);
+    for (int i = 0; i < count; i++) {
+        shapes[i] = Shape_Index(projectiles.shape_[i], shape_ids);
+        impact_shapes[i] = Shape_Index(projectiles.impact_shape_[i], shape_ids);
+    }
+    std::vector<std::string> names;
+    size_t names_size = 0;
+    for (ShapeId id : shape_ids) {
+        names.emplace_back(ShapeCache::Instance().Get_Name(id));
+        names.back().resize(std::min<size_t>(names.back().size(), 255));
+        names_size += 1 + names.back().size();
+    }
+
+    Put_Block(out, SAVE_BLOCK_PROJECTILES, 2 * sizeof(int32_t) + names_size + count * PROJECTILE_BYTES);
+    Put(out, static_cast<int32_t>(count));
+    Put(out, static_cast<int32_t>(names.size()));
+    for (const std::string& name : names) {
+        Put(out, static_cast<uint8_t>(name.size()));
+        Put(out, name.data(), name.size());
+    }
+    Put(out, projectiles.x_.data(), count * sizeof(int32_t));
+    Put(out, projectiles.y_.data(), count * sizeof(int32_t));
+    Put(out, projectiles.vx_.data(), count * sizeof(int32_t));
+    Put(out, projectiles.vy_.data(), count * sizeof(int32_t));
+    Put(out, projectiles.life_.data(), count * sizeof(uint16_t));
+    Put(out, projectiles.frame_.data(), count * sizeof(uint16_t));
+    Put(out, projectiles.impact_frames_.data(), count * sizeof(uint16_t));
+    Put(out, shapes.data(), count * sizeof(int16_t));
+    Put(out, impact_shapes.data(), count * sizeof(int16_t));
+    Put(out, projectiles.frame_step_.data(), count * sizeof(uint8_t));
+    Put(out, projectiles.layer_.data(), count * sizeof(uint8_t));
+
+    Put_Block(out, SAVE_BLOCK_END, 0);
+}
+
+bool SaveLoad::Save(Pipe& pipe, const MapClass& map) {
+    if (map.Get_Cell_Layers() == nullptr) {
+        return false;
+    }
+
+    std::vector<uint8_t> body;
+    body.reserve(MAP_BLOCK_SIZE + 64 * 1024);
+    Write_Body(body, map);
+
+    SaveHeader header = {};
+    header.magic = SAVE_MAGIC;
+    header.version = SAVE_VERSION;
+    header.body_size = static_cast<uint32_t>(body.size());
+    header.object_count = static_cast<uint32_t>(Object_Count());
+    pipe.Put(&header, sizeof(header));
+
+    // Largest blocks: fewest headers and the best compression
+    LZOPipe lzo(LZOPipe::COMPRESS, LZO_MAX_BLOCK_SIZE);
+    lzo.Put_To(pipe);
+    lzo.Put(body.data(), static_cast<int>(body.size()));
+    lzo.End();
+    lzo.Put_To(nullptr);
+    return true;
+}
+
+bool SaveLoad::Save_Game(const char* path, const MapClass& map) {
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_WRITE) : nullptr;
+    if (file == nullptr) {
+        return false;
+    }
+
+    FilePipe pipe(file);
+    bool ok = Save(pipe, map) && !pipe.HasError();
+    Platform_File_Close(file);
+    return ok;
+}
+
+// =============================================================================
+// Reading
+// =============================================================================
+
+bool SaveLoad::Read_Body(const uint8_t* data, size_t size, Snapshot& snapshot) {
+    Reader in{data, size};
+    SaveBlock block;
+
+    if (!in.Get(block) || block.id != SAVE_BLOCK_MAP || block.size != MAP_BLOCK_SIZE ||
+        !in.Get(snapshot.x) || !in.Get(snapshot.y) || !in.Get(snapshot.width) || !in.Get(snapshot.height) ||
+        !in.Get_Array(snapshot.planes, MAP_PLANES * MAP_CELL_TOTAL) ||
+        !in.Get_Array(snapshot.vision, HOUSE_COUNT * 2 * VisionMap::PLANE_WORDS)) {
+        return false;
+    }
+
+    for (int heap = 0; heap < OBJECT_HEAP_COUNT; heap++) {
+        int32_t rtti = 0;
+        int32_t count = 0;
+        if (!in.Get(block) || block.id != SAVE_BLOCK_OBJECTS || !in.Get(rtti) || !in.Get(count) ||
+            rtti != RTTI_UNIT + heap || count < 0 ||
+            block.size != sizeof(int32_t) * 2 + static_cast<size_t>(count) * sizeof(SaveObject) ||
+            !in.Get_Array(snapshot.objects[heap], count)) {
+            return false;
+        }
+    }
+
+    // Every target must name an object the snapshot recreates
+    for (const std::vector<SaveObject>& records : snapshot.objects) {
+        for (const SaveObject& record : records) {
+            if (record.target_index < 0) {
+                continue;
+            }
+            int heap = record.target_rtti - RTTI_UNIT;
+            if (heap < 0 || heap >= OBJECT_HEAP_COUNT ||
+                record.target_index >= static_cast<int>(snapshot.objects[heap].size())) {
+                return false;
+            }
+        }
+    }
+
+    int32_t count = 0;
+    int32_t name_count = 0;
+    if (!in.Get(block) || block.id != SAVE_BLOCK_PROJECTILES || !in.Get(count) || !in.Get(name_count) ||
+        count < 0 || count > PROJECTILE_CAPACITY || name_count < 0 || name_count > 2 * count) {
+        return false;
+    }
+    snapshot.projectile_count = count;
+    snapshot.shape_names.resize(name_count);
+    for (std::string& name : snapshot.shape_names) {
+        uint8_t length = 0;
+        if (!in.Get(length)) {
+            return false;
+        }
+        name.resize(length);
+        if (!in.Get(&name[0], length)) {
+            return false;
+        }
+    }
+    bool ok = in.Get_Array(snapshot.px, count) && in.Get_Array(snapshot.py, count) &&
+              in.Get_Array(snapshot.vx, count) && in.Get_Array(snapshot.vy, count) &&
+              in.Get_Array(snapshot.life, count) && in.Get_Array(snapshot.frame, count) &&
+              in.Get_Array(snapshot.impact_frames, count) &&
+              in.Get_Array(snapshot.shape, count) && in.Get_Array(snapshot.impact_shape, count) &&
+              in.Get_Array(snapshot.frame_step, count) && in.Get_Array(snapshot.layer, count);
+    if (!ok) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        if (snapshot.shape[i] >= name_count || snapshot.impact_shape[i] >= name_count) {
+            return false;
+        }
+    }
+
+    return in.Get(block) && block.id == SAVE_BLOCK_END && in.left == 0;
+}
+
+void SaveLoad::Apply(const Snapshot& snapshot, MapClass& map) {
+    // Objects unmark their cells as they go, so free them before the map resets
+    Destroy_All_Objects();
+    ProjectileSystem::Instance().Clear();
+    SplashDamage::Instance().Clear();
+
+    map.Clear_Map();
+    map.Set_Map_Bounds(snapshot.x, snapshot.y, snapshot.width, snapshot.height);
+    const uint8_t* planes = snapshot.planes.data();
+    map.Load_Cells(planes, planes + MAP_CELL_TOTAL, planes + 2 * MAP_CELL_TOTAL,
+                   planes + 3 * MAP_CELL_TOTAL, planes + 4 * MAP_CELL_TOTAL);
+
+    // Before anything is placed: placing technos adds their sight on top
+    if (VisionMap* vision = map.Get_Vision()) {
+        for (int house = 0; house < HOUSE_COUNT; house++) {
+            const uint64_t* visible = &snapshot.vision[house * 2 * VisionMap::PLANE_WORDS];
+            vision->Load_Planes(static_cast<HousesType>(house), visible, visible + VisionMap::PLANE_WORDS);
+        }
+    }
+
+    // Each heap was emptied, so objects get back their saved heap indices
+    for (int heap = 0; heap < OBJECT_HEAP_COUNT; heap++) {
+        RTTIType rtti = static_cast<RTTIType>(RTTI_UNIT + heap);
+        for (const SaveObject& record : snapshot.objects[heap]) {
+            ObjectClass* obj = Create_Object(rtti);
+            obj->Set_Owner(static_cast<HousesType>(record.owner));
+            obj->Set_Strength(record.strength);
+
+            if (obj->Is_Techno()) {
+                TechnoClass* techno = static_cast<TechnoClass*>(obj);
+                techno->body_facing_.Set(static_cast<DirType>(record.body_current));
+                techno->body_facing_.Set_Desired(static_cast<DirType>(record.body_desired));
+                techno->body_facing_.Set_Rate(record.body_rate);
+                techno->turret_facing_.Set(static_cast<DirType>(record.turret_current));
+                techno->turret_facing_.Set_Desired(static_cast<DirType>(record.turret_desired));
+                techno->turret_facing_.Set_Rate(record.turret_rate);
+                techno->armor_ = static_cast<ArmorType>(record.armor);
+                techno->Set_Weapons(static_cast<WeaponType>(record.primary_weapon),
+                                    static_cast<WeaponType>(record.secondary_weapon));
+                techno->arm_ = record.arm;
+                techno->scan_wait_ = record.scan_wait;
+                techno->Set_Sight_Range(record.sight_range);
+                if (record.flags & SAVE_OBJECT_CLOAKED) {
+                    techno->Cloak();
+                }
+            }
+
+            obj->Set_Coord(record.coord);
+            obj->Latch_Coord();
+            if (record.flags & SAVE_OBJECT_SELECTED) {
+                obj->Select();
+            }
+            if (!(record.flags & SAVE_OBJECT_ACTIVE)) {
+                obj->Deactivate();
+            }
+        }
+    }
+
+    // Links and routes once everything is in place
+    for (int heap = 0; heap < OBJECT_HEAP_COUNT; heap++) {
+        ObjectHeapBase* objects = Object_Heap(static_cast<RTTIType>(RTTI_UNIT + heap));
+        for (int i = 0; i < objects->Count(); i++) {
+            const SaveObject& record = snapshot.objects[heap][i];
+            ObjectClass* obj = objects->Active(i);
+            if (record.target_index >= 0 && obj->Is_Techno()) {
+                ObjectHeapBase* targets = Object_Heap(static_cast<RTTIType>(record.target_rtti));
+                static_cast<TechnoClass*>(obj)->Set_Target(targets->Active(record.target_index));
+            }
+            if (obj->Is_Foot()) {
+                FootClass* foot = static_cast<FootClass*>(obj);
+                foot->Set_Speed(record.speed);
+                if (record.destination != COORD_NONE && record.destination != record.coord) {
+                    foot->Set_Destination(record.destination);
+                }
+            }
+        }
+    }
+
+    // Projectiles: arrays back in place, shape names back to handles
+    ProjectileSystem& projectiles = ProjectileSystem::Instance();
+    std::vector<ShapeId> shape_ids;
+    for (const std::string& name : snapshot.shape_names) {
+        shape_ids.push_back(ShapeCache::Instance().Register(name.c_str()));
+    }
+    int count = snapshot.projectile_count;
+    for (int i = 0; i < count; i++) {
+        projectiles.x_[i] = snapshot.px[i];
+        projectiles.y_[i] = snapshot.py[i];
+        projectiles.vx_[i] = snapshot.vx[i];
+        projectiles.vy_[i] = snapshot.vy[i];
+        projectiles.life_[i] = snapshot.life[i];
+        projectiles.frame_[i] = snapshot.frame[i];
+        projectiles.impact_frames_[i] = snapshot.impact_frames[i];
+        projectiles.shape_[i] = snapshot.shape[i] < 0 ? SHAPE_ID_NONE : shape_ids[snapshot.shape[i]];
+        projectiles.impact_shape_[i] = snapshot.impact_shape[i] < 0 ? SHAPE_ID_NONE
+                                                                    : shape_ids[snapshot.impact_shape[i]];
+        projectiles.frame_step_[i] = snapshot.frame_step[i];
+        projectiles.layer_[i] = snapshot.layer[i];
+    }
+    projectiles.count_ = count;
+}
+
+bool SaveLoad::Load(Straw& straw, MapClass& map) {
+    if (map.Get_Cell_Layers() == nullptr) {
+        return false;
+    }
+
+    SaveHeader header;
+    if (straw.Get(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != SAVE_MAGIC || header.version != SAVE_VERSION ||
+        header.body_size > 64 * 1024 * 1024) {
+        return false;
+    }
+
+    std::vector<uint8_t> body(header.body_size);
+    LZOStraw lzo(LZOStraw::DECOMPRESS, LZO_MAX_BLOCK_SIZE);
+    lzo.Get_From(straw);
+    int got = lzo.Get(body.data(), static_cast<int>(body.size()));
+    lzo.Get_From(nullptr);
+    if (got != static_cast<int>(body.size()) || lzo.HasError()) {
+        return false;
+    }
+
+    Snapshot snapshot;
+    if (!Read_Body(body.data(), body.size(), snapshot)) {
+        return false;
+    }
+    Apply(snapshot, map);
+    return true;
+}
+
+bool SaveLoad::Load_Game(const char* path, MapClass& map) {
+    IoScope io(IoTag::SAVE);
+    int64_t size = 0;
+    const uint8_t* data = path ? Platform_File_Map(path, &size) : nullptr;
+    if (data == nullptr) {
+        return false;
+    }
+
+    BufferStraw straw(data, static_cast<size_t>(size));
+    bool ok = Load(straw, map);
+    Platform_File_Unmap(data);
+    return ok;
+}
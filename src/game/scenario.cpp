@@ -0,0 +1,486 @@
+/**
+ * ScenarioLoader Implementation
+ *
+ * [MapPack] decodes to MAP_CELL_TOTAL little-endian 16-bit template
+ * numbers followed by MAP_CELL_TOTAL icon bytes; [OverlayPack] to one
+ * overlay byte per cell. Both are base64 of a series of LCW blocks, each
+ * led by a 16-bit compressed and a 16-bit uncompressed length. INI cell
+ * numbers are y * 128 + x.
+ */
+
+#include "game/scenario.h"
+#include "game/build_map.h"
+#include "game/cell.h"
+#include "game/economy.h"
+#include "game/object.h"
+#include "game/object_heap.h"
+#include "game/techno.h"
+#include "game/trigger.h"
+#include "game/types/buildingtype.h"
+#include "game/types/unittype.h"
+#include "platform.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// =============================================================================
+// Decoding Helpers
+// =============================================================================
+
+namespace {
+
+// INI cells are numbered across a 128-wide map
+constexpr int INI_MAP_WIDTH = 128;
+
+// The original overlay numbering; entries without a counterpart are dropped
+const OverlayType OVERLAY_FROM_INI[] = {
+    OVERLAY_SANDBAG, OVERLAY_CYCLONE, OVERLAY_BRICK, OVERLAY_BARBWIRE, OVERLAY_WOOD,
+    OVERLAY_GOLD1, OVERLAY_GOLD2, OVERLAY_GOLD3, OVERLAY_GOLD4,
+    OVERLAY_GEMS1, OVERLAY_GEMS2, OVERLAY_GEMS3, OVERLAY_GEMS4,
+    OVERLAY_V12, OVERLAY_V13,
+    OVERLAY_NONE_TYPE, OVERLAY_NONE_TYPE, OVERLAY_NONE_TYPE, OVERLAY_NONE_TYPE, OVERLAY_NONE_TYPE,
+    OVERLAY_NONE_TYPE,                                  // Flag spot
+    OVERLAY_CRATE, OVERLAY_CRATE,                       // Wood, steel crate
+    OVERLAY_BARBWIRE,                                   // Wire fence
+    OVERLAY_CRATE,                                      // Water crate
+};
+
+std::string Trim(const char* begin, const char* end) {
+    while (begin < end && isspace(static_cast<unsigned char>(*begin))) begin++;
+    while (end > begin && isspace(static_cast<unsigned char>(end[-1]))) end--;
+    return std::string(begin, end);
+}
+
+std::string Upper(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+// Field `index` of a comma-separated value, uppercased
+std::string Field(const std::string& value, int index) {
+    size_t start = 0;
+    for (int i = 0; i < index; i++) {
+        start = value.find(',', start);
+        if (start == std::string::npos) {
+            return std::string();
+        }
+        start++;
+    }
+    size_t end = value.find(',', start);
+    if (end == std::string::npos) {
+        end = value.size();
+    }
+    return Upper(Trim(value.c_str() + start, value.c_str() + end));
+}
+
+int Base64_Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+std::vector<uint8_t> Base64_Decode(const std::string& text) {
+    std::vector<uint8_t> out;
+    out.reserve(text.size() * 3 / 4);
+
+    uint32_t bits = 0;
+    int count = 0;
+    for (char c : text) {
+        int value = Base64_Value(c);
+        if (value < 0) {
+            continue;   // Padding and stray whitespace
+        }
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> count));
+        }
+    }
+    return out;
+}
+
+// Undo the LCW block framing; false on a truncated or corrupt block
+bool Unpack_Blocks(const std::vector<uint8_t>& packed, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t pos = 0;
+    while (pos + 4 <= packed.size()) {
+        int comp = packed[pos] | (packed[pos + 1] << 8);
+        int uncomp = packed[pos + 2] | (packed[pos + 3] << 8);
+        pos += 4;
+        if (pos + comp > packed.size()) {
+            return false;
+        }
+
+        size_t start = out.size();
+        out.resize(start + uncomp);
+        int32_t written = Platform_LCW_Decompress(packed.data() + pos, comp, out.data() + start, uncomp);
+        if (written != uncomp) {
+            return false;
+        }
+        pos += comp;
+    }
+    return true;
+}
+
+// INI cell number to CELL, CELL_NONE if off the map
+CELL Cell_From_INI(const std::string& text) {
+    if (text.empty()) {
+        return CELL_NONE;
+    }
+    int number = atoi(text.c_str());
+    if (number < 0 || number >= INI_MAP_WIDTH * INI_MAP_WIDTH) {
+        return CELL_NONE;
+    }
+    int x = number % INI_MAP_WIDTH;
+    int y = number / INI_MAP_WIDTH;
+    if (x >= MAP_CELL_WIDTH || y >= MAP_CELL_HEIGHT) {
+        return CELL_NONE;
+    }
+    return XY_Cell(x, y);
+}
+
+TheaterType Theater_From_Name(const std::string& name) {
+    for (int i = 0; i < THEATER_COUNT; i++) {
+        if (name == TheaterNames[i]) {
+            return static_cast<TheaterType>(i);
+        }
+    }
+    return THEATER_NONE;
+}
+
+// Add a "House,Type,Strength,Cell,..." line; facing_field varies by section
+void Add_Placement(const std::string& section, const std::string& value, ScenarioMap& out) {
+    ScenarioPlacement placement = {};
+    int facing_field = 4;
+
+    std::string type = Field(value, 1);
+    if (section == "UNITS") {
+        placement.rtti = RTTI_UNIT;
+        placement.type = Unit_Type_From_Name(type.c_str());
+    } else if (section == "SHIPS") {
+        placement.rtti = RTTI_VESSEL;
+        placement.type = -1;
+    } else if (section == "INFANTRY") {
+        placement.rtti = RTTI_INFANTRY;
+        placement.type = -1;
+        facing_field = 6;   // House,Type,Strength,Cell,SubCell,Mission,Facing
+    } else if (section == "STRUCTURES") {
+        placement.rtti = RTTI_BUILDING;
+        placement.type = Building_Type_From_Name(type.c_str());
+    } else {
+        return;
+    }
+
+    placement.cell = Cell_From_INI(Field(value, 3));
+    if (placement.cell == CELL_NONE) {
+        return;
+    }
+    placement.house = static_cast<int8_t>(House_From_Name(Field(value, 0).c_str()));
+    placement.strength = static_cast<uint16_t>(std::clamp(atoi(Field(value, 2).c_str()), 0, 256));
+    placement.facing = static_cast<uint8_t>(atoi(Field(value, facing_field).c_str()));
+    out.placements.push_back(placement);
+}
+
+} // namespace
+
+// =============================================================================
+// ScenarioMap
+// =============================================================================
+
+void ScenarioMap::Clear() {
+    theater = THEATER_TEMPERATE;
+    x = 1;
+    y = 1;
+    width = MAP_CELL_WIDTH - 2;
+    height = MAP_CELL_HEIGHT - 2;
+    memset(templates, CELL_TEMPLATE_NONE, sizeof(templates));
+    memset(icons, 0, sizeof(icons));
+    memset(overlays, static_cast<uint8_t>(OVERLAY_NONE_TYPE), sizeof(overlays));
+    memset(overlay_data, 0, sizeof(overlay_data));
+    placements.clear();
+}
+
+// =============================================================================
+// ScenarioLoader
+// =============================================================================
+
+ScenarioLoader& ScenarioLoader::Instance() {
+    static ScenarioLoader instance;
+    return instance;
+}
+
+ScenarioLoader::ScenarioLoader()
+    : cache_dir_set_(false)
+    , was_cached_(false)
+{
+    scenario_.Clear();
+}
+
+std::string ScenarioLoader::Cache_Path(const char* name) const {
+    std::string dir = cache_dir_;
+    if (!cache_dir_set_) {
+        char path[512];
+        if (Platform_GetCachePath(path, sizeof(path)) > 0) {
+            dir = path;
+        }
+    }
+    if (dir.empty() || name == nullptr || name[0] == '\0') {
+        return std::string();
+    }
+
+    std::string stem(name);
+    return dir + "/" + stem.substr(0, stem.rfind('.')) + ".map";
+}
+
+const ScenarioMap* ScenarioLoader::Read(const char* name, const char* text, size_t length) {
+    if (text == nullptr) {
+        return nullptr;
+    }
+
+    uint32_t size = static_cast<uint32_t>(length);
+    uint32_t crc = Platform_CRC32(reinterpret_cast<const uint8_t*>(text), static_cast<int32_t>(length));
+    std::string path = Cache_Path(name);
+
+    bool cached = !path.empty() && Read_Cache(path.c_str(), crc, size, scenario_);
+    if (!cached) {
+        if (!Parse(text, length, scenario_)) {
+            return nullptr;
+        }
+        if (!path.empty()) {
+            Platform_EnsureDirectories();
+            if (!Write_Cache(path.c_str(), crc, size, scenario_)) {
+                Platform_LogWarn("Failed to write scenario cache");
+            }
+        }
+    }
+
+    was_cached_ = cached;
+    return &scenario_;
+}
+
+// =============================================================================
+// INI Parsing
+// =============================================================================
+
+bool ScenarioLoader::Parse(const char* text, size_t length, ScenarioMap& out) {
+    if (text == nullptr) {
+        return false;
+    }
+    out.Clear();
+
+    std::string map_pack;
+    std::string overlay_pack;
+    std::string section;
+
+    const char* pos = text;
+    const char* end = text + length;
+    while (pos < end) {
+        const char* line_end = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        if (!line_end) line_end = end;
+
+        const char* comment = static_cast<const char*>(memchr(pos, ';', line_end - pos));
+        std::string line = Trim(pos, comment ? comment : line_end);
+        pos = line_end + 1;
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            size_t close = line.find(']');
+            section = Upper(line.substr(1, close == std::string::npos ? std::string::npos : close - 1));
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+
+        // Pack lines are base64, which is case-sensitive: keep them as is
+        std::string value = Trim(line.c_str() + eq + 1, line.c_str() + line.size());
+        if (section == "MAPPACK") {
+            map_pack += value;
+            continue;
+        }
+        if (section == "OVERLAYPACK") {
+            overlay_pack += value;
+            continue;
+        }
+
+        std::string key = Upper(Trim(line.c_str(), line.c_str() + eq));
+        if (section == "MAP") {
+            int number = atoi(value.c_str());
+            if (key == "X") out.x = static_cast<int16_t>(number);
+            else if (key == "Y") out.y = static_cast<int16_t>(number);
+            else if (key == "WIDTH") out.width = static_cast<int16_t>(number);
+            else if (key == "HEIGHT") out.height = static_cast<int16_t>(number);
+            else if (key == "THEATER") {
+                TheaterType theater = Theater_From_Name(Upper(value));
+                if (theater != THEATER_NONE) out.theater = theater;
+            }
+        } else {
+            Add_Placement(section, value, out);
+        }
+    }
+
+    // Terrain: 16-bit template numbers, then icons
+    std::vector<uint8_t> data;
+    if (map_pack.empty() || !Unpack_Blocks(Base64_Decode(map_pack), data) ||
+        data.size() < static_cast<size_t>(MAP_CELL_TOTAL) * 3) {
+        return false;
+    }
+    const uint8_t* icons = data.data() + MAP_CELL_TOTAL * 2;
+    for (int i = 0; i < MAP_CELL_TOTAL; i++) {
+        int number = data[i * 2] | (data[i * 2 + 1] << 8);
+        if (number >= CELL_TEMPLATE_NONE) {
+            continue;   // No template (or one this build cannot number)
+        }
+        out.templates[i] = static_cast<uint8_t>(number);
+        out.icons[i] = icons[i];
+    }
+
+    // Overlays are optional; a damaged pack only loses them
+    if (!overlay_pack.empty() && Unpack_Blocks(Base64_Decode(overlay_pack), data) &&
+        data.size() >= static_cast<size_t>(MAP_CELL_TOTAL)) {
+        const int known = static_cast<int>(sizeof(OVERLAY_FROM_INI) / sizeof(OVERLAY_FROM_INI[0]));
+        for (int i = 0; i < MAP_CELL_TOTAL; i++) {
+            if (data[i] < known) {
+                out.overlays[i] = static_cast<uint8_t>(OVERLAY_FROM_INI[data[i]]);
+            }
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Cache Files
+// =============================================================================
+
+bool ScenarioLoader::Read_Cache(const char* path, uint32_t ini_crc, uint32_t ini_size, ScenarioMap& out) {
+    int64_t size = 0;
+    const uint8_t* data = path ? Platform_File_Map(path, &size) : nullptr;
+    if (!data) {
+        return false;
+    }
+
+    const size_t planes = static_cast<size_t>(MAP_CELL_TOTAL) * 4;
+    ScenarioCacheHeader header;
+    bool ok = static_cast<size_t>(size) >= sizeof(header) + planes;
+    if (ok) {
+        memcpy(&header, data, sizeof(header));
+        ok = header.magic == SCENARIO_CACHE_MAGIC && header.version == SCENARIO_CACHE_VERSION &&
+             header.ini_crc == ini_crc && header.ini_size == ini_size &&
+             header.theater >= 0 && header.theater < THEATER_COUNT &&
+             static_cast<size_t>(size) == sizeof(header) + planes +
+                 static_cast<size_t>(header.placement_count) * sizeof(ScenarioPlacement);
+    }
+
+    if (ok) {
+        const uint8_t* pos = data + sizeof(header);
+        out.theater = static_cast<TheaterType>(header.theater);
+        out.x = header.x;
+        out.y = header.y;
+        out.width = header.width;
+        out.height = header.height;
+        memcpy(out.templates, pos, MAP_CELL_TOTAL);
+        memcpy(out.icons, pos + MAP_CELL_TOTAL, MAP_CELL_TOTAL);
+        memcpy(out.overlays, pos + MAP_CELL_TOTAL * 2, MAP_CELL_TOTAL);
+        memcpy(out.overlay_data, pos + MAP_CELL_TOTAL * 3, MAP_CELL_TOTAL);
+        out.placements.resize(header.placement_count);
+        if (header.placement_count > 0) {
+            memcpy(out.placements.data(), pos + planes,
+                   header.placement_count * sizeof(ScenarioPlacement));
+        }
+    }
+
+    Platform_File_Unmap(data);
+    return ok;
+}
+
+bool ScenarioLoader::Write_Cache(const char* path, uint32_t ini_crc, uint32_t ini_size, const ScenarioMap& scenario) {
+    PlatformFile* file = path ? Platform_File_Open(path, FILE_MODE_WRITE) : nullptr;
+    if (!file) {
+        return false;
+    }
+
+    ScenarioCacheHeader header = {};
+    header.magic = SCENARIO_CACHE_MAGIC;
+    header.version = SCENARIO_CACHE_VERSION;
+    header.ini_crc = ini_crc;
+    header.ini_size = ini_size;
+    header.theater = static_cast<int8_t>(scenario.theater);
+    header.x = scenario.x;
+    header.y = scenario.y;
+    header.width = scenario.width;
+    header.height = scenario.height;
+    header.placement_count = static_cast<uint32_t>(scenario.placements.size());
+
+    int32_t placement_bytes = static_cast<int32_t>(scenario.placements.size() * sizeof(ScenarioPlacement));
+    bool ok = Platform_File_Write(file, &header, sizeof(header)) == static_cast<int32_t>(sizeof(header)) &&
+              Platform_File_Write(file, scenario.templates, MAP_CELL_TOTAL) == MAP_CELL_TOTAL &&
+              Platform_File_Write(file, scenario.icons, MAP_CELL_TOTAL) == MAP_CELL_TOTAL &&
+              Platform_File_Write(file, scenario.overlays, MAP_CELL_TOTAL) == MAP_CELL_TOTAL &&
+              Platform_File_Write(file, scenario.overlay_data, MAP_CELL_TOTAL) == MAP_CELL_TOTAL &&
+              (placement_bytes == 0 ||
+               Platform_File_Write(file, scenario.placements.data(), placement_bytes) == placement_bytes);
+    Platform_File_Close(file);
+    return ok;
+}
+
+// =============================================================================
+// Applying
+// =============================================================================
+
+void ScenarioLoader::Apply(const ScenarioMap& scenario, MapClass& map) {
+    Apply_Map(scenario, map);
+    Apply_Objects(scenario, map, 0, scenario.placements.size());
+}
+
+void ScenarioLoader::Apply_Map(const ScenarioMap& scenario, MapClass& map) {
+    // Objects unmark their cells as they go, so free them before the map resets
+    Destroy_All_Objects();
+    Reset_Economies();
+    TriggerEngine::Instance().Clear();
+
+    map.Clear_Map();
+    map.Load_Cells(scenario.templates, scenario.icons, scenario.overlays, scenario.overlay_data);
+    map.Set_Map_Bounds(scenario.x, scenario.y, scenario.width, scenario.height);
+}
+
+size_t ScenarioLoader::Apply_Objects(const ScenarioMap& scenario, MapClass& map,
+                                     size_t first, size_t count) {
+    size_t end = std::min(first + count, scenario.placements.size());
+    for (size_t i = first; i < end; i++) {
+        const ScenarioPlacement& placement = scenario.placements[i];
+        ObjectClass* obj = Create_Object(static_cast<RTTIType>(placement.rtti));
+        if (obj == nullptr) {
+            continue;
+        }
+        obj->Set_Owner(static_cast<HousesType>(placement.house));
+        obj->Set_Strength(obj->Max_Strength() * placement.strength / 256);
+        if (obj->Is_Techno()) {
+            static_cast<TechnoClass*>(obj)->Body_Facing().Set(placement.facing);
+        }
+        obj->Set_Coord(Cell_Coord(placement.cell));
+
+        if (placement.rtti == RTTI_BUILDING && placement.type >= 0) {
+            House_Economy(static_cast<HousesType>(placement.house))
+                .Building_Added(static_cast<BuildingType>(placement.type));
+            if (map.Get_Build_Map() != nullptr) {
+                map.Get_Build_Map()->Building_Added(static_cast<HousesType>(placement.house),
+                                                    static_cast<BuildingType>(placement.type),
+                                                    placement.cell);
+            }
+        }
+    }
+    return end;
+}
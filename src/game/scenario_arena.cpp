@@ -0,0 +1,74 @@
+/**
+ * Scenario Arena Implementation
+ */
+
+#include "game/scenario_arena.h"
+
+// =============================================================================
+// ScenarioArena
+// =============================================================================
+
+ScenarioArena& ScenarioArena::Instance() {
+    static ScenarioArena instance;
+    return instance;
+}
+
+ScenarioArena::ScenarioArena()
+    : arena_(INITIAL_SIZE)
+    , depth_(0)
+    , generation_(0)
+{
+    // A scenario is not a frame: size the block to the last peak, no window
+    arena_.set_high_water_frames(1);
+    cleanups_.reserve(64);
+}
+
+void* ScenarioArena::Allocate(size_t size, size_t alignment) {
+    if (depth_ == 0) {
+        return nullptr;
+    }
+    return arena_.allocate(size, alignment);
+}
+
+void ScenarioArena::At_Scope_End(CleanupFn fn, void* context) {
+    if (depth_ > 0 && fn != nullptr) {
+        cleanups_.push_back(Cleanup{fn, context});
+    }
+}
+
+void ScenarioArena::Unwind(size_t mark) {
+    // Popped before the call, in case a cleanup registers another
+    while (cleanups_.size() > mark) {
+        Cleanup cleanup = cleanups_.back();
+        cleanups_.pop_back();
+        cleanup.fn(cleanup.context);
+    }
+}
+
+void ScenarioArena::Reset() {
+    Unwind(0);
+    arena_.reset();
+    generation_++;
+}
+
+// =============================================================================
+// ScenarioScope
+// =============================================================================
+
+ScenarioScope::ScenarioScope()
+    : arena_(ScenarioArena::Instance())
+    , marker_(arena_.arena_)
+    , cleanup_mark_(arena_.cleanups_.size())
+    , depth_(++arena_.depth_)
+{
+}
+
+ScenarioScope::~ScenarioScope() {
+    if (depth_ == 1) {
+        arena_.Reset();
+    } else {
+        arena_.Unwind(cleanup_mark_);
+    }
+    // marker_ rewinds the arena to where this scope opened
+    arena_.depth_ = depth_ - 1;
+}
@@ -0,0 +1,101 @@
+/**
+ * Scroll Motion Implementation
+ */
+
+#include "game/scroll_motion.h"
+#include <cmath>
+
+// Below this the eased speed snaps to the target (pixels per frame)
+static const float SNAP_SPEED = 0.05f;
+
+// Terrain cells are 24 pixels square
+static const int CELL_PIXELS = 24;
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+ScrollMotion::ScrollMotion()
+    : velocity_x_(0.0f)
+    , velocity_y_(0.0f)
+    , remainder_x_(0.0f)
+    , remainder_y_(0.0f)
+{
+}
+
+void ScrollMotion::Reset() {
+    velocity_x_ = velocity_y_ = 0.0f;
+    remainder_x_ = remainder_y_ = 0.0f;
+}
+
+// =============================================================================
+// Integration
+// =============================================================================
+
+float ScrollMotion::Ease(float velocity, float target) {
+    bool speeding_up = std::fabs(target) > std::fabs(velocity) && target * velocity >= 0.0f;
+    velocity += (target - velocity) * (speeding_up ? EASE_IN : EASE_OUT);
+    if (std::fabs(target - velocity) < SNAP_SPEED) {
+        velocity = target;
+    }
+    return velocity;
+}
+
+void ScrollMotion::Step(float target_x, float target_y, int& dx, int& dy) {
+    velocity_x_ = Ease(velocity_x_, target_x);
+    velocity_y_ = Ease(velocity_y_, target_y);
+
+    remainder_x_ += velocity_x_;
+    remainder_y_ += velocity_y_;
+    dx = static_cast<int>(remainder_x_);
+    dy = static_cast<int>(remainder_y_);
+    remainder_x_ -= static_cast<float>(dx);
+    remainder_y_ -= static_cast<float>(dy);
+
+    // A stopped axis doesn't creep on from a leftover fraction later
+    if (velocity_x_ == 0.0f) remainder_x_ = 0.0f;
+    if (velocity_y_ == 0.0f) remainder_y_ = 0.0f;
+}
+
+// =============================================================================
+// Lookahead
+// =============================================================================
+
+// Cells covering world pixels [lo, hi)
+static void Cell_Span(int lo, int hi, int& start, int& end) {
+    start = static_cast<int>(std::floor(static_cast<float>(lo) / CELL_PIXELS));
+    end = static_cast<int>(std::floor(static_cast<float>(hi - 1) / CELL_PIXELS)) + 1;
+}
+
+int ScrollMotion::LeadCells(int view_x, int view_y, int view_w, int view_h, int frames,
+                            ScrollCellRange out[2]) const {
+    int lead_x = static_cast<int>(std::ceil(std::fabs(velocity_x_) * frames));
+    int lead_y = static_cast<int>(std::ceil(std::fabs(velocity_y_) * frames));
+    int count = 0;
+
+    // The strip beyond the leading edge, as tall as the view will sweep
+    int sweep_y0 = view_y - (velocity_y_ < 0.0f ? lead_y : 0);
+    int sweep_y1 = view_y + view_h + (velocity_y_ > 0.0f ? lead_y : 0);
+    if (lead_x > 0) {
+        ScrollCellRange& range = out[count++];
+        if (velocity_x_ > 0.0f) {
+            Cell_Span(view_x + view_w, view_x + view_w + lead_x, range.start_x, range.end_x);
+        } else {
+            Cell_Span(view_x - lead_x, view_x, range.start_x, range.end_x);
+        }
+        Cell_Span(sweep_y0, sweep_y1, range.start_y, range.end_y);
+    }
+
+    // Above or below, between the old left and right edges
+    if (lead_y > 0) {
+        ScrollCellRange& range = out[count++];
+        Cell_Span(view_x, view_x + view_w, range.start_x, range.end_x);
+        if (velocity_y_ > 0.0f) {
+            Cell_Span(view_y + view_h, view_y + view_h + lead_y, range.start_y, range.end_y);
+        } else {
+            Cell_Span(view_y - lead_y, view_y, range.start_y, range.end_y);
+        }
+    }
+
+    return count;
+}
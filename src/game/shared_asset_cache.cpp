@@ -0,0 +1,233 @@
+/**
+ * SharedAssetCache Implementation
+ */
+
+#include "game/shared_asset_cache.h"
+#include "game/asset_loader.h"
+#include "game/asset_pack.h"
+#include "game/audio/aud_file.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/tile_renderer.h"
+#include "game/map.h"
+#include "platform.h"
+#include <cstdio>
+#include <random>
+
+namespace {
+
+// The archives Game_Register_Mix_Files() registers from the data path
+const char* const KEY_MIX_FILES[] = {
+    "REDALERT.MIX", "MAIN.MIX", "interior.mix", "winter.mix", "temperat.mix",
+};
+
+void Hash_Bytes(uint32_t& hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+}
+
+}  // namespace
+
+SharedAssetCache& SharedAssetCache::Instance() {
+    static SharedAssetCache instance;
+    return instance;
+}
+
+uint32_t SharedAssetCache::Data_Key(const char* data_path) {
+    uint32_t hash = 2166136261u;
+    Hash_Bytes(hash, &ASSET_PACK_VERSION, sizeof(ASSET_PACK_VERSION));
+
+    char path[512];
+    for (const char* name : KEY_MIX_FILES) {
+        snprintf(path, sizeof(path), "%s/%s", data_path ? data_path : ".", name);
+        int64_t size = -1;
+        if (PlatformFile* file = Platform_File_Open(path, FILE_MODE_READ)) {
+            size = Platform_File_Size(file);
+            Platform_File_Close(file);
+        }
+        Hash_Bytes(hash, &size, sizeof(size));
+    }
+    return hash;
+}
+
+// =============================================================================
+// Opening
+// =============================================================================
+
+bool SharedAssetCache::Open(const char* data_path) {
+    char cache_path[512];
+    if (!enabled_ || Platform_GetCachePath(cache_path, sizeof(cache_path)) <= 0) {
+        return false;
+    }
+
+    char path[600];
+    snprintf(path, sizeof(path), "%s/SHARED-%08X.PAK", cache_path, Data_Key(data_path));
+    return Open_File(path);
+}
+
+bool SharedAssetCache::Open_File(const char* path) {
+    Close();
+
+    // A PackAssets pack is mapped and shared already
+    if (!enabled_ || !path || AssetPack::Instance().IsOpen()) {
+        return false;
+    }
+
+    path_ = path;
+    mapped_ = AssetPack::Instance().Open(path);
+    active_.store(true, std::memory_order_relaxed);
+
+    char msg[700];
+    if (mapped_) {
+        snprintf(msg, sizeof(msg), "Shared asset cache: mapped %s (%u entries)",
+                 path, AssetPack::Instance().GetEntryCount());
+    } else {
+        snprintf(msg, sizeof(msg), "Shared asset cache: populating %s", path);
+    }
+    Platform_LogInfo(msg);
+    return mapped_;
+}
+
+void SharedAssetCache::Close() {
+    active_.store(false, std::memory_order_relaxed);
+    if (mapped_) {
+        AssetPack::Instance().Close();
+        mapped_ = false;
+    }
+    path_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    shapes_.clear();
+    audio_.clear();
+    theaters_ = 0;
+}
+
+// =============================================================================
+// Noting
+// =============================================================================
+
+void SharedAssetCache::Note_Shape(const char* filename) {
+    SharedAssetCache& self = Instance();
+    if (self.Is_Active() && filename && filename[0]) {
+        std::lock_guard<std::mutex> lock(self.mutex_);
+        self.shapes_.insert(filename);
+    }
+}
+
+void SharedAssetCache::Note_Audio(const char* filename) {
+    SharedAssetCache& self = Instance();
+    if (self.Is_Active() && filename && filename[0]) {
+        std::lock_guard<std::mutex> lock(self.mutex_);
+        self.audio_.insert(filename);
+    }
+}
+
+void SharedAssetCache::Note_Theater(TheaterType theater) {
+    SharedAssetCache& self = Instance();
+    if (self.Is_Active() && theater >= 0 && theater < 32) {
+        std::lock_guard<std::mutex> lock(self.mutex_);
+        self.theaters_ |= 1u << theater;
+    }
+}
+
+size_t SharedAssetCache::Pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return shapes_.size() + audio_.size() + static_cast<size_t>(__builtin_popcount(theaters_));
+}
+
+// =============================================================================
+// Saving
+// =============================================================================
+
+bool SharedAssetCache::Save() {
+    std::lock_guard<std::mutex> saving(save_mutex_);
+
+    std::set<std::string> shapes;
+    std::set<std::string> audio;
+    uint32_t theaters;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!Is_Active() || (shapes_.empty() && audio_.empty() && theaters_ == 0)) {
+            return false;
+        }
+        shapes = shapes_;
+        audio = audio_;
+        theaters = theaters_;
+    }
+
+    bool written = Write_Pack(shapes, audio, theaters);
+
+    // Written, or failed to decode or write: either way done with them.
+    // Decoding them again above noted them again; that goes too.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::string& name : shapes) {
+        shapes_.erase(name);
+    }
+    for (const std::string& name : audio) {
+        audio_.erase(name);
+    }
+    theaters_ &= ~theaters;
+    return written;
+}
+
+void SharedAssetCache::Save_Async() {
+    if (Pending() > 0) {
+        AssetLoader::Instance().Submit(ASSET_PRIORITY_PREFETCH, [this]() { Save(); });
+    }
+}
+
+bool SharedAssetCache::Write_Pack(const std::set<std::string>& shapes,
+                                  const std::set<std::string>& audio, uint32_t theaters) {
+    // Start from the file as it is now; another instance may have added to it
+    AssetPackWriter writer;
+    {
+        AssetPack current;
+        if (current.Open(path_.c_str())) {
+            writer.AddPack(current);
+        }
+    }
+    size_t existing = writer.GetEntryCount();
+
+    for (int t = 0; t < THEATER_COUNT; t++) {
+        TheaterType theater = static_cast<TheaterType>(t);
+        if ((theaters & (1u << t)) &&
+            !writer.Has(TileRenderer::GetPackedAtlasName(theater).c_str(), ASSET_PACK_ATLAS)) {
+            TileRenderer::PackTheater(theater, writer);
+        }
+    }
+    for (const std::string& name : shapes) {
+        ShapeRenderer shape;
+        if (!writer.Has(name.c_str(), ASSET_PACK_SHAPE) && shape.Load(name.c_str())) {
+            writer.AddShape(name.c_str(), shape);
+        }
+    }
+    for (const std::string& name : audio) {
+        AudFile aud;
+        if (!writer.Has(name.c_str(), ASSET_PACK_AUDIO) && aud.LoadFromMix(name.c_str())) {
+            writer.AddAudio(name.c_str(), aud);
+        }
+    }
+
+    size_t added = writer.GetEntryCount() - existing;
+    if (added == 0) {
+        return false;
+    }
+
+    // Never rewrite the file in place: other instances have it mapped
+    Platform_EnsureDirectories();
+    char temp[700];
+    snprintf(temp, sizeof(temp), "%s.%08X.tmp", path_.c_str(),
+             static_cast<unsigned>(std::random_device()()));
+    if (!writer.Write(temp) || std::rename(temp, path_.c_str()) != 0) {
+        Platform_File_Delete(temp);
+        Platform_LogWarn("Shared asset cache: failed to write the cache file");
+        return false;
+    }
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Shared asset cache: wrote %u entries (%u new)",
+             static_cast<unsigned>(writer.GetEntryCount()), static_cast<unsigned>(added));
+    Platform_LogInfo(msg);
+    return true;
+}
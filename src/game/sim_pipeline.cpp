@@ -0,0 +1,174 @@
+/**
+ * Simulation Pipeline Implementation
+ */
+
+#include "game/sim_pipeline.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include "game/object.h"
+#include "game/object_heap.h"
+#include "game/techno.h"
+#include "game/graphics/remap_tables.h"
+
+// =============================================================================
+// RenderSnapshot
+// =============================================================================
+
+RenderSnapshot::RenderSnapshot()
+    : tick_(0)
+{
+}
+
+void RenderSnapshot::Clear() {
+    objects_.clear();
+    tick_ = 0;
+}
+
+void RenderSnapshot::Capture(uint32_t tick) {
+    objects_.clear();
+    tick_ = tick;
+
+    const CellLayers* layers = Map ? Map->Get_Cell_Layers() : nullptr;
+
+    For_Each_Object([&](ObjectClass* obj) {
+        if (!obj->Is_Active()) {
+            return;
+        }
+
+        // Shroud is decided here, on the sim thread, so the renderer
+        // never reads the visibility layer for objects
+        COORDINATE coord = obj->Get_Coord();
+        CELL cell = Coord_Cell(coord);
+        if (cell == CELL_NONE) {
+            return;
+        }
+        if (layers &&
+            layers->visibility[MapClass::Layer_Index(Cell_X(cell), Cell_Y(cell))] == CELL_SHROUD) {
+            return;
+        }
+
+        ObjectSnapshot snap;
+        snap.coord = coord;
+        snap.prev_coord = obj->Render_Coord(0.0f);
+        snap.rtti = obj->What_Am_I();
+        snap.owner = obj->Get_Owner();
+        snap.facing = DIR_N;
+        snap.turret_facing = DIR_N;
+        snap.remap = static_cast<uint8_t>(snap.owner >= 0 ? snap.owner % HOUSE_COLOR_COUNT : 0);
+        snap.health = static_cast<uint8_t>(obj->Health_Percent());
+        snap.selected = obj->Is_Selected();
+
+        if (obj->Is_Techno()) {
+            const TechnoClass* techno = static_cast<const TechnoClass*>(obj);
+            snap.facing = techno->Get_Facing();
+            snap.turret_facing = techno->Has_Turret() ? techno->Get_Turret_Facing() : snap.facing;
+        }
+
+        objects_.push_back(snap);
+    });
+}
+
+// =============================================================================
+// SimPipeline
+// =============================================================================
+
+SimPipeline::SimPipeline()
+    : pending_ticks_(0)
+    , busy_(false)
+    , stop_(false)
+    , front_(0)
+    , back_ready_(false)
+{
+}
+
+SimPipeline::~SimPipeline() {
+    Stop();
+}
+
+void SimPipeline::Start(TickFn tick_fn) {
+    if (Is_Running()) {
+        return;
+    }
+
+    tick_fn_ = std::move(tick_fn);
+    stop_ = false;
+    busy_ = false;
+    pending_ticks_ = 0;
+    back_ready_ = false;
+    thread_ = std::thread(&SimPipeline::Thread_Main, this);
+}
+
+void SimPipeline::Stop() {
+    if (!Is_Running()) {
+        return;
+    }
+
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void SimPipeline::Kick(int ticks) {
+    if (ticks <= 0 || !Is_Running()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ticks_ = ticks;
+        busy_ = true;
+    }
+    wake_.notify_one();
+}
+
+bool SimPipeline::Wait() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return !busy_; });
+    }
+
+    if (!back_ready_) {
+        return false;
+    }
+
+    // The sim thread is idle, so the swap needs no lock
+    front_ ^= 1;
+    back_ready_ = false;
+    return true;
+}
+
+void SimPipeline::Capture_Now(uint32_t tick) {
+    snapshots_[front_].Capture(tick);
+}
+
+void SimPipeline::Thread_Main() {
+    for (;;) {
+        int ticks;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stop_ || pending_ticks_ > 0; });
+            if (stop_) {
+                return;
+            }
+            ticks = pending_ticks_;
+            pending_ticks_ = 0;
+        }
+
+        uint32_t tick = 0;
+        for (int i = 0; i < ticks; i++) {
+            tick = tick_fn_();
+        }
+        snapshots_[front_ ^ 1].Capture(tick);
+        back_ready_ = true;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+        }
+        done_.notify_one();
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * StateHash Implementation
+ */
+
+#include "game/state_hash.h"
+#include "game/map.h"
+#include "game/object_heap.h"
+
+StateHash& StateHash::Instance() {
+    static StateHash instance;
+    return instance;
+}
+
+uint64_t StateHash::Value() const {
+    return objects_ ^ (Map != nullptr ? Map->Get_Cell_Hash() : 0);
+}
+
+uint64_t StateHash::Recompute() {
+    uint64_t hash = 0;
+    for (int rtti = RTTI_UNIT; rtti < RTTI_TRIGGER; rtti++) {
+        const ObjectHeapBase* heap = Object_Heap(static_cast<RTTIType>(rtti));
+        for (int i = 0; i < heap->Count(); i++) {
+            const ObjectClass* obj = heap->Active(i);
+            ObjectHandle handle = heap->Handle_Of(obj);
+            hash ^= Object_Term(rtti, handle.slot, obj->Get_Coord(), obj->Get_Strength(), obj->Get_Owner());
+        }
+    }
+    return hash ^ (Map != nullptr ? Map->Recompute_Cell_Hash() : 0);
+}
@@ -0,0 +1,53 @@
+/**
+ * Tick Clock Implementation
+ */
+
+#include "game/tick_clock.h"
+
+// =============================================================================
+// Construction
+// =============================================================================
+
+TickClock::TickClock()
+    : last_tick_time_(0)
+    , dropped_ms_(0)
+{
+}
+
+void TickClock::Reset(uint32_t now) {
+    last_tick_time_ = now;
+    dropped_ms_ = 0;
+}
+
+// =============================================================================
+// Scheduling
+// =============================================================================
+
+int TickClock::Advance(uint32_t now, uint32_t interval) {
+    if (interval == 0) {
+        return 0;
+    }
+
+    uint32_t due = (now - last_tick_time_) / interval;
+    if (due > static_cast<uint32_t>(MAX_CATCHUP_TICKS)) {
+        // Drop what the cap can't cover; the sim dilates instead of spiralling
+        uint32_t dropped = (due - MAX_CATCHUP_TICKS) * interval;
+        last_tick_time_ += dropped;
+        dropped_ms_ += dropped;
+        due = MAX_CATCHUP_TICKS;
+    }
+
+    last_tick_time_ += due * interval;
+    return static_cast<int>(due);
+}
+
+float TickClock::Alpha(uint32_t now, uint32_t interval) const {
+    if (interval == 0) {
+        return 1.0f;
+    }
+
+    float alpha = static_cast<float>(now - last_tick_time_) / static_cast<float>(interval);
+    if (alpha < 0.0f) return 0.0f;
+    if (alpha > 1.0f) return 1.0f;
+    return alpha;
+}
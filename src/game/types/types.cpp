@@ -1,11 +1,14 @@
 /**
  * Type Classes Implementation
  *
- * Defines the static type arrays with actual game data.
+ * Builds the type arrays from the constexpr tables in type_tables.h and
+ * applies RULES.INI overrides to them.
  */
 
-#include "game/types/unittype.h"
-#include "game/types/buildingtype.h"
+#include "game/types/type_tables.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/ini.h"
+#include <cstdio>
 #include <cstring>
 
 // =============================================================================
@@ -37,199 +40,63 @@ UnitTypeClass::UnitTypeClass(const char* ini_name, const char* full_name)
 {
 }
 
+UnitTypeClass::UnitTypeClass(UnitType type)
+    : UnitTypeClass(UNIT_TYPE_TABLE[type])
+{
+    type_index_ = type;
+}
+
+UnitTypeClass::UnitTypeClass(const UnitTypeData& data)
+    : TechnoTypeClass(data.name, data.full_name, RTTI_UNITTYPE)
+    , speed_(data.speed)
+    , is_tracked_((data.flags & UNIT_FLAG_WHEELED) == 0)
+    , can_crush_((data.flags & UNIT_FLAG_CRUSHER) != 0)
+    , has_turret_((data.flags & UNIT_FLAG_TURRET) != 0)
+    , turret_rate_(data.turret_rate)
+    , is_harvester_((data.flags & UNIT_FLAG_HARVESTER) != 0)
+    , is_mcv_((data.flags & UNIT_FLAG_MCV) != 0)
+{
+    shape_name_ = data.shape;
+    frame_count_ = data.frames;
+    max_strength_ = data.strength;
+    armor_ = data.armor;
+    primary_weapon_ = data.primary;
+    secondary_weapon_ = data.secondary;
+    cost_ = data.cost;
+    build_time_ = data.build_time;
+    prerequisites_ = data.prerequisites;
+    tech_level_ = data.tech_level;
+    side_ = data.side;
+    sight_range_ = data.sight;
+}
+
 // =============================================================================
 // Unit Types Definition
 // =============================================================================
 
+// One row copy each; the stats are in UNIT_TYPE_TABLE
 UnitTypeClass UnitTypes[UNIT_COUNT] = {
-    // UNIT_MTNK - Medium Tank
-    []() {
-        UnitTypeClass t("MTNK", "Medium Tank");
-        t.Set_Type_Index(UNIT_MTNK);
-        t.Set_Shape_Name("MTNK");
-        t.Set_Frame_Count(32);
-        t.Set_Max_Strength(400);
-        t.Set_Armor(ARMOR_HEAVY);
-        t.Set_Speed(10);
-        t.Set_Primary_Weapon(WEAPON_90MM);
-        t.Set_Has_Turret(true);
-        t.Set_Can_Crush(true);
-        t.Set_Cost(800);
-        t.Set_Build_Time(100);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(2);
-        t.Set_Side(SIDE_ALLIED);
-        t.Set_Sight_Range(5);
-        return t;
-    }(),
-
-    // UNIT_LTNK - Light Tank
-    []() {
-        UnitTypeClass t("LTNK", "Light Tank");
-        t.Set_Type_Index(UNIT_LTNK);
-        t.Set_Shape_Name("LTNK");
-        t.Set_Frame_Count(32);
-        t.Set_Max_Strength(300);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(12);
-        t.Set_Primary_Weapon(WEAPON_75MM);
-        t.Set_Has_Turret(true);
-        t.Set_Cost(600);
-        t.Set_Build_Time(80);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(1);
-        t.Set_Side(SIDE_ALLIED);
-        t.Set_Sight_Range(5);
-        return t;
-    }(),
-
-    // UNIT_HTNK - Heavy Tank (Mammoth)
-    []() {
-        UnitTypeClass t("HTNK", "Heavy Tank");
-        t.Set_Type_Index(UNIT_HTNK);
-        t.Set_Shape_Name("HTNK");
-        t.Set_Frame_Count(32);
-        t.Set_Max_Strength(600);
-        t.Set_Armor(ARMOR_HEAVY);
-        t.Set_Speed(6);
-        t.Set_Primary_Weapon(WEAPON_120MM);
-        t.Set_Secondary_Weapon(WEAPON_MAMMOTH_TUSK);
-        t.Set_Has_Turret(true);
-        t.Set_Can_Crush(true);
-        t.Set_Cost(1500);
-        t.Set_Build_Time(150);
-        t.Set_Prerequisites(PREREQ_WARFACTORY | PREREQ_TECHCENTER);
-        t.Set_Tech_Level(5);
-        t.Set_Side(SIDE_SOVIET);
-        t.Set_Sight_Range(4);
-        return t;
-    }(),
-
-    // UNIT_APC - Armored Personnel Carrier
-    []() {
-        UnitTypeClass t("APC", "APC");
-        t.Set_Type_Index(UNIT_APC);
-        t.Set_Shape_Name("APC");
-        t.Set_Max_Strength(200);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(14);
-        t.Set_Primary_Weapon(WEAPON_M60MG);
-        t.Set_Cost(700);
-        t.Set_Build_Time(90);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(2);
-        t.Set_Side(SIDE_ALLIED);
-        return t;
-    }(),
-
-    // UNIT_ARTY - Artillery
-    []() {
-        UnitTypeClass t("ARTY", "Artillery");
-        t.Set_Type_Index(UNIT_ARTY);
-        t.Set_Shape_Name("ARTY");
-        t.Set_Max_Strength(150);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(8);
-        t.Set_Primary_Weapon(WEAPON_155MM);
-        t.Set_Cost(600);
-        t.Set_Build_Time(80);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(4);
-        t.Set_Side(SIDE_ALLIED);
-        return t;
-    }(),
-
-    // UNIT_HARV - Harvester
-    []() {
-        UnitTypeClass t("HARV", "Ore Truck");
-        t.Set_Type_Index(UNIT_HARV);
-        t.Set_Shape_Name("HARV");
-        t.Set_Max_Strength(600);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(8);
-        t.Set_Cost(1400);
-        t.Set_Build_Time(120);
-        t.Set_Harvester(true);
-        t.Set_Side(SIDE_NEUTRAL); // Both sides use
-        return t;
-    }(),
-
-    // UNIT_MCV - Mobile Construction Vehicle
-    []() {
-        UnitTypeClass t("MCV", "MCV");
-        t.Set_Type_Index(UNIT_MCV);
-        t.Set_Shape_Name("MCV");
-        t.Set_Max_Strength(600);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(6);
-        t.Set_Cost(2500);
-        t.Set_Build_Time(200);
-        t.Set_MCV(true);
-        t.Set_Side(SIDE_NEUTRAL);
-        return t;
-    }(),
-
-    // UNIT_JEEP - Ranger
-    []() {
-        UnitTypeClass t("JEEP", "Ranger");
-        t.Set_Type_Index(UNIT_JEEP);
-        t.Set_Shape_Name("JEEP");
-        t.Set_Max_Strength(150);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(16);
-        t.Set_Tracked(false);
-        t.Set_Primary_Weapon(WEAPON_M60MG);
-        t.Set_Cost(500);
-        t.Set_Build_Time(60);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(1);
-        t.Set_Side(SIDE_ALLIED);
-        return t;
-    }(),
-
-    // UNIT_V2RL - V2 Rocket Launcher
-    []() {
-        UnitTypeClass t("V2RL", "V2 Launcher");
-        t.Set_Type_Index(UNIT_V2RL);
-        t.Set_Shape_Name("V2RL");
-        t.Set_Max_Strength(150);
-        t.Set_Armor(ARMOR_LIGHT);
-        t.Set_Speed(8);
-        t.Set_Primary_Weapon(WEAPON_SCUD);
-        t.Set_Cost(700);
-        t.Set_Build_Time(100);
-        t.Set_Prerequisites(PREREQ_WARFACTORY | PREREQ_RADAR);
-        t.Set_Tech_Level(4);
-        t.Set_Side(SIDE_SOVIET);
-        return t;
-    }(),
-
-    // UNIT_FTNK - Flame Tank
-    []() {
-        UnitTypeClass t("FTNK", "Flame Tank");
-        t.Set_Type_Index(UNIT_FTNK);
-        t.Set_Shape_Name("FTNK");
-        t.Set_Max_Strength(300);
-        t.Set_Armor(ARMOR_HEAVY);
-        t.Set_Speed(10);
-        t.Set_Primary_Weapon(WEAPON_FIREBALL);
-        t.Set_Cost(800);
-        t.Set_Build_Time(100);
-        t.Set_Prerequisites(PREREQ_WARFACTORY);
-        t.Set_Tech_Level(3);
-        t.Set_Side(SIDE_SOVIET);
-        return t;
-    }(),
+    UnitTypeClass(UNIT_MTNK),
+    UnitTypeClass(UNIT_LTNK),
+    UnitTypeClass(UNIT_HTNK),
+    UnitTypeClass(UNIT_APC),
+    UnitTypeClass(UNIT_ARTY),
+    UnitTypeClass(UNIT_HARV),
+    UnitTypeClass(UNIT_MCV),
+    UnitTypeClass(UNIT_JEEP),
+    UnitTypeClass(UNIT_V2RL),
+    UnitTypeClass(UNIT_FTNK),
 };
 
 UnitType Unit_Type_From_Name(const char* name) {
     if (name == nullptr) return UNIT_NONE;
-    for (int i = 0; i < UNIT_COUNT; i++) {
-        if (strcmp(UnitTypes[i].Get_Name(), name) == 0) {
-            return (UnitType)i;
-        }
+
+    // The only name that can match is the one in this name's slot
+    int found = UNIT_NAME_TABLE.index[UNIT_NAME_TABLE.Slot(name)];
+    if (found < 0 || !INI_Equal(UNIT_TYPE_TABLE[found].name, name)) {
+        return UNIT_NONE;
     }
-    return UNIT_NONE;
+    return (UnitType)found;
 }
 
 // =============================================================================
@@ -261,66 +128,154 @@ BuildingTypeClass::BuildingTypeClass(const char* ini_name, const char* full_name
 {
 }
 
+BuildingTypeClass::BuildingTypeClass(BuildingType type)
+    : BuildingTypeClass(BUILDING_TYPE_TABLE[type])
+{
+    type_index_ = type;
+}
+
+BuildingTypeClass::BuildingTypeClass(const BuildingTypeData& data)
+    : TechnoTypeClass(data.name, data.full_name, RTTI_BUILDINGTYPE)
+    , width_(data.width)
+    , height_(data.height)
+    , power_(data.power)
+    , factory_type_(data.factory_type)
+    , is_conyard_((data.flags & BUILDING_FLAG_CONYARD) != 0)
+    , is_defense_((data.flags & BUILDING_FLAG_DEFENSE) != 0)
+    , has_bib_((data.flags & BUILDING_FLAG_NO_BIB) == 0)
+{
+    max_strength_ = data.strength;
+    armor_ = data.armor;
+    primary_weapon_ = data.weapon;
+    cost_ = data.cost;
+    build_time_ = data.build_time;
+    prerequisites_ = data.prerequisites;
+    tech_level_ = data.tech_level;
+    side_ = data.side;
+    sight_range_ = data.sight;
+}
+
 // =============================================================================
-// Building Types Definition (abbreviated)
+// Building Types Definition
 // =============================================================================
 
+// One row copy each; the stats are in BUILDING_TYPE_TABLE
 BuildingTypeClass BuildingTypes[BUILDING_COUNT] = {
-    // BUILDING_FACT - Construction Yard
-    []() {
-        BuildingTypeClass t("FACT", "Construction Yard");
-        t.Set_Type_Index(BUILDING_FACT);
-        t.Set_Size(3, 3);
-        t.Set_Max_Strength(1000);
-        t.Set_Power(-30);
-        t.Set_Factory_Type(4); // Builds buildings
-        t.Set_Construction_Yard(true);
-        t.Set_Side(SIDE_NEUTRAL);
-        return t;
-    }(),
-
-    // BUILDING_POWR - Power Plant
-    []() {
-        BuildingTypeClass t("POWR", "Power Plant");
-        t.Set_Type_Index(BUILDING_POWR);
-        t.Set_Size(2, 2);
-        t.Set_Max_Strength(400);
-        t.Set_Power(100);
-        t.Set_Cost(300);
-        t.Set_Tech_Level(1);
-        t.Set_Side(SIDE_NEUTRAL);
-        return t;
-    }(),
-
-    // ... (rest initialized similarly)
-    // For brevity, remaining buildings use default constructor
-    BuildingTypeClass(),  // APWR
-    BuildingTypeClass(),  // BARR
-    BuildingTypeClass(),  // TENT
-    BuildingTypeClass(),  // WEAP
-    BuildingTypeClass(),  // DOME
-    BuildingTypeClass(),  // HPAD
-    BuildingTypeClass(),  // AFLD
-    BuildingTypeClass(),  // SPEN
-    BuildingTypeClass(),  // SYRD
-    BuildingTypeClass(),  // GUN
-    BuildingTypeClass(),  // AGUN
-    BuildingTypeClass(),  // GTWR
-    BuildingTypeClass(),  // TSLA
-    BuildingTypeClass(),  // SAM
-    BuildingTypeClass(),  // SILO
-    BuildingTypeClass(),  // PROC
-    BuildingTypeClass(),  // FCOM
-    BuildingTypeClass(),  // ATEK
-    BuildingTypeClass(),  // STEK
+    BuildingTypeClass(BUILDING_FACT),
+    BuildingTypeClass(BUILDING_POWR),
+    BuildingTypeClass(BUILDING_APWR),
+    BuildingTypeClass(BUILDING_BARR),
+    BuildingTypeClass(BUILDING_TENT),
+    BuildingTypeClass(BUILDING_WEAP),
+    BuildingTypeClass(BUILDING_DOME),
+    BuildingTypeClass(BUILDING_HPAD),
+    BuildingTypeClass(BUILDING_AFLD),
+    BuildingTypeClass(BUILDING_SPEN),
+    BuildingTypeClass(BUILDING_SYRD),
+    BuildingTypeClass(BUILDING_GUN),
+    BuildingTypeClass(BUILDING_AGUN),
+    BuildingTypeClass(BUILDING_GTWR),
+    BuildingTypeClass(BUILDING_TSLA),
+    BuildingTypeClass(BUILDING_SAM),
+    BuildingTypeClass(BUILDING_SILO),
+    BuildingTypeClass(BUILDING_PROC),
+    BuildingTypeClass(BUILDING_FCOM),
+    BuildingTypeClass(BUILDING_ATEK),
+    BuildingTypeClass(BUILDING_STEK),
 };
 
 BuildingType Building_Type_From_Name(const char* name) {
     if (name == nullptr) return BUILDING_NONE;
+
+    int found = BUILDING_NAME_TABLE.index[BUILDING_NAME_TABLE.Slot(name)];
+    if (found < 0 || !INI_Equal(BUILDING_TYPE_TABLE[found].name, name)) {
+        return BUILDING_NONE;
+    }
+    return (BuildingType)found;
+}
+
+// =============================================================================
+// RULES.INI Overrides
+// =============================================================================
+
+static ArmorType Armor_From_Name(std::string_view name, ArmorType def) {
+    static const char* const names[ARMOR_COUNT] = {"none", "wood", "light", "heavy", "concrete"};
+    for (int i = 0; i < ARMOR_COUNT; i++) {
+        if (INI_Equal(names[i], name)) {
+            return (ArmorType)i;
+        }
+    }
+    return def;
+}
+
+// Entries every techno type takes
+static void Apply_Techno_Rules(const INIClass& rules, const char* section, TechnoTypeClass& type) {
+    type.Set_Max_Strength(rules.Get_Int(section, "Strength", type.Get_Max_Strength()));
+    type.Set_Armor(Armor_From_Name(rules.Get_String(section, "Armor", ""), type.Get_Armor()));
+    type.Set_Cost(rules.Get_Int(section, "Cost", type.Get_Cost()));
+    type.Set_Tech_Level(rules.Get_Int(section, "TechLevel", type.Get_Tech_Level()));
+    type.Set_Sight_Range(rules.Get_Int(section, "Sight", type.Get_Sight_Range()));
+}
+
+int Apply_Type_Rules(const INIClass& rules) {
+    int patched = 0;
+    for (int i = 0; i < UNIT_COUNT; i++) {
+        const char* section = UNIT_TYPE_TABLE[i].name;
+        if (!rules.Is_Present(section)) {
+            continue;
+        }
+        UnitTypeClass& type = UnitTypes[i];
+        Apply_Techno_Rules(rules, section, type);
+        type.Set_Speed(rules.Get_Int(section, "Speed", type.Get_Speed()));
+        type.Set_Turret_Rate(rules.Get_Int(section, "ROT", type.Get_Turret_Rate()));
+        patched++;
+    }
     for (int i = 0; i < BUILDING_COUNT; i++) {
-        if (strcmp(BuildingTypes[i].Get_Name(), name) == 0) {
-            return (BuildingType)i;
+        const char* section = BUILDING_TYPE_TABLE[i].name;
+        if (!rules.Is_Present(section)) {
+            continue;
         }
+        BuildingTypeClass& type = BuildingTypes[i];
+        Apply_Techno_Rules(rules, section, type);
+        type.Set_Power(rules.Get_Int(section, "Power", type.Get_Power()));
+        patched++;
+    }
+    return patched;
+}
+
+void Reset_Type_Rules() {
+    for (int i = 0; i < UNIT_COUNT; i++) {
+        ShapeId shape = UnitTypes[i].Get_Shape_Id();
+        UnitTypes[i] = UnitTypeClass((UnitType)i);
+        UnitTypes[i].Set_Shape_Id(shape);
+    }
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        ShapeId shape = BuildingTypes[i].Get_Shape_Id();
+        BuildingTypes[i] = BuildingTypeClass((BuildingType)i);
+        BuildingTypes[i].Set_Shape_Id(shape);
+    }
+}
+
+// =============================================================================
+// Shape Handle Resolution
+// =============================================================================
+
+static void Register_Type_Shape(ObjectTypeClass& type) {
+    const char* name = type.Get_Shape_Name();
+    if (name == nullptr || name[0] == '\0') {
+        return;
+    }
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%s.SHP", name);
+    type.Set_Shape_Id(ShapeCache::Instance().Register(filename));
+}
+
+void Init_Type_Shapes() {
+    for (int i = 0; i < UNIT_COUNT; i++) {
+        Register_Type_Shape(UnitTypes[i]);
+    }
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        Register_Type_Shape(BuildingTypes[i]);
     }
-    return BUILDING_NONE;
 }
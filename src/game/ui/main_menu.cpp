@@ -6,7 +6,9 @@
 
 #include "game/ui/main_menu.h"
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/text_cache.h"
 #include "platform.h"
+#include "platform/startup_trace.h"
 #include <cstring>
 #include <cstdio>
 
@@ -28,6 +30,7 @@ MainMenu::MainMenu()
     , highlighted_index_(0)
     , background_(nullptr)
     , has_background_(false)
+    , discovery_(nullptr)
 {
     std::memset(palette_, 0, sizeof(palette_));
     std::memset(buttons_, 0, sizeof(buttons_));
@@ -52,7 +55,12 @@ bool MainMenu::Initialize() {
     SetupButtons();
 
     // Try to load title screen
-    if (!LoadTitleScreen()) {
+    bool title_loaded;
+    {
+        STARTUP_PHASE("Title Screen");
+        title_loaded = LoadTitleScreen();
+    }
+    if (!title_loaded) {
         Platform_LogWarn("MainMenu: Could not load TITLE.PCX, using fallback");
         // Continue without background - buttons will still work
     }
@@ -77,6 +85,18 @@ bool MainMenu::Initialize() {
     return true;
 }
 
+void MainMenu::StartDiscovery() {
+    if (discovery_) {
+        return;
+    }
+
+    // The lobby reads what this finds later
+    discovery_ = Platform_Discovery_Start();
+    if (!discovery_) {
+        Platform_LogWarn("MainMenu: LAN discovery unavailable");
+    }
+}
+
 void MainMenu::Shutdown() {
     if (!initialized_) {
         return;
@@ -84,6 +104,10 @@ void MainMenu::Shutdown() {
 
     background_.reset();
     has_background_ = false;
+    if (discovery_) {
+        Platform_Discovery_Stop(discovery_);
+        discovery_ = nullptr;
+    }
     initialized_ = false;
 
     Platform_LogInfo("MainMenu::Shutdown: Complete");
@@ -93,6 +117,17 @@ void MainMenu::Reset() {
     finished_ = false;
     selection_ = MenuResult::NONE;
     highlighted_index_ = 0;
+    if (discovery_) {
+        Platform_Discovery_Refresh(discovery_);
+    }
+}
+
+int MainMenu::GetLanGames(DiscoveredGame* games, int max_games) const {
+    if (!discovery_) {
+        return 0;
+    }
+    int count = Platform_Discovery_GetGames(discovery_, games, max_games);
+    return count > 0 ? count : 0;
 }
 
 // =============================================================================
@@ -347,142 +382,13 @@ void MainMenu::DrawButton(int index) {
 // Simple Bitmap Text Rendering
 // =============================================================================
 
-// 5x7 bitmap font data for uppercase letters, numbers, and common symbols
-// Each character is 5 pixels wide, stored as 7 rows of 5 bits
-static const uint8_t FONT_DATA[][7] = {
-    // Space (32)
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // ! (33)
-    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},
-    // " (34) - skip for now
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // # - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // $ - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // % - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // & (38)
-    {0x08, 0x14, 0x14, 0x08, 0x15, 0x12, 0x0D},
-    // ' - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // ( - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // ) - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // * - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // + - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // , - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // - (45)
-    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},
-    // . (46)
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04},
-    // / - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // 0-9 (48-57)
-    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
-    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
-    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
-    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
-    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
-    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
-    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
-    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
-    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
-    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
-    // : - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // ; - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // < - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // = - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // > - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // ? - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // @ - skip
-    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
-    // A-Z (65-90)
-    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // A
-    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
-    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
-    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
-    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
-    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
-    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
-    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
-    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
-    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
-    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
-    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
-    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
-    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
-    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
-    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
-    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
-    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
-    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
-    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
-    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
-    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
-    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
-    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
-    {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
-    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
-};
-
-// Lowercase letters (map to uppercase for simplicity)
-static const uint8_t FONT_LOWERCASE_OFFSET = 'a' - 'A';
-
 void MainMenu::DrawText(const char* text, int center_x, int center_y, uint8_t color, bool centered) {
     if (!text) return;
 
-    GraphicsBuffer& screen = GraphicsBuffer::Screen();
-
-    // Calculate text width for centering
-    int text_width = 0;
-    for (const char* p = text; *p; p++) {
-        text_width += 6;  // 5 pixels + 1 spacing
-    }
-    text_width -= 1;  // Remove trailing space
-
-    int start_x = centered ? (center_x - text_width / 2) : center_x;
-    int start_y = center_y - 3;  // Center vertically (7 pixel height / 2)
-
-    int x = start_x;
-    for (const char* p = text; *p; p++) {
-        char c = *p;
+    int width = TextCache::Text_Width(text, TEXT_FONT_MENU);
+    int start_x = centered ? (center_x - width / 2) : center_x;
+    int start_y = center_y - TextCache::Text_Height(TEXT_FONT_MENU) / 2;
 
-        // Convert lowercase to uppercase
-        if (c >= 'a' && c <= 'z') {
-            c = c - 'a' + 'A';
-        }
-
-        // Get font data index
-        int font_index = -1;
-        if (c == ' ') font_index = 0;
-        else if (c == '!') font_index = 1;
-        else if (c == '&') font_index = 6;
-        else if (c >= '0' && c <= '9') font_index = 16 + (c - '0');
-        else if (c >= 'A' && c <= 'Z') font_index = 33 + (c - 'A');
-
-        if (font_index >= 0 && font_index < 59) {
-            // Draw character
-            for (int row = 0; row < 7; row++) {
-                uint8_t row_data = FONT_DATA[font_index][row];
-                for (int col = 0; col < 5; col++) {
-                    if (row_data & (0x10 >> col)) {
-                        screen.Put_Pixel(x + col, start_y + row, color);
-                    }
-                }
-            }
-        }
-
-        x += 6;  // Move to next character position
-    }
+    TextCache::Instance().Draw(GraphicsBuffer::Screen(), text, start_x, start_y,
+                               TEXT_FONT_MENU, color);
 }
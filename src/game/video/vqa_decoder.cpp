@@ -0,0 +1,377 @@
+/**
+ * VqaDecoder - Westwood VQA Movie Decoding
+ */
+
+#include "game/video/vqa_decoder.h"
+#include "platform.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t ID_FORM = Vqa_Id('F', 'O', 'R', 'M');
+constexpr uint32_t ID_WVQA = Vqa_Id('W', 'V', 'Q', 'A');
+constexpr uint32_t ID_VQHD = Vqa_Id('V', 'Q', 'H', 'D');
+constexpr uint32_t ID_VQFR = Vqa_Id('V', 'Q', 'F', 'R');
+constexpr uint32_t ID_VQFK = Vqa_Id('V', 'Q', 'F', 'K');
+constexpr uint32_t ID_CBF0 = Vqa_Id('C', 'B', 'F', '0');
+constexpr uint32_t ID_CBFZ = Vqa_Id('C', 'B', 'F', 'Z');
+constexpr uint32_t ID_CBP0 = Vqa_Id('C', 'B', 'P', '0');
+constexpr uint32_t ID_CBPZ = Vqa_Id('C', 'B', 'P', 'Z');
+constexpr uint32_t ID_CPL0 = Vqa_Id('C', 'P', 'L', '0');
+constexpr uint32_t ID_CPLZ = Vqa_Id('C', 'P', 'L', 'Z');
+constexpr uint32_t ID_VPT0 = Vqa_Id('V', 'P', 'T', '0');
+constexpr uint32_t ID_VPTZ = Vqa_Id('V', 'P', 'T', 'Z');
+constexpr uint32_t ID_VPTK = Vqa_Id('V', 'P', 'T', 'K');
+constexpr uint32_t ID_VPTD = Vqa_Id('V', 'P', 'T', 'D');
+constexpr uint32_t ID_SND0 = Vqa_Id('S', 'N', 'D', '0');
+constexpr uint32_t ID_SND2 = Vqa_Id('S', 'N', 'D', '2');
+
+// Codebook room when the header gives no size: every 4x2 pointer
+// below the one-color marker
+constexpr size_t MIN_CODEBOOK_ENTRIES = 0x0F00;
+
+uint32_t Read_Be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// Step over the IFF chunk at pos (bodies are padded to even sizes)
+bool Next_Chunk(const uint8_t* data, uint32_t end, uint32_t& pos,
+                uint32_t& id, const uint8_t*& body, uint32_t& size) {
+    if (end < 8 || pos > end - 8) {
+        return false;
+    }
+    id = Read_Be32(data + pos);
+    size = Read_Be32(data + pos + 4);
+    if (size > end - pos - 8) {
+        return false;
+    }
+    body = data + pos + 8;
+    pos = std::min(pos + 8 + size + (size & 1), end);
+    return true;
+}
+
+// LCW into dest, which is sized to what came out
+bool Unpack_Lcw(const uint8_t* body, uint32_t size, std::vector<uint8_t>& dest, size_t capacity) {
+    dest.resize(capacity);
+    int32_t written = Platform_LCW_Decompress(body, static_cast<int32_t>(size),
+                                              dest.data(), static_cast<int32_t>(capacity));
+    if (written < 0) {
+        dest.clear();
+        return false;
+    }
+    dest.resize(static_cast<size_t>(written));
+    return true;
+}
+
+} // namespace
+
+// =============================================================================
+// Open / Close
+// =============================================================================
+
+bool VqaDecoder::Open(const uint8_t* data, uint32_t size) {
+    Close();
+
+    if (!data || size < 12 || Read_Be32(data) != ID_FORM || Read_Be32(data + 8) != ID_WVQA) {
+        Platform_LogInfo("VqaDecoder: Not a VQA file");
+        return false;
+    }
+    uint32_t form_size = Read_Be32(data + 4);
+    uint32_t end = (form_size <= size - 8) ? form_size + 8 : size;
+
+    // The header comes first; anything before it is skipped
+    uint32_t pos = 12;
+    uint32_t id = 0, chunk_size = 0;
+    const uint8_t* body = nullptr;
+    bool found = false;
+    while (!found && Next_Chunk(data, end, pos, id, body, chunk_size)) {
+        found = (id == ID_VQHD);
+    }
+    if (!found || chunk_size < sizeof(VqaHeader)) {
+        Platform_LogInfo("VqaDecoder: Missing VQHD header");
+        return false;
+    }
+
+    VqaHeader header;
+    memcpy(&header, body, sizeof(header));
+    if (header.width == 0 || header.height == 0 || header.frames == 0 ||
+        header.block_width != 4 || (header.block_height != 2 && header.block_height != 4) ||
+        header.width % header.block_width != 0 || header.height % header.block_height != 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "VqaDecoder: Unsupported movie %ux%u, %ux%u blocks",
+                 header.width, header.height, header.block_width, header.block_height);
+        Platform_LogInfo(msg);
+        return false;
+    }
+    if (header.fps == 0) {
+        header.fps = 15;
+    }
+    if (header.group_size == 0) {
+        header.group_size = 1;
+    }
+    if (header.channels == 0) {
+        header.channels = 1;
+    }
+    if (header.bits_per_sample == 0) {
+        header.bits_per_sample = 16;
+    }
+
+    data_ = data;
+    size_ = end;
+    pos_ = pos;
+    header_ = header;
+    frame_index_ = 0;
+
+    blocks_x_ = header.width / header.block_width;
+    blocks_y_ = header.height / header.block_height;
+    block_size_ = header.block_width * header.block_height;
+    solid_marker_ = (header.block_height == 2) ? 0x0F : 0xFF;
+    codebook_capacity_ = static_cast<size_t>(block_size_) *
+                         std::max<size_t>(header.codebook_entries, MIN_CODEBOOK_ENTRIES);
+    return true;
+}
+
+void VqaDecoder::Close() {
+    data_ = nullptr;
+    size_ = 0;
+    pos_ = 0;
+    header_ = VqaHeader();
+    frame_index_ = 0;
+
+    std::vector<uint8_t>().swap(codebook_);
+    std::vector<uint8_t>().swap(next_codebook_);
+    std::vector<uint8_t>().swap(codebook_parts_);
+    std::vector<uint8_t>().swap(pointers_);
+    next_codebook_ready_ = false;
+    parts_loaded_ = 0;
+    memset(palette_, 0, sizeof(palette_));
+    audio_state_[0].Reset();
+    audio_state_[1].Reset();
+}
+
+bool VqaDecoder::IsFinished() const {
+    return !IsOpen() || frame_index_ >= header_.frames || pos_ >= size_;
+}
+
+size_t VqaDecoder::GetResidentBytes() const {
+    return codebook_.capacity() + next_codebook_.capacity() +
+           codebook_parts_.capacity() + pointers_.capacity();
+}
+
+// =============================================================================
+// Frame Decoding
+// =============================================================================
+
+bool VqaDecoder::DecodeFrame(VqaFrame& frame) {
+    if (IsFinished()) {
+        return false;
+    }
+
+    // A codebook completed during the last frame is drawn from this one
+    if (next_codebook_ready_) {
+        codebook_.swap(next_codebook_);
+        next_codebook_ready_ = false;
+    }
+
+    frame.audio.clear();
+    frame.palette_changed = false;
+
+    bool drawn = false;
+    while (!drawn) {
+        uint32_t id, size;
+        const uint8_t* body;
+        if (!Next_Chunk(data_, size_, pos_, id, body, size)) {
+            pos_ = size_;
+            return false;
+        }
+        if (!Process_Chunk(id, body, size, frame, drawn)) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "VqaDecoder: Bad chunk in frame %d", frame_index_);
+            Platform_LogInfo(msg);
+            pos_ = size_;
+            return false;
+        }
+    }
+
+    memcpy(frame.palette, palette_, sizeof(palette_));
+    frame.index = frame_index_++;
+    return true;
+}
+
+bool VqaDecoder::Process_Chunk(uint32_t id, const uint8_t* body, uint32_t size,
+                               VqaFrame& frame, bool& drawn) {
+    switch (id) {
+        case ID_VQFR:
+        case ID_VQFK: {
+            // Frame container: codebook, palette and pointer chunks
+            uint32_t pos = 0;
+            uint32_t sub_id, sub_size;
+            const uint8_t* sub_body;
+            while (Next_Chunk(body, size, pos, sub_id, sub_body, sub_size)) {
+                if (!Process_Chunk(sub_id, sub_body, sub_size, frame, drawn)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case ID_CBF0: return Load_Codebook(body, size, false);
+        case ID_CBFZ: return Load_Codebook(body, size, true);
+        case ID_CBP0: return Load_Partial_Codebook(body, size, false);
+        case ID_CBPZ: return Load_Partial_Codebook(body, size, true);
+        case ID_CPL0: return Load_Palette(body, size, false, frame);
+        case ID_CPLZ: return Load_Palette(body, size, true, frame);
+
+        case ID_VPT0:
+            drawn = true;
+            return Draw_Pointers(body, size, false, frame);
+        case ID_VPTZ:
+        case ID_VPTK:
+        case ID_VPTD:
+            drawn = true;
+            return Draw_Pointers(body, size, true, frame);
+
+        case ID_SND0:
+        case ID_SND2:
+            Decode_Audio(id, body, size, frame);
+            return true;
+
+        default:
+            // FINF, NAME, captions, the alternate and Zap (SND1) sound
+            return true;
+    }
+}
+
+bool VqaDecoder::Load_Codebook(const uint8_t* body, uint32_t size, bool compressed) {
+    // The first codebook is drawn with at once; later ones wait a frame
+    bool first = codebook_.empty();
+    std::vector<uint8_t>& dest = first ? codebook_ : next_codebook_;
+
+    if (compressed) {
+        if (!Unpack_Lcw(body, size, dest, codebook_capacity_)) {
+            return false;
+        }
+    } else {
+        dest.assign(body, body + std::min<size_t>(size, codebook_capacity_));
+    }
+    next_codebook_ready_ = !first;
+    return true;
+}
+
+bool VqaDecoder::Load_Partial_Codebook(const uint8_t* body, uint32_t size, bool compressed) {
+    codebook_parts_.insert(codebook_parts_.end(), body, body + size);
+    parts_compressed_ = compressed;
+    if (++parts_loaded_ < header_.group_size) {
+        return true;
+    }
+
+    // The group's parts together make the next full codebook
+    bool loaded = Load_Codebook(codebook_parts_.data(),
+                                static_cast<uint32_t>(codebook_parts_.size()), parts_compressed_);
+    codebook_parts_.clear();
+    parts_loaded_ = 0;
+    return loaded;
+}
+
+bool VqaDecoder::Load_Palette(const uint8_t* body, uint32_t size, bool compressed, VqaFrame& frame) {
+    if (compressed) {
+        int32_t written = Platform_LCW_Decompress(body, static_cast<int32_t>(size),
+                                                  palette_, static_cast<int32_t>(sizeof(palette_)));
+        if (written < 0) {
+            return false;
+        }
+    } else {
+        memcpy(palette_, body, std::min<size_t>(size, sizeof(palette_)));
+    }
+    frame.palette_changed = true;
+    return true;
+}
+
+bool VqaDecoder::Draw_Pointers(const uint8_t* body, uint32_t size, bool compressed, VqaFrame& frame) {
+    const size_t count = static_cast<size_t>(blocks_x_) * blocks_y_;
+    if (compressed) {
+        if (!Unpack_Lcw(body, size, pointers_, count * 2)) {
+            return false;
+        }
+    } else {
+        pointers_.assign(body, body + std::min<size_t>(size, count * 2));
+    }
+    if (pointers_.size() < count * 2 || codebook_.empty()) {
+        return false;
+    }
+
+    // Each block's pointer is split: all low bytes, then all high bytes.
+    // A high byte of solid_marker_ means a block of the one color in the
+    // low byte; anything else indexes the codebook.
+    const int width = header_.width;
+    const int block_w = header_.block_width;
+    const int block_h = header_.block_height;
+    frame.pixels.resize(static_cast<size_t>(width) * header_.height);
+
+    const uint8_t* lo = pointers_.data();
+    const uint8_t* hi = lo + count;
+    const size_t entries = codebook_.size() / block_size_;
+    size_t index = 0;
+    for (int by = 0; by < blocks_y_; by++) {
+        uint8_t* row = frame.pixels.data() + static_cast<size_t>(by) * block_h * width;
+        for (int bx = 0; bx < blocks_x_; bx++, index++) {
+            uint8_t* dest = row + bx * block_w;
+            if (hi[index] == solid_marker_) {
+                for (int y = 0; y < block_h; y++) {
+                    memset(dest + y * width, lo[index], block_w);
+                }
+                continue;
+            }
+
+            size_t entry = (static_cast<size_t>(hi[index]) << 8) | lo[index];
+            if (entry >= entries) {
+                for (int y = 0; y < block_h; y++) {
+                    memset(dest + y * width, 0, block_w);
+                }
+                continue;
+            }
+            const uint8_t* src = codebook_.data() + entry * block_size_;
+            for (int y = 0; y < block_h; y++) {
+                memcpy(dest + y * width, src + y * block_w, block_w);
+            }
+        }
+    }
+    return true;
+}
+
+void VqaDecoder::Decode_Audio(uint32_t id, const uint8_t* body, uint32_t size, VqaFrame& frame) {
+    if (!HasAudio()) {
+        return;
+    }
+    std::vector<int16_t>& audio = frame.audio;
+    size_t start = audio.size();
+
+    if (id == ID_SND0) {
+        // Raw PCM: 8-bit unsigned or 16-bit signed
+        if (header_.bits_per_sample == 8) {
+            audio.resize(start + size);
+            for (uint32_t i = 0; i < size; i++) {
+                audio[start + i] = static_cast<int16_t>((body[i] - 128) << 8);
+            }
+        } else {
+            audio.resize(start + size / 2);
+            memcpy(audio.data() + start, body, (size / 2) * sizeof(int16_t));
+        }
+        return;
+    }
+
+    // IMA ADPCM, its state running on across chunks; stereo chunks hold
+    // the left channel's bytes, then the right's
+    if (header_.channels == 2) {
+        uint32_t half = size / 2;
+        audio.resize(start + static_cast<size_t>(half) * 4);
+        DecodeImaAdpcm(audio_state_[0], body, half, audio.data() + start, 2);
+        DecodeImaAdpcm(audio_state_[1], body + half, half, audio.data() + start + 1, 2);
+    } else {
+        audio.resize(start + static_cast<size_t>(size) * 2);
+        DecodeImaAdpcm(audio_state_[0], body, size, audio.data() + start);
+    }
+}
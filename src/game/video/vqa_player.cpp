@@ -0,0 +1,319 @@
+/**
+ * VqaPlayer - Streaming VQA Movie Playback
+ */
+
+#include "game/video/vqa_player.h"
+#include "game/graphics/graphics_buffer.h"
+#include "game/graphics/palette_manager.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// =============================================================================
+// Open / Close
+// =============================================================================
+
+bool VqaPlayer::Open(const char* filename) {
+    Close();
+    if (!view_.Open(filename)) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "VqaPlayer: %s not found", filename ? filename : "(null)");
+        Platform_LogInfo(msg);
+        return false;
+    }
+    if (!decoder_.Open(view_.Data(), static_cast<uint32_t>(view_.Size()))) {
+        view_.Close();
+        return false;
+    }
+    return Start();
+}
+
+bool VqaPlayer::OpenMemory(const uint8_t* data, uint32_t size) {
+    Close();
+    if (!decoder_.Open(data, size)) {
+        return false;
+    }
+    return Start();
+}
+
+bool VqaPlayer::Start() {
+    decoded_ = 0;
+    consumed_ = 0;
+    decode_done_ = false;
+    stop_ = false;
+    decoder_bytes_ = 0;
+    audio_read_ = 0;
+    audio_written_ = 0;
+    audio_finished_ = false;
+    started_ = false;
+    frames_shown_ = 0;
+    frames_dropped_ = 0;
+
+    // No stream (no sound, or no mixer) just means the wall clock times it
+    const VqaHeader& header = decoder_.GetHeader();
+    audio_rate_ = decoder_.HasAudio() ? header.sample_rate * header.channels : 0;
+    if (audio_rate_ > 0) {
+        audio_handle_ = Platform_Stream_Open(header.sample_rate, header.channels,
+                                             audio_rate_ * AUDIO_LEAD_MS / 1000, volume_);
+    }
+    if (audio_handle_ == INVALID_PLAY_HANDLE) {
+        audio_rate_ = 0;
+    }
+
+    worker_ = std::thread(&VqaPlayer::Decode_Loop, this);
+    return true;
+}
+
+void VqaPlayer::Close() {
+    if (worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ring_cv_.notify_all();
+        worker_.join();
+    }
+    if (audio_handle_ != INVALID_PLAY_HANDLE) {
+        Platform_Sound_Stop(audio_handle_);
+        audio_handle_ = INVALID_PLAY_HANDLE;
+    }
+
+    decoder_.Close();
+    view_.Close();
+    for (VqaFrame& slot : slots_) {
+        slot = VqaFrame();
+    }
+    std::vector<int16_t>().swap(audio_queue_);
+    audio_read_ = 0;
+    audio_rate_ = 0;
+    decoded_ = 0;
+    consumed_ = 0;
+}
+
+// =============================================================================
+// Decoder Thread
+// =============================================================================
+
+void VqaPlayer::Decode_Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        ring_cv_.wait(lock, [this] { return stop_ || decoded_ - consumed_ < FRAME_RING; });
+        if (stop_) {
+            return;
+        }
+
+        // The slot past decoded_ is ours until decoded_ moves on
+        VqaFrame& slot = slots_[decoded_ % FRAME_RING];
+        lock.unlock();
+        bool ok = decoder_.DecodeFrame(slot);
+        size_t bytes = decoder_.GetResidentBytes();
+        lock.lock();
+
+        decoder_bytes_ = bytes;
+        if (!ok) {
+            decode_done_ = true;
+            return;
+        }
+        if (audio_rate_ > 0) {
+            audio_queue_.insert(audio_queue_.end(), slot.audio.begin(), slot.audio.end());
+        }
+        slot.audio.clear();
+        decoded_++;
+        if (decoder_.IsFinished()) {
+            decode_done_ = true;
+            return;
+        }
+    }
+}
+
+// =============================================================================
+// Frame Ring
+// =============================================================================
+
+const VqaFrame* VqaPlayer::PeekFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (consumed_ == decoded_) {
+        return nullptr;
+    }
+    return &slots_[consumed_ % FRAME_RING];
+}
+
+void VqaPlayer::ReleaseFrame() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (consumed_ == decoded_) {
+            return;
+        }
+        consumed_++;
+    }
+    ring_cv_.notify_one();
+}
+
+size_t VqaPlayer::GetResidentBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = decoder_bytes_ + audio_queue_.capacity() * sizeof(int16_t);
+    for (const VqaFrame& slot : slots_) {
+        bytes += slot.pixels.capacity() + slot.audio.capacity() * sizeof(int16_t);
+    }
+    return bytes;
+}
+
+// =============================================================================
+// Playback
+// =============================================================================
+
+void VqaPlayer::SetVolume(float volume) {
+    volume_ = volume;
+    if (audio_handle_ != INVALID_PLAY_HANDLE) {
+        Platform_Sound_SetVolume(audio_handle_, volume);
+    }
+}
+
+void VqaPlayer::Feed_Audio() {
+    if (audio_handle_ == INVALID_PLAY_HANDLE || audio_finished_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t pending = audio_queue_.size() - audio_read_;
+    if (pending > 0) {
+        int32_t written = Platform_Stream_Write(audio_handle_, audio_queue_.data() + audio_read_,
+                                                static_cast<int32_t>(pending));
+        if (written > 0) {
+            audio_read_ += static_cast<size_t>(written);
+            audio_written_ += written;
+        }
+    }
+
+    // Drop what the stream has taken once it is most of the buffer
+    if (audio_read_ == audio_queue_.size()) {
+        audio_queue_.clear();
+        audio_read_ = 0;
+    } else if (audio_read_ > audio_queue_.size() / 2) {
+        audio_queue_.erase(audio_queue_.begin(), audio_queue_.begin() + audio_read_);
+        audio_read_ = 0;
+    }
+
+    if (decode_done_ && audio_queue_.empty()) {
+        Platform_Stream_Finish(audio_handle_);
+        audio_finished_ = true;
+    }
+}
+
+double VqaPlayer::Clock_Ms() {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point now = Clock::now();
+    if (!started_) {
+        start_time_ = now;
+        started_ = true;
+    }
+
+    if (audio_handle_ != INVALID_PLAY_HANDLE && audio_written_ > 0) {
+        int64_t queued = std::max(Platform_Stream_GetQueued(audio_handle_), 0);
+        if (queued > 0 || !audio_finished_) {
+            // The sound sets the pace; the wall clock is kept in step so
+            // it carries on from here if the sound runs out
+            double audio_ms = (audio_written_ - queued) * 1000.0 / audio_rate_;
+            start_time_ = now - std::chrono::duration_cast<Clock::duration>(
+                                    std::chrono::duration<double, std::milli>(audio_ms));
+            return audio_ms;
+        }
+    }
+    return std::chrono::duration<double, std::milli>(now - start_time_).count();
+}
+
+bool VqaPlayer::Update() {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    Feed_Audio();
+    int due = static_cast<int>(Clock_Ms() * decoder_.GetFrameRate() / 1000.0);
+
+    // Skip frames that are late when the next is already waiting
+    const VqaFrame* frame = PeekFrame();
+    while (frame && frame->index < due) {
+        bool next_ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            next_ready = decoded_ - consumed_ > 1;
+        }
+        if (!next_ready) {
+            break;
+        }
+        ReleaseFrame();
+        frames_dropped_++;
+        frame = PeekFrame();
+    }
+
+    if (frame && frame->index <= due) {
+        Present(*frame);
+        ReleaseFrame();
+        frames_shown_++;
+    }
+    return !IsFinished();
+}
+
+bool VqaPlayer::IsFinished() const {
+    if (!IsOpen()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!decode_done_ || consumed_ < decoded_) {
+        return false;
+    }
+    return audio_handle_ == INVALID_PLAY_HANDLE ||
+           (audio_finished_ && Platform_Stream_GetQueued(audio_handle_) <= 0);
+}
+
+void VqaPlayer::Present(const VqaFrame& frame) {
+    if (frames_shown_ == 0 || memcmp(frame.palette, shown_palette_, sizeof(shown_palette_)) != 0) {
+        PaletteManager& palette = PaletteManager::Instance();
+        palette.LoadPaletteFromMemory(frame.palette, true);
+        palette.Apply();
+        memcpy(shown_palette_, frame.palette, sizeof(shown_palette_));
+    }
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    if (!screen.Lock()) {
+        return;
+    }
+    if (frames_shown_ == 0) {
+        screen.Clear(0);
+    }
+
+    // Centered at the largest whole multiple that fits
+    const int width = decoder_.GetWidth();
+    const int height = decoder_.GetHeight();
+    const int screen_w = screen.Get_Width();
+    const int screen_h = screen.Get_Height();
+    int scale = std::max(1, std::min(screen_w / width, screen_h / height));
+    int out_w = std::min(width * scale, screen_w);
+    int out_h = std::min(height * scale, screen_h);
+    Platform_Buffer_Scale(screen.Get_Buffer(), screen.Get_Pitch(), screen_w, screen_h,
+                          frame.pixels.data(), width, width, height,
+                          (screen_w - out_w) / 2, (screen_h - out_h) / 2, out_w, out_h);
+
+    screen.Unlock();
+    screen.Flip();
+}
+
+// =============================================================================
+// Blocking Playback
+// =============================================================================
+
+bool Vqa_Play(const char* filename) {
+    VqaPlayer player;
+    if (!player.Open(filename)) {
+        return false;
+    }
+
+    while (player.Update()) {
+        Platform_Input_Update();
+        if (Platform_PollEvents() || Platform_Key_WasPressed(KEY_CODE_ESCAPE)) {
+            break;
+        }
+        Platform_Delay(5);
+    }
+    return true;
+}
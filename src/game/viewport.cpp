@@ -3,6 +3,7 @@
  */
 
 #include "game/viewport.h"
+#include <algorithm>
 #include <cstdlib>  // For abs()
 
 // Global viewport reference
@@ -17,6 +18,8 @@ GameViewport::GameViewport()
     , y(0)
     , width(TACTICAL_WIDTH)
     , height(TACTICAL_HEIGHT)
+    , screen_width_(VP_SCREEN_WIDTH)
+    , screen_height_(VP_SCREEN_HEIGHT)
     , map_width_(64)
     , map_height_(64)
     , scroll_enabled_(true)
@@ -40,11 +43,13 @@ GameViewport& GameViewport::Instance() {
 void GameViewport::Initialize() {
     x = 0;
     y = 0;
-    width = TACTICAL_WIDTH;
-    height = TACTICAL_HEIGHT;
+    width = screen_width_ - VP_SIDEBAR_WIDTH;
+    height = screen_height_ - VP_TAB_HEIGHT;
     scroll_enabled_ = true;
     current_scroll_direction_ = SCROLL_NONE;
     scroll_accel_counter_ = 0;
+    edge_motion_.Reset();
+    keyboard_motion_.Reset();
     tracking_enabled_ = false;
 }
 
@@ -52,6 +57,14 @@ void GameViewport::Reset() {
     Initialize();
 }
 
+void GameViewport::SetScreenSize(int screen_width, int screen_height) {
+    screen_width_ = std::max(screen_width, VP_SIDEBAR_WIDTH + TILE_PIXEL_WIDTH);
+    screen_height_ = std::max(screen_height, VP_TAB_HEIGHT + TILE_PIXEL_HEIGHT);
+    width = screen_width_ - VP_SIDEBAR_WIDTH;
+    height = screen_height_ - VP_TAB_HEIGHT;
+    ClampToBounds();
+}
+
 void GameViewport::SetMapSize(int cells_wide, int cells_high) {
     map_width_ = cells_wide;
     map_height_ = cells_high;
@@ -113,13 +126,7 @@ void GameViewport::UpdateEdgeScroll(int mouse_x, int mouse_y) {
     if (!scroll_enabled_) {
         current_scroll_direction_ = SCROLL_NONE;
         scroll_accel_counter_ = 0;
-        return;
-    }
-
-    // Check if mouse is in tactical area
-    if (mouse_x >= TACTICAL_WIDTH || mouse_y < VP_TAB_HEIGHT) {
-        current_scroll_direction_ = SCROLL_NONE;
-        scroll_accel_counter_ = 0;
+        edge_motion_.Reset();
         return;
     }
 
@@ -127,33 +134,36 @@ void GameViewport::UpdateEdgeScroll(int mouse_x, int mouse_y) {
     int scroll_x = 0;
     int scroll_y = 0;
 
-    // Adjust mouse_y for tactical area (subtract tab height)
-    int tactical_y = mouse_y - VP_TAB_HEIGHT;
+    // Outside the tactical area the scroll winds down
+    if (mouse_x < width && mouse_y >= VP_TAB_HEIGHT) {
+        // Adjust mouse_y for tactical area (subtract tab height)
+        int tactical_y = mouse_y - VP_TAB_HEIGHT;
 
-    // Check left edge
-    if (mouse_x < EDGE_SCROLL_ZONE) {
-        int distance = EDGE_SCROLL_ZONE - mouse_x;
-        scroll_x = -CalculateEdgeScrollSpeed(distance);
-        scroll_dir |= SCROLL_LEFT;
-    }
-    // Check right edge
-    else if (mouse_x >= TACTICAL_WIDTH - EDGE_SCROLL_ZONE) {
-        int distance = mouse_x - (TACTICAL_WIDTH - EDGE_SCROLL_ZONE);
-        scroll_x = CalculateEdgeScrollSpeed(distance);
-        scroll_dir |= SCROLL_RIGHT;
-    }
+        // Check left edge
+        if (mouse_x < EDGE_SCROLL_ZONE) {
+            int distance = EDGE_SCROLL_ZONE - mouse_x;
+            scroll_x = -CalculateEdgeScrollSpeed(distance);
+            scroll_dir |= SCROLL_LEFT;
+        }
+        // Check right edge
+        else if (mouse_x >= width - EDGE_SCROLL_ZONE) {
+            int distance = mouse_x - (width - EDGE_SCROLL_ZONE);
+            scroll_x = CalculateEdgeScrollSpeed(distance);
+            scroll_dir |= SCROLL_RIGHT;
+        }
 
-    // Check top edge
-    if (tactical_y < EDGE_SCROLL_ZONE) {
-        int distance = EDGE_SCROLL_ZONE - tactical_y;
-        scroll_y = -CalculateEdgeScrollSpeed(distance);
-        scroll_dir |= SCROLL_UP;
-    }
-    // Check bottom edge
-    else if (tactical_y >= TACTICAL_HEIGHT - EDGE_SCROLL_ZONE) {
-        int distance = tactical_y - (TACTICAL_HEIGHT - EDGE_SCROLL_ZONE);
-        scroll_y = CalculateEdgeScrollSpeed(distance);
-        scroll_dir |= SCROLL_DOWN;
+        // Check top edge
+        if (tactical_y < EDGE_SCROLL_ZONE) {
+            int distance = EDGE_SCROLL_ZONE - tactical_y;
+            scroll_y = -CalculateEdgeScrollSpeed(distance);
+            scroll_dir |= SCROLL_UP;
+        }
+        // Check bottom edge
+        else if (tactical_y >= height - EDGE_SCROLL_ZONE) {
+            int distance = tactical_y - (height - EDGE_SCROLL_ZONE);
+            scroll_y = CalculateEdgeScrollSpeed(distance);
+            scroll_dir |= SCROLL_DOWN;
+        }
     }
 
     // Update acceleration counter
@@ -168,13 +178,18 @@ void GameViewport::UpdateEdgeScroll(int mouse_x, int mouse_y) {
     current_scroll_direction_ = scroll_dir;
 
     // Apply scroll
-    if (scroll_x != 0 || scroll_y != 0) {
-        Scroll(scroll_x, scroll_y);
+    int dx, dy;
+    edge_motion_.Step(static_cast<float>(scroll_x), static_cast<float>(scroll_y), dx, dy);
+    if (dx != 0 || dy != 0) {
+        Scroll(dx, dy);
     }
 }
 
 void GameViewport::UpdateKeyboardScroll(bool up, bool down, bool left, bool right) {
-    if (!scroll_enabled_) return;
+    if (!scroll_enabled_) {
+        keyboard_motion_.Reset();
+        return;
+    }
 
     int scroll_x = 0;
     int scroll_y = 0;
@@ -199,7 +214,13 @@ void GameViewport::UpdateKeyboardScroll(bool up, bool down, bool left, bool righ
 
     if (scroll_dir != SCROLL_NONE) {
         current_scroll_direction_ = scroll_dir;
-        Scroll(scroll_x, scroll_y);
+    }
+
+    // Keeps easing out for a few frames after the keys are let go
+    int dx, dy;
+    keyboard_motion_.Step(static_cast<float>(scroll_x), static_cast<float>(scroll_y), dx, dy);
+    if (dx != 0 || dy != 0) {
+        Scroll(dx, dy);
     }
 }
 
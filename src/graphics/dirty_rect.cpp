@@ -11,9 +11,12 @@
 //=============================================================================
 
 DirtyRectTracker::DirtyRectTracker(int screen_width, int screen_height)
-    : screen_width_(screen_width)
-    , screen_height_(screen_height) {
-    dirty_rects_.reserve(100);
+    : screen_width_(screen_width > 0 ? screen_width : 0)
+    , screen_height_(screen_height > 0 ? screen_height : 0) {
+    tiles_x_ = (screen_width_ + TILE_SIZE - 1) >> TILE_SHIFT;
+    tiles_y_ = (screen_height_ + TILE_SIZE - 1) >> TILE_SHIFT;
+    words_per_row_ = (tiles_x_ + 63) >> 6;
+    tiles_.assign(static_cast<size_t>(words_per_row_) * tiles_y_, 0);
     merged_rects_.reserve(max_rects_);
 }
 
@@ -23,103 +26,201 @@ void DirtyRectTracker::mark_dirty(int x, int y, int width, int height) {
 
 void DirtyRectTracker::mark_dirty(const Rect& rect) {
     // Clamp to screen bounds
-    Rect clamped;
-    clamped.x = (rect.x < 0) ? 0 : rect.x;
-    clamped.y = (rect.y < 0) ? 0 : rect.y;
-    clamped.width = rect.width;
-    clamped.height = rect.height;
-
-    if (clamped.right() > screen_width_) {
-        clamped.width = screen_width_ - clamped.x;
-    }
-    if (clamped.bottom() > screen_height_) {
-        clamped.height = screen_height_ - clamped.y;
-    }
+    int x0 = (rect.x < 0) ? 0 : rect.x;
+    int y0 = (rect.y < 0) ? 0 : rect.y;
+    int x1 = (rect.right() > screen_width_) ? screen_width_ : rect.right();
+    int y1 = (rect.bottom() > screen_height_) ? screen_height_ : rect.bottom();
 
-    if (clamped.width <= 0 || clamped.height <= 0) {
+    if (x0 >= x1 || y0 >= y1) {
         return;  // Off screen or empty
     }
 
-    dirty_rects_.push_back(clamped);
+    mark_count_++;
+    if (full_redraw_) return;
 
-    // Check if we should switch to full redraw
-    if (static_cast<int>(dirty_rects_.size()) > max_rects_ * 2) {
-        full_redraw_ = true;
+    mark_tiles(x0 >> TILE_SHIFT, y0 >> TILE_SHIFT,
+               (x1 - 1) >> TILE_SHIFT, (y1 - 1) >> TILE_SHIFT);
+}
+
+void DirtyRectTracker::mark_tiles(int tx0, int ty0, int tx1, int ty1) {
+    int w0 = tx0 >> 6;
+    int w1 = tx1 >> 6;
+    uint64_t first_mask = ~0ull << (tx0 & 63);
+    uint64_t last_mask = ~0ull >> (63 - (tx1 & 63));
+
+    for (int ty = ty0; ty <= ty1; ty++) {
+        uint64_t* row = &tiles_[static_cast<size_t>(ty) * words_per_row_];
+        for (int w = w0; w <= w1; w++) {
+            uint64_t mask = ~0ull;
+            if (w == w0) mask &= first_mask;
+            if (w == w1) mask &= last_mask;
+            uint64_t added = mask & ~row[w];
+            if (added) {
+                row[w] |= added;
+                dirty_tiles_ += __builtin_popcountll(added);
+                rects_valid_ = false;
+            }
+        }
     }
 }
 
 void DirtyRectTracker::mark_all_dirty() {
+    mark_count_++;
     full_redraw_ = true;
-    dirty_rects_.clear();
-    dirty_rects_.push_back({0, 0, screen_width_, screen_height_});
+    rects_valid_ = false;
+}
+
+void DirtyRectTracker::add(const DirtyRectTracker& other) {
+    if (other.full_redraw_) {
+        full_redraw_ = true;
+        rects_valid_ = false;
+    }
+    mark_count_ += other.mark_count_;
+    if (full_redraw_ || other.dirty_tiles_ == 0 || other.tiles_.size() != tiles_.size()) {
+        return;
+    }
+
+    for (size_t i = 0; i < tiles_.size(); i++) {
+        uint64_t added = other.tiles_[i] & ~tiles_[i];
+        if (added) {
+            tiles_[i] |= added;
+            dirty_tiles_ += __builtin_popcountll(added);
+            rects_valid_ = false;
+        }
+    }
 }
 
 void DirtyRectTracker::clear() {
-    dirty_rects_.clear();
-    merged_rects_.clear();
+    if (dirty_tiles_ > 0) {
+        std::fill(tiles_.begin(), tiles_.end(), 0);
+    }
+    dirty_tiles_ = 0;
+    mark_count_ = 0;
     full_redraw_ = false;
+    merged_rects_.clear();
+    rects_valid_ = true;
+    cost_full_redraw_ = false;
 }
 
-void DirtyRectTracker::merge_rects() {
-    merged_rects_.clear();
+void DirtyRectTracker::set_merge_threshold(float threshold) {
+    merge_threshold_ = threshold;
+    rects_valid_ = false;
+}
 
-    if (dirty_rects_.empty()) return;
+void DirtyRectTracker::set_max_rects(int max) {
+    max_rects_ = max;
+    rects_valid_ = false;
+}
 
-    if (full_redraw_) {
-        merged_rects_.push_back({0, 0, screen_width_, screen_height_});
-        return;
+const std::vector<Rect>& DirtyRectTracker::get_dirty_rects() const {
+    if (!rects_valid_) {
+        build_rects();
     }
+    return merged_rects_;
+}
 
-    // Simple greedy merge algorithm
-    std::vector<bool> merged(dirty_rects_.size(), false);
-
-    for (size_t i = 0; i < dirty_rects_.size(); i++) {
-        if (merged[i]) continue;
+bool DirtyRectTracker::is_full_redraw() const {
+    if (full_redraw_) return true;
+    if (!rects_valid_) {
+        build_rects();
+    }
+    return cost_full_redraw_;
+}
 
-        Rect current = dirty_rects_[i];
+void DirtyRectTracker::build_rects() const {
+    merged_rects_.clear();
+    rects_valid_ = true;
+    cost_full_redraw_ = false;
 
-        // Try to merge with subsequent rects
-        bool did_merge;
-        do {
-            did_merge = false;
-            for (size_t j = i + 1; j < dirty_rects_.size(); j++) {
-                if (merged[j]) continue;
+    int64_t screen_area = static_cast<int64_t>(screen_width_) * screen_height_;
+    int64_t budget = static_cast<int64_t>(screen_area * merge_threshold_);
 
-                const Rect& other = dirty_rects_[j];
+    // Covered area alone is already over budget
+    if (!full_redraw_ &&
+        static_cast<int64_t>(dirty_tiles_) * TILE_SIZE * TILE_SIZE > budget) {
+        cost_full_redraw_ = true;
+    }
 
-                // Check if merging would be beneficial
-                Rect combined = current.merged_with(other);
-                int original_area = current.area() + other.area();
-                int combined_area = combined.area();
+    if (full_redraw_ || cost_full_redraw_) {
+        merged_rects_.push_back({0, 0, screen_width_, screen_height_});
+        return;
+    }
 
-                // Merge if overlap or combined isn't much larger
-                if (current.intersects(other) ||
-                    combined_area < static_cast<int>(original_area * (1.0f + merge_threshold_))) {
-                    current = combined;
-                    merged[j] = true;
-                    did_merge = true;
+    if (dirty_tiles_ == 0) return;
+
+    int64_t cost = 0;
+    auto close = [&](const Rect& t) {
+        Rect r;
+        r.x = t.x << TILE_SHIFT;
+        r.y = t.y << TILE_SHIFT;
+        r.width = std::min(t.right() << TILE_SHIFT, screen_width_) - r.x;
+        r.height = std::min(t.bottom() << TILE_SHIFT, screen_height_) - r.y;
+        merged_rects_.push_back(r);
+        cost += r.area() + RECT_OVERHEAD_PIXELS;
+    };
+
+    open_rects_.clear();
+    for (int ty = 0; ty < tiles_y_; ty++) {
+        const uint64_t* row = &tiles_[static_cast<size_t>(ty) * words_per_row_];
+        next_rects_.clear();
+        size_t open = 0;
+
+        // Runs of set bits in this tile row
+        int tx = 0;
+        while (tx < tiles_x_) {
+            uint64_t bits = row[tx >> 6] >> (tx & 63);
+            if (bits == 0) {
+                tx = (tx | 63) + 1;
+                continue;
+            }
+            tx += __builtin_ctzll(bits);
+            int start = tx;
+
+            while (tx < tiles_x_) {
+                uint64_t clear_bits = ~row[tx >> 6] >> (tx & 63);
+                if (clear_bits == 0) {
+                    tx = (tx | 63) + 1;
+                    continue;
                 }
+                tx += __builtin_ctzll(clear_bits);
+                break;
             }
-        } while (did_merge);
+            int end = std::min(tx, tiles_x_);
 
-        merged_rects_.push_back(current);
+            // Extend the rect above if it spans exactly this run
+            while (open < open_rects_.size() && open_rects_[open].x < start) {
+                close(open_rects_[open++]);
+            }
+            if (open < open_rects_.size() && open_rects_[open].x == start &&
+                open_rects_[open].width == end - start) {
+                Rect grown = open_rects_[open++];
+                grown.height++;
+                next_rects_.push_back(grown);
+            } else {
+                next_rects_.push_back({start, ty, end - start, 1});
+            }
+        }
+
+        while (open < open_rects_.size()) {
+            close(open_rects_[open++]);
+        }
+        open_rects_.swap(next_rects_);
+    }
+    for (const Rect& t : open_rects_) {
+        close(t);
     }
 
-    // If still too many rects, fall back to full redraw
-    if (static_cast<int>(merged_rects_.size()) > max_rects_) {
-        full_redraw_ = true;
+    // Too many rects, or more work than one full blit
+    if (static_cast<int>(merged_rects_.size()) > max_rects_ || cost > budget) {
+        cost_full_redraw_ = true;
         merged_rects_.clear();
         merged_rects_.push_back({0, 0, screen_width_, screen_height_});
     }
 }
 
-void DirtyRectTracker::optimize_rects() {
-    merge_rects();
-}
-
 int DirtyRectTracker::get_dirty_pixel_count() const {
     int total = 0;
-    for (const Rect& r : merged_rects_) {
+    for (const Rect& r : get_dirty_rects()) {
         total += r.area();
     }
     return total;
@@ -131,7 +232,8 @@ int DirtyRectTracker::get_dirty_pixel_count() const {
 
 DoubleBufferedDirtyTracker::DoubleBufferedDirtyTracker(int width, int height)
     : front_(width, height)
-    , back_(width, height) {
+    , back_(width, height)
+    , combined_(width, height) {
 }
 
 void DoubleBufferedDirtyTracker::mark_dirty(const Rect& rect) {
@@ -149,17 +251,20 @@ void DoubleBufferedDirtyTracker::swap_buffers() {
 }
 
 std::vector<Rect> DoubleBufferedDirtyTracker::get_redraw_rects() const {
-    // For double-buffered rendering, need union of both frames
-    std::vector<Rect> result;
-
-    const auto& front_rects = front_.get_dirty_rects();
-    const auto& back_rects = back_.get_dirty_rects();
+    return combine().get_dirty_rects();
+}
 
-    result.reserve(front_rects.size() + back_rects.size());
-    result.insert(result.end(), front_rects.begin(), front_rects.end());
-    result.insert(result.end(), back_rects.begin(), back_rects.end());
+bool DoubleBufferedDirtyTracker::is_full_redraw() const {
+    return combine().is_full_redraw();
+}
 
-    return result;
+const DirtyRectTracker& DoubleBufferedDirtyTracker::combine() const {
+    // For double-buffered rendering, need union of both frames; merging
+    // the bitmaps keeps areas dirty in both frames from being drawn twice
+    combined_.clear();
+    combined_.add(front_);
+    combined_.add(back_);
+    return combined_;
 }
 
 void DoubleBufferedDirtyTracker::clear_all() {
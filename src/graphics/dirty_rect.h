@@ -43,8 +43,20 @@ struct Rect {
 // Dirty Rectangle Tracker
 //=============================================================================
 
+// Dirty regions are recorded in a coverage bitmap of TILE_SIZE screen
+// tiles, so marking is O(tiles touched) and overlapping marks cost
+// nothing extra. Rects are built on demand: runs of dirty tiles per
+// tile row, then rows with identical runs stacked into one rect. If
+// the rects would cost more to redraw than the whole screen, the
+// tracker reports a full redraw instead.
 class DirtyRectTracker {
 public:
+    static const int TILE_SHIFT = 4;
+    static const int TILE_SIZE = 1 << TILE_SHIFT;   // 16x16 pixel tiles
+
+    // Per-rect cost, in pixels, charged for setup when weighing a full redraw
+    static const int RECT_OVERHEAD_PIXELS = 1024;
+
     DirtyRectTracker(int screen_width, int screen_height);
 
     // Mark region as dirty
@@ -54,39 +66,58 @@ public:
     // Mark entire screen dirty
     void mark_all_dirty();
 
+    // Add another tracker's dirty area (same screen size)
+    void add(const DirtyRectTracker& other);
+
     // Clear dirty regions (call after rendering)
     void clear();
 
-    // Get optimized dirty rectangles for rendering
-    const std::vector<Rect>& get_dirty_rects() const { return merged_rects_; }
+    // Get optimized dirty rectangles for rendering (tile aligned, clipped)
+    const std::vector<Rect>& get_dirty_rects() const;
 
     // Check if anything is dirty
-    bool has_dirty_rects() const { return !dirty_rects_.empty(); }
+    bool has_dirty_rects() const { return full_redraw_ || dirty_tiles_ > 0; }
 
-    // Check if using full redraw (optimization for many dirty rects)
-    bool is_full_redraw() const { return full_redraw_; }
+    // Check if using full redraw (explicit, or cheaper than the rects)
+    bool is_full_redraw() const;
 
-    // Optimization settings
-    void set_merge_threshold(float threshold) { merge_threshold_ = threshold; }
-    void set_max_rects(int max) { max_rects_ = max; }
+    // Full redraw once rect cost exceeds this fraction of the screen
+    void set_merge_threshold(float threshold);
+    // Full redraw once more than this many rects would be produced
+    void set_max_rects(int max);
 
     // Statistics
-    int get_dirty_rect_count() const { return static_cast<int>(dirty_rects_.size()); }
-    int get_merged_rect_count() const { return static_cast<int>(merged_rects_.size()); }
+    int get_dirty_rect_count() const { return mark_count_; }
+    int get_merged_rect_count() const { return static_cast<int>(get_dirty_rects().size()); }
     int get_dirty_pixel_count() const;
+    int get_dirty_tile_count() const { return dirty_tiles_; }
+
+    int get_width() const { return screen_width_; }
+    int get_height() const { return screen_height_; }
 
 private:
-    void merge_rects();
-    void optimize_rects();
+    void mark_tiles(int tx0, int ty0, int tx1, int ty1);
+    void build_rects() const;
 
     int screen_width_;
     int screen_height_;
-    std::vector<Rect> dirty_rects_;
-    std::vector<Rect> merged_rects_;
+    int tiles_x_;
+    int tiles_y_;
+    int words_per_row_;
+    std::vector<uint64_t> tiles_;     // One bit per tile, rows of words_per_row_
+    int dirty_tiles_ = 0;
+    int mark_count_ = 0;
     bool full_redraw_ = false;
 
     float merge_threshold_ = 0.5f;
-    int max_rects_ = 20;
+    int max_rects_ = 128;
+
+    // Built lazily from the bitmap
+    mutable std::vector<Rect> merged_rects_;
+    mutable std::vector<Rect> open_rects_;     // Scratch: rects still growing down (tiles)
+    mutable std::vector<Rect> next_rects_;
+    mutable bool rects_valid_ = true;
+    mutable bool cost_full_redraw_ = false;
 };
 
 //=============================================================================
@@ -107,12 +138,18 @@ public:
     // Get rects that need redrawing (union of both buffers for double-buffering)
     std::vector<Rect> get_redraw_rects() const;
 
+    // Full redraw needed for either buffer
+    bool is_full_redraw() const;
+
     // Clear both buffers (e.g., on resize)
     void clear_all();
 
 private:
+    const DirtyRectTracker& combine() const;
+
     DirtyRectTracker front_;  // Current frame
     DirtyRectTracker back_;   // Previous frame
+    mutable DirtyRectTracker combined_;
 };
 
 #endif // DIRTY_RECT_H
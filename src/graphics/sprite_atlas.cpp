@@ -0,0 +1,168 @@
+// src/graphics/sprite_atlas.cpp
+// 8-bit Indexed Texture Atlas Implementation
+// Task 18h - Performance Optimization
+
+#include "graphics/sprite_atlas.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/tile_renderer.h"
+#include <cstring>
+
+//=============================================================================
+// SpriteAtlas Implementation
+//=============================================================================
+
+SpriteAtlas::SpriteAtlas(int page_size)
+    : page_size_(page_size > 0 ? page_size : DEFAULT_PAGE_SIZE) {}
+
+bool SpriteAtlas::add_image(const uint8_t* pixels, int width, int height, int pitch,
+                            AtlasRegion& out) {
+    if (width <= 0 || height <= 0) {
+        out = make_region(0, 0, 0, 0, 0);
+        return true;
+    }
+
+    uint32_t page;
+    int x, y;
+    if (!allocate(width, height, page, x, y)) {
+        return false;
+    }
+
+    uint8_t* dst = pages_[page].pixels.data() + static_cast<size_t>(y) * page_size_ + x;
+    if (pixels) {
+        for (int row = 0; row < height; row++) {
+            memcpy(dst + static_cast<size_t>(row) * page_size_,
+                   pixels + static_cast<size_t>(row) * pitch, width);
+        }
+    }
+
+    used_pixels_ += static_cast<size_t>(width) * height;
+    out = make_region(page, x, y, width, height);
+    return true;
+}
+
+int SpriteAtlas::add_shape(ShapeRenderer& shape, std::vector<AtlasRegion>& out) {
+    int added = 0;
+    std::vector<uint8_t> scratch;
+
+    for (int frame = 0; frame < shape.GetFrameCount(); frame++) {
+        int w = 0, h = 0;
+        int ox = 0, oy = 0;
+        AtlasRegion region = make_region(0, 0, 0, 0, 0);
+
+        if (shape.GetFrameSize(frame, &w, &h) && w > 0 && h > 0 &&
+            w <= page_size_ && h <= page_size_) {
+            uint32_t page;
+            int x, y;
+            if (allocate(w, h, page, x, y)) {
+                // Decode straight into the page
+                uint8_t* dst = pages_[page].pixels.data() +
+                               static_cast<size_t>(y) * page_size_ + x;
+                if (shape.CopyFramePixels(frame, dst, page_size_)) {
+                    used_pixels_ += static_cast<size_t>(w) * h;
+                    region = make_region(page, x, y, w, h);
+                }
+            }
+        }
+
+        shape.GetFrameOffset(frame, &ox, &oy);
+        region.x_offset = ox;
+        region.y_offset = oy;
+        out.push_back(region);
+        added++;
+    }
+
+    return added;
+}
+
+int SpriteAtlas::add_template(const TemplateData& tmpl, std::vector<AtlasRegion>& out) {
+    int added = 0;
+    for (int i = 0; i < tmpl.tile_count; i++) {
+        AtlasRegion region;
+        const uint8_t* tile = tmpl.GetTile(i);
+        if (!tile || !add_image(tile, TILE_WIDTH, TILE_HEIGHT, TILE_WIDTH, region)) {
+            region = make_region(0, 0, 0, 0, 0);
+        }
+        out.push_back(region);
+        added++;
+    }
+    return added;
+}
+
+void SpriteAtlas::clear() {
+    pages_.clear();
+    used_pixels_ = 0;
+}
+
+const uint8_t* SpriteAtlas::get_page_pixels(uint32_t page) const {
+    if (page >= pages_.size()) return nullptr;
+    return pages_[page].pixels.data();
+}
+
+double SpriteAtlas::get_occupancy() const {
+    if (pages_.empty()) return 0.0;
+    double total = static_cast<double>(pages_.size()) * page_size_ * page_size_;
+    return used_pixels_ / total;
+}
+
+bool SpriteAtlas::allocate(int width, int height, uint32_t& page, int& x, int& y) {
+    int w = width + PADDING;
+    int h = height + PADDING;
+    if (w > page_size_ || h > page_size_) {
+        return false;
+    }
+
+    // Try the open shelf of each page, then a new shelf below it
+    for (size_t i = 0; i < pages_.size(); i++) {
+        Page& p = pages_[i];
+
+        if (p.cursor_x + w <= page_size_ && p.shelf_y + h <= page_size_ &&
+            (h <= p.shelf_height || p.cursor_x == 0)) {
+            page = static_cast<uint32_t>(i);
+            x = p.cursor_x;
+            y = p.shelf_y;
+            p.cursor_x += w;
+            if (h > p.shelf_height) p.shelf_height = h;
+            return true;
+        }
+
+        int next_shelf = p.shelf_y + p.shelf_height;
+        if (next_shelf + h <= page_size_) {
+            p.shelf_y = next_shelf;
+            p.shelf_height = h;
+            p.cursor_x = w;
+            page = static_cast<uint32_t>(i);
+            x = 0;
+            y = next_shelf;
+            return true;
+        }
+    }
+
+    Page fresh;
+    fresh.pixels.assign(static_cast<size_t>(page_size_) * page_size_, 0);
+    fresh.cursor_x = w;
+    fresh.shelf_height = h;
+    pages_.push_back(std::move(fresh));
+
+    page = static_cast<uint32_t>(pages_.size() - 1);
+    x = 0;
+    y = 0;
+    return true;
+}
+
+AtlasRegion SpriteAtlas::make_region(uint32_t page, int x, int y, int width, int height) const {
+    float scale = 1.0f / page_size_;
+
+    AtlasRegion region;
+    region.page = page;
+    region.x = x;
+    region.y = y;
+    region.width = width;
+    region.height = height;
+    region.x_offset = 0;
+    region.y_offset = 0;
+    region.u0 = x * scale;
+    region.v0 = y * scale;
+    region.u1 = (x + width) * scale;
+    region.v1 = (y + height) * scale;
+    return region;
+}
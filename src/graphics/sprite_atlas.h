@@ -0,0 +1,78 @@
+// src/graphics/sprite_atlas.h
+// 8-bit Indexed Texture Atlas
+// Task 18h - Performance Optimization
+
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class ShapeRenderer;
+struct TemplateData;
+
+//=============================================================================
+// Atlas Region
+//=============================================================================
+
+struct AtlasRegion {
+    uint32_t page;            // Atlas page (used as SpriteInstance::texture_id)
+    int x, y;                 // Pixel rect within the page
+    int width, height;
+    int x_offset, y_offset;   // Draw offset from the sprite origin
+    float u0, v0, u1, v1;     // Normalized rect
+};
+
+//=============================================================================
+// Sprite Atlas
+//=============================================================================
+
+// Packs palette-indexed images into square pages with a shelf packer.
+// Pages keep palette indices (0 = transparent); palette lookup and house
+// remap are applied when the atlas is drawn, so one page serves every
+// house and palette.
+class SpriteAtlas {
+public:
+    static const int DEFAULT_PAGE_SIZE = 1024;
+    static const int PADDING = 1;   // Transparent gutter between regions
+
+    explicit SpriteAtlas(int page_size = DEFAULT_PAGE_SIZE);
+
+    // Add one image; fails only if it is larger than a page
+    bool add_image(const uint8_t* pixels, int width, int height, int pitch,
+                   AtlasRegion& out);
+
+    // Add every frame of a shape (one region per frame, in frame order).
+    // Empty frames get a zero-size region. Returns frames added.
+    int add_shape(ShapeRenderer& shape, std::vector<AtlasRegion>& out);
+
+    // Add every tile of a terrain template. Returns tiles added.
+    int add_template(const TemplateData& tmpl, std::vector<AtlasRegion>& out);
+
+    void clear();
+
+    int get_page_size() const { return page_size_; }
+    int get_page_count() const { return static_cast<int>(pages_.size()); }
+    const uint8_t* get_page_pixels(uint32_t page) const;
+
+    // Fraction of allocated page area holding image pixels
+    double get_occupancy() const;
+
+private:
+    struct Page {
+        std::vector<uint8_t> pixels;
+        int cursor_x = 0;        // Next free column on the open shelf
+        int shelf_y = 0;         // Top of the open shelf
+        int shelf_height = 0;
+    };
+
+    bool allocate(int width, int height, uint32_t& page, int& x, int& y);
+    AtlasRegion make_region(uint32_t page, int x, int y, int width, int height) const;
+
+    int page_size_;
+    std::vector<Page> pages_;
+    std::size_t used_pixels_ = 0;
+};
+
+#endif // SPRITE_ATLAS_H
@@ -3,6 +3,10 @@
 // Task 18h - Performance Optimization
 
 #include "graphics/sprite_batch.h"
+#include "graphics/sprite_atlas.h"
+#include "game/graphics/graphics_buffer.h"
+#include "game/graphics/blit_kernels.h"
+#include "game/graphics/render_sort.h"
 #include "platform/profiler.h"
 #include <algorithm>
 #include <cstring>
@@ -32,7 +36,6 @@ SpriteBatch::SpriteBatch(size_t max_sprites)
 }
 
 SpriteBatch::~SpriteBatch() {
-    // Would release GPU buffers here
 }
 
 void SpriteBatch::begin() {
@@ -95,6 +98,7 @@ void SpriteBatch::draw(uint32_t texture_id, float x, float y, float w, float h,
     sprite.rotation = rotation;
     sprite.texture_id = texture_id;
     sprite.layer = 0;
+    sprite.remap = nullptr;
 
     draw(sprite);
 }
@@ -102,12 +106,26 @@ void SpriteBatch::draw(uint32_t texture_id, float x, float y, float w, float h,
 void SpriteBatch::sort_sprites() {
     PROFILE_SCOPE("SpriteBatch::sort");
 
-    // Sort by texture to minimize state changes, then by layer
-    std::sort(sprites_.begin(), sprites_.end(),
-        [](const SpriteInstance& a, const SpriteInstance& b) {
-            if (a.layer != b.layer) return a.layer < b.layer;
-            return a.texture_id < b.texture_id;
-        });
+    size_t count = sprites_.size();
+    if (count < 2) return;
+
+    // Layer first, then texture to minimize state changes. No Y term:
+    // within a layer, sprites keep submission order per texture.
+    sorter_.Begin(count);
+    for (const SpriteInstance& s : sprites_) {
+        sorter_.Add(Make_Render_Sort_Key(s.layer, 0, s.texture_id));
+    }
+
+    const uint32_t* order = sorter_.Sort();
+    if (sorter_.Get_Last_Path() == RenderSorter::SORT_PATH_ORDERED) {
+        return;
+    }
+
+    sorted_sprites_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        sorted_sprites_[i] = sprites_[order[i]];
+    }
+    sprites_.swap(sorted_sprites_);
 }
 
 void SpriteBatch::build_batches() {
@@ -200,19 +218,136 @@ void SpriteBatch::flush() {
 
     if (vertices_.empty()) return;
 
-    // Would upload vertices to GPU here
+    // Counted lock; a no-op if the caller already holds one
+    bool locked = target_ && target_->Lock();
 
     for (const Batch& batch : batches_) {
         render_batch(batch);
     }
+
+    if (locked) {
+        target_->Unlock();
+    }
 }
 
 void SpriteBatch::render_batch(const Batch& batch) {
-    // Would bind texture and issue draw call here
+    // One draw call per atlas page
     draw_calls_++;
     PROFILE_COUNTER("DrawCalls");
 
-    (void)batch;  // Suppress unused warning in stub
+    if (!target_ || !atlas_ || !target_->Get_Buffer()) return;
+
+    const uint8_t* page = atlas_->get_page_pixels(batch.texture_id);
+    if (!page) return;
+
+    int page_size = atlas_->get_page_size();
+    int first = batch.start_index / 6;
+    int last = first + batch.count / 6;
+    for (int i = first; i < last; i++) {
+        const SpriteInstance& sprite = sprites_[i];
+        if (sprite.rotation != 0.0f) {
+            render_rotated(sprite, page, page_size);
+        } else {
+            render_sprite(sprite, page, page_size);
+        }
+    }
+}
+
+// Axis-aligned quad: row kernels, nearest-neighbor when scaled
+void SpriteBatch::render_sprite(const SpriteInstance& s, const uint8_t* page, int page_size) {
+    int sx = static_cast<int>(s.u0 * page_size + 0.5f);
+    int sy = static_cast<int>(s.v0 * page_size + 0.5f);
+    int sw = static_cast<int>(s.u1 * page_size + 0.5f) - sx;
+    int sh = static_cast<int>(s.v1 * page_size + 0.5f) - sy;
+    int dx = static_cast<int>(std::floor(s.x));
+    int dy = static_cast<int>(std::floor(s.y));
+    int dw = static_cast<int>(s.width + 0.5f);
+    int dh = static_cast<int>(s.height + 0.5f);
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0) return;
+
+    // Clip destination to the target
+    int x0 = std::max(dx, 0);
+    int y0 = std::max(dy, 0);
+    int x1 = std::min(dx + dw, target_->Get_Width());
+    int y1 = std::min(dy + dh, target_->Get_Height());
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const BlitKernels& k = GetBlitKernels();
+    uint8_t* dst_base = target_->Get_Buffer();
+    int pitch = target_->Get_Pitch();
+    int count = x1 - x0;
+    bool scaled_x = (dw != sw);
+
+    if (scaled_x && static_cast<int>(scaled_row_.size()) < count) {
+        scaled_row_.resize(count);
+    }
+
+    for (int y = y0; y < y1; y++) {
+        int src_row_index = sy + static_cast<int>(static_cast<int64_t>(y - dy) * sh / dh);
+        const uint8_t* src_row = page + static_cast<size_t>(src_row_index) * page_size + sx;
+        const uint8_t* src;
+
+        if (scaled_x) {
+            for (int x = x0; x < x1; x++) {
+                scaled_row_[x - x0] = src_row[static_cast<int64_t>(x - dx) * sw / dw];
+            }
+            src = scaled_row_.data();
+        } else {
+            src = src_row + (x0 - dx);
+        }
+
+        uint8_t* dst = dst_base + static_cast<size_t>(y) * pitch + x0;
+        if (s.remap) {
+            k.copy_remap_trans(dst, src, count, s.remap, 0);
+        } else {
+            k.copy_trans(dst, src, count, 0);
+        }
+    }
+}
+
+// Rotated quad: inverse-map each pixel of the rotated bounding box
+void SpriteBatch::render_rotated(const SpriteInstance& s, const uint8_t* page, int page_size) {
+    float su0 = s.u0 * page_size;
+    float sv0 = s.v0 * page_size;
+    float su = (s.u1 - s.u0) * page_size;
+    float sv = (s.v1 - s.v0) * page_size;
+    if (s.width <= 0.0f || s.height <= 0.0f) return;
+
+    float cx = s.x + s.width * 0.5f;
+    float cy = s.y + s.height * 0.5f;
+    float cos_r = std::cos(s.rotation);
+    float sin_r = std::sin(s.rotation);
+
+    // Bounding box of the rotated quad
+    float ex = std::fabs(s.width * 0.5f * cos_r) + std::fabs(s.height * 0.5f * sin_r);
+    float ey = std::fabs(s.width * 0.5f * sin_r) + std::fabs(s.height * 0.5f * cos_r);
+    int x0 = std::max(static_cast<int>(std::floor(cx - ex)), 0);
+    int y0 = std::max(static_cast<int>(std::floor(cy - ey)), 0);
+    int x1 = std::min(static_cast<int>(std::ceil(cx + ex)), target_->Get_Width());
+    int y1 = std::min(static_cast<int>(std::ceil(cy + ey)), target_->Get_Height());
+
+    uint8_t* dst_base = target_->Get_Buffer();
+    int pitch = target_->Get_Pitch();
+
+    for (int y = y0; y < y1; y++) {
+        uint8_t* dst = dst_base + static_cast<size_t>(y) * pitch;
+        float ry = y + 0.5f - cy;
+        for (int x = x0; x < x1; x++) {
+            float rx = x + 0.5f - cx;
+
+            // Rotate back into quad space (0..1)
+            float qx = (rx * cos_r + ry * sin_r) / s.width + 0.5f;
+            float qy = (-rx * sin_r + ry * cos_r) / s.height + 0.5f;
+            if (qx < 0.0f || qx >= 1.0f || qy < 0.0f || qy >= 1.0f) continue;
+
+            int tx = static_cast<int>(su0 + qx * su);
+            int ty = static_cast<int>(sv0 + qy * sv);
+            uint8_t pixel = page[static_cast<size_t>(ty) * page_size + tx];
+            if (pixel != 0) {
+                dst[x] = s.remap ? s.remap[pixel] : pixel;
+            }
+        }
+    }
 }
 
 //=============================================================================
@@ -253,6 +388,7 @@ void BatchRenderer::draw_sprite(uint32_t texture_id, float x, float y, float w,
     sprite.color = 0xFFFFFFFF;
     sprite.rotation = 0.0f;
     sprite.layer = current_layer_;
+    sprite.remap = nullptr;
     batch_.draw(sprite);
 }
 
@@ -271,6 +407,7 @@ void BatchRenderer::draw_sprite_rotated(uint32_t texture_id, float x, float y,
     sprite.color = 0xFFFFFFFF;
     sprite.rotation = rotation;
     sprite.layer = current_layer_;
+    sprite.remap = nullptr;
     batch_.draw(sprite);
 }
 
@@ -289,6 +426,28 @@ void BatchRenderer::draw_sprite_tinted(uint32_t texture_id, float x, float y,
     sprite.color = color;
     sprite.rotation = 0.0f;
     sprite.layer = current_layer_;
+    sprite.remap = nullptr;
+    batch_.draw(sprite);
+}
+
+void BatchRenderer::draw_region(const AtlasRegion& region, float x, float y,
+                                const uint8_t* remap) {
+    if (region.width <= 0 || region.height <= 0) return;
+
+    SpriteInstance sprite;
+    sprite.texture_id = region.page;
+    sprite.x = x + region.x_offset;
+    sprite.y = y + region.y_offset;
+    sprite.width = static_cast<float>(region.width);
+    sprite.height = static_cast<float>(region.height);
+    sprite.u0 = region.u0;
+    sprite.v0 = region.v0;
+    sprite.u1 = region.u1;
+    sprite.v1 = region.v1;
+    sprite.color = 0xFFFFFFFF;
+    sprite.rotation = 0.0f;
+    sprite.layer = current_layer_;
+    sprite.remap = remap;
     batch_.draw(sprite);
 }
 
@@ -5,9 +5,15 @@
 #ifndef SPRITE_BATCH_H
 #define SPRITE_BATCH_H
 
+#include "game/graphics/render_sort.h"
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
+class GraphicsBuffer;
+class SpriteAtlas;
+struct AtlasRegion;
+
 //=============================================================================
 // Sprite Vertex
 //=============================================================================
@@ -28,8 +34,9 @@ struct SpriteInstance {
     float u0, v0, u1, v1; // Texture rect (normalized)
     uint32_t color;       // Tint color
     float rotation;       // Rotation in radians
-    uint32_t texture_id;  // Texture to use
+    uint32_t texture_id;  // Texture to use (atlas page)
     int layer;            // Sort layer (higher = on top)
+    const uint8_t* remap = nullptr;  // Optional 256-entry palette remap (house colors)
 };
 
 //=============================================================================
@@ -56,9 +63,17 @@ public:
               float u0, float v0, float u1, float v1,
               uint32_t color, float rotation);
 
-    // Flush current batch to GPU
+    // Flush current batch to the render target
     void flush();
 
+    // Render backend: atlas pages are drawn into an 8-bit target, with the
+    // palette applied later by the platform flip. Without both, batches
+    // are built and counted but nothing is drawn.
+    void set_target(GraphicsBuffer* target) { target_ = target; }
+    void set_atlas(const SpriteAtlas* atlas) { atlas_ = atlas; }
+    GraphicsBuffer* get_target() const { return target_; }
+    const SpriteAtlas* get_atlas() const { return atlas_; }
+
     // Statistics
     int get_draw_calls() const { return draw_calls_; }
     int get_sprite_count() const { return sprite_count_; }
@@ -77,8 +92,12 @@ private:
     void sort_sprites();
     void build_batches();
     void render_batch(const Batch& batch);
+    void render_sprite(const SpriteInstance& sprite, const uint8_t* page, int page_size);
+    void render_rotated(const SpriteInstance& sprite, const uint8_t* page, int page_size);
 
     std::vector<SpriteInstance> sprites_;
+    std::vector<SpriteInstance> sorted_sprites_;   // Scratch for sort_sprites
+    RenderSorter sorter_;
     std::vector<SpriteVertex> vertices_;
     std::vector<uint16_t> indices_;
     std::vector<Batch> batches_;
@@ -92,9 +111,10 @@ private:
     int sprite_count_ = 0;
     int batch_count_ = 0;
 
-    // GPU resources (would be Metal buffers)
-    void* vertex_buffer_ = nullptr;
-    void* index_buffer_ = nullptr;
+    // Render backend
+    GraphicsBuffer* target_ = nullptr;
+    const SpriteAtlas* atlas_ = nullptr;
+    std::vector<uint8_t> scaled_row_;   // Nearest-neighbor scratch row
 };
 
 //=============================================================================
@@ -119,6 +139,14 @@ public:
     void draw_sprite_tinted(uint32_t texture_id, float x, float y, float w, float h,
                             uint32_t color);
 
+    // Draw an atlas region at its natural size (offset applied), optionally remapped
+    void draw_region(const AtlasRegion& region, float x, float y,
+                     const uint8_t* remap = nullptr);
+
+    // Render backend (see SpriteBatch)
+    void set_target(GraphicsBuffer* target) { batch_.set_target(target); }
+    void set_atlas(const SpriteAtlas* atlas) { batch_.set_atlas(atlas); }
+
     // Frame statistics
     int get_total_sprites() const;
     int get_total_draw_calls() const;
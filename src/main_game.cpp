@@ -35,13 +35,31 @@ static void Show_Help() {
     printf("Usage: RedAlertGame [options]\n");
     printf("\n");
     printf("Options:\n");
-    printf("  --help, -h     Show this help message\n");
-    printf("  --test         Run integration tests\n");
+    printf("  --help, -h        Show this help message\n");
+    printf("  --test            Run integration tests\n");
+    printf("  --record FILE     Record a replay of the session to FILE\n");
+    printf("  --replay FILE     Play FILE headless and report ticks/sec\n");
+    printf("  --no-large-pages  Keep screen and map buffers off 2 MB pages\n");
+    printf("  --lock-memory     Pin screen and map buffers in RAM (mlock)\n");
+    printf("  --cache-limit MB  Cap the memory held by asset caches\n");
+    printf("  --no-power-saver  Draw every frame at full rate, even on the static menu\n");
+    printf("                    or with the window in the background\n");
+    printf("  --gpu-palette     Look palette colors up on the GPU (OpenGL 2.1)\n");
+    printf("  --resolution WxH  Internal resolution, e.g. 1920x1080 (default 640x400)\n");
+    printf("  --startup-report FILE\n");
+    printf("                    Log time spent per startup phase and save it to FILE\n");
+    printf("                    as a Chrome trace\n");
+    printf("  --sample-profile FILE\n");
+    printf("                    Sample the main thread's call stacks and save them to\n");
+    printf("                    FILE as folded stacks (for flame graphs) on exit\n");
+    printf("  --sample-rate HZ  Samples per second for --sample-profile (default 1000)\n");
+    printf("  --capture FILE    Record every drawn frame to FILE (8-bit, compressed)\n");
     printf("\n");
     printf("In-game controls:\n");
     printf("  Arrow keys     - Scroll map\n");
     printf("  F5/F6          - Change game speed\n");
     printf("  ESC            - Pause / Quit\n");
+    printf("  F12            - Start / stop the sampling profiler\n");
     printf("  Enter          - Start game (from menu)\n");
     printf("\n");
 }
@@ -112,8 +130,19 @@ static int Run_Tests() {
         failed++;
     }
 
-    // Test 7: Render a frame
-    printf("Test 7: Render frame... ");
+    // Test 7: Deferred startup
+    printf("Test 7: Deferred startup... ");
+    game.Finish_Startup();
+    if (game.Is_Startup_Complete() && game.Get_Mode() == GAME_MODE_MENU) {
+        printf("PASSED\n");
+        passed++;
+    } else {
+        printf("FAILED\n");
+        failed++;
+    }
+
+    // Test 8: Render a frame
+    printf("Test 8: Render frame... ");
     if (game.Get_Display()) {
         game.Get_Display()->Lock();
         game.Get_Display()->Clear(0);
@@ -127,8 +156,8 @@ static int Run_Tests() {
         failed++;
     }
 
-    // Test 8: Shutdown
-    printf("Test 8: Game shutdown... ");
+    // Test 9: Shutdown
+    printf("Test 9: Game shutdown... ");
     game.Shutdown();
     printf("PASSED\n");
     passed++;
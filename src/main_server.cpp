@@ -0,0 +1,135 @@
+/**
+ * Red Alert Server - Headless Relay Entry Point
+ *
+ * Hosts lockstep matches without graphics, audio or input: the platform
+ * layer is never initialized (that brings up SDL), only networking.
+ */
+
+#include "game/relay.h"
+#include "platform.h"
+#include "platform/log.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void Handle_Signal(int) {
+    g_stop = 1;
+}
+
+/**
+ * Server options
+ */
+struct ServerArgs {
+    int port = 5555;
+    int matches = 16;
+    int players = 8;
+    int stats_seconds = 60;
+    bool show_help = false;
+};
+
+/**
+ * Parse command line arguments
+ */
+static void Parse_Args(int argc, char* argv[], ServerArgs* args) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            args->show_help = true;
+        }
+        else if (strcmp(argv[i], "--port") == 0 && has_value) {
+            args->port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--matches") == 0 && has_value) {
+            args->matches = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--players") == 0 && has_value) {
+            args->players = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && has_value) {
+            args->stats_seconds = atoi(argv[++i]);
+        }
+    }
+}
+
+/**
+ * Show help message
+ */
+static void Show_Help() {
+    printf("Red Alert - Dedicated Relay Server\n");
+    printf("\n");
+    printf("Usage: RedAlertServer [options]\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --help, -h        Show this help message\n");
+    printf("  --port PORT       First match's port (default 5555)\n");
+    printf("  --matches N       Matches to host, one port each (default 16)\n");
+    printf("  --players N       Players per match (default 8)\n");
+    printf("  --stats SECONDS   Log traffic this often, 0 for never (default 60)\n");
+    printf("\n");
+}
+
+/**
+ * Main entry point
+ */
+int main(int argc, char* argv[]) {
+    ServerArgs args;
+    Parse_Args(argc, argv, &args);
+
+    if (args.show_help) {
+        Show_Help();
+        return 0;
+    }
+    if (args.port <= 0 || args.port > 65535 || args.matches <= 0 || args.players <= 0 ||
+        args.port + args.matches - 1 > 65535) {
+        fprintf(stderr, "RedAlertServer: Invalid port, match or player count\n");
+        return 1;
+    }
+
+    Platform_Log_Init();
+    // Per-peer logging must not hold up the service loop on a slow disk
+    Platform_Log_SetAsync(1);
+    if (Platform_Network_Init() == -2) {
+        Platform_LogError("RedAlertServer: Network initialization failed");
+        return 1;
+    }
+
+    RelayServer server;
+    int opened = server.Start(static_cast<uint16_t>(args.port), args.matches, args.players);
+    if (opened == 0) {
+        Platform_LogError("RedAlertServer: No match could be opened");
+        Platform_Network_Shutdown();
+        return 1;
+    }
+
+    LOG_INFO("RedAlertServer: Relaying %d matches of %d players from port %d",
+             opened, args.players, args.port);
+
+    std::signal(SIGINT, Handle_Signal);
+    std::signal(SIGTERM, Handle_Signal);
+
+    double next_stats = Platform_Timer_GetTime() + args.stats_seconds;
+    while (!g_stop) {
+        // Nothing came in: yield rather than spin
+        if (server.Service() == 0) {
+            Platform_Timer_Delay(1);
+        }
+
+        if (args.stats_seconds > 0 && Platform_Timer_GetTime() >= next_stats) {
+            RelayStats stats = server.Get_Stats();
+            LOG_INFO("RedAlertServer: %u/%u matches active, %u peers, %llu KB in, %llu KB out",
+                     stats.active_matches, stats.matches, stats.peers,
+                     static_cast<unsigned long long>(stats.bytes_in / 1024),
+                     static_cast<unsigned long long>(stats.bytes_out / 1024));
+            next_stats += args.stats_seconds;
+        }
+    }
+
+    Platform_LogInfo("RedAlertServer: Shutting down");
+    server.Stop();
+    Platform_Network_Shutdown();
+    Platform_Log_Shutdown();
+    return 0;
+}
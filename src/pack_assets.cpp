@@ -0,0 +1,217 @@
+/**
+ * @file pack_assets.cpp
+ * @brief Build the pre-decoded asset pack
+ *
+ * Decodes shapes, theater tiles and sounds out of the MIX archives once
+ * and writes them as an AssetPack, which the game maps at startup in
+ * place of decoding (see game/asset_pack.h).
+ *
+ * Usage:
+ *   PackAssets <gamedata_dir> [out.pak] [names.txt]
+ *
+ * By default the pack is written to <gamedata_dir>/ASSETS.PAK.
+ * names.txt adds further files, one per line: .SHP as shapes, .AUD as
+ * audio. Music is left out; decoded scores would be hundreds of MB and
+ * the player streams them one at a time anyway.
+ */
+
+#include "game/asset_pack.h"
+#include "game/audio/aud_file.h"
+#include "game/audio/sound_effect.h"
+#include "game/audio/voice_event.h"
+#include "game/game.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/graphics/tile_renderer.h"
+#include "game/types/buildingtype.h"
+#include "game/types/unittype.h"
+#include "platform.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct PackStats {
+    int shapes = 0;
+    int atlases = 0;
+    int sounds = 0;
+    int missing = 0;
+};
+
+bool Has_Extension(const std::string& name, const char* ext) {
+    size_t length = strlen(ext);
+    if (name.size() < length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (toupper(static_cast<unsigned char>(name[name.size() - length + i])) != ext[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Pack_Shape(AssetPackWriter& writer, const char* filename, PackStats& stats) {
+    if (!filename || !filename[0] || writer.Has(filename, ASSET_PACK_SHAPE)) {
+        return;
+    }
+
+    ShapeRenderer shape;
+    if (!shape.Load(filename)) {
+        stats.missing++;
+        return;
+    }
+    if (writer.AddShape(filename, shape)) {
+        stats.shapes++;
+    }
+}
+
+// Shape named by a type class (without extension)
+void Pack_Type_Shape(AssetPackWriter& writer, const char* shape_name, PackStats& stats) {
+    if (!shape_name || !shape_name[0]) {
+        return;
+    }
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%s.SHP", shape_name);
+    Pack_Shape(writer, filename, stats);
+}
+
+void Pack_Audio(AssetPackWriter& writer, const char* filename, PackStats& stats) {
+    if (!filename || !filename[0] || writer.Has(filename, ASSET_PACK_AUDIO)) {
+        return;
+    }
+
+    AudFile aud;
+    if (!aud.LoadFromMix(filename)) {
+        stats.missing++;
+        return;
+    }
+    if (writer.AddAudio(filename, aud)) {
+        stats.sounds++;
+    }
+}
+
+void Pack_Theaters(AssetPackWriter& writer, PackStats& stats) {
+    TileRenderer& tiles = TileRenderer::Instance();
+
+    for (int t = 0; t < THEATER_COUNT; t++) {
+        TheaterType theater = static_cast<TheaterType>(t);
+        if (!tiles.SetTheater(theater)) {
+            continue;
+        }
+        tiles.PreloadAllTemplates();
+
+        std::vector<std::string> names;
+        std::vector<const TemplateData*> templates;
+        for (int i = 0; i < TEMPLATE_COUNT; i++) {
+            TemplateType tmpl = static_cast<TemplateType>(i);
+            const TemplateData* data = tiles.GetTemplate(tmpl);
+            if (data) {
+                names.push_back(tiles.GetTemplateFilename(tmpl));
+                templates.push_back(data);
+            }
+        }
+
+        std::string atlas = TileRenderer::GetPackedAtlasName(theater);
+        if (writer.AddAtlas(atlas.c_str(), names, templates, TILE_SIZE)) {
+            stats.atlases++;
+            printf("  %s: %d templates\n", atlas.c_str(), static_cast<int>(templates.size()));
+        } else {
+            stats.missing++;
+        }
+    }
+    tiles.ClearCache();
+}
+
+void Pack_Sounds(AssetPackWriter& writer, PackStats& stats) {
+    for (int i = 1; i < static_cast<int>(SoundEffect::COUNT); i++) {
+        Pack_Audio(writer, GetSoundFilename(static_cast<SoundEffect>(i)), stats);
+    }
+
+    for (int i = 1; i < static_cast<int>(EvaVoice::COUNT); i++) {
+        Pack_Audio(writer, GetEvaVoiceFilename(static_cast<EvaVoice>(i)), stats);
+    }
+
+    // Faction variants share files in places; repeats are skipped
+    const VoiceFaction factions[] = { VoiceFaction::NEUTRAL, VoiceFaction::ALLIED, VoiceFaction::SOVIET };
+    for (int i = 1; i < static_cast<int>(UnitVoice::COUNT); i++) {
+        for (VoiceFaction faction : factions) {
+            Pack_Audio(writer, GetUnitVoiceFilename(static_cast<UnitVoice>(i), faction), stats);
+        }
+    }
+}
+
+void Pack_Name_List(AssetPackWriter& writer, const char* path, PackStats& stats) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char name[64];
+        if (line[0] == '#' || sscanf(line, "%63s", name) != 1) {
+            continue;
+        }
+        if (Has_Extension(name, ".SHP")) {
+            Pack_Shape(writer, name, stats);
+        } else if (Has_Extension(name, ".AUD")) {
+            Pack_Audio(writer, name, stats);
+        } else {
+            fprintf(stderr, "Skipping %s (not .SHP or .AUD)\n", name);
+        }
+    }
+    fclose(file);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <gamedata_dir> [out.pak] [names.txt]\n", argv[0]);
+        return 1;
+    }
+
+    const char* data_path = argv[1];
+    std::string out_path = argc > 2 ? argv[2] : std::string(data_path) + "/" + ASSET_PACK_FILENAME;
+
+    Platform_Assets_Init();
+    if (Game_Register_Mix_Files(data_path) == 0) {
+        fprintf(stderr, "No MIX files found in %s\n", data_path);
+        return 1;
+    }
+
+    AssetPackWriter writer;
+    PackStats stats;
+
+    printf("Packing theaters...\n");
+    Pack_Theaters(writer, stats);
+
+    printf("Packing unit and building shapes...\n");
+    for (int i = 0; i < UNIT_COUNT; i++) {
+        Pack_Type_Shape(writer, UnitTypes[i].Get_Shape_Name(), stats);
+    }
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        Pack_Type_Shape(writer, BuildingTypes[i].Get_Shape_Name(), stats);
+    }
+
+    printf("Packing sounds and voices...\n");
+    Pack_Sounds(writer, stats);
+
+    if (argc > 3) {
+        printf("Packing %s...\n", argv[3]);
+        Pack_Name_List(writer, argv[3], stats);
+    }
+
+    if (!writer.Write(out_path.c_str())) {
+        fprintf(stderr, "Failed to write %s\n", out_path.c_str());
+        return 1;
+    }
+
+    printf("Wrote %s: %d shapes, %d atlases, %d sounds (%d not found)\n",
+           out_path.c_str(), stats.shapes, stats.atlases, stats.sounds, stats.missing);
+    return 0;
+}
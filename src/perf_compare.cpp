@@ -0,0 +1,139 @@
+/**
+ * @file perf_compare.cpp
+ * @brief Compare benchmark results with recorded baselines
+ *
+ * Reads the JSON that PerformanceTests --json and RedAlertBench --json
+ * write, and compares each metric with the baseline recorded for the same
+ * host fingerprint (see test/perf_baseline.h). A metric regressed when the
+ * bootstrap interval of its change in median lies wholly on the worse side
+ * and the change exceeds the threshold; each regression is filed as a
+ * PERFORMANCE bug through RegressionTracker.
+ *
+ * Usage:
+ *   PerfCompare --baseline FILE [--update] [--bugs FILE]
+ *               [--threshold PCT] [--confidence PCT] RESULT.json...
+ *
+ * --update records the results as the new baseline for their host instead
+ * of failing on regressions. --bugs loads and saves the bug registry so
+ * regressions stay tracked between runs.
+ *
+ * Exit status is 1 if anything regressed (without --update), 2 on bad
+ * arguments or unreadable files.
+ */
+
+#include "test/bug_tracker.h"
+#include "test/perf_baseline.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CompareArgs {
+    std::string baseline_path;
+    std::string bugs_path;
+    bool update = false;
+    PerfCompareOptions options;
+    std::vector<std::string> results;
+};
+
+bool Parse_Args(int argc, char* argv[], CompareArgs& args) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--baseline") == 0 && has_value) {
+            args.baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--bugs") == 0 && has_value) {
+            args.bugs_path = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            args.update = true;
+        } else if (strcmp(argv[i], "--threshold") == 0 && has_value) {
+            args.options.threshold = atof(argv[++i]) / 100.0;
+        } else if (strcmp(argv[i], "--confidence") == 0 && has_value) {
+            args.options.confidence = atof(argv[++i]) / 100.0;
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else {
+            args.results.push_back(argv[i]);
+        }
+    }
+    return !args.baseline_path.empty() && !args.results.empty() &&
+           args.options.confidence > 0.0 && args.options.confidence < 1.0;
+}
+
+void Print_Comparison(const PerfComparison& cmp) {
+    if (cmp.verdict == PerfVerdict::NEW_METRIC || cmp.verdict == PerfVerdict::TOO_FEW_SAMPLES) {
+        printf("  %-48s %s\n", cmp.name.c_str(), verdict_to_string(cmp.verdict));
+        return;
+    }
+    printf("  %-48s %12.3f %12.3f %-4s %+7.1f%% [%+6.1f%%, %+6.1f%%]  %s\n",
+           cmp.name.c_str(), cmp.baseline_median, cmp.current_median, cmp.unit.c_str(),
+           cmp.change * 100.0, cmp.ci_low * 100.0, cmp.ci_high * 100.0,
+           verdict_to_string(cmp.verdict));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    CompareArgs args;
+    if (!Parse_Args(argc, argv, args)) {
+        fprintf(stderr, "Usage: PerfCompare --baseline FILE [--update] [--bugs FILE]\n"
+                        "                   [--threshold PCT] [--confidence PCT] RESULT.json...\n");
+        return 2;
+    }
+
+    // A missing baseline file is an empty one
+    PerfBaseline baseline;
+    baseline.load_from_file(args.baseline_path);
+    if (!args.bugs_path.empty()) {
+        BugRegistry::instance().load_from_file(args.bugs_path);
+    }
+
+    int regressions = 0;
+    for (const std::string& path : args.results) {
+        PerfRun run;
+        if (!run.load_from_file(path)) {
+            fprintf(stderr, "PerfCompare: Could not read %s\n", path.c_str());
+            return 2;
+        }
+
+        printf("%s\n  host: %s\n", path.c_str(), run.host.c_str());
+        const std::vector<PerfSeries>* reference = baseline.get_host(run.host);
+        if (reference == nullptr) {
+            printf("  no baseline for this host (%zu other host(s) recorded)\n",
+                   baseline.get_hosts().size());
+        } else {
+            printf("  %-48s %12s %12s %-4s %8s %18s\n", "metric", "baseline", "current",
+                   "", "change", "confidence");
+            std::vector<PerfComparison> comparisons =
+                Perf_Compare(*reference, run.series, args.options);
+            for (const PerfComparison& cmp : comparisons) {
+                Print_Comparison(cmp);
+            }
+            if (!args.update) {
+                regressions += Perf_Record_Regressions(comparisons, run.host);
+            }
+        }
+
+        if (args.update) {
+            baseline.update(run);
+        }
+        printf("\n");
+    }
+
+    if (args.update) {
+        if (!baseline.save_to_file(args.baseline_path)) {
+            fprintf(stderr, "PerfCompare: Could not write %s\n", args.baseline_path.c_str());
+            return 2;
+        }
+        printf("Baseline updated: %s\n", args.baseline_path.c_str());
+        return 0;
+    }
+
+    printf("%s", RegressionTracker::instance().get_regression_report().c_str());
+    if (regressions > 0 && !args.bugs_path.empty()) {
+        BugRegistry::instance().save_to_file(args.bugs_path);
+    }
+    return regressions > 0 ? 1 : 0;
+}
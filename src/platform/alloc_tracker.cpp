@@ -0,0 +1,187 @@
+// src/platform/alloc_tracker.cpp
+// Heap Allocation Tracking Implementation
+// Task 18h - Performance Optimization
+
+#include "platform/alloc_tracker.h"
+#include "platform/profiler.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Calling thread's tag stack. Plain data, so it needs no construction and
+// is safe to touch from inside operator new.
+static thread_local AllocTag t_tags[AllocTracker::MAX_TAG_DEPTH];
+static thread_local int t_tag_depth = 0;
+
+//=============================================================================
+// AllocTracker Implementation
+//=============================================================================
+
+AllocTracker& AllocTracker::instance() {
+    static AllocTracker instance;
+    return instance;
+}
+
+void AllocTracker::push_tag(AllocTag tag) {
+    if (t_tag_depth < MAX_TAG_DEPTH) {
+        t_tags[t_tag_depth] = tag;
+    }
+    t_tag_depth++;
+}
+
+void AllocTracker::pop_tag() {
+    if (t_tag_depth > 0) {
+        t_tag_depth--;
+    }
+}
+
+AllocTag AllocTracker::current_tag() {
+    if (t_tag_depth == 0) {
+        return AllocTag::UNTAGGED;
+    }
+    int top = t_tag_depth < MAX_TAG_DEPTH ? t_tag_depth : MAX_TAG_DEPTH;
+    return t_tags[top - 1];
+}
+
+AllocCounts AllocTracker::get_counts(AllocTag tag) const {
+    AllocCounts counts;
+    for (int i = 0; i < ThreadShards::MAX_SHARDS; i++) {
+        const Counters& c = shards_.shard(i).tags[static_cast<int>(tag)];
+        counts.allocations += c.allocations.load(std::memory_order_relaxed);
+        counts.frees += c.frees.load(std::memory_order_relaxed);
+        counts.live_bytes += c.live_bytes.load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+uint64_t AllocTracker::get_total_allocations() const {
+    uint64_t total = 0;
+    for (int tag = 0; tag < TAG_COUNT; tag++) {
+        total += get_counts(static_cast<AllocTag>(tag)).allocations;
+    }
+    return total;
+}
+
+uint64_t AllocTracker::get_frame_allocations() const {
+    uint64_t total = 0;
+    for (uint64_t count : frame_allocations_) {
+        total += count;
+    }
+    return total;
+}
+
+void AllocTracker::end_frame() {
+    static const ProfileSampleId ids[TAG_COUNT] = {
+        Profiler::instance().register_sample("Allocs Untagged"),
+        Profiler::instance().register_sample("Allocs Graphics"),
+        Profiler::instance().register_sample("Allocs Audio"),
+        Profiler::instance().register_sample("Allocs Assets"),
+        Profiler::instance().register_sample("Allocs Sim"),
+    };
+
+    for (int i = 0; i < TAG_COUNT; i++) {
+        uint64_t now = get_counts(static_cast<AllocTag>(i)).allocations;
+        frame_allocations_[i] = now - frame_start_[i];
+        frame_start_[i] = now;
+        if (is_enabled()) {
+            Profiler::instance().record_value(ids[i], static_cast<double>(frame_allocations_[i]));
+        }
+    }
+}
+
+const char* AllocTracker::get_tag_name(AllocTag tag) {
+    switch (tag) {
+        case AllocTag::GRAPHICS: return "Graphics";
+        case AllocTag::AUDIO: return "Audio";
+        case AllocTag::ASSETS: return "Assets";
+        case AllocTag::SIM: return "Sim";
+        default: return "Untagged";
+    }
+}
+
+//=============================================================================
+// Global operator new/delete
+//=============================================================================
+
+#if ALLOC_TRACKING_ENABLED
+
+namespace {
+
+// In front of every tracked block; HEADER_SIZE keeps the user pointer at
+// malloc's own alignment
+struct AllocHeader {
+    size_t size;
+    size_t offset;          // From the malloc'd address to the user pointer
+    AllocTag tag;
+};
+
+constexpr size_t HEADER_SIZE = (sizeof(AllocHeader) + alignof(std::max_align_t) - 1) &
+                               ~(alignof(std::max_align_t) - 1);
+
+AllocHeader* header_of(void* ptr) {
+    return reinterpret_cast<AllocHeader*>(static_cast<char*>(ptr) - sizeof(AllocHeader));
+}
+
+void* tracked_alloc(size_t size, size_t alignment) {
+    // malloc's alignment already covers the usual case; over-aligned
+    // requests get room to slide the user pointer up
+    if (alignment < alignof(std::max_align_t)) {
+        alignment = alignof(std::max_align_t);
+    }
+    size_t slack = alignment > alignof(std::max_align_t) ? alignment : 0;
+
+    char* raw = static_cast<char*>(std::malloc(HEADER_SIZE + size + slack));
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    uintptr_t user = (reinterpret_cast<uintptr_t>(raw) + HEADER_SIZE + alignment - 1) &
+                     ~(static_cast<uintptr_t>(alignment) - 1);
+    char* ptr = reinterpret_cast<char*>(user);
+
+    AllocHeader* header = header_of(ptr);
+    header->size = size;
+    header->offset = static_cast<size_t>(ptr - raw);
+    header->tag = AllocTracker::current_tag();
+    AllocTracker::instance().on_allocate(header->tag, size);
+    return ptr;
+}
+
+void tracked_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    AllocHeader* header = header_of(ptr);
+    AllocTracker::instance().on_free(header->tag, header->size);
+    std::free(static_cast<char*>(ptr) - header->offset);
+}
+
+void* tracked_new(size_t size, size_t alignment) {
+    void* ptr = tracked_alloc(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return tracked_new(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return tracked_new(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t align) { return tracked_new(size, static_cast<size_t>(align)); }
+void* operator new[](size_t size, std::align_val_t align) { return tracked_new(size, static_cast<size_t>(align)); }
+
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+
+#endif // ALLOC_TRACKING_ENABLED
@@ -0,0 +1,132 @@
+// src/platform/alloc_tracker.h
+// Heap Allocation Tracking
+// Task 18h - Performance Optimization
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include "platform/thread_shards.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//=============================================================================
+// Tracking Configuration
+//=============================================================================
+
+// Platform_Mem_* only sees Platform_Alloc. With ALLOC_TRACKING_ENABLED the
+// global operator new/delete are replaced (alloc_tracker.cpp) so every C++
+// heap allocation - containers, make_unique, plain new - is counted too,
+// charged to the subsystem on top of the calling thread's tag stack. Each
+// block carries a small header holding its size and tag, so deletes are
+// charged back to the right subsystem even from another thread.
+//
+// On in debug builds like the profiler; define ALLOC_TRACKING_ENABLED to 0
+// or 1 to override. Allocations made inside the Rust platform crate go
+// through its own allocator and are not counted here.
+//
+// The counters are sharded per thread (thread_shards.h): a job worker's
+// allocations touch only its own cache lines, and the readers sum the
+// shards.
+#ifndef ALLOC_TRACKING_ENABLED
+    #ifdef NDEBUG
+        #define ALLOC_TRACKING_ENABLED 0
+    #else
+        #define ALLOC_TRACKING_ENABLED 1
+    #endif
+#endif
+
+enum class AllocTag : uint8_t {
+    UNTAGGED,
+    GRAPHICS,
+    AUDIO,
+    ASSETS,
+    SIM,
+    COUNT
+};
+
+//=============================================================================
+// Allocation Tracker
+//=============================================================================
+
+struct AllocCounts {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    int64_t live_bytes = 0;
+};
+
+class AllocTracker {
+public:
+    static constexpr int TAG_COUNT = static_cast<int>(AllocTag::COUNT);
+    static constexpr int MAX_TAG_DEPTH = 32;
+
+    static AllocTracker& instance();
+
+    // True when operator new/delete are replaced in this build
+    static constexpr bool is_enabled() { return ALLOC_TRACKING_ENABLED != 0; }
+
+    // Calling thread's tag stack (use AllocScope)
+    static void push_tag(AllocTag tag);
+    static void pop_tag();
+    static AllocTag current_tag();
+
+    // Called by the replaced operator new/delete
+    void on_allocate(AllocTag tag, size_t size) {
+        Counters& c = shards_.local().tags[static_cast<int>(tag)];
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+    void on_free(AllocTag tag, size_t size) {
+        Counters& c = shards_.local().tags[static_cast<int>(tag)];
+        c.frees.fetch_add(1, std::memory_order_relaxed);
+        c.live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    // Totals since startup
+    AllocCounts get_counts(AllocTag tag) const;
+    uint64_t get_total_allocations() const;
+
+    // Frame boundary (main thread): works out the allocations each tag made
+    // since the last call and records them as Profiler values
+    // ("Allocs Sim", ...) so they show as counter tracks
+    void end_frame();
+    uint64_t get_frame_allocations(AllocTag tag) const { return frame_allocations_[static_cast<int>(tag)]; }
+    uint64_t get_frame_allocations() const;
+
+    static const char* get_tag_name(AllocTag tag);
+
+private:
+    AllocTracker() = default;
+
+    struct Counters {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<int64_t> live_bytes{0};
+    };
+
+    // One thread's counts; a block may be freed on another thread than
+    // the one that allocated it, so a single shard's live_bytes can go
+    // negative - only the sum means anything
+    struct ThreadCounters {
+        Counters tags[TAG_COUNT];
+    };
+
+    ThreadSharded<ThreadCounters> shards_;
+    uint64_t frame_start_[TAG_COUNT] = {};
+    uint64_t frame_allocations_[TAG_COUNT] = {};
+};
+
+//=============================================================================
+// RAII Tag Scope
+//=============================================================================
+
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag) { AllocTracker::push_tag(tag); }
+    ~AllocScope() { AllocTracker::pop_tag(); }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+#endif // ALLOC_TRACKER_H
@@ -0,0 +1,140 @@
+// src/platform/io_stats.cpp
+// File and MIX Read Accounting Implementation
+// Task 18h - Performance Optimization
+
+#include "platform/io_stats.h"
+#include "platform/profiler.h"
+#include <cstdio>
+#include <sstream>
+
+//=============================================================================
+// IoStats Implementation
+//=============================================================================
+
+IoStats& IoStats::instance() {
+    static IoStats stats;
+    return stats;
+}
+
+PlatformIoStats IoStats::get_tag_stats(IoTag tag) const {
+    PlatformIoStats stats = {};
+    Platform_Io_GetTagStats(static_cast<int32_t>(tag), &stats);
+    return stats;
+}
+
+PlatformIoStats IoStats::get_totals() const {
+    PlatformIoStats stats = {};
+    Platform_Io_GetTotals(&stats);
+    return stats;
+}
+
+void IoStats::reset() {
+    Platform_Io_Reset();
+    for (int i = 0; i < TAG_COUNT; i++) {
+        frame_start_[i] = 0;
+        frame_bytes_[i] = 0;
+    }
+    frame_blocked_start_ns_ = 0;
+}
+
+void IoStats::end_frame() {
+    static const ProfileSampleId ids[TAG_COUNT] = {
+        Profiler::instance().register_sample("IO Bytes Untagged"),
+        Profiler::instance().register_sample("IO Bytes Startup"),
+        Profiler::instance().register_sample("IO Bytes Graphics"),
+        Profiler::instance().register_sample("IO Bytes Audio"),
+        Profiler::instance().register_sample("IO Bytes Assets"),
+        Profiler::instance().register_sample("IO Bytes Scenario"),
+        Profiler::instance().register_sample("IO Bytes Save"),
+    };
+    static const ProfileSampleId blocked_id = Profiler::instance().register_sample("IO Blocked ms");
+
+    for (int i = 0; i < TAG_COUNT; i++) {
+        uint64_t now = get_tag_stats(static_cast<IoTag>(i)).bytes;
+        frame_bytes_[i] = now - frame_start_[i];
+        frame_start_[i] = now;
+        Profiler::instance().record_value(ids[i], static_cast<double>(frame_bytes_[i]));
+    }
+
+    uint64_t blocked_ns = get_totals().blocked_ns;
+    Profiler::instance().record_value(blocked_id, (blocked_ns - frame_blocked_start_ns_) / 1000000.0);
+    frame_blocked_start_ns_ = blocked_ns;
+}
+
+const char* IoStats::get_tag_name(IoTag tag) {
+    switch (tag) {
+        case IoTag::STARTUP: return "Startup";
+        case IoTag::GRAPHICS: return "Graphics";
+        case IoTag::AUDIO: return "Audio";
+        case IoTag::ASSETS: return "Assets";
+        case IoTag::SCENARIO: return "Scenario";
+        case IoTag::SAVE: return "Save";
+        default: return "Untagged";
+    }
+}
+
+//=============================================================================
+// Reports
+//=============================================================================
+
+static void Format_Row(std::ostringstream& out, const char* name, const PlatformIoStats& stats) {
+    char line[320];
+    snprintf(line, sizeof(line), "%-34s %8llu %10.1f %10.2f %8llu %10.1f\n", name,
+             static_cast<unsigned long long>(stats.calls), stats.bytes / 1024.0,
+             stats.blocked_ns / 1000000.0, static_cast<unsigned long long>(stats.repeat_calls),
+             stats.repeat_bytes / 1024.0);
+    out << line;
+}
+
+std::string IoStats::format_report(int max_repeats) const {
+    std::ostringstream out;
+    char line[320];
+    snprintf(line, sizeof(line), "%-34s %8s %10s %10s %8s %10s\n",
+             "Reads by tag", "calls", "KB", "ms", "repeats", "repeat KB");
+    out << line;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        PlatformIoStats stats = get_tag_stats(static_cast<IoTag>(i));
+        if (stats.calls > 0) {
+            Format_Row(out, get_tag_name(static_cast<IoTag>(i)), stats);
+        }
+    }
+    Format_Row(out, "Total", get_totals());
+
+    snprintf(line, sizeof(line), "\n%-34s %8s %10s %10s %8s %10s\n",
+             "Reads by archive", "calls", "KB", "ms", "repeats", "repeat KB");
+    out << line;
+    int32_t sources = Platform_Io_GetSourceCount();
+    for (int32_t i = 0; i < sources; i++) {
+        PlatformIoStats stats = {};
+        char name[260];
+        if (Platform_Io_GetSourceStats(i, &stats, name, sizeof(name)) == 0) {
+            Format_Row(out, name, stats);
+        }
+    }
+
+    int32_t repeats = Platform_Io_GetRepeatCount();
+    if (repeats > 0) {
+        snprintf(line, sizeof(line), "\n%-34s %8s %10s %10s %8s %10s\n",
+                 "Entries read more than once", "calls", "KB", "ms", "repeats", "repeat KB");
+        out << line;
+        for (int32_t i = 0; i < repeats && i < max_repeats; i++) {
+            PlatformIoStats stats = {};
+            char source[260];
+            char entry[260];
+            if (Platform_Io_GetRepeat(i, &stats, source, sizeof(source), entry, sizeof(entry)) == 0) {
+                // Archives by file name only; loose files already carry their path
+                std::string name = source;
+                size_t slash = name.find_last_of("/\\");
+                if (slash != std::string::npos) {
+                    name = name.substr(slash + 1);
+                }
+                name = name == "(files)" ? entry : name + ":" + entry;
+                Format_Row(out, name.c_str(), stats);
+            }
+        }
+        if (repeats > max_repeats) {
+            out << "(" << repeats - max_repeats << " more)\n";
+        }
+    }
+    return out.str();
+}
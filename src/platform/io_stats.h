@@ -0,0 +1,90 @@
+// src/platform/io_stats.h
+// File and MIX Read Accounting
+// Task 18h - Performance Optimization
+
+#ifndef IO_STATS_H
+#define IO_STATS_H
+
+#include "platform.h"
+#include <cstdint>
+#include <string>
+
+//=============================================================================
+// Caller Tags
+//=============================================================================
+
+// The platform layer counts every loose file and MIX read (Platform_File_*,
+// Platform_Mix_* and the shape/palette/PCX loaders behind them) and charges
+// it to the reading thread's tag, the archive it came from and the entry
+// itself; an entry read a second time in one session is a repeat. The tag
+// lives in the Rust layer per thread, so a worker sets its own.
+//
+// Mapped reads (MixView, Platform_File_Map) are counted when mapped, with
+// the entry's size; their time is only the mapping, the disk reads happen
+// later as page faults (see StartupTrace's major_faults).
+enum class IoTag : uint8_t {
+    UNTAGGED,
+    STARTUP,
+    GRAPHICS,
+    AUDIO,
+    ASSETS,
+    SCENARIO,
+    SAVE,
+    COUNT
+};
+
+//=============================================================================
+// I/O Stats
+//=============================================================================
+
+class IoStats {
+public:
+    static constexpr int TAG_COUNT = static_cast<int>(IoTag::COUNT);
+
+    static IoStats& instance();
+
+    PlatformIoStats get_tag_stats(IoTag tag) const;
+    PlatformIoStats get_totals() const;
+
+    // Forget everything read so far (repeats start over too)
+    void reset();
+
+    // Frame boundary (main thread): records the bytes each tag read since
+    // the last call as Profiler values ("IO Bytes Graphics", ...) and the
+    // time all reads blocked as "IO Blocked ms"
+    void end_frame();
+    uint64_t get_frame_bytes(IoTag tag) const { return frame_bytes_[static_cast<int>(tag)]; }
+
+    // Tables of the reads by tag and by archive, and the entries read more
+    // than once with the bytes re-read; at most max_repeats of those
+    std::string format_report(int max_repeats = 20) const;
+
+    static const char* get_tag_name(IoTag tag);
+
+private:
+    IoStats() = default;
+
+    uint64_t frame_start_[TAG_COUNT] = {};
+    uint64_t frame_bytes_[TAG_COUNT] = {};
+    uint64_t frame_blocked_start_ns_ = 0;
+};
+
+//=============================================================================
+// RAII Tag Scope
+//=============================================================================
+
+// Charges this thread's reads to a tag while in scope; scopes nest
+class IoScope {
+public:
+    explicit IoScope(IoTag tag)
+        : previous_(Platform_Io_SetTag(static_cast<int32_t>(tag))) {}
+    ~IoScope() { Platform_Io_SetTag(previous_); }
+
+    IoScope(const IoScope&) = delete;
+    IoScope& operator=(const IoScope&) = delete;
+
+private:
+    int32_t previous_;
+};
+
+#endif // IO_STATS_H
@@ -0,0 +1,50 @@
+// src/platform/large_pages.cpp
+// Large Page Buffers Implementation
+// Task 18h - Performance Optimization
+
+#include "platform/large_pages.h"
+#include "platform.h"
+#include <cstdio>
+
+// Platform_Alloc flag (MEM_CLEAR in the original game's numbering)
+static const uint32_t ALLOC_CLEAR = 0x0004;
+
+//=============================================================================
+// LargePages Implementation
+//=============================================================================
+
+LargePages& LargePages::instance() {
+    static LargePages instance;
+    return instance;
+}
+
+uint32_t LargePages::get_alloc_flags(size_t size) const {
+    if (!enabled_ || size < min_bytes_) {
+        return 0;
+    }
+    return PLATFORM_MEM_HUGE_PAGES | (locked_ ? PLATFORM_MEM_LOCK : 0);
+}
+
+void* LargePages::allocate(size_t size, const char* what) {
+    uint32_t flags = get_alloc_flags(size);
+    if (flags == 0) {
+        return Platform_Alloc(size, ALLOC_CLEAR);
+    }
+
+    size_t mapped_before = Platform_Mem_GetLargePageBytes();
+    void* block = Platform_Alloc(size, flags | ALLOC_CLEAR);
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    char msg[160];
+    if (Platform_Mem_GetLargePageBytes() > mapped_before) {
+        snprintf(msg, sizeof(msg), "LargePages: %s (%zu bytes) on 2 MB pages%s",
+                 what, size, locked_ ? ", locked" : "");
+    } else {
+        snprintf(msg, sizeof(msg), "LargePages: %s (%zu bytes) fell back to normal memory",
+                 what, size);
+    }
+    Platform_LogInfo(msg);
+    return block;
+}
@@ -0,0 +1,58 @@
+// src/platform/large_pages.h
+// Large Page Buffers
+// Task 18h - Performance Optimization
+
+#ifndef LARGE_PAGES_H
+#define LARGE_PAGES_H
+
+#include <cstddef>
+#include <cstdint>
+
+//=============================================================================
+// Large Page Policy
+//=============================================================================
+
+// Big buffers that live for the whole session and are walked every frame
+// (off-screen surfaces, the map cell array) ask for 2 MB pages through
+// Platform_Alloc's PLATFORM_MEM_HUGE_PAGES flag, so a full-screen blit or
+// map scan touches a handful of TLB entries instead of hundreds. The
+// platform falls back to ordinary memory when the OS has none to give.
+//
+// Blocks from allocate() are zeroed and freed with Platform_Free like any
+// other Platform_Alloc block. Each one is logged with the backing it got,
+// so a machine's log shows whether huge pages are actually in use.
+class LargePages {
+public:
+    // Smaller buffers are not worth rounding up to a whole 2 MB page;
+    // a 640x400 8-bit screen is the smallest that qualifies
+    static constexpr size_t DEFAULT_MIN_BYTES = 640 * 400;
+
+    static LargePages& instance();
+
+    // On by default; off sends every buffer to the ordinary heap
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    bool is_enabled() const { return enabled_; }
+
+    // Also mlock qualifying buffers so they are never paged out (off by
+    // default; subject to RLIMIT_MEMLOCK)
+    void set_locked(bool locked) { locked_ = locked; }
+    bool is_locked() const { return locked_; }
+
+    void set_min_bytes(size_t bytes) { min_bytes_ = bytes; }
+    size_t get_min_bytes() const { return min_bytes_; }
+
+    // Platform_Alloc flags for a long-lived buffer of size bytes
+    uint32_t get_alloc_flags(size_t size) const;
+
+    // Zeroed long-lived buffer; what names it in the log
+    void* allocate(size_t size, const char* what);
+
+private:
+    LargePages() = default;
+
+    bool enabled_ = true;
+    bool locked_ = false;
+    size_t min_bytes_ = DEFAULT_MIN_BYTES;
+};
+
+#endif // LARGE_PAGES_H
@@ -0,0 +1,16 @@
+// src/platform/log.cpp
+// Leveled Logging Macros
+// Task 18h - Performance Optimization
+
+#include "platform/log.h"
+#include <cstdarg>
+#include <cstdio>
+
+void Log_Write(int level, const char* format, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    Platform_LogMessage(level, line);
+}
@@ -0,0 +1,93 @@
+// src/platform/log.h
+// Leveled Logging Macros
+// Task 18h - Performance Optimization
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "platform.h"
+
+//=============================================================================
+// Log Levels
+//=============================================================================
+
+// The platform logger's numbering (Platform_LogMessage, Platform_Log_SetLevel)
+#define LOG_ERROR_LEVEL 0
+#define LOG_WARN_LEVEL  1
+#define LOG_INFO_LEVEL  2
+#define LOG_DEBUG_LEVEL 3
+#define LOG_TRACE_LEVEL 4
+
+// Most verbose level compiled in. Calls above it expand to nothing, so
+// their arguments are never evaluated; release builds stop at Info.
+#ifndef LOG_COMPILE_LEVEL
+    #ifdef NDEBUG
+        #define LOG_COMPILE_LEVEL LOG_INFO_LEVEL
+    #else
+        #define LOG_COMPILE_LEVEL LOG_TRACE_LEVEL
+    #endif
+#endif
+
+//=============================================================================
+// Log Functions
+//=============================================================================
+
+// Whether a line at this level would be kept (Platform_Log_SetLevel)
+inline bool Log_Enabled(int level) {
+    return level <= Platform_Log_GetLevel();
+}
+
+// printf-style formatting into a stack buffer, then Platform_LogMessage;
+// lines past 512 bytes are cut short
+void Log_Write(int level, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+//=============================================================================
+// Log Macros
+//=============================================================================
+
+// Compiled-in levels still check the runtime level before the arguments
+// are evaluated or anything is formatted
+#define LOG_AT(level, ...) \
+    do { \
+        if (Log_Enabled(level)) { \
+            Log_Write(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DISABLED(...) do {} while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_ERROR_LEVEL
+    #define LOG_ERROR(...) LOG_AT(LOG_ERROR_LEVEL, __VA_ARGS__)
+#else
+    #define LOG_ERROR(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_WARN_LEVEL
+    #define LOG_WARN(...) LOG_AT(LOG_WARN_LEVEL, __VA_ARGS__)
+#else
+    #define LOG_WARN(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_INFO_LEVEL
+    #define LOG_INFO(...) LOG_AT(LOG_INFO_LEVEL, __VA_ARGS__)
+#else
+    #define LOG_INFO(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_DEBUG_LEVEL
+    #define LOG_DEBUG(...) LOG_AT(LOG_DEBUG_LEVEL, __VA_ARGS__)
+#else
+    #define LOG_DEBUG(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_TRACE_LEVEL
+    #define LOG_TRACE(...) LOG_AT(LOG_TRACE_LEVEL, __VA_ARGS__)
+#else
+    #define LOG_TRACE(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#endif // LOG_H
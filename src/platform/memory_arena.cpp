@@ -4,5 +4,59 @@
 
 #include "platform/memory_arena.h"
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 // Template implementations are in the header
 // This file exists for any non-template utilities and static instance
+
+//=============================================================================
+// Block Backing
+//=============================================================================
+
+#if defined(__linux__)
+
+void* arena_map_block(size_t size, size_t* mapped_size) {
+    const size_t page = MemoryArena::HUGE_PAGE_SIZE;
+    size_t length = (size + page - 1) / page * page;
+
+    // Over-map by a page so the block can start on a huge page boundary,
+    // then give back the slack on either side
+    size_t span = length + page;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + page - 1) & ~(static_cast<uintptr_t>(page) - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = (start + span) - (aligned + length);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+
+    void* block = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(block, length, MADV_HUGEPAGE);     // A hint; plain pages if THP is off
+#endif
+    *mapped_size = length;
+    return block;
+}
+
+void arena_unmap_block(void* block, size_t mapped_size) {
+    munmap(block, mapped_size);
+}
+
+#else
+
+void* arena_map_block(size_t, size_t* mapped_size) {
+    *mapped_size = 0;
+    return nullptr;
+}
+
+void arena_unmap_block(void*, size_t) {}
+
+#endif
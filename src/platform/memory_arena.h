@@ -5,44 +5,74 @@
 #ifndef MEMORY_ARENA_H
 #define MEMORY_ARENA_H
 
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <utility>
 
+//=============================================================================
+// Block Backing
+//=============================================================================
+
+// Map a block of at least size bytes backed by transparent huge pages where
+// the platform has them. Returns nullptr (use the heap instead) elsewhere.
+// *mapped_size receives the size actually mapped, a whole number of pages.
+void* arena_map_block(size_t size, size_t* mapped_size);
+void arena_unmap_block(void* block, size_t mapped_size);
+
 //=============================================================================
 // Linear Arena Allocator
 //=============================================================================
 
+// Blocks that fill up during a frame are kept across reset() (up to a byte
+// cap) and handed out again, so a frame that overflows the first block
+// only goes to the system the first time. The arena also remembers how
+// much each of the last N frames used; when the peak outgrows the first
+// block, reset() replaces it with one that holds the whole peak, and once
+// the peak has stayed under half of it for N frames it shrinks back
+// (never below the initial size). Steady-state frames therefore make no
+// system allocations at all.
 class MemoryArena {
 public:
-    explicit MemoryArena(size_t initial_size = 1024 * 1024)  // 1MB default
-        : block_size_(initial_size) {
-        allocate_block(initial_size);
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t DEFAULT_RETAINED_BYTES = 8 * 1024 * 1024;
+    static constexpr int DEFAULT_HIGH_WATER_FRAMES = 60;
+
+    explicit MemoryArena(size_t initial_size = 1024 * 1024,  // 1MB default
+                         bool huge_pages = false)
+        : block_size_(initial_size)
+        , initial_size_(initial_size)
+        , huge_pages_(huge_pages) {
+        blocks_.push_back(make_block(initial_size));
+        set_high_water_frames(DEFAULT_HIGH_WATER_FRAMES);
     }
 
     ~MemoryArena() {
-        for (char* block : blocks_) {
-            delete[] block;
+        for (Block& block : blocks_) {
+            free_block(block);
         }
     }
 
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
     // Allocate raw memory (aligned)
     void* allocate(size_t size, size_t alignment = 8) {
         // Align current position
         size_t aligned_pos = (current_pos_ + alignment - 1) & ~(alignment - 1);
 
-        if (aligned_pos + size > current_block_size_) {
-            // Need new block
-            size_t new_block_size = block_size_;
-            if (size > new_block_size) {
-                new_block_size = size + alignment;
-            }
-            allocate_block(new_block_size);
+        if (aligned_pos + size > blocks_[current_].size) {
+            // Need next block
+            next_block(size + alignment);
             aligned_pos = 0;
         }
 
-        void* ptr = current_block_ + aligned_pos;
+        void* ptr = blocks_[current_].data + aligned_pos;
+        used_ += aligned_pos - current_pos_ + size;
         current_pos_ = aligned_pos + size;
         total_allocated_ += size;
 
@@ -69,114 +99,304 @@ public:
 
     // Reset arena (reuse memory)
     void reset() {
-        // Keep first block, release others
-        while (blocks_.size() > 1) {
-            delete[] blocks_.back();
-            blocks_.pop_back();
+        if (!history_.empty()) {
+            history_[history_pos_] = used_;
+            history_pos_ = (history_pos_ + 1) % history_.size();
+            resize_first_block();
         }
 
-        if (!blocks_.empty()) {
-            current_block_ = blocks_[0];
-            current_block_size_ = block_size_;
+        // Keep overflow blocks up to the cap, release the rest
+        size_t retained = 0;
+        size_t keep = 1;
+        for (size_t i = 1; i < blocks_.size(); i++) {
+            if (retained + blocks_[i].size <= retained_limit_) {
+                retained += blocks_[i].size;
+                std::swap(blocks_[keep++], blocks_[i]);
+            }
         }
+        while (blocks_.size() > keep) {
+            free_block(blocks_.back());
+            blocks_.pop_back();
+        }
+
+        current_ = 0;
         current_pos_ = 0;
+        used_ = 0;
         total_allocated_ = 0;
     }
 
+    // Bytes of overflow blocks reset() keeps for the next frame
+    void set_retained_limit(size_t bytes) { retained_limit_ = bytes; }
+
+    // Frames the high-water mark looks back over (0 = fixed block size)
+    void set_high_water_frames(int frames) {
+        history_.assign(frames > 0 ? static_cast<size_t>(frames) : 0, 0);
+        history_pos_ = 0;
+    }
+
+    // Back blocks of HUGE_PAGE_SIZE or more with huge pages where available
+    // (applies to blocks made from now on)
+    void set_huge_pages(bool enabled) { huge_pages_ = enabled; }
+
     // Statistics
     size_t get_total_allocated() const { return total_allocated_; }
     size_t get_total_capacity() const {
         size_t total = 0;
-        for (size_t i = 0; i < blocks_.size(); i++) {
-            total += (i == 0) ? block_size_ : block_size_;
+        for (const Block& block : blocks_) {
+            total += block.size;
         }
         return total;
     }
     size_t get_block_count() const { return blocks_.size(); }
+    size_t get_block_size() const { return block_size_; }
+    size_t get_system_allocations() const { return system_allocations_; }
+
+    // Largest frame in the high-water window, padding included
+    size_t get_high_water() const {
+        size_t peak = used_;
+        for (size_t used : history_) {
+            peak = used > peak ? used : peak;
+        }
+        return peak;
+    }
 
-    // Scoped marker for temporary allocations
+    // Scoped marker for temporary allocations; rewinds without freeing,
+    // so the blocks it spilled into stay for the next use
     class Marker {
     public:
         Marker(MemoryArena& arena)
             : arena_(arena)
-            , block_index_(arena.blocks_.size() - 1)
-            , position_(arena.current_pos_) {}
+            , block_index_(arena.current_)
+            , position_(arena.current_pos_)
+            , used_(arena.used_)
+            , total_allocated_(arena.total_allocated_) {}
 
         ~Marker() {
             // Restore arena state
-            while (arena_.blocks_.size() > block_index_ + 1) {
-                delete[] arena_.blocks_.back();
-                arena_.blocks_.pop_back();
-            }
-            arena_.current_block_ = arena_.blocks_[block_index_];
+            arena_.current_ = block_index_;
             arena_.current_pos_ = position_;
+            arena_.used_ = used_;
+            arena_.total_allocated_ = total_allocated_;
         }
 
     private:
         MemoryArena& arena_;
         size_t block_index_;
         size_t position_;
+        size_t used_;
+        size_t total_allocated_;
     };
 
     Marker create_marker() { return Marker(*this); }
 
 private:
-    void allocate_block(size_t size) {
-        char* block = new char[size];
-        blocks_.push_back(block);
-        current_block_ = block;
-        current_block_size_ = size;
+    struct Block {
+        char* data;
+        size_t size;
+        bool mapped;                // From arena_map_block, not new[]
+    };
+
+    static constexpr size_t GROWTH_GRANULE = 4096;
+
+    Block make_block(size_t size) {
+        system_allocations_++;
+        if (huge_pages_ && size >= HUGE_PAGE_SIZE) {
+            size_t mapped_size = 0;
+            if (void* data = arena_map_block(size, &mapped_size)) {
+                return Block{static_cast<char*>(data), mapped_size, true};
+            }
+        }
+        return Block{new char[size], size, false};
+    }
+
+    static void free_block(Block& block) {
+        if (block.mapped) {
+            arena_unmap_block(block.data, block.size);
+        } else {
+            delete[] block.data;
+        }
+        block.data = nullptr;
+    }
+
+    // Move on to a block with at least needed bytes, reusing a retained
+    // one if any fits. Blocks before current_ are left in place so markers
+    // stay valid.
+    void next_block(size_t needed) {
+        size_t next = current_ + 1;
+        for (size_t i = next; i < blocks_.size(); i++) {
+            if (blocks_[i].size >= needed) {
+                std::swap(blocks_[next], blocks_[i]);
+                current_ = next;
+                current_pos_ = 0;
+                return;
+            }
+        }
+        blocks_.insert(blocks_.begin() + next, make_block(needed > block_size_ ? needed : block_size_));
+        current_ = next;
         current_pos_ = 0;
     }
 
-    std::vector<char*> blocks_;
-    char* current_block_ = nullptr;
-    size_t current_block_size_ = 0;
+    // Size the first block to the high-water mark: grow as soon as the peak
+    // outgrows it, shrink once the peak has stayed under half for the window
+    void resize_first_block() {
+        size_t peak = get_high_water();
+        size_t target = (peak + GROWTH_GRANULE - 1) / GROWTH_GRANULE * GROWTH_GRANULE;
+        target = target > initial_size_ ? target : initial_size_;
+
+        size_t first = blocks_[0].size;
+        if (target > first || (target < first / 2 && first > initial_size_)) {
+            free_block(blocks_[0]);
+            blocks_[0] = make_block(target);
+            block_size_ = target;
+
+            // The first block now holds a whole peak frame by itself
+            while (blocks_.size() > 1) {
+                free_block(blocks_.back());
+                blocks_.pop_back();
+            }
+        }
+    }
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0;                    // Block being bumped
     size_t current_pos_ = 0;
-    size_t block_size_;
+    size_t block_size_;                     // Size of the first block, and least size of the rest
+    size_t initial_size_;
+    size_t used_ = 0;                       // This frame, padding included
     size_t total_allocated_ = 0;
+    size_t retained_limit_ = DEFAULT_RETAINED_BYTES;
+    std::vector<size_t> history_;           // used_ of recent frames
+    size_t history_pos_ = 0;
+    size_t system_allocations_ = 0;
+    bool huge_pages_;
 };
 
 //=============================================================================
 // Frame Allocator (reset each frame)
 //=============================================================================
 
+// Every thread allocates from arenas of its own, found through a
+// thread_local pointer, so the bump needs no lock or atomic and job
+// workers can use FRAME_ALLOC/FRAME_NEW too. A thread's arenas are made
+// on its first allocation (the only step that locks) and kept for reuse.
+//
+// begin_frame() resets every thread's arena at once; it must run while no
+// other thread is allocating (between job batches, with the simulation
+// thread waited on).
+//
+// Double-buffered, each thread has two arenas used on alternate frames,
+// so memory handed out during frame N stays valid until frame N+2 begins
+// and a consumer running one frame behind (a pipelined render) can still
+// read it.
 class FrameAllocator {
 public:
+    static constexpr size_t MAIN_ARENA_SIZE = 2 * 1024 * 1024;     // Thread that made the allocator
+    static constexpr size_t WORKER_ARENA_SIZE = 256 * 1024;        // Any other thread
+
     static FrameAllocator& instance() {
         static FrameAllocator instance;
         return instance;
     }
 
     void begin_frame() {
-        arena_.reset();
+        std::lock_guard<std::mutex> lock(mutex_);
+        int current = current_.load(std::memory_order_relaxed);
+        if (double_buffered_) {
+            current ^= 1;
+        }
+        for (auto& arenas : threads_) {
+            if (arenas->buffers[current]) {
+                arenas->buffers[current]->reset();
+            }
+        }
+        current_.store(current, std::memory_order_relaxed);
     }
 
     void end_frame() {
         // Could add stats collection here
     }
 
+    // Keep each frame's memory through the next frame (takes effect at
+    // the next begin_frame)
+    void set_double_buffered(bool enabled) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double_buffered_ = enabled;
+    }
+    bool is_double_buffered() const { return double_buffered_; }
+
     void* allocate(size_t size, size_t alignment = 8) {
-        return arena_.allocate(size, alignment);
+        return arena().allocate(size, alignment);
     }
 
     template<typename T, typename... Args>
     T* create(Args&&... args) {
-        return arena_.create<T>(std::forward<Args>(args)...);
+        return arena().create<T>(std::forward<Args>(args)...);
     }
 
     template<typename T>
     T* create_array(size_t count) {
-        return arena_.create_array<T>(count);
+        return arena().create_array<T>(count);
     }
 
+    // Bytes handed out this frame by every thread (call between frames)
     size_t get_frame_allocation() const {
-        return arena_.get_total_allocated();
+        std::lock_guard<std::mutex> lock(mutex_);
+        int current = current_.load(std::memory_order_relaxed);
+        size_t total = 0;
+        for (const auto& arenas : threads_) {
+            if (arenas->buffers[current]) {
+                total += arenas->buffers[current]->get_total_allocated();
+            }
+        }
+        return total;
+    }
+
+    size_t get_thread_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return threads_.size();
     }
 
 private:
-    FrameAllocator() : arena_(2 * 1024 * 1024) {}  // 2MB frame arena
-    MemoryArena arena_;
+    struct ThreadArenas {
+        size_t size;
+        std::unique_ptr<MemoryArena> buffers[2];    // [1] only once double-buffered
+    };
+
+    FrameAllocator() : main_thread_(std::this_thread::get_id()) {}
+
+    // Calling thread's arena for the current frame
+    MemoryArena& arena() {
+        thread_local ThreadArenas* local = nullptr;
+        if (local == nullptr) {
+            local = register_thread();
+        }
+        std::unique_ptr<MemoryArena>& buffer = local->buffers[current_.load(std::memory_order_relaxed)];
+        if (!buffer) {
+            buffer = make_arena(local->size);
+        }
+        return *buffer;
+    }
+
+    // Arenas big enough to span a huge page get one
+    static std::unique_ptr<MemoryArena> make_arena(size_t size) {
+        return std::make_unique<MemoryArena>(size, size >= MemoryArena::HUGE_PAGE_SIZE);
+    }
+
+    ThreadArenas* register_thread() {
+        auto arenas = std::make_unique<ThreadArenas>();
+        arenas->size = std::this_thread::get_id() == main_thread_ ? MAIN_ARENA_SIZE : WORKER_ARENA_SIZE;
+        arenas->buffers[0] = make_arena(arenas->size);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.push_back(std::move(arenas));
+        return threads_.back().get();
+    }
+
+    std::thread::id main_thread_;
+    mutable std::mutex mutex_;                           // Guards threads_ and mode changes
+    std::vector<std::unique_ptr<ThreadArenas>> threads_;
+    std::atomic<int> current_{0};                        // Buffer in use this frame
+    bool double_buffered_ = false;
 };
 
 //=============================================================================
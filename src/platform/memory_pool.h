@@ -8,6 +8,7 @@
 #include <vector>
 #include <cstdint>
 #include <cstddef>
+#include <new>
 #include <utility>
 
 //=============================================================================
@@ -150,4 +151,177 @@ private:
     T* obj_;
 };
 
+//=============================================================================
+// Slot Handle
+//=============================================================================
+
+// 32-bit reference to a SlotPool slot: index in the low 20 bits, the
+// slot's generation in the high 12. A live slot's generation is odd, so
+// a zero handle is "none". A handle stops resolving once its object is freed,
+// even if the slot has been reused since (until the generation wraps,
+// 2048 reuses later).
+struct SlotHandle {
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    static constexpr uint32_t MAX_SLOTS = INDEX_MASK + 1;
+
+    uint32_t value = 0;
+
+    static SlotHandle make(uint32_t index, uint32_t generation) {
+        SlotHandle handle;
+        handle.value = (index & INDEX_MASK) | ((generation & GENERATION_MASK) << INDEX_BITS);
+        return handle;
+    }
+
+    uint32_t index() const { return value & INDEX_MASK; }
+    uint32_t generation() const { return value >> INDEX_BITS; }
+    bool is_none() const { return value == 0; }
+
+    bool operator==(const SlotHandle& other) const { return value == other.value; }
+    bool operator!=(const SlotHandle& other) const { return value != other.value; }
+};
+
+//=============================================================================
+// Slot Pool (intrusive free list, generation-checked handles)
+//=============================================================================
+
+// Like ObjectPool, but the free list lives in the free slots themselves
+// (no per-slot bookkeeping beyond a 2-byte generation), blocks start on a
+// cache line, and objects are referred to by SlotHandle. get() checks a
+// handle in O(1) and returns nullptr for a freed object instead of a
+// dangling pointer.
+//
+// Slots never handed out are taken in index order without touching the
+// free list, so a new block costs one allocation and nothing per slot.
+// for_each() walks live objects in index order.
+template<typename T, size_t BlockSize = 64>
+class SlotPool {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    SlotPool() = default;
+
+    ~SlotPool() {
+        clear();
+        for (Slot* block : blocks_) {
+            ::operator delete(block, std::align_val_t(BLOCK_ALIGN));
+        }
+    }
+
+    SlotPool(const SlotPool&) = delete;
+    SlotPool& operator=(const SlotPool&) = delete;
+
+    // Construct an object; returns a none handle once MAX_SLOTS are live
+    template<typename... Args>
+    SlotHandle allocate(Args&&... args) {
+        uint32_t index;
+        if (free_head_ != NO_SLOT) {
+            index = free_head_;
+            free_head_ = slot(index).next_free;
+        } else if (used_ < capacity()) {
+            index = used_++;
+        } else if (capacity() + BlockSize <= SlotHandle::MAX_SLOTS) {
+            allocate_block();
+            index = used_++;
+        } else {
+            return SlotHandle();
+        }
+
+        new (slot(index).bytes) T(std::forward<Args>(args)...);
+        live_count_++;
+        return SlotHandle::make(index, ++generations_[index]);
+    }
+
+    // Destroy the object a handle refers to; false if it is already gone
+    bool deallocate(SlotHandle handle) {
+        T* obj = get(handle);
+        if (obj == nullptr) return false;
+
+        uint32_t index = handle.index();
+        obj->~T();
+        generations_[index]++;
+        slot(index).next_free = free_head_;
+        free_head_ = index;
+        live_count_--;
+        return true;
+    }
+
+    // Object a handle refers to, or nullptr if it has been freed
+    T* get(SlotHandle handle) const {
+        uint32_t index = handle.index();
+        if (index >= used_) return nullptr;
+        uint16_t generation = generations_[index];
+        if (!(generation & 1) || (generation & SlotHandle::GENERATION_MASK) != handle.generation()) {
+            return nullptr;
+        }
+        return object(index);
+    }
+
+    // Live object in a slot, or nullptr
+    T* at(uint32_t index) const {
+        return index < used_ && (generations_[index] & 1) ? object(index) : nullptr;
+    }
+
+    // Handle to the live object in a slot (none if the slot is free)
+    SlotHandle handle_at(uint32_t index) const {
+        return at(index) ? SlotHandle::make(index, generations_[index]) : SlotHandle();
+    }
+
+    // Call fn(T&) for every live object in index order; fn may free the
+    // object it is given
+    template<typename Fn>
+    void for_each(Fn fn) {
+        for (uint32_t index = 0; index < used_; index++) {
+            if (generations_[index] & 1) {
+                fn(*object(index));
+            }
+        }
+    }
+
+    // Destroy every live object; outstanding handles stop resolving
+    void clear() {
+        for (uint32_t index = 0; index < used_; index++) {
+            if (generations_[index] & 1) {
+                object(index)->~T();
+                generations_[index]++;
+            }
+        }
+        // Slots come back in index order through the never-used path
+        free_head_ = NO_SLOT;
+        used_ = 0;
+        live_count_ = 0;
+    }
+
+    // Statistics
+    size_t size() const { return live_count_; }
+    uint32_t capacity() const { return static_cast<uint32_t>(blocks_.size() * BlockSize); }
+
+private:
+    static constexpr uint32_t NO_SLOT = ~0u;
+
+    // A free slot's first bytes link to the next free slot
+    union Slot {
+        uint32_t next_free;
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    static constexpr size_t BLOCK_ALIGN = alignof(Slot) > CACHE_LINE ? alignof(Slot) : CACHE_LINE;
+
+    Slot& slot(uint32_t index) const { return blocks_[index / BlockSize][index % BlockSize]; }
+    T* object(uint32_t index) const { return std::launder(reinterpret_cast<T*>(slot(index).bytes)); }
+
+    void allocate_block() {
+        void* block = ::operator new(sizeof(Slot) * BlockSize, std::align_val_t(BLOCK_ALIGN));
+        blocks_.push_back(static_cast<Slot*>(block));
+        generations_.resize(capacity(), 0);
+    }
+
+    std::vector<Slot*> blocks_;
+    std::vector<uint16_t> generations_;   // Odd while the slot is live
+    uint32_t free_head_ = NO_SLOT;
+    uint32_t used_ = 0;                   // Slots ever handed out since clear()
+    size_t live_count_ = 0;
+};
+
 #endif // MEMORY_POOL_H
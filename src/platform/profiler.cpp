@@ -3,11 +3,24 @@
 // Task 18h - Performance Optimization
 
 #include "platform/profiler.h"
+#include "platform.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
 #include <cstdio>
+#include <chrono>
+#include <cmath>
+
+// Registration may run from several threads' static initializers
+static std::mutex& register_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Calling thread's buffer, registered on first sample
+static thread_local void* t_thread_buffer = nullptr;
+static thread_local bool t_thread_exited = false;   // Past its ThreadRelease
 
 //=============================================================================
 // Profiler Implementation
@@ -18,101 +31,538 @@ Profiler& Profiler::instance() {
     return instance;
 }
 
+Profiler::Profiler()
+    : counters_(new std::atomic<int>[MAX_SAMPLE_IDS])
+    , values_(new std::atomic<double>[MAX_SAMPLE_IDS])
+    , value_set_(new std::atomic<bool>[MAX_SAMPLE_IDS])
+    , value_dirty_(new std::atomic<bool>[MAX_SAMPLE_IDS])
+    , histogram_slots_(new std::atomic<int>[MAX_SAMPLE_IDS])
+    , histograms_(new HistogramData[MAX_HISTOGRAMS])
+    , trace_ring_(TRACE_RING_SIZE)
+    , frame_records_(MAX_FRAME_RECORDS)
+    , counter_ring_(COUNTER_RING_SIZE) {
+    name_lookup_.reserve(MAX_SAMPLE_IDS);
+    threads_.reserve(MAX_THREADS);
+    for (int i = 0; i < MAX_SAMPLE_IDS; i++) {
+        counters_[i].store(0, std::memory_order_relaxed);
+        values_[i].store(0.0, std::memory_order_relaxed);
+        value_set_[i].store(false, std::memory_order_relaxed);
+        value_dirty_[i].store(false, std::memory_order_relaxed);
+        histogram_slots_[i].store(-1, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MAX_HISTOGRAMS; i++) {
+        histograms_[i].id = PROFILE_ID_INVALID;
+        histograms_[i].clear();
+    }
+}
+
+int64_t Profiler::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//=============================================================================
+// Name Interning
+//=============================================================================
+
+ProfileSampleId Profiler::register_sample(const char* name) {
+    if (name == nullptr) return PROFILE_ID_INVALID;
+
+    std::lock_guard<std::mutex> lock(register_mutex());
+
+    auto it = name_lookup_.find(name);
+    if (it != name_lookup_.end()) return it->second;
+
+    int count = id_count_.load(std::memory_order_relaxed);
+    if (count >= MAX_SAMPLE_IDS) return PROFILE_ID_INVALID;
+
+    ProfileSampleId id = static_cast<ProfileSampleId>(count);
+    names_.emplace_back(name);
+    name_lookup_.emplace(names_.back(), id);
+    id_count_.store(count + 1, std::memory_order_release);
+    return id;
+}
+
+ProfileSampleId Profiler::find_sample(const char* name) const {
+    if (name == nullptr) return PROFILE_ID_INVALID;
+
+    std::lock_guard<std::mutex> lock(register_mutex());
+    auto it = name_lookup_.find(name);
+    return it != name_lookup_.end() ? it->second : PROFILE_ID_INVALID;
+}
+
+const char* Profiler::get_sample_name(ProfileSampleId id) const {
+    if (id >= id_count_.load(std::memory_order_acquire)) return "";
+
+    std::lock_guard<std::mutex> lock(register_mutex());
+    return names_[id].c_str();
+}
+
+//=============================================================================
+// Threads
+//=============================================================================
+
+// Lives in the thread's thread_local storage from its first sample
+struct Profiler::ThreadRelease {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadRelease() {
+        // Samples the thread takes after this are dropped
+        t_thread_buffer = nullptr;
+        t_thread_exited = true;
+        if (buffer) {
+            Profiler::instance().release_thread_buffer(buffer);
+        }
+    }
+};
+
+Profiler::ThreadBuffer* Profiler::thread_buffer() {
+    if (t_thread_buffer) {
+        return static_cast<ThreadBuffer*>(t_thread_buffer);
+    }
+    if (t_thread_exited) {
+        return nullptr;
+    }
+
+    ThreadBuffer* buffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+
+        // Take over an exited thread's buffer; its stats stay in the totals
+        // and its pending events are merged at the next end_frame()
+        for (auto& candidate : threads_) {
+            std::lock_guard<std::mutex> buffer_lock(candidate->mutex);
+            if (candidate->live) continue;
+
+            candidate->live = true;
+            candidate->name = "Thread " + std::to_string(candidate->index);
+            candidate->named = false;
+            buffer = candidate.get();
+            break;
+        }
+
+        if (!buffer) {
+            if (static_cast<int>(threads_.size()) >= MAX_THREADS) {
+                return nullptr;
+            }
+
+            // Cold path: allocates once per slot
+            std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+            created->index = static_cast<uint16_t>(threads_.size() + 1);
+            created->name = "Thread " + std::to_string(created->index);
+            created->stats.resize(MAX_SAMPLE_IDS);
+            created->events.resize(THREAD_EVENT_CAPACITY);
+            buffer = created.get();
+            threads_.push_back(std::move(created));
+        }
+    }
+
+    t_thread_buffer = buffer;
+    thread_local ThreadRelease release;
+    release.buffer = buffer;
+    return buffer;
+}
+
+void Profiler::release_thread_buffer(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+    // Samples left open by the exiting thread can never end
+    buffer->depth = 0;
+    buffer->overflow = 0;
+    buffer->live = false;
+}
+
+void Profiler::set_thread_name(const char* name) {
+    ThreadBuffer* buffer = thread_buffer();
+    if (!buffer || name == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+    buffer->named = true;
+}
+
+int Profiler::get_thread_count() const {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    return static_cast<int>(threads_.size());
+}
+
+std::string Profiler::get_thread_name(int thread) const {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    if (thread < 1 || thread > static_cast<int>(threads_.size())) return "";
+
+    ThreadBuffer& buffer = *threads_[thread - 1];
+    std::lock_guard<std::mutex> buffer_lock(buffer.mutex);
+    return buffer.name;
+}
+
+// Move every thread's completed samples into the shared trace ring
+void Profiler::merge_thread_events() {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    for (auto& buffer : threads_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+        for (int i = 0; i < buffer->event_count; i++) {
+            trace_ring_[trace_head_] = buffer->events[i];
+            trace_head_ = (trace_head_ + 1) % trace_capacity_;
+            if (trace_count_ < trace_capacity_) trace_count_++;
+        }
+        buffer->event_count = 0;
+    }
+}
+
+int Profiler::get_trace_event_count() const {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    return trace_count_;
+}
+
+//=============================================================================
+// Frames and Samples
+//=============================================================================
+
 void Profiler::begin_frame() {
-    if (!enabled_) return;
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+
+    frame_start_ns_ = now_ns();
+
+    // Only the frame thread's stack is reset; workers keep theirs open
+    ThreadBuffer* buffer = thread_buffer();
+    if (buffer) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->depth = 0;
+        buffer->overflow = 0;
+        if (!buffer->named) {
+            buffer->name = "Main";
+            buffer->named = true;
+        }
+    }
 
-    frame_start_ = std::chrono::high_resolution_clock::now();
-    sample_stack_.clear();
-    counters_.clear();
+    int count = id_count_.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
 }
 
 void Profiler::end_frame() {
-    if (!enabled_) return;
+    if (!enabled_.load(std::memory_order_relaxed)) return;
 
-    auto frame_end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-        frame_end - frame_start_);
-    last_frame_time_ms_ = duration.count() / 1000.0;
+    int64_t frame_end_ns = now_ns();
+    last_frame_time_ms_ = (frame_end_ns - frame_start_ns_) / 1000000.0;
 
-    // Store frame time history
-    frame_times_.push_back(last_frame_time_ms_);
-    if (frame_times_.size() > MAX_FRAME_HISTORY) {
-        frame_times_.erase(frame_times_.begin());
+    merge_thread_events();
+
+    ThreadBuffer* buffer = thread_buffer();
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        FrameRecord& record = frame_records_[frame_record_head_];
+        record.start_ns = frame_start_ns_;
+        record.duration_ns = frame_end_ns - frame_start_ns_;
+        record.frame = frame_number_.load(std::memory_order_relaxed);
+        record.thread = buffer ? buffer->index : 0;
+        frame_record_head_ = (frame_record_head_ + 1) % MAX_FRAME_RECORDS;
+        if (frame_record_count_ < MAX_FRAME_RECORDS) frame_record_count_++;
+
+        snapshot_counters(frame_end_ns);
+    }
+
+    if (recorder_enabled_ && spike_threshold_ms_ > 0.0 &&
+        last_frame_time_ms_ > spike_threshold_ms_ &&
+        (spike_dump_count_ == 0 || frame_end_ns - last_spike_dump_ns_ >= recorder_window_ns_)) {
+        dump_spike(frame_end_ns);
     }
 
-    frame_number_++;
+    // Store frame time history
+    frame_times_[frame_time_head_] = last_frame_time_ms_;
+    frame_time_head_ = (frame_time_head_ + 1) % MAX_FRAME_HISTORY;
+    if (frame_time_count_ < MAX_FRAME_HISTORY) frame_time_count_++;
+
+    frame_number_.fetch_add(1, std::memory_order_relaxed);
 }
 
-void Profiler::begin_sample(const std::string& name) {
-    if (!enabled_) return;
+// Caller holds threads_mutex_
+void Profiler::snapshot_counters(int64_t frame_end_ns) {
+    int id_count = id_count_.load(std::memory_order_acquire);
+    for (int id = 0; id < id_count; id++) {
+        double value;
+        if (value_dirty_[id].exchange(false, std::memory_order_relaxed)) {
+            value = values_[id].load(std::memory_order_relaxed);
+        } else {
+            int count = counters_[id].load(std::memory_order_relaxed);
+            if (count == 0) continue;
+            value = count;
+        }
 
-    ActiveSample sample;
-    sample.name = name;
-    sample.start_time = std::chrono::high_resolution_clock::now();
-    sample.depth = static_cast<int>(sample_stack_.size());
-    sample_stack_.push_back(sample);
+        CounterRecord& record = counter_ring_[counter_head_];
+        record.ts_ns = frame_end_ns;
+        record.value = value;
+        record.id = static_cast<ProfileSampleId>(id);
+        counter_head_ = (counter_head_ + 1) % COUNTER_RING_SIZE;
+        if (counter_count_ < COUNTER_RING_SIZE) counter_count_++;
+    }
 }
 
-void Profiler::end_sample(const std::string& name) {
-    if (!enabled_) return;
-    if (sample_stack_.empty()) return;
+void Profiler::begin_sample(ProfileSampleId id) {
+    if (!enabled_.load(std::memory_order_relaxed) || id == PROFILE_ID_INVALID) return;
+
+    ThreadBuffer* buffer = thread_buffer();
+    if (!buffer) return;
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->depth >= MAX_SAMPLE_DEPTH) {
+        buffer->overflow++;
+        return;
+    }
+
+    ActiveSample& sample = buffer->stack[buffer->depth++];
+    sample.id = id;
+    sample.start_ns = now_ns();
+}
+
+void Profiler::end_sample(ProfileSampleId id) {
+    if (!enabled_.load(std::memory_order_relaxed) || id == PROFILE_ID_INVALID) return;
+
+    int64_t end_ns = now_ns();
+
+    ThreadBuffer* buffer = thread_buffer();
+    if (!buffer) return;
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->overflow > 0) {
+        buffer->overflow--;
+        return;
+    }
+    if (buffer->depth == 0) return;
 
     // Find matching sample (should be on top)
-    if (sample_stack_.back().name != name) {
+    const ActiveSample& active = buffer->stack[buffer->depth - 1];
+    if (active.id != id) {
         return;
     }
 
-    ActiveSample& active = sample_stack_.back();
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-        end_time - active.start_time);
-    double duration_ms = duration.count() / 1000.0;
+    int64_t duration_ns = end_ns - active.start_ns;
 
     // Update statistics
-    SampleData& data = sample_data_[name];
+    SampleData& data = buffer->stats[id];
     data.call_count++;
-    data.total_time_ms += duration_ms;
-    data.last_time_ms = duration_ms;
-    if (duration_ms < data.min_time_ms) data.min_time_ms = duration_ms;
-    if (duration_ms > data.max_time_ms) data.max_time_ms = duration_ms;
+    data.total_ns += duration_ns;
+    data.last_ns = duration_ns;
+    if (duration_ns < data.min_ns) data.min_ns = duration_ns;
+    if (duration_ns > data.max_ns) data.max_ns = duration_ns;
+
+    // Store for Chrome trace export (merged at end_frame)
+    if (buffer->event_count < THREAD_EVENT_CAPACITY) {
+        ProfileEvent& event = buffer->events[buffer->event_count++];
+        event.start_ns = active.start_ns;
+        event.duration_ns = duration_ns;
+        event.frame = frame_number_.load(std::memory_order_relaxed);
+        event.id = id;
+        event.depth = static_cast<uint16_t>(buffer->depth - 1);
+        event.thread = buffer->index;
+    } else {
+        dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    buffer->depth--;
+}
 
-    // Store for Chrome trace export
-    ProfileSample chrome_sample;
-    chrome_sample.name = name;
-    auto frame_start_us = std::chrono::duration_cast<std::chrono::microseconds>(
-        active.start_time.time_since_epoch()).count();
-    chrome_sample.start_time_ms = frame_start_us / 1000.0;
-    chrome_sample.duration_ms = duration_ms;
-    chrome_sample.depth = active.depth;
-    chrome_samples_.push_back(chrome_sample);
+void Profiler::begin_sample(const std::string& name) {
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    begin_sample(register_sample(name.c_str()));
+}
 
-    sample_stack_.pop_back();
+void Profiler::end_sample(const std::string& name) {
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    end_sample(find_sample(name.c_str()));
+}
+
+void Profiler::record_value(ProfileSampleId id, double value) {
+    if (!enabled_.load(std::memory_order_relaxed) || id == PROFILE_ID_INVALID) return;
+    values_[id].store(value, std::memory_order_relaxed);
+    value_set_[id].store(true, std::memory_order_relaxed);
+    value_dirty_[id].store(true, std::memory_order_relaxed);
+}
+
+void Profiler::increment_counter(ProfileSampleId id) {
+    if (!enabled_.load(std::memory_order_relaxed) || id == PROFILE_ID_INVALID) return;
+    counters_[id].fetch_add(1, std::memory_order_relaxed);
 }
 
 void Profiler::record_value(const std::string& name, double value) {
-    if (!enabled_) return;
-    values_[name] = value;
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    record_value(register_sample(name.c_str()), value);
 }
 
 void Profiler::increment_counter(const std::string& name) {
-    if (!enabled_) return;
-    counters_[name]++;
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    increment_counter(register_sample(name.c_str()));
+}
+
+//=============================================================================
+// Histograms
+//=============================================================================
+
+static const double HISTOGRAM_FIRST_LIMIT_MS = 0.125;
+
+// Bucket b holds values up to 0.125 * 2^(b/2) ms
+static int histogram_bucket(double value_ms) {
+    if (!(value_ms > HISTOGRAM_FIRST_LIMIT_MS)) return 0;
+    int bucket = static_cast<int>(std::ceil(2.0 * std::log2(value_ms / HISTOGRAM_FIRST_LIMIT_MS)));
+    return std::min(bucket, Profiler::HISTOGRAM_BUCKETS - 1);
 }
 
+double Profiler::get_histogram_bucket_limit_ms(int bucket) {
+    return HISTOGRAM_FIRST_LIMIT_MS * std::exp2(bucket * 0.5);
+}
+
+void Profiler::HistogramData::clear() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    total_us.store(0, std::memory_order_relaxed);
+    min_us.store(INT64_MAX, std::memory_order_relaxed);
+    max_us.store(0, std::memory_order_relaxed);
+}
+
+// Slot for id, claimed on first use; -1 once every slot is taken
+int Profiler::histogram_slot(ProfileSampleId id) {
+    int slot = histogram_slots_[id].load(std::memory_order_acquire);
+    if (slot >= 0) return slot;
+
+    std::lock_guard<std::mutex> lock(register_mutex());
+    slot = histogram_slots_[id].load(std::memory_order_relaxed);
+    if (slot >= 0) return slot;
+
+    int count = histogram_count_.load(std::memory_order_relaxed);
+    if (count >= MAX_HISTOGRAMS) return -1;
+    histograms_[count].id = id;
+    histogram_count_.store(count + 1, std::memory_order_release);
+    histogram_slots_[id].store(count, std::memory_order_release);
+    return count;
+}
+
+void Profiler::record_histogram(ProfileSampleId id, double value_ms) {
+    if (!enabled_.load(std::memory_order_relaxed) || id == PROFILE_ID_INVALID) return;
+
+    int slot = histogram_slot(id);
+    if (slot < 0) return;
+
+    HistogramData& h = histograms_[slot];
+    int64_t value_us = static_cast<int64_t>(std::max(value_ms, 0.0) * 1000.0);
+    h.buckets[histogram_bucket(value_ms)].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.total_us.fetch_add(value_us, std::memory_order_relaxed);
+
+    int64_t seen = h.min_us.load(std::memory_order_relaxed);
+    while (value_us < seen && !h.min_us.compare_exchange_weak(seen, value_us, std::memory_order_relaxed)) {
+    }
+    seen = h.max_us.load(std::memory_order_relaxed);
+    while (value_us > seen && !h.max_us.compare_exchange_weak(seen, value_us, std::memory_order_relaxed)) {
+    }
+}
+
+void Profiler::record_histogram(const std::string& name, double value_ms) {
+    if (!enabled_.load(std::memory_order_relaxed)) return;
+    record_histogram(register_sample(name.c_str()), value_ms);
+}
+
+ProfileHistogram Profiler::get_histogram(const std::string& name) const {
+    return get_histogram(find_sample(name.c_str()));
+}
+
+ProfileHistogram Profiler::get_histogram(ProfileSampleId id) const {
+    ProfileHistogram result;
+    result.name = id == PROFILE_ID_INVALID ? "" : get_sample_name(id);
+    result.count = 0;
+    result.min_ms = 0.0;
+    result.max_ms = 0.0;
+    result.avg_ms = 0.0;
+    result.buckets.assign(HISTOGRAM_BUCKETS, 0);
+
+    int slot = id == PROFILE_ID_INVALID ? -1 : histogram_slots_[id].load(std::memory_order_acquire);
+    if (slot < 0) return result;
+
+    const HistogramData& h = histograms_[slot];
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+        result.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+    }
+    result.count = h.count.load(std::memory_order_relaxed);
+    if (result.count > 0) {
+        result.min_ms = h.min_us.load(std::memory_order_relaxed) / 1000.0;
+        result.max_ms = h.max_us.load(std::memory_order_relaxed) / 1000.0;
+        result.avg_ms = h.total_us.load(std::memory_order_relaxed) / 1000.0 / result.count;
+    }
+    return result;
+}
+
+std::vector<ProfileHistogram> Profiler::get_all_histograms() const {
+    std::vector<ProfileHistogram> result;
+    int count = histogram_count_.load(std::memory_order_acquire);
+    for (int slot = 0; slot < count; slot++) {
+        ProfileHistogram h = get_histogram(histograms_[slot].id);
+        if (h.count > 0) {
+            result.push_back(std::move(h));
+        }
+    }
+    return result;
+}
+
+double ProfileHistogram::get_percentile(int percentile) const {
+    if (count == 0) return 0.0;
+
+    // Smallest rank covering the percentile, at least the first sample
+    int64_t rank = std::max<int64_t>(1, (static_cast<int64_t>(percentile) * count + 99) / 100);
+    int64_t seen = 0;
+    for (int b = 0; b < static_cast<int>(buckets.size()); b++) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return std::min(Profiler::get_histogram_bucket_limit_ms(b), max_ms);
+        }
+    }
+    return max_ms;
+}
+
+//=============================================================================
+// Statistics
+//=============================================================================
+
 ProfileStats Profiler::get_stats(const std::string& name) const {
-    ProfileStats stats;
+    ProfileStats stats = get_stats(find_sample(name.c_str()));
     stats.name = name;
+    return stats;
+}
+
+// Sums the per-thread stats for one ID
+ProfileStats Profiler::get_stats(ProfileSampleId id) const {
+    ProfileStats stats{};
+    if (id >= id_count_.load(std::memory_order_acquire)) return stats;
+
+    stats.name = get_sample_name(id);
+
+    SampleData total;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        for (const auto& buffer : threads_) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            const SampleData& data = buffer->stats[id];
+            if (data.call_count == 0) continue;
+
+            total.call_count += data.call_count;
+            total.total_ns += data.total_ns;
+            total.last_ns = data.last_ns;
+            total.min_ns = std::min(total.min_ns, data.min_ns);
+            total.max_ns = std::max(total.max_ns, data.max_ns);
+        }
+    }
 
-    auto it = sample_data_.find(name);
-    if (it != sample_data_.end()) {
-        const SampleData& data = it->second;
-        stats.call_count = data.call_count;
-        stats.total_time_ms = data.total_time_ms;
-        stats.min_time_ms = data.min_time_ms;
-        stats.max_time_ms = data.max_time_ms;
-        stats.avg_time_ms = data.call_count > 0 ?
-            data.total_time_ms / data.call_count : 0.0;
-        stats.last_time_ms = data.last_time_ms;
+    if (total.call_count > 0) {
+        stats.call_count = total.call_count;
+        stats.total_time_ms = total.total_ns / 1000000.0;
+        stats.min_time_ms = total.min_ns / 1000000.0;
+        stats.max_time_ms = total.max_ns / 1000000.0;
+        stats.avg_time_ms = stats.total_time_ms / total.call_count;
+        stats.last_time_ms = total.last_ns / 1000000.0;
     }
 
     return stats;
@@ -120,8 +570,12 @@ ProfileStats Profiler::get_stats(const std::string& name) const {
 
 std::vector<ProfileStats> Profiler::get_all_stats() const {
     std::vector<ProfileStats> result;
-    for (const auto& pair : sample_data_) {
-        result.push_back(get_stats(pair.first));
+    int count = id_count_.load(std::memory_order_acquire);
+    for (int id = 0; id < count; id++) {
+        ProfileStats stats = get_stats(static_cast<ProfileSampleId>(id));
+        if (stats.call_count > 0) {
+            result.push_back(stats);
+        }
     }
 
     // Sort by total time descending
@@ -134,13 +588,13 @@ std::vector<ProfileStats> Profiler::get_all_stats() const {
 }
 
 double Profiler::get_avg_frame_time_ms() const {
-    if (frame_times_.empty()) return 0.0;
+    if (frame_time_count_ == 0) return 0.0;
 
     double sum = 0.0;
-    for (double t : frame_times_) {
-        sum += t;
+    for (int i = 0; i < frame_time_count_; i++) {
+        sum += frame_times_[i];
     }
-    return sum / frame_times_.size();
+    return sum / frame_time_count_;
 }
 
 double Profiler::get_fps() const {
@@ -149,18 +603,23 @@ double Profiler::get_fps() const {
 }
 
 std::vector<double> Profiler::get_frame_times(int count) const {
-    int start = static_cast<int>(frame_times_.size()) - count;
-    if (start < 0) start = 0;
-
-    return std::vector<double>(
-        frame_times_.begin() + start,
-        frame_times_.end());
+    if (count > frame_time_count_) count = frame_time_count_;
+    if (count < 0) count = 0;
+
+    // Oldest first, ending with the most recent frame
+    std::vector<double> result;
+    result.reserve(count);
+    int start = frame_time_head_ - count + MAX_FRAME_HISTORY;
+    for (int i = 0; i < count; i++) {
+        result.push_back(frame_times_[(start + i) % MAX_FRAME_HISTORY]);
+    }
+    return result;
 }
 
 double Profiler::get_percentile_frame_time(int percentile) const {
-    if (frame_times_.empty()) return 0.0;
+    if (frame_time_count_ == 0) return 0.0;
 
-    std::vector<double> sorted = frame_times_;
+    std::vector<double> sorted(frame_times_, frame_times_ + frame_time_count_);
     std::sort(sorted.begin(), sorted.end());
 
     int index = (percentile * static_cast<int>(sorted.size())) / 100;
@@ -176,7 +635,7 @@ std::string Profiler::get_report() const {
 
     oss << "=== Performance Report ===\n\n";
     oss << "Frame Statistics:\n";
-    oss << "  Frames: " << frame_number_ << "\n";
+    oss << "  Frames: " << get_frame_number() << "\n";
     oss << "  Avg FPS: " << std::fixed << std::setprecision(1) << get_fps() << "\n";
     oss << "  Avg Frame: " << std::setprecision(2) << get_avg_frame_time_ms() << " ms\n";
     oss << "  Last Frame: " << last_frame_time_ms_ << " ms\n";
@@ -204,18 +663,62 @@ std::string Profiler::get_report() const {
             << "\n";
     }
 
-    if (!counters_.empty()) {
-        oss << "\nCounters:\n";
-        for (const auto& pair : counters_) {
-            oss << "  " << pair.first << ": " << pair.second << "\n";
+    int id_count = id_count_.load(std::memory_order_acquire);
+
+    bool header = false;
+    for (int id = 0; id < id_count; id++) {
+        int count = counters_[id].load(std::memory_order_relaxed);
+        if (count == 0) continue;
+        if (!header) {
+            oss << "\nCounters:\n";
+            header = true;
         }
+        oss << "  " << get_sample_name(static_cast<ProfileSampleId>(id)) << ": " << count << "\n";
     }
 
-    if (!values_.empty()) {
-        oss << "\nValues:\n";
-        for (const auto& pair : values_) {
-            oss << "  " << pair.first << ": " << pair.second << "\n";
+    header = false;
+    for (int id = 0; id < id_count; id++) {
+        if (!value_set_[id].load(std::memory_order_relaxed)) continue;
+        if (!header) {
+            oss << "\nValues:\n";
+            header = true;
         }
+        oss << "  " << get_sample_name(static_cast<ProfileSampleId>(id)) << ": "
+            << values_[id].load(std::memory_order_relaxed) << "\n";
+    }
+
+    auto histograms = get_all_histograms();
+    if (!histograms.empty()) {
+        oss << "\nHistograms:\n";
+        oss << std::setw(30) << std::left << "Name"
+            << std::setw(10) << "Count"
+            << std::setw(12) << "Avg(ms)"
+            << std::setw(12) << "P50(ms)"
+            << std::setw(12) << "P95(ms)"
+            << std::setw(12) << "P99(ms)"
+            << std::setw(12) << "Max(ms)"
+            << "\n";
+        oss << std::string(100, '-') << "\n";
+        for (const auto& h : histograms) {
+            oss << std::setw(30) << std::left << h.name
+                << std::setw(10) << h.count
+                << std::setw(12) << std::setprecision(2) << h.avg_ms
+                << std::setw(12) << h.get_percentile(50)
+                << std::setw(12) << h.get_percentile(95)
+                << std::setw(12) << h.get_percentile(99)
+                << std::setw(12) << h.max_ms
+                << "\n";
+        }
+    }
+
+    int threads = get_thread_count();
+    if (threads > 1) {
+        oss << "\nThreads: " << threads;
+        int dropped = get_dropped_event_count();
+        if (dropped > 0) {
+            oss << " (" << dropped << " trace events dropped)";
+        }
+        oss << "\n";
     }
 
     return oss.str();
@@ -236,6 +739,23 @@ std::string Profiler::get_csv_report() const {
             << s.max_time_ms << "\n";
     }
 
+    // Counters (this frame) and the latest recorded values
+    int id_count = id_count_.load(std::memory_order_acquire);
+    bool header = false;
+    for (int id = 0; id < id_count; id++) {
+        int count = counters_[id].load(std::memory_order_relaxed);
+        bool has_value = value_set_[id].load(std::memory_order_relaxed);
+        if (count == 0 && !has_value) continue;
+        if (!header) {
+            oss << "\nName,Counter,Value\n";
+            header = true;
+        }
+        oss << get_sample_name(static_cast<ProfileSampleId>(id)) << ","
+            << count << ",";
+        if (has_value) oss << values_[id].load(std::memory_order_relaxed);
+        oss << "\n";
+    }
+
     return oss.str();
 }
 
@@ -243,28 +763,157 @@ void Profiler::print_report() const {
     printf("%s", get_report().c_str());
 }
 
-std::string Profiler::export_chrome_trace() const {
-    std::ostringstream oss;
-    oss << "{\"traceEvents\":[\n";
+// Writes frames and samples that end at or after from_ns
+void Profiler::write_chrome_trace(std::ostream& out, int64_t from_ns) const {
+    out << "{\"traceEvents\":[\n";
 
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+
+    // Thread name metadata, so viewers label each tid
     bool first = true;
-    for (const auto& sample : chrome_samples_) {
-        if (!first) oss << ",\n";
+    for (const auto& buffer : threads_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        if (!first) out << ",\n";
+        first = false;
+
+        out << "{\"name\":\"thread_name\","
+            << "\"ph\":\"M\","
+            << "\"pid\":1,"
+            << "\"tid\":" << buffer->index << ","
+            << "\"args\":{\"name\":\"" << buffer->name << "\"}}";
+    }
+
+    // Frame spans on the frame thread
+    int start = frame_record_head_ - frame_record_count_ + MAX_FRAME_RECORDS;
+    for (int i = 0; i < frame_record_count_; i++) {
+        const FrameRecord& record = frame_records_[(start + i) % MAX_FRAME_RECORDS];
+        if (record.start_ns + record.duration_ns < from_ns) continue;
+        if (!first) out << ",\n";
+        first = false;
+
+        out << "{\"name\":\"Frame\","
+            << "\"cat\":\"frame\","
+            << "\"ph\":\"X\","
+            << "\"ts\":" << record.start_ns / 1000 << ","
+            << "\"dur\":" << record.duration_ns / 1000 << ","
+            << "\"pid\":1,"
+            << "\"tid\":" << record.thread << ","
+            << "\"args\":{\"frame\":" << record.frame << "}}";
+    }
+
+    // Oldest event first
+    start = trace_head_ - trace_count_ + trace_capacity_;
+    for (int i = 0; i < trace_count_; i++) {
+        const ProfileEvent& event = trace_ring_[(start + i) % trace_capacity_];
+        if (event.start_ns + event.duration_ns < from_ns) continue;
+        if (!first) out << ",\n";
         first = false;
 
-        oss << "{\"name\":\"" << sample.name << "\","
+        out << "{\"name\":\"" << get_sample_name(event.id) << "\","
             << "\"cat\":\"profile\","
             << "\"ph\":\"X\","
-            << "\"ts\":" << static_cast<int64_t>(sample.start_time_ms * 1000) << ","
-            << "\"dur\":" << static_cast<int64_t>(sample.duration_ms * 1000) << ","
+            << "\"ts\":" << event.start_ns / 1000 << ","
+            << "\"dur\":" << event.duration_ns / 1000 << ","
+            << "\"pid\":1,"
+            << "\"tid\":" << event.thread << ","
+            << "\"args\":{\"frame\":" << event.frame
+            << ",\"depth\":" << event.depth << "}}";
+    }
+
+    // Values and counters as counter tracks, one sample per frame
+    start = counter_head_ - counter_count_ + COUNTER_RING_SIZE;
+    for (int i = 0; i < counter_count_; i++) {
+        const CounterRecord& record = counter_ring_[(start + i) % COUNTER_RING_SIZE];
+        if (record.ts_ns < from_ns) continue;
+        if (!first) out << ",\n";
+        first = false;
+
+        out << "{\"name\":\"" << get_sample_name(record.id) << "\","
+            << "\"cat\":\"counter\","
+            << "\"ph\":\"C\","
+            << "\"ts\":" << record.ts_ns / 1000 << ","
             << "\"pid\":1,"
-            << "\"tid\":" << sample.depth << "}";
+            << "\"args\":{\"value\":" << record.value << "}}";
     }
 
-    oss << "\n]}";
+    out << "\n]}";
+}
+
+std::string Profiler::export_chrome_trace() const {
+    std::ostringstream oss;
+    write_chrome_trace(oss, INT64_MIN);
+    return oss.str();
+}
+
+std::string Profiler::export_chrome_trace_window(double window_seconds) const {
+    std::ostringstream oss;
+    write_chrome_trace(oss, now_ns() - static_cast<int64_t>(window_seconds * 1e9));
     return oss.str();
 }
 
+bool Profiler::save_chrome_trace_window(const std::string& path, double window_seconds) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    write_chrome_trace(file, now_ns() - static_cast<int64_t>(window_seconds * 1e9));
+    return true;
+}
+
+//=============================================================================
+// Flight Recorder
+//=============================================================================
+
+void Profiler::enable_flight_recorder(double window_seconds, double spike_threshold_ms,
+                                      int capacity) {
+    if (capacity < 1) capacity = TRACE_RING_SIZE;
+
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        if (capacity != trace_capacity_) {
+            trace_ring_.assign(capacity, ProfileEvent());
+            trace_capacity_ = capacity;
+            trace_head_ = 0;
+            trace_count_ = 0;
+        }
+    }
+
+    recorder_window_ns_ = static_cast<int64_t>(window_seconds * 1e9);
+    spike_threshold_ms_ = spike_threshold_ms;
+    recorder_enabled_ = true;
+}
+
+void Profiler::disable_flight_recorder() {
+    recorder_enabled_ = false;
+}
+
+void Profiler::dump_spike(int64_t frame_end_ns) {
+    char dir[512];
+    if (Platform_GetLogPath(dir, sizeof(dir)) <= 0) {
+        snprintf(dir, sizeof(dir), ".");
+    }
+
+    char path[640];
+    snprintf(path, sizeof(path), "%s/spike_frame%d_%dms.json",
+             dir, frame_number_.load(std::memory_order_relaxed),
+             static_cast<int>(last_frame_time_ms_));
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        Platform_LogError("Profiler: could not write spike trace");
+        return;
+    }
+    write_chrome_trace(file, frame_end_ns - recorder_window_ns_);
+
+    last_spike_dump_ns_ = frame_end_ns;
+    last_spike_dump_path_ = path;
+    spike_dump_count_++;
+
+    char msg[768];
+    snprintf(msg, sizeof(msg), "Profiler: %.1f ms frame, trace written to %s",
+             last_frame_time_ms_, path);
+    Platform_LogInfo(msg);
+}
+
 bool Profiler::save_chrome_trace(const std::string& path) const {
     std::ofstream file(path);
     if (!file.is_open()) return false;
@@ -274,14 +923,39 @@ bool Profiler::save_chrome_trace(const std::string& path) const {
 }
 
 void Profiler::reset() {
-    frame_number_ = 0;
+    frame_number_.store(0, std::memory_order_relaxed);
     last_frame_time_ms_ = 0.0;
-    sample_stack_.clear();
-    sample_data_.clear();
-    values_.clear();
-    counters_.clear();
-    frame_times_.clear();
-    chrome_samples_.clear();
+    for (int i = 0; i < MAX_SAMPLE_IDS; i++) {
+        counters_[i].store(0, std::memory_order_relaxed);
+        values_[i].store(0.0, std::memory_order_relaxed);
+        value_set_[i].store(false, std::memory_order_relaxed);
+        value_dirty_[i].store(false, std::memory_order_relaxed);
+    }
+    // Histogram slots stay claimed, like the IDs
+    for (int i = 0; i < MAX_HISTOGRAMS; i++) {
+        histograms_[i].clear();
+    }
+    frame_time_head_ = 0;
+    frame_time_count_ = 0;
+    dropped_events_.store(0, std::memory_order_relaxed);
+
+    // Threads and their names stay registered
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (auto& buffer : threads_) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->depth = 0;
+        buffer->overflow = 0;
+        buffer->event_count = 0;
+        std::fill(buffer->stats.begin(), buffer->stats.end(), SampleData());
+    }
+    trace_head_ = 0;
+    trace_count_ = 0;
+    frame_record_head_ = 0;
+    frame_record_count_ = 0;
+    counter_head_ = 0;
+    counter_count_ = 0;
+    spike_dump_count_ = 0;
+    last_spike_dump_ns_ = 0;
 }
 
 //=============================================================================
@@ -294,23 +968,54 @@ GPUProfiler& GPUProfiler::instance() {
 }
 
 void GPUProfiler::begin_frame() {
-    // Would set up Metal GPU timestamp queries
+    // Flip stages are timed by the platform layer; nothing to arm here
 }
 
 void GPUProfiler::end_frame() {
-    // Would read back GPU timestamps
+    FlipTiming timing;
+    if (Platform_Graphics_GetFlipTiming(&timing) != 0 ||
+        (has_timing_ && timing.flip_count == last_flip_count_)) {
+        // No flip this frame
+        last_gpu_time_ms_ = convert_ms_ = upload_ms_ = scale_ms_ = present_ms_ = 0.0;
+        pixels_converted_ = 0;
+        return;
+    }
+
+    last_flip_count_ = timing.flip_count;
+    has_timing_ = true;
+
+    convert_ms_ = timing.convert_us / 1000.0;
+    upload_ms_ = timing.upload_us / 1000.0;
+    scale_ms_ = timing.scale_us / 1000.0;
+    present_ms_ = timing.present_us / 1000.0;
+    pixels_converted_ = timing.pixels_converted;
+    last_gpu_time_ms_ = upload_ms_ + scale_ms_ + present_ms_;
+
+    Profiler& profiler = Profiler::instance();
+    profiler.record_value(PROFILE_ID("GPU Convert (ms)"), convert_ms_);
+    profiler.record_value(PROFILE_ID("GPU Upload (ms)"), upload_ms_);
+    profiler.record_value(PROFILE_ID("GPU Scale (ms)"), scale_ms_);
+    profiler.record_value(PROFILE_ID("GPU Present (ms)"), present_ms_);
+    profiler.record_value(PROFILE_ID("GPU Pixels Converted"), pixels_converted_);
 }
 
 void GPUProfiler::begin_gpu_sample(const std::string& name) {
-    (void)name;
+    Profiler::instance().begin_sample(name);
 }
 
 void GPUProfiler::end_gpu_sample(const std::string& name) {
-    (void)name;
+    Profiler::instance().end_sample(name);
 }
 
 std::string GPUProfiler::get_report() const {
     std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
     oss << "GPU Time: " << last_gpu_time_ms_ << " ms\n";
+    if (has_timing_) {
+        oss << "  Convert: " << convert_ms_ << " ms (CPU, " << pixels_converted_ << " px)\n";
+        oss << "  Upload:  " << upload_ms_ << " ms\n";
+        oss << "  Scale:   " << scale_ms_ << " ms\n";
+        oss << "  Present: " << present_ms_ << " ms (includes vsync)\n";
+    }
     return oss.str();
 }
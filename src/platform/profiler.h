@@ -7,8 +7,12 @@
 
 #include <string>
 #include <vector>
-#include <map>
-#include <chrono>
+#include <deque>
+#include <iosfwd>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include <cstdint>
 
 //=============================================================================
@@ -23,17 +27,41 @@
     #endif
 #endif
 
+//=============================================================================
+// Sample IDs
+//=============================================================================
+
+// Interned sample name. Each PROFILE_* site registers its name once
+// (function-local static) and passes the ID from then on, so the hot
+// path does no string work and no heap allocation.
+using ProfileSampleId = uint16_t;
+static const ProfileSampleId PROFILE_ID_INVALID = 0xFFFF;
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Expression form, for use inside other macros
+#define PROFILE_ID(name) \
+    ([]() -> ProfileSampleId { \
+        static const ProfileSampleId id = Profiler::instance().register_sample(name); \
+        return id; \
+    }())
+
 //=============================================================================
 // Profiler Macros
 //=============================================================================
 
 #if PROFILER_ENABLED
-    #define PROFILE_SCOPE(name) ProfileScope _profile_scope_##__LINE__(name)
-    #define PROFILE_FUNCTION() ProfileScope _profile_scope_func(__FUNCTION__)
-    #define PROFILE_BEGIN(name) Profiler::instance().begin_sample(name)
-    #define PROFILE_END(name) Profiler::instance().end_sample(name)
-    #define PROFILE_VALUE(name, value) Profiler::instance().record_value(name, value)
-    #define PROFILE_COUNTER(name) Profiler::instance().increment_counter(name)
+    #define PROFILE_SCOPE(name) \
+        static const ProfileSampleId PROFILE_CONCAT(_profile_id_, __LINE__) = \
+            Profiler::instance().register_sample(name); \
+        ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(PROFILE_CONCAT(_profile_id_, __LINE__))
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+    #define PROFILE_BEGIN(name) Profiler::instance().begin_sample(PROFILE_ID(name))
+    #define PROFILE_END(name) Profiler::instance().end_sample(PROFILE_ID(name))
+    #define PROFILE_VALUE(name, value) Profiler::instance().record_value(PROFILE_ID(name), value)
+    #define PROFILE_COUNTER(name) Profiler::instance().increment_counter(PROFILE_ID(name))
+    #define PROFILE_HISTOGRAM(name, value_ms) Profiler::instance().record_histogram(PROFILE_ID(name), value_ms)
 #else
     #define PROFILE_SCOPE(name)
     #define PROFILE_FUNCTION()
@@ -41,19 +69,21 @@
     #define PROFILE_END(name)
     #define PROFILE_VALUE(name, value)
     #define PROFILE_COUNTER(name)
+    #define PROFILE_HISTOGRAM(name, value_ms)
 #endif
 
 //=============================================================================
 // Profile Sample
 //=============================================================================
 
-struct ProfileSample {
-    std::string name;
-    double start_time_ms;
-    double end_time_ms;
-    double duration_ms;
-    int depth;
-    uint32_t thread_id;
+// Completed sample as stored in the trace ring (names resolved on export)
+struct ProfileEvent {
+    int64_t start_ns;       // steady clock, since epoch
+    int64_t duration_ns;
+    int32_t frame;
+    ProfileSampleId id;
+    uint16_t depth;
+    uint16_t thread;        // Profiler thread index (Chrome trace tid)
 };
 
 struct ProfileStats {
@@ -66,6 +96,19 @@ struct ProfileStats {
     double last_time_ms;
 };
 
+// Distribution of a recorded time (see Profiler::record_histogram)
+struct ProfileHistogram {
+    std::string name;
+    int count;
+    double min_ms;
+    double max_ms;
+    double avg_ms;
+    std::vector<int> buckets;   // Profiler::HISTOGRAM_BUCKETS counts
+
+    // Upper limit of the bucket holding the percentile (capped at max_ms)
+    double get_percentile(int percentile) const;
+};
+
 //=============================================================================
 // Profiler
 //=============================================================================
@@ -74,21 +117,68 @@ class Profiler {
 public:
     static Profiler& instance();
 
-    // Frame management
+    // Fixed capacities (all storage is allocated up front)
+    static const int MAX_SAMPLE_IDS = 1024;
+    static const int MAX_SAMPLE_DEPTH = 64;
+    static const int TRACE_RING_SIZE = 16384;
+    static const int THREAD_EVENT_CAPACITY = 4096;  // Per thread, per frame
+    static const int MAX_THREADS = 64;
+    static const int FLIGHT_RECORDER_EVENTS = 1 << 18;  // 8 MB of ProfileEvent
+    static const int MAX_FRAME_RECORDS = 4096;
+    static const int COUNTER_RING_SIZE = 16384;
+    static const int MAX_HISTOGRAMS = 32;
+    static const int HISTOGRAM_BUCKETS = 32;
+
+    // Name interning (cold path: once per call site)
+    ProfileSampleId register_sample(const char* name);
+    ProfileSampleId find_sample(const char* name) const;
+    const char* get_sample_name(ProfileSampleId id) const;
+    int get_sample_id_count() const { return id_count_; }
+
+    // Threads: each thread records into its own buffer, registered on its
+    // first sample; end_frame() merges every buffer into the trace ring.
+    // An exited thread's buffer (and its trace tid) goes to the next new
+    // thread, so at most MAX_THREADS need be alive at once.
+    void set_thread_name(const char* name);   // For the calling thread
+    int get_thread_count() const;
+    std::string get_thread_name(int thread) const;
+    int get_dropped_event_count() const { return dropped_events_; }
+
+    // Frame management (call from the main thread)
     void begin_frame();
     void end_frame();
     int get_frame_number() const { return frame_number_; }
 
-    // Sampling
+    // Sampling (hot path: no allocation, thread safe)
+    void begin_sample(ProfileSampleId id);
+    void end_sample(ProfileSampleId id);
+
+    // Sampling by name (interns on first use; prefer the macros)
     void begin_sample(const std::string& name);
     void end_sample(const std::string& name);
 
-    // Value tracking
+    // Value tracking. end_frame() snapshots values set during the frame
+    // and non-zero counters, so both export as counter tracks.
+    void record_value(ProfileSampleId id, double value);
+    void increment_counter(ProfileSampleId id);
     void record_value(const std::string& name, double value);
     void increment_counter(const std::string& name);
 
+    // Histograms, for times whose spread matters more than their average
+    // (latencies). Buckets are log spaced: bucket 0 holds up to 0.125 ms,
+    // each later one reaches sqrt(2) further, and the last also takes
+    // everything above. Thread safe, no allocation after an ID's first
+    // record; IDs past MAX_HISTOGRAMS are ignored.
+    void record_histogram(ProfileSampleId id, double value_ms);
+    void record_histogram(const std::string& name, double value_ms);
+    ProfileHistogram get_histogram(const std::string& name) const;
+    ProfileHistogram get_histogram(ProfileSampleId id) const;
+    std::vector<ProfileHistogram> get_all_histograms() const;
+    static double get_histogram_bucket_limit_ms(int bucket);
+
     // Statistics
     ProfileStats get_stats(const std::string& name) const;
+    ProfileStats get_stats(ProfileSampleId id) const;
     std::vector<ProfileStats> get_all_stats() const;
     double get_frame_time_ms() const { return last_frame_time_ms_; }
     double get_avg_frame_time_ms() const;
@@ -103,46 +193,161 @@ public:
     std::string get_csv_report() const;
     void print_report() const;
 
-    // Chrome tracing format export
+    // Chrome tracing format export (everything still in the trace ring)
     std::string export_chrome_trace() const;
     bool save_chrome_trace(const std::string& path) const;
-
-    // Control
+    int get_trace_event_count() const;
+
+    // Chrome trace of only the last window_seconds
+    std::string export_chrome_trace_window(double window_seconds) const;
+    bool save_chrome_trace_window(const std::string& path, double window_seconds) const;
+
+    // Flight recorder: grows the trace ring to hold recent history and,
+    // when a frame takes longer than spike_threshold_ms, writes the last
+    // window_seconds to the log directory (Platform_GetLogPath). Dumps are
+    // at least one window apart. The window is also bounded by capacity.
+    void enable_flight_recorder(double window_seconds, double spike_threshold_ms,
+                                int capacity = FLIGHT_RECORDER_EVENTS);
+    void disable_flight_recorder();
+    bool is_flight_recorder_enabled() const { return recorder_enabled_; }
+    void set_spike_threshold_ms(double threshold_ms) { spike_threshold_ms_ = threshold_ms; }
+    double get_spike_threshold_ms() const { return spike_threshold_ms_; }
+    int get_spike_dump_count() const { return spike_dump_count_; }
+    const std::string& get_last_spike_dump_path() const { return last_spike_dump_path_; }
+
+    // Control (reset keeps registered IDs; call sites cache them)
     void reset();
-    void set_enabled(bool enabled) { enabled_ = enabled; }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
     bool is_enabled() const { return enabled_; }
 
 private:
-    Profiler() = default;
+    Profiler();
+
+    static int64_t now_ns();
 
     struct SampleData {
         int call_count = 0;
-        double total_time_ms = 0.0;
-        double min_time_ms = 999999.0;
-        double max_time_ms = 0.0;
-        double last_time_ms = 0.0;
+        int64_t total_ns = 0;
+        int64_t min_ns = INT64_MAX;
+        int64_t max_ns = 0;
+        int64_t last_ns = 0;
     };
 
     struct ActiveSample {
+        int64_t start_ns;
+        ProfileSampleId id;
+    };
+
+    // Owned by one thread; only its mutex is taken on the hot path and
+    // it is contended only while end_frame() or a stats query runs.
+    struct ThreadBuffer {
+        std::mutex mutex;
+        uint16_t index = 0;
         std::string name;
-        std::chrono::high_resolution_clock::time_point start_time;
-        int depth;
+        bool named = false;     // Set by set_thread_name() or begin_frame()
+        bool live = true;       // Cleared when the owning thread exits
+
+        ActiveSample stack[MAX_SAMPLE_DEPTH];
+        int depth = 0;
+        int overflow = 0;       // Samples begun past MAX_SAMPLE_DEPTH
+
+        std::vector<SampleData> stats;
+        std::vector<ProfileEvent> events;   // THREAD_EVENT_CAPACITY slots
+        int event_count = 0;
     };
 
-    bool enabled_ = true;
-    int frame_number_ = 0;
-    double last_frame_time_ms_ = 0.0;
-    std::chrono::high_resolution_clock::time_point frame_start_;
+    struct FrameRecord {
+        int64_t start_ns;
+        int64_t duration_ns;
+        int32_t frame;
+        uint16_t thread;
+    };
 
-    std::vector<ActiveSample> sample_stack_;
-    std::map<std::string, SampleData> sample_data_;
-    std::map<std::string, double> values_;
-    std::map<std::string, int> counters_;
+    // Value or per-frame counter total at the end of a frame
+    struct CounterRecord {
+        int64_t ts_ns;
+        double value;
+        ProfileSampleId id;
+    };
 
-    std::vector<double> frame_times_;
-    static const int MAX_FRAME_HISTORY = 300;
+    // Times kept in microseconds so they can be atomic integers
+    struct HistogramData {
+        ProfileSampleId id;
+        std::atomic<int> buckets[HISTOGRAM_BUCKETS];
+        std::atomic<int> count;
+        std::atomic<int64_t> total_us;
+        std::atomic<int64_t> min_us;
+        std::atomic<int64_t> max_us;
+
+        void clear();
+    };
 
-    std::vector<ProfileSample> chrome_samples_;
+    struct ThreadRelease;   // Hands the buffer back at thread exit
+
+    ThreadBuffer* thread_buffer();
+    void release_thread_buffer(ThreadBuffer* buffer);
+    int histogram_slot(ProfileSampleId id);
+    void merge_thread_events();
+    void snapshot_counters(int64_t frame_end_ns);
+    void write_chrome_trace(std::ostream& out, int64_t from_ns) const;
+    void dump_spike(int64_t frame_end_ns);
+
+    std::atomic<bool> enabled_{true};
+    std::atomic<int> frame_number_{0};
+    double last_frame_time_ms_ = 0.0;
+    int64_t frame_start_ns_ = 0;
+
+    // Interned names; deque keeps c_str() stable as it grows
+    std::deque<std::string> names_;
+    std::unordered_map<std::string, ProfileSampleId> name_lookup_;
+    std::atomic<int> id_count_{0};
+
+    // Per-ID counters and values, shared by all threads
+    std::unique_ptr<std::atomic<int>[]> counters_;
+    std::unique_ptr<std::atomic<double>[]> values_;
+    std::unique_ptr<std::atomic<bool>[]> value_set_;
+    std::unique_ptr<std::atomic<bool>[]> value_dirty_;   // Set since the last snapshot
+
+    // Histograms, claimed by ID on first record; slots are never released
+    std::unique_ptr<std::atomic<int>[]> histogram_slots_;  // Per ID, -1 if none
+    std::unique_ptr<HistogramData[]> histograms_;
+    std::atomic<int> histogram_count_{0};
+
+    // Registered threads (never removed, so indices stay valid; reused
+    // once their thread has exited)
+    mutable std::mutex threads_mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads_;
+
+    // Frame time ring
+    static const int MAX_FRAME_HISTORY = 300;
+    double frame_times_[MAX_FRAME_HISTORY];
+    int frame_time_head_ = 0;
+    int frame_time_count_ = 0;
+
+    // Completed sample ring (oldest overwritten), guarded by threads_mutex_
+    std::vector<ProfileEvent> trace_ring_;
+    int trace_capacity_ = TRACE_RING_SIZE;
+    int trace_head_ = 0;
+    int trace_count_ = 0;
+    std::atomic<int> dropped_events_{0};
+
+    // Frame spans for trace export, guarded by threads_mutex_
+    std::vector<FrameRecord> frame_records_;
+    int frame_record_head_ = 0;
+    int frame_record_count_ = 0;
+
+    // Counter track samples for trace export, guarded by threads_mutex_
+    std::vector<CounterRecord> counter_ring_;
+    int counter_head_ = 0;
+    int counter_count_ = 0;
+
+    // Flight recorder
+    bool recorder_enabled_ = false;
+    double spike_threshold_ms_ = 0.0;
+    int64_t recorder_window_ns_ = 0;
+    int64_t last_spike_dump_ns_ = 0;
+    int spike_dump_count_ = 0;
+    std::string last_spike_dump_path_;
 };
 
 //=============================================================================
@@ -151,41 +356,63 @@ private:
 
 class ProfileScope {
 public:
-    explicit ProfileScope(const char* name) : name_(name) {
-        Profiler::instance().begin_sample(name_);
+    explicit ProfileScope(ProfileSampleId id) : id_(id) {
+        Profiler::instance().begin_sample(id_);
     }
 
+    explicit ProfileScope(const char* name)
+        : ProfileScope(Profiler::instance().register_sample(name)) {}
+
     ~ProfileScope() {
-        Profiler::instance().end_sample(name_);
+        Profiler::instance().end_sample(id_);
     }
 
     ProfileScope(const ProfileScope&) = delete;
     ProfileScope& operator=(const ProfileScope&) = delete;
 
 private:
-    const char* name_;
+    ProfileSampleId id_;
 };
 
 //=============================================================================
-// GPU Profiler (Placeholder for Metal)
+// GPU Profiler
 //=============================================================================
 
+// Presentation cost per frame. The SDL renderer offers no timer queries,
+// so the platform layer brackets each flip stage with CPU timestamps
+// (FlipTiming in platform.h); present time includes the vsync wait.
 class GPUProfiler {
 public:
     static GPUProfiler& instance();
 
     void begin_frame();
-    void end_frame();
+    void end_frame();   // After the frame's Platform_Graphics_Flip()
 
+    // CPU-timed samples around GPU-bound work (recorded in the Profiler)
     void begin_gpu_sample(const std::string& name);
     void end_gpu_sample(const std::string& name);
 
-    double get_gpu_time_ms() const { return last_gpu_time_ms_; }
+    // Last frame's flip, in milliseconds (zero if the frame did not flip)
+    double get_gpu_time_ms() const { return last_gpu_time_ms_; }  // upload + scale + present
+    double get_convert_time_ms() const { return convert_ms_; }
+    double get_upload_time_ms() const { return upload_ms_; }
+    double get_scale_time_ms() const { return scale_ms_; }
+    double get_present_time_ms() const { return present_ms_; }
+    uint32_t get_pixels_converted() const { return pixels_converted_; }  // Last flip
+    bool has_timing() const { return has_timing_; }
+
     std::string get_report() const;
 
 private:
     GPUProfiler() = default;
     double last_gpu_time_ms_ = 0.0;
+    double convert_ms_ = 0.0;
+    double upload_ms_ = 0.0;
+    double scale_ms_ = 0.0;
+    double present_ms_ = 0.0;
+    uint32_t pixels_converted_ = 0;
+    uint32_t last_flip_count_ = 0;
+    bool has_timing_ = false;
 };
 
 #endif // PROFILER_H
@@ -0,0 +1,327 @@
+// src/platform/sampling_profiler.cpp
+// Sampling Profiler Implementation
+// Task 18h - Performance Optimization
+
+#include "platform/sampling_profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#define SAMPLING_PROFILER_SUPPORTED 1
+#else
+#define SAMPLING_PROFILER_SUPPORTED 0
+#endif
+
+#if SAMPLING_PROFILER_SUPPORTED
+// The handler runs on the sampled thread and may only touch these
+static SamplingProfiler* g_sampled = nullptr;
+static pthread_t g_target;
+static bool g_handler_installed = false;
+#endif
+
+// Frames of the handler and the kernel's signal trampoline above the
+// interrupted code
+static const int HANDLER_FRAMES = 2;
+
+//=============================================================================
+// Sampling
+//=============================================================================
+
+SamplingProfiler& SamplingProfiler::instance() {
+    static SamplingProfiler profiler;
+    return profiler;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+bool SamplingProfiler::is_supported() {
+    return SAMPLING_PROFILER_SUPPORTED != 0;
+}
+
+bool SamplingProfiler::start(int rate_hz) {
+#if SAMPLING_PROFILER_SUPPORTED
+    if (is_running()) {
+        return false;
+    }
+    rate_hz = std::max(1, std::min(rate_hz, MAX_RATE_HZ));
+
+    // backtrace() loads the unwinder on first use, which allocates; do
+    // that here rather than inside the signal handler
+    void* warm[4];
+    backtrace(warm, 4);
+
+    // Installed once and left in place: a SIGPROF still in flight after
+    // stop() must not hit the default action, which ends the process
+    if (!g_handler_installed) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = &SamplingProfiler::signal_handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            return false;
+        }
+        g_handler_installed = true;
+    }
+
+    g_target = pthread_self();
+    g_sampled = this;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    running_.store(true, std::memory_order_release);
+    sampler_ = std::thread(&SamplingProfiler::sampler_main, this, 1000000 / rate_hz);
+    return true;
+#else
+    (void)rate_hz;
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop() {
+    if (!is_running()) {
+        return;
+    }
+    running_.store(false, std::memory_order_release);
+    if (sampler_.joinable()) {
+        sampler_.join();
+    }
+    drain();
+}
+
+void SamplingProfiler::signal_handler(int) {
+#if SAMPLING_PROFILER_SUPPORTED
+    int saved_errno = errno;
+    SamplingProfiler* self = g_sampled;
+    if (self != nullptr && self->running_.load(std::memory_order_acquire)) {
+        uint32_t head = self->head_.load(std::memory_order_relaxed);
+        uint32_t tail = self->tail_.load(std::memory_order_acquire);
+        if (head - tail >= static_cast<uint32_t>(RING_SIZE)) {
+            self->dropped_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            void* frames[MAX_DEPTH + HANDLER_FRAMES];
+            int count = backtrace(frames, MAX_DEPTH + HANDLER_FRAMES);
+            Slot& slot = self->ring_[head & (RING_SIZE - 1)];
+            slot.depth = std::max(0, count - HANDLER_FRAMES);
+            for (int i = 0; i < slot.depth; i++) {
+                slot.frames[i] = frames[i + HANDLER_FRAMES];
+            }
+            self->head_.store(head + 1, std::memory_order_release);
+        }
+    }
+    errno = saved_errno;
+#endif
+}
+
+void SamplingProfiler::sampler_main(int interval_us) {
+#if SAMPLING_PROFILER_SUPPORTED
+    auto next = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+        pthread_kill(g_target, SIGPROF);
+        next += std::chrono::microseconds(interval_us);
+        std::this_thread::sleep_until(next);
+        drain();
+    }
+#else
+    (void)interval_us;
+#endif
+}
+
+void SamplingProfiler::drain() {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    uint32_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    for (; tail != head; tail++) {
+        const Slot& slot = ring_[tail & (RING_SIZE - 1)];
+        if (slot.depth > 0) {
+            stacks_[std::vector<void*>(slot.frames, slot.frames + slot.depth)]++;
+        }
+    }
+    tail_.store(tail, std::memory_order_release);
+}
+
+void SamplingProfiler::clear() {
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    stacks_.clear();
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t SamplingProfiler::get_sample_count() const {
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    uint64_t count = 0;
+    for (const auto& stack : stacks_) {
+        count += stack.second;
+    }
+    return count;
+}
+
+//=============================================================================
+// Symbols
+//=============================================================================
+
+std::string SamplingProfiler::symbolize(const void* address) {
+#if SAMPLING_PROFILER_SUPPORTED
+    Dl_info info;
+    if (dladdr(address, &info) != 0) {
+        if (info.dli_sname != nullptr) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+            free(demangled);
+            return name;
+        }
+        if (info.dli_fname != nullptr) {
+            const char* module = strrchr(info.dli_fname, '/');
+            module = module ? module + 1 : info.dli_fname;
+            char name[256];
+            snprintf(name, sizeof(name), "%s+0x%llx", module,
+                     static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(address) -
+                                                     reinterpret_cast<uintptr_t>(info.dli_fbase)));
+            return name;
+        }
+    }
+#endif
+    char name[32];
+    snprintf(name, sizeof(name), "0x%llx",
+             static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(address)));
+    return name;
+}
+
+std::vector<std::pair<std::vector<std::string>, uint64_t>> SamplingProfiler::symbolized_stacks() const {
+    std::map<const void*, std::string> names;
+    auto name_of = [&names](const void* address) -> const std::string& {
+        auto it = names.find(address);
+        if (it == names.end()) {
+            std::string name = symbolize(address);
+            std::replace(name.begin(), name.end(), ';', ',');   // The folded separator
+            it = names.emplace(address, name).first;
+        }
+        return it->second;
+    };
+
+    std::vector<std::pair<std::vector<std::string>, uint64_t>> result;
+    std::lock_guard<std::mutex> lock(stacks_mutex_);
+    result.reserve(stacks_.size());
+    for (const auto& stack : stacks_) {
+        std::vector<std::string> frames;
+        frames.reserve(stack.first.size());
+        for (size_t i = stack.first.size(); i-- > 0;) {
+            // Callers' frames hold return addresses, one past their call
+            const char* address = static_cast<const char*>(stack.first[i]);
+            frames.push_back(name_of(i == 0 ? address : address - 1));
+        }
+        result.emplace_back(std::move(frames), stack.second);
+    }
+    return result;
+}
+
+//=============================================================================
+// Reports
+//=============================================================================
+
+std::string SamplingProfiler::format_folded() const {
+    // Stacks that differ only in addresses inside the same functions merge
+    std::map<std::string, uint64_t> folded;
+    for (const auto& stack : symbolized_stacks()) {
+        std::string line;
+        for (const std::string& frame : stack.first) {
+            if (!line.empty()) line += ';';
+            line += frame;
+        }
+        folded[line] += stack.second;
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> lines(folded.begin(), folded.end());
+    std::stable_sort(lines.begin(), lines.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+
+    std::ostringstream out;
+    for (const auto& line : lines) {
+        out << line.first << ' ' << line.second << '\n';
+    }
+    return out.str();
+}
+
+bool SamplingProfiler::save_folded(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << format_folded();
+    return file.good();
+}
+
+std::string SamplingProfiler::format_top(int max_rows) const {
+    struct Row {
+        uint64_t self = 0;
+        uint64_t total = 0;
+    };
+    std::map<std::string, Row> rows;
+    uint64_t samples = 0;
+    for (const auto& stack : symbolized_stacks()) {
+        samples += stack.second;
+        if (!stack.first.empty()) {
+            rows[stack.first.back()].self += stack.second;
+        }
+        // Recursion counts a function once per sample
+        std::vector<const std::string*> seen;
+        for (const std::string& frame : stack.first) {
+            bool repeat = false;
+            for (const std::string* name : seen) {
+                if (*name == frame) {
+                    repeat = true;
+                    break;
+                }
+            }
+            if (!repeat) {
+                seen.push_back(&frame);
+                rows[frame].total += stack.second;
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, Row>> sorted(rows.begin(), rows.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.self != b.second.self ? a.second.self > b.second.self
+                                              : a.second.total > b.second.total;
+    });
+
+    std::ostringstream out;
+    char line[512];
+    snprintf(line, sizeof(line), "%8s %6s %8s %6s  %s\n", "self", "%", "total", "%", "function");
+    out << line;
+    int count = 0;
+    for (const auto& row : sorted) {
+        if (count++ >= max_rows) {
+            break;
+        }
+        snprintf(line, sizeof(line), "%8llu %5.1f%% %8llu %5.1f%%  %.400s\n",
+                 static_cast<unsigned long long>(row.second.self),
+                 samples ? 100.0 * row.second.self / samples : 0.0,
+                 static_cast<unsigned long long>(row.second.total),
+                 samples ? 100.0 * row.second.total / samples : 0.0, row.first.c_str());
+        out << line;
+    }
+    snprintf(line, sizeof(line), "%llu samples, %llu dropped\n",
+             static_cast<unsigned long long>(samples),
+             static_cast<unsigned long long>(get_dropped_count()));
+    out << line;
+    return out.str();
+}
@@ -0,0 +1,102 @@
+// src/platform/sampling_profiler.h
+// Sampling Profiler
+// Task 18h - Performance Optimization
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//=============================================================================
+// Sampling Profiler
+//=============================================================================
+
+// Where the main thread spends its time, without PROFILE_SCOPEs. A sampler
+// thread interrupts the thread that called start() with SIGPROF at a fixed
+// rate; the handler copies its call stack into a small lock-free ring and
+// the sampler thread folds the stacks into counts. Samples are wall-clock,
+// so waits (vsync, frame pacing, locks) show up as the calls that wait.
+//
+// Built into release builds and idle until started: F12 in game or
+// --sample-profile FILE toggle it. Reports are folded stacks, one line per
+// distinct stack ("main;GameClass::Run;...;Draw_Tactical 42"), which
+// flamegraph.pl, speedscope and Perfetto read directly.
+//
+// Symbols come from dladdr(), which only sees exported symbols: the game
+// links with ENABLE_EXPORTS (-rdynamic) for that. Frames it can't name are
+// written as module+offset, for addr2line against an unstripped build.
+//
+// POSIX only (Linux, macOS); elsewhere start() returns false.
+class SamplingProfiler {
+public:
+    static const int DEFAULT_RATE_HZ = 1000;
+    static const int MAX_RATE_HZ = 10000;
+    static const int MAX_DEPTH = 64;        // Frames kept per sample
+    static const int RING_SIZE = 256;       // Samples in flight, power of two
+
+    static SamplingProfiler& instance();
+
+    static bool is_supported();
+
+    // Start sampling the calling thread; keeps earlier samples (clear()
+    // drops them). False if unsupported or already running.
+    bool start(int rate_hz = DEFAULT_RATE_HZ);
+    void stop();
+    bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+    // Forget all samples
+    void clear();
+
+    // Samples folded so far, and samples lost to a full ring
+    uint64_t get_sample_count() const;
+    uint64_t get_dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Folded stacks, root first, one "frame;frame;... count" line each,
+    // heaviest first
+    std::string format_folded() const;
+    bool save_folded(const std::string& path) const;
+
+    // The max_rows functions with the most samples at the top of the stack
+    // (self) and anywhere in it (total)
+    std::string format_top(int max_rows = 20) const;
+
+    // Name for a code address: demangled symbol, else module+0xoffset
+    static std::string symbolize(const void* address);
+
+private:
+    SamplingProfiler() = default;
+    ~SamplingProfiler();
+
+    struct Slot {
+        int depth;
+        void* frames[MAX_DEPTH];
+    };
+
+    static void signal_handler(int signal);
+    void sampler_main(int interval_us);
+    void drain();
+
+    // Symbolized stacks, leaf last
+    std::vector<std::pair<std::vector<std::string>, uint64_t>> symbolized_stacks() const;
+
+    std::atomic<bool> running_{false};
+    std::thread sampler_;
+
+    // Single producer (the signal handler), single consumer (sampler thread)
+    Slot ring_[RING_SIZE];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    // Raw stacks, leaf first, to sample counts
+    mutable std::mutex stacks_mutex_;
+    std::map<std::vector<void*>, uint64_t> stacks_;
+};
+
+#endif // SAMPLING_PROFILER_H
@@ -0,0 +1,291 @@
+// src/platform/startup_trace.cpp
+// Startup Phase Timing
+// Task 18h - Performance Optimization
+
+#include "platform/startup_trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//=============================================================================
+// Process Counters
+//=============================================================================
+
+int64_t StartupTrace::get_wall_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t StartupTrace::get_cpu_ns() {
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return static_cast<int64_t>((k.QuadPart + u.QuadPart) * 100);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (static_cast<int64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+            usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000;
+#endif
+}
+
+uint64_t StartupTrace::get_bytes_read() {
+#if defined(_WIN32)
+    IO_COUNTERS io;
+    if (!GetProcessIoCounters(GetCurrentProcess(), &io)) {
+        return 0;
+    }
+    return io.ReadTransferCount;
+#elif defined(__linux__)
+    FILE* file = fopen("/proc/self/io", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    char line[128];
+    unsigned long long bytes = 0;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (sscanf(line, "rchar: %llu", &bytes) == 1) {
+            break;
+        }
+    }
+    fclose(file);
+    return bytes;
+#else
+    return 0;
+#endif
+}
+
+uint64_t StartupTrace::get_major_faults() {
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(usage.ru_majflt);
+#endif
+}
+
+StartupTrace::Sample StartupTrace::take_sample() {
+    Sample sample;
+    sample.wall_ns = get_wall_ns();
+    sample.cpu_ns = get_cpu_ns();
+    sample.bytes_read = get_bytes_read();
+    sample.major_faults = get_major_faults();
+    return sample;
+}
+
+//=============================================================================
+// Tracing
+//=============================================================================
+
+StartupTrace& StartupTrace::instance() {
+    static StartupTrace trace;
+    return trace;
+}
+
+void StartupTrace::start() {
+    phases_.clear();
+    open_.clear();
+    phases_.reserve(64);
+    open_.reserve(64);
+    depth_ = 0;
+    finished_ = false;
+    active_ = true;
+    start_ = take_sample();
+    end_ = start_;
+}
+
+void StartupTrace::finish() {
+    if (!active_) {
+        return;
+    }
+    end_ = take_sample();
+    active_ = false;
+    finished_ = true;
+}
+
+int StartupTrace::begin_phase(const char* name) {
+    if (!active_ || static_cast<int>(phases_.size()) >= MAX_PHASES) {
+        return -1;
+    }
+
+    Sample now = take_sample();
+    Phase phase;
+    phase.name = name;
+    phase.depth = depth_++;
+    phase.start_ns = now.wall_ns - start_.wall_ns;
+    phase.wall_ns = 0;
+    phase.cpu_ns = 0;
+    phase.bytes_read = 0;
+    phase.major_faults = 0;
+    phases_.push_back(phase);
+    open_.push_back(now);
+    return static_cast<int>(phases_.size()) - 1;
+}
+
+void StartupTrace::end_phase(int index) {
+    // A phase still open at finish() keeps zero counts
+    if (index < 0 || !active_) {
+        return;
+    }
+
+    Sample now = take_sample();
+    const Sample& begin = open_[index];
+    Phase& phase = phases_[index];
+    phase.wall_ns = now.wall_ns - begin.wall_ns;
+    phase.cpu_ns = now.cpu_ns - begin.cpu_ns;
+    phase.bytes_read = now.bytes_read - begin.bytes_read;
+    phase.major_faults = now.major_faults - begin.major_faults;
+    depth_--;
+}
+
+int64_t StartupTrace::get_total_wall_ns() const {
+    return (active_ ? get_wall_ns() : end_.wall_ns) - start_.wall_ns;
+}
+
+int64_t StartupTrace::get_total_cpu_ns() const {
+    return (active_ ? get_cpu_ns() : end_.cpu_ns) - start_.cpu_ns;
+}
+
+uint64_t StartupTrace::get_total_bytes_read() const {
+    return (active_ ? get_bytes_read() : end_.bytes_read) - start_.bytes_read;
+}
+
+uint64_t StartupTrace::get_total_major_faults() const {
+    return (active_ ? get_major_faults() : end_.major_faults) - start_.major_faults;
+}
+
+//=============================================================================
+// Reports
+//=============================================================================
+
+std::string StartupTrace::format_report() const {
+    // Repeated phases (one per preloaded file, say) fold into one row
+    struct Row {
+        const Phase* first;
+        int calls;
+        int64_t wall_ns;
+        int64_t cpu_ns;
+        uint64_t bytes_read;
+        uint64_t major_faults;
+    };
+    std::vector<Row> rows;
+    int64_t covered_ns = 0;
+    for (const Phase& phase : phases_) {
+        Row* row = nullptr;
+        for (Row& existing : rows) {
+            if (existing.first->depth == phase.depth && existing.first->name == phase.name) {
+                row = &existing;
+                break;
+            }
+        }
+        if (row == nullptr) {
+            rows.push_back(Row{&phase, 0, 0, 0, 0, 0});
+            row = &rows.back();
+        }
+        row->calls++;
+        row->wall_ns += phase.wall_ns;
+        row->cpu_ns += phase.cpu_ns;
+        row->bytes_read += phase.bytes_read;
+        row->major_faults += phase.major_faults;
+        if (phase.depth == 0) {
+            covered_ns += phase.wall_ns;
+        }
+    }
+
+    int64_t total_ns = get_total_wall_ns();
+    double total_ms = total_ns / 1000000.0;
+    auto percent = [total_ns](int64_t ns) {
+        return total_ns > 0 ? 100.0 * ns / total_ns : 0.0;
+    };
+
+    std::ostringstream out;
+    char line[256];
+    snprintf(line, sizeof(line), "%-34s %10s %6s %10s %10s %8s %6s\n",
+             "Startup phase", "wall ms", "%", "cpu ms", "read KB", "faults", "calls");
+    out << line;
+    for (const Row& row : rows) {
+        std::string name(row.first->depth * 2, ' ');
+        name += row.first->name;
+        snprintf(line, sizeof(line), "%-34s %10.2f %5.1f%% %10.2f %10.1f %8llu %6d\n",
+                 name.c_str(), row.wall_ns / 1000000.0, percent(row.wall_ns),
+                 row.cpu_ns / 1000000.0, row.bytes_read / 1024.0,
+                 static_cast<unsigned long long>(row.major_faults), row.calls);
+        out << line;
+    }
+    snprintf(line, sizeof(line), "%-34s %10.2f %5.1f%%\n", "(outside any phase)",
+             (total_ns - covered_ns) / 1000000.0, percent(total_ns - covered_ns));
+    out << line;
+    snprintf(line, sizeof(line), "%-34s %10.2f %5.1f%% %10.2f %10.1f %8llu\n", "Total",
+             total_ms, total_ns > 0 ? 100.0 : 0.0, get_total_cpu_ns() / 1000000.0,
+             get_total_bytes_read() / 1024.0,
+             static_cast<unsigned long long>(get_total_major_faults()));
+    out << line;
+    return out.str();
+}
+
+std::string StartupTrace::export_chrome_trace() const {
+    std::ostringstream out;
+    out << "{\"traceEvents\":[\n";
+
+    // The whole launch as the outermost span
+    out << "{\"name\":\"Startup\","
+        << "\"cat\":\"startup\","
+        << "\"ph\":\"X\","
+        << "\"ts\":0,"
+        << "\"dur\":" << get_total_wall_ns() / 1000 << ","
+        << "\"pid\":1,"
+        << "\"tid\":0,"
+        << "\"args\":{\"cpu_ms\":" << get_total_cpu_ns() / 1000000.0
+        << ",\"bytes_read\":" << get_total_bytes_read()
+        << ",\"major_faults\":" << get_total_major_faults() << "}}";
+
+    for (const Phase& phase : phases_) {
+        std::string name;
+        for (char c : phase.name) {
+            if (c == '"' || c == '\\') name += '\\';
+            name += c;
+        }
+        out << ",\n{\"name\":\"" << name << "\","
+            << "\"cat\":\"startup\","
+            << "\"ph\":\"X\","
+            << "\"ts\":" << phase.start_ns / 1000 << ","
+            << "\"dur\":" << phase.wall_ns / 1000 << ","
+            << "\"pid\":1,"
+            << "\"tid\":0,"
+            << "\"args\":{\"cpu_ms\":" << phase.cpu_ns / 1000000.0
+            << ",\"bytes_read\":" << phase.bytes_read
+            << ",\"major_faults\":" << phase.major_faults << "}}";
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.str();
+}
+
+bool StartupTrace::save_chrome_trace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << export_chrome_trace();
+    return file.good();
+}
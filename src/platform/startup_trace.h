@@ -0,0 +1,119 @@
+// src/platform/startup_trace.h
+// Startup Phase Timing
+// Task 18h - Performance Optimization
+
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Startup Trace
+//=============================================================================
+
+// Where the time from launch to the main menu goes. GameClass::Initialize
+// starts the trace and finishes it once the menu is up; every
+// STARTUP_PHASE in between records its wall time, the process CPU time
+// spent in it and what it read from disk:
+//
+//   bytes_read    bytes through read() and friends (Linux: /proc/self/io
+//                 rchar, Windows: the process I/O counters)
+//   major_faults  pages faulted in from disk, which is how mapped MIX
+//                 files and the asset pack are read (POSIX only)
+//
+// Counters a platform lacks read as zero. Unlike PROFILE_SCOPE the phases
+// are built into release builds, where cold start matters; outside the
+// startup window they cost one branch. Main thread only.
+class StartupTrace {
+public:
+    struct Phase {
+        std::string name;
+        int depth;              // Phases open around this one
+        int64_t start_ns;       // Since start()
+        int64_t wall_ns;
+        int64_t cpu_ns;
+        uint64_t bytes_read;
+        uint64_t major_faults;
+    };
+
+    // Phases past this are dropped (a runaway loop of preloads)
+    static const int MAX_PHASES = 1024;
+
+    static StartupTrace& instance();
+
+    // Forget any earlier trace and start timing from now
+    void start();
+
+    // Stop taking phases; totals run from start() to here
+    void finish();
+
+    bool is_active() const { return active_; }
+    bool is_finished() const { return finished_; }
+
+    // Open a phase; returns its index, or -1 when not tracing
+    int begin_phase(const char* name);
+    void end_phase(int index);
+
+    const std::vector<Phase>& get_phases() const { return phases_; }
+
+    // start() to finish(), or to now while still tracing
+    int64_t get_total_wall_ns() const;
+    int64_t get_total_cpu_ns() const;
+    uint64_t get_total_bytes_read() const;
+    uint64_t get_total_major_faults() const;
+
+    // A table of the phases, repeated ones summed by name, in the order
+    // they first ran, with the time no phase covered and the totals
+    std::string format_report() const;
+
+    // Chrome tracing format (chrome://tracing, Perfetto)
+    std::string export_chrome_trace() const;
+    bool save_chrome_trace(const std::string& path) const;
+
+    // Process counters the phases are measured with
+    static int64_t get_wall_ns();
+    static int64_t get_cpu_ns();
+    static uint64_t get_bytes_read();
+    static uint64_t get_major_faults();
+
+private:
+    StartupTrace() = default;
+
+    struct Sample {
+        int64_t wall_ns = 0;
+        int64_t cpu_ns = 0;
+        uint64_t bytes_read = 0;
+        uint64_t major_faults = 0;
+    };
+    static Sample take_sample();
+
+    bool active_ = false;
+    bool finished_ = false;
+    int depth_ = 0;
+    Sample start_;
+    Sample end_;
+    std::vector<Phase> phases_;
+    std::vector<Sample> open_;      // Start sample of each phase, by index
+};
+
+// Times a phase for as long as it is in scope
+class StartupPhaseScope {
+public:
+    explicit StartupPhaseScope(const char* name)
+        : index_(StartupTrace::instance().begin_phase(name)) {}
+    ~StartupPhaseScope() { StartupTrace::instance().end_phase(index_); }
+
+    StartupPhaseScope(const StartupPhaseScope&) = delete;
+    StartupPhaseScope& operator=(const StartupPhaseScope&) = delete;
+
+private:
+    int index_;
+};
+
+#define STARTUP_CONCAT_INNER(a, b) a##b
+#define STARTUP_CONCAT(a, b) STARTUP_CONCAT_INNER(a, b)
+#define STARTUP_PHASE(name) StartupPhaseScope STARTUP_CONCAT(_startup_phase_, __LINE__)(name)
+
+#endif // STARTUP_TRACE_H
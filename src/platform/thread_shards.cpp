@@ -0,0 +1,58 @@
+// src/platform/thread_shards.cpp
+// Per-Thread Counter Shards Implementation
+// Task 18h - Performance Optimization
+
+#include "platform/thread_shards.h"
+#include <atomic>
+#include <cstdint>
+
+static_assert(ThreadShards::MAX_SHARDS <= 32, "Claimed shards are tracked in a 32-bit mask");
+
+// Bit i set while some thread holds shard i; SHARED_SHARD is never handed out
+static std::atomic<uint32_t> s_claimed{0};
+
+thread_local int ThreadShards::t_index_ = -1;
+
+// Lives in the thread's thread_local storage from its first claim()
+struct ThreadShards::Release {
+    int index = SHARED_SHARD;
+
+    ~Release() {
+        // Anything the thread counts after this goes to the shared shard
+        t_index_ = SHARED_SHARD;
+        if (index != SHARED_SHARD) {
+            s_claimed.fetch_and(~(1u << index), std::memory_order_release);
+        }
+    }
+};
+
+//=============================================================================
+// ThreadShards Implementation
+//=============================================================================
+
+int ThreadShards::claim() {
+    int index = SHARED_SHARD;
+    uint32_t claimed = s_claimed.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t free = ~claimed & ((1u << SHARED_SHARD) - 1);
+        if (free == 0) {
+            break;
+        }
+        int candidate = __builtin_ctz(free);
+        if (s_claimed.compare_exchange_weak(claimed, claimed | (1u << candidate),
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            index = candidate;
+            break;
+        }
+    }
+
+    t_index_ = index;
+    thread_local Release release;
+    release.index = index;
+    return index;
+}
+
+int ThreadShards::get_claimed_count() {
+    return __builtin_popcount(s_claimed.load(std::memory_order_relaxed));
+}
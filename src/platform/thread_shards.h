@@ -0,0 +1,92 @@
+// src/platform/thread_shards.h
+// Per-Thread Counter Shards
+// Task 18h - Performance Optimization
+
+#ifndef THREAD_SHARDS_H
+#define THREAD_SHARDS_H
+
+#include <cstddef>
+
+//=============================================================================
+// Thread Shard Index
+//=============================================================================
+
+// Statistics bumped from several threads at once make their cache line
+// bounce between cores, even when each thread touches a different field
+// (false sharing), and a shared atomic serialises every update. Sharded,
+// each thread counts into its own cache-line-aligned copy and a reader
+// merges the copies, typically once a frame.
+//
+// A thread takes a shard index on first use and gives it back when it
+// exits, so indices stay dense as job workers and loader threads come and
+// go. Threads beyond the first MAX_SHARDS - 1 alive at once, and threads
+// in their exit teardown, all use SHARED_SHARD; shard contents that are
+// not atomic must only be written by threads that got their own.
+
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+class ThreadShards {
+public:
+    static constexpr int MAX_SHARDS = 32;
+    static constexpr int SHARED_SHARD = MAX_SHARDS - 1;
+
+    // Calling thread's shard, in [0, MAX_SHARDS). Lock-free and never
+    // allocates, so it is safe inside operator new.
+    static int index() {
+        int index = t_index_;
+        return index >= 0 ? index : claim();
+    }
+
+    // Shards held by live threads
+    static int get_claimed_count();
+
+private:
+    struct Release;                         // Hands the index back at thread exit
+
+    static int claim();
+
+    static thread_local int t_index_;       // -1 until claimed
+};
+
+//=============================================================================
+// Sharded Statistics
+//=============================================================================
+
+// One T per shard, each on its own cache lines. Writers go through
+// local(); merge() sums the shards with T::operator+= and is meant for the
+// frame boundary. With plain fields in T, merge() and reset() must not
+// overlap a writer (call them between job batches); with atomic fields
+// they may run at any time.
+template <typename T>
+class ThreadSharded {
+public:
+    // Calling thread's copy
+    T& local() { return shards_[ThreadShards::index()].value; }
+
+    T& shard(int index) { return shards_[index].value; }
+    const T& shard(int index) const { return shards_[index].value; }
+
+    // Sum of every shard
+    T merge() const {
+        T total{};
+        for (const Shard& shard : shards_) {
+            total += shard.value;
+        }
+        return total;
+    }
+
+    void reset() {
+        for (Shard& shard : shards_) {
+            shard.value = T{};
+        }
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        T value{};
+    };
+
+    Shard shards_[ThreadShards::MAX_SHARDS];
+};
+
+#endif // THREAD_SHARDS_H
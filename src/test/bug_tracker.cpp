@@ -6,6 +6,8 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
 
 //=============================================================================
 // BugReport Implementation
@@ -248,6 +250,9 @@ bool BugRegistry::load_from_file(const std::string& path) {
                 else if (key == "PRIORITY") current.priority = string_to_priority(value);
                 else if (key == "STATUS") current.status = string_to_status(value);
                 else if (key == "CATEGORY") current.category = string_to_category(value);
+                else if (key == "TEST") current.linked_test = value;
+                else if (key == "ACTUAL") current.actual_behavior = value;
+                else if (key == "FIXED") current.fixed_date = static_cast<time_t>(std::stoll(value));
             }
         }
     }
@@ -256,6 +261,18 @@ bool BugRegistry::load_from_file(const std::string& path) {
         bugs_[current.id] = current;
     }
 
+    // New bugs continue the numbering; linked tests find their bugs again
+    test_to_bug_.clear();
+    next_id_ = 1;
+    for (const auto& pair : bugs_) {
+        if (pair.first.size() > 4 && pair.first.compare(0, 4, "BUG-") == 0) {
+            next_id_ = std::max(next_id_, std::atoi(pair.first.c_str() + 4) + 1);
+        }
+        if (!pair.second.linked_test.empty()) {
+            test_to_bug_[pair.second.linked_test] = pair.first;
+        }
+    }
+
     return true;
 }
 
@@ -273,6 +290,15 @@ bool BugRegistry::save_to_file(const std::string& path) const {
         file << "PRIORITY:" << priority_to_string(bug.priority) << "\n";
         file << "STATUS:" << status_to_string(bug.status) << "\n";
         file << "CATEGORY:" << category_to_string(bug.category) << "\n";
+        if (!bug.linked_test.empty()) {
+            file << "TEST:" << bug.linked_test << "\n";
+        }
+        if (!bug.actual_behavior.empty()) {
+            file << "ACTUAL:" << bug.actual_behavior << "\n";
+        }
+        if (bug.fixed_date != 0) {
+            file << "FIXED:" << static_cast<long long>(bug.fixed_date) << "\n";
+        }
         file << "\n";
     }
 
@@ -389,6 +415,42 @@ bool RegressionTracker::check_regression(const std::string& test_name, bool test
     return false;
 }
 
+std::string RegressionTracker::record_perf_regression(const std::string& metric,
+                                                     const std::string& details) {
+    BugRegistry& registry = BugRegistry::instance();
+    std::string bug_id = registry.get_bug_for_test(metric);
+    const BugReport* bug = bug_id.empty() ? nullptr : registry.get_bug(bug_id);
+
+    if (bug == nullptr) {
+        BugReport report = BugReportBuilder()
+            .title("Performance regression: " + metric)
+            .description("Significantly worse than the recorded baseline")
+            .severity(BugSeverity::MEDIUM)
+            .priority(BugPriority::P1)
+            .category(BugCategory::PERFORMANCE)
+            .actual(details)
+            .reporter("perf baseline")
+            .linked_test(metric)
+            .build();
+        bug_id = registry.add_bug(report);
+        registry.link_test_to_bug(metric, bug_id);
+    } else {
+        BugReport updated = *bug;
+        updated.actual_behavior = details;
+        registry.update_bug(bug_id, updated);
+        if (!updated.is_open()) {
+            // Slowed down again after a fix
+            registry.mark_regression(bug_id);
+        }
+    }
+
+    if (std::find(detected_regressions_.begin(), detected_regressions_.end(),
+                  bug_id) == detected_regressions_.end()) {
+        detected_regressions_.push_back(bug_id);
+    }
+    return bug_id;
+}
+
 std::vector<std::string> RegressionTracker::get_regressions() const {
     return detected_regressions_;
 }
@@ -171,6 +171,11 @@ public:
     // Check for regressions
     bool check_regression(const std::string& test_name, bool test_passed);
 
+    // Record a metric that got significantly worse than its baseline. Files
+    // a PERFORMANCE bug linked to the metric, or reopens the one it has;
+    // returns the bug id.
+    std::string record_perf_regression(const std::string& metric, const std::string& details);
+
     // Get regression info
     std::vector<std::string> get_regressions() const;
     void clear_regressions();
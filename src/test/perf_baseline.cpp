@@ -0,0 +1,586 @@
+// src/test/perf_baseline.cpp
+// Performance Baselines and Regression Detection Implementation
+// Task 18g - Bug Tracking
+
+#include "test/perf_baseline.h"
+#include "test/bug_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+//=============================================================================
+// JSON Reading
+//=============================================================================
+
+namespace {
+
+// Just enough JSON for the files this module writes
+struct JsonValue {
+    enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* get(const char* key) const {
+        for (const auto& member : object) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text)
+        : p_(text.c_str()), end_(text.c_str() + text.size()) {}
+
+    bool parse_document(JsonValue& value) {
+        if (!parse(value, 0)) {
+            return false;
+        }
+        skip_space();
+        return p_ == end_;
+    }
+
+private:
+    static const int MAX_DEPTH = 32;
+
+    void skip_space() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            p_++;
+        }
+    }
+
+    bool literal(const char* word) {
+        size_t length = std::char_traits<char>::length(word);
+        if (static_cast<size_t>(end_ - p_) < length || std::string(p_, length) != word) {
+            return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+    bool parse_string(std::string& out) {
+        if (p_ >= end_ || *p_ != '"') {
+            return false;
+        }
+        p_++;
+        while (p_ < end_ && *p_ != '"') {
+            char c = *p_++;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (p_ >= end_) {
+                return false;
+            }
+            char escape = *p_++;
+            switch (escape) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // Only ASCII is ever written; anything else becomes '?'
+                    if (end_ - p_ < 4) {
+                        return false;
+                    }
+                    long code = std::strtol(std::string(p_, 4).c_str(), nullptr, 16);
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    p_ += 4;
+                    break;
+                }
+                default: out += escape; break;
+            }
+        }
+        if (p_ >= end_) {
+            return false;
+        }
+        p_++;
+        return true;
+    }
+
+    bool parse(JsonValue& value, int depth) {
+        if (depth > MAX_DEPTH) {
+            return false;
+        }
+        skip_space();
+        if (p_ >= end_) {
+            return false;
+        }
+
+        if (*p_ == '{') {
+            value.type = JsonValue::OBJECT;
+            p_++;
+            skip_space();
+            if (p_ < end_ && *p_ == '}') {
+                p_++;
+                return true;
+            }
+            for (;;) {
+                std::pair<std::string, JsonValue> member;
+                skip_space();
+                if (!parse_string(member.first)) {
+                    return false;
+                }
+                skip_space();
+                if (p_ >= end_ || *p_++ != ':') {
+                    return false;
+                }
+                if (!parse(member.second, depth + 1)) {
+                    return false;
+                }
+                value.object.push_back(std::move(member));
+                skip_space();
+                if (p_ < end_ && *p_ == ',') {
+                    p_++;
+                } else if (p_ < end_ && *p_ == '}') {
+                    p_++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (*p_ == '[') {
+            value.type = JsonValue::ARRAY;
+            p_++;
+            skip_space();
+            if (p_ < end_ && *p_ == ']') {
+                p_++;
+                return true;
+            }
+            for (;;) {
+                JsonValue element;
+                if (!parse(element, depth + 1)) {
+                    return false;
+                }
+                value.array.push_back(std::move(element));
+                skip_space();
+                if (p_ < end_ && *p_ == ',') {
+                    p_++;
+                } else if (p_ < end_ && *p_ == ']') {
+                    p_++;
+                    return true;
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (*p_ == '"') {
+            value.type = JsonValue::STRING;
+            return parse_string(value.string);
+        }
+        if (literal("true") || literal("false")) {
+            value.type = JsonValue::BOOLEAN;
+            value.boolean = p_[-1] == 'e' && p_[-2] == 'u';   // "true", not "false"
+            return true;
+        }
+        if (literal("null")) {
+            value.type = JsonValue::NUL;
+            return true;
+        }
+
+        std::string number(p_, std::min<size_t>(end_ - p_, 64));
+        char* stop = nullptr;
+        value.number = std::strtod(number.c_str(), &stop);
+        if (stop == number.c_str()) {
+            return false;
+        }
+        value.type = JsonValue::NUMBER;
+        p_ += stop - number.c_str();
+        return true;
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+bool Read_Json_File(const std::string& path, JsonValue& root) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+    return JsonParser(text).parse_document(root) && root.type == JsonValue::OBJECT;
+}
+
+bool Read_Series_List(const JsonValue* list, std::vector<PerfSeries>& out) {
+    if (list == nullptr || list->type != JsonValue::ARRAY) {
+        return false;
+    }
+    for (const JsonValue& entry : list->array) {
+        const JsonValue* name = entry.get("name");
+        const JsonValue* samples = entry.get("samples");
+        if (name == nullptr || name->type != JsonValue::STRING ||
+            samples == nullptr || samples->type != JsonValue::ARRAY) {
+            return false;
+        }
+        PerfSeries series;
+        series.name = name->string;
+        if (const JsonValue* unit = entry.get("unit")) {
+            series.unit = unit->string;
+        }
+        if (const JsonValue* better = entry.get("better")) {
+            series.higher_is_better = better->string == "higher";
+        }
+        for (const JsonValue& sample : samples->array) {
+            if (sample.type == JsonValue::NUMBER) {
+                series.samples.push_back(sample.number);
+            }
+        }
+        out.push_back(std::move(series));
+    }
+    return true;
+}
+
+} // namespace
+
+//=============================================================================
+// JSON Writing
+//=============================================================================
+
+std::string Perf_Json_Quote(const std::string& str) {
+    std::string result = "\"";
+    for (char c : str) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            case '\r': result += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[8];
+                    snprintf(code, sizeof(code), "\\u%04x", c);
+                    result += code;
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+    return result + "\"";
+}
+
+void Perf_Write_Series(std::ostream& out, const PerfSeries& series, const char* indent) {
+    out << indent << "{\"name\": " << Perf_Json_Quote(series.name)
+        << ", \"unit\": " << Perf_Json_Quote(series.unit)
+        << ", \"better\": \"" << (series.higher_is_better ? "higher" : "lower")
+        << "\", \"samples\": [";
+    out << std::setprecision(9);
+    for (size_t i = 0; i < series.samples.size(); i++) {
+        out << (i > 0 ? ", " : "") << series.samples[i];
+    }
+    out << "]}";
+}
+
+//=============================================================================
+// PerfRun
+//=============================================================================
+
+bool PerfRun::load_from_file(const std::string& path) {
+    JsonValue root;
+    if (!Read_Json_File(path, root)) {
+        return false;
+    }
+    host.clear();
+    series.clear();
+    if (const JsonValue* value = root.get("host")) {
+        host = value->string;
+    }
+    return Read_Series_List(root.get("metrics"), series);
+}
+
+bool PerfRun::save_to_file(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "{\n  \"format\": 1,\n  \"host\": " << Perf_Json_Quote(host)
+         << ",\n  \"metrics\": [\n";
+    for (size_t i = 0; i < series.size(); i++) {
+        Perf_Write_Series(file, series[i], "    ");
+        file << (i + 1 < series.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+    return file.good();
+}
+
+//=============================================================================
+// Host Fingerprint
+//=============================================================================
+
+static std::string Cpu_Model() {
+#if defined(__APPLE__)
+    char brand[256] = {};
+    size_t size = sizeof(brand);
+    if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) == 0) {
+        return brand;
+    }
+#elif defined(__linux__)
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(" \t", colon + 1);
+                return start == std::string::npos ? "" : line.substr(start);
+            }
+        }
+    }
+#endif
+    return "unknown cpu";
+}
+
+std::string Perf_Host_Fingerprint() {
+    std::ostringstream oss;
+
+#if defined(_WIN32)
+    oss << "windows";
+#elif defined(__APPLE__)
+    oss << "macos";
+#elif defined(__linux__)
+    oss << "linux";
+#else
+    oss << "unknown";
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    oss << "-x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    oss << "-arm64";
+#else
+    oss << "-other";
+#endif
+
+    oss << " | " << Cpu_Model()
+        << " | " << std::thread::hardware_concurrency() << " threads | ";
+
+#if defined(__clang__)
+    oss << "clang " << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+    oss << "gcc " << __GNUC__ << "." << __GNUC_MINOR__;
+#elif defined(_MSC_VER)
+    oss << "msvc " << _MSC_VER;
+#else
+    oss << "unknown compiler";
+#endif
+
+#ifdef NDEBUG
+    oss << " release";
+#else
+    oss << " debug";
+#endif
+    return oss.str();
+}
+
+//=============================================================================
+// PerfBaseline
+//=============================================================================
+
+bool PerfBaseline::load_from_file(const std::string& path) {
+    JsonValue root;
+    if (!Read_Json_File(path, root)) {
+        return false;
+    }
+    hosts_.clear();
+    const JsonValue* hosts = root.get("hosts");
+    if (hosts == nullptr || hosts->type != JsonValue::OBJECT) {
+        return false;
+    }
+    for (const auto& host : hosts->object) {
+        if (!Read_Series_List(host.second.get("metrics"), hosts_[host.first])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PerfBaseline::save_to_file(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "{\n  \"format\": 1,\n  \"hosts\": {";
+    bool first_host = true;
+    for (const auto& host : hosts_) {
+        file << (first_host ? "\n" : ",\n") << "    " << Perf_Json_Quote(host.first)
+             << ": {\n      \"metrics\": [\n";
+        for (size_t i = 0; i < host.second.size(); i++) {
+            Perf_Write_Series(file, host.second[i], "        ");
+            file << (i + 1 < host.second.size() ? ",\n" : "\n");
+        }
+        file << "      ]\n    }";
+        first_host = false;
+    }
+    file << "\n  }\n}\n";
+    return file.good();
+}
+
+const std::vector<PerfSeries>* PerfBaseline::get_host(const std::string& host) const {
+    auto it = hosts_.find(host);
+    return it != hosts_.end() ? &it->second : nullptr;
+}
+
+void PerfBaseline::update(const PerfRun& run) {
+    std::vector<PerfSeries>& stored = hosts_[run.host];
+    for (const PerfSeries& series : run.series) {
+        auto it = std::find_if(stored.begin(), stored.end(),
+            [&](const PerfSeries& s) { return s.name == series.name; });
+        if (it != stored.end()) {
+            *it = series;
+        } else {
+            stored.push_back(series);
+        }
+    }
+}
+
+std::vector<std::string> PerfBaseline::get_hosts() const {
+    std::vector<std::string> hosts;
+    for (const auto& host : hosts_) {
+        hosts.push_back(host.first);
+    }
+    return hosts;
+}
+
+//=============================================================================
+// Comparison
+//=============================================================================
+
+static double Median(std::vector<double> values) {
+    size_t count = values.size();
+    std::nth_element(values.begin(), values.begin() + count / 2, values.end());
+    double upper = values[count / 2];
+    if (count % 2) {
+        return upper;
+    }
+    return (*std::max_element(values.begin(), values.begin() + count / 2) + upper) / 2.0;
+}
+
+std::vector<PerfComparison> Perf_Compare(const std::vector<PerfSeries>& baseline,
+                                         const std::vector<PerfSeries>& current,
+                                         const PerfCompareOptions& options) {
+    std::vector<PerfComparison> comparisons;
+    std::mt19937 rng(options.seed);
+
+    for (const PerfSeries& series : current) {
+        PerfComparison cmp;
+        cmp.name = series.name;
+        cmp.unit = series.unit;
+        cmp.higher_is_better = series.higher_is_better;
+
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+            [&](const PerfSeries& s) { return s.name == series.name; });
+        if (base == baseline.end()) {
+            cmp.verdict = PerfVerdict::NEW_METRIC;
+            comparisons.push_back(cmp);
+            continue;
+        }
+        if (series.samples.size() < 2 || base->samples.size() < 2) {
+            cmp.verdict = PerfVerdict::TOO_FEW_SAMPLES;
+            comparisons.push_back(cmp);
+            continue;
+        }
+
+        cmp.baseline_median = Median(base->samples);
+        cmp.current_median = Median(series.samples);
+        if (cmp.baseline_median <= 0.0) {
+            // A zero baseline has no relative change to speak of
+            cmp.verdict = PerfVerdict::UNCHANGED;
+            comparisons.push_back(cmp);
+            continue;
+        }
+        cmp.change = cmp.current_median / cmp.baseline_median - 1.0;
+
+        // Percentile bootstrap: resample each side with replacement
+        std::vector<double> changes;
+        changes.reserve(options.resamples);
+        std::vector<double> old_draw(base->samples.size());
+        std::vector<double> new_draw(series.samples.size());
+        std::uniform_int_distribution<size_t> pick_old(0, base->samples.size() - 1);
+        std::uniform_int_distribution<size_t> pick_new(0, series.samples.size() - 1);
+        for (int r = 0; r < options.resamples; r++) {
+            for (double& v : old_draw) v = base->samples[pick_old(rng)];
+            for (double& v : new_draw) v = series.samples[pick_new(rng)];
+            double old_median = Median(old_draw);
+            if (old_median > 0.0) {
+                changes.push_back(Median(new_draw) / old_median - 1.0);
+            }
+        }
+        if (changes.empty()) {
+            cmp.verdict = PerfVerdict::UNCHANGED;
+            comparisons.push_back(cmp);
+            continue;
+        }
+        std::sort(changes.begin(), changes.end());
+        double tail = (1.0 - options.confidence) / 2.0;
+        size_t last = changes.size() - 1;
+        cmp.ci_low = changes[static_cast<size_t>(tail * last)];
+        cmp.ci_high = changes[static_cast<size_t>((1.0 - tail) * last)];
+
+        // "Worse" is up for times and down for rates
+        double worse = series.higher_is_better ? -cmp.change : cmp.change;
+        double worse_low = series.higher_is_better ? -cmp.ci_high : cmp.ci_low;
+        double worse_high = series.higher_is_better ? -cmp.ci_low : cmp.ci_high;
+        if (worse_low > 0.0 && worse > options.threshold) {
+            cmp.verdict = PerfVerdict::REGRESSED;
+        } else if (worse_high < 0.0 && -worse > options.threshold) {
+            cmp.verdict = PerfVerdict::IMPROVED;
+        } else {
+            cmp.verdict = PerfVerdict::UNCHANGED;
+        }
+        comparisons.push_back(cmp);
+    }
+    return comparisons;
+}
+
+int Perf_Record_Regressions(const std::vector<PerfComparison>& comparisons,
+                            const std::string& host) {
+    int count = 0;
+    for (const PerfComparison& cmp : comparisons) {
+        if (cmp.verdict != PerfVerdict::REGRESSED) {
+            continue;
+        }
+        std::ostringstream details;
+        details << std::fixed << std::setprecision(3)
+                << "median " << cmp.baseline_median << " -> " << cmp.current_median
+                << " " << cmp.unit << " (" << std::showpos << std::setprecision(1)
+                << cmp.change * 100.0 << "%, CI " << cmp.ci_low * 100.0 << "%.."
+                << cmp.ci_high * 100.0 << "%) on " << std::noshowpos << host;
+        RegressionTracker::instance().record_perf_regression(cmp.name, details.str());
+        count++;
+    }
+    return count;
+}
+
+const char* verdict_to_string(PerfVerdict verdict) {
+    switch (verdict) {
+        case PerfVerdict::UNCHANGED: return "ok";
+        case PerfVerdict::REGRESSED: return "REGRESSED";
+        case PerfVerdict::IMPROVED: return "improved";
+        case PerfVerdict::NEW_METRIC: return "new";
+        case PerfVerdict::TOO_FEW_SAMPLES: return "too few samples";
+        default: return "unknown";
+    }
+}
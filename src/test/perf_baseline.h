@@ -0,0 +1,122 @@
+// src/test/perf_baseline.h
+// Performance Baselines and Regression Detection
+// Task 18g - Bug Tracking
+
+#ifndef PERF_BASELINE_H
+#define PERF_BASELINE_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Result Files
+//=============================================================================
+
+// One measured quantity, every sample of it from one run
+struct PerfSeries {
+    std::string name;            // "Test/Metric", unique within a host
+    std::string unit;            // "ms", "ns", "fps", ...
+    bool higher_is_better = false;
+    std::vector<double> samples;
+};
+
+// A run's results as PerformanceTests --json and RedAlertBench --json write
+// them:
+//
+//   { "format": 1, "host": "...",
+//     "metrics": [ { "name": "...", "unit": "ms", "better": "lower",
+//                    "samples": [ ... ] } ] }
+//
+// Other top-level keys ("tests", ...) are ignored when reading.
+struct PerfRun {
+    std::string host;
+    std::vector<PerfSeries> series;
+
+    bool load_from_file(const std::string& path);
+    bool save_to_file(const std::string& path) const;
+};
+
+// Identifies the machine and build numbers are comparable on: OS, CPU
+// architecture and model, hardware threads, compiler and build type
+std::string Perf_Host_Fingerprint();
+
+// JSON helpers shared by the writers
+std::string Perf_Json_Quote(const std::string& str);
+void Perf_Write_Series(std::ostream& out, const PerfSeries& series, const char* indent);
+
+//=============================================================================
+// Baselines
+//=============================================================================
+
+// Reference samples per host fingerprint, so one file can hold every CI
+// runner and developer machine without comparing across them:
+//
+//   { "format": 1,
+//     "hosts": { "<fingerprint>": { "metrics": [ ... ] } } }
+class PerfBaseline {
+public:
+    bool load_from_file(const std::string& path);
+    bool save_to_file(const std::string& path) const;
+
+    // Baseline series for a host, nullptr if it has none
+    const std::vector<PerfSeries>* get_host(const std::string& host) const;
+
+    // Replace the run host's series with the run's, keeping any it lacks
+    void update(const PerfRun& run);
+
+    std::vector<std::string> get_hosts() const;
+
+private:
+    std::map<std::string, std::vector<PerfSeries>> hosts_;
+};
+
+//=============================================================================
+// Comparison
+//=============================================================================
+
+enum class PerfVerdict {
+    UNCHANGED,
+    REGRESSED,
+    IMPROVED,
+    NEW_METRIC,       // Not in the baseline
+    TOO_FEW_SAMPLES   // Fewer than two samples on a side
+};
+
+struct PerfCompareOptions {
+    double threshold = 0.05;     // Smallest relative change worth flagging
+    double confidence = 0.95;    // Confidence interval level
+    int resamples = 2000;        // Bootstrap resamples
+    uint32_t seed = 1;           // Resampling is deterministic
+};
+
+struct PerfComparison {
+    std::string name;
+    std::string unit;
+    bool higher_is_better = false;
+    double baseline_median = 0.0;
+    double current_median = 0.0;
+    double change = 0.0;         // current / baseline - 1, of the medians
+    double ci_low = 0.0;         // Bootstrap interval of change
+    double ci_high = 0.0;
+    PerfVerdict verdict = PerfVerdict::UNCHANGED;
+};
+
+// Compare current against baseline series of the same names. The change in
+// median is bootstrapped by resampling both sides; a metric regressed when
+// the whole interval lies on the worse side of zero and the point change
+// exceeds the threshold.
+std::vector<PerfComparison> Perf_Compare(const std::vector<PerfSeries>& baseline,
+                                         const std::vector<PerfSeries>& current,
+                                         const PerfCompareOptions& options);
+
+// File a tracked perf bug through RegressionTracker for every regression;
+// returns how many there were
+int Perf_Record_Regressions(const std::vector<PerfComparison>& comparisons,
+                            const std::string& host);
+
+const char* verdict_to_string(PerfVerdict verdict);
+
+#endif // PERF_BASELINE_H
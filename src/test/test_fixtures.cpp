@@ -4,22 +4,193 @@
 
 #include "test/test_fixtures.h"
 #include "platform.h"
+#include <algorithm>
+#include <cstdlib>
+
+//=============================================================================
+// TestEnvironment
+//=============================================================================
+
+TestEnvironment& TestEnvironment::Instance() {
+    static TestEnvironment instance;
+    return instance;
+}
+
+TestEnvironment::TestEnvironment() {
+    const char* env = std::getenv("TEST_ISOLATED");
+    isolated_ = env != nullptr && env[0] != '\0' && env[0] != '0';
+    memset(palette_, 0, sizeof(palette_));
+}
+
+bool TestEnvironment::RequirePlatform() {
+    if (Platform_IsInitialized()) {
+        return true;
+    }
+    // Whatever was registered went down with the last shutdown
+    ForgetAssets();
+    if (Platform_Init() != 0) {
+        return false;
+    }
+    init_count_++;
+    if (!teardown_registered_) {
+        TestRegistry::Instance().AddProcessTeardown([]() { TestEnvironment::Instance().Shutdown(); });
+        teardown_registered_ = true;
+    }
+    return true;
+}
+
+bool TestEnvironment::RequireGraphics() {
+    if (!RequirePlatform()) {
+        return false;
+    }
+    if (Platform_Graphics_IsInitialized()) {
+        return true;
+    }
+    if (Platform_Graphics_Init() != 0) {
+        return false;
+    }
+    init_count_++;
+
+    uint8_t* buffer;
+    int32_t w, h, p;
+    if (Platform_Graphics_GetBackBuffer(&buffer, &w, &h, &p) == 0) {
+        width_ = w;
+        height_ = h;
+    }
+    Platform_Graphics_GetPalette(palette_, 0, 256);
+    return true;
+}
+
+bool TestEnvironment::RequireAudio() {
+    if (!RequirePlatform()) {
+        return false;
+    }
+    if (Platform_Audio_IsInitialized()) {
+        return true;
+    }
+
+    AudioConfig config;
+    config.sample_rate = 22050;
+    config.channels = 2;
+    config.bits_per_sample = 16;
+    config.buffer_size = 1024;
+    if (Platform_Audio_Init(&config) != 0) {
+        return false;
+    }
+    init_count_++;
+    master_volume_ = Platform_Audio_GetMasterVolume();
+    return true;
+}
+
+bool TestEnvironment::RequireAssets() {
+    if (!RequirePlatform()) {
+        return false;
+    }
+    if (!assets_initialized_) {
+        assets_initialized_ = (Platform_Assets_Init() == 0);
+    }
+    return assets_initialized_;
+}
+
+bool TestEnvironment::RequireMix(const char* name) {
+    if (name == nullptr || !RequireAssets()) {
+        return false;
+    }
+    if (IsMixLoaded(name)) {
+        return true;
+    }
+
+    static const char* const dirs[] = {"", "gamedata/", "data/"};
+    for (const char* dir : dirs) {
+        std::string path = std::string(dir) + name;
+        if (Platform_Mix_Register(path.c_str()) == 0) {
+            mixes_.push_back(name);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TestEnvironment::IsMixLoaded(const char* name) const {
+    return name != nullptr && std::find(mixes_.begin(), mixes_.end(), name) != mixes_.end();
+}
+
+void TestEnvironment::Reset() {
+    if (!Platform_IsInitialized()) {
+        ForgetAssets();
+        return;
+    }
+    reset_count_++;
+
+    if (Platform_Graphics_IsInitialized()) {
+        uint8_t* buffer = nullptr;
+        int32_t w = 0, h = 0, p = 0;
+        if (Platform_Graphics_GetBackBuffer(&buffer, &w, &h, &p) == 0 && (w != width_ || h != height_)) {
+            // Changed under us; only a fresh init gets the default size back
+            Platform_Graphics_Shutdown();
+            RequireGraphics();
+        } else if (buffer != nullptr) {
+            for (int y = 0; y < h; y++) {
+                memset(buffer + y * p, 0, w);
+            }
+        }
+        Platform_Graphics_SetPalette(palette_, 0, 256);
+    }
+
+    if (Platform_Audio_IsInitialized()) {
+        Platform_Sound_StopAll();
+        Platform_Audio_SetMasterVolume(master_volume_);
+    }
+
+    Platform_Key_Clear();
+}
+
+void TestEnvironment::Release() {
+    if (isolated_) {
+        Shutdown();
+    } else {
+        Reset();
+    }
+}
+
+void TestEnvironment::Shutdown() {
+    if (Platform_Audio_IsInitialized()) {
+        Platform_Audio_Shutdown();
+    }
+    if (Platform_Graphics_IsInitialized()) {
+        Platform_Graphics_Shutdown();
+    }
+    if (Platform_IsInitialized()) {
+        Platform_Shutdown();
+    }
+    ForgetAssets();
+}
+
+void TestEnvironment::ForgetAssets() {
+    assets_initialized_ = false;
+    mixes_.clear();
+}
 
 //=============================================================================
 // PlatformFixture
 //=============================================================================
 
 void PlatformFixture::SetUp() {
-    initialized_ = (Platform_Init() == 0);
+    initialized_ = TestEnvironment::Instance().RequirePlatform();
 }
 
 void PlatformFixture::TearDown() {
     if (initialized_) {
-        Platform_Shutdown();
+        TestEnvironment::Instance().Release();
         initialized_ = false;
     }
 }
 
+void PlatformFixture::Reset() {
+    TestEnvironment::Instance().Reset();
+    SetUp();
+}
+
 //=============================================================================
 // GraphicsFixture
 //=============================================================================
@@ -28,7 +199,7 @@ void GraphicsFixture::SetUp() {
     PlatformFixture::SetUp();
     if (!initialized_) return;
 
-    graphics_initialized_ = (Platform_Graphics_Init() == 0);
+    graphics_initialized_ = TestEnvironment::Instance().RequireGraphics();
 
     if (graphics_initialized_) {
         uint8_t* buffer;
@@ -42,10 +213,7 @@ void GraphicsFixture::SetUp() {
 }
 
 void GraphicsFixture::TearDown() {
-    if (graphics_initialized_) {
-        Platform_Graphics_Shutdown();
-        graphics_initialized_ = false;
-    }
+    graphics_initialized_ = false;
     PlatformFixture::TearDown();
 }
 
@@ -77,20 +245,11 @@ void AudioFixture::SetUp() {
     PlatformFixture::SetUp();
     if (!initialized_) return;
 
-    AudioConfig config;
-    config.sample_rate = 22050;
-    config.channels = 2;
-    config.bits_per_sample = 16;
-    config.buffer_size = 1024;
-
-    audio_initialized_ = (Platform_Audio_Init(&config) == 0);
+    audio_initialized_ = TestEnvironment::Instance().RequireAudio();
 }
 
 void AudioFixture::TearDown() {
-    if (audio_initialized_) {
-        Platform_Audio_Shutdown();
-        audio_initialized_ = false;
-    }
+    audio_initialized_ = false;
     PlatformFixture::TearDown();
 }
 
@@ -106,26 +265,20 @@ void AssetFixture::SetUp() {
     PlatformFixture::SetUp();
     if (!initialized_) return;
 
-    // Initialize MixManager and load essential MIX files
-    // In real implementation:
-    // MixManager::Instance().Initialize();
-    // assets_loaded_ = MixManager::Instance().LoadMix("REDALERT.MIX");
-
-    assets_loaded_ = true;  // Placeholder
+    assets_loaded_ = TestEnvironment::Instance().RequireAssets();
 }
 
 void AssetFixture::TearDown() {
-    if (assets_loaded_) {
-        // MixManager::Instance().Shutdown();
-        assets_loaded_ = false;
-    }
+    assets_loaded_ = false;
     PlatformFixture::TearDown();
 }
 
 bool AssetFixture::IsMixLoaded(const char* mix_name) const {
-    (void)mix_name;  // Suppress unused parameter warning
-    // return MixManager::Instance().IsMixLoaded(mix_name);
-    return assets_loaded_;  // Placeholder
+    return assets_loaded_ && TestEnvironment::Instance().IsMixLoaded(mix_name);
+}
+
+bool AssetFixture::LoadMix(const char* mix_name) {
+    return assets_loaded_ && TestEnvironment::Instance().RequireMix(mix_name);
 }
 
 //=============================================================================
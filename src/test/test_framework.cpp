@@ -9,7 +9,19 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <map>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 //=============================================================================
 // TestResult Helpers
@@ -22,6 +34,7 @@ const char* TestResult_ToString(TestResult result) {
         case TestResult::SKIPPED: return "SKIPPED";
         case TestResult::TIMEOUT: return "TIMEOUT";
         case TestResult::CRASHED: return "CRASHED";
+        case TestResult::PERF_FAIL: return "PERF_FAIL";
         default: return "UNKNOWN";
     }
 }
@@ -71,6 +84,34 @@ void TestRegistry::Clear() {
     tests_.clear();
 }
 
+void TestRegistry::AddSuiteTeardown(const std::string& category, std::function<void()> func) {
+    suite_teardowns_[category].push_back(std::move(func));
+}
+
+void TestRegistry::EndSuite(const std::string& category) {
+    auto it = suite_teardowns_.find(category);
+    if (it == suite_teardowns_.end()) {
+        return;
+    }
+    std::vector<std::function<void()>> teardowns = std::move(it->second);
+    suite_teardowns_.erase(it);
+    for (auto func = teardowns.rbegin(); func != teardowns.rend(); ++func) {
+        (*func)();
+    }
+}
+
+void TestRegistry::AddProcessTeardown(std::function<void()> func) {
+    process_teardowns_.push_back(std::move(func));
+}
+
+void TestRegistry::EndProcess() {
+    std::vector<std::function<void()>> teardowns = std::move(process_teardowns_);
+    process_teardowns_.clear();
+    for (auto func = teardowns.rbegin(); func != teardowns.rend(); ++func) {
+        (*func)();
+    }
+}
+
 //=============================================================================
 // TestAssertionFailed
 //=============================================================================
@@ -90,11 +131,184 @@ TestSkipped::TestSkipped(const std::string& reason)
     : reason_(reason) {
 }
 
+//=============================================================================
+// Test Metrics
+//=============================================================================
+
+namespace {
+// Metrics of the test RunSingleTest is running
+std::vector<TestMetric>* g_current_metrics = nullptr;
+}
+
+void Test_Record_Metric(const std::string& name, double value,
+                        const char* unit, bool higher_is_better) {
+    if (g_current_metrics == nullptr) {
+        return;
+    }
+    for (auto& metric : *g_current_metrics) {
+        if (metric.name == name) {
+            metric.samples.push_back(value);
+            return;
+        }
+    }
+    TestMetric metric;
+    metric.name = name;
+    metric.unit = unit;
+    metric.higher_is_better = higher_is_better;
+    metric.samples.push_back(value);
+    g_current_metrics->push_back(metric);
+}
+
+//=============================================================================
+// Performance Budgets
+//=============================================================================
+
+namespace {
+
+constexpr int PERF_SAMPLES = 5;             // Batches timed after calibrating
+constexpr double PERF_MIN_BATCH_MS = 5.0;   // Calibrated batch length
+constexpr int PERF_MAX_BATCH = 1 << 20;
+
+volatile uint32_t g_speed_sink = 0;
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// Remapped transparent 32x24 blits into a 320x200 buffer, the game's
+// most common inner loop; small enough to stay in cache, so it measures
+// the core rather than the memory system
+double RunSpeedKernel() {
+    static uint8_t sprite[32 * 24];
+    static uint8_t screen[320 * 200];
+    static uint8_t remap[256];
+
+    uint32_t seed = 0x12345678;
+    for (int i = 0; i < 256; i++) {
+        remap[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    for (auto& pixel : sprite) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        pixel = static_cast<uint8_t>((seed & 3) ? seed >> 8 : 0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t sum = 0;
+    for (int blit = 0; blit < 10000; blit++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int x0 = static_cast<int>(seed % (320 - 32));
+        int y0 = static_cast<int>((seed >> 16) % (200 - 24));
+        for (int y = 0; y < 24; y++) {
+            const uint8_t* src = sprite + y * 32;
+            uint8_t* dst = screen + (y0 + y) * 320 + x0;
+            for (int x = 0; x < 32; x++) {
+                if (src[x] != 0) {
+                    dst[x] = remap[src[x]];
+                }
+            }
+        }
+        sum += screen[(y0 + 12) * 320 + x0 + 16];
+    }
+    double ms = ElapsedMs(start);
+    g_speed_sink = g_speed_sink + sum;
+    return ms;
+}
+
+// Budget multiplier; 0 = measure only
+double PerfSlack() {
+    if (const char* env = std::getenv("TEST_PERF_SLACK")) {
+        return std::max(0.0, std::atof(env));
+    }
+#if defined(NDEBUG)
+    return 1.0;
+#else
+    return 0.0;
+#endif
+}
+
+} // namespace
+
+double Test_Host_Speed_Factor() {
+    static double factor = 0.0;
+    if (factor == 0.0) {
+        // Fastest of a few runs: interruptions only ever make a run slower
+        RunSpeedKernel();
+        double best = RunSpeedKernel();
+        for (int i = 0; i < 3; i++) {
+            best = std::min(best, RunSpeedKernel());
+        }
+        factor = std::max(best, 0.001) / TEST_PERF_REFERENCE_KERNEL_MS;
+    }
+    return factor;
+}
+
+void Test_Perf_Budget(const std::string& name, double budget_ms,
+                      const std::function<void()>& work,
+                      const char* file, int line) {
+    // Calibrate: warm up, then double the batch until it is long enough
+    // for the clock not to matter
+    work();
+    int batch = 1;
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batch; i++) {
+            work();
+        }
+        if (ElapsedMs(start) >= PERF_MIN_BATCH_MS || batch >= PERF_MAX_BATCH) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    // Measure
+    std::vector<double> per_run;
+    for (int sample = 0; sample < PERF_SAMPLES; sample++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batch; i++) {
+            work();
+        }
+        per_run.push_back(ElapsedMs(start) / batch);
+    }
+    std::sort(per_run.begin(), per_run.end());
+    double measured = per_run[per_run.size() / 2];
+    Test_Record_Metric(name, measured, "ms");
+
+    double slack = PerfSlack();
+    if (slack <= 0.0) {
+        return;
+    }
+    double factor = Test_Host_Speed_Factor();
+    double allowed = budget_ms * factor * slack;
+    if (measured > allowed) {
+        std::ostringstream message;
+        message.setf(std::ios::fixed);
+        message.precision(3);
+        message << name << ": " << measured << " ms, budget " << allowed
+                << " ms (" << budget_ms << " ms on the reference machine x "
+                << factor << " host speed factor";
+        if (slack != 1.0) {
+            message << " x " << slack << " slack";
+        }
+        message << ")";
+        throw TestPerfFailed(message.str(), file, line);
+    }
+}
+
 //=============================================================================
 // TestRunnerConfig
 //=============================================================================
 
 bool TestRunnerConfig::ParseArgs(int argc, char* argv[]) {
+    // CTest runs the suites without arguments; let the environment opt in
+    if (const char* env_jobs = std::getenv("TEST_JOBS")) {
+        jobs = std::atoi(env_jobs);
+    }
+
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
 
@@ -117,6 +331,30 @@ bool TestRunnerConfig::ParseArgs(int argc, char* argv[]) {
         else if (arg == "--shuffle") {
             shuffle = true;
         }
+        else if (arg == "--isolated") {
+            // Read by TestEnvironment, in this process and the workers
+#if defined(_WIN32)
+            _putenv_s("TEST_ISOLATED", "1");
+#else
+            setenv("TEST_ISOLATED", "1", 1);
+#endif
+        }
+        else if (arg == "--perf-slack" && i + 1 < argc) {
+            // Read by TEST_PERF_BUDGET, in this process and the workers
+#if defined(_WIN32)
+            _putenv_s("TEST_PERF_SLACK", argv[++i]);
+#else
+            setenv("TEST_PERF_SLACK", argv[++i], 1);
+#endif
+        }
+        else if (arg == "--headless") {
+            // Read by Platform_Graphics_Init, in this process and the workers
+#if defined(_WIN32)
+            _putenv_s("PLATFORM_HEADLESS", "1");
+#else
+            setenv("PLATFORM_HEADLESS", "1", 1);
+#endif
+        }
         else if ((arg == "-f" || arg == "--filter") && i + 1 < argc) {
             filter_name = argv[++i];
         }
@@ -126,6 +364,15 @@ bool TestRunnerConfig::ParseArgs(int argc, char* argv[]) {
         else if ((arg == "-x" || arg == "--xml") && i + 1 < argc) {
             xml_output = argv[++i];
         }
+        else if ((arg == "-j" || arg == "--json") && i + 1 < argc) {
+            json_output = argv[++i];
+        }
+        else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::stoi(argv[++i]);
+        }
+        else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        }
         else if (arg == "--timeout" && i + 1 < argc) {
             default_timeout_ms = static_cast<uint32_t>(std::stoi(argv[++i]));
         }
@@ -151,8 +398,17 @@ void TestRunnerConfig::PrintUsage(const char* program_name) {
               << "  -f, --filter PATTERN  Run tests matching pattern\n"
               << "  -c, --category CAT    Run only tests in category\n"
               << "  -x, --xml FILE        Output JUnit XML to file\n"
+              << "  -j, --json FILE       Output results and metrics as JSON\n"
+              << "  --repeat N            Run each test N times, pooling metrics\n"
+              << "  --jobs N              Worker processes, one category each at\n"
+              << "                        a time (0 = one per core; TEST_JOBS)\n"
               << "  --stop-on-failure     Stop after first failure\n"
               << "  --shuffle             Randomize test order\n"
+              << "  --headless            Graphics without a window (PLATFORM_HEADLESS)\n"
+              << "  --perf-slack F        Multiply TEST_PERF_BUDGET budgets by F, 0 to\n"
+              << "                        measure without gating (TEST_PERF_SLACK)\n"
+              << "  --isolated            Full platform init and shutdown around every\n"
+              << "                        fixture test (TEST_ISOLATED)\n"
               << "  --seed N              Seed for shuffle (0 = random)\n"
               << "  --timeout MS          Default timeout in milliseconds\n";
 }
@@ -218,28 +474,32 @@ int TestRunner::Run() {
         multi_reporter->AddReporter(
             std::make_shared<XmlReporter>(config_.xml_output));
     }
+    if (!config_.json_output.empty()) {
+        multi_reporter->AddReporter(
+            std::make_shared<JsonReporter>(config_.json_output));
+    }
 
     // Run tests
     multi_reporter->OnTestRunStart(static_cast<int>(tests.size()));
 
-    for (const auto& test : tests) {
-        multi_reporter->OnTestStart(test.first);
-
-        TestCaseResult result = RunSingleTest(test.first, test.second);
-        results_.push_back(result);
+    if (config_.jobs == 1 || tests.size() < 2 ||
+        !RunParallel(tests, *multi_reporter)) {
+        for (const auto& test : tests) {
+            multi_reporter->OnTestStart(test.first);
 
-        switch (result.result) {
-            case TestResult::PASSED:  passed_++; break;
-            case TestResult::SKIPPED: skipped_++; break;
-            default: failed_++; break;
-        }
+            EnterSuite(test.first.category);
+            TestCaseResult result = RunRepeated(test.first, test.second);
+            results_.push_back(result);
+            CountResult(result);
 
-        multi_reporter->OnTestComplete(result);
+            multi_reporter->OnTestComplete(result);
 
-        if (config_.stop_on_failure && result.result == TestResult::FAILED) {
-            break;
+            if (config_.stop_on_failure && result.result == TestResult::FAILED) {
+                break;
+            }
         }
     }
+    EndSuite();
 
     multi_reporter->OnTestRunComplete(results_, passed_, failed_, skipped_);
 
@@ -251,6 +511,57 @@ int TestRunner::RunCategory(const std::string& category) {
     return Run();
 }
 
+void TestRunner::EnterSuite(const std::string& category) {
+    if (category != current_suite_) {
+        EndSuite();
+        current_suite_ = category;
+    }
+}
+
+void TestRunner::EndSuite() {
+    if (!current_suite_.empty()) {
+        TestRegistry::Instance().EndSuite(current_suite_);
+        current_suite_.clear();
+    }
+}
+
+void TestRunner::CountResult(const TestCaseResult& result) {
+    switch (result.result) {
+        case TestResult::PASSED:  passed_++; break;
+        case TestResult::SKIPPED: skipped_++; break;
+        default: failed_++; break;
+    }
+}
+
+TestCaseResult TestRunner::RunRepeated(const TestCaseInfo& info,
+                                       TestFunction func) {
+    TestCaseResult result = RunSingleTest(info, func);
+
+    // Repeats only add metric samples; the first failure ends them
+    for (int run = 1; run < config_.repeat &&
+                      result.result == TestResult::PASSED; run++) {
+        TestCaseResult again = RunSingleTest(info, func);
+        result.duration_ms += again.duration_ms;
+        if (again.result != TestResult::PASSED) {
+            again.duration_ms = result.duration_ms;
+            again.metrics = result.metrics;
+            result = again;
+            break;
+        }
+        for (const auto& metric : again.metrics) {
+            auto it = std::find_if(result.metrics.begin(), result.metrics.end(),
+                [&](const TestMetric& m) { return m.name == metric.name; });
+            if (it == result.metrics.end()) {
+                result.metrics.push_back(metric);
+            } else {
+                it->samples.insert(it->samples.end(),
+                                   metric.samples.begin(), metric.samples.end());
+            }
+        }
+    }
+    return result;
+}
+
 TestCaseResult TestRunner::RunSingleTest(const TestCaseInfo& info,
                                          TestFunction func) {
     TestCaseResult result;
@@ -258,11 +569,20 @@ TestCaseResult TestRunner::RunSingleTest(const TestCaseInfo& info,
     result.result = TestResult::PASSED;
     result.failure_line = 0;
 
+    // Saved for a runner nested inside a test
+    std::vector<TestMetric>* outer_metrics = g_current_metrics;
+    g_current_metrics = &result.metrics;
     auto start = std::chrono::steady_clock::now();
 
     try {
         func();
     }
+    catch (const TestPerfFailed& e) {
+        result.result = TestResult::PERF_FAIL;
+        result.message = e.what();
+        result.failure_file = e.file();
+        result.failure_line = e.line();
+    }
     catch (const TestAssertionFailed& e) {
         result.result = TestResult::FAILED;
         result.message = e.what();
@@ -283,8 +603,384 @@ TestCaseResult TestRunner::RunSingleTest(const TestCaseInfo& info,
     }
 
     auto end = std::chrono::steady_clock::now();
+    g_current_metrics = outer_metrics;
     result.duration_ms = std::chrono::duration<double, std::milli>(
         end - start).count();
 
     return result;
 }
+
+//=============================================================================
+// Parallel Runner
+//=============================================================================
+
+#if defined(_WIN32)
+
+bool TestRunner::RunParallel(
+    const std::vector<std::pair<TestCaseInfo, TestFunction>>& tests,
+    TestReporter& reporter) {
+    (void)tests;
+    (void)reporter;
+    return false;  // No fork(); run sequentially
+}
+
+#else
+
+namespace {
+
+// Results cross the worker pipe as length-prefixed records
+void PutBytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+void PutU32(std::string& out, uint32_t value) {
+    PutBytes(out, &value, sizeof(value));
+}
+
+void PutString(std::string& out, const std::string& str) {
+    PutU32(out, static_cast<uint32_t>(str.size()));
+    out += str;
+}
+
+std::string EncodeResult(uint32_t index, const TestCaseResult& result) {
+    std::string body;
+    PutU32(body, index);
+    PutU32(body, static_cast<uint32_t>(result.result));
+    PutBytes(body, &result.duration_ms, sizeof(result.duration_ms));
+    PutU32(body, static_cast<uint32_t>(result.failure_line));
+    PutString(body, result.message);
+    PutString(body, result.failure_file);
+    PutU32(body, static_cast<uint32_t>(result.metrics.size()));
+    for (const auto& metric : result.metrics) {
+        PutString(body, metric.name);
+        PutString(body, metric.unit);
+        PutU32(body, metric.higher_is_better ? 1 : 0);
+        PutU32(body, static_cast<uint32_t>(metric.samples.size()));
+        PutBytes(body, metric.samples.data(), metric.samples.size() * sizeof(double));
+    }
+
+    std::string record;
+    PutU32(record, static_cast<uint32_t>(body.size()));
+    return record + body;
+}
+
+class RecordReader {
+public:
+    RecordReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool Bytes(void* out, size_t size) {
+        if (static_cast<size_t>(end_ - p_) < size) {
+            ok_ = false;
+            return false;
+        }
+        memcpy(out, p_, size);
+        p_ += size;
+        return true;
+    }
+
+    uint32_t U32() {
+        uint32_t value = 0;
+        Bytes(&value, sizeof(value));
+        return value;
+    }
+
+    std::string String() {
+        uint32_t size = U32();
+        if (!ok_ || static_cast<size_t>(end_ - p_) < size) {
+            ok_ = false;
+            return std::string();
+        }
+        std::string str(p_, size);
+        p_ += size;
+        return str;
+    }
+
+    bool Ok() const { return ok_; }
+
+private:
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+bool DecodeResult(const char* data, size_t size, uint32_t* index,
+                  TestCaseResult* result) {
+    RecordReader reader(data, size);
+    *index = reader.U32();
+    result->result = static_cast<TestResult>(reader.U32());
+    reader.Bytes(&result->duration_ms, sizeof(result->duration_ms));
+    result->failure_line = static_cast<int>(reader.U32());
+    result->message = reader.String();
+    result->failure_file = reader.String();
+    uint32_t metric_count = reader.U32();
+    for (uint32_t i = 0; i < metric_count && reader.Ok(); i++) {
+        TestMetric metric;
+        metric.name = reader.String();
+        metric.unit = reader.String();
+        metric.higher_is_better = reader.U32() != 0;
+        uint32_t samples = reader.U32();
+        if (!reader.Ok() || samples > size / sizeof(double)) {
+            return false;
+        }
+        metric.samples.resize(samples);
+        reader.Bytes(metric.samples.data(), samples * sizeof(double));
+        result->metrics.push_back(metric);
+    }
+    return reader.Ok();
+}
+
+bool WriteAll(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+struct Worker {
+    pid_t pid = -1;
+    int fd = -1;
+    std::vector<uint32_t> tests;    // Indices into the run's test list
+    std::string buffer;             // Bytes of a partly read record
+};
+
+} // namespace
+
+bool TestRunner::RunParallel(
+    const std::vector<std::pair<TestCaseInfo, TestFunction>>& tests,
+    TestReporter& reporter) {
+    // Whole categories go to one worker: tests in a category share fixtures
+    // and singletons, and expect to run one at a time in registration order
+    std::vector<std::string> categories;
+    std::map<std::string, std::vector<uint32_t>> by_category;
+    for (uint32_t i = 0; i < tests.size(); i++) {
+        const std::string& category = tests[i].first.category;
+        if (by_category.find(category) == by_category.end()) {
+            categories.push_back(category);
+        }
+        by_category[category].push_back(i);
+    }
+
+    int jobs = config_.jobs;
+    if (jobs <= 0) {
+        jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    jobs = std::min(jobs, static_cast<int>(categories.size()));
+    if (jobs < 2) {
+        return false;
+    }
+
+    // Biggest categories first, each to the least loaded worker
+    std::stable_sort(categories.begin(), categories.end(),
+        [&](const std::string& a, const std::string& b) {
+            return by_category[a].size() > by_category[b].size();
+        });
+    std::vector<Worker> workers(jobs);
+    for (const auto& category : categories) {
+        auto least = std::min_element(workers.begin(), workers.end(),
+            [](const Worker& a, const Worker& b) { return a.tests.size() < b.tests.size(); });
+        const auto& indices = by_category[category];
+        least->tests.insert(least->tests.end(), indices.begin(), indices.end());
+    }
+    for (auto& worker : workers) {
+        std::sort(worker.tests.begin(), worker.tests.end());
+    }
+
+    // Anything buffered now would be printed by every child too
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    for (size_t w = 0; w < workers.size(); w++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            for (size_t other = 0; other < w; other++) {
+                close(workers[other].fd);
+            }
+            for (uint32_t index : workers[w].tests) {
+                EnterSuite(tests[index].first.category);
+                TestCaseResult result = RunRepeated(tests[index].first, tests[index].second);
+                if (!WriteAll(fds[1], EncodeResult(index, result)) ||
+                    (config_.stop_on_failure && result.result == TestResult::FAILED)) {
+                    break;
+                }
+            }
+            EndSuite();
+            TestRegistry::Instance().EndProcess();
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(nullptr);
+            _exit(0);
+        }
+        close(fds[1]);
+        workers[w].pid = pid;
+        workers[w].fd = fds[0];
+    }
+
+    // Tests of workers that never started run here, one after another
+    std::vector<uint32_t> local;
+    for (auto& worker : workers) {
+        if (worker.pid < 0) {
+            local.insert(local.end(), worker.tests.begin(), worker.tests.end());
+        }
+    }
+    if (config_.verbose) {
+        size_t started = std::count_if(workers.begin(), workers.end(),
+            [](const Worker& worker) { return worker.pid >= 0; });
+        std::cout << "Running on " << started << " worker processes\n";
+    }
+
+    std::vector<TestCaseResult> results(tests.size());
+    std::vector<bool> done(tests.size(), false);
+    bool stopping = false;
+
+    auto complete = [&](uint32_t index, TestCaseResult result) {
+        result.info = tests[index].first;
+        reporter.OnTestStart(result.info);
+        CountResult(result);
+        reporter.OnTestComplete(result);
+        results[index] = result;
+        done[index] = true;
+        if (config_.stop_on_failure && result.result == TestResult::FAILED) {
+            stopping = true;
+        }
+    };
+
+    // Merge results as they arrive
+    std::vector<pollfd> polls;
+    for (;;) {
+        polls.clear();
+        for (const auto& worker : workers) {
+            if (worker.fd >= 0) {
+                polls.push_back({worker.fd, POLLIN, 0});
+            }
+        }
+        if (polls.empty()) {
+            break;
+        }
+        if (poll(polls.data(), polls.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (auto& worker : workers) {
+            if (worker.fd < 0) {
+                continue;
+            }
+            auto it = std::find_if(polls.begin(), polls.end(),
+                [&](const pollfd& p) { return p.fd == worker.fd; });
+            if (it == polls.end() || it->revents == 0) {
+                continue;
+            }
+            char chunk[4096];
+            ssize_t n = read(worker.fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                close(worker.fd);
+                worker.fd = -1;
+                continue;
+            }
+            worker.buffer.append(chunk, static_cast<size_t>(n));
+
+            uint32_t size;
+            while (worker.buffer.size() >= sizeof(size)) {
+                memcpy(&size, worker.buffer.data(), sizeof(size));
+                if (worker.buffer.size() < sizeof(size) + size) {
+                    break;
+                }
+                uint32_t index;
+                TestCaseResult result;
+                result.failure_line = 0;
+                if (DecodeResult(worker.buffer.data() + sizeof(size), size, &index, &result) &&
+                    index < tests.size() && !stopping) {
+                    complete(index, result);
+                }
+                worker.buffer.erase(0, sizeof(size) + size);
+            }
+        }
+        if (stopping) {
+            for (auto& worker : workers) {
+                if (worker.fd >= 0) {
+                    kill(worker.pid, SIGTERM);
+                    close(worker.fd);
+                    worker.fd = -1;
+                }
+            }
+        }
+    }
+
+    // A worker that died takes the test it was running with it; report
+    // that test as crashed and the rest of its share as not run
+    for (auto& worker : workers) {
+        if (worker.pid < 0) {
+            continue;
+        }
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+        if (stopping) {
+            continue;
+        }
+        const std::string* crashed_test = nullptr;
+        for (uint32_t index : worker.tests) {
+            if (done[index]) {
+                continue;
+            }
+            TestCaseResult result;
+            result.duration_ms = 0.0;
+            result.failure_line = 0;
+            std::ostringstream message;
+            if (!crashed_test) {
+                result.result = TestResult::CRASHED;
+                if (WIFSIGNALED(status)) {
+                    message << "Worker process killed by signal " << WTERMSIG(status);
+                } else {
+                    message << "Worker process exited with status " << WEXITSTATUS(status);
+                }
+                crashed_test = &tests[index].first.name;
+            } else {
+                result.result = TestResult::SKIPPED;
+                message << "Not run: worker process died in " << *crashed_test;
+            }
+            result.message = message.str();
+            complete(index, result);
+        }
+    }
+
+    for (uint32_t index : local) {
+        if (stopping) {
+            break;
+        }
+        EnterSuite(tests[index].first.category);
+        complete(index, RunRepeated(tests[index].first, tests[index].second));
+    }
+    EndSuite();
+
+    for (size_t i = 0; i < tests.size(); i++) {
+        if (done[i]) {
+            results_.push_back(results[i]);
+        }
+    }
+    return true;
+}
+
+#endif
@@ -3,6 +3,7 @@
 // Task 18a - Test Framework Foundation
 
 #include "test/test_reporter.h"
+#include "test/perf_baseline.h"
 #include <iostream>
 #include <iomanip>
 #include <map>
@@ -83,6 +84,10 @@ void ConsoleReporter::OnTestComplete(const TestCaseResult& result) {
                 std::cout << ColorRed() << "CRASHED" << ColorReset()
                           << " (" << result.message << ")\n";
                 break;
+            case TestResult::PERF_FAIL:
+                std::cout << ColorYellow() << "PERF_FAIL" << ColorReset() << "\n";
+                std::cout << "    " << result.message << "\n";
+                break;
         }
     } else {
         // Compact output
@@ -92,6 +97,7 @@ void ConsoleReporter::OnTestComplete(const TestCaseResult& result) {
             case TestResult::SKIPPED: std::cout << ColorYellow() << "S" << ColorReset(); break;
             case TestResult::TIMEOUT: std::cout << ColorRed() << "T" << ColorReset(); break;
             case TestResult::CRASHED: std::cout << ColorRed() << "X" << ColorReset(); break;
+            case TestResult::PERF_FAIL: std::cout << ColorYellow() << "P" << ColorReset(); break;
         }
         std::cout << std::flush;
     }
@@ -108,18 +114,25 @@ void ConsoleReporter::OnTestRunComplete(const std::vector<TestCaseResult>& resul
 
     // Print failures in detail
     bool has_failures = false;
+    int perf_failed = 0;
     for (const auto& result : results) {
         if (result.result == TestResult::FAILED ||
             result.result == TestResult::CRASHED ||
-            result.result == TestResult::TIMEOUT) {
+            result.result == TestResult::TIMEOUT ||
+            result.result == TestResult::PERF_FAIL) {
 
             if (!has_failures) {
                 std::cout << "\nFailed Tests:\n";
                 has_failures = true;
             }
 
-            std::cout << ColorRed() << "  FAIL: " << ColorReset()
-                      << result.info.category << "::" << result.info.name << "\n";
+            if (result.result == TestResult::PERF_FAIL) {
+                perf_failed++;
+                std::cout << ColorYellow() << "  PERF: " << ColorReset();
+            } else {
+                std::cout << ColorRed() << "  FAIL: " << ColorReset();
+            }
+            std::cout << result.info.category << "::" << result.info.name << "\n";
             std::cout << "        " << result.message << "\n";
             if (!result.failure_file.empty()) {
                 std::cout << "        at " << result.failure_file
@@ -133,7 +146,11 @@ void ConsoleReporter::OnTestRunComplete(const std::vector<TestCaseResult>& resul
     std::cout << "  " << ColorGreen() << passed << " passed" << ColorReset() << "\n";
 
     if (failed > 0) {
-        std::cout << "  " << ColorRed() << failed << " failed" << ColorReset() << "\n";
+        std::cout << "  " << ColorRed() << failed << " failed" << ColorReset();
+        if (perf_failed > 0) {
+            std::cout << " (" << perf_failed << " over their perf budget)";
+        }
+        std::cout << "\n";
     }
 
     if (skipped > 0) {
@@ -260,7 +277,9 @@ void XmlReporter::OnTestRunComplete(const std::vector<TestCaseResult>& results,
                 file_ << ">\n";
                 file_ << "      <failure message=\""
                       << EscapeXml(test->message) << "\"";
-                if (!test->failure_file.empty()) {
+                if (test->result == TestResult::PERF_FAIL) {
+                    file_ << " type=\"perf-fail\"";
+                } else if (!test->failure_file.empty()) {
                     file_ << " type=\"" << EscapeXml(test->failure_file)
                           << ":" << test->failure_line << "\"";
                 }
@@ -276,6 +295,58 @@ void XmlReporter::OnTestRunComplete(const std::vector<TestCaseResult>& results,
     file_.close();
 }
 
+//=============================================================================
+// JsonReporter
+//=============================================================================
+
+JsonReporter::JsonReporter(const std::string& output_path)
+    : output_path_(output_path) {
+}
+
+void JsonReporter::OnTestRunComplete(const std::vector<TestCaseResult>& results,
+                                     int passed, int failed, int skipped) {
+    (void)passed;
+    (void)failed;
+    (void)skipped;
+
+    std::ofstream file(output_path_);
+    if (!file.is_open()) {
+        std::cerr << "Could not write " << output_path_ << "\n";
+        return;
+    }
+
+    file << "{\n  \"format\": 1,\n  \"host\": "
+         << Perf_Json_Quote(Perf_Host_Fingerprint()) << ",\n  \"tests\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const TestCaseResult& result = results[i];
+        file << "    {\"name\": " << Perf_Json_Quote(result.info.name)
+             << ", \"category\": " << Perf_Json_Quote(result.info.category)
+             << ", \"result\": \"" << TestResult_ToString(result.result)
+             << "\", \"duration_ms\": " << std::fixed << std::setprecision(3)
+             << result.duration_ms << ", \"message\": "
+             << Perf_Json_Quote(result.message) << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "  ],\n  \"metrics\": [";
+
+    // Metrics are keyed "Test/Metric" so names stay unique across tests
+    bool first = true;
+    for (const auto& result : results) {
+        for (const auto& metric : result.metrics) {
+            PerfSeries series;
+            series.name = result.info.name + "/" + metric.name;
+            series.unit = metric.unit;
+            series.higher_is_better = metric.higher_is_better;
+            series.samples = metric.samples;
+            file << (first ? "\n" : ",\n");
+            file.unsetf(std::ios_base::floatfield);
+            Perf_Write_Series(file, series, "    ");
+            first = false;
+        }
+    }
+    file << "\n  ]\n}\n";
+}
+
 //=============================================================================
 // MultiReporter
 //=============================================================================
@@ -267,6 +267,44 @@ int test_buffer_remap_copy() {
     PASS();
 }
 
+int test_buffer_remap_copy_trans() {
+    TEST("Buffer_RemapCopyTrans / RemapShadow");
+
+    // 40 wide so rows hold whole 16-pixel blocks and a tail
+    uint8_t src[40 * 4];
+    uint8_t dest[40 * 4];
+    for (int i = 0; i < 40 * 4; i++) src[i] = (i % 40 < 16 || i % 3 == 0) ? 0 : (uint8_t)i;
+    memset(dest, 0x80, sizeof(dest));
+
+    uint8_t remap[256];
+    for (int i = 0; i < 256; i++) remap[i] = (i + 1) % 256;
+
+    Platform_Buffer_RemapCopyTrans(dest, 40, 0, 0, src, 40, 0, 0, 40, 4, remap);
+
+    for (int i = 0; i < 40 * 4; i++) {
+        uint8_t expected = src[i] ? (uint8_t)((src[i] + 1) % 256) : 0x80;
+        if (dest[i] != expected) {
+            printf("at %d: got %d, expected %d\n", i, dest[i], expected);
+            FAIL("RemapCopyTrans incorrect");
+        }
+    }
+
+    // Shadow under the same mask: only opaque pixels move again
+    uint8_t before[40 * 4];
+    memcpy(before, dest, sizeof(dest));
+    Platform_Buffer_RemapShadow(dest, 40, 0, 0, src, 40, 0, 0, 40, 4, remap);
+
+    for (int i = 0; i < 40 * 4; i++) {
+        uint8_t expected = src[i] ? (uint8_t)((before[i] + 1) % 256) : before[i];
+        if (dest[i] != expected) {
+            printf("at %d: got %d, expected %d\n", i, dest[i], expected);
+            FAIL("RemapShadow incorrect");
+        }
+    }
+
+    PASS();
+}
+
 // =============================================================================
 // Scale Tests
 // =============================================================================
@@ -362,6 +400,33 @@ int test_buffer_scale_trans() {
     PASS();
 }
 
+int test_buffer_scale_sharp() {
+    TEST("Buffer_ScaleSharp");
+
+    uint32_t src[2] = {0xFF000000, 0xFFFFFFFF};  // black | white
+    uint32_t dest[5 * 2];
+    memset(dest, 0, sizeof(dest));
+
+    Platform_Buffer_ScaleSharp(
+        dest, 5 * 4, 5, 2,
+        src, 2 * 4, 2, 1,
+        0, 0,
+        5, 2  // 2.5x wide, 2x tall
+    );
+
+    for (int y = 0; y < 2; y++) {
+        const uint32_t* row = dest + y * 5;
+        if (row[0] != src[0] || row[1] != src[0] || row[3] != src[1] || row[4] != src[1]) {
+            FAIL("ScaleSharp blurred the pixel blocks");
+        }
+        if (row[2] == src[0] || row[2] == src[1] || (row[2] >> 24) != 0xFF) {
+            FAIL("ScaleSharp didn't blend the edge");
+        }
+    }
+
+    PASS();
+}
+
 // =============================================================================
 // Shadow Tests
 // =============================================================================
@@ -755,12 +820,14 @@ int main(int argc, char* argv[]) {
     failures += test_buffer_remap();
     failures += test_buffer_remap_trans();
     failures += test_buffer_remap_copy();
+    failures += test_buffer_remap_copy_trans();
 
     // Scale tests
     printf("\n--- Scaling ---\n");
     failures += test_buffer_scale_1x();
     failures += test_buffer_scale_2x();
     failures += test_buffer_scale_trans();
+    failures += test_buffer_scale_sharp();
 
     // Shadow tests
     printf("\n--- Shadow ---\n");
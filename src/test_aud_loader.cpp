@@ -334,6 +334,73 @@ bool Test_GetAudInfo() {
     return true;
 }
 
+// Random-looking ADPCM data of any compression type
+static std::vector<uint8_t> CreateMockAdpcmAud(uint8_t compression, bool stereo, size_t num_bytes) {
+    AudHeader header;
+    header.sample_rate = 22050;
+    header.uncompressed_size = static_cast<uint32_t>(num_bytes * 4);
+    header.compressed_size = static_cast<uint32_t>(num_bytes);
+    header.flags = AUD_FLAG_16BIT | (stereo ? AUD_FLAG_STEREO : 0);
+    header.compression = compression;
+
+    std::vector<uint8_t> data(sizeof(AudHeader) + num_bytes);
+    memcpy(data.data(), &header, sizeof(AudHeader));
+
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < num_bytes; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[sizeof(AudHeader) + i] = static_cast<uint8_t>(seed >> 16);
+    }
+    return data;
+}
+
+// Decode in pieces of `piece` samples, splitting ADPCM blocks
+static std::vector<int16_t> StreamDecode(AudDecoder& decoder, size_t piece) {
+    std::vector<int16_t> out;
+    std::vector<int16_t> buffer(piece);
+    size_t count;
+    while ((count = decoder.Decode(buffer.data(), piece)) > 0) {
+        out.insert(out.end(), buffer.begin(), buffer.begin() + count);
+    }
+    return out;
+}
+
+bool Test_StreamDecode() {
+    struct Case { uint8_t compression; bool stereo; size_t bytes; };
+    const Case cases[] = {
+        { AUD_COMPRESS_WW, false, 16 * 40 + 5 },
+        { AUD_COMPRESS_WW, true, 32 * 40 + 17 },
+        { AUD_COMPRESS_IMA, false, 999 },
+        { AUD_COMPRESS_NONE, true, 1000 },
+    };
+
+    for (const Case& c : cases) {
+        auto aud_data = CreateMockAdpcmAud(c.compression, c.stereo, c.bytes);
+
+        AudFile aud;
+        TEST_ASSERT(aud.LoadFromData(aud_data.data(), aud_data.size()), "Failed to load mock AUD");
+        std::vector<int16_t> whole(aud.GetPCMData(), aud.GetPCMData() + aud.GetPCMSampleCount());
+
+        AudDecoder decoder;
+        TEST_ASSERT(decoder.Open(aud_data.data(), static_cast<uint32_t>(aud_data.size())),
+                    "Decoder failed to open mock AUD");
+        TEST_ASSERT(decoder.GetTotalSamples() == whole.size(), "Total samples should match full decode");
+
+        for (size_t piece : { 1, 7, 49, 4096 }) {
+            decoder.Rewind();
+            TEST_ASSERT(StreamDecode(decoder, piece) == whole, "Streamed samples should match full decode");
+            TEST_ASSERT(decoder.IsFinished(), "Decoder should be finished at end of data");
+        }
+    }
+
+    AudDecoder decoder;
+    TEST_ASSERT(!decoder.Open(nullptr, 100), "Should fail on null data");
+    int16_t sample;
+    TEST_ASSERT(decoder.Decode(&sample, 1) == 0, "Closed decoder should produce nothing");
+
+    return true;
+}
+
 bool Test_LoadFromMix() {
     // This test requires actual game data
     printf("\n  (Integration test - requires game data)\n  ");
@@ -393,6 +460,7 @@ int main(int argc, char* argv[]) {
     RUN_TEST(InvalidData);
     RUN_TEST(CompressionName);
     RUN_TEST(GetAudInfo);
+    RUN_TEST(StreamDecode);
 
     // Integration test (may skip if no game data)
     if (!quick_mode) {
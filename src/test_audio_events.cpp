@@ -3,6 +3,7 @@
 // Task 17f - Game Audio Events
 
 #include "game/audio/audio_events.h"
+#include "game/audio/audio_event_batch.h"
 #include "game/audio/event_rate_limiter.h"
 #include "game/audio/audio_system.h"
 #include "platform.h"
@@ -109,6 +110,44 @@ bool Test_RateLimiter_Combined() {
     return true;
 }
 
+bool Test_RateLimiter_OffMapPosition() {
+    EventRateLimiter limiter;
+
+    limiter.SetPositionCooldown(6, 100);
+
+    // Cells off the 128x128 grid still rate limit, through the keyed table
+    TEST_ASSERT(limiter.CanFireAtPosition(6, -1, 500), "First off-map event should fire");
+    TEST_ASSERT(!limiter.CanFireAtPosition(6, -1, 500), "Second off-map event should be limited");
+    TEST_ASSERT(limiter.CanFireAtPosition(6, 500, -1), "Different off-map cell should fire");
+
+    return true;
+}
+
+bool Test_RateLimiter_ObjectAging() {
+    EventRateLimiter limiter;
+
+    limiter.SetObjectCooldown(7, 20);
+
+    // Far more objects than slots: every first event fires, and the table
+    // never grows past its fixed size
+    for (ObjectKey id = 1; id <= 5000; id++) {
+        TEST_ASSERT(limiter.CanFireForObject(7, id), "First event per object should fire");
+    }
+    TEST_ASSERT(limiter.GetTrackedCount() <= static_cast<size_t>(RATE_LIMIT_OBJECT_SLOTS),
+                "Object table should stay bounded");
+    TEST_ASSERT(!limiter.CanFireForObject(7, 1), "Recorded object should be limited");
+
+    // Expired entries free their slots without Cleanup()
+    Platform_Timer_Delay(30);
+    TEST_ASSERT(limiter.CanFireForObject(7, 1), "Expired object should fire again");
+    for (ObjectKey id = 10000; id < 10500; id++) {
+        TEST_ASSERT(limiter.CanFireForObject(7, id), "New objects should reuse expired slots");
+    }
+    TEST_ASSERT(!limiter.CanFireForObject(7, 10001), "Reused slot should hold its new object");
+
+    return true;
+}
+
 bool Test_RateLimiter_Cleanup() {
     EventRateLimiter limiter;
 
@@ -220,6 +259,68 @@ bool Test_AudioEvents_Explosions() {
     return true;
 }
 
+bool Test_AudioEvents_Coalescing() {
+    GetEventRateLimiter().Reset();
+    AudioEvents_Init();
+
+    // A volley in one spot merges into a single playback
+    uint32_t coalesced = AudioEvents_GetTotalCoalesced();
+    uint32_t limited = AudioEvents_GetTotalRateLimited();
+    for (int i = 0; i < 5; i++) {
+        AudioEvent_Explosion(1000 + i * 10, 1000, 2);
+    }
+    AudioEvents_FlushTick();
+    TEST_ASSERT(AudioEvents_GetTotalRateLimited() == limited, "Merged volley should not be rate-limited");
+    TEST_ASSERT(AudioEvents_GetTotalCoalesced() == coalesced + 4, "Volley should coalesce into one sound");
+
+    // Flushing again has nothing to play
+    coalesced = AudioEvents_GetTotalCoalesced();
+    AudioEvents_FlushTick();
+    TEST_ASSERT(AudioEvents_GetTotalCoalesced() == coalesced, "Batch should be empty after flush");
+
+    return true;
+}
+
+bool Test_AudioEventBatch_Merge() {
+    AudioEventBatch batch;
+
+    // Same type, sound and area merge; anything else gets its own entry
+    batch.Add(AudioEventType::EXPLOSION_LARGE, SoundEffect::EXPLODE_LARGE, 100, 100);
+    batch.Add(AudioEventType::EXPLOSION_LARGE, SoundEffect::EXPLODE_LARGE, 130, 120);
+    batch.Add(AudioEventType::EXPLOSION_LARGE, SoundEffect::EXPLODE_LARGE, 100, 100 + AudioEventBatch::MERGE_RADIUS + 1);
+    batch.Add(AudioEventType::WEAPON_FIRE, SoundEffect::WEAPON_MGUN, 100, 100);
+    TEST_ASSERT(batch.GetPendingCount() == 3, "Should have three entries");
+
+    int flushed = 0;
+    int merged_count = 0;
+    int center_x = 0;
+    batch.Flush([&](const CoalescedAudioEvent& event) {
+        flushed++;
+        if (event.count > merged_count) {
+            merged_count = event.count;
+            center_x = event.GetCenterX();
+        }
+    });
+    TEST_ASSERT(flushed == 3, "Flush should visit every entry");
+    TEST_ASSERT(merged_count == 2, "Nearby explosions should merge");
+    TEST_ASSERT(center_x == 115, "Merged entry should play at the centroid");
+    TEST_ASSERT(batch.GetPendingCount() == 0, "Flush should clear the batch");
+
+    // Full batch refuses new groups but still merges into existing ones
+    for (int i = 0; i < AudioEventBatch::MAX_ENTRIES; i++) {
+        batch.Add(AudioEventType::WEAPON_FIRE, SoundEffect::WEAPON_MGUN, i * 1000, 0);
+    }
+    TEST_ASSERT(!batch.Add(AudioEventType::WEAPON_FIRE, SoundEffect::WEAPON_MGUN, 0, 5000), "Full batch should refuse");
+    TEST_ASSERT(batch.Add(AudioEventType::WEAPON_FIRE, SoundEffect::WEAPON_MGUN, 10, 0), "Full batch should still merge");
+
+    // Volume grows with the group but is capped
+    TEST_ASSERT(AudioEventBatch::GetVolumeForCount(1) == 1.0f, "Single event plays at base volume");
+    TEST_ASSERT(AudioEventBatch::GetVolumeForCount(4) == 2.0f, "Four events double the volume");
+    TEST_ASSERT(AudioEventBatch::GetVolumeForCount(100) == AudioEventBatch::MAX_VOLUME_BOOST, "Boost should be capped");
+
+    return true;
+}
+
 bool Test_AudioEvents_EVA() {
     AudioEvents_Init();
 
@@ -320,6 +421,8 @@ int main(int argc, char* argv[]) {
     RUN_TEST(RateLimiter_Position);
     RUN_TEST(RateLimiter_Object);
     RUN_TEST(RateLimiter_Combined);
+    RUN_TEST(RateLimiter_OffMapPosition);
+    RUN_TEST(RateLimiter_ObjectAging);
     RUN_TEST(RateLimiter_Cleanup);
 
     // Audio event tests
@@ -328,6 +431,8 @@ int main(int argc, char* argv[]) {
     RUN_TEST(AudioEvents_UIClick);
     RUN_TEST(AudioEvents_UnitSelection);
     RUN_TEST(AudioEvents_Explosions);
+    RUN_TEST(AudioEvents_Coalescing);
+    RUN_TEST(AudioEventBatch_Merge);
     RUN_TEST(AudioEvents_EVA);
     RUN_TEST(AudioEvents_GameState);
     RUN_TEST(AudioEvents_BuildingEvents);
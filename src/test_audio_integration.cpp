@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cmath>
+#include <thread>
 
 //=============================================================================
 // Test Utilities
@@ -111,6 +112,13 @@ bool Test_Stats() {
     TEST_ASSERT(stats.music_volume >= 0.0f && stats.music_volume <= 1.0f, "Valid music volume");
     TEST_ASSERT(stats.voice_volume >= 0.0f && stats.voice_volume <= 1.0f, "Valid voice volume");
 
+    // Mixer stats are refreshed by Update()
+    Audio_Update();
+    stats = AudioSystem::Instance().GetStats();
+    TEST_ASSERT(stats.mixer_buffer_max_ms >= 0.0f, "Valid mixer peak");
+    TEST_ASSERT(stats.mixer_mix_max_ms >= 0.0f, "Valid mix block peak");
+    TEST_ASSERT(stats.decode_ms >= 0.0f, "Valid decode time");
+
     return true;
 }
 
@@ -180,6 +188,77 @@ bool Test_PrintDebugInfo() {
     return true;
 }
 
+bool Test_CommandRing() {
+    static AudioCommandRing<8> ring;
+    AudioCommand cmd = {AudioCommandType::PLAY_SOUND, 0, 0, 0, 0.0f};
+
+    for (int i = 0; i < 8; i++) {
+        cmd.a = i;
+        TEST_ASSERT(ring.Push(cmd), "Push should succeed until full");
+    }
+    TEST_ASSERT(!ring.Push(cmd), "Push should fail when full");
+    TEST_ASSERT(ring.Size() == 8, "Size should count queued commands");
+
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT(ring.Pop(cmd) && cmd.a == i, "Pop should return commands in order");
+    }
+    TEST_ASSERT(!ring.Pop(cmd), "Pop should fail when empty");
+
+    // One producer and one consumer across the wrap point
+    const int count = 100000;
+    bool in_order = true;
+    std::thread consumer([&in_order]() {
+        AudioCommand got;
+        int expected = 0;
+        while (expected < count) {
+            if (ring.Pop(got)) {
+                in_order = in_order && got.a == expected;
+                expected++;
+            }
+        }
+    });
+    for (int i = 0; i < count; ) {
+        cmd.a = i;
+        if (ring.Push(cmd)) {
+            i++;
+        }
+    }
+    consumer.join();
+    TEST_ASSERT(in_order, "Consumer should see every command once, in order");
+    TEST_ASSERT(ring.IsEmpty(), "Ring should be drained");
+
+    return true;
+}
+
+bool Test_AudioThread() {
+    AudioSystem& audio = AudioSystem::Instance();
+    if (!audio.IsInitialized()) {
+        printf("SKIPPED - Audio not initialized\n  ");
+        return true;
+    }
+
+    audio.StartThread();
+    TEST_ASSERT(audio.IsThreaded(), "Audio thread should start");
+
+    // Calls return at once; sounds start on the audio thread
+    TEST_ASSERT(audio.PlaySound(SoundEffect::UI_CLICK) == INVALID_PLAY_HANDLE,
+                "Threaded play should not return a handle");
+    audio.SetSFXVolume(0.5f);
+    audio.StopAllSounds();
+    audio.Update();
+    TEST_ASSERT(std::abs(audio.GetSFXVolume() - 0.5f) < 0.01f, "Volume should read back at once");
+
+    AudioStats stats = audio.GetStats();
+    TEST_ASSERT(stats.threaded, "Stats should report the audio thread");
+    TEST_ASSERT(stats.commands_dropped == 0, "No commands should be dropped");
+
+    audio.StopThread();
+    TEST_ASSERT(!audio.IsThreaded(), "Audio thread should stop");
+    audio.SetSFXVolume(1.0f);
+
+    return true;
+}
+
 //=============================================================================
 // Integration Test
 //=============================================================================
@@ -238,6 +317,8 @@ int main(int argc, char* argv[]) {
     RUN_TEST(GlobalFunctionWrappers);
     RUN_TEST(ShutdownReinitialize);
     RUN_TEST(PrintDebugInfo);
+    RUN_TEST(CommandRing);
+    RUN_TEST(AudioThread);
 
     // Integration test
     if (!quick_mode) {
@@ -5,6 +5,11 @@
 #include "game/input/command_system.h"
 #include "game/input/selection_manager.h"
 #include "game/input/cursor_context.h"
+#include "game/map.h"
+#include "game/object.h"
+#include "game/object_heap.h"
+#include "game/replay.h"
+#include "game/resync.h"
 #include "platform.h"
 #include <cstdio>
 #include <cstring>
@@ -334,6 +339,333 @@ bool Test_StopAndGuard() {
     return true;
 }
 
+bool Test_GroupMoveFlowField() {
+    printf("Test: Group Move Flow Field... ");
+
+    CreateTestObjects(0);
+    g_assigned_missions.clear();
+
+    SelectionManager_Init();
+    CommandSystem_Init();
+
+    auto& sel = SelectionManager::Instance();
+    auto& cmd = CommandSystem::Instance();
+
+    sel.SetPlayerHouse(0);
+    sel.SetAllObjectsQuery(QueryAllObjects);
+    cmd.SetAssignMissionCallback(TestAssignMission);
+    cmd.SetCanPerformQuery(TestCanPerform);
+
+    // A small group searches paths itself
+    sel.Select(&g_test_objects[0]);
+    sel.AddToSelection(&g_test_objects[1]);
+    cmd.IssueMoveCommand(100, 100, false);
+    if (cmd.GetLastCommand().flags & CMD_FLAG_FLOW_FIELD) {
+        printf("FAILED - Small group should not use a flow field\n");
+        CommandSystem_Shutdown();
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // A large one shares a field
+    for (auto& obj : g_test_objects) {
+        sel.AddToSelection(&obj);
+    }
+    cmd.IssueMoveCommand(100, 100, false);
+    if (!(cmd.GetLastCommand().flags & CMD_FLAG_FLOW_FIELD)) {
+        printf("FAILED - Large group should use a flow field\n");
+        CommandSystem_Shutdown();
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    CommandSystem_Shutdown();
+    SelectionManager_Shutdown();
+    printf("PASSED\n");
+    return true;
+}
+
+bool Test_ReplayRoundTrip() {
+    printf("Test: Replay Record and Playback... ");
+
+    CreateTestObjects(0);
+    g_assigned_missions.clear();
+
+    SelectionManager_Init();
+    CommandSystem_Init();
+
+    auto& sel = SelectionManager::Instance();
+    auto& cmd = CommandSystem::Instance();
+
+    sel.SetPlayerHouse(0);
+    sel.SetAllObjectsQuery(QueryAllObjects);
+    cmd.SetAssignMissionCallback(TestAssignMission);
+
+    MapClass map;
+    map.Alloc_Cells();
+    Map = &map;
+    ObjectClass* tank = Create_Object(RTTI_UNIT);
+    tank->Set_Coord(Cell_Coord(XY_Cell(20, 20)));
+
+    // Move one unit, wait two ticks, stop two
+    auto& recorder = ReplayRecorder::Instance();
+    bool ok = recorder.Start(1234, map);
+    uint32_t first[1] = {2000};
+    sel.SelectIds(first, 1);
+    cmd.IssueMoveCommand(240, 288, false);
+    recorder.End_Tick();
+    recorder.End_Tick();
+    uint32_t both[2] = {2000, 2001};
+    sel.SelectIds(both, 2);
+    cmd.IssueStopCommand();
+    recorder.End_Tick();
+    Replay replay = recorder.Stop();
+    std::vector<std::pair<void*, MissionType>> recorded = g_assigned_missions;
+    cmd.IssueGuardCommand(false);
+
+    ok = ok && replay.seed == 1234 && replay.tick_count == 3 && replay.commands.size() == 2 &&
+         replay.commands[1].tick == 2 && replay.commands[1].id_count == 2 &&
+         recorder.Stop().commands.empty();
+    if (!ok) {
+        printf("FAILED - Recording wrong\n");
+    }
+
+    Replay loaded;
+    if (ok && !(replay.Save("./TEST.RPL") && loaded.Load("./TEST.RPL") &&
+                loaded.ids == replay.ids && loaded.snapshot == replay.snapshot &&
+                loaded.commands.size() == 2)) {
+        printf("FAILED - Replay file round trip\n");
+        ok = false;
+    }
+    remove("./TEST.RPL");
+
+    // Playback restores the world and gives the same orders on the same ticks
+    g_assigned_missions.clear();
+    tank->Set_Coord(Cell_Coord(XY_Cell(40, 40)));
+    sel.Clear();
+
+    ReplayPlayer player;
+    if (ok && !player.Start(loaded, map)) {
+        printf("FAILED - Playback did not start\n");
+        ok = false;
+    }
+    if (ok && Object_Heap(RTTI_UNIT)->Active(0)->Get_Cell() != XY_Cell(20, 20)) {
+        printf("FAILED - Snapshot not restored\n");
+        ok = false;
+    }
+    int issued[3] = {};
+    while (ok && !player.Is_Finished()) {
+        issued[player.Get_Tick()] = player.Begin_Tick();
+        player.End_Tick();
+    }
+    if (ok && !(issued[0] == 1 && issued[1] == 0 && issued[2] == 1 && g_assigned_missions == recorded)) {
+        printf("FAILED - Playback orders differ\n");
+        ok = false;
+    }
+
+    Destroy_All_Objects();
+    Map = nullptr;
+    CommandSystem_Shutdown();
+    SelectionManager_Shutdown();
+    if (ok) {
+        printf("PASSED\n");
+    }
+    return ok;
+}
+
+bool Test_CommandPackets() {
+    printf("Test: Batched Command Packets... ");
+
+    CreateTestObjects(0);
+    g_assigned_missions.clear();
+
+    SelectionManager_Init();
+    CommandSystem_Init();
+
+    auto& sel = SelectionManager::Instance();
+    auto& cmd = CommandSystem::Instance();
+
+    sel.SetPlayerHouse(0);
+    sel.SetAllObjectsQuery(QueryAllObjects);
+    cmd.SetCanPerformQuery(TestCanPerform);
+
+    int batch_calls = 0;
+    int batch_units = 0;
+    cmd.SetAssignBatchCallback([&](void* const* units, int count, MissionType mission,
+                                   const CommandTarget& target) {
+        (void)target;
+        batch_calls++;
+        batch_units += count;
+        for (int i = 0; i < count; i++) {
+            g_assigned_missions.push_back({units[i], mission});
+        }
+        return count;
+    });
+
+    std::vector<uint8_t> sent;
+    int sends = 0;
+    int sent_count = 0;
+    cmd.SetPacketSink([&](const uint8_t* data, size_t size, int count) {
+        sent.assign(data, data + size);
+        sends++;
+        sent_count = count;
+    });
+
+    // Two orders to five units: two batch calls, one send at the flush
+    sel.Select(&g_test_objects[4]);
+    for (int i = 0; i < 4; i++) {
+        sel.AddToSelection(&g_test_objects[i]);
+    }
+    cmd.IssueMoveCommand(240, 288, false);
+    cmd.IssueStopCommand();
+    bool ok = batch_calls == 2 && batch_units == 10 && sends == 0 &&
+              cmd.GetPendingPacketCount() == 2;
+    const CommandPacket& last = cmd.GetLastPacket();
+    ok = ok && last.type == CommandType::STOP && last.units.size() == 5 &&
+         last.units.front() == 2000 && last.units.back() == 2004;
+    cmd.FlushPackets();
+    ok = ok && sends == 1 && sent_count == 2 && cmd.GetPendingPacketCount() == 0;
+    // Adjacent ids pack to a byte each
+    ok = ok && sent.size() == 2 * (CommandPacket::HEADER_SIZE + 2 + 4);
+    if (!ok) {
+        printf("FAILED - Batching or flush wrong\n");
+    }
+
+    // The wire form reads back as written
+    CommandPacket packet;
+    packet.Clear();
+    size_t used = ok ? packet.Read(sent.data(), sent.size()) : 0;
+    if (ok && !(used == CommandPacket::HEADER_SIZE + 6 && packet.type == CommandType::MOVE &&
+                packet.world_x == 240 && packet.world_y == 288 && packet.cell_x == 10 &&
+                packet.cell_y == 12 && packet.units.size() == 5 && packet.units[4] == 2004)) {
+        printf("FAILED - Packet round trip\n");
+        ok = false;
+    }
+    if (ok && packet.Read(sent.data(), CommandPacket::HEADER_SIZE + 3) != 0) {
+        printf("FAILED - Truncated packet accepted\n");
+        ok = false;
+    }
+
+    // A received buffer runs on its own units and leaves the selection alone
+    sel.Select(&g_test_objects[9]);
+    g_assigned_missions.clear();
+    if (ok && !(cmd.ExecutePackets(sent.data(), sent.size()) == 2 &&
+                g_assigned_missions.size() == 10 &&
+                g_assigned_missions[0].first == &g_test_objects[0] &&
+                g_assigned_missions[9].second == MISSION_STOP &&
+                sel.GetSelectionCount() == 1 && sel.IsSelected(&g_test_objects[9]))) {
+        printf("FAILED - Received packets\n");
+        ok = false;
+    }
+
+    cmd.SetAssignBatchCallback(nullptr);
+    cmd.SetPacketSink(nullptr);
+    CommandSystem_Shutdown();
+    SelectionManager_Shutdown();
+    if (ok) {
+        printf("PASSED\n");
+    }
+    return ok;
+}
+
+bool Test_ResyncLog() {
+    printf("Test: Resync Log and Fast-Forward... ");
+
+    CreateTestObjects(0);
+    g_assigned_missions.clear();
+
+    SelectionManager_Init();
+    CommandSystem_Init();
+
+    auto& sel = SelectionManager::Instance();
+    auto& cmd = CommandSystem::Instance();
+
+    sel.SetPlayerHouse(0);
+    sel.SetAllObjectsQuery(QueryAllObjects);
+    cmd.SetAssignMissionCallback(TestAssignMission);
+
+    MapClass map;
+    map.Alloc_Cells();
+    Map = &map;
+    ObjectClass* tank = Create_Object(RTTI_UNIT);
+    tank->Set_Coord(Cell_Coord(XY_Cell(20, 20)));
+
+    // Checkpoint before tick 100, move before it, stop two ticks later
+    auto& log = ResyncLog::Instance();
+    bool ok = log.Start(100, map) && log.Get_Checkpoint_Tick() == 100;
+    uint32_t first[1] = {2000};
+    sel.SelectIds(first, 1);
+    cmd.IssueMoveCommand(240, 288, false);
+    log.End_Tick(101, map);
+    log.End_Tick(102, map);
+    uint32_t both[2] = {2000, 2001};
+    sel.SelectIds(both, 2);
+    cmd.IssueStopCommand();
+    log.End_Tick(103, map);
+    std::vector<std::pair<void*, MissionType>> recorded = g_assigned_missions;
+
+    ResyncPackage package;
+    std::vector<uint8_t> bytes;
+    ok = ok && log.Build(103, 0xC0FFEE, package);
+    package.Write(bytes);
+    ResyncPackage loaded;
+    if (!(ok && loaded.Read(bytes.data(), bytes.size()) && loaded.base_tick == 100 &&
+          loaded.live_tick == 103 && loaded.state_hash == 0xC0FFEE &&
+          loaded.snapshot == package.snapshot && loaded.log == package.log)) {
+        printf("FAILED - Package round trip\n");
+        ok = false;
+    }
+    if (ok && loaded.Read(bytes.data(), bytes.size() - 1)) {
+        printf("FAILED - Truncated package accepted\n");
+        ok = false;
+    }
+    loaded.Read(bytes.data(), bytes.size());
+
+    // A new checkpoint drops the log that led up to it
+    log.Set_Checkpoint_Interval(4);
+    log.End_Tick(104, map);
+    if (ok && !(log.Get_Checkpoint_Tick() == 104 && log.Get_Log_Size() == 0)) {
+        printf("FAILED - Checkpoint not taken\n");
+        ok = false;
+    }
+    log.Set_Checkpoint_Interval(RESYNC_CHECKPOINT_TICKS);
+    log.Stop();
+
+    // Fast-forward restores the world and reissues each tick's packets
+    g_assigned_missions.clear();
+    tank->Set_Coord(Cell_Coord(XY_Cell(40, 40)));
+    sel.Clear();
+
+    ResyncPlayer player;
+    if (ok && !player.Start(loaded, map)) {
+        printf("FAILED - Checkpoint did not load\n");
+        ok = false;
+    }
+    if (ok && Object_Heap(RTTI_UNIT)->Active(0)->Get_Cell() != XY_Cell(20, 20)) {
+        printf("FAILED - Checkpoint not restored\n");
+        ok = false;
+    }
+    int issued[3] = {};
+    while (ok && !player.Is_Finished()) {
+        issued[player.Get_Tick() - 100] = player.Begin_Tick();
+        player.End_Tick();
+    }
+    if (ok && !(issued[0] == 1 && issued[1] == 0 && issued[2] == 1 &&
+                g_assigned_missions == recorded)) {
+        printf("FAILED - Fast-forward orders differ\n");
+        ok = false;
+    }
+
+    Destroy_All_Objects();
+    Map = nullptr;
+    CommandSystem_Shutdown();
+    SelectionManager_Shutdown();
+    if (ok) {
+        printf("PASSED\n");
+    }
+    return ok;
+}
+
 int main(int argc, char* argv[]) {
     printf("=== Command System Tests (Task 16f) ===\n\n");
 
@@ -358,6 +690,10 @@ int main(int argc, char* argv[]) {
     if (Test_CommandResolution()) passed++; else failed++;
     if (Test_NoSelection()) passed++; else failed++;
     if (Test_StopAndGuard()) passed++; else failed++;
+    if (Test_GroupMoveFlowField()) passed++; else failed++;
+    if (Test_ReplayRoundTrip()) passed++; else failed++;
+    if (Test_CommandPackets()) passed++; else failed++;
+    if (Test_ResyncLog()) passed++; else failed++;
 
     Platform_Shutdown();
 
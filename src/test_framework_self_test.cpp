@@ -5,7 +5,10 @@
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
 #include "test/test_reporter.h"
+#include <chrono>
+#include <cstdlib>
 #include <sstream>
+#include <thread>
 
 //=============================================================================
 // Basic Test Registration Tests
@@ -115,6 +118,75 @@ TEST_CASE(Categories_Listed, "Framework") {
     TEST_ASSERT_GE(categories.size(), 3u);  // At least Framework, Assertions, CategoryA
 }
 
+TEST_CASE(Parallel_MergesCategories, "Framework") {
+    // Category_Test1..3 span two categories, so two workers
+    TestRunnerConfig config;
+    config.quiet = true;
+    config.jobs = 2;
+    config.filter_name = "Category_Test";
+    TestRunner runner(config);
+
+    TEST_ASSERT_EQ(runner.Run(), 0);
+    TEST_ASSERT_EQ(runner.GetPassedCount(), 3);
+
+    // Registration order, whichever worker finished first
+    const auto& results = runner.GetResults();
+    TEST_ASSERT_EQ(results.size(), 3u);
+    TEST_ASSERT_EQ(results[0].info.name, "Category_Test1");
+    TEST_ASSERT_EQ(results[2].info.name, "Category_Test3");
+}
+
+#if !defined(_WIN32)
+
+static bool g_worker_probe_armed = false;
+
+TEST_CASE(WorkerProbe_First, "WorkerProbe") {
+    TEST_ASSERT(true);
+}
+
+TEST_CASE(WorkerProbe_Dies, "WorkerProbe") {
+    if (!g_worker_probe_armed) {
+        TEST_SKIP("Run by Parallel_DeadWorkerReportsWholeShare");
+    }
+    std::_Exit(3);
+}
+
+TEST_CASE(WorkerProbe_After, "WorkerProbe") {
+    TEST_ASSERT(true);
+}
+
+TEST_CASE(WorkerProbe_Other, "WorkerProbeOther") {
+    TEST_ASSERT(true);
+}
+
+TEST_CASE(Parallel_DeadWorkerReportsWholeShare, "Framework") {
+    // The worker running WorkerProbe dies mid-share; the test after the
+    // crash must still be reported, not dropped from the totals
+    TestRunnerConfig config;
+    config.quiet = true;
+    config.jobs = 2;
+    config.filter_name = "WorkerProbe_";
+    TestRunner runner(config);
+
+    g_worker_probe_armed = true;
+    int failures = runner.Run();
+    g_worker_probe_armed = false;
+
+    TEST_ASSERT_EQ(failures, 1);
+    TEST_ASSERT_EQ(runner.GetTotalCount(), 4);
+    TEST_ASSERT_EQ(runner.GetPassedCount(), 2);
+    TEST_ASSERT_EQ(runner.GetSkippedCount(), 1);
+
+    const auto& results = runner.GetResults();
+    TEST_ASSERT_EQ(results.size(), 4u);
+    TEST_ASSERT_EQ(results[1].info.name, "WorkerProbe_Dies");
+    TEST_ASSERT(results[1].result == TestResult::CRASHED);
+    TEST_ASSERT_EQ(results[2].info.name, "WorkerProbe_After");
+    TEST_ASSERT(results[2].result == TestResult::SKIPPED);
+}
+
+#endif
+
 //=============================================================================
 // Test with Message
 //=============================================================================
@@ -165,6 +237,140 @@ TEST_WITH_FIXTURE(SimpleFixture, Fixture_SetupCalled, "Fixtures") {
     TEST_ASSERT_EQ(fixture.value, 42);
 }
 
+static int g_suite_setups = 0;
+static int g_suite_resets = 0;
+static int g_suite_teardowns = 0;
+
+class CountingFixture : public TestFixture {
+public:
+    void SetUp() override { g_suite_setups++; setups++; }
+    void Reset() override { g_suite_resets++; resets++; }
+    void TearDown() override { g_suite_teardowns++; }
+
+    int setups = 0;
+    int resets = 0;
+};
+
+TEST_WITH_SUITE_FIXTURE(CountingFixture, SuiteProbe_First, "SuiteProbe") {
+    TEST_ASSERT_EQ(fixture.setups, 1);
+}
+
+TEST_WITH_SUITE_FIXTURE(CountingFixture, SuiteProbe_Second, "SuiteProbe") {
+    TEST_ASSERT_EQ(fixture.setups, 1);
+}
+
+TEST_CASE(SuiteFixture_SharedAndTornDown, "Fixtures") {
+    int setups = g_suite_setups;
+    int resets = g_suite_resets;
+    int teardowns = g_suite_teardowns;
+
+    TestRunnerConfig config;
+    config.quiet = true;
+    config.filter_name = "SuiteProbe_";
+    TestRunner runner(config);
+
+    // Set up by the first test, reset for the second, gone after the suite
+    TEST_ASSERT_EQ(runner.Run(), 0);
+    TEST_ASSERT_EQ(g_suite_setups - setups, 1);
+    TEST_ASSERT_EQ(g_suite_resets - resets, 1);
+    TEST_ASSERT_EQ(g_suite_teardowns - teardowns, 1);
+}
+
+TEST_CASE(ProcessFixture_SetUpOnce, "Fixtures") {
+    CountingFixture& first = ProcessFixture<CountingFixture>::Get();
+    CountingFixture& second = ProcessFixture<CountingFixture>::Get();
+    TEST_ASSERT(&first == &second);
+    TEST_ASSERT_EQ(second.setups, 1);
+    TEST_ASSERT_GE(second.resets, 1);
+}
+
+TEST_CASE(Registry_SuiteTeardownsRunOnce, "Fixtures") {
+    std::string order;
+    auto& registry = TestRegistry::Instance();
+    registry.AddSuiteTeardown("TeardownProbe", [&order]() { order += "a"; });
+    registry.AddSuiteTeardown("TeardownProbe", [&order]() { order += "b"; });
+
+    registry.EndSuite("TeardownProbe");
+    registry.EndSuite("TeardownProbe");
+    TEST_ASSERT_EQ(order, "ba");  // Newest first, like destructors
+}
+
+//=============================================================================
+// Performance Budget Tests
+//=============================================================================
+
+static void SetPerfSlack(const char* slack) {
+#if defined(_WIN32)
+    _putenv_s("TEST_PERF_SLACK", slack ? slack : "");
+#else
+    if (slack) {
+        setenv("TEST_PERF_SLACK", slack, 1);
+    } else {
+        unsetenv("TEST_PERF_SLACK");
+    }
+#endif
+}
+
+static void SleepWork() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+static bool g_perf_probe_armed = false;
+
+TEST_CASE(PerfProbe_OverBudget, "PerfProbe") {
+    if (!g_perf_probe_armed) {
+        TEST_SKIP("Run by PerfBudget_ReportedAsPerfFail");
+    }
+    TEST_PERF_BUDGET("Sleep", 0.01, SleepWork);
+}
+
+TEST_CASE(PerfBudget_SpeedFactorPositive, "Performance") {
+    double factor = Test_Host_Speed_Factor();
+    TEST_ASSERT_GT(factor, 0.0);
+    TEST_ASSERT_EQ(Test_Host_Speed_Factor(), factor);  // Measured once
+}
+
+TEST_CASE(PerfBudget_WithinBudget, "Performance") {
+    SetPerfSlack("1");
+    int runs = 0;
+    TEST_PERF_BUDGET("Noop", 1000.0, [&runs]() { runs++; });
+    SetPerfSlack(nullptr);
+    TEST_ASSERT_GE(runs, 1 + 5);  // Warm-up, then at least one per sample
+}
+
+TEST_CASE(PerfBudget_OverBudgetThrows, "Performance") {
+    SetPerfSlack("1");
+    TEST_ASSERT_THROWS(TEST_PERF_BUDGET("Sleep", 0.01, SleepWork), TestPerfFailed);
+
+    // Slack 0 measures without gating
+    SetPerfSlack("0");
+    TEST_PERF_BUDGET("Sleep", 0.01, SleepWork);
+    SetPerfSlack(nullptr);
+}
+
+TEST_CASE(PerfBudget_ReportedAsPerfFail, "Performance") {
+    TestRunnerConfig config;
+    config.quiet = true;
+    config.filter_name = "PerfProbe_OverBudget";
+    TestRunner runner(config);
+
+    SetPerfSlack("1");
+    g_perf_probe_armed = true;
+    int status = runner.Run();
+    g_perf_probe_armed = false;
+    SetPerfSlack(nullptr);
+
+    // A failure like any other, but reported as PERF_FAIL with the timing
+    TEST_ASSERT_EQ(status, 1);
+    TEST_ASSERT_EQ(runner.GetFailedCount(), 1);
+    const auto& results = runner.GetResults();
+    TEST_ASSERT_EQ(results.size(), 1u);
+    TEST_ASSERT(results[0].result == TestResult::PERF_FAIL);
+    TEST_ASSERT_EQ(std::string(TestResult_ToString(results[0].result)), "PERF_FAIL");
+    TEST_ASSERT_EQ(results[0].metrics.size(), 1u);
+    TEST_ASSERT_EQ(results[0].metrics[0].name, "Sleep");
+}
+
 //=============================================================================
 // Performance/Timing Tests
 //=============================================================================
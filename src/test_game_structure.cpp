@@ -8,6 +8,7 @@
 #include "game/display.h"
 #include "game/cell.h"
 #include "game/object.h"
+#include "game/object_heap.h"
 #include "game/techno.h"
 #include "game/mission.h"
 #include "game/types/unittype.h"
@@ -69,7 +70,7 @@ int main() {
 
     // Test object system
     printf("\n--- Object System ---\n");
-    TEST("AllObjects initially null", AllObjects == nullptr);
+    TEST("No objects initially", Object_Count() == 0);
 
     // Test facing
     printf("\n--- Facing System ---\n");
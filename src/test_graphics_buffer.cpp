@@ -6,7 +6,13 @@
  */
 
 #include "game/graphics/graphics_buffer.h"
+#include "game/graphics/blit_batch.h"
+#include "game/graphics/blit_kernels.h"
+#include "game/graphics/selection_overlay.h"
+#include "game/graphics/text_cache.h"
 #include "platform.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <utility>
@@ -215,6 +221,310 @@ bool test_color_remapping() {
     return true;
 }
 
+bool test_buffer_shift() {
+    TEST_START("buffer shift");
+
+    GraphicsBuffer buf(8, 4);
+    ASSERT(buf.Lock(), "Lock should succeed");
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 8; x++) {
+            buf.Put_Pixel(x, y, (uint8_t)(y * 8 + x));
+        }
+    }
+
+    buf.Shift(-2, 1);
+    ASSERT(buf.Get_Pixel(0, 1) == 2 && buf.Get_Pixel(5, 3) == 23, "Shift should move pixels");
+    buf.Shift(2, -1);
+    ASSERT(buf.Get_Pixel(2, 0) == 2 && buf.Get_Pixel(7, 2) == 23, "Shift back should restore them");
+
+    buf.Unlock();
+    TEST_PASS();
+    return true;
+}
+
+bool test_blit_batch() {
+    TEST_START("blit batch");
+
+    // The same drawing, once op by op and once batched
+    uint8_t pattern[4 * 4];
+    for (int i = 0; i < 16; i++) {
+        pattern[i] = (i % 3) ? static_cast<uint8_t>(60 + i) : 0;
+    }
+    uint8_t remap[256];
+    for (int i = 0; i < 256; i++) {
+        remap[i] = static_cast<uint8_t>(255 - i);
+    }
+
+    GraphicsBuffer direct(48, 40);
+    GraphicsBuffer batched(48, 40);
+    ASSERT(direct.Lock() && batched.Lock(), "Lock should succeed");
+    direct.Clear(7);
+    batched.Clear(7);
+
+    direct.Fill_Rect(-4, 2, 20, 6, 11);
+    direct.Draw_Rect(30, 20, 25, 12, 3);
+    direct.Draw_HLine(0, 39, 100, 9);
+    direct.Blit_From_Raw(pattern, 4, 0, 0, 4, 4, 10, 12, 4, 4);
+    direct.Blit_From_Raw_Trans(pattern, 4, 1, 1, 4, 4, 45, 37, 3, 3);
+    direct.Remap(2, 3, 10, 10, remap);
+
+    {
+        BlitBatch batch(batched);
+        batch.Fill_Rect(-4, 2, 20, 6, 11);
+        batch.Draw_Rect(30, 20, 25, 12, 3);
+        batch.Draw_HLine(0, 39, 100, 9);
+        batch.Blit_Raw(pattern, 4, 0, 0, 4, 4, 10, 12, 4, 4);
+        batch.Blit_Raw(pattern, 4, 1, 1, 4, 4, 45, 37, 3, 3, true);
+        batch.Remap(2, 3, 10, 10, remap);
+        ASSERT(batch.Pending() == 9, "Ops should wait for the flush");
+        ASSERT(batched.Get_Pixel(0, 2) == 7, "Nothing drawn before the flush");
+    }
+    bool same = true;
+    for (int y = 0; y < 40; y++) {
+        for (int x = 0; x < 48; x++) {
+            same = same && direct.Get_Pixel(x, y) == batched.Get_Pixel(x, y);
+        }
+    }
+    ASSERT(same, "Batched drawing should match direct drawing");
+
+    // More ops than fit flush along the way, in order
+    {
+        BlitBatch batch(batched);
+        for (int i = 0; i < BlitBatch::CAPACITY * 2 + 5; i++) {
+            batch.Fill_Rect(0, 0, 1, 1, static_cast<uint8_t>(i));
+        }
+        ASSERT(batch.Pending() == 5, "Full batches should flush themselves");
+    }
+    ASSERT(batched.Get_Pixel(0, 0) == static_cast<uint8_t>(BlitBatch::CAPACITY * 2 + 4),
+           "Last op should win");
+
+    direct.Unlock();
+    batched.Unlock();
+    TEST_PASS();
+    return true;
+}
+
+bool test_selection_overlay() {
+    TEST_START("selection overlay");
+
+    SelectionOverlay overlay;
+    overlay.Add_Box(30, 20, 25, 12, 3);                 // Clipped on the right
+    overlay.Add_Brackets(4, 4, 16, 16, 15);
+    overlay.Add_Health_Bar(4, -2, 12, 50);              // Clipped at the top
+    overlay.Add_Box(0, 0, 0, 5, 9);                     // Empty: dropped
+    ASSERT(overlay.Count() == 3, "Empty records should be dropped");
+
+    GraphicsBuffer direct(48, 40);
+    GraphicsBuffer whole(48, 40);
+    GraphicsBuffer banded(48, 40);
+    ASSERT(direct.Lock() && whole.Lock() && banded.Lock(), "Lock should succeed");
+    direct.Clear(7);
+    whole.Clear(7);
+    banded.Clear(7);
+
+    direct.Draw_Rect(30, 20, 25, 12, 3);
+    ASSERT(overlay.Draw(whole) == 3, "Every record should be drawn");
+
+    bool same = true;
+    for (int y = 20; y < 32; y++) {
+        for (int x = 28; x < 48; x++) {
+            same = same && direct.Get_Pixel(x, y) == whole.Get_Pixel(x, y);
+        }
+    }
+    ASSERT(same, "A box should match Draw_Rect");
+
+    // Brackets: arms of 4 at each corner, nothing in between
+    ASSERT(whole.Get_Pixel(4, 4) == 15 && whole.Get_Pixel(7, 4) == 15, "Top left arm");
+    ASSERT(whole.Get_Pixel(8, 4) == 7 && whole.Get_Pixel(15, 4) == 7, "Gap between arms");
+    ASSERT(whole.Get_Pixel(19, 19) == 15 && whole.Get_Pixel(19, 16) == 15, "Bottom right arm");
+    ASSERT(whole.Get_Pixel(4, 12) == 7, "Gap between vertical arms");
+
+    // Health bar: 10 inside, half filled yellow, framed in black
+    ASSERT(whole.Get_Pixel(4, 0) == OVERLAY_COLOR_BLACK, "Frame");
+    ASSERT(whole.Get_Pixel(5, 0) == OVERLAY_COLOR_YELLOW && whole.Get_Pixel(9, 0) == OVERLAY_COLOR_YELLOW,
+           "Fill");
+    ASSERT(whole.Get_Pixel(10, 0) == OVERLAY_COLOR_BLACK, "Unfilled part");
+    ASSERT(whole.Get_Pixel(5, 1) == OVERLAY_COLOR_BLACK, "Bottom of the frame");
+
+    // Drawn as two row bands, as the render thread does, the result is
+    // the same and each record is counted once
+    int counted = overlay.Draw(banded.Get_Buffer(), banded.Get_Pitch(), 48, 13, 0);
+    counted += overlay.Draw(banded.Get_Buffer() + 13 * banded.Get_Pitch(), banded.Get_Pitch(),
+                            48, 27, 13);
+    ASSERT(counted == 3, "Records should be counted by their first band");
+    same = true;
+    for (int y = 0; y < 40; y++) {
+        for (int x = 0; x < 48; x++) {
+            same = same && whole.Get_Pixel(x, y) == banded.Get_Pixel(x, y);
+        }
+    }
+    ASSERT(same, "Banded drawing should match drawing the whole buffer");
+
+    overlay.Clear();
+    ASSERT(overlay.Count() == 0 && overlay.Draw(whole) == 0, "Clear should drop every record");
+
+    direct.Unlock();
+    whole.Unlock();
+    banded.Unlock();
+    TEST_PASS();
+    return true;
+}
+
+bool test_blit_kernels() {
+    TEST_START("blit kernels match scalar");
+
+    // Every length up to N covers each level's vector body and tail
+    const int N = 77;
+    uint8_t src[N], table[256], base[N];
+    for (int i = 0; i < 256; i++) table[i] = static_cast<uint8_t>(255 - i);
+    for (int i = 0; i < N; i++) {
+        src[i] = (i % 5 == 0 || (i > 20 && i < 40)) ? 0 : static_cast<uint8_t>(i * 7);
+        base[i] = static_cast<uint8_t>(200 + i);
+    }
+
+    BlitKernelLevel detected = DetectBlitKernelLevel();
+    const BlitKernelLevel levels[] = { BLIT_KERNEL_SSE2, BLIT_KERNEL_AVX2, BLIT_KERNEL_NEON };
+
+    for (int count = 0; count <= N; count++) {
+        uint8_t ref[5][N];
+        ASSERT(SetBlitKernelLevel(BLIT_KERNEL_SCALAR), "Scalar must be supported");
+        for (int op = 0; op < 5; op++) {
+            memcpy(ref[op], base, N);
+            const BlitKernels& k = GetBlitKernels();
+            if (op == 0) k.copy_trans(ref[op], src, count, 0);
+            if (op == 1) k.copy_remap(ref[op], src, count, table);
+            if (op == 2) k.copy_remap_trans(ref[op], src, count, table, 0);
+            if (op == 3) k.remap_inplace(ref[op], count, table);
+            if (op == 4) k.remap_masked(ref[op], src, count, table, 0);
+        }
+
+        for (BlitKernelLevel level : levels) {
+            if (!SetBlitKernelLevel(level)) {
+                continue;
+            }
+            for (int op = 0; op < 5; op++) {
+                uint8_t out[N];
+                memcpy(out, base, N);
+                const BlitKernels& k = GetBlitKernels();
+                if (op == 0) k.copy_trans(out, src, count, 0);
+                if (op == 1) k.copy_remap(out, src, count, table);
+                if (op == 2) k.copy_remap_trans(out, src, count, table, 0);
+                if (op == 3) k.remap_inplace(out, count, table);
+                if (op == 4) k.remap_masked(out, src, count, table, 0);
+                ASSERT(memcmp(out, ref[op], N) == 0, "Vector kernel output differs from scalar");
+            }
+        }
+    }
+
+    ASSERT(SetBlitKernelLevel(detected), "Detected level must be supported");
+
+    TEST_PASS();
+    return true;
+}
+
+// Best of several passes of copy_trans over rows of one width, ns per pixel
+static double Time_Copy_Trans(const BlitKernels& k, int width) {
+    const int ROWS = 256;
+    static uint8_t src[ROWS * 640];
+    static uint8_t dst[ROWS * 640];
+    for (int i = 0; i < ROWS * width; i++) {
+        src[i] = (i % 3 == 0) ? 0 : static_cast<uint8_t>(i);
+    }
+
+    double best = 1e30;
+    for (int pass = 0; pass < 9; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < 8; rep++) {
+            for (int row = 0; row < ROWS; row++) {
+                k.copy_trans(dst + row * width, src + row * width, width, 0);
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / (8.0 * ROWS * width));
+    }
+    return best;
+}
+
+bool test_blit_kernel_avx2_speed() {
+    TEST_START("AVX2 transparent copy not slower than SSE2");
+
+    BlitKernelLevel detected = DetectBlitKernelLevel();
+    if (!SetBlitKernelLevel(BLIT_KERNEL_AVX2)) {
+        SetBlitKernelLevel(detected);
+        printf("(no AVX2) ");
+        TEST_PASS();
+        return true;
+    }
+
+    // Shape rows are short, so short widths matter most. The slack only
+    // absorbs timer noise: an AVX->SSE transition per row costs 5-10x.
+    const int widths[] = {24, 48, 640};
+    bool ok = true;
+    for (int width : widths) {
+        SetBlitKernelLevel(BLIT_KERNEL_SSE2);
+        double sse2 = Time_Copy_Trans(GetBlitKernels(), width);
+        SetBlitKernelLevel(BLIT_KERNEL_AVX2);
+        double avx2 = Time_Copy_Trans(GetBlitKernels(), width);
+        if (avx2 > sse2 * 1.5) {
+            printf("[width %d: avx2 %.3f ns/px, sse2 %.3f] ", width, avx2, sse2);
+            ok = false;
+        }
+    }
+    SetBlitKernelLevel(detected);
+    ASSERT(ok, "AVX2 kernel is slower than SSE2");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_tile24_blits() {
+    TEST_START("24x24 tile blits");
+
+    uint8_t tile[24 * 24];
+    for (int i = 0; i < 24 * 24; i++) {
+        tile[i] = static_cast<uint8_t>(1 + i % 250);
+    }
+
+    // Interior: every pixel copied, neighbours untouched
+    GraphicsBuffer inner(64, 48);
+    ASSERT(inner.Lock(), "Lock should succeed");
+    inner.Clear(0);
+    inner.Blit_Tile24(tile, 10, 12);
+    ASSERT(inner.Get_Pixel(10, 12) == tile[0], "Top-left should match");
+    ASSERT(inner.Get_Pixel(33, 35) == tile[23 * 24 + 23], "Bottom-right should match");
+    ASSERT(inner.Get_Pixel(34, 12) == 0, "Right neighbour untouched");
+    ASSERT(inner.Get_Pixel(10, 36) == 0, "Row below untouched");
+    inner.Unlock();
+
+    // Edge: clipped on the left and bottom
+    GraphicsBuffer edge(64, 48);
+    ASSERT(edge.Lock(), "Lock should succeed");
+    edge.Clear(0);
+    edge.Blit_Tile24_Clipped(tile, -5, 40);
+    ASSERT(edge.Get_Pixel(0, 40) == tile[5], "Left clip should skip 5 columns");
+    ASSERT(edge.Get_Pixel(18, 47) == tile[7 * 24 + 23], "Bottom clip keeps 8 rows");
+    edge.Unlock();
+
+    // Fully outside draws nothing
+    GraphicsBuffer outside(64, 48);
+    ASSERT(outside.Lock(), "Lock should succeed");
+    outside.Clear(0);
+    outside.Blit_Tile24_Clipped(tile, 64, 0);
+    outside.Blit_Tile24_Clipped(tile, -24, -24);
+    for (int y = 0; y < 48; y++) {
+        for (int x = 0; x < 64; x++) {
+            if (outside.Get_Pixel(x, y) != 0) {
+                TEST_FAIL("Off-buffer tile should draw nothing");
+            }
+        }
+    }
+    outside.Unlock();
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_screen_buffer() {
     TEST_START("screen buffer singleton");
 
@@ -355,6 +665,44 @@ void run_visual_test() {
 // Main
 // =============================================================================
 
+bool test_text_cache() {
+    TEST_START("text cache");
+
+    TextCache cache(2);
+    ASSERT(TextCache::Text_Width("AB", TEXT_FONT_MENU) == 11, "Two glyphs plus one gap");
+    ASSERT(TextCache::Text_Width("", TEXT_FONT_MENU) == 0, "Empty text has no width");
+
+    // "I" is a bar on rows 0 and 6 and one column between them
+    const TextLayout* layout = cache.Get_Layout("I", TEXT_FONT_MENU, 15);
+    ASSERT(layout != nullptr, "Layout should be built");
+    ASSERT(layout->spans.size() == 7, "One span per row");
+    ASSERT(layout->spans[0].x == 1 && layout->spans[0].length == 3, "Top bar");
+    ASSERT(layout->spans[1].x == 2 && layout->spans[1].length == 1, "Stem");
+
+    // Second lookup is a hit; lowercase shares the uppercase glyphs
+    cache.Get_Layout("I", TEXT_FONT_MENU, 15);
+    ASSERT(cache.Get_Hits() == 1 && cache.Get_Misses() == 1, "Second lookup should hit");
+    const TextLayout* lower = cache.Get_Layout("i", TEXT_FONT_MENU, 15);
+    ASSERT(lower->spans.size() == 7, "Lowercase draws as uppercase");
+
+    // Colour is part of the key; a full cache drops the oldest string
+    cache.Get_Layout("I", TEXT_FONT_MENU, 7);
+    ASSERT(cache.Size() == 2, "Cache should stay at capacity");
+    ASSERT(cache.Get_Misses() == 3, "New colour should miss");
+
+    GraphicsBuffer buf(32, 16);
+    ASSERT(buf.Lock(), "Lock should succeed");
+    buf.Clear(0);
+    cache.Draw(buf, "I", 4, 2, TEXT_FONT_MENU, 9);
+    ASSERT(buf.Get_Pixel(5, 2) == 9, "Top bar drawn");
+    ASSERT(buf.Get_Pixel(6, 5) == 9, "Stem drawn");
+    ASSERT(buf.Get_Pixel(5, 5) == 0, "Gap beside stem untouched");
+    buf.Unlock();
+
+    TEST_PASS();
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     printf("==========================================\n");
     printf("GraphicsBuffer Test Suite\n");
@@ -390,6 +738,13 @@ int main(int argc, char* argv[]) {
     test_rectangle_operations();
     test_blitting();
     test_color_remapping();
+    test_buffer_shift();
+    test_blit_batch();
+    test_selection_overlay();
+    test_blit_kernels();
+    test_blit_kernel_avx2_speed();
+    test_tile24_blits();
+    test_text_cache();
     test_screen_buffer();
     test_nested_locks();
     test_move_semantics();
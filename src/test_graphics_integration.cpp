@@ -77,6 +77,36 @@ public:
     }
 };
 
+// Opaque 48x48 box, like a building body
+class OccluderObject : public TestObject {
+public:
+    OccluderObject(int wx, int wy, uint8_t c) : TestObject(wx, wy, RenderLayer::BUILDING, c) {}
+
+    bool IsOccluder() const override { return true; }
+    void Draw(GraphicsBuffer& buffer, int screen_x, int screen_y) override {
+        buffer.Fill_Rect(screen_x, screen_y, 48, 48, color);
+        draw_count++;
+    }
+    void GetBounds(int& x, int& y, int& width, int& height) const override {
+        x = 0; y = 0; width = 48; height = 48;
+    }
+};
+
+// Map whose cells from column 10 on are unexplored
+class ShroudedTerrain : public ITerrainProvider {
+public:
+    int GetTerrainTile(int /*cell_x*/, int /*cell_y*/) const override { return 0; }
+    int GetTerrainIcon(int /*cell_x*/, int /*cell_y*/) const override { return 0; }
+    bool IsValidCell(int cell_x, int cell_y) const override {
+        return cell_x >= 0 && cell_x < 64 && cell_y >= 0 && cell_y < 64;
+    }
+    void GetMapSize(int* w, int* h) const override {
+        if (w) *w = 64;
+        if (h) *h = 64;
+    }
+    bool IsCellShrouded(int cell_x, int /*cell_y*/) const override { return cell_x >= 10; }
+};
+
 // =============================================================================
 // Integration Tests
 // =============================================================================
@@ -549,6 +579,237 @@ bool test_stats_tracking() {
     return true;
 }
 
+bool test_layer_stats_and_overdraw() {
+    TEST_START("layer stats and overdraw heatmap");
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    pipeline.SetScrollPosition(0, 0);
+
+    // Two 24x24 boxes overlapping in a 12x12 corner
+    TestObject ground(100, 100, RenderLayer::GROUND, 120);
+    TestObject air(112, 112, RenderLayer::AIR, 119);
+
+    pipeline.SetDebugMode(true);
+    pipeline.SetOverdrawHeatmap(true);
+    pipeline.BeginFrame();
+    pipeline.AddRenderable(&ground);
+    pipeline.AddRenderable(&air);
+    pipeline.RenderFrame();
+
+    const RenderStats& stats = pipeline.GetStats();
+    const LayerStats& ground_stats = stats.Layer(RenderLayer::GROUND);
+    const LayerStats& air_stats = stats.Layer(RenderLayer::AIR);
+    ASSERT(ground_stats.commands == 1 && air_stats.commands == 1, "One draw per layer");
+    ASSERT(ground_stats.pixels == 24 * 24 && air_stats.pixels == 24 * 24,
+           "Pixels should be each draw's bounds");
+    ASSERT(stats.Layer(RenderLayer::BUILDING).commands == 0, "Empty layer should count nothing");
+    ASSERT(ground_stats.time_ms >= 0.0f && air_stats.time_ms >= 0.0f, "Layer times should be set");
+
+    screen.Lock();
+    uint8_t none = screen.Get_Pixel(50, 50);
+    uint8_t once = screen.Get_Pixel(104, 104);
+    uint8_t twice = screen.Get_Pixel(118, 118);
+    screen.Unlock();
+    pipeline.EndFrame();
+    pipeline.SetOverdrawHeatmap(false);
+    pipeline.SetDebugMode(false);
+
+    ASSERT(none != once && once != twice && none != twice,
+           "Heatmap should tell 0, 1 and 2 writes apart");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_threaded_render_frame() {
+    TEST_START("threaded render frame");
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    pipeline.SetScrollPosition(0, 0);
+
+    TestObject ground(100, 100, RenderLayer::GROUND, 120);
+    TestObject air(110, 110, RenderLayer::AIR, 119);
+
+    pipeline.SetThreaded(true);
+    pipeline.SetRasterBands(1);
+    ASSERT(pipeline.IsThreaded(), "Render thread should start");
+
+    // Frame 1 is only handed over; frame 2's EndFrame presents it
+    for (int frame = 0; frame < 2; frame++) {
+        pipeline.BeginFrame();
+        pipeline.AddRenderable(&ground);
+        pipeline.AddRenderable(&air);
+        pipeline.RenderFrame();
+        pipeline.EndFrame();
+    }
+    pipeline.Finish();
+
+    ASSERT(ground.draw_count == 2 && air.draw_count == 2,
+           "Both frames should be drawn on the render thread");
+    ASSERT(pipeline.GetStats().objects_drawn == 2, "Presented frame stats should count its objects");
+
+    screen.Lock();
+    uint8_t under = screen.Get_Pixel(105, 105);
+    uint8_t over = screen.Get_Pixel(115, 115);
+    screen.Unlock();
+    ASSERT(under == 120, "Presented frame should show the ground object");
+    ASSERT(over == 119, "Air layer should draw over ground");
+
+    pipeline.SetThreaded(false);
+    pipeline.SetRasterBands(0);
+    ASSERT(!pipeline.IsThreaded(), "Render thread should stop");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_banded_render_frame() {
+    TEST_START("banded render frame");
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    pipeline.SetScrollPosition(0, 0);
+
+    // Overlapping boxes across every band edge, in several layers
+    std::vector<TestObject> objects;
+    for (int i = 0; i < 60; i++) {
+        RenderLayer layer = (i % 3 == 0) ? RenderLayer::AIR :
+                            (i % 3 == 1) ? RenderLayer::BUILDING : RenderLayer::GROUND;
+        objects.emplace_back((i * 37) % 440, (i * 53) % 360, layer,
+                             static_cast<uint8_t>(100 + i));
+    }
+
+    // Draw the same scene with one band and with five; present and read back
+    std::vector<uint8_t> frames[2];
+    const int bands[2] = {1, 5};
+    pipeline.SetThreaded(true);
+    for (int pass = 0; pass < 2; pass++) {
+        pipeline.SetRasterBands(bands[pass]);
+        for (int frame = 0; frame < 2; frame++) {
+            pipeline.BeginFrame();
+            for (auto& obj : objects) {
+                pipeline.AddRenderable(&obj);
+            }
+            pipeline.RenderFrame();
+            pipeline.EndFrame();
+        }
+        pipeline.Finish();
+
+        screen.Lock();
+        for (int y = 0; y < screen.Get_Height(); y++) {
+            for (int x = 0; x < DEFAULT_TACTICAL_WIDTH; x++) {
+                frames[pass].push_back(screen.Get_Pixel(x, y));
+            }
+        }
+        screen.Unlock();
+    }
+    pipeline.SetThreaded(false);
+    pipeline.SetRasterBands(0);
+
+    ASSERT(frames[0] == frames[1], "Bands should rasterize the same frame as one band");
+    ASSERT(pipeline.GetStats().objects_drawn == static_cast<int>(objects.size()),
+           "Objects spanning bands should be counted once");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_threaded_terrain_cold_templates() {
+    TEST_START("threaded terrain with a cold template cache");
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    TileRenderer& tiles = TileRenderer::Instance();
+    pipeline.SetScrollPosition(0, 0);
+    pipeline.SetTileRenderer(&tiles);
+    tiles.SetTheater(THEATER_TEMPERATE);
+    ASSERT(tiles.IsTheaterLoaded(), "Theater should be set");
+
+    // Every frame queues against an emptied cache, and the game thread
+    // loads templates while the bands draw
+    pipeline.SetThreaded(true);
+    pipeline.SetRasterBands(4);
+    for (int frame = 0; frame < 4; frame++) {
+        tiles.ClearCache();
+        pipeline.BeginFrame();
+        pipeline.RenderFrame();
+        for (int t = TEMPLATE_CLEAR1; t < TEMPLATE_CLEAR1 + 8; t++) {
+            tiles.GetTemplate(static_cast<TemplateType>(t));
+        }
+        pipeline.EndFrame();
+    }
+    pipeline.Finish();
+    int drawn = pipeline.GetStats().terrain_tiles_drawn;
+
+    // Cell (1,2) is the placeholder tile, or the clear fill without MIX data
+    const uint8_t* tile = tiles.GetTilePixels(TEMPLATE_CLEAR1, 0);
+    uint8_t expected = tile ? tile[5 * TILE_WIDTH + 5] : 21;
+    screen.Lock();
+    uint8_t pixel = screen.Get_Pixel(TILE_WIDTH + 5, 2 * TILE_HEIGHT + 5);
+    screen.Unlock();
+
+    pipeline.SetThreaded(false);
+    pipeline.SetRasterBands(0);
+    pipeline.SetTileRenderer(nullptr);
+
+    ASSERT(drawn > 0, "Terrain should be drawn on the render thread");
+    ASSERT(pixel == expected, "Presented terrain should be the looked-up tile");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_shroud_and_occlusion_culling() {
+    TEST_START("shroud and occlusion culling");
+
+    GraphicsBuffer& screen = GraphicsBuffer::Screen();
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    ShroudedTerrain terrain;
+    pipeline.SetScrollPosition(0, 0);
+    pipeline.SetTerrainProvider(&terrain);
+
+    // A building filling cells (2,2)-(3,3), a tank under it, a plane over
+    // it, and a tank out in the shroud
+    OccluderObject building(48, 48, 130);
+    TestObject hidden(52, 52, RenderLayer::GROUND, 120);
+    TestObject plane(52, 52, RenderLayer::AIR, 119);
+    TestObject unexplored(300, 100, RenderLayer::GROUND, 118);
+    TestObject explored(100, 100, RenderLayer::GROUND, 117);
+
+    ASSERT(pipeline.IsShrouded(300, 100), "Cell 12 should be shrouded");
+    ASSERT(!pipeline.IsShrouded(100, 100), "Cell 4 should be explored");
+
+    pipeline.BeginFrame();
+    pipeline.AddRenderable(&building);
+    pipeline.AddRenderable(&hidden);
+    pipeline.AddRenderable(&plane);
+    pipeline.AddRenderable(&unexplored);
+    pipeline.AddRenderable(&explored);
+    ASSERT(pipeline.GetRenderableCount() == 4, "Shrouded object should not be queued");
+    pipeline.RenderFrame();
+
+    const RenderStats& stats = pipeline.GetStats();
+    ASSERT(stats.objects_culled == 2, "Shrouded and occluded objects should be culled");
+    ASSERT(hidden.draw_count == 0 && unexplored.draw_count == 0, "Culled objects should not draw");
+    ASSERT(building.draw_count == 1 && plane.draw_count == 1 && explored.draw_count == 1,
+           "Visible objects should draw");
+
+    screen.Lock();
+    uint8_t over = screen.Get_Pixel(60, 60);
+    uint8_t shroud = screen.Get_Pixel(300, 100);
+    screen.Unlock();
+    pipeline.EndFrame();
+    pipeline.SetTerrainProvider(nullptr);
+
+    ASSERT(over == 119, "Plane should draw over the building");
+    ASSERT(shroud == 0, "Shrouded cells should be filled black");
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -802,6 +1063,11 @@ int main(int argc, char* argv[]) {
     test_dirty_rect_system();
     test_render_layer_ordering();
     test_stats_tracking();
+    test_layer_stats_and_overdraw();
+    test_threaded_render_frame();
+    test_banded_render_frame();
+    test_threaded_terrain_cold_templates();
+    test_shroud_and_occlusion_culling();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
@@ -3,8 +3,10 @@
 // Task 16a - Input Foundation
 
 #include "game/input/input_state.h"
+#include "game/input/input_latency.h"
 #include "game/viewport.h"
 #include "platform.h"
+#include "platform/profiler.h"
 #include <cstdio>
 #include <cstring>
 
@@ -339,6 +341,62 @@ bool Test_ModifierFlags() {
     return true;
 }
 
+bool Test_InputLatency() {
+    printf("Test: Input Latency Tracing... ");
+
+    InputState& input = InputState::Instance();
+    InputLatency& latency = InputLatency::Instance();
+    latency.Reset();
+
+    // Two moves before a present: the older stamp is the one timed
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_MOUSE_MOVE, 0, 10, 10, 1000000});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_MOUSE_MOVE, 0, 12, 10, 1004000});
+    if (latency.GetPending(LatencyEffect::CURSOR) != 1000000) {
+        printf("FAILED - Cursor should wait with the oldest stamp\n");
+        return false;
+    }
+
+    ProfileSampleId id = Profiler::instance().register_sample(
+        InputLatency::GetHistogramName(LatencyEffect::CURSOR));
+    int before = Profiler::instance().get_histogram(id).count;
+
+    latency.Present(1016000);
+    if (latency.GetPending(LatencyEffect::CURSOR) != 0 ||
+        latency.GetLastLatencyMs(LatencyEffect::CURSOR) != 16.0) {
+        printf("FAILED - Present should record 16 ms\n");
+        return false;
+    }
+
+    ProfileHistogram h = Profiler::instance().get_histogram(id);
+    if (h.count != before + 1 || h.max_ms < 16.0) {
+        printf("FAILED - Histogram not updated\n");
+        return false;
+    }
+
+    // Nothing new, nothing recorded
+    latency.Present(1032000);
+    if (Profiler::instance().get_histogram(id).count != h.count) {
+        printf("FAILED - Present without input recorded a sample\n");
+        return false;
+    }
+
+    // Bucket limits bracket the recorded value
+    ProfileHistogram fresh;
+    fresh.count = 3;
+    fresh.max_ms = 40.0;
+    fresh.buckets.assign(Profiler::HISTOGRAM_BUCKETS, 0);
+    fresh.buckets[0] = 2;
+    fresh.buckets[Profiler::HISTOGRAM_BUCKETS - 1] = 1;
+    if (fresh.get_percentile(50) != Profiler::get_histogram_bucket_limit_ms(0) ||
+        fresh.get_percentile(99) != 40.0) {
+        printf("FAILED - Histogram percentiles wrong\n");
+        return false;
+    }
+
+    printf("PASSED\n");
+    return true;
+}
+
 //=============================================================================
 // Interactive Test
 //=============================================================================
@@ -455,6 +513,7 @@ int main(int argc, char* argv[]) {
     if (Test_ModifierFlags()) passed++; else failed++;
     if (Test_InputStateInit()) passed++; else failed++;
     if (Test_GlobalFunctions()) passed++; else failed++;
+    if (Test_InputLatency()) passed++; else failed++;
 
     printf("\n");
     if (failed == 0) {
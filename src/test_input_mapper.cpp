@@ -353,6 +353,184 @@ bool Test_ConflictDetection() {
     return true;
 }
 
+bool Test_EventDrivenActions() {
+    printf("Test: Event-Driven Action Resolution... ");
+
+    Platform_Init();
+    Platform_Graphics_Init();
+
+    // Initialize viewport for coordinate conversion
+    GameViewport::Instance().Initialize();
+    GameViewport::Instance().SetMapSize(64, 64);
+
+    Input_Init();
+    InputMapper_Init();
+
+    InputState& input = InputState::Instance();
+    InputMapper& mapper = InputMapper::Instance();
+
+    auto finish = [](bool ok, const char* why) {
+        if (!ok) {
+            printf("FAILED - %s\n", why);
+        }
+        InputMapper_Shutdown();
+        Input_Shutdown();
+        Platform_Graphics_Shutdown();
+        Platform_Shutdown();
+        if (ok) {
+            printf("PASSED\n");
+        }
+        return ok;
+    };
+
+    // First event-mode frame resamples everything
+    input.SetEventMode(true);
+    input.Update();
+    mapper.ProcessFrame();
+    if (!input.IsFullUpdate()) {
+        return finish(false, "First event frame should be a full update");
+    }
+
+    // S pressed mid-frame: only ORDER_STOP's key changed
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_S, 0, 0, 1234});
+    mapper.ProcessFrame();
+    if (input.IsFullUpdate() || input.GetChangedKeyCount() != 1 ||
+        input.GetChangedKey(0) != KEY_S) {
+        return finish(false, "Key event should list one changed key");
+    }
+    if (!input.WasKeyPressed(KEY_S) || input.GetKeyPressTimeUs(KEY_S) != 1234) {
+        return finish(false, "Key press or its timestamp not applied");
+    }
+    if (!mapper.WasActionTriggered(GameAction::ORDER_STOP)) {
+        return finish(false, "ORDER_STOP should trigger");
+    }
+
+    // Held: the one-shot action ends although no key changed
+    input.Update();
+    mapper.ProcessFrame();
+    if (input.GetChangedKeyCount() != 0 || !input.IsKeyDown(KEY_S)) {
+        return finish(false, "Held key should stay down with no changes");
+    }
+    if (mapper.IsActionActive(GameAction::ORDER_STOP) ||
+        !mapper.WasActionReleased(GameAction::ORDER_STOP)) {
+        return finish(false, "ORDER_STOP should release after one frame");
+    }
+
+    // Ctrl changes the modifiers, so Ctrl+A resolves SELECT_ALL
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_UP, KEY_S, 0, 0, 2000});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_CONTROL, 0, 0, 2100});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_A, 0, 0, 2200});
+    mapper.ProcessFrame();
+    if (!input.ModifiersChanged() || !input.IsCtrlDown()) {
+        return finish(false, "Ctrl event should update modifiers");
+    }
+    if (!mapper.WasActionTriggered(GameAction::SELECT_ALL) ||
+        mapper.WasActionTriggered(GameAction::ORDER_STOP)) {
+        return finish(false, "Only SELECT_ALL should trigger");
+    }
+    if (input.GetKeyPressTimeUs(KEY_CONTROL) >= input.GetKeyPressTimeUs(KEY_A)) {
+        return finish(false, "Sub-frame press order lost");
+    }
+
+    return finish(true, nullptr);
+}
+
+bool Test_CompiledBindings() {
+    printf("Test: Compiled Binding Table... ");
+
+    Platform_Init();
+    Platform_Graphics_Init();
+
+    // Initialize viewport for coordinate conversion
+    GameViewport::Instance().Initialize();
+    GameViewport::Instance().SetMapSize(64, 64);
+
+    Input_Init();
+    InputMapper_Init();
+
+    InputState& input = InputState::Instance();
+    InputMapper& mapper = InputMapper::Instance();
+
+    auto finish = [&mapper](bool ok, const char* why) {
+        if (!ok) {
+            printf("FAILED - %s\n", why);
+        }
+        mapper.SetDebugEnabled(false);
+        mapper.ResetBindings();
+        InputMapper_Shutdown();
+        Input_Shutdown();
+        Platform_Graphics_Shutdown();
+        Platform_Shutdown();
+        if (ok) {
+            printf("PASSED\n");
+        }
+        return ok;
+    };
+
+    mapper.SetDebugEnabled(false);
+    input.SetEventMode(true);
+    input.Update();
+    mapper.ProcessFrame();
+
+    // Ctrl+Shift+R: BUILDING_REPAIR excludes both, debug is off
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_CONTROL, 0, 0, 100});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_SHIFT, 0, 0, 110});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_R, 0, 0, 120});
+    mapper.ProcessFrame();
+    if (mapper.WasActionTriggered(GameAction::DEBUG_REVEAL_MAP) ||
+        mapper.WasActionTriggered(GameAction::BUILDING_REPAIR)) {
+        return finish(false, "Nothing should trigger on Ctrl+Shift+R");
+    }
+    if (!mapper.IsActionActive(GameAction::SCROLL_FAST)) {
+        return finish(false, "Held Shift should keep SCROLL_FAST active");
+    }
+
+    // Enabling debug recompiles the table; the next press resolves it
+    mapper.SetDebugEnabled(true);
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_UP, KEY_R, 0, 0, 200});
+    mapper.ProcessFrame();
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_R, 0, 0, 300});
+    mapper.ProcessFrame();
+    if (!mapper.WasActionTriggered(GameAction::DEBUG_REVEAL_MAP)) {
+        return finish(false, "DEBUG_REVEAL_MAP should trigger once enabled");
+    }
+
+    // Releasing Shift drops SCROLL_FAST without touching R
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_UP, KEY_SHIFT, 0, 0, 400});
+    mapper.ProcessFrame();
+    if (mapper.IsActionActive(GameAction::SCROLL_FAST) ||
+        !mapper.WasActionReleased(GameAction::SCROLL_FAST)) {
+        return finish(false, "SCROLL_FAST should release with Shift");
+    }
+
+    // A rebound action resolves on its new key only
+    mapper.RebindAction(GameAction::ORDER_STOP, KEY_Q, MOD_NONE);
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_UP, KEY_CONTROL, 0, 0, 500});
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_UP, KEY_R, 0, 0, 510});
+    mapper.ProcessFrame();
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_S, 0, 0, 600});
+    mapper.ProcessFrame();
+    if (mapper.WasActionTriggered(GameAction::ORDER_STOP)) {
+        return finish(false, "ORDER_STOP should no longer fire on S");
+    }
+    input.Update();
+    input.ApplyEvent(InputEvent{INPUT_EVENT_TYPE_KEY_DOWN, KEY_Q, 0, 0, 700});
+    mapper.ProcessFrame();
+    if (!mapper.WasActionTriggered(GameAction::ORDER_STOP)) {
+        return finish(false, "ORDER_STOP should fire on Q");
+    }
+
+    return finish(true, nullptr);
+}
+
 //=============================================================================
 // Interactive Test
 //=============================================================================
@@ -442,6 +620,8 @@ int main(int argc, char* argv[]) {
     if (Test_DebugActions()) passed++; else failed++;
     if (Test_RebindAction()) passed++; else failed++;
     if (Test_ConflictDetection()) passed++; else failed++;
+    if (Test_EventDrivenActions()) passed++; else failed++;
+    if (Test_CompiledBindings()) passed++; else failed++;
 
     printf("\n");
     if (failed == 0) {
@@ -210,6 +210,15 @@ void test_file_read() {
             }
             TEST_ASSERT(valid_palette, "Palette data appears valid (all values 0-63)");
 
+            // Mapped view sees the same bytes without a copy
+            int32_t mapped_size = 0;
+            const uint8_t* mapped = Platform_Mix_Map("PALETTE.PAL", &mapped_size);
+            TEST_ASSERT(mapped != nullptr && mapped_size == size, "Map returns the whole file");
+            if (mapped) {
+                TEST_ASSERT(memcmp(mapped, data, size) == 0, "Mapped data matches read data");
+                Platform_Mix_Unmap(mapped);
+            }
+
             free(data);
         } else {
             TEST_SKIP("Could not get PALETTE.PAL size");
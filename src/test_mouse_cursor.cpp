@@ -206,6 +206,35 @@ bool test_scroll_edge() {
     return true;
 }
 
+bool test_hardware_mode() {
+    TEST_START("hardware cursor mode");
+
+    MouseCursor& mc = MouseCursor::Instance();
+
+    ASSERT(!mc.IsHardwareMode(), "Should start in software mode");
+    ASSERT(mc.SetHardwareMode(true), "Enabling should succeed");
+    ASSERT(mc.IsHardwareMode(), "Should be in hardware mode");
+
+    // Nothing is drawn into the buffer, so there is no rect to save
+    int rx, ry, rw, rh;
+    ASSERT(!mc.GetDrawRect(100, 100, &rx, &ry, &rw, &rh), "Hardware cursor has no draw rect");
+
+    // Cursors are built on demand; none without MOUSE.SHP
+    ASSERT(mc.GetHardwareCursorCount() == 0, "No cursors built while unloaded");
+
+    mc.SetScale(3);
+    ASSERT(mc.GetScale() == 3, "Scale should be 3");
+    mc.SetScale(0);
+    ASSERT(mc.GetScale() == 3, "Scale below 1 should be ignored");
+    mc.SetScale(2);
+
+    ASSERT(mc.SetHardwareMode(false), "Disabling should succeed");
+    ASSERT(!mc.IsHardwareMode(), "Should be back in software mode");
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -346,6 +375,7 @@ int main(int argc, char* argv[]) {
     test_hotspots();
     test_scroll_cursor();
     test_scroll_edge();
+    test_hardware_mode();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
@@ -110,6 +110,66 @@ bool Test_MouseHandlerInit() {
     return true;
 }
 
+bool Test_ContextCache() {
+    printf("Test: Context Cache... ");
+
+    Platform_Init();
+    Platform_Graphics_Init();
+    Input_Init();
+    MouseHandler_Init();
+
+    static int object_queries = 0;
+    static int selection_queries = 0;
+    static uint32_t cell_generation = 0;
+    static uint32_t selection_generation = 0;
+    object_queries = 0;
+    selection_queries = 0;
+
+    MouseHandler& mouse = MouseHandler::Instance();
+    mouse.SetPlacementMode(false);
+    mouse.SetSellMode(false);
+    mouse.SetRepairMode(false);
+    mouse.SetObjectAtPosQuery([](int, int) -> void* { object_queries++; return nullptr; });
+    mouse.SetHasSelectionQuery([]() { selection_queries++; return true; });
+    mouse.SetCellGenerationQuery([](int, int) { return cell_generation; });
+    mouse.SetSelectionGenerationQuery([]() { return selection_generation; });
+
+    // The mouse stays put: only the first frame queries
+    MouseHandler_ProcessFrame();
+    MouseHandler_ProcessFrame();
+    MouseHandler_ProcessFrame();
+    bool ok = object_queries == 1 && selection_queries == 1;
+
+    // Occupants and selection changing each force one query
+    cell_generation++;
+    MouseHandler_ProcessFrame();
+    ok = ok && object_queries == 2 && selection_queries == 1;
+    selection_generation++;
+    MouseHandler_ProcessFrame();
+    ok = ok && object_queries == 2 && selection_queries == 2;
+
+    mouse.InvalidateContext();
+    MouseHandler_ProcessFrame();
+    ok = ok && object_queries == 3 && selection_queries == 3;
+
+    mouse.SetObjectAtPosQuery(nullptr);
+    mouse.SetHasSelectionQuery(nullptr);
+    mouse.SetCellGenerationQuery(nullptr);
+    mouse.SetSelectionGenerationQuery(nullptr);
+    MouseHandler_Shutdown();
+    Input_Shutdown();
+    Platform_Graphics_Shutdown();
+    Platform_Shutdown();
+
+    if (!ok) {
+        printf("FAILED - %d object, %d selection queries\n", object_queries, selection_queries);
+        return false;
+    }
+
+    printf("PASSED\n");
+    return true;
+}
+
 bool Test_CursorShapeMapping() {
     printf("Test: Cursor Shape Mapping... ");
 
@@ -332,6 +392,7 @@ int main(int argc, char* argv[]) {
     if (Test_CursorShapeMapping()) passed++; else failed++;
     if (Test_SpecialModes()) passed++; else failed++;
     if (Test_DragRectNormalization()) passed++; else failed++;
+    if (Test_ContextCache()) passed++; else failed++;
 
     printf("\n");
     if (failed == 0) {
@@ -234,6 +234,31 @@ bool Test_AutoAdvance() {
     return true;
 }
 
+bool Test_Crossfade() {
+    MusicPlayer& player = MusicPlayer::Instance();
+
+    if (!player.IsInitialized()) {
+        player.Initialize();
+    }
+
+    float original = player.GetCrossfadeDuration();
+    TEST_ASSERT(original > 0.0f, "Auto-advance should crossfade by default");
+
+    player.SetCrossfadeDuration(0.0f);
+    TEST_ASSERT(player.GetCrossfadeDuration() == 0.0f, "Crossfade should be disabled");
+
+    player.SetCrossfadeDuration(-100.0f);
+    TEST_ASSERT(player.GetCrossfadeDuration() == 0.0f, "Negative crossfade should clamp to 0");
+
+    player.SetCrossfadeDuration(original);  // Reset
+
+    // Nothing queued while stopped
+    player.Stop();
+    TEST_ASSERT(player.GetQueuedTrack() == MusicTrack::NONE, "No track should be queued when stopped");
+
+    return true;
+}
+
 bool Test_TrackDisplayName() {
     const char* name = GetMusicTrackDisplayName(MusicTrack::HELL_MARCH);
     TEST_ASSERT(name != nullptr, "Should have display name");
@@ -323,6 +348,7 @@ int main(int argc, char* argv[]) {
     RUN_TEST(GlobalFunctions);
     RUN_TEST(TrackInfoTableCompleteness);
     RUN_TEST(AutoAdvance);
+    RUN_TEST(Crossfade);
     RUN_TEST(TrackDisplayName);
 
     // Integration test
@@ -157,6 +157,38 @@ bool test_flash() {
     return true;
 }
 
+bool test_fade_tables() {
+    TEST_START("precomputed fade and flash tables");
+
+    PaletteManager& pm = PaletteManager::Instance();
+    pm.Init();
+
+    // Halfway through a fade, colors sit at half brightness
+    pm.StartFadeOut(4);
+    pm.Update();
+    pm.Update();
+    ASSERT(pm.GetColor(200).r == 100, "Half fade should halve index 200");
+    ASSERT(pm.GetColor(10).r == 10, "UI range should ignore the fade");
+
+    // Full white flash saturates every index but 0
+    pm.RestoreFromBlack();
+    pm.StartFlash(FlashType::White, 4, 1.0f);
+    ASSERT(pm.GetColor(50).r == 255 && pm.GetColor(50).b == 255, "Full flash should be white");
+    ASSERT(pm.GetColor(0).r == 0, "Index 0 stays black during flash");
+
+    // Half flash over a half fade blends without overflowing
+    pm.StartFadeOut(2);
+    pm.Update();
+    pm.StartFlash(PaletteColor(255, 255, 255), 2, 0.5f);
+    const PaletteColor& c = pm.GetColor(255);
+    ASSERT(c.r >= 190 && c.r <= 192, "Flash should add to the faded color");
+
+    pm.Init();
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_animation() {
     TEST_START("color animation");
 
@@ -207,6 +239,61 @@ bool test_find_closest_color() {
     return true;
 }
 
+bool test_closest_color_lookup() {
+    TEST_START("closest color lookup matches linear search");
+
+    PaletteManager& pm = PaletteManager::Instance();
+
+    // Scattered colors so cells have several candidates
+    PaletteColor colors[PaletteManager::PALETTE_SIZE];
+    uint32_t seed = 12345;
+    for (int i = 0; i < PaletteManager::PALETTE_SIZE; i++) {
+        seed = seed * 1103515245 + 12345;
+        colors[i] = PaletteColor(static_cast<uint8_t>(seed >> 8),
+                                 static_cast<uint8_t>(seed >> 16),
+                                 static_cast<uint8_t>(seed >> 24));
+    }
+    pm.SetPalette(colors);
+
+    const PaletteColor* pal = pm.GetOriginalPalette();
+    for (int n = 0; n < 4000; n++) {
+        seed = seed * 1103515245 + 12345;
+        int r = (seed >> 8) & 0xFF;
+        int g = (seed >> 16) & 0xFF;
+        int b = (seed >> 24) & 0xFF;
+
+        int expected = 1;
+        int best = 0x7FFFFFFF;
+        for (int i = 1; i < PaletteManager::PALETTE_SIZE; i++) {
+            int dr = r - pal[i].r;
+            int dg = g - pal[i].g;
+            int db = b - pal[i].b;
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < best) {
+                best = dist;
+                expected = i;
+            }
+        }
+
+        if (pm.FindClosestColor(r, g, b, true) != expected) {
+            TEST_FAIL("Lookup disagrees with linear search");
+        }
+    }
+
+    // Cached shadow tables are stable across calls
+    uint8_t first[256];
+    uint8_t second[256];
+    pm.GenerateShadowTable(first, 0.5f);
+    pm.GenerateShadowTable(second, 0.5f);
+    ASSERT(memcmp(first, second, sizeof(first)) == 0, "Cached shadow table should repeat");
+    ASSERT(first[0] == 0, "Shadow should preserve transparent");
+
+    pm.Init();
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_raw_palette() {
     TEST_START("raw palette extraction");
 
@@ -226,6 +313,44 @@ bool test_raw_palette() {
     return true;
 }
 
+bool test_changed_mask() {
+    TEST_START("packed palette and changed mask");
+
+    PaletteManager& pm = PaletteManager::Instance();
+    pm.Init();
+
+    // Init applies everything, so nothing is pending
+    ASSERT(!pm.HasChangedIndices(), "Mask should be clear after Init");
+    ASSERT(pm.GetPackedPalette()[0] == 0xFF000000u, "Index 0 should pack to opaque black");
+    ASSERT(pm.GetPackedPalette()[255] == 0xFFFFFFFFu, "Index 255 should pack to opaque white");
+
+    // One color change marks one index
+    pm.SetColor(100, PaletteColor(255, 0, 0));
+    ASSERT(pm.GetChangedCount() == 1, "Only one index should be marked");
+    ASSERT(pm.IsIndexChanged(100), "Index 100 should be marked");
+    ASSERT(pm.GetPackedPalette()[100] == 0xFFFF0000u, "Packed entry should be red");
+
+    pm.Update();
+    ASSERT(!pm.HasChangedIndices(), "Update should clear the mask");
+
+    // Setting the same color again changes nothing
+    pm.SetColor(100, PaletteColor(255, 0, 0));
+    ASSERT(!pm.HasChangedIndices(), "Unchanged color should not be marked");
+
+    // Fading to black marks everything but index 0 and the UI range
+    pm.FadeToBlack();
+    ASSERT(pm.GetChangedCount() == PaletteManager::PALETTE_SIZE - 1 -
+           (PaletteManager::UI_RANGE_END - PaletteManager::UI_RANGE_START + 1),
+           "Fade should mark all non-UI indices");
+    ASSERT(!pm.IsIndexChanged(0), "Index 0 stays black");
+
+    pm.RestoreFromBlack();
+    pm.Update();
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -379,9 +504,12 @@ int main(int argc, char* argv[]) {
     test_initialization();
     test_fade_state();
     test_flash();
+    test_fade_tables();
     test_animation();
     test_find_closest_color();
+    test_closest_color_lookup();
     test_raw_palette();
+    test_changed_mask();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
@@ -150,6 +150,22 @@ TEST(log_levels) {
     Platform_Log_SetLevel(2);  // Reset to Info
 }
 
+TEST(log_async) {
+    ASSERT_EQ(Platform_Log_SetAsync(1), 0);
+    ASSERT_EQ(Platform_Log_IsAsync(), 1);
+
+    for (int i = 0; i < 100; i++) {
+        Platform_Log(LOG_LEVEL_INFO, "Async log message from C++");
+    }
+
+    // Flush waits for the writer thread
+    Platform_Log_Flush();
+    ASSERT_EQ(Platform_Log_GetDropped(), 0u);
+
+    ASSERT_EQ(Platform_Log_SetAsync(0), 0);
+    ASSERT_EQ(Platform_Log_IsAsync(), 0);
+}
+
 // =============================================================================
 // Application Lifecycle Tests
 // =============================================================================
@@ -246,6 +262,7 @@ void run_logging_tests(void) {
     printf("\n=== Logging Tests ===\n");
     RUN_TEST(log_init_shutdown);
     RUN_TEST(log_levels);
+    RUN_TEST(log_async);
 }
 
 void run_lifecycle_tests(void) {
@@ -4,13 +4,18 @@
 
 #include "game/graphics/render_pipeline.h"
 #include "game/graphics/render_layer.h"
+#include "game/graphics/render_sort.h"
 #include "game/graphics/sidebar_render.h"
 #include "game/graphics/radar_render.h"
 #include "game/graphics/graphics_buffer.h"
 #include "game/graphics/mouse_cursor.h"
+#include "game/economy.h"
+#include "graphics/sprite_atlas.h"
+#include "graphics/sprite_batch.h"
 #include "platform.h"
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 // =============================================================================
 // Test Utilities
@@ -204,10 +209,25 @@ bool test_dirty_rects() {
     ASSERT(rp.GetDirtyRectCount() == 0, "Should have no dirty rects after clear");
 
     rp.AddDirtyRect(10, 10, 50, 50);
-    // Note: full redraw may absorb dirty rects
-    // This is expected behavior
+    ASSERT(rp.GetDirtyRectCount() == 1, "Should have one dirty rect");
+
+    // Overlapping marks share tiles; distant marks stay separate
+    rp.AddDirtyRect(20, 10, 50, 50);
+    ASSERT(rp.GetDirtyRectCount() == 1, "Overlapping rects should merge");
+    rp.AddDirtyRect(300, 200, 10, 10);
+    ASSERT(rp.GetDirtyRectCount() == 2, "Distant rect should stay separate");
+    ASSERT(!rp.IsFullRedraw(), "Small dirty area should not force full redraw");
+
+    // Covering most of the screen falls back to a full redraw
+    rp.AddDirtyRect(0, 0, 600, 380);
+    ASSERT(rp.IsFullRedraw(), "Large dirty area should force full redraw");
+    ASSERT(rp.GetDirtyRectCount() == 1, "Full redraw should be one rect");
+
+    rp.ClearDirtyRects();
+    ASSERT(rp.GetDirtyRectCount() == 0, "Should have no dirty rects after clear");
 
     rp.MarkFullRedraw();
+    ASSERT(rp.IsFullRedraw(), "MarkFullRedraw should request full redraw");
     // After full redraw, dirty rects are cleared
     rp.ClearDirtyRects();
     ASSERT(rp.GetDirtyRectCount() == 0, "Should have no dirty rects after full redraw clear");
@@ -216,6 +236,34 @@ bool test_dirty_rects() {
     return true;
 }
 
+bool test_cursor_frame() {
+    TEST_START("cursor-only frames");
+
+    RenderPipeline& rp = RenderPipeline::Instance();
+    rp.SetDirtyFlipEnabled(true);
+
+    // A full frame is needed first
+    rp.MarkFullRedraw();
+    ASSERT(!rp.DrawCursorFrame(), "Pending full redraw needs a full frame");
+    rp.DrawFrame();
+
+    // Static screen: only the cursor is considered
+    ASSERT(rp.DrawCursorFrame(), "Static screen should take the cursor path");
+    ASSERT(rp.GetDirtyRectCount() == 0, "Cursor path leaves nothing dirty");
+
+    // Any reported change goes back to a full frame
+    rp.AddDirtyRect(10, 10, 8, 8);
+    ASSERT(!rp.DrawCursorFrame(), "Dirty rects need a full frame");
+    rp.DrawFrame();
+    ASSERT(rp.DrawCursorFrame(), "Cursor path available again");
+
+    rp.SetDirtyFlipEnabled(false);
+    rp.MarkFullRedraw();
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_renderable_queue() {
     TEST_START("renderable queue");
 
@@ -243,6 +291,54 @@ bool test_renderable_queue() {
     return true;
 }
 
+bool test_render_commands() {
+    TEST_START("render command queue");
+
+    RenderPipeline& rp = RenderPipeline::Instance();
+
+    rp.SetScrollPosition(0, 0);
+    rp.BeginFrame();
+
+    // Submitted out of order; drawn by layer, then Y
+    MockRenderable air(50, 60, RenderLayer::AIR);
+    MockRenderable ground_low(100, 300, RenderLayer::GROUND);
+    MockRenderable ground_high(120, 40, RenderLayer::GROUND);
+    MockRenderable offscreen(5000, 5000, RenderLayer::GROUND);
+
+    rp.AddRenderable(&air);
+    rp.AddRenderable(&ground_low);
+    rp.AddRenderable(&ground_high);
+    rp.AddRenderable(&offscreen);
+    ASSERT(rp.GetRenderableCount() == 3, "Off-screen object should be culled");
+
+    // Raw commands with an unregistered shape are queued but not drawn
+    RenderCommand cmd = {};
+    cmd.sort_key = Make_Render_Sort_Key(static_cast<int>(RenderLayer::EFFECT), 0, 0);
+    cmd.shape = SHAPE_ID_NONE;
+    cmd.layer = static_cast<uint8_t>(RenderLayer::EFFECT);
+    rp.SubmitCommand(cmd);
+    ASSERT(rp.GetRenderableCount() == 4, "Command should be queued");
+
+    rp.RenderFrame();
+
+    const RenderCommand* cmds = rp.GetCommands();
+    ASSERT(cmds[0].object == &ground_high, "Lower Y should draw first");
+    ASSERT(cmds[1].object == &ground_low, "Higher Y should draw second");
+    ASSERT(cmds[2].object == &air, "Air layer should draw after ground");
+    ASSERT(cmds[3].object == nullptr, "Effect command should draw last");
+    ASSERT(air.draw_count == 1 && ground_low.draw_count == 1 && ground_high.draw_count == 1,
+           "Each renderable should draw once");
+    ASSERT(offscreen.draw_count == 0, "Culled object should not draw");
+    ASSERT(cmds[1].screen_x == 100 && cmds[1].screen_y == 300,
+           "Screen position should be resolved at submit");
+
+    rp.ClearRenderables();
+    ASSERT(rp.GetRenderableCount() == 0, "Queue should be empty after clear");
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_render_entry_sorting() {
     TEST_START("render entry sorting");
 
@@ -266,6 +362,59 @@ bool test_render_entry_sorting() {
     return true;
 }
 
+bool test_render_sorter() {
+    TEST_START("render sort keys");
+
+    // Key order matches (layer, Y, texture), including negative values
+    ASSERT(Make_Render_Sort_Key(-1, 500, 0) < Make_Render_Sort_Key(0, -500, 0),
+           "Lower layer should sort first");
+    ASSERT(Make_Render_Sort_Key(5, -10, 9) < Make_Render_Sort_Key(5, 10, 0),
+           "Lower Y should sort first within a layer");
+    ASSERT(Make_Render_Sort_Key(5, 10, 1) < Make_Render_Sort_Key(5, 10, 2),
+           "Lower texture should sort first at equal Y");
+
+    // Radix order matches a stable comparison sort
+    const int count = 1000;
+    std::vector<uint64_t> keys;
+    RenderSorter sorter;
+    sorter.Begin(count);
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        int layer = static_cast<int>((seed >> 16) % 14);
+        int y = static_cast<int>((seed >> 4) % 3000) - 100;
+        uint64_t key = Make_Render_Sort_Key(layer, y, 0);
+        keys.push_back(key);
+        sorter.Add(key);
+    }
+    const uint32_t* order = sorter.Sort();
+    ASSERT(sorter.Get_Last_Path() == RenderSorter::SORT_PATH_RADIX, "Should radix sort");
+    for (int i = 1; i < count; i++) {
+        uint64_t a = keys[order[i - 1]];
+        uint64_t b = keys[order[i]];
+        ASSERT(a < b || (a == b && order[i - 1] < order[i]), "Order should be stable and sorted");
+    }
+
+    // Same keys next frame reuse the order
+    sorter.Begin(count);
+    for (int i = 0; i < count; i++) {
+        sorter.Add(keys[i]);
+    }
+    sorter.Sort();
+    ASSERT(sorter.Get_Last_Path() == RenderSorter::SORT_PATH_REUSED, "Unchanged keys should reuse order");
+
+    // Already ordered input skips the sort
+    sorter.Begin();
+    sorter.Add(1);
+    sorter.Add(2);
+    sorter.Add(2);
+    sorter.Sort();
+    ASSERT(sorter.Get_Last_Path() == RenderSorter::SORT_PATH_ORDERED, "Ordered keys should not sort");
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_dirty_rect_struct() {
     TEST_START("DirtyRect structure");
 
@@ -373,6 +522,141 @@ bool test_radar_renderer() {
     return true;
 }
 
+bool test_radar_incremental() {
+    TEST_START("radar incremental update");
+
+    // Mutable terrain so single cells can change
+    class EditableTerrain : public MockTerrainProvider {
+    public:
+        int tiles[128 * 128];
+        EditableTerrain() : MockTerrainProvider(128, 128) {
+            for (int i = 0; i < 128 * 128; i++) tiles[i] = (i % 128 + i / 128) % 16;
+        }
+        int GetTerrainTile(int cell_x, int cell_y) const override {
+            if (!IsValidCell(cell_x, cell_y)) return -1;
+            return tiles[cell_y * 128 + cell_x];
+        }
+    };
+
+    EditableTerrain terrain;
+    RadarRenderer incremental;
+    RadarRenderer full;
+    incremental.Initialize(128, 128);
+    full.Initialize(128, 128);
+    incremental.SetTerrainProvider(&terrain);
+    full.SetTerrainProvider(&terrain);
+    incremental.UpdateTerrainImage();
+
+    // Change a few cells, including the map edges
+    const int changed[][2] = { {0, 0}, {64, 64}, {127, 127}, {5, 90}, {100, 3} };
+    for (const auto& c : changed) {
+        terrain.tiles[c[1] * 128 + c[0]] = 40;  // Shore
+        incremental.InvalidateCell(c[0], c[1]);
+    }
+    incremental.UpdateDirtyCells();
+    full.UpdateTerrainImage();
+
+    int size = incremental.GetWidth() * incremental.GetHeight();
+    ASSERT(memcmp(incremental.GetTerrainImage(), full.GetTerrainImage(), size) == 0,
+           "Incremental update should match full rebuild");
+
+    // Cell to radar position uses the lookup tables
+    int rx, ry;
+    incremental.CellToRadar(64, 64, &rx, &ry);
+    ASSERT(rx == incremental.GetX() + 80 && ry == incremental.GetY() + 68,
+           "Cell 64,64 should map to radar center");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_panel_caching() {
+    TEST_START("sidebar and radar panel caching");
+
+    GraphicsBuffer screen(640, 400);
+    ASSERT(screen.Lock(), "Lock should succeed");
+
+    SidebarRenderer sidebar;
+    sidebar.Initialize(400);
+    sidebar.AddBuildItem(1, -1);
+
+    sidebar.Draw(screen);
+    ASSERT(sidebar.GetPanelRedrawCount() == 1, "First draw renders the panel");
+    uint8_t tab_pixel = screen.Get_Pixel(sidebar.GetX() + 10, 10);
+    sidebar.Draw(screen);
+    ASSERT(sidebar.GetPanelRedrawCount() == 1, "Unchanged sidebar is only composited");
+    ASSERT(screen.Get_Pixel(sidebar.GetX() + 10, 10) == tab_pixel, "Composite matches panel");
+
+    // Sub-pixel progress ticks don't touch the panel; visible ones do
+    sidebar.SetBuildProgress(1, 0.5f);
+    ASSERT(sidebar.IsPanelDirty(), "Bar appearing should redraw");
+    sidebar.Draw(screen);
+    sidebar.SetBuildProgress(1, 0.501f);
+    ASSERT(!sidebar.IsPanelDirty(), "Sub-pixel progress should not redraw");
+    sidebar.SetSellButtonState(ButtonState::NORMAL);
+    ASSERT(!sidebar.IsPanelDirty(), "Same button state should not redraw");
+    sidebar.SetActiveTab(SidebarTab::UNIT);
+    ASSERT(sidebar.IsPanelDirty(), "Tab switch should redraw");
+    sidebar.Draw(screen);
+    ASSERT(sidebar.GetPanelRedrawCount() == 3, "Two changes, two redraws");
+
+    // Economy changes reach the panel only through their events
+    HouseEconomy economy;
+    economy.Refund_Money(1000);
+    economy.Start_Production(FACTORY_UNIT, 1, 540, 540);
+    sidebar.ApplyEconomy(economy, economy.Take_Events());
+    ASSERT(sidebar.GetCredits() == 1000 && sidebar.IsPanelDirty(), "Credits event should redraw");
+    sidebar.Draw(screen);
+    for (int i = 0; i < 9; i++) {
+        economy.AI();
+        sidebar.ApplyEconomy(economy, economy.Take_Events());
+    }
+    ASSERT(!sidebar.IsPanelDirty(), "Ticks between steps should not redraw");
+    economy.AI();
+    sidebar.ApplyEconomy(economy, economy.Take_Events());
+    ASSERT(sidebar.GetCredits() == 990 && sidebar.IsPanelDirty(), "Paid step should redraw");
+    sidebar.Draw(screen);
+
+    RadarRenderer radar;
+    radar.Initialize(128, 128);
+    radar.SetState(RadarState::ACTIVE);
+    radar.SetBlipSource([](RadarRenderer& r) { r.AddBlip(10, 10, 15); });
+
+    radar.Draw(screen);
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 1, "Same blips should not redraw");
+    ASSERT(screen.Get_Pixel(radar.GetX() - 1, radar.GetY() - 1) == 0, "Frame composited");
+
+    radar.SetBlipSource([](RadarRenderer& r) { r.AddBlip(11, 10, 15); });
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 2, "Moved blip should redraw");
+
+    radar.SetViewport(0, 0, 20, 16);
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 2, "Same viewport should not redraw");
+    radar.SetViewport(4, 0, 20, 16);
+    radar.InvalidateCell(3, 3);
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 3, "Changes since last draw share one redraw");
+
+    // A longer refresh interval only looks for changes every Nth draw
+    radar.SetRefreshInterval(3);
+    radar.SetBlipSource([](RadarRenderer& r) { r.AddBlip(12, 10, 15); });
+    radar.Draw(screen);
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 3, "Blip change waits for the refresh");
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 4, "Refresh draw picks it up");
+    radar.InvalidatePanel();
+    radar.Draw(screen);
+    ASSERT(radar.GetPanelRedrawCount() == 5, "Invalidated panel redraws at once");
+
+    screen.Unlock();
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_stats() {
     TEST_START("render statistics");
 
@@ -411,6 +695,144 @@ bool test_viewport_struct() {
     return true;
 }
 
+// =============================================================================
+// Sprite Atlas / Sprite Batch Tests
+// =============================================================================
+
+bool test_sprite_atlas_packing() {
+    TEST_START("sprite atlas shelf packing");
+
+    SpriteAtlas atlas(64);
+    uint8_t image[20 * 10];
+
+    // Three 20x10 images share the first shelf, each with its own pixels
+    AtlasRegion regions[3];
+    for (int i = 0; i < 3; i++) {
+        memset(image, 10 + i, sizeof(image));
+        ASSERT(atlas.add_image(image, 20, 10, 20, regions[i]), "Image should fit");
+    }
+    ASSERT(atlas.get_page_count() == 1, "Should use one page");
+    ASSERT(regions[0].y == 0 && regions[1].y == 0 && regions[2].y == 0, "Should share a shelf");
+    ASSERT(regions[1].x >= regions[0].x + 20 + SpriteAtlas::PADDING, "Regions should not overlap");
+    ASSERT(regions[2].x >= regions[1].x + 20 + SpriteAtlas::PADDING, "Regions should not overlap");
+
+    const uint8_t* page = atlas.get_page_pixels(0);
+    ASSERT(page != nullptr, "Page pixels should exist");
+    for (int i = 0; i < 3; i++) {
+        const AtlasRegion& r = regions[i];
+        ASSERT(page[r.y * 64 + r.x] == 10 + i, "Region top-left should hold its image");
+        ASSERT(page[(r.y + 9) * 64 + r.x + 19] == 10 + i, "Region bottom-right should hold its image");
+        ASSERT(page[r.y * 64 + r.x + 20] == 0, "Gutter should stay transparent");
+    }
+    ASSERT(regions[1].u0 == regions[1].x / 64.0f && regions[1].v1 == 10 / 64.0f, "UVs should match rect");
+
+    // A fourth no longer fits the shelf and opens one below it
+    AtlasRegion next;
+    ASSERT(atlas.add_image(image, 20, 10, 20, next), "Fourth image should fit");
+    ASSERT(next.page == 0 && next.x == 0 && next.y >= 10 + SpriteAtlas::PADDING, "Should open a new shelf");
+
+    // Larger than a page fails; a full page spills onto another
+    AtlasRegion big;
+    ASSERT(!atlas.add_image(image, 70, 10, 20, big), "Oversized image should fail");
+    std::vector<uint8_t> block(50 * 50, 7);
+    AtlasRegion spill;
+    ASSERT(atlas.add_image(block.data(), 50, 50, 50, spill), "Block should fit a fresh page");
+    ASSERT(spill.page == 1 && atlas.get_page_count() == 2, "Block should spill onto a second page");
+
+    double expected = (4 * 20 * 10 + 50 * 50) / (2.0 * 64 * 64);
+    ASSERT(atlas.get_occupancy() > expected - 1e-9 && atlas.get_occupancy() < expected + 1e-9,
+           "Occupancy should count image pixels");
+
+    atlas.clear();
+    ASSERT(atlas.get_page_count() == 0 && atlas.get_occupancy() == 0.0, "Clear should drop pages");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_sprite_batch_render() {
+    TEST_START("sprite batch software rendering");
+
+    // 4x4 sprite of color 5 with a transparent top-left pixel; fillers
+    // close both shelves so the 2x2 sprite of color 9 opens a second page
+    SpriteAtlas atlas(16);
+    uint8_t sprite[16];
+    memset(sprite, 5, sizeof(sprite));
+    sprite[0] = 0;
+    AtlasRegion a, b;
+    ASSERT(atlas.add_image(sprite, 4, 4, 4, a), "Sprite should fit");
+    std::vector<uint8_t> filler(15 * 10, 1);
+    AtlasRegion fill;
+    ASSERT(atlas.add_image(filler.data(), 10, 4, 15, fill), "Shelf filler should fit");
+    ASSERT(atlas.add_image(filler.data(), 15, 10, 15, fill), "Page filler should fit");
+    ASSERT(fill.page == a.page, "Fillers should share the sprite's page");
+    uint8_t small[4] = {9, 9, 9, 9};
+    ASSERT(atlas.add_image(small, 2, 2, 2, b), "Small sprite should fit");
+    ASSERT(b.page != a.page, "Small sprite should land on another page");
+
+    GraphicsBuffer target(32, 32);
+    SpriteBatch batch(64);
+    batch.set_target(&target);
+    batch.set_atlas(&atlas);
+
+    uint8_t remap[256];
+    for (int i = 0; i < 256; i++) {
+        remap[i] = static_cast<uint8_t>(i);
+    }
+    remap[5] = 77;
+
+    batch.begin();
+    batch.draw(a.page, 2, 2, 4, 4, a.u0, a.v0, a.u1, a.v1);      // Natural size
+    batch.draw(b.page, 20, 2, 2, 2, b.u0, b.v0, b.u1, b.v1);     // Other page
+    batch.draw(a.page, 10, 10, 8, 8, a.u0, a.v0, a.u1, a.v1);    // Scaled 2x
+    SpriteInstance remapped = {};
+    remapped.x = 2;
+    remapped.y = 20;
+    remapped.width = 4;
+    remapped.height = 4;
+    remapped.u0 = a.u0;
+    remapped.v0 = a.v0;
+    remapped.u1 = a.u1;
+    remapped.v1 = a.v1;
+    remapped.texture_id = a.page;
+    remapped.remap = remap;
+    batch.draw(remapped);
+    batch.draw(a.page, 30, 30, 4, 4, a.u0, a.v0, a.u1, a.v1);    // Clipped at the edge
+    batch.end();
+
+    ASSERT(batch.get_sprite_count() == 5, "Should count five sprites");
+    ASSERT(batch.get_batch_count() == 2, "Sprites should batch by page");
+    ASSERT(batch.get_draw_calls() == 2, "One draw call per page");
+
+    target.Lock();
+    ASSERT(target.Get_Pixel(2, 2) == 0, "Transparent pixel should be skipped");
+    ASSERT(target.Get_Pixel(3, 2) == 5 && target.Get_Pixel(5, 5) == 5, "Sprite should be drawn");
+    ASSERT(target.Get_Pixel(6, 2) == 0, "Nothing past the sprite");
+    ASSERT(target.Get_Pixel(20, 2) == 9 && target.Get_Pixel(21, 3) == 9, "Second page sprite drawn");
+    ASSERT(target.Get_Pixel(10, 10) == 0 && target.Get_Pixel(11, 11) == 0,
+           "Scaled transparent pixel should cover 2x2");
+    ASSERT(target.Get_Pixel(12, 10) == 5 && target.Get_Pixel(17, 17) == 5, "Scaled sprite drawn");
+    ASSERT(target.Get_Pixel(18, 18) == 0, "Scaled sprite should end at 8 pixels");
+    ASSERT(target.Get_Pixel(3, 20) == 77, "Remap should apply");
+    ASSERT(target.Get_Pixel(2, 20) == 0, "Remap should keep transparency");
+    ASSERT(target.Get_Pixel(31, 31) == 5, "Clipped sprite should draw what fits");
+    target.Unlock();
+
+    // Without an atlas, batches are counted but nothing is drawn
+    GraphicsBuffer blank(8, 8);
+    SpriteBatch counting(8);
+    counting.set_target(&blank);
+    counting.begin();
+    counting.draw(0, 0, 0, 4, 4);
+    counting.end();
+    blank.Lock();
+    ASSERT(counting.get_draw_calls() == 1 && blank.Get_Pixel(1, 1) == 0, "No atlas draws nothing");
+    blank.Unlock();
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -552,13 +974,20 @@ int main(int argc, char* argv[]) {
     test_coordinate_conversion();
     test_visibility();
     test_dirty_rects();
+    test_cursor_frame();
     test_renderable_queue();
+    test_render_commands();
     test_render_entry_sorting();
+    test_render_sorter();
     test_dirty_rect_struct();
     test_sidebar_renderer();
     test_radar_renderer();
+    test_radar_incremental();
+    test_panel_caching();
     test_stats();
     test_viewport_struct();
+    test_sprite_atlas_packing();
+    test_sprite_batch_render();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
@@ -3,6 +3,7 @@
 // Task 16e - Selection System
 
 #include "game/input/selection_manager.h"
+#include "game/viewport.h"
 #include "platform.h"
 #include <cstdio>
 #include <cstring>
@@ -352,6 +353,201 @@ bool Test_EnemyNotSelectable() {
     return true;
 }
 
+bool Test_SpatialGridDefaultQuery() {
+    printf("Test: Spatial Grid Default Query... ");
+
+    CreateTestObjects(0);
+    SelectionManager_Init();
+
+    auto& mgr = SelectionManager::Instance();
+    mgr.SetPlayerHouse(0);
+    mgr.SetObjectsInRectQuery(nullptr);
+    mgr.SetObjectAtPosQuery(nullptr);
+    for (auto& obj : g_test_objects) {
+        mgr.TrackObject(&obj);
+    }
+
+    if (mgr.GetSpatialGrid().Size() != static_cast<int>(g_test_objects.size())) {
+        printf("FAILED - Grid should track every object\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Grid answer must match a brute-force scan of the same world rect
+    int wx1, wy1, wx2, wy2;
+    GameViewport::Instance().ScreenToWorld(0, 16, wx1, wy1);
+    GameViewport::Instance().ScreenToWorld(200, 150, wx2, wy2);
+    auto expected = QueryObjectsInRect(wx1, wy1, wx2, wy2);
+    auto found = mgr.GetObjectsInRect(0, 16, 200, 150);
+    if (found.size() != expected.size()) {
+        printf("FAILED - Grid returned %d objects, expected %d\n",
+               (int)found.size(), (int)expected.size());
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Moving an object across buckets keeps it findable
+    SelectableObject* mover = &g_test_objects[1];
+    mover->cell_x = 100;
+    mover->cell_y = 90;
+    mover->pixel_x = 100 * 24;
+    mover->pixel_y = 90 * 24;
+    mgr.UpdateObject(mover);
+    if (mgr.GetObjectAt(100, 90) != mover || mgr.GetObjectAt(2, 0) == mover) {
+        printf("FAILED - Moved object not found at new cell\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    std::vector<SelectableObject*> nearby;
+    mgr.GetSpatialGrid().QueryRadius(mover->pixel_x + 10, mover->pixel_y, 12, nearby);
+    if (nearby.size() != 1 || nearby[0] != mover) {
+        printf("FAILED - Radius query should find only the moved object\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Destroyed objects leave the index
+    mgr.OnObjectDestroyed(mover);
+    if (mgr.GetSpatialGrid().Contains(mover) || mgr.GetObjectAt(100, 90) != nullptr) {
+        printf("FAILED - Destroyed object still tracked\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Box select falls back to the grid when no callback is set
+    mgr.SelectInBox(0, 16, 200, 150);
+    if (!mgr.HasSelection()) {
+        printf("FAILED - Box selection via grid found nothing\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    SelectionManager_Shutdown();
+    printf("PASSED\n");
+    return true;
+}
+
+bool Test_BulkSelection() {
+    printf("Test: Bulk Selection... ");
+
+    CreateTestObjects(0);
+    SelectionManager_Init();
+
+    auto& mgr = SelectionManager::Instance();
+    mgr.SetPlayerHouse(0);
+    mgr.SetAllObjectsQuery(QueryAllObjects);
+
+    int events = 0;
+    mgr.SetSelectionCallback([&events](SelectionEvent) { events++; });
+
+    // 40 friendly objects, 10 enemy: one event, trimmed to the limit
+    std::vector<SelectableObject*> all = QueryAllObjects();
+    mgr.SelectObjects(all.data(), static_cast<int>(all.size()));
+    bool ok = events == 1 && mgr.GetSelectionCount() == MAX_SELECTION;
+
+    // Flags agree with the list for every ID
+    for (auto& obj : g_test_objects) {
+        bool listed = false;
+        for (auto* sel : mgr.GetSelection()) {
+            listed = listed || sel == &obj;
+        }
+        ok = ok && mgr.IsSelected(obj.id) == listed && mgr.IsSelected(&obj) == listed;
+    }
+    if (!ok) {
+        printf("FAILED - Bulk select (%d events, %d selected)\n", events, mgr.GetSelectionCount());
+        mgr.SetSelectionCallback(nullptr);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Adding what is already selected changes nothing and stays quiet
+    mgr.Clear();
+    events = 0;
+    mgr.AddObjectsToSelection(&all[1], 3);
+    mgr.AddObjectsToSelection(&all[1], 3);
+    if (events != 1 || mgr.GetSelectionCount() != 3 || !mgr.IsSelected(all[2]->id)) {
+        printf("FAILED - Bulk add (%d events)\n", events);
+        mgr.SetSelectionCallback(nullptr);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Select all (any type) goes through the same path
+    events = 0;
+    mgr.SelectAllOfType(-1);
+    if (events != 1 || mgr.GetSelectionCount() != MAX_SELECTION) {
+        printf("FAILED - Select all of any type (%d events)\n", events);
+        mgr.SetSelectionCallback(nullptr);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    mgr.SetSelectionCallback(nullptr);
+    SelectionManager_Shutdown();
+    if (mgr.IsSelected(all[0]->id)) {
+        printf("FAILED - Flag survived shutdown\n");
+        return false;
+    }
+
+    printf("PASSED\n");
+    return true;
+}
+
+bool Test_GroupCenter() {
+    printf("Test: Group Center... ");
+
+    CreateTestObjects(0);
+    SelectionManager_Init();
+
+    auto& mgr = SelectionManager::Instance();
+    mgr.SetPlayerHouse(0);
+
+    // Objects 1 and 2 sit at (48, 0) and (96, 0)
+    mgr.Select(&g_test_objects[1]);
+    mgr.AddToSelection(&g_test_objects[2]);
+    mgr.SaveGroup(3);
+    mgr.SaveGroup(4);
+
+    int cx = 0, cy = 0;
+    if (!mgr.GetGroupCenter(3, cx, cy) || cx != 72 || cy != 0) {
+        printf("FAILED - Center (%d, %d), expected (72, 0)\n", cx, cy);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // A reported move shifts every group the object is in
+    g_test_objects[2].pixel_y = 100;
+    mgr.UpdateObject(&g_test_objects[2]);
+    if (!mgr.GetGroupCenter(4, cx, cy) || cx != 72 || cy != 50) {
+        printf("FAILED - Center after move (%d, %d), expected (72, 50)\n", cx, cy);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Destruction leaves the other member alone in both groups
+    mgr.OnObjectDestroyed(g_test_objects[1].id);
+    if (mgr.GetGroupSize(3) != 1 || mgr.GetGroupSize(4) != 1 ||
+        !mgr.GetGroupCenter(3, cx, cy) || cx != 96 || cy != 100) {
+        printf("FAILED - Center after destroy (%d, %d)\n", cx, cy);
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    // Recall drops members that went inactive
+    g_test_objects[2].is_active = false;
+    mgr.RecallGroup(3);
+    if (mgr.HasGroup(3) || mgr.GetGroupCenter(3, cx, cy) || mgr.GetGroupSize(4) != 1) {
+        printf("FAILED - Inactive member kept\n");
+        SelectionManager_Shutdown();
+        return false;
+    }
+
+    SelectionManager_Shutdown();
+    printf("PASSED\n");
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     printf("=== Selection System Tests (Task 16e) ===\n\n");
 
@@ -377,6 +573,9 @@ int main(int argc, char* argv[]) {
     if (Test_MaxSelection()) passed++; else failed++;
     if (Test_ObjectDestroyed()) passed++; else failed++;
     if (Test_EnemyNotSelectable()) passed++; else failed++;
+    if (Test_SpatialGridDefaultQuery()) passed++; else failed++;
+    if (Test_BulkSelection()) passed++; else failed++;
+    if (Test_GroupCenter()) passed++; else failed++;
 
     Platform_Shutdown();
 
@@ -7,9 +7,16 @@
 #include "game/graphics/shape_renderer.h"
 #include "game/graphics/graphics_buffer.h"
 #include "game/graphics/remap_tables.h"
+#include "game/asset_loader.h"
+#include "game/asset_pack.h"
+#include "game/audio/aud_file.h"
+#include "game/graphics/tile_renderer.h"
 #include "platform.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 // =============================================================================
@@ -67,6 +74,226 @@ bool test_shape_cache() {
 
     // Note: Can't test actual loading without real SHP files
     // Just verify cache operations work
+    ASSERT(!cache.Pin("MOUSE.SHP"), "Pin should fail for uncached shape");
+    ASSERT(!cache.IsPinned("MOUSE.SHP"), "Uncached shape should not be pinned");
+
+    cache.SetMemoryBudget(1024 * 1024);
+    ASSERT(cache.GetMemoryBudget() == 1024 * 1024, "Budget should be stored");
+    cache.Trim();
+    ASSERT(cache.GetMemoryUsage() == 0, "Empty cache should use no memory");
+    cache.SetMemoryBudget(0);
+
+    // Handles are stable and case-insensitive, and don't load the shape
+    ShapeId id = cache.Register("MTNK.SHP");
+    ASSERT(id != SHAPE_ID_NONE, "Register should return a handle");
+    ASSERT(cache.Register("mtnk.shp") == id, "Same name should give same handle");
+    ASSERT(cache.Register("LTNK.SHP") != id, "Different names should differ");
+    ASSERT(strcmp(cache.Get_Name(id), "MTNK.SHP") == 0, "Handle should keep its name");
+    ASSERT(cache.GetCount() == 0, "Register should not load");
+    ASSERT(cache.Register("") == SHAPE_ID_NONE, "Empty name should not register");
+    ASSERT(cache.Get(SHAPE_ID_NONE) == nullptr, "Invalid handle should return null");
+
+    TEST_PASS();
+    return true;
+}
+
+// Pack of one-frame 16x16 shapes named A.SHP, B.SHP, ... for cache tests
+static bool Open_Cache_Test_Pack(int count, std::vector<uint8_t>& pack_data) {
+    AssetPackWriter writer;
+    for (int i = 0; i < count; i++) {
+        std::vector<ShapeFrame> frames(1);
+        frames[0].width = 16;
+        frames[0].height = 16;
+        frames[0].pixels.assign(frames[0].GetSize(), static_cast<uint8_t>(1 + i));
+        char name[16];
+        snprintf(name, sizeof(name), "%c.SHP", 'A' + i);
+        if (!frames[0].BuildSpans(false) || !writer.AddFrames(name, frames, 16, 16)) {
+            return false;
+        }
+    }
+    pack_data = writer.Build();
+    return AssetPack::Instance().OpenMemory(pack_data.data(), pack_data.size());
+}
+
+// Get a shape and cache its frames, so it counts against the budget
+static size_t Cache_Test_Shape(ShapeCache& cache, const char* name) {
+    ShapeRenderer* renderer = cache.Get(name);
+    if (!renderer) {
+        return 0;
+    }
+    renderer->PrecacheAllFrames(1);
+    return renderer->GetCacheSize();
+}
+
+bool test_shape_cache_lru_eviction() {
+    TEST_START("shape cache LRU eviction");
+
+    ShapeCache& cache = ShapeCache::Instance();
+    cache.Clear();
+    cache.SetMemoryBudget(0);
+    std::vector<uint8_t> pack_data;
+    ASSERT(Open_Cache_Test_Pack(5, pack_data), "Pack should open");
+
+    // A, B, C loaded in that order, then A touched: B is now the oldest
+    size_t size = Cache_Test_Shape(cache, "A.SHP");
+    ASSERT(size > 0, "Cached frames should count");
+    ASSERT(Cache_Test_Shape(cache, "B.SHP") == size, "B should load");
+    ASSERT(Cache_Test_Shape(cache, "C.SHP") == size, "C should load");
+    ASSERT(cache.Get("A.SHP") != nullptr, "A should still be cached");
+    ASSERT(cache.GetCount() == 3 && cache.GetMemoryUsage() == 3 * size, "Three shapes cached");
+    uint32_t evictions = cache.GetEvictionCount();
+
+    // Shrinking the budget evicts the least recently used, and only it
+    cache.SetMemoryBudget(2 * size);
+    ASSERT(cache.GetEvictionCount() == evictions + 1, "One shape should be evicted");
+    ASSERT(!cache.IsCached("B.SHP"), "Least recently used shape should go");
+    ASSERT(cache.IsCached("A.SHP") && cache.IsCached("C.SHP"), "Newer shapes should stay");
+    ASSERT(cache.GetMemoryUsage() == 2 * size, "Usage should drop by the evicted bytes");
+
+    // C is now the oldest but pinned, so loading D evicts A instead
+    ASSERT(cache.Pin("C.SHP"), "Pin should succeed for a cached shape");
+    ASSERT(Cache_Test_Shape(cache, "D.SHP") == size, "D should load");
+    cache.Trim();
+    ASSERT(cache.GetEvictionCount() == evictions + 2, "Trim should evict one more");
+    ASSERT(!cache.IsCached("A.SHP"), "Oldest unpinned shape should go");
+    ASSERT(cache.IsCached("C.SHP") && cache.IsPinned("C.SHP"), "Pinned shape should survive");
+    ASSERT(cache.IsCached("D.SHP"), "Newest shape should stay");
+
+    // Release frees what it can from unpinned shapes, pinned ones stay
+    ASSERT(Cache_Test_Shape(cache, "E.SHP") == size, "E should load");
+    cache.SetMemoryBudget(0);
+    ASSERT(cache.GetMemoryUsage() == 3 * size, "No budget: nothing evicted");
+    ASSERT(cache.Release(size) == size, "Release should free one shape's bytes");
+    ASSERT(!cache.IsCached("D.SHP") && cache.IsCached("E.SHP"), "Release should go oldest first");
+    ASSERT(cache.Release(10 * size) == size, "Release can only free unpinned shapes");
+    ASSERT(cache.GetCount() == 1 && cache.IsCached("C.SHP"), "Only the pinned shape is left");
+    ASSERT(cache.GetEvictionCount() == evictions + 4, "Every eviction should be counted");
+
+    // An evicted shape reloads through Get(), handles included
+    ShapeId id = cache.Register("A.SHP");
+    ASSERT(cache.Get(id) != nullptr && cache.IsCached("A.SHP"), "Evicted shape should reload");
+
+    cache.Clear();
+    AssetPack::Instance().Close();
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_shape_cache_eviction_hold() {
+    TEST_START("shape cache eviction hold");
+
+    ShapeCache& cache = ShapeCache::Instance();
+    cache.Clear();
+    std::vector<uint8_t> pack_data;
+    ASSERT(Open_Cache_Test_Pack(3, pack_data), "Pack should open");
+
+    // Budget for one shape; a frame's renderers are gathered under a hold
+    size_t size = Cache_Test_Shape(cache, "A.SHP");
+    ASSERT(size > 0, "Cached frames should count");
+    cache.SetMemoryBudget(size);
+    uint32_t evictions = cache.GetEvictionCount();
+
+    cache.HoldEviction();
+    ShapeRenderer* first = cache.Get("A.SHP");
+    ASSERT(Cache_Test_Shape(cache, "B.SHP") == size, "B should load");
+    ASSERT(Cache_Test_Shape(cache, "C.SHP") == size, "C should load");
+    cache.Trim();
+    ASSERT(cache.Release(size) == 0, "Release should free nothing while held");
+    ASSERT(cache.GetEvictionCount() == evictions, "Nothing should be evicted while held");
+    ASSERT(cache.IsCached("A.SHP") && cache.Get("A.SHP") == first,
+           "Earlier renderers should stay valid while held");
+    ASSERT(cache.GetMemoryUsage() == 3 * size, "Budget may be exceeded while held");
+
+    // Holds nest; the last release trims back to budget, oldest first
+    cache.HoldEviction();
+    cache.ReleaseEviction();
+    ASSERT(cache.IsEvictionHeld() && cache.GetCount() == 3, "Inner release should not trim");
+    cache.ReleaseEviction();
+    ASSERT(!cache.IsEvictionHeld(), "Hold should be released");
+    ASSERT(cache.GetEvictionCount() == evictions + 2, "Release should evict down to budget");
+    ASSERT(!cache.IsCached("B.SHP") && !cache.IsCached("C.SHP") && cache.IsCached("A.SHP"),
+           "Least recently used shapes should go");
+    cache.ReleaseEviction();
+    ASSERT(!cache.IsEvictionHeld(), "Unbalanced release should be ignored");
+
+    cache.SetMemoryBudget(0);
+    cache.Clear();
+    AssetPack::Instance().Close();
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_asset_loader() {
+    TEST_START("asset loader");
+
+    // Not started: work runs inline, completions wait for Pump()
+    {
+        AssetLoader loader;
+        int work = 0;
+        int done = 0;
+        AssetJobId id = loader.Submit(ASSET_PRIORITY_VISIBLE,
+                                      [&]() { work++; }, [&]() { done++; });
+        ASSERT(id != ASSET_JOB_NONE, "Submit should return a job id");
+        ASSERT(work == 1 && done == 0, "Inline work runs now, completion later");
+        ASSERT(loader.Pump() == 1 && done == 1, "Pump should run the completion");
+        ASSERT(loader.Pump() == 0, "Nothing left to pump");
+    }
+
+    // One worker, held busy so the rest queue up behind it
+    {
+        AssetLoader loader;
+        loader.Start(1);
+        ASSERT(loader.IsRunning() && loader.GetWorkerCount() == 1, "Worker should start");
+
+        std::atomic<bool> release(false);
+        loader.Submit(ASSET_PRIORITY_UI, [&]() {
+            while (!release) std::this_thread::yield();
+        });
+        while (loader.GetQueuedCount() != 0) std::this_thread::yield();
+
+        std::vector<int> order;
+        std::thread::id main_thread = std::this_thread::get_id();
+        bool done_on_main = true;
+        auto record = [&](int n) {
+            return [&, n]() {
+                order.push_back(n);
+                done_on_main = done_on_main && std::this_thread::get_id() == main_thread;
+            };
+        };
+
+        loader.Submit(ASSET_PRIORITY_PREFETCH, AssetLoader::Task(), record(3));
+        AssetJobId cancelled = loader.Submit(ASSET_PRIORITY_AUDIO, AssetLoader::Task(), record(9));
+        loader.Submit(ASSET_PRIORITY_VISIBLE, AssetLoader::Task(), record(2));
+        loader.Submit(ASSET_PRIORITY_UI, AssetLoader::Task(), record(1));
+        ASSERT(loader.GetQueuedCount() == 4, "Four jobs should be queued");
+        ASSERT(loader.Cancel(cancelled), "Queued job should cancel");
+        ASSERT(!loader.Cancel(cancelled), "Cancelled job is gone");
+
+        ASSERT(loader.Pump() == 0 && order.empty(), "Nothing finished yet");
+        release = true;
+        loader.Flush();
+
+        ASSERT(order.size() == 3, "Three completions should run");
+        ASSERT(order[0] == 1 && order[1] == 2 && order[2] == 3,
+               "Jobs should finish in priority order");
+        ASSERT(done_on_main, "Completions should run on the calling thread");
+        ASSERT(loader.GetCompletedCount() == 4, "Blocker plus three jobs completed");
+
+        loader.Stop();
+        ASSERT(!loader.IsRunning(), "Stop should join the workers");
+    }
+
+    // Shape preload of a missing file settles without caching anything
+    ShapeCache& cache = ShapeCache::Instance();
+    cache.Clear();
+    ASSERT(cache.PreloadAsync("NOSUCH.SHP"), "Preload should queue");
+    ASSERT(cache.IsLoading("nosuch.shp"), "Preload should be in flight");
+    ASSERT(!cache.PreloadAsync("NOSUCH.SHP"), "Second preload should not queue");
+    AssetLoader::Instance().Flush();
+    ASSERT(!cache.IsLoading("NOSUCH.SHP"), "Preload should have settled");
+    ASSERT(cache.GetCount() == 0, "Missing shape should not be cached");
 
     TEST_PASS();
     return true;
@@ -157,6 +384,372 @@ bool test_shape_renderer_api() {
     return true;
 }
 
+bool test_span_encoding() {
+    TEST_START("span encoding");
+
+    // 300x4 frame: mostly transparent, with a run longer than 255
+    ShapeFrame frame;
+    frame.width = 300;
+    frame.height = 4;
+    frame.pixels.assign(frame.GetSize(), 0);
+    for (int x = 10; x < 20; x++) frame.pixels[0 * 300 + x] = 5;
+    for (int x = 0; x < 290; x++) frame.pixels[1 * 300 + x] = static_cast<uint8_t>(1 + x % 200);
+    frame.pixels[3 * 300 + 299] = 7;
+    std::vector<uint8_t> original = frame.pixels;
+
+    ASSERT(frame.BuildSpans(true), "BuildSpans should succeed");
+    ASSERT(frame.HasSpans(), "Frame should have spans");
+    ASSERT(!frame.HasPixels(), "Dense pixels should be released");
+    ASSERT(frame.IsValid(), "Span-only frame should be valid");
+    ASSERT(frame.GetMemoryUsage() < original.size(), "Spans should be smaller than dense");
+
+    ASSERT(frame.ExpandSpans(), "ExpandSpans should succeed");
+    ASSERT(frame.pixels == original, "Round trip should match original pixels");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_asset_pack() {
+    TEST_START("asset pack round trip");
+
+    AssetPackWriter writer;
+
+    // Shape: one sparse frame and one empty frame
+    ShapeFrame sparse;
+    sparse.x_offset = -3;
+    sparse.y_offset = 2;
+    sparse.width = 40;
+    sparse.height = 6;
+    sparse.pixels.assign(sparse.GetSize(), 0);
+    for (int y = 0; y < 6; y++) {
+        for (int x = y; x < y + 10; x++) sparse.pixels[y * 40 + x] = static_cast<uint8_t>(1 + x + y);
+    }
+    std::vector<uint8_t> sparse_pixels = sparse.pixels;
+    ASSERT(sparse.BuildSpans(true), "BuildSpans should succeed");
+    std::vector<ShapeFrame> frames(2);
+    frames[0] = sparse;
+    ASSERT(writer.AddFrames("test.shp", frames, 40, 6), "AddFrames should succeed");
+    ASSERT(!writer.AddFrames("TEST.SHP", frames, 40, 6), "Duplicate name should be rejected");
+    ASSERT(!writer.AddFrames("A_NAME_LONGER_THAN_AN_ENTRY.SHP", frames, 40, 6),
+           "Overlong name should be rejected");
+
+    // Atlas: one two-tile template
+    std::vector<uint8_t> tiles(2 * TILE_SIZE);
+    for (size_t i = 0; i < tiles.size(); i++) tiles[i] = static_cast<uint8_t>(i * 7);
+    TemplateData tmpl;
+    tmpl.type = static_cast<TemplateType>(0);
+    tmpl.width = 1;
+    tmpl.height = 1;
+    tmpl.tile_count = 2;
+    tmpl.tiles = tiles.data();
+    ASSERT(writer.AddAtlas("TEMPERAT.ATL", {"CLEAR1.TEM"}, {&tmpl}, TILE_SIZE),
+           "AddAtlas should succeed");
+
+    // Audio: uncompressed 16-bit mono AUD
+    const int16_t samples[8] = { 0, 100, -100, 2000, -2000, 32767, -32768, 1 };
+    uint8_t aud_data[sizeof(AudHeader) + sizeof(samples)];
+    AudHeader header = {};
+    header.sample_rate = 22050;
+    header.uncompressed_size = sizeof(samples);
+    header.compressed_size = sizeof(samples);
+    header.flags = AUD_FLAG_16BIT;
+    header.compression = AUD_COMPRESS_NONE;
+    memcpy(aud_data, &header, sizeof(header));
+    memcpy(aud_data + sizeof(header), samples, sizeof(samples));
+    AudFile source;
+    ASSERT(source.LoadFromData(aud_data, sizeof(aud_data)), "Source AUD should load");
+    ASSERT(writer.AddAudio("TEST.AUD", source), "AddAudio should succeed");
+
+    std::vector<uint8_t> pack_data = writer.Build();
+    AssetPack& pack = AssetPack::Instance();
+    ASSERT(pack.OpenMemory(pack_data.data(), pack_data.size()), "Pack should open");
+    ASSERT(pack.GetEntryCount() == 3, "Pack should have 3 entries");
+    for (uint32_t i = 0; i < pack.GetEntryCount(); i++) {
+        ASSERT(pack.GetEntry(i)->offset % ASSET_PACK_PAGE_SIZE == 0, "Blobs should be page-aligned");
+    }
+    ASSERT(!pack.Find("TEST.SHP", ASSET_PACK_AUDIO), "Lookup should check the kind");
+    ASSERT(!pack.Find("MISSING.SHP", ASSET_PACK_SHAPE), "Unknown name should not be found");
+
+    // Shapes load from the pack without a platform shape
+    ShapeRenderer renderer;
+    ASSERT(renderer.Load("Test.Shp"), "Packed shape should load (any case)");
+    ASSERT(renderer.GetFrameCount() == 2, "Packed shape should keep its frames");
+    ASSERT(renderer.GetWidth() == 40 && renderer.GetHeight() == 6, "Packed shape size");
+    int x_off = 0, y_off = 0;
+    ASSERT(renderer.GetFrameOffset(0, &x_off, &y_off) && x_off == -3 && y_off == 2,
+           "Packed frame offset");
+    std::vector<uint8_t> copied(sparse_pixels.size(), 0xFF);
+    ASSERT(renderer.CopyFramePixels(0, copied.data(), 40), "Packed frame should copy");
+    ASSERT(copied == sparse_pixels, "Packed frame pixels should match");
+    ASSERT(!renderer.CopyFramePixels(1, copied.data(), 40), "Empty frame should not copy");
+    renderer.ClearCache();
+    ASSERT(renderer.CopyFramePixels(0, copied.data(), 40) && copied == sparse_pixels,
+           "Frame should reload from the pack after ClearCache");
+
+    AssetPackBlob blob;
+    const AssetPackAtlas* atlas = pack.FindAtlas("TEMPERAT.ATL", &blob);
+    ASSERT(atlas && atlas->template_count == 1 && atlas->tile_count == 2, "Atlas header");
+    const AssetPackTemplate* entry = reinterpret_cast<const AssetPackTemplate*>(atlas + 1);
+    ASSERT(strcmp(entry->name, "CLEAR1.TEM") == 0 && entry->tile_count == 2, "Atlas template");
+    ASSERT(memcmp(blob.data + atlas->tiles_offset, tiles.data(), tiles.size()) == 0,
+           "Atlas tiles should match");
+
+    AudFile aud;
+    ASSERT(aud.LoadFromMix("test.aud"), "Packed audio should load");
+    ASSERT(aud.GetSampleRate() == 22050 && aud.GetChannels() == 1, "Packed audio format");
+    ASSERT(aud.GetPCMSampleCount() == 8 &&
+           memcmp(aud.GetPCMData(), samples, sizeof(samples)) == 0, "Packed PCM should match");
+
+    // Nothing may read from the pack once it is closed
+    renderer.Unload();
+    pack.Close();
+    ShapeRenderer unpacked;
+    ASSERT(!unpacked.Load("TEST.SHP"), "Closed pack should not serve shapes");
+
+    // Damaged packs are refused
+    std::vector<uint8_t> bad = pack_data;
+    bad[0] = 'X';
+    ASSERT(!pack.OpenMemory(bad.data(), bad.size()), "Bad magic should be refused");
+    bad = pack_data;
+    bad.resize(bad.size() - 1);
+    ASSERT(!pack.OpenMemory(bad.data(), bad.size()), "Truncated pack should be refused");
+    ASSERT(!pack.IsOpen(), "Pack should stay closed");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_parallel_precache() {
+    TEST_START("parallel frame precache");
+
+    // A shape with enough frames to split across workers
+    const int FRAMES = 300;
+    const int W = 24;
+    const int H = 20;
+    std::vector<ShapeFrame> frames(FRAMES);
+    std::vector<std::vector<uint8_t>> expected(FRAMES);
+    for (int f = 0; f < FRAMES; f++) {
+        ShapeFrame& frame = frames[f];
+        frame.width = W;
+        frame.height = static_cast<int16_t>(1 + f % H);
+        frame.pixels.assign(frame.GetSize(), 0);
+        for (size_t i = 0; i < frame.pixels.size(); i++) {
+            if ((i + f) % 3) frame.pixels[i] = static_cast<uint8_t>(1 + (i * 7 + f) % 200);
+        }
+        expected[f] = frame.pixels;
+        ASSERT(frame.BuildSpans(true), "BuildSpans should succeed");
+    }
+
+    AssetPackWriter writer;
+    ASSERT(writer.AddFrames("MANY.SHP", frames, W, H), "AddFrames should succeed");
+    std::vector<uint8_t> pack_data = writer.Build();
+    AssetPack& pack = AssetPack::Instance();
+    ASSERT(pack.OpenMemory(pack_data.data(), pack_data.size()), "Pack should open");
+
+    ShapeRenderer serial;
+    ShapeRenderer parallel;
+    ASSERT(serial.Load("MANY.SHP") && parallel.Load("MANY.SHP"), "Packed shape should load");
+    serial.PrecacheAllFrames();
+    parallel.PrecacheAllFrames(4);
+    ASSERT(parallel.GetCacheSize() == serial.GetCacheSize(), "Both caches should hold every frame");
+
+    std::vector<uint8_t> copied(W * H);
+    for (int f = 0; f < FRAMES; f++) {
+        ASSERT(parallel.CopyFramePixels(f, copied.data(), W), "Precached frame should copy");
+        ASSERT(std::equal(expected[f].begin(), expected[f].end(), copied.begin()),
+               "Precached frame pixels should match");
+    }
+
+    // 0 uses one worker per hardware thread
+    parallel.ClearCache();
+    parallel.PrecacheAllFrames(0);
+    ASSERT(parallel.GetCacheSize() == serial.GetCacheSize(), "Default worker count should cache all");
+
+    serial.Unload();
+    parallel.Unload();
+    pack.Close();
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_delta_shape_precache() {
+    TEST_START("delta shape precache");
+
+    // Raw SHP: frame 0 a keyframe, every later frame XOR'd with the one
+    // before it, so frame N only decodes through frames 0..N-1
+    const int FRAMES = 40;
+    const int W = 16;
+    const int H = 8;
+    const size_t size = static_cast<size_t>(W) * H;
+    std::vector<std::vector<uint8_t>> expected(FRAMES, std::vector<uint8_t>(size));
+    for (int f = 0; f < FRAMES; f++) {
+        for (size_t i = 0; i < size; i++) {
+            expected[f][i] = ((i + f) % 4) ? static_cast<uint8_t>(1 + (i * 5 + f * 3) % 250) : 0;
+        }
+    }
+
+    std::vector<uint8_t> shp = {FRAMES, 0, 0, 0, W, 0, H, 0};
+    size_t data_start = 8 + FRAMES * 8;
+    for (int f = 0; f < FRAMES; f++) {
+        uint32_t offset = static_cast<uint32_t>(data_start + f * size);
+        for (int b = 0; b < 4; b++) shp.push_back(static_cast<uint8_t>(offset >> (b * 8)));
+        shp.push_back(f == 0 ? 0 : 0x01);
+        shp.push_back(static_cast<uint8_t>(f == 0 ? 0 : f - 1));
+        shp.push_back(0);
+        shp.push_back(0);
+    }
+    for (int f = 0; f < FRAMES; f++) {
+        for (size_t i = 0; i < size; i++) {
+            shp.push_back(f == 0 ? expected[f][i] : expected[f][i] ^ expected[f - 1][i]);
+        }
+    }
+
+    ShapeRenderer precached;
+    ASSERT(precached.LoadFromMemory(shp.data(), static_cast<int32_t>(shp.size()), "DELTA.SHP"),
+           "Delta shape should load");
+    precached.PrecacheAllFrames();
+
+    std::vector<uint8_t> copied(size);
+    for (int f = 0; f < FRAMES; f++) {
+        ASSERT(precached.CopyFramePixels(f, copied.data(), W), "Precached frame should copy");
+        ASSERT(copied == expected[f], "Precached delta frame should match");
+    }
+
+    // One frame at a time, as an animation would ask for them
+    ShapeRenderer played;
+    ASSERT(played.LoadFromMemory(shp.data(), static_cast<int32_t>(shp.size()), "DELTA.SHP"),
+           "Delta shape should load");
+    for (int f = FRAMES - 1; f >= 0; f -= 7) {
+        ASSERT(played.CopyFramePixels(f, copied.data(), W), "Frame should copy");
+        ASSERT(copied == expected[f], "Delta frame decoded alone should match");
+    }
+
+    std::vector<uint8_t> range(size * 3);
+    ASSERT(Platform_Shape_DecodeRange(nullptr, 0, 3, range.data(), static_cast<int32_t>(range.size())) == -1,
+           "Null shape should fail");
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_frame_slab() {
+    TEST_START("shape frame slab");
+
+    ShapeFrameSlab slab;
+    std::vector<ShapeFrame> frames(40);
+    std::vector<uint32_t> offsets;
+    for (int f = 0; f < 40; f++) {
+        ShapeFrame& frame = frames[f];
+        frame.width = 9;
+        frame.height = static_cast<int16_t>(1 + f % 7);
+        frame.pixels.assign(frame.GetSize(), 0);
+        for (size_t i = f % 2; i < frame.pixels.size(); i += 2) {
+            frame.pixels[i] = static_cast<uint8_t>(1 + f);
+        }
+        ASSERT(frame.BuildSpans(false), "BuildSpans should succeed");
+        offsets.push_back(slab.Append(frame));
+        ASSERT(offsets.back() % sizeof(uint32_t) == 0, "Frames should stay 4-byte aligned");
+    }
+    ASSERT(slab.GetCapacity() < slab.GetSize() * 2, "Growth should be geometric");
+
+    // Offsets survive every reallocation along the way
+    for (int f = 0; f < 40; f++) {
+        const ShapeFrame& frame = frames[f];
+        ASSERT(memcmp(slab.Rows(offsets[f]), frame.row_offsets.data(),
+                      frame.row_offsets.size() * sizeof(uint32_t)) == 0, "Rows should round-trip");
+        ASSERT(memcmp(slab.Spans(offsets[f], frame.height), frame.spans.data(),
+                      frame.spans.size()) == 0, "Spans should round-trip");
+    }
+
+    ShapeFrameSlab moved(std::move(slab));
+    ASSERT(slab.GetSize() == 0 && moved.GetSize() > 0, "Move should take the storage");
+
+    // Lazily precached frames land in the same slab
+    AssetPackWriter writer;
+    ASSERT(writer.AddFrames("SLAB.SHP", frames, 9, 7), "AddFrames should succeed");
+    std::vector<uint8_t> pack_data = writer.Build();
+    AssetPack& pack = AssetPack::Instance();
+    ASSERT(pack.OpenMemory(pack_data.data(), pack_data.size()), "Pack should open");
+
+    ShapeRenderer shape;
+    ASSERT(shape.Load("SLAB.SHP"), "Packed shape should load");
+    for (int f = 39; f >= 0; f--) {
+        shape.PrecacheFrame(f);
+    }
+    std::vector<uint8_t> copied(9 * 7);
+    for (int f = 0; f < 40; f++) {
+        ASSERT(shape.CopyFramePixels(f, copied.data(), 9), "Precached frame should copy");
+        ASSERT(std::equal(frames[f].pixels.begin(), frames[f].pixels.end(), copied.begin()),
+               "Precached frame pixels should match");
+    }
+    size_t lazy_size = shape.GetCacheSize();
+    shape.ClearCache();
+    ASSERT(shape.GetCacheSize() == 0, "ClearCache should free the slab");
+    shape.PrecacheAllFrames(1);
+    ASSERT(shape.GetCacheSize() <= lazy_size, "Bulk precache should size the slab exactly");
+
+    shape.Unload();
+    pack.Close();
+
+    TEST_PASS();
+    return true;
+}
+
+bool test_shadow_mask() {
+    TEST_START("combined shadow mask");
+
+    // One fully opaque 8x8 frame
+    std::vector<ShapeFrame> frames(1);
+    frames[0].width = 8;
+    frames[0].height = 8;
+    frames[0].pixels.assign(frames[0].GetSize(), 5);
+    ASSERT(frames[0].BuildSpans(false), "BuildSpans should succeed");
+    AssetPackWriter writer;
+    ASSERT(writer.AddFrames("SHADOW.SHP", frames, 8, 8), "AddFrames should succeed");
+    std::vector<uint8_t> pack_data = writer.Build();
+    AssetPack& pack = AssetPack::Instance();
+    ASSERT(pack.OpenMemory(pack_data.data(), pack_data.size()), "Pack should open");
+
+    ShapeRenderer shape;
+    ASSERT(shape.Load("SHADOW.SHP"), "Packed shape should load");
+
+    uint8_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = static_cast<uint8_t>(i / 2);
+    }
+
+    // Two shadows overlapping in a 4x4 corner, per shadow and combined
+    const int W = 32, H = 32;
+    std::vector<uint8_t> stacked(W * H, 200), combined(W * H, 200), mask(W * H, 0);
+    GraphicsBuffer stacked_view(stacked.data(), W, H, W);
+    GraphicsBuffer mask_view(mask.data(), W, H, W);
+    stacked_view.Lock();
+    mask_view.Lock();
+    for (int i = 0; i < 2; i++) {
+        ASSERT(shape.DrawShadow(stacked_view, 4 + i * 4, 4 + i * 4, 0, table), "DrawShadow should draw");
+        ASSERT(shape.DrawMask(mask_view, 4 + i * 4, 4 + i * 4, 0), "DrawMask should draw");
+    }
+    mask_view.Unlock();
+    stacked_view.Unlock();
+    ASSERT(mask[9 * W + 9] == 1, "Overlapping marks should OR, not add");
+    Platform_Buffer_ShadowMask(combined.data(), W, W, H, &mask[4 * W + 4], W,
+                               4, 4, 12, 12, table);
+
+    ASSERT(stacked[9 * W + 9] == 50, "Stacked shadows should darken twice");
+    ASSERT(combined[9 * W + 9] == 100, "Combined shadow should darken once");
+    ASSERT(combined[5 * W + 5] == stacked[5 * W + 5], "Single cover should match DrawShadow");
+    ASSERT(combined[2 * W + 2] == 200 && combined[14 * W + 5] == 200,
+           "Unmasked pixels should be untouched");
+
+    shape.Unload();
+    pack.Close();
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -304,9 +897,18 @@ int main(int argc, char* argv[]) {
     // Run unit tests
     test_shape_loading();
     test_shape_cache();
+    test_shape_cache_lru_eviction();
+    test_shape_cache_eviction_hold();
+    test_asset_loader();
     test_remap_tables();
     test_draw_flags();
     test_shape_renderer_api();
+    test_span_encoding();
+    test_asset_pack();
+    test_parallel_precache();
+    test_delta_shape_precache();
+    test_frame_slab();
+    test_shadow_mask();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
@@ -4,10 +4,13 @@
 
 #include "game/audio/sound_manager.h"
 #include "game/audio/aud_file.h"
+#include "game/asset_pack.h"
+#include "game/shared_asset_cache.h"
 #include "platform.h"
 #include <cstdio>
 #include <cstring>
 #include <cmath>
+#include <vector>
 
 //=============================================================================
 // Test Utilities
@@ -207,6 +210,34 @@ bool Test_MaxDistance() {
     return true;
 }
 
+bool Test_DistanceFalloff() {
+    SoundManager& mgr = SoundManager::Instance();
+
+    if (!mgr.IsInitialized()) {
+        mgr.Initialize();
+    }
+
+    mgr.SetListenerPosition(1000, 1000);
+    mgr.SetMaxDistance(1000);
+
+    TEST_ASSERT(mgr.CalculateDistanceVolume(1000, 1000) == 1.0f, "Full volume at the listener");
+    TEST_ASSERT(mgr.CalculateDistanceVolume(2000, 1000) == 0.0f, "Silent at max distance");
+    TEST_ASSERT(mgr.CalculateDistanceVolume(1000, 2500) == 0.0f, "Silent beyond max distance");
+
+    // Table lookup should track the linear falloff it replaces
+    float previous = 1.0f;
+    for (int d = 0; d < 1000; d += 50) {
+        float expected = 1.0f - d / 1000.0f;
+        float actual = mgr.CalculateDistanceVolume(1000 + d * 3 / 5, 1000 + d * 4 / 5);
+        TEST_ASSERT(std::fabs(actual - expected) < 0.04f, "Falloff should be linear in distance");
+        TEST_ASSERT(actual <= previous, "Falloff should not rise with distance");
+        previous = actual;
+    }
+
+    mgr.SetMaxDistance(1200);  // Reset to default
+    return true;
+}
+
 bool Test_GlobalFunctions() {
     // Test the C-style global functions
 
@@ -293,6 +324,184 @@ bool Test_SoundStats() {
     return true;
 }
 
+// Uncompressed 16-bit mono AUD of `count` samples
+static bool AddTestSound(AssetPackWriter& writer, SoundEffect sfx, int count) {
+    std::vector<uint8_t> data(sizeof(AudHeader) + count * sizeof(int16_t));
+    AudHeader header = {};
+    header.sample_rate = 22050;
+    header.uncompressed_size = static_cast<uint32_t>(count * sizeof(int16_t));
+    header.compressed_size = header.uncompressed_size;
+    header.flags = AUD_FLAG_16BIT;
+    header.compression = AUD_COMPRESS_NONE;
+    memcpy(data.data(), &header, sizeof(header));
+
+    AudFile aud;
+    return aud.LoadFromData(data.data(), data.size()) &&
+           writer.AddAudio(GetSoundFilename(sfx), aud);
+}
+
+bool Test_SoundCacheBudget() {
+    SoundManager& mgr = SoundManager::Instance();
+    if (!mgr.IsInitialized()) {
+        mgr.Initialize();
+    }
+
+    AssetPackWriter writer;
+    TEST_ASSERT(AddTestSound(writer, SoundEffect::UI_CLICK, 1000), "CLICK should pack");
+    TEST_ASSERT(AddTestSound(writer, SoundEffect::UI_BEEP, 2000), "BEEP1 should pack");
+    TEST_ASSERT(AddTestSound(writer, SoundEffect::UI_CANCEL, 3000), "CANCEL should pack");
+    std::vector<uint8_t> pack_data = writer.Build();
+    AssetPack& pack = AssetPack::Instance();
+    TEST_ASSERT(pack.OpenMemory(pack_data.data(), pack_data.size()), "Pack should open");
+
+    size_t budget = mgr.GetCacheBudget();
+    mgr.StopAll();
+    mgr.UnloadAllSounds();
+    TEST_ASSERT(mgr.GetResidentBytes() == 0, "Nothing should be resident after unload");
+
+    if (!mgr.Preload(SoundEffect::UI_CLICK)) {
+        printf("SKIPPED - No audio device\n  ");
+        pack.Close();
+        return true;
+    }
+    TEST_ASSERT(mgr.GetResidentBytes() == 2000, "Resident bytes should count decoded PCM");
+
+    // Room for BEEP1 and CANCEL but not all three: the oldest goes
+    uint32_t evicted = mgr.GetEvictionCount();
+    mgr.SetCacheBudget(10000);
+    TEST_ASSERT(mgr.Preload(SoundEffect::UI_BEEP), "BEEP1 should load");
+    TEST_ASSERT(mgr.Preload(SoundEffect::UI_CANCEL), "CANCEL should load");
+    TEST_ASSERT(!mgr.IsSoundLoaded(SoundEffect::UI_CLICK), "LRU sound should be evicted");
+    TEST_ASSERT(mgr.IsSoundLoaded(SoundEffect::UI_CANCEL), "Newest sound should stay");
+    TEST_ASSERT(mgr.GetResidentBytes() == 10000, "Resident bytes should fit the budget");
+    TEST_ASSERT(mgr.GetEvictionCount() == evicted + 1, "One sound should be evicted");
+
+    // Pinned sounds survive; the next oldest goes instead
+    mgr.UnloadAllSounds();
+    TEST_ASSERT(mgr.Preload(SoundEffect::UI_CLICK, true), "CLICK should load pinned");
+    mgr.Preload(SoundEffect::UI_BEEP);
+    mgr.Preload(SoundEffect::UI_CANCEL);
+    TEST_ASSERT(mgr.IsSoundLoaded(SoundEffect::UI_CLICK), "Pinned sound should stay");
+    TEST_ASSERT(!mgr.IsSoundLoaded(SoundEffect::UI_BEEP), "Unpinned LRU sound should be evicted");
+    TEST_ASSERT(mgr.GetResidentBytes() == 8000, "Eviction should release its bytes");
+
+    // Shrinking the budget evicts at once, but never below the pins
+    mgr.SetCacheBudget(1);
+    TEST_ASSERT(mgr.GetResidentBytes() == 2000, "Only the pinned sound should remain");
+    TEST_ASSERT(mgr.GetHitRate() >= 0.0f && mgr.GetHitRate() <= 1.0f, "Hit rate should be a fraction");
+
+    mgr.UnpinAll();
+    mgr.UnloadAllSounds();
+    mgr.SetCacheBudget(budget);
+    pack.Close();
+    return true;
+}
+
+bool Test_VoicePoolStealing() {
+    SoundVoicePool pool;
+    pool.Reset(3);
+    TEST_ASSERT(pool.GetCapacity() == 3, "Capacity should follow Reset");
+    TEST_ASSERT(pool.FindLowest() == -1, "Empty pool has no lowest voice");
+
+    PlayingSoundInfo info = {};
+    info.play_handle = 1;
+    int a = pool.Allocate(info, 100);
+    info.play_handle = 2;
+    int b = pool.Allocate(info, 40);
+    info.play_handle = 3;
+    int c = pool.Allocate(info, 40);
+    TEST_ASSERT(a >= 0 && b >= 0 && c >= 0, "Three voices should fit");
+    TEST_ASSERT(pool.IsFull(), "Pool should be full");
+    TEST_ASSERT(pool.Allocate(info, 200) == -1, "Full pool should refuse");
+
+    // Lowest priority first, oldest first within a priority
+    TEST_ASSERT(pool.FindLowest() == b, "Oldest of the quietest voices is stolen first");
+    TEST_ASSERT(pool.Find(3) == c, "Find should locate a handle");
+
+    pool.SetPriority(b, 150);
+    TEST_ASSERT(pool.FindLowest() == c, "Raised voice should no longer be lowest");
+
+    pool.Release(c);
+    TEST_ASSERT(!pool.IsFull() && pool.GetActiveCount() == 2, "Release should free a slot");
+    TEST_ASSERT(pool.FindLowest() == a, "Next lowest should be found");
+    TEST_ASSERT(pool.Find(3) == -1, "Released handle should be gone");
+
+    pool.Reset(1000);
+    TEST_ASSERT(pool.GetCapacity() == SoundVoicePool::MAX_VOICES, "Capacity should clamp");
+    TEST_ASSERT(pool.GetActiveCount() == 0, "Reset should drop every voice");
+
+    return true;
+}
+
+bool Test_VoicePriority() {
+    // Category floors order the classes; volume orders within one
+    uint8_t ui = SoundManager::GetVoicePriority(SoundEffect::UI_CLICK, 1.0f);
+    uint8_t near_nuke = SoundManager::GetVoicePriority(SoundEffect::EXPLODE_NUKE, 1.0f);
+    uint8_t far_nuke = SoundManager::GetVoicePriority(SoundEffect::EXPLODE_NUKE, 0.1f);
+    uint8_t near_pistol = SoundManager::GetVoicePriority(SoundEffect::WEAPON_PISTOL, 1.0f);
+    uint8_t fire = SoundManager::GetVoicePriority(SoundEffect::AMBIENT_FIRE, 1.0f);
+
+    TEST_ASSERT(near_nuke > far_nuke, "Distant sounds should rank lower");
+    TEST_ASSERT(near_nuke > near_pistol, "Sound priority should order a category");
+    TEST_ASSERT(near_pistol > fire, "Combat should outrank ambient");
+    TEST_ASSERT(ui > fire, "UI should outrank ambient");
+
+    return true;
+}
+
+bool Test_SharedAssetCache() {
+    const char* path = "test_shared_assets.pak";
+    Platform_File_Delete(path);
+    AssetPack::Instance().Close();
+
+    SharedAssetCache cache_off;
+    TEST_ASSERT(!cache_off.Open_File(path), "Disabled cache should not open");
+    TEST_ASSERT(!cache_off.Is_Active(), "Disabled cache should stay inactive");
+
+    SharedAssetCache& cache = SharedAssetCache::Instance();
+    cache.Set_Enabled(true);
+    SharedAssetCache::Note_Audio("CLICK.AUD");
+    TEST_ASSERT(cache.Pending() == 0, "Notes before Open should be ignored");
+
+    // No file yet: this instance populates it
+    TEST_ASSERT(!cache.Open_File(path), "Missing cache file should not map");
+    TEST_ASSERT(cache.Is_Active() && !cache.Is_Mapped(), "Missing cache file should still note");
+    SharedAssetCache::Note_Audio("NOSUCH1.AUD");
+    SharedAssetCache::Note_Audio("NOSUCH1.AUD");
+    SharedAssetCache::Note_Shape("NOSUCH2.SHP");
+    TEST_ASSERT(cache.Pending() == 2, "Notes should dedupe");
+
+    // Nothing decodes without MIX files: dropped, no file written
+    TEST_ASSERT(!cache.Save(), "Undecodable notes should not be written");
+    TEST_ASSERT(cache.Pending() == 0, "Undecodable notes should be dropped");
+    cache.Close();
+    TEST_ASSERT(!cache.Is_Active() && cache.Get_Path().empty(), "Close should reset");
+
+    // A cache another instance wrote maps into AssetPack::Instance()
+    AssetPackWriter writer;
+    TEST_ASSERT(AddTestSound(writer, SoundEffect::UI_CLICK, 1000), "CLICK should pack");
+    TEST_ASSERT(writer.Write(path), "Cache file should write");
+
+    AssetPackWriter copy;
+    AssetPack written;
+    TEST_ASSERT(written.Open(path), "Cache file should open");
+    TEST_ASSERT(copy.AddPack(written) == 1 && copy.Has(GetSoundFilename(SoundEffect::UI_CLICK),
+                ASSET_PACK_AUDIO), "AddPack should copy the entries");
+    written.Close();
+
+    TEST_ASSERT(cache.Open_File(path), "Existing cache file should map");
+    TEST_ASSERT(cache.Is_Mapped() && AssetPack::Instance().IsOpen(), "Cache should be the asset pack");
+    AssetPackBlob blob;
+    TEST_ASSERT(AssetPack::Instance().FindAudio(GetSoundFilename(SoundEffect::UI_CLICK), &blob),
+                "Cached sound should be found");
+
+    cache.Close();
+    TEST_ASSERT(!AssetPack::Instance().IsOpen(), "Close should unmap the cache");
+    cache.Set_Enabled(false);
+    Platform_File_Delete(path);
+    return true;
+}
+
 //=============================================================================
 // Integration Test (requires game assets)
 //=============================================================================
@@ -311,6 +520,8 @@ bool Test_LoadFromMix() {
         mgr.Initialize();
     }
 
+    // Sounds load on demand; load them all to check the archives
+    mgr.LoadAllSounds();
     int loaded = mgr.GetLoadedSoundCount();
     if (loaded > 0) {
         printf("Loaded %d sounds from MIX\n  ", loaded);
@@ -357,10 +568,15 @@ int main(int argc, char* argv[]) {
     RUN_TEST(Muting);
     RUN_TEST(ListenerPosition);
     RUN_TEST(MaxDistance);
+    RUN_TEST(DistanceFalloff);
     RUN_TEST(GlobalFunctions);
     RUN_TEST(SoundInfoTableCompleteness);
     RUN_TEST(PlayingSoundCount);
     RUN_TEST(SoundStats);
+    RUN_TEST(SoundCacheBudget);
+    RUN_TEST(VoicePoolStealing);
+    RUN_TEST(VoicePriority);
+    RUN_TEST(SharedAssetCache);
 
     // Integration tests
     if (!quick_mode) {
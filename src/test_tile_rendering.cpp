@@ -174,6 +174,42 @@ bool test_tile_clipping() {
     return true;
 }
 
+bool test_tile_run() {
+    TEST_START("tile run drawing");
+
+    GraphicsBuffer buf(96, 48);
+    buf.Lock();
+    buf.Clear(0);
+
+    TileRenderer& renderer = TileRenderer::Instance();
+
+    TileRunEntry run[5];
+    for (int i = 0; i < 5; i++) {
+        run[i].tmpl = (i % 2) ? TEMPLATE_WATER1 : TEMPLATE_NONE;
+        run[i].icon = 0;
+        run[i].seed = static_cast<uint32_t>(i);
+    }
+
+    ASSERT(renderer.DrawTileRun(buf, 0, 0, run, 0) == 0, "Empty run draws nothing");
+
+    // Without MIX files every cell falls back to clear terrain
+    int drawn = renderer.DrawTileRun(buf, -12, 12, run, 5);
+    ASSERT(drawn >= 0 && drawn <= 5, "Drawn count should be within the run");
+
+    for (int i = 0; i < 4; i++) {
+        int px = i * TILE_WIDTH + 2;
+        ASSERT(buf.Get_Pixel(px, 20) != 0, "Every cell in the run should be drawn");
+    }
+    ASSERT(buf.Get_Pixel(50, 4) == 0, "Rows above the run are untouched");
+
+    buf.Unlock();
+
+    ASSERT(renderer.DrawTileRun(buf, 0, 0, run, 5) == 0, "Unlocked buffer draws nothing");
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_cache_operations() {
     TEST_START("cache operations");
 
@@ -199,6 +235,40 @@ bool test_cache_operations() {
     return true;
 }
 
+bool test_background_theater_load() {
+    TEST_START("background theater load");
+
+    TileRenderer& renderer = TileRenderer::Instance();
+
+    ASSERT(!renderer.BeginTheaterLoad(static_cast<TheaterType>(THEATER_COUNT)),
+           "Invalid theater should be rejected");
+
+    // Loads to completion and swaps in
+    ASSERT(renderer.BeginTheaterLoad(THEATER_SNOW), "Begin should succeed");
+    ASSERT(renderer.GetTheater() == THEATER_SNOW, "Theater switches immediately");
+    renderer.WaitForTheaterLoad();
+    ASSERT(!renderer.IsTheaterLoading(), "Load should be finished");
+    ASSERT(renderer.GetTheaterLoadProgress() == 1.0f, "Idle progress should be 1");
+    ASSERT(!renderer.UpdateTheaterLoad(), "Nothing left to install");
+
+    // Switching theater again cancels an in-flight load
+    ASSERT(renderer.BeginTheaterLoad(THEATER_TEMPERATE), "Begin should succeed");
+    renderer.SetTheater(THEATER_INTERIOR);
+    ASSERT(!renderer.IsTheaterLoading(), "SetTheater should cancel the load");
+    ASSERT(renderer.GetTheater() == THEATER_INTERIOR, "Theater should be interior");
+
+    // Polling eventually installs
+    renderer.BeginTheaterLoad(THEATER_TEMPERATE);
+    for (int i = 0; i < 1000 && renderer.UpdateTheaterLoad(); i++) {
+        Platform_Delay(1);
+    }
+    renderer.WaitForTheaterLoad();
+    ASSERT(!renderer.IsTheaterLoading(), "Polling should finish the load");
+
+    TEST_PASS();
+    return true;
+}
+
 // =============================================================================
 // Visual Test
 // =============================================================================
@@ -329,7 +399,9 @@ int main(int argc, char* argv[]) {
     test_overlay_types();
     test_clear_terrain();
     test_tile_clipping();
+    test_tile_run();
     test_cache_operations();
+    test_background_theater_load();
 
     printf("\n------------------------------------------\n");
     printf("Tests: %d/%d passed\n", tests_passed, tests_run);
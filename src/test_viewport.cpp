@@ -356,6 +356,64 @@ bool test_tracking() {
     return true;
 }
 
+bool test_scroll_motion() {
+    TEST_START("scroll motion easing and lookahead");
+
+    ScrollMotion motion;
+    int dx, dy;
+
+    // Eases in: the first frame moves less than full speed
+    motion.Step(8.0f, 0.0f, dx, dy);
+    ASSERT(dx > 0 && dx < 8 && dy == 0, "First frame should ease in");
+
+    int total = dx;
+    for (int i = 0; i < 30; i++) {
+        motion.Step(8.0f, 0.0f, dx, dy);
+        total += dx;
+    }
+    ASSERT(motion.GetVelocityX() == 8.0f && dx == 8, "Should reach full speed");
+
+    // Eases out: keeps moving a few frames after release, then stops dead
+    motion.Step(0.0f, 0.0f, dx, dy);
+    ASSERT(dx > 0 && motion.IsMoving(), "Should coast after release");
+    for (int i = 0; i < 30; i++) {
+        motion.Step(0.0f, 0.0f, dx, dy);
+    }
+    ASSERT(!motion.IsMoving() && dx == 0, "Should come to rest");
+
+    // A half-pixel speed moves one pixel every other frame
+    motion.Reset();
+    for (int i = 0; i < 30; i++) {
+        motion.Step(0.0f, 0.5f, dx, dy);
+    }
+    total = 0;
+    for (int i = 0; i < 10; i++) {
+        motion.Step(0.0f, 0.5f, dx, dy);
+        total += dy;
+    }
+    ASSERT(total == 5, "Sub-pixel speed should accumulate");
+
+    // Heading right and down 12 px/frame: a column strip past the right edge
+    // and a row strip under the bottom
+    motion.Reset();
+    for (int i = 0; i < 30; i++) {
+        motion.Step(12.0f, 12.0f, dx, dy);
+    }
+    ScrollCellRange ahead[2];
+    int count = motion.LeadCells(240, 48, 480, 384, 4, ahead);
+    ASSERT(count == 2, "Diagonal scroll should expose two strips");
+    ASSERT(ahead[0].start_x == 30 && ahead[0].end_x == 32, "Column strip should lead right edge");
+    ASSERT(ahead[0].start_y == 2 && ahead[0].end_y == 20, "Column strip should span the sweep");
+    ASSERT(ahead[1].start_x == 10 && ahead[1].end_x == 30, "Row strip should span the view");
+    ASSERT(ahead[1].start_y == 18 && ahead[1].end_y == 20, "Row strip should lead bottom edge");
+
+    motion.Reset();
+    ASSERT(motion.LeadCells(240, 48, 480, 384, 4, ahead) == 0, "Still view exposes nothing");
+
+    TEST_PASS();
+    return true;
+}
+
 bool test_scroll_manager_singleton() {
     TEST_START("scroll manager singleton");
 
@@ -604,6 +662,7 @@ int main(int argc, char* argv[]) {
     test_edge_scroll();
     test_keyboard_scroll();
     test_tracking();
+    test_scroll_motion();
     test_scroll_manager_singleton();
     test_scroll_easing();
 
@@ -215,6 +215,38 @@ bool Test_QueueOperations() {
     return true;
 }
 
+bool Test_QueueDedup() {
+    VoiceManager& mgr = VoiceManager::Instance();
+
+    if (!mgr.IsInitialized()) {
+        mgr.Initialize();
+    }
+
+    mgr.ClearEvaQueue();
+    uint32_t collapsed = mgr.GetEvaCollapsedCount();
+
+    // A burst of the same line queues it once
+    for (int i = 0; i < 10; i++) {
+        mgr.QueueEva(EvaVoice::UNIT_LOST);
+    }
+    mgr.QueueEva(EvaVoice::BUILDING_LOST);
+
+    TEST_ASSERT(mgr.GetQueueSize() == 2, "Repeated line should queue once");
+    TEST_ASSERT(mgr.GetEvaCollapsedCount() == collapsed + 9, "Duplicates should be counted");
+
+    // Clearing forgets what was queued
+    mgr.ClearEvaQueue();
+    mgr.QueueEva(EvaVoice::UNIT_LOST);
+    TEST_ASSERT(mgr.GetQueueSize() == 1, "Line should queue again after clear");
+
+    // Out-of-range lines are ignored
+    mgr.QueueEva(EvaVoice::COUNT);
+    TEST_ASSERT(mgr.GetQueueSize() == 1, "Invalid line should not queue");
+
+    mgr.ClearEvaQueue();
+    return true;
+}
+
 bool Test_VoiceFactionEnum() {
     TEST_ASSERT(static_cast<int>(VoiceFaction::NEUTRAL) == 0, "NEUTRAL should be 0");
     TEST_ASSERT(static_cast<int>(VoiceFaction::ALLIED) == 1, "ALLIED should be 1");
@@ -359,6 +391,7 @@ int main(int argc, char* argv[]) {
     RUN_TEST(GlobalFunctions);
     RUN_TEST(InitialState);
     RUN_TEST(QueueOperations);
+    RUN_TEST(QueueDedup);
     RUN_TEST(VoiceFactionEnum);
     RUN_TEST(EvaVoiceInfoTableCompleteness);
     RUN_TEST(UnitVoiceInfoTableCompleteness);
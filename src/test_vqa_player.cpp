@@ -0,0 +1,295 @@
+// src/test_vqa_player.cpp
+// Unit tests for VQA movie decoding and playback
+// Movies are built in memory, so no MIX archives are needed
+
+#include "game/video/vqa_decoder.h"
+#include "game/video/vqa_player.h"
+#include "platform.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//=============================================================================
+// Test Utilities
+//=============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (!(cond)) { \
+            printf("  FAILED: %s\n", msg); \
+            return false; \
+        } \
+    } while(0)
+
+#define RUN_TEST(name) \
+    do { \
+        printf("Test: %s... ", #name); \
+        if (Test_##name()) { \
+            printf("PASSED\n"); \
+            tests_passed++; \
+        } else { \
+            tests_failed++; \
+        } \
+    } while(0)
+
+//=============================================================================
+// Movie Builder
+//=============================================================================
+
+static const int MOVIE_WIDTH = 16;
+static const int MOVIE_HEIGHT = 8;
+static const int MOVIE_BLOCKS = (MOVIE_WIDTH / 4) * (MOVIE_HEIGHT / 2);
+static const int SOUND_BYTES = 64;      // IMA bytes per frame, two samples each
+
+static void Put_Be32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void Put_Chunk(std::vector<uint8_t>& out, uint32_t id, const std::vector<uint8_t>& body) {
+    Put_Be32(out, id);
+    Put_Be32(out, static_cast<uint32_t>(body.size()));
+    out.insert(out.end(), body.begin(), body.end());
+    if (body.size() & 1) {
+        out.push_back(0);
+    }
+}
+
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out(data.size() * 2 + 64);
+    int32_t size = Platform_LCW_Compress(data.data(), static_cast<int32_t>(data.size()),
+                                         out.data(), static_cast<int32_t>(out.size()));
+    out.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    return out;
+}
+
+// Two-entry 4x2 codebook: entry e, pixel p is base + e * 8 + p
+static std::vector<uint8_t> Make_Codebook(uint8_t base) {
+    std::vector<uint8_t> book(16);
+    for (int i = 0; i < 16; i++) {
+        book[i] = static_cast<uint8_t>(base + i);
+    }
+    return book;
+}
+
+// Every third block solid in color 100 + block, the rest codebook entries
+static std::vector<uint8_t> Make_Pointers() {
+    std::vector<uint8_t> pointers(MOVIE_BLOCKS * 2);
+    for (int i = 0; i < MOVIE_BLOCKS; i++) {
+        bool solid = (i % 3 == 0);
+        pointers[i] = static_cast<uint8_t>(solid ? 100 + i : i % 2);
+        pointers[MOVIE_BLOCKS + i] = solid ? 0x0F : 0x00;
+    }
+    return pointers;
+}
+
+// A 16x8 movie of 4x2 blocks. Frame 1 carries a raw codebook that takes
+// over from frame 2; with audio, an SND2 chunk leads every frame.
+static std::vector<uint8_t> Build_Movie(int frames, bool audio) {
+    VqaHeader header = {};
+    header.version = 2;
+    header.flags = audio ? VQA_FLAG_AUDIO : 0;
+    header.frames = static_cast<uint16_t>(frames);
+    header.width = MOVIE_WIDTH;
+    header.height = MOVIE_HEIGHT;
+    header.block_width = 4;
+    header.block_height = 2;
+    header.fps = 15;
+    header.group_size = 8;
+    header.colors = 256;
+    header.codebook_entries = 2;
+    header.sample_rate = 22050;
+    header.channels = 1;
+    header.bits_per_sample = 16;
+
+    std::vector<uint8_t> body;
+    Put_Be32(body, Vqa_Id('W', 'V', 'Q', 'A'));
+    std::vector<uint8_t> header_bytes(sizeof(header));
+    memcpy(header_bytes.data(), &header, sizeof(header));
+    Put_Chunk(body, Vqa_Id('V', 'Q', 'H', 'D'), header_bytes);
+
+    std::vector<uint8_t> palette(768);
+    for (int i = 0; i < 768; i++) {
+        palette[i] = static_cast<uint8_t>(i % 64);
+    }
+    std::vector<uint8_t> sound(SOUND_BYTES, 0x37);
+
+    for (int f = 0; f < frames; f++) {
+        if (audio) {
+            Put_Chunk(body, Vqa_Id('S', 'N', 'D', '2'), sound);
+        }
+        std::vector<uint8_t> frame;
+        if (f == 0) {
+            Put_Chunk(frame, Vqa_Id('C', 'B', 'F', 'Z'), Compress(Make_Codebook(10)));
+            Put_Chunk(frame, Vqa_Id('C', 'P', 'L', '0'), palette);
+        }
+        if (f == 1) {
+            Put_Chunk(frame, Vqa_Id('C', 'B', 'F', '0'), Make_Codebook(50));
+        }
+        Put_Chunk(frame, Vqa_Id('V', 'P', 'T', 'Z'), Compress(Make_Pointers()));
+        Put_Chunk(body, Vqa_Id('V', 'Q', 'F', 'R'), frame);
+    }
+
+    std::vector<uint8_t> movie;
+    Put_Chunk(movie, Vqa_Id('F', 'O', 'R', 'M'), body);
+    return movie;
+}
+
+// Pixel (x, y) as drawn with the codebook starting at base
+static uint8_t Expected_Pixel(int x, int y, uint8_t base) {
+    int block = (y / 2) * (MOVIE_WIDTH / 4) + x / 4;
+    if (block % 3 == 0) {
+        return static_cast<uint8_t>(100 + block);
+    }
+    return static_cast<uint8_t>(base + (block % 2) * 8 + (y % 2) * 4 + x % 4);
+}
+
+static bool Frame_Matches(const VqaFrame& frame, uint8_t base) {
+    if (frame.pixels.size() != static_cast<size_t>(MOVIE_WIDTH * MOVIE_HEIGHT)) {
+        return false;
+    }
+    for (int y = 0; y < MOVIE_HEIGHT; y++) {
+        for (int x = 0; x < MOVIE_WIDTH; x++) {
+            if (frame.pixels[y * MOVIE_WIDTH + x] != Expected_Pixel(x, y, base)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//=============================================================================
+// Unit Tests
+//=============================================================================
+
+bool Test_RejectsNonVqa() {
+    std::vector<uint8_t> junk(64, 0xAB);
+    VqaDecoder decoder;
+    TEST_ASSERT(!decoder.Open(junk.data(), static_cast<uint32_t>(junk.size())),
+                "Junk should not open");
+    TEST_ASSERT(!decoder.Open(nullptr, 0), "Null data should not open");
+
+    std::vector<uint8_t> movie = Build_Movie(2, false);
+    TEST_ASSERT(!decoder.Open(movie.data(), 20), "Truncated header should not open");
+    return true;
+}
+
+bool Test_DecodeFrames() {
+    std::vector<uint8_t> movie = Build_Movie(3, true);
+    VqaDecoder decoder;
+    TEST_ASSERT(decoder.Open(movie.data(), static_cast<uint32_t>(movie.size())), "Movie should open");
+    TEST_ASSERT(decoder.GetWidth() == MOVIE_WIDTH, "Width from VQHD");
+    TEST_ASSERT(decoder.GetFrameCount() == 3, "Frame count from VQHD");
+    TEST_ASSERT(decoder.HasAudio(), "Audio flag from VQHD");
+
+    VqaFrame frame;
+    TEST_ASSERT(decoder.DecodeFrame(frame), "Frame 0 should decode");
+    TEST_ASSERT(frame.index == 0, "First frame is 0");
+    TEST_ASSERT(Frame_Matches(frame, 10), "Frame 0 drawn with the first codebook");
+    TEST_ASSERT(frame.palette_changed, "Frame 0 brings the palette");
+    TEST_ASSERT(frame.palette[3] == 3 && frame.palette[767] == 767 % 64, "Palette copied");
+    TEST_ASSERT(frame.audio.size() == SOUND_BYTES * 2, "Each IMA byte is two samples");
+
+    // A codebook arriving with frame 1 only draws from frame 2
+    TEST_ASSERT(decoder.DecodeFrame(frame), "Frame 1 should decode");
+    TEST_ASSERT(Frame_Matches(frame, 10), "Frame 1 still on the first codebook");
+    TEST_ASSERT(!frame.palette_changed, "No palette with frame 1");
+    TEST_ASSERT(frame.palette[3] == 3, "Palette carries over");
+
+    TEST_ASSERT(decoder.DecodeFrame(frame), "Frame 2 should decode");
+    TEST_ASSERT(Frame_Matches(frame, 50), "Frame 2 on the new codebook");
+
+    TEST_ASSERT(!decoder.DecodeFrame(frame), "No frame past the end");
+    TEST_ASSERT(decoder.IsFinished(), "Decoder finished");
+    return true;
+}
+
+bool Test_PlayerRingDecodesAll() {
+    const int frames = 60;
+    std::vector<uint8_t> movie = Build_Movie(frames, false);
+    VqaPlayer player;
+    TEST_ASSERT(player.OpenMemory(movie.data(), static_cast<uint32_t>(movie.size())),
+                "Player should open");
+
+    int seen = 0;
+    int waits = 0;
+    size_t early_bytes = 0;
+    bool in_order = true;
+    bool drawn = true;
+    while (seen < frames && waits < 5000) {
+        const VqaFrame* frame = player.PeekFrame();
+        if (!frame) {
+            Platform_Delay(1);
+            waits++;
+            continue;
+        }
+        in_order = in_order && frame->index == seen;
+        drawn = drawn && Frame_Matches(*frame, seen < 2 ? 10 : 50);
+        player.ReleaseFrame();
+        if (++seen == 5) {
+            early_bytes = player.GetResidentBytes();
+        }
+    }
+
+    TEST_ASSERT(seen == frames, "Every frame comes through the ring");
+    TEST_ASSERT(in_order, "Frames arrive in order");
+    TEST_ASSERT(drawn, "Frames drawn correctly on the worker");
+    TEST_ASSERT(player.IsFinished(), "Player finished once the ring drains");
+
+    // Memory holds at the ring and codebooks however long the movie runs
+    size_t end_bytes = player.GetResidentBytes();
+    TEST_ASSERT(early_bytes > 0, "Resident bytes reported");
+    TEST_ASSERT(end_bytes <= early_bytes, "Resident bytes do not grow with the movie");
+    TEST_ASSERT(end_bytes < 64 * 1024, "Resident bytes bounded by the ring and codebook room");
+
+    player.Close();
+    TEST_ASSERT(!player.IsOpen(), "Closed");
+    return true;
+}
+
+bool Test_PlayerCloseWhileDecoding() {
+    std::vector<uint8_t> movie = Build_Movie(200, true);
+    VqaPlayer player;
+    TEST_ASSERT(player.OpenMemory(movie.data(), static_cast<uint32_t>(movie.size())),
+                "Player should open");
+
+    // The worker is parked on a full ring; Close must wake and join it
+    Platform_Delay(10);
+    player.Close();
+    TEST_ASSERT(!player.IsOpen(), "Closed mid-movie");
+    TEST_ASSERT(player.PeekFrame() == nullptr, "Nothing left in the ring");
+    return true;
+}
+
+//=============================================================================
+// Main
+//=============================================================================
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+    printf("=== VQA Player Tests ===\n\n");
+
+    Platform_Init();
+
+    RUN_TEST(RejectsNonVqa);
+    RUN_TEST(DecodeFrames);
+    RUN_TEST(PlayerRingDecodesAll);
+    RUN_TEST(PlayerCloseWhileDecoding);
+
+    Platform_Shutdown();
+
+    printf("\n");
+    if (tests_failed == 0) {
+        printf("All tests PASSED (%d/%d)\n", tests_passed, tests_passed + tests_failed);
+    } else {
+        printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+    }
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+// src/tests/all_tests_main.cpp
+// Combined Test Binary Main Entry Point
+
+#include "test/test_framework.h"
+
+// Every suite's test files are linked in and self-register via TEST_CASE;
+// the platform comes up once for all of them (see TestEnvironment)
+
+TEST_MAIN()
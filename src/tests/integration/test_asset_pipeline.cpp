@@ -4,8 +4,22 @@
 
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
+#include "map_fixture.h"
+#include "game/asset_loader.h"
+#include "game/asset_manifest.h"
+#include "game/incremental_loader.h"
+#include "game/scenario.h"
+#include "game/tiberium.h"
 #include "platform.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 //=============================================================================
 // Helper to check for game data
@@ -371,3 +385,298 @@ TEST_CASE(AssetPipeline_CaseSensitivity, "AssetPipeline") {
 
     Platform_Shutdown();
 }
+
+//=============================================================================
+// Scenario Prefetch Manifest Tests
+//=============================================================================
+
+static const char SCENARIO_INI[] =
+    "; test scenario\n"
+    "[Basic]\n"
+    "Player=Greece\n"
+    "[Map]\n"
+    "Theater=SNOW\n"
+    "[UNITS]\n"
+    "0=Greece,FTNK,256,1234,0,Guard,None\n"
+    "1=Greece,ftnk,256,1240,64,Guard,None\n"
+    "[INFANTRY]\n"
+    "0=USSR,E1,256,2000,0,Guard,0,None\n"
+    "[STRUCTURES]\n"
+    "0=USSR,POWR,256,3000,0,None,1,0\n"
+    "[TERRAIN]\n"
+    "4000=T01,None\n";
+
+TEST_CASE(AssetPipeline_Manifest_FromScenario, "AssetPipeline") {
+    AssetManifest manifest;
+    TEST_ASSERT(manifest.Parse_Scenario(SCENARIO_INI, strlen(SCENARIO_INI)));
+    TEST_ASSERT_EQ(manifest.Get_Theater(), THEATER_SNOW);
+    TEST_ASSERT_EQ(manifest.Get_Player(), HOUSE_GREECE);
+
+    int shapes = 0;
+    int voices = 0;
+    bool has_ftnk = false, has_e1 = false, has_powr = false, has_tree = false;
+    for (const AssetManifestEntry& entry : manifest.Get_Entries()) {
+        if (entry.kind == ASSET_KIND_SHAPE) {
+            shapes++;
+            has_ftnk |= entry.name == "FTNK.SHP";
+            has_e1 |= entry.name == "E1.SHP";
+            has_powr |= entry.name == "POWR.SHP";
+            has_tree |= entry.name == "T01.SNO";     // Terrain takes the theater suffix
+        } else if (entry.kind == ASSET_KIND_UNIT_VOICE) {
+            voices++;
+        }
+    }
+    TEST_ASSERT_EQ(shapes, 4);
+    TEST_ASSERT(has_ftnk && has_e1 && has_powr);
+    TEST_ASSERT(has_tree);
+    TEST_ASSERT_GT(voices, 0);
+    TEST_ASSERT_EQ(manifest.Size(), static_cast<size_t>(shapes + voices));
+    TEST_ASSERT(!AssetManifest().Parse_Scenario("x=1", 3));
+}
+
+TEST_CASE(AssetPipeline_Manifest_FirstUseLog, "AssetPipeline") {
+    AssetManifest first_use;
+    AssetManifest::Begin_Recording(&first_use);
+    AssetManifest::Record_Shape("mtnk.shp");
+    AssetManifest::Record_Shape("MTNK.SHP");
+    AssetManifest::Record_Eva(EvaVoice::UNIT_READY);
+    AssetManifest::End_Recording();
+    AssetManifest::Record_Shape("LTNK.SHP");
+    TEST_ASSERT_EQ(first_use.Size(), 2u);
+
+    AssetManifest manifest;
+    manifest.Parse_Scenario(SCENARIO_INI, strlen(SCENARIO_INI));
+    size_t parsed = manifest.Size();
+    manifest.Merge(first_use);
+    TEST_ASSERT_EQ(manifest.Size(), parsed + 2);
+
+    const char* log_path = "test_first_use.log";
+    AssetManifest reloaded;
+    TEST_ASSERT(first_use.Save_Log(log_path));
+    TEST_ASSERT(reloaded.Load_Log(log_path));
+    remove(log_path);
+    TEST_ASSERT_EQ(reloaded.Size(), 2u);
+    TEST_ASSERT_EQ(reloaded.Get_Entries()[0].name, "MTNK.SHP");
+    TEST_ASSERT_EQ(reloaded.Get_Entries()[1].kind, ASSET_KIND_EVA);
+}
+
+//=============================================================================
+// Scenario Loader Tests
+//=============================================================================
+
+/// Packs a plane the way scenario editors do: LCW blocks, then base64
+static std::string Pack_Plane(const std::vector<uint8_t>& raw, const char* section) {
+    std::vector<uint8_t> blocks;
+    std::vector<uint8_t> comp(Platform_LCW_MaxCompressedSize(8192));
+    for (size_t pos = 0; pos < raw.size(); pos += 8192) {
+        int32_t length = static_cast<int32_t>(std::min<size_t>(8192, raw.size() - pos));
+        int32_t size = Platform_LCW_Compress(raw.data() + pos, length, comp.data(),
+                                             static_cast<int32_t>(comp.size()));
+        const uint8_t header[4] = { uint8_t(size), uint8_t(size >> 8),
+                                    uint8_t(length), uint8_t(length >> 8) };
+        blocks.insert(blocks.end(), header, header + 4);
+        blocks.insert(blocks.end(), comp.begin(), comp.begin() + size);
+    }
+    static const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    for (size_t i = 0; i < blocks.size(); i += 3) {
+        uint32_t bits = blocks[i] << 16;
+        if (i + 1 < blocks.size()) bits |= blocks[i + 1] << 8;
+        if (i + 2 < blocks.size()) bits |= blocks[i + 2];
+        size_t bytes = std::min<size_t>(3, blocks.size() - i);
+        for (size_t d = 0; d < 4; d++) {
+            text += d <= bytes ? digits[(bits >> (18 - 6 * d)) & 63] : '=';
+        }
+    }
+    std::string ini = std::string("[") + section + "]\n";
+    for (size_t pos = 0, line = 1; pos < text.size(); pos += 70, line++) {
+        ini += std::to_string(line) + "=" + text.substr(pos, 70) + "\n";
+    }
+    return ini;
+}
+
+/// A snow map with a tree at (40, 50), ore and a wall at (44..45, 52),
+/// one tank and one power plant
+static std::string Test_Scenario_Ini() {
+    std::vector<uint8_t> map_pack(MAP_CELL_TOTAL * 3, 0xFF);
+    std::vector<uint8_t> overlay_pack(MAP_CELL_TOTAL, 0xFF);
+    int tree_cell = 50 * 128 + 40;
+    map_pack[tree_cell * 2] = 12;
+    map_pack[tree_cell * 2 + 1] = 0;
+    map_pack[MAP_CELL_TOTAL * 2 + tree_cell] = 3;
+    overlay_pack[52 * 128 + 44] = 5;    // GOLD1 in the original numbering
+    overlay_pack[52 * 128 + 45] = 2;    // Brick wall
+
+    return "[Map]\nTheater=SNOW\nX=10\nY=12\nWidth=60\nHeight=50\n"
+           "[UNITS]\n0=Greece,MTNK,128,6700,64,Guard,None\n"
+           "[STRUCTURES]\n0=USSR,POWR,256,6810,0,None,1,0\n" +
+           Pack_Plane(map_pack, "MapPack") + Pack_Plane(overlay_pack, "OverlayPack");
+}
+
+TEST_CASE(AssetPipeline_Scenario_Parse, "AssetPipeline") {
+    std::string ini = Test_Scenario_Ini();
+    std::unique_ptr<ScenarioMap> parsed(new ScenarioMap());
+    TEST_ASSERT(ScenarioLoader::Parse(ini.c_str(), ini.size(), *parsed));
+
+    // Terrain decoded and overlays renumbered
+    int tree = MapClass::Layer_Index(40, 50);
+    TEST_ASSERT_EQ(parsed->templates[tree], 12);
+    TEST_ASSERT_EQ(parsed->icons[tree], 3);
+    TEST_ASSERT_EQ(parsed->templates[tree + 1], CELL_TEMPLATE_NONE);
+    TEST_ASSERT_EQ(parsed->overlays[MapClass::Layer_Index(44, 52)], static_cast<uint8_t>(OVERLAY_GOLD1));
+    TEST_ASSERT_EQ(parsed->overlays[MapClass::Layer_Index(45, 52)], static_cast<uint8_t>(OVERLAY_BRICK));
+
+    TEST_ASSERT_EQ(parsed->theater, THEATER_SNOW);
+    TEST_ASSERT_EQ(parsed->x, 10);
+    TEST_ASSERT_EQ(parsed->width, 60);
+    TEST_ASSERT_EQ(parsed->placements.size(), 2u);
+    TEST_ASSERT_EQ(parsed->placements[0].cell, XY_Cell(6700 % 128, 6700 / 128));
+    TEST_ASSERT_EQ(parsed->placements[0].house, HOUSE_GREECE);
+    TEST_ASSERT_EQ(parsed->placements[0].facing, 64);
+    TEST_ASSERT_EQ(parsed->placements[1].rtti, RTTI_BUILDING);
+
+    // No MapPack, no map
+    TEST_ASSERT(!ScenarioLoader::Parse("[Map]\nX=1\n", 10, *parsed));
+}
+
+TEST_CASE(AssetPipeline_Scenario_BinaryCache, "AssetPipeline") {
+    std::string ini = Test_Scenario_Ini();
+    int tree = MapClass::Layer_Index(40, 50);
+    ScenarioLoader loader;
+    loader.Set_Cache_Dir(".");
+
+    const ScenarioMap* first = loader.Read("TESTSCEN.INI", ini.c_str(), ini.size());
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT(!loader.Was_Cached());
+    const ScenarioMap* second = loader.Read("TESTSCEN.INI", ini.c_str(), ini.size());
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT(loader.Was_Cached());
+    TEST_ASSERT_EQ(second->templates[tree], 12);
+    TEST_ASSERT_EQ(second->placements.size(), 2u);
+
+    // An edited INI reparses
+    std::string edited = ini + "[Basic]\nName=Edited\n";
+    TEST_ASSERT_NOT_NULL(loader.Read("TESTSCEN.INI", edited.c_str(), edited.size()));
+    TEST_ASSERT(!loader.Was_Cached());
+    remove("./TESTSCEN.map");
+}
+
+TEST_WITH_FIXTURE(MapFixture, AssetPipeline_Scenario_Apply, "AssetPipeline") {
+    MapClass& map = fixture.map;
+    std::string ini = Test_Scenario_Ini();
+    std::unique_ptr<ScenarioMap> scenario(new ScenarioMap());
+    TEST_ASSERT(ScenarioLoader::Parse(ini.c_str(), ini.size(), *scenario));
+
+    ScenarioLoader::Apply(*scenario, map);
+    TEST_ASSERT_EQ(map[XY_Cell(40, 50)].Get_Template(), 12);
+    TEST_ASSERT_EQ(map[XY_Cell(40, 50)].Get_Icon(), 3);
+    TEST_ASSERT_EQ(map.Get_Cell_Layers()->overlay[MapClass::Layer_Index(45, 52)],
+                   static_cast<uint8_t>(OVERLAY_BRICK));
+    TEST_ASSERT_EQ(map[XY_Cell(45, 52)].Get_Land(), LAND_WALL);
+    TEST_ASSERT(map.Get_Tiberium()->Contains(XY_Cell(44, 52)));
+    TEST_ASSERT_EQ(map.Map_Bounds_X(), 10);
+    TEST_ASSERT_EQ(map.Map_Bounds_Height(), 50);
+
+    TEST_ASSERT_EQ(Object_Heap(RTTI_UNIT)->Count(), 1);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_BUILDING)->Count(), 1);
+    ObjectClass* tank = Object_Heap(RTTI_UNIT)->Active(0);
+    TEST_ASSERT_EQ(tank->Get_Owner(), HOUSE_GREECE);
+    TEST_ASSERT_EQ(tank->Get_Cell(), XY_Cell(6700 % 128, 6700 / 128));
+    TEST_ASSERT_EQ(tank->Get_Strength(), MAX_HEALTH * 128 / 256);
+    Destroy_All_Objects();
+
+    // Objects can be placed a slice at a time
+    ScenarioLoader::Apply_Map(*scenario, map);
+    size_t next = ScenarioLoader::Apply_Objects(*scenario, map, 0, 1);
+    TEST_ASSERT_EQ(next, 1u);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_UNIT)->Count(), 1);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_BUILDING)->Count(), 0);
+    TEST_ASSERT_EQ(ScenarioLoader::Apply_Objects(*scenario, map, next, 1), 2u);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_BUILDING)->Count(), 1);
+    TEST_ASSERT_EQ(ScenarioLoader::Apply_Objects(*scenario, map, 2, 1), 2u);
+}
+
+//=============================================================================
+// Incremental Loader Tests
+//=============================================================================
+
+/// Leaves the asset loader stopped with nothing waiting to finish
+class AssetLoaderFixture : public TestFixture {
+public:
+    void TearDown() override {
+        AssetLoader::Instance().Stop();
+        AssetLoader::Instance().Pump();
+    }
+};
+
+TEST_CASE(AssetPipeline_IncrementalLoader_Steps, "AssetPipeline") {
+    std::vector<std::string> order;
+    int slices = 0;
+    IncrementalLoader load;
+    load.Add("First", [&]() { order.push_back("First"); return true; });
+    load.Add("Sliced", [&]() { order.push_back("Sliced"); return ++slices == 3; });
+    load.Add("Last", [&]() { order.push_back("Last"); return true; });
+    TEST_ASSERT(!load.Is_Done());
+    TEST_ASSERT_EQ(load.Get_Progress(), 0.0f);
+    TEST_ASSERT_EQ(strcmp(load.Get_Step_Name(), "First"), 0);
+
+    // A zero budget makes one step call, an unfinished step stays current
+    TEST_ASSERT(!load.Pump(0.0));
+    TEST_ASSERT_EQ(order.size(), 1u);
+    load.Pump(0.0);
+    TEST_ASSERT_EQ(strcmp(load.Get_Step_Name(), "Sliced"), 0);
+    TEST_ASSERT_GT(load.Get_Progress(), 0.3f);
+    TEST_ASSERT_LT(load.Get_Progress(), 0.4f);
+
+    // A budget covers the rest
+    TEST_ASSERT(load.Pump(1000.0));
+    TEST_ASSERT(load.Is_Done());
+    TEST_ASSERT_EQ(order.size(), 5u);
+    TEST_ASSERT_EQ(order.back(), "Last");
+    TEST_ASSERT_EQ(slices, 3);
+
+    TEST_ASSERT(load.Pump(0.0));
+    TEST_ASSERT_EQ(load.Get_Progress(), 1.0f);
+    TEST_ASSERT_EQ(strcmp(load.Get_Step_Name(), ""), 0);
+    TEST_ASSERT_EQ(order.size(), 5u);
+}
+
+TEST_WITH_FIXTURE(AssetLoaderFixture, AssetPipeline_IncrementalLoader_ParallelJoin, "AssetPipeline") {
+    // A parallel run is handed out together and joined before the next step
+    AssetLoader::Instance().Start(2);
+    std::atomic<int> ran{0};
+    std::atomic<int> at_once{0};
+    std::atomic<int> most_at_once{0};
+    bool joined = false;
+    IncrementalLoader load;
+    for (int i = 0; i < 2; i++) {
+        load.Add_Parallel("Work", [&]() {
+            int now = ++at_once;
+            int most = most_at_once.load();
+            while (now > most && !most_at_once.compare_exchange_weak(most, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --at_once;
+            ++ran;
+        });
+    }
+    load.Add("Join", [&]() { joined = ran.load() == 2; return true; });
+    int pumps = 0;
+    while (!load.Pump(0.0) && pumps < 1000) {
+        pumps++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    TEST_ASSERT(load.Is_Done());
+    TEST_ASSERT(joined);
+    TEST_ASSERT_EQ(most_at_once.load(), 2);     // Overlapped
+}
+
+TEST_WITH_FIXTURE(AssetLoaderFixture, AssetPipeline_IncrementalLoader_ParallelInline, "AssetPipeline") {
+    // Without workers the run is done inline, within the same pump
+    int ran = 0;
+    bool joined = false;
+    IncrementalLoader load;
+    load.Add_Parallel("Work", [&]() { ++ran; });
+    load.Add("Join", [&]() { joined = ran == 1; return true; });
+    TEST_ASSERT(load.Pump(0.0));
+    TEST_ASSERT(joined);
+}
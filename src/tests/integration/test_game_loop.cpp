@@ -4,6 +4,11 @@
 
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
+#include "game/frame_pacer.h"
+#include "game/power_saver.h"
+#include "game/quality_governor.h"
+#include "game/sim_pipeline.h"
+#include "game/tick_clock.h"
 #include "platform.h"
 #include <cstring>
 
@@ -258,6 +263,193 @@ TEST_CASE(GameLoop_FrameRateControl, "GameLoop") {
     Platform_Shutdown();
 }
 
+TEST_CASE(GameLoop_FramePacing, "GameLoop") {
+    Platform_Init();
+
+    // No display: the pacer alone holds the rate
+    Platform_Frame_SetVSyncRefresh(0);
+    Platform_Frame_SetTargetFPS(120);
+    TEST_ASSERT_EQ(Platform_Frame_GetSpinThreshold(), 1000u);
+
+    for (int frame = 0; frame < 60; frame++) {
+        Platform_Frame_Begin();
+        Platform_Frame_End();
+    }
+
+    FramePacingStats stats;
+    Platform_Frame_GetPacingStats(&stats);
+    TEST_ASSERT_EQ(stats.frames, 59u);
+
+    // Deadlines on the performance counter: no millisecond rounding
+    TEST_ASSERT_GE(stats.mean_ms, 1000.0 / 120.0 - 0.25);
+    TEST_ASSERT_LE(stats.mean_ms, 1000.0 / 120.0 + 0.25);
+    TEST_ASSERT_LE(stats.stddev_ms, 1.0);
+
+    Platform_Frame_SetTargetFPS(60);
+    Platform_Shutdown();
+}
+
+TEST_CASE(GameLoop_FramePacer_LowLatency, "GameLoop") {
+    FramePacer pacer;
+    TEST_ASSERT_EQ(pacer.Get_Input_Wait_Us(0, 16666), 0u);     // No wait while off
+    pacer.Set_Low_Latency(true);
+    TEST_ASSERT_EQ(pacer.Get_Input_Wait_Us(0, 16666), 0u);     // Nor before the first frame
+
+    // 4 ms of work, present blocked for vsync and returned at 100000
+    for (int i = 0; i < 10; i++) {
+        pacer.End_Frame(100000, 16666, 4.0, 10.0);
+    }
+    TEST_ASSERT_EQ(pacer.Get_Predicted_Work_Ms(), 4.0);
+    TEST_ASSERT_EQ(pacer.Get_Next_Present_Us(), 116666u);
+
+    // Sleeps until the work just fits, and not at all once it no longer does
+    TEST_ASSERT_EQ(pacer.Get_Input_Wait_Us(100000, 16666), 16666u - 4000u - FramePacer::DEFAULT_MARGIN_US);
+    TEST_ASSERT_EQ(pacer.Get_Input_Wait_Us(112000, 16666), 0u);
+
+    // Unblocked present keeps cadence
+    pacer.End_Frame(120000, 16666, 9.0, 0.0);
+    TEST_ASSERT_EQ(pacer.Get_Next_Present_Us(), 133332u);
+
+    // A second queued frame starts a period earlier
+    pacer.Set_Max_Frames_Queued(2);
+    TEST_ASSERT_EQ(pacer.Get_Input_Wait_Us(120000, 16666), 0u);
+    pacer.Set_Max_Frames_Queued(10);
+    TEST_ASSERT_EQ(pacer.Get_Max_Frames_Queued(), FramePacer::MAX_FRAMES_QUEUED);
+}
+
+//=============================================================================
+// Quality Governor Tests
+//=============================================================================
+
+TEST_CASE(GameLoop_QualityGovernor_CutsAndRestores, "GameLoop") {
+    QualityGovernor governor;
+    QualityGovernor::Knobs applied = {};
+    int applies = 0;
+    governor.Set_Apply([&](const QualityGovernor::Knobs& knobs) {
+        applied = knobs;
+        applies++;
+    });
+    TEST_ASSERT_EQ(applies, 1);             // Applied at full quality
+    TEST_ASSERT(applied.shadows);
+    TEST_ASSERT_EQ(applied.anim_density, 256);
+
+    auto run = [&governor](double frame_ms, int frames) {
+        for (int i = 0; i < frames; i++) {
+            governor.Evaluate(frame_ms);
+        }
+    };
+
+    // No budget, no cuts
+    run(40.0, 100);
+    TEST_ASSERT_EQ(governor.Get_Level(), 0);
+    TEST_ASSERT_EQ(applies, 1);
+
+    // A brief overrun is ridden out, a sustained one cuts a level
+    governor.Set_Budget_Ms(16.0);
+    run(20.0, QualityGovernor::OVER_FRAMES - 1);
+    TEST_ASSERT_EQ(governor.Get_Level(), 0);
+    run(20.0, 1);
+    TEST_ASSERT_EQ(governor.Get_Level(), 1);
+    TEST_ASSERT_EQ(applies, 2);
+    TEST_ASSERT_LT(applied.anim_density, 256);
+
+    // Waits for the window after a cut, then cuts again
+    run(20.0, QualityGovernor::WINDOW_FRAMES);
+    TEST_ASSERT_EQ(governor.Get_Level(), 1);
+    run(20.0, QualityGovernor::OVER_FRAMES);
+    TEST_ASSERT_EQ(governor.Get_Level(), 2);
+    TEST_ASSERT(!applied.shadows);
+    TEST_ASSERT_GT(applied.voice_limit, 0);
+
+    run(40.0, 1000);
+    TEST_ASSERT_EQ(governor.Get_Level(), QualityGovernor::MAX_LEVEL);
+
+    // Between the recover line and the budget nothing moves either way
+    governor.Set_Level(1);
+    run(14.0, 1000);
+    TEST_ASSERT_EQ(governor.Get_Level(), 1);
+
+    // Restoring takes longer than cutting
+    run(10.0, QualityGovernor::UNDER_FRAMES - 1);
+    TEST_ASSERT_EQ(governor.Get_Level(), 1);
+    run(10.0, 1);
+    TEST_ASSERT_EQ(governor.Get_Level(), 0);
+    TEST_ASSERT(applied.shadows);
+    TEST_ASSERT_EQ(applied.anim_density, 256);
+    TEST_ASSERT_EQ(applied.voice_limit, 0);
+
+    // Alternating frames never build a run
+    governor.Set_Level(2);
+    for (int i = 0; i < 1000; i++) {
+        governor.Evaluate(i % 2 ? 20.0 : 10.0);
+    }
+    TEST_ASSERT_EQ(governor.Get_Level(), 2);
+
+    // Turning off restores full quality
+    governor.Set_Budget_Ms(0.0);
+    governor.Evaluate(40.0);
+    TEST_ASSERT_EQ(governor.Get_Level(), 0);
+    TEST_ASSERT(applied.shadows);
+}
+
+TEST_CASE(GameLoop_QualityGovernor_LevelsCutMore, "GameLoop") {
+    for (int level = 1; level <= QualityGovernor::MAX_LEVEL; level++) {
+        const QualityGovernor::Knobs& a = QualityGovernor::Get_Knobs(level - 1);
+        const QualityGovernor::Knobs& b = QualityGovernor::Get_Knobs(level);
+        TEST_ASSERT_LE(b.anim_density, a.anim_density);
+        TEST_ASSERT(a.shadows || !b.shadows);
+        TEST_ASSERT_GE(b.palette_divisor, a.palette_divisor);
+        TEST_ASSERT_GE(b.radar_interval, a.radar_interval);
+    }
+}
+
+//=============================================================================
+// Power Saver Tests
+//=============================================================================
+
+TEST_CASE(GameLoop_PowerSaver_SkipsStaticFrames, "GameLoop") {
+    PowerSaver saver;
+    TEST_ASSERT(saver.Begin_Frame(1000, false, false, 0));     // Active frames always draw
+    TEST_ASSERT(saver.Begin_Frame(1001, false, false, 0));
+    TEST_ASSERT_EQ(saver.Get_Wait_Ms(1005), 0u);
+
+    // A static frame draws once, then waits for the redraw timer
+    TEST_ASSERT(saver.Begin_Frame(1002, false, true, 0));
+    TEST_ASSERT(saver.Get_State() == PowerSaver::POWER_STATIC);
+    TEST_ASSERT(!saver.Begin_Frame(1010, false, true, 0));
+    TEST_ASSERT_EQ(saver.Get_Wait_Ms(1010), PowerSaver::STATIC_REDRAW_MS - 8);
+
+    // Events, Invalidate and the redraw timer each draw one
+    TEST_ASSERT(saver.Begin_Frame(1020, false, true, 3));
+    TEST_ASSERT(!saver.Begin_Frame(1030, false, true, 3));
+    saver.Invalidate();
+    TEST_ASSERT(saver.Begin_Frame(1040, false, true, 3));
+    TEST_ASSERT(saver.Begin_Frame(1040 + PowerSaver::STATIC_REDRAW_MS, false, true, 3));
+    TEST_ASSERT_EQ(saver.Get_Stats().frames_drawn, 6u);
+    TEST_ASSERT_EQ(saver.Get_Stats().frames_skipped, 2u);
+
+    // Background frames draw at the low rate
+    TEST_ASSERT(saver.Begin_Frame(5000, true, false, 3));
+    TEST_ASSERT(saver.Get_State() == PowerSaver::POWER_BACKGROUND);
+    TEST_ASSERT_EQ(saver.Get_Wait_Ms(5030), 1000 / PowerSaver::BACKGROUND_FPS - 30);
+    TEST_ASSERT_EQ(saver.Get_Wait_Ms(5000 + 1000 / PowerSaver::BACKGROUND_FPS), 0u);
+
+    // Disabled is always active
+    saver.Set_Enabled(false);
+    TEST_ASSERT(saver.Begin_Frame(6000, true, true, 3));
+    TEST_ASSERT(saver.Get_State() == PowerSaver::POWER_ACTIVE);
+    TEST_ASSERT_EQ(saver.Get_Wait_Ms(6001), 0u);
+}
+
+TEST_CASE(GameLoop_PowerSaver_CpuRate, "GameLoop") {
+    PowerSaver saver;
+    saver.Sample_Cpu(0, 0);
+    saver.Sample_Cpu(500000000, 400000000);
+    TEST_ASSERT_EQ(saver.Get_Cpu_Ms_Per_Second(), 0.0);      // Waits for a full window
+    saver.Sample_Cpu(2000000000, 500000000);
+    TEST_ASSERT_EQ(saver.Get_Cpu_Ms_Per_Second(), 250.0);
+}
+
 //=============================================================================
 // Quit Request Tests
 //=============================================================================
@@ -344,3 +536,40 @@ TEST_CASE(GameLoop_FrameCount, "GameLoop") {
     Platform_Graphics_Shutdown();
     Platform_Shutdown();
 }
+
+//=============================================================================
+// Fixed Timestep Tests
+//=============================================================================
+
+TEST_CASE(GameLoop_TickClock_CatchUp, "GameLoop") {
+    TickClock clock;
+    clock.Reset(1000);
+    TEST_ASSERT_EQ(clock.Advance(1065, 66), 0);
+    TEST_ASSERT_EQ(clock.Advance(1066, 66), 1);
+    TEST_ASSERT_EQ(clock.Alpha(1066, 66), 0.0f);
+    TEST_ASSERT_EQ(clock.Alpha(1099, 66), 0.5f);
+
+    // A long stall runs a capped number of ticks and drops the rest
+    TEST_ASSERT_EQ(clock.Advance(1066 + 66 * 20, 66), TickClock::MAX_CATCHUP_TICKS);
+    TEST_ASSERT_EQ(clock.Get_Dropped_Time(), 66u * (20 - TickClock::MAX_CATCHUP_TICKS));
+    TEST_ASSERT_EQ(clock.Advance(1066 + 66 * 20, 66), 0);
+}
+
+TEST_CASE(GameLoop_SimPipeline_Handoff, "GameLoop") {
+    uint32_t sim_tick = 0;
+    SimPipeline pipeline;
+    pipeline.Start([&sim_tick]() { return ++sim_tick; });
+    TEST_ASSERT(pipeline.Is_Running());
+    TEST_ASSERT(!pipeline.Wait());      // Nothing published yet
+
+    pipeline.Kick(3);
+    TEST_ASSERT(pipeline.Wait());
+    TEST_ASSERT_EQ(sim_tick, 3u);
+    TEST_ASSERT_EQ(pipeline.Front().Get_Tick(), 3u);
+
+    // Stopping finishes the ticks already kicked
+    pipeline.Kick(2);
+    pipeline.Stop();
+    TEST_ASSERT_EQ(sim_tick, 5u);
+    TEST_ASSERT(!pipeline.Is_Running());
+}
@@ -4,8 +4,12 @@
 
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
+#include "game/frame_capture.h"
 #include "platform.h"
+#include <cstdio>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 //=============================================================================
 // Helper to check for game data
@@ -17,13 +21,6 @@ static bool HasGameData() {
            Platform_File_Exists("data/REDALERT.MIX");
 }
 
-static bool RegisterGameMix() {
-    if (Platform_Mix_Register("REDALERT.MIX") == 0) return true;
-    if (Platform_Mix_Register("gamedata/REDALERT.MIX") == 0) return true;
-    if (Platform_Mix_Register("data/REDALERT.MIX") == 0) return true;
-    return false;
-}
-
 //=============================================================================
 // Basic Render Tests
 //=============================================================================
@@ -71,9 +68,10 @@ TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_DrawPattern, "Render") {
 // Palette Integration Tests
 //=============================================================================
 
-TEST_CASE(RenderPipeline_Palette_Apply, "Render") {
-    Platform_Init();
-    Platform_Graphics_Init();
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_Palette_Apply, "Render") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
 
     // Create a grayscale palette
     PaletteEntry entries[256];
@@ -84,24 +82,17 @@ TEST_CASE(RenderPipeline_Palette_Apply, "Render") {
     }
 
     Platform_Graphics_SetPalette(entries, 0, 256);
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
-TEST_CASE(RenderPipeline_Palette_LoadAndApply, "Render") {
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_Palette_LoadAndApply, "Render") {
     if (!HasGameData()) {
         TEST_SKIP("Game data not found");
     }
 
-    Platform_Init();
-    Platform_Graphics_Init();
-    Platform_Assets_Init();
-
-    bool has_data = RegisterGameMix();
-    if (!has_data) {
-        Platform_Graphics_Shutdown();
-        Platform_Shutdown();
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
+    if (!TestEnvironment::Instance().RequireMix("REDALERT.MIX")) {
         TEST_SKIP("Game data not found");
     }
 
@@ -121,28 +112,21 @@ TEST_CASE(RenderPipeline_Palette_LoadAndApply, "Render") {
         // Render a frame with the palette
         Platform_Graphics_Flip();
     }
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
 //=============================================================================
 // Shape Rendering Tests
 //=============================================================================
 
-TEST_CASE(RenderPipeline_Shape_DrawToBuffer, "Render") {
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_Shape_DrawToBuffer, "Render") {
     if (!HasGameData()) {
         TEST_SKIP("Game data not found");
     }
 
-    Platform_Init();
-    Platform_Graphics_Init();
-    Platform_Assets_Init();
-
-    bool has_data = RegisterGameMix();
-    if (!has_data) {
-        Platform_Graphics_Shutdown();
-        Platform_Shutdown();
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
+    if (!TestEnvironment::Instance().RequireMix("REDALERT.MIX")) {
         TEST_SKIP("Game data not found");
     }
 
@@ -195,18 +179,16 @@ TEST_CASE(RenderPipeline_Shape_DrawToBuffer, "Render") {
         delete[] frame_data;
         Platform_Shape_Free(shape);
     }
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
 //=============================================================================
 // Multi-Frame Render Tests
 //=============================================================================
 
-TEST_CASE(RenderPipeline_Animation_MultipleFrames, "Render") {
-    Platform_Init();
-    Platform_Graphics_Init();
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_Animation_MultipleFrames, "Render") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
 
     // Render 30 frames (0.5 second at 60fps)
     for (int frame = 0; frame < 30; frame++) {
@@ -223,24 +205,17 @@ TEST_CASE(RenderPipeline_Animation_MultipleFrames, "Render") {
         Platform_Graphics_Flip();
         Platform_Timer_Delay(16);
     }
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
-TEST_CASE(RenderPipeline_Shape_AllFrames, "Render") {
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_Shape_AllFrames, "Render") {
     if (!HasGameData()) {
         TEST_SKIP("Game data not found");
     }
 
-    Platform_Init();
-    Platform_Graphics_Init();
-    Platform_Assets_Init();
-
-    bool has_data = RegisterGameMix();
-    if (!has_data) {
-        Platform_Graphics_Shutdown();
-        Platform_Shutdown();
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
+    if (!TestEnvironment::Instance().RequireMix("REDALERT.MIX")) {
         TEST_SKIP("Game data not found");
     }
 
@@ -284,18 +259,16 @@ TEST_CASE(RenderPipeline_Shape_AllFrames, "Render") {
         delete[] frame_data;
         Platform_Shape_Free(shape);
     }
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
 //=============================================================================
 // Buffer Operations Tests
 //=============================================================================
 
-TEST_CASE(RenderPipeline_BufferFill, "Render") {
-    Platform_Init();
-    Platform_Graphics_Init();
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_BufferFill, "Render") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
 
     uint8_t* buffer;
     int32_t w, h, p;
@@ -309,14 +282,12 @@ TEST_CASE(RenderPipeline_BufferFill, "Render") {
     TEST_ASSERT_EQ(buffer[150 * p + 200], 42);
 
     Platform_Graphics_Flip();
-
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
 }
 
-TEST_CASE(RenderPipeline_BufferLines, "Render") {
-    Platform_Init();
-    Platform_Graphics_Init();
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_BufferLines, "Render") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
 
     uint8_t* buffer;
     int32_t w, h, p;
@@ -336,18 +307,47 @@ TEST_CASE(RenderPipeline_BufferLines, "Render") {
     TEST_ASSERT_EQ(buffer[50 * p + 150], 128);  // V-line start
 
     Platform_Graphics_Flip();
+}
 
-    Platform_Graphics_Shutdown();
-    Platform_Shutdown();
+TEST_CASE(RenderPipeline_SpriteBlit_Budget, "Render") {
+    // An infantry-sized sprite, opaque but for a transparent border
+    const int sw = 24, sh = 24, w = 640, h = 400;
+    std::vector<uint8_t> sprite(sw * sh, 0);
+    for (int y = 2; y < sh - 2; y++) {
+        for (int x = 2; x < sw - 2; x++) {
+            sprite[y * sw + x] = static_cast<uint8_t>(16 + x);
+        }
+    }
+    std::vector<uint8_t> screen(w * h, 0);
+
+    Platform_Buffer_ToBufferTrans(screen.data(), w, w, h, sprite.data(), sw, sw, sh,
+                                  100, 100, 0, 0, sw, sh);
+    TEST_ASSERT_EQ(screen[100 * w + 100], 0);                   // Border stays transparent
+    TEST_ASSERT_EQ(screen[110 * w + 110], 16 + 10);
+
+    // A busy battlefield frame's worth of sprites and fills
+    TEST_PERF_BUDGET("TransBlit/10k", 25.0, [&]() {
+        for (int i = 0; i < 10000; i++) {
+            Platform_Buffer_ToBufferTrans(screen.data(), w, w, h, sprite.data(), sw, sw, sh,
+                                          (i * 37) % (w - sw), (i * 17) % (h - sh), 0, 0, sw, sh);
+        }
+    });
+    TEST_PERF_BUDGET("FillRect/10k", 10.0, [&]() {
+        for (int i = 0; i < 10000; i++) {
+            Platform_Buffer_FillRect(screen.data(), w, w, h,
+                                     (i * 37) % (w - sw), (i * 17) % (h - sh), sw, sh, 42);
+        }
+    });
 }
 
 //=============================================================================
 // Palette Fade Tests
 //=============================================================================
 
-TEST_CASE(RenderPipeline_PaletteFade, "Render") {
-    Platform_Init();
-    Platform_Graphics_Init();
+TEST_WITH_FIXTURE(GraphicsFixture, RenderPipeline_PaletteFade, "Render") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
 
     // Set up a palette
     PaletteEntry entries[256];
@@ -378,7 +378,128 @@ TEST_CASE(RenderPipeline_PaletteFade, "Render") {
     // Restore
     Platform_Graphics_RestorePalette();
     Platform_Graphics_Flip();
+}
+
+//=============================================================================
+// Headless Render Tests
+//=============================================================================
+
+TEST_CASE(RenderPipeline_Headless_Flip, "Render") {
+    Platform_Init();
+    Platform_Graphics_SetHeadless(true, "headless_frames");
+    int32_t init = Platform_Graphics_Init();
+    Platform_Graphics_SetHeadless(false, nullptr);
+    if (init != 0) {
+        Platform_Shutdown();
+        TEST_FAIL("Headless graphics failed to initialize");
+    }
+    bool headless = Platform_Graphics_IsHeadless();
+
+    // Draw and fade as on screen; the flips only convert
+    PaletteEntry entries[256];
+    for (int i = 0; i < 256; i++) {
+        entries[i].r = static_cast<uint8_t>(i);
+        entries[i].g = static_cast<uint8_t>(255 - i);
+        entries[i].b = 0;
+    }
+    Platform_Graphics_SetPalette(entries, 0, 256);
+
+    uint8_t* buffer;
+    int32_t w, h, p;
+    Platform_Graphics_GetBackBuffer(&buffer, &w, &h, &p);
+    for (int y = 0; y < h; y++) {
+        memset(buffer + y * p, y & 0xFF, w);
+    }
+    int32_t flipped = Platform_Graphics_Flip();
+    Platform_Graphics_FadePalette(0.5f);
+    ClipRect rect = {0, 0, 32, 32};
+    int32_t flipped_rects = Platform_Graphics_FlipRects(&rect, 1);
+
+    FlipTiming timing = {};
+    Platform_Graphics_GetFlipTiming(&timing);
+    bool dumped = Platform_File_Exists("headless_frames/frame_000001.png") &&
+                  Platform_File_Exists("headless_frames/frame_000002.png");
+    Platform_File_Delete("headless_frames/frame_000001.png");
+    Platform_File_Delete("headless_frames/frame_000002.png");
+    Platform_DeleteDirectory("headless_frames");
 
     Platform_Graphics_Shutdown();
     Platform_Shutdown();
+
+    TEST_ASSERT(headless);
+    TEST_ASSERT_EQ(flipped, 0);
+    TEST_ASSERT_EQ(flipped_rects, 0);
+    TEST_ASSERT_EQ(timing.flip_count, 2u);
+    TEST_ASSERT_EQ(timing.upload_us, 0u);
+    TEST_ASSERT_EQ(timing.present_us, 0u);
+    TEST_ASSERT(dumped);
+}
+
+//=============================================================================
+// Frame Capture Tests
+//=============================================================================
+
+/// Removes the capture file however the test ends
+class CaptureFileFixture : public TestFixture {
+public:
+    void TearDown() override { remove(path); }
+
+    const char* path = "./TEST.CAP";
+};
+
+TEST_WITH_FIXTURE(CaptureFileFixture, RenderPipeline_FrameCapture_RoundTrip, "Render") {
+    const int width = 64, height = 40, pitch = 80;
+    std::vector<uint8_t> screen(pitch * height, 0);
+    PaletteEntry palette[256] = {};
+    std::vector<std::vector<uint8_t>> frames;
+
+    FrameCapture capture;
+    TEST_ASSERT(!capture.Is_Recording());
+    TEST_ASSERT(!capture.Capture(screen.data(), pitch, palette, 0));     // Not before Start
+    TEST_ASSERT(capture.Start(fixture.path, width, height));
+    TEST_ASSERT(capture.Is_Recording());
+    TEST_ASSERT(!capture.Start(fixture.path, width, height));            // Nor twice
+
+    // A moving box, with the palette changing halfway
+    for (int f = 0; f < 20; f++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                bool box = x >= f * 2 && x < f * 2 + 8 && y >= 10 && y < 20;
+                screen[y * pitch + x] = box ? 15 : static_cast<uint8_t>((x + y) & 7);
+            }
+        }
+        if (f == 10) {
+            palette[15] = {63, 0, 0};
+        }
+        while (!capture.Capture(screen.data(), pitch, palette, f * 66)) {
+            std::this_thread::yield();      // Ring full; let the encoder catch up
+        }
+        std::vector<uint8_t> frame(width * height);
+        for (int y = 0; y < height; y++) {
+            memcpy(&frame[y * width], &screen[y * pitch], width);
+        }
+        frames.push_back(frame);
+    }
+    capture.Stop();
+    FrameCapture::Stats stats = capture.Get_Stats();
+    TEST_ASSERT(!capture.Is_Recording());
+    TEST_ASSERT_EQ(stats.captured, 20u);
+    TEST_ASSERT_EQ(stats.written, 20u);
+    TEST_ASSERT_LT(stats.bytes_written, 20u * width * height);
+
+    // Frames and palette changes decode exactly
+    FrameCaptureReader reader;
+    TEST_ASSERT(reader.Open(fixture.path));
+    TEST_ASSERT_EQ(reader.Get_Width(), width);
+    TEST_ASSERT_EQ(reader.Get_Height(), height);
+    int read = 0;
+    while (reader.Next()) {
+        TEST_ASSERT_LT(read, 20);
+        TEST_ASSERT_EQ(memcmp(reader.Get_Pixels(), frames[read].data(), width * height), 0);
+        TEST_ASSERT_EQ(reader.Get_Time(), static_cast<uint32_t>(read * 66));
+        TEST_ASSERT_EQ(reader.Get_Palette()[15].r, (read >= 10 ? 63 : 0));
+        read++;
+    }
+    TEST_ASSERT_EQ(read, 20);
+    reader.Close();
 }
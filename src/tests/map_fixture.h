@@ -0,0 +1,76 @@
+// src/tests/map_fixture.h
+// Shared map fixture and object helpers for game simulation tests
+
+#ifndef MAP_FIXTURE_H
+#define MAP_FIXTURE_H
+
+#include "test/test_fixtures.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include "game/object_heap.h"
+#include "game/techno.h"
+#include "game/movement.h"
+#include "game/projectile.h"
+#include "game/findpath.h"
+#include "game/flow_field.h"
+#include "game/job_system.h"
+
+//=============================================================================
+// ObjectFixture - Game objects with no map
+//=============================================================================
+
+class ObjectFixture : public TestFixture {
+public:
+    /// Leaves no objects, moves, effects or cached routes for the next test,
+    /// whether or not this one got to the end
+    void TearDown() override {
+        JobSystem::Instance().Stop();
+        Destroy_All_Objects();
+        MovementSystem::Instance().Clear();
+        ProjectileSystem::Instance().Clear();
+        PathFinder::Instance().Invalidate();
+        FlowField::Flush_Cache();
+    }
+};
+
+//=============================================================================
+// MapFixture - Game objects on an allocated map installed as the global Map
+//=============================================================================
+
+class MapFixture : public ObjectFixture {
+public:
+    void SetUp() override {
+        map.Alloc_Cells();
+        Map = &map;
+    }
+
+    void TearDown() override {
+        ObjectFixture::TearDown();
+        Map = nullptr;
+    }
+
+    MapClass map;
+};
+
+//=============================================================================
+// Object Helpers
+//=============================================================================
+
+/// A unit standing in the middle of cell (x, y)
+inline FootClass* Place_Unit(int x, int y, HousesType owner = HOUSE_NONE) {
+    FootClass* unit = static_cast<FootClass*>(Create_Object(RTTI_UNIT));
+    if (owner != HOUSE_NONE) {
+        unit->Set_Owner(owner);
+    }
+    unit->Set_Coord(Cell_Coord(XY_Cell(x, y)));
+    return unit;
+}
+
+/// Brick wall down column x, rows first..last-1
+inline void Build_Wall(MapClass& map, int x, int first, int last) {
+    for (int y = first; y < last; y++) {
+        map[XY_Cell(x, y)].Set_Overlay(OVERLAY_BRICK, 0);
+    }
+}
+
+#endif // MAP_FIXTURE_H
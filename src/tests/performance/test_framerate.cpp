@@ -5,7 +5,9 @@
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
 #include "perf_utils.h"
+#include "platform/sampling_profiler.h"
 #include <cstring>
+#include <sstream>
 
 //=============================================================================
 // Frame Rate Tests
@@ -45,6 +47,7 @@ TEST_WITH_FIXTURE(GraphicsFixture, Perf_FrameRate_Baseline, "Performance") {
     snprintf(msg, sizeof(msg), "Baseline FPS: avg=%.1f, min=%.1f, max=%.1f",
              avg_fps, min_fps, tracker.GetMaxFPS());
     Platform_Log(LOG_LEVEL_INFO, msg);
+    TEST_METRIC_HIGHER("AverageFPS", avg_fps, "fps");
 
     // Baseline should be very fast
     TEST_ASSERT_GT(avg_fps, 60.0f);
@@ -251,3 +254,56 @@ TEST_WITH_FIXTURE(GraphicsFixture, Perf_FrameRate_30fps, "Performance") {
     TEST_ASSERT_GT(actual_fps, 28.0f);
     TEST_ASSERT_LT(actual_fps, 32.0f);
 }
+
+TEST_WITH_FIXTURE(GraphicsFixture, Perf_FrameRate_Sampled, "Performance") {
+    if (!fixture.IsInitialized()) {
+        TEST_SKIP("Graphics not initialized");
+    }
+    if (!SamplingProfiler::is_supported()) {
+        TEST_SKIP("Sampling profiler not supported on this platform");
+    }
+
+    // The frames of Perf_FrameRate_FilledScreen with the sampler running
+    // at its default rate
+    const int FRAMES = 100;
+    SamplingProfiler& profiler = SamplingProfiler::instance();
+    profiler.clear();
+    TEST_ASSERT(profiler.start());
+
+    FrameRateTracker tracker;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        uint32_t frame_start = Platform_Timer_GetTicks();
+
+        uint8_t* buffer = fixture.GetBackBuffer();
+        int pitch = fixture.GetPitch();
+        int width = fixture.GetWidth();
+        int height = fixture.GetHeight();
+
+        for (int y = 0; y < height; y++) {
+            memset(buffer + y * pitch, static_cast<uint8_t>((frame + y) & 0xFF), width);
+        }
+
+        fixture.RenderFrame();
+        tracker.RecordFrame(Platform_Timer_GetTicks() - frame_start);
+    }
+    profiler.stop();
+
+    uint64_t samples = profiler.get_sample_count();
+    TEST_METRIC("Avg Frame", static_cast<double>(tracker.GetAverageFrameTimeMs()), "ms");
+    TEST_METRIC("Samples", static_cast<double>(samples), "");
+    TEST_METRIC("Dropped", static_cast<double>(profiler.get_dropped_count()), "");
+    Platform_Log(LOG_LEVEL_INFO, profiler.format_top(10).c_str());
+    TEST_ASSERT_GT(samples, 0ull);
+
+    // Every folded line is "frame;frame;... count", and the counts add up
+    std::istringstream folded(profiler.format_folded());
+    std::string line;
+    uint64_t folded_samples = 0;
+    while (std::getline(folded, line)) {
+        size_t space = line.rfind(' ');
+        TEST_ASSERT(space != std::string::npos && space > 0);
+        folded_samples += strtoull(line.c_str() + space + 1, nullptr, 10);
+    }
+    TEST_ASSERT_EQ(folded_samples, samples);
+    profiler.clear();
+}
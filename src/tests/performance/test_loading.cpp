@@ -5,8 +5,16 @@
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
 #include "perf_utils.h"
+#include "game/audio/aud_file.h"
+#include "game/game.h"
 #include "platform.h"
+#include "platform/startup_trace.h"
+#include "platform/io_stats.h"
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <string>
+#include <vector>
 
 //=============================================================================
 // Helper Functions
@@ -276,6 +284,65 @@ TEST_CASE(Perf_Loading_DecompressLCW, "Performance") {
     TEST_ASSERT_LT(timer.ElapsedMs(), 200u);
 }
 
+TEST_CASE(Perf_Audio_DecodeADPCM, "Performance") {
+    // Decode throughput of the AUD ADPCM decoders (SFX loading, music streaming)
+    const uint32_t DATA_SIZE = 1024 * 1024;
+    const int ITERATIONS = 4;
+
+    struct Format {
+        const char* name;
+        uint8_t compression;
+        uint8_t flags;
+    };
+    const Format formats[] = {
+        { "IMA", AUD_COMPRESS_IMA, AUD_FLAG_16BIT },
+        { "WW mono", AUD_COMPRESS_WW, AUD_FLAG_16BIT },
+        { "WW stereo", AUD_COMPRESS_WW, AUD_FLAG_16BIT | AUD_FLAG_STEREO },
+    };
+
+    for (const Format& format : formats) {
+        AudHeader header;
+        header.sample_rate = 22050;
+        header.uncompressed_size = DATA_SIZE * 4;
+        header.compressed_size = DATA_SIZE;
+        header.flags = format.flags;
+        header.compression = format.compression;
+
+        std::vector<uint8_t> data(sizeof(AudHeader) + DATA_SIZE);
+        memcpy(data.data(), &header, sizeof(AudHeader));
+        uint32_t seed = 12345;
+        for (uint32_t i = 0; i < DATA_SIZE; i++) {
+            seed = seed * 1103515245 + 12345;
+            data[sizeof(AudHeader) + i] = static_cast<uint8_t>(seed >> 16);
+        }
+
+        AudDecoder decoder;
+        TEST_ASSERT(decoder.Open(data.data(), static_cast<uint32_t>(data.size())));
+        std::vector<int16_t> pcm(decoder.GetTotalSamples());
+
+        PerfTimer timer;
+        timer.Start();
+
+        for (int iter = 0; iter < ITERATIONS; iter++) {
+            decoder.Rewind();
+            TEST_ASSERT_EQ(decoder.Decode(pcm.data(), pcm.size()), pcm.size());
+        }
+
+        timer.Stop();
+
+        uint32_t elapsed = std::max(timer.ElapsedMs(), 1u);
+        double megabytes = static_cast<double>(pcm.size() * sizeof(int16_t)) * ITERATIONS / (1024.0 * 1024.0);
+
+        char msg[128];
+        snprintf(msg, sizeof(msg),
+                 "ADPCM decode (%s): %.1f MB/s of PCM",
+                 format.name, megabytes * 1000.0 / elapsed);
+        Platform_Log(LOG_LEVEL_INFO, msg);
+
+        TEST_ASSERT_LT(timer.ElapsedMs(), 1000u);
+    }
+}
+
 //=============================================================================
 // Initialization Tests
 //=============================================================================
@@ -305,3 +372,57 @@ TEST_WITH_FIXTURE(GraphicsFixture, Perf_Loading_GraphicsInit, "Performance") {
     TEST_ASSERT_GT(width, 0);
     TEST_ASSERT_GT(height, 0);
 }
+
+//=============================================================================
+// Cold Start
+//=============================================================================
+
+// Launch to main menu budget; STARTUP_BUDGET_MS overrides it for slow
+// machines. PerfCompare catches smaller regressions against the baseline.
+static const double DEFAULT_STARTUP_BUDGET_MS = 3000.0;
+
+TEST_CASE(Perf_Loading_ColdStart, "Performance") {
+    // The first start in this process; caches are as cold as they get
+    // without dropping the OS file cache
+    StartupTrace& startup = StartupTrace::instance();
+    startup.start();
+    IoStats::instance().reset();
+
+    GameClass game;
+    bool started = game.Initialize();
+    startup.finish();
+    PlatformIoStats io = IoStats::instance().get_totals();
+    if (!started) {
+        TEST_SKIP("Game could not start");
+    }
+    game.Shutdown();
+
+    const char* env = getenv("STARTUP_BUDGET_MS");
+    double budget_ms = env ? atof(env) : 0.0;
+    if (budget_ms <= 0.0) {
+        budget_ms = DEFAULT_STARTUP_BUDGET_MS;
+    }
+
+    std::string report = startup.format_report() + "\n" + IoStats::instance().format_report();
+    size_t begin = 0;
+    while (begin < report.size()) {
+        size_t end = report.find('\n', begin);
+        if (end == std::string::npos) end = report.size();
+        Platform_Log(LOG_LEVEL_INFO, report.substr(begin, end - begin).c_str());
+        begin = end + 1;
+    }
+
+    double total_ms = startup.get_total_wall_ns() / 1000000.0;
+    TEST_METRIC("Total", total_ms, "ms");
+    TEST_METRIC("CPU", startup.get_total_cpu_ns() / 1000000.0, "ms");
+    TEST_METRIC("Read", io.bytes / 1024.0, "KB");
+    TEST_METRIC("Read Again", io.repeat_bytes / 1024.0, "KB");
+    for (const StartupTrace::Phase& phase : startup.get_phases()) {
+        if (phase.depth == 0) {
+            TEST_METRIC(phase.name, phase.wall_ns / 1000000.0, "ms");
+        }
+    }
+
+    TEST_ASSERT(!startup.get_phases().empty());
+    TEST_ASSERT_LT(total_ms, budget_ms);
+}
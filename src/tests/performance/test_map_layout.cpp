@@ -0,0 +1,280 @@
+// src/tests/performance/test_map_layout.cpp
+// Cell Storage Layout Benchmarks
+// Compares row-major and tiled MapClass cell layouts
+
+#include "test/test_framework.h"
+#include "perf_utils.h"
+#include "game/map.h"
+#include "game/cell.h"
+#include "game/graphics/shroud_edges.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+double Elapsed_Us(std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// Scatter some impassable terrain so searches have to route around it
+void Setup_Map(MapClass& map) {
+    map.Alloc_Cells();
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            if ((x * 7 + y * 13) % 11 == 0) {
+                map.Cell_At(x, y)->Set_Overlay(OVERLAY_SANDBAG);
+            }
+        }
+    }
+}
+
+// Sight-range reveals over a grid of unit positions
+double Bench_Reveal(MapClass& map, int passes) {
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int y = 4; y < MAP_CELL_HEIGHT; y += 9) {
+            for (int x = 4; x < MAP_CELL_WIDTH; x += 9) {
+                map.Reveal_Area(XY_Cell(x, y), 6, (pass & 1) == 0);
+            }
+        }
+    }
+    return Elapsed_Us(start);
+}
+
+// Breadth-first path search across the map, the access pattern of a path flood
+int Path_Search(MapClass& map, CELL from, CELL to, std::vector<int16_t>& dist) {
+    dist.assign(MAP_CELL_TOTAL, -1);
+    std::vector<CELL> queue;
+    queue.reserve(MAP_CELL_TOTAL);
+
+    dist[Cell_Y(from) * MAP_CELL_WIDTH + Cell_X(from)] = 0;
+    queue.push_back(from);
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        CELL cell = queue[head];
+        int d = dist[Cell_Y(cell) * MAP_CELL_WIDTH + Cell_X(cell)];
+        if (cell == to) {
+            return d;
+        }
+        for (int dir = 0; dir < FACING_COUNT; dir++) {
+            CELL next = Adjacent_Cell(cell, dir);
+            if (next == CELL_NONE) continue;
+            int index = Cell_Y(next) * MAP_CELL_WIDTH + Cell_X(next);
+            if (dist[index] >= 0) continue;
+            if (!map[next].Is_Passable()) continue;
+            dist[index] = (int16_t)(d + 1);
+            queue.push_back(next);
+        }
+    }
+    return -1;
+}
+
+double Bench_Path(MapClass& map, int searches, int& checksum) {
+    std::vector<int16_t> dist;
+    checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < searches; i++) {
+        CELL from = XY_Cell(1 + (i * 17) % 20, 1 + (i * 29) % 20);
+        CELL to = XY_Cell(126 - (i * 23) % 20, 126 - (i * 31) % 20);
+        checksum += Path_Search(map, from, to, dist);
+    }
+    return Elapsed_Us(start);
+}
+
+} // namespace
+
+//=============================================================================
+// Layout Tests
+//=============================================================================
+
+TEST_CASE(Perf_MapLayout_Equivalent, "Performance") {
+    MapClass linear;
+    MapClass tiled;
+    Setup_Map(linear);
+    tiled.Set_Cell_Layout(CELL_LAYOUT_TILED);
+    Setup_Map(tiled);
+
+    // Same cell reachable by X,Y and by CELL in both layouts
+    for (int y = 0; y < MAP_CELL_HEIGHT; y += 7) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x += 5) {
+            CELL cell = XY_Cell(x, y);
+            TEST_ASSERT_EQ(tiled[cell].Get_Cell_Index(), cell);
+            TEST_ASSERT_EQ(tiled.Cell_At(x, y)->Is_Wall(), linear.Cell_At(x, y)->Is_Wall());
+        }
+    }
+
+    // Switching layout preserves contents
+    linear.Set_Cell_Layout(CELL_LAYOUT_TILED);
+    TEST_ASSERT_EQ(linear.Cell_At(77, 33)->Get_Cell_Index(), XY_Cell(77, 33));
+    TEST_ASSERT_EQ(linear.Cell_At(77, 33)->Is_Wall(), tiled.Cell_At(77, 33)->Is_Wall());
+}
+
+TEST_CASE(Perf_MapLayout_RevealAndPath, "Performance") {
+    const int REVEAL_PASSES = 50;
+    const int PATH_SEARCHES = 20;
+
+    MapClass linear;
+    MapClass tiled;
+    Setup_Map(linear);
+    tiled.Set_Cell_Layout(CELL_LAYOUT_TILED);
+    Setup_Map(tiled);
+
+    double linear_reveal = Bench_Reveal(linear, REVEAL_PASSES);
+    double tiled_reveal = Bench_Reveal(tiled, REVEAL_PASSES);
+
+    int linear_sum = 0;
+    int tiled_sum = 0;
+    double linear_path = Bench_Path(linear, PATH_SEARCHES, linear_sum);
+    double tiled_path = Bench_Path(tiled, PATH_SEARCHES, tiled_sum);
+
+    char msg[256];
+    snprintf(msg, sizeof(msg),
+             "Map layout: reveal linear %.0f us / tiled %.0f us, "
+             "path linear %.0f us / tiled %.0f us",
+             linear_reveal, tiled_reveal, linear_path, tiled_path);
+    Platform_Log(LOG_LEVEL_INFO, msg);
+
+    // Both layouts must find the same paths
+    TEST_ASSERT_EQ(linear_sum, tiled_sum);
+    TEST_ASSERT_GT(linear_sum, 0);
+
+    // Sanity bound, not a speed race
+    TEST_ASSERT_LT(tiled_reveal + tiled_path, 5000000.0);
+}
+
+//=============================================================================
+// Packed Layer Tests
+//=============================================================================
+
+TEST_CASE(Perf_MapLayers_LandScan, "Performance") {
+    const int SCANS = 200;
+
+    MapClass map;
+    MapClass* old_map = Map;
+    Map = &map;   // Setters keep the global map's layers in sync
+    Setup_Map(map);
+
+    const CellLayers* layers = map.Get_Cell_Layers();
+    TEST_ASSERT(layers != nullptr);
+
+    // Setters update the packed copies
+    map.Cell_At(40, 50)->Set_Template(12, 3);
+    map.Cell_At(40, 50)->Reveal(true);
+    TEST_ASSERT_EQ(layers->template_type[MapClass::Layer_Index(40, 50)], 12);
+    TEST_ASSERT_EQ(layers->icon[MapClass::Layer_Index(40, 50)], 3);
+    TEST_ASSERT_EQ(layers->visibility[MapClass::Layer_Index(40, 50)], (uint8_t)CELL_VISIBLE);
+
+    int cell_count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int scan = 0; scan < SCANS; scan++) {
+        for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+            for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+                cell_count += map.Cell_At(x, y)->Is_Passable() ? 1 : 0;
+            }
+        }
+    }
+    double cell_us = Elapsed_Us(start);
+
+    int layer_count = 0;
+    start = std::chrono::steady_clock::now();
+    for (int scan = 0; scan < SCANS; scan++) {
+        for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+            for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+                layer_count += map.Is_Cell_Passable(x, y) ? 1 : 0;
+            }
+        }
+    }
+    double layer_us = Elapsed_Us(start);
+
+    Map = old_map;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "Land scan x%d: CellClass %.0f us / packed layer %.0f us (%u bytes)",
+             SCANS, cell_us, layer_us, (unsigned)sizeof(layers->land));
+    Platform_Log(LOG_LEVEL_INFO, msg);
+
+    TEST_ASSERT_EQ(cell_count, layer_count);
+}
+
+TEST_CASE(Perf_MapLayers_ShroudEdges, "Performance") {
+    MapClass map;
+    MapClass* old_map = Map;
+    Map = &map;
+    map.Alloc_Cells();
+    map.Clear_Changed_Cells();
+
+    const CellLayers* layers = map.Get_Cell_Layers();
+    TEST_ASSERT(layers != nullptr);
+    TEST_ASSERT_EQ(map.Get_Shroud_Edge(60, 60), 0xFF);
+
+    // Visible core, fogged ring, then incremental masks vs. a full rebuild
+    auto start = std::chrono::steady_clock::now();
+    map.Reveal_Area(XY_Cell(60, 60), 10, false);
+    map.Reveal_Area(XY_Cell(60, 60), 6, true);
+    double reveal_us = Elapsed_Us(start);
+
+    uint8_t shroud[MAP_CELL_TOTAL];
+    uint8_t fog[MAP_CELL_TOTAL];
+    memcpy(shroud, layers->shroud_edge, sizeof(shroud));
+    memcpy(fog, layers->fog_edge, sizeof(fog));
+
+    // Inside the visible core nothing is covered; only the rims have edges
+    TEST_ASSERT_EQ(map.Get_Shroud_Edge(60, 60), 0);
+    TEST_ASSERT_EQ(map.Get_Fog_Edge(60, 60), 0);
+    TEST_ASSERT(map.Get_Fog_Edge(66, 60) != 0);
+    TEST_ASSERT(map.Get_Shroud_Edge(70, 60) != 0);
+    TEST_ASSERT_EQ(map.Get_Shroud_Edge(70, 60) & (1 << FACING_W), 0);
+    TEST_ASSERT(map.Get_Shroud_Edge(70, 60) & (1 << FACING_E));
+
+    // Shrouded cells outside the reveal were not flagged for redraw
+    TEST_ASSERT(!map.Is_Cell_Changed(90, 90));
+    TEST_ASSERT(map.Is_Cell_Changed(60, 60));
+
+    start = std::chrono::steady_clock::now();
+    map.Sync_All_Layers();
+    double rebuild_us = Elapsed_Us(start);
+
+    TEST_ASSERT(memcmp(shroud, layers->shroud_edge, sizeof(shroud)) == 0);
+    TEST_ASSERT(memcmp(fog, layers->fog_edge, sizeof(fog)) == 0);
+
+    Map = old_map;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "Shroud edges: incremental reveal %.0f us / full rebuild %.0f us",
+             reveal_us, rebuild_us);
+    Platform_Log(LOG_LEVEL_INFO, msg);
+}
+
+TEST_CASE(Perf_ShroudEdge_Frames, "Performance") {
+    // 256 masks collapse to the 47 distinct side/corner shapes
+    bool used[SHROUD_EDGE_FRAMES] = {};
+    for (int mask = 0; mask < 256; mask++) {
+        int frame = Shroud_Edge_Frame(static_cast<uint8_t>(mask));
+        TEST_ASSERT(frame >= 0 && frame < SHROUD_EDGE_FRAMES);
+        used[frame] = true;
+    }
+    for (int frame = 0; frame < SHROUD_EDGE_FRAMES; frame++) {
+        TEST_ASSERT(used[frame]);
+    }
+
+    TEST_ASSERT_EQ(Shroud_Edge_Frame(0), 0);
+    TEST_ASSERT_EQ(Shroud_Edge_Frame(1 << FACING_N),
+                   Shroud_Edge_Frame((1 << FACING_N) | (1 << FACING_NE)));
+    TEST_ASSERT(Shroud_Edge_Frame(1 << FACING_NE) != 0);
+
+    // North edge: top row black, bottom row untouched
+    const uint8_t* north = Shroud_Edge_Shape(Shroud_Edge_Frame(1 << FACING_N));
+    TEST_ASSERT(north != nullptr);
+    TEST_ASSERT_EQ(north[0], 0x00);
+    TEST_ASSERT_EQ(north[23 * 24 + 12], 0xFF);
+    TEST_ASSERT(Shroud_Edge_Shape(SHROUD_EDGE_FRAMES) == nullptr);
+}
@@ -0,0 +1,294 @@
+// src/tests/performance/test_network.cpp
+// Lockstep Network Benchmarks
+// Two headless lockstep peers play a replay's commands over simulated links
+
+#include "test/test_framework.h"
+#include "perf_utils.h"
+#include "game/replay.h"
+#include "platform.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+const uint64_t TICK_US = 1000000 / 15;
+const int MAX_PACKET = 2048;
+
+// Played when NETBENCH.RPL is missing: a minute of play with bursts of
+// orders, the way a skirmish opens with build queues and unit moves
+void Build_Replay(Replay& replay) {
+    replay.Clear();
+    replay.seed = 12345;
+    replay.tick_count = 900;
+    for (uint32_t tick = 0; tick < replay.tick_count; tick++) {
+        int burst = static_cast<int>((tick * 7919u) % 11u);
+        int count = burst < 3 ? burst + 1 : 0;
+        for (int i = 0; i < count; i++) {
+            ReplayCommand cmd;
+            memset(&cmd, 0, sizeof(cmd));
+            cmd.tick = tick;
+            cmd.type = static_cast<int32_t>((tick + i) % 6);
+            cmd.cell_x = static_cast<int32_t>((tick * 13 + i) % 128);
+            cmd.cell_y = static_cast<int32_t>((tick * 29 + i) % 128);
+            cmd.world_x = cmd.cell_x * 24;
+            cmd.world_y = cmd.cell_y * 24;
+            cmd.first_id = static_cast<uint32_t>(replay.ids.size());
+            cmd.id_count = 1;
+            replay.ids.push_back(tick);
+            replay.commands.push_back(cmd);
+        }
+    }
+}
+
+// One side of a two-player lockstep match. Each tick it sends the
+// commands it issued, stamped for tick + delay, and it can't run a tick
+// until the other side's commands for that tick are in.
+class LockstepPeer {
+public:
+    LockstepPeer(int id, const Replay& replay, uint32_t delay)
+        : id_(id), replay_(replay), delay_(delay),
+          remote_(replay.tick_count + delay, 0), remote_data_(replay.tick_count + delay),
+          local_(replay.tick_count + delay), next_tick_us_(TICK_US) {}
+
+    bool Running() const { return tick_ < replay_.tick_count; }
+    uint32_t Get_Tick() const { return tick_; }
+    uint64_t Get_Next_Tick_Us() const { return next_tick_us_; }
+    uint64_t Get_Stall_Us() const { return stall_us_; }
+    uint64_t Get_Bytes_Sent() const { return bytes_sent_; }
+    uint32_t Get_Checksum() const { return checksum_; }
+    uint32_t Get_Commands_Run() const { return commands_run_; }
+
+    // A command packet from the other side
+    void Accept(const uint8_t* data, int size) {
+        uint32_t tick;
+        if (size < 4) return;
+        memcpy(&tick, data, 4);
+        if (tick < remote_.size()) {
+            remote_[tick] = 1;
+            remote_data_[tick].assign(data + 4, data + size);
+        }
+    }
+
+    bool Ready(uint64_t now_us) const {
+        return tick_ < replay_.tick_count && now_us >= next_tick_us_ &&
+               (tick_ < delay_ || remote_[tick_] != 0);
+    }
+
+    // Run the current tick and send this tick's commands to the link
+    void Execute(uint64_t now_us, PacketConditioner* link) {
+        stall_us_ += now_us - next_tick_us_;
+
+        // Commands scheduled for this tick, player 0's first on both peers
+        for (int side = 0; side < 2; side++) {
+            const std::vector<uint8_t>& cmds = side == id_ ? local_[tick_] : remote_data_[tick_];
+            for (size_t i = 0; i + sizeof(ReplayCommand) <= cmds.size(); i += sizeof(ReplayCommand)) {
+                ReplayCommand cmd;
+                memcpy(&cmd, &cmds[i], sizeof(cmd));
+                checksum_ = checksum_ * 31u + cmd.tick * 7u + static_cast<uint32_t>(cmd.cell_x * 3 + cmd.cell_y);
+                commands_run_++;
+            }
+        }
+
+        // Our orders issued this tick, for tick + delay
+        uint32_t exec_tick = tick_ + delay_;
+        uint8_t packet[MAX_PACKET];
+        memcpy(packet, &exec_tick, 4);
+        int size = 4;
+        for (size_t i = 0; i < replay_.commands.size(); i++) {
+            const ReplayCommand& cmd = replay_.commands[i];
+            if (cmd.tick == tick_ && static_cast<int>(i % 2) == id_ &&
+                size + static_cast<int>(sizeof(cmd)) <= MAX_PACKET) {
+                memcpy(packet + size, &cmd, sizeof(cmd));
+                size += sizeof(cmd);
+            }
+        }
+        local_[exec_tick].assign(packet + 4, packet + size);
+        Platform_Conditioner_Submit(link, now_us, 0, packet, size, 1);
+        bytes_sent_ += static_cast<uint64_t>(size);
+
+        tick_++;
+        next_tick_us_ = now_us + TICK_US;
+    }
+
+private:
+    int id_;
+    const Replay& replay_;
+    uint32_t delay_;
+    uint32_t tick_ = 0;
+    std::vector<uint8_t> remote_;
+    std::vector<std::vector<uint8_t>> remote_data_;
+    std::vector<std::vector<uint8_t>> local_;
+    uint64_t next_tick_us_;
+    uint64_t stall_us_ = 0;
+    uint64_t bytes_sent_ = 0;
+    uint32_t checksum_ = 0;
+    uint32_t commands_run_ = 0;
+};
+
+struct LinkResult {
+    uint32_t ticks = 0;
+    uint32_t commands = 0;
+    uint64_t stall_us = 0;          // Worse of the two peers
+    double bytes_per_tick = 0.0;    // Per peer
+    bool in_sync = false;
+    ConditionerStats link = {};
+};
+
+// Play replay between two peers over a link with conditions in both
+// directions, on a simulated clock
+LinkResult Run_Link(const Replay& replay, const NetConditions& conditions, uint32_t delay) {
+    LockstepPeer peers[2] = {LockstepPeer(0, replay, delay), LockstepPeer(1, replay, delay)};
+    NetConditions reverse = conditions;
+    reverse.seed = conditions.seed * 2 + 1;
+    PacketConditioner* links[2] = {Platform_Conditioner_Create(&conditions),
+                                   Platform_Conditioner_Create(&reverse)};
+
+    // Starts a tick in, so a release time of 0 only ever means "none held"
+    uint64_t now_us = TICK_US;
+    uint8_t buffer[MAX_PACKET];
+    while (peers[0].Running() || peers[1].Running()) {
+        // links[i] carries peer i's packets to the other peer
+        for (int i = 0; i < 2; i++) {
+            int size;
+            while ((size = Platform_Conditioner_Receive(links[i], now_us, buffer, MAX_PACKET, nullptr)) > 0) {
+                peers[1 - i].Accept(buffer, size);
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            while (peers[i].Ready(now_us)) {
+                peers[i].Execute(now_us, links[i]);
+            }
+        }
+
+        // Skip ahead to whatever happens next
+        uint64_t next_us = UINT64_MAX;
+        for (int i = 0; i < 2; i++) {
+            if (peers[i].Running() && peers[i].Get_Next_Tick_Us() > now_us) {
+                next_us = std::min(next_us, peers[i].Get_Next_Tick_Us());
+            }
+            uint64_t release_us = Platform_Conditioner_NextRelease(links[i]);
+            if (release_us != 0) {
+                next_us = std::min(next_us, std::max(release_us, now_us));
+            }
+        }
+        if (next_us == UINT64_MAX) {
+            break;      // Nothing in flight and no one can move: deadlocked
+        }
+        now_us = next_us;
+    }
+
+    LinkResult result;
+    result.ticks = std::min(peers[0].Get_Tick(), peers[1].Get_Tick());
+    result.commands = peers[0].Get_Commands_Run();
+    result.stall_us = std::max(peers[0].Get_Stall_Us(), peers[1].Get_Stall_Us());
+    result.bytes_per_tick = result.ticks > 0
+        ? static_cast<double>(peers[0].Get_Bytes_Sent() + peers[1].Get_Bytes_Sent()) / (2.0 * result.ticks)
+        : 0.0;
+    result.in_sync = peers[0].Get_Checksum() == peers[1].Get_Checksum() &&
+                     peers[0].Get_Commands_Run() == peers[1].Get_Commands_Run();
+    Platform_Conditioner_GetStats(links[0], &result.link);
+
+    Platform_Conditioner_Destroy(links[0]);
+    Platform_Conditioner_Destroy(links[1]);
+    return result;
+}
+
+NetConditions Make_Conditions(uint32_t latency_ms, uint32_t jitter_ms, uint32_t loss_percent,
+                              uint32_t bandwidth_kbps) {
+    NetConditions conditions;
+    memset(&conditions, 0, sizeof(conditions));
+    conditions.latency_ms = latency_ms;
+    conditions.jitter_ms = jitter_ms;
+    conditions.loss_percent = loss_percent;
+    conditions.bandwidth_kbps = bandwidth_kbps;
+    conditions.seed = 2024;
+    return conditions;
+}
+
+} // namespace
+
+//=============================================================================
+// Conditioner Tests
+//=============================================================================
+
+TEST_CASE(Perf_Network_ConditionerDelays, "Performance") {
+    NetConditions conditions = Make_Conditions(50, 0, 0, 0);
+    PacketConditioner* link = Platform_Conditioner_Create(&conditions);
+    TEST_ASSERT_NOT_NULL(link);
+
+    const uint8_t data[3] = {1, 2, 3};
+    TEST_ASSERT_EQ(Platform_Conditioner_Submit(link, 1000, 0, data, 3, 1), 0);
+    TEST_ASSERT_EQ(Platform_Conditioner_NextRelease(link), 51000ull);
+
+    uint8_t buffer[16];
+    TEST_ASSERT_EQ(Platform_Conditioner_Receive(link, 50999, buffer, 16, nullptr), 0);
+    TEST_ASSERT_EQ(Platform_Conditioner_Receive(link, 51000, buffer, 16, nullptr), 3);
+    TEST_ASSERT_EQ(buffer[2], 3);
+
+    Platform_Conditioner_Destroy(link);
+}
+
+//=============================================================================
+// Lockstep Benchmarks
+//=============================================================================
+
+TEST_CASE(Perf_Network_LockstepLinks, "Performance") {
+    struct Scenario {
+        const char* name;
+        NetConditions conditions;
+        uint32_t delay;             // Command delay in ticks
+    };
+    const Scenario scenarios[] = {
+        {"LAN",       Make_Conditions(1, 0, 0, 0),       2},
+        {"Broadband", Make_Conditions(40, 10, 1, 0),     3},
+        {"WAN",       Make_Conditions(100, 30, 2, 0),    5},
+        {"Lossy",     Make_Conditions(60, 20, 10, 0),    5},
+        {"Modem",     Make_Conditions(75, 10, 0, 28),    5},
+    };
+
+    Replay replay;
+    if (!replay.Load("NETBENCH.RPL")) {
+        Build_Replay(replay);
+    }
+
+    for (const Scenario& scenario : scenarios) {
+        // Orders issued in the last few ticks are scheduled past the end
+        uint32_t expected = 0;
+        for (const ReplayCommand& cmd : replay.commands) {
+            expected += cmd.tick + scenario.delay < replay.tick_count ? 1 : 0;
+        }
+
+        LinkResult result = Run_Link(replay, scenario.conditions, scenario.delay);
+
+        char msg[256];
+        snprintf(msg, sizeof(msg),
+                 "Lockstep %-9s delay %u: %u ticks, stall %.0f ms, %.1f bytes/tick, "
+                 "%llu resends",
+                 scenario.name, scenario.delay, result.ticks, result.stall_us / 1000.0,
+                 result.bytes_per_tick, static_cast<unsigned long long>(result.link.retransmitted));
+        Platform_Log(LOG_LEVEL_INFO, msg);
+        TEST_METRIC(std::string("Stall/") + scenario.name, result.stall_us / 1000.0, "ms");
+
+        // Every tick ran, and both peers ran the same commands in the same order
+        TEST_ASSERT_EQ(result.ticks, replay.tick_count);
+        TEST_ASSERT_EQ(result.commands, expected);
+        TEST_ASSERT(result.in_sync);
+        TEST_ASSERT_GT(result.bytes_per_tick, 0.0);
+    }
+
+    // A LAN never waits on the other side
+    LinkResult lan = Run_Link(replay, scenarios[0].conditions, scenarios[0].delay);
+    TEST_ASSERT_EQ(lan.stall_us, 0ull);
+
+    // A delay shorter than the link stalls
+    LinkResult short_delay = Run_Link(replay, scenarios[2].conditions, 2);
+    TEST_ASSERT_GT(short_delay.stall_us, 0ull);
+}
@@ -0,0 +1,131 @@
+// src/tests/performance/test_render_thread.cpp
+// Render Thread Benchmarks
+// Game-thread work overlapped with rasterizing the previous frame
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "perf_utils.h"
+#include "game/graphics/render_pipeline.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+const int FRAMES = 60;
+const int WARMUP_FRAMES = 5;
+const int OBJECT_COUNT = 400;
+
+// Per-frame game work, sized to be about as dear as rasterizing
+const int SIM_ITERATIONS = 400000;
+
+// Threaded frames must come in at least this much under serial ones
+const double MAX_THREADED_RATIO = 0.8;
+
+// A filled box standing in for a sprite draw
+class BoxObject : public IRenderable {
+public:
+    BoxObject(int x, int y, RenderLayer layer, uint8_t color)
+        : x_(x), y_(y), layer_(layer), color_(color) {}
+
+    RenderLayer GetRenderLayer() const override { return layer_; }
+    int GetSortY() const override { return y_ + 48; }
+    void Draw(GraphicsBuffer& buffer, int screen_x, int screen_y) override {
+        buffer.Fill_Rect(screen_x, screen_y, 48, 48, color_);
+    }
+    int GetWorldX() const override { return x_; }
+    int GetWorldY() const override { return y_; }
+    void GetBounds(int& x, int& y, int& width, int& height) const override {
+        x = 0; y = 0; width = 48; height = 48;
+    }
+
+private:
+    int x_, y_;
+    RenderLayer layer_;
+    uint8_t color_;
+};
+
+// Stand-in for a logic tick: dependent arithmetic the optimizer keeps
+uint32_t Simulate(uint32_t seed) {
+    for (int i = 0; i < SIM_ITERATIONS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        seed ^= seed >> 13;
+    }
+    return seed;
+}
+
+// Average ms per frame of simulate + record + render + present
+double Run_Frames(RenderPipeline& pipeline, std::vector<BoxObject>& objects, uint32_t& seed) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    for (int frame = 0; frame < FRAMES; frame++) {
+        if (frame == WARMUP_FRAMES) {
+            start = Clock::now();
+        }
+        seed = Simulate(seed);
+
+        pipeline.BeginFrame();
+        for (BoxObject& object : objects) {
+            pipeline.AddRenderable(&object);
+        }
+        pipeline.RenderFrame();
+        pipeline.EndFrame();
+    }
+    pipeline.Finish();
+
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count() / (FRAMES - WARMUP_FRAMES);
+}
+
+} // namespace
+
+//=============================================================================
+// Render Thread Overlap
+//=============================================================================
+
+TEST_WITH_FIXTURE(GraphicsFixture, Perf_RenderThread_Overlap, "Performance") {
+    if (!fixture.IsInitialized() || !Platform_Graphics_IsInitialized()) {
+        TEST_SKIP("Graphics not available");
+    }
+
+    RenderPipeline& pipeline = RenderPipeline::Instance();
+    if (!pipeline.Initialize(fixture.GetWidth(), fixture.GetHeight())) {
+        TEST_SKIP("Screen too small for the pipeline");
+    }
+    pipeline.SetScrollPosition(0, 0);
+
+    std::vector<BoxObject> objects;
+    uint32_t seed = 0x7E4D3u;
+    const Viewport& view = pipeline.GetTacticalViewport();
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int x = static_cast<int>((seed >> 8) % static_cast<uint32_t>(view.width - 48));
+        int y = static_cast<int>((seed >> 16) % static_cast<uint32_t>(view.height - 48));
+        RenderLayer layer = (i % 5 == 0) ? RenderLayer::AIR : RenderLayer::GROUND;
+        objects.emplace_back(x, y, layer, static_cast<uint8_t>(16 + i % 200));
+    }
+
+    double serial_ms = Run_Frames(pipeline, objects, seed);
+    pipeline.SetThreaded(true);
+    double threaded_ms = Run_Frames(pipeline, objects, seed);
+    pipeline.SetThreaded(false);
+    pipeline.Shutdown();
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Frame with %d objects: serial %.3f ms, render thread %.3f ms (%.0f%%)",
+             OBJECT_COUNT, serial_ms, threaded_ms, 100.0 * threaded_ms / serial_ms);
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    TEST_METRIC("SerialFrame", serial_ms, "ms");
+    TEST_METRIC("ThreadedFrame", threaded_ms, "ms");
+
+    // With cores to spare the frame costs max(sim, render), not their sum
+    if (std::thread::hardware_concurrency() >= 4) {
+        TEST_ASSERT_LT(threaded_ms, serial_ms * MAX_THREADED_RATIO);
+    }
+}
@@ -0,0 +1,498 @@
+// src/tests/performance/test_replay_frames.cpp
+// Replay Frame-Time Benchmark
+// Plays a recorded match back one logic tick per frame and draws every
+// frame offscreen, timing each render layer. This is the number renderer
+// changes are accepted or rejected on.
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "game/game.h"
+#include "game/display.h"
+#include "game/cell.h"
+#include "game/movement.h"
+#include "game/object_heap.h"
+#include "game/projectile.h"
+#include "game/replay.h"
+#include "game/techno.h"
+#include "game/findpath.h"
+#include "game/flow_field.h"
+#include "game/job_system.h"
+#include "game/input/command_system.h"
+#include "game/input/selection_manager.h"
+#include "platform.h"
+#include "platform/profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+// The match played; recorded on first use so every later run (and every
+// renderer change) draws exactly the same frames. FRAMEBENCH_REPLAY picks
+// another file.
+const char* const DEFAULT_REPLAY_PATH = "FRAMEBENCH.RPL";
+
+// The match recorded when there is no replay file yet
+const int RECORD_OBJECTS = 1000;
+const int RECORD_TICKS = 1200;
+const int ORDERS_PER_TICK = 2;
+const uint32_t RECORD_SEED = 0xF7A3E000u;
+
+// The first frame fills the whole terrain cache; it is drawn but not counted
+const int WARMUP_FRAMES = 1;
+
+// Render layers reported, as named by their PROFILE_SCOPEs in DisplayClass
+const char* const LAYERS[] = {"Render Terrain", "Render Objects", "Render Cursor"};
+const int LAYER_COUNT = sizeof(LAYERS) / sizeof(LAYERS[0]);
+
+// Small deterministic generator, so the recorded battle is the same everywhere
+struct FrameRandom {
+    uint32_t state;
+    explicit FrameRandom(uint32_t seed) : state(seed) {}
+    uint32_t Next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    int Range(int lo, int hi) { return lo + static_cast<int>(Next() % static_cast<uint32_t>(hi - lo + 1)); }
+};
+
+const char* Replay_Path() {
+    const char* env = getenv("FRAMEBENCH_REPLAY");
+    return (env != nullptr && *env != '\0') ? env : DEFAULT_REPLAY_PATH;
+}
+
+// Every unit and soldier on the map, with the selectable records commands
+// are issued and replayed on. Ids follow heap order, which a snapshot
+// restores, so they match between recording and playback.
+struct Army {
+    std::vector<FootClass*> units;              // Indexed by SelectableObject::id - 1
+    std::vector<SelectableObject> selectable;
+    std::vector<int> sides[2];                  // Indices into units, Greece then USSR
+};
+
+void Index_Army(Army& army) {
+    army.units.clear();
+    army.sides[0].clear();
+    army.sides[1].clear();
+    const RTTIType kinds[] = {RTTI_UNIT, RTTI_INFANTRY};
+    for (RTTIType rtti : kinds) {
+        ObjectHeapBase* heap = Object_Heap(rtti);
+        for (int i = 0; i < heap->Count(); i++) {
+            army.units.push_back(static_cast<FootClass*>(heap->Active(i)));
+        }
+    }
+
+    army.selectable.assign(army.units.size(), SelectableObject());
+    for (size_t i = 0; i < army.units.size(); i++) {
+        FootClass* unit = army.units[i];
+        SelectableObject& obj = army.selectable[i];
+        obj.id = static_cast<uint32_t>(i + 1);
+        obj.cell_x = Cell_X(unit->Get_Cell());
+        obj.cell_y = Cell_Y(unit->Get_Cell());
+        obj.pixel_x = obj.cell_x * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2;
+        obj.pixel_y = obj.cell_y * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2;
+        obj.width = CELL_PIXEL_SIZE;
+        obj.height = CELL_PIXEL_SIZE;
+        obj.owner = unit->Get_Owner();
+        obj.is_unit = true;
+        obj.is_active = unit->Is_Active();
+        obj.rtti_type = unit->What_Am_I();
+        army.sides[unit->Get_Owner() == HOUSE_GREECE ? 0 : 1].push_back(static_cast<int>(i));
+    }
+}
+
+// Dead units drop out of the records as the game would
+void Refresh_Army(Army& army) {
+    for (size_t i = 0; i < army.units.size(); i++) {
+        army.selectable[i].is_active = army.units[i]->Is_Active();
+    }
+}
+
+// Orders and replayed orders reach the army through these
+void Connect_Army(Army& army) {
+    SelectionManager::Instance().SetAllObjectsQuery([&army]() {
+        std::vector<SelectableObject*> all;
+        all.reserve(army.selectable.size());
+        for (SelectableObject& obj : army.selectable) {
+            all.push_back(&obj);
+        }
+        return all;
+    });
+    CommandSystem::Instance().SetAssignBatchCallback(
+        [&army](void* const* units, int count, MissionType mission, const CommandTarget& target) {
+            FootClass* victim = nullptr;
+            if (mission == MISSION_ATTACK) {
+                const SelectableObject* obj = static_cast<const SelectableObject*>(target.object);
+                victim = obj ? army.units[obj->id - 1] : nullptr;
+                if (victim == nullptr || !victim->Is_Active()) {
+                    return 0;
+                }
+            }
+            COORDINATE dest = Cell_Coord(XY_Cell(target.cell_x, target.cell_y));
+
+            int assigned = 0;
+            for (int i = 0; i < count; i++) {
+                const SelectableObject* obj = static_cast<const SelectableObject*>(units[i]);
+                FootClass* unit = army.units[obj->id - 1];
+                if (!unit->Is_Active()) continue;
+                if (mission == MISSION_ATTACK) {
+                    unit->Set_Target(victim);
+                } else if (target.flow_field) {
+                    unit->Follow_Flow_Field(target.flow_field, dest);
+                } else {
+                    unit->Set_Destination(dest);
+                }
+                assigned++;
+            }
+            return assigned;
+        });
+}
+
+void Disconnect_Army() {
+    SelectionManager::Instance().Clear();
+    SelectionManager::Instance().SetAllObjectsQuery(nullptr);
+    CommandSystem::Instance().SetAssignBatchCallback(nullptr);
+}
+
+// Grass, ore fields and wall lines, all revealed
+void Generate_Map(MapClass& map, FrameRandom& rng) {
+    map.Set_Map_Bounds(1, 1, MAP_CELL_WIDTH - 2, MAP_CELL_HEIGHT - 2);
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            CellClass* cell = map.Cell_At(x, y);
+            cell->Set_Template(0, static_cast<uint8_t>(rng.Range(0, 15)));
+            cell->Reveal(true);
+        }
+    }
+    for (int patch = 0; patch < 24; patch++) {
+        int cx = rng.Range(8, MAP_CELL_WIDTH - 9);
+        int cy = rng.Range(8, MAP_CELL_HEIGHT - 9);
+        for (int y = cy - 3; y <= cy + 3; y++) {
+            for (int x = cx - 3; x <= cx + 3; x++) {
+                map.Cell_At(x, y)->Set_Overlay(rng.Range(0, 3) == 0 ? OVERLAY_GEMS1 : OVERLAY_GOLD2);
+            }
+        }
+    }
+    for (int wall = 0; wall < 12; wall++) {
+        int x = rng.Range(4, MAP_CELL_WIDTH - 5);
+        int y0 = rng.Range(4, MAP_CELL_HEIGHT - 30);
+        for (int y = y0; y < y0 + 20; y++) {
+            map.Cell_At(x, y)->Set_Overlay(OVERLAY_BRICK);
+        }
+    }
+}
+
+// Two lines facing each other across the middle, a third of them infantry
+void Spawn_Armies(MapClass& map, FrameRandom& rng) {
+    const int depth = 30;   // Columns per side
+    int per_side = RECORD_OBJECTS / 2;
+    for (int i = 0; i < per_side * 2; i++) {
+        int side = i / per_side;
+        int index = i % per_side;
+        int column = index % depth;
+        int row = 2 + (index / depth) % (MAP_CELL_HEIGHT - 4);
+        int x = side == 0 ? MAP_CELL_WIDTH / 2 - 1 - column : MAP_CELL_WIDTH / 2 + column;
+        CELL cell = XY_Cell(x, row);
+        if (!map[cell].Is_Passable()) {
+            map[cell].Set_Overlay(OVERLAY_NONE_TYPE);
+        }
+
+        bool infantry = rng.Range(0, 2) == 0;
+        FootClass* unit = static_cast<FootClass*>(Create_Object(infantry ? RTTI_INFANTRY : RTTI_UNIT));
+        unit->Set_Owner(side == 0 ? HOUSE_GREECE : HOUSE_USSR);
+        unit->Set_Coord(Cell_Coord(cell));
+        unit->Set_Speed(infantry ? 12 : 24);
+        unit->Set_Weapons(infantry ? WEAPON_M1_CARBINE : WEAPON_90MM);
+    }
+}
+
+// One tick's orders: a group on one side moves toward the front or attacks
+void Issue_Orders(Army& army, FrameRandom& rng) {
+    SelectionManager& selection = SelectionManager::Instance();
+    CommandSystem& commands = CommandSystem::Instance();
+    std::vector<SelectableObject*> group;
+
+    for (int order = 0; order < ORDERS_PER_TICK; order++) {
+        int side = rng.Range(0, 1);
+        const std::vector<int>& members = army.sides[side];
+        const std::vector<int>& enemies = army.sides[1 - side];
+        if (members.empty() || enemies.empty()) continue;
+        int size = std::min(rng.Range(4, MAX_SELECTION), static_cast<int>(members.size()));
+        int first = rng.Range(0, static_cast<int>(members.size()) - size);
+
+        group.clear();
+        for (int i = first; i < first + size; i++) {
+            group.push_back(&army.selectable[members[i]]);
+        }
+        selection.SetPlayerHouse(side == 0 ? HOUSE_GREECE : HOUSE_USSR);
+        selection.SelectObjects(group.data(), static_cast<int>(group.size()));
+        if (!selection.HasSelection()) continue;
+
+        if (rng.Range(0, 9) < 6) {
+            int x = rng.Range(MAP_CELL_WIDTH / 2 - 20, MAP_CELL_WIDTH / 2 + 20);
+            int y = rng.Range(2, MAP_CELL_HEIGHT - 3);
+            commands.IssueMoveCommand(x * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2,
+                                      y * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2);
+        } else {
+            int enemy = enemies[rng.Range(0, static_cast<int>(enemies.size()) - 1)];
+            commands.IssueAttackCommand(&army.selectable[enemy]);
+        }
+    }
+    selection.Clear();
+}
+
+// Objects unmark their cells as they go, so free them before the map
+void Clear_World() {
+    Destroy_All_Objects();
+    MovementSystem::Instance().Clear();
+    ProjectileSystem::Instance().Clear();
+    PathFinder::Instance().Invalidate();
+    FlowField::Flush_Cache();
+}
+
+// Play a generated battle headless and record it
+bool Record_Match(GameClass& game, DisplayClass& display, Replay& replay) {
+    FrameRandom rng(RECORD_SEED);
+    Generate_Map(display, rng);
+    Spawn_Armies(display, rng);
+
+    Army army;
+    Index_Army(army);
+    Connect_Army(army);
+
+    ReplayRecorder& recorder = ReplayRecorder::Instance();
+    bool ok = recorder.Start(RECORD_SEED, display);
+    for (int tick = 0; ok && tick < RECORD_TICKS; tick++) {
+        Refresh_Army(army);
+        Issue_Orders(army, rng);
+        game.Run_Ticks(1);
+        recorder.End_Tick();
+    }
+    replay = recorder.Stop();
+
+    Disconnect_Army();
+    Clear_World();
+    return ok && replay.tick_count > 0;
+}
+
+struct FrameSample {
+    double total_ms = 0.0;               // Draw_Frame(), every layer
+    double layer_ms[LAYER_COUNT] = {};
+    RenderStats stats;
+};
+
+struct FrameSummary {
+    double avg_ms = 0.0;
+    double median_ms = 0.0;
+    double low_1_ms = 0.0;               // Mean of the slowest 1% of frames
+    double low_01_ms = 0.0;              // Mean of the slowest 0.1%
+    double max_ms = 0.0;
+};
+
+// Lows are the mean of the slowest fraction of frames (at least one), the
+// frame time a player notices as a hitch
+double Mean_Of_Slowest(const std::vector<double>& sorted, double fraction) {
+    size_t count = std::max<size_t>(1, static_cast<size_t>(sorted.size() * fraction));
+    double sum = 0.0;
+    for (size_t i = sorted.size() - count; i < sorted.size(); i++) {
+        sum += sorted[i];
+    }
+    return sum / count;
+}
+
+FrameSummary Summarize(std::vector<double> times) {
+    FrameSummary summary;
+    if (times.empty()) {
+        return summary;
+    }
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (double t : times) {
+        sum += t;
+    }
+    summary.avg_ms = sum / times.size();
+    summary.median_ms = times[times.size() / 2];
+    summary.low_1_ms = Mean_Of_Slowest(times, 0.01);
+    summary.low_01_ms = Mean_Of_Slowest(times, 0.001);
+    summary.max_ms = times.back();
+    return summary;
+}
+
+double To_Fps(double ms) {
+    return ms > 0.0 ? 1000.0 / ms : 0.0;
+}
+
+// Frame times in the profiler's histogram buckets (half-octave steps)
+void Log_Histogram(const std::vector<double>& times) {
+    std::vector<int> buckets(Profiler::HISTOGRAM_BUCKETS, 0);
+    for (double t : times) {
+        int b = 0;
+        while (b < Profiler::HISTOGRAM_BUCKETS - 1 && t > Profiler::get_histogram_bucket_limit_ms(b)) {
+            b++;
+        }
+        buckets[b]++;
+    }
+    int peak = *std::max_element(buckets.begin(), buckets.end());
+
+    char msg[256];
+    for (int b = 0; b < Profiler::HISTOGRAM_BUCKETS; b++) {
+        if (buckets[b] == 0) continue;
+        int width = peak > 0 ? (buckets[b] * 50 + peak - 1) / peak : 0;
+        snprintf(msg, sizeof(msg), "  <= %8.3f ms %6d  %s",
+                 Profiler::get_histogram_bucket_limit_ms(b), buckets[b],
+                 std::string(width, '#').c_str());
+        Platform_Log(LOG_LEVEL_INFO, msg);
+    }
+}
+
+} // namespace
+
+//=============================================================================
+// Replay Frame Times
+//=============================================================================
+
+TEST_WITH_FIXTURE(GraphicsFixture, Perf_Replay_FrameTimes, "Performance") {
+#if !PROFILER_ENABLED
+    TEST_SKIP("Profiler not built in");
+#endif
+    if (!fixture.IsInitialized() || !Platform_Graphics_IsInitialized()) {
+        TEST_SKIP("Graphics not available");
+    }
+
+    JobSystem::Instance().Start();
+    CommandSystem::Instance().Initialize();
+    SelectionManager::Instance().Initialize();
+
+    GameClass game;
+    game.Set_Player_House(HOUSE_GREECE);
+
+    DisplayClass display;
+    display.One_Time();
+    display.Init(THEATER_TEMPERATE);
+    MapClass* previous_map = Map;
+    Map = &display;
+
+    const char* path = Replay_Path();
+    Replay replay;
+    bool loaded = replay.Load(path);
+    bool recorded = false;
+    if (!loaded && Record_Match(game, display, replay)) {
+        recorded = replay.Save(path);
+        loaded = true;
+    }
+
+    Army army;
+    ReplayPlayer player;
+    if (!loaded || !player.Start(replay, display)) {
+        Clear_World();
+        Map = previous_map;
+        TEST_FAIL("Replay could not be recorded or played");
+    }
+    Index_Army(army);
+    Connect_Army(army);
+    display.Center_On(XY_Cell(MAP_CELL_WIDTH / 2, MAP_CELL_HEIGHT / 2));
+
+    // Fixed sim time: exactly one logic tick per frame, whatever the frame took
+    Profiler& profiler = Profiler::instance();
+    profiler.reset();
+    std::vector<FrameSample> frames;
+    frames.reserve(replay.tick_count);
+    while (!player.Is_Finished()) {
+        uint32_t tick = player.Get_Tick();
+        Refresh_Army(army);
+        player.Begin_Tick();
+        game.Run_Ticks(1);
+        player.End_Tick();
+
+        // A slow pan, so the terrain cache has edges to fill in
+        display.Scroll((tick / 40) % 2 ? -4 : 4, 1);
+        display.Set_Cursor_Cell(XY_Cell(MAP_CELL_WIDTH / 2 + static_cast<int>(tick % 16), MAP_CELL_HEIGHT / 2));
+
+        double before[LAYER_COUNT + 1];
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            before[i] = profiler.get_stats(LAYERS[i]).total_time_ms;
+        }
+        before[LAYER_COUNT] = profiler.get_stats("Replay Frame").total_time_ms;
+
+        profiler.begin_frame();
+        {
+            PROFILE_SCOPE("Replay Frame");
+            display.Draw_Frame();
+        }
+        profiler.end_frame();
+
+        FrameSample sample;
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            sample.layer_ms[i] = profiler.get_stats(LAYERS[i]).total_time_ms - before[i];
+        }
+        sample.total_ms = profiler.get_stats("Replay Frame").total_time_ms - before[LAYER_COUNT];
+        sample.stats = display.Get_Frame_Stats();
+        sample.stats.frame_time_ms = static_cast<float>(sample.total_ms);
+        frames.push_back(sample);
+    }
+
+    Disconnect_Army();
+    Clear_World();
+    Map = previous_map;
+
+    // Report
+    int counted = std::max(0, static_cast<int>(frames.size()) - WARMUP_FRAMES);
+    std::vector<double> totals;
+    std::vector<double> layers[LAYER_COUNT];
+    RenderStats sum;
+    for (int f = WARMUP_FRAMES; f < static_cast<int>(frames.size()); f++) {
+        totals.push_back(frames[f].total_ms);
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            layers[i].push_back(frames[f].layer_ms[i]);
+        }
+        sum += frames[f].stats;
+    }
+    FrameSummary frame = Summarize(totals);
+
+    char msg[256];
+    snprintf(msg, sizeof(msg), "Replay %s%s: %d frames (%d warm-up not counted)",
+             path, recorded ? " (recorded)" : "", counted, WARMUP_FRAMES);
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    snprintf(msg, sizeof(msg), "%-16s %9s %9s %9s %9s %9s", "layer", "avg", "median", "1% low",
+             "0.1% low", "max");
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    for (int i = 0; i <= LAYER_COUNT; i++) {
+        FrameSummary s = i < LAYER_COUNT ? Summarize(layers[i]) : frame;
+        snprintf(msg, sizeof(msg), "%-16s %9.3f %9.3f %9.3f %9.3f %9.3f",
+                 i < LAYER_COUNT ? LAYERS[i] : "Frame", s.avg_ms, s.median_ms,
+                 s.low_1_ms, s.low_01_ms, s.max_ms);
+        Platform_Log(LOG_LEVEL_INFO, msg);
+    }
+    snprintf(msg, sizeof(msg), "FPS: avg %.1f, 1%% low %.1f, 0.1%% low %.1f",
+             To_Fps(frame.avg_ms), To_Fps(frame.low_1_ms), To_Fps(frame.low_01_ms));
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    if (counted > 0) {
+        snprintf(msg, sizeof(msg),
+                 "Per frame: %.1f tiles, %.1f objects, %.1f dirty rects, %.0f pixels filled",
+                 static_cast<double>(sum.terrain_tiles_drawn) / counted,
+                 static_cast<double>(sum.objects_drawn) / counted,
+                 static_cast<double>(sum.dirty_rects_count) / counted,
+                 static_cast<double>(sum.pixels_filled) / counted);
+        Platform_Log(LOG_LEVEL_INFO, msg);
+    }
+    Platform_Log(LOG_LEVEL_INFO, "Frame time histogram:");
+    Log_Histogram(totals);
+
+    TEST_METRIC("Frame", frame.avg_ms, "ms");
+    TEST_METRIC("Frame/1%Low", frame.low_1_ms, "ms");
+    TEST_METRIC("Frame/0.1%Low", frame.low_01_ms, "ms");
+    for (int i = 0; i < LAYER_COUNT; i++) {
+        TEST_METRIC(LAYERS[i], Summarize(layers[i]).avg_ms, "ms");
+    }
+
+    TEST_ASSERT_EQ(static_cast<uint32_t>(frames.size()), replay.tick_count);
+    TEST_ASSERT_GT(counted, 0);
+    TEST_ASSERT_GT(frame.avg_ms, 0.0);
+    TEST_ASSERT_GT(sum.objects_drawn, 0);
+}
@@ -0,0 +1,166 @@
+// src/tests/performance/test_resolution.cpp
+// Internal Resolution Benchmarks
+// Tactical frames drawn at 640x400, 1280x800 and 1920x1080
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "perf_utils.h"
+#include "game/display.h"
+#include "game/cell.h"
+#include "platform/profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+struct Resolution {
+    int width;
+    int height;
+};
+
+const Resolution RESOLUTIONS[] = {{640, 400}, {1280, 800}, {1920, 1080}};
+const int RESOLUTION_COUNT = sizeof(RESOLUTIONS) / sizeof(RESOLUTIONS[0]);
+
+// Frames drawn per resolution; the first few fill the terrain cache
+const int FRAMES = 150;
+const int WARMUP_FRAMES = 10;
+
+// A 1920x1080 pixel may cost at most this much more than a 640x400 one
+const double MAX_PIXEL_COST_RATIO = 1.5;
+
+struct ResolutionRow {
+    Resolution size = {0, 0};
+    int visible_cells = 0;
+    double terrain_ms = 0.0;    // Per frame: cache update and blit
+    double objects_ms = 0.0;    // Per frame: visible cell scan
+    double frame_ms = 0.0;      // Per frame: all of Draw_Frame()
+    double ns_per_pixel = 0.0;  // frame_ms over the tactical area
+};
+
+// Every cell revealed with mixed templates and ore, so the whole view draws
+void Fill_Map(MapClass& map) {
+    uint32_t seed = 0x12E50u;
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            seed = seed * 1664525u + 1013904223u;
+            CellClass* cell = map.Cell_At(x, y);
+            cell->Set_Template(0, static_cast<uint8_t>((seed >> 8) % 16));
+            if ((seed >> 20) % 8 == 0) {
+                cell->Set_Overlay(OVERLAY_GOLD2);
+            }
+            cell->Reveal(true);
+        }
+    }
+}
+
+// Bring graphics up at this size and draw a panning view
+bool Run_Resolution(const Resolution& size, ResolutionRow& row) {
+    Platform_Graphics_Shutdown();
+    if (Platform_Graphics_SetResolution(size.width, size.height) != 0) {
+        return false;
+    }
+
+    DisplayClass display;
+    display.One_Time();
+    if (display.Get_Width() != size.width || display.Get_Height() != size.height) {
+        return false;
+    }
+    display.Init(THEATER_TEMPERATE);
+    MapClass* previous_map = Map;
+    Map = &display;
+    Fill_Map(display);
+    display.Center_On(XY_Cell(MAP_CELL_WIDTH / 2, MAP_CELL_HEIGHT / 2));
+
+    int start_x, start_y, end_x, end_y;
+    display.Get_Visible_Cells(start_x, start_y, end_x, end_y);
+    row.size = size;
+    row.visible_cells = (end_x - start_x) * (end_y - start_y);
+
+    Profiler& profiler = Profiler::instance();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        if (frame == WARMUP_FRAMES) {
+            profiler.reset();
+        }
+        // A slow pan, so the terrain cache has edges to fill in
+        display.Scroll((frame / 40) % 2 ? -4 : 4, 1);
+
+        profiler.begin_frame();
+        {
+            PROFILE_SCOPE("Resolution Frame");
+            display.Draw_Frame();
+        }
+        profiler.end_frame();
+    }
+
+    int counted = FRAMES - WARMUP_FRAMES;
+    row.terrain_ms = profiler.get_stats("Render Terrain").total_time_ms / counted;
+    row.objects_ms = profiler.get_stats("Render Objects").total_time_ms / counted;
+    row.frame_ms = profiler.get_stats("Resolution Frame").total_time_ms / counted;
+    double pixels = static_cast<double>(display.Tactical_Width()) * display.Tactical_Height();
+    row.ns_per_pixel = row.frame_ms * 1e6 / pixels;
+
+    Map = previous_map;
+    return true;
+}
+
+} // namespace
+
+//=============================================================================
+// Resolution Scaling
+//=============================================================================
+
+TEST_WITH_FIXTURE(GraphicsFixture, Perf_Resolution_Tactical, "Performance") {
+#if !PROFILER_ENABLED
+    TEST_SKIP("Profiler not built in");
+#endif
+    if (!fixture.IsInitialized() || !Platform_Graphics_IsInitialized()) {
+        TEST_SKIP("Graphics not available");
+    }
+
+    std::vector<ResolutionRow> rows;
+    bool all_ran = true;
+    for (int i = 0; i < RESOLUTION_COUNT; i++) {
+        ResolutionRow row;
+        if (Run_Resolution(RESOLUTIONS[i], row)) {
+            rows.push_back(row);
+        } else {
+            all_ran = false;
+        }
+    }
+
+    // Leave graphics as the fixture found it
+    Platform_Graphics_Shutdown();
+    Platform_Graphics_SetResolution(640, 400);
+    Platform_Graphics_Init();
+
+    char msg[256];
+    Platform_Log(LOG_LEVEL_INFO, "Tactical frame by internal resolution (ms per frame):");
+    snprintf(msg, sizeof(msg), "%11s %7s %9s %9s %9s %9s",
+             "resolution", "cells", "terrain", "objects", "frame", "ns/pixel");
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    for (const ResolutionRow& row : rows) {
+        std::string name = std::to_string(row.size.width) + "x" + std::to_string(row.size.height);
+        snprintf(msg, sizeof(msg), "%11s %7d %9.3f %9.3f %9.3f %9.2f",
+                 name.c_str(), row.visible_cells, row.terrain_ms, row.objects_ms,
+                 row.frame_ms, row.ns_per_pixel);
+        Platform_Log(LOG_LEVEL_INFO, msg);
+
+        TEST_METRIC("Frame/" + name, row.frame_ms, "ms");
+        TEST_METRIC("Terrain/" + name, row.terrain_ms, "ms");
+        TEST_METRIC("PixelCost/" + name, row.ns_per_pixel, "ns");
+    }
+
+    TEST_ASSERT(all_ran);
+    TEST_ASSERT_EQ(static_cast<int>(rows.size()), RESOLUTION_COUNT);
+
+    // Cost follows the visible area: a pixel at 1920x1080 is no dearer
+    // than one at 640x400, give or take cache effects
+    TEST_ASSERT_GT(rows.back().visible_cells, rows.front().visible_cells * 6);
+    TEST_ASSERT_LT(rows.back().ns_per_pixel, rows.front().ns_per_pixel * MAX_PIXEL_COST_RATIO);
+}
@@ -0,0 +1,364 @@
+// src/tests/performance/test_scenario_stress.cpp
+// Scenario Stress Benchmarks
+// Two armies on a generated map, driven through the real game systems
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "perf_utils.h"
+#include "game/game.h"
+#include "game/display.h"
+#include "game/cell.h"
+#include "game/combat.h"
+#include "game/movement.h"
+#include "game/object_heap.h"
+#include "game/projectile.h"
+#include "game/techno.h"
+#include "game/findpath.h"
+#include "game/flow_field.h"
+#include "game/job_system.h"
+#include "game/audio/audio_events.h"
+#include "game/input/command_system.h"
+#include "game/input/selection_manager.h"
+#include "platform/profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+namespace {
+
+// Army sizes run by default; STRESS_OBJECTS="250,4000" picks others
+const int DEFAULT_OBJECT_COUNTS[] = {100, 500, 1000, 2500, 5000};
+const int MIN_OBJECTS = 2;
+const int MAX_OBJECTS = 5000;
+
+// Logic ticks per army size (STRESS_TICKS overrides), one frame drawn per tick
+const int DEFAULT_TICKS = 60;
+
+// Every unit gets a new order about this often
+const int ORDER_PERIOD_TICKS = 30;
+
+// Subsystems reported, as named by their PROFILE_SCOPEs
+const char* const SUBSYSTEMS[] = {"Sim", "Render Terrain", "Render Objects", "Audio", "Input"};
+const int SUBSYSTEM_COUNT = sizeof(SUBSYSTEMS) / sizeof(SUBSYSTEMS[0]);
+
+// Small deterministic generator, so every run lays out the same battle
+struct StressRandom {
+    uint32_t state;
+    explicit StressRandom(uint32_t seed) : state(seed) {}
+    uint32_t Next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    int Range(int lo, int hi) { return lo + static_cast<int>(Next() % static_cast<uint32_t>(hi - lo + 1)); }
+};
+
+std::vector<int> Object_Counts() {
+    std::vector<int> counts;
+    const char* env = getenv("STRESS_OBJECTS");
+    while (env != nullptr && *env != '\0') {
+        char* end;
+        long value = strtol(env, &end, 10);
+        if (end == env) break;
+        counts.push_back(static_cast<int>(std::min<long>(std::max<long>(value, MIN_OBJECTS), MAX_OBJECTS)));
+        env = (*end == ',') ? end + 1 : end;
+    }
+    if (counts.empty()) {
+        counts.assign(DEFAULT_OBJECT_COUNTS, DEFAULT_OBJECT_COUNTS + sizeof(DEFAULT_OBJECT_COUNTS) / sizeof(int));
+    }
+    return counts;
+}
+
+int Tick_Count() {
+    const char* env = getenv("STRESS_TICKS");
+    int ticks = env ? atoi(env) : 0;
+    return ticks > 0 ? ticks : DEFAULT_TICKS;
+}
+
+// Clear land with ore fields, wall lines and scattered sandbags; the
+// whole map revealed so the view draws every cell
+void Generate_Map(MapClass& map, StressRandom& rng) {
+    map.Set_Map_Bounds(1, 1, MAP_CELL_WIDTH - 2, MAP_CELL_HEIGHT - 2);
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            CellClass* cell = map.Cell_At(x, y);
+            cell->Set_Template(0, static_cast<uint8_t>(rng.Range(0, 15)));
+            cell->Reveal(true);
+        }
+    }
+    for (int patch = 0; patch < 24; patch++) {
+        int cx = rng.Range(8, MAP_CELL_WIDTH - 9);
+        int cy = rng.Range(8, MAP_CELL_HEIGHT - 9);
+        for (int y = cy - 3; y <= cy + 3; y++) {
+            for (int x = cx - 3; x <= cx + 3; x++) {
+                map.Cell_At(x, y)->Set_Overlay(rng.Range(0, 3) == 0 ? OVERLAY_GEMS1 : OVERLAY_GOLD2);
+            }
+        }
+    }
+    for (int wall = 0; wall < 12; wall++) {
+        int x = rng.Range(4, MAP_CELL_WIDTH - 5);
+        int y0 = rng.Range(4, MAP_CELL_HEIGHT - 30);
+        for (int y = y0; y < y0 + 20; y++) {
+            map.Cell_At(x, y)->Set_Overlay(OVERLAY_BRICK);
+        }
+    }
+    for (int i = 0; i < 200; i++) {
+        map.Cell_At(rng.Range(2, MAP_CELL_WIDTH - 3), rng.Range(2, MAP_CELL_HEIGHT - 3))->Set_Overlay(OVERLAY_SANDBAG);
+    }
+}
+
+// Both armies, with the selectable records commands are issued on
+struct Army {
+    std::vector<FootClass*> units;              // Indexed by SelectableObject::id - 1
+    std::vector<SelectableObject> selectable;
+    int per_side = 0;                           // Greece first, then USSR
+};
+
+// Two lines facing each other across the middle, a third of them infantry
+void Spawn_Armies(MapClass& map, int count, StressRandom& rng, Army& army) {
+    army.per_side = count / 2;
+    army.units.clear();
+    army.selectable.assign(army.per_side * 2, SelectableObject());
+
+    const int depth = 30;   // Columns per side
+    for (int i = 0; i < army.per_side * 2; i++) {
+        int side = i / army.per_side;
+        int index = i % army.per_side;
+        int column = index % depth;
+        int row = 2 + (index / depth) % (MAP_CELL_HEIGHT - 4);
+        int x = side == 0 ? MAP_CELL_WIDTH / 2 - 1 - column : MAP_CELL_WIDTH / 2 + column;
+        CELL cell = XY_Cell(x, row);
+        if (!map[cell].Is_Passable()) {
+            map[cell].Set_Overlay(OVERLAY_NONE_TYPE);
+        }
+
+        bool infantry = rng.Range(0, 2) == 0;
+        FootClass* unit = static_cast<FootClass*>(Create_Object(infantry ? RTTI_INFANTRY : RTTI_UNIT));
+        unit->Set_Owner(side == 0 ? HOUSE_GREECE : HOUSE_USSR);
+        unit->Set_Coord(Cell_Coord(cell));
+        unit->Set_Speed(infantry ? 12 : 24);
+        unit->Set_Weapons(infantry ? WEAPON_M1_CARBINE : WEAPON_90MM);
+        army.units.push_back(unit);
+
+        SelectableObject& obj = army.selectable[i];
+        obj.id = static_cast<uint32_t>(i + 1);
+        obj.cell_x = x;
+        obj.cell_y = row;
+        obj.pixel_x = x * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2;
+        obj.pixel_y = row * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2;
+        obj.width = CELL_PIXEL_SIZE;
+        obj.height = CELL_PIXEL_SIZE;
+        obj.owner = unit->Get_Owner();
+        obj.type = 0;
+        obj.is_unit = true;
+        obj.is_active = true;
+        obj.rtti_type = infantry ? RTTI_INFANTRY : RTTI_UNIT;
+    }
+}
+
+// What the game's mission code would do with an order: drive there (on
+// the group's field if it has one) or take the target
+void Connect_Commands(Army& army) {
+    CommandSystem::Instance().SetAssignBatchCallback(
+        [&army](void* const* units, int count, MissionType mission, const CommandTarget& target) {
+            FootClass* victim = nullptr;
+            if (mission == MISSION_ATTACK) {
+                const SelectableObject* obj = static_cast<const SelectableObject*>(target.object);
+                victim = obj ? army.units[obj->id - 1] : nullptr;
+                if (victim == nullptr || !victim->Is_Active()) {
+                    return 0;
+                }
+            }
+            COORDINATE dest = Cell_Coord(XY_Cell(target.cell_x, target.cell_y));
+
+            int assigned = 0;
+            for (int i = 0; i < count; i++) {
+                const SelectableObject* obj = static_cast<const SelectableObject*>(units[i]);
+                FootClass* unit = army.units[obj->id - 1];
+                if (!unit->Is_Active()) continue;
+                if (mission == MISSION_ATTACK) {
+                    unit->Set_Target(victim);
+                } else if (target.flow_field) {
+                    unit->Follow_Flow_Field(target.flow_field, dest);
+                } else {
+                    unit->Set_Destination(dest);
+                }
+                assigned++;
+            }
+            return assigned;
+        });
+}
+
+// One tick's orders: groups of neighbours on either side either move
+// toward the front or attack an enemy
+int Issue_Orders(Army& army, StressRandom& rng, int orders) {
+    SelectionManager& selection = SelectionManager::Instance();
+    CommandSystem& commands = CommandSystem::Instance();
+    std::vector<SelectableObject*> group;
+    int issued = 0;
+
+    for (int order = 0; order < orders; order++) {
+        int side = rng.Range(0, 1);
+        int size = std::min(rng.Range(4, MAX_SELECTION), army.per_side);
+        int first = side * army.per_side + rng.Range(0, army.per_side - size);
+
+        // Dead units drop out of the records as the game would
+        group.clear();
+        for (int i = first; i < first + size; i++) {
+            army.selectable[i].is_active = army.units[i]->Is_Active();
+            group.push_back(&army.selectable[i]);
+        }
+        selection.SetPlayerHouse(side == 0 ? HOUSE_GREECE : HOUSE_USSR);
+        selection.SelectObjects(group.data(), static_cast<int>(group.size()));
+        if (!selection.HasSelection()) continue;
+
+        CommandResult result;
+        if (rng.Range(0, 9) < 6) {
+            int x = rng.Range(MAP_CELL_WIDTH / 2 - 20, MAP_CELL_WIDTH / 2 + 20);
+            int y = rng.Range(2, MAP_CELL_HEIGHT - 3);
+            result = commands.IssueMoveCommand(x * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2,
+                                               y * CELL_PIXEL_SIZE + CELL_PIXEL_SIZE / 2);
+        } else {
+            int enemy = (1 - side) * army.per_side + rng.Range(0, army.per_side - 1);
+            result = commands.IssueAttackCommand(&army.selectable[enemy]);
+        }
+        issued += result == CommandResult::SUCCESS ? 1 : 0;
+    }
+    selection.Clear();
+    return issued;
+}
+
+struct StressRow {
+    int objects = 0;
+    int ticks = 0;
+    int orders = 0;
+    uint32_t shots = 0;
+    double ms_per_tick[SUBSYSTEM_COUNT] = {};
+};
+
+// Spawn, then run ticks with orders before each and a frame after
+StressRow Run_Scenario(GameClass& game, int objects, int ticks, bool render) {
+    StressRandom rng(0x5EED0000u + static_cast<uint32_t>(objects));
+    StressRow row;
+    row.objects = objects;
+
+    DisplayClass display;
+    if (render) {
+        display.One_Time();
+        display.Init(THEATER_TEMPERATE);
+    } else {
+        display.Alloc_Cells();
+    }
+    MapClass* previous_map = Map;
+    Map = &display;
+
+    Generate_Map(display, rng);
+    Army army;
+    Spawn_Armies(display, objects, rng, army);
+    Connect_Commands(army);
+    if (render) {
+        display.Center_On(XY_Cell(MAP_CELL_WIDTH / 2, MAP_CELL_HEIGHT / 2));
+    }
+    int orders_per_tick = std::max(1, (objects + MAX_SELECTION * ORDER_PERIOD_TICKS - 1) /
+                                      (MAX_SELECTION * ORDER_PERIOD_TICKS));
+
+    Profiler& profiler = Profiler::instance();
+    profiler.reset();
+    CombatSystem::Instance().Reset_Stats();
+    for (int tick = 0; tick < ticks; tick++) {
+        profiler.begin_frame();
+        {
+            PROFILE_SCOPE("Input");
+            row.orders += Issue_Orders(army, rng, orders_per_tick);
+        }
+        game.Run_Ticks(1);
+        if (render) {
+            // A slow pan, so the terrain cache has edges to fill in
+            display.Scroll((tick / 40) % 2 ? -4 : 4, 1);
+            display.Render();
+        }
+        profiler.end_frame();
+        row.ticks++;
+    }
+
+    for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+        row.ms_per_tick[i] = profiler.get_stats(SUBSYSTEMS[i]).total_time_ms / std::max(ticks, 1);
+    }
+    row.shots = CombatSystem::Instance().Get_Stats().shots;
+
+    // Objects unmark their cells as they go, so free them before the map
+    CommandSystem::Instance().SetAssignBatchCallback(nullptr);
+    Destroy_All_Objects();
+    MovementSystem::Instance().Clear();
+    ProjectileSystem::Instance().Clear();
+    PathFinder::Instance().Invalidate();
+    FlowField::Flush_Cache();
+    Map = previous_map;
+    return row;
+}
+
+} // namespace
+
+//=============================================================================
+// Scenario Stress
+//=============================================================================
+
+TEST_WITH_FIXTURE(GraphicsFixture, Perf_Stress_Scenario, "Performance") {
+#if !PROFILER_ENABLED
+    TEST_SKIP("Profiler not built in");
+#endif
+    // Without a window the simulation still runs; the render columns stay empty
+    bool render = fixture.IsInitialized() && Platform_Graphics_IsInitialized();
+
+    JobSystem::Instance().Start();
+    AudioEvents_Init();
+    CommandSystem::Instance().Initialize();
+    SelectionManager::Instance().Initialize();
+
+    GameClass game;
+    game.Set_Player_House(HOUSE_GREECE);
+
+    int ticks = Tick_Count();
+    std::vector<StressRow> rows;
+    for (int objects : Object_Counts()) {
+        rows.push_back(Run_Scenario(game, objects, ticks, render));
+    }
+    JobSystem::Instance().Stop();
+
+    char msg[256];
+    snprintf(msg, sizeof(msg), "Scenario stress, %d ticks (ms per tick)%s:", ticks,
+             render ? "" : ", nothing drawn");
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    snprintf(msg, sizeof(msg), "%8s %8s %8s %9s %9s %8s %8s %8s",
+             "objects", "orders", "shots", "sim", "terrain", "objects", "audio", "input");
+    Platform_Log(LOG_LEVEL_INFO, msg);
+    for (const StressRow& row : rows) {
+        snprintf(msg, sizeof(msg), "%8d %8d %8u %9.3f %9.3f %8.3f %8.3f %8.3f",
+                 row.objects, row.orders, row.shots,
+                 row.ms_per_tick[0], row.ms_per_tick[1], row.ms_per_tick[2],
+                 row.ms_per_tick[3], row.ms_per_tick[4]);
+        Platform_Log(LOG_LEVEL_INFO, msg);
+
+        for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+            if (render || i == 0 || i >= 3) {
+                TEST_METRIC(std::string(SUBSYSTEMS[i]) + "/" + std::to_string(row.objects),
+                            row.ms_per_tick[i], "ms");
+            }
+        }
+    }
+
+    for (const StressRow& row : rows) {
+        TEST_ASSERT_EQ(row.ticks, ticks);
+        TEST_ASSERT_GT(row.orders, 0);
+        TEST_ASSERT_GT(row.ms_per_tick[0], 0.0);
+        if (render) {
+            TEST_ASSERT_GT(row.ms_per_tick[2], 0.0);
+        }
+    }
+}
@@ -359,6 +359,7 @@ TEST_CASE(Perf_Stress_MathOperations, "Performance") {
              "Math ops: %d iterations in %u ms (result=%.2f)",
              ITERATIONS, timer.ElapsedMs(), result);
     Platform_Log(LOG_LEVEL_INFO, msg);
+    TEST_METRIC("Elapsed", timer.ElapsedMs(), "ms");
 
     // Should complete quickly (< 1 second)
     TEST_ASSERT_LT(timer.ElapsedMs(), 1000u);
@@ -392,6 +393,7 @@ TEST_CASE(Perf_Stress_ArrayAccess, "Performance") {
              "Array access: %d iterations in %u ms (sum=%d)",
              ITERATIONS * ARRAY_SIZE, timer.ElapsedMs(), sum);
     Platform_Log(LOG_LEVEL_INFO, msg);
+    TEST_METRIC("Elapsed", timer.ElapsedMs(), "ms");
 
     // Should be very fast
     TEST_ASSERT_LT(timer.ElapsedMs(), 500u);
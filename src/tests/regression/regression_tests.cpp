@@ -4,6 +4,7 @@
 
 #include "test/test_framework.h"
 #include "test/bug_tracker.h"
+#include "test/perf_baseline.h"
 
 //=============================================================================
 // Regression Test Infrastructure
@@ -209,3 +210,76 @@ TEST_CASE(BugTracker_Statistics, "BugTracker") {
     TEST_ASSERT_EQ(category_breakdown[BugCategory::GRAPHICS], 1);
     TEST_ASSERT_EQ(category_breakdown[BugCategory::AUDIO], 1);
 }
+
+//=============================================================================
+// Performance Baselines
+//=============================================================================
+
+static PerfSeries Make_Series(const char* name, double center, double spread) {
+    PerfSeries series;
+    series.name = name;
+    series.unit = "ms";
+    for (int i = 0; i < 15; i++) {
+        series.samples.push_back(center + spread * ((i * 7) % 15 - 7) / 7.0);
+    }
+    return series;
+}
+
+TEST_CASE(PerfBaseline_BootstrapVerdicts, "BugTracker") {
+    std::vector<PerfSeries> baseline = {
+        Make_Series("Sim", 10.0, 0.5),
+        Make_Series("Render", 10.0, 0.5),
+        Make_Series("Audio", 10.0, 0.5),
+    };
+    std::vector<PerfSeries> current = {
+        Make_Series("Sim", 10.1, 0.5),      // Within noise
+        Make_Series("Render", 13.0, 0.5),   // 30% slower
+        Make_Series("Audio", 7.0, 0.5),     // 30% faster
+        Make_Series("Input", 1.0, 0.1),     // Not in the baseline
+    };
+
+    auto results = Perf_Compare(baseline, current, PerfCompareOptions());
+    TEST_ASSERT_EQ(results.size(), 4u);
+    TEST_ASSERT(results[0].verdict == PerfVerdict::UNCHANGED);
+    TEST_ASSERT(results[1].verdict == PerfVerdict::REGRESSED);
+    TEST_ASSERT(results[1].ci_low > 0.0);
+    TEST_ASSERT_NEAR(results[1].change, 0.3, 0.01);
+    TEST_ASSERT(results[2].verdict == PerfVerdict::IMPROVED);
+    TEST_ASSERT(results[3].verdict == PerfVerdict::NEW_METRIC);
+
+    // A rate going down is the regression
+    current[1].higher_is_better = true;
+    current[2].higher_is_better = true;
+    results = Perf_Compare(baseline, current, PerfCompareOptions());
+    TEST_ASSERT(results[1].verdict == PerfVerdict::IMPROVED);
+    TEST_ASSERT(results[2].verdict == PerfVerdict::REGRESSED);
+}
+
+TEST_CASE(PerfBaseline_RegressionFilesBug, "BugTracker") {
+    auto& tracker = RegressionTracker::instance();
+    auto& registry = BugRegistry::instance();
+    tracker.reset();
+    registry.reset();
+
+    std::vector<PerfSeries> baseline = {Make_Series("Test/Sim", 10.0, 0.5)};
+    std::vector<PerfSeries> current = {Make_Series("Test/Sim", 12.0, 0.5)};
+    auto results = Perf_Compare(baseline, current, PerfCompareOptions());
+    TEST_ASSERT_EQ(Perf_Record_Regressions(results, "host"), 1);
+
+    auto regressions = tracker.get_regressions();
+    TEST_ASSERT_EQ(regressions.size(), 1u);
+    const BugReport* bug = registry.get_bug(regressions[0]);
+    TEST_ASSERT_NOT_NULL(bug);
+    TEST_ASSERT(bug->category == BugCategory::PERFORMANCE);
+    TEST_ASSERT_EQ(bug->linked_test, "Test/Sim");
+
+    // Fixed, then slow again: the same bug is reopened and escalated
+    BugReport fixed = *bug;
+    fixed.status = BugStatus::FIXED;
+    registry.update_bug(regressions[0], fixed);
+    tracker.clear_regressions();
+    Perf_Record_Regressions(results, "host");
+    TEST_ASSERT_EQ(registry.get_total_count(), 1);
+    TEST_ASSERT(registry.get_bug(regressions[0])->status == BugStatus::NEW);
+    TEST_ASSERT(registry.get_bug(regressions[0])->priority == BugPriority::P0);
+}
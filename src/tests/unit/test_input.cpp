@@ -4,6 +4,8 @@
 
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
+#include "game/gadget.h"
+#include "game/gscreen.h"
 #include "platform.h"
 #include <cmath>
 
@@ -222,3 +224,76 @@ TEST_WITH_FIXTURE(PlatformFixture, Input_WasDoubleClicked_InitiallyFalse, "Input
     TEST_ASSERT(!Platform_Mouse_WasDoubleClicked(MOUSE_BUTTON_LEFT));
     TEST_ASSERT(!Platform_Mouse_WasDoubleClicked(MOUSE_BUTTON_RIGHT));
 }
+
+//=============================================================================
+// Gadget Tests
+//=============================================================================
+
+TEST_CASE(Input_Gadgets_HitTestAndRedraw, "Input") {
+    GScreenClass screen;
+    GadgetClass panel(0, 0, 200, 100, GADGET_NONE, 3);
+    ButtonClass ok(10, 10, 60, 20, "OK", 1);
+    ButtonClass cancel(100, 10, 60, 20, "Cancel", 2);
+    screen.Add_Gadget(&panel);
+    screen.Add_Gadget(&ok);
+    screen.Add_Gadget(&cancel);
+    screen.Draw_Gadgets();
+    TEST_ASSERT(!panel.Is_Dirty());
+    TEST_ASSERT(!ok.Is_Dirty());
+    TEST_ASSERT(!cancel.Is_Dirty());
+
+    // Hover goes to the topmost gadget, and only the hover change redraws
+    GadgetInput input = {};
+    input.mouse_x = 20;
+    input.mouse_y = 15;
+    screen.Process_Gadgets(input);
+    TEST_ASSERT(ok.Is_Hover());
+    TEST_ASSERT(!panel.Is_Hover());
+    TEST_ASSERT(!cancel.Is_Hover());
+    TEST_ASSERT(ok.Is_Dirty());
+    TEST_ASSERT(!panel.Is_Dirty());
+    TEST_ASSERT(!cancel.Is_Dirty());
+    screen.Draw_Gadgets();
+
+    // Press captures; release elsewhere cancels
+    input.left_press = true;
+    TEST_ASSERT_EQ(screen.Process_Gadgets(input), 0);
+    TEST_ASSERT(ok.Is_Pressed());
+    input.left_press = false;
+    input.left_release = true;
+    input.mouse_x = 120;
+    TEST_ASSERT_EQ(screen.Process_Gadgets(input), 0);
+    TEST_ASSERT(!ok.Is_Pressed());
+    TEST_ASSERT(cancel.Is_Hover());
+    TEST_ASSERT(!ok.Is_Hover());
+
+    // Click activates
+    input.left_release = false;
+    input.left_press = true;
+    screen.Process_Gadgets(input);
+    input.left_press = false;
+    input.left_release = true;
+    TEST_ASSERT_EQ(screen.Process_Gadgets(input), 2);
+
+    // Moved gadget is re-indexed
+    cancel.Set_Position(400, 300);
+    input.left_release = false;
+    input.mouse_x = 410;
+    input.mouse_y = 305;
+    screen.Process_Gadgets(input);
+    TEST_ASSERT(cancel.Is_Hover());
+
+    // A shown gadget is queued and then drawn
+    screen.Draw_Gadgets();
+    ok.Hide();
+    screen.Draw_Gadgets();
+    ok.Show();
+    TEST_ASSERT(ok.Is_Dirty());
+    screen.Draw_Gadgets();
+    TEST_ASSERT(!ok.Is_Dirty());
+
+    // Removed gadget loses its hover
+    screen.Remove_Gadget(&cancel);
+    TEST_ASSERT_EQ(screen.Process_Gadgets(input), 0);
+    TEST_ASSERT(!cancel.Is_Hover());
+}
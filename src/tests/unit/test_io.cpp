@@ -0,0 +1,404 @@
+// src/tests/unit/test_io.cpp
+// Pipe/Straw, LZO, INI and Save Game Unit Tests
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "map_fixture.h"
+#include "game/io/lzo.h"
+#include "game/io/lzo_pipe.h"
+#include "game/io/pipe.h"
+#include "game/io/straw.h"
+#include "game/fixed.h"
+#include "game/graphics/shape_renderer.h"
+#include "game/ini.h"
+#include "game/saveload.h"
+#include "game/vision_map.h"
+#include "game/types/type_tables.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Mix of runs, repeats far and near, and noise
+std::vector<uint8_t> Make_Test_Data(size_t size) {
+    std::vector<uint8_t> data(size);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        switch ((i / 700) % 4) {
+            case 0: data[i] = static_cast<uint8_t>(seed >> 16); break;
+            case 1: data[i] = 0x55; break;
+            case 2: data[i] = static_cast<uint8_t>(i % 13); break;
+            default: data[i] = i >= 20000 ? data[i - 20000] : static_cast<uint8_t>(i); break;
+        }
+    }
+    return data;
+}
+
+bool LZO_Round_Trip(const std::vector<uint8_t>& data) {
+    std::vector<uint32_t> dict(LZO_DICT_SIZE);
+    std::vector<uint8_t> packed(LZO_Max_Compressed_Size(static_cast<int>(data.size())));
+    int size = LZO_Compress(data.data(), static_cast<int>(data.size()), packed.data(), dict.data());
+    if (size <= 0 || size > static_cast<int>(packed.size())) {
+        return false;
+    }
+
+    std::vector<uint8_t> unpacked(data.size() + 1);
+    int count = LZO_Decompress(packed.data(), size, unpacked.data(), static_cast<int>(data.size()));
+    return count == static_cast<int>(data.size()) &&
+           std::equal(data.begin(), data.end(), unpacked.begin());
+}
+
+/// Puts the type tables back after tests that patch them with rules
+class TypeRulesFixture : public TestFixture {
+public:
+    void TearDown() override { Reset_Type_Rules(); }
+};
+
+} // namespace
+
+//=============================================================================
+// LZO Codec Tests
+//=============================================================================
+
+TEST_CASE(IO_LZO_RoundTrip, "IO") {
+    const size_t sizes[] = { 0, 1, 5, 13, 14, 100, 238, 239, 4096, 50000 };
+    for (size_t size : sizes) {
+        TEST_ASSERT(LZO_Round_Trip(Make_Test_Data(size)));
+    }
+
+    std::vector<uint8_t> zeros(70000, 0);
+    TEST_ASSERT(LZO_Round_Trip(zeros));
+}
+
+TEST_CASE(IO_LZO_Compresses_Runs, "IO") {
+    std::vector<uint8_t> data(8192, 0xAA);
+    std::vector<uint32_t> dict(LZO_DICT_SIZE);
+    std::vector<uint8_t> packed(LZO_Max_Compressed_Size(8192));
+    int size = LZO_Compress(data.data(), 8192, packed.data(), dict.data());
+    TEST_ASSERT_LT(size, 100);
+}
+
+TEST_CASE(IO_LZO_Rejects_Bad_Data, "IO") {
+    std::vector<uint8_t> data = Make_Test_Data(4096);
+    std::vector<uint32_t> dict(LZO_DICT_SIZE);
+    std::vector<uint8_t> packed(LZO_Max_Compressed_Size(4096));
+    int size = LZO_Compress(data.data(), 4096, packed.data(), dict.data());
+
+    std::vector<uint8_t> out(4096);
+    TEST_ASSERT_EQ(LZO_Decompress(packed.data(), size - 1, out.data(), 4096), -1);
+    TEST_ASSERT_EQ(LZO_Decompress(packed.data(), size, out.data(), 4095), -1);
+
+    // Garbage must fail or stay inside the buffer, never crash
+    uint32_t seed = 99;
+    for (int trial = 0; trial < 200; trial++) {
+        std::vector<uint8_t> garbage(packed.begin(), packed.begin() + size);
+        for (int i = 0; i < 8; i++) {
+            seed = seed * 1103515245 + 12345;
+            garbage[(seed >> 8) % garbage.size()] = static_cast<uint8_t>(seed >> 24);
+        }
+        int count = LZO_Decompress(garbage.data(), size, out.data(), 4096);
+        TEST_ASSERT(count >= -1 && count <= 4096);
+    }
+}
+
+//=============================================================================
+// Stream Stage Tests
+//=============================================================================
+
+TEST_CASE(IO_LZOPipe_RoundTrip, "IO") {
+    std::vector<uint8_t> data = Make_Test_Data(100000);
+
+    BufferPipe packed;
+    LZOPipe compress(LZOPipe::COMPRESS, 4096);
+    compress.Put_To(packed);
+    for (size_t pos = 0; pos < data.size(); pos += 777) {
+        compress.Put(&data[pos], static_cast<int>(std::min<size_t>(777, data.size() - pos)));
+    }
+    compress.End();
+    TEST_ASSERT_LT(packed.GetData().size(), data.size());
+
+    // Feed back in pieces that straddle block headers
+    BufferPipe unpacked;
+    LZOPipe decompress(LZOPipe::DECOMPRESS);
+    decompress.Put_To(unpacked);
+    const std::vector<uint8_t>& bytes = packed.GetData();
+    for (size_t pos = 0; pos < bytes.size(); pos += 3) {
+        decompress.Put(&bytes[pos], static_cast<int>(std::min<size_t>(3, bytes.size() - pos)));
+    }
+    decompress.End();
+
+    TEST_ASSERT(!decompress.HasError());
+    TEST_ASSERT(unpacked.GetData() == data);
+}
+
+TEST_CASE(IO_LZOStraw_RoundTrip, "IO") {
+    std::vector<uint8_t> data = Make_Test_Data(30000);
+
+    BufferStraw source(data.data(), data.size());
+    LZOStraw compress(LZOStraw::COMPRESS, 5000);
+    compress.Get_From(source);
+    std::vector<uint8_t> packed;
+    uint8_t chunk[1000];
+    int count;
+    while ((count = compress.Get(chunk, sizeof(chunk))) > 0) {
+        packed.insert(packed.end(), chunk, chunk + count);
+    }
+
+    BufferStraw packed_source(packed.data(), packed.size());
+    LZOStraw decompress(LZOStraw::DECOMPRESS);
+    decompress.Get_From(packed_source);
+    std::vector<uint8_t> unpacked(data.size() + 10);
+    int first = decompress.Get(unpacked.data(), 123);
+    int rest = decompress.Get(unpacked.data() + first, static_cast<int>(unpacked.size()) - first);
+
+    TEST_ASSERT_EQ(first, 123);
+    TEST_ASSERT_EQ(first + rest, static_cast<int>(data.size()));
+    TEST_ASSERT(!decompress.HasError());
+    TEST_ASSERT(std::equal(data.begin(), data.end(), unpacked.begin()));
+}
+
+TEST_CASE(IO_LZOStraw_Detects_Truncation, "IO") {
+    std::vector<uint8_t> data = Make_Test_Data(10000);
+    BufferPipe packed;
+    LZOPipe compress(LZOPipe::COMPRESS);
+    compress.Put_To(packed);
+    compress.Put(data.data(), static_cast<int>(data.size()));
+    compress.End();
+
+    const std::vector<uint8_t>& bytes = packed.GetData();
+    BufferStraw source(bytes.data(), bytes.size() - 5);
+    LZOStraw decompress(LZOStraw::DECOMPRESS);
+    decompress.Get_From(source);
+    std::vector<uint8_t> out(data.size());
+    int count = decompress.Get(out.data(), static_cast<int>(out.size()));
+
+    TEST_ASSERT_LT(count, static_cast<int>(data.size()));
+    TEST_ASSERT(decompress.HasError());
+}
+
+TEST_CASE(IO_Pipe_Chain_Survives_Stage_Destruction, "IO") {
+    BufferPipe sink;
+    Pipe head;
+    {
+        Pipe middle;
+        head.Put_To(middle);
+        middle.Put_To(sink);
+    }
+    const char text[] = "abc";
+    TEST_ASSERT_EQ(head.Put(text, 3), 3);
+    TEST_ASSERT_EQ(sink.GetData().size(), 3u);
+}
+
+//=============================================================================
+// INI Tests
+//=============================================================================
+
+TEST_CASE(IO_INI_Parse, "IO") {
+    const char text[] =
+        "; leading comment\n"
+        "[General]\n"
+        "RepairPercent = 25%   ; trailing comment\n"
+        "Gravity=0.5\n"
+        "Count=$1F\r\n"
+        "Negative=-12\n"
+        "Flag=yes\n"
+        "Off=false\n"
+        "\n"
+        "[MTNK]\n"
+        "Cost=800\n"
+        "Cost=900\n"
+        "Name=Medium Tank\n"
+        "[general]\n"
+        "Extra=1\n"
+        "orphan line\n";
+
+    INIClass ini;
+    TEST_ASSERT(ini.Load(text, sizeof(text) - 1));
+
+    // Duplicate sections merge, case-insensitively, keeping file order
+    TEST_ASSERT_EQ(ini.Section_Count(), 2);
+    TEST_ASSERT(ini.Is_Present("GENERAL"));
+    TEST_ASSERT(ini.Is_Present("mtnk"));
+    TEST_ASSERT_EQ(ini.Entry_Count("General"), 7);
+    TEST_ASSERT_EQ(ini.Get_Entry("General", 0), "RepairPercent");
+    TEST_ASSERT_EQ(ini.Get_Entry("General", 6), "Extra");
+
+    // Duplicate entry keeps the last value
+    TEST_ASSERT_EQ(ini.Get_Int("MTNK", "Cost"), 900);
+    TEST_ASSERT_EQ(ini.Entry_Count("MTNK"), 2);
+    TEST_ASSERT_EQ(ini.Get_String("mtnk", "name"), "Medium Tank");
+    TEST_ASSERT(!ini.Is_Present("MTNK", "Speed"));
+    TEST_ASSERT_EQ(ini.Get_Int("MTNK", "Speed", 7), 7);
+
+    TEST_ASSERT_EQ(ini.Get_Int("General", "Count"), 0x1F);
+    TEST_ASSERT_EQ(ini.Get_Int("General", "Negative"), -12);
+    TEST_ASSERT(ini.Get_Bool("General", "Flag"));
+    TEST_ASSERT(!ini.Get_Bool("General", "Off", true));
+    TEST_ASSERT(ini.Get_Bool("MTNK", "Name", true));        // Non-bool gives default
+    TEST_ASSERT(ini.Get_Fixed("General", "RepairPercent") == fixed::Ratio(1, 4));
+    TEST_ASSERT(ini.Get_Fixed("General", "Gravity") == fixed::Ratio(1, 2));
+
+    // Text without a section is rejected
+    TEST_ASSERT(!ini.Load("Key=Value\n", 10));
+    TEST_ASSERT_EQ(ini.Section_Count(), 0);
+}
+
+TEST_CASE(IO_INI_IndexGrows, "IO") {
+    // Many entries force the index to grow
+    std::string big = "[Big]\n";
+    for (int i = 0; i < 1000; i++) {
+        big += "Key" + std::to_string(i) + "=" + std::to_string(i * 3) + "\n";
+    }
+    INIClass ini;
+    ini.Load(big.data(), big.size());
+    TEST_ASSERT_EQ(ini.Entry_Count("Big"), 1000);
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQ(ini.Get_Int("Big", "KEY" + std::to_string(i), -1), i * 3);
+    }
+}
+
+//=============================================================================
+// Type Table Tests
+//=============================================================================
+
+TEST_CASE(IO_TypeTables_FromName, "IO") {
+    TEST_ASSERT_EQ(Unit_Type_From_Name("MTNK"), UNIT_MTNK);
+    TEST_ASSERT_EQ(Unit_Type_From_Name("htnk"), UNIT_HTNK);
+    TEST_ASSERT_EQ(Unit_Type_From_Name("XXXX"), UNIT_NONE);
+    TEST_ASSERT_EQ(Unit_Type_From_Name(""), UNIT_NONE);
+    TEST_ASSERT_EQ(Building_Type_From_Name("FACT"), BUILDING_FACT);
+    TEST_ASSERT_EQ(Building_Type_From_Name("NOPE"), BUILDING_NONE);
+
+    // Every building type resolves by name
+    for (int i = 0; i < BUILDING_COUNT; i++) {
+        TEST_ASSERT_EQ(Building_Type_From_Name(BUILDING_TYPE_TABLE[i].name), i);
+        TEST_ASSERT_EQ(BuildingTypes[i].Get_Type_Index(), i);
+    }
+}
+
+TEST_CASE(IO_TypeTables_Defaults, "IO") {
+    TEST_ASSERT(BuildingTypes[BUILDING_TSLA].Is_Defense());
+    TEST_ASSERT_EQ(BuildingTypes[BUILDING_TSLA].Get_Power(), -150);
+    TEST_ASSERT(!UnitTypes[UNIT_JEEP].Is_Tracked());
+
+    // Occupy list from footprint
+    TEST_ASSERT_EQ(Building_Occupy(BUILDING_FACT).count, 9);
+    TEST_ASSERT_EQ(Building_Occupy(BUILDING_SAM).count, 2);
+    TEST_ASSERT_EQ(Building_Occupy(BUILDING_SAM).cells[1].x, 1);
+}
+
+TEST_WITH_FIXTURE(TypeRulesFixture, IO_TypeTables_RulesPatch, "IO") {
+    const char rules_text[] =
+        "[MTNK]\n"
+        "Cost=900\n"
+        "Armor=light\n"
+        "[powr]\n"
+        "Power=150\n";
+    INIClass rules;
+    rules.Load(rules_text, sizeof(rules_text) - 1);
+    TEST_ASSERT_EQ(Apply_Type_Rules(rules), 2);
+
+    // Only the given entries change
+    TEST_ASSERT_EQ(UnitTypes[UNIT_MTNK].Get_Cost(), 900);
+    TEST_ASSERT_EQ(UnitTypes[UNIT_MTNK].Get_Armor(), ARMOR_LIGHT);
+    TEST_ASSERT_EQ(BuildingTypes[BUILDING_POWR].Get_Power(), 150);
+    TEST_ASSERT_EQ(UnitTypes[UNIT_MTNK].Get_Max_Strength(), 400);
+    TEST_ASSERT_EQ(UnitTypes[UNIT_LTNK].Get_Cost(), 600);
+
+    Reset_Type_Rules();
+    TEST_ASSERT_EQ(UnitTypes[UNIT_MTNK].Get_Cost(), 800);
+    TEST_ASSERT_EQ(UnitTypes[UNIT_MTNK].Get_Type_Index(), UNIT_MTNK);
+    TEST_ASSERT_EQ(BuildingTypes[BUILDING_POWR].Get_Power(), 100);
+}
+
+//=============================================================================
+// Save Game Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, IO_SaveLoad_RoundTrip, "IO") {
+    MapClass& map = fixture.map;
+    map.Set_Map_Bounds(4, 6, 50, 40);
+    map[XY_Cell(10, 12)].Set_Overlay(OVERLAY_GOLD1, 3);
+    map[XY_Cell(11, 12)].Set_Template(9, 2);
+    map.Sync_All_Layers();
+
+    FootClass* tank = Place_Unit(20, 20, HOUSE_USSR);
+    tank->Set_Strength(300);
+    tank->Set_Weapons(WEAPON_120MM);
+    tank->Body_Facing().Set(DIR_E);
+    tank->Set_Speed(12);
+    tank->Select();
+    TechnoClass* yard = static_cast<TechnoClass*>(Create_Object(RTTI_BUILDING));
+    yard->Set_Owner(HOUSE_GREECE);
+    yard->Set_Coord(Cell_Coord(XY_Cell(24, 20)));
+    tank->Set_Target(yard);
+    map.Update_Vision(HOUSE_USSR);
+
+    ProjectileSystem& shots = ProjectileSystem::Instance();
+    ShapeId ball = ShapeCache::Instance().Register("FB1.SHP");
+    shots.Fire(ball, 2, tank->Get_Coord(), yard->Get_Coord(), 30, ball, 5);
+
+    BufferPipe saved;
+    TEST_ASSERT(SaveLoad::Save(saved, map));
+    SaveHeader header;
+    memcpy(&header, saved.GetData().data(), sizeof(header));
+    TEST_ASSERT_EQ(header.magic, SAVE_MAGIC);
+    TEST_ASSERT_EQ(header.version, SAVE_VERSION);
+    TEST_ASSERT_EQ(header.object_count, 2u);
+    TEST_ASSERT_LT(saved.GetData().size(), header.body_size / 4);     // Compressed
+
+    // Damaged data is rejected before the world is touched
+    std::vector<uint8_t> cut(saved.GetData().begin(), saved.GetData().end() - 16);
+    BufferStraw cut_straw(cut.data(), cut.size());
+    TEST_ASSERT(!SaveLoad::Load(cut_straw, map));
+    TEST_ASSERT_EQ(Object_Count(), 2);
+    TEST_ASSERT_EQ(shots.Count(), 1);
+
+    Destroy_All_Objects();
+    shots.Clear();
+    map.Clear_Map();
+    BufferStraw straw(saved.GetData().data(), saved.GetData().size());
+    TEST_ASSERT(SaveLoad::Load(straw, map));
+
+    // Map and explored cells restored
+    TEST_ASSERT_EQ(map.Map_Bounds_X(), 4);
+    TEST_ASSERT_EQ(map.Map_Bounds_Height(), 40);
+    TEST_ASSERT_EQ(map[XY_Cell(10, 12)].Get_Overlay(), OVERLAY_GOLD1);
+    TEST_ASSERT_EQ(map[XY_Cell(10, 12)].Get_Overlay_Data(), 3);
+    TEST_ASSERT_EQ(map[XY_Cell(11, 12)].Get_Template(), 9);
+    TEST_ASSERT_EQ(map[XY_Cell(11, 12)].Get_Icon(), 2);
+    TEST_ASSERT(map.Get_Vision()->Is_Explored(HOUSE_USSR, 20, 20));
+    TEST_ASSERT(map[XY_Cell(20, 20)].Is_Visible());
+
+    // Objects restored with their state, links and occupancy
+    TEST_ASSERT_EQ(Object_Heap(RTTI_UNIT)->Count(), 1);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_BUILDING)->Count(), 1);
+    FootClass* loaded = static_cast<FootClass*>(Object_Heap(RTTI_UNIT)->Active(0));
+    TEST_ASSERT_EQ(loaded->Get_Owner(), HOUSE_USSR);
+    TEST_ASSERT_EQ(loaded->Get_Strength(), 300);
+    TEST_ASSERT_EQ(loaded->Get_Cell(), XY_Cell(20, 20));
+    TEST_ASSERT_EQ(loaded->Get_Facing(), DIR_E);
+    TEST_ASSERT_EQ(loaded->Get_Speed(), 12);
+    TEST_ASSERT(loaded->Is_Selected());
+    TEST_ASSERT_EQ(loaded->Get_Primary_Weapon(), WEAPON_120MM);
+    TEST_ASSERT(loaded->Get_Target() == Object_Heap(RTTI_BUILDING)->Active(0));
+    TEST_ASSERT(map[XY_Cell(24, 20)].Is_Occupied());
+
+    // Projectiles restored
+    TEST_ASSERT_EQ(shots.Count(), 1);
+    TEST_ASSERT_EQ(shots.Get_Shape(0), ball);
+    TEST_ASSERT_EQ(shots.Get_Frame(0), 2);
+    TEST_ASSERT(shots.Get_Layer(0) == RenderLayer::PROJECTILE);
+
+    // The same world through a save file
+    TEST_ASSERT(SaveLoad::Save_Game("./TEST.SAV", map));
+    Destroy_All_Objects();
+    bool from_file = SaveLoad::Load_Game("./TEST.SAV", map);
+    remove("./TEST.SAV");
+    TEST_ASSERT(from_file);
+    TEST_ASSERT_EQ(Object_Count(), 2);
+}
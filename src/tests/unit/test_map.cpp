@@ -0,0 +1,600 @@
+// src/tests/unit/test_map.cpp
+// Map Layer Unit Tests
+
+#include "test/test_framework.h"
+#include "map_fixture.h"
+#include "game/cell.h"
+#include "game/map.h"
+#include "game/build_map.h"
+#include "game/chunked_grid.h"
+#include "game/findpath.h"
+#include "game/flow_field.h"
+#include "game/tiberium.h"
+#include "game/vision_map.h"
+#include "game/zone_map.h"
+#include "game/movement.h"
+#include "game/spatial_grid.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+//=============================================================================
+// Change Tracking Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_ChangeTracking, "Map") {
+    // No cell array needed for the bitmap
+    MapClass bare;
+    TEST_ASSERT(!bare.Has_Changed_Cells());
+
+    MapClass& map = fixture.map;
+    map.Clear_Changed_Cells();
+    CellClass& cell = map[XY_Cell(10, 20)];
+    cell.Set_Template(7, 1);
+    TEST_ASSERT(map.Is_Cell_Changed(XY_Cell(10, 20)));
+    TEST_ASSERT(!map.Is_Cell_Changed(11, 20));
+    map.Clear_Changed_Cells();
+    TEST_ASSERT(!map.Is_Cell_Changed(10, 20));
+    TEST_ASSERT(!map.Has_Changed_Cells());
+
+    cell.Reveal(true);
+    TEST_ASSERT(map.Is_Cell_Changed(10, 20));
+    map.Clear_Changed_Cells();
+    cell.Reveal(true);
+    TEST_ASSERT(!map.Has_Changed_Cells());
+
+    map.Flag_All_Cells_Changed();
+    TEST_ASSERT(map.Is_Cell_Changed(127, 127));
+    TEST_ASSERT(map.Is_Cell_Changed(0, 0));
+}
+
+//=============================================================================
+// Path Finding Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_PathFinding_Hierarchical, "Map") {
+    MapClass& map = fixture.map;
+    // Wall down the middle with a gap at the bottom
+    Build_Wall(map, 64, 1, 120);
+
+    std::vector<CELL> path;
+    PathFinder& finder = PathFinder::Instance();
+    finder.Reset_Stats();
+    TEST_ASSERT(finder.Find_Path(XY_Cell(10, 10), XY_Cell(14, 10), LOCO_TRACK, path));
+    TEST_ASSERT_EQ(path.size(), 4u);
+    TEST_ASSERT_EQ(path.back(), XY_Cell(14, 10));
+    TEST_ASSERT_GT(finder.Graph_Node_Count(LOCO_TRACK), 0);
+
+    // Long path goes round the wall
+    TEST_ASSERT(finder.Find_Path(XY_Cell(10, 10), XY_Cell(100, 10), LOCO_TRACK, path));
+    TEST_ASSERT_EQ(path.back(), XY_Cell(100, 10));
+    bool through_gap = false;
+    bool hits_wall = false;
+    for (CELL step : path) {
+        through_gap |= Cell_X(step) == 64 && Cell_Y(step) >= 120;
+        hits_wall |= !map[step].Is_Passable();
+    }
+    TEST_ASSERT(through_gap);
+    TEST_ASSERT(!hits_wall);
+
+    // Infantry crosses walls
+    TEST_ASSERT(finder.Find_Path(XY_Cell(10, 10), XY_Cell(100, 10), LOCO_FOOT, path));
+    TEST_ASSERT_LT(path.size(), 100u);
+    TEST_ASSERT(!finder.Find_Path(XY_Cell(10, 10), XY_Cell(64, 10), LOCO_TRACK, path));
+
+    // The long path above already planned this cluster pair, so the whole
+    // group move reuses one route
+    finder.Reset_Stats();
+    for (int i = 0; i < 50; i++) {
+        finder.Find_Path(XY_Cell(4 + i % 10, 4 + i / 10), XY_Cell(100, 10), LOCO_TRACK, path);
+    }
+    TEST_ASSERT_EQ(finder.Get_Stats().cache_misses, 0u);
+    TEST_ASSERT_EQ(finder.Get_Stats().cache_hits, 50u);
+
+    // Land change drops cached routes
+    map[XY_Cell(64, 122)].Set_Overlay(OVERLAY_BRICK, 0);
+    finder.Find_Path(XY_Cell(10, 10), XY_Cell(100, 10), LOCO_TRACK, path);
+    TEST_ASSERT_EQ(finder.Get_Stats().cache_misses, 1u);
+
+    // Unit drives the found path
+    FootClass* unit = Place_Unit(60, 60);
+    unit->Set_Speed(128);
+    unit->Set_Destination(Cell_Coord(XY_Cell(68, 60)));
+    for (int i = 0; i < 2000 && unit->Is_Moving(); i++) {
+        MovementSystem::Instance().Update();
+    }
+    TEST_ASSERT_EQ(unit->Get_Coord(), Cell_Coord(XY_Cell(68, 60)));
+}
+
+//=============================================================================
+// Flow Field Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_FlowField_GroupMove, "Map") {
+    MapClass& map = fixture.map;
+    Build_Wall(map, 64, 1, 120);
+
+    std::shared_ptr<const FlowField> field = FlowField::Acquire(XY_Cell(100, 10), LOCO_TRACK);
+    TEST_ASSERT_NOT_NULL(field);
+    TEST_ASSERT(FlowField::Acquire(XY_Cell(100, 10), LOCO_TRACK) == field);
+    TEST_ASSERT_EQ(field->Next_Direction(XY_Cell(100, 10)), FlowField::NO_FLOW);
+    TEST_ASSERT(!field->Is_Reachable(XY_Cell(64, 10)));
+    TEST_ASSERT_NULL(FlowField::Acquire(XY_Cell(64, 10), LOCO_TRACK));
+
+    // Whole group traces to the target through the gap
+    std::vector<CELL> cells;
+    bool all_reach = true;
+    bool through_gap = false;
+    for (int i = 0; i < 50; i++) {
+        all_reach &= field->Trace(XY_Cell(4 + i % 10, 4 + i / 10), cells) &&
+                     cells.back() == XY_Cell(100, 10);
+        for (CELL step : cells) {
+            through_gap |= Cell_X(step) == 64 && Cell_Y(step) >= 120;
+        }
+    }
+    TEST_ASSERT(all_reach);
+    TEST_ASSERT(through_gap);
+
+    // Land change stales the field and the next acquire rebuilds it
+    map[XY_Cell(64, 122)].Set_Overlay(OVERLAY_BRICK, 0);
+    TEST_ASSERT(!field->Is_Current());
+    TEST_ASSERT(FlowField::Acquire(XY_Cell(100, 10), LOCO_TRACK) != field);
+
+    // Unit follows the field
+    FootClass* unit = Place_Unit(60, 60);
+    unit->Set_Speed(128);
+    unit->Follow_Flow_Field(FlowField::Acquire(XY_Cell(68, 60), LOCO_TRACK), Cell_Coord(XY_Cell(68, 60)));
+    for (int i = 0; i < 2000 && unit->Is_Moving(); i++) {
+        MovementSystem::Instance().Update();
+    }
+    TEST_ASSERT_EQ(unit->Get_Coord(), Cell_Coord(XY_Cell(68, 60)));
+}
+
+//=============================================================================
+// Zone Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_Zones_Connectivity, "Map") {
+    MapClass& map = fixture.map;
+    const ZoneMap* zones = map.Get_Zones();
+    TEST_ASSERT_NOT_NULL(zones);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 1);
+
+    // Wall the whole height of the map
+    Build_Wall(map, 64, 1, 127);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 2);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_FOOT), 1);
+    TEST_ASSERT(!zones->Can_Reach(LOCO_TRACK, XY_Cell(10, 10), XY_Cell(100, 10)));
+    TEST_ASSERT(zones->Can_Reach(LOCO_TRACK, XY_Cell(10, 10), XY_Cell(10, 100)));
+
+    // No search across the wall
+    std::vector<CELL> path;
+    PathFinder& finder = PathFinder::Instance();
+    finder.Reset_Stats();
+    TEST_ASSERT(!finder.Find_Path(XY_Cell(10, 10), XY_Cell(100, 10), LOCO_TRACK, path));
+    TEST_ASSERT_EQ(finder.Get_Stats().unreachable, 1u);
+    TEST_ASSERT_EQ(finder.Get_Stats().cells_expanded, 0u);
+
+    // A gap joins the zones and closing it splits them again
+    map[XY_Cell(64, 50)].Set_Overlay(OVERLAY_NONE_TYPE, 0);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 1);
+    TEST_ASSERT(zones->Can_Reach(LOCO_TRACK, XY_Cell(10, 10), XY_Cell(100, 10)));
+    map[XY_Cell(64, 50)].Set_Overlay(OVERLAY_BRICK, 0);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 2);
+    TEST_ASSERT(!zones->Can_Reach(LOCO_TRACK, XY_Cell(10, 10), XY_Cell(100, 10)));
+
+    // Lone wall needs no flood
+    uint32_t relabelled = zones->Get_Relabelled();
+    map[XY_Cell(20, 20)].Set_Overlay(OVERLAY_BRICK, 0);
+    TEST_ASSERT_EQ(zones->Get_Relabelled(), relabelled);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 2);
+    TEST_ASSERT(zones->Can_Reach(LOCO_TRACK, XY_Cell(20, 20), XY_Cell(10, 10)));    // Blocked start steps off
+
+    map.Set_Map_Bounds(1, 1, 60, 60);
+    TEST_ASSERT_EQ(zones->Zone_Count(LOCO_TRACK), 1);
+    TEST_ASSERT_EQ(zones->Get_Zone(LOCO_TRACK, 100, 10), ZoneMap::NO_ZONE);
+}
+
+//=============================================================================
+// Objects In Radius Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_ObjectsInRadius, "Map") {
+    MapClass& map = fixture.map;
+    ObjectClass* center = Place_Unit(20, 20);
+    ObjectClass* near_obj = Place_Unit(22, 20);
+    ObjectClass* far_obj = Place_Unit(60, 20);
+    TEST_ASSERT(map[XY_Cell(22, 20)].Get_First_Object() == near_obj);
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(20, 20), 2);
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(60, 20), 1);
+
+    std::vector<ObjectClass*> found;
+    TEST_ASSERT_EQ(map.Objects_In_Radius(center->Get_Coord(), 3 * LEPTON_PER_CELL, found), 2);
+    TEST_ASSERT_EQ(std::count(found.begin(), found.end(), near_obj), 1);
+    TEST_ASSERT_EQ(std::count(found.begin(), found.end(), far_obj), 0);
+    found.clear();
+    map.Objects_In_Radius(center->Get_Coord(), 3 * LEPTON_PER_CELL, found,
+        [center](const ObjectClass* obj) { return obj != center; });
+    TEST_ASSERT_EQ(found.size(), 1u);
+    TEST_ASSERT(found[0] == near_obj);
+
+    // Moving updates the cell lists and the blocks
+    near_obj->Set_Coord(Cell_Coord(XY_Cell(61, 20)));
+    TEST_ASSERT_NULL(map[XY_Cell(22, 20)].Get_First_Object());
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(20, 20), 1);
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(60, 20), 2);
+
+    // A full cell spills over without hiding anyone from queries
+    for (int i = 0; i < CELL_MAX_OBJECTS + 2; i++) {
+        Create_Object(RTTI_INFANTRY)->Set_Coord(Cell_Coord(XY_Cell(90, 90)));
+    }
+    found.clear();
+    TEST_ASSERT_EQ(map.Objects_In_Radius(Cell_Coord(XY_Cell(90, 90)), 0, found), CELL_MAX_OBJECTS + 2);
+
+    Destroy_All_Objects();
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(20, 20), 0);
+    TEST_ASSERT_EQ(map.Get_Block_Occupancy(90, 90), 0);
+}
+
+//=============================================================================
+// Cell Occupancy Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_Cell_Occupancy, "Map") {
+    CELL cell = XY_Cell(30, 30);
+    CellClass& target = fixture.map[cell];
+    TEST_ASSERT_EQ(CellClass::Coord_Spot(Cell_Coord(cell)), SPOT_CENTER);
+    TEST_ASSERT_EQ(CellClass::Coord_Spot(CellClass::Spot_Coord(cell, SPOT_SE)), SPOT_SE);
+
+    // Infantry take their spots
+    ObjectClass* rifle = Create_Object(RTTI_INFANTRY);
+    rifle->Set_Coord(CellClass::Spot_Coord(cell, SPOT_NW));
+    ObjectClass* medic = Create_Object(RTTI_INFANTRY);
+    medic->Set_Coord(CellClass::Spot_Coord(cell, SPOT_CENTER));
+    TEST_ASSERT_EQ(target.Get_Occupancy(), (OCCUPY_NW | OCCUPY_CENTER));
+    TEST_ASSERT_EQ(target.Object_Count(), 2);
+    TEST_ASSERT(target.Find_Techno() == static_cast<TechnoClass*>(rifle));
+    TEST_ASSERT(target.Is_Clear_To_Enter(true));
+    TEST_ASSERT(!target.Is_Clear_To_Enter(false));
+    TEST_ASSERT(!target.Is_Clear_To_Build());
+    TEST_ASSERT_EQ(target.Closest_Free_Spot(CellClass::Spot_Coord(cell, SPOT_NE)), SPOT_NE);
+    TEST_ASSERT_NE(target.Closest_Free_Spot(Cell_Coord(cell)), SPOT_CENTER);
+
+    // Leaving clears the spot
+    rifle->Set_Coord(Cell_Coord(XY_Cell(31, 30)));
+    TEST_ASSERT_EQ(target.Get_Occupancy(), OCCUPY_CENTER);
+    TEST_ASSERT(target.Find_Techno() == static_cast<TechnoClass*>(medic));
+
+    // A vehicle blocks infantry
+    ObjectClass* tank = Create_Object(RTTI_UNIT);
+    tank->Set_Coord(CellClass::Spot_Coord(cell, SPOT_SE));
+    TEST_ASSERT(target.Get_Occupancy() & OCCUPY_VEHICLE);
+    TEST_ASSERT(!target.Is_Clear_To_Enter(true));
+    TEST_ASSERT_EQ(target.Closest_Free_Spot(Cell_Coord(cell)), SPOT_NONE);
+
+    Destroy_All_Objects();
+    TEST_ASSERT_EQ(target.Get_Occupancy(), 0);
+    TEST_ASSERT_NULL(target.Find_Techno());
+    TEST_ASSERT(target.Is_Clear_To_Build());
+    TEST_ASSERT(!target.Is_Occupied());
+}
+
+//=============================================================================
+// Build Map Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_BuildMap_Placement, "Map") {
+    BuildMap& build = *fixture.map.Get_Build_Map();
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 23, 20));     // Nothing to build next to
+
+    build.Building_Added(HOUSE_GREECE, BUILDING_FACT, XY_Cell(20, 20));
+    build.Building_Added(HOUSE_GREECE, BUILDING_SILO, XY_Cell(62, 40));     // Across a word edge
+    TEST_ASSERT(!build.Is_Free(22, 22));
+    TEST_ASSERT(build.Is_Free(23, 22));
+    TEST_ASSERT(build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 23, 20));
+    TEST_ASSERT(build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 18, 18));
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 24, 20));     // Too far
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 21, 21));     // Overlapping
+    TEST_ASSERT(!build.Can_Place(HOUSE_USSR, BUILDING_POWR, 23, 20));       // Other house
+
+    // Walls and units block
+    Build_Wall(fixture.map, 24, 21, 22);
+    TEST_ASSERT(!build.Is_Free(24, 21));
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 23, 20));
+    FootClass* tank = Place_Unit(21, 24);
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 20, 23));
+    TEST_ASSERT(build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 22, 23));
+    tank->Set_Coord(Cell_Coord(XY_Cell(40, 24)));
+    TEST_ASSERT(build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 20, 23));
+
+    // The map-wide scan agrees with the single test everywhere
+    uint64_t legal[BuildMap::PLANE_WORDS];
+    int count = build.Legal_Placements(HOUSE_GREECE, BUILDING_WEAP, legal);
+    bool agree = true;
+    int checked = 0;
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            bool bit = (legal[y * BuildMap::ROW_WORDS + (x >> 6)] >> (x & 63)) & 1;
+            bool single = build.Can_Place(HOUSE_GREECE, BUILDING_WEAP, x, y);
+            agree = agree && bit == single;
+            checked += single ? 1 : 0;
+        }
+    }
+    TEST_ASSERT(agree);
+    TEST_ASSERT_EQ(count, checked);
+    TEST_ASSERT_GT(count, 0);
+    CELL spot = build.Find_Placement(HOUSE_GREECE, BUILDING_WEAP, XY_Cell(70, 40));
+    TEST_ASSERT_NE(spot, CELL_NONE);
+    TEST_ASSERT_GE(Cell_X(spot), 60);
+    TEST_ASSERT(build.Can_Place(HOUSE_GREECE, BUILDING_WEAP, Cell_X(spot), Cell_Y(spot)));
+
+    // A removed building frees its area
+    build.Building_Removed(HOUSE_GREECE, BUILDING_FACT, XY_Cell(20, 20));
+    TEST_ASSERT(build.Is_Free(22, 22));
+    TEST_ASSERT(!build.Can_Place(HOUSE_GREECE, BUILDING_POWR, 22, 23));
+    TEST_ASSERT_EQ(build.Building_Count(HOUSE_GREECE), 1);
+}
+
+//=============================================================================
+// Vision Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_Vision_PerHouse, "Map") {
+    MapClass& map = fixture.map;
+    const VisionMap* vision = map.Get_Vision();
+
+    TechnoClass* scout = Place_Unit(63, 10, HOUSE_GREECE);
+    TEST_ASSERT_EQ(vision->Sighter_Count(HOUSE_GREECE), 1);
+    TEST_ASSERT(!vision->Is_Visible(HOUSE_GREECE, 63, 10));     // Nothing seen before update
+
+    // Sight is a circle across words
+    map.Update_Vision(HOUSE_GREECE);
+    for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+        for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+            int dx = x - 63;
+            int dy = y - 10;
+            TEST_ASSERT_EQ(vision->Is_Visible(HOUSE_GREECE, x, y), dx * dx + dy * dy <= 9);
+        }
+    }
+    TEST_ASSERT(!vision->Is_Visible(HOUSE_USSR, 63, 10));
+    TEST_ASSERT(map[XY_Cell(65, 10)].Is_Visible());
+
+    // Moving away loses the view but keeps it explored
+    scout->Set_Coord(Cell_Coord(XY_Cell(80, 10)));
+    map.Update_Vision(HOUSE_GREECE);
+    TEST_ASSERT(!vision->Is_Visible(HOUSE_GREECE, 63, 10));
+    TEST_ASSERT(vision->Is_Visible(HOUSE_GREECE, 80, 10));
+    TEST_ASSERT(vision->Is_Explored(HOUSE_GREECE, 63, 10));
+    TEST_ASSERT(map[XY_Cell(63, 10)].Is_Explored());
+    TEST_ASSERT(!map[XY_Cell(63, 10)].Is_Visible());
+
+    // Overlapping sight survives one sighter leaving
+    TechnoClass* buddy = Place_Unit(82, 10, HOUSE_GREECE);
+    Destroy_Object(scout);
+    map.Update_Vision(HOUSE_GREECE);
+    TEST_ASSERT(vision->Is_Visible(HOUSE_GREECE, 80, 10));
+    TEST_ASSERT(!vision->Is_Visible(HOUSE_GREECE, 78, 10));
+
+    buddy->Set_Sight_Range(6);
+    map.Update_Vision(HOUSE_GREECE);
+    TEST_ASSERT_EQ(vision->Sighter_Count(HOUSE_GREECE), 1);
+    TEST_ASSERT(vision->Is_Visible(HOUSE_GREECE, 88, 10));
+
+    // Destroyed units stop seeing
+    Destroy_All_Objects();
+    map.Update_Vision(HOUSE_GREECE);
+    TEST_ASSERT_EQ(vision->Sighter_Count(HOUSE_GREECE), 0);
+    TEST_ASSERT(!vision->Is_Visible(HOUSE_GREECE, 82, 10));
+}
+
+//=============================================================================
+// Tiberium Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Map_Tiberium_Growth, "Map") {
+    MapClass& map = fixture.map;
+    TiberiumGrowth* ore = map.Get_Tiberium();
+
+    map[XY_Cell(30, 30)].Set_Overlay(OVERLAY_GOLD3, 40);
+    map[XY_Cell(60, 60)].Set_Overlay(OVERLAY_GEMS1, 40);
+    map[XY_Cell(70, 70)].Set_Overlay(OVERLAY_BRICK, 0);
+    TEST_ASSERT_EQ(ore->Count(), 1);
+    TEST_ASSERT(ore->Contains(XY_Cell(30, 30)));
+
+    map.Clear_Changed_Cells();
+    map.Grow_Tiberium();
+    TEST_ASSERT_EQ(map[XY_Cell(30, 30)].Get_Overlay(), OVERLAY_GOLD4);
+    TEST_ASSERT(map.Is_Cell_Changed(30, 30));
+    TEST_ASSERT_EQ(map[XY_Cell(60, 60)].Get_Overlay(), OVERLAY_GEMS1);     // Gems stay put
+
+    // Full ore spreads
+    map.Grow_Tiberium();
+    TEST_ASSERT_EQ(ore->Count(), 2);
+    TEST_ASSERT_EQ(ore->Get_Stats().spread, 1u);
+
+    // Fence the field in; it can only fill itself up
+    for (int i = 0; i < 8; i++) {
+        map[XY_Cell(30 + FacingOffset_X[i], 30 + FacingOffset_Y[i])].Set_Overlay(OVERLAY_BRICK, 0);
+    }
+    TEST_ASSERT_EQ(ore->Count(), 1);
+    for (int tick = 0; tick < 20; tick++) {
+        map.Grow_Tiberium();
+    }
+    TEST_ASSERT_EQ(ore->Count(), 1);
+
+    // Per-tick work is the budget, whatever the field size
+    for (int y = 80; y < 100; y++) {
+        for (int x = 80; x < 100; x++) {
+            map[XY_Cell(x, y)].Set_Overlay(OVERLAY_GOLD1, 40);
+        }
+    }
+    ore->Reset_Stats();
+    map.Grow_Tiberium();
+    TEST_ASSERT_EQ(ore->Get_Stats().visited, (uint32_t)ore->Get_Budget());
+
+    // Harvested cell leaves the set
+    map[XY_Cell(80, 80)].Reduce_Tiberium(255);
+    TEST_ASSERT(!ore->Contains(XY_Cell(80, 80)));
+    TEST_ASSERT_EQ(ore->Count(), 400);
+}
+
+TEST_WITH_FIXTURE(MapFixture, Map_Tiberium_OreFields, "Map") {
+    MapClass& map = fixture.map;
+    const OreFields* fields = map.Get_Ore_Fields();
+    TEST_ASSERT_EQ(fields->Nearest_Ore(XY_Cell(10, 10)), CELL_NONE);
+
+    map[XY_Cell(20, 20)].Set_Overlay(OVERLAY_GOLD1, 40);
+    map[XY_Cell(21, 20)].Set_Overlay(OVERLAY_GOLD4, 40);
+    map[XY_Cell(90, 40)].Set_Overlay(OVERLAY_GEMS4, 40);
+    map[XY_Cell(91, 40)].Set_Overlay(OVERLAY_GEMS4, 40);
+    Build_Wall(map, 70, 70, 71);
+    TEST_ASSERT_EQ(fields->Count(), 4);
+    TEST_ASSERT(!fields->Contains(XY_Cell(70, 70)));
+    TEST_ASSERT_EQ(fields->Total_Value(), 25 + 100 + 200 + 200);
+    TEST_ASSERT_EQ(fields->Field_Count(), 2);
+
+    TEST_ASSERT_EQ(fields->Nearest_Ore(XY_Cell(10, 10)), XY_Cell(20, 20));
+    TEST_ASSERT_EQ(fields->Nearest_Ore(XY_Cell(100, 40)), XY_Cell(91, 40));    // Across blocks
+    TEST_ASSERT_EQ(fields->Nearest_Ore(XY_Cell(10, 10), 10), CELL_NONE);      // Out of range
+
+    OreFields::Field field;
+    TEST_ASSERT(fields->Richest_Field(XY_Cell(10, 10), 128, field));
+    TEST_ASSERT_EQ(field.value, 400);
+    TEST_ASSERT_EQ(field.cells, 2);
+    TEST_ASSERT_EQ(Cell_Y(field.centroid), 40);
+    TEST_ASSERT(fields->Richest_Field(XY_Cell(10, 10), 30, field));
+    TEST_ASSERT_EQ(field.value, 125);
+    TEST_ASSERT(!fields->Richest_Field(XY_Cell(10, 10), 5, field));
+
+    // Growth and harvesting move the sums
+    map[XY_Cell(20, 20)].Set_Overlay(OVERLAY_GOLD2, 40);
+    TEST_ASSERT_EQ(fields->Total_Value(), 550);
+    map[XY_Cell(91, 40)].Reduce_Tiberium(255);
+    TEST_ASSERT_EQ(fields->Count(), 3);
+    TEST_ASSERT_EQ(fields->Total_Value(), 350);
+    map[XY_Cell(90, 40)].Reduce_Tiberium(255);
+    TEST_ASSERT_EQ(fields->Field_Count(), 1);                               // Empty field dropped
+    TEST_ASSERT_EQ(fields->Nearest_Ore(XY_Cell(100, 40)), XY_Cell(21, 20));
+}
+
+TEST_WITH_FIXTURE(MapFixture, Map_Tiberium_NearestMatchesScan, "Map") {
+    MapClass& map = fixture.map;
+    const OreFields* fields = map.Get_Ore_Fields();
+    for (int i = 0; i < 60; i++) {
+        map[XY_Cell((i * 37) % 120 + 4, (i * 53) % 120 + 4)].Set_Overlay(OVERLAY_GOLD1, 40);
+    }
+
+    // Matches a brute-force search over the scattered map
+    for (int probe = 0; probe < 40; probe++) {
+        CELL from = XY_Cell((probe * 29) % 128, (probe * 71) % 128);
+        CELL expect = CELL_NONE;
+        int expect_d2 = INT32_MAX;
+        for (int y = 0; y < MAP_CELL_HEIGHT; y++) {
+            for (int x = 0; x < MAP_CELL_WIDTH; x++) {
+                if (!map[XY_Cell(x, y)].Is_Tiberium()) {
+                    continue;
+                }
+                int dx = x - Cell_X(from);
+                int dy = y - Cell_Y(from);
+                if (dx * dx + dy * dy < expect_d2) {
+                    expect = XY_Cell(x, y);
+                    expect_d2 = dx * dx + dy * dy;
+                }
+            }
+        }
+        TEST_ASSERT_EQ(fields->Nearest_Ore(from), expect);
+    }
+}
+
+//=============================================================================
+// Large Map Tests
+//=============================================================================
+
+TEST_CASE(Map_Large_WideCell, "Map") {
+    WIDE_CELL wide = XY_Wide_Cell(200, 250);
+    TEST_ASSERT_EQ(Wide_Cell_X(wide), 200);
+    TEST_ASSERT_EQ(Wide_Cell_Y(wide), 250);
+    TEST_ASSERT_EQ(Cell_Wide(XY_Cell(17, 99)), XY_Wide_Cell(17, 99));
+}
+
+TEST_CASE(Map_Large_ChunkedGrid, "Map") {
+    WIDE_CELL wide = XY_Wide_Cell(200, 250);
+    ChunkedGrid<uint8_t> grid(MAP_MAX_CELL_WIDTH, MAP_MAX_CELL_HEIGHT, 0xFF);
+    TEST_ASSERT_EQ(grid.Chunk_Count(), 64);
+    TEST_ASSERT_EQ(grid.Allocated_Chunks(), 0);
+    TEST_ASSERT_EQ(grid.Get(200, 250), 0xFF);
+    TEST_ASSERT_NULL(grid.Cell_At(200, 250));
+
+    // Writing empty allocates nothing, other writes allocate their chunk
+    grid.Set(10, 10, 0xFF);
+    TEST_ASSERT_EQ(grid.Allocated_Chunks(), 0);
+    grid.Touch(wide) = 7;
+    grid.Set(201, 250, 8);
+    grid.Set(5, 5, 9);
+    TEST_ASSERT_EQ(grid.Allocated_Chunks(), 2);
+    TEST_ASSERT_EQ(grid.Get(wide), 7);
+    TEST_ASSERT_EQ(grid.Get(201, 250), 8);
+    TEST_ASSERT_EQ(grid.Get(5, 5), 9);
+    TEST_ASSERT_EQ(grid.Get(202, 250), 0xFF);
+    TEST_ASSERT_EQ(grid.Memory_Used(), 2u * CHUNK_CELLS);
+
+    // Off-map cells read empty
+    TEST_ASSERT_EQ(grid.Get(-1, 0), 0xFF);
+    TEST_ASSERT_EQ(grid.Get(256, 0), 0xFF);
+    TEST_ASSERT(!grid.Has_Chunk(256, 0));
+
+    // The chunk walk skips empty space
+    int chunks = 0, sum = 0;
+    grid.For_Each_Chunk([&](int x0, int y0, const uint8_t* cells) {
+        chunks++;
+        sum += cells[ChunkedGrid<uint8_t>::Offset(200 - x0, 250 - y0)] == 7 ? 1 : 0;
+    });
+    TEST_ASSERT_EQ(chunks, 2);
+    TEST_ASSERT_EQ(sum, 1);
+    grid.Release_Chunk(200, 250);
+    TEST_ASSERT_EQ(grid.Allocated_Chunks(), 1);
+    TEST_ASSERT_EQ(grid.Get(wide), 0xFF);
+
+    // Partial chunks cover the edges
+    ChunkedGrid<uint8_t> odd(100, 40);
+    TEST_ASSERT_EQ(odd.Chunks_Wide(), 4);
+    TEST_ASSERT_EQ(odd.Chunks_High(), 2);
+    TEST_ASSERT(!odd.Is_Valid(100, 0));
+    TEST_ASSERT(odd.Is_Valid(99, 39));
+}
+
+TEST_CASE(Map_Large_Vision, "Map") {
+    VisionMap vision(MAP_MAX_CELL_WIDTH, MAP_MAX_CELL_HEIGHT);
+    TEST_ASSERT_EQ(vision.Get_Row_Words(), 4);
+    TEST_ASSERT_EQ(vision.Get_Plane_Words(), 4 * 256);
+
+    // Sight past cell 128
+    vision.Add_Sight(HOUSE_GREECE, 200, 250, 3);
+    vision.Update();
+    for (int y = 240; y < 256; y++) {
+        for (int x = 190; x < 212; x++) {
+            int dx = x - 200;
+            int dy = y - 250;
+            TEST_ASSERT_EQ(vision.Is_Visible(HOUSE_GREECE, x, y), dx * dx + dy * dy <= 9);
+        }
+    }
+    TEST_ASSERT(vision.Is_Explored(HOUSE_GREECE, 200, 253));
+
+    vision.Remove_Sight(HOUSE_GREECE, 200, 250, 3);
+    vision.Update();
+    TEST_ASSERT_EQ(vision.Sighter_Count(HOUSE_GREECE), 0);
+    TEST_ASSERT(!vision.Is_Visible(HOUSE_GREECE, 200, 250));
+    TEST_ASSERT(vision.Is_Explored(HOUSE_GREECE, 200, 250));
+}
+
+TEST_CASE(Map_Large_SpatialIndex, "Map") {
+    int object = 0;
+    SpatialGrid<int> index(MAP_MAX_CELL_WIDTH * CELL_PIXEL_SIZE, MAP_MAX_CELL_HEIGHT * CELL_PIXEL_SIZE);
+    index.Insert(&object, 200 * CELL_PIXEL_SIZE, 250 * CELL_PIXEL_SIZE);
+    std::vector<int*> found;
+    index.QueryRadius(200 * CELL_PIXEL_SIZE, 250 * CELL_PIXEL_SIZE, 10, found);
+    TEST_ASSERT_EQ(index.Grid_Width(), 48);
+    TEST_ASSERT_EQ(index.Grid_Height(), 48);
+    TEST_ASSERT_EQ(found.size(), 1u);
+}
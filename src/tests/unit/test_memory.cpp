@@ -0,0 +1,450 @@
+// src/tests/unit/test_memory.cpp
+// Memory Arena and Allocation Unit Tests
+
+#include "test/test_framework.h"
+#include "map_fixture.h"
+#include "game/audio/audio_events.h"
+#include "game/cell.h"
+#include "game/combat.h"
+#include "game/job_system.h"
+#include "game/memory_budget.h"
+#include "game/scenario_arena.h"
+#include "game/movement.h"
+#include "game/projectile.h"
+#include "game/state_hash.h"
+#include "game/tiberium.h"
+#include "game/vision_map.h"
+#include "platform/alloc_tracker.h"
+#include "platform/large_pages.h"
+#include "platform/memory_arena.h"
+#include "platform/thread_shards.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//=============================================================================
+// Memory Arena Tests
+//=============================================================================
+
+TEST_CASE(Memory_Arena_BlockReuse, "Memory") {
+    MemoryArena arena(4096);
+    arena.set_high_water_frames(4);
+    arena.allocate(20000);
+    TEST_ASSERT_GE(arena.get_total_capacity(), 4096u + 20000u);   // Counts oversized blocks
+
+    // An overflowing frame keeps its blocks for the next one
+    arena.reset();
+    arena.set_high_water_frames(0);
+    size_t blocks = arena.get_block_count();
+    size_t made = arena.get_system_allocations();
+    for (int frame = 0; frame < 3; frame++) {
+        arena.allocate(20000);
+        arena.reset();
+    }
+    TEST_ASSERT_EQ(arena.get_block_count(), blocks);
+    TEST_ASSERT_EQ(arena.get_system_allocations(), made);
+
+    // Retention cap releases them
+    arena.set_retained_limit(0);
+    arena.reset();
+    TEST_ASSERT_EQ(arena.get_block_count(), 1u);
+
+    // The first block grows to the peak, then frames stop allocating
+    arena.set_high_water_frames(4);
+    for (int frame = 0; frame < 3; frame++) {
+        for (int i = 0; i < 10; i++) {
+            arena.allocate(3000);
+        }
+        arena.reset();
+    }
+    made = arena.get_system_allocations();
+    for (int frame = 0; frame < 3; frame++) {
+        for (int i = 0; i < 10; i++) {
+            arena.allocate(3000);
+        }
+        arena.reset();
+    }
+    TEST_ASSERT_GE(arena.get_block_size(), 30000u);
+    TEST_ASSERT_EQ(arena.get_block_count(), 1u);
+    TEST_ASSERT_EQ(arena.get_system_allocations(), made);
+
+    // Quiet frames shrink it back once the peak leaves the window
+    for (int frame = 0; frame < 5; frame++) {
+        arena.allocate(100);
+        arena.reset();
+    }
+    TEST_ASSERT_EQ(arena.get_block_size(), 4096u);
+
+    // A marker rewinds without giving blocks back
+    arena.set_retained_limit(MemoryArena::DEFAULT_RETAINED_BYTES);
+    int* before = arena.create<int>(5);
+    {
+        MemoryArena::Marker marker = arena.create_marker();
+        arena.allocate(10000);
+    }
+    int* after = arena.create<int>(6);
+    TEST_ASSERT_EQ(*before, 5);
+    TEST_ASSERT(after == before + 1);
+    TEST_ASSERT_EQ(arena.get_block_count(), 2u);
+}
+
+//=============================================================================
+// Frame Allocator Tests
+//=============================================================================
+
+TEST_CASE(Memory_FrameAllocator_PerThread, "Memory") {
+    FrameAllocator& frame = FrameAllocator::instance();
+    frame.begin_frame();
+    int* main_value = FRAME_NEW(int, 7);
+    TEST_ASSERT_NOT_NULL(main_value);
+    TEST_ASSERT_EQ(*main_value, 7);
+    TEST_ASSERT_GE(frame.get_frame_allocation(), sizeof(int));
+
+    // Workers bump their own arenas, no lock needed
+    JobSystem& jobs = JobSystem::Instance();
+    jobs.Start(3);
+    std::vector<int*> chunks(64, nullptr);
+    jobs.Parallel_For(64, 1, [&chunks](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            int* values = FRAME_ARRAY(int, 100);
+            for (int k = 0; k < 100; k++) {
+                values[k] = i;
+            }
+            chunks[i] = values;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));   // Let every worker join in
+        }
+    });
+    jobs.Stop();
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_NOT_NULL(chunks[i]);
+        TEST_ASSERT_EQ(chunks[i][0], i);
+        TEST_ASSERT_EQ(chunks[i][99], i);
+    }
+    TEST_ASSERT_GE(frame.get_thread_count(), 2u);
+
+    frame.begin_frame();
+    TEST_ASSERT_EQ(frame.get_frame_allocation(), 0u);
+}
+
+TEST_CASE(Memory_FrameAllocator_DoubleBuffered, "Memory") {
+    // Last frame's data survives this frame
+    FrameAllocator& frame = FrameAllocator::instance();
+    frame.set_double_buffered(true);
+    frame.begin_frame();
+    int* kept = FRAME_NEW(int, 42);
+    frame.begin_frame();
+    int* next = FRAME_NEW(int, 43);
+    int kept_value = *kept;
+    int next_value = *next;
+    frame.set_double_buffered(false);
+    frame.begin_frame();
+
+    TEST_ASSERT_EQ(kept_value, 42);
+    TEST_ASSERT_EQ(next_value, 43);
+    TEST_ASSERT(kept != next);
+}
+
+//=============================================================================
+// Allocation Tracking Tests
+//=============================================================================
+
+TEST_CASE(Memory_AllocTracker_Scopes, "Memory") {
+    {
+        AllocScope sim(AllocTag::SIM);
+        {
+            AllocScope audio(AllocTag::AUDIO);
+            TEST_ASSERT(AllocTracker::current_tag() == AllocTag::AUDIO);     // Inner tag wins
+        }
+        TEST_ASSERT(AllocTracker::current_tag() == AllocTag::SIM);
+    }
+    TEST_ASSERT(AllocTracker::current_tag() == AllocTag::UNTAGGED);
+}
+
+TEST_CASE(Memory_AllocTracker_ChargesTag, "Memory") {
+    if (!AllocTracker::is_enabled()) {
+        TEST_SKIP("Allocation tracking not built in");
+    }
+
+    AllocTracker& tracker = AllocTracker::instance();
+    uint64_t before = tracker.get_counts(AllocTag::ASSETS).allocations;
+    int64_t live = tracker.get_counts(AllocTag::ASSETS).live_bytes;
+    std::vector<int>* data;
+    {
+        AllocScope assets(AllocTag::ASSETS);
+        data = new std::vector<int>(100);
+    }
+    uint64_t charged = tracker.get_counts(AllocTag::ASSETS).allocations;
+    int64_t charged_bytes = tracker.get_counts(AllocTag::ASSETS).live_bytes;
+    delete data;
+    TEST_ASSERT_EQ(charged, before + 2);
+    TEST_ASSERT_GE(charged_bytes, live + 400);
+    TEST_ASSERT_EQ(tracker.get_counts(AllocTag::ASSETS).live_bytes, live);    // Frees charged back
+}
+
+TEST_WITH_FIXTURE(MapFixture, Memory_AllocTracker_SteadyStateTick, "Memory") {
+    if (!AllocTracker::is_enabled()) {
+        TEST_SKIP("Allocation tracking not built in");
+    }
+
+    // A steady battle: once warmed up, a tick must not touch the heap
+    MapClass& map = fixture.map;
+    AllocTracker& tracker = AllocTracker::instance();
+    for (int i = 0; i < 64; i++) {
+        TechnoClass* techno = Place_Unit(20 + (i % 2) * 3, 10 + i / 2, i % 2 ? HOUSE_USSR : HOUSE_GREECE);
+        techno->Set_Strength(30000);
+        techno->Set_Weapons(WEAPON_120MM);
+    }
+    FootClass* first_runner = nullptr;
+    for (int i = 0; i < 16; i++) {
+        FootClass* runner = Place_Unit(60, 10 + i, HOUSE_GREECE);
+        runner->Set_Speed(2);
+        runner->Set_Destination(Cell_Coord(XY_Cell(63, 10 + i)));
+        first_runner = first_runner ? first_runner : runner;
+    }
+    auto tick = [&map]() {
+        AllocScope sim(AllocTag::SIM);
+        CombatSystem::Instance().Update();
+        AI_All_Objects();
+        MovementSystem::Instance().Update();
+        ProjectileSystem::Instance().Update();
+        map.Update_Vision(HOUSE_GREECE);
+        map.Grow_Tiberium();
+        AudioEvents_FlushTick();
+        StateHash::Instance().Value();
+    };
+    for (int i = 0; i < 60; i++) {
+        tick();
+    }
+    tracker.end_frame();
+    uint32_t shots = CombatSystem::Instance().Get_Stats().shots;
+    CELL runner_cell = first_runner->Get_Cell();
+    for (int i = 0; i < 120; i++) {
+        tick();
+    }
+    tracker.end_frame();
+    TEST_ASSERT_EQ(tracker.get_frame_allocations(), 0u);
+    TEST_ASSERT_GT(CombatSystem::Instance().Get_Stats().shots, shots);       // Still fighting
+    TEST_ASSERT_NE(first_runner->Get_Cell(), runner_cell);                   // Still moving
+}
+
+//=============================================================================
+// Large Page Tests
+//=============================================================================
+
+TEST_CASE(Memory_LargePages_AllocFlags, "Memory") {
+    LargePages& pages = LargePages::instance();
+    TEST_ASSERT_EQ(pages.get_alloc_flags(64 * 64), 0u);      // Small buffers stay on the heap
+    TEST_ASSERT_EQ(pages.get_alloc_flags(LargePages::DEFAULT_MIN_BYTES), (uint32_t)PLATFORM_MEM_HUGE_PAGES);
+
+    pages.set_locked(true);
+    uint32_t locked = pages.get_alloc_flags(1 << 20);
+    pages.set_locked(false);
+    pages.set_enabled(false);
+    uint32_t disabled = pages.get_alloc_flags(1 << 20);
+    pages.set_enabled(true);
+    TEST_ASSERT_EQ(locked, (uint32_t)(PLATFORM_MEM_HUGE_PAGES | PLATFORM_MEM_LOCK));
+    TEST_ASSERT_EQ(disabled, 0u);
+}
+
+TEST_CASE(Memory_LargePages_MapRelayout, "Memory") {
+    MapClass paged_map;
+    TEST_ASSERT(paged_map.Alloc_Cells());
+    paged_map[XY_Cell(5, 7)].Set_Overlay(OVERLAY_SANDBAG);
+    paged_map.Set_Cell_Layout(paged_map.Get_Cell_Layout() == CELL_LAYOUT_TILED ?
+                              CELL_LAYOUT_LINEAR : CELL_LAYOUT_TILED);
+    TEST_ASSERT_EQ(paged_map[XY_Cell(5, 7)].Get_Overlay(), OVERLAY_SANDBAG);
+}
+
+//=============================================================================
+// Memory Budget Tests
+//=============================================================================
+
+TEST_CASE(Memory_Budget_EvictionOrder, "Memory") {
+    // Fake caches that free whatever they are asked for
+    size_t big = 800, small = 100, dear = 400;
+    auto evict_from = [](size_t& held) {
+        return [&held](size_t bytes) {
+            size_t freed = std::min(held, bytes);
+            held -= freed;
+            return freed;
+        };
+    };
+
+    MemoryBudget budget;
+    int big_id = budget.Register("Big", 1, [&big]() { return big; }, evict_from(big));
+    int small_id = budget.Register("Small", 1, [&small]() { return small; }, evict_from(small));
+    int dear_id = budget.Register("Dear", 8, [&dear]() { return dear; }, evict_from(dear));
+
+    // Nothing evicted without limits
+    TEST_ASSERT_EQ(budget.Update(), 0u);
+    TEST_ASSERT_EQ(budget.Get_Total_Bytes(), 1300u);
+
+    // A limit evicts the excess, cheap big cache first
+    budget.Set_Limit(1000);
+    TEST_ASSERT_EQ(budget.Update(), 300u);
+    TEST_ASSERT_EQ(budget.Get_Total_Bytes(), 1000u);
+    TEST_ASSERT_EQ(big, 500u);
+    TEST_ASSERT_EQ(small, 100u);
+    TEST_ASSERT_EQ(dear, 400u);
+
+    // Own budget caps one cache
+    budget.Set_Limit(0);
+    budget.Set_Budget(dear_id, 100);
+    budget.Update();
+    TEST_ASSERT_EQ(dear, 100u);
+    TEST_ASSERT_EQ(big, 500u);
+
+    // Expensive cache goes last
+    budget.Set_Limit(200);
+    budget.Update();
+    TEST_ASSERT_EQ(big, 0u);
+    TEST_ASSERT_EQ(small, 100u);
+    TEST_ASSERT_EQ(dear, 100u);
+
+    const MemoryBudget::CacheStats* stats = budget.Get_Stats(big_id);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_EQ(stats->evicted_bytes, 800u);
+    TEST_ASSERT_EQ(stats->bytes, 0u);
+
+    // Unregistered cache drops out
+    budget.Unregister(small_id);
+    TEST_ASSERT_NULL(budget.Get_Stats(small_id));
+    TEST_ASSERT_EQ(budget.Update(), 0u);
+    TEST_ASSERT_EQ(budget.Get_Total_Bytes(), 100u);
+    TEST_ASSERT_EQ(budget.Get_Evicted_Bytes(), 1100u);
+}
+
+//=============================================================================
+// Thread Shard Tests
+//=============================================================================
+
+TEST_CASE(Memory_ThreadShards_PerThread, "Memory") {
+    struct Hits {
+        int count = 0;
+        Hits& operator+=(const Hits& other) {
+            count += other.count;
+            return *this;
+        }
+    };
+    ThreadSharded<Hits> hits;
+    int main_index = ThreadShards::index();
+    int claimed = ThreadShards::get_claimed_count();
+
+    // All four alive at once, so none can inherit another's shard
+    std::vector<int> indices(4);
+    std::vector<std::thread> threads;
+    std::atomic<int> arrived{0};
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&hits, &indices, &arrived, t]() {
+            indices[t] = ThreadShards::index();
+            arrived.fetch_add(1);
+            while (arrived.load() < 4) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < 1000; i++) {
+                hits.local().count++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    hits.local().count += 5;
+
+    // Live threads get their own shards
+    for (int t = 0; t < 4; t++) {
+        TEST_ASSERT_NE(indices[t], main_index);
+        TEST_ASSERT_NE(indices[t], ThreadShards::SHARED_SHARD);
+        for (int u = 0; u < t; u++) {
+            TEST_ASSERT_NE(indices[t], indices[u]);
+        }
+    }
+    TEST_ASSERT_GE(reinterpret_cast<uintptr_t>(&hits.shard(1)) - reinterpret_cast<uintptr_t>(&hits.shard(0)),
+                   CACHE_LINE_SIZE);
+    TEST_ASSERT_EQ(hits.merge().count, 4005);
+    TEST_ASSERT_EQ(ThreadShards::get_claimed_count(), claimed);    // Exited threads give theirs back
+    hits.reset();
+    TEST_ASSERT_EQ(hits.merge().count, 0);
+}
+
+TEST_CASE(Memory_ThreadShards_WorkerAllocTracking, "Memory") {
+    if (!AllocTracker::is_enabled()) {
+        TEST_SKIP("Allocation tracking not built in");
+    }
+
+    AllocTracker& tracker = AllocTracker::instance();
+    uint64_t before = tracker.get_counts(AllocTag::GRAPHICS).allocations;
+    std::thread worker([]() {
+        AllocScope graphics(AllocTag::GRAPHICS);
+        int* volatile block = new int(1);    // volatile: the pair can't be elided
+        delete block;
+    });
+    worker.join();
+    TEST_ASSERT_EQ(tracker.get_counts(AllocTag::GRAPHICS).allocations, before + 1);
+}
+
+//=============================================================================
+// Scenario Arena Tests
+//=============================================================================
+
+TEST_CASE(Memory_ScenarioArena_NestedScopes, "Memory") {
+    ScenarioArena& arena = ScenarioArena::Instance();
+    TEST_ASSERT_NULL(arena.Allocate(16));      // No allocation outside a scope
+
+    static int destroyed = 0;
+    static int order[3];
+    struct Tracked {
+        int id = 0;
+        ~Tracked() { order[destroyed++ % 3] = id; }
+    };
+    destroyed = 0;
+
+    uint32_t generation = arena.Get_Generation();
+    size_t system_allocations = 0;
+    {
+        ScenarioScope scenario;
+        TEST_ASSERT_EQ(arena.Get_Depth(), 1);
+        Tracked* first = arena.Create<Tracked>();
+        first->id = 1;
+        Tracked* many = arena.Create_Array<Tracked>(2);
+        many[0].id = 2;
+        many[1].id = 3;
+        uint32_t* plain = arena.Create_Array<uint32_t>(1000);
+        TEST_ASSERT_EQ(reinterpret_cast<uintptr_t>(plain) % alignof(uint32_t), 0u);
+
+        {
+            ScenarioScope nested;
+            size_t used = arena.Get_Used();
+            arena.Create<Tracked>()->id = 4;
+            arena.Allocate(4096);
+            TEST_ASSERT_GT(arena.Get_Used(), used);
+        }
+        // Nested scope unwinds only its own
+        TEST_ASSERT_EQ(destroyed, 1);
+        TEST_ASSERT_EQ(order[0], 4);
+        TEST_ASSERT_EQ(arena.Get_Depth(), 1);
+        destroyed = 0;
+        system_allocations = arena.Get_System_Allocations();
+    }
+    // Scope end destroys newest first and resets the arena
+    TEST_ASSERT_EQ(destroyed, 3);
+    TEST_ASSERT_EQ(order[0], 3);
+    TEST_ASSERT_EQ(order[1], 2);
+    TEST_ASSERT_EQ(order[2], 1);
+    TEST_ASSERT_EQ(arena.Get_Used(), 0u);
+    TEST_ASSERT_EQ(arena.Get_Depth(), 0);
+    TEST_ASSERT_EQ(arena.Get_Generation(), generation + 1);
+
+    // Cleanups run once per scope and restarts reuse the memory
+    static int flushed = 0;
+    flushed = 0;
+    for (int restart = 0; restart < 3; restart++) {
+        ScenarioScope scenario;
+        arena.Create_Array<uint32_t>(1000);
+        arena.At_Scope_End([](void*) { flushed++; }, nullptr);
+    }
+    TEST_ASSERT_EQ(flushed, 3);
+    TEST_ASSERT_EQ(arena.Get_System_Allocations(), system_allocations);
+}
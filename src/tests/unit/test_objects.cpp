@@ -0,0 +1,189 @@
+// src/tests/unit/test_objects.cpp
+// Game Object Storage and State Unit Tests
+
+#include "test/test_framework.h"
+#include "map_fixture.h"
+#include "game/object.h"
+#include "game/object_dispatch.h"
+#include "game/object_heap.h"
+#include "game/fixed.h"
+#include "game/movement.h"
+#include "game/state_hash.h"
+#include "platform/memory_pool.h"
+
+#include <cstdint>
+
+//=============================================================================
+// Slot Pool Tests
+//=============================================================================
+
+TEST_CASE(Objects_SlotPool_Handles, "Objects") {
+    struct Counted {
+        int value;
+        int* destroyed;
+        Counted(int v, int* d) : value(v), destroyed(d) {}
+        ~Counted() { (*destroyed)++; }
+    };
+    int destroyed = 0;
+    using CountedPool = SlotPool<Counted, 4>;
+    CountedPool pool;
+    SlotHandle a = pool.allocate(1, &destroyed);
+    SlotHandle b = pool.allocate(2, &destroyed);
+    TEST_ASSERT_NOT_NULL(pool.get(a));
+    TEST_ASSERT_EQ(pool.get(a)->value, 1);
+    TEST_ASSERT_EQ(pool.get(b)->value, 2);
+    TEST_ASSERT_NULL(pool.get(SlotHandle()));
+    TEST_ASSERT(!a.is_none());
+    TEST_ASSERT_EQ(reinterpret_cast<uintptr_t>(pool.get(a)) % CountedPool::CACHE_LINE, 0u);
+
+    // Freed once, and the handle dies with it
+    TEST_ASSERT(pool.deallocate(a));
+    TEST_ASSERT(!pool.deallocate(a));
+    TEST_ASSERT_EQ(destroyed, 1);
+    TEST_ASSERT_NULL(pool.get(a));
+    TEST_ASSERT_EQ(pool.size(), 1u);
+
+    // Freed slot reused with a new generation
+    SlotHandle c = pool.allocate(3, &destroyed);
+    TEST_ASSERT_EQ(c.index(), a.index());
+    TEST_ASSERT(c != a);
+    TEST_ASSERT_NULL(pool.get(a));
+    TEST_ASSERT_EQ(pool.get(c)->value, 3);
+
+    // Grows by blocks
+    for (int i = 0; i < 6; i++) {
+        pool.allocate(10 + i, &destroyed);
+    }
+    TEST_ASSERT_EQ(pool.size(), 8u);
+    TEST_ASSERT_EQ(pool.capacity(), 8u);
+
+    int sum = 0;
+    pool.for_each([&sum](Counted& obj) { sum += obj.value; });
+    TEST_ASSERT_EQ(sum, 2 + 3 + 10 + 11 + 12 + 13 + 14 + 15);
+
+    // Clear destroys live objects
+    pool.clear();
+    TEST_ASSERT_EQ(pool.size(), 0u);
+    TEST_ASSERT_EQ(destroyed, 9);
+    TEST_ASSERT_NULL(pool.get(b));
+    TEST_ASSERT_NULL(pool.get(c));
+}
+
+//=============================================================================
+// Object Heap Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(ObjectFixture, Objects_Heap_KindsAndHandles, "Objects") {
+    ObjectClass* unit_a = Create_Object(RTTI_UNIT);
+    ObjectClass* unit_b = Create_Object(RTTI_UNIT);
+    ObjectClass* building = Create_Object(RTTI_BUILDING);
+    TEST_ASSERT_NOT_NULL(unit_a);
+    TEST_ASSERT_NOT_NULL(building);
+    TEST_ASSERT_EQ(unit_a->What_Am_I(), RTTI_UNIT);
+    TEST_ASSERT(unit_a->Is_Foot());
+    TEST_ASSERT(building->Is_Building());
+    TEST_ASSERT(building->Is_Techno());
+    TEST_ASSERT_NULL(Create_Object(RTTI_TRIGGER));     // No heap for triggers
+
+    // Each kind's heap is dense
+    TEST_ASSERT_EQ(Object_Heap(RTTI_UNIT)->Count(), 2);
+    TEST_ASSERT_EQ(unit_a->Get_Heap_ID(), 0);
+    TEST_ASSERT_EQ(unit_b->Get_Heap_ID(), 1);
+    ObjectHandle handle_a = Object_Handle(unit_a);
+    TEST_ASSERT_EQ(Resolve_Object(handle_a), unit_a);
+
+    int visited = 0;
+    For_Each_Object([&visited](ObjectClass*) { visited++; });
+    TEST_ASSERT_EQ(visited, 3);
+
+    // Freeing keeps the heap dense and kills the handle, even once the
+    // slot is reused
+    Destroy_Object(unit_a);
+    TEST_ASSERT_EQ(Object_Heap(RTTI_UNIT)->Count(), 1);
+    TEST_ASSERT_EQ(unit_b->Get_Heap_ID(), 0);
+    TEST_ASSERT_NULL(Resolve_Object(handle_a));
+    ObjectClass* unit_c = Create_Object(RTTI_UNIT);
+    TEST_ASSERT_NULL(Resolve_Object(handle_a));
+    TEST_ASSERT_EQ(Resolve_Object(Object_Handle(unit_c)), unit_c);
+
+    AI_All_Objects();
+    TEST_ASSERT_EQ(Object_Count(), 3);
+
+    Destroy_All_Objects();
+    TEST_ASSERT_EQ(Object_Count(), 0);
+}
+
+TEST_WITH_FIXTURE(ObjectFixture, Objects_Dispatch_TakeDamage, "Objects") {
+    ObjectClass* unit = Create_Object(RTTI_UNIT);
+    ObjectClass* building = Create_Object(RTTI_BUILDING);
+    building->Set_Strength(100);
+    unit->Set_Strength(100);
+
+    // Heap objects dispatch straight to their kind's Take_Damage
+    int dealt = Dispatch_Take_Damage(building, 30, unit);
+    TEST_ASSERT_EQ(dealt, unit->Take_Damage(30, building));
+    TEST_ASSERT_EQ(building->Get_Strength(), unit->Get_Strength());
+
+    // Objects outside the heaps go through the virtual call
+    ObjectClass loose;
+    loose.Set_Strength(100);
+    Dispatch_Take_Damage(&loose, 10);
+    TEST_ASSERT_EQ(loose.Get_Strength(), 90);
+}
+
+TEST_WITH_FIXTURE(ObjectFixture, Objects_HealthRatio, "Objects") {
+    ObjectClass* hurt = Create_Object(RTTI_UNIT);
+    hurt->Set_Strength(hurt->Max_Strength());
+    TEST_ASSERT(hurt->Health_Ratio() == fixed(1));
+    hurt->Set_Strength(hurt->Max_Strength() / 4);
+    TEST_ASSERT(hurt->Health_Ratio() < fixed::Ratio(1, 4));
+    TEST_ASSERT(hurt->Health_Ratio() > fixed::Ratio(1, 5));
+}
+
+//=============================================================================
+// State Hash Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Objects_StateHash_Incremental, "Objects") {
+    MapClass& map = fixture.map;
+    StateHash& state = StateHash::Instance();
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+
+    uint64_t empty = state.Value();
+    FootClass* tank = Place_Unit(30, 30, HOUSE_USSR);
+    tank->Set_Strength(200);
+    TechnoClass* yard = static_cast<TechnoClass*>(Create_Object(RTTI_BUILDING));
+    yard->Set_Coord(Cell_Coord(XY_Cell(34, 30)));
+    TEST_ASSERT_NE(state.Value(), empty);
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+
+    // Moves are tracked and moving back restores the hash
+    uint64_t placed = state.Value();
+    tank->Set_Coord(Cell_Coord(XY_Cell(31, 30)));
+    TEST_ASSERT_NE(state.Value(), placed);
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+    tank->Set_Coord(Cell_Coord(XY_Cell(30, 30)));
+    TEST_ASSERT_EQ(state.Value(), placed);
+
+    yard->Take_Damage(40);
+    tank->Set_Owner(HOUSE_GREECE);
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+
+    map[XY_Cell(40, 40)].Set_Overlay(OVERLAY_GOLD2, 7);
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+    map[XY_Cell(40, 40)].Set_Overlay(OVERLAY_NONE_TYPE, 0);
+
+    // Movement writes coordinates straight into the units
+    tank->Set_Speed(20);
+    tank->Set_Destination(Cell_Coord(XY_Cell(36, 34)));
+    for (int t = 0; t < 10; t++) {
+        MovementSystem::Instance().Update();
+    }
+    TEST_ASSERT_NE(tank->Get_Coord(), Cell_Coord(XY_Cell(30, 30)));
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+
+    Destroy_Object(yard);
+    TEST_ASSERT_EQ(state.Value(), StateHash::Recompute());
+    Destroy_All_Objects();
+    TEST_ASSERT_EQ(state.Value(), empty);
+}
@@ -5,7 +5,9 @@
 #include "test/test_framework.h"
 #include "test/test_fixtures.h"
 #include "platform.h"
+#include "platform/profiler.h"
 #include <cstring>
+#include <thread>
 
 //=============================================================================
 // Platform Initialization Tests
@@ -200,3 +202,28 @@ TEST_WITH_FIXTURE(PlatformFixture, Events_Poll_DoesNotCrash, "Platform") {
 
     TEST_ASSERT(true);
 }
+
+//=============================================================================
+// Profiler Thread Tests
+//=============================================================================
+
+TEST_CASE(Profiler_ExitedThreadsFreeTheirBuffers, "Profiler") {
+    Profiler& profiler = Profiler::instance();
+    ProfileSampleId id = profiler.register_sample("UnitTest_ShortLivedThread");
+    TEST_ASSERT_NE(id, PROFILE_ID_INVALID);
+
+    int before = profiler.get_stats(id).call_count;
+
+    // More short-lived threads than buffers, one alive at a time
+    const int thread_count = Profiler::MAX_THREADS + 16;
+    for (int i = 0; i < thread_count; i++) {
+        std::thread worker([&profiler, id]() {
+            profiler.begin_sample(id);
+            profiler.end_sample(id);
+        });
+        worker.join();
+    }
+
+    TEST_ASSERT_EQ(profiler.get_stats(id).call_count, before + thread_count);
+    TEST_ASSERT_LE(profiler.get_thread_count(), Profiler::MAX_THREADS);
+}
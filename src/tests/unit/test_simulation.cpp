@@ -0,0 +1,627 @@
+// src/tests/unit/test_simulation.cpp
+// Game Simulation Unit Tests
+
+#include "test/test_framework.h"
+#include "test/test_fixtures.h"
+#include "map_fixture.h"
+#include "game/combat.h"
+#include "game/economy.h"
+#include "game/facing.h"
+#include "game/job_system.h"
+#include "game/movement.h"
+#include "game/object_heap.h"
+#include "game/projectile.h"
+#include "game/splash_damage.h"
+#include "game/trigger.h"
+#include "game/techno.h"
+#include "game/timer_wheel.h"
+
+#include <algorithm>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+/// A unit at full strength, carrying a cannon if armed
+static TechnoClass* Place_Fighter(HousesType owner, int x, int y, bool armed) {
+    TechnoClass* techno = Place_Unit(x, y, owner);
+    techno->Set_Strength(100);
+    if (armed) {
+        techno->Set_Weapons(WEAPON_120MM);
+    }
+    return techno;
+}
+
+/// Starts and leaves every house's economy empty
+class EconomyFixture : public TestFixture {
+public:
+    void SetUp() override { Reset_Economies(); }
+    void TearDown() override { Reset_Economies(); }
+};
+
+/// Objects, plus an empty trigger engine that records what fires
+class TriggerFixture : public ObjectFixture {
+public:
+    void SetUp() override {
+        TriggerEngine::Instance().Clear();
+        Reset_Economies();
+        TriggerEngine::Instance().Set_Action_Handler([this](int id, const TriggerType&) {
+            fired.push_back(id);
+        });
+    }
+
+    void TearDown() override {
+        TriggerEngine::Instance().Set_Action_Handler(nullptr);
+        TriggerEngine::Instance().Clear();
+        Reset_Economies();
+        ObjectFixture::TearDown();
+    }
+
+    std::vector<int> fired;
+};
+
+//=============================================================================
+// Movement Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(ObjectFixture, Simulation_Movement_TurnThenDrive, "Simulation") {
+    MovementSystem& movement = MovementSystem::Instance();
+    COORDINATE start = Cell_Coord(XY_Cell(10, 10));
+
+    FootClass* unit = Place_Unit(10, 10);
+    unit->Set_Speed(64);
+    unit->Body_Facing().Set_Rate(32);
+    unit->Set_Destination(Cell_Coord(XY_Cell(12, 10)));
+    TEST_ASSERT_EQ(movement.Count(), 1);
+    TEST_ASSERT(unit->Is_Moving());
+
+    // Turns before driving
+    movement.Update();
+    TEST_ASSERT_EQ(unit->Get_Coord(), start);
+    TEST_ASSERT_EQ(unit->Get_Facing(), DIR_NE);
+
+    // Drives once facing
+    movement.Update();
+    TEST_ASSERT_EQ(unit->Get_Facing(), DIR_E);
+    TEST_ASSERT_EQ(unit->Get_Coord(), XY_Coord(Coord_X(start) + 64, Coord_Y(start)));
+    TEST_ASSERT_EQ(movement.Get_Cell_Transitions(), 0u);
+
+    for (int i = 0; i < 8; i++) {
+        movement.Update();
+    }
+    TEST_ASSERT_EQ(unit->Get_Coord(), Cell_Coord(XY_Cell(12, 10)));
+    // Cells marked on transitions only
+    TEST_ASSERT_EQ(movement.Get_Cell_Transitions(), 2u);
+    TEST_ASSERT_EQ(movement.Count(), 0);
+    TEST_ASSERT(!unit->Is_Moving());
+
+    // Freed unit leaves the system
+    unit->Set_Destination(Cell_Coord(XY_Cell(12, 14)));
+    Destroy_Object(unit);
+    TEST_ASSERT_EQ(movement.Count(), 0);
+}
+
+TEST_CASE(Simulation_Facing_RotateBatch, "Simulation") {
+    DirType current[3] = {DIR_N, DIR_N, DIR_E};
+    const DirType desired[3] = {DIR_E, DIR_W, DIR_E};
+    const uint8_t rate[3] = {16, 0, 8};
+    FacingClass::Rotate_Batch(current, desired, rate, 3);
+    TEST_ASSERT_EQ(current[0], 16);         // Steps by rate
+    TEST_ASSERT_EQ(current[1], DIR_W);      // Instant at rate 0
+    TEST_ASSERT_EQ(current[2], DIR_E);      // Holds at target
+}
+
+//=============================================================================
+// Job System Tests
+//=============================================================================
+
+TEST_CASE(Simulation_JobSystem_ParallelFor, "Simulation") {
+    JobSystem& jobs = JobSystem::Instance();
+    std::vector<int> squares(1000, 0);
+    auto square = [&squares](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            squares[i] = i * i;
+        }
+    };
+
+    // Inline jobs cover the range
+    jobs.Parallel_For(1000, 64, square);
+    TEST_ASSERT_EQ(squares[0], 0);
+    TEST_ASSERT_EQ(squares[999], 999 * 999);
+
+    jobs.Start(3);
+    TEST_ASSERT_EQ(jobs.Get_Worker_Count(), 3);
+    std::fill(squares.begin(), squares.end(), -1);
+    jobs.Parallel_For(1000, 7, square);
+    jobs.Stop();
+    TEST_ASSERT(!jobs.Is_Running());
+
+    // Worker jobs cover the range
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_EQ(squares[i], i * i);
+    }
+}
+
+//=============================================================================
+// Combat Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(MapFixture, Simulation_Combat_TargetAndFire, "Simulation") {
+    CombatSystem& combat = CombatSystem::Instance();
+    combat.Reset_Stats();
+
+    TechnoClass* gunner = Place_Fighter(HOUSE_GREECE, 10, 10, true);
+    Place_Fighter(HOUSE_GREECE, 11, 10, true);
+    TechnoClass* near_enemy = Place_Fighter(HOUSE_USSR, 13, 10, false);
+    TechnoClass* far_enemy = Place_Fighter(HOUSE_USSR, 40, 10, true);
+
+    combat.Update();
+    TEST_ASSERT(gunner->Get_Target() == near_enemy);
+    TEST_ASSERT_NULL(far_enemy->Get_Target());      // Out of range
+    TEST_ASSERT_NULL(near_enemy->Get_Target());     // Unarmed holds
+
+    // Fires once on target
+    for (int i = 0; i < 40 && combat.Get_Stats().shots == 0; i++) {
+        AI_All_Objects();
+        combat.Update();
+    }
+    TEST_ASSERT_EQ(combat.Get_Stats().shots, 2u);
+    TEST_ASSERT_EQ(near_enemy->Get_Strength(), 100 - 2 * TECHNO_WEAPON_DAMAGE);
+
+    // Waits to rearm, then fires again
+    for (int i = 0; i < TECHNO_REARM_TICKS - 1; i++) {
+        combat.Update();
+    }
+    TEST_ASSERT_EQ(combat.Get_Stats().shots, 2u);
+    combat.Update();
+    TEST_ASSERT_EQ(combat.Get_Stats().shots, 4u);
+}
+
+TEST_WITH_FIXTURE(MapFixture, Simulation_Combat_IdleScans, "Simulation") {
+    CombatSystem& combat = CombatSystem::Instance();
+
+    // An idle army scans a fraction of the ticks, and still notices
+    std::vector<TechnoClass*> idle;
+    for (int i = 0; i < 64; i++) {
+        idle.push_back(Place_Fighter(HOUSE_GREECE, 60 + i % 8, 60 + i / 8, true));
+    }
+    combat.Reset_Stats();
+    for (int i = 0; i < 40; i++) {
+        combat.Update();
+    }
+    uint32_t idle_scans = combat.Get_Stats().scans;
+    TEST_ASSERT_GT(idle_scans, 64u);
+    TEST_ASSERT_LE(idle_scans, 64u * 40 / CombatSystem::SCAN_WAIT_MIN);
+
+    TechnoClass* intruder = Place_Fighter(HOUSE_USSR, 70, 60, false);
+    int waited = 0;
+    while (idle[7]->Get_Target() != intruder && waited < 20) {
+        combat.Update();
+        waited++;
+    }
+    TEST_ASSERT(idle[7]->Get_Target() == intruder);
+    TEST_ASSERT_LE(waited, CombatSystem::SCAN_WAIT_MIN + CombatSystem::SCAN_WAIT_SPREAD);
+}
+
+TEST_WITH_FIXTURE(MapFixture, Simulation_Combat_Deterministic, "Simulation") {
+    CombatSystem& combat = CombatSystem::Instance();
+
+    // The same battle run inline and on workers must end identically
+    std::vector<int> outcome[2];
+    for (int run = 0; run < 2; run++) {
+        if (run == 1) {
+            JobSystem::Instance().Start(3);
+        }
+        for (int i = 0; i < 400; i++) {
+            Place_Fighter(i % 2 ? HOUSE_USSR : HOUSE_GREECE, 20 + (i % 2) * 3 + (i / 200), 10 + (i / 2) % 100, true);
+        }
+        for (int tick = 0; tick < 120; tick++) {
+            combat.Update();
+            AI_All_Objects();
+        }
+        ObjectHeapBase* heap = Object_Heap(RTTI_UNIT);
+        for (int i = 0; i < heap->Count(); i++) {
+            outcome[run].push_back(heap->Active(i)->Get_Strength());
+        }
+        Destroy_All_Objects();
+    }
+    TEST_ASSERT_GT(std::count(outcome[0].begin(), outcome[0].end(), 0), 0);   // Fought
+    TEST_ASSERT(outcome[0] == outcome[1]);
+}
+
+//=============================================================================
+// Splash Damage Tests
+//=============================================================================
+
+TEST_CASE(Simulation_Splash_Falloff, "Simulation") {
+    TEST_ASSERT_EQ(SplashDamage::Falloff(100, 0, 256), 100);      // Full at center
+    TEST_ASSERT_EQ(SplashDamage::Falloff(100, 256, 256), 50);     // Half at edge
+    TEST_ASSERT_EQ(SplashDamage::Falloff(100, 257, 256), 0);      // None outside
+}
+
+TEST_WITH_FIXTURE(MapFixture, Simulation_Splash_BatchedImpacts, "Simulation") {
+    SplashDamage& splash = SplashDamage::Instance();
+    splash.Reset_Stats();
+    ObjectClass* center = Place_Unit(30, 30);
+    ObjectClass* beside = Place_Unit(31, 30);
+    ObjectClass* far = Place_Unit(36, 30);
+    for (ObjectClass* obj : {center, beside, far}) {
+        obj->Set_Strength(200);
+    }
+
+    // Two overlapping blasts: the center takes both, once
+    splash.Add_Impact(center->Get_Coord(), 40, 256);
+    splash.Add_Impact(beside->Get_Coord(), 40, 256);
+    TEST_ASSERT_EQ(splash.Pending(), 2);
+    TEST_ASSERT_EQ(splash.Resolve(), 2);
+    TEST_ASSERT_EQ(splash.Get_Stats().damaged, 2u);
+    TEST_ASSERT_EQ(splash.Get_Stats().hits, 4u);
+    TEST_ASSERT_EQ(center->Get_Strength(), 200 - 60);
+    TEST_ASSERT_EQ(beside->Get_Strength(), 200 - 60);
+    TEST_ASSERT_EQ(far->Get_Strength(), 200);
+    TEST_ASSERT_EQ(splash.Pending(), 0);
+    TEST_ASSERT_EQ(splash.Resolve(), 0);
+
+    // Landing order does not change the outcome
+    std::vector<int> outcome[2];
+    for (int run = 0; run < 2; run++) {
+        for (ObjectClass* obj : {center, beside, far}) {
+            obj->Set_Strength(200);
+        }
+        for (int i = 0; i < 12; i++) {
+            int k = run == 0 ? i : 11 - i;
+            splash.Add_Impact(XY_Coord(30 * 256 + 128 + k * 64, 30 * 256 + 128), 10 + k, 512);
+        }
+        splash.Resolve();
+        outcome[run] = {center->Get_Strength(), beside->Get_Strength(), far->Get_Strength()};
+    }
+    TEST_ASSERT(outcome[0] == outcome[1]);
+    TEST_ASSERT_LT(outcome[0][0], 200);
+
+    splash.Add_Impact(center->Get_Coord(), 1000, 128);
+    splash.Resolve();
+    TEST_ASSERT(!center->Is_Active());      // Blast destroys
+    TEST_ASSERT(beside->Is_Active());
+}
+
+//=============================================================================
+// Projectile Tests
+//=============================================================================
+
+TEST_CASE(Simulation_Projectiles_FlightAndImpact, "Simulation") {
+    ProjectileSystem pool;
+    COORDINATE from = XY_Coord(1000, 1000);
+    COORDINATE to = XY_Coord(1000 + 301, 1000 - 77);
+
+    int bullet = pool.Fire(3, 5, from, to, 40, 7, 4);
+    TEST_ASSERT_EQ(bullet, 0);
+    TEST_ASSERT(pool.Get_Layer(bullet) == RenderLayer::PROJECTILE);
+    int ticks = pool.Get_Life(bullet);
+    TEST_ASSERT_EQ(ticks, (Coord_Distance(from, to) + 39) / 40);   // Flight time rounds up
+
+    // Bullet moves toward the target and keeps its frame
+    pool.Update();
+    COORDINATE step = pool.Get_Coord(0);
+    TEST_ASSERT_GT(Coord_X(step), 1000);
+    TEST_ASSERT_LT(Coord_Y(step), 1000);
+    TEST_ASSERT_EQ(pool.Get_Frame(0), 5);
+
+    // Arrival starts the impact anim on the target
+    for (int t = 1; t < ticks; t++) {
+        pool.Update();
+    }
+    TEST_ASSERT_EQ(pool.Count(), 1);
+    TEST_ASSERT_EQ(pool.Get_Shape(0), 7);
+    TEST_ASSERT(pool.Get_Layer(0) == RenderLayer::EFFECT);
+    TEST_ASSERT_EQ(pool.Get_Stats().impacts, 1u);
+    TEST_ASSERT_EQ(pool.Get_Coord(0), to);
+
+    pool.Update();
+    TEST_ASSERT_EQ(pool.Get_Frame(0), 1);
+    TEST_ASSERT_EQ(pool.Get_Life(0), 3);
+    for (int t = 0; t < 3; t++) {
+        pool.Update();
+    }
+    TEST_ASSERT_EQ(pool.Count(), 0);
+}
+
+TEST_CASE(Simulation_Projectiles_PoolPacking, "Simulation") {
+    ProjectileSystem pool;
+    COORDINATE from = XY_Coord(1000, 1000);
+
+    // Removal keeps the live entries packed
+    for (int i = 0; i < 10; i++) {
+        pool.Spawn_Anim(1, from, 1 + (i % 2), 0);
+    }
+    pool.Update();
+    TEST_ASSERT_EQ(pool.Count(), 5);
+    TEST_ASSERT_EQ(pool.Get_Life(4), 1);
+
+    // A full pool drops spawns
+    pool.Clear();
+    pool.Reset_Stats();
+    for (int i = 0; i < PROJECTILE_CAPACITY + 3; i++) {
+        pool.Spawn_Anim(1, from, 2);
+    }
+    TEST_ASSERT_EQ(pool.Count(), PROJECTILE_CAPACITY);
+    TEST_ASSERT_EQ(pool.Get_Stats().dropped, 3u);
+}
+
+//=============================================================================
+// Economy Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(EconomyFixture, Simulation_Economy_PowerAndStorage, "Simulation") {
+    HouseEconomy& economy = House_Economy(HOUSE_GREECE);
+    economy.Take_Events();
+
+    // Power follows the buildings
+    economy.Building_Added(BUILDING_POWR);
+    economy.Building_Added(BUILDING_FACT);
+    int plant = Building_Type(BUILDING_POWR)->Get_Power();
+    int yard = -Building_Type(BUILDING_FACT)->Get_Power();
+    TEST_ASSERT_EQ(economy.Power_Output(), plant);
+    TEST_ASSERT_EQ(economy.Power_Drain(), yard);
+    TEST_ASSERT_EQ(economy.Take_Events(), static_cast<uint32_t>(ECON_POWER));
+    economy.Building_Removed(BUILDING_POWR);
+    TEST_ASSERT_EQ(economy.Power_Output(), 0);
+    TEST_ASSERT(economy.Is_Low_Power());
+    economy.Building_Added(BUILDING_POWR);
+    economy.Take_Events();
+
+    // Harvest stops at capacity, spending takes ore first
+    economy.Building_Added(BUILDING_SILO);
+    TEST_ASSERT_EQ(economy.Capacity(), 1500);
+    TEST_ASSERT(economy.Take_Events() & ECON_STORAGE);
+    TEST_ASSERT_EQ(economy.Harvest(2000), 1500);
+    TEST_ASSERT_EQ(economy.Stored_Ore(), 1500);
+    economy.Refund_Money(500);
+    TEST_ASSERT(economy.Spend_Money(1000));
+    TEST_ASSERT_EQ(economy.Stored_Ore(), 500);
+    TEST_ASSERT_EQ(economy.Credits(), 500);
+    TEST_ASSERT(!economy.Spend_Money(1001));
+    TEST_ASSERT_EQ(economy.Available_Money(), 1000);
+
+    // Idle tick is silent
+    economy.Take_Events();
+    economy.AI();
+    TEST_ASSERT_EQ(economy.Take_Events(), 0u);
+}
+
+TEST_WITH_FIXTURE(EconomyFixture, Simulation_Economy_Production, "Simulation") {
+    HouseEconomy& economy = House_Economy(HOUSE_GREECE);
+    economy.Building_Added(BUILDING_POWR);
+    economy.Building_Added(BUILDING_FACT);
+    economy.Building_Added(BUILDING_SILO);
+    economy.Harvest(500);
+    economy.Refund_Money(500);
+
+    TEST_ASSERT(economy.Start_Production(FACTORY_UNIT, 3, 540, 540));
+    TEST_ASSERT(!economy.Start_Production(FACTORY_UNIT, 4, 100));      // Busy factory refuses
+    economy.Take_Events();
+    for (int i = 0; i < 9; i++) {
+        economy.AI();
+    }
+    TEST_ASSERT_EQ(economy.Take_Events(), 0u);
+    TEST_ASSERT_EQ(economy.Factory(FACTORY_UNIT).step, 0);
+
+    // Each step is charged and reported
+    economy.AI();
+    TEST_ASSERT_EQ(economy.Factory(FACTORY_UNIT).step, 1);
+    TEST_ASSERT_EQ(economy.Available_Money(), 990);
+    TEST_ASSERT_EQ(economy.Take_Events(), static_cast<uint32_t>(ECON_FACTORY | ECON_CREDITS));
+
+    economy.Set_On_Hold(FACTORY_UNIT, true);
+    for (int i = 0; i < 20; i++) {
+        economy.AI();
+    }
+    TEST_ASSERT_EQ(economy.Factory(FACTORY_UNIT).step, 1);
+    economy.Set_On_Hold(FACTORY_UNIT, false);
+    for (int i = 0; i < 10 * 53; i++) {
+        economy.AI();
+    }
+    TEST_ASSERT(economy.Factory(FACTORY_UNIT).Is_Done());
+    TEST_ASSERT_EQ(economy.Available_Money(), 1000 - 540);
+    TEST_ASSERT_EQ(economy.Take_Completed(FACTORY_UNIT), 3);
+    TEST_ASSERT(!economy.Factory(FACTORY_UNIT).Is_Busy());
+
+    // A broke factory waits, abandoning refunds what was spent
+    economy.Start_Production(FACTORY_BUILDING, 1, 5400, 540);
+    for (int i = 0; i < 100; i++) {
+        economy.AI();
+    }
+    TEST_ASSERT_EQ(economy.Factory(FACTORY_BUILDING).step, 4);
+    TEST_ASSERT_EQ(economy.Available_Money(), 60);
+    economy.Abandon_Production(FACTORY_BUILDING);
+    TEST_ASSERT_EQ(economy.Available_Money(), 460);
+
+    // Lost storage spills the ore
+    economy.Harvest(300);
+    economy.Building_Removed(BUILDING_SILO);
+    TEST_ASSERT_EQ(economy.Stored_Ore(), 0);
+    TEST_ASSERT_EQ(economy.Available_Money(), 460);
+}
+
+//=============================================================================
+// Timer Wheel Tests
+//=============================================================================
+
+TEST_CASE(Simulation_TimerWheel_FiresOnItsTick, "Simulation") {
+    TimerWheel wheel;
+    std::vector<uint32_t> fired;
+    auto record = [&](uint32_t payload) { fired.push_back(payload); };
+
+    TimerWheel::TimerId soon = wheel.Schedule(3, 1);
+    wheel.Schedule(3, 2);
+    TimerWheel::TimerId later = wheel.Schedule(100, 3);
+    TimerWheel::TimerId far = wheel.Schedule(300000, 4);
+    TEST_ASSERT_NE(soon, TimerWheel::TIMER_NONE);
+    TEST_ASSERT_EQ(wheel.Count(), 4);
+    TEST_ASSERT_EQ(wheel.Due(later), 100u);
+    TEST_ASSERT(wheel.Is_Pending(far));
+
+    wheel.Advance(record);
+    wheel.Advance(record);
+    TEST_ASSERT(fired.empty());
+
+    // Same tick fires in schedule order, and the timer is gone
+    TEST_ASSERT_EQ(wheel.Advance(record), 2);
+    TEST_ASSERT_EQ(fired.size(), 2u);
+    TEST_ASSERT_EQ(fired[0], 1u);
+    TEST_ASSERT_EQ(fired[1], 2u);
+    TEST_ASSERT(!wheel.Is_Pending(soon));
+    TEST_ASSERT(!wheel.Cancel(soon));
+
+    TEST_ASSERT(wheel.Cancel(later));
+    TEST_ASSERT(!wheel.Is_Pending(later));
+    TEST_ASSERT_EQ(wheel.Count(), 1);
+
+    // A far timer waits for its own tick
+    while (wheel.Now() < 299999) {
+        wheel.Advance(record);
+    }
+    TEST_ASSERT_EQ(fired.size(), 2u);
+    wheel.Advance(record);
+    TEST_ASSERT_EQ(fired.size(), 3u);
+    TEST_ASSERT_EQ(fired[2], 4u);
+    TEST_ASSERT_EQ(wheel.Count(), 0);
+}
+
+TEST_CASE(Simulation_TimerWheel_HandlersReschedule, "Simulation") {
+    TimerWheel wheel;
+    std::vector<uint32_t> fired;
+
+    // A handler can reschedule itself and cancel a timer due the same tick
+    wheel.Schedule(2, 7);
+    TimerWheel::TimerId victim = wheel.Schedule(2, 99);
+    int repeats = 0;
+    auto handler = [&](uint32_t payload) {
+        fired.push_back(payload);
+        wheel.Cancel(victim);
+        if (payload == 7 && repeats++ < 3) {
+            wheel.Schedule(5, 7);
+        }
+    };
+    for (int i = 0; i < 30; i++) {
+        wheel.Advance(handler);
+    }
+    TEST_ASSERT(fired == std::vector<uint32_t>({7, 7, 7, 7}));
+}
+
+TEST_CASE(Simulation_TimerWheel_MatchesDueList, "Simulation") {
+    TimerWheel wheel;
+    std::vector<uint32_t> fired;
+    auto record = [&](uint32_t payload) { fired.push_back(payload); };
+
+    // Against a plain list of due ticks
+    std::vector<uint32_t> due(2000);
+    std::vector<TimerWheel::TimerId> ids(2000);
+    uint32_t seed = 12345;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        due[i] = 1 + (seed >> 8) % (i % 3 == 0 ? 50000 : 300);
+        ids[i] = wheel.Schedule(due[i], i);
+    }
+    for (int i = 0; i < 2000; i += 7) {
+        wheel.Cancel(ids[i]);
+        due[i] = 0;
+    }
+    while (wheel.Count() > 0 && wheel.Now() < 60000) {
+        fired.clear();
+        wheel.Advance(record);
+        for (uint32_t payload : fired) {
+            TEST_ASSERT_EQ(due[payload], wheel.Now());
+            due[payload] = 0;
+        }
+    }
+    TEST_ASSERT_EQ(wheel.Count(), 0);
+    TEST_ASSERT_EQ(std::count(due.begin(), due.end(), 0u), 2000);
+}
+
+//=============================================================================
+// Trigger Tests
+//=============================================================================
+
+TEST_WITH_FIXTURE(TriggerFixture, Simulation_Triggers_CellEntered, "Simulation") {
+    TriggerEngine& triggers = TriggerEngine::Instance();
+
+    // Many triggers nobody springs cost nothing
+    TriggerType idle;
+    idle.event1 = {TEVENT_ENTERED, HOUSE_NONE, 0};
+    for (int i = 0; i < 500; i++) {
+        triggers.Attach_Cell(triggers.Add(idle), XY_Cell(i % 100, 100 + i / 100));
+    }
+    FootClass* unit = Place_Unit(10, 10, HOUSE_GREECE);
+    for (int i = 0; i < 100; i++) {
+        triggers.Update();
+    }
+    TEST_ASSERT_EQ(triggers.Evaluations(), 0u);
+    TEST_ASSERT(fixture.fired.empty());
+
+    TriggerType enter;
+    enter.event1 = {TEVENT_ENTERED, HOUSE_GREECE, 0};
+    int enter_id = triggers.Add(enter);
+    triggers.Attach_Cell(enter_id, XY_Cell(11, 10));
+    TEST_ASSERT(triggers.Is_Cell_Watched(XY_Cell(11, 10)));
+    TEST_ASSERT(!triggers.Is_Cell_Watched(XY_Cell(12, 10)));
+
+    // Entering fires that trigger only, and a volatile trigger retires
+    unit->Set_Coord(Cell_Coord(XY_Cell(11, 10)));
+    triggers.Update();
+    TEST_ASSERT_EQ(fixture.fired.size(), 1u);
+    TEST_ASSERT_EQ(fixture.fired[0], enter_id);
+    TEST_ASSERT_EQ(triggers.Evaluations(), 1u);
+    TEST_ASSERT(!triggers.Is_Active(enter_id));
+
+    // Another house's cell trigger waits
+    TriggerType other_house;
+    other_house.event1 = {TEVENT_ENTERED, HOUSE_USSR, 0};
+    triggers.Attach_Cell(triggers.Add(other_house), XY_Cell(12, 10));
+    unit->Set_Coord(Cell_Coord(XY_Cell(12, 10)));
+    triggers.Update();
+    TEST_ASSERT_EQ(fixture.fired.size(), 1u);
+}
+
+TEST_WITH_FIXTURE(TriggerFixture, Simulation_Triggers_PersistentTimer, "Simulation") {
+    TriggerEngine& triggers = TriggerEngine::Instance();
+
+    TriggerType timer;
+    timer.event1 = {TEVENT_TIME, HOUSE_NONE, 5};
+    timer.persist = TRIGGER_PERSISTENT;
+    int timer_id = triggers.Add(timer);
+    for (int i = 0; i < 4; i++) {
+        triggers.Update();
+    }
+    TEST_ASSERT_EQ(triggers.Fire_Count(timer_id), 0);
+    triggers.Update();
+    TEST_ASSERT_EQ(triggers.Fire_Count(timer_id), 1);
+
+    // Rearms after firing
+    for (int i = 0; i < 5; i++) {
+        triggers.Update();
+    }
+    TEST_ASSERT_EQ(triggers.Fire_Count(timer_id), 2);
+}
+
+TEST_WITH_FIXTURE(TriggerFixture, Simulation_Triggers_AndWaitsForBoth, "Simulation") {
+    TriggerEngine& triggers = TriggerEngine::Instance();
+    FootClass* unit = Place_Unit(10, 10, HOUSE_GREECE);
+
+    TriggerType both;
+    both.event1 = {TEVENT_DESTROYED, HOUSE_NONE, 0};
+    both.event2 = {TEVENT_CREDITS, HOUSE_GREECE, 1000};
+    both.logic = TRIGGER_AND;
+    int both_id = triggers.Add(both);
+    triggers.Attach_Object(both_id, unit);
+    House_Economy(HOUSE_GREECE).Refund_Money(500);
+    triggers.Update();
+    House_Economy(HOUSE_GREECE).Refund_Money(600);
+    triggers.Update();
+    TEST_ASSERT_EQ(triggers.Fire_Count(both_id), 0);
+
+    unit->Destroyed();
+    triggers.Update();
+    TEST_ASSERT_EQ(triggers.Fire_Count(both_id), 1);
+    TEST_ASSERT(!triggers.Is_Watching_Objects());       // Destroyed object unwatched
+}
@@ -3,9 +3,19 @@
 // Task 18b - Unit Tests
 
 #include "test/test_framework.h"
+#include "game/coord.h"
+#include "game/core/containers.h"
+#include "game/facing.h"
+#include "game/fixed.h"
+#include "game/random.h"
+#include "game/weapon.h"
+#include "platform.h"
+#include "platform/alloc_tracker.h"
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <string>
+#include <utility>
 
 //=============================================================================
 // String Utility Tests
@@ -189,6 +199,32 @@ TEST_CASE(Utils_Fixed_Multiply, "Utils") {
     TEST_ASSERT_EQ(integer_part, 5);
 }
 
+TEST_CASE(Utils_Fixed_Class, "Utils") {
+    constexpr fixed half = fixed::Ratio(1, 2);
+    static_assert((half * 3).Raw() == 3 * fixed::ONE / 2, "constexpr fixed");
+    TEST_ASSERT_EQ(fixed(5).To_Int(), 5);
+    TEST_ASSERT_EQ(fixed(-5).To_Int(), -5);
+    TEST_ASSERT_EQ((half * fixed(75)).To_Int(), 37);
+    TEST_ASSERT_EQ((half * 75).Round(), 38);
+    TEST_ASSERT(fixed(7) / fixed(2) == fixed(7) / 2);
+    TEST_ASSERT_EQ((fixed(7) / 2).Round(), 4);
+
+    // Negatives truncate toward zero and round away from it
+    TEST_ASSERT_EQ((fixed(-7) / 2).To_Int(), -3);
+    TEST_ASSERT_EQ((fixed(-7) / 2).Round(), -4);
+
+    // Ratios round down
+    TEST_ASSERT_EQ(fixed::Ratio(-1, 3).Raw(), -21846);
+    TEST_ASSERT_EQ(fixed::Ratio(1, 3).Raw(), 21845);
+    TEST_ASSERT(fixed::Ratio(1, 3) < half);
+    TEST_ASSERT(-half < fixed(0));
+}
+
+TEST_CASE(Utils_Fixed_ArmorModifier, "Utils") {
+    const WarheadVsArmor versus = {{100, 75, 50, 25, 10}};
+    TEST_ASSERT_EQ((versus.Modifier(ARMOR_HEAVY) * 100).To_Int(), 25);
+}
+
 //=============================================================================
 // Random Number Tests
 //=============================================================================
@@ -223,6 +259,47 @@ TEST_CASE(Utils_Random_InRange, "Utils") {
     }
 }
 
+TEST_CASE(Utils_RandomStream_MatchesPlatform, "Utils") {
+    RandomStream stream(777);
+    Platform_Random_Seed(777);
+
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_EQ(stream.Next(), Platform_Random_Get());
+        TEST_ASSERT_EQ(stream.Range(-5, 90), Platform_Random_Range(-5, 90));
+        TEST_ASSERT_EQ(stream.Max(13), Platform_Random_Max(13));
+    }
+    TEST_ASSERT_EQ(stream.Get_Seed(), Platform_Random_GetSeed());
+    TEST_ASSERT_EQ(stream.Range(4, 4), 4);
+    TEST_ASSERT_EQ(stream.Max(0), 0u);
+}
+
+TEST_CASE(Utils_RandomStream_FillMatchesNext, "Utils") {
+    // Counts around the eight-lane block size
+    const size_t counts[] = {0, 1, 7, 8, 9, 64, 131};
+    for (size_t count : counts) {
+        RandomStream batch(4242);
+        RandomStream single(4242);
+        uint32_t values[131];
+        batch.Fill(values, count);
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQ(values[i], single.Next());
+        }
+        TEST_ASSERT_EQ(batch.Get_Seed(), single.Get_Seed());
+    }
+}
+
+TEST_CASE(Utils_RandomStream_FxLeavesSimAlone, "Utils") {
+    Sim_Random_Seed(99);
+    RandomStream expected(99);
+
+    uint32_t effects[32];
+    Fx_Random().Fill(effects, 32);
+    Fx_Random().Next();
+
+    TEST_ASSERT_EQ(Sim_Random().Next(), expected.Next());
+    TEST_ASSERT_EQ(Platform_Random_GetSeed(), 99u);
+}
+
 //=============================================================================
 // Direction/Facing Tests
 //=============================================================================
@@ -268,6 +345,44 @@ TEST_CASE(Utils_Direction_FromDelta, "Utils") {
     TEST_ASSERT_EQ(direction_from_delta(-1, 0), 6);   // West
 }
 
+TEST_CASE(Utils_Direction_DirFromXY, "Utils") {
+    TEST_ASSERT_EQ(Dir_From_XY(0, -9), DIR_N);
+    TEST_ASSERT_EQ(Dir_From_XY(9, 0), DIR_E);
+    TEST_ASSERT_EQ(Dir_From_XY(0, 9), DIR_S);
+    TEST_ASSERT_EQ(Dir_From_XY(-9, 0), DIR_W);
+    TEST_ASSERT_EQ(Dir_From_XY(7, -7), DIR_NE);
+    TEST_ASSERT_EQ(Dir_From_XY(-7, 7), DIR_SW);
+
+    // Rounds to the nearest of the 256 directions
+    TEST_ASSERT_EQ(Dir_From_XY(5, -2), 49);
+    TEST_ASSERT_EQ(Dir_From_XY(-81, 922), 131);
+}
+
+TEST_CASE(Utils_Direction_AxisFactors, "Utils") {
+    TEST_ASSERT_EQ(Dir_X_Factor(DIR_E), 256);
+    TEST_ASSERT_EQ(Dir_Y_Factor(DIR_N), -256);
+    TEST_ASSERT_EQ(Dir_X_Factor(DIR_S), 0);
+    TEST_ASSERT_EQ(DirYFactorTable[DIR_S], 256);
+    TEST_ASSERT_EQ(Dir_X_Factor(DIR_NE), 181);
+    TEST_ASSERT_EQ(Dir_Y_Factor(DIR_NE), -181);
+}
+
+TEST_CASE(Utils_Direction_CoordBatch, "Utils") {
+    COORDINATE origin = Cell_Coord(XY_Cell(40, 40));
+    const COORDINATE from[3] = {origin, origin, origin};
+    const COORDINATE to[3] = {Cell_Coord(XY_Cell(40, 30)), Cell_Coord(XY_Cell(45, 45)),
+                              Coord_Move(origin, DIR_W, 512)};
+    uint8_t dirs[3];
+    Coord_Direction_Batch(from, to, dirs, 3);
+    TEST_ASSERT_EQ(dirs[0], DIR_N);
+    TEST_ASSERT_EQ(dirs[1], DIR_SE);
+    TEST_ASSERT_EQ(dirs[2], DIR_W);
+
+    // Move by factors
+    TEST_ASSERT_EQ(Coord_X(to[2]), Coord_X(origin) - 512);
+    TEST_ASSERT_EQ(Coord_Y(to[2]), Coord_Y(origin));
+}
+
 //=============================================================================
 // Coordinate/Cell Tests
 //=============================================================================
@@ -301,6 +416,15 @@ TEST_CASE(Utils_Coord_IndexToCell, "Utils") {
     TEST_ASSERT_EQ(index_to_cell_y(645), 10);
 }
 
+TEST_CASE(Utils_Coord_Lerp, "Utils") {
+    COORDINATE coord = Cell_Coord(XY_Cell(64, 64));
+    COORDINATE next = XY_Coord(Coord_X(coord) + 64, Coord_Y(coord));
+
+    TEST_ASSERT_EQ(Coord_Lerp(coord, next, 0.0f), coord);
+    TEST_ASSERT_EQ(Coord_Lerp(coord, next, 1.0f), next);
+    TEST_ASSERT_EQ(Coord_X(Coord_Lerp(coord, next, 0.5f)), Coord_X(coord) + 32);
+}
+
 //=============================================================================
 // Memory/Endian Tests
 //=============================================================================
@@ -326,3 +450,68 @@ TEST_CASE(Utils_Endian_LittleEndian32, "Utils") {
 
     TEST_ASSERT_EQ(value, 0x12345678u);
 }
+
+//=============================================================================
+// Container Tests
+//=============================================================================
+
+TEST_CASE(Utils_Containers_FixedString, "Utils") {
+    FixedString<8> name("E1.SHP");
+    TEST_ASSERT(name == "E1.SHP");
+    TEST_ASSERT_EQ(name.size(), 6u);
+    name = "TOOLONGNAME.SHP";
+    TEST_ASSERT_EQ(name.size(), 7u);
+    TEST_ASSERT_EQ(strcmp(name.c_str(), "TOOLONG"), 0);
+    name.clear();
+    TEST_ASSERT(name.empty());
+    TEST_ASSERT_EQ(name.c_str()[0], '\0');
+}
+
+TEST_CASE(Utils_Containers_SmallVector, "Utils") {
+    uint64_t before = AllocTracker::instance().get_total_allocations();
+    SmallVector<int, 4> small;
+    for (int i = 0; i < 4; i++) {
+        small.push_back(i * 10);
+    }
+    TEST_ASSERT(small.is_inline());
+    TEST_ASSERT_EQ(small.size(), 4u);
+    TEST_ASSERT_EQ(small.back(), 30);
+    if (AllocTracker::is_enabled()) {
+        TEST_ASSERT_EQ(AllocTracker::instance().get_total_allocations(), before);    // Inline skips the heap
+    }
+
+    // Spills past capacity
+    small.push_back(small[0]);
+    TEST_ASSERT(!small.is_inline());
+    TEST_ASSERT_EQ(small.size(), 5u);
+    TEST_ASSERT_EQ(small[4], 0);
+
+    // Erase keeps order
+    small.erase(small.begin() + 1, small.begin() + 3);
+    TEST_ASSERT_EQ(small.size(), 3u);
+    TEST_ASSERT_EQ(small[0], 0);
+    TEST_ASSERT_EQ(small[1], 30);
+    TEST_ASSERT_EQ(small[2], 0);
+
+    SmallVector<std::string, 2> strings;
+    strings.emplace_back("alpha");
+    strings.emplace_back("beta");
+    strings.emplace_back("gamma");
+    SmallVector<std::string, 2> copy = strings;
+    SmallVector<std::string, 2> moved = std::move(strings);
+    TEST_ASSERT(copy == moved);
+    TEST_ASSERT_EQ(moved.size(), 3u);
+    TEST_ASSERT(strings.empty());
+}
+
+TEST_CASE(Utils_Containers_FunctionRef, "Utils") {
+    int total = 0;
+    auto add = [&total](int n) { total += n; };
+    FunctionRef<void(int)> ref = add;
+    ref(3);
+    ref(4);
+    FunctionRef<void(int)> empty_ref;
+    TEST_ASSERT_EQ(total, 7);
+    TEST_ASSERT(static_cast<bool>(ref));
+    TEST_ASSERT(!empty_ref);
+}
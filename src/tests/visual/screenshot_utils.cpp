@@ -7,6 +7,15 @@
 #include <fstream>
 #include <cstring>
 #include <algorithm>
+#include <map>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCREENSHOT_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define SCREENSHOT_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
 
 // Simple BMP file writing (no external dependencies)
 static bool WriteBMP(const char* filename, const uint8_t* data,
@@ -122,73 +131,276 @@ bool Screenshot_CaptureToBuffer(std::vector<uint8_t>& out_buffer,
     return true;
 }
 
-ImageCompareResult Screenshot_Compare(const uint8_t* a, const uint8_t* b,
-                                       int width, int height, int threshold) {
-    ImageCompareResult result = {};
-    result.total_pixels = width * height;
-
-    for (int i = 0; i < result.total_pixels; i++) {
-        int diff = std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
-        result.max_difference = std::max(result.max_difference, diff);
+//=============================================================================
+// Image Comparison
+//=============================================================================
+
+namespace {
+
+// Differences found so far; rows are fed top to bottom
+struct DiffAccumulator {
+    int count = 0;
+    int max_difference = 0;
+    int left = -1, top = -1, right = -1, bottom = -1;
+
+    void Add_Run(int y, int first_x, int last_x, int pixels) {
+        if (pixels == 0) return;
+        count += pixels;
+        if (top < 0) {
+            top = y;
+            left = first_x;
+            right = last_x;
+        }
+        bottom = y;
+        left = std::min(left, first_x);
+        right = std::max(right, last_x);
+    }
 
+    ImageCompareResult Finish(int width, int height) const {
+        ImageCompareResult result = {};
+        result.total_pixels = width * height;
+        result.different_pixels = count;
+        result.max_difference = max_difference;
+        result.diff_left = left;
+        result.diff_top = top;
+        result.diff_right = right;
+        result.diff_bottom = bottom;
+        result.difference_ratio = result.total_pixels > 0
+            ? static_cast<float>(count) / result.total_pixels : 0.0f;
+        result.match = result.difference_ratio < 0.01f;  // < 1% different
+        return result;
+    }
+};
+
+// Scan one row span pixel by pixel, returning the differing count and
+// widening [first_x, last_x]
+int Compare_Span_Scalar(const uint8_t* a, const uint8_t* b, int x0, int x1,
+                        int threshold, int& max_diff, int& first_x, int& last_x) {
+    int count = 0;
+    for (int x = x0; x < x1; x++) {
+        int diff = std::abs(static_cast<int>(a[x]) - static_cast<int>(b[x]));
+        max_diff = std::max(max_diff, diff);
         if (diff > threshold) {
-            result.different_pixels++;
+            if (first_x < 0) first_x = x;
+            last_x = x;
+            count++;
         }
     }
+    return count;
+}
 
-    result.difference_ratio =
-        static_cast<float>(result.different_pixels) / result.total_pixels;
-    result.match = result.difference_ratio < 0.01f;  // < 1% different
-
-    return result;
+#if SCREENSHOT_HAVE_SSE2
+int Popcount16(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    int count = 0;
+    for (; mask; mask &= mask - 1) count++;
+    return count;
+#endif
 }
 
-std::string Screenshot_GetReferencePath(const char* name) {
-    return std::string("reference/") + name + ".bmp";
+int Lowest_Bit(uint32_t mask) {
+    int bit = 0;
+    while (!(mask & 1u)) { mask >>= 1; bit++; }
+    return bit;
 }
 
-bool Screenshot_SaveReference(const char* name) {
-    std::string path = Screenshot_GetReferencePath(name);
-    return Screenshot_Capture(path.c_str());
+int Highest_Bit(uint32_t mask) {
+    int bit = -1;
+    while (mask) { mask >>= 1; bit++; }
+    return bit;
 }
+#endif
+
+int Compare_Row(const uint8_t* a, const uint8_t* b, int width, int threshold,
+                int& max_diff, int& first_x, int& last_x) {
+    int x = 0;
+    int count = 0;
+
+#if SCREENSHOT_HAVE_SSE2 || SCREENSHOT_HAVE_NEON
+    uint8_t limit = static_cast<uint8_t>(std::min(std::max(threshold, 0), 255));
+#endif
+
+#if SCREENSHOT_HAVE_SSE2
+    // |a - b| from two saturating subtracts; over threshold where the
+    // difference survives subtracting the threshold
+    const __m128i thr = _mm_set1_epi8(static_cast<char>(limit));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i max_vec = zero;
+    for (; x + 16 <= width; x += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        max_vec = _mm_max_epu8(max_vec, diff);
+        __m128i over = _mm_subs_epu8(diff, thr);
+        uint32_t mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(over, zero))) ^ 0xFFFFu;
+        if (mask) {
+            if (first_x < 0) first_x = x + Lowest_Bit(mask);
+            last_x = x + Highest_Bit(mask);
+            count += Popcount16(mask);
+        }
+    }
+    alignas(16) uint8_t lanes[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), max_vec);
+    for (uint8_t lane : lanes) {
+        max_diff = std::max(max_diff, static_cast<int>(lane));
+    }
+#elif SCREENSHOT_HAVE_NEON
+    const uint8x16_t thr = vdupq_n_u8(limit);
+    uint8x16_t max_vec = vdupq_n_u8(0);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(a + x), vld1q_u8(b + x));
+        max_vec = vmaxq_u8(max_vec, diff);
+        if (vmaxvq_u8(vcgtq_u8(diff, thr)) != 0) {
+            // Rare in a passing frame; find the exact pixels in scalar
+            int block_max = 0;
+            count += Compare_Span_Scalar(a, b, x, x + 16, threshold,
+                                         block_max, first_x, last_x);
+        }
+    }
+    max_diff = std::max(max_diff, static_cast<int>(vmaxvq_u8(max_vec)));
+#endif
 
-ImageCompareResult Screenshot_CompareToReference(const char* reference_file,
-                                                  int threshold) {
-    ImageCompareResult result = {};
-    result.match = false;
+    count += Compare_Span_Scalar(a, b, x, width, threshold, max_diff, first_x, last_x);
+    return count;
+}
 
-    // Capture current
-    std::vector<uint8_t> current;
-    int cur_w, cur_h;
-    if (!Screenshot_CaptureToBuffer(current, cur_w, cur_h)) {
-        return result;
+// Redmean color distance, a cheap close fit to perceived difference
+int Color_Distance(const PaletteEntry& p, const PaletteEntry& q) {
+    int mean_r = (p.r + q.r) / 2;
+    int dr = p.r - q.r;
+    int dg = p.g - q.g;
+    int db = p.b - q.b;
+    int weighted = (((512 + mean_r) * dr * dr) >> 8) + 4 * dg * dg +
+                   (((767 - mean_r) * db * db) >> 8);
+    int root = 0;
+    while ((root + 1) * (root + 1) <= weighted) {
+        root++;
     }
+    return root;
+}
 
-    // Load reference
-    std::vector<uint8_t> reference;
-    int ref_w, ref_h;
-    if (!Screenshot_LoadReference(reference_file, reference, ref_w, ref_h)) {
-        return result;
+} // namespace
+
+ImageCompareResult Screenshot_Compare(const uint8_t* a, const uint8_t* b,
+                                       int width, int height, int threshold) {
+    DiffAccumulator acc;
+    for (int y = 0; y < height; y++) {
+        int first_x = -1, last_x = -1;
+        int count = Compare_Row(a + y * width, b + y * width, width, threshold,
+                                acc.max_difference, first_x, last_x);
+        acc.Add_Run(y, first_x, last_x, count);
     }
+    return acc.Finish(width, height);
+}
 
-    // Size mismatch
-    if (cur_w != ref_w || cur_h != ref_h) {
-        result.different_pixels = cur_w * cur_h;
-        result.total_pixels = cur_w * cur_h;
-        result.difference_ratio = 1.0f;
-        return result;
+ImageCompareResult Screenshot_ComparePerceptual(
+    const uint8_t* a, const PaletteEntry* palette_a,
+    const uint8_t* b, const PaletteEntry* palette_b,
+    int width, int height, int tolerance) {
+    // Only index pairs that actually occur need a distance
+    std::vector<int16_t> distance(256 * 256, -1);
+    bool same_palette = memcmp(palette_a, palette_b, 256 * sizeof(PaletteEntry)) == 0;
+
+    DiffAccumulator acc;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row_a = a + y * width;
+        const uint8_t* row_b = b + y * width;
+        int first_x = -1, last_x = -1;
+        int count = 0;
+        for (int x = 0; x < width; x += 16) {
+            int span = std::min(width - x, 16);
+
+            // Identical indices under one palette are identical colors, so
+            // blocks the vector compare finds equal need no lookups
+            if (same_palette) {
+                int block_max = 0, block_first = -1, block_last = -1;
+                if (Compare_Row(row_a + x, row_b + x, span, 0,
+                                block_max, block_first, block_last) == 0) {
+                    continue;
+                }
+            }
+            for (int i = x; i < x + span; i++) {
+                int pa = row_a[i];
+                int pb = row_b[i];
+                int16_t& d = distance[pa * 256 + pb];
+                if (d < 0) {
+                    d = static_cast<int16_t>(Color_Distance(palette_a[pa], palette_b[pb]));
+                }
+                acc.max_difference = std::max(acc.max_difference, static_cast<int>(d));
+                if (d > tolerance) {
+                    if (first_x < 0) first_x = i;
+                    last_x = i;
+                    count++;
+                }
+            }
+        }
+        acc.Add_Run(y, first_x, last_x, count);
     }
+    return acc.Finish(width, height);
+}
 
-    return Screenshot_Compare(current.data(), reference.data(),
-                              cur_w, cur_h, threshold);
+//=============================================================================
+// Reference Images
+//=============================================================================
+
+namespace {
+
+// Compact reference header; the palette (256 RGB) and LCW data follow
+struct ReferenceHeader {
+    char magic[4];              // "RREF"
+    uint16_t version;
+    uint16_t width;
+    uint16_t height;
+    uint16_t reserved;
+    uint32_t compressed_size;
+};
+static_assert(sizeof(ReferenceHeader) == 16, "Reference header is 16 bytes on disk");
+
+const uint16_t REFERENCE_VERSION = 1;
+const int MAX_REFERENCE_SIZE = 4096;
+
+struct CachedReference {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+    PaletteEntry palette[256];
+};
+
+std::map<std::string, CachedReference>& Reference_Cache() {
+    static std::map<std::string, CachedReference> cache;
+    return cache;
 }
 
-bool Screenshot_LoadReference(const char* name,
-                               std::vector<uint8_t>& buffer,
-                               int& width, int& height) {
-    std::string path = Screenshot_GetReferencePath(name);
+bool Read_Compact(const std::string& path, CachedReference& ref) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
 
-    // Simple BMP loading
+    ReferenceHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || memcmp(header.magic, "RREF", 4) != 0 ||
+        header.version != REFERENCE_VERSION ||
+        header.width == 0 || header.height == 0 ||
+        header.width > MAX_REFERENCE_SIZE || header.height > MAX_REFERENCE_SIZE) {
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(ref.palette), sizeof(ref.palette));
+    std::vector<uint8_t> packed(header.compressed_size);
+    file.read(reinterpret_cast<char*>(packed.data()), packed.size());
+    if (!file) return false;
+
+    ref.width = header.width;
+    ref.height = header.height;
+    ref.pixels.resize(ref.width * ref.height);
+    int32_t unpacked = Platform_LCW_Decompress(packed.data(), static_cast<int32_t>(packed.size()),
+                                               ref.pixels.data(), static_cast<int32_t>(ref.pixels.size()));
+    return unpacked == static_cast<int32_t>(ref.pixels.size());
+}
+
+bool Read_BMP(const std::string& path, CachedReference& ref) {
     std::ifstream file(path, std::ios::binary);
     if (!file) return false;
 
@@ -196,28 +408,196 @@ bool Screenshot_LoadReference(const char* name,
     uint8_t header[54];
     file.read(reinterpret_cast<char*>(header), 54);
 
-    if (header[0] != 'B' || header[1] != 'M') {
+    if (!file || header[0] != 'B' || header[1] != 'M') {
         return false;
     }
 
-    width = *reinterpret_cast<int32_t*>(&header[18]);
-    height = *reinterpret_cast<int32_t*>(&header[22]);
+    int width = *reinterpret_cast<int32_t*>(&header[18]);
+    int height = *reinterpret_cast<int32_t*>(&header[22]);
 
-    if (width <= 0 || height <= 0 || width > 4096 || height > 4096) {
+    if (width <= 0 || height <= 0 || width > MAX_REFERENCE_SIZE || height > MAX_REFERENCE_SIZE) {
         return false;
     }
 
-    // Skip palette
-    file.seekg(54 + 1024);
+    // Palette (BGRA)
+    for (int i = 0; i < 256; i++) {
+        uint8_t bgra[4];
+        file.read(reinterpret_cast<char*>(bgra), 4);
+        ref.palette[i].r = bgra[2];
+        ref.palette[i].g = bgra[1];
+        ref.palette[i].b = bgra[0];
+    }
 
     // Read pixel data
     int row_padding = (4 - (width % 4)) % 4;
-    buffer.resize(width * height);
+    ref.width = width;
+    ref.height = height;
+    ref.pixels.resize(width * height);
 
     for (int y = height - 1; y >= 0; y--) {
-        file.read(reinterpret_cast<char*>(buffer.data() + y * width), width);
+        file.read(reinterpret_cast<char*>(ref.pixels.data() + y * width), width);
         file.seekg(row_padding, std::ios::cur);
     }
 
+    return static_cast<bool>(file);
+}
+
+// A cached reference, loading it on first use
+const CachedReference* Find_Reference(const char* name) {
+    auto& cache = Reference_Cache();
+    auto it = cache.find(name);
+    if (it != cache.end()) {
+        return &it->second;
+    }
+
+    CachedReference ref;
+    if (!Read_Compact(Screenshot_GetReferencePath(name), ref) &&
+        !Read_BMP(std::string("reference/") + name + ".bmp", ref)) {
+        return nullptr;
+    }
+    return &(cache[name] = std::move(ref));
+}
+
+ImageCompareResult Size_Mismatch(int width, int height) {
+    ImageCompareResult result = {};
+    result.total_pixels = width * height;
+    result.different_pixels = result.total_pixels;
+    result.difference_ratio = 1.0f;
+    result.diff_left = 0;
+    result.diff_top = 0;
+    result.diff_right = width - 1;
+    result.diff_bottom = height - 1;
+    return result;
+}
+
+ImageCompareResult No_Comparison() {
+    ImageCompareResult result = {};
+    result.match = false;
+    result.diff_left = result.diff_top = result.diff_right = result.diff_bottom = -1;
+    return result;
+}
+
+} // namespace
+
+std::string Screenshot_GetReferencePath(const char* name) {
+    return std::string("reference/") + name + ".ref";
+}
+
+bool Screenshot_WriteReference(const char* path,
+                                const uint8_t* pixels, int width, int height,
+                                const PaletteEntry* palette) {
+    if (width <= 0 || height <= 0 || width > MAX_REFERENCE_SIZE || height > MAX_REFERENCE_SIZE) {
+        return false;
+    }
+
+    int32_t size = width * height;
+    std::vector<uint8_t> packed(Platform_LCW_MaxCompressedSize(size));
+    int32_t packed_size = Platform_LCW_Compress(pixels, size, packed.data(),
+                                                static_cast<int32_t>(packed.size()));
+    if (packed_size < 0) {
+        return false;
+    }
+
+    ReferenceHeader header = {};
+    memcpy(header.magic, "RREF", 4);
+    header.version = REFERENCE_VERSION;
+    header.width = static_cast<uint16_t>(width);
+    header.height = static_cast<uint16_t>(height);
+    header.compressed_size = static_cast<uint32_t>(packed_size);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(palette), 256 * sizeof(PaletteEntry));
+    file.write(reinterpret_cast<const char*>(packed.data()), packed_size);
+    return static_cast<bool>(file);
+}
+
+bool Screenshot_SaveReference(const char* name) {
+    CachedReference ref;
+    if (!Screenshot_CaptureToBuffer(ref.pixels, ref.width, ref.height)) {
+        return false;
+    }
+    Platform_Graphics_GetPalette(ref.palette, 0, 256);
+
+    std::string path = Screenshot_GetReferencePath(name);
+    if (!Screenshot_WriteReference(path.c_str(), ref.pixels.data(),
+                                   ref.width, ref.height, ref.palette)) {
+        return false;
+    }
+    Reference_Cache()[name] = std::move(ref);
+    return true;
+}
+
+void Screenshot_ClearReferenceCache() {
+    Reference_Cache().clear();
+}
+
+ImageCompareResult Screenshot_CompareToReference(const char* reference_file,
+                                                  int threshold) {
+    // Capture current
+    std::vector<uint8_t> current;
+    int cur_w, cur_h;
+    if (!Screenshot_CaptureToBuffer(current, cur_w, cur_h)) {
+        return No_Comparison();
+    }
+
+    const CachedReference* ref = Find_Reference(reference_file);
+    if (ref == nullptr) {
+        return No_Comparison();
+    }
+
+    if (cur_w != ref->width || cur_h != ref->height) {
+        return Size_Mismatch(cur_w, cur_h);
+    }
+
+    return Screenshot_Compare(current.data(), ref->pixels.data(),
+                              cur_w, cur_h, threshold);
+}
+
+ImageCompareResult Screenshot_CompareToReferencePerceptual(const char* reference_file,
+                                                            int tolerance) {
+    std::vector<uint8_t> current;
+    int cur_w, cur_h;
+    if (!Screenshot_CaptureToBuffer(current, cur_w, cur_h)) {
+        return No_Comparison();
+    }
+    PaletteEntry palette[256];
+    Platform_Graphics_GetPalette(palette, 0, 256);
+
+    const CachedReference* ref = Find_Reference(reference_file);
+    if (ref == nullptr) {
+        return No_Comparison();
+    }
+
+    if (cur_w != ref->width || cur_h != ref->height) {
+        return Size_Mismatch(cur_w, cur_h);
+    }
+
+    return Screenshot_ComparePerceptual(current.data(), palette,
+                                        ref->pixels.data(), ref->palette,
+                                        cur_w, cur_h, tolerance);
+}
+
+bool Screenshot_LoadReference(const char* name,
+                               std::vector<uint8_t>& buffer,
+                               int& width, int& height,
+                               PaletteEntry* palette) {
+    const CachedReference* ref = Find_Reference(name);
+    if (ref == nullptr) {
+        return false;
+    }
+    buffer = ref->pixels;
+    width = ref->width;
+    height = ref->height;
+    if (palette != nullptr) {
+        memcpy(palette, ref->palette, sizeof(ref->palette));
+    }
     return true;
 }
+
+bool Screenshot_LoadReference(const char* name,
+                               std::vector<uint8_t>& buffer,
+                               int& width, int& height) {
+    return Screenshot_LoadReference(name, buffer, width, height, nullptr);
+}
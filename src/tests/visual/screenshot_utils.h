@@ -11,6 +11,8 @@
 #include <sstream>
 #include "test/test_framework.h"
 
+struct PaletteEntry;
+
 //=============================================================================
 // Screenshot Capture
 //=============================================================================
@@ -32,19 +34,39 @@ struct ImageCompareResult {
     int different_pixels;    // Pixels exceeding threshold
     float difference_ratio;  // Ratio of different pixels
     int max_difference;      // Maximum single-pixel difference
+    int diff_left;           // Bounding box of the differing pixels,
+    int diff_top;            // inclusive; all -1 when none differ
+    int diff_right;
+    int diff_bottom;
 };
 
-/// Compare two image buffers
+/// Compare two image buffers by palette index, 16 pixels at a time where
+/// SSE2/NEON is available
 ImageCompareResult Screenshot_Compare(
     const uint8_t* a, const uint8_t* b,
     int width, int height,
     int threshold = 5);      // Per-pixel threshold
 
+/// Compare two image buffers by the colors their indices stand for. A
+/// pixel differs when the redmean RGB distance between its two colors is
+/// over tolerance, so a reshuffled palette or a near-identical shade still
+/// matches; max_difference is that distance.
+ImageCompareResult Screenshot_ComparePerceptual(
+    const uint8_t* a, const PaletteEntry* palette_a,
+    const uint8_t* b, const PaletteEntry* palette_b,
+    int width, int height,
+    int tolerance = 8);
+
 /// Compare captured buffer against reference file
 ImageCompareResult Screenshot_CompareToReference(
     const char* reference_file,
     int threshold = 5);
 
+/// Compare captured buffer and palette against a reference's colors
+ImageCompareResult Screenshot_CompareToReferencePerceptual(
+    const char* reference_file,
+    int tolerance = 8);
+
 //=============================================================================
 // Reference Image Management
 //=============================================================================
@@ -57,9 +79,28 @@ bool Screenshot_LoadReference(const char* name,
                                std::vector<uint8_t>& buffer,
                                int& width, int& height);
 
-/// Get reference image path
+/// Load reference image with the palette it was captured under
+/// (palette must hold 256 entries)
+bool Screenshot_LoadReference(const char* name,
+                               std::vector<uint8_t>& buffer,
+                               int& width, int& height,
+                               PaletteEntry* palette);
+
+/// Get reference image path: reference/<name>.ref, the compact format of
+/// a small header, the palette and LCW-compressed indices. References in
+/// the older reference/<name>.bmp still load.
 std::string Screenshot_GetReferencePath(const char* name);
 
+/// Write a frame as a compact reference
+bool Screenshot_WriteReference(const char* path,
+                                const uint8_t* pixels, int width, int height,
+                                const PaletteEntry* palette);
+
+/// Loaded references stay in memory for the rest of the run so a suite
+/// comparing many frames against the same golden reads it once. Saving a
+/// reference replaces its cached copy.
+void Screenshot_ClearReferenceCache();
+
 //=============================================================================
 // Visual Test Macros
 //=============================================================================
@@ -70,7 +111,22 @@ std::string Screenshot_GetReferencePath(const char* name);
         if (!result.match) { \
             std::ostringstream _ss; \
             _ss << "Visual mismatch: " << (result.difference_ratio * 100) \
-                << "% different (max diff: " << result.max_difference << ")"; \
+                << "% different (max diff: " << result.max_difference \
+                << ") in (" << result.diff_left << "," << result.diff_top \
+                << ")-(" << result.diff_right << "," << result.diff_bottom << ")"; \
+            throw TestAssertionFailed(_ss.str(), __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+#define VISUAL_ASSERT_MATCHES_REFERENCE_PERCEPTUAL(name, tolerance) \
+    do { \
+        auto result = Screenshot_CompareToReferencePerceptual(name, tolerance); \
+        if (!result.match) { \
+            std::ostringstream _ss; \
+            _ss << "Visual mismatch: " << result.different_pixels \
+                << " pixels in (" << result.diff_left << "," << result.diff_top \
+                << ")-(" << result.diff_right << "," << result.diff_bottom \
+                << "), max color distance " << result.max_difference; \
             throw TestAssertionFailed(_ss.str(), __FILE__, __LINE__); \
         } \
     } while (0)
@@ -0,0 +1,130 @@
+// src/tests/visual/test_compare.cpp
+// Image Comparison Tests
+// Task 18d - Visual Tests
+
+#include "test/test_framework.h"
+#include "screenshot_utils.h"
+#include "platform.h"
+#include <cstring>
+#include <vector>
+
+//=============================================================================
+// Index Comparison
+//=============================================================================
+
+TEST_CASE(Visual_Compare_BoundingBox, "Visual") {
+    // Odd width so rows end in a partial vector block
+    const int W = 101;
+    const int H = 37;
+    std::vector<uint8_t> a(W * H, 10);
+    std::vector<uint8_t> b = a;
+
+    b[5 * W + 3] = 200;
+    b[20 * W + 70] = 0;
+    b[30 * W + 100] = 90;
+    b[33 * W + 50] = 13;        // Within the threshold of 5
+
+    ImageCompareResult result = Screenshot_Compare(a.data(), b.data(), W, H, 5);
+    TEST_ASSERT_EQ(result.different_pixels, 3);
+    TEST_ASSERT_EQ(result.max_difference, 190);
+    TEST_ASSERT_EQ(result.diff_left, 3);
+    TEST_ASSERT_EQ(result.diff_top, 5);
+    TEST_ASSERT_EQ(result.diff_right, 100);
+    TEST_ASSERT_EQ(result.diff_bottom, 30);
+    TEST_ASSERT(result.match);      // 3 of 3737 pixels
+
+    ImageCompareResult same = Screenshot_Compare(a.data(), a.data(), W, H, 0);
+    TEST_ASSERT_EQ(same.different_pixels, 0);
+    TEST_ASSERT_EQ(same.diff_left, -1);
+    TEST_ASSERT_EQ(same.diff_bottom, -1);
+}
+
+//=============================================================================
+// Perceptual Comparison
+//=============================================================================
+
+TEST_CASE(Visual_Compare_Perceptual, "Visual") {
+    PaletteEntry palette[256];
+    for (int i = 0; i < 256; i++) {
+        palette[i].r = palette[i].g = palette[i].b = static_cast<uint8_t>(i);
+    }
+    // Index 200 is nearly the gray at index 100
+    palette[200].r = 101;
+    palette[200].g = 100;
+    palette[200].b = 100;
+
+    const int W = 64;
+    const int H = 8;
+    std::vector<uint8_t> a(W * H, 100);
+    std::vector<uint8_t> b = a;
+    for (int x = 0; x < W; x++) {
+        b[2 * W + x] = 200;
+    }
+
+    // Different indices, same color: a match that index compare would fail
+    ImageCompareResult close = Screenshot_ComparePerceptual(
+        a.data(), palette, b.data(), palette, W, H, 8);
+    TEST_ASSERT_EQ(close.different_pixels, 0);
+    TEST_ASSERT(Screenshot_Compare(a.data(), b.data(), W, H, 5).different_pixels > 0);
+
+    b[6 * W + 9] = 255;
+    ImageCompareResult far = Screenshot_ComparePerceptual(
+        a.data(), palette, b.data(), palette, W, H, 8);
+    TEST_ASSERT_EQ(far.different_pixels, 1);
+    TEST_ASSERT_EQ(far.diff_left, 9);
+    TEST_ASSERT_EQ(far.diff_top, 6);
+    TEST_ASSERT_GT(far.max_difference, 8);
+
+    // The same indices under a different palette are different colors
+    PaletteEntry inverted[256];
+    for (int i = 0; i < 256; i++) {
+        inverted[i].r = inverted[i].g = inverted[i].b = static_cast<uint8_t>(255 - i);
+    }
+    ImageCompareResult repaletted = Screenshot_ComparePerceptual(
+        a.data(), palette, a.data(), inverted, W, H, 8);
+    TEST_ASSERT_EQ(repaletted.different_pixels, W * H);
+}
+
+//=============================================================================
+// Compact References
+//=============================================================================
+
+TEST_CASE(Visual_Reference_CompactRoundTrip, "Visual") {
+    const int W = 160;
+    const int H = 100;
+    std::vector<uint8_t> frame(W * H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            frame[y * W + x] = static_cast<uint8_t>((x / 16) * 16 + (y / 25));
+        }
+    }
+    PaletteEntry palette[256];
+    for (int i = 0; i < 256; i++) {
+        palette[i].r = static_cast<uint8_t>(i);
+        palette[i].g = static_cast<uint8_t>(255 - i);
+        palette[i].b = static_cast<uint8_t>(i / 2);
+    }
+
+    std::string path = Screenshot_GetReferencePath("test_compact_roundtrip");
+    if (!Screenshot_WriteReference(path.c_str(), frame.data(), W, H, palette)) {
+        TEST_SKIP("No reference/ directory to write to");
+    }
+
+    Screenshot_ClearReferenceCache();
+    std::vector<uint8_t> loaded;
+    PaletteEntry loaded_palette[256];
+    int width = 0;
+    int height = 0;
+    TEST_ASSERT(Screenshot_LoadReference("test_compact_roundtrip", loaded,
+                                         width, height, loaded_palette));
+    remove(path.c_str());
+
+    TEST_ASSERT_EQ(width, W);
+    TEST_ASSERT_EQ(height, H);
+    TEST_ASSERT(loaded == frame);
+    TEST_ASSERT_EQ(memcmp(loaded_palette, palette, sizeof(palette)), 0);
+
+    // Served from memory once loaded, even with the file gone
+    TEST_ASSERT(Screenshot_LoadReference("test_compact_roundtrip", loaded, width, height));
+    Screenshot_ClearReferenceCache();
+}